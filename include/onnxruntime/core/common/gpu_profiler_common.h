@@ -444,6 +444,10 @@ class GPUProfilerBase : public EpProfiler {
   }
 
   virtual void EndProfiling(TimePoint start_time, Events& events) override {
+    CollectEvents(start_time, events);
+  }
+
+  virtual void CollectEvents(TimePoint start_time, Events& events) override {
     auto& manager = TManager::GetInstance();
     std::map<uint64_t, Events> event_map;
     manager.Consume(client_handle_, start_time, event_map);
@@ -145,6 +145,25 @@
 #define LOGF_USER_DEFAULT(severity, format_str, ...) \
   LOGF_USER_DEFAULT_CATEGORY(severity, ::onnxruntime::logging::Category::onnxruntime, format_str, ##__VA_ARGS__)
 
+/*
+  Hot path logging.
+  For the messages of code that runs for every inference run, e.g. the executor and the allocators. Messages with a
+  severity below ORT_HOT_PATH_MIN_LOG_SEVERITY (the integer value of a Severity) are compiled out, so a build can
+  remove the cost of checking and capturing them. By default, none are compiled out.
+*/
+#ifndef ORT_HOT_PATH_MIN_LOG_SEVERITY
+#define ORT_HOT_PATH_MIN_LOG_SEVERITY 0
+#endif
+
+#define LOGS_HOT(logger, severity)                                                                                 \
+  if constexpr (static_cast<int>(::onnxruntime::logging::Severity::k##severity) < ORT_HOT_PATH_MIN_LOG_SEVERITY) { \
+    /* compiled out */                                                                                             \
+  } else                                                                                                           \
+    LOGS(logger, severity)
+
+#define LOGS_DEFAULT_HOT(severity) \
+  LOGS_HOT(::onnxruntime::logging::LoggingManager::DefaultLogger(), severity)
+
 /*
   Conditional logging
 */
@@ -16,6 +16,7 @@ enum EventCategory {
   NODE_EVENT,
   KERNEL_EVENT,
   API_EVENT,
+  MEMORY_EVENT,
   EVENT_CATEGORY_MAX
 };
 
@@ -24,7 +25,8 @@ static constexpr const char* event_category_names_[EVENT_CATEGORY_MAX] = {
     "Session",
     "Node",
     "Kernel",
-    "Api"};
+    "Api",
+    "Memory"};
 
 // Timing record for all events.
 struct EventRecord {
@@ -81,6 +83,7 @@ class EpProfiler {
   virtual ~EpProfiler() = default;
   virtual bool StartProfiling(TimePoint profiling_start_time) = 0;      // called when profiling starts
   virtual void EndProfiling(TimePoint start_time, Events& events) = 0;  // called when profiling ends, save all captures numbers to "events"
+  virtual void CollectEvents(TimePoint, Events&){};                     // called while profiling continues, e.g. after a sampled run, save the captures made so far to "events"
   virtual void Start(uint64_t){};                                       // called before op start, accept an id as argument to identify the op
   virtual void Stop(uint64_t){};                                        // called after op stop, accept an id as argument to identify the op
 };
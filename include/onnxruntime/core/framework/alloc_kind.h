@@ -29,7 +29,8 @@ enum class AllocKind {
   kAllocateStatically = 3,
   kAllocateOutput = 4,
   kShare = 5,
-  kAllocatedExternally = 6
+  kAllocatedExternally = 6,
+  kReuseSubBuffer = 7
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
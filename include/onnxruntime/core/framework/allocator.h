@@ -20,7 +20,10 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_max_bytes(-1),
+                  arena_type(-1),
+                  huge_page_mode(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
               int64_t max_power_of_two_extend_bytes)
@@ -29,7 +32,10 @@ struct OrtArenaCfg {
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_max_bytes(-1),
+        arena_type(-1),
+        huge_page_mode(-1) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +43,10 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int64_t thread_cache_max_bytes;         // use -1 to allow ORT to choose the default (disabled), 0 = disabled
+  int arena_type;                         // use -1 to allow ORT to choose the default, 0 = BFC arena, 1 = slab arena
+  int huge_page_mode;                     // use -1 to allow ORT to choose the default (disabled), 0 = disabled,
+                                          // 1 = transparent huge pages, 2 = explicit huge pages
 };
 
 namespace onnxruntime {
@@ -48,6 +58,7 @@ constexpr const char* CANN_PINNED = "CannPinned";
 constexpr const char* DML = "DML";
 constexpr const char* HIP = "Hip";
 constexpr const char* HIP_PINNED = "HipPinned";
+constexpr const char* QNN_HTP_SHARED = "QnnHtpShared";
 constexpr const char* OpenVINO_CPU = "OpenVINO_CPU";
 constexpr const char* OpenVINO_GPU = "OpenVINO_GPU";
 constexpr const char* WEBGPU_BUFFER = "WebGPU_Buffer";
@@ -93,6 +104,18 @@ class IAllocator {
   // Each implementation of IAllocator can override and provide their own implementation
   virtual void GetStats(AllocatorStats* /*stats*/) { return; }
 
+  // Stream aware allocators order the reuse of their buffers with the work of the streams that use them,
+  // e.g. the stream aware arena or the CUDA memory pool allocator.
+  virtual bool IsStreamAware() const { return false; }
+
+  // Allocate memory used by the work queued on stream. wait_fn makes a stream wait on another one, for allocators
+  // that reuse the buffers released by another stream.
+  // By default, the base implementation just calls Alloc().
+  virtual void* AllocOnStream(size_t size, Stream* /*stream*/, WaitNotificationFn /*wait_fn*/) { return Alloc(size); }
+
+  // Called when the work of a run on stream is done, before the stream is reused or destroyed.
+  virtual void ReleaseStreamBuffers(Stream* /*stream*/) {}
+
   static bool CalcMemSizeForArray(size_t nmemb, size_t size, size_t* out) noexcept {
     return CalcMemSizeForArrayWithAlignment(nmemb, size, 0, out);
   }
@@ -15,6 +15,7 @@
 #include "core/framework/tensor.h"
 
 namespace onnxruntime {
+class CompiledPartitionCache;
 class GraphViewer;
 struct ComputeCapability;
 class KernelRegistry;
@@ -62,6 +63,18 @@ enum class DataLayout {
   NCHWC,
 };
 
+// A block quantized weight format of MatMulNBits that an EP runs on its fast kernels, e.g. by prepacking the weights
+// into its own layout, rather than by dequantizing them on every run.
+struct MatMulNBitsFormat {
+  int64_t bits;
+  int64_t block_size;
+  // the accuracy_level attribute the EP prefers for the nodes it runs with this format
+  int64_t accuracy_level;
+};
+
+// The MatMulNBits formats of the EPs of a session, by EP type.
+using MatMulNBitsFormatsByEp = std::unordered_map<std::string, std::vector<MatMulNBitsFormat>>;
+
 class IExecutionProvider {
  protected:
   IExecutionProvider(const std::string& type)
@@ -291,6 +304,19 @@ class IExecutionProvider {
     return logger_;
   }
 
+  void SetCompiledPartitionCache(std::shared_ptr<const CompiledPartitionCache> compiled_partition_cache) {
+    compiled_partition_cache_ = std::move(compiled_partition_cache);
+  }
+
+  /**
+     The cache that a compiling EP keeps the partitions it compiled in, so that the next sessions on the same model
+     load them instead of compiling them again. nullptr if the session doesn't set
+     kOrtSessionOptionsEpCompiledPartitionCacheDir.
+  */
+  const CompiledPartitionCache* GetCompiledPartitionCache() const {
+    return compiled_partition_cache_.get();
+  }
+
   virtual std::unique_ptr<profiling::EpProfiler> GetProfiler() {
     return {};
   }
@@ -301,6 +327,24 @@ class IExecutionProvider {
     return DataLayout::NCHW;
   }
 
+  /**
+     Whether the layout transformation for an EP that prefers NHWC converts only the regions of connected layout
+     sensitive nodes where the NHWC kernels are estimated to save more than the Transposes at the region boundary
+     cost, instead of every layout sensitive node the EP is assigned.
+  */
+  virtual bool ConvertLayoutByCost() const {
+    return false;
+  }
+
+  /**
+     The MatMulNBits weight formats the EP runs on its fast kernels, in order of preference.
+     Graph transformers that create MatMulNBits nodes assigned to the EP use them to choose the attributes of the
+     nodes. An empty list means the EP has no preference.
+  */
+  virtual std::vector<MatMulNBitsFormat> GetMatMulNBitsFormats() const {
+    return {};
+  }
+
   virtual void RegisterStreamHandlers(IStreamCommandHandleRegistry& /*stream_handle_registry*/, AllocatorMap&) const {}
 
   /** Does the EP support concurrent calls to InferenceSession::Run to execute the model.
@@ -344,5 +388,8 @@ class IExecutionProvider {
 
   // It will be set when this object is registered to a session
   const logging::Logger* logger_ = nullptr;
+
+  // It will be set when this object is registered to a session that sets kOrtSessionOptionsEpCompiledPartitionCacheDir
+  std::shared_ptr<const CompiledPartitionCache> compiled_partition_cache_;
 };
 }  // namespace onnxruntime
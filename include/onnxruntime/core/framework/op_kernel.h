@@ -129,6 +129,21 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function, along with UseSharedPrePackedBuffers(), to let a session use pre-packed buffers saved by
+  // an earlier session instead of calling PrePack() (see kOrtSessionOptionsConfigPrepackedWeightsFile).
+  // It must set up everything PrePack() sets up for 'tensor', apart from the pre-packed buffers, which are provided
+  // by a following UseSharedPrePackedBuffers() call. It must not read the data of 'tensor', only its shape and type.
+  // @param tensor: The initialized constant tensor the buffers were pre-packed from
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffer_sizes: The sizes of the saved pre-packed buffers, in the order PrePack() produced them
+  // @param restored: Set it to true if the kernel can use the saved buffers, or to false to have PrePack() called.
+  virtual Status RestorePrePackedState(const Tensor& /*tensor*/, int /*input_idx*/,
+                                       gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                       /*out*/ bool& restored) {
+    restored = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
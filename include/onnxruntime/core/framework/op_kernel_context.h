@@ -186,6 +186,13 @@ class OpKernelContext {
   */
   AllocatorPtr GetAllocator(const OrtDevice& device) const;
 
+  /**
+  Returns a scratch buffer of at least `bytes` bytes on the device of the kernel, for temporaries that don't outlive
+  Compute. The CPU buffers are reused by the kernels that run after this one in the same run instead of going
+  through the allocator for each of them. Returns an empty pointer if `bytes` is 0.
+  */
+  IAllocatorUniquePtr<void> GetScratchBuffer(size_t bytes) const;
+
  protected:
   OpKernelContext(concurrency::ThreadPool* threadpool, const logging::Logger& logger, Stream* stream);
 
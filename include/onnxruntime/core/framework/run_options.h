@@ -6,8 +6,15 @@
 #include <string>
 #include <atomic>
 #include "core/session/onnxruntime_c_api.h"
+#include "core/common/inlined_containers_fwd.h"
 #include "core/framework/config_options.h"
 
+namespace onnxruntime {
+namespace lora {
+class LoraAdapter;
+}
+}  // namespace onnxruntime
+
 /**
  * Configuration information for a Run call.
  */
@@ -40,6 +47,10 @@ struct OrtRunOptions {
   // /include/onnxruntime/core/session/onnxruntime_run_options_config_keys.h
   onnxruntime::ConfigOptions config_options;
 
+  // The LoRA adapters whose parameters are fed to the model inputs of the same names in this run.
+  // Added with OrtApis::RunOptionsAddActiveLoraAdapter, they must outlive the runs using this OrtRunOptions.
+  onnxruntime::InlinedVector<const onnxruntime::lora::LoraAdapter*> active_lora_adapters;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 };
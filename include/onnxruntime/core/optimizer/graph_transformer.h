@@ -11,6 +11,9 @@
 #include "core/optimizer/graph_transformer_level.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 /**
 @class GraphTransformer
@@ -55,6 +58,13 @@ class GraphTransformer {
     return Status::OK();
   }
 
+  /** Helper method to call ApplyImpl on any subgraphs in the Node, with the subgraphs of the node, such as the
+  branches of an If or the encoder and decoder of a BeamSearch, transformed concurrently on `thread_pool`.
+  Only for transformers whose ApplyImpl doesn't modify anything but the graph it is given, as the subgraphs share
+  their parent graph and the transformer. */
+  Status Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger,
+                 concurrency::ThreadPool* thread_pool) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformer);
 
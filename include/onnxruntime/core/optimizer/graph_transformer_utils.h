@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "core/common/inlined_containers.h"
+#include "core/framework/execution_provider.h"
 #include "core/framework/session_options.h"
 #include "core/framework/tensor.h"
 #include "core/optimizer/graph_transformer.h"
@@ -48,14 +49,16 @@ std::unique_ptr<RuleBasedGraphTransformer> GenerateRuleBasedGraphTransformer(
     const InlinedHashSet<std::string_view>& compatible_execution_providers);
 
 /** Generates all predefined (both rule-based and non-rule-based) transformers for this level.
-    Any transformers or rewrite rules named in rules_and_transformers_to_disable will be excluded. */
+    Any transformers or rewrite rules named in rules_and_transformers_to_disable will be excluded.
+    matmul_nbits_formats are the MatMulNBits formats the EPs of the session prefer. */
 InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
     TransformerLevel level,
     const SessionOptions& session_options,
     const IExecutionProvider& execution_provider /*required by constant folding*/,
     const InlinedHashSet<std::string>& rules_and_transformers_to_disable = {},
     concurrency::ThreadPool* intra_op_thread_pool = nullptr,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr,
+    const MatMulNBitsFormatsByEp& matmul_nbits_formats = {});
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
@@ -64,6 +67,7 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 /** Generates all predefined transformers which can be used to provide runtime optimizations for this level
     in a minimal build.
     Any transformers or rewrite rules named in rules_and_transformers_to_disable will be excluded.
+    matmul_nbits_formats are the MatMulNBits formats the EPs of the session prefer.
 
     This is a distinct function from GenerateTransformers() because:
     - An ORT format model used in a minimal build will have been pre-optimized to at least level 1 when created, so
@@ -86,7 +90,8 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
     const IExecutionProvider& cpu_execution_provider,
     const InlinedHashSet<std::string>& rules_and_transformers_to_disable = {},
     concurrency::ThreadPool* intra_op_thread_pool = nullptr,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr,
+    const MatMulNBitsFormatsByEp& matmul_nbits_formats = {});
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
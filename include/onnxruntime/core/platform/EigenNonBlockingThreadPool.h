@@ -39,6 +39,8 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
@@ -77,7 +79,10 @@
 //   work.
 //
 //   This spin-then-block behavior is configured via a flag provided
-//   when creating the thread pool, and by the constant spin_count.
+//   when creating the thread pool.  Each worker adapts the length of
+//   its spin to the gaps it sees between pieces of work: it spins
+//   longer when work arrived shortly after it blocked, and shorter when
+//   it blocked for longer than it had spun.
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -219,19 +224,32 @@ class ThreadPoolProfiler {
     WAIT_REVOKE,
     MAX_EVENT
   };
+  enum ChildThreadEvent {
+    SPIN = 0,
+    BLOCKED,
+    WORK,
+    MAX_CHILD_EVENT
+  };
   ThreadPoolProfiler(int, const CHAR_TYPE*) {};
   ~ThreadPoolProfiler() = default;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolProfiler);
   void Start() {};
   std::string Stop() { return "not available for minimal build"; }
+  std::string GetStats() const { return {}; }
+  bool IsEnabled() const { return false; }
   void LogStart() {};
   void LogEnd(ThreadPoolEvent){};
   void LogEndAndStart(ThreadPoolEvent){};
   void LogStartAndCoreAndBlock(std::ptrdiff_t){};
   void LogCoreAndBlock(std::ptrdiff_t){};
+  void LogLoopStart(std::function<void(unsigned)>&, unsigned) {};
+  void LogLoopEnd() {};
+  void LogSchedule(size_t) {};
   void LogThreadId(int) {};
   void LogRun(int) {};
-  std::string DumpChildThreadStat() { return {}; }
+  void LogChildEvent(int, ChildThreadEvent) {};
+  void LogSteal(int) {};
+  std::string DumpChildThreadStat() const { return {}; }
 };
 #else
 class ThreadPoolProfiler {
@@ -244,38 +262,66 @@ class ThreadPoolProfiler {
     WAIT_REVOKE,
     MAX_EVENT
   };
+  // where the time of a child thread goes: spinning for work, blocked waiting for work, or running tasks
+  enum ChildThreadEvent {
+    SPIN = 0,
+    BLOCKED,
+    WORK,
+    MAX_CHILD_EVENT
+  };
   ThreadPoolProfiler(int num_threads, const CHAR_TYPE* threal_pool_name);
   ~ThreadPoolProfiler();
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolProfiler);
   using Clock = std::chrono::high_resolution_clock;
   void Start();                  // called by executor to start profiling
   std::string Stop();            // called by executor to stop profiling and return collected numbers
+  std::string GetStats() const;  // return the statistics accumulated by the pool since Start, without resetting them
+  bool IsEnabled() const { return enabled_; }
   void LogStart();               // called in main thread to record the starting time point
   void LogEnd(ThreadPoolEvent);  // called in main thread to calculate and save the time elapsed from last start point
   void LogEndAndStart(ThreadPoolEvent);
   void LogStartAndCoreAndBlock(std::ptrdiff_t block_size);
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
+  // called in main thread before a parallel loop of n work items, wraps fn to time each of them
+  void LogLoopStart(std::function<void(unsigned)>& fn, unsigned n);
+  void LogLoopEnd();                                // called in main thread after the loop to log its load imbalance
+  void LogSchedule(size_t queue_size);              // called in Schedule to log the length of the queue pushed to
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
-  void LogRun(int thread_idx);                      // called in child thread to log num of run
-  std::string DumpChildThreadStat();                // return all child statitics collected so far
+  void LogRun(int thread_idx);                      // called in child thread to log num of run and the time of the run
+  void LogSteal(int thread_idx);                    // called in child thread to log a task stolen from another queue
+  std::string DumpChildThreadStat() const;          // return all child statitics collected so far
+  // called in child thread to attribute the time since its last event to evt
+  void LogChildEvent(int thread_idx, ChildThreadEvent evt);
 
  private:
   static const char* GetEventName(ThreadPoolEvent);
+  static const char* GetChildEventName(ChildThreadEvent);
   struct MainThreadStat {
     uint64_t events_[MAX_EVENT] = {};
     int32_t core_ = -1;
     std::vector<std::ptrdiff_t> blocks_;  // block size determined by cost model
+    std::vector<double> imbalances_;      // max over mean of the time of the work items of every parallel loop
+    std::vector<int64_t> loop_item_ns_;   // time of each work item of the running loop, -1 if it didn't run
     std::vector<onnxruntime::TimePoint> points_;
     void LogCore();
     void LogBlockSize(std::ptrdiff_t block_size);
     void LogStart();
-    void LogEnd(ThreadPoolEvent);
-    void LogEndAndStart(ThreadPoolEvent);
+    uint64_t LogEnd(ThreadPoolEvent);
+    uint64_t LogEndAndStart(ThreadPoolEvent);
     std::string Reset();
   };
   bool enabled_ = false;
   MainThreadStat& GetMainThreadStat();  // return thread local stat
+  std::string DumpScheduleStat() const;
   int num_threads_;
+  // accumulated over all the main threads, in the thousandths for the imbalances
+  std::atomic<uint64_t> num_loops_{0};
+  std::atomic<uint64_t> fork_join_us_{0};
+  std::atomic<uint64_t> imbalance_sum_{0};
+  std::atomic<uint64_t> imbalance_max_{0};
+  std::atomic<uint64_t> num_schedules_{0};
+  std::atomic<uint64_t> schedule_queue_size_sum_{0};
+  std::atomic<uint64_t> schedule_queue_size_max_{0};
 #ifdef _MSC_VER
 #pragma warning(push)
   // C4324: structure was padded due to alignment specifier
@@ -284,8 +330,13 @@ class ThreadPoolProfiler {
   struct ORT_ALIGN_TO_AVOID_FALSE_SHARING ChildThreadStat {
     std::thread::id thread_id_;
     uint64_t num_run_ = 0;
+    uint64_t num_steals_ = 0;
+    uint64_t events_ns_[MAX_CHILD_EVENT] = {};
     onnxruntime::TimePoint last_logged_point_ = Clock::now();
-    int32_t core_ = -1;  // core that the child thread is running on
+    onnxruntime::TimePoint last_event_point_;
+    bool event_started_ = false;  // the first event only starts the clock, it follows an unknown state
+    int32_t core_ = -1;           // core that the child thread is running on
+    void LogEvent(ChildThreadEvent evt, onnxruntime::TimePoint now);
   };
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -339,6 +390,12 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+  // The statistics collected since StartProfiling, as json, without resetting them.
+  virtual std::string GetProfilingStats() const { return {}; }
+
+  // Number of tasks queued for the worker threads that have not started yet.
+  // The value is approximate if tasks are added or removed concurrently.
+  virtual size_t NumPendingTasks() const { return 0; }
 };
 
 class ThreadPoolParallelSection {
@@ -730,6 +787,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  std::string GetProfilingStats() const override {
+    return profiler_.GetStats();
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -822,6 +883,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     WorkerData& td = worker_data_[q_idx];
     Queue& q = td.queue;
     fn = q.PushBack(std::move(fn));
+    if (profiler_.IsEnabled()) {
+      profiler_.LogSchedule(q.Size());
+    }
     if (!fn) {
       // The queue accepted the work; ensure that the thread will pick it up
       td.EnsureAwake();
@@ -1251,6 +1315,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // section, and ensure it is visible to any new threads created
     // below.
     assert((!ps.current_loop) && "RunInParallelSection, but loop already active");
+    profiler_.LogLoopStart(fn, n);
     ThreadPoolLoop loop{std::move(fn), n};
     ps.current_loop = &loop;
 
@@ -1284,6 +1349,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       onnxruntime::concurrency::SpinPause();
     }
     profiler_.LogEnd(ThreadPoolProfiler::WAIT);
+    profiler_.LogLoopEnd();
   }
 
   // Run a single parallel loop _without_ a parallel section.  This is a
@@ -1301,6 +1367,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) override {
     ORT_ENFORCE(n <= num_threads_ + 1, "More work items than threads");
     profiler_.LogStartAndCoreAndBlock(block_size);
+    profiler_.LogLoopStart(fn, n);
     PerThread* pt = GetPerThread();
     ThreadPoolParallelSection ps;
     StartParallelSectionInternal(*pt, ps);
@@ -1310,12 +1377,21 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     profiler_.LogEndAndStart(ThreadPoolProfiler::RUN);
     EndParallelSectionInternal(*pt, ps);  // wait for all
     profiler_.LogEnd(ThreadPoolProfiler::WAIT);
+    profiler_.LogLoopEnd();
   }
 
   int NumThreads() const final {
     return num_threads_;
   }
 
+  size_t NumPendingTasks() const final {
+    size_t num_tasks = 0;
+    for (size_t i = 0; i < worker_data_.size(); ++i) {
+      num_tasks += worker_data_[i].queue.Size();
+    }
+    return num_tasks;
+  }
+
   int CurrentThreadId() const final {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -1532,9 +1608,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     assert(td.GetStatus() == WorkerData::ThreadStatus::Spinning);
 
+    // The spin starts at its longest and is halved, down to min_spin_count, each time the worker then blocks for
+    // longer than it spun.  It is doubled back up each time work arrives while the worker is blocked for less time
+    // than it spun, so a worker that is woken often keeps spinning while an idle one stops burning CPU.
     constexpr int log2_spin = 20;
-    const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
-    const int steal_count = spin_count / 100;
+    constexpr int log2_min_spin = 12;
+    const int max_spin_count = allow_spinning_ ? (1 << log2_spin) : 0;
+    const int min_spin_count = allow_spinning_ ? (1 << log2_min_spin) : 0;
+    int spin_count = max_spin_count;
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
@@ -1543,15 +1624,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       Task t = q.PopFront();
       if (!t) {
         // Spin waiting for work.
+        const int steal_count = spin_count / 100;
+        const auto spin_start = std::chrono::steady_clock::now();
+        bool spun_out = spin_count > 0;
         for (int i = 0; i < spin_count && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
+            if (t) profiler_.LogSteal(thread_id);
           } else {
             t = q.PopFront();
           }
           if (t) break;
 
           if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
+            spun_out = false;
             break;
           }
           onnxruntime::concurrency::SpinPause();
@@ -1559,6 +1645,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
         // Attempt to block
         if (!t) {
+          profiler_.LogChildEvent(thread_id, ThreadPoolProfiler::SPIN);
+          const auto block_start = std::chrono::steady_clock::now();
+          bool blocked = false;
           td.SetBlocked(  // Pre-block test
               [&]() -> bool {
                 bool should_block = true;
@@ -1614,16 +1703,32 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
               // Post-block update (executed only if we blocked)
               [&]() {
                 blocked_--;
+                blocked = true;
               });
+          profiler_.LogChildEvent(thread_id, ThreadPoolProfiler::BLOCKED);
+          // Tune the next spin to the gap before this wake-up.  A spin that the session cut short as idle says
+          // nothing about the gap, so it leaves the spin as is.
+          if (blocked && spun_out && !done_) {
+            const auto block_end = std::chrono::steady_clock::now();
+            if (block_end - block_start < block_start - spin_start) {
+              spin_count = std::min(spin_count * 2, max_spin_count);
+            } else {
+              spin_count = std::max(spin_count / 2, min_spin_count);
+            }
+          }
           // Thread just unblocked.  Unless we picked up work while
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
           if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) {
+            t = Steal(StealAttemptKind::TRY_ALL);
+            if (t) profiler_.LogSteal(thread_id);
+          }
         }
       }
 
       if (t) {
+        profiler_.LogChildEvent(thread_id, ThreadPoolProfiler::SPIN);
         td.SetActive();
         t();
         profiler_.LogRun(thread_id);
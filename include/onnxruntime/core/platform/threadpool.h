@@ -134,6 +134,7 @@ class ThreadPoolTempl;
 
 class ExtendedThreadPoolInterface;
 class LoopCounter;
+class ParallelForCostTable;
 class ThreadPoolParallelSection;
 
 class ThreadPool {
@@ -192,8 +193,10 @@ class ThreadPool {
   // Parallel sections are only implemented with the Eigen threadpool.
   // They have no effect when using OpenMP.
   //
-  // Parallel sections may not be nested, and may not be used inside
-  // parallel loops.
+  // A parallel section opened while another one is active on the
+  // calling thread has no effect: loops on the pool of the enclosing
+  // section run in it, and loops on other pools run without a
+  // section.  Parallel sections may not be used inside parallel loops.
 
   class ParallelSection {
    public:
@@ -213,6 +216,20 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Limits the degree of parallelism of the parallel loops that the calling thread runs while the object is alive,
+  // e.g. so that a session sharing a global pool with other sessions doesn't take all of its threads. The limit
+  // counts the calling thread, and a value of 0 or less keeps the current limit. Scopes nest, the innermost one with
+  // a limit applies.
+  class ScopedMaxDegreeOfParallelism {
+   public:
+    explicit ScopedMaxDegreeOfParallelism(int max_degree_of_parallelism);
+    ~ScopedMaxDegreeOfParallelism();
+
+   private:
+    int previous_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedMaxDegreeOfParallelism);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -360,12 +377,20 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Number of tasks waiting for a worker thread of the pool, for monitoring. 0 if tp is nullptr.
+  static size_t NumPendingTasks(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
   static void StartProfiling(concurrency::ThreadPool* tp);
   static std::string StopProfiling(concurrency::ThreadPool* tp);
 
+  // The scheduling statistics of the pool accumulated since profiling was started, as json: the spin, blocked and
+  // work time, tasks and steals of every worker thread, the fork/join overhead and load imbalance of the parallel
+  // loops, and the queue lengths seen by Schedule. Empty if profiling was not started or tp runs on a single thread.
+  static std::string GetProfilingStats(const concurrency::ThreadPool* tp);
+
  private:
   friend class LoopCounter;
 
@@ -373,6 +398,10 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads of the pool that the parallel loops of the calling thread may use, which is lower
+  // than NumThreads() in a ScopedMaxDegreeOfParallelism.
+  int NumLoopThreads() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -407,6 +436,10 @@ class ThreadPool {
   void ParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
                    const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
 
+  // ParallelFor sizing the blocks from the cost measured in earlier runs of the loop, see ParallelForCostTable.
+  void AdaptiveParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
+                           const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
+
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
   void Schedule(std::function<void()> fn);
@@ -415,6 +448,8 @@ class ThreadPool {
 
   std::string StopProfiling();
 
+  std::string GetProfilingStats() const;
+
   ThreadOptions thread_options_;
 
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
@@ -428,6 +463,9 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Measured costs of parallel loops, if ThreadOptions::adaptive_block_sizing_ is set.
+  std::unique_ptr<ParallelForCostTable> cost_table_;
 };
 
 }  // namespace concurrency
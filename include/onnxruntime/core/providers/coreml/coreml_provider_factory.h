@@ -31,9 +31,13 @@ enum COREMLFlags {
   // Create an MLProgram. By default it will create a NeuralNetwork model. Requires Core ML 5 or later.
   COREML_FLAG_CREATE_MLPROGRAM = 0x010,
 
+  // Keep the compiled CoreML models in the caches directory of the app, so that the sessions created later for the
+  // same model skip the compilation. The cache is keyed by the generated CoreML model and the OS version.
+  COREML_FLAG_ENABLE_MODEL_CACHE = 0x020,
+
   // Keep COREML_FLAG_LAST at the end of the enum definition
   // And assign the last COREMLFlag to it
-  COREML_FLAG_LAST = COREML_FLAG_CREATE_MLPROGRAM,
+  COREML_FLAG_LAST = COREML_FLAG_ENABLE_MODEL_CACHE,
 };
 
 #ifdef __cplusplus
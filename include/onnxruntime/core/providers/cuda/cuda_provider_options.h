@@ -40,4 +40,7 @@ struct OrtCUDAProviderOptionsV2 {
   int use_tf32 = 1;                                                                                            // use TF32
   int fuse_conv_bias = 0;                                                                                      // Enable CUDNN Frontend kernel fusing, results in JIT compiles
   int sdpa_kernel = 0;                                                                                         // Scaled Dot Product Attention kernel option
+  int use_cuda_mempool = 0;                                                                                    // flag specifying if a stream ordered CUDA memory pool (cudaMallocAsync) is used instead of the BFC Arena.
+  size_t cuda_mempool_release_threshold = std::numeric_limits<size_t>::max();                                  // Bytes of unused memory the CUDA memory pool keeps when a stream is synchronized.
+  int nhwc_cost_model = 0;                                                                                     // flag specifying if prefer_nhwc only converts the regions where NHWC is estimated to pay off.
 };
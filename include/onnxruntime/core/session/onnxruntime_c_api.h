@@ -64,6 +64,7 @@ extern "C" {
 #define _In_reads_(X)
 #define _Inout_updates_(X)
 #define _Out_writes_(X)
+#define _Out_writes_opt_(X)
 #define _Inout_updates_all_(X)
 #define _Out_writes_bytes_all_(X)
 #define _Out_writes_all_(X)
@@ -304,6 +305,9 @@ ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
+ORT_RUNTIME_CLASS(PreparedRun);
+ORT_RUNTIME_CLASS(LoraAdapter);
+ORT_RUNTIME_CLASS(SharedPrePackedWeightCache);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -726,6 +730,35 @@ typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options
  */
 typedef void (*RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
 
+/** \brief Callback function that provides the memory of an output bound with OrtApi::BindOutputToAllocator
+ *
+ * It is called during the run once the final shape of the output is known.
+ *
+ * \param[in] user_data User specific data that was passed to OrtApi::BindOutputToAllocator
+ * \param[in] shape Final shape of the output
+ * \param[in] shape_len Number of dimensions of the output
+ * \param[in] element_type Element type of the output
+ * \param[in] memory_info Device the output is produced on. The provided tensor must be in memory of this device.
+ * \param[out] output Set to a tensor of the given shape and element type, e.g. created with
+ *             OrtApi::CreateTensorWithDataAsOrtValue over a slot of a ring buffer. The caller of the callback takes
+ *             ownership of it. Set to nullptr to let onnxruntime allocate the output.
+ */
+typedef OrtStatus*(ORT_API_CALL* OrtOutputAllocatorFn)(void* user_data, const int64_t* shape, size_t shape_len,
+                                                      ONNXTensorElementDataType element_type,
+                                                      const OrtMemoryInfo* memory_info, OrtValue** output);
+
+/** \brief Callback function that receives the profile of a run sampled by the sampled profiling mode
+ *
+ * It is called on the thread of the run, before the run returns, so it should hand the profile over quickly.
+ *
+ * \param[in] user_data User specific data that was passed to OrtApi::SessionSetProfilingSampleCallback
+ * \param[in] trace_json The events of the run as a json array in chrome tracing format. Only valid during the call.
+ * \param[in] trace_json_len Length of trace_json in bytes
+ * \param[in] run_duration_us Duration of the run in microseconds
+ */
+typedef void(ORT_API_CALL* OrtProfilingSampleCallbackFn)(void* user_data, const char* trace_json,
+                                                         size_t trace_json_len, int64_t run_duration_us);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2804,6 +2837,18 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_bytes": Maximum number of bytes of freed small allocations (up to 1MB each) that are
+   *  kept in per-thread caches in front of the arena so they can be reused without taking the arena lock.
+   *  Useful when many threads run the same session concurrently. Only applies to arenas that are not stream aware.
+   *  Use 0 or -1 to disable the cache, which is the default.
+   * "arena_type": 0 = BFC arena, 1 = slab arena. The slab arena is a segregated-fit allocator with lock-free free
+   *  lists that trades some memory for lower allocation latency. It is only supported for CPU memory; other devices
+   *  fall back to the BFC arena. Only "max_mem" applies to the slab arena.
+   *  Use -1 to allow ORT to choose the default (BFC arena).
+   * "huge_page_mode": 0 = disabled, 1 = transparent huge pages, 2 = explicit huge pages. Backs the memory the BFC
+   *  arena allocates from the system with 2MB pages to reduce TLB misses. Explicit huge pages have to be reserved
+   *  (vm.nr_hugepages) and fall back to transparent huge pages. Regions that cannot get huge pages use regular pages.
+   *  Only supported for CPU memory on Linux. Use -1 to allow ORT to choose the default (disabled).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -3654,6 +3699,11 @@ struct OrtApi {
        Enable the float32 model to be inferenced with fp16 precision. Otherwise, it will be fp32 precision.
          - "0": Default. With fp32 precision.
          - "1": With fp16 precision.
+   *   "enable_htp_shared_memory_allocator": Create an allocator of host memory shared with the HTP (rpcmem), named
+   *   "QnnHtpShared". The inputs and outputs bound with it are accessed by the HTP without a copy.
+   *   Requires libcdsprpc.
+   *     - "0": Default. Disabled.
+   *     - "1": Enabled.
    *
    * SNPE supported keys:
    *   "runtime": SNPE runtime engine, options: "CPU", "CPU_FLOAT32", "GPU", "GPU_FLOAT32_16_HYBRID", "GPU_FLOAT16",
@@ -4667,6 +4717,249 @@ struct OrtApi {
                   _In_reads_(num_external_initializer_files) char* const* external_initializer_file_buffer_array,
                   _In_reads_(num_external_initializer_files) const size_t* external_initializer_file_lengths,
                   size_t num_external_initializer_files);
+
+  /** \brief Get the metrics the session recorded since it was initialized
+   *
+   * Metrics are recorded if the session config entry "session.enable_metrics" is set to "1". They are returned as a
+   * json object with latency histograms of every node and of every op type, allocator statistics and the number of
+   * tasks waiting in the thread pools of the session.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated UTF-8 encoded json. It must be freed using `allocator`.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Bind an output to a callback that provides its memory once its final shape is known
+   *
+   * The output is written in place into the tensor the callback provides, without an intermediate allocation or a
+   * copy. It is not copied to another device: the callback is given the device of the node that produces the output.
+   * The callback is called in every run. If the output is not produced by a node, e.g. if it is a graph input, the
+   * callback is not called and onnxruntime allocates the output.
+   * Retrieve the outputs after the run with OrtApi::GetBoundOutputValues.
+   *
+   * \param[in] binding_ptr
+   * \param[in] name Name of a tensor output of the model
+   * \param[in] allocator_fn Callback that provides the memory of the output
+   * \param[in] user_data User data that is passed back to allocator_fn
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(BindOutputToAllocator, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                  _In_ OrtOutputAllocatorFn allocator_fn, _In_opt_ void* user_data);
+
+  /** \brief Replace the values of initializers of a session, e.g. to swap in fine-tuned weights
+   *
+   * The new values are copied into new buffers of the initializers, and kernels that pre-packed an initializer
+   * pre-pack the new value. The memory of the current values, e.g. mapped external data files or the bytes of an ORT
+   * format model, is never written. Initializers added with OrtApi::AddInitializer can't be updated.
+   * The optimized graph and the kernels are kept, which is much faster than creating a new session.
+   * Initializers that graph optimizations folded into other values can't be updated: list them in the session config
+   * entry "session.updatable_initializers" to keep them from being constant folded.
+   * Waits for the runs in progress to complete. A session that shares its state with clones can't be updated.
+   * The values can be released when the call returns.
+   *
+   * \param[in] session
+   * \param[in] initializer_names Array of null terminated UTF-8 encoded initializer names
+   * \param[in] initializers Array of tensors with the type and shape of the current values
+   * \param[in] num_initializers Number of elements in the initializer_names and initializers arrays
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(UpdateSessionInitializers, _Inout_ OrtSession* session,
+                  _In_reads_(num_initializers) const char* const* initializer_names,
+                  _In_reads_(num_initializers) const OrtValue* const* initializers, size_t num_initializers);
+
+  /** \brief Bind an output to an input as the state of a streaming model
+   *
+   * After every run the output becomes the input of the next run, without a copy. The output is produced on the
+   * device of the input, and the state before the current one is reused as the buffer of the next output when the
+   * shape of the state does not change, so the state alternates between two buffers.
+   * Bind the initial state with OrtApi::BindInput before the first run. Binding the input again restarts the stream
+   * from the new value. Values of the state retrieved with OrtApi::GetBoundOutputValues may be overwritten after
+   * the next run. OrtApi::ClearBoundOutputs also clears the states.
+   *
+   * \param[in] binding_ptr
+   * \param[in] input_name Name of an input of the model
+   * \param[in] output_name Name of an output of the model with the type of the input
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                  _In_ const char* output_name);
+
+  /// \name OrtPreparedRun
+  /// @{
+
+  /** \brief Create an ::OrtPreparedRun for repeated runs of a session with the same input and output names
+   *
+   * The names are resolved once, and the device copy plan of the inputs and outputs is kept between the runs of
+   * OrtApi::RunPrepared. An ::OrtPreparedRun must not be used by concurrent runs. Create one per thread instead.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF-8 encoded input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF-8 encoded output names
+   * \param[in] output_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be freed with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_len) const char* const* output_names, size_t output_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Run the model in an ::OrtSession with the names of an ::OrtPreparedRun
+   *
+   * Same as OrtApi::Run with the input and output names given to OrtApi::CreatePreparedRun.
+   * The session of the ::OrtPreparedRun must be `session`.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run
+   * \param[in] inputs Array of ::OrtValue%s in the order of the input names of `prepared_run`
+   * \param[out] outputs Array of ::OrtValue%s in the order of the output names of `prepared_run`. As in OrtApi::Run,
+   *     the elements can be nullptr, in which case ::OrtValue objects are allocated for the outputs.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run, _In_ const OrtValue* const* inputs, _Inout_ OrtValue** outputs);
+
+  /** \brief Release an ::OrtPreparedRun obtained from OrtApi::CreatePreparedRun
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /// @}
+
+  /** \brief Warm up an ::OrtSession before serving
+   *
+   * Runs the model on zero filled inputs, so that the memory arenas, memory patterns, weights packed on first use,
+   * kernel algorithm searches and tuning, and the pages of mapped initializers are ready before the first request.
+   * All the outputs of the model are computed.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] input_names Array of null terminated UTF-8 encoded names of the inputs with a given shape
+   * \param[in] input_shapes Array of the shapes of the named inputs
+   * \param[in] input_shape_lens Array of the number of dimensions of the named inputs
+   * \param[in] input_len Number of elements in the input_names, input_shapes and input_shape_lens arrays.
+   *     The inputs not named use the shapes of the model, whose free dimensions must be overridden with
+   *     OrtApi::AddFreeDimensionOverride or OrtApi::AddFreeDimensionOverrideByName.
+   * \param[in] num_runs Number of runs. More than one run is needed before a captured graph is replayed.
+   * \param[out] run_durations_us Optional array of num_runs elements set to the duration of each run in microseconds
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(WarmUpSession, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const int64_t* const* input_shapes,
+                  _In_reads_(input_len) const size_t* input_shape_lens, size_t input_len, size_t num_runs,
+                  _Out_writes_opt_(num_runs) int64_t* run_durations_us);
+
+  /** \brief Set the callback the profiles of sampled runs are handed to
+   *
+   * Sampled profiling is enabled with the session config entries "session.profiling_sample_every_n_runs" and
+   * "session.profiling_sample_latency_threshold_ms" (see onnxruntime_session_options_config_keys.h). Only the sampled
+   * runs are profiled, their events are kept in a ring buffer of a fixed size, and handed to the callback at the end
+   * of the run instead of being written to a file. Events of execution provider profilers, e.g. CUDA kernels, are
+   * included.
+   *
+   * \param[in] session
+   * \param[in] callback The callback, or nullptr to drop the profiles
+   * \param[in] user_data Passed to the callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionSetProfilingSampleCallback, _Inout_ OrtSession* session,
+                  _In_opt_ OrtProfilingSampleCallbackFn callback, _In_opt_ void* user_data);
+
+  /// \name OrtLoraAdapter
+  /// @{
+
+  /** \brief Load an ::OrtLoraAdapter from a file
+   *
+   * The adapter file is an ONNX model whose initializers are the parameters of the adapter, e.g. the low rank A and B
+   * matrices of each adapted MatMul, named like the inputs of the model they are fed to. The base model takes the
+   * adapter parameters as inputs, so one session serves all the adapters over one copy of the base weights.
+   * The parameters are kept in CPU memory and copied to the device of the inputs in each run, like other inputs.
+   *
+   * \param[in] adapter_file_path Path of the adapter file
+   * \param[out] out Newly created ::OrtLoraAdapter. Must be freed with OrtApi::ReleaseLoraAdapter
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreateLoraAdapter, _In_ const ORTCHAR_T* adapter_file_path, _Outptr_ OrtLoraAdapter** out);
+
+  /** \brief Release an ::OrtLoraAdapter obtained from OrtApi::CreateLoraAdapter
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(LoraAdapter);
+
+  /** \brief Make an ::OrtLoraAdapter active in the runs using an ::OrtRunOptions
+   *
+   * The parameters of the active adapters are fed to the model inputs of the same names that are not fed by the
+   * caller. When several active adapters have a parameter of the same name, the one added first is used.
+   * The adapter must outlive the runs using `options`. An adapter can be active in concurrent runs.
+   * Adapters can't be active in runs of an ::OrtPreparedRun.
+   *
+   * \param[in] options
+   * \param[in] adapter
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunOptionsAddActiveLoraAdapter, _Inout_ OrtRunOptions* options,
+                  _In_ const OrtLoraAdapter* adapter);
+
+  /** \brief Hand the pre-packed buffers of a custom op kernel over to a cache shared between sessions
+   *
+   * Called from OrtCustomOp::KernelPrePackWeight when it gets a cache. The buffers must have been allocated with the
+   * allocator passed to KernelPrePackWeight, and ORT owns and frees them once they are stored. The kernel must not
+   * keep them: it gets the shared buffers, which may be the ones of another session, through
+   * OrtCustomOp::KernelSetSharedPrePackedWeight.
+   *
+   * \param[in] prepacked_weight_cache The cache passed to OrtCustomOp::KernelPrePackWeight
+   * \param[in] buffer_data_ptrs The pre-packed buffers
+   * \param[in] buffer_data_sizes The sizes of the buffers in bytes
+   * \param[in] num_buffers
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SharedPrePackedWeightCache_StoreWeightData,
+                  _Inout_ OrtSharedPrePackedWeightCache* prepacked_weight_cache,
+                  _In_reads_(num_buffers) void** buffer_data_ptrs,
+                  _In_reads_(num_buffers) const size_t* buffer_data_sizes, _In_ size_t num_buffers);
+
+  /// @}
 };
 
 /*
@@ -4779,6 +5072,23 @@ struct OrtCustomOp {
   // Same as GetMayInplace() and ReleaseMayInplace()
   size_t(ORT_API_CALL* GetAliasMap)(_Out_ int** input_index, _Out_ int** output_index);
   void(ORT_API_CALL* ReleaseAliasMap)(_Frees_ptr_opt_ int* input_index, _Frees_ptr_opt_ int* output_index);
+
+  // Pre-pack a constant initializer input when the session is initialized, like the built-in kernels pre-pack their
+  // weights. Set *is_packed to true if the kernel packed the tensor: the initializer may then be released, and isn't
+  // available to the compute calls anymore. The packed buffers must be allocated with `allocator`.
+  // When `prepacked_weight_cache` is not null, the packed weights are shared between sessions: the kernel stores its
+  // buffers with OrtApi::SharedPrePackedWeightCache_StoreWeightData instead of keeping them, and gets the shared
+  // buffers through KernelSetSharedPrePackedWeight. Can be null.
+  OrtStatusPtr(ORT_API_CALL* KernelPrePackWeight)(_In_ void* op_kernel, _In_ const OrtValue* tensor,
+                                                  _In_ int input_index, _Inout_ OrtAllocator* allocator,
+                                                  _In_opt_ OrtSharedPrePackedWeightCache* prepacked_weight_cache,
+                                                  _Out_ bool* is_packed);
+
+  // Pass the shared pre-packed buffers of an input to the kernel, in the order KernelPrePackWeight stored them.
+  // The buffers are owned by ORT and outlive the kernel. Must be set if KernelPrePackWeight stores buffers.
+  OrtStatusPtr(ORT_API_CALL* KernelSetSharedPrePackedWeight)(
+      _In_ void* op_kernel, _In_reads_(num_buffers) const void* const* buffer_data_ptrs, _In_ size_t num_buffers,
+      _In_ int input_index);
 };
 
 /*
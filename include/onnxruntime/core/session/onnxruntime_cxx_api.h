@@ -2309,6 +2309,8 @@ struct CustomOpBase : OrtCustomOp {
     OrtCustomOp::ReleaseMayInplace = nullptr;
     OrtCustomOp::GetAliasMap = nullptr;
     OrtCustomOp::ReleaseAliasMap = nullptr;
+    OrtCustomOp::KernelPrePackWeight = nullptr;
+    OrtCustomOp::KernelSetSharedPrePackedWeight = nullptr;
   }
 
   // Default implementation of GetExecutionProviderType that returns nullptr to default to the CPU provider
@@ -867,6 +867,9 @@ struct OrtLiteCustomOp : public OrtCustomOp {
     OrtCustomOp::ReleaseMayInplace = {};
     OrtCustomOp::GetAliasMap = {};
     OrtCustomOp::ReleaseAliasMap = {};
+
+    OrtCustomOp::KernelPrePackWeight = {};
+    OrtCustomOp::KernelSetSharedPrePackedWeight = {};
   }
 
   const std::string op_name_;
@@ -920,6 +923,7 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
       std::vector<ArgPtr> args;
+      args.reserve(kernel->num_input_ + kernel->num_output_);
       auto t = CreateTuple<0, 0, Args...>(context, args, kernel->num_input_, kernel->num_output_, kernel->ep_);
       std::apply([kernel](Args const&... t_args) { kernel->compute_fn_(t_args...); }, t);
     };
@@ -960,6 +964,7 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
     OrtCustomOp::KernelComputeV2 = [](void* op_kernel, OrtKernelContext* context) -> OrtStatusPtr {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
       std::vector<ArgPtr> args;
+      args.reserve(kernel->num_input_ + kernel->num_output_);
       auto t = CreateTuple<0, 0, Args...>(context, args, kernel->num_input_, kernel->num_output_, kernel->ep_);
       return std::apply([kernel](Args const&... t_args) { Status status = kernel->compute_fn_return_status_(t_args...); return status.release(); }, t);
     };
@@ -999,6 +1004,11 @@ struct OrtLiteCustomFunc : public OrtLiteCustomOp {
 //                   Ort::Custom::Tensor<std::string>* strings_out) {...}
 //      bool reverse_ = false;
 //   };
+// The struct may also pre-pack its constant initializer inputs when the session is initialized, by defining
+//      Status PrePackWeight(Ort::ConstValue tensor, int input_index, OrtAllocator* allocator,
+//                           OrtSharedPrePackedWeightCache* prepacked_weight_cache, bool& is_packed) {...}
+//      Status SetSharedPrePackedWeight(const void* const* buffers, size_t num_buffers, int input_index) {...}
+// See OrtCustomOp::KernelPrePackWeight and OrtCustomOp::KernelSetSharedPrePackedWeight.
 // It could be registered this way:
 //   Ort::CustomOpDomain v2_domain{"v2"};
 //   std::unique_ptr<OrtLiteCustomOp> mrg_op_ptr{Ort::Custom::CreateLiteCustomOp<Merge>("Merge", "CPUExecutionProvider")};
@@ -1043,6 +1053,8 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
     };
 
     SetShapeInfer<CustomOp>(0);
+    SetPrePackWeight<CustomOp>(0);
+    SetSharedPrePackedWeight<CustomOp>(0);
   }
 
   template <typename... Args>
@@ -1051,6 +1063,7 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
       ArgPtrs args;
+      args.reserve(kernel->num_input_ + kernel->num_output_);
       auto t = CreateTuple<0, 0, Args...>(context, args, kernel->num_input_, kernel->num_output_, kernel->ep_);
       std::apply([kernel](Args const&... t_args) { kernel->custom_op_->Compute(t_args...); }, t);
     };
@@ -1062,6 +1075,7 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
     OrtCustomOp::KernelComputeV2 = [](void* op_kernel, OrtKernelContext* context) -> OrtStatusPtr {
       auto kernel = reinterpret_cast<Kernel*>(op_kernel);
       ArgPtrs args;
+      args.reserve(kernel->num_input_ + kernel->num_output_);
       auto t = CreateTuple<0, 0, Args...>(context, args, kernel->num_input_, kernel->num_output_, kernel->ep_);
       return std::apply([kernel](Args const&... t_args) { Status status = kernel->custom_op_->Compute(t_args...); return status.release(); }, t);
     };
@@ -1080,6 +1094,41 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
   void SetShapeInfer(...) {
     OrtCustomOp::InferOutputShapeFn = {};
   }
+
+  template <typename C>
+  decltype(&C::PrePackWeight) SetPrePackWeight(decltype(&C::PrePackWeight)) {
+    OrtCustomOp::KernelPrePackWeight = [](void* op_kernel, const OrtValue* tensor, int input_index,
+                                          OrtAllocator* allocator,
+                                          OrtSharedPrePackedWeightCache* prepacked_weight_cache,
+                                          bool* is_packed) -> OrtStatusPtr {
+      auto kernel = reinterpret_cast<Kernel*>(op_kernel);
+      Status status = kernel->custom_op_->PrePackWeight(ConstValue{tensor}, input_index, allocator,
+                                                        prepacked_weight_cache, *is_packed);
+      return status.release();
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetPrePackWeight(...) {
+    OrtCustomOp::KernelPrePackWeight = {};
+  }
+
+  template <typename C>
+  decltype(&C::SetSharedPrePackedWeight) SetSharedPrePackedWeight(decltype(&C::SetSharedPrePackedWeight)) {
+    OrtCustomOp::KernelSetSharedPrePackedWeight = [](void* op_kernel, const void* const* buffer_data_ptrs,
+                                                     size_t num_buffers, int input_index) -> OrtStatusPtr {
+      auto kernel = reinterpret_cast<Kernel*>(op_kernel);
+      Status status = kernel->custom_op_->SetSharedPrePackedWeight(buffer_data_ptrs, num_buffers, input_index);
+      return status.release();
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetSharedPrePackedWeight(...) {
+    OrtCustomOp::KernelSetSharedPrePackedWeight = {};
+  }
 };  // struct OrtLiteCustomStruct
 
 /////////////////////////// CreateLiteCustomOp ////////////////////////////
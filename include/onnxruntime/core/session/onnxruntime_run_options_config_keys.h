@@ -26,6 +26,13 @@
 // By default, the value for this key is empty (i.e.) no memory arenas are shrunk
 static const char* const kOrtRunOptionsConfigEnableMemoryArenaShrinkage = "memory.enable_memory_arena_shrinkage";
 
+// Set to '1' to report the memory the run took from the allocators of the session, per device: the peak bytes of
+// the tensors and memory pattern buffers the execution frames allocated, the number of allocations, and the number
+// of arena extensions while the run executed. The report is logged at INFO level on the run logger and, if the
+// session option session.enable_metrics is set, aggregated per device in the "run_allocations" of the metrics.
+// Per default it will be set to '0'
+static const char* const kOrtRunOptionsConfigReportAllocations = "memory.report_allocations";
+
 // Set to '1' to not synchronize execution providers with CPU at the end of session run.
 // Per default it will be set to '0'
 // Taking CUDA EP as an example, it omit triggering cudaStreamSynchronize on the compute stream.
@@ -54,3 +61,8 @@ static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id
 // “Default”: OS determines the scheduling priority and processor performance to service this workload. [Default]
 // “Efficient”: OS treats this workload is efficiency oriented with low scheduling priority and efficient processor performance.
 static const char* const kOrtRunOptionsWorkloadType = "run.workload_type";
+
+// Specify the priority of this run as an integer. Higher values are more urgent. The default is "0".
+// While a run of a higher priority is executing in the same session, runs of lower priority wait between nodes.
+// With session.max_concurrent_async_runs, queued asynchronous runs are also started in priority order.
+static const char* const kOrtRunOptionsConfigRunPriority = "run.priority";
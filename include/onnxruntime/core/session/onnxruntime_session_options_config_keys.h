@@ -20,6 +20,54 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// The constant initializers of the kernels of different nodes are pre-packed in parallel on the intra-op thread pool
+// when the pre-packed weights are not shared. Set to "1" to pre-pack them one node at a time, e.g. for custom kernels
+// whose PrePack() is not thread-safe.
+// "0": default, pre-pack in parallel. "1": pre-pack serially.
+static const char* const kOrtSessionOptionsConfigDisableParallelPrepacking = "session.disable_parallel_prepacking";
+
+// Directory used to share the pre-packed weights of CPU kernels between processes, e.g. "/dev/shm/ort_prepacked".
+// The first process to pre-pack a weight writes it to a file in the directory, and every process that pre-packs the
+// same weight then maps that file read-only instead of keeping its own copy, so processes serving the same model
+// share one copy of the pre-packed weights. Use a directory on a memory backed file system to avoid disk I/O, and
+// don't share it between hosts. Weights shared within a process through a PrepackedWeightsContainer are not affected.
+// The default "" disables sharing between processes.
+static const char* const kOrtSessionOptionsConfigSharedPrepackedWeightsDir = "session.shared_prepacked_weights_dir";
+
+// Path of a file that keeps the pre-packed weights of CPU kernels between sessions of a model, e.g. "model.ort.prepacked",
+// so sessions skip OpKernel::PrePack() at load for the kernels that support it.
+// If the file exists, its weights are mapped read-only and handed to the kernels instead of pre-packing them. If it
+// doesn't exist, or was saved by a different onnxruntime version or on a CPU with different features, the weights
+// are pre-packed and the file is (re)written. Each weight is only used if the initializer it was packed from is
+// unchanged. Only weights of the main graph are saved. The default "" disables the file.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsFile = "session.prepacked_weights_file";
+
+// Comma separated names of initializers whose values will be replaced in the initialized session, e.g. "w0,w1".
+// Constant folding and constant sharing skip nodes that use them, so they are kept in the optimized graph and can be
+// updated with OrtApi::UpdateSessionInitializers. Other graph optimizations, e.g. fusions, may still fold them.
+static const char* const kOrtSessionOptionsConfigUpdatableInitializers = "session.updatable_initializers";
+
+// Loads external initializers in parallel on the intra-op thread pool during session initialization.
+// Applies to external initializers that are copied to a non-CPU device, and to those loaded by an external data
+// loader that supports concurrent loads. Their device memory is allocated in order, then the files are read and
+// copied to the device by several threads at once, so reading overlaps with the copies.
+// "0": default, initializers are loaded one after another. "1": load them in parallel.
+// The data transfer of the execution provider must allow concurrent copies.
+static const char* const kOrtSessionOptionsConfigParallelInitializerLoading = "session.parallel_initializer_loading";
+
+// Creates the initializers and kernels of the then/else branches of If nodes when the branch is first executed,
+// instead of during session initialization. This reduces the initialization time and memory usage of models with
+// large branches that are rarely taken, e.g. task specific heads selected by an If. The first execution of such a
+// branch includes its initialization.
+// "0": default, all subgraphs are initialized during session initialization. "1": initialize If branches lazily.
+static const char* const kOrtSessionOptionsConfigLazySubgraphInitialization = "session.lazy_subgraph_initialization";
+
+// Used with session.lazy_subgraph_initialization. Initializes the lazily initialized If branches on a background
+// thread once the session is initialized, so that session creation isn't delayed by them and their first execution
+// usually isn't either.
+// "0": default, branches are initialized when they are first executed. "1": initialize them in the background.
+static const char* const kOrtSessionOptionsConfigLazySubgraphWarmUp = "session.lazy_subgraph_warm_up";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -32,6 +80,24 @@ static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load
 // If unset, format will default to ONNX unless optimized_model_filepath ends in '.ort'.
 static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save_model_format";
 
+// Directory of an automatic cache of optimized models. The default is "" (disabled).
+// When set, the graph produced by the graph optimizations and partitioning of an ONNX model is saved in ORT format to
+// the directory, keyed by a hash of the model, the session options, the execution providers with their options and
+// the ORT version. A later session with the same key loads the cached ORT format model instead of optimizing the
+// ONNX model again. Sessions that save the optimized model through SessionOptions.optimized_model_filepath, that
+// inject external initializers, that use custom ops, or that compile nodes in an execution provider do not use the
+// cache. The key includes the path, size and modification time of each external data file of the model, and models
+// with external data in memory do not use the cache.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Directory of an automatic cache of the TunableOp tuning results of the execution providers. The default is ""
+// (disabled). When set, the tuning results of each execution provider that supports TunableOp are loaded from the
+// directory when the session is initialized, and saved back with the results tuned by the session when it is
+// destroyed. The entries are keyed by the validators of the execution provider, e.g. the ORT version, the GPU model
+// and the CUDA runtime and driver versions, so a directory can be shared by machines with different GPUs.
+// Loaded results enable the use of TunableOp like the tuning results embedded in a model.
+static const char* const kOrtSessionOptionsConfigTuningResultsCacheDir = "session.tuning_results_cache_dir";
+
 // If a value is "1", flush-to-zero and denormal-as-zero are applied. The default is "0".
 // When multiple sessions are created, a main thread doesn't override changes from succeeding session options,
 // but threads in session thread pools follow option changes.
@@ -67,6 +133,66 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable fusing chains of float elementwise operators on CPU, and of float and float16 ones on CUDA, into a
+// FusedElementwise node in graph optimization. "0": disable; "1": enable. The default is "0".
+// The fusion may take nodes away from other fusions that run after it, so it is disabled by default.
+static const char* const kOrtSessionOptionsEnableElementwiseChainFusion =
+    "optimization.enable_elementwise_chain_fusion";
+
+// Quantize the large float embedding tables looked up by Gather or EmbeddingBag on CPU row by row, and look them up
+// with GatherRowQuantized, in graph optimization. "0": disable; "8", "4" or "2": the number of bits per value.
+// The default is "0". The quantization changes the results, so it is disabled by default.
+static const char* const kOrtSessionOptionsEmbeddingTableQuantizationBits =
+    "optimization.embedding_table_quantization_bits";
+
+// Enable or disable folding independent constant nodes in parallel on the intra-op thread pool. The values computed
+// by constant folding are passed between the folded nodes directly and only the ones the remaining graph uses become
+// initializers. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableParallelConstantFolding =
+    "optimization.enable_parallel_constant_folding";
+
+// Enable or disable estimating whether converting a region of nodes to the NCHWc layout pays for the reorders at
+// its boundary. If enabled, the NchwcTransformer leaves regions in NCHW layout when the estimated cost of the NCHWc
+// nodes and reorders is higher, e.g. for convolutions with small spatial dims. Regions whose shapes are not
+// statically known are converted as before. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableNchwcLayoutCostModel = "optimization.enable_nchwc_layout_cost_model";
+
+// Enable or disable fusing the self attention of decoder models exported from PyTorch, with rotary embeddings and a
+// past key/value Concat, into a GroupQueryAttention node in graph optimization.
+// GroupQueryAttention always applies a causal mask and computes the sequence lengths from the attention_mask input,
+// so the fusion is only exact without padding in the batch. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableGroupQueryAttentionFusion =
+    "optimization.enable_group_query_attention_fusion";
+
+// Enable or disable fusing the MatMul of float 8 (E4M3FN or E5M2) QDQ models, a DequantizeLinear activation and a
+// DequantizeLinear constant weight quantized per tensor or per column, into GemmFloat8 in graph optimization, for the
+// CUDA execution provider. GemmFloat8 runs on the float 8 tensor cores of GPUs with compute capability 8.9 or higher
+// (Ada, Hopper), it fails on older GPUs. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableGemmFloat8Fusion = "optimization.enable_gemm_float8_fusion";
+
+// Shard the model over the GPUs of a tensor parallel group in graph optimization, following the Megatron-LM scheme:
+// the weights of the MLP (MatMul, activation, MatMul) and Attention (Attention, MatMul) blocks are split over the
+// ranks, and the partial results are summed by the AllReduce collective operator. Each rank of the group runs its own
+// session of the same model, usually in its own process, with the rank of its NCCL communicator (the MPI rank), and
+// only keeps its shard of these weights. Requires a CUDA or ROCm build with NCCL (ORT_USE_NCCL).
+// The number of ranks of the group. The default "1" disables the sharding.
+static const char* const kOrtSessionOptionsTensorParallelSize = "optimization.tensor_parallel_size";
+// The 0-based rank of the session in the group, in the range [0, tensor_parallel_size). The default is "0".
+static const char* const kOrtSessionOptionsTensorParallelRank = "optimization.tensor_parallel_rank";
+
+// Enable or disable choosing the execution order of the nodes to reduce the peak memory of the intermediate tensors,
+// using their inferred sizes. The order is recorded in the node priorities, so if enabled and the execution order of
+// the session is ExecutionOrder::DEFAULT, the session uses ExecutionOrder::PRIORITY_BASED instead.
+// It runs with the graph optimizations of level ORT_ENABLE_ALL. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableMemoryAwareNodeOrder = "optimization.enable_memory_aware_node_order";
+
+// Enable or disable naming the dims that shape inference leaves unknown, e.g. the Concat of "seq" and 1 along a dim,
+// with affine expressions of the named dims of their inputs, such as "seq + 1". Buffers that are the same size as
+// expressions can then be reused by the memory planner even if the model has dynamic shapes.
+// "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableSymbolicShapePropagation =
+    "optimization.enable_symbolic_shape_propagation";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -96,6 +222,15 @@ static const char* const kOrtSessionOptionsMemoryOptimizerApplyConfig = "optimiz
 // Specifies the config for detecting subgraphs for memory footprint reduction.
 // The value should be a string contains int separated using commas. The default value is "0:0".
 static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimization.enable_memory_probe_recompute_config";
+
+// Specifies a memory budget in bytes to apply the memory optimizations to graphs without a YieldOp, e.g. inference.
+// The activations consumed long after they are produced are recomputed close to their late consumers, for the
+// subgraphs enabled in the "optimization.memory_optimizer_config" file and starting from the largest ones, until the
+// estimated size of the remaining long-lived activations fits in the budget. "0" recomputes all enabled subgraphs.
+// The sizes are estimated from the inferred shapes, counting dims that are not statically known as 1.
+// The default value is "-1", which disables the memory optimizations for such graphs. The training graphs of the
+// training API have no YieldOp either, the default value is "0" for them when a memory_optimizer_config is given.
+static const char* const kOrtSessionOptionsMemoryOptimizerInferenceBudget = "optimization.memory_optimizer_inference_budget";
 #endif
 
 // This setting if set should contain a comma separated list of optimizers names that should be disabled.
@@ -111,6 +246,111 @@ static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimiz
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Stream the large weights of the CUDA and ROCm nodes from host memory instead of keeping them on the device, to run
+// models that do not fit in the device memory. "1": enable; "0": disable. The default is "0".
+// The weight inputs (1MB or more) of MatMul, Gemm, Conv, ConvTranspose and Gather are kept in pinned host memory and
+// copied to the device ahead of each use, the copy is released once its consumer ran. The copies overlap with the
+// computation when session.max_streams_per_device is more than 1.
+static const char* const kOrtSessionOptionsStreamInitializersFromHost = "session.stream_initializers_from_host";
+
+// Maximum number of memory patterns a session keeps when memory pattern is enabled. Each distinct set of input shapes
+// gets its own pattern, and the least recently used pattern is dropped once the limit is reached.
+// The value is a non-negative integer. "0" (the default) means the number of patterns is not limited.
+static const char* const kOrtSessionOptionsMemoryPatternCacheSize = "session.memory_pattern_cache_size";
+
+// Rounds input dimensions up to a multiple of this value when looking up a memory pattern, so inputs with similar
+// shapes (e.g. varying sequence lengths) share a pattern planned for the largest shape seen in the bucket.
+// Tensors may then use only part of the block that was planned for them, trading some memory for fewer re-plans.
+// The value is a non-negative integer. "0" or "1" (the default is "0") means shapes have to match exactly.
+static const char* const kOrtSessionOptionsMemoryPatternShapeBucketSize = "session.memory_pattern_shape_bucket_size";
+
+// Freezes the memory pattern of each set of input shapes once it is planned. Runs with the same input shapes then
+// place planned tensors with a precomputed table instead of looking up their blocks, and take over the pattern
+// buffers of earlier runs instead of allocating new ones.
+// Only applies if memory patterns are enabled, shape buckets are not used and all patterned memory is on CPU.
+// Pattern buffers are kept until the session is destroyed, one set per concurrently executing run.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigFreezeStaticShapePlan = "session.freeze_static_shape_plan";
+
+// Enables dynamic batching of RunAsync calls. Concurrent RunAsync calls with the same input and output names and
+// compatible CPU input tensors are concatenated along dim 0, run once and their outputs are split again.
+// Only calls without run options, or with default run options, are batched. Inputs are not padded.
+// The value is the maximum number of rows (the sum of the dim 0 of the batched requests) of a batched run.
+// "0" (the default) disables dynamic batching.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize =
+    "session.dynamic_batching_max_batch_size";
+
+// Used with session.dynamic_batching_max_batch_size. The maximum time in microseconds a request waits for other
+// requests to form a batch with. The default is "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicroseconds =
+    "session.dynamic_batching_max_wait_us";
+
+// Runs a session using graph capture (e.g. enable_cuda_graph of the CUDA EP) with inputs of varying shapes by
+// rounding the dims named by some dim_params of the model inputs up to bucket sizes. The inputs are zero padded into
+// buffers kept per combination of padded shapes, each of which is captured once as its own graph and then replayed,
+// and the output dims named by the same dim_params are cropped back. The padding has to be neutral for the model,
+// e.g. masked by a padded attention mask. Runs with larger dims or non CPU inputs, and runs after 32 graphs were
+// captured, execute without graph capture. Only applies to calls of Run without IOBinding or graph annotation
+// (gpu_graph_id), and their outputs are returned on the CPU.
+// The value lists the increasing bucket sizes of every dim_param, e.g. "sequence:64,128,256,512;batch:1,2,4,8".
+// Empty (the default) disables it.
+static const char* const kOrtSessionOptionsConfigGraphCaptureShapeBuckets = "session.graph_capture_shape_buckets";
+
+// The maximum number of RunAsync calls of a session that execute at the same time. Further calls are queued and
+// started in the order of their priority (run.priority), then in the order they were made.
+// "0" (the default) means the number is not limited and calls are started in the order they were made.
+static const char* const kOrtSessionOptionsConfigMaxConcurrentAsyncRuns = "session.max_concurrent_async_runs";
+
+// Records the latency of every node, and of every op type, in histograms that are kept for the lifetime of the
+// session. They are returned, together with allocator and thread pool counters, by the SessionGetMetrics API.
+// Unlike profiling this does not write a file and can stay enabled in production.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigEnableMetrics = "session.enable_metrics";
+
+// Adds a memory timeline to the profile written when profiling is enabled. After every node the bytes of the live
+// tensors and the bytes in use of every allocator are recorded per device as chrome trace counter events, and the
+// arena extensions caused by the node are recorded as node events. At the end of every run the tensors that were
+// live at the peak are reported, largest first, in a "memory_peak" session event and in the session log.
+// Walks all the values of the execution frame after every node, so it slows down the run.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigProfileMemory = "session.profile_memory";
+
+// Emits NVTX ranges, which Nsight Systems shows next to the CUDA activity, for the runs, the nodes, the memcpy nodes,
+// the arena extensions, the CUDA graph captures and replays, and the steps of beam and greedy search. The boundaries
+// between the partitions of the execution providers are NVTX markers. Every run gets a correlation id that is the
+// payload of its ranges and the correlation_id arg of its node events when the session is profiled as well.
+// NVTX is process wide, so the ranges stay enabled for all sessions once a session enables them. Needs the CUDA
+// execution provider, which makes the NVTX calls. Builds with the onnxruntime_ENABLE_NVTX_PROFILE option enable it.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigEnableNvtxRanges = "session.enable_nvtx_ranges";
+
+// Sampled profiling for production: instead of every run, only some runs are profiled, and their events are handed
+// to the callback set with SessionSetProfilingSampleCallback instead of being written to a file.
+// Can't be combined with enable_profiling.
+// Profile one run out of every N runs. "0" (the default) means runs are not sampled by count.
+static const char* const kOrtSessionOptionsConfigProfilingSampleEveryNRuns = "session.profiling_sample_every_n_runs";
+
+// Hand over the profile of the runs that take at least this many milliseconds. As a run is only known to be slow
+// when it ends, all runs are recorded when it is set. "0" (the default) means runs are not sampled by latency.
+static const char* const kOrtSessionOptionsConfigProfilingSampleLatencyThresholdMs =
+    "session.profiling_sample_latency_threshold_ms";
+
+// The number of events kept for the sampled runs, the oldest events are overwritten. Default is "100000".
+static const char* const kOrtSessionOptionsConfigProfilingSampleBufferSize = "session.profiling_sample_buffer_size";
+
+// Adds the hardware performance counters (PMU) of every node to its "_kernel_time" event in the profile: cycles,
+// instructions, last level cache misses and data TLB misses. They are read with perf_event_open on Linux, for all
+// the threads of the process when the session is initialized, e.g. the intra-op threads, so concurrent runs are
+// counted together. If the kernel doesn't allow it (see /proc/sys/kernel/perf_event_paranoid) a warning is logged.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigProfileHardwareCounters = "session.profile_hardware_counters";
+
+// The raw PMU event that counts floating point operations on the CPU, as the perf_event_attr.config of a
+// PERF_TYPE_RAW event, e.g. "0x4c7" (decimal, or hexadecimal with a 0x prefix). As there is no generic event for
+// them, they are only counted if it is set. Used with session.profile_hardware_counters.
+static const char* const kOrtSessionOptionsConfigProfileHardwareCountersFpEvent =
+    "session.profile_hardware_counters_fp_event";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
@@ -131,10 +371,24 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 /// Requires `session.use_ort_model_bytes_directly` to be true.
 /// If set, the flatbuffer bytes provided when creating the InferenceSession MUST remain valid for the entire
 /// duration of the InferenceSession.
+/// When the InferenceSession is created from an ORT format model file, the file is memory mapped for the duration
+/// of the InferenceSession instead, and `session.use_ort_model_bytes_directly` is not required.
 /// </summary>
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+/// <summary>
+/// Key for using memory mapped external data files directly for CPU initializers.
+/// This is the ONNX format counterpart of `session.use_ort_model_bytes_for_initializers`: the initializers of a
+/// model with external data are backed by the mapped pages of the data file, so no memory is allocated for them,
+/// loading doesn't wait for the file to be read, and the page cache is shared by all processes using the file.
+/// It only applies to initializers whose data offset is aligned for their element type (and on big-endian
+/// platforms, only to single byte element types). Other initializers are copied into allocated memory.
+/// "1": default, use the mapped external data directly. "0": always copy external data into allocated memory.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigUseMappedExternalInitializers =
+    "session.use_mapped_external_initializers";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -176,6 +430,14 @@ static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "e
 // Available since version 1.11.
 static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dynamic_block_base";
 
+// Enables adaptive block sizing for the parallel loops of the intra-op thread pool.
+// The cost per iteration of every loop is measured when it runs, per loop body and per order of magnitude of the
+// number of iterations. Later runs of the loop decide whether to parallelize and how large to make the blocks from
+// the measured cost instead of the cost estimated by the kernel. If session.dynamic_block_base is also set, the
+// measured cost decides whether to parallelize and the blocks then shrink with the remaining iterations.
+// "0": disabled (default). "1": enabled.
+static const char* const kOrtSessionOptionsConfigAdaptiveBlockSizing = "session.adaptive_block_sizing";
+
 // This option allows to decrease CPU usage between infrequent
 // requests and forces any TP threads spinning stop immediately when the last of
 // concurrent Run() call returns.
@@ -197,6 +459,24 @@ static const char* const kOrtSessionOptionsConfigStrictAllowReleasedOpsetsOnly =
 // The file saves configuration for partitioning node among logic streams
 static const char* const kNodePartitionConfigFile = "session.node_partition_config_file";
 
+// The maximum number of streams the nodes assigned to a non CPU device, e.g. a CUDA GPU, are partitioned into when
+// session.node_partition_config_file does not give the partition. Independent branches of the graph, e.g. the heads
+// of an ensemble, are then put in different streams to run concurrently, and the streams are synchronized with events
+// where a node consumes the output of another stream. Only takes effect in builds with stream support, and is ignored
+// when graph capture is enabled.
+// "1" (the default) puts the nodes of each device in one stream.
+static const char* const kOrtSessionOptionsConfigMaxStreamsPerDevice = "session.max_streams_per_device";
+
+// Copy the CPU inputs given to Run to a device, e.g. a CUDA GPU, and the outputs back to the CPU through buffers of
+// pinned memory of the device's execution provider instead of copying from and to the pageable memory of the caller.
+// The inputs are staged in chunks, each uploaded asynchronously while the next one is staged, so the upload overlaps
+// the staging and the first kernels are queued as soon as their inputs are. The downloads of all the outputs are queued
+// first, and each output is copied to the caller as soon as it arrived. Only takes effect in builds with stream
+// support, for inputs and outputs of at least 64KB.
+// "0": copy from and to pageable memory. [DEFAULT]
+// "1": stage the copies in pinned memory.
+static const char* const kOrtSessionOptionsConfigStageCopiesInPinnedMemory = "session.stage_copies_in_pinned_memory";
+
 // This Option allows setting affinities for intra op threads.
 // Affinity string follows format:
 // logical_processor_id,logical_processor_id;logical_processor_id,logical_processor_id
@@ -214,6 +494,40 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Runs the session on one NUMA node, so a process can run one session per socket.
+// The value is the 0-based NUMA node number. The default "-1" means no NUMA placement.
+// When set:
+// 1. The intra-op threads are pinned to the physical cores of the node, one thread per core, unless
+//    session.intra_op_thread_affinities is set. If intra_op_num_threads is 0, one thread per core of the node is created.
+// 2. The memory of the default CPU execution provider's allocator is placed on the node.
+// The option is ignored, with a warning, if the NUMA topology can't be determined on the platform.
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
+
+// Keeps the intra-op threads on the performance cores (P-cores) of a hybrid CPU, so latency critical sessions are not
+// slowed down by work running on the efficiency cores.
+// "0": default, the threads may run on any core. "1": one thread is pinned to each performance core.
+// Combined with session.numa_node, only the performance cores of the node are used. If intra_op_num_threads is 0,
+// one thread per performance core is created. Ignored if session.intra_op_thread_affinities is set, and ignored with
+// a warning if the CPU is not hybrid or its core types can't be determined.
+static const char* const kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly = "session.intra_op_performance_cores_only";
+
+// Limits the number of threads, counting the thread calling Run, that the parallel loops of the kernels of a run
+// may use. This is intended for sessions sharing the global intra-op thread pool, so that a heavy model doesn't take
+// all of its threads from the other sessions. In the parallel execution mode, it only applies to the kernels run by
+// the thread calling Run.
+// The default "0" leaves the degree of parallelism of the pool.
+static const char* const kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism =
+    "session.intra_op_max_degree_of_parallelism";
+
+// Runs the parallel loops of the kernels of a run in a single parallel section of the intra-op thread pool, so the
+// workers stay engaged from one kernel to the next instead of being handed new tasks for every loop, and each worker
+// tends to process the same slice of the tensors of consecutive loops.
+// The workers spin between the loops of the section, including while the kernels without parallel loops run, so this
+// suits models made mostly of short parallel kernels on a pool that the session does not share with others. In the
+// parallel execution mode, it only applies to the kernels run by the thread calling Run.
+// "0": default, each parallel loop dispatches its own tasks. "1": a parallel section is opened for each run.
+static const char* const kOrtSessionOptionsConfigParallelSectionPerRun = "session.parallel_section_per_run";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -269,12 +583,139 @@ static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed
 // in case user need to merge/connect multiple EPContext nodes in one model
 static const char* const kOrtSessionOptionEpContextNodeNamePrefix = "ep.context_node_name_prefix";
 
+// Share the EP contexts between the sessions that set this option, e.g. the sessions of the prefill and decode
+// graphs of a model whose EPContext nodes point to one context binary. The graphs of a context binary that are not
+// used by the session loading it are kept for the next sessions, so the binary is loaded once and its weights are
+// shared by all its graphs.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_contexts";
+
+// The directory that the partitions compiled by the EPs of the session are cached in. The next sessions that set
+// the same directory load the compiled partitions of the same model, EP and EP options instead of compiling them
+// again. A cached partition is identified by the ORT version, the EP, its options and the content of the partition,
+// so a change of any of them compiles the partition again. The EPs that don't cache compiled partitions ignore it.
+// Default is empty, which disables the cache.
+static const char* const kOrtSessionOptionsEpCompiledPartitionCacheDir = "ep.compiled_partition_cache_dir";
+
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// Gemm fastmath mode on x86-64 processors with AMX-BF16 (e.g. Sapphire Rapids). fp32 MatMul is computed with bfloat16
+// operands and fp32 accumulation; the weights are converted and packed once. It is ignored on other processors.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathAmxBfloat16 = "mlas.enable_gemm_fastmath_amx_bfloat16";
+
+// Output tile of the Winograd algorithm used by the CPU Conv for 3x3 stride 1 convolutions with constant weights and
+// at least 16 input and output channels per group. Larger tiles do fewer multiplies but lose more fp32 accuracy:
+// F(2x2, 3x3) stays close to the GEMM based algorithms, F(4x4, 3x3) has errors around 1e-5 and F(6x6, 3x3) around
+// 1e-4 relative to the magnitude of the accumulations.
+// Option values:
+// - "0": Winograd is not used. [DEFAULT]
+// - "2", "4", "6": the F(2x2, 3x3), F(4x4, 3x3) or F(6x6, 3x3) output tile.
+static const char* const kOrtSessionOptionsMlasConvWinogradTile = "mlas.conv_winograd_tile";
+
+// Use the direct convolution kernel for the CPU QLinearConv with 3x3 and 5x5 2D filters that do not take the symmetric
+// (MlasConvSym) path. The input is read in place instead of being expanded by im2col, which avoids the temporary
+// column buffer of kernel_size * input_channels bytes per output pixel. The results are identical.
+// Option values:
+// - "0": the im2col and QGEMM path is used. [DEFAULT]
+// - "1": the direct convolution kernel is used.
+static const char* const kOrtSessionOptionsMlasQLinearConvDirect = "mlas.qlinearconv_direct";
+
+// Generate an x86-64 FMA3 SGEMM kernel specialized for the shape of each constant, pre-packed 2D B of the CPU MatMul.
+// The loop bounds and packed B offsets are fixed at kernel creation, which removes the per call blocking logic of the
+// generic kernel and helps small and skinny products the most. Kernels are shared by all MatMul nodes with the same
+// B shape. Other platforms and shapes use the generic kernel.
+// Option values:
+// - "0": the generic SGEMM kernel is used. [DEFAULT]
+// - "1": generated kernels are used where supported.
+static const char* const kOrtSessionOptionsMlasSgemmJit = "mlas.sgemm_jit";
+
+// Multiply the constant 2D B of the CPU MatMul with a block sparse kernel when at least this fraction of its 1x16
+// blocks (one row of K by 16 columns of N) are all zero, as in models pruned by input channels or by groups of output
+// channels. The zero blocks are skipped. The results match the dense kernel up to the float summation order.
+// Option values:
+// - "0": the dense SGEMM kernel is always used. [DEFAULT]
+// - a value in (0, 1], e.g. "0.7": the minimum fraction of zero blocks. Below about 0.5 the dense kernel is faster.
+static const char* const kOrtSessionOptionsMlasSparseSgemmMinSparsity = "mlas.sparse_sgemm_min_sparsity";
+
+// Quantize each block of rows of A of the CPU DynamicQuantizeMatMul with its own scale and zero point instead of those
+// of the whole tensor. A is then read once: every thread finds the range of its block, quantizes it into a buffer that
+// stays in the cache and multiplies it. The results are usually more accurate but depend on the number of threads.
+// Only inputs with a single product and at least 16 rows per thread of the intra-op thread pool are quantized by blocks,
+// the others use a single scale and zero point. With the default the blocks are quantized and multiplied the same way
+// after the range of the whole tensor is found, and the results are identical to those of the unfused kernel.
+// Option values:
+// - "0": a single scale and zero point is used for A. [DEFAULT]
+// - "1": a scale and zero point is used per block of rows of A.
+static const char* const kOrtSessionOptionsMlasDynamicQuantizeMatMulBlockScale =
+    "mlas.dynamic_quantize_matmul_block_scale";
+
+// Multiply the outlier channels of A of the CPU 4-bit MatMulNBits with accuracy_level 4 (int8 compute) in float.
+// A channel is a column of A, and it is an outlier in a run if one of its values has a magnitude of at least the
+// threshold; at most K / 16 channels with the largest magnitudes are outliers. The outlier channels are set to zero
+// before A is quantized to int8, so they don't inflate the scales of their blocks, and are multiplied with the
+// dequantized rows of B in float. This recovers most of the accuracy lost to int8 on models with a few large
+// activation channels, e.g. LLMs. B is then kept next to its packed copy, which doubles its memory.
+// Option values:
+// - "0": all channels are quantized to int8. [DEFAULT]
+// - a positive threshold, e.g. "6".
+static const char* const kOrtSessionOptionsMlasMatMulNBitsInt8OutlierThreshold =
+    "mlas.matmul_nbits_int8_outlier_threshold";
+
+// Copy the decision nodes of the CPU TreeEnsembleRegressor and TreeEnsembleClassifier kernels into a compact depth
+// first layout with 16-bit feature ids when the session is created, so that large ensembles are more likely to fit in
+// the caches. The thresholds can also be replaced by their index among the distinct thresholds of their feature, and
+// the features of every row then by the number of thresholds below them, which gives 8-byte nodes.
+// The results are identical. Ensembles whose nodes do not all use the same mode keep the usual layout.
+// Option values:
+// - "0": the usual layout is used. [DEFAULT]
+// - "1": the compact layout is used.
+// - "2": the compact layout with binned thresholds is used. Ensembles whose nodes use BRANCH_EQ or BRANCH_NEQ, or that
+//        have 65535 distinct thresholds or more for a feature, fall back to "1".
+static const char* const kOrtSessionOptionsTreeEnsembleCompactLayout = "session.tree_ensemble_compact_layout";
+
+// Load the large initializers of an ONNX model file in place. Only the graph structure is parsed when the model is
+// loaded, and the raw data of the initializers of the main graph is referenced as external data in the model file,
+// which is mapped into memory when the session is initialized. This avoids holding a copy of the initializer data in
+// the parsed model while the initializers are created, which can double the peak memory usage of a session.
+// Only applies to models loaded from a file path, and is ignored when an optimized model is saved.
+// Option values:
+// - "0": the whole model is parsed. [DEFAULT]
+// - "1": the large initializers are loaded in place.
+static const char* const kOrtSessionOptionsLoadInitializersInPlace = "session.load_initializers_in_place";
+
+// Minimum number of nodes of a partition of an execution provider other than the CPU EP.
+// Graph partitioning assigns nodes greedily in the order of the execution providers, which can leave small islands of
+// nodes on a device, each needing copies of its inputs and outputs between the device and the host. With this option,
+// the fused partitions with fewer nodes, and the groups of connected single nodes with fewer nodes, are left to the
+// next execution providers and the CPU EP instead. Nodes the CPU EP has no kernel for stay with their EP.
+// Only applies to ONNX format models, and not to execution providers with a NHWC preferred layout.
+// Option values:
+// - "0": partitions are not filtered by size. [DEFAULT]
+// - "N": partitions of fewer than N nodes are not assigned to the EP.
+static const char* const kOrtSessionOptionsMinDevicePartitionSize = "session.min_device_partition_size";
+
+// Records the inputs of sampled runs as test data sets that onnxruntime_perf_test and onnx_test_runner can replay,
+// e.g. to benchmark with the shapes of production traffic. The value is the directory the test data sets are
+// written to, as <directory>/test_data_set_<n>/input_<i>.pb. Only runs that succeed are recorded, and only if all
+// their inputs are CPU tensors. The inputs are written by the thread of the run.
+// Empty (the default) disables the recording.
+static const char* const kOrtSessionOptionsRecordInputsDirectory = "session.record_inputs_directory";
+
+// Used with session.record_inputs_directory. The inputs of one run in every N are recorded. The default is "100".
+static const char* const kOrtSessionOptionsRecordInputsEveryNRuns = "session.record_inputs_every_n_runs";
+
+// Used with session.record_inputs_directory. The maximum number of test data sets recorded by a session.
+// The default is "1000".
+static const char* const kOrtSessionOptionsRecordInputsMaxSamples = "session.record_inputs_max_samples";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
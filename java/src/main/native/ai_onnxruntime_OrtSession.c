@@ -455,6 +455,199 @@ cleanup_input_names:
   return outputArray;
 }
 
+/*
+ * The names and the native arrays of runs with a fixed set of inputs and outputs, created once by createRunContext
+ * so that runWithContext neither converts the Java name strings nor allocates per call. The scratch arrays are
+ * reused, so a context is used by one thread at a time. The Java side keeps a pool of contexts, and of the
+ * preallocated output values, for concurrent callers.
+ */
+typedef struct OrtJniRunContext {
+  size_t numInputs;
+  size_t numOutputs;
+  char** inputNames;
+  char** outputNames;
+  const OrtValue** inputValues;
+  OrtValue** outputValues;
+  jlong* handleScratch;
+} OrtJniRunContext;
+
+static void freeRunContext(OrtJniRunContext* context) {
+  if (context->inputNames != NULL) {
+    for (size_t i = 0; i < context->numInputs; i++) {
+      free(context->inputNames[i]);
+    }
+  }
+  if (context->outputNames != NULL) {
+    for (size_t i = 0; i < context->numOutputs; i++) {
+      free(context->outputNames[i]);
+    }
+  }
+  free(context->inputNames);
+  free(context->outputNames);
+  free((void*)context->inputValues);
+  free(context->outputValues);
+  free(context->handleScratch);
+  free(context);
+}
+
+// Copies the UTF-8 form of the Java strings, returns 0 and throws OutOfMemoryError on failure.
+static int copyJavaStrings(JNIEnv* jniEnv, jobjectArray javaStrings, size_t numStrings, char** output) {
+  for (size_t i = 0; i < numStrings; i++) {
+    jobject javaString = (*jniEnv)->GetObjectArrayElement(jniEnv, javaStrings, (jsize)i);
+    const char* utf8 = (*jniEnv)->GetStringUTFChars(jniEnv, javaString, NULL);
+    if (utf8 == NULL) {
+      return 0;
+    }
+    size_t length = strlen(utf8);
+    output[i] = malloc(length + 1);
+    if (output[i] != NULL) {
+      memcpy(output[i], utf8, length + 1);
+    }
+    (*jniEnv)->ReleaseStringUTFChars(jniEnv, javaString, utf8);
+    (*jniEnv)->DeleteLocalRef(jniEnv, javaString);
+    if (output[i] == NULL) {
+      throwOrtException(jniEnv, convertErrorCode(ORT_FAIL), "Failed to allocate the name of a run context.");
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    createRunContext
+ * Signature: ([Ljava/lang/String;[Ljava/lang/String;)J
+ * private static native long createRunContext(String[] inputNamesArray, String[] outputNamesArray) throws OrtException;
+ */
+JNIEXPORT jlong JNICALL Java_ai_onnxruntime_OrtSession_createRunContext(JNIEnv* jniEnv, jclass jclazz,
+                                                                       jobjectArray inputNamesArr,
+                                                                       jobjectArray outputNamesArr) {
+  (void)jclazz;  // Required JNI parameter not needed by functions which don't need to access their host object.
+  OrtJniRunContext* context = calloc(1, sizeof(OrtJniRunContext));
+  if (context == NULL) {
+    throwOrtException(jniEnv, convertErrorCode(ORT_FAIL), "Failed to allocate a run context.");
+    return (jlong)NULL;
+  }
+  context->numInputs = (size_t)(*jniEnv)->GetArrayLength(jniEnv, inputNamesArr);
+  context->numOutputs = (size_t)(*jniEnv)->GetArrayLength(jniEnv, outputNamesArr);
+
+  // The names are zero initialized so that a partially filled context can be freed.
+  context->inputNames = calloc(context->numInputs + 1, sizeof(char*));
+  context->outputNames = calloc(context->numOutputs + 1, sizeof(char*));
+  context->inputValues = allocarray(context->numInputs + 1, sizeof(OrtValue*));
+  context->outputValues = allocarray(context->numOutputs + 1, sizeof(OrtValue*));
+  size_t maxHandles = context->numInputs > context->numOutputs ? context->numInputs : context->numOutputs;
+  context->handleScratch = allocarray(maxHandles + 1, sizeof(jlong));
+  if (context->inputNames == NULL || context->outputNames == NULL || context->inputValues == NULL ||
+      context->outputValues == NULL || context->handleScratch == NULL) {
+    freeRunContext(context);
+    throwOrtException(jniEnv, convertErrorCode(ORT_FAIL), "Failed to allocate a run context.");
+    return (jlong)NULL;
+  }
+
+  if (!copyJavaStrings(jniEnv, inputNamesArr, context->numInputs, context->inputNames) ||
+      !copyJavaStrings(jniEnv, outputNamesArr, context->numOutputs, context->outputNames)) {
+    freeRunContext(context);
+    return (jlong)NULL;
+  }
+
+  return (jlong)context;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    runWithContext
+ * Signature: (JJJJ[J[Lai/onnxruntime/OnnxValue;[JJ)[Z
+ * private native boolean[] runWithContext(long apiHandle, long nativeHandle, long allocatorHandle,
+ *                                         long runContextHandle, long[] inputs,
+ *                                         OnnxValue[] outputValues, long[] outputHandles,
+ *                                         long runOptionsHandle) throws OrtException;
+ *
+ * As run, with the input and output names of the context. Outputs with a preallocated value in outputValues (e.g. a
+ * tensor over a direct ByteBuffer) are written in place, the others are returned as new values owned by ORT.
+ */
+JNIEXPORT jbooleanArray JNICALL Java_ai_onnxruntime_OrtSession_runWithContext(JNIEnv* jniEnv, jobject jobj,
+                                                                             jlong apiHandle, jlong sessionHandle,
+                                                                             jlong allocatorHandle,
+                                                                             jlong runContextHandle,
+                                                                             jlongArray tensorArr,
+                                                                             jobjectArray outputValuesArr,
+                                                                             jlongArray outputHandlesArr,
+                                                                             jlong runOptionsHandle) {
+  (void)jobj;  // Required JNI parameter not needed by functions which don't need to access their host object.
+  const OrtApi* api = (const OrtApi*)apiHandle;
+  OrtAllocator* allocator = (OrtAllocator*)allocatorHandle;
+  OrtSession* session = (OrtSession*)sessionHandle;
+  OrtRunOptions* runOptions = (OrtRunOptions*)runOptionsHandle;
+  OrtJniRunContext* context = (OrtJniRunContext*)runContextHandle;
+  const size_t numInputs = context->numInputs;
+  const size_t numOutputs = context->numOutputs;
+
+  // The Java-side objects store native pointers as 64-bit longs, so they are copied applying the appropriate cast.
+  // GetLongArrayRegion throws if the handle arrays are too short.
+  (*jniEnv)->GetLongArrayRegion(jniEnv, tensorArr, 0, (jsize)numInputs, context->handleScratch);
+  if ((*jniEnv)->ExceptionCheck(jniEnv)) {
+    return NULL;
+  }
+  for (size_t i = 0; i < numInputs; i++) {
+    context->inputValues[i] = (const OrtValue*)context->handleScratch[i];
+  }
+  (*jniEnv)->GetLongArrayRegion(jniEnv, outputHandlesArr, 0, (jsize)numOutputs, context->handleScratch);
+  if ((*jniEnv)->ExceptionCheck(jniEnv)) {
+    return NULL;
+  }
+  for (size_t i = 0; i < numOutputs; i++) {
+    context->outputValues[i] = (OrtValue*)context->handleScratch[i];
+  }
+
+  OrtErrorCode code = checkOrtStatus(jniEnv, api, api->Run(session, runOptions,
+                                                           (const char* const*)context->inputNames,
+                                                           (const OrtValue* const*)context->inputValues, numInputs,
+                                                           (const char* const*)context->outputNames, numOutputs,
+                                                           context->outputValues));
+  if (code != ORT_OK) {
+    return NULL;
+  }
+
+  // Create the output boolean array denoting if ORT owns the memory for each output.
+  // Java boolean arrays are initialized to false.
+  jbooleanArray outputArray = (*jniEnv)->NewBooleanArray(jniEnv, safecast_size_t_to_jsize(numOutputs));
+  if (outputArray == NULL) {
+    return NULL;
+  }
+  jboolean* boolArr = (*jniEnv)->GetBooleanArrayElements(jniEnv, outputArray, NULL);
+
+  // Convert the outputs that were not preallocated into ONNXValues
+  for (size_t i = 0; i < numOutputs; i++) {
+    if (context->outputValues[i] != NULL &&
+        (*jniEnv)->GetObjectArrayElement(jniEnv, outputValuesArr, (jsize)i) == NULL) {
+      jobject onnxValue = convertOrtValueToONNXValue(jniEnv, api, allocator, context->outputValues[i]);
+      if (onnxValue == NULL) {
+        break;  // exception thrown
+      }
+      boolArr[i] = 1;
+      (*jniEnv)->SetObjectArrayElement(jniEnv, outputValuesArr, (jsize)i, onnxValue);
+    }
+  }
+
+  // Write the output array back to Java.
+  (*jniEnv)->ReleaseBooleanArrayElements(jniEnv, outputArray, boolArr, 0);
+
+  return outputArray;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession
+ * Method:    closeRunContext
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_closeRunContext(JNIEnv* jniEnv, jclass jclazz,
+                                                                     jlong runContextHandle) {
+  (void)jniEnv;
+  (void)jclazz;  // Required JNI parameters not needed by functions which don't need to access their host object.
+  freeRunContext((OrtJniRunContext*)runContextHandle);
+}
+
 /*
  * Class:     ai_onnxruntime_OrtSession
  * Method:    getProfilingStartTimeInNs
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -243,5 +245,61 @@ T* ConcatStateChunkGQA(const T* past,
   return start;
 }
 
+// Quantized KV cache rows. A row holds the head_size values of one token of one kv head, either as int8 or as packed
+// signed int4 with the even element in the low nibble. The scales are static per kv head and per block of
+// block_size consecutive elements of the row, so dequantization can be factored out of the sums over tokens.
+inline size_t QuantizedKVCacheRowBytes(int head_size, int bit_width) {
+  return bit_width == 4 ? static_cast<size_t>(head_size) / 2 : static_cast<size_t>(head_size);
+}
+
+inline void QuantizeKVCacheRow(const float* input, const float* scales, int block_size, int head_size, int bit_width,
+                               uint8_t* output) {
+  const float max_value = bit_width == 4 ? 7.0f : 127.0f;
+  const float min_value = bit_width == 4 ? -8.0f : -127.0f;
+  for (int h = 0; h < head_size; h++) {
+    const float scale = scales[h / block_size];
+    const float value = scale == 0.0f ? 0.0f : std::nearbyint(input[h] / scale);
+    const int8_t quantized = static_cast<int8_t>(std::min(std::max(value, min_value), max_value));
+    if (bit_width == 8) {
+      output[h] = static_cast<uint8_t>(quantized);
+    } else if (h % 2 == 0) {
+      output[h / 2] = static_cast<uint8_t>(quantized & 0x0F);
+    } else {
+      output[h / 2] |= static_cast<uint8_t>(quantized << 4);
+    }
+  }
+}
+
+inline int8_t QuantizedKVCacheValue(const uint8_t* row, int h, int bit_width) {
+  if (bit_width == 8) {
+    return static_cast<int8_t>(row[h]);
+  }
+  // shift the nibble to the top of the byte and sign extend it back down
+  const uint8_t packed = row[h / 2];
+  return static_cast<int8_t>(static_cast<int8_t>(h % 2 == 0 ? packed << 4 : packed) >> 4);
+}
+
+// Returns the dot product of `q` with the dequantized row.
+inline float DotQuantizedKVCacheRow(const float* q, const uint8_t* row, const float* scales, int block_size,
+                                    int head_size, int bit_width) {
+  float sum = 0.0f;
+  for (int block_start = 0; block_start < head_size; block_start += block_size) {
+    float block_sum = 0.0f;
+    for (int h = block_start; h < block_start + block_size; h++) {
+      block_sum += q[h] * static_cast<float>(QuantizedKVCacheValue(row, h, bit_width));
+    }
+    sum += block_sum * scales[block_start / block_size];
+  }
+  return sum;
+}
+
+// Accumulates weight * row into `output` without applying the scales.
+inline void AccumulateQuantizedKVCacheRow(float weight, const uint8_t* row, int head_size, int bit_width,
+                                          float* output) {
+  for (int h = 0; h < head_size; h++) {
+    output[h] += weight * static_cast<float>(QuantizedKVCacheValue(row, h, bit_width));
+  }
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -10,6 +10,12 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env_var_utils.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -33,6 +39,9 @@ class GQAAttentionBase {
     use_smooth_softmax_ = info.GetAttrOrDefault<int64_t>("smooth_softmax", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -44,6 +53,9 @@ class GQAAttentionBase {
 
   bool use_smooth_softmax_;
 
+  bool disable_flash_;
+  int l2_cache_size_;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
@@ -71,6 +83,13 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && !use_smooth_softmax_ && l2_cache_size_ > 0) {
+        return ApplyFlashAttention(Q, K, V, past_key, past_value, output, present_key, present_value, seqlens_k,
+                                   parameters, seqlen_past_kv_cache, seqlen_present_kv_cache, allocator, tp);
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
@@ -98,7 +117,288 @@ class GQAAttentionBase {
     return Status::OK();
   }
 
+  // Computes the attention with an int8 or packed int4 k-v cache (see QuantizeKVCacheRow). The new key and value
+  // are quantized with the static scales when they are appended to the present buffers, and the cache is dequantized
+  // inside the attention loops, so the per-token cost of reading the cache is 1 or 1/2 byte per element.
+  Status ApplyQuantizedKVAttention(const float* Q,                            // Q data with shape BxNxSxH
+                                   const float* K,                            // K data with shape BxN_kvxSxH
+                                   const float* V,                            // V data with shape BxN_kvxSxH
+                                   const Tensor* past_key,                    // past K input tensor
+                                   const Tensor* past_value,                  // past V input tensor
+                                   Tensor* output,                            // output tensor
+                                   Tensor* present_key,                       // present K output tensor
+                                   Tensor* present_value,                     // present V output tensor
+                                   const Tensor* seqlens_k,                   // past sequence lengths tensor
+                                   const float* k_scale,                      // key scales with shape N_kv x blocks
+                                   const float* v_scale,                      // value scales with shape N_kv x blocks
+                                   int scale_block_count,                     // number of scale blocks per row
+                                   int kv_cache_bit_width,                    // 8 or 4
+                                   GroupQueryAttentionParameters& parameters,  // attention parameters
+                                   OpKernelContext* context) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const bool is_prompt = sequence_length != 1;
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    const int scale_block_size = head_size / scale_block_count;
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    const int past_buffer_sequence_length =
+        past_key != nullptr ? static_cast<int>(past_key->Shape().GetDims()[2]) : 0;
+    const int present_buffer_sequence_length = static_cast<int>(present_key->Shape().GetDims()[2]);
+
+    const uint8_t* past_key_data = past_key != nullptr ? static_cast<const uint8_t*>(past_key->DataRaw()) : nullptr;
+    uint8_t* present_key_data = static_cast<uint8_t*>(present_key->MutableDataRaw());
+    const uint8_t* past_value_data =
+        past_value != nullptr ? static_cast<const uint8_t*>(past_value->DataRaw()) : nullptr;
+    uint8_t* present_value_data = static_cast<uint8_t*>(present_value->MutableDataRaw());
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const size_t row_bytes = QuantizedKVCacheRowBytes(head_size, kv_cache_bit_width);
+    const size_t past_buff_chunk_bytes = static_cast<size_t>(past_buffer_sequence_length) * row_bytes;
+    const size_t present_buff_chunk_bytes = static_cast<size_t>(present_buffer_sequence_length) * row_bytes;
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_bytes;
+      memset(present_key_data, 0, present_bytes);
+      memset(present_value_data, 0, present_bytes);
+    }
+
+    // Append the quantized key and value of each kv head to the present buffers.
+    TensorOpCost append_cost;
+    append_cost.bytes_loaded =
+        static_cast<double>(2 * input_chunk_length * sizeof(float) + 2 * present_buff_chunk_bytes);
+    append_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_bytes);
+    append_cost.compute_cycles = static_cast<double>(4 * input_chunk_length);
+
+    const float* k_input = packed_qkv ? Q + num_heads_ * input_chunk_length : K;
+    const float* v_input = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * input_chunk_length : V;
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, append_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / kv_num_heads_);
+            const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+            const int past_seqlen = is_prompt ? 0 : static_cast<int>(seqlens_k_data[batch_index]);
+            const size_t past_chunk_bytes = static_cast<size_t>(past_seqlen) * row_bytes;
+
+            uint8_t* present_k = present_key_data + i * present_buff_chunk_bytes;
+            uint8_t* present_v = present_value_data + i * present_buff_chunk_bytes;
+            if (!past_present_share_buffer && past_chunk_bytes > 0) {
+              memcpy(present_k, past_key_data + i * past_buff_chunk_bytes, past_chunk_bytes);
+              memcpy(present_v, past_value_data + i * past_buff_chunk_bytes, past_chunk_bytes);
+            }
+
+            const ptrdiff_t chunk_length = static_cast<ptrdiff_t>(input_chunk_length);
+            const ptrdiff_t input_offset =
+                packed_qkv ? packed_batch_stride * batch_index + chunk_length * kv_head_index : chunk_length * i;
+            const float* k_scale_head = k_scale + kv_head_index * scale_block_count;
+            const float* v_scale_head = v_scale + kv_head_index * scale_block_count;
+            for (int s = 0; s < sequence_length; s++) {
+              const size_t row_offset = past_chunk_bytes + s * row_bytes;
+              QuantizeKVCacheRow(k_input + input_offset + s * head_size, k_scale_head, scale_block_size, head_size,
+                                 kv_cache_bit_width, present_k + row_offset);
+              QuantizeKVCacheRow(v_input + input_offset + s * head_size, v_scale_head, scale_block_size, head_size,
+                                 kv_cache_bit_width, present_v + row_offset);
+            }
+          }
+        });
+
+    // Compute softmax(Q x K') x V one query row at a time, reading each cache row once per query row.
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    float* output_data = output->MutableData<float>();
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded =
+        static_cast<double>(input_chunk_length * sizeof(float) + 2 * sequence_length * present_buff_chunk_bytes);
+    unit_cost.bytes_stored = static_cast<double>(input_chunk_length * sizeof(float));
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          std::vector<float> scores(present_buffer_sequence_length);
+          std::vector<float> accumulator(head_size);
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / num_heads_);
+            const int head_index = static_cast<int>(i % num_heads_);
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k_data[batch_index] + 1;
+
+            const float* q = packed_qkv ? Q + packed_batch_stride * batch_index + input_chunk_length * head_index
+                                        : Q + input_chunk_length * i;
+            const ptrdiff_t kv_head = SafeInt<ptrdiff_t>(batch_index) * kv_num_heads_ + kv_head_index;
+            const uint8_t* k = present_key_data + kv_head * present_buff_chunk_bytes;
+            const uint8_t* v = present_value_data + kv_head * present_buff_chunk_bytes;
+            const float* k_scale_head = k_scale + kv_head_index * scale_block_count;
+            const float* v_scale_head = v_scale + kv_head_index * scale_block_count;
+
+            for (int seq = 0; seq < sequence_length; seq++) {
+              const int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
+              const int window_start = (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1)
+                                           ? seq_causal_length - local_window_size_ - 1
+                                           : 0;
+              const int window_length = seq_causal_length - window_start;
+
+              const float* q_row = q + seq * head_size;
+              for (int t = window_start; t < seq_causal_length; t++) {
+                scores[t] = alpha * DotQuantizedKVCacheRow(q_row, k + t * row_bytes, k_scale_head, scale_block_size,
+                                                           head_size, kv_cache_bit_width);
+              }
+
+              if (use_smooth_softmax_) {
+                ComputeSmoothSoftmaxInplace(scores.data() + window_start, 1, window_length, nullptr);
+              } else {
+                ComputeAttentionSoftmaxInplace(scores.data() + window_start, 1, window_length, nullptr);
+              }
+
+              std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+              for (int t = window_start; t < seq_causal_length; t++) {
+                AccumulateQuantizedKVCacheRow(scores[t], v + t * row_bytes, head_size, kv_cache_bit_width,
+                                              accumulator.data());
+              }
+
+              // output has shape BxSxNxH
+              float* output_row =
+                  output_data + (SafeInt<ptrdiff_t>(batch_index) * sequence_length + seq) * hidden_size +
+                  head_index * head_size;
+              for (int h = 0; h < head_size; h++) {
+                output_row[h] = accumulator[h] * v_scale_head[h / scale_block_size];
+              }
+            }
+          }
+        });
+
+    return Status::OK();
+  }
+
  private:
+  // Computes the attention with the fused MLAS kernel, which never materializes the BxNxSxT attention probs.
+  // The past and new key/value are first concatenated into the present buffers, which the kernel reads in place.
+  Status ApplyFlashAttention(const float* Q,                            // Q data with shape BxNxSxH
+                             const float* K,                            // K data with shape BxN_kvxSxH
+                             const float* V,                            // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                    // past K input tensor
+                             const Tensor* past_value,                  // past V input tensor
+                             Tensor* output,                            // output tensor
+                             Tensor* present_key,                       // present K output tensor
+                             Tensor* present_value,                     // present V output tensor
+                             const Tensor* seqlens_k,                   // past sequence lengths tensor
+                             GroupQueryAttentionParameters& parameters,  // attention parameters
+                             int past_buffer_sequence_length,           // sequence length of past state
+                             int present_buffer_sequence_length,        // sequence length of present state
+                             AllocatorPtr allocator,                    // allocator for temporary buffers
+                             ThreadPool* tp) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const bool is_prompt = sequence_length != 1;
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+
+    const float* past_key_data = past_key != nullptr ? past_key->Data<float>() : nullptr;
+    float* present_key_data = present_key->MutableData<float>();
+    const float* past_value_data = past_value != nullptr ? past_value->Data<float>() : nullptr;
+    float* present_value_data = present_value->MutableData<float>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                    // S x H
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes =
+          SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length * sizeof(float);
+      memset(present_key_data, 0, present_bytes);
+      memset(present_value_data, 0, present_bytes);
+    }
+
+    // Unlike the unfused path, the key and value of a kv head are concatenated once, not once per query head.
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+
+    const float* k_input = packed_qkv ? Q + num_heads_ * kv_input_chunk_length : K;
+    const float* v_input = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * kv_input_chunk_length : V;
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / kv_num_heads_);
+            const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+            const int past_seqlen =
+                is_prompt ? past_buffer_sequence_length : static_cast<int>(seqlens_k_data[batch_index]);
+            const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+
+            const ptrdiff_t chunk_length = static_cast<ptrdiff_t>(kv_input_chunk_length);
+            const ptrdiff_t input_offset =
+                packed_qkv ? packed_batch_stride * batch_index + chunk_length * kv_head_index : chunk_length * i;
+            ConcatStateChunkGQA(past_key_data, k_input + input_offset, present_key_data, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length, is_prompt,
+                                past_present_share_buffer, i);
+            ConcatStateChunkGQA(past_value_data, v_input + input_offset, present_value_data, present_buff_chunk_length,
+                                past_buff_chunk_length, past_chunk_length, kv_input_chunk_length, is_prompt,
+                                past_present_share_buffer, i);
+          }
+        });
+
+    std::vector<int32_t> total_seqlens(seqlens_k_data, seqlens_k_data + batch_size);
+    for (auto& total_seqlen : total_seqlens) {
+      total_seqlen += 1;
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.kv_num_heads = kv_num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = present_buffer_sequence_length;
+    args.kv_buffer_sequence_length = present_buffer_sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    args.query_batch_stride = static_cast<size_t>(packed_batch_stride);
+    args.kv_sequence_lengths = total_seqlens.data();
+    args.causal = true;
+    // the first token is at position seqlens_k in token generation, and at 0 in the prompt
+    args.past_sequence_lengths = is_prompt ? nullptr : seqlens_k_data;
+    args.local_window_size = local_window_size_;
+
+    // Block sizes are chosen as in the MultiHeadAttention kernel, see there for the derivation.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, 2 * head_size);
+    args.kv_block_size = std::min(args.kv_block_size, present_buffer_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, sequence_length);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                  sizeof(float);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query = Q;
+    args.key = present_key_data;
+    args.value = present_value_data;
+    args.output = output->MutableData<float>();
+
+    MlasFlashAttention(&args, tp);
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
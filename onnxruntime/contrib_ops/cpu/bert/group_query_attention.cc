@@ -30,12 +30,57 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<float>(),
+                                    DataTypeImpl::GetTensorType<int8_t>(),
+                                    DataTypeImpl::GetTensorType<uint8_t>()})
         .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
     GroupQueryAttention<float>);
 
 template <typename T>
 GroupQueryAttention<T>::GroupQueryAttention(const OpKernelInfo& info)
-    : OpKernel(info), GQAAttentionBase(info, true) {}
+    : OpKernel(info), GQAAttentionBase(info, true) {
+  kv_cache_bit_width_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("kv_cache_bit_width", 0));
+  ORT_ENFORCE(kv_cache_bit_width_ == 0 || kv_cache_bit_width_ == 8 || kv_cache_bit_width_ == 4,
+              "kv_cache_bit_width must be 0, 8 or 4. Got ", kv_cache_bit_width_);
+}
+
+namespace {
+
+// Validates the static scales of a quantized k-v cache, which have shape (kv_num_heads) or
+// (kv_num_heads, scale_block_count), and returns the number of scale blocks per cache row.
+Status CheckKVCacheScales(const Tensor* k_scale, const Tensor* v_scale, int kv_num_heads, int head_size,
+                          int kv_cache_bit_width, int& scale_block_count) {
+  if (k_scale == nullptr || v_scale == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'k_scale' and 'v_scale' are required when kv_cache_bit_width is not 0.");
+  }
+  if (k_scale->Shape() != v_scale->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'k_scale' and 'v_scale' shall have the same shape, got ", k_scale->Shape(),
+                           " and ", v_scale->Shape());
+  }
+
+  const auto& scale_dims = k_scale->Shape().GetDims();
+  if ((scale_dims.size() != 1 && scale_dims.size() != 2) || scale_dims[0] != kv_num_heads) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'k_scale' shall have shape (kv_num_heads) or (kv_num_heads, blocks), got ",
+                           k_scale->Shape());
+  }
+
+  scale_block_count = scale_dims.size() == 2 ? static_cast<int>(scale_dims[1]) : 1;
+  if (scale_block_count <= 0 || head_size % scale_block_count != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The number of scale blocks shall divide head_size, got ", scale_block_count);
+  }
+  if (kv_cache_bit_width == 4 && (head_size / scale_block_count) % 2 != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The scale block size of an int4 k-v cache shall be even, got ",
+                           head_size / scale_block_count);
+  }
+  return Status::OK();
+}
+
+}  // namespace
 
 template <typename T>
 Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
@@ -48,6 +93,8 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* k_scale = context->Input<Tensor>(9);
+  const Tensor* v_scale = context->Input<Tensor>(10);
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
@@ -78,8 +125,27 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   output_shape[2] = static_cast<int64_t>(q_hidden_size);
   Tensor* output = context->Output(0, output_shape);
 
-  std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
-  std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+  int scale_block_count = 0;
+  if (kv_cache_bit_width_ != 0) {
+    ORT_RETURN_IF_ERROR(CheckKVCacheScales(k_scale, v_scale, kv_num_heads_, head_size, kv_cache_bit_width_,
+                                           scale_block_count));
+    const bool is_cache_type = past_key == nullptr || (kv_cache_bit_width_ == 8 ? past_key->IsDataType<int8_t>()
+                                                                                 : past_key->IsDataType<uint8_t>());
+    if (!is_cache_type || (past_key != nullptr && past_key->DataType() != past_value->DataType())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'past_key' and 'past_value' shall be int8 for kv_cache_bit_width 8 and uint8 for "
+                             "kv_cache_bit_width 4.");
+    }
+  } else if (past_key != nullptr && (!past_key->IsDataType<T>() || !past_value->IsDataType<T>())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'past_key' and 'past_value' shall have the type of 'query' when kv_cache_bit_width "
+                           "is 0.");
+  }
+
+  // an int4 cache packs two values in each byte of the last dimension
+  const int64_t cache_head_size = kv_cache_bit_width_ == 4 ? head_size / 2 : head_size;
+  std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), cache_head_size});
+  std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), cache_head_size});
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
 
@@ -175,6 +241,13 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
     }
   }
 
+  if (kv_cache_bit_width_ != 0) {
+    return ApplyQuantizedKVAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                                     packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output,
+                                     present_k, present_v, seqlens_k, k_scale->Data<float>(), v_scale->Data<float>(),
+                                     scale_block_count, kv_cache_bit_width_, parameters, context);
+  }
+
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
@@ -15,6 +15,9 @@ class GroupQueryAttention final : public OpKernel, public GQAAttentionBase {
  public:
   GroupQueryAttention(const OpKernelInfo& info);
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int kv_cache_bit_width_;  // 0 for a cache in T, 8 or 4 for a quantized cache
 };
 
 }  // namespace contrib
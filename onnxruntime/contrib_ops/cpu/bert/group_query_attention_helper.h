@@ -152,12 +152,14 @@ Status CheckInputs(const Tensor* query,
     // We assume all sequence in past kv are right-padded to max or past sequence length
     past_sequence_length = static_cast<int>(past_key_dims[2]);
 
-    if (past_key_dims[3] != head_size) {
+    // a uint8 cache packs two int4 values per element
+    const int64_t cache_head_size = past_key->IsDataType<uint8_t>() ? head_size / 2 : head_size;
+    if (past_key_dims[3] != cache_head_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_key' dimension 3 should be same as head_size, got ",
                              past_key_dims[3]);
     }
-    if (past_value_dims[3] != head_size) {
+    if (past_value_dims[3] != cache_head_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_value' dimension 3 should be same as head_size, got ",
                              past_value_dims[3]);
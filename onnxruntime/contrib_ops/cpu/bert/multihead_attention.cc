@@ -147,7 +147,7 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
 
   if (std::is_same_v<T, float> &&
       !disable_flash_ &&
-      !is_unidirectional_ &&
+      (!is_unidirectional_ || kv_sequence_length == q_sequence_length) &&
       key_padding_mask == nullptr &&
       attn_bias == nullptr &&
       past_key == nullptr &&
@@ -163,6 +163,7 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     args.qk_head_size = qk_head_size;
     args.v_head_size = v_head_size;
     args.scale = (scale_ == 0.0f) ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
+    args.causal = is_unidirectional_;
     /*
       q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
       Let M = l2_cache_size / sizeof(float)
@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/diffusion/group_norm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    GroupNorm, kMSDomain, 1, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+ONNX_OPERATOR_KERNEL_EX(
+    SkipGroupNorm, kMSDomain, 1, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+namespace {
+
+// The values are summed in float so that the reduction is vectorized, and the partial sums are accumulated in double
+// so that the variance of large groups doesn't lose its precision.
+void Accumulate(const float* values, int64_t count, double& sum, double& sum_square) {
+  ConstEigenVectorArrayMap<float> value_map(values, narrow<Eigen::Index>(count));
+  sum += static_cast<double>(value_map.sum());
+  sum_square += static_cast<double>(value_map.square().sum());
+}
+
+// y = y * sigmoid(y)
+void ApplySwish(float* values, int64_t count) {
+  constexpr int64_t kChunkSize = 256;
+  float sigmoid[kChunkSize];
+  for (int64_t start = 0; start < count; start += kChunkSize) {
+    const int64_t length = std::min(kChunkSize, count - start);
+    MlasComputeLogistic(values + start, sigmoid, narrow<size_t>(length));
+    EigenVectorArrayMap<float>(values + start, narrow<Eigen::Index>(length)) *=
+        ConstEigenVectorArrayMap<float>(sigmoid, narrow<Eigen::Index>(length));
+  }
+}
+
+}  // namespace
+
+GroupNorm::GroupNorm(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
+  has_skip_ = op_kernel_info.GetKernelDef().OpName() == "SkipGroupNorm";
+
+  epsilon_ = op_kernel_info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  ORT_ENFORCE(epsilon_ >= 0);
+
+  ORT_ENFORCE(op_kernel_info.GetAttr("groups", &num_groups_).IsOK());
+  ORT_ENFORCE(num_groups_ > 0);
+
+  int64_t activation;
+  ORT_ENFORCE(op_kernel_info.GetAttr("activation", &activation).IsOK());
+  ORT_ENFORCE(activation == 0 || activation == 1);  // 0 is None, 1 is Swish
+  use_swish_activation_ = (activation == 1);
+
+  channels_last_ = (op_kernel_info.GetAttrOrDefault<int64_t>("channels_last", static_cast<int64_t>(1)) != 0);
+}
+
+Status GroupNorm::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* gamma = context->Input<Tensor>(1);
+  const Tensor* beta = context->Input<Tensor>(2);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 4 dimensions, got ", input_dims.size());
+  }
+
+  const int64_t batch_size = input_dims[0];
+  const int64_t num_channels = channels_last_ ? input_dims[3] : input_dims[1];
+  const int64_t image_size = channels_last_ ? input_dims[1] * input_dims[2] : input_dims[2] * input_dims[3];
+
+  if (num_channels % num_groups_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "number of channels should be divisible by num_groups");
+  }
+
+  const auto& gamma_dims = gamma->Shape().GetDims();
+  if (gamma_dims.size() != 1 || gamma_dims[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "gamma is expected to have shape (C), got ", gamma->Shape());
+  }
+
+  const auto& beta_dims = beta->Shape().GetDims();
+  if (beta_dims.size() != 1 || beta_dims[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "beta is expected to have shape (C), got ", beta->Shape());
+  }
+
+  const Tensor* skip = nullptr;
+  const Tensor* bias = nullptr;
+  bool broadcast_skip = false;
+  if (has_skip_) {
+    skip = context->Input<Tensor>(3);
+    bias = context->Input<Tensor>(4);
+
+    if (bias != nullptr) {  // Bias is optional
+      const auto& bias_dims = bias->Shape().GetDims();
+      if (bias_dims.size() != 1 || bias_dims[0] != num_channels) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "bias is expected to have shape (C), got ", bias->Shape());
+      }
+    }
+
+    if (skip->Shape() != input->Shape()) {
+      // The skip can also have one value per channel of each batch: (N, C), or (N, 1, 1, C) in the NHWC layout and
+      // (N, C, 1, 1) in the NCHW layout.
+      const auto& dims = skip->Shape().GetDims();
+      const bool b2 = (dims.size() == 2 && dims[0] == batch_size && dims[1] == num_channels);
+      const bool b4 = (dims.size() == 4 && dims[0] == batch_size &&
+                       (channels_last_ ? (dims[1] == 1 && dims[2] == 1 && dims[3] == num_channels)
+                                       : (dims[1] == num_channels && dims[2] == 1 && dims[3] == 1)));
+      if (!b2 && !b4) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "skip is expected to have the shape of input or one value per channel of each batch, ",
+                               "got ", skip->Shape());
+      }
+      broadcast_skip = true;
+    }
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  Tensor* add_out = has_skip_ ? context->Output(1, input->Shape()) : nullptr;
+
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const float* input_data = input->Data<float>();
+  const float* gamma_data = gamma->Data<float>();
+  const float* beta_data = beta->Data<float>();
+  const float* skip_data = skip == nullptr ? nullptr : skip->Data<float>();
+  const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+  float* output_data = output->MutableData<float>();
+  float* add_out_data = add_out == nullptr ? nullptr : add_out->MutableData<float>();
+
+  const int64_t channels_per_group = num_channels / num_groups_;
+  const int64_t group_size = channels_per_group * image_size;
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  // The statistics of each group of each batch. With a skip, x + skip + bias is written to the output here and the
+  // output is normalized in place below.
+  std::vector<float> mean(narrow<size_t>(batch_size * num_groups_));
+  std::vector<float> inv_std_dev(narrow<size_t>(batch_size * num_groups_));
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, narrow<int32_t>(batch_size * num_groups_),
+      [&](ptrdiff_t task_idx) {
+        const int64_t n = task_idx / num_groups_;
+        const int64_t first_channel = (task_idx % num_groups_) * channels_per_group;
+        double sum = 0.0;
+        double sum_square = 0.0;
+
+        if (channels_last_) {
+          // the channels of the group are contiguous in each pixel
+          for (int64_t i = 0; i < image_size; i++) {
+            const int64_t offset = (n * image_size + i) * num_channels + first_channel;
+            const float* values = input_data + offset;
+            if (skip_data != nullptr) {
+              const float* skip_values = skip_data + (broadcast_skip ? n * num_channels + first_channel : offset);
+              EigenVectorArrayMap<float> sum_map(output_data + offset, channels_per_group);
+              sum_map = ConstEigenVectorArrayMap<float>(values, channels_per_group) +
+                        ConstEigenVectorArrayMap<float>(skip_values, channels_per_group);
+              if (bias_data != nullptr) {
+                sum_map += ConstEigenVectorArrayMap<float>(bias_data + first_channel, channels_per_group);
+              }
+              values = output_data + offset;
+              if (add_out_data != nullptr) {
+                std::copy_n(values, channels_per_group, add_out_data + offset);
+              }
+            }
+            Accumulate(values, channels_per_group, sum, sum_square);
+          }
+        } else {
+          // the group is contiguous
+          for (int64_t c = first_channel; c < first_channel + channels_per_group; c++) {
+            const int64_t offset = (n * num_channels + c) * image_size;
+            const float* values = input_data + offset;
+            if (skip_data != nullptr) {
+              EigenVectorArrayMap<float> sum_map(output_data + offset, image_size);
+              const float channel_bias = bias_data != nullptr ? bias_data[c] : 0.0f;
+              if (broadcast_skip) {
+                sum_map = ConstEigenVectorArrayMap<float>(values, image_size) +
+                          (skip_data[n * num_channels + c] + channel_bias);
+              } else {
+                sum_map = ConstEigenVectorArrayMap<float>(values, image_size) +
+                          ConstEigenVectorArrayMap<float>(skip_data + offset, image_size) + channel_bias;
+              }
+              values = output_data + offset;
+              if (add_out_data != nullptr) {
+                std::copy_n(values, image_size, add_out_data + offset);
+              }
+            }
+            Accumulate(values, image_size, sum, sum_square);
+          }
+        }
+
+        const double group_mean = sum / group_size;
+        const double variance = std::max(sum_square / group_size - group_mean * group_mean, 0.0);
+        mean[task_idx] = static_cast<float>(group_mean);
+        inv_std_dev[task_idx] = static_cast<float>(1.0 / std::sqrt(variance + epsilon_));
+      },
+      0);
+
+  // Folds the statistics into a scale and a shift per channel of each batch, so y = s * scale + shift.
+  std::vector<float> scale(narrow<size_t>(batch_size * num_channels));
+  std::vector<float> shift(narrow<size_t>(batch_size * num_channels));
+  for (int64_t n = 0; n < batch_size; n++) {
+    for (int64_t c = 0; c < num_channels; c++) {
+      const int64_t group_idx = n * num_groups_ + c / channels_per_group;
+      const int64_t idx = n * num_channels + c;
+      scale[idx] = gamma_data[c] * inv_std_dev[group_idx];
+      shift[idx] = beta_data[c] - mean[group_idx] * scale[idx];
+    }
+  }
+
+  // A row is a pixel of a batch in the NHWC layout, with a scale per element, and a channel of a batch in the NCHW
+  // layout, with a single scale.
+  const float* normalize_input = skip_data != nullptr ? output_data : input_data;
+  const int64_t row_count = channels_last_ ? batch_size * image_size : batch_size * num_channels;
+  const int64_t row_size = channels_last_ ? num_channels : image_size;
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, narrow<int32_t>(row_count),
+      [&](ptrdiff_t row) {
+        ConstEigenVectorArrayMap<float> x(normalize_input + row * row_size, row_size);
+        EigenVectorArrayMap<float> y(output_data + row * row_size, row_size);
+        if (channels_last_) {
+          const int64_t n = row / image_size;
+          y = x * ConstEigenVectorArrayMap<float>(scale.data() + n * num_channels, num_channels) +
+              ConstEigenVectorArrayMap<float>(shift.data() + n * num_channels, num_channels);
+        } else {
+          y = x * scale[row] + shift[row];
+        }
+
+        if (use_swish_activation_) {
+          ApplySwish(output_data + row * row_size, row_size);
+        }
+      },
+      0);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// GroupNorm and SkipGroupNorm in float, in the NHWC or the NCHW layout.
+class GroupNorm final : public OpKernel {
+ public:
+  explicit GroupNorm(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float epsilon_;
+  int64_t num_groups_;
+  bool use_swish_activation_;
+  bool channels_last_;
+  bool has_skip_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
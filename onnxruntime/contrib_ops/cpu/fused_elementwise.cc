@@ -0,0 +1,322 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+bool FusedElementwise::ParseOpKind(const std::string& op_type, OpKind& kind, bool& is_binary) {
+  static const std::pair<const char*, OpKind> binary_ops[] = {
+      {"Add", OpKind::Add}, {"Sub", OpKind::Sub}, {"Mul", OpKind::Mul}, {"Div", OpKind::Div}};
+  static const std::pair<const char*, OpKind> unary_ops[] = {
+      {"Sigmoid", OpKind::Sigmoid}, {"Tanh", OpKind::Tanh}, {"Relu", OpKind::Relu}, {"Exp", OpKind::Exp},
+      {"Erf", OpKind::Erf}, {"Neg", OpKind::Neg}, {"Abs", OpKind::Abs}, {"Sqrt", OpKind::Sqrt},
+      {"Reciprocal", OpKind::Reciprocal}};
+
+  for (const auto& op : binary_ops) {
+    if (op_type == op.first) {
+      kind = op.second;
+      is_binary = true;
+      return true;
+    }
+  }
+  for (const auto& op : unary_ops) {
+    if (op_type == op.first) {
+      kind = op.second;
+      is_binary = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one instruction.");
+  ORT_ENFORCE(operands.size() == 2 * ops.size(), "FusedElementwise requires two operands per instruction, got ",
+              operands.size(), " operands for ", ops.size(), " instructions.");
+
+  const int64_t num_inputs = static_cast<int64_t>(info.GetInputCount());
+  for (size_t i = 0; i < ops.size(); i++) {
+    Instruction instruction{};
+    bool is_binary = false;
+    ORT_ENFORCE(ParseOpKind(ops[i], instruction.kind, is_binary), "Unsupported operator in FusedElementwise: ",
+                ops[i]);
+
+    // an instruction reads the inputs and the results of the instructions before it
+    const int64_t num_values = num_inputs + static_cast<int64_t>(i);
+    const int64_t operand0 = operands[2 * i];
+    const int64_t operand1 = operands[2 * i + 1];
+    ORT_ENFORCE(operand0 >= 0 && operand0 < num_values, "Invalid operand ", operand0, " of instruction ", i);
+    if (is_binary) {
+      ORT_ENFORCE(operand1 >= 0 && operand1 < num_values, "Invalid operand ", operand1, " of instruction ", i);
+    } else {
+      ORT_ENFORCE(operand1 == -1, "Unary instruction ", i, " shall have -1 as its second operand.");
+    }
+
+    instruction.operand0 = static_cast<int>(operand0);
+    instruction.operand1 = static_cast<int>(operand1);
+    instructions_.push_back(instruction);
+  }
+}
+
+namespace {
+
+// Number of output elements that are evaluated at a time. The intermediate results of a tile stay in L1/L2.
+constexpr size_t kTileSize = 1024;
+
+MLAS_ELTWISE_BINARY_KIND ToMlasKind(FusedElementwise::OpKind kind) {
+  switch (kind) {
+    case FusedElementwise::OpKind::Add:
+      return MlasEltwiseAdd;
+    case FusedElementwise::OpKind::Sub:
+      return MlasEltwiseSub;
+    case FusedElementwise::OpKind::Mul:
+      return MlasEltwiseMul;
+    default:
+      return MlasEltwiseDiv;
+  }
+}
+
+// Computes a unary operator over count contiguous elements.
+void ComputeUnary(FusedElementwise::OpKind kind, const float* input, float* output, size_t count) {
+  switch (kind) {
+    case FusedElementwise::OpKind::Sigmoid:
+      MlasComputeLogistic(input, output, count);
+      break;
+    case FusedElementwise::OpKind::Tanh:
+      MlasComputeTanh(input, output, count);
+      break;
+    case FusedElementwise::OpKind::Exp:
+      MlasComputeExp(input, output, count);
+      break;
+    case FusedElementwise::OpKind::Erf:
+      MlasComputeErf(input, output, count);
+      break;
+    case FusedElementwise::OpKind::Relu:
+      for (size_t i = 0; i < count; i++) {
+        output[i] = std::max(input[i], 0.0f);
+      }
+      break;
+    case FusedElementwise::OpKind::Neg:
+      for (size_t i = 0; i < count; i++) {
+        output[i] = -input[i];
+      }
+      break;
+    case FusedElementwise::OpKind::Abs:
+      for (size_t i = 0; i < count; i++) {
+        output[i] = std::abs(input[i]);
+      }
+      break;
+    case FusedElementwise::OpKind::Sqrt:
+      for (size_t i = 0; i < count; i++) {
+        output[i] = std::sqrt(input[i]);
+      }
+      break;
+    case FusedElementwise::OpKind::Reciprocal:
+      for (size_t i = 0; i < count; i++) {
+        output[i] = 1.0f / input[i];
+      }
+      break;
+    default:
+      ORT_THROW("Unexpected binary operator in a unary instruction.");
+  }
+}
+
+}  // namespace
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const size_t num_inputs = static_cast<size_t>(context->InputCount());
+  InlinedVector<const Tensor*> inputs(num_inputs);
+  size_t rank = 0;
+  for (size_t i = 0; i < num_inputs; i++) {
+    inputs[i] = context->Input<Tensor>(static_cast<int>(i));
+    rank = std::max(rank, inputs[i]->Shape().NumDimensions());
+  }
+
+  // strides[i * rank + axis] is the element stride of input i along the output axis, 0 where it is broadcast
+  TensorShapeVector output_dims(rank, 1);
+  InlinedVector<size_t> strides(num_inputs * rank);
+  for (size_t i = 0; i < num_inputs; i++) {
+    const auto dims = inputs[i]->Shape().GetDims();
+    size_t stride = 1;
+    for (size_t axis = rank; axis-- > 0;) {
+      const int64_t dim = axis + dims.size() >= rank ? dims[axis + dims.size() - rank] : 1;
+      if (dim != 1) {
+        ORT_RETURN_IF_NOT(output_dims[axis] == 1 || output_dims[axis] == dim,
+                          "FusedElementwise: input ", i, " with shape ", inputs[i]->Shape(),
+                          " can not be broadcast with the other inputs.");
+        output_dims[axis] = dim;
+      }
+      strides[i * rank + axis] = dim == 1 ? 0 : stride;
+      stride *= static_cast<size_t>(dim);
+    }
+  }
+
+  Tensor& output = *context->Output(0, TensorShape(output_dims));
+  const size_t output_size = narrow<size_t>(output.Shape().Size());
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // Fold the axes, innermost first, as long as every input stays contiguous or stays broadcast across them.
+  // per_axis_strides[k][i] is the stride of input i along folded axis k.
+  InlinedVector<size_t> folded_dims;
+  InlinedVector<InlinedVector<size_t>> per_axis_strides;
+  for (size_t axis = rank; axis-- > 0;) {
+    const size_t dim = static_cast<size_t>(output_dims[axis]);
+    if (dim == 1) {
+      continue;
+    }
+
+    if (!folded_dims.empty()) {
+      const size_t inner_dim = folded_dims.back();
+      bool fold = true;
+      for (size_t i = 0; i < num_inputs && fold; i++) {
+        fold = strides[i * rank + axis] == per_axis_strides.back()[i] * inner_dim;
+      }
+      if (fold) {
+        folded_dims.back() *= dim;
+        continue;
+      }
+    }
+
+    folded_dims.push_back(dim);
+    per_axis_strides.emplace_back(num_inputs);
+    for (size_t i = 0; i < num_inputs; i++) {
+      per_axis_strides.back()[i] = strides[i * rank + axis];
+    }
+  }
+
+  if (folded_dims.empty()) {
+    // a single output element
+    folded_dims.push_back(1);
+    per_axis_strides.emplace_back(num_inputs, 0);
+  }
+
+  // An instruction is uniform when none of its operands varies along the innermost run, so it is evaluated for
+  // one element per run. Its result is then read with a stride of 0.
+  const size_t num_instructions = instructions_.size();
+  InlinedVector<bool> uniform(num_inputs + num_instructions);
+  for (size_t i = 0; i < num_inputs; i++) {
+    uniform[i] = per_axis_strides[0][i] == 0;
+  }
+  for (size_t j = 0; j < num_instructions; j++) {
+    const Instruction& instruction = instructions_[j];
+    uniform[num_inputs + j] = uniform[instruction.operand0] &&
+                              (instruction.operand1 < 0 || uniform[instruction.operand1]);
+  }
+
+  InlinedVector<const float*> input_data(num_inputs);
+  for (size_t i = 0; i < num_inputs; i++) {
+    input_data[i] = inputs[i]->Data<float>();
+  }
+  float* output_data = output.MutableData<float>();
+
+  const size_t inner_size = folded_dims[0];
+  const size_t num_tiles = (inner_size + kTileSize - 1) / kTileSize;
+  const size_t outer_size = output_size / inner_size;
+  const size_t num_outer_axes = folded_dims.size() - 1;
+  const size_t tile_capacity = std::min(kTileSize, inner_size);
+
+  auto work = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    size_t outer = static_cast<size_t>(first) / num_tiles;
+    size_t tile = static_cast<size_t>(first) % num_tiles;
+
+    InlinedVector<size_t> index(num_outer_axes);
+    InlinedVector<size_t> offsets(num_inputs, 0);
+    size_t output_offset = outer * inner_size;
+    for (size_t k = 0; k < num_outer_axes; ++k) {
+      index[k] = outer % folded_dims[k + 1];
+      outer /= folded_dims[k + 1];
+      for (size_t i = 0; i < num_inputs; i++) {
+        offsets[i] += index[k] * per_axis_strides[k + 1][i];
+      }
+    }
+
+    // one tile of scratch per instruction, except the last one that writes to the output
+    std::vector<float> scratch((num_instructions - 1) * tile_capacity);
+    InlinedVector<const float*> values(num_inputs + num_instructions);
+    InlinedVector<size_t> value_strides(num_inputs + num_instructions);
+
+    for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+      const size_t start = tile * kTileSize;
+      const size_t count = std::min(kTileSize, inner_size - start);
+      for (size_t i = 0; i < num_inputs; i++) {
+        values[i] = input_data[i] + offsets[i] + start * per_axis_strides[0][i];
+        value_strides[i] = per_axis_strides[0][i];
+      }
+
+      for (size_t j = 0; j < num_instructions; j++) {
+        const Instruction& instruction = instructions_[j];
+        const bool is_last = j + 1 == num_instructions;
+        const size_t n = uniform[num_inputs + j] ? 1 : count;
+        float* result = is_last ? output_data + output_offset + start : scratch.data() + j * tile_capacity;
+
+        if (instruction.operand1 >= 0) {
+          MlasEltwiseBinary(ToMlasKind(instruction.kind),
+                            values[instruction.operand0], value_strides[instruction.operand0],
+                            values[instruction.operand1], value_strides[instruction.operand1],
+                            result, n);
+        } else {
+          // the operand of a non-uniform unary instruction is contiguous
+          ComputeUnary(instruction.kind, values[instruction.operand0], result, n);
+        }
+
+        values[num_inputs + j] = result;
+        value_strides[num_inputs + j] = n == 1 ? 0 : 1;
+        if (is_last && n < count) {
+          std::fill_n(result + 1, count - 1, result[0]);
+        }
+      }
+
+      if (++tile == num_tiles) {
+        tile = 0;
+        output_offset += inner_size;
+        for (size_t k = 0; k < num_outer_axes; ++k) {
+          for (size_t i = 0; i < num_inputs; i++) {
+            offsets[i] += per_axis_strides[k + 1][i];
+          }
+          if (++index[k] < folded_dims[k + 1]) {
+            break;
+          }
+          for (size_t i = 0; i < num_inputs; i++) {
+            offsets[i] -= folded_dims[k + 1] * per_axis_strides[k + 1][i];
+          }
+          index[k] = 0;
+        }
+      }
+    }
+  };
+
+  const double tile_elements = static_cast<double>(tile_capacity);
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(outer_size * num_tiles),
+      TensorOpCost{static_cast<double>(num_inputs * sizeof(float)) * tile_elements,
+                   sizeof(float) * tile_elements,
+                   static_cast<double>(num_instructions) * tile_elements},
+      work);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a fused chain of elementwise operators (see the FusedElementwise schema) tile by tile, so the
+// intermediate results stay in cache instead of making a round trip to memory per operator. The broadcast loops
+// are planned once per call like in the binary Add/Sub/Mul/Div kernels, and instructions whose operands are all
+// broadcast along the innermost run are evaluated once per run instead of once per element.
+class FusedElementwise final : public OpKernel {
+ public:
+  enum class OpKind {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Sigmoid,
+    Tanh,
+    Relu,
+    Exp,
+    Erf,
+    Neg,
+    Abs,
+    Sqrt,
+    Reciprocal,
+  };
+
+  struct Instruction {
+    OpKind kind;
+    int operand0;
+    int operand1;  // -1 for a unary operator
+  };
+
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  // Returns false if op_type is not supported. is_binary is set to whether it takes two operands.
+  static bool ParseOpKind(const std::string& op_type, OpKind& kind, bool& is_binary);
+
+ private:
+  InlinedVector<Instruction> instructions_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
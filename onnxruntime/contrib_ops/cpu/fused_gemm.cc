@@ -21,6 +21,33 @@ class FusedGemm final : public Gemm<T> {
       }
     }
     ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
+
+    if constexpr (std::is_same_v<T, float>) {
+      // Let MLAS apply the activation to the output tiles while they are still in cache.
+      MLAS_ACTIVATION mlas_activation{};
+      bool supported = true;
+      if (activation == "Relu") {
+        mlas_activation.ActivationKind = MlasReluActivation;
+      } else if (activation == "Tanh") {
+        mlas_activation.ActivationKind = MlasTanhActivation;
+      } else if (activation == "Sigmoid") {
+        mlas_activation.ActivationKind = MlasLogisticActivation;
+      } else if (activation == "LeakyRelu") {
+        mlas_activation.ActivationKind = MlasLeakyReluActivation;
+        mlas_activation.Parameters.LeakyRelu.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.01f);
+      } else if (activation == "HardSigmoid") {
+        mlas_activation.ActivationKind = MlasHardSigmoidActivation;
+        mlas_activation.Parameters.HardSigmoid.alpha = info.GetAttrOrDefault<float>("activation_alpha", 0.2f);
+        mlas_activation.Parameters.HardSigmoid.beta = info.GetAttrOrDefault<float>("activation_beta", 0.5f);
+      } else {
+        supported = false;
+      }
+
+      if (supported) {
+        this->mlas_activation_ = mlas_activation;
+        this->activation_.reset();
+      }
+    }
   }
 };
 
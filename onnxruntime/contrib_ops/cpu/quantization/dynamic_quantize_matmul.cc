@@ -7,6 +7,7 @@
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/cpu/quantization/matmul_integer_base.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
 
@@ -157,7 +158,10 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
 
 class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
  public:
-  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {}
+  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {
+    block_scale_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasDynamicQuantizeMatMulBlockScale,
+                                                              "0") == "1";
+  }
 
   Status Compute(OpKernelContext* context) const override;
 
@@ -171,6 +175,25 @@ class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
 
  protected:
   int GetBIdx() const override { return IN_B; }
+
+ private:
+  // Quantizes A by blocks of rows and multiplies each block right after quantizing it, so the quantized block is
+  // still in the cache and A is never quantized as a whole. a_scale and a_zero_point are those of A, or nullptr to
+  // use those of each block.
+  Status ComputeByRowBlocks(OpKernelContext* ctx,
+                            const MatMulComputeHelper& helper,
+                            const float* a_scale,
+                            const uint8_t* a_zero_point,
+                            const Tensor* b,
+                            const Tensor* b_scale_tensor,
+                            const Tensor* b_zp_tensor) const;
+
+  // the minimum number of rows of a block, fewer rows per thread use the unfused path
+  static constexpr size_t kMinRowsPerBlock = 16;
+  // the target size of a quantized block so that it stays in the L2 cache while being multiplied
+  static constexpr size_t kBlockBytes = 128 * 1024;
+
+  bool block_scale_{false};
 };
 
 class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
@@ -198,40 +221,164 @@ class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
   static void FixupScaleTensor(const Tensor*& a_scale_tensor, const Tensor*& b_scale_tensor);
 };
 
+Status DynamicQuantizeMatMul::ComputeByRowBlocks(OpKernelContext* ctx,
+                                                 const MatMulComputeHelper& helper,
+                                                 const float* a_scale,
+                                                 const uint8_t* a_zero_point,
+                                                 const Tensor* b,
+                                                 const Tensor* b_scale_tensor,
+                                                 const Tensor* b_zp_tensor) const {
+  Tensor* y = ctx->Output(OUT_Y, helper.OutputShape());
+  auto* y_data = y->MutableData<float>();
+  const float* a_data = ctx->Input<Tensor>(IN_A)->Data<float>();
+  const Tensor* bias_tensor = ctx->Input<Tensor>(IN_BIAS);
+  const float* bias_data = bias_tensor != nullptr ? bias_tensor->Data<float>() : nullptr;
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  bool is_b_zp_per_column = false;
+  uint8_t b_zp_default = 0;
+  const uint8_t* b_zp_ptr = &b_zp_default;
+  if (nullptr != b_zp_tensor) {
+    ORT_ENFORCE(IsBQuantParamSupported(b_zp_tensor->Shape(), b ? b->Shape() : b_shape_),
+                "MatmulInteger : b zero point is not valid");
+
+    is_b_zp_per_column = !IsScalarOr1ElementVector(b_zp_tensor);
+    b_zp_ptr = static_cast<const uint8_t*>(b_zp_tensor->DataRaw());
+  }
+
+  const bool is_b_scale_per_column = b_scale_tensor != nullptr && !IsScalarOr1ElementVector(b_scale_tensor);
+  const float* b_scale_data = b_scale_tensor != nullptr ? b_scale_tensor->Data<float>() : nullptr;
+
+  MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+  gemm_shape.N = N;
+  gemm_shape.K = K;
+  gemm_shape.AIsSigned = false;
+  gemm_shape.BIsSigned = b ? b->IsDataType<int8_t>() : b_is_signed_;
+
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const size_t num_threads = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+  const size_t rows_per_block = std::max(kMinRowsPerBlock,
+                                         std::min(kBlockBytes / K, (M + num_threads - 1) / num_threads));
+  const size_t num_blocks = (M + rows_per_block - 1) / rows_per_block;
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, static_cast<std::ptrdiff_t>(num_blocks), [&](std::ptrdiff_t block) {
+    const size_t row_begin = static_cast<size_t>(block) * rows_per_block;
+    const size_t num_rows = std::min(rows_per_block, M - row_begin);
+    const float* a_block = a_data + row_begin * K;
+    const size_t block_size = num_rows * K;
+
+    float block_scale;
+    uint8_t block_zero_point;
+    if (a_scale != nullptr) {
+      block_scale = *a_scale;
+      block_zero_point = *a_zero_point;
+    } else {
+      GetQuantizationParameter(a_block, static_cast<int64_t>(block_size), block_scale, block_zero_point, nullptr);
+    }
+
+    auto a_block_quant = IAllocator::MakeUniquePtr<uint8_t>(allocator, block_size);
+    MlasQuantizeLinear(a_block, a_block_quant.get(), block_size, block_scale, block_zero_point);
+
+    float multiplier_per_tensor = block_scale;
+    std::vector<float> multipliers_per_column;
+    const float* multipliers = &multiplier_per_tensor;
+    if (is_b_scale_per_column) {
+      multipliers_per_column.resize(N);
+      std::transform(b_scale_data, b_scale_data + N, multipliers_per_column.begin(),
+                     [block_scale](float b_scale) { return block_scale * b_scale; });
+      multipliers = multipliers_per_column.data();
+    } else if (b_scale_data != nullptr) {
+      multiplier_per_tensor *= *b_scale_data;
+    }
+
+    float* y_block = y_data + row_begin * N;
+    MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR scale_bias_processor(
+        y_block, N, multipliers, bias_data, MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
+        is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
+
+    MLAS_GEMM_QUANT_SHAPE_PARAMS block_shape = gemm_shape;
+    block_shape.M = num_rows;
+
+    MLAS_GEMM_QUANT_DATA_PARAMS params;
+    params.OutputProcessor = &scale_bias_processor;
+    params.A = a_block_quant.get();
+    params.lda = K;
+    params.ZeroPointA = block_zero_point;
+    params.BIsPacked = bool(packed_b_);
+    params.B = b ? static_cast<const uint8_t*>(b->DataRaw()) : packed_b_.get();
+    params.ldb = N;
+    params.ZeroPointB = b_zp_ptr;
+    params.PerColumnZeroPoints = is_b_zp_per_column;
+    params.C = reinterpret_cast<int32_t*>(y_block);
+    params.ldc = N;
+
+    MlasGemmBatch(block_shape, &params, 1, nullptr);
+  });
+
+  return Status::OK();
+}
+
 Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
   const Tensor* a = ctx->Input<Tensor>(IN_A);
   const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(IN_B);
 
   const Tensor* b_scale_tensor = ctx->Input<Tensor>(IN_B_SCALE);
   const Tensor* b_zp_tensor = ctx->Input<Tensor>(IN_B_ZERO_POINT);
+  bool is_b_scale_supported = IsBQuantParamSupported(b_scale_tensor->Shape(), b ? b->Shape() : b_shape_);
+
+  // A single product with enough rows for every thread is quantized and multiplied by blocks of rows.
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(),
+                                     b ? b->Shape() : b_shape_,
+                                     is_b_scale_supported ? &b_scale_tensor->Shape() : nullptr,
+                                     b_zp_tensor ? &b_zp_tensor->Shape() : nullptr));
+  const size_t num_threads = static_cast<size_t>(
+      concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()));
+  const bool by_row_blocks = helper.OutputOffsets().size() == 1 && helper.N() > 0 && helper.K() > 0 &&
+                             static_cast<size_t>(helper.M()) >= kMinRowsPerBlock * std::max<size_t>(2, num_threads);
 
   // calculate quantization parameter of a
   const float* a_data = a->Data<float>();
   int64_t num_of_elements = a->Shape().Size();
 
-  float a_scale;
-  uint8_t a_zero_point;
-  GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point, ctx->GetOperatorThreadPool());
-
-  AllocatorPtr allocator;
-  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
-  uint8_t* a_data_quant = static_cast<uint8_t*>(allocator->Alloc(SafeInt<size_t>(num_of_elements) * sizeof(uint8_t)));
-  BufferUniquePtr a_buffer_quant_holder(a_data_quant, BufferDeleter(std::move(allocator)));
-
-  ParQuantizeLinearStd(a_data, a_data_quant, narrow<size_t>(num_of_elements), a_scale, a_zero_point, ctx->GetOperatorThreadPool());
-
-  bool is_b_scale_supported = IsBQuantParamSupported(b_scale_tensor->Shape(), b ? b->Shape() : b_shape_);
-  ORT_RETURN_IF_ERROR(ComputeCommon(
-      ctx,
-      a_data_quant,
-      a->Shape(),
-      a_scale,
-      a_zero_point,
-      false /*a_is_signed*/,
-      b,
-      is_b_scale_supported ? b_scale_tensor : nullptr,
-      b_zp_tensor,
-      ctx->Input<Tensor>(IN_BIAS)));
+  if (by_row_blocks && block_scale_) {
+    ORT_RETURN_IF_ERROR(ComputeByRowBlocks(ctx, helper, nullptr, nullptr, b,
+                                           is_b_scale_supported ? b_scale_tensor : nullptr, b_zp_tensor));
+  } else {
+    float a_scale;
+    uint8_t a_zero_point;
+    GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+
+    if (by_row_blocks) {
+      ORT_RETURN_IF_ERROR(ComputeByRowBlocks(ctx, helper, &a_scale, &a_zero_point, b,
+                                             is_b_scale_supported ? b_scale_tensor : nullptr, b_zp_tensor));
+    } else {
+      AllocatorPtr allocator;
+      ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+      uint8_t* a_data_quant = static_cast<uint8_t*>(allocator->Alloc(SafeInt<size_t>(num_of_elements) * sizeof(uint8_t)));
+      BufferUniquePtr a_buffer_quant_holder(a_data_quant, BufferDeleter(std::move(allocator)));
+
+      ParQuantizeLinearStd(a_data, a_data_quant, narrow<size_t>(num_of_elements), a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+
+      ORT_RETURN_IF_ERROR(ComputeCommon(
+          ctx,
+          a_data_quant,
+          a->Shape(),
+          a_scale,
+          a_zero_point,
+          false /*a_is_signed*/,
+          b,
+          is_b_scale_supported ? b_scale_tensor : nullptr,
+          b_zp_tensor,
+          ctx->Input<Tensor>(IN_BIAS)));
+    }
+  }
 
   if (!is_b_scale_supported) {
     ScaleOutput(*b_scale_tensor, *ctx->Output<Tensor>(0));
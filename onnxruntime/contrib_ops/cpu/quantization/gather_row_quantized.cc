@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/framework/float16.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather_rows.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Gather of the rows of a table quantized row by row, with the optional pooling of every bag. See the
+// GatherRowQuantized schema and EmbeddingTableQuantization.
+class GatherRowQuantized final : public OpKernel {
+ public:
+  GatherRowQuantized(const OpKernelInfo& info) : OpKernel(info) {
+    bits_ = info.GetAttrOrDefault<int64_t>("bits", 8);
+    ORT_ENFORCE(bits_ == 8 || bits_ == 4 || bits_ == 2, "'bits' must be 8, 4 or 2, got ", bits_);
+    ORT_ENFORCE(info.GetAttr<int64_t>("embedding_dim", &embedding_dim_).IsOK() && embedding_dim_ >= 0,
+                "'embedding_dim' must be set to a non-negative value.");
+    const std::string mode = info.GetAttrOrDefault<std::string>("mode", "none");
+    ORT_ENFORCE(mode == "none" || mode == "sum" || mode == "mean",
+                "'mode' must be 'none', 'sum' or 'mean', got ", mode);
+    pooled_ = mode != "none";
+    mean_ = mode == "mean";
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind, typename T>
+  Status ComputeImpl(const Tensor& data, const Tensor& indices, const Tensor& scales, const Tensor& biases,
+                     Tensor& output, concurrency::ThreadPool* tp) const;
+
+  int64_t bits_;
+  int64_t embedding_dim_;
+  bool pooled_{false};
+  bool mean_{false};
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    GatherRowQuantized,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<MLFloat16>()})
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    GatherRowQuantized);
+
+namespace {
+
+// Dequantizes the packed values of a row into out, or adds them to out.
+template <int Bits, bool Accumulate>
+void DequantizeRow(const uint8_t* row, float scale, float bias, int64_t embedding_dim, float* out) {
+  constexpr int kValuesPerByte = 8 / Bits;
+  constexpr uint8_t kMask = static_cast<uint8_t>((1 << Bits) - 1);
+  for (int64_t k = 0; k < embedding_dim; ++k) {
+    const uint8_t q = static_cast<uint8_t>(row[k / kValuesPerByte] >> ((k % kValuesPerByte) * Bits)) & kMask;
+    const float value = static_cast<float>(q) * scale + bias;
+    if constexpr (Accumulate) {
+      out[k] += value;
+    } else {
+      out[k] = value;
+    }
+  }
+}
+
+template <int Bits, typename T>
+void DequantizeRows(const uint8_t* data, int64_t row_bytes, const T* scales, const T* biases,
+                    const int64_t* rows, int64_t num_rows, int64_t embedding_dim, bool pooled, bool mean,
+                    float* out) {
+  for (int64_t j = 0; j < std::min<int64_t>(num_rows, gather_rows::kPrefetchDistance); ++j) {
+    gather_rows::PrefetchRow(data + rows[j] * row_bytes, narrow<size_t>(row_bytes));
+  }
+
+  for (int64_t j = 0; j < num_rows; ++j) {
+    if (j + gather_rows::kPrefetchDistance < num_rows) {
+      gather_rows::PrefetchRow(data + rows[j + gather_rows::kPrefetchDistance] * row_bytes,
+                               narrow<size_t>(row_bytes));
+    }
+    const int64_t r = rows[j];
+    const float scale = static_cast<float>(scales[r]);
+    const float bias = static_cast<float>(biases[r]);
+    if (!pooled) {
+      DequantizeRow<Bits, false>(data + r * row_bytes, scale, bias, embedding_dim, out + j * embedding_dim);
+    } else if (j == 0) {
+      DequantizeRow<Bits, false>(data + r * row_bytes, scale, bias, embedding_dim, out);
+    } else {
+      DequantizeRow<Bits, true>(data + r * row_bytes, scale, bias, embedding_dim, out);
+    }
+  }
+
+  if (pooled && num_rows == 0) {
+    // The sum of an empty bag is 0 and its mean is NaN, as the ReduceSum and ReduceMean of an empty axis.
+    std::fill_n(out, embedding_dim, mean ? std::numeric_limits<float>::quiet_NaN() : 0.0f);
+  } else if (mean) {
+    const float count = static_cast<float>(num_rows);
+    for (int64_t k = 0; k < embedding_dim; ++k) {
+      out[k] /= count;
+    }
+  }
+}
+
+}  // namespace
+
+Status GatherRowQuantized::Compute(OpKernelContext* context) const {
+  const Tensor& data = *context->Input<Tensor>(0);
+  const Tensor& indices = *context->Input<Tensor>(1);
+  const Tensor& scales = *context->Input<Tensor>(2);
+  const Tensor& biases = *context->Input<Tensor>(3);
+
+  const TensorShape& data_shape = data.Shape();
+  const TensorShape& indices_shape = indices.Shape();
+  ORT_RETURN_IF_NOT(data_shape.NumDimensions() == 2, "data must have a rank of 2, got ", data_shape);
+  ORT_RETURN_IF_NOT(data_shape[1] == (embedding_dim_ * bits_ + 7) / 8,
+                    "data must have ceil(embedding_dim * bits / 8) = ", (embedding_dim_ * bits_ + 7) / 8,
+                    " bytes per row, got ", data_shape[1]);
+  ORT_RETURN_IF_NOT(scales.Shape().NumDimensions() == 1 && scales.Shape()[0] == data_shape[0] &&
+                        biases.Shape() == scales.Shape(),
+                    "scales and biases must have the shape [", data_shape[0], "], got ", scales.Shape(), " and ",
+                    biases.Shape());
+  ORT_RETURN_IF_NOT(scales.GetElementType() == biases.GetElementType(), "scales and biases must have the same type.");
+  ORT_RETURN_IF_NOT(!pooled_ || indices_shape.NumDimensions() >= 1, "indices must have a rank of at least 1 to be pooled.");
+
+  TensorShapeVector output_dims(indices_shape.GetDims().begin(), indices_shape.GetDims().end());
+  if (pooled_) {
+    output_dims.pop_back();
+  }
+  output_dims.push_back(embedding_dim_);
+  Tensor& output = *context->Output(0, TensorShape(output_dims));
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const bool half_scales = scales.IsDataType<MLFloat16>();
+  if (indices.IsDataType<int32_t>()) {
+    return half_scales ? ComputeImpl<int32_t, MLFloat16>(data, indices, scales, biases, output, tp)
+                       : ComputeImpl<int32_t, float>(data, indices, scales, biases, output, tp);
+  }
+  return half_scales ? ComputeImpl<int64_t, MLFloat16>(data, indices, scales, biases, output, tp)
+                     : ComputeImpl<int64_t, float>(data, indices, scales, biases, output, tp);
+}
+
+template <typename Tind, typename T>
+Status GatherRowQuantized::ComputeImpl(const Tensor& data, const Tensor& indices, const Tensor& scales,
+                                       const Tensor& biases, Tensor& output, concurrency::ThreadPool* tp) const {
+  const int64_t num_embeddings = data.Shape()[0];
+  const int64_t row_bytes = data.Shape()[1];
+  const TensorShape& indices_shape = indices.Shape();
+  const int64_t num_indices = indices_shape.Size();
+
+  // The normalized indices, checked first in case there is an out of bound index.
+  const Tind* indices_data = indices.Data<Tind>();
+  std::vector<int64_t> rows(narrow<size_t>(num_indices));
+  for (int64_t i = 0; i < num_indices; ++i) {
+    const int64_t idx = static_cast<int64_t>(indices_data[i]);
+    if (idx < -num_embeddings || idx >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_embeddings, ",", num_embeddings - 1, "]");
+    }
+    rows[narrow<size_t>(i)] = idx < 0 ? idx + num_embeddings : idx;
+  }
+
+  // With pooling every unit of work is a bag, otherwise it is a row of the output.
+  const int64_t bag_size = pooled_ ? indices_shape[indices_shape.NumDimensions() - 1] : 1;
+  const int64_t num_bags = pooled_ ? indices_shape.SizeToDimension(indices_shape.NumDimensions() - 1) : num_indices;
+  if (num_bags == 0 || embedding_dim_ == 0) {
+    return Status::OK();
+  }
+
+  const uint8_t* data_ptr = data.Data<uint8_t>();
+  const T* scales_ptr = scales.Data<T>();
+  const T* biases_ptr = biases.Data<T>();
+  float* output_ptr = output.MutableData<float>();
+  const TensorOpCost cost{static_cast<double>(bag_size * row_bytes),
+                          static_cast<double>(embedding_dim_ * sizeof(float)),
+                          static_cast<double>(bag_size * embedding_dim_ * 3)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<ptrdiff_t>(num_bags), cost, [&](ptrdiff_t first, ptrdiff_t last) {
+        const int64_t* first_row = rows.data() + first * bag_size;
+        const int64_t num_rows = (last - first) * bag_size;
+        float* out = output_ptr + first * embedding_dim_;
+        if (!pooled_) {
+          // The rows of the range are dequantized in one pass, to prefetch across them.
+          switch (bits_) {
+            case 8:
+              DequantizeRows<8>(data_ptr, row_bytes, scales_ptr, biases_ptr, first_row, num_rows,
+                                embedding_dim_, false, false, out);
+              break;
+            case 4:
+              DequantizeRows<4>(data_ptr, row_bytes, scales_ptr, biases_ptr, first_row, num_rows,
+                                embedding_dim_, false, false, out);
+              break;
+            default:
+              DequantizeRows<2>(data_ptr, row_bytes, scales_ptr, biases_ptr, first_row, num_rows,
+                                embedding_dim_, false, false, out);
+              break;
+          }
+          return;
+        }
+
+        for (ptrdiff_t b = first; b < last; ++b) {
+          const int64_t* bag = rows.data() + b * bag_size;
+          float* bag_out = output_ptr + b * embedding_dim_;
+          switch (bits_) {
+            case 8:
+              DequantizeRows<8>(data_ptr, row_bytes, scales_ptr, biases_ptr, bag, bag_size,
+                                embedding_dim_, true, mean_, bag_out);
+              break;
+            case 4:
+              DequantizeRows<4>(data_ptr, row_bytes, scales_ptr, biases_ptr, bag, bag_size,
+                                embedding_dim_, true, mean_, bag_out);
+              break;
+            default:
+              DequantizeRows<2>(data_ptr, row_bytes, scales_ptr, biases_ptr, bag, bag_size,
+                                embedding_dim_, true, mean_, bag_out);
+              break;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
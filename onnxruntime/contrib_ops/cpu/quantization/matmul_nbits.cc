@@ -3,11 +3,14 @@
 
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <type_traits>
 
 #include "core/common/common.h"
 #include "core/common/narrow.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
@@ -15,6 +18,7 @@
 #include "core/mlas/inc/mlas_q4.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/common.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #ifdef ORT_NEURAL_SPEED
 #include "contrib_ops/cpu/quantization/neural_speed_gemm.h"
@@ -102,10 +106,15 @@ class MatMulNBits final : public OpKernel {
       has_unquantized_zero_point_ = type != ONNX_NAMESPACE::TensorProto_DataType_UINT8;
     }
 
-    ORT_ENFORCE(nbits_ == 4,
-                "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(nbits_ == 2 || nbits_ == 3 || nbits_ == 4,
+                "Only 2b, 3b and 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
     const Tensor* tensor_zero_point = nullptr;
     has_zp_input_ = info.TryGetConstantInput(InputIndex::zero_points, &tensor_zero_point);
+
+    const std::string outlier_threshold =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasMatMulNBitsInt8OutlierThreshold, "0");
+    ORT_ENFORCE(TryParseStringWithClassicLocale(outlier_threshold, outlier_threshold_) && outlier_threshold_ >= 0.0f,
+                "Invalid value for ", kOrtSessionOptionsMlasMatMulNBitsInt8OutlierThreshold, ": ", outlier_threshold);
 #ifdef ORT_NEURAL_SPEED
     const Tensor* tensor_B = nullptr;
     const Tensor* tensor_scale = nullptr;
@@ -126,7 +135,23 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedState(const Tensor& tensor, int input_idx,
+                               gsl::span<const size_t> prepacked_buffer_sizes,
+                               /*out*/ bool& restored) override;
+
  private:
+  // Whether the outlier channels of A are multiplied in float, see kOrtSessionOptionsMlasMatMulNBitsInt8OutlierThreshold.
+  bool HandlesOutlierChannels(MLAS_SQNBIT_GEMM_COMPUTE_TYPE compute_type) const {
+    return outlier_threshold_ > 0.0f && compute_type == CompInt8 && nbits_ == 4;
+  }
+
+  // The channels of the rows of A with a value of at least outlier_threshold_ in magnitude, in increasing order.
+  InlinedVector<size_t> FindOutlierChannels(const float* a_data, size_t num_rows) const;
+
+  // Adds the products of the outlier channels of A with the dequantized rows of B to C.
+  Status MultiplyOutlierChannels(OpKernelContext* ctx, const MatMulComputeHelper& helper,
+                                 gsl::span<const size_t> outlier_channels, const float* a_data, float* y_data) const;
+
   const size_t K_;
   const size_t N_;
   const size_t block_size_;
@@ -140,6 +165,7 @@ class MatMulNBits final : public OpKernel {
   size_t packed_b_size_{0};
 
   bool has_zp_input_{false};
+  float outlier_threshold_{0.0f};
 #if defined(ORT_NEURAL_SPEED)
 
   bool is_asym_{false};
@@ -209,7 +235,6 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
   }
 
 #else  // defined(ORT_NEURAL_SPEED)
-  ORT_UNUSED_PARAMETER(prepacked_weights);
   const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
   if (input_idx == InputIndex::B) {
     if (!MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
@@ -222,7 +247,17 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
     auto qptr = tensor.DataRaw();
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
-    is_packed = true;
+    // With CompInt8 the scales and zero points are packed into the same buffer later, so it can't be shared.
+    bool can_share_packed_b = true;
+#ifdef MLAS_TARGET_AMD64_IX86
+    can_share_packed_b = compute_type != CompInt8;
+#endif
+    // B itself is still read to dequantize the rows of the outlier channels.
+    is_packed = !HandlesOutlierChannels(compute_type);
+    if (prepacked_weights && can_share_packed_b && is_packed) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+    }
   } else if (compute_type == CompInt8) {
 #ifdef MLAS_TARGET_AMD64_IX86
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
@@ -273,6 +308,117 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+Status MatMulNBits::RestorePrePackedState(const Tensor& /*tensor*/, int input_idx,
+                                          gsl::span<const size_t> prepacked_buffer_sizes,
+                                          /*out*/ bool& restored) {
+  restored = false;
+#if !defined(ORT_NEURAL_SPEED)
+  // only the packed B of the MLAS path is complete after PrePack() of input B, see PrePack()
+  const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
+  bool can_share_packed_b = true;
+#ifdef MLAS_TARGET_AMD64_IX86
+  can_share_packed_b = compute_type != CompInt8;
+#endif
+  if (input_idx != InputIndex::B || !can_share_packed_b || has_g_idx_ || has_unquantized_zero_point_ ||
+      HandlesOutlierChannels(compute_type) || prepacked_buffer_sizes.size() != 1 ||
+      !MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
+    return Status::OK();
+  }
+
+  const size_t packed_b_size = MlasSQNBitGemmPackQuantBDataSize(N_, K_, nbits_, block_size_, compute_type);
+  if (packed_b_size == 0 || packed_b_size != prepacked_buffer_sizes[0]) {
+    return Status::OK();
+  }
+  packed_b_size_ = packed_b_size;
+  restored = true;
+#else
+  ORT_UNUSED_PARAMETER(input_idx);
+  ORT_UNUSED_PARAMETER(prepacked_buffer_sizes);
+#endif  // !defined(ORT_NEURAL_SPEED)
+  return Status::OK();
+}
+
+InlinedVector<size_t> MatMulNBits::FindOutlierChannels(const float* a_data, size_t num_rows) const {
+  std::vector<float> channel_max(K_, 0.0f);
+  for (size_t m = 0; m < num_rows; ++m) {
+    const float* a_row = a_data + m * K_;
+    for (size_t k = 0; k < K_; ++k) {
+      channel_max[k] = std::max(channel_max[k], std::abs(a_row[k]));
+    }
+  }
+
+  InlinedVector<size_t> channels;
+  for (size_t k = 0; k < K_; ++k) {
+    if (channel_max[k] >= outlier_threshold_) {
+      channels.push_back(k);
+    }
+  }
+
+  // keep the largest ones, so that the float products stay small next to the int8 ones
+  const size_t max_channels = std::max<size_t>(1, K_ / 16);
+  if (channels.size() > max_channels) {
+    std::nth_element(channels.begin(), channels.begin() + max_channels, channels.end(),
+                     [&channel_max](size_t lhs, size_t rhs) { return channel_max[lhs] > channel_max[rhs]; });
+    channels.resize(max_channels);
+    std::sort(channels.begin(), channels.end());
+  }
+
+  return channels;
+}
+
+Status MatMulNBits::MultiplyOutlierChannels(OpKernelContext* ctx, const MatMulComputeHelper& helper,
+                                            gsl::span<const size_t> outlier_channels, const float* a_data,
+                                            float* y_data) const {
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t num_channels = outlier_channels.size();
+
+  const auto* b_data = ctx->Input<Tensor>(InputIndex::B)->Data<uint8_t>();
+  const auto* scales_data = ctx->Input<Tensor>(InputIndex::scales)->Data<float>();
+  const Tensor* zero_points = ctx->Input<Tensor>(InputIndex::zero_points);
+  const auto* zero_points_data = zero_points == nullptr ? nullptr : zero_points->Data<uint8_t>();
+
+  const size_t k_blks = (K_ + block_size_ - 1) / block_size_;
+  const size_t blob_size = block_size_ * nbits_ / 8;
+  const size_t zero_points_column_size = (k_blks + 1) / 2;
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  // the dequantized rows of B of the outlier channels, num_channels x N
+  auto b_rows = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_channels) * N_);
+  for (size_t n = 0; n < N_; ++n) {
+    const uint8_t* b_column = b_data + n * k_blks * blob_size;
+    for (size_t c = 0; c < num_channels; ++c) {
+      const size_t blk = outlier_channels[c] / block_size_;
+      const size_t k_in_blk = outlier_channels[c] % block_size_;
+      const uint8_t b_pair = b_column[blk * blob_size + k_in_blk / 2];
+      const int32_t b_value = (k_in_blk & 1) ? (b_pair >> 4) : (b_pair & 0x0F);
+      int32_t zero_point = 8;
+      if (zero_points_data != nullptr) {
+        const uint8_t zero_point_pair = zero_points_data[n * zero_points_column_size + blk / 2];
+        zero_point = (blk & 1) ? (zero_point_pair >> 4) : (zero_point_pair & 0x0F);
+      }
+      b_rows.get()[c * N_ + n] = static_cast<float>(b_value - zero_point) * scales_data[n * k_blks + blk];
+    }
+  }
+
+  // the outlier channels of the rows of A of a product, M x num_channels
+  auto a_columns = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(M) * num_channels);
+  for (size_t i = 0; i < helper.OutputOffsets().size(); ++i) {
+    const float* a_rows = a_data + helper.LeftOffsets()[i];
+    for (size_t m = 0; m < M; ++m) {
+      for (size_t c = 0; c < num_channels; ++c) {
+        a_columns.get()[m * num_channels + c] = a_rows[m * K_ + outlier_channels[c]];
+      }
+    }
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N_, num_channels, 1.0f, a_columns.get(), num_channels, b_rows.get(), N_,
+             1.0f, y_data + helper.OutputOffsets()[i], N_, ctx->GetOperatorThreadPool());
+  }
+
+  return Status::OK();
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(InputIndex::A);
@@ -340,18 +486,40 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
       const auto* zero_points_data = zero_points == nullptr ? nullptr : zero_points->DataRaw();
       const auto* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
 
+      AllocatorPtr allocator;
+      ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
       IAllocatorUniquePtr<std::byte> workspace{};
       const size_t workspace_size = MlasSQNBitGemmBatchWorkspaceSize(
           M, N, K, batch_count, nbits_, block_size_, compute_type);
       if (workspace_size > 0) {
-        AllocatorPtr allocator;
-        ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
         workspace = IAllocator::MakeUniquePtr<std::byte>(allocator, workspace_size);
       }
 
+      // The outlier channels are zero in the A that is quantized and are multiplied separately.
+      InlinedVector<size_t> outlier_channels;
+      IAllocatorUniquePtr<float> a_inliers{};
+      const float* a_quantized_data = a_data;
+      if (HandlesOutlierChannels(compute_type)) {
+        const size_t a_size = narrow<size_t>(a->Shape().Size());
+        const size_t num_rows = a_size / K;
+        outlier_channels = FindOutlierChannels(a_data, num_rows);
+        if (!outlier_channels.empty()) {
+          a_inliers = IAllocator::MakeUniquePtr<float>(allocator, a_size);
+          std::copy_n(a_data, a_size, a_inliers.get());
+          for (size_t m = 0; m < num_rows; ++m) {
+            float* a_row = a_inliers.get() + m * K;
+            for (size_t k : outlier_channels) {
+              a_row[k] = 0.0f;
+            }
+          }
+          a_quantized_data = a_inliers.get();
+        }
+      }
+
       InlinedVector<MLAS_SQNBIT_GEMM_DATA_PARAMS> data(batch_count);
       for (size_t i = 0; i < batch_count; ++i) {
-        data[i].A = a_data + helper.LeftOffsets()[i];
+        data[i].A = a_quantized_data + helper.LeftOffsets()[i];
         data[i].lda = lda;
 #ifdef MLAS_TARGET_AMD64_IX86
         if (compute_type == CompInt8) {
@@ -368,6 +536,10 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
       MlasSQNBitGemmBatch(M, N, K, batch_count, nbits_, block_size_, compute_type, data.data(), workspace.get(),
                           thread_pool);
 
+      if (!outlier_channels.empty()) {
+        ORT_RETURN_IF_ERROR(MultiplyOutlierChannels(ctx, helper, outlier_channels, a_data, y_data));
+      }
+
       return Status::OK();
     }
   }
@@ -391,8 +563,34 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_);
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
-    // dequantize b, only 4b quantization is supported for now
+  if (nbits_ != 4) {
+    if ((zero_points && zero_points->IsDataType<float>())) {
+      DequantizeBlockwiseNBits<float, float>(
+          tmp_b_data_ptr.get(),                         // dequantized output
+          b_data,                                       // quantized input
+          scales_data,                                  // quantization scales
+          static_cast<const float*>(zero_points_data),  // quantization zero points
+          reorder_idx_data,
+          static_cast<int32_t>(nbits_),       // number of bits per quantized value
+          static_cast<int32_t>(block_size_),  // quantization block size
+          static_cast<int32_t>(K_),           // number of rows in quantized input
+          static_cast<int32_t>(N_),           // number of columns in quantized input
+          thread_pool);
+    } else {
+      DequantizeBlockwiseNBits<float, uint8_t>(
+          tmp_b_data_ptr.get(),                           // dequantized output
+          b_data,                                         // quantized input
+          scales_data,                                    // quantization scales
+          static_cast<const uint8_t*>(zero_points_data),  // quantization zero points
+          reorder_idx_data,
+          static_cast<int32_t>(nbits_),       // number of bits per quantized value
+          static_cast<int32_t>(block_size_),  // quantization block size
+          static_cast<int32_t>(K_),           // number of rows in quantized input
+          static_cast<int32_t>(N_),           // number of columns in quantized input
+          thread_pool);
+    }
+  } else if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
+    // dequantize b, MlasDequantizeBlockwise() only supports 4b quantization
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
         b_data,                                         // quantized input
@@ -102,6 +102,59 @@ void DequantizeBlockwise(
       });
 }
 
+namespace {
+uint32_t ExtractNBits(const uint8_t* data, size_t bit_offset, int32_t bits) {
+  const uint8_t* p = data + bit_offset / 8;
+  const size_t shift = bit_offset % 8;
+  uint32_t value = p[0];
+  if (shift + static_cast<size_t>(bits) > 8) {
+    value |= static_cast<uint32_t>(p[1]) << 8;
+  }
+  return (value >> shift) & ((uint32_t{1} << bits) - 1);
+}
+}  // namespace
+
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,              // dequantized output
+    const uint8_t* quant_data,   // quantized input
+    const inputT* scales_data,   // quantization scales
+    const zeroT* zero_points,    // quantization zero points
+    const int32_t* reorder_idx,  // reorder_idx for groupwise quantization
+    int32_t bits,                // number of bits per quantized value
+    int32_t block_size,          // quantization block size
+    int32_t K,                   // number of rows in quantized input
+    int32_t N,                   // number of columns in quantized input
+    onnxruntime::concurrency::ThreadPool* pool) {
+  const size_t blocks_per_col = (static_cast<size_t>(K) + block_size - 1) / block_size;
+  const size_t blob_size = (static_cast<size_t>(block_size) * bits + 7) / 8;
+  const size_t zero_point_bytes_per_col = (blocks_per_col * bits + 7) / 8;
+  const float default_zero_point = static_cast<float>(1 << (bits - 1));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      pool, static_cast<std::ptrdiff_t>(N),
+      [&](std::ptrdiff_t n) {
+        const uint8_t* quant_col = quant_data + n * blocks_per_col * blob_size;
+        inputT* output_col = output + n * K;
+        for (int32_t k = 0; k < K; ++k) {
+          const size_t blk = static_cast<size_t>(k / block_size);
+          const size_t rid = reorder_idx ? static_cast<size_t>(reorder_idx[k]) : blk;
+          const uint32_t q = ExtractNBits(quant_col + blk * blob_size, static_cast<size_t>(k % block_size) * bits,
+                                          bits);
+          const float scale = static_cast<float>(scales_data[n * blocks_per_col + rid]);
+          float zp = default_zero_point;
+          if (zero_points) {
+            if constexpr (std::is_same_v<zeroT, inputT>) {
+              zp = static_cast<float>(zero_points[n * blocks_per_col + rid]);
+            } else {
+              zp = static_cast<float>(ExtractNBits(zero_points + n * zero_point_bytes_per_col, rid * bits, bits));
+            }
+          }
+          output_col[k] = static_cast<inputT>((static_cast<float>(q) - zp) * scale);
+        }
+      });
+}
+
 template void DequantizeBlockwise<float, uint8_t>(
     float* output, const uint8_t* quant_data, const float* scales_data,
     const uint8_t* zero_points, const int32_t* reorder_idx, int32_t block_size,
@@ -112,5 +165,15 @@ template void DequantizeBlockwise<float, float>(
     const float* zero_points, const int32_t* reorder_idx, int32_t block_size,
     bool columnwise, int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
 
+template void DequantizeBlockwiseNBits<float, uint8_t>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const uint8_t* zero_points, const int32_t* reorder_idx, int32_t bits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, float>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const float* zero_points, const int32_t* reorder_idx, int32_t bits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
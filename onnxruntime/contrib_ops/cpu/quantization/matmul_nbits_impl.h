@@ -19,5 +19,20 @@ void DequantizeBlockwise(
     int32_t N,                   // number of columns in quantized input
     onnxruntime::concurrency::ThreadPool* thread_pool);
 
+// Dequantizes B with 2 or 3 bits per value. Values (and uint8_t zero points) are packed densely, least significant
+// bits first, so a value may span two bytes. The output is [N, K], the same as DequantizeBlockwise().
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,              // dequantized output
+    const uint8_t* quant_data,   // quantized input
+    const inputT* scales_data,   // quantization scales
+    const zeroT* zero_points,    // quantization zero points
+    const int32_t* reorder_idx,  // reorder_idx for groupwise quantization
+    int32_t bits,                // number of bits per quantized value
+    int32_t block_size,          // quantization block size
+    int32_t K,                   // number of rows in quantized input
+    int32_t N,                   // number of columns in quantized input
+    onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/quantization/matmul_integer_base.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+enum class FusedActivation {
+  None,
+  Relu,
+  Gelu,
+};
+
+// Dequantizes the int32 accumulators of a tile, adds the bias, applies the activation and requantizes the result,
+// so the float values only live in a row sized buffer of the thread processing the tile.
+class QLinearFusedMatMulOutputProcessor : public MLAS_QGEMM_OUTPUT_PROCESSOR {
+ public:
+  QLinearFusedMatMulOutputProcessor(void* output, size_t output_leading_dimension,
+                                    const float* scale, bool per_column_scale, const float* bias,
+                                    FusedActivation activation, float output_scale, int32_t output_zero_point,
+                                    bool output_is_signed)
+      : output_(output),
+        output_leading_dimension_(output_leading_dimension),
+        scale_(scale),
+        per_column_scale_(per_column_scale),
+        bias_(bias),
+        activation_(activation),
+        output_scale_(output_scale),
+        output_zero_point_(output_zero_point),
+        output_is_signed_(output_is_signed) {
+  }
+
+  void Process(const int32_t* C, size_t StartM, size_t StartN, size_t CountM, size_t CountN,
+               size_t ldc) const override {
+    InlinedVector<float> values(CountN);
+    InlinedVector<float> temp(activation_ == FusedActivation::Gelu ? CountN : 0);
+
+    for (size_t m = StartM; m < StartM + CountM; m++) {
+      const int32_t* row = C + m * ldc + StartN;
+      for (size_t n = 0; n < CountN; n++) {
+        float value = static_cast<float>(row[n]) * scale_[per_column_scale_ ? StartN + n : 0];
+        if (bias_ != nullptr) {
+          value += bias_[StartN + n];
+        }
+        values[n] = value;
+      }
+
+      if (activation_ == FusedActivation::Relu) {
+        for (size_t n = 0; n < CountN; n++) {
+          values[n] = std::max(values[n], 0.0f);
+        }
+      } else if (activation_ == FusedActivation::Gelu) {
+        for (size_t n = 0; n < CountN; n++) {
+          temp[n] = values[n] * static_cast<float>(M_SQRT1_2);
+        }
+
+        MlasComputeErf(temp.data(), temp.data(), CountN);
+
+        for (size_t n = 0; n < CountN; n++) {
+          values[n] = 0.5f * values[n] * (temp[n] + 1.0f);
+        }
+      }
+
+      const size_t output_offset = m * output_leading_dimension_ + StartN;
+      if (output_is_signed_) {
+        MlasQuantizeLinear(values.data(), static_cast<int8_t*>(output_) + output_offset, CountN, output_scale_,
+                           static_cast<int8_t>(output_zero_point_));
+      } else {
+        MlasQuantizeLinear(values.data(), static_cast<uint8_t*>(output_) + output_offset, CountN, output_scale_,
+                           static_cast<uint8_t>(output_zero_point_));
+      }
+    }
+  }
+
+ private:
+  void* output_;
+  size_t output_leading_dimension_;
+  const float* scale_;
+  bool per_column_scale_;
+  const float* bias_;
+  FusedActivation activation_;
+  float output_scale_;
+  int32_t output_zero_point_;
+  bool output_is_signed_;
+};
+
+}  // namespace
+
+class QLinearFusedMatMul : public MatMulIntegerBase {
+ public:
+  QLinearFusedMatMul(const OpKernelInfo& info) : MatMulIntegerBase(info) {
+    const std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
+    if (activation == "Relu") {
+      activation_ = FusedActivation::Relu;
+    } else if (activation == "Gelu") {
+      activation_ = FusedActivation::Gelu;
+    } else {
+      ORT_ENFORCE(activation.empty(), "QLinearFusedMatMul : unsupported activation ", activation);
+    }
+  }
+
+  Status Compute(OpKernelContext* ctx) const override {
+    const auto* a = ctx->Input<Tensor>(IN_A);
+    const auto* b = packed_b_ ? nullptr : ctx->Input<Tensor>(IN_B);
+    const auto& b_shape = b ? b->Shape() : b_shape_;
+
+    const auto* a_zp = ctx->Input<Tensor>(IN_A_ZERO_POINT);
+    const auto* b_zp = ctx->Input<Tensor>(IN_B_ZERO_POINT);
+    const auto* y_zp = ctx->Input<Tensor>(IN_Y_ZERO_POINT);
+    const auto* a_scale = ctx->Input<Tensor>(IN_A_SCALE);
+    const auto* b_scale = ctx->Input<Tensor>(IN_B_SCALE);
+    const auto* y_scale = ctx->Input<Tensor>(IN_Y_SCALE);
+    const auto* bias = ctx->Input<Tensor>(IN_BIAS);
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_scale) && IsScalarOr1ElementVector(a_zp),
+                      "QLinearFusedMatMul : scale and zero point of input a must be scalars or 1D tensors of size 1");
+    ORT_RETURN_IF_NOT(IsBQuantParamSupported(b_scale->Shape(), b_shape) &&
+                          IsBQuantParamSupported(b_zp->Shape(), b_shape),
+                      "QLinearFusedMatMul : scale and zero point of input b must be scalars, 1D tensors of size 1, "
+                      "or last to second dimension is 1");
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_scale) && IsScalarOr1ElementVector(y_zp),
+                      "QLinearFusedMatMul : scale and zero point of output y must be scalars or 1D tensors of size 1");
+
+    MatMulComputeHelper helper;
+    ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape, &b_scale->Shape(), &b_zp->Shape()));
+    ORT_RETURN_IF_NOT(bias == nullptr ||
+                          (bias->Shape().NumDimensions() == 1 && bias->Shape()[0] == static_cast<int64_t>(helper.N())),
+                      "QLinearFusedMatMul : bias must be a 1D tensor whose size is the last dimension of b");
+
+    Tensor* y = ctx->Output(OUT_Y, helper.OutputShape());
+    // Bail out early if the output is going to be empty
+    if (y->Shape().Size() == 0)
+      return Status::OK();
+
+    // The accumulators are only dequantized with the input scales, as the bias and the activation are applied on
+    // the float values before they are requantized.
+    const auto* b_scale_data = b_scale->Data<float>();
+    const float a_scale_data = *(a_scale->Data<float>());
+    const int64_t dequant_scale_size = b_scale->Shape().Size();
+    std::vector<float> dequant_scales(narrow<size_t>(dequant_scale_size));
+    for (int64_t i = 0; i < dequant_scale_size; i++) {
+      dequant_scales[narrow<size_t>(i)] = a_scale_data * b_scale_data[narrow<size_t>(i)];
+    }
+
+    const size_t num_gemms = helper.OutputOffsets().size();
+    MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+    gemm_shape.M = static_cast<size_t>(helper.M());
+    gemm_shape.N = static_cast<size_t>(helper.N());
+    gemm_shape.K = static_cast<size_t>(helper.K());
+    gemm_shape.AIsSigned = a->IsDataType<int8_t>();
+    gemm_shape.BIsSigned = b ? b->IsDataType<int8_t>() : b_is_signed_;
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(gemm_shape.M) *
+                                         gemm_shape.N * sizeof(int32_t) * num_gemms);
+    BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(std::move(alloc)));
+    auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+    std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_params(num_gemms);
+    std::vector<QLinearFusedMatMulOutputProcessor> output_procs;
+    output_procs.reserve(num_gemms);
+
+    const bool is_output_signed = y->IsDataType<int8_t>();
+    const int32_t output_zero_point = is_output_signed ? *(static_cast<const int8_t*>(y_zp->DataRaw()))
+                                                       : *(static_cast<const uint8_t*>(y_zp->DataRaw()));
+    const uint8_t* b_data = b ? static_cast<const uint8_t*>(b->DataRaw())
+                              : static_cast<const uint8_t*>(packed_b_.get());
+    const auto* b_zp_data = static_cast<const uint8_t*>(b_zp->DataRaw());
+    for (size_t i = 0; i < num_gemms; i++) {
+      gemm_params[i].A = static_cast<const uint8_t*>(a->DataRaw()) + helper.LeftOffsets()[i];
+      gemm_params[i].lda = gemm_shape.K;
+      gemm_params[i].ZeroPointA = *(static_cast<const uint8_t*>(a_zp->DataRaw()));
+
+      gemm_params[i].B = b_data + helper.RightOffsets()[i];
+      gemm_params[i].ldb = gemm_shape.N;
+      gemm_params[i].BIsPacked = bool(packed_b_);
+      gemm_params[i].ZeroPointB = b_zp_data + helper.RightZeroPointOffsets()[i];
+
+      gemm_params[i].C = gemm_output + (gemm_shape.M * gemm_shape.N * i);
+      gemm_params[i].ldc = gemm_shape.N;
+
+      gemm_params[i].PerColumnZeroPoints = !IsScalarOr1ElementVector(b_zp);
+
+      output_procs.emplace_back(static_cast<uint8_t*>(y->MutableDataRaw()) + helper.OutputOffsets()[i],
+                                gemm_shape.N,
+                                dequant_scales.data() + helper.RightScaleOffsets()[i],
+                                dequant_scales.size() > 1,
+                                bias != nullptr ? bias->Data<float>() : nullptr,
+                                activation_,
+                                *(y_scale->Data<float>()),
+                                output_zero_point,
+                                is_output_signed);
+      gemm_params[i].OutputProcessor = &(output_procs[i]);
+    }
+
+    MlasGemmBatch(gemm_shape, gemm_params.data(), num_gemms, ctx->GetOperatorThreadPool());
+
+    return Status::OK();
+  }
+
+ protected:
+  int GetBIdx() const override {
+    return IN_B;
+  }
+
+ private:
+  enum InputTensors : int {
+    IN_A = 0,
+    IN_A_SCALE = 1,
+    IN_A_ZERO_POINT = 2,
+    IN_B = 3,
+    IN_B_SCALE = 4,
+    IN_B_ZERO_POINT = 5,
+    IN_Y_SCALE = 6,
+    IN_Y_ZERO_POINT = 7,
+    IN_BIAS = 8
+  };
+
+  enum OutputTensors : int {
+    OUT_Y = 0
+  };
+
+  FusedActivation activation_{FusedActivation::None};
+};
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearFusedMatMul,
+    kMSDomain,
+    1,
+    uint8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T3", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    QLinearFusedMatMul);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QLinearFusedMatMul,
+    kMSDomain,
+    1,
+    int8_t,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("T3", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    QLinearFusedMatMul);
+
+}  // namespace contrib
+}  // namespace onnxruntime
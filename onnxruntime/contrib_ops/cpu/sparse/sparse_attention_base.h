@@ -11,6 +11,11 @@
 #include "core/framework/op_kernel.h"
 #include "contrib_ops/cpu/utils/dump_tensor.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -65,26 +70,37 @@ class SparseAttentionBase {
     int past_buffer_sequence_length = static_cast<int>(past_key->Shape().GetDims()[2]);
     int present_buffer_sequence_length = static_cast<int>(present_key->Shape().GetDims()[2]);
 
-    // Allocate a buffer to store Softmax(QK)
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * parameters.total_sequence_length * sizeof(T);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-
     bool past_present_share_buffer = parameters.past_present_share_buffer;
     assert(past_present_share_buffer);
 
     auto* tp = context->GetOperatorThreadPool();
 
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+
+    if (HasSparseLayout(block_row_indices->Data<int32_t>(), parameters)) {
+      ComputeBlockSparseAttention<T>(
+          output->MutableData<T>(), Q, k, v, total_key_lengths->Data<int32_t>(),
+          batch_size, sequence_length, parameters.total_sequence_length,
+          past_buffer_sequence_length, present_buffer_sequence_length, head_size, parameters.hidden_size,
+          past_key->Data<T>(), present_key->MutableData<T>(), past_value->Data<T>(), present_value->MutableData<T>(),
+          past_present_share_buffer, packed_qkv,
+          block_row_indices->Data<int32_t>(), block_col_indices->Data<int32_t>(), parameters, tp);
+      return Status::OK();
+    }
+
+    // Allocate a buffer to store Softmax(QK)
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * parameters.total_sequence_length * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     ComputeAttentionProbs<T>(
         static_cast<T*>(attention_probs), Q, k, total_key_lengths->Data<int32_t>(),
         batch_size, sequence_length, parameters.total_sequence_length,
         past_buffer_sequence_length, present_buffer_sequence_length, head_size,
-        past_key->Data<T>(), present_key->MutableData<T>(), past_present_share_buffer, packed_qkv,
-        block_row_indices->Data<int32_t>(), block_col_indices->Data<int32_t>(), parameters, tp);
+        past_key->Data<T>(), present_key->MutableData<T>(), past_present_share_buffer, packed_qkv, tp);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
-    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
     ComputeVxAttentionScore<T>(
         output->MutableData<T>(), static_cast<T*>(attention_probs), v,
         total_key_lengths->Data<int32_t>(),
@@ -96,6 +112,214 @@ class SparseAttentionBase {
   }
 
  private:
+  // Whether any layout has zeros in its lower triangular blocks.
+  static bool HasSparseLayout(const int32_t* block_row_indices, const SparseAttentionParameters& parameters) {
+    const int dense_nonzero = (parameters.stride_row_indices * (parameters.stride_row_indices - 1)) / 2;
+    for (int layout_index = 0; layout_index < parameters.num_sparse_layout; layout_index++) {
+      if (block_row_indices[(layout_index + 1) * parameters.stride_row_indices - 1] < dense_nonzero) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Computes the attention of each head over the nonzero blocks of its layout only:
+  //  for each block of query rows, a tile of Q x K' is computed for each nonzero block of keys in the row of the
+  //  layout, and accumulated into output = Softmax(Q x K') x V with an online softmax, so the probabilities of the
+  //  whole sequence are never materialized. The layout is given in CSR format like in the CUDA kernel: the nonzero
+  //  blocks of block row r are block_col_indices[block_row_indices[r]:block_row_indices[r + 1]].
+  template <typename T>
+  void ComputeBlockSparseAttention(
+      T* output,                              // output buffer with size BxSxNxH
+      const T* Q,                             // query start pointer
+      const T* K,                             // key start pointer
+      const T* V,                             // value start pointer
+      const int32_t* total_key_lengths,       // total key sequence lengths (past + new)
+      int batch_size,                         // batch size
+      int sequence_length,                    // sequence length of query or new key
+      int total_sequence_length,              // maximum past_sequence_length + sequence_length
+      int past_buffer_sequence_length,        // sequence length of past_key or past_value
+      int present_buffer_sequence_length,     // sequence length of present_key or present_value
+      int head_size,                          // head size of Q, K, V
+      int hidden_size,                        // hidden size of Output
+      const T* past_key,                      // past key
+      T* present_key,                         // present key
+      const T* past_value,                    // past value
+      T* present_value,                       // present value
+      bool past_present_share_buffer,         // whether past and present share the buffer
+      bool packed_qkv,                        // whether Q, K, V are packed
+      const int32_t* block_row_indices,       // block row indices
+      const int32_t* block_col_indices,       // block column indices
+      SparseAttentionParameters& parameters,  // parameters
+      ThreadPool* tp) const {                 // thread pool
+    const bool is_prompt = (total_sequence_length == sequence_length);
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const size_t kv_input_chunk_length = q_input_chunk_length;
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;
+    const int block_size = parameters.sparse_block_size;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    // Estimate the keys each query attends to with the densest layout.
+    const int dense_nonzero = (parameters.stride_row_indices * (parameters.stride_row_indices - 1)) / 2;
+    int max_nonzero = 1;
+    for (int layout_index = 0; layout_index < parameters.num_sparse_layout; layout_index++) {
+      max_nonzero = std::max(max_nonzero, block_row_indices[(layout_index + 1) * parameters.stride_row_indices - 1]);
+    }
+    const double density = std::min(1.0, static_cast<double>(max_nonzero) / std::max(dense_nonzero, 1));
+
+    TensorOpCost unit_cost;
+    const double attended_keys = density * total_sequence_length;
+    unit_cost.compute_cycles = 4.0 * sequence_length * head_size * attended_keys;
+    unit_cost.bytes_loaded = static_cast<double>(sequence_length + 2 * attended_keys) * head_size * sizeof(T);
+    unit_cost.bytes_stored = static_cast<double>(3 * sequence_length * head_size * sizeof(T));
+
+    DUMP_CPU_TENSOR_INIT();
+    DUMP_CPU_TENSOR("block_row_indices", block_row_indices, parameters.num_sparse_layout, parameters.stride_row_indices);
+    DUMP_CPU_TENSOR("block_col_indices", block_col_indices, parameters.num_sparse_layout, parameters.stride_col_indices);
+
+    const int loop_len = batch_size * num_heads_;
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // a tile of scores for a block of queries and keys, and the accumulated output of the block of queries
+      std::vector<T> scores(static_cast<size_t>(block_size) * block_size);
+      std::vector<T> accumulator(static_cast<size_t>(block_size) * head_size);
+      std::vector<float> row_max(block_size);
+      std::vector<float> row_sum(block_size);
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i) / num_heads_;
+        const int head_index = static_cast<int>(i) % num_heads_;
+        const int past_seq_len = is_prompt ? 0 : (static_cast<int>(total_key_lengths[batch_index]) - sequence_length);
+        const size_t past_chunk_length = static_cast<size_t>(past_seq_len) * head_size;
+        const std::ptrdiff_t kv_head = i / kv_num_heads_factor;
+
+        const T* q;
+        const T* k;
+        const T* v;
+        if (packed_qkv) {
+          q = Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index;
+          k = K + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
+          v = V + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
+        } else {
+          q = Q + q_input_chunk_length * i;
+          k = K + kv_input_chunk_length * kv_head;
+          v = V + kv_input_chunk_length * kv_head;
+        }
+
+        // Concatenate past + new -> present
+        k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
+                                past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                                kv_head);
+        v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
+                                past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                                kv_head);
+
+        const int layout_id = head_index % parameters.num_sparse_layout;
+        const int32_t* layout_row_indices = block_row_indices + layout_id * parameters.stride_row_indices;
+        const int32_t* layout_col_indices = block_col_indices + layout_id * parameters.stride_col_indices;
+
+        T* output_head = output + (static_cast<ptrdiff_t>(batch_index) * sequence_length * num_heads_ + head_index) *
+                                      head_size;
+
+        for (int q_start = 0; q_start < sequence_length;) {
+          // The queries of the block row at absolute positions [q_abs_position, q_abs_position + q_rows)
+          const int q_abs_position = past_seq_len + q_start;
+          const int row_in_sparse_layout = q_abs_position / block_size;
+          const int q_rows = std::min(sequence_length - q_start, (row_in_sparse_layout + 1) * block_size - q_abs_position);
+
+          std::fill_n(row_max.begin(), q_rows, -std::numeric_limits<float>::infinity());
+          std::fill_n(row_sum.begin(), q_rows, 0.0f);
+          std::fill_n(accumulator.begin(), static_cast<size_t>(q_rows) * head_size, T{});
+
+          for (int j = layout_row_indices[row_in_sparse_layout]; j < layout_row_indices[row_in_sparse_layout + 1]; j++) {
+            const int k_start = layout_col_indices[j] * block_size;
+            // the keys of the block up to the last query of the block row, which masks the future keys
+            const int k_len = std::min(block_size, q_abs_position + q_rows - k_start);
+            if (k_len <= 0) {
+              continue;
+            }
+
+            math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, q_rows, k_len, head_size, alpha,
+                                        q + static_cast<size_t>(q_start) * head_size, head_size,
+                                        k + static_cast<size_t>(k_start) * head_size, head_size, 0.0f,
+                                        scores.data(), k_len, nullptr);
+
+            for (int r = 0; r < q_rows; r++) {
+              T* row_scores = scores.data() + static_cast<size_t>(r) * k_len;
+              const int causal_len = std::min(k_len, q_abs_position + r + 1 - k_start);
+              if (causal_len <= 0) {
+                std::fill_n(row_scores, k_len, T{});
+                continue;
+              }
+
+              float new_max = row_max[r];
+              for (int c = 0; c < causal_len; c++) {
+                new_max = std::max(new_max, static_cast<float>(row_scores[c]));
+              }
+
+              // Rescale what was accumulated with the previous maximum.
+              const float rescale = std::exp(row_max[r] - new_max);
+              if (rescale != 1.0f) {
+                row_sum[r] *= rescale;
+                T* row_accumulator = accumulator.data() + static_cast<size_t>(r) * head_size;
+                for (int h = 0; h < head_size; h++) {
+                  row_accumulator[h] = static_cast<T>(row_accumulator[h] * rescale);
+                }
+              }
+              row_max[r] = new_max;
+
+              for (int c = 0; c < causal_len; c++) {
+                const float p = std::exp(static_cast<float>(row_scores[c]) - new_max);
+                row_scores[c] = static_cast<T>(p);
+                row_sum[r] += p;
+              }
+              std::fill(row_scores + causal_len, row_scores + k_len, T{});
+            }
+
+            math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, q_rows, head_size, k_len, 1.0f,
+                                        scores.data(), k_len, v + static_cast<size_t>(k_start) * head_size, head_size,
+                                        1.0f, accumulator.data(), head_size, nullptr);
+          }
+
+          for (int r = 0; r < q_rows; r++) {
+            T* row_output = output_head + static_cast<size_t>(q_start + r) * hidden_size;
+            if (row_sum[r] == 0.0f) {
+              // No key of the layout is visible to this query, e.g. its block row is empty. Masking its scores
+              // attends to all its causal keys with the same weight, so average their values.
+              const int causal_length = q_abs_position + r + 1;
+              std::fill_n(row_output, head_size, T{});
+              for (int t = 0; t < causal_length; t++) {
+                const T* v_row = v + static_cast<size_t>(t) * head_size;
+                for (int h = 0; h < head_size; h++) {
+                  row_output[h] += v_row[h];
+                }
+              }
+              for (int h = 0; h < head_size; h++) {
+                row_output[h] = static_cast<T>(row_output[h] / causal_length);
+              }
+              continue;
+            }
+
+            const float inverse_sum = 1.0f / row_sum[r];
+            const T* row_accumulator = accumulator.data() + static_cast<size_t>(r) * head_size;
+            for (int h = 0; h < head_size; h++) {
+              row_output[h] = static_cast<T>(row_accumulator[h] * inverse_sum);
+            }
+          }
+
+          q_start += q_rows;
+        }
+
+        DUMP_STRING("i=", i, ",batch_index=", batch_index, ",head_index=", head_index,
+                    ",past_seq_len=", past_seq_len, ",layout_id=", layout_id);
+      }
+    });
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -115,9 +339,6 @@ class SparseAttentionBase {
       T* present_key,                         // present key
       bool past_present_share_buffer,         // whether past_key and present_key share the buffer
       bool packed_qkv,                        // whether Q, K, V are packed
-      const int32_t* block_row_indices,       // block row indices
-      const int32_t* block_col_indices,       // block column indices
-      SparseAttentionParameters& parameters,  // parameters
       ThreadPool* tp) const {                 // thread pool
     const bool is_prompt = (total_sequence_length == sequence_length);
     const ptrdiff_t packed_batch_stride =
@@ -150,17 +371,6 @@ class SparseAttentionBase {
     unit_cost.bytes_stored += bytes_to_copy_key;
 
     DUMP_CPU_TENSOR_INIT();
-    DUMP_CPU_TENSOR("block_row_indices", block_row_indices, parameters.num_sparse_layout, parameters.stride_row_indices);
-    DUMP_CPU_TENSOR("block_col_indices", block_col_indices, parameters.num_sparse_layout, parameters.stride_col_indices);
-
-    // Check whether each layout has sparse (has zero in lower triangular)
-    std::vector<bool> layout_has_sparse(parameters.num_sparse_layout);
-    for (int layout_index = 0; layout_index < parameters.num_sparse_layout; layout_index++) {
-      int nonzero_elements = block_row_indices[(layout_index + 1) * parameters.stride_row_indices - 1];
-      int dense_nonzero = (parameters.stride_row_indices * (parameters.stride_row_indices - 1)) / 2;
-      layout_has_sparse[layout_index] = nonzero_elements < dense_nonzero;
-      DUMP_STRING("layout_has_sparse[", layout_index, "]=", layout_has_sparse[layout_index]);
-    }
 
     ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       DUMP_STRING("batch_size=", batch_size, ",num_heads=", num_heads_, ",loop_len=", loop_len, ",begin=", begin, ",end=", end);
@@ -212,85 +422,13 @@ class SparseAttentionBase {
 
         // Compute Softmax for causal and output result in place.
         T* output_softmax = output;
-
-        int layout_id = head_index % parameters.num_sparse_layout;
-        bool is_sparse_layout = layout_has_sparse[layout_id];
-
-        DUMP_STRING("layout_id=", layout_id, ",is_sparse_layout=", is_sparse_layout);
-
-        if (!is_sparse_layout) {  // dense
-          for (int q_id = 0; q_id < sequence_length; q_id++) {
-            int causal_length = past_seq_len + q_id + 1;
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, causal_length, nullptr);
-            for (int remain_seq_id = causal_length; remain_seq_id < total_seq_len; remain_seq_id++) {
-              output_softmax[remain_seq_id] = 0.f;
-            }
-            output_softmax += total_seq_len;
+        for (int q_id = 0; q_id < sequence_length; q_id++) {
+          int causal_length = past_seq_len + q_id + 1;
+          ComputeAttentionSoftmaxInplace(output_softmax, 1, causal_length, nullptr);
+          for (int remain_seq_id = causal_length; remain_seq_id < total_seq_len; remain_seq_id++) {
+            output_softmax[remain_seq_id] = 0.f;
           }
-        } else {  // sparse
-          int q_id = 0;
-          bool has_sparse = false;
-          std::vector<int32_t> mask(parameters.max_sequence_length);
-
-          const int32_t* layout_row_indices = block_row_indices + layout_id * parameters.stride_row_indices;
-          const int32_t* layout_col_indices = block_col_indices + layout_id * parameters.stride_col_indices;
-          do {
-            int q_abs_position = past_seq_len + q_id;
-            int causal_length = q_abs_position + 1;
-
-            // Update mask when query token is the first or at the boundary of sparse block.
-            if (q_id == 0 || q_abs_position % parameters.sparse_block_size == 0) {
-              int row_in_sparse_layout = q_abs_position / parameters.sparse_block_size;
-              int start_in_col_indices = layout_row_indices[row_in_sparse_layout];
-              int end_in_col_indices = layout_row_indices[row_in_sparse_layout + 1];
-              int nonzero_blocks = end_in_col_indices - start_in_col_indices;
-              has_sparse = (nonzero_blocks != row_in_sparse_layout + 1);
-
-              DUMP_STRING("q_id=", q_id,
-                          ",q_abs_position=", q_abs_position,
-                          ",sparse_block_size=", parameters.sparse_block_size,
-                          ",row_in_sparse_layout=", row_in_sparse_layout,
-                          ",start_in_col_indices=", start_in_col_indices,
-                          ",end_in_col_indices=", end_in_col_indices,
-                          ",nonzero_blocks=", nonzero_blocks,
-                          ",has_sparse=", has_sparse);
-
-              // Expand attention mask for current row of q_id
-              if (has_sparse) {
-                int block_aligned_length = q_abs_position / parameters.sparse_block_size * parameters.sparse_block_size + parameters.sparse_block_size;
-                DUMP_STRING("block_aligned_length=", block_aligned_length);
-
-                std::fill_n(mask.begin(), block_aligned_length, 0);
-                for (int j = start_in_col_indices; j < end_in_col_indices; j++) {
-                  int col_in_sparse_layout = layout_col_indices[j];
-
-                  int offset = col_in_sparse_layout * parameters.sparse_block_size;
-                  for (int s = 0; s < parameters.sparse_block_size; s++, offset++) {
-                    mask[offset] = 1;
-                  }
-                }
-
-                DUMP_CPU_TENSOR("mask", mask, block_aligned_length);
-              }
-            }
-
-            // Update inline according to attention mask.
-            if (has_sparse) {
-              for (int s = 0; s < causal_length; s++) {
-                if (mask[s] == 0)
-                  output_softmax[s] = std::numeric_limits<T>::lowest();
-              }
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, causal_length, nullptr);
-
-            for (int remain_seq_id = causal_length; remain_seq_id < total_seq_len; remain_seq_id++) {
-              output_softmax[remain_seq_id] = 0.f;
-            }
-
-            output_softmax += total_seq_len;
-            q_id++;
-
-          } while (q_id < sequence_length);
+          output_softmax += total_seq_len;
         }
 
         DUMP_CPU_TENSOR("softmax", output, sequence_length, total_seq_len);
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/tensor/embedding_bag.h"
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather_rows.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind",
+                        std::vector<MLDataType>{
+                            DataTypeImpl::GetTensorType<int32_t>(),
+                            DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const Tensor& data = *context->Input<Tensor>(0);
+  const Tensor& indices = *context->Input<Tensor>(1);
+  const TensorShape& data_shape = data.Shape();
+  const TensorShape& indices_shape = indices.Shape();
+  ORT_RETURN_IF_NOT(data_shape.NumDimensions() >= 1 && indices_shape.NumDimensions() >= 1,
+                    "EmbeddingBag requires data and indices of rank >= 1, got ", data_shape, " and ", indices_shape);
+
+  TensorShapeVector output_dims(indices_shape.GetDims().begin(), indices_shape.GetDims().end() - 1);
+  output_dims.insert(output_dims.end(), data_shape.GetDims().begin() + 1, data_shape.GetDims().end());
+  Tensor& output = *context->Output(0, TensorShape(output_dims));
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  if (indices.IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(data, indices, output, tp);
+  }
+  return ComputeImpl<int64_t>(data, indices, output, tp);
+}
+
+template <typename Tind>
+Status EmbeddingBag::ComputeImpl(const Tensor& data, const Tensor& indices, Tensor& output,
+                                 concurrency::ThreadPool* tp) const {
+  const TensorShape& indices_shape = indices.Shape();
+  const int64_t num_rows = data.Shape()[0];
+  const ptrdiff_t row_size = narrow<ptrdiff_t>(data.Shape().SizeFromDimension(1));
+  const ptrdiff_t bag_size = narrow<ptrdiff_t>(indices_shape[indices_shape.NumDimensions() - 1]);
+  const ptrdiff_t num_bags = narrow<ptrdiff_t>(indices_shape.SizeToDimension(indices_shape.NumDimensions() - 1));
+
+  const Tind* indices_data = indices.Data<Tind>();
+  const int64_t num_indices = indices_shape.Size();
+  for (int64_t i = 0; i < num_indices; ++i) {
+    const Tind idx = indices_data[i];
+    if (idx < -num_rows || idx >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_rows, ",", num_rows - 1, "]");
+    }
+  }
+
+  if (num_bags == 0 || row_size == 0) {
+    return Status::OK();
+  }
+
+  const float* data_base = data.Data<float>();
+  float* output_base = output.MutableData<float>();
+  // The mean of an empty bag is NaN, as the ReduceMean of an empty axis.
+  const float count = static_cast<float>(bag_size);
+  const size_t row_bytes = static_cast<size_t>(row_size) * sizeof(float);
+  auto row = [&](const Tind* bag, ptrdiff_t j) {
+    const int64_t idx = bag[j] < 0 ? bag[j] + num_rows : bag[j];
+    return data_base + idx * row_size;
+  };
+
+  // Every bag is pooled by a single thread, in the order of its indices, while the rows of its next indices are
+  // prefetched.
+  const TensorOpCost cost{static_cast<double>(bag_size * row_size * sizeof(float)),
+                          static_cast<double>(row_bytes),
+                          static_cast<double>(bag_size * row_size)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_bags, cost, [&](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t b = first; b < last; ++b) {
+          const Tind* bag = indices_data + b * bag_size;
+          float* out = output_base + b * row_size;
+          for (ptrdiff_t j = 0; j < std::min(bag_size, gather_rows::kPrefetchDistance); ++j) {
+            gather_rows::PrefetchRow(row(bag, j), row_bytes);
+          }
+
+          if (bag_size == 0) {
+            std::fill_n(out, row_size, 0.0f);
+          } else {
+            gather_rows::CopyRow(out, row(bag, 0), row_bytes);
+          }
+          for (ptrdiff_t j = 1; j < bag_size; ++j) {
+            if (j + gather_rows::kPrefetchDistance < bag_size) {
+              gather_rows::PrefetchRow(row(bag, j + gather_rows::kPrefetchDistance), row_bytes);
+            }
+            const float* in = row(bag, j);
+            for (ptrdiff_t k = 0; k < row_size; ++k) {
+              out[k] += in[k];
+            }
+          }
+
+          if (mean_) {
+            for (ptrdiff_t k = 0; k < row_size; ++k) {
+              out[k] /= count;
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Gather of the rows of an embedding table followed by the sum or the mean of the rows of every bag.
+// See the EmbeddingBag schema and EmbeddingBagFusion.
+class EmbeddingBag final : public OpKernel {
+ public:
+  EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+    const std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag mode must be 'sum' or 'mean', got ", mode);
+    mean_ = mode == "mean";
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(const Tensor& data, const Tensor& indices, Tensor& output,
+                     concurrency::ThreadPool* tp) const;
+
+  bool mean_{false};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
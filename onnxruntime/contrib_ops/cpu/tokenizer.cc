@@ -8,6 +8,7 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
 #ifdef _MSC_VER
@@ -16,6 +17,7 @@
 #endif
 
 #include <optional>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -45,12 +47,12 @@ class Tokenizer final : public OpKernel {
   Status CharTokenize(OpKernelContext* context, size_t N, size_t C,
                       gsl::span<const int64_t> input_dims) const;
 
-  Status SeparatorExpressionTokenizer(OpKernelContext* context, size_t N, size_t C,
-                                      gsl::span<const int64_t> input_dims) const;
+  // Tokenizes the strings with the separators or the tokenexp in batches of rows split between the threads.
+  Status ExpressionTokenize(OpKernelContext* ctx, gsl::span<const int64_t> input_dims) const;
 
-  Status TokenExpression(OpKernelContext* ctx,
-                         size_t N, size_t C,
-                         gsl::span<const int64_t> input_dims) const;
+  Status SeparatorExpressionTokenizer(const std::string& s, SlicesVector& row, SlicesVector& tokens) const;
+
+  Status TokenExpression(const std::string& s, SlicesVector& row) const;
 
   void OutputData(gsl::span<const SlicesVector> rows,
                   size_t max_tokens, size_t max_output_index, std::string* output_data) const;
@@ -60,6 +62,8 @@ class Tokenizer final : public OpKernel {
   size_t mincharnum_{0};
   bool char_tokenezation_{false};
   InlinedVector<std::unique_ptr<re2::RE2>> separators_;
+  // separators without any regex syntax, which are found with a byte search instead of RE2. empty for the others.
+  InlinedVector<std::string> literal_separators_;
   std::unique_ptr<re2::RE2> regex_;
 };
 
@@ -125,6 +129,8 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
           ORT_THROW("Can not digest separators: ", sep, " ", regex->error());
         }
         separators_.push_back(std::move(regex));
+        constexpr std::string_view kRegexSyntax = "\\^$.|?*+()[]{}";
+        literal_separators_.push_back(sep.find_first_of(kRegexSyntax) == std::string::npos ? sep : std::string());
       }
     } else {
       // Use tokenexp
@@ -314,6 +320,15 @@ class MemoryAllocator {
 };
 
 #endif
+
+// Rows tokenized by one thread. The rows are destroyed before the allocator of their tokens.
+struct TokenizedBatch {
+  std::optional<MemoryAllocator> allocator;
+  std::vector<SlicesVector> rows;
+  size_t max_tokens = 0;
+  Status status;
+};
+
 }  // namespace
 
 void Tokenizer::OutputData(gsl::span<const SlicesVector> rows,
@@ -340,223 +355,220 @@ void Tokenizer::OutputData(gsl::span<const SlicesVector> rows,
   }
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               gsl::span<const int64_t> input_dims) const {
+Status Tokenizer::SeparatorExpressionTokenizer(const std::string& s, SlicesVector& row, SlicesVector& tokens) const {
   using namespace re2;
 
-  auto X = ctx->Input<Tensor>(0);
-  const auto input_span = X->DataAsSpan<std::string>();
-
-  // Let's estimate maximum number of tokens
-  // It is hard to estimate the number of separate characters that would not appear in the
-  // output.
-  size_t total_tokens_estimate = 0;
-  size_t max_tokens_per_row = 0;
-  ORT_RETURN_IF_ERROR(EstimateNumberOfTokens(input_span, max_tokens_per_row, total_tokens_estimate));
-  // Add a scratch token vector allocation
-  total_tokens_estimate += max_tokens_per_row;
-
-  // Pre-allocate memory for all tokens (StringPieces)
-  MemoryAllocator allocator(total_tokens_estimate);
-
-  // Make sure the vectors below are destroyed before the allocator
-  const size_t vector_num = SafeInt<size_t>(N) * C;
-
-  std::vector<SlicesVector> rows;
-  rows.reserve(vector_num);
-
-  // Re-use the same vector for each tokenization round
-  SlicesVector tokens = allocator.CreateVectorWithAllocator();
-  tokens.reserve(max_tokens_per_row);
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   constexpr RE2::Anchor anchor = RE2::UNANCHORED;
 
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  for (const auto& s : input_span) {
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_len(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                  utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  size_t utf8_chars = 0;  // length in utf8 chars
+  if (!utf8_len(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
 
-    const auto expected_tokens = std::max<size_t>(1, utf8_chars / mincharnum_);
-    auto& row = allocator.EmplaceBack(rows);
-    row.reserve(expected_tokens);
-    row.emplace_back(s);
+  const auto expected_tokens = std::max<size_t>(1, utf8_chars / mincharnum_);
+  row.reserve(expected_tokens);
+  row.emplace_back(s);
 
-    for (const auto& sep : separators_) {
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
+  for (size_t sep_idx = 0; sep_idx < separators_.size(); ++sep_idx) {
+    const auto& sep = separators_[sep_idx];
+    const std::string& literal = literal_separators_[sep_idx];
+    for (const auto& text : row) {
+      const auto end_pos = text.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
 
-        bool match = true;
-        do {
+      bool match = true;
+      do {
+        size_t match_pos = 0;
+        size_t match_len = 0;
+        if (!literal.empty()) {
+          // std::string_view::find scans for the first byte of the separator with memchr
+          match_pos = std::string_view(text.data(), end_pos).find(literal, start_pos);
+          match = match_pos != std::string_view::npos;
+          match_len = literal.size();
+        } else {
           match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
           if (match) {
-            // Record  pos/len
             assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + std::string{submatch});
-            }
-            if (utf8_chars >= mincharnum_) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
+            match_pos = submatch.data() - text.data();
+            match_len = submatch.length();
+          }
+        }
+        if (match) {
+          // Record  pos/len
+          assert(match_pos >= start_pos);
+          auto token_len = match_pos - start_pos;
+          utf8_chars = 0;
+          bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                token_len, utf8_chars);
+          if (!valid) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + std::string(text.data() + match_pos, match_len));
+          }
+          if (utf8_chars >= mincharnum_) {
+            tokens.emplace_back(text.data() + start_pos, token_len);
+          }
+          // Update starting position
+          // Guard against empty string match
+          if (match_len > 0) {
+            start_pos = match_pos + match_len;
           } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= mincharnum_) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
+            size_t bytes = 0;
+            utf8_bytes(text.data()[match_pos], bytes);
+            start_pos = match_pos + bytes;
           }
-        } while (match);
-      }  // row
-
-      // We want to preserve the buffer for the next separator
-      // copying slices is cheaper than allocating new memory
-      if (!tokens.empty()) {
-        row = tokens;
-        tokens.clear();
-        continue;
-      }
+        } else {
+          // record trailing token
+          auto trailing_len = end_pos - start_pos;
+          utf8_chars = 0;
+          utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                   trailing_len, utf8_chars);
+          if (utf8_chars >= mincharnum_) {
+            tokens.emplace_back(text.data() + start_pos, trailing_len);
+          }
+        }
+      } while (match);
+    }  // row
 
-      // Nothing more to match for any remaining separators
-      row.clear();
+    // We want to preserve the buffer for the next separator
+    // copying slices is cheaper than allocating new memory
+    if (!tokens.empty()) {
+      row = tokens;
       tokens.clear();
-      break;
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-  }
-
-  TensorShapeVector output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to either empty input
-  // or everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
-
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
-
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->MutableData<std::string>();
+      continue;
+    }
 
-  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data);
+    // Nothing more to match for any remaining separators
+    row.clear();
+    tokens.clear();
+    break;
+  }  // separators_
 
   return Status::OK();
 }
 
-Status Tokenizer::TokenExpression(OpKernelContext* ctx,
-                                  size_t N, size_t C,
-                                  gsl::span<const int64_t> input_dims) const {
+Status Tokenizer::TokenExpression(const std::string& s, SlicesVector& row) const {
   using namespace re2;
 
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  const auto input_span = X->DataAsSpan<std::string>();
-
-  // Let's estimate maximum number of tokens
-  size_t total_tokens_estimate = 0;
-  size_t max_tokens_per_row = 0;
-  ORT_RETURN_IF_ERROR(EstimateNumberOfTokens(input_span, max_tokens_per_row, total_tokens_estimate));
-
-  // Pre-allocate memory for all tokens (StringPieces)
-  MemoryAllocator allocator(total_tokens_estimate);
-
-  // Make sure the vectors below are destroyed before the allocator
-  const size_t vector_num = SafeInt<size_t>(N) * C;
-
-  // We use std::vector in this case, because InlinedVector::clear() is incompatible
-  // with std::vector. It also deallocates memory, which is not what we want.
-  std::vector<SlicesVector> rows;
-  rows.reserve(vector_num);
-
   // We do not constraint the search to match
   // on the beginning or end of the string
   constexpr RE2::Anchor anchor = RE2::UNANCHORED;
 
-  for (const auto& s : input_span) {
-    size_t utf8_chars = 0;
-    utf8_len(reinterpret_cast<const unsigned char*>(s.data()), s.size(), utf8_chars);
+  size_t utf8_chars = 0;
+  utf8_len(reinterpret_cast<const unsigned char*>(s.data()), s.size(), utf8_chars);
+
+  if (utf8_chars >= mincharnum_) {
+    auto estimated_tokens = std::max<size_t>(1, utf8_chars / mincharnum_);
+    row.reserve(estimated_tokens);
+
+    StringPiece text(s);
+    const auto end_pos = s.length();
+    size_t start_pos = 0;
+    StringPiece submatch;
+
+    bool match = true;
+    do {
+      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+      if (match) {
+        // Record  pos/len
+        assert(submatch.data() != nullptr);
+        size_t match_pos = submatch.data() - s.data();
+        assert(match_pos >= start_pos);
+        // Guard against empty match and make
+        // sure we make progress either way
+        auto token_len = submatch.length();
+        utf8_chars = 0;
+        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                        "Match contains invalid utf8 chars: " + std::string{submatch});
+        }
+        if (utf8_chars >= mincharnum_) {
+          row.push_back(submatch);
+          start_pos = match_pos + token_len;
+        } else {
+          size_t bytes = 0;
+          utf8_bytes(*submatch.data(), bytes);
+          start_pos = match_pos + bytes;
+        }
+      }
+    } while (match);
+  }
 
-    auto& row = allocator.EmplaceBack(rows);
+  return Status::OK();
+}
 
-    if (utf8_chars >= mincharnum_) {
-      auto estimated_tokens = std::max<size_t>(1, utf8_chars / mincharnum_);
-      row.reserve(estimated_tokens);
+Status Tokenizer::ExpressionTokenize(OpKernelContext* ctx, gsl::span<const int64_t> input_dims) const {
+  auto X = ctx->Input<Tensor>(0);
+  const auto input_span = X->DataAsSpan<std::string>();
 
-      StringPiece text(s);
-      const auto end_pos = s.length();
-      size_t start_pos = 0;
-      StringPiece submatch;
+  // RE2 is thread safe, so batches of rows are tokenized in parallel, each with its own allocator for the tokens.
+  // A batch has at least kMinBytesPerBatch bytes on average so small inputs are not worth the threads.
+  constexpr size_t kMinBytesPerBatch = 16 * 1024;
+  size_t total_bytes = 0;
+  for (const auto& s : input_span) {
+    total_bytes += s.size();
+  }
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const size_t num_batches = std::max<size_t>(
+      1, std::min<size_t>({static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool)),
+                           total_bytes / kMinBytesPerBatch, input_span.size()}));
+
+  std::vector<TokenizedBatch> batches(num_batches);
+  auto tokenize_batch = [&](TokenizedBatch& batch, gsl::span<const std::string> strings) -> Status {
+    // Let's estimate maximum number of tokens
+    // It is hard to estimate the number of separate characters that would not appear in the
+    // output.
+    size_t total_tokens_estimate = 0;
+    size_t max_tokens_per_row = 0;
+    ORT_RETURN_IF_ERROR(EstimateNumberOfTokens(strings, max_tokens_per_row, total_tokens_estimate));
+
+    if (separators_.empty()) {
+      // Pre-allocate memory for all tokens (StringPieces)
+      auto& allocator = batch.allocator.emplace(total_tokens_estimate);
+      batch.rows.reserve(strings.size());
+      for (const auto& s : strings) {
+        auto& row = allocator.EmplaceBack(batch.rows);
+        ORT_RETURN_IF_ERROR(TokenExpression(s, row));
+        batch.max_tokens = std::max(batch.max_tokens, row.size());
+      }
+      return Status::OK();
+    }
 
-      bool match = true;
-      do {
-        match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-        if (match) {
-          // Record  pos/len
-          assert(submatch.data() != nullptr);
-          size_t match_pos = submatch.data() - s.data();
-          assert(match_pos >= start_pos);
-          // Guard against empty match and make
-          // sure we make progress either way
-          auto token_len = submatch.length();
-          utf8_chars = 0;
-          if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                          "Match contains invalid utf8 chars: " + std::string{submatch});
-          }
-          if (utf8_chars >= mincharnum_) {
-            row.push_back(submatch);
-            start_pos = match_pos + token_len;
-          } else {
-            size_t bytes = 0;
-            utf8_bytes(*submatch.data(), bytes);
-            start_pos = match_pos + bytes;
-          }
-        }
-      } while (match);
+    // Add a scratch token vector allocation
+    auto& allocator = batch.allocator.emplace(total_tokens_estimate + max_tokens_per_row);
+    batch.rows.reserve(strings.size());
+
+    // Re-use the same vector for each tokenization round
+    SlicesVector tokens = allocator.CreateVectorWithAllocator();
+    tokens.reserve(max_tokens_per_row);
+    for (const auto& s : strings) {
+      auto& row = allocator.EmplaceBack(batch.rows);
+      ORT_RETURN_IF_ERROR(SeparatorExpressionTokenizer(s, row, tokens));
+      batch.max_tokens = std::max(batch.max_tokens, row.size());
     }
-    max_tokens = std::max(max_tokens, row.size());
+    return Status::OK();
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, narrow<std::ptrdiff_t>(num_batches), [&](std::ptrdiff_t batch_idx) {
+        const auto work = concurrency::ThreadPool::PartitionWork(batch_idx, num_batches, input_span.size());
+        auto& batch = batches[batch_idx];
+        batch.status = tokenize_batch(batch, input_span.subspan(work.start, work.end - work.start));
+      });
+
+  size_t max_tokens = 0;
+  for (const auto& batch : batches) {
+    ORT_RETURN_IF_ERROR(batch.status);
+    max_tokens = std::max(max_tokens, batch.max_tokens);
   }
 
-  // Check for empty output
   TensorShapeVector output_dims(input_dims.begin(), input_dims.end());
   // Check if we have no output due to either empty input
-  // everything is a separator
+  // or everything is a separator
   if (max_tokens == 0) {
     output_dims.push_back(0);
     TensorShape output_shape(output_dims);
@@ -573,8 +585,14 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
 
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
+  const size_t output_size = narrow<size_t>(output_shape.Size());
 
-  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, narrow<std::ptrdiff_t>(num_batches), [&](std::ptrdiff_t batch_idx) {
+        const auto work = concurrency::ThreadPool::PartitionWork(batch_idx, num_batches, input_span.size());
+        const size_t output_offset = work.start * max_tokens;
+        OutputData(batches[batch_idx].rows, max_tokens, output_size - output_offset, output_data + output_offset);
+      });
 
   return Status::OK();
 }
@@ -620,12 +638,8 @@ Status Tokenizer::Compute(OpKernelContext* ctx) const {
   if (char_tokenezation_) {
     s = CharTokenize(ctx, N, C, input_dims);
   } else {
-    if (!separators_.empty()) {
-      s = SeparatorExpressionTokenizer(ctx, N, C, input_dims);
-    } else {
-      assert(regex_ != nullptr);
-      s = TokenExpression(ctx, N, C, input_dims);
-    }
+    assert(!separators_.empty() || regex_ != nullptr);
+    s = ExpressionTokenize(ctx, input_dims);
   }
   return s;
 }
@@ -277,6 +277,7 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
+    profile::NvtxScopedRange step_range("BeamSearchStep", profile::Color::Cyan, static_cast<uint64_t>(current_length));
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
     dumper->Print("***CurrentLength", cur_len, true);
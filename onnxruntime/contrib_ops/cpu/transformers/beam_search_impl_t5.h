@@ -296,7 +296,13 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
     }
   }
 
+  // The CUDA scorer reports whether all the batches are finished once the GPU ran it. When the feeds of the next step
+  // don't need the results of the scorer on the CPU, the next step is launched before waiting for the report, so the
+  // GPU doesn't idle between the steps, and the step is discarded if all the batches were finished.
+  const bool launch_next_step_before_done = this->IsCuda() && decoder_subgraph_.has_decoder_masked_attention_;
+
   while (current_length < parameters->max_length) {
+    profile::NvtxScopedRange step_range("BeamSearchStep", profile::Color::Cyan, static_cast<uint64_t>(current_length));
     iteration_counter++;
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
@@ -330,6 +336,10 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
 
     ORT_RETURN_IF_ERROR(status);
 
+    if (launch_next_step_before_done && this->beam_scorer_->IsDoneLater()) {
+      break;
+    }
+
 #ifdef DEBUG_GENERATION
     for (int i = 0; i <= decoder_subgraph_.GetFirstPresentOutputIndex(); i++) {
       dumper->Print("decoder_fetches", i, true);
@@ -349,9 +359,7 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
       break;
     }
 
-    // TODO: If this is safe to do after update_decoder_feeds_func, move it later so that we can speculatively run the next steps while we wait
-    // for the done result to transfer to the CPU
-    if (this->beam_scorer_->IsDoneLater()) {
+    if (!launch_next_step_before_done && this->beam_scorer_->IsDoneLater()) {
       break;
     }
 
@@ -352,7 +352,13 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
     }
   }
 
+  // The CUDA scorer reports whether all the batches are finished once the GPU ran it. When the feeds of the next step
+  // don't need the results of the scorer on the CPU, the next step is launched before waiting for the report, so the
+  // GPU doesn't idle between the steps, and the step is discarded if all the batches were finished.
+  const bool launch_next_step_before_done = this->IsCuda() && decoder_subgraph_.has_decoder_masked_attention_;
+
   while (current_length < parameters->max_length) {
+    profile::NvtxScopedRange step_range("BeamSearchStep", profile::Color::Cyan, static_cast<uint64_t>(current_length));
     iteration_counter++;
 #ifdef DEBUG_GENERATION
     auto cur_len = std::to_string(current_length);
@@ -382,6 +388,11 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
 
     ORT_RETURN_IF_ERROR(status);
 
+    if (launch_next_step_before_done && this->beam_scorer_->IsDoneLater()) {
+      --iteration_counter;
+      break;
+    }
+
     if (decoder_subgraph_.output_cross_qk_) {
       int decoder_output_first_cross_qk = decoder_subgraph_.GetFirstPresentOutputIndex() + (2 * decoder_subgraph_.num_layers);
       ORT_RETURN_IF_ERROR(this->update_decoder_cross_qk_func_(
@@ -416,9 +427,7 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
       break;
     }
 
-    // TODO: If this is safe to do after update_decoder_feeds_func, move it later so that we can speculatively run the next steps while we wait
-    // for the done result to transfer to the CPU
-    if (this->beam_scorer_->IsDoneLater()) {
+    if (!launch_next_step_before_done && this->beam_scorer_->IsDoneLater()) {
       break;
     }
 
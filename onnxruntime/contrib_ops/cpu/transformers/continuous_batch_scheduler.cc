@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/float16.h"
+#include "contrib_ops/cpu/transformers/continuous_batch_scheduler.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+template <typename T>
+ContinuousBatchScheduler<T>::ContinuousBatchScheduler(PagedKVCache<T>& cache, int max_batch_size, int eos_token_id,
+                                                      PrefixKVCache<T>* prefix_cache)
+    : cache_(cache), max_batch_size_(max_batch_size), eos_token_id_(eos_token_id), prefix_cache_(prefix_cache) {
+  ORT_ENFORCE(max_batch_size > 0);
+}
+
+template <typename T>
+void ContinuousBatchScheduler<T>::AddRequest(int64_t request_id, gsl::span<const int32_t> prompt_ids,
+                                             int max_new_tokens) {
+  ORT_ENFORCE(!prompt_ids.empty(), "The prompt of request ", request_id, " is empty.");
+  ORT_ENFORCE(max_new_tokens > 0, "max_new_tokens of request ", request_id, " shall be positive.");
+
+  Request request;
+  request.request_id = request_id;
+  request.token_ids.assign(prompt_ids.begin(), prompt_ids.end());
+  request.prompt_length = static_cast<int>(prompt_ids.size());
+  request.max_new_tokens = max_new_tokens;
+  waiting_.push_back(std::move(request));
+}
+
+template <typename T>
+void ContinuousBatchScheduler<T>::Preempt(Request& request) {
+  cache_.ReleaseSequence(request.sequence_id);
+  request.sequence_id = -1;
+  request.num_cached = 0;
+}
+
+template <typename T>
+Status ContinuousBatchScheduler<T>::Schedule(std::vector<ScheduledSequence>& batch) {
+  batch.clear();
+
+  // Reserve the next position of every running sequence. When the cache is full, drop cached prefixes first,
+  // then preempt from the back so that the oldest sequences, which hold the most work, keep running.
+  bool preempted = false;
+  size_t i = 0;
+  while (i < running_.size()) {
+    Request& request = running_[i];
+    const int new_tokens = static_cast<int>(request.token_ids.size()) - request.num_cached;
+    if (cache_.AppendTokens(request.sequence_id, new_tokens).IsOK()) {
+      ++i;
+      continue;
+    }
+    if (prefix_cache_ != nullptr && prefix_cache_->Evict(1) > 0) {
+      continue;
+    }
+
+    preempted = true;
+    Preempt(running_.back());
+    waiting_.push_front(std::move(running_.back()));
+    running_.pop_back();
+  }
+
+  // Admit waiting requests unless running sequences were just preempted, which would only evict them again.
+  if (!preempted || running_.empty()) {
+    while (!waiting_.empty() && static_cast<int>(running_.size()) < max_batch_size_) {
+      Request& request = waiting_.front();
+      const int tokens = static_cast<int>(request.token_ids.size());
+      if (prefix_cache_ != nullptr) {
+        request.sequence_id = prefix_cache_->AddSequence(request.token_ids, request.num_cached);
+      } else {
+        request.sequence_id = cache_.AddSequence();
+      }
+
+      // the cached prefix is made of full blocks
+      const int required_blocks = BlocksFor(tokens) - request.num_cached / cache_.BlockSize();
+      if (prefix_cache_ != nullptr && required_blocks > cache_.NumFreeBlocks()) {
+        prefix_cache_->Evict(required_blocks - cache_.NumFreeBlocks());
+      }
+      if (required_blocks > cache_.NumFreeBlocks()) {
+        Preempt(request);
+        if (running_.empty()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Request ", request.request_id, " needs ", required_blocks,
+                                 " blocks of the paged kv cache, which has ", cache_.NumFreeBlocks(), " free.");
+        }
+        break;
+      }
+
+      ORT_RETURN_IF_ERROR(cache_.AppendTokens(request.sequence_id, tokens - request.num_cached));
+      running_.push_back(std::move(request));
+      waiting_.pop_front();
+    }
+  }
+
+  batch.reserve(running_.size());
+  for (const Request& request : running_) {
+    gsl::span<const int32_t> token_ids(request.token_ids);
+    batch.push_back({request.request_id, request.sequence_id, request.num_cached,
+                     token_ids.subspan(request.num_cached)});
+  }
+  return Status::OK();
+}
+
+template <typename T>
+void ContinuousBatchScheduler<T>::CompleteStep(gsl::span<const int32_t> next_tokens,
+                                               std::vector<FinishedRequest>& finished) {
+  ORT_ENFORCE(next_tokens.size() == running_.size(), "Expected ", running_.size(), " tokens, got ",
+              next_tokens.size());
+
+  std::vector<Request> running;
+  running.reserve(running_.size());
+  for (size_t i = 0; i < running_.size(); i++) {
+    Request& request = running_[i];
+    if (prefix_cache_ != nullptr && request.num_cached < request.prompt_length) {
+      // the prompt step was just run
+      gsl::span<const int32_t> token_ids(request.token_ids);
+      prefix_cache_->Insert(request.sequence_id, token_ids.first(request.prompt_length));
+    }
+    request.num_cached = static_cast<int>(request.token_ids.size());
+    request.token_ids.push_back(next_tokens[i]);
+
+    const int generated = static_cast<int>(request.token_ids.size()) - request.prompt_length;
+    if (next_tokens[i] == eos_token_id_ || generated >= request.max_new_tokens) {
+      cache_.ReleaseSequence(request.sequence_id);
+      finished.push_back({request.request_id, std::vector<int32_t>(request.token_ids.begin() + request.prompt_length,
+                                                                   request.token_ids.end())});
+    } else {
+      running.push_back(std::move(request));
+    }
+  }
+  running_ = std::move(running);
+}
+
+template class ContinuousBatchScheduler<float>;
+template class ContinuousBatchScheduler<MLFloat16>;
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
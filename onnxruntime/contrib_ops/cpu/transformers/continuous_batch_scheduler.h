@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// A sequence scheduled for the next decoding step.
+struct ScheduledSequence {
+  int64_t request_id;
+  int sequence_id;                     // sequence of the paged kv cache
+  int first_position;                  // position of input_ids[0]; 0 for the prompt (prefill) step
+  gsl::span<const int32_t> input_ids;  // tokens to run, valid until the step is completed
+};
+
+struct FinishedRequest {
+  int64_t request_id;
+  std::vector<int32_t> output_ids;  // generated tokens, excluding the prompt
+};
+
+// Iteration-level scheduler for generation (continuous batching).
+//
+// Requests join and leave the batch between decoding steps instead of the batch running until every sequence
+// is done. Each step, the running sequences decode one token and waiting requests are admitted for their prompt
+// step while the batch size and the free blocks of the paged kv cache allow it. When the cache cannot hold
+// the next token of every running sequence, the most recently admitted sequences are preempted: their blocks are
+// released and they go back to the front of the queue, to be recomputed from prompt + generated tokens.
+//
+// With a prefix cache, an admitted request starts from the cached keys and values of its longest cached prompt
+// prefix (first_position is the prefix length), and the prompt blocks are cached after its prompt step. Cached
+// blocks are evicted when a request cannot be admitted otherwise.
+//
+// The caller runs the model on the scheduled batch, writes the new keys and values to the cache at
+// first_position.., and reports the sampled tokens with CompleteStep.
+template <typename T>
+class ContinuousBatchScheduler {
+ public:
+  ContinuousBatchScheduler(PagedKVCache<T>& cache, int max_batch_size, int eos_token_id,
+                           PrefixKVCache<T>* prefix_cache = nullptr);
+
+  // Queues a request. max_new_tokens is the number of tokens to generate at most.
+  void AddRequest(int64_t request_id, gsl::span<const int32_t> prompt_ids, int max_new_tokens);
+
+  // Selects the sequences of the next step and reserves their positions in the cache. The batch is empty when
+  // there is nothing to run. Fails when a waiting request cannot fit in an empty cache.
+  Status Schedule(std::vector<ScheduledSequence>& batch);
+
+  // Appends the sampled token of each sequence of the last scheduled batch, in batch order. Sequences that
+  // produce the end of sequence token or reach max_new_tokens leave the batch and release their blocks.
+  void CompleteStep(gsl::span<const int32_t> next_tokens, std::vector<FinishedRequest>& finished);
+
+  bool HasPendingWork() const { return !running_.empty() || !waiting_.empty(); }
+  size_t NumRunning() const { return running_.size(); }
+  size_t NumWaiting() const { return waiting_.size(); }
+
+ private:
+  struct Request {
+    int64_t request_id;
+    std::vector<int32_t> token_ids;  // prompt followed by the generated tokens
+    int prompt_length;
+    int max_new_tokens;
+    int sequence_id = -1;
+    int num_cached = 0;  // tokens whose keys and values are in the cache
+  };
+
+  int BlocksFor(int token_count) const { return (token_count + cache_.BlockSize() - 1) / cache_.BlockSize(); }
+  void Preempt(Request& request);
+
+  PagedKVCache<T>& cache_;
+  int max_batch_size_;
+  int eos_token_id_;
+  PrefixKVCache<T>* prefix_cache_;
+
+  std::vector<Request> running_;  // in admission order, which is also the order of the scheduled batch
+  std::deque<Request> waiting_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include <vector>
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/generation_shared.h"
+#include "core/providers/cuda/nvtx_profile.h"
 
 namespace onnxruntime {
 namespace contrib {
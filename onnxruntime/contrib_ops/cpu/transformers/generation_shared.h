@@ -92,6 +92,7 @@ struct ISamplingState {
 
   gsl::span<T> sorted_scores;
   gsl::span<T> cumulative_probs;
+  gsl::span<int32_t> candidate_indices;
 };
 
 struct ISequences {
@@ -177,6 +178,7 @@ struct IGenerationParameters {
   float filter_value;
   float temperature = 1.0f;
   float top_p = 0.0f;
+  int top_k = 0;
   int seed = 0;
   int min_tokens_to_keep = 1;
   bool custom_sampling = false;
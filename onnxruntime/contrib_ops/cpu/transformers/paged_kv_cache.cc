@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include "core/common/safeint.h"
+#include "core/framework/float16.h"
+#include "core/mlas/inc/mlas.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+template <typename T>
+PagedKVCache<T>::PagedKVCache(AllocatorPtr allocator, int num_layers, int num_heads, int head_size, int block_size,
+                              int num_blocks)
+    : num_layers_(num_layers), num_heads_(num_heads), head_size_(head_size), block_size_(block_size) {
+  ORT_ENFORCE(num_layers > 0 && num_heads > 0 && head_size > 0 && block_size > 0 && num_blocks > 0);
+  block_elements_ = SafeInt<size_t>(num_layers) * 2 * num_heads * block_size * head_size;
+  data_ = IAllocator::MakeUniquePtr<T>(allocator, SafeInt<size_t>(num_blocks) * block_elements_);
+  reference_counts_.assign(num_blocks, 0);
+
+  // hand out low block ids first
+  free_blocks_.resize(num_blocks);
+  for (int i = 0; i < num_blocks; i++) {
+    free_blocks_[i] = num_blocks - 1 - i;
+  }
+}
+
+template <typename T>
+const T* PagedKVCache<T>::BlockHead(int block, int layer, int kv, int head) const {
+  const size_t head_elements = static_cast<size_t>(block_size_) * head_size_;
+  return data_.get() + block * block_elements_ +
+         ((static_cast<size_t>(layer) * 2 + kv) * num_heads_ + head) * head_elements;
+}
+
+template <typename T>
+T* PagedKVCache<T>::BlockHead(int block, int layer, int kv, int head) {
+  return const_cast<T*>(static_cast<const PagedKVCache<T>*>(this)->BlockHead(block, layer, kv, head));
+}
+
+template <typename T>
+int PagedKVCache<T>::AddSequence() {
+  int sequence_id;
+  if (!free_sequence_ids_.empty()) {
+    sequence_id = free_sequence_ids_.back();
+    free_sequence_ids_.pop_back();
+  } else {
+    sequence_id = static_cast<int>(sequences_.size());
+    sequences_.emplace_back();
+  }
+
+  Sequence& sequence = sequences_[sequence_id];
+  sequence.blocks.clear();
+  sequence.length = 0;
+  sequence.active = true;
+  return sequence_id;
+}
+
+template <typename T>
+int PagedKVCache<T>::AddSequence(gsl::span<const int32_t> prefix_blocks) {
+  const int sequence_id = AddSequence();
+  Sequence& sequence = sequences_[sequence_id];
+  sequence.blocks.assign(prefix_blocks.begin(), prefix_blocks.end());
+  sequence.length = static_cast<int>(prefix_blocks.size()) * block_size_;
+  for (int32_t block : sequence.blocks) {
+    ORT_ENFORCE(reference_counts_[block] > 0, "Block ", block, " is free.");
+    ++reference_counts_[block];
+  }
+  return sequence_id;
+}
+
+template <typename T>
+int PagedKVCache<T>::ForkSequence(int source_sequence_id) {
+  ORT_ENFORCE(sequences_[source_sequence_id].active, "Sequence ", source_sequence_id, " is not active.");
+  const int sequence_id = AddSequence();
+
+  // AddSequence may grow sequences_, so look the source up again
+  const Sequence& source = sequences_[source_sequence_id];
+  Sequence& sequence = sequences_[sequence_id];
+  sequence.blocks = source.blocks;
+  sequence.length = source.length;
+  for (int32_t block : sequence.blocks) {
+    ++reference_counts_[block];
+  }
+  return sequence_id;
+}
+
+template <typename T>
+void PagedKVCache<T>::ReleaseBlocks(Sequence& sequence) {
+  for (int32_t block : sequence.blocks) {
+    if (--reference_counts_[block] == 0) {
+      free_blocks_.push_back(block);
+    }
+  }
+  sequence.blocks.clear();
+  sequence.length = 0;
+}
+
+template <typename T>
+void PagedKVCache<T>::ReleaseSequence(int sequence_id) {
+  Sequence& sequence = sequences_[sequence_id];
+  ORT_ENFORCE(sequence.active, "Sequence ", sequence_id, " is not active.");
+  ReleaseBlocks(sequence);
+  sequence.active = false;
+  free_sequence_ids_.push_back(sequence_id);
+}
+
+template <typename T>
+void PagedKVCache<T>::ReleaseBlock(int block) {
+  ORT_ENFORCE(reference_counts_[block] > 0, "Block ", block, " is free.");
+  if (--reference_counts_[block] == 0) {
+    free_blocks_.push_back(block);
+  }
+}
+
+template <typename T>
+void PagedKVCache<T>::ReorderSequences(gsl::span<const int> sequence_ids, gsl::span<const int32_t> beam_indices) {
+  ORT_ENFORCE(sequence_ids.size() == beam_indices.size());
+
+  // Take the references of the selected tables before dropping the old ones, so that a block kept by any beam
+  // never reaches a reference count of zero.
+  std::vector<Sequence> selected(sequence_ids.size());
+  for (size_t i = 0; i < sequence_ids.size(); i++) {
+    const Sequence& source = sequences_[sequence_ids[beam_indices[i]]];
+    selected[i].blocks = source.blocks;
+    selected[i].length = source.length;
+    selected[i].active = true;
+    for (int32_t block : selected[i].blocks) {
+      ++reference_counts_[block];
+    }
+  }
+
+  for (size_t i = 0; i < sequence_ids.size(); i++) {
+    Sequence& sequence = sequences_[sequence_ids[i]];
+    ReleaseBlocks(sequence);
+    sequence = std::move(selected[i]);
+  }
+}
+
+template <typename T>
+Status PagedKVCache<T>::AppendTokens(int sequence_id, int token_count) {
+  Sequence& sequence = sequences_[sequence_id];
+  ORT_ENFORCE(sequence.active, "Sequence ", sequence_id, " is not active.");
+
+  const int new_length = sequence.length + token_count;
+  const int required_blocks = (new_length + block_size_ - 1) / block_size_;
+  const int new_blocks = required_blocks - static_cast<int>(sequence.blocks.size());
+
+  // the partially filled last block is written by the new tokens, so it has to be private to this sequence
+  const bool copy_last_block = token_count > 0 && sequence.length % block_size_ != 0 &&
+                               reference_counts_[sequence.blocks.back()] > 1;
+
+  if (new_blocks + (copy_last_block ? 1 : 0) > NumFreeBlocks()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The paged kv cache is out of blocks. Required ",
+                           new_blocks + (copy_last_block ? 1 : 0), ", free ", NumFreeBlocks());
+  }
+
+  if (copy_last_block) {
+    const int32_t shared_block = sequence.blocks.back();
+    const int32_t block = free_blocks_.back();
+    free_blocks_.pop_back();
+    memcpy(data_.get() + block * block_elements_, data_.get() + shared_block * block_elements_,
+           block_elements_ * sizeof(T));
+    --reference_counts_[shared_block];
+    reference_counts_[block] = 1;
+    sequence.blocks.back() = block;
+  }
+
+  for (int i = 0; i < new_blocks; i++) {
+    const int32_t block = free_blocks_.back();
+    free_blocks_.pop_back();
+    reference_counts_[block] = 1;
+    sequence.blocks.push_back(block);
+  }
+
+  sequence.length = new_length;
+  return Status::OK();
+}
+
+template <typename T>
+void PagedKVCache<T>::WriteToken(int sequence_id, int layer, int position, const T* key, const T* value) {
+  const Sequence& sequence = sequences_[sequence_id];
+  ORT_ENFORCE(position < sequence.length, "Position ", position, " is not appended to sequence ", sequence_id);
+
+  const int32_t block = sequence.blocks[position / block_size_];
+  ORT_ENFORCE(reference_counts_[block] == 1, "Block ", block, " is shared and cannot be written.");
+
+  const size_t row_offset = static_cast<size_t>(position % block_size_) * head_size_;
+  for (int head = 0; head < num_heads_; head++) {
+    memcpy(BlockHead(block, layer, 0, head) + row_offset, key + head * head_size_, head_size_ * sizeof(T));
+    memcpy(BlockHead(block, layer, 1, head) + row_offset, value + head * head_size_, head_size_ * sizeof(T));
+  }
+}
+
+template <typename T>
+void PagedKVCache<T>::GatherLayer(int sequence_id, int layer, int max_sequence_length, T* key, T* value) const {
+  const Sequence& sequence = sequences_[sequence_id];
+  ORT_ENFORCE(sequence.length <= max_sequence_length);
+
+  for (int head = 0; head < num_heads_; head++) {
+    T* key_head = key + static_cast<size_t>(head) * max_sequence_length * head_size_;
+    T* value_head = value + static_cast<size_t>(head) * max_sequence_length * head_size_;
+    for (size_t i = 0; i < sequence.blocks.size(); i++) {
+      const int first_token = static_cast<int>(i) * block_size_;
+      const size_t tokens = static_cast<size_t>(std::min(block_size_, sequence.length - first_token));
+      const size_t offset = static_cast<size_t>(first_token) * head_size_;
+      memcpy(key_head + offset, KeyBlock(sequence.blocks[i], layer, head), tokens * head_size_ * sizeof(T));
+      memcpy(value_head + offset, ValueBlock(sequence.blocks[i], layer, head), tokens * head_size_ * sizeof(T));
+    }
+  }
+}
+
+void PagedKVCacheAttention(const PagedKVCache<float>& cache,
+                           int sequence_id,
+                           int layer,
+                           const float* query,
+                           int num_query_heads,
+                           float scale,
+                           float* output) {
+  const int num_heads = cache.NumHeads();
+  const int head_size = cache.HeadSize();
+  const int block_size = cache.BlockSize();
+  const int sequence_length = cache.SequenceLength(sequence_id);
+  gsl::span<const int32_t> block_table = cache.BlockTable(sequence_id);
+  ORT_ENFORCE(num_query_heads % num_heads == 0);
+  const int group_size = num_query_heads / num_heads;
+
+  std::vector<float> scores(sequence_length);
+  for (int query_head = 0; query_head < num_query_heads; query_head++) {
+    const int head = query_head / group_size;
+    const float* q = query + static_cast<size_t>(query_head) * head_size;
+    float* out = output + static_cast<size_t>(query_head) * head_size;
+
+    for (int t = 0; t < sequence_length; t++) {
+      const float* k = cache.KeyBlock(block_table[t / block_size], layer, head) +
+                       static_cast<size_t>(t % block_size) * head_size;
+      float sum = 0.0f;
+      for (int h = 0; h < head_size; h++) {
+        sum += q[h] * k[h];
+      }
+      scores[t] = sum * scale;
+    }
+
+    MlasComputeSoftmax(scores.data(), scores.data(), 1, static_cast<size_t>(sequence_length), false, false, nullptr);
+
+    std::fill_n(out, head_size, 0.0f);
+    for (int t = 0; t < sequence_length; t++) {
+      const float* v = cache.ValueBlock(block_table[t / block_size], layer, head) +
+                       static_cast<size_t>(t % block_size) * head_size;
+      for (int h = 0; h < head_size; h++) {
+        out[h] += scores[t] * v[h];
+      }
+    }
+  }
+}
+
+template class PagedKVCache<float>;
+template class PagedKVCache<MLFloat16>;
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
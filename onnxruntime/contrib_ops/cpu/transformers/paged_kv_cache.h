@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Paged key/value cache for generation.
+//
+// Instead of one contiguous max_length buffer per sequence, the cache is a pool of fixed-size blocks of
+// block_size tokens. Each sequence owns a block table that maps its token positions to blocks, so a sequence
+// only holds the blocks it has filled. Blocks are reference counted: forking a sequence (for example when beam
+// search selects the same beam twice) shares all of its blocks, and a shared block is copied only when one of
+// its owners appends into it (copy-on-write). Reordering beams is therefore a block table update, not a copy
+// of the whole cache.
+//
+// The data of a block is laid out as (num_layers, 2, num_heads, block_size, head_size), where index 0 of the
+// second dimension is the key and 1 is the value, so one block holds a token range of every layer.
+template <typename T>
+class PagedKVCache {
+ public:
+  PagedKVCache(AllocatorPtr allocator, int num_layers, int num_heads, int head_size, int block_size, int num_blocks);
+
+  // Adds an empty sequence and returns its id. Ids of released sequences are reused.
+  int AddSequence();
+
+  // Adds a sequence that starts with the full blocks `prefix_blocks`, shared with their other owners, and
+  // returns its id.
+  int AddSequence(gsl::span<const int32_t> prefix_blocks);
+
+  // Adds a sequence that shares all blocks of `source_sequence_id` and returns its id.
+  int ForkSequence(int source_sequence_id);
+
+  // Releases the blocks of a sequence that are not shared with other sequences.
+  void ReleaseSequence(int sequence_id);
+
+  // Takes or drops a reference to a block outside of any sequence, for example to keep it in a prefix cache.
+  // A block returns to the pool when its last reference is dropped.
+  void RetainBlock(int block) { ++reference_counts_[block]; }
+  void ReleaseBlock(int block);
+
+  // Selects beams: after the call, sequence sequence_ids[i] holds the cache of sequence_ids[beam_indices[i]]
+  // before the call. Only block tables and reference counts are updated.
+  void ReorderSequences(gsl::span<const int> sequence_ids, gsl::span<const int32_t> beam_indices);
+
+  // Grows a sequence by token_count positions, allocating blocks as needed. A shared last block that would be
+  // written is copied first. Fails without changing the sequence when the pool runs out of blocks.
+  Status AppendTokens(int sequence_id, int token_count);
+
+  // Writes the key and value of one token of one layer, each with shape (num_heads, head_size).
+  void WriteToken(int sequence_id, int layer, int position, const T* key, const T* value);
+
+  // Copies the cache of one layer of a sequence to key and value buffers with shape
+  // (num_heads, max_sequence_length, head_size), for consumers that require a contiguous past state.
+  void GatherLayer(int sequence_id, int layer, int max_sequence_length, T* key, T* value) const;
+
+  // Returns the key (or value) rows of one head of one layer in a block, with shape (block_size, head_size).
+  const T* KeyBlock(int block, int layer, int head) const { return BlockHead(block, layer, 0, head); }
+  const T* ValueBlock(int block, int layer, int head) const { return BlockHead(block, layer, 1, head); }
+
+  gsl::span<const int32_t> BlockTable(int sequence_id) const { return sequences_[sequence_id].blocks; }
+  int SequenceLength(int sequence_id) const { return sequences_[sequence_id].length; }
+  int NumFreeBlocks() const { return static_cast<int>(free_blocks_.size()); }
+  int BlockReferenceCount(int block) const { return reference_counts_[block]; }
+
+  int NumHeads() const { return num_heads_; }
+  int HeadSize() const { return head_size_; }
+  int BlockSize() const { return block_size_; }
+
+ private:
+  struct Sequence {
+    std::vector<int32_t> blocks;
+    int length = 0;
+    bool active = false;
+  };
+
+  const T* BlockHead(int block, int layer, int kv, int head) const;
+  T* BlockHead(int block, int layer, int kv, int head);
+  void ReleaseBlocks(Sequence& sequence);
+
+  int num_layers_;
+  int num_heads_;
+  int head_size_;
+  int block_size_;
+  size_t block_elements_;  // elements of one block over all layers
+
+  IAllocatorUniquePtr<T> data_;
+  std::vector<int32_t> reference_counts_;
+  std::vector<int32_t> free_blocks_;
+  std::vector<Sequence> sequences_;
+  std::vector<int> free_sequence_ids_;
+};
+
+// Computes the attention of one new token per query head over a sequence of the paged cache, reading the keys
+// and values through the block table. query and output have shape (num_query_heads, head_size); num_query_heads
+// shall be a multiple of the number of kv heads of the cache (grouped query attention).
+void PagedKVCacheAttention(const PagedKVCache<float>& cache,
+                           int sequence_id,
+                           int layer,
+                           const float* query,
+                           int num_query_heads,
+                           float scale,
+                           float* output);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
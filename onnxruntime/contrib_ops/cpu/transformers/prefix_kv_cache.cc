@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <functional>
+#include "core/common/hash_combine.h"
+#include "core/framework/float16.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+template <typename T>
+PrefixKVCache<T>::PrefixKVCache(PagedKVCache<T>& cache, int max_cached_blocks)
+    : cache_(cache), max_cached_blocks_(max_cached_blocks) {
+  ORT_ENFORCE(max_cached_blocks >= 0);
+}
+
+template <typename T>
+PrefixKVCache<T>::~PrefixKVCache() {
+  Clear();
+}
+
+template <typename T>
+size_t PrefixKVCache<T>::Hash(int32_t parent_block, gsl::span<const int32_t> token_ids) {
+  size_t hash = std::hash<int32_t>{}(parent_block);
+  for (int32_t token_id : token_ids) {
+    HashCombine(token_id, hash);
+  }
+  return hash;
+}
+
+template <typename T>
+typename PrefixKVCache<T>::EntryList::iterator PrefixKVCache<T>::Find(int32_t parent_block,
+                                                                      gsl::span<const int32_t> token_ids) {
+  auto range = index_.equal_range(Hash(parent_block, token_ids));
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = *it->second;
+    if (entry.parent_block == parent_block &&
+        std::equal(entry.token_ids.begin(), entry.token_ids.end(), token_ids.begin(), token_ids.end())) {
+      return it->second;
+    }
+  }
+  return entries_.end();
+}
+
+template <typename T>
+int PrefixKVCache<T>::AddSequence(gsl::span<const int32_t> token_ids, int& cached_length) {
+  ORT_ENFORCE(!token_ids.empty());
+  const size_t block_size = static_cast<size_t>(cache_.BlockSize());
+  const size_t max_blocks = (token_ids.size() - 1) / block_size;
+
+  std::vector<int32_t> blocks;
+  std::vector<typename EntryList::iterator> path;
+  int32_t parent_block = -1;
+  while (blocks.size() < max_blocks) {
+    auto it = Find(parent_block, token_ids.subspan(blocks.size() * block_size, block_size));
+    if (it == entries_.end()) {
+      break;
+    }
+    blocks.push_back(it->block);
+    path.push_back(it);
+    parent_block = it->block;
+  }
+
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    entries_.splice(entries_.begin(), entries_, *it);
+  }
+
+  cached_length = static_cast<int>(blocks.size() * block_size);
+  return cache_.AddSequence(blocks);
+}
+
+template <typename T>
+void PrefixKVCache<T>::Insert(int sequence_id, gsl::span<const int32_t> token_ids) {
+  ORT_ENFORCE(static_cast<int>(token_ids.size()) <= cache_.SequenceLength(sequence_id));
+  const size_t block_size = static_cast<size_t>(cache_.BlockSize());
+  gsl::span<const int32_t> block_table = cache_.BlockTable(sequence_id);
+
+  std::vector<typename EntryList::iterator> path;
+  int32_t parent_block = -1;
+  for (size_t i = 0; i < token_ids.size() / block_size; i++) {
+    gsl::span<const int32_t> block_tokens = token_ids.subspan(i * block_size, block_size);
+    auto it = Find(parent_block, block_tokens);
+    if (it == entries_.end()) {
+      // a block that is cached for another prefix does not hold token_ids
+      if (blocks_.count(block_table[i]) != 0) {
+        break;
+      }
+
+      entries_.push_front({parent_block, std::vector<int32_t>(block_tokens.begin(), block_tokens.end()),
+                           block_table[i]});
+      it = entries_.begin();
+      index_.emplace(Hash(parent_block, block_tokens), it);
+      blocks_.emplace(block_table[i], it);
+      cache_.RetainBlock(block_table[i]);
+      if (parent_block >= 0) {
+        ++blocks_.at(parent_block)->num_children;
+      }
+    }
+
+    // A cached block with the same prefix may differ from the block of this sequence, when the prefix was
+    // computed by two sequences. The following blocks are chained to the cached one.
+    path.push_back(it);
+    parent_block = it->block;
+  }
+
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    entries_.splice(entries_.begin(), entries_, *it);
+  }
+
+  if (NumCachedBlocks() > max_cached_blocks_) {
+    Evict(NumCachedBlocks() - max_cached_blocks_);
+  }
+}
+
+template <typename T>
+int PrefixKVCache<T>::Evict(int num_blocks) {
+  int evicted = 0;
+  auto it = entries_.end();
+  while (evicted < num_blocks && it != entries_.begin()) {
+    --it;
+    // a block is dropped after the blocks that follow it, whose keys refer to it
+    if (it->num_children > 0) {
+      continue;
+    }
+
+    auto range = index_.equal_range(Hash(it->parent_block, it->token_ids));
+    for (auto index_it = range.first; index_it != range.second; ++index_it) {
+      if (index_it->second == it) {
+        index_.erase(index_it);
+        break;
+      }
+    }
+    if (it->parent_block >= 0) {
+      --blocks_.at(it->parent_block)->num_children;
+    }
+    blocks_.erase(it->block);
+    cache_.ReleaseBlock(it->block);
+    it = entries_.erase(it);
+    ++evicted;
+  }
+  return evicted;
+}
+
+template class PrefixKVCache<float>;
+template class PrefixKVCache<MLFloat16>;
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
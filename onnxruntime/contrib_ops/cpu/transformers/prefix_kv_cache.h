@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Prefix cache of prompt keys and values over a paged kv cache.
+//
+// Requests that share a prompt prefix (such as a system prompt) reuse the keys and values of that prefix instead
+// of recomputing them. After the prompt step of a sequence, its full blocks are inserted into the cache, keyed by
+// the block tokens and the block that precedes them, so a key identifies the whole token prefix up to the end of
+// the block. A new sequence starts with the blocks of its longest cached prefix, shared through the reference
+// counts of the paged cache, and only the remaining tokens are computed.
+//
+// The cache holds a reference to each cached block and keeps at most max_cached_blocks of them. The least
+// recently used blocks are evicted first. Looking a prefix up touches its blocks from the last one to the first,
+// so a block is always more recently used than the blocks that follow it, and eviction drops prefixes from
+// their end.
+//
+// The paged cache shall outlive the prefix cache.
+template <typename T>
+class PrefixKVCache {
+ public:
+  PrefixKVCache(PagedKVCache<T>& cache, int max_cached_blocks);
+  ~PrefixKVCache();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrefixKVCache);
+
+  // Adds a sequence to the paged cache that starts with the longest cached prefix of token_ids, and returns its
+  // id. cached_length is set to the number of tokens whose keys and values are already in the sequence. At
+  // least the last token is left to compute, so that the model produces its logits.
+  int AddSequence(gsl::span<const int32_t> token_ids, int& cached_length);
+
+  // Caches the full blocks of a sequence whose first token_ids.size() positions hold the keys and values of
+  // token_ids. Blocks of prefixes that are cached already are only touched.
+  void Insert(int sequence_id, gsl::span<const int32_t> token_ids);
+
+  // Drops up to num_blocks of the least recently used blocks and returns the number of blocks dropped. Blocks
+  // that are not used by a sequence return to the pool of the paged cache.
+  int Evict(int num_blocks);
+
+  void Clear() { Evict(NumCachedBlocks()); }
+
+  int NumCachedBlocks() const { return static_cast<int>(entries_.size()); }
+
+ private:
+  struct Entry {
+    int32_t parent_block;  // cached block of the preceding tokens, -1 for the first block of a prompt
+    std::vector<int32_t> token_ids;
+    int32_t block;
+    int num_children = 0;  // cached blocks whose parent is this block
+  };
+  using EntryList = std::list<Entry>;
+
+  static size_t Hash(int32_t parent_block, gsl::span<const int32_t> token_ids);
+  typename EntryList::iterator Find(int32_t parent_block, gsl::span<const int32_t> token_ids);
+
+  PagedKVCache<T>& cache_;
+  int max_cached_blocks_;
+
+  EntryList entries_;  // most recently used first
+  std::unordered_multimap<size_t, typename EntryList::iterator> index_;
+  std::unordered_map<int32_t, typename EntryList::iterator> blocks_;  // entry of each cached block
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -45,6 +45,10 @@ void Sampling::Init(const OpKernelInfo& info) {
   // Model_type could be either 0 (GPT-2) or 1 (encoder-decoder like T5)
   ORT_ENFORCE(parameters_.model_type == IGenerationParameters::kModelTypeGpt);
 
+  ORT_ENFORCE(parameters_.top_k >= 0, "top_k shall be non-negative, got ", parameters_.top_k);
+  ORT_ENFORCE(parameters_.top_k == 0 || info.GetKernelDef().Provider() == kCpuExecutionProvider,
+              "top_k is only supported by the CPU execution provider.");
+
   ONNX_NAMESPACE::GraphProto proto;
   if (parameters_.model_type != IGenerationParameters::kModelTypeGpt) {
     // Make sure the encoder sub-graph attribute is present for the T5 model.
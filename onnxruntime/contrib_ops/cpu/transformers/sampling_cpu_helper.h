@@ -6,54 +6,126 @@ namespace onnxruntime {
 namespace contrib {
 namespace SamplingCpuHelper {
 
-template <typename T>
-void filter_scores(std::vector<size_t>& sorted_indice,
-                   gsl::span<T>& next_token_score,
-                   const transformers::IGenerationParameters* parameters,
-                   size_t chunk_offset,
-                   size_t offset) {
-  size_t real_index = sorted_indice[chunk_offset + offset];
-  next_token_score[chunk_offset + real_index] = (T)parameters->filter_value;
+// Number of candidates that the nucleus (top-p) selection partially sorts first. It is doubled until the
+// nucleus is complete, so the whole vocabulary is only sorted when the distribution is very flat.
+constexpr size_t kInitialNucleusCandidates = 256;
+
+// Returns whether the token at `rank` (in descending probability order) is kept, given the total probability
+// `prefix` of the tokens ranked above it. The rules match the ones in HuggingFace TopPLogitsWarper
+// (or the custom sampling one that always keeps the most probable token).
+inline bool KeepInNucleus(const transformers::IGenerationParameters* parameters, size_t rank, float prefix) {
+  if (parameters->custom_sampling) {
+    return rank == 0 || prefix <= parameters->top_p;
+  }
+  return parameters->top_p >= 1.0f || rank < static_cast<size_t>(parameters->min_tokens_to_keep) ||
+         1.0f - prefix > 1.0f - parameters->top_p;
 }
 
+// Applies top-k and top-p filtering to one row of scores and draws the next token from what is left.
+// Filtered scores are set to filter_value. `probs` is the softmax of the scores, `kept_scores` and `indices`
+// are vocab_size workspaces of the row, and `uniform` is a draw of U(0, 1).
 template <typename T>
-void cumulate_and_filter_custom(gsl::span<T>& next_token_scores,
-                                gsl::span<T>& cumulative_probs,
-                                const transformers::IGenerationParameters* parameters,
-                                std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] > parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 1);
+int32_t SampleRow(gsl::span<T> scores,
+                  gsl::span<const T> probs,
+                  gsl::span<T> kept_scores,
+                  gsl::span<int32_t> indices,
+                  double uniform,
+                  const transformers::IGenerationParameters* parameters) {
+  const size_t vocab_size = scores.size();
+  auto by_probability = [&probs](int32_t a, int32_t b) {
+    return probs[a] > probs[b] || (probs[a] == probs[b] && a < b);
+  };
+
+  // Select the candidates in descending probability order until one falls out of the nucleus. Only the
+  // selected prefix of `indices` is sorted.
+  const size_t top_k = parameters->top_k > 0 ? std::min(static_cast<size_t>(parameters->top_k), vocab_size)
+                                             : vocab_size;
+  std::iota(indices.begin(), indices.end(), 0);
+
+  // As in HuggingFace, top-p applies to the softmax of the scores left by top-k, i.e. to the probabilities of the
+  // top-k tokens divided by their total.
+  float top_k_total = 1.0f;
+  if (top_k < vocab_size) {
+    std::nth_element(indices.begin(), indices.begin() + top_k, indices.end(), by_probability);
+    top_k_total = 0.0f;
+    for (size_t i = 0; i < top_k; i++) {
+      top_k_total += static_cast<float>(probs[indices[i]]);
+    }
+  }
+
+  size_t kept = 0;
+  float prefix = 0.0f;
+  const bool keep_all = top_k == vocab_size && !parameters->custom_sampling && parameters->top_p >= 1.0f;
+  for (size_t selected = std::min(kInitialNucleusCandidates, top_k); !keep_all;
+       selected = std::min(2 * selected, top_k)) {
+    if (selected < top_k) {
+      std::nth_element(indices.begin() + kept, indices.begin() + selected, indices.begin() + top_k, by_probability);
+    }
+    std::sort(indices.begin() + kept, indices.begin() + selected, by_probability);
+
+    while (kept < selected && KeepInNucleus(parameters, kept, prefix / top_k_total)) {
+      prefix += static_cast<float>(probs[indices[kept]]);
+      ++kept;
     }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - 1; j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] > parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j + 1);
-      }
+    if (kept < selected || selected == top_k) {
+      break;
     }
   }
-}
+  if (keep_all) {
+    kept = vocab_size;
+  }
 
-template <typename T>
-void cumulate_and_filter(gsl::span<T>& next_token_scores,
-                         gsl::span<T>& cumulative_probs,
-                         const transformers::IGenerationParameters* parameters,
-                         std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] <= 1 - parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 0);
+  if (kept == 0) {
+    // Every score is filter_value, which makes the tokens equally likely.
+    std::fill(scores.begin(), scores.end(), static_cast<T>(parameters->filter_value));
+    return static_cast<int32_t>(std::min(static_cast<size_t>(uniform * vocab_size), vocab_size - 1));
+  }
+
+  // Draw like torch.multinomial() over the kept tokens in token id order.
+  if (!keep_all) {
+    std::sort(indices.begin(), indices.begin() + kept);
+  }
+  double max_logit = std::numeric_limits<double>::lowest();
+  for (size_t i = 0; i < kept; i++) {
+    kept_scores[i] = scores[indices[i]];
+    if (std::isfinite(static_cast<double>(kept_scores[i]))) {
+      max_logit = std::max(max_logit, static_cast<double>(kept_scores[i]));
+    }
+  }
+
+  double total = 0.0;
+  for (size_t i = 0; i < kept; i++) {
+    if (std::isfinite(static_cast<double>(kept_scores[i]))) {
+      total += std::exp(static_cast<double>(kept_scores[i]) - max_logit);
+    }
+  }
+
+  const double target = uniform * total;
+  int32_t next_token = indices[kept - 1];
+  double cumulative = 0.0;
+  for (size_t i = 0; i < kept; i++) {
+    if (std::isfinite(static_cast<double>(kept_scores[i]))) {
+      cumulative += std::exp(static_cast<double>(kept_scores[i]) - max_logit);
     }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - static_cast<size_t>(parameters->min_tokens_to_keep); j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] <= 1 - parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j);
-      }
+    if (cumulative > target) {
+      next_token = indices[i];
+      break;
     }
   }
+
+  if (kept < vocab_size) {
+    std::fill(scores.begin(), scores.end(), static_cast<T>(parameters->filter_value));
+    for (size_t i = 0; i < kept; i++) {
+      scores[indices[i]] = kept_scores[i];
+    }
+  }
+
+  return next_token;
 }
 
+// Top-k/top-p sampling of the next tokens. After the softmax, each batch row is filtered and sampled in one
+// selection pass over the preallocated workspace of the sampling state, and rows are distributed over the
+// thread pool.
 template <typename T>
 Status Sample(AllocatorPtr& allocator,
               onnxruntime::concurrency::ThreadPool* thread_pool,
@@ -62,99 +134,39 @@ Status Sample(AllocatorPtr& allocator,
               transformers::IGreedySearchState<T>* greedy_state,
               const transformers::IGenerationParameters* parameters,
               const IConsoleDumper* dumper) {
+  ORT_UNUSED_PARAMETER(allocator);
   ORT_UNUSED_PARAMETER(dumper);
 
-  gsl::span<T>& sorted_scores = sampling_state->sorted_scores;
-  memcpy(sorted_scores.data(), next_token_scores.data(), next_token_scores.size_bytes());
-  std::vector<size_t> sorted_indices(static_cast<size_t>(parameters->batch_size) * static_cast<size_t>(parameters->vocab_size));
-
-  std::function<bool(T, T)> predicator;
-  if (parameters->custom_sampling) {
-    predicator = std::greater<T>();
-  } else {
-    predicator = std::less<T>();
-  }
+  const int batch_size = parameters->batch_size;
+  const size_t vocab_size = static_cast<size_t>(parameters->vocab_size);
 
-  // TODO: This could be optimized with allocated buffer and handwritten sort algorithm
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    auto indices_begin = sorted_indices.begin() + i * parameters->vocab_size;
-    auto indices_end = sorted_indices.begin() + (i + 1) * parameters->vocab_size;
-    gsl::span<T> next_token_score = next_token_scores.subspan(i * parameters->vocab_size, parameters->vocab_size);
-    std::iota(indices_begin, indices_end, 0);
-    std::sort(indices_begin, indices_end,
-              [&next_token_score, &predicator](size_t i1, size_t i2) {
-                return predicator(next_token_score[i1], next_token_score[i2]);
-              });
-
-    std::sort(sorted_scores.begin() + i * parameters->vocab_size,
-              sorted_scores.begin() + (i + 1) * parameters->vocab_size,
-              predicator);
+  // Draw the random numbers up front and in batch order, so the result does not depend on the threading.
+  std::default_random_engine& generator = sampling_state->generator;
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  InlinedVector<double> uniforms(batch_size);
+  for (int i = 0; i < batch_size; i++) {
+    uniforms[i] = distribution(generator);
   }
 
-#ifdef DEBUG_GENERATION
-  dumper->Print("sorted_scores", sorted_scores.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("sorted_indices", sorted_indices.data(), parameters->batch_size, parameters->vocab_size);
-#endif
-
-  gsl::span<T>& cumulative_probs = sampling_state->cumulative_probs;
-
-  ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(parameters->batch_size,
-                                    parameters->vocab_size,
-                                    sorted_scores.data(),
-                                    cumulative_probs.data(),
-                                    false,
+  gsl::span<T>& probs = sampling_state->cumulative_probs;
+  ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(batch_size, vocab_size, next_token_scores.data(), probs.data(), false,
                                     thread_pool));
 
-  if (parameters->custom_sampling) {
-    cumulate_and_filter_custom(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  } else {
-    cumulate_and_filter(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  }
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("cumulative_probs after filtering", cumulative_probs.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("next_token_scores after filtering", next_token_scores.data(), parameters->batch_size, parameters->vocab_size);
-#endif
-
-  // torch.multinomial()
-  int64_t next_token_probs_dims[] = {static_cast<int64_t>(parameters->batch_size), parameters->vocab_size};
-  TensorShape next_token_probs_shape(&next_token_probs_dims[0], 2);
-  auto element_type = DataTypeImpl::GetType<T>();
-  OrtValue next_token_probs_value;
-  Tensor::InitOrtValue(element_type,
-                       next_token_probs_shape,
-                       next_token_scores.data(),
-                       allocator->Info(),
-                       next_token_probs_value);
-  const Tensor& input = next_token_probs_value.Get<Tensor>();
-
-  std::default_random_engine& generator = sampling_state->generator;
+  gsl::span<int32_t>& next_tokens = greedy_state->next_tokens;
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(batch_size), [&](std::ptrdiff_t i) {
+        const size_t offset = SafeInt<size_t>(i) * vocab_size;
+        next_tokens[i] = SampleRow<T>(next_token_scores.subspan(offset, vocab_size),
+                                      gsl::span<const T>(probs).subspan(offset, vocab_size),
+                                      sampling_state->sorted_scores.subspan(offset, vocab_size),
+                                      sampling_state->candidate_indices.subspan(offset, vocab_size),
+                                      uniforms[i],
+                                      parameters);
+      });
 
-  int64_t sampled_idx_dims[] = {static_cast<int64_t>(parameters->batch_size), 1};
-  TensorShape sampled_idx_shape(&sampled_idx_dims[0], 2);
-
-  gsl::span<int32_t>& next_token_idx = greedy_state->next_tokens;
-
-  OrtValue sampled_idx_ov;
-  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(),
-                       sampled_idx_shape,
-                       next_token_idx.data(),
-                       allocator->Info(),
-                       sampled_idx_ov);
-  Tensor* sampled_idx = sampled_idx_ov.GetMutable<Tensor>();
-
-  // Copy the allocator because MultinomialComputeShared() uses move(allocator)
-  AllocatorPtr allocatortemp = allocator;
-  ORT_RETURN_IF_ERROR(MultinomialComputeShared<int32_t>(allocatortemp,
-                                                        input,
-                                                        parameters->batch_size,
-                                                        parameters->vocab_size,
-                                                        1,
-                                                        generator,
-                                                        *sampled_idx));
-  // TODO: update presence_mask()
 #ifdef DEBUG_GENERATION
-  dumper->Print("sampled_idx", *sampled_idx);
+  dumper->Print("next_token_scores after filtering", next_token_scores.data(), batch_size, parameters->vocab_size);
+  dumper->Print("sampled_idx", next_tokens.data(), batch_size, 1);
 #endif
 
   return Status::OK();
@@ -14,6 +14,7 @@ void SamplingParameters::ParseFromAttributes(const OpKernelInfo& info) {
   no_repeat_ngram_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_repeat_ngram_size", 0));
   temperature = info.GetAttrOrDefault<float>("temperature", 1.0f);
   top_p = info.GetAttrOrDefault<float>("top_p", 0.0f);
+  top_k = static_cast<int>(info.GetAttrOrDefault<int64_t>("top_k", 0));
   filter_value = info.GetAttrOrDefault<float>("filter_value", -std::numeric_limits<float>::infinity());
   min_tokens_to_keep = static_cast<int>(info.GetAttrOrDefault<int64_t>("min_tokens_to_keep", 0));
   presence_penalty = info.GetAttrOrDefault<float>("presence_penalty", 0.0f);
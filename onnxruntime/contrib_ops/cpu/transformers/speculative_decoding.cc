@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include "core/common/safeint.h"
+#include "core/framework/float16.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/speculative_decoding.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+int ProposePromptLookupDraft(gsl::span<const int32_t> sequence, int max_ngram_size, gsl::span<int32_t> draft) {
+  const int length = static_cast<int>(sequence.size());
+  const int max_draft_tokens = static_cast<int>(draft.size());
+
+  for (int ngram_size = std::min(max_ngram_size, length - 1); ngram_size > 0; ngram_size--) {
+    gsl::span<const int32_t> ngram = sequence.subspan(length - ngram_size);
+
+    // search backwards so that the most recent match wins, excluding the trailing n-gram itself
+    for (int start = length - ngram_size - 1; start >= 0; start--) {
+      if (!std::equal(ngram.begin(), ngram.end(), sequence.begin() + start)) {
+        continue;
+      }
+
+      const int first = start + ngram_size;
+      const int count = std::min(max_draft_tokens, length - first);
+      std::copy_n(sequence.begin() + first, count, draft.begin());
+      return count;
+    }
+  }
+  return 0;
+}
+
+int VerifyDraftGreedy(gsl::span<const int32_t> draft, gsl::span<const int32_t> target_tokens) {
+  ORT_ENFORCE(target_tokens.size() == draft.size() + 1);
+  int accepted = 0;
+  while (accepted < static_cast<int>(draft.size()) && draft[accepted] == target_tokens[accepted]) {
+    ++accepted;
+  }
+  return accepted;
+}
+
+int VerifyDraftSampling(gsl::span<const int32_t> draft,
+                        gsl::span<const float> target_probs,
+                        int vocab_size,
+                        std::default_random_engine& generator,
+                        int32_t& next_token) {
+  ORT_ENFORCE(target_probs.size() == (draft.size() + 1) * static_cast<size_t>(vocab_size));
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+  auto sample = [&](gsl::span<const float> probs, int32_t excluded) {
+    float total = 0.0f;
+    for (int v = 0; v < vocab_size; v++) {
+      total += v == excluded ? 0.0f : probs[v];
+    }
+    float threshold = uniform(generator) * total;
+    int32_t last_candidate = 0;
+    for (int v = 0; v < vocab_size; v++) {
+      if (v == excluded || probs[v] <= 0.0f) {
+        continue;
+      }
+      last_candidate = v;
+      threshold -= probs[v];
+      if (threshold < 0.0f) {
+        return static_cast<int32_t>(v);
+      }
+    }
+    return last_candidate;
+  };
+
+  for (size_t i = 0; i < draft.size(); i++) {
+    gsl::span<const float> probs = target_probs.subspan(i * vocab_size, vocab_size);
+    // The draft puts all of its mass on draft[i], so the acceptance ratio p / q is just p. On rejection the
+    // residual max(p - q, 0) is p without draft[i].
+    if (uniform(generator) >= probs[draft[i]]) {
+      next_token = sample(probs, draft[i]);
+      return static_cast<int>(i);
+    }
+  }
+
+  next_token = sample(target_probs.subspan(draft.size() * vocab_size, vocab_size), -1);
+  return static_cast<int>(draft.size());
+}
+
+template <typename T>
+void TruncateGptPastState(const OrtValue& present, int sequence_length, AllocatorPtr allocator, OrtValue& past) {
+  const Tensor& present_tensor = present.Get<Tensor>();
+  const TensorShape& present_shape = present_tensor.Shape();
+  ORT_ENFORCE(present_shape.NumDimensions() == 5 && sequence_length <= present_shape[3]);
+
+  TensorShape past_shape = present_shape;
+  past_shape[3] = sequence_length;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), past_shape, allocator, past);
+
+  // each (kv, batch_beam, head) chunk keeps its first sequence_length rows
+  const int64_t chunks = present_shape[0] * present_shape[1] * present_shape[2];
+  const size_t present_chunk = SafeInt<size_t>(present_shape[3]) * present_shape[4];
+  const size_t past_chunk = SafeInt<size_t>(sequence_length) * present_shape[4];
+  const T* source = present_tensor.Data<T>();
+  T* target = past.GetMutable<Tensor>()->MutableData<T>();
+  for (int64_t i = 0; i < chunks; i++) {
+    memcpy(target + i * past_chunk, source + i * present_chunk, past_chunk * sizeof(T));
+  }
+}
+
+template void TruncateGptPastState<float>(const OrtValue& present, int sequence_length, AllocatorPtr allocator,
+                                          OrtValue& past);
+template void TruncateGptPastState<MLFloat16>(const OrtValue& present, int sequence_length, AllocatorPtr allocator,
+                                              OrtValue& past);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
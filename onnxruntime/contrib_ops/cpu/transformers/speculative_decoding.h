@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <random>
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Helpers for speculative decoding. A cheap proposer drafts k tokens, the decoder verifies them in one step that
+// feeds all k tokens after the past state, and the accepted prefix plus one token from the decoder is kept.
+// Verification only accepts tokens the decoder itself would have produced (greedy), or follows the speculative
+// sampling rule (sampling), so the output distribution does not change.
+
+// Prompt lookup (n-gram) proposer: finds the most recent earlier occurrence of the last n tokens of `sequence`,
+// trying n = max_ngram_size down to 1, and copies up to draft.size() tokens that followed it into `draft`.
+// Returns the number of drafted tokens, which is 0 when no n-gram repeats.
+int ProposePromptLookupDraft(gsl::span<const int32_t> sequence, int max_ngram_size, gsl::span<int32_t> draft);
+
+// Greedy verification. target_tokens[i] is the decoder's next token after the prefix and draft[0..i), so it has
+// one more element than draft. Returns the number of accepted draft tokens; target_tokens[accepted] is the token
+// to append after them.
+int VerifyDraftGreedy(gsl::span<const int32_t> draft, gsl::span<const int32_t> target_tokens);
+
+// Speculative sampling verification for a deterministic draft (such as prompt lookup). target_probs holds
+// draft.size() + 1 rows of vocab_size next token probabilities of the decoder. Draft token i is accepted with
+// probability target_probs[i][draft[i]]. At the first rejection the next token is sampled from that row with the
+// rejected token removed, otherwise from the last row. Returns the number of accepted tokens and the token to
+// append after them in `next_token`.
+int VerifyDraftSampling(gsl::span<const int32_t> draft,
+                        gsl::span<const float> target_probs,
+                        int vocab_size,
+                        std::default_random_engine& generator,
+                        int32_t& next_token);
+
+// Rolls back a GPT present state of shape (2, batch_beam_size, num_heads, total_length, head_size) after
+// verification by copying the first `sequence_length` positions into a new past state. When past and present
+// share a buffer, the rollback is only a smaller past_sequence_length and needs no copy.
+template <typename T>
+void TruncateGptPastState(const OrtValue& present, int sequence_length, AllocatorPtr allocator, OrtValue& past);
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise.h"
+
+#include <utility>
+
+#include "core/providers/cuda/math/binary_elementwise_ops.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                                           \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                           \
+      FusedElementwise,                                                                    \
+      kMSDomain,                                                                           \
+      1,                                                                                   \
+      T,                                                                                   \
+      kCudaExecutionProvider,                                                              \
+      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedElementwise<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+namespace {
+
+// Returns false if op_type is not supported. is_binary is set to whether it takes two operands.
+bool ParseOp(const std::string& op_type, FusedElementwiseOp& op, bool& is_binary) {
+  static const std::pair<const char*, FusedElementwiseOp> binary_ops[] = {
+      {"Add", FusedElementwiseOp::Add}, {"Sub", FusedElementwiseOp::Sub}, {"Mul", FusedElementwiseOp::Mul},
+      {"Div", FusedElementwiseOp::Div}};
+  static const std::pair<const char*, FusedElementwiseOp> unary_ops[] = {
+      {"Sigmoid", FusedElementwiseOp::Sigmoid}, {"Tanh", FusedElementwiseOp::Tanh},
+      {"Relu", FusedElementwiseOp::Relu}, {"Exp", FusedElementwiseOp::Exp}, {"Erf", FusedElementwiseOp::Erf},
+      {"Neg", FusedElementwiseOp::Neg}, {"Abs", FusedElementwiseOp::Abs}, {"Sqrt", FusedElementwiseOp::Sqrt},
+      {"Reciprocal", FusedElementwiseOp::Reciprocal}};
+
+  for (const auto& binary_op : binary_ops) {
+    if (op_type == binary_op.first) {
+      op = binary_op.second;
+      is_binary = true;
+      return true;
+    }
+  }
+  for (const auto& unary_op : unary_ops) {
+    if (op_type == unary_op.first) {
+      op = unary_op.second;
+      is_binary = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one instruction.");
+  ORT_ENFORCE(operands.size() == 2 * ops.size(), "FusedElementwise requires two operands per instruction, got ",
+              operands.size(), " operands for ", ops.size(), " instructions.");
+
+  const int64_t num_inputs = static_cast<int64_t>(info.GetInputCount());
+  ORT_ENFORCE(num_inputs <= kMaxFusedElementwiseInputs && ops.size() <= kMaxFusedElementwiseInstructions,
+              "FusedElementwise on CUDA supports up to ", kMaxFusedElementwiseInputs, " inputs and ",
+              kMaxFusedElementwiseInstructions, " instructions, got ", num_inputs, " inputs and ", ops.size(),
+              " instructions.");
+
+  program_.num_inputs = static_cast<int32_t>(num_inputs);
+  program_.num_instructions = static_cast<int32_t>(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) {
+    FusedElementwiseInstruction& instruction = program_.instructions[i];
+    bool is_binary = false;
+    ORT_ENFORCE(ParseOp(ops[i], instruction.op, is_binary), "Unsupported operator in FusedElementwise: ", ops[i]);
+
+    // an instruction reads the inputs and the results of the instructions before it
+    const int64_t num_values = num_inputs + static_cast<int64_t>(i);
+    const int64_t operand0 = operands[2 * i];
+    const int64_t operand1 = operands[2 * i + 1];
+    ORT_ENFORCE(operand0 >= 0 && operand0 < num_values, "Invalid operand ", operand0, " of instruction ", i);
+    if (is_binary) {
+      ORT_ENFORCE(operand1 >= 0 && operand1 < num_values, "Invalid operand ", operand1, " of instruction ", i);
+    } else {
+      ORT_ENFORCE(operand1 == -1, "Unary instruction ", i, " shall have -1 as its second operand.");
+    }
+
+    instruction.operand0 = static_cast<int32_t>(operand0);
+    instruction.operand1 = static_cast<int32_t>(operand1);
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const int num_inputs = program_.num_inputs;
+  TensorShape output_shape = context->Input<Tensor>(0)->Shape();
+  for (int i = 1; i < num_inputs; ++i) {
+    TensorShape broadcast_shape;
+    ORT_RETURN_IF_ERROR(ComputeOutputShape(Node().Name(), output_shape, context->Input<Tensor>(i)->Shape(),
+                                           broadcast_shape));
+    output_shape = std::move(broadcast_shape);
+  }
+
+  Tensor* output = context->Output(0, output_shape);
+  const size_t output_size = static_cast<size_t>(output_shape.Size());
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const int32_t output_rank = static_cast<int32_t>(output_shape.NumDimensions());
+  ORT_RETURN_IF(output_rank > TArray<fast_divmod>::Capacity(), "FusedElementwise on CUDA supports up to ",
+                TArray<fast_divmod>::Capacity(), " dims, got ", output_rank);
+
+  FusedElementwiseInputs<CudaT> inputs{};
+  bool is_broadcast = false;
+  for (int i = 0; i < num_inputs; ++i) {
+    const Tensor& input = *context->Input<Tensor>(i);
+    inputs.data[i] = reinterpret_cast<const CudaT*>(input.Data<T>());
+
+    const auto& input_dims = input.Shape().GetDims();
+    if (input.Shape() == output_shape) {
+      continue;
+    }
+
+    // the stride of a broadcast dim is kept as 0
+    const int32_t offset = output_rank - static_cast<int32_t>(input_dims.size());
+    TensorPitches input_strides(input_dims, output_rank);
+    inputs.padded_strides[i].SetSize(output_rank);
+    for (int32_t dim = offset; dim < output_rank; ++dim) {
+      if (input_dims[static_cast<size_t>(dim - offset)] != 1) {
+        inputs.padded_strides[i][dim] = input_strides[dim];
+      }
+    }
+    is_broadcast = true;
+  }
+
+  TArray<fast_divmod> fdm_output_strides;
+  if (is_broadcast) {
+    TensorPitches output_strides(output_shape.GetDims());
+    fdm_output_strides.SetSize(output_rank);
+    for (int32_t dim = 0; dim < output_rank; ++dim) {
+      fdm_output_strides[dim] = fast_divmod(gsl::narrow_cast<int>(output_strides[dim]));
+    }
+  }
+
+  LaunchFusedElementwiseKernel<CudaT>(Stream(context), program_, inputs, fdm_output_strides,
+                                      reinterpret_cast<CudaT*>(output->MutableData<T>()), output_size);
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
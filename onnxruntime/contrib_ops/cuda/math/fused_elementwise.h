@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_kernel.h"
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Evaluates a fused chain of elementwise operators (see the FusedElementwise schema) in a single kernel launch,
+// one thread per output element.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  FusedElementwiseProgram program_{};
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+namespace {
+
+__device__ __forceinline__ float Evaluate(FusedElementwiseOp op, float a, float b) {
+  switch (op) {
+    case FusedElementwiseOp::Add:
+      return a + b;
+    case FusedElementwiseOp::Sub:
+      return a - b;
+    case FusedElementwiseOp::Mul:
+      return a * b;
+    case FusedElementwiseOp::Div:
+      return a / b;
+    case FusedElementwiseOp::Sigmoid:
+      return 1.0f / (1.0f + expf(-a));
+    case FusedElementwiseOp::Tanh:
+      return tanhf(a);
+    case FusedElementwiseOp::Relu:
+      return a > 0.0f ? a : 0.0f;
+    case FusedElementwiseOp::Exp:
+      return expf(a);
+    case FusedElementwiseOp::Erf:
+      return erff(a);
+    case FusedElementwiseOp::Neg:
+      return -a;
+    case FusedElementwiseOp::Abs:
+      return fabsf(a);
+    case FusedElementwiseOp::Sqrt:
+      return sqrtf(a);
+    default:
+      return 1.0f / a;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+__global__ void FusedElementwiseKernel(const FusedElementwiseProgram program, const FusedElementwiseInputs<T> inputs,
+                                       const TArray<fast_divmod> fdm_output_strides, T* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  // the coordinates of the output element, which the broadcast inputs are read at
+  int coordinates[TArray<fast_divmod>::Capacity()];
+  int remainder = id;
+  for (int dim = 0; dim < fdm_output_strides.Size(); ++dim) {
+    fdm_output_strides[dim].divmod(remainder, coordinates[dim], remainder);
+  }
+
+  // every value is computed in float and only rounded to T when the output is written
+  float values[kMaxFusedElementwiseInputs + kMaxFusedElementwiseInstructions];
+  for (int i = 0; i < program.num_inputs; ++i) {
+    const TArray<int64_t>& strides = inputs.padded_strides[i];
+    CUDA_LONG offset = id;
+    if (strides.Size() > 0) {
+      offset = 0;
+      for (int dim = 0; dim < strides.Size(); ++dim) {
+        offset += static_cast<CUDA_LONG>(strides[dim]) * coordinates[dim];
+      }
+    }
+    values[i] = static_cast<float>(inputs.data[i][offset]);
+  }
+
+  for (int i = 0; i < program.num_instructions; ++i) {
+    const FusedElementwiseInstruction& instruction = program.instructions[i];
+    const float b = instruction.operand1 >= 0 ? values[instruction.operand1] : 0.0f;
+    values[program.num_inputs + i] = Evaluate(instruction.op, values[instruction.operand0], b);
+  }
+
+  output[id] = static_cast<T>(values[program.num_inputs + program.num_instructions - 1]);
+}
+
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs,
+                                  const TArray<fast_divmod>& fdm_output_strides, T* output, size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  const int blocks_per_grid = static_cast<int>(CeilDiv(count, GridDim::maxThreadsPerBlock));
+  FusedElementwiseKernel<T><<<blocks_per_grid, GridDim::maxThreadsPerBlock, 0, stream>>>(
+      program, inputs, fdm_output_strides, output, static_cast<CUDA_LONG>(count));
+}
+
+#define SPECIALIZED_FUSED_ELEMENTWISE_IMPL(T)                                                               \
+  template void LaunchFusedElementwiseKernel<T>(cudaStream_t stream, const FusedElementwiseProgram& program, \
+                                                const FusedElementwiseInputs<T>& inputs,                    \
+                                                const TArray<fast_divmod>& fdm_output_strides, T* output,   \
+                                                size_t count)
+
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(float);
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(half);
+
+#undef SPECIALIZED_FUSED_ELEMENTWISE_IMPL
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+#include "core/providers/cuda/shared_inc/fast_divmod.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The largest FusedElementwise node the CUDA kernel evaluates. ElementwiseChainFusion does not create larger ones
+// for the CUDA EP.
+constexpr int kMaxFusedElementwiseInputs = 8;
+constexpr int kMaxFusedElementwiseInstructions = 32;
+
+enum class FusedElementwiseOp : int32_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Sigmoid,
+  Tanh,
+  Relu,
+  Exp,
+  Erf,
+  Neg,
+  Abs,
+  Sqrt,
+  Reciprocal,
+};
+
+struct FusedElementwiseInstruction {
+  FusedElementwiseOp op;
+  int32_t operand0;
+  int32_t operand1;  // -1 for a unary operator
+};
+
+// The instructions of a FusedElementwise node, passed to the kernel by value.
+struct FusedElementwiseProgram {
+  int32_t num_inputs;
+  int32_t num_instructions;
+  FusedElementwiseInstruction instructions[kMaxFusedElementwiseInstructions];
+};
+
+// The inputs of a FusedElementwise node. padded_strides[i] holds the strides of input i over the dims of the output,
+// 0 along the broadcast dims. It is empty if input i has the shape of the output.
+template <typename T>
+struct FusedElementwiseInputs {
+  const T* data[kMaxFusedElementwiseInputs];
+  onnxruntime::cuda::TArray<int64_t> padded_strides[kMaxFusedElementwiseInputs];
+};
+
+// Evaluates the program for every one of the count elements of the output in one launch, with the intermediate
+// results kept in registers. fdm_output_strides is empty if no input is broadcast.
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs,
+                                  const onnxruntime::cuda::TArray<onnxruntime::cuda::fast_divmod>& fdm_output_strides,
+                                  T* output, size_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -56,14 +56,61 @@ template <typename TValue>
 int32_t GetTypeAndShape(const TValue* input,
                         TensorShape& shape,
                         bool swap = false) {
-  shape = input->Shape();
-  ORT_ENFORCE(shape.NumDimensions() == 2);
+  const TensorShape& input_shape = input->Shape();
+  const size_t rank = input_shape.NumDimensions();
+  ORT_ENFORCE(rank >= 2);
+  // The leading dimensions of a batched input are flattened into the rows of the matrix.
+  shape = rank == 2 ? input_shape : TensorShape({input_shape.SizeToDimension(rank - 1), input_shape[rank - 1]});
   if (swap) {
     std::swap(shape[0], shape[1]);
   }
   return input->GetElementType();
 }
 
+// Shape of the output, with the leading dimensions of a batched A.
+static TensorShape GetOutputShape(const TensorShape& shape_A, int M, int N) {
+  if (shape_A.NumDimensions() == 2) {
+    return TensorShape({M, N});
+  }
+  TensorShapeVector dims = shape_A.AsShapeVector();
+  dims.back() = N;
+  return TensorShape(dims);
+}
+
+template <typename T>
+__global__ void _ScaleColumns(T* y, const float* scales, CUDA_LONG N, CUDA_LONG size) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, size);
+  y[id] = T(static_cast<float>(y[id]) * scales[id % N]);
+}
+
+// Multiplies every column of the row major [M, N] output by its scale.
+static Status ScaleColumns(cudaStream_t stream, int32_t dtype_Y, void* p_output_y, const float* scales,
+                           int M, int N) {
+  const CUDA_LONG size = static_cast<CUDA_LONG>(M) * N;
+  if (size == 0) {
+    return Status::OK();
+  }
+  const int blocks = static_cast<int>(CeilDiv(size, GridDim::maxThreadsPerBlock));
+  switch (dtype_Y) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      _ScaleColumns<float><<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(
+          static_cast<float*>(p_output_y), scales, N, size);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      _ScaleColumns<half><<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(
+          static_cast<half*>(p_output_y), scales, N, size);
+      break;
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      _ScaleColumns<BFloat16><<<blocks, GridDim::maxThreadsPerBlock, 0, stream>>>(
+          static_cast<BFloat16*>(p_output_y), scales, N, size);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "A scaleB per column requires a float, float16 or bfloat16 output, not ", dtype_Y, ".");
+  }
+  return CUDA_CALL(cudaGetLastError());
+}
+
 Status GemmFloat8::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* input_A = nullptr;
   const Tensor* input_B = nullptr;
@@ -96,6 +143,17 @@ Status GemmFloat8::ComputeInternal(OpKernelContext* ctx) const {
     }
   }
 
+  ORT_RETURN_IF(input_B->Shape().NumDimensions() != 2, "B must be a matrix.");
+  ORT_RETURN_IF(input_A->Shape().NumDimensions() != 2 && transA_, "A must be a matrix if transA is set.");
+  if (has_scales && scale_B->Shape().Size() != 1) {
+    // The scales of the columns of B are applied to the output, cublasLt only takes scalars.
+    const int64_t N = input_B->Shape()[transB_ ? 0 : 1];
+    ORT_RETURN_IF(scale_B->Shape().NumDimensions() != 1 || scale_B->Shape()[0] != N,
+                  "scaleB must be a scalar or have the N=", N, " elements of the columns of B.");
+    ORT_RETURN_IF(has_bias || epilogue_ != CUBLASLT_EPILOGUE_DEFAULT || scale_Y != nullptr,
+                  "A scaleB per column is not supported with C, an activation or scaleY.");
+  }
+
   auto first_type = input_A->GetElementType();
 #if !defined(DISABLE_FLOAT8_TYPES)
   bool is_float8 = first_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN || first_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E5M2;
@@ -122,19 +180,23 @@ Status GemmFloat8::ComputeRowMajor(
   int M, N, K, lda, ldb, ldd;
   SetParams(shape_A, shape_B, M, N, K, lda, ldb, ldd);
 
-  TensorShape dimensions{M, N};
-  Tensor* Y = ctx->Output(0, dimensions);
+  Tensor* Y = ctx->Output(0, GetOutputShape(input_A->Shape(), M, N));
   dtype_Y = GetTypeAndShape(Y, shape_Y);
   dtype_C = has_bias ? GetTypeAndShape(input_C, shape_C)
                      : ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
-  return ComputeGemm(ctx, n_inputs, has_bias, has_scales, dtype_A, dtype_B, dtype_C,
-                     dtype_Y, shape_A, shape_B, shape_C, shape_Y, transA_, transB_,
-                     input_A->DataRaw(), input_B->DataRaw(),
-                     has_bias ? input_C->DataRaw() : nullptr,
-                     has_scales ? scale_A->DataRaw() : nullptr,
-                     has_scales ? scale_B->DataRaw() : nullptr,
-                     has_scales && scale_Y != nullptr ? scale_Y->DataRaw() : nullptr,
-                     Y->MutableDataRaw(), M, N, K, lda, ldb, ldd, true);
+  const bool scale_per_column = has_scales && scale_B->Shape().Size() != 1;
+  ORT_RETURN_IF_ERROR(ComputeGemm(ctx, n_inputs, has_bias, has_scales, dtype_A, dtype_B, dtype_C,
+                                  dtype_Y, shape_A, shape_B, shape_C, shape_Y, transA_, transB_,
+                                  input_A->DataRaw(), input_B->DataRaw(),
+                                  has_bias ? input_C->DataRaw() : nullptr,
+                                  has_scales ? scale_A->DataRaw() : nullptr,
+                                  has_scales && !scale_per_column ? scale_B->DataRaw() : nullptr,
+                                  has_scales && scale_Y != nullptr ? scale_Y->DataRaw() : nullptr,
+                                  Y->MutableDataRaw(), M, N, K, lda, ldb, ldd, true));
+  if (scale_per_column) {
+    ORT_RETURN_IF_ERROR(ScaleColumns(Stream(ctx), dtype_Y, Y->MutableDataRaw(), scale_B->Data<float>(), M, N));
+  }
+  return Status::OK();
 }
 
 Status GemmFloat8::ComputeColMajor(
@@ -153,20 +215,24 @@ Status GemmFloat8::ComputeColMajor(
   std::swap(shape_A[0], shape_A[1]);
   std::swap(shape_B[0], shape_B[1]);
 
-  TensorShape dimensions{M, N};
-  Tensor* Y = ctx->Output(0, dimensions);
+  Tensor* Y = ctx->Output(0, GetOutputShape(input_A->Shape(), M, N));
   dtype_Y = GetTypeAndShape(Y, shape_Y);
   dtype_C = has_bias ? GetTypeAndShape(input_C, shape_C, true)
                      : ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
 
-  return ComputeGemm(ctx, n_inputs, has_bias, has_scales, dtype_B, dtype_A, dtype_C,
-                     dtype_Y, shape_B, shape_A, shape_C, shape_Y, transB_, transA_,
-                     input_B->DataRaw(), input_A->DataRaw(),
-                     has_bias ? input_C->DataRaw() : nullptr,
-                     has_scales ? scale_B->DataRaw() : nullptr,
-                     has_scales ? scale_A->DataRaw() : nullptr,
-                     has_scales && scale_Y != nullptr ? scale_Y->DataRaw() : nullptr,
-                     Y->MutableDataRaw(), N, M, K, ldb, lda, ldd, false);
+  const bool scale_per_column = has_scales && scale_B->Shape().Size() != 1;
+  ORT_RETURN_IF_ERROR(ComputeGemm(ctx, n_inputs, has_bias, has_scales, dtype_B, dtype_A, dtype_C,
+                                  dtype_Y, shape_B, shape_A, shape_C, shape_Y, transB_, transA_,
+                                  input_B->DataRaw(), input_A->DataRaw(),
+                                  has_bias ? input_C->DataRaw() : nullptr,
+                                  has_scales && !scale_per_column ? scale_B->DataRaw() : nullptr,
+                                  has_scales ? scale_A->DataRaw() : nullptr,
+                                  has_scales && scale_Y != nullptr ? scale_Y->DataRaw() : nullptr,
+                                  Y->MutableDataRaw(), N, M, K, ldb, lda, ldd, false));
+  if (scale_per_column) {
+    ORT_RETURN_IF_ERROR(ScaleColumns(Stream(ctx), dtype_Y, Y->MutableDataRaw(), scale_B->Data<float>(), M, N));
+  }
+  return Status::OK();
 }
 
 Status GemmFloat8::ComputeGemm(
@@ -180,10 +246,7 @@ Status GemmFloat8::ComputeGemm(
     const void* p_scale_y, void* p_output_y, int M, int N, int K, int lda,
     int ldb, int ldd, bool row_major_compute) const {
   cudaStream_t stream = Stream(ctx);
-  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
-
-  cublasLtHandle_t cublasLt;
-  CUBLAS_RETURN_IF_ERROR(cublasLtCreate(&cublasLt));
+  cublasLtHandle_t cublasLt = CublasLtHandle();
 
   cublasLtMatmulDesc_t operationDesc = nullptr;
   cublasLtMatrixLayout_t Adesc = nullptr, Bdesc = nullptr, Cdesc = nullptr,
@@ -320,9 +383,8 @@ Status GemmFloat8::ComputeGemm(
 
   // See
   // https://docs.nvidia.com/cuda/cublas/index.html?highlight=cublasLtMatmulPreferenceAttributes_t#cublasltmatmulpreferenceattributes-t
-  // The workspace should be allocated once from OpKernelContext assuming
-  // only one cuda function is running at a time (which is not necessarily true
-  // with H100).
+  // The workspace is a scratch buffer of the compute stream, so it is reused by
+  // the following kernels instead of being allocated by every call.
   size_t workspaceSize = static_cast<size_t>(1 << 25);  // suggested fixed value 32Mb
   cublasLtMatmulPreference_t preference = nullptr;
   cublasLtMatmulPreferenceCreate(&preference);
@@ -362,10 +424,8 @@ Status GemmFloat8::ComputeGemm(
       "index.html?highlight=cublasLtMatmulAlgoGetHeuristic#"
       "cublasltmatmulalgogetheuristic. CUDA>=11.8 is required to use float 8 types.");
 
-  void* workspace = nullptr;
-  if (workspaceSize > 0) {
-    CUDA_RETURN_IF_ERROR(cudaMalloc(reinterpret_cast<void**>(&workspace), workspaceSize));
-  }
+  auto workspace_buffer = GetScratchBuffer<void>(workspaceSize, ctx->GetComputeStream());
+  void* workspace = workspace_buffer.get();
   // https://docs.nvidia.com/cuda/cublas/index.html?highlight=cublasLtMatmul#cublasltmatmul
   const void* bias = has_bias ? p_input_c : p_output_y;
   cuda_status = cublasLtMatmul(
@@ -399,17 +459,12 @@ Status GemmFloat8::ComputeGemm(
       ", rowMajorCompute=", (row_major_compute ? 1 : 0),
       ". CUDA>=11.8 is required to use float 8 types.");
 
-  if (workspaceSize > 0) {
-    CUDA_RETURN_IF_ERROR(cudaFree(workspace));
-  }
-
   CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceDestroy(preference));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Ddesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Cdesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Bdesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Adesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescDestroy(operationDesc));
-  CUBLAS_RETURN_IF_ERROR(cublasLtDestroy(cublasLt));
   return Status::OK();
 }
 
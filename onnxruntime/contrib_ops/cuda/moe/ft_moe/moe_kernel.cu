@@ -20,6 +20,7 @@
 #include <cfloat>
 #include <cuda.h>
 #include <cuda_fp16.h>
+#include <initializer_list>
 #include <math.h>
 #include <sstream>
 
@@ -807,12 +808,12 @@ template <typename T>
 void elementWiseMul(T *output, T const *input, int inter_size, int num_tokens, cudaStream_t stream) {
     int const blocks = num_tokens;
 
-    if (inter_size & 3 == 0) {
+    if ((inter_size & 3) == 0) {
         using vec_type = typename T4<T>::Type;
         int const threads = std::min(inter_size / 4, 1024);
         elementWiseMulKernel<vec_type><<<blocks, threads, 0, stream>>>(
             reinterpret_cast<vec_type *>(output), reinterpret_cast<vec_type const *>(input), inter_size / 4);
-    } else if (inter_size & 1 == 0) {
+    } else if ((inter_size & 1) == 0) {
         using vec_type = typename T2<T>::Type;
         int const threads = std::min(inter_size / 2, 1024);
         elementWiseMulKernel<vec_type><<<blocks, threads, 0, stream>>>(
@@ -996,11 +997,30 @@ void CutlassMoeFCRunner<T, WeightType, Enable>::get_total_rows_info(int64_t expe
 // (k-1)*rows_in_input all map to row 0 in the original matrix. Thus, to know where to read in the source matrix, we
 // simply take the modulus of the expanded index.
 
+// The rows are copied and reduced with 16 byte accesses when the number of columns and the pointers allow it.
+constexpr int kRoutingAccessBytes = 16;
+
 template <typename T>
+bool can_access_rows_vectorized(int cols, std::initializer_list<const T *> ptrs) {
+    constexpr int elts_per_access = kRoutingAccessBytes / sizeof(T);
+    if (cols % elts_per_access != 0) {
+        return false;
+    }
+    for (const T *ptr : ptrs) {
+        if (ptr != nullptr && reinterpret_cast<uintptr_t>(ptr) % kRoutingAccessBytes != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, int ELTS_PER_ACCESS>
 __global__ void initialize_moe_routing_kernel(const T *unpermuted_input, T *permuted_output,
                                               const int *expanded_dest_row_to_expanded_source_row,
                                               int *expanded_source_row_to_expanded_dest_row, int num_rows,
                                               int active_rows, int cols) {
+    using AccessType = cutlass::AlignedArray<T, ELTS_PER_ACCESS>;
+
     // Reverse permutation map.
     // I do this so that later, we can use the source -> dest map to do the k-way reduction and unpermuting. I need
     // the reverse map for that reduction to allow each threadblock to do 1 k-way reduce without atomics later in
@@ -1015,10 +1035,12 @@ __global__ void initialize_moe_routing_kernel(const T *unpermuted_input, T *perm
         // Duplicate and permute rows
         const int source_row = expanded_source_row % num_rows;
 
-        const T *source_row_ptr = unpermuted_input + source_row * cols;
-        T *dest_row_ptr = permuted_output + expanded_dest_row * cols;
+        const AccessType *source_row_ptr =
+            reinterpret_cast<const AccessType *>(unpermuted_input + int64_t(source_row) * cols);
+        AccessType *dest_row_ptr = reinterpret_cast<AccessType *>(permuted_output + int64_t(expanded_dest_row) * cols);
 
-        for (int tid = threadIdx.x; tid < cols; tid += blockDim.x) {
+        const int accesses_per_row = cols / ELTS_PER_ACCESS;
+        for (int tid = threadIdx.x; tid < accesses_per_row; tid += blockDim.x) {
             dest_row_ptr[tid] = source_row_ptr[tid];
         }
     }
@@ -1030,48 +1052,65 @@ void initialize_moe_routing_kernelLauncher(const T *unpermuted_input, T *permute
                                            int *expanded_source_row_to_expanded_dest_row, int num_rows, int active_rows,
                                            int cols, int k, cudaStream_t stream) {
     const int blocks = num_rows * k;
-    const int threads = std::min(cols, 1024);
-    initialize_moe_routing_kernel<T>
-        <<<blocks, threads, 0, stream>>>(unpermuted_input, permuted_output, expanded_dest_row_to_expanded_source_row,
-                                         expanded_source_row_to_expanded_dest_row, num_rows, k * active_rows, cols);
+    if (can_access_rows_vectorized<T>(cols, {unpermuted_input, permuted_output})) {
+        constexpr int elts_per_access = kRoutingAccessBytes / sizeof(T);
+        const int threads = std::min(cols / elts_per_access, 1024);
+        initialize_moe_routing_kernel<T, elts_per_access>
+            <<<blocks, threads, 0, stream>>>(unpermuted_input, permuted_output, expanded_dest_row_to_expanded_source_row,
+                                             expanded_source_row_to_expanded_dest_row, num_rows, k * active_rows, cols);
+    } else {
+        const int threads = std::min(cols, 1024);
+        initialize_moe_routing_kernel<T, 1>
+            <<<blocks, threads, 0, stream>>>(unpermuted_input, permuted_output, expanded_dest_row_to_expanded_source_row,
+                                             expanded_source_row_to_expanded_dest_row, num_rows, k * active_rows, cols);
+    }
 }
 
 // Final kernel to unpermute and scale
 // This kernel unpermutes the original data, does the k-way reduction and performs the final skip connection.
 #if defined(__CUDA_ARCH__) && __CUDA_ARCH__ < 530
-template <typename T, int RESIDUAL_NUM>
+template <typename T, int RESIDUAL_NUM, int ELTS_PER_ACCESS>
 __global__ void finalize_moe_routing_kernel(const T *, T *, const T *, const T *, const T *, const T *, const int *,
                                             const int *, int, const int) {
     // Does not support pre-Kepler architectures
     ;
 }
 #else
-template <typename T, int RESIDUAL_NUM>
+template <typename T, int RESIDUAL_NUM, int ELTS_PER_ACCESS>
 __global__ void finalize_moe_routing_kernel(const T *expanded_permuted_rows, T *reduced_unpermuted_output,
                                             const T *skip_1, const T *skip_2, const T *bias, const T *scales,
                                             const int *expanded_source_row_to_expanded_dest_row,
                                             const int *expert_for_source_row, int cols, int k) {
+    using AccessType = cutlass::AlignedArray<T, ELTS_PER_ACCESS>;
+
     const int original_row = blockIdx.x;
     int num_rows = gridDim.x;
-    T *reduced_row_ptr = reduced_unpermuted_output + original_row * cols;
+    AccessType *reduced_row_ptr =
+        reinterpret_cast<AccessType *>(reduced_unpermuted_output + int64_t(original_row) * cols);
 
-    const T *skip_1_row_ptr = nullptr;
-    if (RESIDUAL_NUM == 1) {
-        skip_1_row_ptr = skip_1 + original_row * cols;
+    const AccessType *skip_1_row_ptr = nullptr;
+    if (RESIDUAL_NUM >= 1) {
+        skip_1_row_ptr = reinterpret_cast<const AccessType *>(skip_1 + int64_t(original_row) * cols);
     }
-    const T *skip_2_row_ptr = nullptr;
+    const AccessType *skip_2_row_ptr = nullptr;
     if (RESIDUAL_NUM == 2) {
-        skip_2_row_ptr = skip_2 + original_row * cols;
+        skip_2_row_ptr = reinterpret_cast<const AccessType *>(skip_2 + int64_t(original_row) * cols);
     }
 
-    for (int tid = threadIdx.x; tid < cols; tid += blockDim.x) {
-        T thread_output;
+    const int accesses_per_row = cols / ELTS_PER_ACCESS;
+    for (int tid = threadIdx.x; tid < accesses_per_row; tid += blockDim.x) {
+        AccessType thread_output;
         if (RESIDUAL_NUM == 0) {
-            thread_output = T(0);
+            thread_output.fill(T(0));
         } else if (RESIDUAL_NUM == 1) {
             thread_output = skip_1_row_ptr[tid];
         } else if (RESIDUAL_NUM == 2) {
-            thread_output = skip_1_row_ptr[tid] + skip_2_row_ptr[tid];
+            const AccessType skip_1_value = skip_1_row_ptr[tid];
+            const AccessType skip_2_value = skip_2_row_ptr[tid];
+#pragma unroll
+            for (int i = 0; i < ELTS_PER_ACCESS; ++i) {
+                thread_output[i] = skip_1_value[i] + skip_2_value[i];
+            }
         }
         for (int k_idx = 0; k_idx < k; ++k_idx) {
             const int expanded_original_row = original_row + k_idx * num_rows;
@@ -1079,29 +1118,56 @@ __global__ void finalize_moe_routing_kernel(const T *expanded_permuted_rows, T *
 
             const int64_t k_offset = original_row * k + k_idx;
             const T row_scale = scales[k_offset];
-            const T *expanded_permuted_rows_row_ptr = expanded_permuted_rows + expanded_permuted_row * cols;
-
-            const int expert_idx = expert_for_source_row[k_offset];
-            const T *bias_ptr = bias ? bias + expert_idx * cols : nullptr;
+            const AccessType expanded_permuted_value = reinterpret_cast<const AccessType *>(
+                expanded_permuted_rows + int64_t(expanded_permuted_row) * cols)[tid];
+
+            AccessType bias_value;
+            if (bias) {
+                const int expert_idx = expert_for_source_row[k_offset];
+                bias_value = reinterpret_cast<const AccessType *>(bias + int64_t(expert_idx) * cols)[tid];
+            } else {
+                bias_value.fill(T(0));
+            }
 
-            thread_output =
-                thread_output + row_scale * (expanded_permuted_rows_row_ptr[tid] + (bias_ptr ? bias_ptr[tid] : T(0)));
+#pragma unroll
+            for (int i = 0; i < ELTS_PER_ACCESS; ++i) {
+                thread_output[i] = thread_output[i] + row_scale * (expanded_permuted_value[i] + bias_value[i]);
+            }
         }
         reduced_row_ptr[tid] = thread_output;
     }
 }
 #endif
 
+template <typename T, int RESIDUAL_NUM>
+void finalize_moe_routing_kernelLauncherImpl(const T *expanded_permuted_rows, T *reduced_unpermuted_output,
+                                             const T *skip_1, const T *skip_2, const T *bias, const T *scales,
+                                             const int *expanded_source_row_to_expanded_dest_row,
+                                             const int *expert_for_source_row, int num_rows, int cols, int k,
+                                             cudaStream_t stream) {
+    const int blocks = num_rows;
+    if (can_access_rows_vectorized<T>(cols, {expanded_permuted_rows, reduced_unpermuted_output, skip_1, skip_2, bias})) {
+        constexpr int elts_per_access = kRoutingAccessBytes / sizeof(T);
+        const int threads = std::min(cols / elts_per_access, 1024);
+        finalize_moe_routing_kernel<T, RESIDUAL_NUM, elts_per_access><<<blocks, threads, 0, stream>>>(
+            expanded_permuted_rows, reduced_unpermuted_output, skip_1, skip_2, bias, scales,
+            expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+    } else {
+        const int threads = std::min(cols, 1024);
+        finalize_moe_routing_kernel<T, RESIDUAL_NUM, 1><<<blocks, threads, 0, stream>>>(
+            expanded_permuted_rows, reduced_unpermuted_output, skip_1, skip_2, bias, scales,
+            expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+    }
+}
+
 template <typename T>
 void finalize_moe_routing_kernelLauncher(const T *expanded_permuted_rows, T *reduced_unpermuted_output, const T *bias,
                                          const T *scales, const int *expanded_source_row_to_expanded_dest_row,
                                          const int *expert_for_source_row, int num_rows, int cols, int k,
                                          cudaStream_t stream) {
-    const int blocks = num_rows;
-    const int threads = std::min(cols, 1024);
-    finalize_moe_routing_kernel<T, 0><<<blocks, threads, 0, stream>>>(
-        expanded_permuted_rows, reduced_unpermuted_output, nullptr, nullptr, bias, scales,
-        expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+    finalize_moe_routing_kernelLauncherImpl<T, 0>(expanded_permuted_rows, reduced_unpermuted_output, nullptr, nullptr,
+                                                  bias, scales, expanded_source_row_to_expanded_dest_row,
+                                                  expert_for_source_row, num_rows, cols, k, stream);
 }
 
 template <typename T>
@@ -1110,11 +1176,9 @@ void finalize_moe_routing_kernelLauncher(const T *expanded_permuted_rows, T *red
                                          const int *expanded_source_row_to_expanded_dest_row,
                                          const int *expert_for_source_row, int num_rows, int cols, int k,
                                          cudaStream_t stream) {
-    const int blocks = num_rows;
-    const int threads = std::min(cols, 1024);
-    finalize_moe_routing_kernel<T, 1>
-        <<<blocks, threads, 0, stream>>>(expanded_permuted_rows, reduced_unpermuted_output, skip, nullptr, bias, scales,
-                                         expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+    finalize_moe_routing_kernelLauncherImpl<T, 1>(expanded_permuted_rows, reduced_unpermuted_output, skip, nullptr,
+                                                  bias, scales, expanded_source_row_to_expanded_dest_row,
+                                                  expert_for_source_row, num_rows, cols, k, stream);
 }
 
 template <typename T>
@@ -1123,16 +1187,14 @@ void finalize_moe_routing_kernelLauncher(const T *expanded_permuted_rows, T *red
                                          const int *expanded_source_row_to_expanded_dest_row,
                                          const int *expert_for_source_row, int num_rows, int cols, int k,
                                          cudaStream_t stream) {
-    const int blocks = num_rows;
-    const int threads = std::min(cols, 1024);
     if (skip_2 == nullptr) {
-        finalize_moe_routing_kernel<T, 1><<<blocks, threads, 0, stream>>>(
-            expanded_permuted_rows, reduced_unpermuted_output, skip_1, skip_2, bias, scales,
-            expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+        finalize_moe_routing_kernelLauncherImpl<T, 1>(expanded_permuted_rows, reduced_unpermuted_output, skip_1,
+                                                      nullptr, bias, scales, expanded_source_row_to_expanded_dest_row,
+                                                      expert_for_source_row, num_rows, cols, k, stream);
     } else {
-        finalize_moe_routing_kernel<T, 2><<<blocks, threads, 0, stream>>>(
-            expanded_permuted_rows, reduced_unpermuted_output, skip_1, skip_2, bias, scales,
-            expanded_source_row_to_expanded_dest_row, expert_for_source_row, cols, k);
+        finalize_moe_routing_kernelLauncherImpl<T, 2>(expanded_permuted_rows, reduced_unpermuted_output, skip_1,
+                                                      skip_2, bias, scales, expanded_source_row_to_expanded_dest_row,
+                                                      expert_for_source_row, num_rows, cols, k, stream);
     }
 }
 
@@ -4,9 +4,11 @@
 #include "contrib_ops/cuda/quantization/matmul_nbits.h"
 
 #include <cstdint>
+#include <vector>
 
 #include "core/common/status.h"
 #include "core/framework/float16.h"
+#include "core/mickey/blk_q4/f16_prepack_sm80.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "matmul_nbits.cuh"
 #include "dequantize_blockwise.cuh"
@@ -16,6 +18,94 @@ namespace contrib {
 namespace cuda {
 using namespace onnxruntime::cuda;
 
+namespace {
+// Calls fn with the BlockwiseQuantization of 4-bit column wise blocks of block_size fp16 elements.
+template <typename Fn>
+void VisitSm80BlockwiseQuantization(int64_t block_size, Fn&& fn) {
+  switch (block_size) {
+    case 16:
+      fn(BlockwiseQuantization<MLFloat16, 16, 4, true>{});
+      break;
+    case 32:
+      fn(BlockwiseQuantization<MLFloat16, 32, 4, true>{});
+      break;
+    case 64:
+      fn(BlockwiseQuantization<MLFloat16, 64, 4, true>{});
+      break;
+    default:
+      ORT_THROW("Unsupported block size for the SM80 prepacked layout: ", block_size);
+  }
+}
+
+// Copies the tensor to the host, prepacks it with prepack and copies the result to a buffer of alloc.
+template <typename ElementT, typename Prepack>
+Status PrepackOnHost(const Tensor& tensor, size_t packed_size, AllocatorPtr alloc, Prepack&& prepack,
+                     IAllocatorUniquePtr<ElementT>& packed) {
+  const size_t size = SafeInt<size_t>(tensor.SizeInBytes()) / sizeof(ElementT);
+  std::vector<ElementT> host(size);
+  CUDA_RETURN_IF_ERROR(cudaMemcpy(host.data(), tensor.DataRaw(), tensor.SizeInBytes(), cudaMemcpyDeviceToHost));
+
+  std::vector<ElementT> host_packed(packed_size);
+  prepack(gsl::make_span(host), gsl::make_span(host_packed));
+
+  packed = IAllocator::MakeUniquePtr<ElementT>(alloc, packed_size, true);
+  CUDA_RETURN_IF_ERROR(cudaMemcpy(packed.get(), host_packed.data(), packed_size * sizeof(ElementT),
+                                  cudaMemcpyHostToDevice));
+  return Status::OK();
+}
+}  // namespace
+
+template <typename T>
+Status MatMulNBits<T>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                               /*out*/ bool& is_packed,
+                               /*out*/ PrePackedWeights* /*prepacked_weights*/) {
+  is_packed = false;
+  if constexpr (std::is_same_v<T, MLFloat16>) {
+    if (!prepack_sm80_) {
+      return Status::OK();
+    }
+
+    const int rows = SafeInt<int>(K_);
+    const int columns = SafeInt<int>(N_);
+    const size_t meta_size = SafeInt<size_t>(K_ / block_size_) * N_;
+    if (input_idx == 1 && tensor.SizeInBytes() == SafeInt<size_t>(K_) * N_ / 2) {
+      ORT_RETURN_IF_ERROR(PrepackOnHost<uint8_t>(
+          tensor, tensor.SizeInBytes(), alloc,
+          [&](gsl::span<const uint8_t> weights, gsl::span<uint8_t> packed) {
+            VisitSm80BlockwiseQuantization(block_size_, [&](auto quantization) {
+              decltype(quantization)::prepack_weights(rows, columns, weights, packed);
+            });
+          },
+          packed_b_sm80_));
+    } else if (input_idx == 2 && static_cast<size_t>(tensor.Shape().Size()) == meta_size) {
+      ORT_RETURN_IF_ERROR(PrepackOnHost<MLFloat16>(
+          tensor, meta_size, alloc,
+          [&](gsl::span<const MLFloat16> scales, gsl::span<MLFloat16> packed) {
+            VisitSm80BlockwiseQuantization(block_size_, [&](auto quantization) {
+              decltype(quantization)::prepack_quant_scales(rows, columns, scales, packed);
+            });
+          },
+          packed_scales_sm80_));
+    } else if (input_idx == 3 && tensor.IsDataType<uint8_t>() &&
+               static_cast<size_t>(tensor.Shape().Size()) == SafeInt<size_t>((K_ / block_size_ + 1) / 2) * N_) {
+      ORT_RETURN_IF_ERROR(PrepackOnHost<uint8_t>(
+          tensor, meta_size, alloc,
+          [&](gsl::span<const uint8_t> offsets, gsl::span<uint8_t> packed) {
+            VisitSm80BlockwiseQuantization(block_size_, [&](auto quantization) {
+              decltype(quantization)::prepack_quant_offsets(rows, columns, offsets, packed);
+            });
+          },
+          packed_zero_points_sm80_));
+    }
+  } else {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    ORT_UNUSED_PARAMETER(alloc);
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* a = ctx->Input<Tensor>(0);
@@ -62,6 +152,25 @@ Status MatMulNBits<T>::ComputeInternal(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+  if constexpr (std::is_same_v<T, MLFloat16>) {
+    const bool is_sm80_prepacked = packed_b_sm80_ && packed_scales_sm80_ &&
+                                   (zero_points == nullptr || packed_zero_points_sm80_) && reorder_idx == nullptr;
+    if (is_sm80_prepacked && helper.OutputOffsets().size() == 1 &&
+        TryBlkQ4GemmSm80(
+            reinterpret_cast<half*>(Y->MutableData<T>()),
+            reinterpret_cast<const half*>(a_data),
+            packed_b_sm80_.get(),
+            reinterpret_cast<const half*>(packed_scales_sm80_.get()),
+            zero_points == nullptr ? nullptr : packed_zero_points_sm80_.get(),
+            SafeInt<int>(helper.M()),
+            SafeInt<int>(helper.N()),
+            SafeInt<int>(helper.K()),
+            SafeInt<int>(block_size_),
+            static_cast<cudaStream_t>(ctx->GetComputeStream()->GetHandle()))) {
+      return Status::OK();
+    }
+  }
+
   int64_t K_padded = (K_ + block_size_ - 1) / block_size_ * block_size_;
   IAllocatorUniquePtr<T> b_data_ptr = GetScratchBuffer<T>(N_ * K_padded, ctx->GetComputeStream());
   auto* b_data = b_data_ptr.get();
@@ -22,6 +22,24 @@ bool TryMatMul4Bits(
     int shared_mem_per_block,
     cudaStream_t stream);
 
+// Whether TryBlkQ4GemmSm80() supports the shape, block_size is the number of elements along K of a block.
+bool IsBlkQ4GemmSm80Available(int sm, int n, int k, int block_size);
+
+// fp16 GEMM on the tensor cores that dequantizes B in registers. B, its scales and zero points are those of
+// MatMulNBits prepacked with onnxruntime::cuda::BlockwiseQuantization for column wise blocks. Returns false if the
+// kernel can't run the problem, e.g. because of the alignment of the pointers.
+bool TryBlkQ4GemmSm80(
+    half* output,
+    const half* a_data,
+    const uint8_t* packed_b,
+    const half* packed_scales,
+    const uint8_t* packed_zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    cudaStream_t stream);
+
 }  // namespace cuda
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -7,9 +7,12 @@
 // pre-packed and block-compacted into int4
 //
 #pragma once
+#include <type_traits>
+
 #include "core/common/safeint.h"
 #include "core/providers/cuda/cuda_kernel.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
+#include "contrib_ops/cuda/quantization/matmul_nbits.cuh"
 
 namespace onnxruntime {
 namespace contrib {
@@ -24,16 +27,31 @@ class MatMulNBits final : public CudaKernel {
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("N", &N_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("block_size", &block_size_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("bits", &nbits_));
+
+    const int sm = GetDeviceProp().major * 10 + GetDeviceProp().minor;
+    prepack_sm80_ = std::is_same_v<T, MLFloat16> && nbits_ == 4 &&
+                    IsBlkQ4GemmSm80Available(sm, SafeInt<int>(N_), SafeInt<int>(K_), SafeInt<int>(block_size_));
   }
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
  private:
   int64_t K_;
   int64_t N_;
   int64_t block_size_;
   int64_t nbits_;
   bool column_wise_quant_blk_{true};
+
+  // B, scales and zero points prepacked for TryBlkQ4GemmSm80(), which multiplies A with more than one row. Inputs
+  // B and scales are still used by the kernel for a single row, so they are kept.
+  bool prepack_sm80_{false};
+  IAllocatorUniquePtr<uint8_t> packed_b_sm80_{};
+  IAllocatorUniquePtr<T> packed_scales_sm80_{};
+  IAllocatorUniquePtr<uint8_t> packed_zero_points_sm80_{};
 };
 
 }  // namespace cuda
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_fp16.h>
+#include "core/providers/cuda/cuda_common.h"
+#include "matmul_nbits.cuh"
+
+#if defined(CUDA_VERSION) && CUDA_VERSION <= 12030
+#include "core/mickey/blk_q4/f16_gemm_sm80.h"
+#endif
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#if defined(CUDA_VERSION) && CUDA_VERSION <= 12030
+
+namespace {
+
+template <int block_size, bool small_m, bool has_zero_point>
+bool RunBlkQ4GemmSm80(
+    half* output,
+    const half* a_data,
+    const uint8_t* packed_b,
+    const half* packed_scales,
+    const uint8_t* packed_zero_points,
+    int m,
+    int n,
+    int k,
+    cudaStream_t stream) {
+  using GemmRunner = onnxruntime::cuda::BlkQ4F16GemmImpl<cutlass::half_t, cutlass::MatrixShape<block_size, 1>,
+                                                         small_m, has_zero_point>;
+
+  using ElementInputA = typename GemmRunner::ElementInputA;
+  using ElementOutput = typename GemmRunner::ElementOutput;
+  using ElementWPack = typename GemmRunner::ElementWPack;
+  using ElementQScale = typename GemmRunner::ElementQScale;
+  using ElementQOffset = typename GemmRunner::ElementQOffset;
+
+  using LayoutInputA = typename GemmRunner::LayoutInputA;
+  using LayoutOutput = typename GemmRunner::LayoutOutput;
+  using LayoutInputWPack = typename GemmRunner::LayoutInputWPack;
+  using LayoutInputQScale = typename GemmRunner::LayoutInputQScale;
+
+  const cutlass::gemm::GemmCoord problem_size = {m, n, k};
+  const cutlass::MatrixCoord meta_shape = {k / block_size, n};
+
+  cutlass::TensorRef<ElementInputA const, LayoutInputA> ref_a(
+      reinterpret_cast<ElementInputA const*>(a_data), LayoutInputA::packed(problem_size.mk()));
+  // 4 weights are packed in a 16b element
+  cutlass::TensorRef<ElementWPack const, LayoutInputWPack> ref_w(
+      reinterpret_cast<ElementWPack const*>(packed_b), LayoutInputWPack::packed({k / 2, n / 2}));
+  cutlass::TensorRef<ElementQScale const, LayoutInputQScale> ref_scales(
+      reinterpret_cast<ElementQScale const*>(packed_scales), LayoutInputQScale::packed(meta_shape));
+  cutlass::TensorRef<ElementOutput, LayoutOutput> ref_d(
+      reinterpret_cast<ElementOutput*>(output), LayoutOutput::packed(problem_size.mn()));
+
+  // beta is 0, so C is not read
+  cutlass::Status status;
+  if constexpr (has_zero_point) {
+    cutlass::TensorRef<ElementQOffset const, LayoutInputQScale> ref_zero_points(
+        packed_zero_points, LayoutInputQScale::packed(meta_shape));
+    status = GemmRunner::run(stream, problem_size, ref_a, ref_w, ref_scales, ref_zero_points, ref_d, ref_d);
+  } else {
+    ORT_UNUSED_PARAMETER(packed_zero_points);
+    status = GemmRunner::run(stream, problem_size, ref_a, ref_w, ref_scales, ref_d, ref_d);
+  }
+  return status == cutlass::Status::kSuccess;
+}
+
+template <int block_size>
+bool DispatchBlkQ4GemmSm80(
+    half* output,
+    const half* a_data,
+    const uint8_t* packed_b,
+    const half* packed_scales,
+    const uint8_t* packed_zero_points,
+    int m,
+    int n,
+    int k,
+    cudaStream_t stream) {
+  if (m <= 16) {
+    return packed_zero_points != nullptr
+               ? RunBlkQ4GemmSm80<block_size, true, true>(output, a_data, packed_b, packed_scales,
+                                                          packed_zero_points, m, n, k, stream)
+               : RunBlkQ4GemmSm80<block_size, true, false>(output, a_data, packed_b, packed_scales,
+                                                           packed_zero_points, m, n, k, stream);
+  }
+  return packed_zero_points != nullptr
+             ? RunBlkQ4GemmSm80<block_size, false, true>(output, a_data, packed_b, packed_scales,
+                                                         packed_zero_points, m, n, k, stream)
+             : RunBlkQ4GemmSm80<block_size, false, false>(output, a_data, packed_b, packed_scales,
+                                                          packed_zero_points, m, n, k, stream);
+}
+
+}  // namespace
+
+#endif  // defined(CUDA_VERSION) && CUDA_VERSION <= 12030
+
+bool IsBlkQ4GemmSm80Available(int sm, int n, int k, int block_size) {
+#if defined(CUDA_VERSION) && CUDA_VERSION <= 12030
+  return sm >= 80 && (block_size == 16 || block_size == 32 || block_size == 64) &&
+         n % 16 == 0 && k % 16 == 0 && k % block_size == 0;
+#else
+  ORT_UNUSED_PARAMETER(sm);
+  ORT_UNUSED_PARAMETER(n);
+  ORT_UNUSED_PARAMETER(k);
+  ORT_UNUSED_PARAMETER(block_size);
+  return false;
+#endif
+}
+
+bool TryBlkQ4GemmSm80(
+    half* output,
+    const half* a_data,
+    const uint8_t* packed_b,
+    const half* packed_scales,
+    const uint8_t* packed_zero_points,
+    int m,
+    int n,
+    int k,
+    int block_size,
+    cudaStream_t stream) {
+#if defined(CUDA_VERSION) && CUDA_VERSION <= 12030
+  switch (block_size) {
+    case 16:
+      return DispatchBlkQ4GemmSm80<16>(output, a_data, packed_b, packed_scales, packed_zero_points, m, n, k, stream);
+    case 32:
+      return DispatchBlkQ4GemmSm80<32>(output, a_data, packed_b, packed_scales, packed_zero_points, m, n, k, stream);
+    case 64:
+      return DispatchBlkQ4GemmSm80<64>(output, a_data, packed_b, packed_scales, packed_zero_points, m, n, k, stream);
+    default:
+      return false;
+  }
+#else
+  ORT_UNUSED_PARAMETER(output);
+  ORT_UNUSED_PARAMETER(a_data);
+  ORT_UNUSED_PARAMETER(packed_b);
+  ORT_UNUSED_PARAMETER(packed_scales);
+  ORT_UNUSED_PARAMETER(packed_zero_points);
+  ORT_UNUSED_PARAMETER(m);
+  ORT_UNUSED_PARAMETER(n);
+  ORT_UNUSED_PARAMETER(k);
+  ORT_UNUSED_PARAMETER(block_size);
+  ORT_UNUSED_PARAMETER(stream);
+  return false;
+#endif
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -21,11 +21,7 @@
 #include "contrib_ops/cuda/transformers/greedy_search_top_one.h"
 #include "core/providers/cuda/tensor/transpose.h"
 
-// the includes would be dummy for ROCm, we will ignore them for now
-#ifdef ENABLE_NVTX_PROFILE
 #include "core/providers/cuda/nvtx_profile.h"
-#include "core/providers/cuda/nvtx_profile_context.h"
-#endif
 
 #include "sampling_cuda_helper.h"
 
@@ -113,10 +109,7 @@ Status TopK(const Tensor* input, const int axis, const unsigned k, bool largest,
             onnxruntime::concurrency::ThreadPool* /*threadpool*/,
             Tensor& output_values,
             Tensor& output_indices) {
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator topkRange("TopK", profile::Color::Green);
-  topkRange.Begin();
-#endif
+  profile::NvtxScopedRange topkRange("TopK", profile::Color::Green);
 
   ORT_ENFORCE(nullptr != input);
   int32_t rank = static_cast<int32_t>(input->Shape().NumDimensions());
@@ -176,9 +169,6 @@ Status TopK(const Tensor* input, const int axis, const unsigned k, bool largest,
                              input->DataType(), " is not supported yet");
   }
 
-#ifdef ENABLE_NVTX_PROFILE
-  topkRange.End();
-#endif
   return result;
 }
 
@@ -189,10 +179,7 @@ Status AddToFeeds(Stream* ort_stream,
                   AllocatorPtr device_allocator,
                   AllocatorPtr host_allocator,
                   const OrtMemoryInfo& location) {
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator addToFeedsRange("AddToFeeds", profile::Color::Blue);
-  addToFeedsRange.Begin();
-#endif
+  profile::NvtxScopedRange addToFeedsRange("AddToFeeds", profile::Color::Blue);
 
   // Copy tensors to GPU, then add to feeds
   size_t total_bytes = 0;
@@ -258,10 +245,6 @@ Status AddToFeeds(Stream* ort_stream,
     }
   }
 
-#ifdef ENABLE_NVTX_PROFILE
-  addToFeedsRange.End();
-#endif
-
   return Status::OK();
 }
 
@@ -271,10 +254,7 @@ void InitBeamState(transformers::IBeamSearchState<T>* beam_state,
                    int batch_size,
                    int num_beams,
                    Stream* ort_stream) {
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator initStateRange("InitBeamState", profile::Color::Red);
-  initStateRange.Begin();
-#endif
+  profile::NvtxScopedRange initStateRange("InitBeamState", profile::Color::Red);
 
   // TODO(tianleiwu): we can use another stream to avoid blocking subgraph execution.
   cudaStream_t cuda_stream = ort_stream ? static_cast<cudaStream_t>(ort_stream->GetHandle()) : nullptr;
@@ -295,19 +275,13 @@ void InitBeamState(transformers::IBeamSearchState<T>* beam_state,
                                     cudaMemcpyHostToDevice, cuda_stream));
   }
 
-#ifdef ENABLE_NVTX_PROFILE
-  initStateRange.End();
-#endif
 }
 
 template <typename T>
 void InitGreedyState(transformers::IGreedySearchState<T>* greedy_state,
                      gsl::span<int32_t>& sequence_lengths,
                      Stream* ort_stream) {
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator initStateRange("InitGreedyState", profile::Color::Red);
-  initStateRange.Begin();
-#endif
+  profile::NvtxScopedRange initStateRange("InitGreedyState", profile::Color::Red);
 
   cudaStream_t cuda_stream = ort_stream ? reinterpret_cast<cudaStream_t>(ort_stream->GetHandle()) : nullptr;
   CUDA_CALL_THROW(cudaMemsetAsync(greedy_state->next_token_scores.data(), 0, greedy_state->next_token_scores.size_bytes(), cuda_stream));
@@ -316,9 +290,6 @@ void InitGreedyState(transformers::IGreedySearchState<T>* greedy_state,
   CUDA_CALL_THROW(cudaMemcpyAsync(greedy_state->next_positions.data(), sequence_lengths.data(), sequence_lengths.size_bytes(),
                                   cudaMemcpyHostToDevice, cuda_stream));
 
-#ifdef ENABLE_NVTX_PROFILE
-  initStateRange.End();
-#endif
 }
 
 template <typename T>
@@ -334,10 +305,7 @@ Status ProcessLogits(const OrtValue& logits,                                 //
                      Stream* ort_stream,                                     // cuda stream (for CUDA only)
                      const IConsoleDumper* dumper) {                         // tensor dumper
 
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator processLogitsRange("ProcessLogits", profile::Color::Red);
-  processLogitsRange.Begin();
-#endif
+  profile::NvtxScopedRange processLogitsRange("ProcessLogits", profile::Color::Red);
 
   ORT_UNUSED_PARAMETER(logits_processors);
   ORT_UNUSED_PARAMETER(thread_pool);
@@ -606,10 +574,6 @@ Status ProcessLogits(const OrtValue& logits,                                 //
       next_tokens,
       next_indices);
 
-#ifdef ENABLE_NVTX_PROFILE
-  processLogitsRange.End();
-#endif
-
   return Status::OK();
 }
 
@@ -826,10 +790,7 @@ Status GreedySearchProcessLogits(
     Stream* stream,                                         // cuda stream (for CUDA only)
     const IConsoleDumper* dumper) {                         // tensor dumper
 
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator processLogitsRange("ProcessLogits", profile::Color::Red);
-  processLogitsRange.Begin();
-#endif
+  profile::NvtxScopedRange processLogitsRange("ProcessLogits", profile::Color::Red);
 
   ORT_UNUSED_PARAMETER(logits_processors);
   ORT_UNUSED_PARAMETER(thread_pool);
@@ -996,10 +957,6 @@ Status GreedySearchProcessLogits(
   dumper->Print("greedy_state->next_tokens", greedy_state->next_tokens.data(), batch_size, 1);
 #endif
 
-#ifdef ENABLE_NVTX_PROFILE
-  processLogitsRange.End();
-#endif
-
   return Status::OK();
 }
 
@@ -1124,10 +1081,7 @@ Status UpdateGptFeeds(
     int past_sequence_len,
     int input_sequence_len,
     bool need_cache_indir) {
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxNestedRangeCreator updateFeedsRange("UpdateGptFeeds", profile::Color::Yellow);
-  updateFeedsRange.Begin();
-#endif
+  profile::NvtxScopedRange updateFeedsRange("UpdateGptFeeds", profile::Color::Yellow);
 
   // Update input_ids with next tokens.
   int batch_beam_size = static_cast<int>(beam_next_tokens.size());
@@ -1215,10 +1169,6 @@ Status UpdateGptFeeds(
     }
   }
 
-#ifdef ENABLE_NVTX_PROFILE
-  updateFeedsRange.End();
-#endif
-
   return Status::OK();
 }
 
@@ -1338,9 +1288,7 @@ Status UpdateDecoderFeeds(
                               t5_decoder_first_past_input_idx, t5_decoder_first_present_output_idx, ort_stream);
   }
 
-  // Make sure data is ready before next subgraph execution.
-  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(cuda_stream));
-
+  // The next subgraph execution runs on the same stream, so there is no need to wait for the copies and kernels above.
   return Status::OK();
 }
 
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "core/common/code_location.h"
+#include "core/common/common.h"
+#include "core/common/logging/capture.h"
+#include "core/common/make_string.h"
+
+namespace onnxruntime {
+namespace logging {
+
+namespace {
+size_t RoundUpToPowerOf2(size_t n) {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+}  // namespace
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, size_t queue_capacity)
+    : sink_{std::move(sink)},
+      mask_{RoundUpToPowerOf2(std::max<size_t>(queue_capacity, 2)) - 1},
+      slots_{std::make_unique<Slot[]>(mask_ + 1)} {
+  for (size_t i = 0; i <= mask_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  writer_ = std::thread(&AsyncSink::WriterLoop, this);
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  writer_cv_.notify_one();
+  writer_.join();
+}
+
+// A bounded multi-producer queue (D. Vyukov). The sequence of a slot tells whose turn it is: it is the position of
+// the next message to push into the slot, or that position + 1 once the message is there to pop.
+bool AsyncSink::TryPush(Message& message) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[pos & mask_];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        slot.message = std::move(message);
+        // sequentially consistent, like the load of writer_waiting_ after it in WakeWriter(), so either the writer
+        // sees the message before it waits, or this thread sees that the writer waits
+        slot.sequence.store(pos + 1, std::memory_order_seq_cst);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;  // the queue is full
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// Only the writer pops, so the dequeue position needs no read-modify-write.
+bool AsyncSink::TryPop(Message& message) {
+  const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[pos & mask_];
+  if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+    return false;
+  }
+  message = std::move(slot.message);
+  dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+  slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+bool AsyncSink::HasMessage() const {
+  const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  return slots_[pos & mask_].sequence.load(std::memory_order_seq_cst) == pos + 1;
+}
+
+void AsyncSink::WakeWriter() {
+  if (writer_waiting_.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer_cv_.notify_one();
+  }
+}
+
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  const CodeLocation& location = message.Location();
+  Message queued{timestamp,
+                 logger_id,
+                 message.Severity(),
+                 message.Category() != nullptr ? message.Category() : "",
+                 message.DataType(),
+                 location.file_and_path,
+                 location.line_num,
+                 location.function,
+                 location.stacktrace,
+                 message.Message()};
+
+  if (message.Severity() == Severity::kFATAL) {
+    while (!TryPush(queued)) {
+      WakeWriter();
+      std::this_thread::yield();
+    }
+    WakeWriter();
+    Flush();
+    return;
+  }
+
+  if (TryPush(queued)) {
+    WakeWriter();
+  } else {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AsyncSink::Flush() {
+  const size_t target = enqueue_pos_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mutex_);
+  writer_cv_.notify_one();
+  flushed_cv_.wait(lock, [&]() { return written_ >= target; });
+}
+
+void AsyncSink::Write(const Message& message) {
+  const CodeLocation location{message.file.c_str(), message.line, message.function.c_str(), message.stacktrace};
+  Capture capture{message.severity, message.category.c_str(), message.data_type, location};
+  capture.Stream() << message.text;
+  ORT_TRY {
+    sink_->Send(message.timestamp, message.logger_id, capture);
+  }
+  ORT_CATCH(const std::exception&) {
+    // there is no caller to report the failure to, so the message is lost
+  }
+}
+
+void AsyncSink::WriterLoop() {
+  Message message;
+  for (;;) {
+    // a batch is at most a queue full, so Flush() doesn't wait on messages queued after it
+    size_t count = 0;
+    while (count <= mask_ && TryPop(message)) {
+      Write(message);
+      ++count;
+    }
+
+    const size_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+      const CodeLocation where = ORT_WHERE;
+      Message report{std::chrono::system_clock::now(),
+                     "AsyncSink",
+                     Severity::kWARNING,
+                     Category::onnxruntime,
+                     DataType::SYSTEM,
+                     where.file_and_path,
+                     where.line_num,
+                     where.function,
+                     {},
+                     MakeString(dropped - reported_dropped_,
+                                " log message(s) were dropped because the log queue was full.")};
+      Write(report);
+      reported_dropped_ = dropped;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_ += count;
+    flushed_cv_.notify_all();
+    if (count > mask_) {
+      continue;
+    }
+    if (stop_ && !HasMessage()) {
+      break;
+    }
+    writer_waiting_.store(true, std::memory_order_seq_cst);
+    writer_cv_.wait(lock, [this]() { return stop_ || HasMessage(); });
+    writer_waiting_.store(false, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
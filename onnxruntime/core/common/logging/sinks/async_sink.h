@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/logging/isink.h"
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// ISink that sends the messages to another sink on a background thread, so the threads that log don't wait for
+/// the other sink to write them.
+/// </summary>
+/// <remarks>
+/// The messages are queued in a bounded lock-free queue. When the queue is full, a message is dropped rather than
+/// making the thread that logs it wait, and the number of dropped messages is logged once there is room again.
+/// Fatal messages are the exception: they wait for room, and are sent before Send() returns, as the process may not
+/// outlive them.
+/// </remarks>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  static constexpr size_t kDefaultQueueCapacity = 4096;
+
+  /// <summary>
+  /// Initializes a new instance of the <see cref="AsyncSink"/> class.
+  /// </summary>
+  /// <param name="sink">The sink to send the messages to. It is only called from the background thread.</param>
+  /// <param name="queue_capacity">The number of messages that can be queued. Rounded up to a power of 2.</param>
+  explicit AsyncSink(std::unique_ptr<ISink> sink, size_t queue_capacity = kDefaultQueueCapacity);
+
+  /// <summary>
+  /// Sends the queued messages and stops the background thread.
+  /// </summary>
+  ~AsyncSink() override;
+
+  /// <summary>
+  /// Waits until the messages that were queued before the call have been sent.
+  /// </summary>
+  void Flush();
+
+  /// <summary>
+  /// The number of messages dropped so far because the queue was full.
+  /// </summary>
+  size_t DroppedMessageCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+  void SendProfileEvent(profiling::EventRecord& event_record) const override {
+    sink_->SendProfileEvent(event_record);
+  }
+
+ private:
+  struct Message {
+    Timestamp timestamp;
+    std::string logger_id;
+    Severity severity;
+    std::string category;
+    DataType data_type;
+    // the parts of the CodeLocation, which can't be assigned
+    std::string file;
+    int line;
+    std::string function;
+    std::vector<std::string> stacktrace;
+    std::string text;
+  };
+
+  struct Slot {
+    std::atomic<size_t> sequence;
+    Message message;
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  bool TryPush(Message& message);
+  bool TryPop(Message& message);
+  bool HasMessage() const;
+  void WakeWriter();
+  void Write(const Message& message);
+  void WriterLoop();
+
+  std::unique_ptr<ISink> sink_;
+
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // the positions the producers and the writer are at, on separate cache lines
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+  std::atomic<size_t> dropped_{0};
+  size_t reported_dropped_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable writer_cv_;
+  std::condition_variable flushed_cv_;
+  std::atomic<bool> writer_waiting_{false};
+  bool stop_ = false;
+  // the number of messages the writer has sent, guarded by mutex_
+  size_t written_ = 0;
+
+  std::thread writer_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -3,11 +3,98 @@
 
 #include "profiler.h"
 
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
 
 std::atomic<size_t> Profiler::global_max_num_events_{1000 * 1000};
+thread_local const Profiler::RecordedRun* Profiler::current_run_ = nullptr;
+
+namespace {
+
+// Write the events as a json array in chrome tracing format.
+void WriteEvents(std::ostream& stream, const Events& events) {
+  stream << "[\n";
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    auto& rec = events[i];
+    stream << R"({"cat" : ")" << event_category_names_[rec.cat] << "\",";
+    stream << "\"pid\" :" << rec.pid << ",";
+    stream << "\"tid\" :" << rec.tid << ",";
+    stream << "\"dur\" :" << rec.dur << ",";
+    stream << "\"ts\" :" << rec.ts << ",";
+    // memory events are counters, their args are the (numeric) values of the series
+    const bool is_counter = rec.cat == MEMORY_EVENT;
+    stream << (is_counter ? R"("ph" : "C",)" : R"("ph" : "X",)");
+    stream << R"("name" :")" << rec.name << "\",";
+    stream << "\"args\" : {";
+    bool is_first_arg = true;
+    for (std::pair<std::string, std::string> event_arg : rec.args) {
+      if (!is_first_arg) stream << ",";
+      if (is_counter ||
+          (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '['))) {
+        stream << "\"" << event_arg.first << "\" : " << event_arg.second << "";
+      } else {
+        stream << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
+      }
+      is_first_arg = false;
+    }
+    stream << "}";
+    if (i == events.size() - 1) {
+      stream << "}\n";
+    } else {
+      stream << "},\n";
+    }
+  }
+  stream << "]\n";
+}
+
+}  // namespace
+
+EventRingBuffer::EventRingBuffer(size_t capacity)
+    : capacity_(capacity), slots_(std::make_unique<Slot[]>(capacity)) {
+  ORT_ENFORCE(capacity_ > 0, "The ring buffer must hold at least one event.");
+}
+
+void EventRingBuffer::Push(uint64_t run_id, EventRecord&& event) {
+  const uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[sequence % capacity_];
+  while (slot.busy.exchange(true, std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  slot.sequence = sequence;
+  slot.run_id = run_id;
+  slot.event = std::move(event);
+  slot.busy.store(false, std::memory_order_release);
+}
+
+Events EventRingBuffer::Collect(uint64_t run_id) {
+  std::vector<std::pair<uint64_t, EventRecord>> run_events;
+  for (size_t i = 0; i < capacity_; ++i) {
+    Slot& slot = slots_[i];
+    while (slot.busy.exchange(true, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    if (slot.run_id == run_id && !slot.event.name.empty()) {
+      run_events.emplace_back(slot.sequence, slot.event);
+    }
+    slot.busy.store(false, std::memory_order_release);
+  }
+
+  std::sort(run_events.begin(), run_events.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  Events events;
+  events.reserve(run_events.size());
+  for (auto& run_event : run_events) {
+    events.push_back(std::move(run_event.second));
+  }
+  return events;
+}
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
 Profiler* Profiler::instance_ = nullptr;
@@ -20,7 +107,7 @@ profiling::Profiler::~Profiler() {}
 #endif
 
 ::onnxruntime::TimePoint profiling::Profiler::Start() {
-  ORT_ENFORCE(enabled_);
+  ORT_ENFORCE(IsEnabled());
   auto start_time = std::chrono::high_resolution_clock::now();
   auto ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
   for (const auto& ep_profiler : ep_profilers_) {
@@ -44,6 +131,7 @@ void Profiler::Initialize(const logging::Logger* session_logger) {
 
 void Profiler::StartProfiling(const logging::Logger* custom_logger) {
   ORT_ENFORCE(custom_logger != nullptr);
+  ORT_ENFORCE(!sampling_, "Profiling can't be started while the profiler is sampling runs.");
   enabled_ = true;
   profile_with_logger_ = true;
   custom_logger_ = custom_logger;
@@ -55,6 +143,7 @@ void Profiler::StartProfiling(const logging::Logger* custom_logger) {
 
 template <typename T>
 void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
+  ORT_ENFORCE(!sampling_, "Profiling can't be started while the profiler is sampling runs.");
   enabled_ = true;
 #if !defined(__wasm__)
   profile_stream_.open(file_name, std::ios::out | std::ios::trunc);
@@ -81,10 +170,54 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
 
   EventRecord event(category, logging::GetProcessId(),
                     logging::GetThreadId(), event_name, ts, dur, {event_args.begin(), event_args.end()});
+  // TODO: sync_gpu if needed.
+  RecordEvent(std::move(event));
+
+  for (const auto& ep_profiler : ep_profilers_) {
+    ep_profiler->Stop(ts);
+  }
+}
+
+void Profiler::EndTimeAndRecordEvent(EventCategory category,
+                                     const std::string& event_name,
+                                     const TimePoint& start_time,
+                                     std::unordered_map<std::string, std::string>&& event_args) {
+  long long dur = TimeDiffMicroSeconds(start_time);
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+
+  RecordEvent(EventRecord(category, logging::GetProcessId(), logging::GetThreadId(), event_name, ts, dur,
+                          std::move(event_args)));
+
+  for (const auto& ep_profiler : ep_profilers_) {
+    ep_profiler->Stop(ts);
+  }
+}
+
+void Profiler::RecordCounterEvent(const std::string& event_name,
+                                  const std::vector<std::pair<std::string, int64_t>>& values) {
+  long long ts = TimeDiffMicroSeconds(profiling_start_time_);
+
+  std::unordered_map<std::string, std::string> args;
+  for (const auto& value : values) {
+    args.emplace(value.first, std::to_string(value.second));
+  }
+
+  RecordEvent(EventRecord(MEMORY_EVENT, logging::GetProcessId(), logging::GetThreadId(), event_name, ts, 0,
+                          std::move(args)));
+}
+
+void Profiler::RecordEvent(EventRecord&& event) {
+  if (!enabled_) {
+    // an event of a run recorded in the sampled mode
+    if (current_run_ != nullptr && current_run_->profiler == this) {
+      ring_buffer_->Push(current_run_->id, std::move(event));
+    }
+    return;
+  }
+
   if (profile_with_logger_) {
     custom_logger_->SendProfileEvent(event);
   } else {
-    // TODO: sync_gpu if needed.
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
       events_.emplace_back(std::move(event));
@@ -96,10 +229,6 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
       }
     }
   }
-
-  for (const auto& ep_profiler : ep_profilers_) {
-    ep_profiler->Stop(ts);
-  }
 }
 
 std::string Profiler::EndProfiling() {
@@ -116,40 +245,11 @@ std::string Profiler::EndProfiling() {
   }
 
   std::lock_guard<OrtMutex> lock(mutex_);
-  profile_stream_ << "[\n";
-
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->EndProfiling(profiling_start_time_, events_);
   }
 
-  for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
-    profile_stream_ << R"({"cat" : ")" << event_category_names_[rec.cat] << "\",";
-    profile_stream_ << "\"pid\" :" << rec.pid << ",";
-    profile_stream_ << "\"tid\" :" << rec.tid << ",";
-    profile_stream_ << "\"dur\" :" << rec.dur << ",";
-    profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
-    profile_stream_ << R"("name" :")" << rec.name << "\",";
-    profile_stream_ << "\"args\" : {";
-    bool is_first_arg = true;
-    for (std::pair<std::string, std::string> event_arg : rec.args) {
-      if (!is_first_arg) profile_stream_ << ",";
-      if (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '[')) {
-        profile_stream_ << "\"" << event_arg.first << "\" : " << event_arg.second << "";
-      } else {
-        profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
-      }
-      is_first_arg = false;
-    }
-    profile_stream_ << "}";
-    if (i == events_.size() - 1) {
-      profile_stream_ << "}\n";
-    } else {
-      profile_stream_ << "},\n";
-    }
-  }
-  profile_stream_ << "]\n";
+  WriteEvents(profile_stream_, events_);
 #if !defined(__wasm__)
   profile_stream_.close();
 #endif
@@ -157,5 +257,100 @@ std::string Profiler::EndProfiling() {
   return profile_stream_file_;
 }
 
+void Profiler::StartSampling(const SamplingOptions& options) {
+  ORT_ENFORCE(!enabled_, "Runs can't be sampled while the profiler is enabled.");
+  ORT_ENFORCE(options.every_n_runs > 0 || options.latency_threshold_us > 0,
+              "Either the number of runs or the latency threshold to sample runs by must be set.");
+  sampling_options_ = options;
+  ring_buffer_ = std::make_unique<EventRingBuffer>(options.ring_buffer_size);
+  sampling_ = true;
+  profiling_start_time_ = std::chrono::high_resolution_clock::now();
+  for (const auto& ep_profiler : ep_profilers_) {
+    ep_profiler->StartProfiling(profiling_start_time_);
+  }
+}
+
+void Profiler::SetSampleCallback(SampleCallback callback) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  sample_callback_ = std::move(callback);
+}
+
+void Profiler::EndRecordedRun(uint64_t run_id, const TimePoint& start_time, long long duration_us, bool hand_over) {
+  // the captures of the EPs can't be told apart by run, they are collected after every recorded run so they don't
+  // accumulate, and filtered by the time of the run.
+  Events events;
+  if (hand_over) {
+    events = ring_buffer_->Collect(run_id);
+  }
+  for (const auto& ep_profiler : ep_profilers_) {
+    ep_profiler->CollectEvents(profiling_start_time_, events);
+  }
+  if (!hand_over) {
+    return;
+  }
+
+  const long long run_begin = TimeDiffMicroSeconds(profiling_start_time_, start_time);
+  const long long run_end = run_begin + duration_us;
+  events.erase(std::remove_if(events.begin(), events.end(),
+                              [&](const EventRecord& event) { return event.ts < run_begin || event.ts > run_end; }),
+               events.end());
+
+  SampleCallback callback;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    callback = sample_callback_;
+  }
+  if (!callback) {
+    if (session_logger_) {
+      LOGS(*session_logger_, VERBOSE) << "No callback to hand the profile of a sampled run to.";
+    }
+    return;
+  }
+
+  std::ostringstream trace_json;
+  WriteEvents(trace_json, events);
+  callback(trace_json.str(), static_cast<int64_t>(duration_us));
+}
+
+Profiler::RunScope::RunScope(Profiler& profiler) {
+  if (!profiler.sampling_ || (current_run_ != nullptr && current_run_->profiler == &profiler)) {
+    return;
+  }
+
+  const auto& options = profiler.sampling_options_;
+  const uint64_t run_id = profiler.num_runs_.fetch_add(1, std::memory_order_relaxed);
+  sampled_ = options.every_n_runs > 0 && run_id % options.every_n_runs == 0;
+  if (!sampled_ && options.latency_threshold_us == 0) {
+    return;
+  }
+
+  profiler_ = &profiler;
+  run_ = {&profiler, run_id};
+  previous_ = current_run_;
+  current_run_ = &run_;
+  start_time_ = std::chrono::high_resolution_clock::now();
+}
+
+Profiler::RunScope::~RunScope() {
+  if (profiler_ == nullptr) {
+    return;
+  }
+
+  current_run_ = previous_;
+  const long long duration_us = TimeDiffMicroSeconds(start_time_);
+  const auto threshold_us = profiler_->sampling_options_.latency_threshold_us;
+  const bool hand_over = sampled_ || (threshold_us > 0 && duration_us >= threshold_us);
+  ORT_TRY {
+    profiler_->EndRecordedRun(run_.id, start_time_, duration_us, hand_over);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      if (profiler_->session_logger_) {
+        LOGS(*profiler_->session_logger_, ERROR) << "Failed to hand over the profile of a sampled run: " << ex.what();
+      }
+    });
+  }
+}
+
 }  // namespace profiling
 }  // namespace onnxruntime
@@ -5,12 +5,16 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <tuple>
+#include <vector>
 
 #include "core/common/profiler_common.h"
 #include "core/common/logging/logging.h"
+#include "core/platform/hardware_counters.h"
 #include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
@@ -21,6 +25,35 @@ namespace profiling {
 // note that static profiler instance only works with single session
 // #define ENABLE_STATIC_PROFILER_INSTANCE
 
+/**
+ * A ring buffer of a fixed number of events, used by the sampled mode of the profiler.
+ * Writers claim slots with an atomic counter, so they only wait for each other when the buffer wraps around onto
+ * a slot that is still being written or collected. The oldest events are overwritten.
+ */
+class EventRingBuffer {
+ public:
+  explicit EventRingBuffer(size_t capacity);
+
+  void Push(uint64_t run_id, EventRecord&& event);
+
+  // Copy the events of the given run that are still in the buffer, in the order they were pushed.
+  Events Collect(uint64_t run_id);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(EventRingBuffer);
+
+  struct Slot {
+    std::atomic<bool> busy{false};
+    uint64_t sequence = 0;
+    uint64_t run_id = 0;
+    EventRecord event;
+  };
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_sequence_{0};
+};
+
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
@@ -58,7 +91,7 @@ class Profiler {
   Whether data collection and output from this profiler is enabled.
   */
   bool IsEnabled() const {
-    return enabled_;
+    return enabled_ || (current_run_ != nullptr && current_run_->profiler == this);
   }
   /*
   Return the stored start time of profiler.
@@ -80,6 +113,21 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Record a single event with args that are only known at runtime.
+  */
+  void EndTimeAndRecordEvent(EventCategory category,
+                             const std::string& event_name,
+                             const TimePoint& start_time,
+                             std::unordered_map<std::string, std::string>&& event_args);
+
+  /*
+  Record a counter event of the MEMORY_EVENT category at the current time. The values must be integers,
+  they are written as the series of a "counter event (C)".
+  */
+  void RecordCounterEvent(const std::string& event_name,
+                          const std::vector<std::pair<std::string, int64_t>>& values);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -110,10 +158,109 @@ class Profiler {
     global_max_num_events_.store(new_max_num_events);
   }
 
+  /*
+  Options of the sampled mode.
+  */
+  struct SamplingOptions {
+    // Profile one run out of every_n_runs. 0 to not sample by count.
+    size_t every_n_runs = 0;
+    // Hand over the runs that take at least this long. 0 to not sample by latency.
+    // As a run is only known to be slow when it ends, all runs are recorded then.
+    int64_t latency_threshold_us = 0;
+    // The number of events kept, the oldest events are overwritten.
+    size_t ring_buffer_size = 100 * 1000;
+  };
+
+  /*
+  Called with the events of a sampled run in chrome tracing format and the duration of the run in microseconds,
+  on the thread that ran it before the run returns.
+  */
+  using SampleCallback = std::function<void(const std::string& trace_json, int64_t run_duration_us)>;
+
+  /*
+  Start the sampled mode: instead of all runs, only the runs chosen by the options are profiled. Their events are
+  kept in a ring buffer of a fixed size, and handed to the callback at the end of the run instead of being written
+  to a file. The runs are the lifetimes of RunScope instances. Can't be combined with StartProfiling.
+  */
+  void StartSampling(const SamplingOptions& options);
+
+  void SetSampleCallback(SampleCallback callback);
+
+  bool IsSampling() const {
+    return sampling_;
+  }
+
+  /*
+  A run recorded in the sampled mode. The profiler is enabled on the threads the run is current on.
+  */
+  struct RecordedRun {
+    const Profiler* profiler;
+    uint64_t id;
+  };
+
+  /*
+  The run recorded on the calling thread, or nullptr.
+  */
+  static const RecordedRun* CurrentRun() {
+    return current_run_;
+  }
+
+  /*
+  Makes a run the current run of the calling thread for the lifetime of the object, so that the work of a run that
+  is dispatched to other threads, e.g. the inter-op thread pool, is recorded too.
+  */
+  class ThreadRunScope {
+   public:
+    explicit ThreadRunScope(const RecordedRun* run) : previous_(current_run_) {
+      current_run_ = run;
+    }
+    ~ThreadRunScope() {
+      current_run_ = previous_;
+    }
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadRunScope);
+
+   private:
+    const RecordedRun* previous_;
+  };
+
+  /*
+  A run in the sampled mode. Decides whether the run is recorded, makes it the current run of the calling thread,
+  and at the end hands the events over to the sample callback if the run was sampled or was slow.
+  Does nothing if the profiler is not sampling or a run is already recorded on the calling thread.
+  */
+  class RunScope {
+   public:
+    explicit RunScope(Profiler& profiler);
+    ~RunScope();
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScope);
+
+   private:
+    // nullptr if the run isn't recorded
+    Profiler* profiler_{nullptr};
+    RecordedRun run_{};
+    bool sampled_{false};
+    TimePoint start_time_;
+    const RecordedRun* previous_{nullptr};
+  };
+
+  /*
+  Set the hardware counters read around every node, their difference is added to the args of the node events.
+  */
+  void SetHardwareCounters(std::unique_ptr<HardwareCounters> hardware_counters) {
+    hardware_counters_ = std::move(hardware_counters);
+  }
+
+  /*
+  The hardware counters, or nullptr if they are not recorded.
+  */
+  const HardwareCounters* GetHardwareCounters() const {
+    return hardware_counters_.get();
+  }
+
   void AddEpProfilers(std::unique_ptr<EpProfiler> ep_profiler) {
     if (ep_profiler) {
       ep_profilers_.push_back(std::move(ep_profiler));
-      if (enabled_) {
+      if (enabled_ || sampling_) {
         ep_profilers_.back()->StartProfiling(profiling_start_time_);
       }
     }
@@ -122,6 +269,10 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  void RecordEvent(EventRecord&& event);
+
+  void EndRecordedRun(uint64_t run_id, const TimePoint& start_time, long long duration_us, bool hand_over);
+
   /**
    * The maximum number of profiler records to collect.
    * This value is used to initialize the per-profiler maximum.
@@ -156,6 +307,17 @@ class Profiler {
 #endif
 
   std::vector<std::unique_ptr<EpProfiler>> ep_profilers_;
+  std::unique_ptr<HardwareCounters> hardware_counters_;
+
+  // sampled mode
+  bool sampling_{false};
+  SamplingOptions sampling_options_;
+  std::unique_ptr<EventRingBuffer> ring_buffer_;
+  std::atomic<uint64_t> num_runs_{0};
+  // guarded by mutex_
+  SampleCallback sample_callback_;
+
+  static thread_local const RecordedRun* current_run_;
 };
 
 }  // namespace profiling
@@ -13,6 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <optional>
 
@@ -84,10 +88,49 @@ std::string ThreadPoolProfiler::Stop() {
      << GetMainThreadStat().Reset()
      << "}, \"sub_threads\": {"
      << DumpChildThreadStat()
+     << "}, \"schedule\": {"
+     << DumpScheduleStat()
      << "}}";
   return ss.str();
 }
 
+std::string ThreadPoolProfiler::GetStats() const {
+  if (!enabled_) {
+    return {};
+  }
+  const uint64_t num_loops = num_loops_;
+  std::ostringstream ss;
+  ss << "{\"thread_pool_name\": \"" << thread_pool_name_ << "\", "
+     << "\"num_loops\": " << num_loops << ", "
+     << "\"fork_join_us\": " << fork_join_us_ << ", "
+     << "\"mean_imbalance\": "
+     << (num_loops == 0 ? 0.0 : static_cast<double>(imbalance_sum_) / 1000.0 / static_cast<double>(num_loops)) << ", "
+     << "\"max_imbalance\": " << static_cast<double>(imbalance_max_) / 1000.0 << ", "
+     << "\"schedule\": {" << DumpScheduleStat() << "}, "
+     << "\"sub_threads\": {" << DumpChildThreadStat() << "}}";
+  return ss.str();
+}
+
+std::string ThreadPoolProfiler::DumpScheduleStat() const {
+  const uint64_t num_schedules = num_schedules_;
+  std::ostringstream ss;
+  ss << "\"num_tasks\": " << num_schedules << ", "
+     << "\"mean_queue_size\": "
+     << (num_schedules == 0 ? 0.0 : static_cast<double>(schedule_queue_size_sum_) / static_cast<double>(num_schedules))
+     << ", \"max_queue_size\": " << schedule_queue_size_max_;
+  return ss.str();
+}
+
+namespace {
+
+void UpdateMax(std::atomic<uint64_t>& max, uint64_t value) {
+  uint64_t current = max.load(std::memory_order_relaxed);
+  while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
 void ThreadPoolProfiler::LogStartAndCoreAndBlock(std::ptrdiff_t block_size) {
   if (enabled_) {
     MainThreadStat& stat = GetMainThreadStat();
@@ -113,13 +156,72 @@ void ThreadPoolProfiler::LogStart() {
 
 void ThreadPoolProfiler::LogEnd(ThreadPoolEvent evt) {
   if (enabled_) {
-    GetMainThreadStat().LogEnd(evt);
+    const uint64_t elapsed = GetMainThreadStat().LogEnd(evt);
+    // distributing the work of a loop and waiting for the threads to finish it is the fork/join overhead
+    if (evt == DISTRIBUTION || evt == WAIT) {
+      fork_join_us_ += elapsed;
+    }
   }
 }
 
 void ThreadPoolProfiler::LogEndAndStart(ThreadPoolEvent evt) {
   if (enabled_) {
-    GetMainThreadStat().LogEndAndStart(evt);
+    const uint64_t elapsed = GetMainThreadStat().LogEndAndStart(evt);
+    if (evt == DISTRIBUTION || evt == WAIT) {
+      fork_join_us_ += elapsed;
+    }
+  }
+}
+
+void ThreadPoolProfiler::LogLoopStart(std::function<void(unsigned)>& fn, unsigned n) {
+  if (enabled_) {
+    MainThreadStat& stat = GetMainThreadStat();
+    stat.loop_item_ns_.assign(n, -1);
+    // each work item is run by a single thread, and the loop is joined before LogLoopEnd reads the times
+    int64_t* item_ns = stat.loop_item_ns_.data();
+    fn = [fn = std::move(fn), item_ns](unsigned idx) {
+      const auto start = Clock::now();
+      fn(idx);
+      item_ns[idx] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    };
+  }
+}
+
+void ThreadPoolProfiler::LogLoopEnd() {
+  if (!enabled_) {
+    return;
+  }
+  MainThreadStat& stat = GetMainThreadStat();
+  if (stat.loop_item_ns_.empty()) {
+    return;
+  }
+  // work items revoked from the queues never ran, the threads that ran the others did their iterations
+  int64_t max_ns = 0;
+  int64_t sum_ns = 0;
+  int64_t num_items = 0;
+  for (const int64_t ns : stat.loop_item_ns_) {
+    if (ns >= 0) {
+      max_ns = std::max(max_ns, ns);
+      sum_ns += ns;
+      ++num_items;
+    }
+  }
+  stat.loop_item_ns_.clear();
+  const double imbalance = sum_ns == 0 ? 1.0
+                                       : static_cast<double>(max_ns) * static_cast<double>(num_items) /
+                                             static_cast<double>(sum_ns);
+  stat.imbalances_.push_back(imbalance);
+  const auto imbalance_thousandths = static_cast<uint64_t>(imbalance * 1000.0);
+  ++num_loops_;
+  imbalance_sum_ += imbalance_thousandths;
+  UpdateMax(imbalance_max_, imbalance_thousandths);
+}
+
+void ThreadPoolProfiler::LogSchedule(size_t queue_size) {
+  if (enabled_) {
+    ++num_schedules_;
+    schedule_queue_size_sum_ += queue_size;
+    UpdateMax(schedule_queue_size_max_, queue_size);
   }
 }
 
@@ -151,16 +253,20 @@ void ThreadPoolProfiler::MainThreadStat::LogStart() {
   points_.emplace_back(Clock::now());
 }
 
-void ThreadPoolProfiler::MainThreadStat::LogEnd(ThreadPoolEvent evt) {
+uint64_t ThreadPoolProfiler::MainThreadStat::LogEnd(ThreadPoolEvent evt) {
   ORT_ENFORCE(!points_.empty(), "LogStart must pair with LogEnd");
-  events_[evt] += TimeDiffMicroSeconds(points_.back(), Clock::now());
+  const uint64_t elapsed = TimeDiffMicroSeconds(points_.back(), Clock::now());
+  events_[evt] += elapsed;
   points_.pop_back();
+  return elapsed;
 }
 
-void ThreadPoolProfiler::MainThreadStat::LogEndAndStart(ThreadPoolEvent evt) {
+uint64_t ThreadPoolProfiler::MainThreadStat::LogEndAndStart(ThreadPoolEvent evt) {
   ORT_ENFORCE(!points_.empty(), "LogStart must pair with LogEnd");
-  events_[evt] += TimeDiffMicroSeconds(points_.back(), Clock::now());
+  const uint64_t elapsed = TimeDiffMicroSeconds(points_.back(), Clock::now());
+  events_[evt] += elapsed;
   points_.back() = Clock::now();
+  return elapsed;
 }
 
 std::string ThreadPoolProfiler::MainThreadStat::Reset() {
@@ -172,6 +278,12 @@ std::string ThreadPoolProfiler::MainThreadStat::Reset() {
     ss << blocks_.back();
     blocks_.clear();
   }
+  ss << "], \"imbalance\": [";
+  if (!imbalances_.empty()) {
+    std::copy(imbalances_.begin(), imbalances_.end() - 1, std::ostream_iterator<double>(ss, ", "));
+    ss << imbalances_.back();
+    imbalances_.clear();
+  }
   ss << "], \"core\": " << core_ << ", ";
   for (int i = 0; i < MAX_EVENT; ++i) {
     ss << "\"" << ThreadPoolProfiler::GetEventName(static_cast<ThreadPoolEvent>(i))
@@ -198,14 +310,48 @@ const char* ThreadPoolProfiler::GetEventName(ThreadPoolEvent event) {
   }
 }
 
+const char* ThreadPoolProfiler::GetChildEventName(ChildThreadEvent event) {
+  switch (event) {
+    case SPIN:
+      return "spin_us";
+    case BLOCKED:
+      return "blocked_us";
+    case WORK:
+      return "work_us";
+    default:
+      return "unknown_us";
+  }
+}
+
 void ThreadPoolProfiler::LogThreadId(int thread_idx) {
   child_thread_stats_[thread_idx].thread_id_ = std::this_thread::get_id();
 }
 
+void ThreadPoolProfiler::ChildThreadStat::LogEvent(ChildThreadEvent evt, onnxruntime::TimePoint now) {
+  if (event_started_) {
+    events_ns_[evt] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_event_point_).count();
+  }
+  last_event_point_ = now;
+  event_started_ = true;
+}
+
+void ThreadPoolProfiler::LogChildEvent(int thread_idx, ChildThreadEvent evt) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].LogEvent(evt, Clock::now());
+  }
+}
+
+void ThreadPoolProfiler::LogSteal(int thread_idx) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].num_steals_++;
+  }
+}
+
 void ThreadPoolProfiler::LogRun(int thread_idx) {
   if (enabled_) {
     child_thread_stats_[thread_idx].num_run_++;
     auto now = Clock::now();
+    child_thread_stats_[thread_idx].LogEvent(WORK, now);
     if (child_thread_stats_[thread_idx].core_ < 0 ||
         TimeDiffMicroSeconds(child_thread_stats_[thread_idx].last_logged_point_, now) > 10000) {
 #ifdef _WIN32
@@ -230,12 +376,17 @@ void ThreadPoolProfiler::LogRun(int thread_idx) {
   }
 }
 
-std::string ThreadPoolProfiler::DumpChildThreadStat() {
+std::string ThreadPoolProfiler::DumpChildThreadStat() const {
   std::stringstream ss;
   for (int i = 0; i < num_threads_; ++i) {
     ss << "\"" << child_thread_stats_[i].thread_id_ << "\": {"
        << "\"num_run\": " << child_thread_stats_[i].num_run_ << ", "
-       << "\"core\": " << child_thread_stats_[i].core_ << "}"
+       << "\"num_steals\": " << child_thread_stats_[i].num_steals_ << ", ";
+    for (int j = 0; j < MAX_CHILD_EVENT; ++j) {
+      ss << "\"" << GetChildEventName(static_cast<ChildThreadEvent>(j)) << "\": "
+         << child_thread_stats_[i].events_ns_[j] / 1000 << ", ";
+    }
+    ss << "\"core\": " << child_thread_stats_[i].core_ << "}"
        << (i == num_threads_ - 1 ? "" : ",");
   }
   return ss.str();
@@ -331,6 +482,39 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
     return false;
   }
 
+  // As ClaimIterations, but claims a multiple of block_size iterations: 1/(2 * num_claimants) of the blocks that
+  // remain in the shard, and at least one block.  Early claims are large, keeping the number of atomic operations
+  // low, and claims shrink to a single block as the shard drains.  On hybrid CPUs this lets the faster cores take
+  // a larger share of the loop without knowing their relative throughput, and keeps the slower cores from being
+  // left with a large claim at the end of the loop.  num_claimants is the number of threads expected to claim
+  // from a shard.
+  bool ClaimGuidedIterations(unsigned my_home_shard,
+                             unsigned& my_shard,
+                             uint64_t& my_start,
+                             uint64_t& my_end,
+                             uint64_t block_size,
+                             uint64_t num_claimants) {
+    do {
+      auto& shard = _shards[my_shard];
+      uint64_t temp_start = shard._next.load(::std::memory_order_relaxed);
+      while (temp_start < shard._end) {
+        uint64_t remaining_blocks = (shard._end - temp_start) / block_size;
+        uint64_t claim = std::max<uint64_t>(1, remaining_blocks / (2 * num_claimants)) * block_size;
+        if (shard._next.compare_exchange_weak(temp_start, temp_start + claim)) {
+          my_start = temp_start;
+          my_end = std::min(shard._end, temp_start + claim);
+          return true;
+        }
+      }
+      my_shard = (my_shard + 1) % _num_shards;
+    } while (my_shard != my_home_shard);
+    return false;
+  }
+
+  unsigned NumShards() const {
+    return _num_shards;
+  }
+
  private:
   // Derive the number of shards to use for a given loop.  We require
   // at least one block of work per shard, and subject to the
@@ -369,6 +553,74 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// The cost per iteration measured in earlier runs of parallel loops, in nanoseconds.
+//
+// A loop is identified by the type of its body, which is unique to the call site when RTTI is available, by the
+// cost estimated by the caller and by the order of magnitude of its number of iterations. The estimated cost is
+// kept out of the measured one, so a wrong estimate is corrected after the first run.
+//
+// The table has a fixed number of entries that are updated without locking. Loops whose keys collide replace each
+// other's entries and a concurrent update can pair the key of one loop with the cost of another. Both only lead to
+// a less suitable block size for a run.
+class ParallelForCostTable {
+ public:
+  static uint64_t Key(std::ptrdiff_t total, const TensorOpCost& cost,
+                      const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+    uint64_t magnitude = 0;
+    for (auto n = static_cast<uint64_t>(total); n > 1; n >>= 1) {
+      ++magnitude;
+    }
+
+    size_t key = std::hash<uint64_t>{}(magnitude);
+    auto combine = [&key](size_t value) {
+      key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    };
+#ifndef ORT_NO_RTTI
+    combine(fn.target_type().hash_code());
+#else
+    ORT_UNUSED_PARAMETER(fn);
+#endif
+    combine(std::hash<double>{}(cost.bytes_loaded));
+    combine(std::hash<double>{}(cost.bytes_stored));
+    combine(std::hash<double>{}(cost.compute_cycles));
+    // 0 marks an empty entry
+    return static_cast<uint64_t>(key) | 1;
+  }
+
+  bool TryGetCostPerUnit(uint64_t key, double& cost_ns) const {
+    const Entry& entry = entries_[key % kNumEntries];
+    if (entry.key.load(std::memory_order_relaxed) != key) {
+      return false;
+    }
+    cost_ns = entry.cost_ns.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  void Update(uint64_t key, double measured_cost_ns) {
+    Entry& entry = entries_[key % kNumEntries];
+    double cost_ns = measured_cost_ns;
+    if (entry.key.load(std::memory_order_relaxed) == key) {
+      // moving average, so the cost follows changes of the inputs and of the load of the machine
+      const double previous_cost_ns = entry.cost_ns.load(std::memory_order_relaxed);
+      cost_ns = previous_cost_ns + (measured_cost_ns - previous_cost_ns) * kSmoothingFactor;
+    } else {
+      entry.key.store(key, std::memory_order_relaxed);
+    }
+    entry.cost_ns.store(cost_ns, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kNumEntries = 1024;
+  static constexpr double kSmoothingFactor = 0.25;
+
+  struct Entry {
+    std::atomic<uint64_t> key{0};
+    std::atomic<double> cost_ns{0.0};
+  };
+
+  std::array<Entry, kNumEntries> entries_;
+};
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -396,6 +648,10 @@ ThreadPool::ThreadPool(Env* env,
                                                 *env,
                                                 thread_options_);
     underlying_threadpool_ = extended_eigen_threadpool_.get();
+
+    if (thread_options_.adaptive_block_sizing_) {
+      cost_table_ = std::make_unique<ParallelForCostTable>();
+    }
   }
 }
 
@@ -420,16 +676,21 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = NumLoopThreads() + 1;
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
     LoopCounter lc(total, d_of_p, block_size);
+    // On hybrid CPUs the threads run at different speeds, so claim guided chunks rather than single blocks.
+    const bool guided = force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid();
+    const uint64_t claimants_per_shard = (static_cast<uint64_t>(num_work_items) + lc.NumShards() - 1) / lc.NumShards();
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
       unsigned my_home_shard = lc.GetHomeShard(idx);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
-      while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
+      while (guided ? lc.ClaimGuidedIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size,
+                                               claimants_per_shard)
+                    : lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
         fn(static_cast<std::ptrdiff_t>(my_iter_start),
            static_cast<std::ptrdiff_t>(my_iter_end));
       }
@@ -459,7 +720,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(NumLoopThreads() + 1, num_of_blocks), base_block_size);
   }
 }
 
@@ -493,31 +754,55 @@ std::string ThreadPool::StopProfiling() {
   }
 }
 
+std::string ThreadPool::GetProfilingStats() const {
+  if (underlying_threadpool_) {
+    return underlying_threadpool_->GetProfilingStats();
+  } else {
+    return {};
+  }
+}
+
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+thread_local ThreadPool* current_parallel_section_pool = nullptr;
+thread_local int current_max_degree_of_parallelism = 0;
+}  // namespace
+
+ThreadPool::ScopedMaxDegreeOfParallelism::ScopedMaxDegreeOfParallelism(int max_degree_of_parallelism)
+    : previous_(current_max_degree_of_parallelism) {
+  if (max_degree_of_parallelism > 0) {
+    current_max_degree_of_parallelism = max_degree_of_parallelism;
+  }
+}
+
+ThreadPool::ScopedMaxDegreeOfParallelism::~ScopedMaxDegreeOfParallelism() {
+  current_max_degree_of_parallelism = previous_;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
-  ORT_ENFORCE(!current_parallel_section.has_value(), "Nested parallelism not supported");
   ORT_ENFORCE(!ps_);
   tp_ = tp;
-  if (tp && tp->underlying_threadpool_) {
+  // A section opened inside another one, e.g. by a kernel of a run that has a section open, leaves its loops to the
+  // enclosing section.
+  if (tp && tp->underlying_threadpool_ && !current_parallel_section.has_value()) {
     current_parallel_section.emplace();
+    current_parallel_section_pool = tp;
     ps_ = &*current_parallel_section;
     tp_->underlying_threadpool_->StartParallelSection(*ps_);
   }
 }
 
 ThreadPool::ParallelSection::~ParallelSection() {
-  if (current_parallel_section) {
+  if (ps_) {
     tp_->underlying_threadpool_->EndParallelSection(*ps_);
     current_parallel_section.reset();
+    current_parallel_section_pool = nullptr;
   }
 }
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
-    if (current_parallel_section.has_value()) {
+    if (current_parallel_section.has_value() && current_parallel_section_pool == this) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
                                                    n, block_size);
@@ -541,8 +826,8 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
   // caller is outside the current pool (ID == -1) then we parallelize
   // if the pool has any threads.  If the caller is inside the current pool
   // (ID != -1) then we require at least one additional thread in the pool.
-  if ((CurrentThreadId() == -1 && NumThreads() == 0) ||
-      (CurrentThreadId() != -1 && NumThreads() == 1)) {
+  if ((CurrentThreadId() == -1 && NumLoopThreads() == 0) ||
+      (CurrentThreadId() != -1 && NumLoopThreads() == 1)) {
     return false;
   }
 
@@ -613,6 +898,11 @@ static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::Tenso
 void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
   ORT_ENFORCE(n >= 0);
+  if (cost_table_) {
+    AdaptiveParallelFor(n, c, f);
+    return;
+  }
+
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
   auto d_of_p = DegreeOfParallelism(this);
   // Compute small problems directly in the caller thread.
@@ -626,6 +916,48 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
   ParallelForFixedBlockSizeScheduling(n, block, f);
 }
 
+// The cost model works in cycles, measured costs are converted at a nominal clock rate.
+static constexpr double kNominalCyclesPerNanosecond = 3.0;
+
+void ThreadPool::AdaptiveParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
+                                     const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
+  if (n == 0) {
+    return;
+  }
+
+  const uint64_t key = ParallelForCostTable::Key(n, c, f);
+  Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+  double measured_cost_ns = 0.0;
+  if (cost_table_->TryGetCostPerUnit(key, measured_cost_ns)) {
+    cost = Eigen::TensorOpCost{0, 0, measured_cost_ns * kNominalCyclesPerNanosecond};
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsed_ns = [](Clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+  };
+
+  // Compute small problems directly in the caller thread.
+  const int d_of_p = DegreeOfParallelism(this);
+  const int num_threads = CostModel::numThreads(static_cast<double>(n), cost, d_of_p);
+  if (!ShouldParallelizeLoop(n) || num_threads == 1) {
+    const auto start = Clock::now();
+    f(0, n);
+    cost_table_->Update(key, static_cast<double>(elapsed_ns(start)) / static_cast<double>(n));
+    return;
+  }
+
+  // Only the time spent in the blocks is counted, so waiting for threads to join does not inflate the cost.
+  std::atomic<uint64_t> busy_ns{0};
+  const ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, num_threads);
+  ParallelForFixedBlockSizeScheduling(n, block, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const auto start = Clock::now();
+    f(first, last);
+    busy_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+  });
+  cost_table_->Update(key, static_cast<double>(busy_ns.load(std::memory_order_relaxed)) / static_cast<double>(n));
+}
+
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
   ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
@@ -640,9 +972,9 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return ((tp->NumLoopThreads() + 1)) * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return ((tp->NumLoopThreads() + 1));
     }
   } else {
     return 1;
@@ -655,6 +987,13 @@ void ThreadPool::StartProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+size_t ThreadPool::NumPendingTasks(const concurrency::ThreadPool* tp) {
+  if (tp && tp->underlying_threadpool_) {
+    return tp->underlying_threadpool_->NumPendingTasks();
+  }
+  return 0;
+}
+
 std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   if (tp) {
     return tp->StopProfiling();
@@ -663,6 +1002,14 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+std::string ThreadPool::GetProfilingStats(const concurrency::ThreadPool* tp) {
+  if (tp) {
+    return tp->GetProfilingStats();
+  } else {
+    return {};
+  }
+}
+
 void ThreadPool::EnableSpinning() {
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
@@ -684,6 +1031,14 @@ int ThreadPool::NumThreads() const {
   }
 }
 
+int ThreadPool::NumLoopThreads() const {
+  const int num_threads = NumThreads();
+  if (current_max_degree_of_parallelism > 0) {
+    return std::min(num_threads, current_max_degree_of_parallelism - 1);
+  }
+  return num_threads;
+}
+
 // Return ID of the current thread within this pool.  Returns -1 for a thread outside the
 // current pool.
 int ThreadPool::CurrentThreadId() const {
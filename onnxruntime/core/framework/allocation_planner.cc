@@ -5,6 +5,11 @@
 #include <list>
 #include <algorithm>
 #include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
@@ -19,6 +24,7 @@
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/symbolic_dim_expr.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -70,6 +76,9 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kAllocatedExternally:
       out << "AllocatedExternally";
       break;
+    case AllocKind::kReuseSubBuffer:
+      out << "ReuseSubBuffer";
+      break;
     case AllocKind::kNotSet:
       out << "NotSet";
       break;
@@ -98,6 +107,9 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kReuseSubBuffer) {
+        out << " " << elt_plan.reused_buffer << "+" << elt_plan.reused_buffer_offset;
+      }
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
     } else {
@@ -418,7 +430,10 @@ class PlannerImpl {
         bool can_strided = true;
         for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
           const KernelCreateInfo& output_node_ci = GetKernelCreateInfo(kernel_create_info_map_, it->Index());
-          if (!output_node_ci.kernel_def) {
+          // the implicit inputs of a control flow node are read by its subgraphs
+          const auto& implicit_inputs = it->ImplicitInputDefs();
+          if (!output_node_ci.kernel_def ||
+              std::find(implicit_inputs.begin(), implicit_inputs.end(), p_output_arg) != implicit_inputs.end()) {
             can_strided = false;
             break;
           }
@@ -473,8 +488,8 @@ class PlannerImpl {
         continue;  // same known dimension
       if (utils::HasDimParam(val1) && utils::HasDimParam(val2)) {
         const auto& val1_param = val1.dim_param();
-        if (val1_param == val2.dim_param() && !val1_param.empty())
-          continue;  // same unknown dimension
+        if (!val1_param.empty() && SameSymbolicDim(val1_param, val2.dim_param()))
+          continue;  // same unknown dimension, possibly written as a different but equal expression
       }
       return false;
     }
@@ -522,6 +537,52 @@ class PlannerImpl {
     */
   }
 
+  static bool IsStringTensor(const onnxruntime::NodeArg& arg) {
+    return arg.TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING;
+  }
+
+  /*! \brief Returns the size in bytes of a tensor if its shape is fully known, or std::nullopt otherwise.
+   */
+  static std::optional<size_t> GetStaticSizeInBytes(const TensorShapeProto& shape, const onnxruntime::NodeArg& arg) {
+    SafeInt<size_t> num_bytes = GetElementSize(arg.Type());
+    for (const auto& dim : shape.dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return std::nullopt;
+      num_bytes *= static_cast<size_t>(dim.dim_value());
+    }
+    return static_cast<size_t>(num_bytes);
+  }
+
+  /*! \brief Whether a freed buffer of (available_shape, available_arg) is large enough for an output of
+   *  (required_shape, required_arg) with a different element type. Sets wasted_bytes to the unused part of the buffer
+   *  if both sizes are known, or to 0 if the shapes match and the output's elements are not larger.
+   */
+  static bool FitsInBuffer(const TensorShapeProto& available_shape, const onnxruntime::NodeArg& available_arg,
+                           const TensorShapeProto& required_shape, const onnxruntime::NodeArg& required_arg,
+                           size_t& wasted_bytes) {
+    // string tensors need to be placement new'ed, see SameSize. buffers of the same type are only re-used for the
+    // same size, as the execution frame treats a larger buffer of the same type as a sign of a bad model.
+    if (IsStringTensor(available_arg) || IsStringTensor(required_arg) ||
+        available_arg.Type() == required_arg.Type()) {
+      return false;
+    }
+
+    const auto available_bytes = GetStaticSizeInBytes(available_shape, available_arg);
+    const auto required_bytes = GetStaticSizeInBytes(required_shape, required_arg);
+    if (available_bytes.has_value() && required_bytes.has_value()) {
+      if (*required_bytes == 0 || *required_bytes > *available_bytes) return false;
+      wasted_bytes = *available_bytes - *required_bytes;
+      return true;
+    }
+
+    // e.g. Cast from float to float16 with symbolic dims. the output needs at most as many bytes as the buffer.
+    if (GetElementSize(required_arg.Type()) <= GetElementSize(available_arg.Type()) &&
+        SameShape(available_shape, required_shape)) {
+      wasted_bytes = 0;
+      return true;
+    }
+    return false;
+  }
+
   static bool OutputHasConsumerNode(const Node& node, int output_idx) {
     // there will be an edge to all consumer nodes.
     // if consumed in a subgraph the edge will be to an implicit input of the node containing the subgraph.
@@ -540,7 +601,8 @@ class PlannerImpl {
     return SameSize(*p_shape1, arg1, *p_shape2, arg2);
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
+  // Find if freelist contains a buffer of the same size as output_arg. If there is none, use the freed buffer of
+  // another element type that output_arg fits in with the least memory left unused.
   bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, OrtValueIndex* reusable_tensor) {
     if (!context_->GetEnableMemoryReuse()) {
       return false;
@@ -549,6 +611,9 @@ class PlannerImpl {
     if (nullptr == p_required_buffer_shape || p_required_buffer_shape->dim_size() == 0) return false;
     auto& required_memory_info = AllocPlan(output_arg.Name()).location;
 
+    auto best_fit = freelist_.end();
+    size_t best_fit_wasted_bytes = std::numeric_limits<size_t>::max();
+
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
       size_t reusable = static_cast<size_t>(it->ml_value);
       const onnxruntime::NodeArg* p_node_arg = ort_value_info_.at(reusable).p_def_site;
@@ -576,11 +641,155 @@ class PlannerImpl {
           freelist_.erase(it);
           return true;
         }
+
+        size_t wasted_bytes = 0;
+        if (FitsInBuffer(*p_available_buffer_shape, *p_node_arg, *p_required_buffer_shape, output_arg,
+                         wasted_bytes) &&
+            wasted_bytes < best_fit_wasted_bytes) {
+          best_fit = it;
+          best_fit_wasted_bytes = wasted_bytes;
+        }
       }
     }
+
+    if (best_fit != freelist_.end()) {
+      *reusable_tensor = best_fit->ml_value;
+      freelist_.erase(best_fit);
+      return true;
+    }
     return false;
   }
 
+  // Whether the producer of a Concat input can write it anywhere but in a buffer of its own choosing.
+  bool CanProduceIntoSubBuffer(const Node& producer, int output_arg_num) {
+    const KernelCreateInfo& ci = GetKernelCreateInfo(kernel_create_info_map_, producer.Index());
+    if (ci.kernel_def == nullptr || HasExternalOutputs(producer) || producer.ContainsSubgraph()) {
+      return false;
+    }
+
+    // an output that must alias an input
+    const auto alias_map = GetAliasMap(producer, ci);
+    if (std::any_of(alias_map.begin(), alias_map.end(),
+                    [output_arg_num](const std::pair<int, int>& pair) { return pair.second == output_arg_num; }) ||
+        ci.kernel_def->VariadicAlias().has_value()) {
+      return false;
+    }
+
+#ifdef ENABLE_STRIDED_TENSORS
+    const auto& may_strided_outputs_map = ci.kernel_def->MayStridedOutput();
+    if (std::any_of(may_strided_outputs_map.begin(), may_strided_outputs_map.end(),
+                    [output_arg_num](const std::pair<int, int>& pair) { return pair.second == output_arg_num; })) {
+      return false;
+    }
+#endif
+
+    return true;
+  }
+
+  // A CPU Concat whose output has a static shape with all the dims before the axis equal to 1 places each input in
+  // a contiguous range of the output. Such an input can be produced directly in that range, a sub-buffer of the
+  // output, which leaves nothing for the Concat to copy. Finds the inputs of the Concat nodes of execution_plan that
+  // can be planned that way: sub_buffers maps each of them to the Concat output and the byte offset in it, and
+  // concat_outputs gets the Concat outputs, which must have a buffer of their own.
+  void FindConcatSubBuffers(gsl::span<const NodeIndex> execution_plan,
+                            InlinedHashMap<OrtValueIndex, std::pair<OrtValueIndex, size_t>>& sub_buffers,
+                            InlinedHashSet<OrtValueIndex>& concat_outputs) {
+#ifdef ENABLE_TRAINING
+    // the static memory patterns of training builds trace a buffer from the step of its producer on, while the
+    // buffer of a Concat output would be needed from the step of the producer of its first input on.
+    ORT_UNUSED_PARAMETER(execution_plan);
+    ORT_UNUSED_PARAMETER(sub_buffers);
+    ORT_UNUSED_PARAMETER(concat_outputs);
+#else
+    if (!IsSingleStream() || context_->IsParallelExecutionEnabled() || !context_->GetEnableMemoryReuse()) {
+      return;
+    }
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    auto is_graph_output = [&graph_outputs](const NodeArg* arg) {
+      return std::find(graph_outputs.begin(), graph_outputs.end(), arg) != graph_outputs.end();
+    };
+
+    for (auto node_index : execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(node_index);
+      if (pnode->OpType() != "Concat" || pnode->Domain() != kOnnxDomain ||
+          pnode->GetExecutionProviderType() != kCpuExecutionProvider || pnode->InputDefs().size() < 2) {
+        continue;
+      }
+
+      const NodeArg* output = pnode->OutputDefs()[0];
+      if (!output->Exists() || IsNonTensor(*output) || IsStringTensor(*output) || is_graph_output(output)) {
+        continue;
+      }
+
+      const auto* output_shape = context_->GetShape(*output);
+      const auto output_bytes = output_shape ? GetStaticSizeInBytes(*output_shape, *output) : std::nullopt;
+      const auto axis_attr = pnode->GetAttributes().find("axis");
+      if (!output_bytes.has_value() || axis_attr == pnode->GetAttributes().end()) {
+        continue;
+      }
+
+      const int rank = output_shape->dim_size();
+      const int64_t axis = axis_attr->second.i() < 0 ? axis_attr->second.i() + rank : axis_attr->second.i();
+      if (axis < 0 || axis >= rank ||
+          !std::all_of(output_shape->dim().begin(), output_shape->dim().begin() + axis,
+                       [](const auto& dim) { return dim.dim_value() == 1; })) {
+        continue;
+      }
+
+      // the producer of each input, and the index of the input in its outputs
+      const auto& input_defs = pnode->InputDefs();
+      InlinedVector<std::pair<const Node*, int>> producers(input_defs.size(), {nullptr, -1});
+      for (auto it = pnode->InputEdgesBegin(), end = pnode->InputEdgesEnd(); it != end; ++it) {
+        if (static_cast<size_t>(it->GetDstArgIndex()) < producers.size()) {
+          producers[it->GetDstArgIndex()] = {&it->GetNode(), it->GetSrcArgIndex()};
+        }
+      }
+
+      const OrtValueIndex output_index = Index(output->Name());
+      InlinedVector<std::pair<OrtValueIndex, size_t>> inputs;
+      size_t offset = 0;
+      bool can_place_inputs = true;
+      for (size_t i = 0; can_place_inputs && i < input_defs.size(); ++i) {
+        const NodeArg* input = input_defs[i];
+        const auto [producer, output_arg_num] = producers[i];
+        const auto* input_shape = input->Exists() ? context_->GetShape(*input) : nullptr;
+        const auto input_bytes = input_shape ? GetStaticSizeInBytes(*input_shape, *input) : std::nullopt;
+
+        // the input must only be consumed by this Concat, once
+        can_place_inputs = producer != nullptr && input_bytes.has_value() && input->Type() == output->Type() &&
+                           !is_graph_output(input) &&
+                           std::count_if(producer->OutputEdgesBegin(), producer->OutputEdgesEnd(),
+                                         [output_arg_num = output_arg_num](const Node::EdgeEnd& edge) {
+                                           return edge.GetSrcArgIndex() == output_arg_num;
+                                         }) == 1 &&
+                           CanProduceIntoSubBuffer(*producer, output_arg_num);
+        if (!can_place_inputs) {
+          break;
+        }
+
+        const OrtValueIndex input_index = Index(input->Name());
+        // the output of an earlier Concat has its own inputs placed in it
+        can_place_inputs = AllocPlan(input_index).location == AllocPlan(output_index).location &&
+                           concat_outputs.find(input_index) == concat_outputs.end();
+        if (can_place_inputs && *input_bytes != 0) {
+          inputs.emplace_back(input_index, offset);
+        }
+        offset += *input_bytes;
+      }
+
+      if (!can_place_inputs || inputs.empty() || offset != *output_bytes) {
+        continue;
+      }
+
+      for (const auto& [input_index, input_offset] : inputs) {
+        sub_buffers.emplace(input_index, std::make_pair(output_index, input_offset));
+      }
+      concat_outputs.insert(output_index);
+    }
+#endif
+  }
+
   void Initialize(size_t num_ml_values) {
     // All ml-value indices must be in range 0 .. num_ml_values-1
     ort_value_info_.resize(num_ml_values);
@@ -885,6 +1094,13 @@ class PlannerImpl {
 
     const KernelCreateInfo& kernel_create_info = GetKernelCreateInfo(kernel_create_info_map, node.Index());
 
+    // a weight copied to a device, e.g. by the InitializerStreamingTransformer, is kept in its pinned memory so the
+    // copies are asynchronous
+    if (node.OpType() == "MemcpyFromHost" && node.Domain() == kOnnxDomain &&
+        p_provider->Type() != kCpuExecutionProvider) {
+      return p_provider->GetOrtDeviceByMemType(OrtMemTypeCPUOutput);
+    }
+
     // weights are not output from any node, so it's OK to put its location on CPU provider
     return p_provider->GetOrtDeviceByMemType(utils::IsInputOnCpu(node, &kernel_create_info, input_index) ? OrtMemTypeCPUInput : OrtMemTypeDefault);
   }
@@ -1476,6 +1692,10 @@ class PlannerImpl {
     auto& execution_plan = stream_nodes_[stream_index];
     // Cached graph outputs.
     const auto& graph_outputs = graph_viewer_.GetOutputs();
+    // Concat inputs planned in the buffer of the Concat output.
+    InlinedHashMap<OrtValueIndex, std::pair<OrtValueIndex, size_t>> concat_sub_buffers;
+    InlinedHashSet<OrtValueIndex> concat_outputs;
+    FindConcatSubBuffers(execution_plan, concat_sub_buffers, concat_outputs);
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
       auto node_index = execution_plan[program_counter];
       // the node (aka operator) which carries the considered program (aka computation).
@@ -1537,6 +1757,18 @@ class PlannerImpl {
               }
             }
           }
+        } else if (auto sub_buffer = concat_sub_buffers.find(current); sub_buffer != concat_sub_buffers.end()) {
+          // the buffer of the Concat output is allocated when the first of its inputs is created
+          const auto [concat_output, offset] = sub_buffer->second;
+          Reuse(concat_output, current, AllocKind::kReuseSubBuffer);
+          AllocPlan(current).reused_buffer_offset = offset;
+          const auto* concat_output_shape = context_->GetShape(*ort_value_info_[concat_output].p_def_site);
+          for (const auto& dim : concat_output_shape->dim()) {
+            AllocPlan(current).reused_buffer_shape.push_back(dim.dim_value());
+          }
+        } else if (concat_outputs.find(current) != concat_outputs.end()) {
+          // its buffer is written from the step that produces its first input on, so it can't be one freed since
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
         } else if (!context_->IsParallelExecutionEnabled() &&
                    FindReusableInput(graph_viewer_, *pnode, static_cast<int>(output_arg_def_index),
                                      &reused, &is_strided_tensor)) {
@@ -1918,7 +2150,8 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file,
+                                                                 context_->GetMaxStreamsPerDevice());
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -1931,6 +2164,75 @@ class PlannerImpl {
   }
 
   // build each logic streams
+  // In parallel execution mode, the steps triggered by a node are scheduled on the inter-op thread pool in the order
+  // of plan_.downstream_map, and the streams are started in the order of plan_.stream_dispatch_order.
+  // Order both by the estimated cost of the longest chain of work that can still run once a step is reached
+  // (critical path first), so wide graphs keep all the threads busy and the longest branch starts first.
+  // The cost of a step is estimated statically as the number of kernels on the path.
+  void PrioritizeByCriticalPath(const std::vector<std::vector<size_t>>& stream_kernel_steps,
+                                const std::vector<std::vector<std::pair<size_t, size_t>>>& stream_trigger_steps) {
+    auto& execution_plan = plan_.execution_plan;
+    constexpr size_t kNoTrigger = std::numeric_limits<size_t>::max();
+
+    std::vector<std::vector<bool>> is_kernel_step(num_logic_streams_);
+    std::vector<std::vector<size_t>> trigger_at_step(num_logic_streams_);
+    for (size_t i = 0; i < num_logic_streams_; ++i) {
+      const size_t num_steps = execution_plan[i]->steps_.size();
+      is_kernel_step[i].resize(num_steps, false);
+      trigger_at_step[i].resize(num_steps, kNoTrigger);
+      for (auto step : stream_kernel_steps[i]) is_kernel_step[i][step] = true;
+      for (const auto& trigger : stream_trigger_steps[i]) trigger_at_step[i][trigger.first] = trigger.second;
+    }
+
+    // memoized remaining cost of the steps that start a task: {stream_idx, step_idx} -> cost
+    std::map<std::pair<size_t, size_t>, size_t> remaining_cost;
+    std::function<size_t(size_t, size_t)> get_remaining_cost = [&](size_t stream_idx, size_t since) -> size_t {
+      auto it = remaining_cost.find({stream_idx, since});
+      if (it != remaining_cost.end()) return it->second;
+
+      // walk the stream backwards. the downstream steps of a trigger run in parallel with the rest of the stream.
+      size_t cost = 0;
+      for (size_t step = execution_plan[stream_idx]->steps_.size(); step-- > since;) {
+        const size_t trigger = trigger_at_step[stream_idx][step];
+        if (trigger != kNoTrigger) {
+          auto downstream_it = plan_.downstream_map.find(trigger);
+          if (downstream_it != plan_.downstream_map.end()) {
+            for (const auto& downstream : downstream_it->second) {
+              cost = std::max(cost, get_remaining_cost(downstream.first, downstream.second));
+            }
+          }
+        }
+        if (is_kernel_step[stream_idx][step]) ++cost;
+      }
+
+      remaining_cost[{stream_idx, since}] = cost;
+      return cost;
+    };
+
+    for (auto& entry : plan_.downstream_map) {
+      auto& downstreams = entry.second;
+      std::vector<size_t> costs;
+      costs.reserve(downstreams.size());
+      for (const auto& downstream : downstreams) costs.push_back(get_remaining_cost(downstream.first, downstream.second));
+
+      std::vector<size_t> order(downstreams.size());
+      std::iota(order.begin(), order.end(), size_t{0});
+      std::stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+      std::vector<std::pair<size_t, size_t>> sorted;
+      sorted.reserve(downstreams.size());
+      for (auto idx : order) sorted.push_back(downstreams[idx]);
+      downstreams = std::move(sorted);
+    }
+
+    std::vector<size_t> stream_costs(num_logic_streams_);
+    for (size_t i = 0; i < num_logic_streams_; ++i) stream_costs[i] = get_remaining_cost(i, 0);
+    plan_.stream_dispatch_order.resize(num_logic_streams_);
+    std::iota(plan_.stream_dispatch_order.begin(), plan_.stream_dispatch_order.end(), size_t{0});
+    std::stable_sort(plan_.stream_dispatch_order.begin(), plan_.stream_dispatch_order.end(),
+                     [&stream_costs](size_t a, size_t b) { return stream_costs[a] > stream_costs[b]; });
+  }
+
   Status BuildExecutionPlan(const ExecutionProviders& execution_providers,
                             const IStreamCommandHandleRegistry& stream_handle_registry) {
     // 1. create logic stream instance
@@ -2065,6 +2367,10 @@ class PlannerImpl {
     }
 
     // 4. add commands to logic queue
+    // step index of every kernel launch and {step index, trigger point} of every trigger, per stream.
+    // used to prioritize the downstream steps below.
+    std::vector<std::vector<size_t>> stream_kernel_steps(num_logic_streams_);
+    std::vector<std::vector<std::pair<size_t, size_t>>> stream_trigger_steps(num_logic_streams_);
     for (size_t i = 0; i < num_logic_streams_; ++i) {
       for (size_t j = 0; j < stream_nodes_[i].size(); ++j) {
         auto node_index = stream_nodes_[i][j];
@@ -2110,6 +2416,7 @@ class PlannerImpl {
           dependence_graph_[it->Index()].insert(node_index);
         }
 // push launch kernel command
+        stream_kernel_steps[i].push_back(execution_plan[i]->steps_.size());
 #if defined(ORT_MINIMAL_BUILD)
         execution_plan[i]->steps_.emplace_back(std::make_unique<LaunchKernelStep>(node_index));
 #else
@@ -2125,11 +2432,16 @@ class PlannerImpl {
         auto trigger_point_it = node_to_trigger_points.find(node_index);
         if (trigger_point_it != node_to_trigger_points.end()) {
           // notify downstreams
+          stream_trigger_steps[i].push_back({execution_plan[i]->steps_.size(), trigger_point_it->second});
           execution_plan[i]->steps_.emplace_back(std::make_unique<TriggerDownstreamStep>(trigger_point_it->second, node_index));
         }
       }
     }
 
+    if (context_->IsParallelExecutionEnabled()) {
+      PrioritizeByCriticalPath(stream_kernel_steps, stream_trigger_steps);
+    }
+
     for (auto node_index : graph_viewer_.GetNodesInTopologicalOrder(context_->GetExecutionOrder())) {
       auto* node = graph_viewer_.GetNode(node_index);
       const auto& output_defs = node->OutputDefs();
@@ -2302,6 +2614,8 @@ Status PlannerImpl::CreatePlan(
 #else
   ORT_RETURN_IF_ERROR(BuildExecutionPlan(execution_providers_));
 #endif
+  plan_.is_single_stream_of_kernels = plan_.execution_plan.size() == 1 && plan_.num_barriers == 0 &&
+                                      plan_.notification_owners.empty() && plan_.downstream_map.empty();
 
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
@@ -2381,11 +2695,19 @@ DeviceBasedPartitioner stores config in json format:
 "streams" specifies streams of nodes;
 "devices" specifies the type of device of each stream.
 Pls check definition of OrtDevice for more detail on device type.
+
+Without a config, the nodes of each device are put in one stream. If max_streams_per_device is more than 1, the nodes
+of a non CPU device are spread over up to that many streams instead, so that independent branches of the graph, e.g.
+the heads of an ensemble or the towers of an encoder, run concurrently. A node continues the stream of one of its
+producers if that producer is the last node of its stream, so chains stay in one stream. Otherwise it starts a new
+stream while the device has fewer streams than the limit, and then joins the stream of a producer, or the stream with
+the fewest nodes. The planner synchronizes the streams where a node consumes the output of another stream.
 */
 class DeviceBasedPartitioner : public IGraphPartitioner {
  public:
-  DeviceBasedPartitioner(const logging::Logger& logger,
-                         const PathString& config_file) : IGraphPartitioner(logger, config_file) {
+  DeviceBasedPartitioner(const logging::Logger& logger, const PathString& config_file,
+                         size_t max_streams_per_device)
+      : IGraphPartitioner(logger, config_file), max_streams_per_device_(max_streams_per_device) {
     Initialize();
   }
 
@@ -2410,6 +2732,7 @@ class DeviceBasedPartitioner : public IGraphPartitioner {
   std::vector<OrtDevice::DeviceType> device_types_;
   std::vector<InlinedVector<std::string>> node_names_by_stream_;
   bool need_save_ = false;
+  size_t max_streams_per_device_ = 1;
 };
 
 #define EXIT_ON_ERR(warning)         \
@@ -2428,6 +2751,45 @@ Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& gr
   if (node_names_by_stream_.empty()) {  // input configure empty, do it from scratch
 
     InlinedHashMap<OrtDevice::DeviceType, int> device_to_stream;
+    // streams of every device when its branches are spread over several streams
+    InlinedHashMap<OrtDevice::DeviceType, InlinedVector<size_t>> device_streams;
+    InlinedHashMap<NodeIndex, size_t> node_to_stream;
+    // last node of every stream
+    InlinedVector<NodeIndex> stream_tails;
+
+    auto new_stream = [&](OrtDevice::DeviceType device_type) {
+      node_names_by_stream_.push_back({});
+      device_types_.push_back(device_type);
+      stream_tails.push_back(0);
+      return node_names_by_stream_.size() - 1;
+    };
+
+    auto pick_branch_stream = [&](const Node& node, OrtDevice::DeviceType device_type) -> size_t {
+      auto& streams = device_streams[device_type];
+      std::optional<size_t> producer_stream;
+      for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+        auto producer = node_to_stream.find(it->Index());
+        if (producer == node_to_stream.end() || device_types_[producer->second] != device_type) {
+          continue;
+        }
+        if (stream_tails[producer->second] == it->Index()) {
+          return producer->second;
+        }
+        if (!producer_stream.has_value()) {
+          producer_stream = producer->second;
+        }
+      }
+      if (streams.size() < max_streams_per_device_) {
+        streams.push_back(new_stream(device_type));
+        return streams.back();
+      }
+      if (producer_stream.has_value()) {
+        return *producer_stream;
+      }
+      return *std::min_element(streams.begin(), streams.end(), [this](size_t a, size_t b) {
+        return node_names_by_stream_[a].size() < node_names_by_stream_[b].size();
+      });
+    };
 
     for (auto node_index : p_graph_nodes) {
       // get device info of the node
@@ -2437,19 +2799,25 @@ Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& gr
       auto* ep = execution_providers.Get(*node);
       auto device_type = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
 
-      // log the device
-      auto it = device_to_stream.find(device_type);
-      if (it == device_to_stream.end()) {
-        device_to_stream[device_type] = static_cast<int>(node_names_by_stream_.size());
-        node_names_by_stream_.push_back({});
-        device_types_.push_back(device_type);
-        it = device_to_stream.find(device_type);
+      size_t stream = 0;
+      if (max_streams_per_device_ > 1 && device_type != OrtDevice::CPU) {
+        stream = pick_branch_stream(*node, device_type);
+      } else {
+        // log the device
+        auto it = device_to_stream.find(device_type);
+        if (it == device_to_stream.end()) {
+          it = device_to_stream.emplace(device_type, static_cast<int>(new_stream(device_type))).first;
+        }
+        stream = static_cast<size_t>(it->second);
       }
+      node_to_stream[node_index] = stream;
+      stream_tails[stream] = node_index;
+
       // put the node into the belonging stream
       if (node_name.empty()) {
-        node_names_by_stream_[it->second].push_back(op_type + std::to_string(op_type_counter[op_type]++));
+        node_names_by_stream_[stream].push_back(op_type + std::to_string(op_type_counter[op_type]++));
       } else {
-        node_names_by_stream_[it->second].push_back(node_name);
+        node_names_by_stream_[stream].push_back(node_name);
       }
     }
   }
@@ -2542,7 +2910,8 @@ void DeviceBasedPartitioner::SaveConfig() const {
 }
 
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
+                                                                             const PathString& config_file,
+                                                                             size_t max_streams_per_device) {
   // use device based partitioner by default
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
       IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
@@ -2565,7 +2934,7 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   }
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
-    return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+    return std::make_unique<DeviceBasedPartitioner>(logger, config_file, max_streams_per_device);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
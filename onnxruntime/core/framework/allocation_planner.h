@@ -46,15 +46,20 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // Maximum number of logic streams the nodes of a non CPU device are partitioned into.
+  virtual size_t GetMaxStreamsPerDevice() const { return 1; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           size_t max_streams_per_device = 1)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        max_streams_per_device_(max_streams_per_device) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +72,13 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  size_t GetMaxStreamsPerDevice() const override { return max_streams_per_device_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  size_t max_streams_per_device_ = 1;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -90,8 +98,11 @@ class IGraphPartitioner {
   virtual ~IGraphPartitioner() = default;
   // create the partition based on the partition type.
   // perform partition based on the user input when provided.
+  // max_streams_per_device is used when the partition is not read from config_file: the independent branches of the
+  // nodes of a non CPU device are then spread over up to that many streams.
   static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
-                                                                   const PathString& config_file);
+                                                                   const PathString& config_file,
+                                                                   size_t max_streams_per_device = 1);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
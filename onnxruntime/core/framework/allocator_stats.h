@@ -18,6 +18,8 @@ struct AllocatorStats {
   int64_t total_allocated_bytes;  // The total number of allocated bytes by the allocator.
   int64_t max_bytes_in_use;       // The maximum bytes in use.
   int64_t max_alloc_size;         // The max single allocation seen.
+  int64_t huge_page_bytes;        // Bytes of arena regions backed by huge pages. For transparent huge pages, the
+                                  // bytes the kernel was asked to back by huge pages.
                                   // The upper limit what the allocator can allocate, if such a limit
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
@@ -35,6 +37,7 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->huge_page_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +50,8 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "HugePageBytes:            " << this->huge_page_bytes << "\n";
     return ss.str();
   }
 };
@@ -11,6 +11,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/slab_arena.h"
 
 namespace onnxruntime {
 using namespace common;
@@ -32,6 +33,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int64_t thread_cache_max_bytes = info.arena_cfg.thread_cache_max_bytes == -1
+                                         ? BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES
+                                         : info.arena_cfg.thread_cache_max_bytes;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -47,6 +51,51 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
         return nullptr;
     }
 
+    ArenaHugePageMode huge_page_mode;
+    switch (info.arena_cfg.huge_page_mode) {
+      case static_cast<int>(ArenaHugePageMode::kTransparent):
+        huge_page_mode = ArenaHugePageMode::kTransparent;
+        break;
+      case static_cast<int>(ArenaHugePageMode::kExplicit):
+        huge_page_mode = ArenaHugePageMode::kExplicit;
+        break;
+      case -1:  // default value supplied by user
+      case static_cast<int>(ArenaHugePageMode::kDisabled):
+        huge_page_mode = ArenaHugePageMode::kDisabled;
+        break;
+      default:
+        LOGS_DEFAULT(ERROR) << "Received invalid value of huge_page_mode " << info.arena_cfg.huge_page_mode;
+        return nullptr;
+    }
+    if (huge_page_mode != ArenaHugePageMode::kDisabled && device_allocator->Info().device.Type() != OrtDevice::CPU) {
+      LOGS_DEFAULT(WARNING) << "Huge pages are only supported for CPU memory. Not using them for "
+                            << device_allocator->Info().name;
+      huge_page_mode = ArenaHugePageMode::kDisabled;
+    }
+
+    ArenaAllocatorType arena_type;
+    switch (info.arena_cfg.arena_type) {
+      case static_cast<int>(ArenaAllocatorType::kSlabArena):
+        arena_type = ArenaAllocatorType::kSlabArena;
+        break;
+      case -1:  // default value supplied by user
+      case static_cast<int>(ArenaAllocatorType::kBFCArena):
+        arena_type = ArenaAllocatorType::kBFCArena;
+        break;
+      default:
+        LOGS_DEFAULT(ERROR) << "Received invalid value of arena_type " << info.arena_cfg.arena_type;
+        return nullptr;
+    }
+
+    if (arena_type == ArenaAllocatorType::kSlabArena) {
+      // SlabArena keeps its block headers in the allocated memory and has no notion of streams.
+      if (device_allocator->Info().device.Type() == OrtDevice::CPU && !info.use_stream_aware_arena) {
+        return AllocatorPtr(std::make_unique<SlabArena>(std::move(device_allocator), max_mem));
+      }
+      LOGS_DEFAULT(WARNING) << "The slab arena is only supported for CPU memory without stream aware allocation. "
+                            << "Using BFCArena for " << device_allocator->Info().name;
+    }
+
     if (info.use_stream_aware_arena) {
 #ifdef ORT_ENABLE_STREAM
       return AllocatorPtr(
@@ -68,7 +117,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_bytes,
+                                     huge_page_mode));
     }
   } else {
     return device_allocator;
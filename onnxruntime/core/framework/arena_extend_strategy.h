@@ -12,4 +12,19 @@ enum class ArenaExtendStrategy : int32_t {
   kSameAsRequested,
 };
 
+// The allocator implementation used when an arena is requested.
+enum class ArenaAllocatorType : int32_t {
+  kBFCArena = 0,
+  kSlabArena,
+};
+
+// How the regions of a CPU arena are backed by 2MB huge pages. Only supported on Linux.
+enum class ArenaHugePageMode : int32_t {
+  kDisabled = 0,
+  // transparent huge pages, requested with madvise(MADV_HUGEPAGE)
+  kTransparent,
+  // huge pages reserved with vm.nr_hugepages (MAP_HUGETLB), falling back to transparent huge pages
+  kExplicit,
+};
+
 }  // namespace onnxruntime
@@ -3,16 +3,77 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include "core/providers/cuda/nvtx_profile.h"
+#include <atomic>
 #include <type_traits>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace onnxruntime {
+
+namespace {
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Maps size bytes, a multiple of kHugePageSize, backed by huge pages. Returns nullptr if that is not possible.
+void* MapHugePages(size_t size, ArenaHugePageMode mode) {
+#if defined(__linux__)
+  if (mode == ArenaHugePageMode::kExplicit) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      return p;
+    }
+    // not enough huge pages are reserved, fall back to transparent huge pages
+  }
+
+  // transparent huge pages have to be aligned to the huge page size, so map more and trim the ends
+  void* p = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto begin = reinterpret_cast<uintptr_t>(p);
+  const uintptr_t aligned = (begin + kHugePageSize - 1) & ~(uintptr_t{kHugePageSize} - 1);
+  if (aligned != begin) {
+    munmap(p, aligned - begin);
+  }
+  const size_t tail = (begin + size + kHugePageSize) - (aligned + size);
+  if (tail != 0) {
+    munmap(reinterpret_cast<void*>(aligned + size), tail);
+  }
+  if (madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE) != 0) {
+    // the kernel does not support transparent huge pages
+    munmap(reinterpret_cast<void*>(aligned), size);
+    return nullptr;
+  }
+  return reinterpret_cast<void*>(aligned);
+#else
+  ORT_UNUSED_PARAMETER(size);
+  ORT_UNUSED_PARAMETER(mode);
+  return nullptr;
+#endif
+}
+
+void UnmapHugePages(void* p, size_t size) {
+#if defined(__linux__)
+  munmap(p, size);
+#else
+  ORT_UNUSED_PARAMETER(p);
+  ORT_UNUSED_PARAMETER(size);
+#endif
+}
+
+}  // namespace
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_max_bytes,
+                   ArenaHugePageMode huge_page_mode)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,14 +86,21 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      huge_page_mode_(huge_page_mode),
+      thread_cache_max_bytes_(thread_cache_max_bytes) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_max_bytes: " << thread_cache_max_bytes_
+                     << " huge_page_mode: " << static_cast<int32_t>(huge_page_mode_);
+
+  ORT_ENFORCE(huge_page_mode_ == ArenaHugePageMode::kDisabled || device_allocator_->Info().device.Type() == OrtDevice::CPU,
+              "Huge pages are only supported for CPU memory.");
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -75,11 +143,17 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (ThreadCacheEnabled()) {
+    ORT_ENFORCE(ThreadCacheSizeClass(kMaxThreadCacheAllocationSize) == kNumThreadCacheSizeClasses - 1);
+    thread_cache_shards_ = std::make_unique<ThreadCacheShard[]>(kNumThreadCacheShards);
+    thread_cache_owners_ = std::make_unique<ThreadCacheOwnerShard[]>(kNumThreadCacheShards);
+  }
 }
 
 BFCArena::~BFCArena() {
   for (const auto& region : region_manager_.regions()) {
-    device_allocator_->Free(region.ptr());
+    FreeRegion(region.ptr());
   }
 
   for (const auto& reserve_chunk : reserved_chunks_) {
@@ -97,6 +171,8 @@ BFCArena::Chunk* BFCArena::ChunkFromHandle(ChunkHandle h) {
 }
 
 Status BFCArena::Extend(size_t rounded_bytes) {
+  // the payload of the range is the size of the request that extends the arena
+  profile::NvtxScopedRange extend_range("BFCArena::Extend", profile::Color::Amber, rounded_bytes);
   size_t available_bytes = memory_limit_ - static_cast<size_t>(stats_.total_allocated_bytes);
   // Rounds available_bytes down to the nearest multiple of kMinAllocationSize.
   available_bytes = (available_bytes / kMinAllocationSize) * kMinAllocationSize;
@@ -111,7 +187,7 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   auto safe_alloc = [this](size_t alloc_bytes) {
     void* new_mem = nullptr;
     ORT_TRY {
-      new_mem = device_allocator_->Alloc(alloc_bytes);
+      new_mem = AllocateRegion(alloc_bytes);
     }
     ORT_CATCH(const std::bad_alloc&) {
       // attempted allocation can throw std::bad_alloc. we want to treat this the same as if it returned nullptr
@@ -167,6 +243,13 @@ Status BFCArena::Extend(size_t rounded_bytes) {
   };
 
   size_t bytes = get_extend_bytes(rounded_bytes);
+  if (huge_page_mode_ != ArenaHugePageMode::kDisabled) {
+    // use whole huge pages rather than falling back to regular pages for the region
+    const size_t huge_page_bytes = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (huge_page_bytes <= available_bytes) {
+      bytes = huge_page_bytes;
+    }
+  }
   // Try allocating.
   void* mem_addr = safe_alloc(bytes);
 
@@ -203,14 +286,14 @@ Status BFCArena::Extend(size_t rounded_bytes) {
                            "Failed to allocate memory for requested buffer of size ", rounded_bytes);
   }
 
-  LOGS_DEFAULT(INFO) << "Extended allocation by " << bytes << " bytes.";
+  LOGS_DEFAULT_HOT(INFO) << "Extended allocation by " << bytes << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
-  LOGS_DEFAULT(INFO) << "Total allocated bytes: "
-                     << stats_.total_allocated_bytes;
+  LOGS_DEFAULT_HOT(INFO) << "Total allocated bytes: "
+                         << stats_.total_allocated_bytes;
 
-  LOGS_DEFAULT(INFO) << "Allocated memory at " << mem_addr << " to "
-                     << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
+  LOGS_DEFAULT_HOT(INFO) << "Allocated memory at " << mem_addr << " to "
+                         << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
   region_manager_.AddAllocationRegion(mem_addr, bytes, stats_.num_arena_extensions);
   stats_.num_arena_extensions += 1;
 
@@ -269,9 +352,125 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (ThreadCacheEnabled() && size != 0 && size <= kMaxThreadCacheAllocationSize) {
+    return AllocateWithThreadCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+size_t BFCArena::ThreadCacheSizeClass(size_t rounded_bytes) {
+  // 256, 512, 768 and 1024 bytes get a class each. Above that every power of two is split in 4 classes,
+  // so rounding a request up to its class wastes at most 25%.
+  if (rounded_bytes <= 4 * kMinAllocationSize) {
+    return rounded_bytes / kMinAllocationSize - 1;
+  }
+  const int lg = Log2FloorNonZero(rounded_bytes - 1);
+  return 4 * static_cast<size_t>(lg - 10) + ((rounded_bytes - 1) >> (lg - 2));
+}
+
+size_t BFCArena::ThreadCacheClassSize(size_t size_class) {
+  if (size_class < 4) {
+    return (size_class + 1) * kMinAllocationSize;
+  }
+  const size_t lg = 10 + (size_class - 4) / 4;
+  return (size_t{1} << lg) + ((size_class - 4) % 4 + 1) * (size_t{1} << (lg - 2));
+}
+
+BFCArena::ThreadCacheShard& BFCArena::CurrentThreadCacheShard() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kNumThreadCacheShards;
+  return thread_cache_shards_[shard];
+}
+
+BFCArena::ThreadCacheOwnerShard& BFCArena::ThreadCacheOwnerFor(const void* p) {
+  auto p_int = reinterpret_cast<std::uintptr_t>(p);
+  return thread_cache_owners_[(p_int >> kMinAllocationBits) % kNumThreadCacheShards];
+}
+
+void* BFCArena::AllocateWithThreadCache(size_t num_bytes) {
+  const size_t size_class = ThreadCacheSizeClass(RoundedBytes(num_bytes));
+  const size_t class_size = ThreadCacheClassSize(size_class);
+
+  ThreadCacheShard& shard = CurrentThreadCacheShard();
+  {
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto& free_list = shard.free_lists[size_class];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      shard.cached_bytes -= class_size;
+      return ptr;
+    }
+  }
+
+  // Cache miss. Get a chunk of the full class size from the bins so it can serve any request of this class later.
+  void* ptr = AllocateRawInternal(class_size, false, nullptr, false, nullptr);
+
+  ThreadCacheOwnerShard& owner = ThreadCacheOwnerFor(ptr);
+  std::lock_guard<OrtMutex> lock(owner.mutex);
+  owner.size_classes[ptr] = size_class;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  size_t size_class;
+  {
+    ThreadCacheOwnerShard& owner = ThreadCacheOwnerFor(p);
+    std::lock_guard<OrtMutex> lock(owner.mutex);
+    auto it = owner.size_classes.find(p);
+    if (it == owner.size_classes.end()) {
+      return false;
+    }
+    size_class = it->second;
+  }
+
+  std::vector<void*> evicted;
+  {
+    ThreadCacheShard& shard = CurrentThreadCacheShard();
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    shard.free_lists[size_class].push_back(p);
+    shard.cached_bytes += ThreadCacheClassSize(size_class);
+    if (shard.cached_bytes > static_cast<size_t>(thread_cache_max_bytes_)) {
+      // keep the shard half full so a thread cycling around the limit doesn't flush on every Free
+      TakeFromThreadCacheShard(shard, static_cast<size_t>(thread_cache_max_bytes_) / 2, evicted);
+    }
+  }
+
+  if (!evicted.empty()) {
+    ReleaseThreadCacheChunks(evicted);
+  }
+
+  return true;
+}
+
+void BFCArena::TakeFromThreadCacheShard(ThreadCacheShard& shard, size_t target_bytes, std::vector<void*>& chunks) {
+  // evict the largest classes first as they account for most of the cached bytes
+  for (size_t size_class = kNumThreadCacheSizeClasses; size_class-- > 0 && shard.cached_bytes > target_bytes;) {
+    auto& free_list = shard.free_lists[size_class];
+    const size_t class_size = ThreadCacheClassSize(size_class);
+    while (!free_list.empty() && shard.cached_bytes > target_bytes) {
+      chunks.push_back(free_list.back());
+      free_list.pop_back();
+      shard.cached_bytes -= class_size;
+    }
+  }
+}
+
+void BFCArena::ReleaseThreadCacheChunks(const std::vector<void*>& chunks) {
+  // Drop ownership before handing the chunks back to the bins. Once they are in the bins another thread may get
+  // the same address from the fast path and register it again.
+  for (void* p : chunks) {
+    ThreadCacheOwnerShard& owner = ThreadCacheOwnerFor(p);
+    std::lock_guard<OrtMutex> lock(owner.mutex);
+    owner.size_classes.erase(p);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* p : chunks) {
+    DeallocateRawInternal(p);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -314,7 +513,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                                     bool enable_cross_stream_reusing,
                                     WaitNotificationFn wait_fn) {
   if (num_bytes == 0) {
-    LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
+    LOGS_DEFAULT_HOT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
   }
   // First, always allocate memory of at least kMinAllocationSize
@@ -344,8 +543,8 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
     return chunk->ptr;
   }
 
-  LOGS_DEFAULT(INFO) << "Extending BFCArena for " << device_allocator_->Info().name
-                     << ". bin_num:" << bin_num << " (requested) num_bytes: " << num_bytes << " (actual) rounded_bytes:" << rounded_bytes;
+  LOGS_DEFAULT_HOT(INFO) << "Extending BFCArena for " << device_allocator_->Info().name
+                         << ". bin_num:" << bin_num << " (requested) num_bytes: " << num_bytes << " (actual) rounded_bytes:" << rounded_bytes;
 
   // Try to extend
   auto status = Extend(rounded_bytes);
@@ -376,6 +575,29 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   ORT_THROW(status.ErrorMessage());
 }
 
+void* BFCArena::AllocateRegion(size_t bytes) {
+  if (huge_page_mode_ != ArenaHugePageMode::kDisabled && bytes % kHugePageSize == 0) {
+    if (void* p = MapHugePages(bytes, huge_page_mode_)) {
+      huge_page_regions_[p] = bytes;
+      stats_.huge_page_bytes += static_cast<int64_t>(bytes);
+      return p;
+    }
+    LOGS_DEFAULT_HOT(VERBOSE) << "Could not allocate " << bytes << " bytes of huge pages, using regular pages.";
+  }
+  return device_allocator_->Alloc(bytes);
+}
+
+void BFCArena::FreeRegion(void* ptr) {
+  auto it = huge_page_regions_.find(ptr);
+  if (it == huge_page_regions_.end()) {
+    device_allocator_->Free(ptr);
+    return;
+  }
+  UnmapHugePages(ptr, it->second);
+  stats_.huge_page_bytes -= static_cast<int64_t>(it->second);
+  huge_page_regions_.erase(it);
+}
+
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
@@ -496,6 +718,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (ThreadCacheEnabled() && FreeToThreadCache(p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -509,6 +734,16 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  if (ThreadCacheEnabled()) {
+    std::vector<void*> cached_chunks;
+    for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+      ThreadCacheShard& shard = thread_cache_shards_[i];
+      std::lock_guard<OrtMutex> shard_lock(shard.mutex);
+      TakeFromThreadCacheShard(shard, 0, cached_chunks);
+    }
+    ReleaseThreadCacheChunks(cached_chunks);
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
@@ -544,9 +779,9 @@ Status BFCArena::Shrink() {
       stats_.num_arena_shrinkages += 1;
       stats_.total_allocated_bytes -= shrink_size;
 
-      LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
-                            << shrink_size << " bytes. "
-                            << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+      LOGS_DEFAULT_HOT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
+                                << shrink_size << " bytes. "
+                                << " The total allocated bytes is now " << stats_.total_allocated_bytes;
 
       h = region_begin_chunk;
       ChunkHandle temp = region_begin_chunk;
@@ -558,7 +793,7 @@ Status BFCArena::Shrink() {
         h = temp;
       }
 
-      device_allocator_->Free(region_ptr);
+      FreeRegion(region_ptr);
       region_manager_.RemoveAllocationRegion(region_ptr);
       stats_.num_arena_extensions--;
     }
@@ -19,6 +19,8 @@ limitations under the License.
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -61,6 +63,9 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  // The per-thread allocation cache is disabled by default.
+  static const int64_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;
+  static const ArenaHugePageMode DEFAULT_HUGE_PAGE_MODE = ArenaHugePageMode::kDisabled;
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +78,9 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES,
+           ArenaHugePageMode huge_page_mode = DEFAULT_HUGE_PAGE_MODE);
 
   ~BFCArena() override;
 
@@ -86,6 +93,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks parked in the per-thread caches are returned to the bins first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -123,6 +131,54 @@ class BFCArena : public IAllocator {
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Per-thread fast path in front of the bins.
+  //
+  // When enabled (thread_cache_max_bytes > 0), Alloc() requests up to kMaxThreadCacheAllocationSize are rounded up
+  // to a size class and, once freed, the chunk is parked in the free list of the calling thread's cache shard
+  // instead of being returned to the bins. A later request of the same size class from a thread mapped to that
+  // shard is served without taking lock_. Threads are assigned to one of kNumThreadCacheShards shards round-robin,
+  // so the cache does not depend on thread lifetime. From the bins' point of view cached chunks are still in use.
+  // A shard is flushed back to the bins when it holds more than thread_cache_max_bytes, and all shards are flushed
+  // by Shrink(). Allocations on a stream never go through the cache.
+  static const size_t kNumThreadCacheShards = 16;
+  static const size_t kMaxThreadCacheAllocationSize = 1 << 20;
+  // 4 classes per power of two between 256 bytes and kMaxThreadCacheAllocationSize.
+  static const size_t kNumThreadCacheSizeClasses = 44;
+
+  struct alignas(64) ThreadCacheShard {
+    OrtMutex mutex;
+    std::array<std::vector<void*>, kNumThreadCacheSizeClasses> free_lists;
+    size_t cached_bytes = 0;
+  };
+
+  // Maps the pointers handed out by the fast path to their size class. A pointer owned by the fast path stays
+  // here until its chunk is flushed back to the bins. Sharded by address so that Free() from any thread only
+  // contends with operations on nearby addresses.
+  struct alignas(64) ThreadCacheOwnerShard {
+    OrtMutex mutex;
+    std::unordered_map<const void*, size_t> size_classes;
+  };
+
+  bool ThreadCacheEnabled() const { return thread_cache_max_bytes_ > 0; }
+
+  // Size class index for a request of 'rounded_bytes' and the chunk size of a size class.
+  size_t ThreadCacheSizeClass(size_t rounded_bytes);
+  size_t ThreadCacheClassSize(size_t size_class);
+
+  ThreadCacheShard& CurrentThreadCacheShard();
+  ThreadCacheOwnerShard& ThreadCacheOwnerFor(const void* p);
+
+  void* AllocateWithThreadCache(size_t num_bytes);
+
+  // Returns true if 'p' was handed out by the fast path, in which case it is now cached.
+  bool FreeToThreadCache(void* p);
+
+  // Moves cached chunks out of 'shard' until it holds at most 'target_bytes'. Requires shard.mutex.
+  void TakeFromThreadCacheShard(ThreadCacheShard& shard, size_t target_bytes, std::vector<void*>& chunks);
+
+  // Returns chunks taken from the thread caches to the bins. Must not be called with lock_ held.
+  void ReleaseThreadCacheChunks(const std::vector<void*>& chunks);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -369,6 +425,10 @@ class BFCArena : public IAllocator {
   // 'rounded_bytes' bytes.
   Status Extend(size_t rounded_bytes);
 
+  // Allocates an allocation region, backed by huge pages if they are enabled and available.
+  void* AllocateRegion(size_t bytes);
+  void FreeRegion(void* ptr);
+
   // Returns an underlying allocated chunk of size
   // 'rounded_bytes'.
   BFCArena::Chunk* FindChunkPtr(BinNum bin_num,
@@ -509,11 +569,21 @@ class BFCArena : public IAllocator {
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
 
+  // Huge pages are only used for regions of multiples of the huge page size. Those regions are mapped directly
+  // instead of being allocated from device_allocator_. Maps them to their size.
+  const ArenaHugePageMode huge_page_mode_;
+  std::unordered_map<void*, size_t> huge_page_regions_;
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Maximum number of bytes each thread cache shard may hold before it is flushed. 0 disables the cache.
+  const int64_t thread_cache_max_bytes_;
+  std::unique_ptr<ThreadCacheShard[]> thread_cache_shards_;
+  std::unique_ptr<ThreadCacheOwnerShard[]> thread_cache_owners_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
@@ -531,9 +601,11 @@ class StreamAwareArena : public BFCArena {
   // If size is 0, then this function returns either NULL,
   // or a unique pointer value that can later be successfully
   // passed to free(). Whatever, do not dereference that pointer
-  void* AllocOnStream(size_t size, Stream* current_stream_id, WaitNotificationFn wait_fn);
+  void* AllocOnStream(size_t size, Stream* current_stream_id, WaitNotificationFn wait_fn) override;
+
+  void ReleaseStreamBuffers(Stream* stream) override;
 
-  void ReleaseStreamBuffers(Stream* stream);
+  bool IsStreamAware() const override { return true; }
 
   static StreamAwareArena* FromBFCArena(BFCArena& arena) {
     return arena.GetArenaType() == ArenaType::StreamAwareArena ? reinterpret_cast<StreamAwareArena*>(&arena) : nullptr;
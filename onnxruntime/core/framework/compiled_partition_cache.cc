@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/compiled_partition_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/common/path_string.h"
+#include "core/framework/murmurhash3.h"
+#include "core/graph/graph_viewer.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kEntryMagic[8] = {'O', 'R', 'T', 'C', 'P', 'C', '0', '1'};
+
+// An entry is the magic, the size and the hash of the data, and the data.
+struct EntryHeader {
+  char magic[sizeof(kEntryMagic)];
+  uint64_t size;
+  uint32_t hash[4];
+};
+
+// Chains the hash of each piece of the key into the next one. Each piece is prefixed by its size, so that
+// different splits of the same bytes don't collide.
+class KeyHasher {
+ public:
+  void Add(const void* data, size_t size) {
+    const uint64_t size64 = size;
+    Mix(&size64, sizeof(size64));
+    Mix(data, size);
+  }
+
+  void Add(std::string_view s) { Add(s.data(), s.size()); }
+
+  void Add(int64_t value) { Add(&value, sizeof(value)); }
+
+  std::string Hex() const {
+    std::ostringstream stream;
+    stream << std::hex << std::setfill('0');
+    for (uint32_t h : hash_) {
+      stream << std::setw(8) << h;
+    }
+    return stream.str();
+  }
+
+ private:
+  void Mix(const void* data, size_t size) {
+    std::array<uint32_t, 4> hash;
+    MurmurHash3::x86_128(data, narrow<int>(size), hash_[0] ^ hash_[1] ^ hash_[2] ^ hash_[3], hash.data());
+    for (size_t i = 0; i < hash.size(); ++i) {
+      hash_[i] ^= hash[i];
+    }
+  }
+
+  std::array<uint32_t, 4> hash_{};
+};
+
+void HashData(std::string_view data, uint32_t (&hash)[4]) {
+  MurmurHash3::x86_128(data.data(), narrow<int>(data.size()), 0, hash);
+}
+
+std::filesystem::path EntryPath(const std::filesystem::path& ep_directory, const std::string& key) {
+  return ep_directory / ToPathString(key + ".bin");
+}
+
+}  // namespace
+
+std::string CompiledPartitionCache::ComputeKey(const GraphViewer& partition, std::string_view ep_type,
+                                               std::string_view compile_options) {
+  KeyHasher hasher;
+  hasher.Add(ORT_VERSION);
+  hasher.Add(ep_type);
+  hasher.Add(compile_options);
+
+  auto add_node_arg = [&hasher](const NodeArg& node_arg) {
+    hasher.Add(node_arg.Name());
+    const auto* type = node_arg.TypeAsProto();
+    hasher.Add(type != nullptr ? type->SerializeAsString() : std::string{});
+  };
+
+  for (const NodeArg* input : partition.GetInputsIncludingInitializers()) {
+    add_node_arg(*input);
+
+    // the values of the initializers are compiled into the partition
+    const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+    if (partition.GetInitializedTensor(input->Name(), initializer)) {
+      if (initializer->has_raw_data()) {
+        hasher.Add(static_cast<int64_t>(initializer->data_type()));
+        for (int64_t dim : initializer->dims()) {
+          hasher.Add(dim);
+        }
+        hasher.Add(initializer->raw_data());
+      } else {
+        hasher.Add(initializer->SerializeAsString());
+      }
+    }
+  }
+
+  for (const NodeArg* output : partition.GetOutputs()) {
+    add_node_arg(*output);
+  }
+
+  for (NodeIndex node_index : partition.GetNodesInTopologicalOrder()) {
+    const Node& node = *partition.GetNode(node_index);
+    hasher.Add(node.OpType());
+    hasher.Add(node.Domain());
+    hasher.Add(static_cast<int64_t>(node.SinceVersion()));
+    for (const NodeArg* input : node.InputDefs()) {
+      hasher.Add(input->Exists() ? input->Name() : std::string{});
+    }
+    for (const NodeArg* output : node.OutputDefs()) {
+      hasher.Add(output->Exists() ? output->Name() : std::string{});
+    }
+
+    // the attributes are kept in a hash map, so they are hashed in the order of their names
+    std::vector<std::reference_wrapper<const ONNX_NAMESPACE::AttributeProto>> attributes;
+    for (const auto& [name, attribute] : node.GetAttributes()) {
+      attributes.push_back(std::cref(attribute));
+    }
+    std::sort(attributes.begin(), attributes.end(),
+              [](const auto& a, const auto& b) { return a.get().name() < b.get().name(); });
+    for (const auto& attribute : attributes) {
+      hasher.Add(attribute.get().SerializeAsString());
+    }
+  }
+
+  return hasher.Hex();
+}
+
+std::filesystem::path CompiledPartitionCache::GetEpDirectory(std::string_view ep_type) const {
+  auto ep_directory = directory_ / ToPathString(std::string{ep_type});
+  std::error_code error;
+  std::filesystem::create_directories(ep_directory, error);
+  return ep_directory;
+}
+
+bool CompiledPartitionCache::Load(std::string_view ep_type, const std::string& key, std::string& data) const {
+  std::ifstream file(EntryPath(GetEpDirectory(ep_type), key), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  EntryHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, kEntryMagic, sizeof(kEntryMagic)) != 0) {
+    return false;
+  }
+
+  std::string entry_data(narrow<size_t>(header.size), '\0');
+  if (!file.read(entry_data.data(), entry_data.size())) {
+    return false;
+  }
+
+  uint32_t hash[4];
+  HashData(entry_data, hash);
+  if (std::memcmp(hash, header.hash, sizeof(hash)) != 0) {
+    return false;
+  }
+
+  data = std::move(entry_data);
+  return true;
+}
+
+Status CompiledPartitionCache::Store(std::string_view ep_type, const std::string& key, std::string_view data) const {
+  const auto path = EntryPath(GetEpDirectory(ep_type), key);
+
+  EntryHeader header;
+  std::memcpy(header.magic, kEntryMagic, sizeof(kEntryMagic));
+  header.size = data.size();
+  HashData(data, header.hash);
+
+  // The entry is written to a file of its own and renamed into place, so that a session that loads the entry
+  // while another one stores it reads either the old entry or the new one.
+  auto temp_path = path;
+  temp_path += ToPathString("." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp");
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file, "Failed to open ", temp_path, " to store the compiled partition ", key);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(data.data(), data.size());
+    ORT_RETURN_IF_NOT(file, "Failed to write the compiled partition ", key, " to ", temp_path);
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to store the compiled partition ", key, " to ", path);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "core/common/status.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+/**
+   An on-disk cache of the partitions that the compiling EPs of a session compiled, shared by the sessions that point
+   kOrtSessionOptionsEpCompiledPartitionCacheDir at the same directory.
+
+   A partition is looked up by a key that identifies it, see ComputeKey(). An EP either keeps its compiled
+   partitions with Store() and Load(), or, when its compiler caches compiled models itself, passes GetEpDirectory()
+   and the key on to the compiler.
+*/
+class CompiledPartitionCache {
+ public:
+  explicit CompiledPartitionCache(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+  /**
+     The key of a partition: a hash, in 32 hex digits, of the ORT version, the EP type, the options the EP compiles
+     the partition with, and the partition itself, i.e. its nodes and attributes, its inputs and outputs with their
+     types and shapes, and its initializers. A change of any of them makes the cached partition unreachable.
+  */
+  static std::string ComputeKey(const GraphViewer& partition, std::string_view ep_type,
+                                std::string_view compile_options);
+
+  /** The directory of the cache entries of an EP. It is created if it doesn't exist. */
+  std::filesystem::path GetEpDirectory(std::string_view ep_type) const;
+
+  /**
+     Reads the compiled partition of the key into `data`.
+     Returns false if there is none, or if the entry is truncated or corrupted.
+  */
+  bool Load(std::string_view ep_type, const std::string& key, std::string& data) const;
+
+  /** Writes the compiled partition of the key, replacing the one that is there. */
+  Status Store(std::string_view ep_type, const std::string& key, std::string_view data) const;
+
+ private:
+  std::filesystem::path directory_;
+};
+
+}  // namespace onnxruntime
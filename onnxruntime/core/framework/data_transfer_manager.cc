@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/framework/data_transfer_manager.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 
@@ -129,16 +133,36 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
     return first_dt->CopyTensors(src_dst_pairs);
   }
 
-  // there are a mix of devices requiring copies. we don't expect this to happen, so just iterate the pairs
-  // copying one at a time. if this becomes expected we could create a list for each IDataTransfer instance so we
-  // batch as much as possible.
-
-  // copy the first one as we already did the IDataTransfer lookup
-  ORT_RETURN_IF_ERROR(first_pair.src_stream ? first_dt->CopyTensorAsync(first_pair.src.get(), first_pair.dst.get(), *(first_pair.src_stream))
-                                            : first_dt->CopyTensor(first_pair.src.get(), first_pair.dst.get()));
+  // there are a mix of devices requiring copies, e.g. the feeds of a session with some inputs on CPU and some on a
+  // device. group the pairs by IDataTransfer, keeping their order within each group, so each IDataTransfer can still
+  // batch its copies.
+  std::vector<std::pair<const IDataTransfer*, std::vector<IDataTransfer::SrcDstPair>>> groups;
+  groups.push_back({first_dt, {first_pair}});
 
   for (auto cur_pair = src_dst_pairs.cbegin() + 1, end_pair = src_dst_pairs.cend(); cur_pair != end_pair; ++cur_pair) {
-    ORT_RETURN_IF_ERROR(!cur_pair->src_stream ? CopyTensor(cur_pair->src, cur_pair->dst) : CopyTensorAsync(cur_pair->src, cur_pair->dst, *(cur_pair->src_stream)));
+    const OrtDevice& cur_src_device = cur_pair->src.get().Location().device;
+    const OrtDevice& cur_dst_device = cur_pair->dst.get().Location().device;
+    const IDataTransfer* data_transfer = GetDataTransfer(cur_src_device, cur_dst_device);
+    if (data_transfer == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME,
+                             FAIL,
+                             "There's no data transfer registered for copying tensors from ",
+                             cur_src_device.ToString(),
+                             " to ",
+                             cur_dst_device.ToString());
+    }
+
+    auto group = std::find_if(groups.begin(), groups.end(),
+                              [data_transfer](const auto& entry) { return entry.first == data_transfer; });
+    if (group == groups.end()) {
+      groups.push_back({data_transfer, {*cur_pair}});
+    } else {
+      group->second.push_back(*cur_pair);
+    }
+  }
+
+  for (const auto& [data_transfer, pairs] : groups) {
+    ORT_RETURN_IF_ERROR(data_transfer->CopyTensors(pairs));
   }
 
   return Status::OK();
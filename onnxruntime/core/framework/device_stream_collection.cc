@@ -1,7 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 #ifdef ORT_ENABLE_STREAM
-#include "core/framework/bfc_arena.h"
 #include "core/framework/device_stream_collection.h"
 #include "core/framework/session_state.h"
 
@@ -33,13 +32,8 @@ class DeviceStreamCollectionImpl {
   void ReleaseSingleStreamBuffers(Stream* stream) {
     if (!stream) return;
     for (auto it : allocators_) {
-      if (it.second->Info().device == stream->GetDevice() &&
-          it.second->Info().alloc_type == OrtArenaAllocator) {
-        auto* arena_alloc = static_cast<BFCArena*>(it.second.get());
-        auto* stream_aware_alloc = StreamAwareArena::FromBFCArena(*arena_alloc);
-        if (stream_aware_alloc) {
-          stream_aware_alloc->ReleaseStreamBuffers(stream);
-        }
+      if (it.second->Info().device == stream->GetDevice() && it.second->IsStreamAware()) {
+        it.second->ReleaseStreamBuffers(stream);
       }
     }
   }
@@ -14,6 +14,7 @@
 #include "core/framework/sparse_utils.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/run_allocation_report.h"
 #include "core/framework/session_state.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/utils.h"
@@ -202,6 +203,71 @@ AllocatorPtr IExecutionFrame::GetAllocator(const OrtDevice& info) const {
   return GetAllocatorImpl(info);
 }
 
+IAllocatorUniquePtr<void> IExecutionFrame::GetScratchBuffer(const OrtDevice& device, size_t bytes) {
+  if (bytes == 0) {
+    return {};
+  }
+
+  AllocatorPtr allocator = GetAllocator(device);
+  ORT_ENFORCE(allocator != nullptr, "Allocator not found for scratch buffer on device ", device.ToString());
+
+  // A device buffer released by a kernel may still be in use by the work that it queued on its stream, so only the
+  // CPU buffers are shared.
+  if (device.Type() != OrtDevice::CPU) {
+    return IAllocator::MakeUniquePtr<void>(std::move(allocator), bytes);
+  }
+
+  size_t size = bytes;
+  BufferUniquePtr buffer;
+  {
+    std::lock_guard<std::mutex> lock(scratch_buffers_mutex_);
+    // take the smallest buffer that is large enough. if none is, the largest one is replaced by a larger allocation
+    // so that the frame doesn't accumulate buffers that are too small to be used.
+    auto best = free_scratch_buffers_.end();
+    auto largest = free_scratch_buffers_.end();
+    for (auto it = free_scratch_buffers_.begin(); it != free_scratch_buffers_.end(); ++it) {
+      if (it->first >= bytes && (best == free_scratch_buffers_.end() || it->first < best->first)) {
+        best = it;
+      }
+      if (largest == free_scratch_buffers_.end() || it->first > largest->first) {
+        largest = it;
+      }
+    }
+
+    if (best != free_scratch_buffers_.end()) {
+      size = best->first;
+      buffer = std::move(best->second);
+      free_scratch_buffers_.erase(best);
+    } else if (largest != free_scratch_buffers_.end()) {
+      free_scratch_buffers_.erase(largest);
+    }
+  }
+
+  if (!buffer) {
+    void* p = allocator->Alloc(bytes);
+    ORT_ENFORCE(p != nullptr, "Failed to allocate a scratch buffer of ", bytes, " bytes.");
+    buffer = BufferUniquePtr(p, BufferDeleter(std::move(allocator)));
+  }
+
+  void* p = buffer.release();
+  BufferDeleter deleter = std::move(buffer.get_deleter());
+  return IAllocatorUniquePtr<void>{p, [this, size, deleter = std::move(deleter)](void* released) mutable {
+                                     std::lock_guard<std::mutex> lock(scratch_buffers_mutex_);
+                                     free_scratch_buffers_.emplace_back(size, BufferUniquePtr(released,
+                                                                                              std::move(deleter)));
+                                   }};
+}
+
+void IExecutionFrame::ForEachAllocatedTensor(
+    const std::function<void(int ort_value_idx, const Tensor& tensor)>& func) const {
+  for (size_t ort_value_idx = 0; ort_value_idx < all_values_size_; ++ort_value_idx) {
+    const OrtValue& value = all_values_[ort_value_idx];
+    if (value.IsAllocated() && value.IsTensor()) {
+      func(static_cast<int>(ort_value_idx), value.Get<Tensor>());
+    }
+  }
+}
+
 Status IExecutionFrame::ReleaseMLValue(int ort_value_idx) { return ReleaseMLValueImpl(ort_value_idx); }
 
 #ifdef ENABLE_TRAINING
@@ -357,7 +423,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       device_streams_(device_streams),
 #endif
       session_state_(session_state),
-      mem_patterns_(nullptr) {
+      mem_patterns_(nullptr),
+      allocation_report_(RunAllocationReport::Current()) {
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -406,17 +473,39 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
+      mem_pattern_entry_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs);
+      if (mem_pattern_entry_) {
+        mem_patterns_ = &mem_pattern_entry_->patterns;
+        // the shapes inferred for a bucket's pattern are those of the largest inputs in the bucket
+        if (!mem_pattern_entry_->inferred_shapes.empty() && !session_state.GetMemoryPatternUsesShapeBuckets()) {
+          inferred_shapes_ = &mem_pattern_entry_->inferred_shapes;
+        }
+      }
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
       } else {
+        // a frozen pattern takes over the big chunks of an earlier run if one has finished.
+        frozen_plan_ = mem_pattern_entry_->frozen_plan.get();
+        if (frozen_plan_) {
+          frozen_buffers_ = frozen_plan_->AcquireBuffers();
+          frozen_buffers_.resize(mem_patterns_->locations.size());
+        } else {
+          buffers_.reserve(mem_patterns_->locations.size());
+        }
+
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
-        buffers_.reserve(mem_patterns_->locations.size());
         for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
           const auto& location = mem_patterns_->locations[i];
           ORT_ENFORCE(buffers_.find(location) == buffers_.end());
+          if (frozen_plan_ && frozen_buffers_[i]) {
+            if (allocation_report_) {
+              allocation_report_->RecordAllocation(location, frozen_buffers_[i].get(),
+                                                   mem_patterns_->patterns[i].PeakSize(), false);
+            }
+            continue;
+          }
           if (mem_patterns_->patterns[i].PeakSize() > 0) {
             AllocatorPtr alloc = GetAllocator(location);
             void* buffer = nullptr;
@@ -457,19 +546,26 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
               // handle allocator that doesn't throw
               if (buffer == nullptr) {
                 // INFO level as this may fire on every run and there may not be much a user can do
-                LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
-                                                    << location.ToString() << " returned nullptr";
+                LOGS_HOT(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
+                                                        << location.ToString() << " returned nullptr";
               }
             }
             ORT_CATCH(const OnnxRuntimeException& ex) {
               ORT_HANDLE_EXCEPTION([&]() {
-                LOGS(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
-                                                    << location.ToString() << " failed. Error:" << ex.what();
+                LOGS_HOT(session_state_.Logger(), INFO) << "Allocation of memory pattern buffer for "
+                                                        << location.ToString() << " failed. Error:" << ex.what();
               });
             }
 
             if (buffer != nullptr) {
-              buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              if (allocation_report_) {
+                allocation_report_->RecordAllocation(location, buffer, mem_patterns_->patterns[i].PeakSize());
+              }
+              if (frozen_plan_) {
+                frozen_buffers_[i] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              } else {
+                buffers_[location] = BufferUniquePtr(buffer, BufferDeleter(alloc));
+              }
             }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
             // Record activation memory pattern
@@ -492,7 +588,23 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (allocation_report_) {
+    ForEachAllocatedTensor([this](int /*ort_value_idx*/, const Tensor& tensor) {
+      allocation_report_->RecordRelease(tensor.DataRaw());
+    });
+    for (const auto& buffer : buffers_) {
+      allocation_report_->RecordRelease(buffer.second.get());
+    }
+    for (const auto& buffer : frozen_buffers_) {
+      allocation_report_->RecordRelease(buffer.get());
+    }
+  }
+
+  if (frozen_plan_) {
+    frozen_plan_->ReleaseBuffers(std::move(frozen_buffers_));
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -539,8 +651,21 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   // try to allocate on pre-allocated big chunk.
   const auto& per_alloc_plan = GetAllocationPlan(ort_value_index);
 
-  if (mem_patterns_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
+  if (frozen_plan_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
       per_alloc_plan.alloc_kind != AllocKind::kAllocatedExternally) {
+    // the placement table of a frozen pattern replaces the lookup of the location's pattern and block.
+    const auto* placement = frozen_plan_->GetPlacement(ort_value_index);
+    if (placement && placement->size == size &&
+        mem_patterns_->locations[placement->location_index] == location) {
+      void* buffer = frozen_buffers_[placement->location_index].get();
+      if (buffer != nullptr) {
+        return AllocateTensorWithPreAllocateBufferHelper(
+            ort_value, static_cast<void*>(static_cast<char*>(buffer) + placement->offset), element_type, location,
+            shape);
+      }
+    }
+  } else if (mem_patterns_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
+             per_alloc_plan.alloc_kind != AllocKind::kAllocatedExternally) {
     auto pattern = mem_patterns_->GetPatterns(location);
     if (pattern) {
       auto block = pattern->GetBlock(ort_value_index);
@@ -548,8 +673,11 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // with shape buckets the pattern may have been planned for larger inputs, so a smaller tensor can use
+          // the start of its block.
+          if (block->size_ == size ||
+              (session_state_.GetMemoryPatternUsesShapeBuckets() && size <= block->size_)) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -560,10 +688,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
             // fed in, so use VERBOSE as the log level as it's expected.
             // TODO: Should we reuse the block if the size is large enough? Would probably need to allow it
             // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
-            LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
-                                                   << ", block in memory pattern size is: " << block->size_
-                                                   << " but the actual size is: " << size
-                                                   << ", fall back to default allocation behavior";
+            LOGS_HOT(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
+                                                       << ", block in memory pattern size is: " << block->size_
+                                                       << " but the actual size is: " << size
+                                                       << ", fall back to default allocation behavior";
           }
         }
         // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
@@ -578,13 +706,12 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
   Stream* current_stream = GetValueStream(ort_value_index);
   if (current_stream) {
 #ifdef ORT_ENABLE_STREAM
-    auto stream_aware_alloc = AsStreamBasedAllocator(alloc);
-    if (stream_aware_alloc) {
+    if (alloc->IsStreamAware()) {
       size_t buffer_size = Tensor::CalculateTensorStorageSize(element_type, shape);
       // the reused memory must from same EP
       auto wait_handle = this->session_state_.GetStreamHandleRegistryInstance().GetWaitHandle(
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
-      void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
+      void* p_data = alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
       Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
     } else {
       Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
@@ -596,6 +723,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
     Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
   }
 
+  if (allocation_report_) {
+    allocation_report_->RecordAllocation(location, ort_value.Get<Tensor>().DataRaw(), size);
+  }
+
   // trace the memory allocation.
   // don't trace the memory allocation on string tensors, as it need
   // placement new, we don't support it in memory pattern optimization.
@@ -634,6 +765,19 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
     auto buffer_num_elements = reuse_tensor->Shape().Size();
     auto required_num_elements = shape.Size();
 
+    // the planner may place an output in the freed buffer of a tensor with a larger or equal byte size but a
+    // different element type (e.g. Cast fp32 -> fp16). compare the number of bytes then.
+    if (reuse_tensor->DataType() != element_type) {
+      if (static_cast<size_t>(required_num_elements) * element_type->Size() > reuse_tensor->SizeInBytes()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Buffer of ", reuse_tensor->SizeInBytes(),
+                               " bytes is too small to be re-used for a tensor of shape ", shape,
+                               " with element size ", element_type->Size());
+      }
+
+      return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_tensor->MutableDataRaw(), element_type,
+                                                       location, shape);
+    }
+
     // check number of elements matches. shape may not be an exact match (e.g. Reshape op)
     if (buffer_num_elements != required_num_elements) {
       // could be an allocation planner bug (less likely) or the model incorrectly uses something like 'None'
@@ -770,6 +914,25 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
             ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, is_strided_tensor));
         break;
       }
+      case AllocKind::kReuseSubBuffer: {
+        int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
+        const TensorShape reuse_shape(per_alloc_plan.reused_buffer_shape);
+        ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, &reuse_shape));
+
+        auto* reuse_tensor = GetMutableMLValue(reuse_mlvalue_index).GetMutable<Tensor>();
+        const size_t offset = per_alloc_plan.reused_buffer_offset;
+        const size_t required_bytes = static_cast<size_t>(shape->Size()) * ml_data_type->Size();
+        if (reuse_tensor->DataType() != ml_data_type || offset + required_bytes > reuse_tensor->SizeInBytes()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tensor of shape ", *shape, " does not fit at byte offset ", offset,
+                                 " of the buffer of shape ", reuse_tensor->Shape(), " it is planned in. ",
+                                 "Validate usage of dim_value in shapes in the model.");
+        }
+
+        ORT_RETURN_IF_ERROR(AllocateTensorWithPreAllocateBufferHelper(
+            ort_value, static_cast<std::byte*>(reuse_tensor->MutableDataRaw()) + offset, ml_data_type, alloc_info,
+            *shape));
+        break;
+      }
       case AllocKind::kShare: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
 
@@ -875,6 +1038,12 @@ void ExecutionFrame::VerifyOutputSizes(int output_index, const Node& node, const
 
 // do not call this in ParallExecutionPlan
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
+  if (allocation_report_ && ort_value_idx != NodeIndexInfo::kInvalidEntry) {
+    const OrtValue& ort_value = GetMutableMLValue(ort_value_idx);
+    if (ort_value.IsTensor()) {
+      allocation_report_->RecordRelease(ort_value.Get<Tensor>().DataRaw());
+    }
+  }
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
   return Status::OK();
@@ -10,6 +10,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -22,6 +23,7 @@ namespace onnxruntime {
 class DataTransferManager;
 class SessionState;
 class OrtValueNameIdxMap;
+class RunAllocationReport;
 struct MemoryPatternGroup;
 class NodeIndexInfo;
 class Stream;
@@ -90,6 +92,15 @@ class IExecutionFrame {
 
   AllocatorPtr GetAllocator(const OrtDevice& info) const;
 
+  // Returns a buffer of at least `bytes` bytes on `device` for temporaries that don't outlive the caller.
+  // The CPU buffers go back to the frame when they are released and are handed out again by the requests that follow,
+  // so the kernels of a run share their workspace instead of allocating it for each Compute.
+  IAllocatorUniquePtr<void> GetScratchBuffer(const OrtDevice& device, size_t bytes);
+
+  // Call `func` with the index and the tensor of every value of the frame that holds an allocated tensor.
+  // This is for inspecting the live tensors between nodes, it must not run concurrently with a node.
+  void ForEachAllocatedTensor(const std::function<void(int ort_value_idx, const Tensor& tensor)>& func) const;
+
   Status ReleaseMLValue(int ort_value_idx);
 
  protected:
@@ -135,6 +146,10 @@ class IExecutionFrame {
   InlinedVector<int> fetch_mlvalue_idxs_;
 
   const OrtValueNameIdxMap& ort_value_idx_map_;
+
+  // The released CPU scratch buffers, with their sizes. Nodes running in parallel can request them concurrently.
+  std::mutex scratch_buffers_mutex_;
+  InlinedVector<std::pair<size_t, BufferUniquePtr>> free_scratch_buffers_;
 };
 
 class ExecutionFrame final : public IExecutionFrame {
@@ -231,6 +246,8 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
+  // mem_pattern_entry_ keeps the pattern alive while the frame uses it, as the session may evict it.
+  std::shared_ptr<const MemoryPatternCacheEntry> mem_pattern_entry_;
   const MemoryPatternGroup* mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
@@ -240,6 +257,11 @@ class ExecutionFrame final : public IExecutionFrame {
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
+  // Set if the pattern is frozen. The big chunks are then taken from, and returned to, its buffer pool and are
+  // held in frozen_buffers_ instead of buffers_.
+  const FrozenMemoryPlan* frozen_plan_{nullptr};
+  FrozenMemoryPlan::Buffers frozen_buffers_;
+
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
@@ -247,6 +269,9 @@ class ExecutionFrame final : public IExecutionFrame {
   // It is never updated after creation
   const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
 
+  // the report of the run if it records the memory the frames allocate, see RunAllocationReport.
+  RunAllocationReport* const allocation_report_;
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
   // This field is not physical memory size.
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/external_data_compression.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// A literal or match length of 15 in the token continues in the following bytes, each of which is added to it,
+// up to and including the first one that isn't 255.
+bool ReadLz4Length(const uint8_t*& ip, const uint8_t* ip_end, size_t& length) {
+  if (length != 15) {
+    return true;
+  }
+  uint8_t byte;
+  do {
+    if (ip == ip_end) {
+      return false;
+    }
+    byte = *ip++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace
+
+common::Status DecompressLz4Block(gsl::span<const char> src, gsl::span<char> dst) {
+  const uint8_t* ip = reinterpret_cast<const uint8_t*>(src.data());
+  const uint8_t* const ip_end = ip + src.size();
+  uint8_t* op = reinterpret_cast<uint8_t*>(dst.data());
+  uint8_t* const op_begin = op;
+  uint8_t* const op_end = op + dst.size();
+
+  while (ip != ip_end) {
+    const uint8_t token = *ip++;
+
+    size_t literal_length = token >> 4;
+    ORT_RETURN_IF_NOT(ReadLz4Length(ip, ip_end, literal_length), "LZ4 block is truncated.");
+    ORT_RETURN_IF(literal_length > static_cast<size_t>(ip_end - ip), "LZ4 block is truncated.");
+    ORT_RETURN_IF(literal_length > static_cast<size_t>(op_end - op),
+                  "LZ4 block decompresses to more than ", dst.size(), " bytes.");
+    std::memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // the last sequence has literals only
+    if (ip == ip_end) {
+      break;
+    }
+
+    ORT_RETURN_IF(ip_end - ip < 2, "LZ4 block is truncated.");
+    const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    ORT_RETURN_IF(offset == 0 || offset > static_cast<size_t>(op - op_begin),
+                  "LZ4 block has an invalid match offset ", offset, ".");
+
+    size_t match_length = token & 0x0F;
+    ORT_RETURN_IF_NOT(ReadLz4Length(ip, ip_end, match_length), "LZ4 block is truncated.");
+    match_length += 4;
+    ORT_RETURN_IF(match_length > static_cast<size_t>(op_end - op),
+                  "LZ4 block decompresses to more than ", dst.size(), " bytes.");
+
+    // a match may overlap the bytes it produces, e.g. an offset of 1 repeats the last byte
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      std::memcpy(op, match, match_length);
+    } else {
+      for (size_t i = 0; i < match_length; ++i) {
+        op[i] = match[i];
+      }
+    }
+    op += match_length;
+  }
+
+  ORT_RETURN_IF(op != op_end, "LZ4 block decompresses to ", op - op_begin, " bytes, expected ", dst.size(), ".");
+  return Status::OK();
+}
+
+common::Status DecompressExternalData(std::string_view compression, gsl::span<const char> src, gsl::span<char> dst) {
+  if (compression == kExternalDataCompressionLz4) {
+    return DecompressLz4Block(src, dst);
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported external data compression: ", compression);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string_view>
+
+#include <gsl/gsl>
+
+#include "core/common/status.h"
+
+namespace onnxruntime {
+
+// The value of the 'compression' key of the external data info of a tensor whose data is an LZ4 block, i.e. the
+// LZ4 block format without the frame around it.
+constexpr std::string_view kExternalDataCompressionLz4 = "lz4";
+
+// Decompresses an LZ4 block into dst. The size of dst is the size of the decompressed data, and a block that
+// decompresses to a different size, or that is malformed, is an error. The block is untrusted input: every
+// literal and match is checked against the bounds of src and dst.
+common::Status DecompressLz4Block(gsl::span<const char> src, gsl::span<char> dst);
+
+// Decompresses external data that was compressed with the given codec, see ExternalDataInfo::GetCompression().
+common::Status DecompressExternalData(std::string_view compression, gsl::span<const char> src, gsl::span<char> dst);
+
+}  // namespace onnxruntime
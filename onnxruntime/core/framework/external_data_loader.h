@@ -30,6 +30,10 @@ class IExternalDataLoader {
 
   virtual bool CanLoad(const OrtMemoryInfo& target_memory_info) const = 0;
 
+  // Returns true if LoadTensor() may be called from several threads at once, which lets a session load
+  // initializers in parallel (see kOrtSessionOptionsConfigParallelInitializerLoading).
+  virtual bool SupportsConcurrentLoads() const { return false; }
+
   // Tensor should be already allocated with the correct memory info and size.
   virtual common::Status LoadTensor(const Env& env,
                                     const std::filesystem::path& data_file_path,
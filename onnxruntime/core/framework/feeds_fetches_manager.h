@@ -100,6 +100,8 @@ class FeedsFetchesManager {
 
   const DeviceCopyChecks& GetDeviceCopyChecks() const { return device_copy_checks_; }
   void SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed, DeviceCopyCheck output_copy_needed);
+  // Forget the checks of a previous run so a manager that is reused across runs is finalized again.
+  void ResetDeviceCopyChecks() { device_copy_checks_ = DeviceCopyChecks{}; }
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <functional>
 
+#include "core/common/parse_string.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/func_kernel.h"
@@ -350,6 +351,88 @@ static Node* PlaceNode(Graph& graph, const IndexedSubGraph& capability,
   return result;
 }
 
+// Drop the capabilities that would create partitions of fewer than min_partition_size nodes, so that their nodes are
+// left to the lower priority EPs and the CPU EP instead of becoming an island that needs copies to and from the
+// device on every boundary edge. Fused capabilities are partitions on their own. Single node capabilities are grouped
+// with the other single node capabilities they are connected to, as the nodes of a group run next to each other on
+// the device.
+// A partition is only dropped when the CPU EP has a kernel for each of its nodes, so that no node is left unassigned.
+static void RemoveSmallPartitions(const Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                                  size_t min_partition_size,
+                                  std::vector<std::unique_ptr<ComputeCapability>>& capabilities,
+                                  const std::string& ep_type) {
+  const auto has_cpu_kernels = [&](gsl::span<const NodeIndex> node_indices) {
+    return std::all_of(node_indices.begin(), node_indices.end(), [&](NodeIndex node_index) {
+      const Node* node = graph.GetNode(node_index);
+      return node != nullptr &&
+             KernelRegistryManager::HasImplementationOf(kernel_registry_mgr, *node, kCpuExecutionProvider);
+    });
+  };
+
+  // union-find over the nodes of the single node capabilities
+  InlinedHashMap<NodeIndex, NodeIndex> group_of;
+  for (const auto& capability : capabilities) {
+    if (capability->sub_graph->GetMetaDef() == nullptr && capability->sub_graph->nodes.size() == 1) {
+      group_of.emplace(capability->sub_graph->nodes[0], capability->sub_graph->nodes[0]);
+    }
+  }
+
+  const auto find_group = [&group_of](NodeIndex node_index) {
+    while (group_of[node_index] != node_index) {
+      node_index = group_of[node_index] = group_of[group_of[node_index]];
+    }
+    return node_index;
+  };
+
+  for (const auto& entry : group_of) {
+    const NodeIndex node_index = entry.first;
+    const Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+      if (group_of.count(it->Index()) != 0) {
+        group_of[find_group(it->Index())] = find_group(node_index);
+      }
+    }
+  }
+
+  InlinedHashMap<NodeIndex, InlinedVector<NodeIndex>> groups;
+  for (const auto& entry : group_of) {
+    groups[find_group(entry.first)].push_back(entry.first);
+  }
+
+  InlinedHashSet<NodeIndex> dropped_nodes;
+  for (const auto& entry : groups) {
+    if (entry.second.size() < min_partition_size && has_cpu_kernels(entry.second)) {
+      dropped_nodes.insert(entry.second.begin(), entry.second.end());
+    }
+  }
+
+  size_t num_dropped = 0;
+  capabilities.erase(
+      std::remove_if(capabilities.begin(), capabilities.end(),
+                     [&](const std::unique_ptr<ComputeCapability>& capability) {
+                       const auto& nodes = capability->sub_graph->nodes;
+                       bool drop = false;
+                       if (capability->sub_graph->GetMetaDef() == nullptr && nodes.size() == 1) {
+                         drop = dropped_nodes.count(nodes[0]) != 0;
+                       } else {
+                         drop = nodes.size() < min_partition_size && has_cpu_kernels(nodes);
+                       }
+
+                       num_dropped += drop ? nodes.size() : 0;
+                       return drop;
+                     }),
+      capabilities.end());
+
+  if (num_dropped != 0) {
+    LOGS_DEFAULT(INFO) << num_dropped << " nodes in partitions of fewer than " << min_partition_size
+                       << " nodes were not assigned to " << ep_type;
+  }
+}
+
 // for the current EP, recursively iterate through the Graph and any nested subgraphs (recursion is bottom-up).
 // assign any nodes to the EP that are currently unassigned, and that the EP can handle.
 static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
@@ -359,7 +442,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
                                            GraphPartitioner::Mode mode,
                                            int& fused_node_unique_id,
                                            const layout_transformation::TransformLayoutFunction& transform_layout_fn,
-                                           const layout_transformation::DebugGraphFn& debug_graph_fn) {
+                                           const layout_transformation::DebugGraphFn& debug_graph_fn,
+                                           size_t min_partition_size) {
   // handle testing edge case where optimizers or constant lifting results in graph with no nodes.
   // doing it here saves all providers checking for this in GetCapability
   if (graph.NumberOfNodes() == 0) {
@@ -373,7 +457,7 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       // we pass through the FuncManager from the top level graph
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(*subgraph, func_mgr, kernel_registry_mgr,
                                                        fused_kernel_registry, current_ep, mode, fused_node_unique_id,
-                                                       transform_layout_fn, debug_graph_fn));
+                                                       transform_layout_fn, debug_graph_fn, min_partition_size));
     }
   }
 
@@ -399,6 +483,13 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       std::cref(debug_graph_fn)};
 
   ORT_RETURN_IF_ERROR(GetCapabilityForEP(get_capability_params));
+
+  // the nodes of an EP with a NHWC preferred layout may have been replaced by the layout transformer, and must then be
+  // taken by that EP.
+  if (min_partition_size > 1 && current_ep.GetPreferredLayout() != DataLayout::NHWC) {
+    RemoveSmallPartitions(graph, kernel_registry_mgr, min_partition_size, capabilities, current_ep.Type());
+  }
+
   if (capabilities.empty()) {
     return Status::OK();
   }
@@ -727,7 +818,8 @@ static Status CreateEpContextModel(const ExecutionProviders& execution_providers
 
 static Status PartitionOnnxFormatModel(const PartitionParams& partition_params, GraphPartitioner::Mode mode,
                                        const ExecutionProviders& execution_providers,
-                                       KernelRegistryManager& kernel_registry_manager) {
+                                       KernelRegistryManager& kernel_registry_manager,
+                                       size_t min_partition_size) {
   bool modified_graph = false;
 
   auto& graph = partition_params.graph.get();
@@ -739,10 +831,16 @@ static Status PartitionOnnxFormatModel(const PartitionParams& partition_params,
   do {
     // process full graph with each EP
     for (const auto& ep : execution_providers) {
+      // small partitions are only given back when the CPU EP can take their nodes
+      const size_t ep_min_partition_size = ep->Type() != kCpuExecutionProvider &&
+                                                   execution_providers.Get(kCpuExecutionProvider) != nullptr
+                                               ? min_partition_size
+                                               : 0;
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(graph, func_mgr, kernel_registry_manager,
                                                        fused_kernel_registry, *ep, mode, fused_node_unique_id,
                                                        transform_layout_function,
-                                                       partition_params.debug_graph_fn));
+                                                       partition_params.debug_graph_fn,
+                                                       ep_min_partition_size));
     }
 
     // expand any nodes that have an ONNX function definition but no matching ORT kernel.
@@ -977,8 +1075,14 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
 
   if (mode == Mode::kNormal || mode == Mode::kAssignOnly) {
 #if !defined(ORT_MINIMAL_BUILD)
+    size_t min_partition_size = 0;
+    const std::string min_partition_size_str =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsMinDevicePartitionSize, "0");
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(min_partition_size_str, min_partition_size),
+                      "Invalid value for ", kOrtSessionOptionsMinDevicePartitionSize, ": ", min_partition_size_str);
+
     ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode,
-                                                 providers_, kernel_registry_mgr_));
+                                                 providers_, kernel_registry_mgr_, min_partition_size));
 
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
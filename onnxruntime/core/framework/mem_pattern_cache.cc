@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+FrozenMemoryPlan::FrozenMemoryPlan(const MemoryPatternGroup& patterns) {
+  for (size_t i = 0; i < patterns.patterns.size(); ++i) {
+    for (const auto& [ort_value_index, block] : patterns.patterns[i].GetPatternsMap()) {
+      if (ort_value_index < 0) {
+        continue;
+      }
+      if (static_cast<size_t>(ort_value_index) >= placements_.size()) {
+        placements_.resize(static_cast<size_t>(ort_value_index) + 1);
+      }
+      placements_[ort_value_index] = Placement{static_cast<int>(i), block.offset_, block.size_};
+    }
+  }
+}
+
+bool FrozenMemoryPlan::CanFreeze(const MemoryPatternGroup& patterns) {
+  return !patterns.locations.empty() &&
+         std::all_of(patterns.locations.begin(), patterns.locations.end(),
+                     [](const OrtDevice& location) { return location.Type() == OrtDevice::CPU; });
+}
+
+FrozenMemoryPlan::Buffers FrozenMemoryPlan::AcquireBuffers() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (buffer_pool_.empty()) {
+    return {};
+  }
+
+  Buffers buffers = std::move(buffer_pool_.back());
+  buffer_pool_.pop_back();
+  return buffers;
+}
+
+void FrozenMemoryPlan::ReleaseBuffers(Buffers buffers) const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  buffer_pool_.push_back(std::move(buffers));
+}
+
+MemoryPatternCache::Key MemoryPatternCache::MakeKey(gsl::span<const int64_t> input_dims) const {
+  Key key(input_dims.begin(), input_dims.end());
+  if (UsesShapeBuckets()) {
+    // the ranks are not dims, so step over them
+    for (size_t i = 0; i < key.size(); i += static_cast<size_t>(key[i]) + 1) {
+      for (size_t j = i + 1, end = i + 1 + static_cast<size_t>(key[i]); j < end && j < key.size(); ++j) {
+        if (key[j] > 0) {
+          key[j] = (key[j] + bucket_size_ - 1) / bucket_size_ * bucket_size_;
+        }
+      }
+    }
+  }
+  return key;
+}
+
+bool MemoryPatternCache::CanServe(gsl::span<const int64_t> entry_dims, gsl::span<const int64_t> input_dims) const {
+  if (entry_dims.size() != input_dims.size()) {
+    return false;
+  }
+
+  if (!UsesShapeBuckets()) {
+    return std::equal(entry_dims.begin(), entry_dims.end(), input_dims.begin());
+  }
+
+  // same key means the ranks match, so comparing the ranks with <= is harmless
+  for (size_t i = 0; i < entry_dims.size(); ++i) {
+    if (input_dims[i] > entry_dims[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Find(gsl::span<const int64_t> input_dims) const {
+  const Key key = MakeKey(input_dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  const auto& entry = it->second->second;
+  if (!CanServe(entry->input_dims, input_dims)) {
+    return nullptr;
+  }
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return entry;
+}
+
+std::shared_ptr<const MemoryPatternCacheEntry> MemoryPatternCache::Insert(
+    gsl::span<const int64_t> input_dims,
+    MemoryPatternGroup patterns,
+    InlinedHashMap<int, TensorShape> inferred_shapes) {
+  Key key = MakeKey(input_dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    if (CanServe(it->second->second->input_dims, input_dims)) {
+      // Do not update if present. Concurrent runs may have generated a pattern for the same inputs.
+      return it->second->second;
+    }
+  }
+
+  auto entry = std::make_shared<MemoryPatternCacheEntry>();
+  entry->patterns = std::move(patterns);
+  entry->inferred_shapes = std::move(inferred_shapes);
+  entry->input_dims.assign(input_dims.begin(), input_dims.end());
+  if (freeze_patterns_ && !UsesShapeBuckets() && FrozenMemoryPlan::CanFreeze(entry->patterns)) {
+    entry->frozen_plan = std::make_unique<const FrozenMemoryPlan>(entry->patterns);
+  }
+
+  if (it != entries_.end()) {
+    // a larger shape in the bucket. frames using the previous entry keep it alive until they are done.
+    it->second->second = entry;
+    return entry;
+  }
+
+  lru_.emplace_front(key, entry);
+  entries_.emplace(std::move(key), lru_.begin());
+
+  while (max_entries_ != 0 && lru_.size() > max_entries_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+
+  return entry;
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return lru_.size();
+}
+
+}  // namespace onnxruntime
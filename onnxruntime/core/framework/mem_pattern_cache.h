@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// A memory pattern frozen for repeated runs with the same input shapes: the block of every planned value in a
+// table indexed by OrtValue index, and a pool of pattern buffers that execution frames take over from earlier runs
+// instead of allocating their own.
+//
+// Only patterns whose locations are all CPU memory can be frozen, as the buffers of other devices may be tied to a
+// stream.
+//
+// Thread-safe.
+class FrozenMemoryPlan {
+ public:
+  struct Placement {
+    // index into MemoryPatternGroup::locations. -1 if the value is not planned in the pattern.
+    int location_index = -1;
+    size_t offset = 0;
+    size_t size = 0;
+  };
+
+  // The buffer for each location of the pattern, in the order of MemoryPatternGroup::locations.
+  // An entry is null if no buffer exists for that location.
+  using Buffers = InlinedVector<BufferUniquePtr>;
+
+  explicit FrozenMemoryPlan(const MemoryPatternGroup& patterns);
+
+  static bool CanFreeze(const MemoryPatternGroup& patterns);
+
+  // Returns the placement of the value, or nullptr if the value is not planned in the pattern.
+  const Placement* GetPlacement(int ort_value_index) const {
+    return ort_value_index >= 0 && static_cast<size_t>(ort_value_index) < placements_.size() &&
+                   placements_[ort_value_index].location_index >= 0
+               ? &placements_[ort_value_index]
+               : nullptr;
+  }
+
+  // Takes a set of buffers released by an earlier run. Returns an empty set if there is none.
+  Buffers AcquireBuffers() const;
+
+  void ReleaseBuffers(Buffers buffers) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FrozenMemoryPlan);
+
+  std::vector<Placement> placements_;
+
+  mutable OrtMutex mutex_;
+  mutable std::vector<Buffers> buffer_pool_;
+};
+
+// The memory pattern generated for one set of input shapes, together with the shapes that were inferred
+// while generating it (training builds only).
+struct MemoryPatternCacheEntry {
+  MemoryPatternGroup patterns;
+  InlinedHashMap<int, TensorShape> inferred_shapes;
+  // Input shapes the pattern was generated with, encoded as described in MemoryPatternCache.
+  InlinedVector<int64_t> input_dims;
+  // Set if the cache freezes its patterns and this one can be frozen.
+  std::unique_ptr<const FrozenMemoryPlan> frozen_plan;
+};
+
+// Cache of the memory patterns of a session, keyed by input shapes.
+//
+// Input shapes are passed in as a flat list: for every input its rank followed by its dims.
+//
+// If bucket_size is greater than 1, every dim is rounded up to a multiple of bucket_size to form the key, so inputs
+// with e.g. a sequence length of 100 and 120 share the pattern of bucket 128. A pattern can serve every input whose
+// dims are not larger than the dims it was generated with, with tensors smaller than their planned block using
+// part of it. When larger inputs show up in a bucket, a new pattern is generated and replaces the old one, so the
+// resident pattern converges to the largest shape seen in the bucket.
+//
+// If max_entries is not 0, at most max_entries patterns are kept and the least recently used one is evicted.
+// Entries are reference counted so an execution frame can keep using an evicted pattern until it is done.
+//
+// If freeze_patterns is true and shape buckets are not used, a FrozenMemoryPlan is created for every pattern that
+// can be frozen.
+//
+// Thread-safe.
+class MemoryPatternCache {
+ public:
+  explicit MemoryPatternCache(size_t max_entries = 0, int64_t bucket_size = 0, bool freeze_patterns = false)
+      : max_entries_(max_entries), bucket_size_(bucket_size), freeze_patterns_(freeze_patterns) {}
+
+  // Returns the pattern that can serve 'input_dims', or nullptr.
+  std::shared_ptr<const MemoryPatternCacheEntry> Find(gsl::span<const int64_t> input_dims) const;
+
+  // Adds the pattern generated for 'input_dims' and returns the resident entry for these inputs.
+  // An existing entry is only replaced if it can't serve 'input_dims'.
+  std::shared_ptr<const MemoryPatternCacheEntry> Insert(gsl::span<const int64_t> input_dims,
+                                                        MemoryPatternGroup patterns,
+                                                        InlinedHashMap<int, TensorShape> inferred_shapes = {});
+
+  // Whether a pattern may be used for inputs smaller than the ones it was generated with.
+  bool UsesShapeBuckets() const { return bucket_size_ > 1; }
+
+  size_t Size() const;
+
+ private:
+  using Key = InlinedVector<int64_t>;
+  using LruList = std::list<std::pair<Key, std::shared_ptr<const MemoryPatternCacheEntry>>>;
+
+  Key MakeKey(gsl::span<const int64_t> input_dims) const;
+
+  // Whether the pattern generated for 'entry_dims' can serve 'input_dims'. Both must have the same key.
+  bool CanServe(gsl::span<const int64_t> entry_dims, gsl::span<const int64_t> input_dims) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  const size_t max_entries_;
+  const int64_t bucket_size_;
+  const bool freeze_patterns_;
+
+  mutable OrtMutex mutex_;
+  // most recently used first
+  mutable LruList lru_;
+  std::map<Key, LruList::iterator> entries_;
+};
+
+}  // namespace onnxruntime
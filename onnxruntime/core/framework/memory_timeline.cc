@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_timeline.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/allocator_stats.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+namespace {
+
+std::string DeviceLabel(const OrtMemoryInfo& info) {
+  return MakeString(info.name, ":", info.id);
+}
+
+bool RunsOnSingleStream(const SequentialExecutionPlan& plan) {
+  size_t num_streams = 0;
+  for (const auto& stream : plan.execution_plan) {
+    if (stream && !stream->steps_.empty()) {
+      ++num_streams;
+    }
+  }
+  return num_streams <= 1;
+}
+
+}  // namespace
+
+MemoryTimeline::MemoryTimeline(const SessionState& session_state, const IExecutionFrame& frame)
+    : session_state_(session_state),
+      frame_(frame),
+      record_live_tensors_(RunsOnSingleStream(*session_state.GetExecutionPlan())) {
+  // only the extensions made during this execution are attributed to its nodes
+  for (const auto& entry : session_state_.GetAllocators()) {
+    AllocatorStats stats;
+    entry.second->GetStats(&stats);
+    num_arena_extensions_[DeviceLabel(entry.second->Info())] = stats.num_arena_extensions;
+  }
+}
+
+void MemoryTimeline::RecordNode(const std::string& node_name, const std::string& op_type) {
+  auto& profiler = session_state_.Profiler();
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  std::vector<std::pair<std::string, int64_t>> bytes_in_use;
+  for (const auto& entry : session_state_.GetAllocators()) {
+    AllocatorStats stats;
+    entry.second->GetStats(&stats);
+    const std::string device = DeviceLabel(entry.second->Info());
+    bytes_in_use.emplace_back(device, stats.bytes_in_use);
+
+    auto& num_arena_extensions = num_arena_extensions_[device];
+    if (stats.num_arena_extensions > num_arena_extensions) {
+      auto start_time = profiler.Start();
+      profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT, node_name + "_arena_extend", start_time,
+                                     {{"op_name", op_type},
+                                      {"device", device},
+                                      {"extensions", std::to_string(stats.num_arena_extensions -
+                                                                    num_arena_extensions)},
+                                      {"total_allocated_bytes", std::to_string(stats.total_allocated_bytes)}});
+      num_arena_extensions = stats.num_arena_extensions;
+    }
+  }
+  profiler.RecordCounterEvent("allocator_bytes_in_use", bytes_in_use);
+
+  if (!record_live_tensors_) {
+    return;
+  }
+
+  const auto& initializers = session_state_.GetInitializedTensors();
+  const auto& allocation_plan = session_state_.GetExecutionPlan()->allocation_plan;
+
+  // values that reuse or share the buffer of another value are counted once
+  std::unordered_set<const void*> buffers;
+  std::map<std::string, int64_t> device_bytes;
+  std::vector<std::pair<int, const Tensor*>> live_tensors;
+  size_t total_bytes = 0;
+  frame_.ForEachAllocatedTensor([&](int ort_value_idx, const Tensor& tensor) {
+    if (initializers.count(ort_value_idx) != 0 || !buffers.insert(tensor.DataRaw()).second) {
+      return;
+    }
+    device_bytes[DeviceLabel(tensor.Location())] += static_cast<int64_t>(tensor.SizeInBytes());
+    total_bytes += tensor.SizeInBytes();
+    live_tensors.emplace_back(ort_value_idx, &tensor);
+  });
+  profiler.RecordCounterEvent("live_tensor_bytes",
+                              std::vector<std::pair<std::string, int64_t>>(device_bytes.begin(), device_bytes.end()));
+
+  if (total_bytes <= peak_bytes_) {
+    return;
+  }
+
+  peak_bytes_ = total_bytes;
+  peak_node_ = node_name;
+  peak_op_type_ = op_type;
+
+  const size_t num_peak_tensors = std::min(kNumPeakTensors, live_tensors.size());
+  std::partial_sort(live_tensors.begin(), live_tensors.begin() + num_peak_tensors, live_tensors.end(),
+                    [](const auto& a, const auto& b) { return a.second->SizeInBytes() > b.second->SizeInBytes(); });
+
+  peak_tensors_.clear();
+  for (size_t i = 0; i < num_peak_tensors; ++i) {
+    const int ort_value_idx = live_tensors[i].first;
+    const Tensor& tensor = *live_tensors[i].second;
+    LiveTensor live_tensor{{}, DeviceLabel(tensor.Location()), AllocKind::kNotSet, tensor.SizeInBytes()};
+    ORT_IGNORE_RETURN_VALUE(session_state_.GetOrtValueNameIdxMap().GetName(ort_value_idx, live_tensor.name));
+    if (static_cast<size_t>(ort_value_idx) < allocation_plan.size()) {
+      live_tensor.alloc_kind = allocation_plan[ort_value_idx].alloc_kind;
+    }
+    peak_tensors_.push_back(std::move(live_tensor));
+  }
+}
+
+void MemoryTimeline::ReportPeak() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (peak_bytes_ == 0) {
+    return;
+  }
+
+  std::ostringstream tensors_json;
+  std::ostringstream report;
+  tensors_json << "[";
+  report << "Tensors live at the memory peak of " << peak_bytes_ << " bytes after node " << peak_node_
+         << " (" << peak_op_type_ << "):";
+  for (size_t i = 0; i < peak_tensors_.size(); ++i) {
+    const auto& tensor = peak_tensors_[i];
+    tensors_json << (i > 0 ? "," : "")
+                 << "{\"name\":\"" << tensor.name << "\",\"device\":\"" << tensor.device
+                 << "\",\"alloc_kind\":\"" << tensor.alloc_kind << "\",\"bytes\":" << tensor.bytes << "}";
+    report << "\n  " << tensor.name << ": " << tensor.bytes << " bytes ("
+           << (100.0 * static_cast<double>(tensor.bytes) / static_cast<double>(peak_bytes_)) << "%) on "
+           << tensor.device << ", " << tensor.alloc_kind;
+  }
+  tensors_json << "]";
+
+  auto& profiler = session_state_.Profiler();
+  auto start_time = profiler.Start();
+  profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "memory_peak", start_time,
+                                 {{"peak_bytes", std::to_string(peak_bytes_)},
+                                  {"node_name", peak_node_},
+                                  {"op_name", peak_op_type_},
+                                  {"top_tensors", tensors_json.str()}});
+
+  LOGS(session_state_.Logger(), INFO) << report.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/alloc_kind.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class IExecutionFrame;
+class SessionState;
+
+// Records the memory timeline of one execution of a graph to the session profiler
+// (kOrtSessionOptionsConfigProfileMemory).
+//
+// After every node the bytes of the live tensors of the execution frame and the bytes in use of every allocator are
+// recorded per device as counter events, and the arena extensions caused by the node as node events. The live
+// tensors are those held by the frame when the node completes, i.e. its inputs have not been released yet, so the
+// peak includes the inputs and the outputs of the node that needed them at the same time.
+//
+// The tensors of the frame are only inspected when the graph runs on a single stream, as the values of the other
+// streams may be changing concurrently. With several streams only the allocator counters are recorded.
+class MemoryTimeline {
+ public:
+  // The number of tensors reported as the top contributors at the peak.
+  static constexpr size_t kNumPeakTensors = 10;
+
+  MemoryTimeline(const SessionState& session_state, const IExecutionFrame& frame);
+
+  // Record the memory after the node named `node_name` (the name of its profiler events) was computed.
+  void RecordNode(const std::string& node_name, const std::string& op_type);
+
+  // Record the tensors that were live at the peak in a "memory_peak" session event and log them.
+  void ReportPeak();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryTimeline);
+
+  struct LiveTensor {
+    std::string name;
+    std::string device;
+    AllocKind alloc_kind;
+    size_t bytes;
+  };
+
+  const SessionState& session_state_;
+  const IExecutionFrame& frame_;
+  const bool record_live_tensors_;
+
+  OrtMutex mutex_;
+  // arena extensions of every allocator already recorded, by device label
+  std::map<std::string, int64_t> num_arena_extensions_;
+
+  size_t peak_bytes_{0};
+  std::string peak_node_;
+  std::string peak_op_type_;
+  // the largest kNumPeakTensors tensors live at the peak, largest first
+  std::vector<LiveTensor> peak_tensors_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/numa_allocator.h"
+
+#include "core/common/safeint.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+namespace {
+// Precedes the memory returned to the caller. Keeps the returned pointer aligned like the default CPU allocator.
+struct alignas(64) AllocationHeader {
+  // size of the whole mapping, 0 if the memory came from the default CPU allocator
+  size_t mapping_size;
+};
+}  // namespace
+
+NumaAllocator::NumaAllocator(int numa_node)
+    : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)), numa_node_(numa_node) {
+  ORT_ENFORCE(numa_node >= 0, "Invalid NUMA node: ", numa_node);
+}
+
+void* NumaAllocator::Alloc(size_t size) {
+  const size_t mapping_size = SafeInt<size_t>(size) + sizeof(AllocationHeader);
+  void* mapping = Env::Default().AllocateOnNumaNode(mapping_size, numa_node_);
+  size_t recorded_size = mapping_size;
+  if (mapping == nullptr) {
+    mapping = AllocatorDefaultAlloc(mapping_size);
+    recorded_size = 0;
+  }
+
+  auto* header = static_cast<AllocationHeader*>(mapping);
+  header->mapping_size = recorded_size;
+  return header + 1;
+}
+
+void NumaAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  auto* header = static_cast<AllocationHeader*>(p) - 1;
+  if (header->mapping_size == 0) {
+    AllocatorDefaultFree(header);
+  } else {
+    Env::Default().FreeOnNumaNode(header, header->mapping_size);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+// A CPU allocator whose memory is placed on one NUMA node (mbind on Linux, VirtualAllocExNuma on Windows).
+//
+// Every allocation is a separate mapping from the OS, so this is meant to be used as the device allocator of an
+// arena, which requests memory in large regions. If the memory can't be placed on the node (e.g. the platform doesn't
+// support it), the allocation falls back to the default CPU allocator.
+class NumaAllocator : public IAllocator {
+ public:
+  explicit NumaAllocator(int numa_node);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  int NumaNode() const { return numa_node_; }
+
+ private:
+  const int numa_node_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaAllocator);
+};
+
+}  // namespace onnxruntime
@@ -186,6 +186,10 @@ AllocatorPtr OpKernelContext::GetAllocator(const OrtDevice& device) const {
   return execution_frame_->GetAllocator(device);
 }
 
+IAllocatorUniquePtr<void> OpKernelContext::GetScratchBuffer(size_t bytes) const {
+  return execution_frame_->GetScratchBuffer(kernel_->GetDevice(OrtMemTypeDefault), bytes);
+}
+
 #ifdef ENABLE_ATEN
 Status OpKernelContext::SetOutputMLValue(int index, const OrtValue& ort_value) {
   if (index < 0 || index >= OutputCount()) {
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#ifdef ORT_ENABLE_STREAM
+#include "core/framework/pinned_staging.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/session_state.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+// Smaller copies are about as fast from and to pageable memory.
+constexpr size_t kMinStagedBytes = 64 * 1024;
+// Size of the chunks an upload is split in, the upload of a chunk overlaps the staging of the next one.
+constexpr size_t kUploadChunkBytes = 4 * 1024 * 1024;
+// Bytes copied on the host by each thread of the intra-op thread pool.
+constexpr size_t kHostCopyBlockBytes = 256 * 1024;
+
+AllocatorPtr FindPinnedAllocator(const SessionState& session_state) {
+  for (const auto mem_type : {OrtDevice::MemType::CUDA_PINNED, OrtDevice::MemType::HIP_PINNED,
+                              OrtDevice::MemType::CANN_PINNED}) {
+    auto allocator = session_state.GetAllocator(OrtDevice(OrtDevice::CPU, mem_type, 0));
+    if (allocator) {
+      return allocator;
+    }
+  }
+  return nullptr;
+}
+
+bool IsPageableCpu(const OrtDevice& device) {
+  return device.Type() == OrtDevice::CPU && device.MemType() == OrtDevice::MemType::DEFAULT;
+}
+}  // namespace
+
+PinnedStaging::PinnedStaging(const SessionState& session_state) : session_state_(session_state) {
+  if (session_state.GetSessionOptions().config_options.GetConfigOrDefault(
+          kOrtSessionOptionsConfigStageCopiesInPinnedMemory, "0") == "1") {
+    pinned_allocator_ = FindPinnedAllocator(session_state);
+  }
+}
+
+PinnedStaging::~PinnedStaging() {
+  // a run that failed may still have transfers in flight from or to the staging buffers
+  for (auto& transfer : transfers_) {
+    WaitFor(transfer);
+  }
+}
+
+bool PinnedStaging::ShouldStage(const Tensor& src, const OrtDevice& dst_device, const Stream* stream) const {
+  if (!pinned_allocator_ || stream == nullptr || stream->GetDevice().Type() == OrtDevice::CPU ||
+      src.IsDataTypeString() || src.SizeInBytes() < kMinStagedBytes) {
+    return false;
+  }
+
+  const OrtDevice& src_device = src.Location().device;
+  const OrtDevice& pinned_device = pinned_allocator_->Info().device;
+  const auto& data_transfer_mgr = session_state_.GetDataTransferMgr();
+  if (IsPageableCpu(src_device) && dst_device.Type() != OrtDevice::CPU) {
+    return data_transfer_mgr.GetDataTransfer(pinned_device, dst_device) != nullptr;
+  }
+  if (IsPageableCpu(dst_device) && src_device.Type() != OrtDevice::CPU) {
+    return data_transfer_mgr.GetDataTransfer(src_device, pinned_device) != nullptr;
+  }
+  return false;
+}
+
+PinnedStaging::Transfer& PinnedStaging::AddTransfer(const Tensor& tensor, Tensor* dst, Stream& stream) {
+  Transfer transfer{};
+  Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), pinned_allocator_, transfer.staging);
+  transfer.dst = dst;
+  transfer.stream = &stream;
+  transfers_.push_back(std::move(transfer));
+  return transfers_.back();
+}
+
+Status PinnedStaging::Upload(const Tensor& src, Tensor& dst, Stream& stream) {
+  auto& transfer = AddTransfer(src, nullptr, stream);
+  Tensor& staging = *transfer.staging.GetMutable<Tensor>();
+
+  const auto* src_data = static_cast<const char*>(src.DataRaw());
+  auto* staging_data = static_cast<char*>(staging.MutableDataRaw());
+  auto* dst_data = static_cast<char*>(dst.MutableDataRaw());
+  const size_t bytes = src.SizeInBytes();
+  const auto byte_type = DataTypeImpl::GetType<uint8_t>();
+  for (size_t offset = 0; offset < bytes; offset += kUploadChunkBytes) {
+    const size_t chunk_bytes = std::min(kUploadChunkBytes, bytes - offset);
+    CopyOnHost(staging_data + offset, src_data + offset, chunk_bytes);
+
+    const TensorShape chunk_shape({static_cast<int64_t>(chunk_bytes)});
+    const Tensor staged_chunk(byte_type, chunk_shape, staging_data + offset, staging.Location());
+    Tensor dst_chunk(byte_type, chunk_shape, dst_data + offset, dst.Location());
+    ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensorAsync(staged_chunk, dst_chunk, stream));
+  }
+
+  transfer.done = stream.CreateNotification(1);
+  if (transfer.done) {
+    transfer.done->ActivateAndUpdate();
+  }
+  return Status::OK();
+}
+
+Status PinnedStaging::Download(const Tensor& src, Tensor& dst, Stream& stream) {
+  ORT_RETURN_IF_NOT(src.SizeInBytes() == dst.SizeInBytes(), "Size mismatch copying ", src.SizeInBytes(),
+                    " bytes to a buffer of ", dst.SizeInBytes(), " bytes.");
+  auto& transfer = AddTransfer(src, &dst, stream);
+  ORT_RETURN_IF_ERROR(session_state_.GetDataTransferMgr().CopyTensorAsync(
+      src, *transfer.staging.GetMutable<Tensor>(), stream));
+
+  transfer.done = stream.CreateNotification(1);
+  if (transfer.done) {
+    transfer.done->ActivateAndUpdate();
+  }
+  return Status::OK();
+}
+
+Status PinnedStaging::Finish() {
+  for (auto& transfer : transfers_) {
+    WaitFor(transfer);
+    if (transfer.dst != nullptr) {
+      const Tensor& staging = transfer.staging.Get<Tensor>();
+      CopyOnHost(transfer.dst->MutableDataRaw(), staging.DataRaw(), staging.SizeInBytes());
+    }
+    // the staging buffer can be reused
+    transfer.staging = OrtValue();
+  }
+  transfers_.clear();
+  return Status::OK();
+}
+
+void PinnedStaging::WaitFor(Transfer& transfer) const {
+  if (transfer.done) {
+    // the streams of the devices wait for their notifications on the host without using the waiting stream
+    auto wait_on_host = session_state_.GetStreamHandleRegistryInstance().GetWaitHandle(
+        transfer.stream->GetDevice().Type(), OrtDevice::CPU);
+    if (wait_on_host) {
+      wait_on_host(*transfer.stream, *transfer.done);
+      transfer.done.reset();
+      return;
+    }
+  }
+  transfer.stream->Flush();
+  transfer.done.reset();
+}
+
+void PinnedStaging::CopyOnHost(void* dst, const void* src, size_t bytes) const {
+  if (bytes < 2 * kHostCopyBlockBytes) {
+    std::memcpy(dst, src, bytes);
+    return;
+  }
+
+  auto* dst_bytes = static_cast<char*>(dst);
+  const auto* src_bytes = static_cast<const char*>(src);
+  const auto num_blocks = static_cast<std::ptrdiff_t>((bytes + kHostCopyBlockBytes - 1) / kHostCopyBlockBytes);
+  concurrency::ThreadPool::TryParallelFor(
+      session_state_.GetThreadPool(), num_blocks,
+      TensorOpCost{static_cast<double>(kHostCopyBlockBytes), static_cast<double>(kHostCopyBlockBytes), 0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const size_t begin = static_cast<size_t>(first) * kHostCopyBlockBytes;
+        const size_t end = std::min(bytes, static_cast<size_t>(last) * kHostCopyBlockBytes);
+        std::memcpy(dst_bytes + begin, src_bytes + begin, end - begin);
+      });
+}
+
+}  // namespace onnxruntime
+#endif
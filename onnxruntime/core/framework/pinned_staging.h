@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#ifdef ORT_ENABLE_STREAM
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/stream_handles.h"
+
+namespace onnxruntime {
+class SessionState;
+class Tensor;
+
+// Copies the CPU inputs and outputs of a run from and to a device through buffers of pinned memory allocated by the
+// device's execution provider (kOrtSessionOptionsConfigStageCopiesInPinnedMemory), so the transfers are asynchronous
+// instead of the blocking copies from and to pageable memory.
+// Uploads are staged in chunks, the upload of a chunk overlaps the staging of the next one. Downloads are all queued
+// first, then each one is waited for and copied to its destination while the following ones are in flight.
+// An instance lives for the copies of one run. The staging buffers are released once the transfers using them are
+// done, see Finish().
+class PinnedStaging {
+ public:
+  explicit PinnedStaging(const SessionState& session_state);
+  ~PinnedStaging();
+
+  // Whether the copy of src to dst_device on stream is staged.
+  bool ShouldStage(const Tensor& src, const OrtDevice& dst_device, const Stream* stream) const;
+
+  // Stages src, a tensor in pageable CPU memory, and queues its upload to the device tensor dst on stream.
+  common::Status Upload(const Tensor& src, Tensor& dst, Stream& stream);
+
+  // Queues the download of the device tensor src on stream. dst, in pageable CPU memory, is written by Finish().
+  common::Status Download(const Tensor& src, Tensor& dst, Stream& stream);
+
+  // Copies the downloads to their destinations, in the order they were queued, and waits for the uploads to be done
+  // with their staging buffers.
+  common::Status Finish();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PinnedStaging);
+
+  struct Transfer {
+    OrtValue staging;
+    // destination of a download, nullptr for an upload
+    Tensor* dst;
+    Stream* stream;
+    // activated on the stream after the transfer, nullptr if the stream has no notifications
+    std::unique_ptr<synchronize::Notification> done;
+  };
+
+  Transfer& AddTransfer(const Tensor& tensor, Tensor* dst, Stream& stream);
+  void WaitFor(Transfer& transfer) const;
+  void CopyOnHost(void* dst, const void* src, size_t bytes) const;
+
+  const SessionState& session_state_;
+  AllocatorPtr pinned_allocator_;
+  std::vector<Transfer> transfers_;
+};
+
+}  // namespace onnxruntime
+#endif
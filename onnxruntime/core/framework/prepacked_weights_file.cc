@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <system_error>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
+#include "core/platform/env.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+// File layout, in native byte order:
+//   magic, format version, layout tag, number of entries,
+//   for each entry: key, initializer hash, number of buffers, (offset, size) of each buffer,
+//   buffer data, each at a kDataAlignment aligned offset from the start of the file.
+// Strings are saved as their length followed by their characters.
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'R', 'E', 'P', 'K'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kDataAlignment = 64;
+
+void WriteU64(std::ostream& out, uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ostream& out, const std::string& value) {
+  WriteU64(out, value.size());
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool ReadU64(std::istream& in, uint64_t& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool ReadString(std::istream& in, std::string& value) {
+  uint64_t size = 0;
+  // guards against reading a huge length from a corrupt file
+  if (!ReadU64(in, size) || size > (1 << 20)) return false;
+  value.resize(static_cast<size_t>(size));
+  return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+}
+
+uint64_t AlignData(uint64_t offset) {
+  return (offset + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+}  // namespace
+
+std::string PrepackedWeightsFile::GetLayoutTag() {
+  const auto& cpu = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream tag;
+  tag << "ort=" << ORT_VERSION << ";arch=";
+#if defined(_M_X64) || defined(__x86_64__)
+  tag << "x64";
+#elif defined(_M_IX86) || defined(__i386__)
+  tag << "x86";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+  tag << "arm64";
+#else
+  tag << "other";
+#endif
+  // the features MLAS dispatches its packing and compute kernels on
+  tag << ";isa=" << cpu.HasAVX() << cpu.HasAVX2() << cpu.HasAVX512f() << cpu.HasAVX512Skylake()
+      << cpu.HasAVX512_BF16() << cpu.HasAMX_BF16() << cpu.HasArmNeonDot() << cpu.HasArmNeon_I8MM()
+      << cpu.HasArmSVE_I8MM() << cpu.HasArmNeon_BF16() << cpu.HasFp16VectorAcceleration();
+  return tag.str();
+}
+
+HashValue PrepackedWeightsFile::HashTensorData(const Tensor& tensor) {
+  ORT_ENFORCE(!tensor.IsDataTypeString(), "Pre-packed weights of string tensors are not supported");
+  uint32_t hash[4] = {0, 0, 0, 0};
+  const auto* data = static_cast<const char*>(tensor.DataRaw());
+  size_t remaining = tensor.SizeInBytes();
+  // MurmurHash3 takes an int length, so large tensors are hashed in chunks seeded with the previous hash
+  constexpr size_t kChunkBytes = 1 << 30;
+  do {
+    const size_t chunk = std::min(remaining, kChunkBytes);
+    MurmurHash3::x86_128(data, static_cast<int>(chunk), hash[0], &hash);
+    data += chunk;
+    remaining -= chunk;
+  } while (remaining > 0);
+  return static_cast<HashValue>(hash[0]) | (static_cast<HashValue>(hash[1]) << 32);
+}
+
+Status PrepackedWeightsFile::Load(const std::filesystem::path& path) {
+  entries_.clear();
+
+  std::ifstream in(path, std::ios::binary);
+  ORT_RETURN_IF_NOT(in, "Failed to open pre-packed weights file: ", path.string());
+
+  char magic[sizeof(kMagic)] = {};
+  uint64_t format_version = 0;
+  std::string tag;
+  uint64_t num_entries = 0;
+  in.read(magic, sizeof(magic));
+  ORT_RETURN_IF_NOT(in && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0 && ReadU64(in, format_version) &&
+                        format_version == kFormatVersion && ReadString(in, tag),
+                    "Not a pre-packed weights file: ", path.string());
+  ORT_RETURN_IF_NOT(tag == GetLayoutTag(), "Pre-packed weights file ", path.string(), " was saved for '", tag,
+                    "', which differs from this build and CPU: '", GetLayoutTag(), "'");
+  ORT_RETURN_IF_NOT(ReadU64(in, num_entries), "Malformed pre-packed weights file: ", path.string());
+
+  std::error_code error;
+  const uint64_t file_size = std::filesystem::file_size(path, error);
+  ORT_RETURN_IF(error, "Failed to get the size of pre-packed weights file: ", path.string());
+
+  Env::MappedMemoryPtr mapped_memory;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(path.native().c_str(), 0, static_cast<size_t>(file_size),
+                                                       mapped_memory));
+  // every buffer's deleter shares the mapping, so the file stays mapped while any buffer is in use
+  std::shared_ptr<char[]> mapping = std::move(mapped_memory);
+
+  std::map<std::string, Entry> entries;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    std::string key;
+    Entry entry;
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_NOT(ReadString(in, key) && ReadU64(in, entry.initializer_hash) && ReadU64(in, num_buffers) &&
+                          num_buffers < 1024,
+                      "Malformed pre-packed weights file: ", path.string());
+    for (uint64_t b = 0; b < num_buffers; ++b) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_NOT(ReadU64(in, offset) && ReadU64(in, size) && offset <= file_size && size <= file_size - offset,
+                        "Malformed pre-packed weights file: ", path.string());
+      if (size == 0) {
+        // place-holder buffer
+        entry.weights.buffers_.emplace_back(nullptr, [](void*) {});
+      } else {
+        entry.weights.buffers_.emplace_back(mapping.get() + offset, [mapping](void*) {});
+      }
+      entry.weights.buffer_sizes_.push_back(static_cast<size_t>(size));
+    }
+    entries.insert_or_assign(std::move(key), std::move(entry));
+  }
+
+  entries_ = std::move(entries);
+  return Status::OK();
+}
+
+Status PrepackedWeightsFile::Save(const std::filesystem::path& path) const {
+  // header size, to place the buffer data after it
+  std::ostringstream header;
+  header.write(kMagic, sizeof(kMagic));
+  WriteU64(header, kFormatVersion);
+  WriteString(header, GetLayoutTag());
+  WriteU64(header, entries_.size());
+  uint64_t data_size = 0;
+  for (const auto& [key, entry] : entries_) {
+    WriteString(header, key);
+    WriteU64(header, entry.initializer_hash);
+    WriteU64(header, entry.weights.buffers_.size());
+    for (size_t b = 0; b < entry.weights.buffers_.size(); ++b) {
+      WriteU64(header, 0);
+      WriteU64(header, 0);
+    }
+  }
+  const uint64_t data_start = AlignData(static_cast<uint64_t>(header.tellp()));
+
+  // the same layout with the real offsets
+  header.seekp(0);
+  header.write(kMagic, sizeof(kMagic));
+  WriteU64(header, kFormatVersion);
+  WriteString(header, GetLayoutTag());
+  WriteU64(header, entries_.size());
+  for (const auto& [key, entry] : entries_) {
+    WriteString(header, key);
+    WriteU64(header, entry.initializer_hash);
+    WriteU64(header, entry.weights.buffers_.size());
+    for (size_t b = 0; b < entry.weights.buffers_.size(); ++b) {
+      const bool is_placeholder = entry.weights.buffers_[b] == nullptr;
+      const uint64_t size = is_placeholder ? 0 : entry.weights.buffer_sizes_[b];
+      WriteU64(header, size == 0 ? 0 : data_start + data_size);
+      WriteU64(header, size);
+      data_size = AlignData(SafeInt<uint64_t>(data_size) + size);
+    }
+  }
+
+  // write through a temporary file, so a concurrent session never loads a partial file
+  static std::atomic<uint64_t> temp_file_counter{0};
+  auto temp_path = path;
+  temp_path += "." + std::to_string(Env::Default().GetSelfPid()) + "." + std::to_string(temp_file_counter++) + ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(out, "Failed to create pre-packed weights file: ", temp_path.string());
+    const std::string header_bytes = header.str();
+    out.write(header_bytes.data(), static_cast<std::streamsize>(header_bytes.size()));
+    const std::string padding(kDataAlignment, '\0');
+    uint64_t offset = header_bytes.size();
+    auto pad_to = [&](uint64_t target) {
+      out.write(padding.data(), static_cast<std::streamsize>(target - offset));
+      offset = target;
+    };
+    pad_to(data_start);
+    for (const auto& [key, entry] : entries_) {
+      for (size_t b = 0; b < entry.weights.buffers_.size(); ++b) {
+        if (entry.weights.buffers_[b] == nullptr || entry.weights.buffer_sizes_[b] == 0) continue;
+        const size_t size = entry.weights.buffer_sizes_[b];
+        out.write(static_cast<const char*>(entry.weights.buffers_[b].get()), static_cast<std::streamsize>(size));
+        offset += size;
+        pad_to(AlignData(offset));
+      }
+    }
+    ORT_RETURN_IF_NOT(out.flush(), "Failed to write pre-packed weights file: ", temp_path.string());
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write pre-packed weights file: ", path.string());
+  }
+  return Status::OK();
+}
+
+const PrepackedWeightsFile::Entry* PrepackedWeightsFile::Find(const std::string& key) const {
+  auto it = entries_.find(key);
+  return it != entries_.end() ? &it->second : nullptr;
+}
+
+const PrepackedWeightsFile::Entry& PrepackedWeightsFile::Add(const std::string& key, HashValue initializer_hash,
+                                                              PrePackedWeights&& weights) {
+  Entry entry;
+  entry.initializer_hash = initializer_hash;
+  entry.weights = std::move(weights);
+  return entries_.insert_or_assign(key, std::move(entry)).first->second;
+}
+
+}  // namespace onnxruntime
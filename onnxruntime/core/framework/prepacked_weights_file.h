@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+// Pre-packed weights saved to a file next to the model, so later sessions can map them instead of calling
+// OpKernel::PrePack(). See kOrtSessionOptionsConfigPrepackedWeightsFile.
+//
+// Pre-packed layouts depend on the onnxruntime version and on the CPU features the kernels dispatch on, so the file
+// records a layout tag and is rejected by a session with a different tag. Each weight also records a hash of the
+// initializer it was packed from, so a weight is not used if the model changed.
+class PrepackedWeightsFile final {
+ public:
+  struct Entry {
+    // hash of the data of the initializer the weight was pre-packed from
+    HashValue initializer_hash{0};
+    PrePackedWeights weights;
+  };
+
+  PrepackedWeightsFile() = default;
+
+  // Returns the tag identifying the pre-packed layouts of this build on this CPU.
+  static std::string GetLayoutTag();
+
+  static HashValue HashTensorData(const Tensor& tensor);
+
+  // Maps the weights saved in 'path'. The buffers stay valid while their entry exists.
+  // Returns an error if the file can't be read, is malformed, or has a different layout tag.
+  Status Load(const std::filesystem::path& path);
+
+  // Saves the weights to 'path', replacing the file if it exists.
+  Status Save(const std::filesystem::path& path) const;
+
+  // Returns the weight saved for 'key', nullptr if there is none.
+  const Entry* Find(const std::string& key) const;
+
+  // Adds a weight, replacing any weight with the same key, and returns the added entry.
+  const Entry& Add(const std::string& key, HashValue initializer_hash, PrePackedWeights&& weights);
+
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  // ordered so the saved file doesn't depend on the order weights were added in
+  std::map<std::string, Entry> entries_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFile);
+};
+
+}  // namespace onnxruntime
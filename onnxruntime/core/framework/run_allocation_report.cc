@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_allocation_report.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace onnxruntime {
+
+namespace {
+thread_local RunAllocationReport* current_report = nullptr;
+
+int64_t GetArenaExtensions(IAllocator& allocator) {
+  AllocatorStats stats;
+  allocator.GetStats(&stats);
+  return stats.num_arena_extensions;
+}
+}  // namespace
+
+RunAllocationReport::Scope::Scope(RunAllocationReport* report) : parent_(current_report) {
+  current_report = report;
+}
+
+RunAllocationReport::Scope::~Scope() {
+  current_report = parent_;
+}
+
+RunAllocationReport* RunAllocationReport::Current() {
+  return current_report;
+}
+
+void RunAllocationReport::Start(const AllocatorMap& allocators) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& [device, allocator] : allocators) {
+    arena_extensions_at_start_[device] = GetArenaExtensions(*allocator);
+  }
+}
+
+void RunAllocationReport::Stop(const AllocatorMap& allocators) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& [device, allocator] : allocators) {
+    auto start = arena_extensions_at_start_.find(device);
+    if (start == arena_extensions_at_start_.end()) {
+      continue;
+    }
+    const int64_t num_arena_extensions = GetArenaExtensions(*allocator) - start->second;
+    if (num_arena_extensions > 0) {
+      devices_[device].num_arena_extensions += num_arena_extensions;
+    }
+  }
+}
+
+void RunAllocationReport::RecordAllocation(const OrtDevice& device, const void* buffer, size_t size,
+                                           bool is_new_allocation) {
+  if (buffer == nullptr) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!buffers_.emplace(buffer, std::make_pair(device, size)).second) {
+    // the start of a buffer that is already held, e.g. a value that reuses the buffer of another one
+    return;
+  }
+  auto& usage = devices_[device];
+  usage.bytes_in_use += size;
+  usage.peak_bytes = std::max(usage.peak_bytes, usage.bytes_in_use);
+  if (is_new_allocation) {
+    ++usage.num_allocations;
+  }
+}
+
+void RunAllocationReport::RecordRelease(const void* buffer) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = buffers_.find(buffer);
+  if (it == buffers_.end()) {
+    return;
+  }
+  devices_[it->second.first].bytes_in_use -= it->second.second;
+  buffers_.erase(it);
+}
+
+std::map<OrtDevice, RunAllocationReport::DeviceUsage> RunAllocationReport::GetDeviceUsage() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return devices_;
+}
+
+std::string RunAllocationReport::ToString() const {
+  std::ostringstream ss;
+  bool first = true;
+  for (const auto& [device, usage] : GetDeviceUsage()) {
+    ss << (first ? "" : ", ") << device.ToString() << ":[peak_bytes:" << usage.peak_bytes
+       << " num_allocations:" << usage.num_allocations << " num_arena_extensions:" << usage.num_arena_extensions
+       << "]";
+    first = false;
+  }
+  return ss.str();
+}
+
+}  // namespace onnxruntime
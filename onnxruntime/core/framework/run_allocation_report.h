@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// The memory the execution frames of a run took from the allocators of the session, per device. Recorded when the
+// run option memory.report_allocations is set.
+//
+// The frames report the buffers of the values they allocate and the chunks of their memory patterns, so the memory
+// the kernels allocate for themselves is not included. The arena extensions are those of the allocators of the
+// session while the run executed, which includes the extensions caused by runs executing concurrently.
+//
+// Thread-safe.
+class RunAllocationReport {
+ public:
+  struct DeviceUsage {
+    size_t bytes_in_use = 0;
+    // the largest bytes_in_use while the run executed
+    size_t peak_bytes = 0;
+    // the buffers allocated, the buffers of memory patterns that are reused across runs are not counted
+    size_t num_allocations = 0;
+    int64_t num_arena_extensions = 0;
+  };
+
+  // Makes a report the report of the frames created on the calling thread for the lifetime of the object.
+  class Scope {
+   public:
+    explicit Scope(RunAllocationReport* report);
+    ~Scope();
+
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Scope);
+
+   private:
+    RunAllocationReport* parent_;
+  };
+
+  RunAllocationReport() = default;
+
+  // The report of the frames created on the calling thread, nullptr if the run doesn't record one.
+  static RunAllocationReport* Current();
+
+  // Reads the arena extensions of the allocators when the run starts and when it ends.
+  void Start(const AllocatorMap& allocators);
+  void Stop(const AllocatorMap& allocators);
+
+  // Records that the frame holds the buffer, which it allocated if is_new_allocation is set.
+  void RecordAllocation(const OrtDevice& device, const void* buffer, size_t size, bool is_new_allocation = true);
+  // Records that the frame released the buffer. Buffers that were not recorded are ignored.
+  void RecordRelease(const void* buffer);
+
+  std::map<OrtDevice, DeviceUsage> GetDeviceUsage() const;
+
+  // e.g. "Cpu:[peak_bytes:1024 num_allocations:3 num_arena_extensions:1]"
+  std::string ToString() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunAllocationReport);
+
+  mutable OrtMutex mutex_;
+  std::map<OrtDevice, DeviceUsage> devices_;
+  // the buffers the frames hold and their size
+  InlinedHashMap<const void*, std::pair<OrtDevice, size_t>> buffers_;
+  std::map<OrtDevice, int64_t> arena_extensions_at_start_;
+};
+
+}  // namespace onnxruntime
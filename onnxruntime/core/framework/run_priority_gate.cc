@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_priority_gate.h"
+
+namespace onnxruntime {
+
+void RunPriorityGate::Enter(int priority) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ++active_runs_[priority];
+  highest_active_priority_.store(active_runs_.rbegin()->first, std::memory_order_relaxed);
+}
+
+void RunPriorityGate::Leave(int priority) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = active_runs_.find(priority);
+    ORT_ENFORCE(it != active_runs_.end() && it->second > 0);
+    if (--it->second == 0) {
+      active_runs_.erase(it);
+    }
+    highest_active_priority_.store(
+        active_runs_.empty() ? std::numeric_limits<int>::min() : active_runs_.rbegin()->first,
+        std::memory_order_relaxed);
+  }
+  cv_.notify_all();
+}
+
+void RunPriorityGate::WaitForPriority(int priority) {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  cv_.wait(lock, [this, priority]() {
+    return highest_active_priority_.load(std::memory_order_relaxed) <= priority;
+  });
+}
+
+}  // namespace onnxruntime
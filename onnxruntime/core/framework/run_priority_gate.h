@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <map>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Tracks the priorities of the runs executing in a session, so that runs of lower priority can yield at node
+// boundaries while runs of higher priority are executing.
+//
+// A run registers itself for its duration with a Scope, and calls Scope::YieldIfPreempted between nodes.
+// Runs of the highest active priority never wait, so a steady stream of high priority runs can starve lower ones.
+//
+// Thread-safe.
+class RunPriorityGate {
+ public:
+  class Scope {
+   public:
+    Scope(RunPriorityGate& gate, int priority) : gate_(gate), priority_(priority) { gate_.Enter(priority_); }
+    ~Scope() { gate_.Leave(priority_); }
+
+    // Blocks while a run of a higher priority is executing.
+    void YieldIfPreempted() const {
+      if (gate_.highest_active_priority_.load(std::memory_order_relaxed) > priority_) {
+        gate_.WaitForPriority(priority_);
+      }
+    }
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Scope);
+
+    RunPriorityGate& gate_;
+    const int priority_;
+  };
+
+  RunPriorityGate() = default;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunPriorityGate);
+
+  void Enter(int priority);
+  void Leave(int priority);
+  void WaitForPriority(int priority);
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  // number of executing runs per priority
+  std::map<int, size_t> active_runs_;
+  std::atomic<int> highest_active_priority_{std::numeric_limits<int>::min()};
+};
+
+}  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include "core/framework/alloc_kind.h"
 #include "core/framework/data_types.h"
 #include "core/framework/execution_plan_base.h"
+#include "core/framework/tensor_shape.h"
 #include "core/graph/graph.h"
 
 namespace onnxruntime {
@@ -32,9 +33,14 @@ struct AllocPlanPerValue {
   AllocKind alloc_kind{AllocKind::kNotSet};
   MLDataType value_type{nullptr};
   OrtDevice location;
-  // reused_buffer is valid only if alloc_kind == kReuse. It indicates
+  // reused_buffer is valid only if alloc_kind == kReuse or kReuseSubBuffer. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // reused_buffer_offset and reused_buffer_shape are valid only if alloc_kind == kReuseSubBuffer. This OrtValue
+  // lives at byte offset reused_buffer_offset of the buffer of reused_buffer, which is allocated with the static
+  // shape reused_buffer_shape if this OrtValue is created first (e.g. an input of a Concat placed in its output).
+  size_t reused_buffer_offset{0};
+  TensorShapeVector reused_buffer_shape;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   IntervalT life_interval{0, 0};
   IntervalT allocate_interval{0, 0};
@@ -165,6 +171,14 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
 
   size_t num_barriers{0};
 
+  // order to start the logic streams in. empty means in stream index order.
+  // set in parallel execution mode, where the stream with the most estimated work left is started first.
+  std::vector<size_t> stream_dispatch_order;
+
+  // set when the plan is a single logic stream with no barriers or notifications, i.e. a sequence of kernel launches.
+  // such plans are run in the calling thread by a loop over the kernels, without scheduling the stream as a task.
+  bool is_single_stream_of_kernels{false};
+
 #ifdef ENABLE_TRAINING
   InlinedVector<NodeIndex> node_execution_order_in_training;
   InlinedHashMap<NodeIndex, size_t> node_index_2_toposort_index;
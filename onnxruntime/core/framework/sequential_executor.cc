@@ -3,6 +3,7 @@
 
 #include "core/framework/sequential_executor.h"
 
+#include <atomic>
 #include <chrono>
 #include <thread>
 #include <vector>
@@ -11,6 +12,7 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/memory_timeline.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -20,9 +22,9 @@
 #include "core/framework/debug_node_inputs_outputs_utils.h"
 #endif
 
-#ifdef ENABLE_NVTX_PROFILE
 // This header is for profile using Nvidia's visual profilier.
 #include "core/providers/cuda/nvtx_profile.h"
+#ifdef ENABLE_NVTX_PROFILE
 #include "core/providers/cuda/nvtx_profile_context.h"
 #endif
 
@@ -155,7 +157,9 @@ class SessionScope {
  public:
   friend class KernelScope;
   SessionScope(const SessionState& session_state, const ExecutionFrame& frame)
-      : session_state_(session_state)
+      : session_state_(session_state),
+        recorded_run_(profiling::Profiler::CurrentRun()),
+        nvtx_correlation_id_(profile::CurrentNvtxCorrelationId())
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
         ,
         frame_(frame)
@@ -178,6 +182,9 @@ class SessionScope {
   {
     if (session_state_.Profiler().IsEnabled()) {
       session_start_ = session_state.Profiler().Start();
+      if (session_state_.ProfileMemory()) {
+        memory_timeline_ = std::make_unique<MemoryTimeline>(session_state_, frame);
+      }
     }
 
     auto& logger = session_state_.Logger();
@@ -189,9 +196,6 @@ class SessionScope {
 // Enable TRACE_EXECUTION compile flag to dump execution plan
 #if defined(TRACE_EXECUTION)
     std::cout << std::make_pair(&seq_exec_plan, &session_state) << std::endl;
-#endif
-#if defined(ORT_MINIMAL_BUILD) || !defined(ORT_MEMORY_PROFILE)
-    ORT_UNUSED_PARAMETER(frame);
 #endif
   }
 
@@ -225,6 +229,9 @@ class SessionScope {
 #endif
 
     if (session_state_.Profiler().IsEnabled()) {
+      if (memory_timeline_) {
+        memory_timeline_->ReportPeak();
+      }
       session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", session_start_);
     }
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
@@ -241,6 +248,8 @@ class SessionScope {
 #endif
   }
 
+  const profiling::Profiler::RecordedRun* GetRecordedRun() const { return recorded_run_; }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   void SetFlushMemoryInfoFlag(bool flush_memory_info) {
     flush_memory_info_ = flush_memory_info;
@@ -249,7 +258,16 @@ class SessionScope {
 
  private:
   const SessionState& session_state_;
+  // the run recorded by the profiler in the sampled mode on the thread that started the execution.
+  // the nodes are executed with it as the current run of their thread.
+  const profiling::Profiler::RecordedRun* recorded_run_;
+  // the correlation id of the run of the execution, 0 if the NVTX ranges are disabled.
+  const uint64_t nvtx_correlation_id_;
+  // the provider of the last node whose NVTX range started, to mark the boundaries of the partitions.
+  std::atomic<const std::string*> last_nvtx_provider_{nullptr};
   TimePoint session_start_;
+  // the memory timeline of this execution if the profiler records it
+  std::unique_ptr<MemoryTimeline> memory_timeline_;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   const ExecutionFrame& frame_;
   // Whether memory profiler need create events and flush to file.
@@ -285,16 +303,6 @@ class KernelScope {
         ,
         span_(session_scope_.series_, "%s.%d", kernel_.Node().OpType().c_str(), kernel_.Node().Index())
 #endif
-#ifdef ENABLE_NVTX_PROFILE
-        ,
-        node_compute_range_(MakeString(kernel_.Node().OpType(),
-                                       ".",
-                                       kernel_.Node().Index(),
-                                       "(",
-                                       kernel_.Node().Name(),
-                                       ")"),
-                            profile::Color::Yellow)
-#endif
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
         ,
         dump_context_{
@@ -332,9 +340,9 @@ class KernelScope {
     utils::DumpNodeInputs(dump_context_, kernel_context_, kernel_.Node(), session_state_);
 #endif
 
-#ifdef ENABLE_NVTX_PROFILE
-    node_compute_range_.Begin();
-#endif
+    if (session_scope_.nvtx_correlation_id_ != 0 && profile::IsNvtxRangesEnabled()) {
+      BeginNvtxRange();
+    }
 
     if (session_state_.Profiler().IsEnabled()) {
       auto& node = kernel.Node();
@@ -345,47 +353,79 @@ class KernelScope {
                                      node_name_ + "_fence_before",
                                      sync_time_begin,
                                      {{"op_name", kernel_.KernelDef().OpName()}});
-      concurrency::ThreadPool::StartProfiling(session_state_.GetThreadPool());
+      concurrency::ThreadPool::StartProfiling(kernel_context_.GetOperatorThreadPool());
       VLOGS(session_state_.Logger(), 1) << "Computing kernel: " << node_name_;
+      if (const auto* hardware_counters = profiler.GetHardwareCounters()) {
+        hardware_counters_begin_ = hardware_counters->Read();
+      }
       kernel_begin_time_ = session_state_.Profiler().Start();
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
     }
+
+    node_metrics_ = session_state_.GetNodeMetrics(kernel_.Node().Index());
+    if (node_metrics_) {
+      metrics_begin_time_ = std::chrono::steady_clock::now();
+    }
   }
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
 
   ~KernelScope() {
-#ifdef ENABLE_NVTX_PROFILE
-    node_compute_range_.End();
-#endif
+    if (node_metrics_) {
+      const auto elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                        std::chrono::steady_clock::now() - metrics_begin_time_)
+                                                        .count());
+      node_metrics_->node->Record(elapsed_ns);
+      node_metrics_->op_type->Record(elapsed_ns);
+    }
+
+    if (nvtx_range_pushed_) {
+      profile::NvtxPopRange();
+    }
 
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
+      const auto* hardware_counters = profiler.GetHardwareCounters();
+      HardwareCounters::Values hardware_counters_end{};
+      if (hardware_counters) {
+        hardware_counters_end = hardware_counters->Read();
+      }
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
+      // Log additional operation args / info.
+      std::unordered_map<std::string, std::string> event_args{
+          {"op_name", kernel_.KernelDef().OpName()},
+          {"provider", kernel_.KernelDef().Provider()},
+          {"node_index", std::to_string(kernel_.Node().Index())},
+          {"activation_size", std::to_string(input_activation_sizes_)},
+          {"parameter_size", std::to_string(input_parameter_sizes_)},
+          {"output_size", std::to_string(total_output_sizes_)},
+          {"input_type_shape", input_type_shape_},
+          {"output_type_shape", output_type_shape_},
+          {"thread_scheduling_stats",
+           concurrency::ThreadPool::StopProfiling(kernel_context_.GetOperatorThreadPool())},
+      };
+      if (session_scope_.nvtx_correlation_id_ != 0) {
+        event_args.emplace("correlation_id", std::to_string(session_scope_.nvtx_correlation_id_));
+      }
+      if (hardware_counters) {
+        event_args.emplace("hardware_counters", hardware_counters->ToJson(hardware_counters_begin_,
+                                                                          hardware_counters_end));
+      }
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_kernel_time",
                                      kernel_begin_time_,
-                                     // Log additional operation args / info.
-                                     {
-                                         {"op_name", kernel_.KernelDef().OpName()},
-                                         {"provider", kernel_.KernelDef().Provider()},
-                                         {"node_index", std::to_string(kernel_.Node().Index())},
-                                         {"activation_size", std::to_string(input_activation_sizes_)},
-                                         {"parameter_size", std::to_string(input_parameter_sizes_)},
-                                         {"output_size", std::to_string(total_output_sizes_)},
-                                         {"input_type_shape", input_type_shape_},
-                                         {"output_type_shape", output_type_shape_},
-                                         {"thread_scheduling_stats",
-                                          concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
-                                     });
+                                     std::move(event_args));
       auto sync_time_begin = profiler.Start();
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_fence_after",
                                      sync_time_begin,
                                      {{"op_name", kernel_.KernelDef().OpName()}});
+      if (session_scope_.memory_timeline_) {
+        session_scope_.memory_timeline_->RecordNode(node_name_, kernel_.KernelDef().OpName());
+      }
     }
 
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
@@ -408,6 +448,23 @@ class KernelScope {
   }  //~KernelScope
 
  private:
+  // Pushes the NVTX range of the node, colored by its kind, and marks the boundary of a partition if it runs on
+  // another provider than the node before it.
+  void BeginNvtxRange() {
+    const auto& node = kernel_.Node();
+    const std::string& provider = kernel_.KernelDef().Provider();
+    const std::string* last_provider = session_scope_.last_nvtx_provider_.exchange(&provider);
+    if (last_provider == nullptr || *last_provider != provider) {
+      profile::NvtxMark(("Partition " + provider).c_str(), profile::Color::Cyan);
+    }
+
+    const bool is_memcpy = node.OpType() == "MemcpyFromHost" || node.OpType() == "MemcpyToHost";
+    const std::string message = MakeString(node.OpType(), ".", node.Index(), "(", node.Name(), ")");
+    profile::NvtxPushRange(message.c_str(), is_memcpy ? profile::Color::Red : profile::Color::Yellow,
+                           session_scope_.nvtx_correlation_id_);
+    nvtx_range_pushed_ = true;
+  }
+
   TimePoint kernel_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
@@ -419,14 +476,16 @@ class KernelScope {
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
   std::string input_type_shape_;
+  HardwareCounters::Values hardware_counters_begin_{};
+
+  const SessionMetrics::NodeHistograms* node_metrics_{nullptr};
+  std::chrono::steady_clock::time_point metrics_begin_time_;
 
 #ifdef CONCURRENCY_VISUALIZER
   diagnostic::span span_;
 #endif
 
-#ifdef ENABLE_NVTX_PROFILE
-  profile::NvtxRangeCreator node_compute_range_;
-#endif
+  bool nvtx_range_pushed_{false};
 
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   utils::NodeDumpContext dump_context_;
@@ -438,6 +497,7 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   size_t stream_idx,
                                   const bool& terminate_flag,
                                   SessionScope& session_scope) {
+  profiling::Profiler::ThreadRunScope recorded_run_scope(session_scope.GetRecordedRun());
   auto* p_kernel = ctx.GetSessionState().GetKernel(idx);
   if (p_kernel->KernelDef().OpName() == "YieldOp") {
     // Do not execute YieldOp (it is an no-op anyways).
@@ -454,7 +514,8 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                      *p_kernel,
                                      ctx.GetLogger(),
                                      terminate_flag,
-                                     ctx.GetDeviceStream(stream_idx));
+                                     ctx.GetDeviceStream(stream_idx),
+                                     ctx.GetIntraOpThreadPool());
   onnxruntime::Status status;
   auto& logger = ctx.GetLogger();
   if (p_kernel->IsAsync()) {
@@ -521,6 +582,30 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
   return Status::OK();
 }
 
+// Runs the kernels of a plan that is a single stream of kernel launches in the calling thread.
+static Status RunKernelsInline(StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag) {
+  const auto& steps = ctx.GetSessionState().GetExecutionPlan()->execution_plan[0]->steps_;
+  for (const auto& step : steps) {
+    if (terminate_flag) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+    if (const auto* priority_scope = ctx.GetPriorityScope()) {
+      priority_scope->YieldIfPreempted();
+    }
+    Status status;
+    ORT_TRY {
+      status = ExecuteKernel(ctx, step->GetNodeIndex(), 0, terminate_flag, session_scope);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
 onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                                    gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
                                    std::vector<OrtValue>& fetches,
@@ -531,7 +616,9 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode) {
+                                   bool single_thread_mode,
+                                   const RunPriorityGate::Scope* priority_scope,
+                                   const RunThreadPools* thread_pools) {
   auto* execution_plan = session_state.GetExecutionPlan();
   VLOGS(logger, 0) << "Number of streams: " << execution_plan->execution_plan.size();
   int32_t valid_streams = 0;
@@ -573,26 +660,45 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #else
   ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
 #endif
+  ctx.SetPriorityScope(priority_scope);
+  if (thread_pools != nullptr) {
+    ctx.SetThreadPools(*thread_pools);
+  }
 
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
 
-  auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
+  // A single stream of kernels has nothing to synchronize with, it is run without the task accounting of the streams.
+  bool run_inline = execution_plan->is_single_stream_of_kernels;
+#if defined(USE_CANN)
+  run_inline = false;  // RunSince starts the run of the CANN EP in the thread of the stream
+#endif
+#ifdef ENABLE_TRAINING
+  run_inline = run_inline && !only_execute_path_to_fetches;
+#endif
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  if (run_inline) {
+    ORT_RETURN_IF_ERROR(RunKernelsInline(ctx, session_scope, terminate_flag));
+  } else {
+    auto* tp = single_thread_mode ? nullptr : ctx.GetInterOpThreadPool();
+
+    const auto& stream_dispatch_order = execution_plan->stream_dispatch_order;
+    for (size_t order_idx = 0; order_idx < execution_plan->execution_plan.size(); ++order_idx) {
+      const size_t i = stream_dispatch_order.empty() ? order_idx : stream_dispatch_order[order_idx];
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
-  }
 
-  ctx.WaitAll();
-  ORT_RETURN_IF_ERROR(ctx.TaskStatus());
+    ctx.WaitAll();
+    ORT_RETURN_IF_ERROR(ctx.TaskStatus());
+  }
   ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GetOutputs(fetches));
   if (ctx.GetExecutionFrame().HasMemoryPatternPlanner()) {
     bool all_tensors = true;
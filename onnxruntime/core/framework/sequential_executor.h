@@ -10,6 +10,7 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/ort_value.h"
+#include "core/framework/run_priority_gate.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -22,6 +23,7 @@
 namespace onnxruntime {
 
 class StreamExecutionContext;
+struct RunThreadPools;
 class DeviceStreamCollection;
 class SessionScope;
 
@@ -46,7 +48,9 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode);
+                                   bool single_thread_mode,
+                                   const RunPriorityGate::Scope* priority_scope = nullptr,
+                                   const RunThreadPools* thread_pools = nullptr);
 
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
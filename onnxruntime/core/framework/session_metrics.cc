@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_metrics.h"
+#include "core/framework/run_allocation_report.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace onnxruntime {
+
+size_t LatencyHistogram::BucketForValue(uint64_t ns) noexcept {
+  if (ns < kSubBuckets) {
+    return static_cast<size_t>(ns);
+  }
+  if (ns >= kMaxValueNs) {
+    return kNumBuckets - 1;
+  }
+
+  size_t msb = 0;
+  for (uint64_t v = ns; v > 1; v >>= 1) {
+    ++msb;
+  }
+
+  const size_t sub_bucket = static_cast<size_t>(ns >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+  return (msb - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t bucket) noexcept {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+
+  const size_t msb = bucket / kSubBuckets + kSubBucketBits - 1;
+  const uint64_t sub_bucket = bucket % kSubBuckets;
+  return (kSubBuckets + sub_bucket) << (msb - kSubBucketBits);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) noexcept {
+  return bucket + 1 < kNumBuckets ? BucketLowerBound(bucket + 1) - 1 : std::numeric_limits<uint64_t>::max();
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.bucket_counts.resize(kNumBuckets);
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    snapshot.bucket_counts[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+  snapshot.max_ns = max_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::PercentileNs(double percentile) const {
+  uint64_t total = 0;
+  for (uint64_t bucket_count : bucket_counts) {
+    total += bucket_count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * total));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < bucket_counts.size(); ++i) {
+    seen += bucket_counts[i];
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      return std::min(BucketUpperBound(i), max_ns);
+    }
+  }
+
+  return max_ns;
+}
+
+SessionMetrics::NodeHistograms SessionMetrics::RegisterNode(const std::string& node_name,
+                                                            const std::string& op_type) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  NodeHistograms histograms;
+  // try_emplace constructs the histogram in place if the name is new
+  histograms.node = &node_histograms_.try_emplace(node_name).first->second;
+  histograms.op_type = &op_type_histograms_.try_emplace(op_type).first->second;
+  return histograms;
+}
+
+void SessionMetrics::RecordRunAllocations(const RunAllocationReport& report) {
+  const auto device_usage = report.GetDeviceUsage();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& [device, usage] : device_usage) {
+    auto& allocations = run_allocations_[device.ToString()];
+    ++allocations.num_runs;
+    allocations.sum_peak_bytes += usage.peak_bytes;
+    allocations.max_peak_bytes = std::max<uint64_t>(allocations.max_peak_bytes, usage.peak_bytes);
+    allocations.num_allocations += usage.num_allocations;
+    if (usage.num_arena_extensions > 0) {
+      ++allocations.num_runs_with_arena_extensions;
+    }
+  }
+}
+
+std::map<std::string, SessionMetrics::RunAllocations> SessionMetrics::GetRunAllocations() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return run_allocations_;
+}
+
+}  // namespace onnxruntime
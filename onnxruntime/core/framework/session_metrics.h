@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class RunAllocationReport;
+
+// A latency histogram that can be recorded to concurrently without locking.
+//
+// Buckets are log-linear in nanoseconds, like HDR histograms: every power of two is split into kSubBuckets buckets,
+// so a value is reported with a relative error of at most 1 / kSubBuckets. Values of kMaxValueNs and above are
+// counted in the last bucket.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  // about 18 minutes
+  static constexpr uint64_t kMaxValueNs = uint64_t{1} << 40;
+  static constexpr size_t kNumBuckets = (40 - kSubBucketBits + 1) * kSubBuckets;
+
+  struct Snapshot {
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t max_ns = 0;
+    std::vector<uint64_t> bucket_counts;
+
+    // The upper bound of the bucket that contains the given percentile (0-100) of the values.
+    uint64_t PercentileNs(double percentile) const;
+  };
+
+  LatencyHistogram() = default;
+
+  void Record(uint64_t ns) noexcept {
+    buckets_[BucketForValue(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max_ns && !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Values recorded concurrently may be partially included.
+  Snapshot GetSnapshot() const;
+
+  static size_t BucketForValue(uint64_t ns) noexcept;
+  // Smallest and largest value counted in a bucket.
+  static uint64_t BucketLowerBound(size_t bucket) noexcept;
+  static uint64_t BucketUpperBound(size_t bucket) noexcept;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LatencyHistogram);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+// Always-on metrics of a session: the latency of every node and of every op type, including the nodes of subgraphs.
+//
+// Histograms are created when the session state of a graph is finalized, so recording a latency is lock free.
+//
+// Thread-safe.
+class SessionMetrics {
+ public:
+  // Histograms a node records its latency to.
+  struct NodeHistograms {
+    LatencyHistogram* node = nullptr;
+    LatencyHistogram* op_type = nullptr;
+  };
+
+  // The memory of the runs that report their allocations, per device, see RunAllocationReport.
+  struct RunAllocations {
+    uint64_t num_runs = 0;
+    uint64_t sum_peak_bytes = 0;
+    uint64_t max_peak_bytes = 0;
+    uint64_t num_allocations = 0;
+    uint64_t num_runs_with_arena_extensions = 0;
+  };
+
+  SessionMetrics() = default;
+
+  // node_name is unique within the session, op_type is per domain.
+  NodeHistograms RegisterNode(const std::string& node_name, const std::string& op_type);
+
+  void RecordRunAllocations(const RunAllocationReport& report);
+
+  // keyed by the name of the device
+  std::map<std::string, RunAllocations> GetRunAllocations() const;
+
+  // Calls fn(name, snapshot) for every node, then per_op_type_fn(name, snapshot) for every op type, in name order.
+  template <typename NodeFn, typename OpTypeFn>
+  void ForEachHistogram(NodeFn&& node_fn, OpTypeFn&& op_type_fn) const {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (const auto& [name, histogram] : node_histograms_) {
+      node_fn(name, histogram.GetSnapshot());
+    }
+    for (const auto& [name, histogram] : op_type_histograms_) {
+      op_type_fn(name, histogram.GetSnapshot());
+    }
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionMetrics);
+
+  mutable OrtMutex mutex_;
+  // std::map as the histograms are neither copyable nor movable and have to keep their address
+  std::map<std::string, LatencyHistogram> node_histograms_;
+  std::map<std::string, LatencyHistogram> op_type_histograms_;
+  std::map<std::string, RunAllocations> run_allocations_;
+};
+
+}  // namespace onnxruntime
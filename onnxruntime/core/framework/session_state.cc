@@ -3,10 +3,13 @@
 
 #include "core/framework/session_state.h"
 
+#include <atomic>
+#include <limits>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -14,6 +17,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/shared_prepacked_weights_store.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -61,6 +65,19 @@ class StreamCommandHandleRegistryImpl : public IStreamCommandHandleRegistry {
 };
 #endif
 
+namespace {
+template <typename T>
+T GetMemoryPatternConfig(const SessionOptions& sess_options, const char* key, const logging::Logger& logger) {
+  const std::string value = sess_options.config_options.GetConfigOrDefault(key, "0");
+  T result{};
+  if (!TryParseStringWithClassicLocale(value, result) || result < 0) {
+    LOGS(logger, WARNING) << "Invalid value '" << value << "' for session config " << key << ". Using the default.";
+    return T{};
+  }
+  return result;
+}
+}  // namespace
+
 SessionState::SessionState(Graph& graph,
                            const ExecutionProviders& execution_providers,
                            concurrency::ThreadPool* thread_pool,
@@ -76,6 +93,10 @@ SessionState::SessionState(Graph& graph,
       execution_providers_(execution_providers),
       logger_(logger),
       profiler_(profiler),
+      mem_pattern_cache_(
+          GetMemoryPatternConfig<size_t>(sess_options, kOrtSessionOptionsMemoryPatternCacheSize, logger),
+          GetMemoryPatternConfig<int64_t>(sess_options, kOrtSessionOptionsMemoryPatternShapeBucketSize, logger),
+          sess_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigFreezeStaticShapePlan, "0") == "1"),
       thread_pool_(thread_pool),
       inter_op_thread_pool_(inter_op_thread_pool),
       data_transfer_mgr_(data_transfer_mgr),
@@ -398,7 +419,41 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  // pre-packed weights of the CPU EP may be shared with other processes through files in a directory
+  std::optional<SharedPrepackedWeightsStore> shared_prepacked_weights_store;
+  const std::string shared_prepacked_weights_dir =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSharedPrepackedWeightsDir, "");
+  if (!shared_prepacked_weights_dir.empty()) {
+    ORT_TRY {
+      shared_prepacked_weights_store.emplace(ToPathString(shared_prepacked_weights_dir));
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(logger_, WARNING) << "Pre-packed weights are not shared between processes: " << ex.what();
+      });
+    }
+  }
+
+  // pre-packed weights of the main graph may be kept in a file between sessions
+  const std::string prepacked_weights_file_path =
+      parent_ == nullptr
+          ? sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsFile, "")
+          : "";
+  bool save_prepacked_weights_file = false;
+  if (!prepacked_weights_file_path.empty()) {
+    prepacked_weights_file_ = std::make_unique<PrepackedWeightsFile>();
+    auto status = prepacked_weights_file_->Load(ToPathString(prepacked_weights_file_path));
+    if (status.IsOK()) {
+      LOGS(logger_, INFO) << "Loaded " << prepacked_weights_file_->Size() << " pre-packed weight(s) from "
+                          << prepacked_weights_file_path;
+    } else {
+      LOGS(logger_, INFO) << "Pre-packed weights file will be saved: " << status.ErrorMessage();
+      save_prepacked_weights_file = true;
+    }
+  }
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     &shared_prepacked_weights_store, save_prepacked_weights_file](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -478,6 +533,66 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     }
                   }
 
+                } else if ((shared_prepacked_weights_store || prepacked_weights_file_) &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  // pre-packed weights shared between processes, or kept in a file between sessions
+                  const std::string file_key = std::to_string(node.Index()) + "/" + node.OpType() + "/" +
+                                               std::to_string(input_idx) + "/" + input_name;
+                  if (prepacked_weights_file_) {
+                    const auto* saved = prepacked_weights_file_->Find(file_key);
+                    if (saved != nullptr &&
+                        saved->initializer_hash == PrepackedWeightsFile::HashTensorData(const_initialized_tensor)) {
+                      ORT_RETURN_IF_ERROR(kernel->RestorePrePackedState(const_initialized_tensor, input_idx,
+                                                                        saved->weights.buffer_sizes_, is_packed));
+                      if (is_packed) {
+                        ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, saved->weights,
+                                                                            node.Name()));
+                      }
+                    }
+                  }
+
+                  if (!is_packed) {
+                    AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                    PrePackedWeights packed_weights;
+                    // The weight is still pre-packed when sharing between processes, as kernels may initialize
+                    // other state in PrePack(). The process's own copy is released once the shared copy is mapped.
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, session_cpu_alloc,
+                                                        is_packed, &packed_weights));
+
+                    // a kernel that can't provide its pre-packed buffers keeps its own copy
+                    if (is_packed && !packed_weights.buffers_.empty()) {
+                      if (shared_prepacked_weights_store) {
+                        PrePackedWeights shared_weights;
+                        auto status = shared_prepacked_weights_store->GetOrWriteWeight(
+                            GenerateKeyForPrepackedWeightsMap(node.OpType(), packed_weights), packed_weights,
+                            shared_weights);
+                        if (status.IsOK()) {
+                          packed_weights = std::move(shared_weights);
+                        } else {
+                          LOGS(logger_, WARNING) << "Pre-packed weight for constant initializer: " << input_name
+                                                 << " used in the node: " << node.Name()
+                                                 << " is not shared between processes: " << status.ErrorMessage();
+                        }
+                      }
+
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, packed_weights,
+                                                                          node.Name()));
+
+                      // only weights the kernel can restore without PrePack() are worth saving
+                      bool can_restore = false;
+                      if (save_prepacked_weights_file) {
+                        ORT_RETURN_IF_ERROR(kernel->RestorePrePackedState(const_initialized_tensor, input_idx,
+                                                                          packed_weights.buffer_sizes_, can_restore));
+                      }
+                      if (can_restore) {
+                        prepacked_weights_file_->Add(file_key,
+                                                     PrepackedWeightsFile::HashTensorData(const_initialized_tensor),
+                                                     std::move(packed_weights));
+                      } else {
+                        shared_prepacked_weights_.push_back(std::move(packed_weights));
+                      }
+                    }
+                  }
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -488,8 +603,12 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                 }
                 if (is_packed) {
                   ++number_of_prepacks_counter_;
+                  prepacked_initializer_uses_[input_name].push_back(
+                      {node.Index(), input_idx, const_initialized_tensor.DataType(), const_initialized_tensor.Shape()});
 
-                  if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+                  // the initializers of a session state that may already be running are left as they are
+                  if (IsFinalizedWith(*st) && constant_initializers_use_count.count(input_name) &&
+                      --constant_initializers_use_count[input_name] == 0) {
                     // release the constant initialized tensor
                     st->initialized_tensors_.erase(ort_value_idx);
                     constant_initialized_tensors.erase(ort_value_idx);
@@ -519,18 +638,179 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(true));
+  } else if (!shared_prepacked_weights_store && !prepacked_weights_file_ &&
+             sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisableParallelPrepacking,
+                                                             "0") != "1") {
+    ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensorsInParallel(constant_initializers_use_count));
   } else {
-    return prepacked_constant_weights(false);
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(false));
   }
+
+  if (save_prepacked_weights_file && prepacked_weights_file_->Size() > 0) {
+    auto status = prepacked_weights_file_->Save(ToPathString(prepacked_weights_file_path));
+    if (status.IsOK()) {
+      LOGS(logger_, INFO) << "Saved " << prepacked_weights_file_->Size() << " pre-packed weight(s) to "
+                          << prepacked_weights_file_path;
+    } else {
+      LOGS(logger_, WARNING) << "Pre-packed weights were not saved: " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
+Status SessionState::PrepackConstantInitializedTensorsInParallel(
+    InlinedHashMap<std::string, size_t>& constant_initializers_use_count) {
+  // The constant initialized tensors read by the kernels, in the order of the nodes and of their inputs. The
+  // initializers of outer scopes are looked up as in PrepackConstantInitializedTensors().
+  struct PrepackCandidate {
+    const Node* node;
+    OpKernel* kernel;
+    int input_idx;
+    const std::string* input_name;
+    SessionState* session_state;
+    int ort_value_idx;
+    const Tensor* tensor;
+    MLDataType data_type;
+    TensorShape shape;
+    AllocatorPtr allocator;
+    // the use count of an initializer that can be released, or nullptr
+    std::atomic<size_t>* use_count;
+    bool is_packed;
+    bool is_released;
+  };
+  std::vector<PrepackCandidate> candidates;
+  // the ranges of candidates of each node
+  std::vector<std::pair<size_t, size_t>> cpu_node_ranges;
+  std::vector<std::pair<size_t, size_t>> other_node_ranges;
+  // the index in use_counts of each initializer that can be released
+  InlinedHashMap<std::string, size_t> use_count_indices;
+  std::vector<size_t> candidate_use_count_indices;
+  for (auto& node : GetGraphViewer().Nodes()) {
+    const size_t node_start = candidates.size();
+    auto kernel = GetMutableKernel(node.Index());
+    int input_idx = 0;
+    for (auto& input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        const std::string& input_name = input_def->Name();
+        SessionState* st = this;
+        do {
+          int ort_value_idx;
+          if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+            auto it = st->constant_initialized_tensors_.find(ort_value_idx);
+            if (it != st->constant_initialized_tensors_.end()) {
+              const Tensor& tensor = it->second.Get<Tensor>();
+              candidates.push_back({&node, kernel, input_idx, &input_name, st, ort_value_idx, &tensor,
+                                    tensor.DataType(), tensor.Shape(),
+                                    GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault)),
+                                    nullptr, false, false});
+              // the initializers of a session state that may already be running are left as they are
+              size_t use_count_idx = std::numeric_limits<size_t>::max();
+              if (IsFinalizedWith(*st) && constant_initializers_use_count.count(input_name)) {
+                use_count_idx = use_count_indices.emplace(input_name, use_count_indices.size()).first->second;
+              }
+              candidate_use_count_indices.push_back(use_count_idx);
+            }
+            if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+              break;
+            }
+          }
+          st = st->Parent();
+        } while (st);
+      }
+      input_idx++;
+    }
+    if (candidates.size() > node_start) {
+      auto& node_ranges = node.GetExecutionProviderType() == kCpuExecutionProvider ? cpu_node_ranges
+                                                                                   : other_node_ranges;
+      node_ranges.emplace_back(node_start, candidates.size());
+    }
+  }
+
+  // The uses of an initializer count down as their kernels pre-pack it, so the last one releases it right away and
+  // the peak memory stays close to that of pre-packing one node after the other.
+  std::vector<std::atomic<size_t>> use_counts(use_count_indices.size());
+  for (const auto& [input_name, use_count_idx] : use_count_indices) {
+    use_counts[use_count_idx].store(constant_initializers_use_count[input_name], std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (candidate_use_count_indices[i] != std::numeric_limits<size_t>::max()) {
+      candidates[i].use_count = &use_counts[candidate_use_count_indices[i]];
+    }
+  }
+
+  // The kernel of a node pre-packs its inputs in order, and the kernels don't share anything they pre-pack. The
+  // entries of the released initializers are reset here and erased once all nodes are pre-packed, as the maps of
+  // the initializers must not change while other tasks run.
+  auto prepack_node = [&candidates](const std::pair<size_t, size_t>& node_range) -> Status {
+    Status status;
+    ORT_TRY {
+      for (size_t i = node_range.first; i < node_range.second && status.IsOK(); ++i) {
+        auto& candidate = candidates[i];
+        status = candidate.kernel->PrePack(*candidate.tensor, candidate.input_idx, candidate.allocator,
+                                           candidate.is_packed, nullptr);
+        if (status.IsOK() && candidate.is_packed && candidate.use_count != nullptr &&
+            candidate.use_count->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          // release the constant initialized tensor
+          SessionState& st = *candidate.session_state;
+          st.initialized_tensors_.at(candidate.ort_value_idx) = OrtValue();
+          st.constant_initialized_tensors_.at(candidate.ort_value_idx) = OrtValue();
+          candidate.is_released = true;
+        }
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PrePack of node ", candidates[node_range.first].node->Name(),
+                                 " failed: ", ex.what());
+      });
+    }
+    return status;
+  };
+
+  // other EPs may pre-pack with state of the calling thread, e.g. its current device
+  for (const auto& node_range : other_node_ranges) {
+    ORT_RETURN_IF_ERROR(prepack_node(node_range));
+  }
+  std::vector<Status> cpu_node_statuses(cpu_node_ranges.size());
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(cpu_node_ranges.size()), [&](std::ptrdiff_t i) {
+        cpu_node_statuses[i] = prepack_node(cpu_node_ranges[i]);
+      });
+  for (const auto& status : cpu_node_statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  for (const auto& [input_name, use_count_idx] : use_count_indices) {
+    constant_initializers_use_count[input_name] = use_counts[use_count_idx].load(std::memory_order_relaxed);
+  }
+  for (auto& candidate : candidates) {
+    if (!candidate.is_packed) {
+      continue;
+    }
+
+    ++number_of_prepacks_counter_;
+    prepacked_initializer_uses_[*candidate.input_name].push_back({candidate.node->Index(), candidate.input_idx,
+                                                                  candidate.data_type, candidate.shape});
+    if (candidate.is_released) {
+      candidate.session_state->initialized_tensors_.erase(candidate.ort_value_idx);
+      candidate.session_state->constant_initialized_tensors_.erase(candidate.ort_value_idx);
+    }
+  }
+
+  return Status::OK();
+}
+
+// Encodes the input shapes as rank followed by dims for each input so different shapes never share a key.
+static InlinedVector<int64_t> GetMemoryPatternInputDims(gsl::span<const OrtValue> tensor_inputs) {
+  InlinedVector<int64_t> input_dims;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    auto dims = input.Get<Tensor>().Shape().GetDims();
+    input_dims.push_back(static_cast<int64_t>(dims.size()));
+    input_dims.insert(input_dims.end(), dims.begin(), dims.end());
   }
-  return key;
+  return input_dims;
 }
 
 #ifdef ENABLE_TRAINING
@@ -767,38 +1047,25 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// The returned entry is shared with the cache, so it stays valid for the caller
+// even if the cache evicts or replaces it in the meantime.
+std::shared_ptr<const MemoryPatternCacheEntry> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
-    gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
-  out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+    gsl::span<const int> feed_mlvalue_idxs) const {
+  const auto input_dims = GetMemoryPatternInputDims(tensor_inputs);
+  auto entry = mem_pattern_cache_.Find(input_dims);
 #ifdef ENABLE_TRAINING
+  if (!entry) {
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      entry = mem_pattern_cache_.Insert(input_dims, std::move(mem_patterns), std::move(inferred_shapes));
     }
+  }
 #else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
+  ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
 #endif
-    return nullptr;
-  }
-
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
-  }
-  return &it->second;
+  return entry;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -849,11 +1116,9 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // An existing pattern that can serve these inputs is kept. Frames that use a replaced
+  // or evicted pattern hold their own reference to it.
+  mem_pattern_cache_.Insert(GetMemoryPatternInputDims(tensor_inputs), std::move(mem_patterns));
   return Status::OK();
 }
 
@@ -976,6 +1241,125 @@ SessionState* SessionState::GetMutableSubgraphSessionState(onnxruntime::NodeInde
   return session_state;
 }
 
+Status SessionState::EnsureFinalized() const {
+  if (!finalization_deferred_ || deferred_finalization_done_.load(std::memory_order_acquire)) {
+    return deferred_finalization_status_;
+  }
+
+  std::lock_guard<OrtMutex> lock(deferred_finalization_mutex_);
+  if (!deferred_finalization_done_.load(std::memory_order_relaxed)) {
+    LOGS(logger_, INFO) << "Initializing subgraph '" << graph_.Name() << "'.";
+    ORT_TRY {
+      deferred_finalization_status_ = deferred_finalization_();
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        deferred_finalization_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION,
+                                                        "Exception initializing subgraph '", graph_.Name(),
+                                                        "': ", ex.what());
+      });
+    }
+    deferred_finalization_ = nullptr;
+    deferred_finalization_done_.store(true, std::memory_order_release);
+  }
+
+  return deferred_finalization_status_;
+}
+
+Status SessionState::FinalizeDeferredSubgraphs(const std::atomic<bool>& stop) const {
+  for (const auto& entry : subgraph_session_states_) {
+    for (const auto& name_to_subgraph_session_state : entry.second) {
+      if (stop.load(std::memory_order_relaxed)) {
+        return Status::OK();
+      }
+
+      const SessionState& subgraph_session_state = *name_to_subgraph_session_state.second;
+      ORT_RETURN_IF_ERROR(subgraph_session_state.EnsureFinalized());
+      ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeDeferredSubgraphs(stop));
+    }
+  }
+
+  return Status::OK();
+}
+
+bool SessionState::IsFinalizedWith(const SessionState& ancestor) const {
+  for (const SessionState* session_state = this; session_state != &ancestor; session_state = session_state->parent_) {
+    if (session_state->finalization_deferred_) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status SessionState::UpdateInitializer(const std::string& name, const Tensor& value, bool& found) {
+  int ort_value_idx;
+  if (GetOrtValueNameIdxMap().GetIdx(name, ort_value_idx).IsOK()) {
+    auto it = initialized_tensors_.find(ort_value_idx);
+    if (it != initialized_tensors_.end()) {
+      ORT_RETURN_IF_NOT(it->second.IsTensor(), "Initializer ", name, " is not a dense tensor.");
+      Tensor& tensor = *it->second.GetMutable<Tensor>();
+      ORT_RETURN_IF_NOT(tensor.DataType() == value.DataType() && tensor.Shape() == value.Shape(),
+                        "The new value of initializer ", name, " has type ", DataTypeImpl::ToString(value.DataType()),
+                        " and shape ", value.Shape(), " instead of ", DataTypeImpl::ToString(tensor.DataType()),
+                        " and ", tensor.Shape());
+      // The current buffer may be a read-only mapping of an external data file or memory of the caller, so the new
+      // value gets a buffer of its own. The Tensor is kept, as constant_initialized_tensors_ shares it and kernels
+      // may have looked it up with OpKernelInfo::TryGetConstantInput.
+      AllocatorPtr allocator = GetAllocator(tensor.Location().device);
+      ORT_RETURN_IF_NOT(allocator, "Failed to find allocator for device ", tensor.Location().device.ToString());
+      Tensor new_tensor(value.DataType(), value.Shape(), std::move(allocator));
+      ORT_RETURN_IF_ERROR(data_transfer_mgr_.CopyTensor(value, new_tensor));
+      tensor = std::move(new_tensor);
+      found = true;
+    }
+  }
+
+  auto uses = prepacked_initializer_uses_.find(name);
+  if (uses != prepacked_initializer_uses_.end()) {
+    for (const auto& use : uses->second) {
+      ORT_RETURN_IF_NOT(use.type == value.DataType() && use.shape == value.Shape(),
+                        "The new value of initializer ", name, " has type ", DataTypeImpl::ToString(value.DataType()),
+                        " and shape ", value.Shape(), " instead of ", DataTypeImpl::ToString(use.type),
+                        " and ", use.shape);
+    }
+
+    for (const auto& use : uses->second) {
+      OpKernel* kernel = GetMutableKernel(use.node_index);
+      const OrtDevice device = kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault);
+      AllocatorPtr allocator = GetAllocator(device);
+      ORT_RETURN_IF_NOT(allocator, "Failed to find allocator for device ", device.ToString());
+
+      // kernels pre-pack initializers that are on their device
+      const Tensor* weight = &value;
+      Tensor weight_on_device;
+      if (value.Location().device != device) {
+        weight_on_device = Tensor(value.DataType(), value.Shape(), allocator);
+        ORT_RETURN_IF_ERROR(data_transfer_mgr_.CopyTensor(value, weight_on_device));
+        weight = &weight_on_device;
+      }
+
+      // the kernel keeps its own pre-packed copy of the new value, even if the old one was shared
+      bool is_packed = false;
+      ORT_RETURN_IF_ERROR(kernel->PrePack(*weight, use.input_idx, allocator, is_packed, nullptr));
+      ORT_RETURN_IF_NOT(is_packed, "The kernel of node ", graph_viewer_->GetNode(use.node_index)->Name(),
+                        " did not pre-pack the new value of initializer ", name);
+    }
+    found = true;
+  }
+
+  for (auto& entry : subgraph_session_states_) {
+    for (auto& name_to_subgraph_session_state : entry.second) {
+      SessionState& subgraph_session_state = *name_to_subgraph_session_state.second;
+      // a subgraph that is finalized later would read the old value from the graph
+      ORT_RETURN_IF_ERROR(subgraph_session_state.EnsureFinalized());
+      ORT_RETURN_IF_ERROR(subgraph_session_state.UpdateInitializer(name, value, found));
+    }
+  }
+
+  return Status::OK();
+}
+
 const SessionState* SessionState::GetSubgraphSessionState(onnxruntime::NodeIndex index,
                                                           const std::string& attribute_name) const {
   return const_cast<SessionState*>(this)->GetMutableSubgraphSessionState(index, attribute_name);
@@ -1378,9 +1762,23 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  size_t max_streams_per_device = 1;
+  const std::string max_streams_per_device_str =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMaxStreamsPerDevice, "1");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_streams_per_device_str, max_streams_per_device) &&
+                        max_streams_per_device > 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigMaxStreamsPerDevice, ": ", max_streams_per_device_str);
+  // a captured graph replays the kernels of a single stream
+  for (const auto& ep : execution_providers_) {
+    if (ep->IsGraphCaptureEnabled()) {
+      max_streams_per_device = 1;
+    }
+  }
+
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   max_streams_per_device);
 
 #ifdef _WIN32
 
@@ -1418,6 +1816,50 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   GetMemoryProfiler()->Init(GetExecutionPlan(), GetOrtValueNameIdxMap());
 #endif
 
+#ifdef ORT_ENABLE_STREAM
+  // set the has_device_stream_enabled_ep_ flag
+  has_device_stream_enabled_ep_ = false;
+  if (p_seq_exec_plan_.has_value()) {
+    auto& execution_plan = (*p_seq_exec_plan_).execution_plan;
+    for (size_t i = 0; i < execution_plan.size(); ++i) {
+      auto& logic_stream = execution_plan[i];
+      if (logic_stream->steps_.size() > 0) {
+        auto create_stream_fn = GetStreamHandleRegistryInstance().GetCreateStreamFn(logic_stream->device_.Type());
+        if (create_stream_fn) {
+          has_device_stream_enabled_ep_ = true;
+        }
+      }
+    }
+  }
+#endif
+
+  ORT_RETURN_IF_ERROR(
+      session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
+
+  // The branches of an If node may be initialized on their first execution. What the parent session state needs to
+  // set up the execution of the subgraph (the plan and the input/output mappings) is available at this point.
+  if (parent_node != nullptr && parent_node->OpType() == "If" && parent_node->Domain() == kOnnxDomain &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazySubgraphInitialization, "0") == "1") {
+    finalization_deferred_ = true;
+    deferred_finalization_ = [this, graph_location, &kernel_registry_manager, session_options, remove_initializers,
+                              constant_initializers_use_count]() mutable {
+      return FinalizeInitializersAndKernels(graph_location, kernel_registry_manager, session_options,
+                                            remove_initializers, constant_initializers_use_count);
+    };
+    LOGS(logger_, INFO) << "Deferring the initialization of subgraph '" << graph_.Name() << "' of node '"
+                        << parent_node->Name() << "' until it is executed.";
+    return Status::OK();
+  }
+
+  return FinalizeInitializersAndKernels(graph_location, kernel_registry_manager, session_options, remove_initializers,
+                                        constant_initializers_use_count);
+}
+
+Status SessionState::FinalizeInitializersAndKernels(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                                    const KernelRegistryManager& kernel_registry_manager,
+                                                    const SessionOptions& session_options,
+                                                    bool remove_initializers,
+                                                    InlinedHashMap<std::string, size_t>& constant_initializers_use_count) {
   // Note: For Training Prepacking should be always disabled.
   // For inference it is enabled by default, but users can choose to disable it via session options.
   const bool disable_prepacking =
@@ -1458,23 +1900,6 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
 #endif
 
-#ifdef ORT_ENABLE_STREAM
-  // set the has_device_stream_enabled_ep_ flag
-  has_device_stream_enabled_ep_ = false;
-  if (p_seq_exec_plan_.has_value()) {
-    auto& execution_plan = (*p_seq_exec_plan_).execution_plan;
-    for (size_t i = 0; i < execution_plan.size(); ++i) {
-      auto& logic_stream = execution_plan[i];
-      if (logic_stream->steps_.size() > 0) {
-        auto create_stream_fn = GetStreamHandleRegistryInstance().GetCreateStreamFn(logic_stream->device_.Type());
-        if (create_stream_fn) {
-          has_device_stream_enabled_ep_ = true;
-        }
-      }
-    }
-  }
-#endif
-
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1489,7 +1914,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             return Status::OK();
           },
           logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, session_options,
-          memory_profile_func, name_to_buffered_tensor_));
+          memory_profile_func, name_to_buffered_tensor_, thread_pool_));
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1505,14 +1930,22 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+  if (metrics_) {
+    node_metrics_.resize(graph_viewer_->MaxNodeIndex());
+    for (const auto& node : graph_viewer_->Nodes()) {
+      const std::string& op_type = node.Domain().empty() || node.Domain() == kOnnxDomainAlias
+                                       ? node.OpType()
+                                       : MakeString(node.Domain(), ".", node.OpType());
+      const std::string node_name = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
+      node_metrics_[node.Index()] = metrics_->RegisterNode(metrics_node_prefix_ + node_name, op_type);
+    }
+  }
+
   if (!disable_prepacking) {
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
   }
 
-  ORT_RETURN_IF_ERROR(
-      session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
-
   // Need to recurse into subgraph session state instances to finalize them and add the execution info
 
   // Currently all subgraphs need to be executed using the sequential EP due to potential deadlock with the current
@@ -1532,6 +1965,11 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                   "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
 
       SessionState& subgraph_session_state = *entry->second;
+      if (metrics_) {
+        subgraph_session_state.metrics_ = metrics_;
+        subgraph_session_state.metrics_node_prefix_ = MakeString(metrics_node_prefix_, node.Name(), "/", attr_name, "/");
+      }
+      subgraph_session_state.profile_memory_ = profile_memory_;
 
       // recurse
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -26,9 +28,12 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/session_metrics.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -217,16 +222,13 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  In training scenarios, a pattern is generated and cached if none is found.
+  The returned entry stays valid while the caller holds it, even if the cache evicts it,
+  and contains the inferred shapes generated together with the pattern.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternCacheEntry> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
-      gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      gsl::span<const int> feed_mlvalue_idxs) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -243,6 +245,37 @@ class SessionState {
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Whether a cached memory pattern may be used for inputs smaller than the inputs it was generated with
+  (kOrtSessionOptionsMemoryPatternShapeBucketSize). Tensors then may use only part of their planned block.
+  */
+  bool GetMemoryPatternUsesShapeBuckets() const { return mem_pattern_cache_.UsesShapeBuckets(); }
+
+  // Set before the session state is finalized to record node latencies to 'metrics'.
+  // Subgraph session states share the metrics of their parent.
+  void SetMetrics(SessionMetrics* metrics) { metrics_ = metrics; }
+
+  // The histograms to record the latency of a node to, or nullptr if no metrics are recorded.
+  const SessionMetrics::NodeHistograms* GetNodeMetrics(NodeIndex node_index) const {
+    return node_index < node_metrics_.size() && node_metrics_[node_index].node ? &node_metrics_[node_index] : nullptr;
+  }
+
+  // Set before the session state is finalized to add a memory timeline to the profile
+  // (kOrtSessionOptionsConfigProfileMemory). Subgraph session states inherit it from their parent.
+  void SetProfileMemory(bool profile_memory) { profile_memory_ = profile_memory; }
+
+  // Whether the memory timeline is recorded. Only relevant while the profiler is enabled.
+  bool ProfileMemory() const { return profile_memory_; }
+
+  /**
+  Replace the value of an initializer of this graph and its subgraphs after the session state is finalized.
+  The new value is copied into a new buffer of the initializer and is pre-packed again by the kernels that pre-packed
+  the old value. The optimized graph and the kernel instances are kept.
+  Must not be called while the session state is executing.
+  @param found Set to true if the initializer is used by this graph or one of its subgraphs.
+  */
+  Status UpdateInitializer(const std::string& name, const Tensor& value, bool& found);
+
   /**
   Get enable memory re-use flag.
   */
@@ -341,6 +374,19 @@ class SessionState {
     return subgraph_session_states_;
   }
 
+  /**
+   * Creates the initializers and kernels of a subgraph whose finalization was deferred until it is first executed
+   * (see kOrtSessionOptionsConfigLazySubgraphInitialization). Does nothing if the session state is fully finalized.
+   * May be called concurrently; the first call does the work and all calls return its result.
+   */
+  Status EnsureFinalized() const;
+
+  /**
+   * Calls EnsureFinalized() for all the subgraph session states nested in this one, including subgraphs which only
+   * become available once their parent subgraph is finalized. Returns early if 'stop' is set.
+   */
+  Status FinalizeDeferredSubgraphs(const std::atomic<bool>& stop) const;
+
 #ifdef ORT_ENABLE_STREAM
   std::unique_ptr<DeviceStreamCollection> AcquireDeviceStreamCollection() const;
 
@@ -384,6 +430,14 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  /**
+   * Prepack the constant initialized tensors with the kernels of different nodes running in parallel on the intra-op
+   * thread pool. Only used when the pre-packed weights are not shared between kernels, processes or sessions.
+   * An initializer is released by the task that pre-packs its last use, as in PrepackConstantInitializedTensors().
+   */
+  Status PrepackConstantInitializedTensorsInParallel(
+      InlinedHashMap<std::string, size_t>& constant_initializers_use_count);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -403,6 +457,18 @@ class SessionState {
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
                                   bool graph_info_already_created = false);
 
+  // The part of FinalizeSessionStateImpl that creates the initializers and kernels, and finalizes the subgraphs.
+  // This part is deferred for a lazily initialized subgraph.
+  Status FinalizeInitializersAndKernels(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+                                        const KernelRegistryManager& kernel_registry_manager,
+                                        const SessionOptions& session_options,
+                                        bool remove_initializers,
+                                        InlinedHashMap<std::string, size_t>& constant_initializers_use_count);
+
+  // Returns true if this session state and the ones between it and 'ancestor' are finalized along with 'ancestor',
+  // i.e. none of them was initialized lazily. Otherwise the state of 'ancestor' may already be in use.
+  bool IsFinalizedWith(const SessionState& ancestor) const;
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       gsl::span<const OrtValue> inputs,
@@ -417,6 +483,23 @@ class SessionState {
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
+  // pre-packed weights mapped from kOrtSessionOptionsConfigSharedPrepackedWeightsDir.
+  // must live longer than the session_kernels_, which use them.
+  std::vector<PrePackedWeights> shared_prepacked_weights_;
+
+  // kernel inputs that pre-packed a constant initializer, by initializer name. Used to pre-pack an updated value.
+  struct PrePackedInitializerUse {
+    NodeIndex node_index;
+    int input_idx;
+    MLDataType type;
+    TensorShape shape;
+  };
+  InlinedHashMap<std::string, InlinedVector<PrePackedInitializerUse>> prepacked_initializer_uses_;
+
+  // pre-packed weights loaded from, or to be saved to, kOrtSessionOptionsConfigPrepackedWeightsFile.
+  // must live longer than the session_kernels_, which use them.
+  std::unique_ptr<PrepackedWeightsFile> prepacked_weights_file_;
+
   // cache of the constructed kernels to avoid spending construction time per executor
   std::vector<std::unique_ptr<OpKernel>> session_kernels_;
   Graph& graph_;
@@ -493,18 +576,16 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  mutable MemoryPatternCache mem_pattern_cache_;
+
+  SessionMetrics* metrics_{nullptr};
+  // prefix of the names the nodes of this graph are registered with in metrics_, for subgraphs
+  std::string metrics_node_prefix_;
+  // indexed by NodeIndex
+  std::vector<SessionMetrics::NodeHistograms> node_metrics_;
+
+  bool profile_memory_{false};
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -539,6 +620,15 @@ class SessionState {
 #endif
 
   SessionState* parent_ = nullptr;
+
+  // set for a subgraph whose initializers and kernels are created on first execution. deferred_finalization_ runs
+  // the rest of FinalizeSessionStateImpl once, under deferred_finalization_mutex_.
+  bool finalization_deferred_ = false;
+  mutable std::function<Status()> deferred_finalization_;
+  mutable std::atomic<bool> deferred_finalization_done_{false};
+  mutable Status deferred_finalization_status_;
+  mutable OrtMutex deferred_finalization_mutex_;
+
   // Assign each graph in each session an unique id.
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   int graph_id_ = 0;
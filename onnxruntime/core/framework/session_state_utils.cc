@@ -1,9 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
@@ -28,6 +30,7 @@
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
@@ -91,6 +94,39 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// Loads the external data of tensor_proto into p_tensor, which is already allocated on the target device, and
+// initializes ort_value with it.
+// If external_data_loader is not null it loads the data directly. Otherwise the data is loaded into CPU memory
+// (using mmap, so no CPU memory is allocated in advance) and copied to the device.
+static common::Status LoadExtDataToDeviceTensor(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
+                                                const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                const AllocatorPtr& default_cpu_alloc,
+                                                const DataTransferManager& data_transfer_mgr,
+                                                const IExternalDataLoader* external_data_loader,
+                                                std::unique_ptr<Tensor>& p_tensor, OrtValue& ort_value,
+                                                Tensor* buffered_tensor = nullptr) {
+  if (external_data_loader) {
+    ORT_RETURN_IF_ERROR(utils::LoadExtDataToTensorFromTensorProto(env, proto_path, tensor_proto,
+                                                                  *external_data_loader, *p_tensor));
+
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+    return common::Status::OK();
+  }
+
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  std::unique_ptr<Tensor> p_deserialize_tensor = std::make_unique<Tensor>(type, TensorShape(), default_cpu_alloc);
+
+  OrtCallback ext_data_deleter;
+  std::optional<ScopedOrtCallbackInvoker> scoped_ort_callback_invoker;
+  ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_deserialize_tensor,
+                                                 ext_data_deleter, buffered_tensor));
+  scoped_ort_callback_invoker = ScopedOrtCallbackInvoker(ext_data_deleter);
+  // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
+
+  return CopyTensorFromCPUToDevice(data_transfer_mgr, p_deserialize_tensor, p_tensor, ort_value);
+}
+
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
@@ -101,6 +137,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              const ExternalDataLoaderManager& external_data_loader_mgr,
                                              bool use_device_allocator_for_initializers = false,
+                                             bool use_external_data_in_place = true,
                                              Tensor* buffered_tensor = nullptr) {
   if (bool(alloc) == (m != nullptr)) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
@@ -119,18 +156,16 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   auto device_type = memory_info.device.Type();
 
   if (utils::HasExternalData(tensor_proto)) {
-    auto external_data_loader = external_data_loader_mgr.GetExternalDataLoader(memory_info);
+    // compressed data is decompressed in CPU memory, an external data loader can't load it
+    const bool compressed = utils::HasCompressedExternalData(tensor_proto);
+    auto external_data_loader = compressed ? nullptr : external_data_loader_mgr.GetExternalDataLoader(memory_info);
     if (external_data_loader) {
       // if custom external data loader is used, always allocate memory on device - p_tensor
       ORT_RETURN_IF_ERROR(AllocateTensor(m, p_tensor, type, tensor_shape, use_device_allocator_for_initializers, alloc));
 
-      ORT_RETURN_IF_ERROR(utils::LoadExtDataToTensorFromTensorProto(env, proto_path, tensor_proto,
-                                                                    *external_data_loader, *p_tensor));
-
-      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
-      ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
-      return common::Status::OK();
-    } else if (device_type == OrtDevice::CPU) {
+      return LoadExtDataToDeviceTensor(env, proto_path, tensor_proto, default_cpu_alloc, data_transfer_mgr,
+                                       external_data_loader, p_tensor, ort_value, buffered_tensor);
+    } else if (device_type == OrtDevice::CPU && (use_external_data_in_place || buffered_tensor)) {
       // for external initializer on CPU we will use mmap for large initializers so don't need to allocate memory in advance
       p_tensor = std::make_unique<Tensor>();
 
@@ -145,29 +180,28 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       MLDataType ml_tensor_type = DataTypeImpl::GetType<Tensor>();
       ort_value.Init(p_tensor.release(), ml_tensor_type, deleter);
       return common::Status::OK();
+    } else if (device_type == OrtDevice::CPU) {
+      // the external data can't back the tensor as is (alignment, endianness or compression), so copy or decompress
+      // it into allocated memory
+      ORT_RETURN_IF_ERROR(AllocateTensor(m, p_tensor, type, tensor_shape, use_device_allocator_for_initializers, alloc));
+      if (compressed) {
+        ORT_RETURN_IF_ERROR(utils::DecompressExternalDataIntoTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
+      } else {
+        ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_tensor));
+      }
+      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+      ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+      return common::Status::OK();
     } else {  // non-cpu tensor
       if (tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "string tensor is not supported for copying between allocators");
       }
 
-      // deserialize to CPU first for non-CPU allocator, then copy to device
-      // for external initializer load on non-CPU device:
-      // 1. allocate memory on device - p_tensor
-      // 2. load initializer into CPU memory - p_deserialize_tensor,
-      //    we will use mmap so no need to allocate memory on CPU in advance
-      // 3. copy tensor from CPU to device - p_deserialize_tensor -> p_tensor
+      // for external initializer load on non-CPU device, allocate memory on device - p_tensor, then load the data
       ORT_RETURN_IF_ERROR(AllocateTensor(m, p_tensor, type, tensor_shape, use_device_allocator_for_initializers, alloc));
 
-      std::unique_ptr<Tensor> p_deserialize_tensor = std::make_unique<Tensor>(type, TensorShape(), default_cpu_alloc);
-
-      OrtCallback ext_data_deleter;
-      std::optional<ScopedOrtCallbackInvoker> scoped_ort_callback_invoker;
-      ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_deserialize_tensor,
-                                                     ext_data_deleter, buffered_tensor));
-      scoped_ort_callback_invoker = ScopedOrtCallbackInvoker(ext_data_deleter);
-      // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
-
-      return CopyTensorFromCPUToDevice(data_transfer_mgr, p_deserialize_tensor, p_tensor, ort_value);
+      return LoadExtDataToDeviceTensor(env, proto_path, tensor_proto, default_cpu_alloc, data_transfer_mgr,
+                                       nullptr, p_tensor, ort_value, buffered_tensor);
     }
   } else {
     // for internal initializer, always allocate memory on device - p_tensor
@@ -272,7 +306,8 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -322,6 +357,16 @@ common::Status SaveInitializedTensors(
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
+  // CPU initializers with external data that can be used as is are backed by the mmap'd file and need no memory
+  const bool use_mapped_external_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseMappedExternalInitializers,
+                                                        "1") == "1";
+  auto use_external_data_in_place = [&](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return use_mapped_external_initializers && utils::HasExternalData(tensor_proto) &&
+           exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU &&
+           utils::CanUseExternalDataInPlace(tensor_proto);
+  };
+
   // tensors requiring a specific allocation order are traced first, to ensure they are allocated in order
   // NB1: vector with init allocation order may contain a subset of all tensors (or none at all)
   // NB2: only skip tracing and planning memory when data is external (i.e mmap) and on CPU.
@@ -331,7 +376,7 @@ common::Status SaveInitializedTensors(
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!use_external_data_in_place(ort_value_index, *entry->second)) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -348,6 +393,10 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (use_external_data_in_place(entry.first, *entry.second)) {
+      // planned memory would be unused
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -367,6 +416,53 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  auto save_initializer = [&](const std::string& name, int ort_value_index, const OrtValue& ort_value) -> Status {
+    // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
+    // so we need to output this message prior to calling save_tensor_func
+    VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << ort_value_index;
+
+    // any outer scope value is shadowed by a local value and can't override it.
+    // due to that check_outer_scope is false
+    const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
+#if !defined(DISABLE_SPARSE_TENSORS)
+    const bool sparse = graph.GetGraph().IsSparseInitializer(name);
+    return save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse);
+#else
+    return save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false);
+#endif
+  };
+
+  // External initializers that are copied to a device, decompressed, or loaded by an external data loader that
+  // supports concurrent loads, are allocated in order and then loaded in parallel, so reading the files overlaps with
+  // the copies to the device and the decompression.
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+  const bool load_in_parallel =
+      concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1 &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelInitializerLoading, "0") == "1";
+  struct DeferredInitializer {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    const IExternalDataLoader* external_data_loader;
+    // the data is compressed and is decompressed straight into the allocated CPU tensor
+    bool decompress;
+    std::unique_ptr<Tensor> p_tensor;
+    OrtValue ort_value;
+    Status status;
+  };
+  std::vector<DeferredInitializer> deferred_initializers;
+
+  // External initializers that are copied into CPU memory as is are read together once the others are created, so
+  // the reads of each file can be in flight at the same time (see Env::ReadFileRegionsIntoBuffers).
+  struct FileReadInitializer {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    std::basic_string<ORTCHAR_T> file_path;
+    FileOffsetType offset;
+    std::unique_ptr<Tensor> p_tensor;
+  };
+  std::vector<FileReadInitializer> file_read_initializers;
+
   // 3. create weight tensors based on weights buffer
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
@@ -389,8 +485,6 @@ common::Status SaveInitializedTensors(
       AllocatorPtr alloc;
       // TODO: if the tensor need be copied, does it have enough room?
       ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
       Tensor* p_tensor = nullptr;
       if (auto iter = buffered_tensors.find(name);
@@ -399,9 +493,53 @@ common::Status SaveInitializedTensors(
         buffered_tensors.erase(iter);
       }
 
+      if (load_in_parallel && p_tensor == nullptr && utils::HasExternalData(tensor_proto) &&
+          tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+        const auto& memory_info = alloc ? alloc->Info() : m->GetAllocInfo();
+        const bool compressed = utils::HasCompressedExternalData(tensor_proto);
+        const bool on_cpu = memory_info.device.Type() == OrtDevice::CPU;
+        const auto* external_data_loader =
+            compressed ? nullptr : external_data_loader_mgr.GetExternalDataLoader(memory_info);
+        if (external_data_loader ? external_data_loader->SupportsConcurrentLoads() : (!on_cpu || compressed)) {
+          TensorShape tensor_shape = utils::GetTensorShapeFromTensorProto(tensor_proto);
+          const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+          std::unique_ptr<Tensor> p_device_tensor;
+          ORT_RETURN_IF_ERROR(AllocateTensor(m.has_value() ? &*m : nullptr, p_device_tensor, type, tensor_shape,
+                                             use_device_allocator_for_initializers, alloc));
+          deferred_initializers.push_back({ort_value_index, &tensor_proto, external_data_loader, compressed && on_cpu,
+                                           std::move(p_device_tensor), OrtValue(), Status::OK()});
+          continue;
+        }
+      }
+
+      if (p_tensor == nullptr && utils::HasExternalData(tensor_proto) &&
+          tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+          !use_external_data_in_place(ort_value_index, tensor_proto)) {
+        const auto& memory_info = alloc ? alloc->Info() : m->GetAllocInfo();
+        std::basic_string<ORTCHAR_T> file_path;
+        FileOffsetType offset;
+        size_t length;
+        if (memory_info.device.Type() == OrtDevice::CPU &&
+            external_data_loader_mgr.GetExternalDataLoader(memory_info) == nullptr &&
+            utils::GetExternalDataFileRegion(graph_loc, tensor_proto, file_path, offset, length)) {
+          TensorShape tensor_shape = utils::GetTensorShapeFromTensorProto(tensor_proto);
+          const DataTypeImpl* const type =
+              DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+          std::unique_ptr<Tensor> p_cpu_tensor;
+          ORT_RETURN_IF_ERROR(AllocateTensor(m.has_value() ? &*m : nullptr, p_cpu_tensor, type, tensor_shape,
+                                             use_device_allocator_for_initializers, alloc));
+          if (p_cpu_tensor->SizeInBytes() == length) {
+            file_read_initializers.push_back({ort_value_index, &tensor_proto, std::move(file_path), offset,
+                                              std::move(p_cpu_tensor)});
+            continue;
+          }
+        }
+      }
+
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
                                          default_cpu_alloc, ort_value, data_transfer_mgr, external_data_loader_mgr,
-                                         use_device_allocator_for_initializers, p_tensor);
+                                         use_device_allocator_for_initializers,
+                                         use_external_data_in_place(ort_value_index, tensor_proto), p_tensor);
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -409,19 +547,92 @@ common::Status SaveInitializedTensors(
       }
     }
 
-    // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
-    // so we need to output this message prior to calling save_tensor_func
-    VLOGS(logger, 1) << "Adding weight with name : " << name << " with index: " << ort_value_index;
+    ORT_RETURN_IF_ERROR(save_initializer(name, ort_value_index, ort_value));
+  }
 
-    // any outer scope value is shadowed by a local value and can't override it.
-    // due to that check_outer_scope is false
-    const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
-#if !defined(DISABLE_SPARSE_TENSORS)
-    const bool sparse = graph.GetGraph().IsSparseInitializer(name);
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
-#else
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false));
-#endif
+  if (!file_read_initializers.empty()) {
+    // grouped by file, in file order
+    std::sort(file_read_initializers.begin(), file_read_initializers.end(),
+              [](const FileReadInitializer& a, const FileReadInitializer& b) {
+                return std::tie(a.file_path, a.offset) < std::tie(b.file_path, b.offset);
+              });
+
+    std::vector<Env::FileRegionRead> reads;
+    for (auto file_begin = file_read_initializers.begin(); file_begin != file_read_initializers.end();) {
+      const auto file_end = std::find_if(file_begin, file_read_initializers.end(),
+                                         [&](const FileReadInitializer& initializer) {
+                                           return initializer.file_path != file_begin->file_path;
+                                         });
+
+      reads.clear();
+      for (auto it = file_begin; it != file_end; ++it) {
+        const size_t length = it->p_tensor->SizeInBytes();
+        char* buffer = static_cast<char*>(it->p_tensor->MutableDataRaw());
+        reads.push_back({it->offset, length, gsl::make_span(buffer, length)});
+      }
+
+      Status st = env.ReadFileRegionsIntoBuffers(file_begin->file_path.c_str(), reads);
+      if (!st.IsOK()) {
+        std::ostringstream oss;
+        oss << "Reading external initializers from " << ToUTF8String(file_begin->file_path) << " failed."
+            << st.ErrorMessage();
+        return Status(st.Category(), st.Code(), oss.str());
+      }
+
+      file_begin = file_end;
+    }
+
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    for (auto& initializer : file_read_initializers) {
+      OrtValue ort_value;
+      ort_value.Init(initializer.p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+      ORT_RETURN_IF_ERROR(save_initializer(initializer.tensor_proto->name(), initializer.ort_value_index, ort_value));
+    }
+  }
+
+  if (!deferred_initializers.empty()) {
+    LOGS(logger, INFO) << "Loading " << deferred_initializers.size() << " external initializer(s) in parallel.";
+
+    // largest first, so a large initializer doesn't start loading last
+    std::sort(deferred_initializers.begin(), deferred_initializers.end(),
+              [](const DeferredInitializer& a, const DeferredInitializer& b) {
+                return a.p_tensor->SizeInBytes() > b.p_tensor->SizeInBytes();
+              });
+
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(deferred_initializers.size()), [&](std::ptrdiff_t i) {
+          auto& initializer = deferred_initializers[i];
+          ORT_TRY {
+            if (initializer.decompress) {
+              initializer.status = utils::DecompressExternalDataIntoTensor(env, graph_loc, *initializer.tensor_proto,
+                                                                           *initializer.p_tensor);
+              if (initializer.status.IsOK()) {
+                auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+                initializer.ort_value.Init(initializer.p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+              }
+            } else {
+              initializer.status = LoadExtDataToDeviceTensor(env, graph_loc, *initializer.tensor_proto,
+                                                             default_cpu_alloc, data_transfer_mgr,
+                                                             initializer.external_data_loader, initializer.p_tensor,
+                                                             initializer.ort_value);
+            }
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+            });
+          }
+        });
+
+    for (auto& initializer : deferred_initializers) {
+      const std::string& name = initializer.tensor_proto->name();
+      if (!initializer.status.IsOK()) {
+        std::ostringstream oss;
+        oss << "Deserialize tensor " << name << " failed." << initializer.status.ErrorMessage();
+        return Status(initializer.status.Category(), initializer.status.Code(), oss.str());
+      }
+      ORT_RETURN_IF_ERROR(save_initializer(name, initializer.ort_value_index, initializer.ort_value));
+    }
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -25,6 +25,9 @@ class OrtValueNameIdxMap;
 class DataTransferManager;
 class ExternalDataLoaderManager;
 class NodeArg;
+namespace concurrency {
+class ThreadPool;
+}
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 class MemoryInfo;
 #endif
@@ -50,7 +53,8 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    concurrency::ThreadPool* thread_pool);
 
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_prepacked_weights_store.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#include "core/platform/env.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+// Writes the buffer to 'path' through a temporary file, so other processes never map a partially written file.
+Status WriteBufferFile(const std::filesystem::path& path, const void* data, size_t size) {
+  // unique per process and per call, as sessions in one process may write the same weight concurrently
+  static std::atomic<uint64_t> temp_file_counter{0};
+  auto temp_path = path;
+  temp_path += "." + std::to_string(Env::Default().GetSelfPid()) + "." + std::to_string(temp_file_counter++) + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file, "Failed to create pre-packed weight file: ", temp_path.string());
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    ORT_RETURN_IF_NOT(file.flush(), "Failed to write pre-packed weight file: ", temp_path.string());
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    // another process may have written the file first, which is fine as the content is the same
+    ORT_RETURN_IF_NOT(std::filesystem::exists(path, error), "Failed to write pre-packed weight file: ", path.string());
+  }
+  return Status::OK();
+}
+}  // namespace
+
+SharedPrepackedWeightsStore::SharedPrepackedWeightsStore(const std::filesystem::path& directory)
+    : directory_(directory / ORT_VERSION) {
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  ORT_ENFORCE(!error, "Failed to create the shared pre-packed weights directory ", directory_.string(), ": ",
+              error.message());
+}
+
+Status SharedPrepackedWeightsStore::GetOrWriteWeight(const std::string& key, const PrePackedWeights& packed_weights,
+                                                     PrePackedWeights& shared_weights) const {
+  ORT_ENFORCE(packed_weights.buffers_.size() == packed_weights.buffer_sizes_.size());
+  shared_weights.buffers_.clear();
+  shared_weights.buffer_sizes_ = packed_weights.buffer_sizes_;
+
+  for (size_t i = 0; i < packed_weights.buffers_.size(); ++i) {
+    const void* buffer = packed_weights.buffers_[i].get();
+    const size_t size = packed_weights.buffer_sizes_[i];
+    // place-holder buffers are kept as they are
+    if (buffer == nullptr || size == 0) {
+      shared_weights.buffers_.emplace_back(nullptr, [](void*) {});
+      continue;
+    }
+
+    const auto path = directory_ / (key + "." + std::to_string(i) + ".bin");
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+      ORT_RETURN_IF_ERROR(WriteBufferFile(path, buffer, size));
+    }
+
+    const auto file_size = std::filesystem::file_size(path, error);
+    ORT_RETURN_IF(error || file_size != size, "Shared pre-packed weight file has an unexpected size: ", path.string());
+
+    Env::MappedMemoryPtr mapped_memory;
+    ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(path.native().c_str(), 0, size, mapped_memory));
+    // guards against hash collisions and files left by other builds
+    ORT_RETURN_IF(std::memcmp(mapped_memory.get(), buffer, size) != 0,
+                  "Shared pre-packed weight file does not match the pre-packed weight: ", path.string());
+
+    // the deleter owns the mapping, so the buffer stays mapped for as long as it is in use
+    std::shared_ptr<char[]> mapping = std::move(mapped_memory);
+    void* data = mapping.get();
+    shared_weights.buffers_.emplace_back(data, [mapping = std::move(mapping)](void*) mutable { mapping.reset(); });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
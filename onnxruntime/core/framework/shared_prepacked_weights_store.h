@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/framework/prepacked_weights.h"
+
+namespace onnxruntime {
+
+// Shares pre-packed weights between processes through files in a directory.
+//
+// Each pre-packed buffer is written once, to a file named after the PrepackedWeightsContainer key of the weight,
+// and every process that produces the same pre-packed weight maps the file instead of keeping its own copy. The
+// mapped pages come from the page cache, so all processes share one copy of them. A directory on a memory backed
+// file system (e.g. /dev/shm) avoids any disk I/O.
+//
+// Pre-packed layouts depend on the onnxruntime version and the CPU, so the files are kept in a subdirectory per
+// version and the directory must not be shared between hosts.
+class SharedPrepackedWeightsStore final {
+ public:
+  explicit SharedPrepackedWeightsStore(const std::filesystem::path& directory);
+
+  // Returns, in 'shared_weights', the buffers of 'packed_weights' mapped read-only from the shared files. The
+  // files are written first if they don't exist. Returns an error if the files can't be written or mapped, or if
+  // their content differs from 'packed_weights'.
+  Status GetOrWriteWeight(const std::string& key, const PrePackedWeights& packed_weights,
+                          PrePackedWeights& shared_weights) const;
+
+ private:
+  const std::filesystem::path directory_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedPrepackedWeightsStore);
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,257 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/slab_arena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+namespace {
+void UpdateMax(std::atomic<int64_t>& max_value, int64_t value) {
+  int64_t current = max_value.load(std::memory_order_relaxed);
+  while (current < value &&
+         !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+int Log2Floor(size_t n) {
+  int r = -1;
+  while (n > 0) {
+    r++;
+    n >>= 1;
+  }
+  return r;
+}
+}  // namespace
+
+SlabArena::SlabArena(std::unique_ptr<IAllocator> resource_allocator, size_t total_memory)
+    : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
+                               OrtAllocatorType::OrtDeviceAllocator,
+                               resource_allocator->Info().device,
+                               resource_allocator->Info().id,
+                               resource_allocator->Info().mem_type)),
+      device_allocator_(std::move(resource_allocator)),
+      memory_limit_(total_memory) {
+  LOGS_DEFAULT(INFO) << "Creating SlabArena for " << device_allocator_->Info().name
+                     << " with " << kNumSizeClasses << " size classes of " << kMinSizeClassBytes << " to "
+                     << kMaxSizeClassBytes << " bytes. memory limit: " << total_memory;
+
+  ORT_ENFORCE(SizeClassForBytes(kMaxSizeClassBytes) == kNumSizeClasses - 1);
+
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    SizeClass& size_class = size_classes_[i];
+    size_class.block_bytes = kBlockHeaderBytes + SizeClassBytes(i);
+    size_class.blocks_per_slab = static_cast<uint32_t>(std::max<size_t>(1, kSlabBytes / size_class.block_bytes));
+    size_class.slabs = std::make_unique<std::atomic<char*>[]>(kMaxSlabsPerSizeClass);
+  }
+}
+
+SlabArena::~SlabArena() {
+  for (auto& size_class : size_classes_) {
+    const uint32_t num_slabs = size_class.num_slabs.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < num_slabs; ++i) {
+      device_allocator_->Free(size_class.slabs[i].load(std::memory_order_relaxed));
+    }
+  }
+}
+
+// static
+size_t SlabArena::SizeClassForBytes(size_t bytes) {
+  // 64, 128, 192 and 256 bytes get a class each. Above that every power of two is split in 4 classes.
+  if (bytes <= 4 * kMinSizeClassBytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / kMinSizeClassBytes;
+  }
+  const int lg = Log2Floor(bytes - 1);
+  return 4 * static_cast<size_t>(lg - 8) + ((bytes - 1) >> (lg - 2));
+}
+
+// static
+size_t SlabArena::SizeClassBytes(size_t size_class) {
+  if (size_class < 4) {
+    return (size_class + 1) * kMinSizeClassBytes;
+  }
+  const size_t lg = 8 + (size_class - 4) / 4;
+  return (size_t{1} << lg) + ((size_class - 4) % 4 + 1) * (size_t{1} << (lg - 2));
+}
+
+SlabArena::BlockHeader* SlabArena::BlockAt(const SizeClass& size_class, uint32_t index) const {
+  char* slab = size_class.slabs[index / size_class.blocks_per_slab].load(std::memory_order_acquire);
+  return reinterpret_cast<BlockHeader*>(slab + (index % size_class.blocks_per_slab) * size_class.block_bytes);
+}
+
+SlabArena::BlockHeader* SlabArena::PopFreeBlock(SizeClass& size_class) {
+  uint64_t head = size_class.free_head.load(std::memory_order_acquire);
+  while (static_cast<uint32_t>(head) != 0) {
+    BlockHeader* block = BlockAt(size_class, static_cast<uint32_t>(head) - 1);
+    // the tag in the upper 32 bits changes on every update so a stale 'next' read here makes the exchange fail
+    const uint64_t new_head = (((head >> 32) + 1) << 32) | block->next.load(std::memory_order_relaxed);
+    if (size_class.free_head.compare_exchange_weak(head, new_head,
+                                                   std::memory_order_acquire, std::memory_order_acquire)) {
+      return block;
+    }
+  }
+  return nullptr;
+}
+
+void SlabArena::PushFreeBlocks(SizeClass& size_class, BlockHeader* first, BlockHeader* last) {
+  uint64_t head = size_class.free_head.load(std::memory_order_relaxed);
+  uint64_t new_head;
+  do {
+    last->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    new_head = (((head >> 32) + 1) << 32) | (uint64_t{first->index} + 1);
+  } while (!size_class.free_head.compare_exchange_weak(head, new_head,
+                                                       std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool SlabArena::TryReserveDeviceBytes(size_t bytes) {
+  const int64_t total = total_allocated_bytes_.fetch_add(static_cast<int64_t>(bytes)) + static_cast<int64_t>(bytes);
+  if (static_cast<size_t>(total) > memory_limit_) {
+    total_allocated_bytes_.fetch_sub(static_cast<int64_t>(bytes));
+    return false;
+  }
+  return true;
+}
+
+SlabArena::BlockHeader* SlabArena::Grow(size_t size_class_index) {
+  SizeClass& size_class = size_classes_[size_class_index];
+  std::lock_guard<OrtMutex> lock(size_class.grow_mutex);
+
+  // another thread may have added a slab while we were waiting
+  if (BlockHeader* block = PopFreeBlock(size_class)) {
+    return block;
+  }
+
+  const uint32_t slab_index = size_class.num_slabs.load(std::memory_order_relaxed);
+  if (slab_index == kMaxSlabsPerSizeClass) {
+    return nullptr;
+  }
+
+  const uint32_t blocks_per_slab = size_class.blocks_per_slab;
+  const size_t slab_bytes = SafeInt<size_t>(size_class.block_bytes) * blocks_per_slab;
+  char* slab = static_cast<char*>(device_allocator_->Alloc(slab_bytes));
+  if (slab == nullptr) {
+    ORT_THROW("Failed to allocate memory for requested buffer of size ", slab_bytes);
+  }
+
+  if (!TryReserveDeviceBytes(slab_bytes)) {
+    device_allocator_->Free(slab);
+    ORT_THROW("Available memory of ", memory_limit_ - static_cast<size_t>(total_allocated_bytes_.load()),
+              " is smaller than requested bytes of ", slab_bytes);
+  }
+
+  for (uint32_t i = 0; i < blocks_per_slab; ++i) {
+    auto* block = new (slab + i * size_class.block_bytes) BlockHeader;
+    block->size_class = static_cast<uint32_t>(size_class_index);
+    block->index = slab_index * blocks_per_slab + i;
+    block->next.store(i + 1 < blocks_per_slab ? block->index + 2 : 0, std::memory_order_relaxed);
+    block->large_bytes = 0;
+  }
+
+  // publish the slab before any of its blocks can be found through the free list
+  size_class.slabs[slab_index].store(slab, std::memory_order_release);
+  size_class.num_slabs.store(slab_index + 1, std::memory_order_release);
+  ++num_slabs_;
+
+  LOGS_DEFAULT(VERBOSE) << "SlabArena extended size class " << SizeClassBytes(size_class_index)
+                        << " by a slab of " << slab_bytes << " bytes.";
+
+  // keep the first block and put the rest, which are already linked together, on the free list
+  if (blocks_per_slab > 1) {
+    PushFreeBlocks(size_class, BlockAt(size_class, slab_index * blocks_per_slab + 1),
+                   BlockAt(size_class, slab_index * blocks_per_slab + blocks_per_slab - 1));
+  }
+
+  return BlockAt(size_class, slab_index * blocks_per_slab);
+}
+
+void* SlabArena::AllocateLarge(size_t size) {
+  const size_t bytes = SafeInt<size_t>(size) + kBlockHeaderBytes;
+  void* mem = device_allocator_->Alloc(bytes);
+  if (mem == nullptr) {
+    ORT_THROW("Failed to allocate memory for requested buffer of size ", bytes);
+  }
+
+  if (!TryReserveDeviceBytes(bytes)) {
+    device_allocator_->Free(mem);
+    ORT_THROW("Available memory of ", memory_limit_ - static_cast<size_t>(total_allocated_bytes_.load()),
+              " is smaller than requested bytes of ", bytes);
+  }
+
+  auto* block = new (mem) BlockHeader;
+  block->size_class = kLargeAllocation;
+  block->index = 0;
+  block->next.store(0, std::memory_order_relaxed);
+  block->large_bytes = size;
+
+  RecordAllocation(size);
+  return static_cast<char*>(mem) + kBlockHeaderBytes;
+}
+
+void SlabArena::RecordAllocation(size_t bytes) {
+  ++num_allocs_;
+  const int64_t in_use = bytes_in_use_.fetch_add(static_cast<int64_t>(bytes)) + static_cast<int64_t>(bytes);
+  UpdateMax(max_bytes_in_use_, in_use);
+  UpdateMax(max_alloc_size_, static_cast<int64_t>(bytes));
+}
+
+void* SlabArena::Alloc(size_t size) {
+  if (size == 0) {
+    LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
+    return nullptr;
+  }
+
+  if (size > kMaxSizeClassBytes) {
+    return AllocateLarge(size);
+  }
+
+  const size_t size_class_index = SizeClassForBytes(size);
+  BlockHeader* block = PopFreeBlock(size_classes_[size_class_index]);
+  if (block == nullptr) {
+    block = Grow(size_class_index);
+    if (block == nullptr) {
+      // the size class can't take another slab
+      return AllocateLarge(size);
+    }
+  }
+
+  RecordAllocation(SizeClassBytes(size_class_index));
+  return reinterpret_cast<char*>(block) + kBlockHeaderBytes;
+}
+
+void SlabArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  auto* block = reinterpret_cast<BlockHeader*>(static_cast<char*>(p) - kBlockHeaderBytes);
+  if (block->size_class == kLargeAllocation) {
+    const size_t bytes = block->large_bytes;
+    bytes_in_use_ -= static_cast<int64_t>(bytes);
+    total_allocated_bytes_ -= static_cast<int64_t>(bytes + kBlockHeaderBytes);
+    block->~BlockHeader();
+    device_allocator_->Free(block);
+    return;
+  }
+
+  ORT_ENFORCE(block->size_class < kNumSizeClasses, "Invalid pointer passed to SlabArena::Free: ", p);
+  bytes_in_use_ -= static_cast<int64_t>(SizeClassBytes(block->size_class));
+  PushFreeBlocks(size_classes_[block->size_class], block, block);
+}
+
+void SlabArena::GetStats(AllocatorStats* stats) {
+  stats->Clear();
+  stats->num_allocs = num_allocs_.load();
+  stats->num_arena_extensions = num_slabs_.load();
+  stats->bytes_in_use = bytes_in_use_.load();
+  stats->total_allocated_bytes = total_allocated_bytes_.load();
+  stats->max_bytes_in_use = max_bytes_in_use_.load();
+  stats->max_alloc_size = max_alloc_size_.load();
+  stats->bytes_limit = static_cast<int64_t>(memory_limit_);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// A segregated-fit allocator with lock-free free lists.
+//
+// Requests are rounded up to one of kNumSizeClasses size classes (4 classes per power of two, so at most 25% of a
+// block is wasted). Each size class carves fixed size blocks out of slabs obtained from the device allocator and
+// keeps free blocks in a lock-free stack, so Alloc/Free of a cached block never takes a lock and never splits or
+// coalesces memory. Slabs are only returned to the device allocator when the arena is destroyed, which keeps the
+// resident size predictable for long-running processes. Requests larger than kMaxSizeClassBytes go directly to the
+// device allocator.
+//
+// Every block is prefixed by a small header that records its size class, so the memory returned by the device
+// allocator must be CPU accessible.
+//
+// This is not a BFCArena: it reports OrtDeviceAllocator as its allocator type so arena specific code paths
+// (Shrink, stream aware allocation) do not apply to it.
+class SlabArena : public IAllocator {
+ public:
+  static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+
+  // The header in front of each block. Keeps the user visible pointer aligned to kBlockHeaderBytes.
+  static constexpr size_t kBlockHeaderBytes = 64;
+  static constexpr size_t kMinSizeClassBytes = 64;
+  static constexpr size_t kMaxSizeClassBytes = 1 << 20;
+  static constexpr size_t kNumSizeClasses = 52;
+  // Blocks of a size class are carved out of slabs of (at least) this size.
+  static constexpr size_t kSlabBytes = 1 << 20;
+  static constexpr size_t kMaxSlabsPerSizeClass = 1024;
+
+  SlabArena(std::unique_ptr<IAllocator> resource_allocator, size_t total_memory = DEFAULT_MAX_MEM);
+
+  ~SlabArena() override;
+
+  void* Alloc(size_t size) override;
+
+  void Free(void* p) override;
+
+  void GetStats(AllocatorStats* stats) override;
+
+  // Size class index for a request of 'bytes' (<= kMaxSizeClassBytes) and the payload size of a size class.
+  static size_t SizeClassForBytes(size_t bytes);
+  static size_t SizeClassBytes(size_t size_class);
+
+ private:
+  static constexpr uint32_t kLargeAllocation = std::numeric_limits<uint32_t>::max();
+
+  struct BlockHeader {
+    // size class of the block, kLargeAllocation for requests served directly by the device allocator
+    uint32_t size_class;
+    // index of the block within its size class
+    uint32_t index;
+    // free list link: index + 1 of the next free block, 0 for the end of the list
+    std::atomic<uint32_t> next;
+    // payload size of a large allocation
+    size_t large_bytes;
+  };
+  static_assert(sizeof(BlockHeader) <= kBlockHeaderBytes, "BlockHeader must fit in kBlockHeaderBytes");
+
+  struct SizeClass {
+    // (ABA tag << 32) | (index + 1) of the first free block, 0 when the free list is empty
+    std::atomic<uint64_t> free_head{0};
+    size_t block_bytes = 0;
+    uint32_t blocks_per_slab = 0;
+    std::atomic<uint32_t> num_slabs{0};
+    std::unique_ptr<std::atomic<char*>[]> slabs;
+    // serializes growing the size class by a slab
+    OrtMutex grow_mutex;
+  };
+
+  BlockHeader* BlockAt(const SizeClass& size_class, uint32_t index) const;
+
+  BlockHeader* PopFreeBlock(SizeClass& size_class);
+  void PushFreeBlocks(SizeClass& size_class, BlockHeader* first, BlockHeader* last);
+
+  // Adds a slab to the size class and returns one of its blocks. Returns nullptr if the size class has no room
+  // for another slab.
+  BlockHeader* Grow(size_t size_class_index);
+
+  void* AllocateLarge(size_t size);
+
+  // Accounts for 'bytes' more memory being taken from the device allocator.
+  // Returns false, without accounting for them, if that would exceed the memory limit.
+  bool TryReserveDeviceBytes(size_t bytes);
+
+  void RecordAllocation(size_t bytes);
+
+  std::unique_ptr<IAllocator> device_allocator_;
+  const size_t memory_limit_;
+
+  std::array<SizeClass, kNumSizeClasses> size_classes_;
+
+  std::atomic<int64_t> num_allocs_{0};
+  std::atomic<int64_t> num_slabs_{0};
+  std::atomic<int64_t> bytes_in_use_{0};
+  std::atomic<int64_t> max_bytes_in_use_{0};
+  std::atomic<int64_t> max_alloc_size_{0};
+  std::atomic<int64_t> total_allocated_bytes_{0};
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SlabArena);
+};
+
+}  // namespace onnxruntime
@@ -22,6 +22,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const logging::Logger& sess_logger,
                                                bool single_thread_mode)
     : session_state_(&sess_state),
+      thread_pools_{sess_state.GetThreadPool(), sess_state.GetInterOpThreadPool()},
       frame_(feed_mlvalue_idxs,
              feeds,
              fetch_mlvalue_idxs,
@@ -90,6 +91,7 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const logging::Logger& sess_logger,
                                                bool single_thread_mode)
     : session_state_(&sess_state),
+      thread_pools_{sess_state.GetThreadPool(), sess_state.GetInterOpThreadPool()},
       frame_(feed_mlvalue_idxs,
              feeds,
              fetch_mlvalue_idxs,
@@ -216,6 +218,9 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
       ctx.CompleteTask();
       return;
     }
+    if (const auto* priority_scope = ctx.GetPriorityScope()) {
+      priority_scope->YieldIfPreempted();
+    }
     bool continue_flag = true;
     Status status;
     ORT_TRY {
@@ -248,7 +253,7 @@ void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single
                         const bool& terminate_flag, SessionScope& session_scope) {
   auto* plan = ctx.GetSessionState().GetExecutionPlan();
   auto& downstream_map = plan->downstream_map;
-  auto* tp = single_thread_mode ? nullptr : ctx.GetSessionState().GetInterOpThreadPool();
+  auto* tp = single_thread_mode ? nullptr : ctx.GetInterOpThreadPool();
   auto it = downstream_map.find(trigger);
   if (it != downstream_map.end()) {
     for (auto downstream : it->second) {
@@ -10,6 +10,7 @@
 #include "core/graph/basic_types.h"
 #include "core/common/inlined_containers.h"
 #include "core/framework/memory_info.h"
+#include "core/framework/run_priority_gate.h"
 #ifdef ENABLE_TRAINING
 #include "core/framework/partial_graph_execution_state.h"
 #endif
@@ -18,9 +19,19 @@ namespace onnxruntime {
 class SessionState;
 
 class SessionScope;
+namespace concurrency {
+class ThreadPool;
+}
 typedef InlinedHashMap<std::string, OrtValue> OrtValueCache;
 typedef std::shared_ptr<OrtValueCache> OrtValueCachePtr;
 
+// The thread pools of a run. They are those of the session state, except for the runs of a session that shares the
+// session state of another one and has thread pools of its own.
+struct RunThreadPools {
+  concurrency::ThreadPool* intra_op{};
+  concurrency::ThreadPool* inter_op{};
+};
+
 // Execution context that support to execute a command on stream.
 // It is composed by following components:
 // 1. a execution frame
@@ -96,6 +107,15 @@ class StreamExecutionContext {
   // 2. multi-threads mode: use inter-op thread pool to schedule the N streams.
   bool SingleThreadMode() const { return single_thread_mode_; }
 
+  // The priority of the run, if lower priority runs yield to higher priority ones. May be nullptr.
+  void SetPriorityScope(const RunPriorityGate::Scope* priority_scope) { priority_scope_ = priority_scope; }
+  const RunPriorityGate::Scope* GetPriorityScope() const { return priority_scope_; }
+
+  // The thread pools the kernels run in, those of the session state unless they are set.
+  void SetThreadPools(const RunThreadPools& thread_pools) { thread_pools_ = thread_pools; }
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return thread_pools_.intra_op; }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return thread_pools_.inter_op; }
+
   // Get the Stream instance for a given logic sequence.
   // return nullptr if the device of given logic sequence doesn't register stream support.
   Stream* GetDeviceStream(size_t idx);
@@ -150,6 +170,8 @@ class StreamExecutionContext {
  private:
   const SessionState* session_state_;
 
+  RunThreadPools thread_pools_;
+
   ExecutionFrame frame_;
 
   const logging::Logger* logger_;
@@ -171,6 +193,8 @@ class StreamExecutionContext {
 #endif
   const bool single_thread_mode_;
 
+  const RunPriorityGate::Scope* priority_scope_{nullptr};
+
 #ifdef ORT_ENABLE_STREAM
   InlinedVector<std::unique_ptr<synchronize::Notification>> notifications_;
   // if it is nullptr, means current session doesn't have any EP using stream feature
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_dim_expr.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+
+namespace onnxruntime {
+
+namespace {
+
+bool ParseInteger(std::string_view text, int64_t& value) {
+  if (text.empty() || text[0] < '0' || text[0] > '9') {
+    return false;
+  }
+  const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool IsSymbol(std::string_view text) {
+  return !text.empty() && !(text[0] >= '0' && text[0] <= '9') && text[0] != '-' && text[0] != '+' &&
+         text.find_first_of(" *") == std::string_view::npos;
+}
+
+}  // namespace
+
+SymbolicDimExpr SymbolicDimExpr::Symbol(const std::string& name) {
+  SymbolicDimExpr expr;
+  expr.coefficients_[name] = 1;
+  return expr;
+}
+
+std::optional<SymbolicDimExpr> SymbolicDimExpr::Parse(const std::string& text) {
+  const std::string_view view = text;
+  SymbolicDimExpr expr;
+  int64_t sign = 1;
+  size_t pos = 0;
+  if (!view.empty() && view[0] == '-') {
+    sign = -1;
+    pos = 1;
+  }
+
+  while (true) {
+    const size_t end = std::min(view.find(" + ", pos), view.find(" - ", pos));
+    const std::string_view term = view.substr(pos, end == std::string_view::npos ? end : end - pos);
+
+    int64_t coefficient = 1;
+    std::string_view symbol = term;
+    const size_t star = term.find('*');
+    if (star != std::string_view::npos) {
+      if (!ParseInteger(term.substr(0, star), coefficient)) {
+        return std::nullopt;
+      }
+      symbol = term.substr(star + 1);
+    }
+
+    if (star == std::string_view::npos && ParseInteger(term, coefficient)) {
+      expr.constant_ += sign * coefficient;
+    } else if (IsSymbol(symbol)) {
+      SymbolicDimExpr term_expr = Symbol(std::string(symbol));
+      term_expr *= sign * coefficient;
+      expr += term_expr;
+    } else {
+      return std::nullopt;
+    }
+
+    if (end == std::string_view::npos) {
+      break;
+    }
+    sign = view[end + 1] == '+' ? 1 : -1;
+    pos = end + 3;
+  }
+
+  return expr;
+}
+
+std::optional<SymbolicDimExpr> SymbolicDimExpr::FromDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) {
+  if (dim.has_dim_value()) {
+    return SymbolicDimExpr(dim.dim_value());
+  }
+  if (dim.has_dim_param()) {
+    return Parse(dim.dim_param());
+  }
+  return std::nullopt;
+}
+
+SymbolicDimExpr& SymbolicDimExpr::operator+=(const SymbolicDimExpr& other) {
+  for (const auto& [symbol, coefficient] : other.coefficients_) {
+    auto& sum = coefficients_[symbol];
+    sum += coefficient;
+    if (sum == 0) {
+      coefficients_.erase(symbol);
+    }
+  }
+  constant_ += other.constant_;
+  return *this;
+}
+
+SymbolicDimExpr& SymbolicDimExpr::operator-=(const SymbolicDimExpr& other) {
+  SymbolicDimExpr negated = other;
+  negated *= -1;
+  return *this += negated;
+}
+
+SymbolicDimExpr& SymbolicDimExpr::operator*=(int64_t factor) {
+  if (factor == 0) {
+    coefficients_.clear();
+  }
+  for (auto& term : coefficients_) {
+    term.second *= factor;
+  }
+  constant_ *= factor;
+  return *this;
+}
+
+bool SymbolicDimExpr::DivideExactly(int64_t divisor) {
+  if (divisor == 0 || constant_ % divisor != 0) {
+    return false;
+  }
+  for (const auto& term : coefficients_) {
+    if (term.second % divisor != 0) {
+      return false;
+    }
+  }
+
+  for (auto& term : coefficients_) {
+    term.second /= divisor;
+  }
+  constant_ /= divisor;
+  return true;
+}
+
+std::string SymbolicDimExpr::ToString() const {
+  std::string text;
+  auto append_term = [&text](int64_t coefficient, const std::string& symbol) {
+    if (!text.empty()) {
+      text += coefficient < 0 ? " - " : " + ";
+      coefficient = std::abs(coefficient);
+    } else if (coefficient < 0 && !symbol.empty()) {
+      text += "-";
+      coefficient = -coefficient;
+    }
+
+    if (symbol.empty()) {
+      text += std::to_string(coefficient);
+    } else if (coefficient == 1) {
+      text += symbol;
+    } else {
+      text += std::to_string(coefficient) + "*" + symbol;
+    }
+  };
+
+  for (const auto& [symbol, coefficient] : coefficients_) {
+    append_term(coefficient, symbol);
+  }
+  if (constant_ != 0 || text.empty()) {
+    append_term(constant_, "");
+  }
+  return text;
+}
+
+void SymbolicDimExpr::ToDim(ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) const {
+  if (IsConstant()) {
+    dim.set_dim_value(constant_);
+  } else {
+    dim.set_dim_param(ToString());
+  }
+}
+
+bool SameSymbolicDim(const std::string& dim_param1, const std::string& dim_param2) {
+  if (dim_param1 == dim_param2) {
+    return true;
+  }
+  const auto expr1 = SymbolicDimExpr::Parse(dim_param1);
+  const auto expr2 = SymbolicDimExpr::Parse(dim_param2);
+  return expr1.has_value() && expr2.has_value() && *expr1 == *expr2;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+
+// An affine expression of named dims, e.g. "batch", "seq + 1" or "2*past_seq + seq", as found in the dim_param of a
+// tensor shape. The text form uses the conventions of the symbolic shape inference tool: the terms are separated by
+// " + " or " - ", and a term is an integer, a symbol or "<integer>*<symbol>". Symbols cannot contain spaces or '*'.
+//
+// Two dim_params describe the same size if they parse to the same expression, e.g. "seq + 1" and "1 + seq".
+class SymbolicDimExpr {
+ public:
+  explicit SymbolicDimExpr(int64_t constant = 0) : constant_(constant) {}
+
+  static SymbolicDimExpr Symbol(const std::string& name);
+
+  // Returns std::nullopt if the text is not an affine expression of symbols following the conventions above.
+  static std::optional<SymbolicDimExpr> Parse(const std::string& text);
+
+  // Returns the expression of a dim with a dim_value or a dim_param, or std::nullopt if the dim is unknown.
+  static std::optional<SymbolicDimExpr> FromDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim);
+
+  bool IsConstant() const { return coefficients_.empty(); }
+  int64_t Constant() const { return constant_; }
+
+  SymbolicDimExpr& operator+=(const SymbolicDimExpr& other);
+  SymbolicDimExpr& operator-=(const SymbolicDimExpr& other);
+  SymbolicDimExpr& operator*=(int64_t factor);
+
+  // Divides all the terms by the divisor. Returns false and leaves the expression unchanged if any term is not a
+  // multiple of it.
+  bool DivideExactly(int64_t divisor);
+
+  bool operator==(const SymbolicDimExpr& other) const {
+    return constant_ == other.constant_ && coefficients_ == other.coefficients_;
+  }
+  bool operator!=(const SymbolicDimExpr& other) const { return !(*this == other); }
+
+  // Canonical text form, with the symbols in lexicographic order followed by the constant, e.g. "batch + 2*seq - 1".
+  std::string ToString() const;
+
+  // Sets the dim_value of the dim if the expression is constant, or its dim_param otherwise.
+  void ToDim(ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) const;
+
+ private:
+  // Symbols with a non-zero coefficient.
+  std::map<std::string, int64_t> coefficients_;
+  int64_t constant_;
+};
+
+// Whether two dim_params are the same size, either as the same text or as the same affine expression.
+bool SameSymbolicDim(const std::string& dim_param1, const std::string& dim_param2);
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "tensor_external_data_info.h"
 #include "core/common/common.h"
+#include "core/framework/external_data_compression.h"
 #include "core/platform/path_lib.h"
 
 #ifdef _WIN32
@@ -40,6 +41,11 @@ Status ExternalDataInfo::Create(const RepeatedPtrField<StringStringEntryProto>&
         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "parsing ", stringmap.value(), " failed");
     } else if (stringmap.key() == "checksum" && !stringmap.value().empty()) {
       out->checksum_ = stringmap.value();
+    } else if (stringmap.key() == "compression" && !stringmap.value().empty()) {
+      if (stringmap.value() != kExternalDataCompressionLz4)
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "model format error! Unsupported external data compression: ",
+                               stringmap.value());
+      out->compression_ = stringmap.value();
     } else {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "model format error!");
     }
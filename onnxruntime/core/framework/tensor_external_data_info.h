@@ -23,6 +23,10 @@ class ExternalDataInfo {
 
   const std::string& GetChecksum() const { return checksum_; }
 
+  // The codec the data is compressed with, or empty if it is stored as is. The 'length' of compressed data is the
+  // size of the compressed data in the file, not the size of the tensor.
+  const std::string& GetCompression() const { return compression_; }
+
   // If the value of 'offset' or 'length' field is larger the max value of ssize_t, this function will treat it as a
   // wrong value and return FAIL.
   static common::Status Create(
@@ -36,5 +40,6 @@ class ExternalDataInfo {
   // 0 means the whole file
   size_t length_ = 0;
   std::string checksum_;
+  std::string compression_;
 };
 }  // namespace onnxruntime
@@ -57,3 +57,6 @@ struct OrtTensorTypeAndShapeInfo {
 };
 
 constexpr ONNXTensorElementDataType TensorDataTypeToOnnxRuntimeTensorElementDataType(int32_t dtype);
+
+// Element type of a tensor. ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED for non-primitive types.
+ONNXTensorElementDataType MLDataTypeToOnnxRuntimeTensorElementDataType(const onnxruntime::DataTypeImpl* cpp_type);
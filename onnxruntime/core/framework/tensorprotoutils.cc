@@ -5,7 +5,9 @@
 
 #include <memory>
 #include <algorithm>
+#include <cstddef>
 #include <limits>
+#include <optional>
 #include <string>
 #include <filesystem>
 #if defined(__wasm__)
@@ -18,6 +20,7 @@
 #include "core/common/span_utils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/endian_utils.h"
+#include "core/framework/external_data_compression.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -165,11 +168,21 @@ Status UnpackTensorWithRawData(const void* raw_data, size_t raw_data_len, size_t
 DEFINE_INT4_UNPACK_TENSOR_WITH_RAW_DATA_IMPL(Int4x2)
 DEFINE_INT4_UNPACK_TENSOR_WITH_RAW_DATA_IMPL(UInt4x2)
 
+// The compressed external data of a tensor, see ExternalDataInfo::GetCompression().
+struct CompressedExternalData {
+  std::string compression;
+  // the size of the compressed data in the file
+  size_t length;
+};
+
+// Compressed external data is an error unless the caller can decompress it and passes `compressed`, which is set
+// if the data is compressed and reset otherwise.
 static Status GetExternalDataInfo(const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                   const std::filesystem::path& tensor_proto_dir,
                                   std::basic_string<ORTCHAR_T>& external_file_path,
                                   onnxruntime::FileOffsetType& file_offset,
-                                  SafeInt<size_t>& tensor_byte_size) {
+                                  SafeInt<size_t>& tensor_byte_size,
+                                  std::optional<CompressedExternalData>* compressed = nullptr) {
   ORT_RETURN_IF_NOT(onnxruntime::utils::HasExternalData(tensor_proto),
                     "Tensor does not have external data to read from.");
 
@@ -186,10 +199,23 @@ static Status GetExternalDataInfo(const ONNX_NAMESPACE::TensorProto& tensor_prot
 
   ORT_RETURN_IF_ERROR(onnxruntime::utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &tensor_byte_size));
   const size_t external_data_length = external_data_info->GetLength();
-  ORT_RETURN_IF_NOT(external_data_length == 0 || external_data_length == tensor_byte_size,
-                    "TensorProto: ", tensor_proto.name(),
-                    " external data size mismatch. Computed size: ", *&tensor_byte_size,
-                    ", external_data.length: ", external_data_length);
+  const std::string& compression = external_data_info->GetCompression();
+  if (!compression.empty()) {
+    ORT_RETURN_IF(compressed == nullptr, "TensorProto: ", tensor_proto.name(), " external data is compressed with ",
+                  compression, ", which is not supported here.");
+    ORT_RETURN_IF(location == onnxruntime::utils::kTensorProtoMemoryAddressTag || external_data_length == 0,
+                  "TensorProto: ", tensor_proto.name(),
+                  " compressed external data must be in a file and have the length of the compressed data.");
+    *compressed = CompressedExternalData{compression, external_data_length};
+  } else {
+    ORT_RETURN_IF_NOT(external_data_length == 0 || external_data_length == tensor_byte_size,
+                      "TensorProto: ", tensor_proto.name(),
+                      " external data size mismatch. Computed size: ", *&tensor_byte_size,
+                      ", external_data.length: ", external_data_length);
+    if (compressed != nullptr) {
+      compressed->reset();
+    }
+  }
 
   file_offset = external_data_info->GetOffset();
 
@@ -206,10 +232,20 @@ Status ReadExternalDataForTensor(const ONNX_NAMESPACE::TensorProto& tensor_proto
   std::basic_string<ORTCHAR_T> external_file_path;
   onnxruntime::FileOffsetType file_offset;
   SafeInt<size_t> tensor_byte_size;
-  ORT_RETURN_IF_ERROR(
-      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset, tensor_byte_size));
+  std::optional<CompressedExternalData> compressed;
+  ORT_RETURN_IF_ERROR(GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset,
+                                          tensor_byte_size, &compressed));
 
   unpacked_tensor.resize(tensor_byte_size);
+  if (compressed) {
+    std::vector<char> compressed_data(compressed->length);
+    ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
+        external_file_path.c_str(), file_offset, compressed_data.size(), gsl::make_span(compressed_data)));
+    return onnxruntime::DecompressExternalData(
+        compressed->compression, gsl::make_span(compressed_data),
+        gsl::make_span(reinterpret_cast<char*>(unpacked_tensor.data()), unpacked_tensor.size()));
+  }
+
   ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
       external_file_path.c_str(),
       file_offset,
@@ -985,6 +1021,44 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
 }
 #endif
 
+// Reads the compressed external data of tensor_proto and decompresses it into dst, which has the size of the tensor.
+// The decompressed bytes are little-endian, like the bytes of uncompressed external data.
+static Status DecompressExternalDataFromFile(const Env& env, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                             const std::basic_string<ORTCHAR_T>& file_path, FileOffsetType offset,
+                                             const CompressedExternalData& compressed, gsl::span<char> dst) {
+#if defined(__wasm__)
+  ORT_RETURN_IF(offset < 0 || offset + compressed.length >= 4294967296,
+                "External initializer: ", tensor_proto.name(), " offset: ", offset,
+                " size to read: ", compressed.length, " are out of bounds or can not be read in full (>4GB).");
+
+  std::vector<char> compressed_data(compressed.length);
+  ORT_RETURN_IF_ERROR(LoadWebAssemblyExternalData(env, file_path, offset, compressed.length,
+                                                  ExternalDataLoadType::CPU, compressed_data.data()));
+  gsl::span<const char> src = gsl::make_span(compressed_data);
+#else
+  std::uintmax_t file_length = std::filesystem::file_size(file_path);
+
+  SafeInt<FileOffsetType> end_of_read(offset);
+  end_of_read += compressed.length;
+  ORT_RETURN_IF(offset < 0 || static_cast<std::uintmax_t>(end_of_read) > file_length,
+                "External initializer: ", tensor_proto.name(), " offset: ", offset,
+                " size to read: ", compressed.length, " given file_length: ", file_length,
+                " are out of bounds or can not be read in full.");
+
+  // the compressed data is mapped, so only the decompressed data takes up memory
+  void* compressed_data = nullptr;
+  OrtCallback compressed_data_deleter;
+  ORT_RETURN_IF_ERROR(GetFileContent(env, file_path.c_str(), offset, compressed.length, compressed_data,
+                                     compressed_data_deleter));
+  ScopedOrtCallbackInvoker compressed_data_invoker(compressed_data_deleter);
+  gsl::span<const char> src = gsl::make_span(static_cast<const char*>(compressed_data), compressed.length);
+#endif
+
+  Status status = DecompressExternalData(compressed.compression, src, dst);
+  ORT_RETURN_IF_NOT(status.IsOK(), "External initializer: ", tensor_proto.name(), " ", status.ErrorMessage());
+  return Status::OK();
+}
+
 Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, void*& ext_data_buf,
                                  SafeInt<size_t>& ext_data_len, OrtCallback& ext_data_deleter,
@@ -997,10 +1071,18 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
   std::basic_string<ORTCHAR_T> external_data_file_path;
   FileOffsetType file_offset;
   SafeInt<size_t> raw_data_safe_len = 0;
-  ORT_RETURN_IF_ERROR(
-      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_data_file_path, file_offset, raw_data_safe_len));
+  std::optional<CompressedExternalData> compressed;
+  ORT_RETURN_IF_ERROR(GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_data_file_path, file_offset,
+                                          raw_data_safe_len, &compressed));
 
-  if (external_data_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag) {
+  if (compressed) {
+    auto buffer = std::make_unique<char[]>(raw_data_safe_len);
+    ORT_RETURN_IF_ERROR(DecompressExternalDataFromFile(env, tensor_proto, external_data_file_path, file_offset,
+                                                       *compressed, gsl::make_span(buffer.get(), raw_data_safe_len)));
+    ext_data_deleter = OrtCallback{DeleteCharArray, buffer.get()};
+    ext_data_buf = buffer.release();
+    ext_data_len = raw_data_safe_len;
+  } else if (external_data_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag) {
     // the value in location is the memory address of the data
     ext_data_buf = reinterpret_cast<void*>(file_offset);
     ext_data_len = raw_data_safe_len;
@@ -1048,6 +1130,93 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
   return Status::OK();
 }
 
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  std::basic_string<ORTCHAR_T> external_data_file_path;
+  FileOffsetType file_offset;
+  SafeInt<size_t> raw_data_safe_len = 0;
+  if (!GetExternalDataInfo(tensor_proto, std::filesystem::path(), external_data_file_path, file_offset,
+                           raw_data_safe_len)
+           .IsOK()) {
+    return false;
+  }
+
+  const size_t element_size =
+      DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType()->Size();
+
+  // the bytes in an external data file are little-endian. data in memory was written by this process.
+  if constexpr (endian::native != endian::little) {
+    if (element_size > 1 && external_data_file_path != onnxruntime::utils::kTensorProtoMemoryAddressTag) {
+      return false;
+    }
+  }
+
+  // Env::MapFileIntoMemory maps whole pages, so the data has the alignment of its offset within the file
+  const size_t required_alignment = std::min(element_size, alignof(std::max_align_t));
+  return file_offset >= 0 && static_cast<uint64_t>(file_offset) % required_alignment == 0;
+}
+
+bool GetExternalDataFileRegion(const std::filesystem::path& model_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                               std::basic_string<ORTCHAR_T>& file_path, FileOffsetType& offset, size_t& length) {
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (!model_path.empty() && !GetDirNameFromFilePath(model_path, tensor_proto_dir).IsOK()) {
+    return false;
+  }
+
+  SafeInt<size_t> raw_data_safe_len = 0;
+  if (!GetExternalDataInfo(tensor_proto, tensor_proto_dir, file_path, offset, raw_data_safe_len).IsOK() ||
+      file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag || offset < 0) {
+    return false;
+  }
+
+  if constexpr (endian::native != endian::little) {
+    if (DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType()->Size() > 1) {
+      return false;
+    }
+  }
+
+  length = raw_data_safe_len;
+  return true;
+}
+
+bool HasCompressedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  return HasExternalData(tensor_proto) &&
+         ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK() &&
+         !external_data_info->GetCompression().empty();
+}
+
+Status DecompressExternalDataIntoTensor(const Env& env, const std::filesystem::path& model_path,
+                                        const ONNX_NAMESPACE::TensorProto& tensor_proto, Tensor& tensor) {
+  ORT_ENFORCE(utils::HasExternalData(tensor_proto));
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (!model_path.empty()) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_path, tensor_proto_dir));
+  }
+  std::basic_string<ORTCHAR_T> external_data_file_path;
+  FileOffsetType file_offset;
+  SafeInt<size_t> raw_data_safe_len = 0;
+  std::optional<CompressedExternalData> compressed;
+  ORT_RETURN_IF_ERROR(GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_data_file_path, file_offset,
+                                          raw_data_safe_len, &compressed));
+  ORT_RETURN_IF_NOT(compressed, "External initializer: ", tensor_proto.name(), " is not compressed.");
+  ORT_RETURN_IF(raw_data_safe_len != tensor.SizeInBytes(), "External initializer: ", tensor_proto.name(),
+                " size: ", static_cast<size_t>(raw_data_safe_len), " does not match the tensor size: ",
+                tensor.SizeInBytes());
+
+  auto dst = gsl::make_span(static_cast<char*>(tensor.MutableDataRaw()), tensor.SizeInBytes());
+  ORT_RETURN_IF_ERROR(
+      DecompressExternalDataFromFile(env, tensor_proto, external_data_file_path, file_offset, *compressed, dst));
+
+  if constexpr (endian::native != endian::little) {
+    const size_t element_size = tensor.DataType()->Size();
+    for (size_t i = 0; i + element_size <= dst.size(); i += element_size) {
+      std::reverse(dst.begin() + i, dst.begin() + i + element_size);
+    }
+  }
+
+  return Status::OK();
+}
+
 Status LoadExtDataToTensorFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                           const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                           const IExternalDataLoader& ext_data_loader,
@@ -150,6 +150,7 @@ constexpr const ORTCHAR_T* kTensorProtoMemoryAddressTag = ORT_TSTR("*/_ORT_MEM_A
 
 // Given a tensor proto with external data obtain a pointer to the data and its length.
 // The ext_data_deleter argument is updated with a callback that owns/releases the data.
+// Compressed external data is decompressed into a buffer that ext_data_deleter owns.
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
@@ -160,6 +161,28 @@ common::Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::
                                          OrtCallback& ext_data_deleter,
                                          Tensor* buffered_tensor = nullptr);
 
+// Returns true if the external data of tensor_proto can be used as the buffer of a CPU Tensor as is, i.e. without
+// copying it into separately allocated memory. That requires the data to be suitably aligned for the element type
+// and, unless it is an existing memory buffer (kTensorProtoMemoryAddressTag), to not need an endianness conversion.
+// File data is memory mapped, so the mapping offset determines the alignment.
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+// Gets the file, and the region of it, that holds the external data of tensor_proto, so that the data can be read
+// into a tensor as is. Returns false if the data is not in a file (kTensorProtoMemoryAddressTag), is compressed, needs
+// an endianness conversion, or its external data info is invalid.
+bool GetExternalDataFileRegion(const std::filesystem::path& model_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                               std::basic_string<ORTCHAR_T>& file_path, FileOffsetType& offset, size_t& length);
+
+// Returns true if the external data of tensor_proto is compressed, see ExternalDataInfo::GetCompression().
+// Compressed data can't be used in place or loaded by an IExternalDataLoader. GetExtDataFromTensorProto() returns it
+// decompressed, and DecompressExternalDataIntoTensor() decompresses it into an allocated CPU tensor.
+bool HasCompressedExternalData(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+// Decompresses the compressed external data of tensor_proto into tensor, a CPU tensor of the type and shape of
+// tensor_proto. The compressed data is memory mapped where possible, so it isn't copied before it is decompressed.
+common::Status DecompressExternalDataIntoTensor(const Env& env, const std::filesystem::path& model_path,
+                                                const ONNX_NAMESPACE::TensorProto& tensor_proto, Tensor& tensor);
+
 // Given a tensor proto with external data obtain a tensor using the specified custom external data loader.
 common::Status LoadExtDataToTensorFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto,
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/transpose_helper.h"
@@ -309,4 +312,229 @@ bool IsTransposeMovingSingleAxis(gsl::span<const size_t> permutations, size_t& f
   return single_axis_moved;
 }
 
-}  // namespace onnxruntime
\ No newline at end of file
+namespace {
+
+// Tile edge, in elements, of the 2D sub-transposes done by BlockedTranspose. A 64x64 tile of 32-bit elements keeps
+// the source and destination tiles of one sub-transpose resident in the L1 data cache.
+constexpr size_t kTransposeTileSize = 64;
+
+template <typename T>
+struct has_mlas_strided_transpose : std::false_type {};
+
+template <>
+struct has_mlas_strided_transpose<uint8_t> : std::true_type {};
+
+template <>
+struct has_mlas_strided_transpose<uint16_t> : std::true_type {};
+
+template <>
+struct has_mlas_strided_transpose<uint32_t> : std::true_type {};
+
+// transposes the m x n matrix at `input`, whose rows are `input_stride` elements apart, to the n x m matrix at
+// `output`, whose rows are `output_stride` elements apart.
+template <typename T>
+typename std::enable_if<has_mlas_strided_transpose<T>::value, void>::type TransposeTile(
+    const T* input, size_t input_stride, T* output, size_t output_stride, size_t m, size_t n) {
+  MlasTranspose(input, input_stride, output, output_stride, m, n);
+}
+
+template <typename T>
+typename std::enable_if<!has_mlas_strided_transpose<T>::value, void>::type TransposeTile(
+    const T* input, size_t input_stride, T* output, size_t output_stride, size_t m, size_t n) {
+  for (size_t i = 0; i < m; ++i) {
+    const T* s = input + i * input_stride;
+    T* d = output + i;
+    for (size_t j = 0; j < n; ++j) {
+      *d = s[j];
+      d += output_stride;
+    }
+  }
+}
+
+template <typename T>
+void BlockedTransposeImpl(gsl::span<const size_t> dims, gsl::span<const size_t> perm, const uint8_t* input_bytes,
+                          uint8_t* output_bytes, concurrency::ThreadPool* tp) {
+  const auto* input_data = reinterpret_cast<const T*>(input_bytes);
+  auto* output_data = reinterpret_cast<T*>(output_bytes);
+  const size_t rank = dims.size();
+
+  // element strides of each input axis in the input and in the output
+  InlinedVector<size_t> input_strides(rank);
+  InlinedVector<size_t> output_strides(rank);
+  size_t total_size = 1;
+  for (size_t i = rank; i-- > 0;) {
+    input_strides[i] = total_size;
+    total_size *= dims[i];
+  }
+  for (size_t i = rank, stride = 1; i-- > 0;) {
+    output_strides[perm[i]] = stride;
+    stride *= dims[perm[i]];
+  }
+
+  // the innermost input axis is contiguous in the input and `inner_axis` is contiguous in the output. if they are the
+  // same axis each unit of work is a memcpy of a contiguous run, otherwise it is a tile of the 2D transpose of
+  // `inner_axis` x `input_axis` that is strided in both the input and the output.
+  const size_t input_axis = rank - 1;
+  const size_t inner_axis = perm[rank - 1];
+  const bool is_copy = input_axis == inner_axis;
+  const size_t rows = is_copy ? 1 : dims[inner_axis];
+  const size_t cols = dims[input_axis];
+
+  // the remaining axes are walked in the output order so consecutive units write nearby output.
+  InlinedVector<size_t> outer_dims;
+  InlinedVector<size_t> outer_input_strides;
+  InlinedVector<size_t> outer_output_strides;
+  for (size_t i = 0; i < rank; ++i) {
+    if (perm[i] != input_axis && perm[i] != inner_axis) {
+      outer_dims.push_back(dims[perm[i]]);
+      outer_input_strides.push_back(input_strides[perm[i]]);
+      outer_output_strides.push_back(output_strides[perm[i]]);
+    }
+  }
+
+  const size_t row_tiles = is_copy ? 1 : (rows + kTransposeTileSize - 1) / kTransposeTileSize;
+  const size_t col_tiles = is_copy ? 1 : (cols + kTransposeTileSize - 1) / kTransposeTileSize;
+  const size_t tiles_per_outer = row_tiles * col_tiles;
+  const size_t row_stride = is_copy ? 0 : input_strides[inner_axis];
+  const size_t col_stride = is_copy ? 0 : output_strides[input_axis];
+  const size_t num_units = total_size / (rows * cols) * tiles_per_outer;
+  const double unit_bytes = static_cast<double>(total_size * sizeof(T)) / static_cast<double>(num_units);
+
+  auto work = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const size_t num_outer_axes = outer_dims.size();
+    size_t outer = static_cast<size_t>(first) / tiles_per_outer;
+    size_t tile = static_cast<size_t>(first) % tiles_per_outer;
+
+    InlinedVector<size_t> index(num_outer_axes);
+    size_t input_offset = 0;
+    size_t output_offset = 0;
+    for (size_t k = num_outer_axes; k-- > 0;) {
+      index[k] = outer % outer_dims[k];
+      outer /= outer_dims[k];
+      input_offset += index[k] * outer_input_strides[k];
+      output_offset += index[k] * outer_output_strides[k];
+    }
+
+    for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+      if (is_copy) {
+        memcpy(output_data + output_offset, input_data + input_offset, cols * sizeof(T));
+      } else {
+        const size_t row = (tile / col_tiles) * kTransposeTileSize;
+        const size_t col = (tile % col_tiles) * kTransposeTileSize;
+        TransposeTile(input_data + input_offset + row * row_stride + col, row_stride,
+                      output_data + output_offset + col * col_stride + row, col_stride,
+                      std::min(kTransposeTileSize, rows - row), std::min(kTransposeTileSize, cols - col));
+      }
+
+      if (++tile == tiles_per_outer) {
+        tile = 0;
+        for (size_t k = num_outer_axes; k-- > 0;) {
+          input_offset += outer_input_strides[k];
+          output_offset += outer_output_strides[k];
+          if (++index[k] < outer_dims[k]) {
+            break;
+          }
+          input_offset -= outer_dims[k] * outer_input_strides[k];
+          output_offset -= outer_dims[k] * outer_output_strides[k];
+          index[k] = 0;
+        }
+      }
+    }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(num_units),
+                                          TensorOpCost{unit_bytes, unit_bytes, unit_bytes / sizeof(T)}, work);
+}
+
+}  // namespace
+
+bool BlockedTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output,
+                      const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
+  if (input.IsDataTypeString()) {
+    return false;
+  }
+
+  const auto element_size = input.DataType()->Size();
+  if (element_size != sizeof(uint8_t) && element_size != sizeof(uint16_t) && element_size != sizeof(uint32_t) &&
+      element_size != sizeof(uint64_t)) {
+    return false;
+  }
+
+  const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
+  const auto input_dims = input_shape.GetDims();
+  const size_t rank = input_dims.size();
+  if (input_shape.Size() == 0) {
+    return true;
+  }
+
+  // drop the size 1 axes, renumbering the remaining input axes.
+  InlinedVector<size_t> kept_axis(rank, std::numeric_limits<size_t>::max());
+  InlinedVector<size_t> kept_dims;
+  for (size_t axis = 0; axis < rank; ++axis) {
+    if (input_dims[axis] != 1) {
+      kept_axis[axis] = kept_dims.size();
+      kept_dims.push_back(onnxruntime::narrow<size_t>(input_dims[axis]));
+    }
+  }
+
+  // merge consecutive output axes that read consecutive input axes into groups, in output order.
+  InlinedVector<size_t> group_first_axis;
+  InlinedVector<size_t> group_dims;
+  size_t previous_axis = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < rank; ++i) {
+    const size_t axis = kept_axis[permutations[i]];
+    if (axis == std::numeric_limits<size_t>::max()) {
+      continue;
+    }
+
+    if (!group_first_axis.empty() && axis == previous_axis + 1) {
+      group_dims.back() *= kept_dims[axis];
+    } else {
+      group_first_axis.push_back(axis);
+      group_dims.push_back(kept_dims[axis]);
+    }
+
+    previous_axis = axis;
+  }
+
+  // the groups become the axes of the canonical transpose, ordered in the input by their first axis.
+  const size_t num_groups = group_first_axis.size();
+  InlinedVector<size_t> input_order(num_groups);
+  std::iota(input_order.begin(), input_order.end(), size_t{0});
+  std::sort(input_order.begin(), input_order.end(),
+            [&group_first_axis](size_t l, size_t r) { return group_first_axis[l] < group_first_axis[r]; });
+
+  InlinedVector<size_t> dims(num_groups);
+  InlinedVector<size_t> perm(num_groups);
+  for (size_t i = 0; i < num_groups; ++i) {
+    dims[i] = group_dims[input_order[i]];
+    perm[input_order[i]] = i;
+  }
+
+  const auto* input_data = reinterpret_cast<const uint8_t*>(input.DataRaw());
+  auto* output_data = reinterpret_cast<uint8_t*>(output.MutableDataRaw());
+
+  if (num_groups <= 1) {
+    memcpy(output_data, input_data, onnxruntime::narrow<size_t>(input_shape.Size()) * element_size);
+    return true;
+  }
+
+  switch (element_size) {
+    case sizeof(uint8_t):
+      BlockedTransposeImpl<uint8_t>(dims, perm, input_data, output_data, tp);
+      break;
+    case sizeof(uint16_t):
+      BlockedTransposeImpl<uint16_t>(dims, perm, input_data, output_data, tp);
+      break;
+    case sizeof(uint32_t):
+      BlockedTransposeImpl<uint32_t>(dims, perm, input_data, output_data, tp);
+      break;
+    default:
+      BlockedTransposeImpl<uint64_t>(dims, perm, input_data, output_data, tp);
+      break;
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -27,6 +27,12 @@ We use simple pointer arithmetic if the size of each read/write is a power of 2
 We use memcpy if the block size is larger.
 
 We fall back to the default implementation in all other cases, and if the input is std::string.
+
+For general permutations BlockedTranspose first removes size 1 axes and merges axes that stay adjacent in the output.
+If the innermost axis is unchanged, each contiguous run is copied with memcpy. Otherwise the innermost input axis and
+the input axis that becomes innermost in the output form a strided 2D transpose that is split into cache sized tiles
+and done with MlasTranspose for 8, 16 and 32 bit elements. The tiles of all the remaining outer axes are distributed
+across the thread pool.
 */
 
 #include <sstream>
@@ -44,4 +50,8 @@ bool IsTransposeMovingSingleAxis(gsl::span<const size_t> permutations, size_t& f
 void SingleAxisTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output, size_t from,
                          size_t to, const TensorShape* input_shape_override = nullptr,
                          concurrency::ThreadPool* tp = nullptr);
+
+// Returns false without writing to `output` if the element type is not supported (e.g. std::string).
+bool BlockedTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output,
+                      const TensorShape* input_shape_override = nullptr, concurrency::ThreadPool* tp = nullptr);
 }  // namespace onnxruntime
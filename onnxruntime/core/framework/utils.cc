@@ -15,6 +15,7 @@
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/pinned_staging.h"
 #include "core/framework/session_state.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/tensorprotoutils.h"
@@ -329,6 +330,8 @@ common::Status InitializeFeedFetchCopyInfo(const SessionState& session_state,
   if (cpu_only) {
     feeds_fetches_manager.SetDeviceCopyChecks(DeviceCopyCheck::NoCopy, DeviceCopyCheck::NoCopy);
   } else {
+    feeds_fetches_manager.ResetDeviceCopyChecks();
+
     // setup all the static info about where the graph inputs and outputs are located
     auto info = feeds_fetches_manager.GetFeedsFetchesInfo();
     auto& feed_copy_info = feeds_fetches_manager.GetMutableFeedsDeviceCopyInfo();
@@ -340,6 +343,14 @@ common::Status InitializeFeedFetchCopyInfo(const SessionState& session_state,
   return Status::OK();
 }
 
+// The host memory shared with an NPU is ordinary CPU memory for the nodes on the CPU, so a feed or fetch in it is
+// used by the nodes without a copy to or from the default CPU memory, and the NPU accesses it without a copy too.
+static bool IsSharedHostMemory(const OrtDevice& device, const OrtDevice& other) {
+  return device.Type() == OrtDevice::CPU && other.Type() == OrtDevice::CPU &&
+         ((device.MemType() == OrtDevice::MemType::QNN_HTP_SHARED && other.MemType() == OrtDevice::MemType::DEFAULT) ||
+          (device.MemType() == OrtDevice::MemType::DEFAULT && other.MemType() == OrtDevice::MemType::QNN_HTP_SHARED));
+}
+
 // update the allocation_provider in the copy info based on the actual feeds
 static bool FinalizeCopyInfoForFeeds(gsl::span<const OrtDevice> feed_locations,
                                      std::vector<MLValueCopyInfo>& copy_info) {
@@ -348,6 +359,9 @@ static bool FinalizeCopyInfoForFeeds(gsl::span<const OrtDevice> feed_locations,
 
   for (size_t i = 0, end = feed_locations.size(); i < end; ++i) {
     copy_info[i].source_device = feed_locations[i];
+    if (IsSharedHostMemory(copy_info[i].source_device, copy_info[i].target_device)) {
+      copy_info[i].target_device = copy_info[i].source_device;
+    }
 
     if (copy_info[i].source_device != copy_info[i].target_device) {
       copy_needed = true;
@@ -368,6 +382,10 @@ static bool FinalizeCopyInfoForFetches(gsl::span<const OrtDevice* const>& fetch_
 
     if (alloc_info != nullptr) {
       copy_info[i].target_device = *alloc_info;
+      // the node writes the output in the pre-allocated fetch
+      if (IsSharedHostMemory(copy_info[i].target_device, copy_info[i].source_device)) {
+        copy_info[i].source_device = copy_info[i].target_device;
+      }
     }
 
     if (copy_info[i].source_device != copy_info[i].target_device) {
@@ -453,6 +471,7 @@ static common::Status CopyInputsAcrossDevices(const SessionState& session_state,
                                               std::vector<OrtValue>& new_feeds,
 #ifdef ORT_ENABLE_STREAM
                                               DeviceStreamCollection* device_stream_collection,
+                                              PinnedStaging* staging,
 #endif
                                               gsl::span<const MLValueCopyInfo> copy_info) {
   size_t num_feeds = orig_feeds.size();
@@ -482,6 +501,17 @@ static common::Status CopyInputsAcrossDevices(const SessionState& session_state,
         copy_this_feed = device_stream_collection->GetStream(copy_info[idx].unique_stream_index_consumes_it);
       }
     }
+
+    // upload through pinned memory, the upload of the next feeds overlaps the ones in flight
+    if (staging && orig_feeds[idx].IsTensor() &&
+        staging->ShouldStage(orig_feeds[idx].Get<Tensor>(), copy_info[idx].target_device, copy_this_feed)) {
+      auto allocator = session_state.GetAllocator(copy_info[idx].target_device);
+      ORT_ENFORCE(allocator != nullptr, "Failed to find allocator for device ", copy_info[idx].target_device.ToString());
+      ORT_RETURN_IF_ERROR(utils::AllocateHelper(allocator, copy_this_feed, orig_feeds[idx], new_feeds[idx]));
+      ORT_RETURN_IF_ERROR(staging->Upload(orig_feeds[idx].Get<Tensor>(), *new_feeds[idx].GetMutable<Tensor>(),
+                                          *copy_this_feed));
+      continue;
+    }
 #endif
 #if !defined(DISABLE_SPARSE_TENSORS)
     ORT_RETURN_IF_ERROR(BatchOrCopyMLValue(session_state, copy_info[idx], orig_feeds[idx], new_feeds[idx],
@@ -580,6 +610,9 @@ common::Status CopyOneInputAcrossDevices(const SessionState& session_state, cons
 static common::Status CopyOutputsAcrossDevices(const SessionState& session_state,
                                                gsl::span<const OrtValue> fetches,
                                                std::vector<OrtValue>& user_fetches,
+#ifdef ORT_ENABLE_STREAM
+                                               PinnedStaging* staging,
+#endif
                                                gsl::span<const MLValueCopyInfo> copy_info,
                                                gsl::span<Stream* const> fetch_streams) {
   auto num_outputs = fetches.size();
@@ -591,6 +624,21 @@ static common::Status CopyOutputsAcrossDevices(const SessionState& session_state
 #endif
 
   for (size_t idx = 0; idx < num_outputs; ++idx) {
+#ifdef ORT_ENABLE_STREAM
+    // download through pinned memory, the copies to user_fetches are done by staging->Finish()
+    if (staging && fetches[idx].IsTensor() &&
+        staging->ShouldStage(fetches[idx].Get<Tensor>(), copy_info[idx].target_device, fetch_streams[idx])) {
+      if (!user_fetches[idx].IsAllocated()) {
+        auto allocator = session_state.GetAllocator(copy_info[idx].target_device);
+        ORT_ENFORCE(allocator != nullptr, "Failed to find allocator for device ",
+                    copy_info[idx].target_device.ToString());
+        ORT_RETURN_IF_ERROR(utils::AllocateHelper(allocator, nullptr, fetches[idx], user_fetches[idx]));
+      }
+      ORT_RETURN_IF_ERROR(staging->Download(fetches[idx].Get<Tensor>(), *user_fetches[idx].GetMutable<Tensor>(),
+                                            *fetch_streams[idx]));
+      continue;
+    }
+#endif
 #if !defined(DISABLE_SPARSE_TENSORS)
     ORT_RETURN_IF_ERROR(BatchOrCopyMLValue(session_state, copy_info[idx], fetches[idx], user_fetches[idx], fetch_streams[idx],
                                            &batched_data_transfers, &batched_sparse_data_transfers));
@@ -624,7 +672,9 @@ ExecuteGraphImpl(const SessionState& session_state,
                  DeviceStreamCollection* device_stream_collection,
 #endif
                  const bool only_execute_path_to_fetches = false,
-                 Stream* parent_stream = nullptr) {
+                 Stream* parent_stream = nullptr,
+                 const RunPriorityGate::Scope* priority_scope = nullptr,
+                 const RunThreadPools* thread_pools = nullptr) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   const auto& device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 #ifdef ORT_ENABLE_STREAM
@@ -656,7 +706,9 @@ ExecuteGraphImpl(const SessionState& session_state,
                                   terminate_flag,
                                   only_execute_path_to_fetches,
                                   // single thread mode
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  priority_scope,
+                                  thread_pools));
     ORT_RETURN_IF_ERROR(status);
   } else {
     auto feeds_to_use = feeds;
@@ -664,11 +716,16 @@ ExecuteGraphImpl(const SessionState& session_state,
     std::vector<OrtValue> device_feeds;
     std::vector<OrtValue> device_fetches;
 
+#ifdef ORT_ENABLE_STREAM
+    // declared before the copies of the feeds and fetches so their staging buffers outlive the transfers
+    PinnedStaging staging(session_state);
+#endif
+
     if (device_copy_checks.input_copy_needed == DeviceCopyCheck::Copy) {
       const auto& feed_copy_info = feeds_fetches_manager.GetFeedsDeviceCopyInfo();
       auto status = CopyInputsAcrossDevices(session_state, feeds, device_feeds,
 #ifdef ORT_ENABLE_STREAM
-                                            device_stream_collection,
+                                            device_stream_collection, &staging,
 #endif
                                             feed_copy_info);
       ORT_RETURN_IF_ERROR(status);
@@ -704,7 +761,9 @@ ExecuteGraphImpl(const SessionState& session_state,
 #endif
                                   terminate_flag,
                                   only_execute_path_to_fetches,
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  priority_scope,
+                                  thread_pools));
     ORT_RETURN_IF_ERROR(status);
     InlinedVector<Stream*> fetches_streams;
     fetches_streams.reserve(feeds_fetches_info.fetches_mlvalue_idxs.size());
@@ -727,8 +786,15 @@ ExecuteGraphImpl(const SessionState& session_state,
 #endif
 
     if (device_copy_checks.output_copy_needed == DeviceCopyCheck::Copy) {
-      ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, fetch_copy_info, fetches_streams));
+      ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches,
+#ifdef ORT_ENABLE_STREAM
+                                                   &staging,
+#endif
+                                                   fetch_copy_info, fetches_streams));
     }
+#ifdef ORT_ENABLE_STREAM
+    ORT_RETURN_IF_ERROR(staging.Finish());
+#endif
   }
   return Status::OK();
 }
@@ -742,24 +808,44 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             bool only_execute_path_to_fetches,
-                            Stream* parent_stream) {
+                            Stream* parent_stream,
+                            const RunPriorityGate::Scope* priority_scope,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators,
+                            const RunThreadPools* thread_pools) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
+  static const std::unordered_map<size_t, IExecutor::CustomAllocator> no_fetch_allocators;
+  if (fetch_allocators == nullptr) {
+    fetch_allocators = &no_fetch_allocators;
+  }
+
+  // fetches with a custom allocator are written in place on the device that produces them
+  auto& fetch_copy_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+  for (const auto& entry : *fetch_allocators) {
+    if (entry.first < fetch_copy_info.size()) {
+      fetch_copy_info[entry.first].target_device = fetch_copy_info[entry.first].source_device;
+    }
+  }
+
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
-  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, *fetch_allocators,
                                  execution_mode, terminate_flag, logger,
                                  device_stream_collection,
                                  only_execute_path_to_fetches,
-                                 parent_stream);
+                                 parent_stream,
+                                 priority_scope,
+                                 thread_pools);
   return retval;
 #else
-  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, *fetch_allocators,
                           execution_mode, terminate_flag, logger,
                           only_execute_path_to_fetches,
-                          parent_stream);
+                          parent_stream,
+                          priority_scope,
+                          thread_pools);
 #endif
 }
 
@@ -770,7 +856,10 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
-                            const logging::Logger& logger) {
+                            const logging::Logger& logger,
+                            const RunPriorityGate::Scope* priority_scope,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators,
+                            const RunThreadPools* thread_pools) {
   return ExecuteGraph(session_state,
                       feeds_fetches_manager,
                       feeds, fetches,
@@ -780,7 +869,11 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                       device_stream_collection_holder,
 #endif
-                      run_options.only_execute_path_to_fetches);
+                      run_options.only_execute_path_to_fetches,
+                      nullptr,
+                      priority_scope,
+                      fetch_allocators,
+                      thread_pools);
 }
 
 #ifdef ENABLE_TRAINING
@@ -824,7 +917,8 @@ common::Status ExecutePartialGraphImpl(const SessionState& session_state, FeedsF
 
     if (device_copy_checks.input_copy_needed == DeviceCopyCheck::Copy) {
       const auto& feed_copy_info = feeds_fetches_manager.GetFeedsDeviceCopyInfo();
-      ORT_RETURN_IF_ERROR(CopyInputsAcrossDevices(session_state, feeds, device_feeds, device_stream_collection, feed_copy_info));
+      ORT_RETURN_IF_ERROR(CopyInputsAcrossDevices(session_state, feeds, device_feeds, device_stream_collection, nullptr,
+                                                  feed_copy_info));
       p_feeds = device_feeds;
     }
 
@@ -874,7 +968,8 @@ common::Status ExecutePartialGraphImpl(const SessionState& session_state, FeedsF
     }
 
     if (device_copy_checks.output_copy_needed == DeviceCopyCheck::Copy) {
-      ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, fetch_copy_info, fetches_streams));
+      ORT_RETURN_IF_ERROR(CopyOutputsAcrossDevices(session_state, *p_fetches, fetches, nullptr, fetch_copy_info,
+                                                   fetches_streams));
     }
     // training don't want to flush the stream
   }
@@ -903,18 +998,23 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
                                Stream* parent_stream,
-                               bool sync_subgraph_fetches) {
+                               bool sync_subgraph_fetches,
+                               concurrency::ThreadPool* intra_op_thread_pool) {
+  const RunThreadPools thread_pools{intra_op_thread_pool, session_state.GetInterOpThreadPool()};
+  const RunThreadPools* subgraph_thread_pools = intra_op_thread_pool != nullptr ? &thread_pools : nullptr;
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
 
   auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 execution_mode, terminate_flag, logger, device_stream_collection, false, parent_stream);
+                                 execution_mode, terminate_flag, logger, device_stream_collection, false, parent_stream,
+                                 nullptr, subgraph_thread_pools);
   if (device_stream_collection)
     ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(false));
 #else
   auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 execution_mode, terminate_flag, logger, false, parent_stream);
+                                 execution_mode, terminate_flag, logger, false, parent_stream,
+                                 nullptr, subgraph_thread_pools);
 #endif
   if (retval.IsOK() && sync_subgraph_fetches && parent_stream) {
     parent_stream->Flush();
@@ -8,12 +8,14 @@
 #include "core/framework/data_types.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/run_priority_gate.h"
 #include "core/framework/session_state.h"
 #include "core/framework/session_options.h"
 
 namespace onnxruntime {
 class ExecutionProviders;
 struct FeedsFetchesInfo;
+struct RunThreadPools;
 class FeedsFetchesManager;
 struct MLValueCopyInfo;
 class Graph;
@@ -88,7 +90,10 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             bool only_execute_path_to_fetches = false,
-                            Stream* parent_stream = nullptr);
+                            Stream* parent_stream = nullptr,
+                            const RunPriorityGate::Scope* priority_scope = nullptr,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators = nullptr,
+                            const RunThreadPools* thread_pools = nullptr);
 
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
@@ -96,7 +101,10 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
-                            const logging::Logger& logger);
+                            const logging::Logger& logger,
+                            const RunPriorityGate::Scope* priority_scope = nullptr,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>* fetch_allocators = nullptr,
+                            const RunThreadPools* thread_pools = nullptr);
 
 #ifdef ENABLE_TRAINING
 common::Status ExecutePartialGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
@@ -118,7 +126,10 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                /*when this is enabled, we will sync the parent stream to make sure the subgraph fetches
                                is complete. this is mainly used when the parent kernel depends on the CPU value of the
                                subgraph fetches, i.e. the loop condition*/
-                               bool sync_subgraph_fetches = false);
+                               bool sync_subgraph_fetches = false,
+                               /*the thread pool the kernels of the subgraph run in, or nullptr for the one of its
+                               session state. the parent kernel passes its own so the subgraph runs where it runs*/
+                               concurrency::ThreadPool* intra_op_thread_pool = nullptr);
 
 bool IsInputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 bool IsOutputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
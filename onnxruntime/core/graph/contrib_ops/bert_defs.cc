@@ -277,11 +277,20 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
   }
 
   if (ctx.getNumOutputs() > 1) {  // has present output
-    // copy the type from query to present key
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
+    const int64_t kv_cache_bit_width = getAttribute(ctx, "kv_cache_bit_width", static_cast<int64_t>(0));
+    if (kv_cache_bit_width == 0) {
+      // copy the type from query to present key
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
 
-    // copy the type from query to present value
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+      // copy the type from query to present value
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+    } else {
+      // quantized cache: int8 values, or two int4 values packed in each uint8
+      const auto cache_type = kv_cache_bit_width == 4 ? ONNX_NAMESPACE::TensorProto::UINT8
+                                                      : ONNX_NAMESPACE::TensorProto::INT8;
+      updateOutputElemType(ctx, 1, cache_type);
+      updateOutputElemType(ctx, 2, cache_type);
+    }
 
     if (past_key_index >= 0 && hasInputShape(ctx, past_key_index)) {
       auto& past_shape = getInputShape(ctx, past_key_index);
@@ -1049,6 +1058,8 @@ Supports different number of heads for q and kv for CPU and CUDA.
 Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
+Supports an int8 or int4 quantized k-v cache for CPU (kv_cache_bit_width). The cache is quantized with static
+scales (k_scale and v_scale) when new tokens are appended, and dequantized inside the attention kernel.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1077,6 +1088,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "Use a smooth factor in softmax.",
               AttributeProto::INT,
               static_cast<int64_t>(-1))
+        .Attr("kv_cache_bit_width",
+              "Bit width of the quantized k-v cache. 0 (default) keeps the cache in type T. 8 stores int8 values. "
+              "4 stores signed int4 values packed two per uint8 (the even element in the low nibble), so the last "
+              "dimension of the cache is head_size / 2.",
+              AttributeProto::INT,
+              static_cast<int64_t>(0))
         .Input(0,
                "query",
                "Query with shape (batch_size, sequence_length, hidden_size), or packed QKV with shape"
@@ -1096,13 +1113,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1123,6 +1140,18 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "k_scale",
+               "Static scales of the quantized key cache with shape (kv_num_heads) for per-head scales, or "
+               "(kv_num_heads, head_size / block_size) for blockwise scales. Required when kv_cache_bit_width is "
+               "not 0.",
+               "tensor(float)",
+               OpSchema::Optional)
+        .Input(10,
+               "v_scale",
+               "Static scales of the quantized value cache with the same shape as k_scale.",
+               "tensor(float)",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1132,14 +1161,17 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE",
+                        {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)", "tensor(uint8)"},
+                        "Constrain the k-v cache to type T, or to int8/uint8 when it is quantized.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
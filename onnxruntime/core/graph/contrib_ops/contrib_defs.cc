@@ -631,6 +631,42 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators over broadcast inputs in one pass, as created by the
+ElementwiseChainFusion optimizer. The expression is a list of instructions: `ops` holds the operator of each
+instruction and `operands` holds two operand indices per instruction (the second is -1 for a unary operator).
+An operand index below the number of inputs refers to that input, and index `num_inputs + i` refers to the result
+of instruction i, which shall precede the instruction that reads it. The output is the result of the last
+instruction, with the multidirectional (Numpy-style) broadcast shape of the inputs.
+
+Supported operators: Add, Sub, Mul, Div, Sigmoid, Tanh, Relu, Exp, Erf, Neg, Abs, Sqrt and Reciprocal.
+The intermediate results of float16 inputs are computed in float.
+)DOC";
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDomain(kMSDomain)
+        .SinceVersion(1)
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The operator of each instruction.", AttributeProto::STRINGS)
+        .Attr("operands", "Two operand indices per instruction.", AttributeProto::INTS)
+        .Input(0, "inputs", "The inputs of the expression.", "T", OpSchema::Variadic)
+        .Output(0, "Y", "The result of the last instruction.", "T")
+        .TypeConstraint("T", {"tensor(float)", "tensor(float16)"},
+                        "Constrain input and output types to float and float16 tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          const size_t num_inputs = ctx.getNumInputs();
+          if (hasNInputShapes(ctx, static_cast<int>(num_inputs))) {
+            std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+            for (size_t i = 0; i < num_inputs; i++) {
+              shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+            }
+            multidirectionalBroadcastShapeInference(
+                shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+          }
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -1351,6 +1387,9 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
                                 .Attr("top_p",
                                       "If set to float < 1, only the smallest set of most probable tokens with probabilities that add up to `top_p` or higher are kept for generation.",
                                       AttributeProto::FLOAT, 0.0f)
+                                .Attr("top_k",
+                                      "If set to int > 0, only the `top_k` most probable tokens are kept for generation before the `top_p` filtering. Default value 0 means no top-k filtering.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("filter_value", "All filtered values will be set to this float value.", AttributeProto::FLOAT, -1e20f)
                                 .Attr("min_tokens_to_keep", "Minimumber of tokens we keep per batch example in the output.", AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("presence_penalty", "Presence penalty for custom sampling", AttributeProto::FLOAT, 0.0f)
@@ -2399,6 +2438,43 @@ ONNX_MS_OPERATOR_SET_SCHEMA(WordConvEmbedding, 1,
                                     "Constrain to tensor(float).")
                                 .SetDoc(R"DOC(The WordConvEmbedding takes in a batch of sequence words and embed each word to a vector.)DOC"));
 
+constexpr const char* EmbeddingBag_ver1_doc = R"DOC(
+Looks up bags of rows of an embedding table and pools the rows of every bag, which is the same as a Gather of `data`
+along axis 0 followed by a ReduceSum or ReduceMean over the last axis of `indices`, without materializing the
+gathered rows. E.g. with `indices` of shape [batch_size, bag_size] and `data` of shape [num_embeddings, embedding_dim],
+the output has the shape [batch_size, embedding_dim]. Negative indices count from the end of `data`.
+)DOC";
+ONNX_MS_OPERATOR_SET_SCHEMA(EmbeddingBag, 1,
+                            OpSchema()
+                                .SetDoc(EmbeddingBag_ver1_doc)
+                                .Attr("mode",
+                                      "How the rows of a bag are pooled, 'sum' or 'mean'.",
+                                      AttributeProto::STRING,
+                                      std::string("sum"))
+                                .Input(0, "data", "The embedding table, a tensor of rank r >= 1.", "T")
+                                .Input(1, "indices", "The rows of every bag, a tensor of rank q >= 1.", "Tind")
+                                .Output(0, "output", "The pooled rows, a tensor of rank q - 1 + r - 1.", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  if (!hasNInputShapes(ctx, 2)) {
+                                    return;
+                                  }
+                                  auto& data_shape = getInputShape(ctx, 0);
+                                  auto& indices_shape = getInputShape(ctx, 1);
+                                  if (data_shape.dim_size() < 1 || indices_shape.dim_size() < 1) {
+                                    fail_shape_inference("data and indices must have a rank of at least 1.");
+                                  }
+                                  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+                                  for (int i = 0; i < indices_shape.dim_size() - 1; ++i) {
+                                    *output_shape->add_dim() = indices_shape.dim(i);
+                                  }
+                                  for (int i = 1; i < data_shape.dim_size(); ++i) {
+                                    *output_shape->add_dim() = data_shape.dim(i);
+                                  }
+                                }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(Pad, 1,
                             OpSchema()
                                 .Attr(
@@ -2724,7 +2800,9 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GemmFloat8, 1,
                                     "A",
                                     "Input tensor A. "
                                     "The shape of A should be (M, K) if transA is 0, "
-                                    "or (K, M) if transA is non-zero.",
+                                    "or (K, M) if transA is non-zero. "
+                                    "If transA is 0, A can also be a batch of shape (..., K), "
+                                    "its leading dimensions are flattened into M.",
                                     "TA")
                                 .Input(
                                     1,
@@ -2748,7 +2826,9 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GemmFloat8, 1,
                                 .Input(
                                     4,
                                     "scaleB",
-                                    "Scale of tensor B if B is float 8 tensor",
+                                    "Scale of tensor B if B is float 8 tensor, "
+                                    "a scalar or one scale for each of the N columns of B. "
+                                    "Scales of the columns require no C, no activation and no scaleY.",
                                     "TS",
                                     OpSchema::Optional)
                                 .Input(
@@ -2757,7 +2837,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GemmFloat8, 1,
                                     "Scale of the output tensor if A or B is float 8.",
                                     "TS",
                                     OpSchema::Optional)
-                                .Output(0, "Y", "Output tensor of shape (M, N).", "TR")
+                                .Output(0, "Y", "Output tensor of shape (M, N), or (..., N) for a batch A.", "TR")
                                 .TypeConstraint(
                                     "TA",
                                     GEMM_FLOAT8_TYPES,
@@ -2787,13 +2867,22 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GemmFloat8, 1,
                                   bool transB = transBAttr ? static_cast<int>(transBAttr->i()) != 0 : false;
                                   auto& first_input_shape = getInputShape(ctx, 0);
                                   auto& second_input_shape = getInputShape(ctx, 1);
-                                  if (first_input_shape.dim_size() != 2) {
-                                    fail_shape_inference("First input does not have rank 2");
+                                  if (first_input_shape.dim_size() < 2 || (transA && first_input_shape.dim_size() != 2)) {
+                                    fail_shape_inference("First input does not have rank 2, or at least 2 if transA is 0");
                                   }
                                   if (second_input_shape.dim_size() != 2) {
                                     fail_shape_inference("Second input does not have rank 2");
                                   }
-                                  updateOutputShape(ctx, 0, {first_input_shape.dim(transA ? 1 : 0), second_input_shape.dim(transB ? 0 : 1)});
+                                  if (first_input_shape.dim_size() == 2) {
+                                    updateOutputShape(ctx, 0, {first_input_shape.dim(transA ? 1 : 0), second_input_shape.dim(transB ? 0 : 1)});
+                                    return;
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  for (int i = 0; i < first_input_shape.dim_size() - 1; ++i) {
+                                    *output_shape.add_dim() = first_input_shape.dim(i);
+                                  }
+                                  *output_shape.add_dim() = second_input_shape.dim(transB ? 0 : 1);
+                                  updateOutputShape(ctx, 0, output_shape);
                                 }));
 
 static void MatmulWithQuantWeightShapeInference(ONNX_NAMESPACE::InferenceContext& ctx,
@@ -3677,6 +3766,65 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
         }
       });
 
+  static const char* GatherRowQuantized_ver1_doc = R"DOC(
+GatherRowQuantized looks up rows of an embedding table that is quantized row by row, dequantizes them and optionally
+pools the rows of every bag, as a Gather along axis 0 followed by a ReduceSum or ReduceMean over the last axis of
+`indices` would do with the float table.
+  1. Every row of the table has `embedding_dim` unsigned values of `bits` bits, packed in the bytes of the row of
+     `data` from the lowest bits up, so `data` has the shape [num_embeddings, ceil(embedding_dim * bits / 8)].
+  2. The value q of a row is dequantized as q * scale + bias, with the `scales` and `biases` of the row.
+  3. With `mode` "none" the output has the shape indices.shape + [embedding_dim]. With "sum" or "mean" the rows along
+     the last axis of `indices` are pooled and the output has the shape indices.shape[:-1] + [embedding_dim].
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GatherRowQuantized)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(GatherRowQuantized_ver1_doc)
+      .Attr("bits", "Number of bits of the quantized values, 8, 4 or 2.", AttributeProto::INT, static_cast<int64_t>(8))
+      .Attr("embedding_dim", "Number of values of every row.", AttributeProto::INT)
+      .Attr("mode", "How the rows of a bag are pooled, 'none', 'sum' or 'mean'.", AttributeProto::STRING,
+            std::string("none"))
+      .Input(0, "data", "Quantized table of rank 2, with the packed values of every row.", "T1")
+      .Input(1,
+             "indices",
+             "Tensor of int32/int64 indices. All index values are expected to be within bounds [-s, s-1] where s is "
+             "the number of rows. It is an error if any of the index values are out of bounds.",
+             "Tind")
+      .Input(2, "scales", "Scale of every row, of shape [num_embeddings].", "T2")
+      .Input(3, "biases", "Bias of every row, of shape [num_embeddings].", "T2")
+      .Output(0, "output", "Dequantized, and optionally pooled, rows.", "T3")
+      .TypeConstraint("T1", {"tensor(uint8)"}, "Constrain quantized types.")
+      .TypeConstraint("T2", {"tensor(float)", "tensor(float16)"}, "Constrain quantization parameter types.")
+      .TypeConstraint("T3", {"tensor(float)"}, "Constrain dequantized types.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::FLOAT);
+        if (!hasInputShape(ctx, 1)) {
+          return;
+        }
+        const int64_t bits = getAttribute(ctx, "bits", 8);
+        if (bits != 8 && bits != 4 && bits != 2) {
+          fail_shape_inference("bits must be 8, 4 or 2");
+        }
+        const int64_t embedding_dim = getAttribute(ctx, "embedding_dim", -1);
+        if (embedding_dim < 0) {
+          fail_shape_inference("embedding_dim must be set");
+        }
+        const std::string mode = getAttribute(ctx, "mode", "none");
+        const bool pooled = mode != "none";
+        const TensorShapeProto& indices_shape = getInputShape(ctx, 1);
+        if (pooled && indices_shape.dim_size() < 1) {
+          fail_shape_inference("indices must have a rank of at least 1 to be pooled");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < indices_shape.dim_size() - (pooled ? 1 : 0); ++i) {
+          *output_shape->add_dim() = indices_shape.dim(i);
+        }
+        output_shape->add_dim()->set_dim_value(embedding_dim);
+      });
+
 #ifdef ENABLE_ATEN
   ONNX_CONTRIB_OPERATOR_SCHEMA(ATen)
       .SetDomain(kPytorchAtenDomain)
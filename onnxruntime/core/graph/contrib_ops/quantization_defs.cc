@@ -445,6 +445,42 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::defs::math::utils::MatMulShapeInference(ctx, 0, 1);
         }));
 
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    QLinearFusedMatMul, 1,
+    OpSchema()
+        .SetDoc(R"DOC(
+Matrix product that behaves like numpy.matmul on the quantized inputs A and B, with an optional bias and activation
+applied to the dequantized product before it is requantized with y_scale and y_zero_point:
+Y = QuantizeLinear(activation(DequantizeLinear(A) * DequantizeLinear(B) + bias), y_scale, y_zero_point)
+It is the fusion of DequantizeLinear -> MatMul -> Add -> Relu/Gelu -> QuantizeLinear, keeping the intermediate
+values in the int32 accumulator of the quantized GEMM.
+)DOC")
+        .Attr("activation",
+              "Activation applied after the bias. One of \"Relu\", \"Gelu\" or empty for none. Default is empty.",
+              AttributeProto::STRING, std::string(""))
+        .Input(0, "a", "N-dimensional quantized matrix a", "T1")
+        .Input(1, "a_scale", "scale of quantized input a. It must be a scalar.", "tensor(float)")
+        .Input(2, "a_zero_point", "zero point of quantized input a. It must be a scalar.", "T1")
+        .Input(3, "b", "N-dimensional quantized matrix b", "T2")
+        .Input(4, "b_scale",
+               "scale of quantized input b. It could be a scalar or a 1-D tensor, which means a per-tensor or "
+               "per-column quantization. If it's a 1-D tensor, its number of elements should be equal to the number "
+               "of columns of input b.",
+               "tensor(float)")
+        .Input(5, "b_zero_point", "zero point of quantized input b. It must have the same shape as b_scale.", "T2")
+        .Input(6, "y_scale", "scale of quantized output y. It must be a scalar.", "tensor(float)")
+        .Input(7, "y_zero_point", "zero point of quantized output y. It must be a scalar.", "T3")
+        .Input(8, "bias", "1D float tensor, whose dimension is same as b's last dimension", "tensor(float)",
+               OpSchema::Optional)
+        .Output(0, "y", "Quantized matrix multiply results from a * b", "T3")
+        .TypeConstraint("T1", {"tensor(int8)", "tensor(uint8)"}, "Constrain input a data type to 8-bit integer tensor.")
+        .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain input b data type to 8-bit integer tensor.")
+        .TypeConstraint("T3", {"tensor(int8)", "tensor(uint8)"}, "Constrain output y data type to 8-bit integer tensor.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 7, 0);
+          ONNX_NAMESPACE::defs::math::utils::MatMulShapeInference(ctx, 0, 3);
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearAdd, 1,
     OpSchema().FillUsing(QLinearMathDocGenerator(
@@ -58,6 +58,13 @@ Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
       ORT_RETURN_IF_ERROR(external_writer(src_type, unpacked_tensor, offset));
       external_data_offset = onnxruntime::narrow<int64_t>(offset);  // offset in fb is int64_t so -1 can mark not in use
     } else {
+      // align the data of the initializers that can be used in place from the flatbuffer (see
+      // LoadInitializerOrtFormat), so that the kernels can read it with aligned SIMD loads. the padding is
+      // transparent to readers, so the format version is unchanged.
+      if (unpacked_tensor.size() >= kMinimumSizeForInPlaceInitializer) {
+        builder.ForceVectorAlignment(unpacked_tensor.size(), sizeof(uint8_t), kInPlaceInitializerAlignment);
+      }
+
       raw_data = builder.CreateVector(unpacked_tensor.data(), unpacked_tensor.size());
     }
   }
@@ -299,7 +306,8 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
   } else {
     const auto* fbs_raw_data = fbs_tensor.raw_data();
     if (fbs_raw_data) {
-      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127) {
+      if (load_options.can_use_flatbuffer_for_initializers &&
+          fbs_raw_data->size() >= kMinimumSizeForInPlaceInitializer) {
         initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
 
         static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
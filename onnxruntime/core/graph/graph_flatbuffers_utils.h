@@ -61,6 +61,17 @@ using ExternalDataReader = std::function<Status(uint64_t offset, gsl::span<uint8
 /// </remarks>
 constexpr uint32_t kMinimumSizeForExternalData = 64;
 
+/// <summary>
+/// Minimum number of bytes of raw data for an initializer to use the flatbuffer bytes directly when loading.
+/// </summary>
+constexpr size_t kMinimumSizeForInPlaceInitializer = 128;
+
+/// <summary>
+/// Alignment of the raw data of those initializers within the flatbuffer when saving.
+/// </summary>
+/// <remarks>a cache line, which covers the alignment of the SIMD loads of the kernels.</remarks>
+constexpr size_t kInPlaceInitializerAlignment = 64;
+
 /// <summary>
 /// Save an initializer to an ORT format flatbuffer.
 /// </summary>
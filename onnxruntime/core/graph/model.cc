@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+#include <limits>
 #include <memory>
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/framework/tensorprotoutils.h"
@@ -15,6 +18,7 @@
 #pragma warning(disable : 4800)
 #endif
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -724,6 +728,158 @@ Status Model::Load(int fd, ONNX_NAMESPACE::ModelProto& model_proto) {
   return Status::OK();
 }
 
+namespace {
+using ::google::protobuf::internal::WireFormatLite;
+
+// initializers with less raw data are parsed as usual
+constexpr size_t kMinInPlaceInitializerBytes = 1024;
+
+struct InPlaceInitializerData {
+  int initializer_index;
+  int64_t offset;  // in the model file
+  size_t length;
+};
+
+// Call field_fn(field_number, field_data, field_offset, output) for the length delimited fields of the message in
+// `data`, and copy the other fields as they are. field_fn returns false to copy the field as it is.
+template <typename FieldFn>
+bool FilterMessage(gsl::span<const uint8_t> data, int64_t data_offset, std::string& output, FieldFn&& field_fn) {
+  CodedInputStream input(data.data(), narrow<int>(data.size()));
+  while (true) {
+    const int field_start = input.CurrentPosition();
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      return field_start == narrow<int>(data.size());
+    }
+
+    if (WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t length = 0;
+      if (!input.ReadVarint32(&length) || length > data.size() - input.CurrentPosition()) {
+        return false;
+      }
+
+      const int field_data_start = input.CurrentPosition();
+      input.Skip(static_cast<int>(length));
+      if (field_fn(WireFormatLite::GetTagFieldNumber(tag), data.subspan(field_data_start, length),
+                   data_offset + field_data_start, output)) {
+        continue;
+      }
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return false;
+    }
+
+    output.append(reinterpret_cast<const char*>(data.data()) + field_start, input.CurrentPosition() - field_start);
+  }
+}
+
+// Append a length delimited field with the given contents.
+void AppendLengthDelimitedField(int field_number, const std::string& contents, std::string& output) {
+  using ::google::protobuf::io::CodedOutputStream;
+  uint8_t header[16];
+  uint8_t* header_end = CodedOutputStream::WriteTagToArray(
+      WireFormatLite::MakeTag(field_number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED), header);
+  header_end = CodedOutputStream::WriteVarint32ToArray(narrow<uint32_t>(contents.size()), header_end);
+  output.append(reinterpret_cast<const char*>(header), header_end - header);
+  output.append(contents);
+}
+
+// Parse the ModelProto in `data`, the mapped model file, leaving out the raw data of the large initializers of the main
+// graph. Their locations in the model file are returned in `in_place_data`, so that they can be loaded like external
+// data, and the raw data is never copied into the ModelProto.
+bool ParseModelWithoutInitializerData(gsl::span<const uint8_t> data, ModelProto& model_proto,
+                                      std::vector<InPlaceInitializerData>& in_place_data) {
+  const auto filter_tensor = [&in_place_data](int initializer_index, int field_number,
+                                              gsl::span<const uint8_t> field_data, int64_t field_offset,
+                                              std::string& /*output*/) {
+    if (field_number != TensorProto::kRawDataFieldNumber || field_data.size() < kMinInPlaceInitializerBytes) {
+      return false;
+    }
+
+    in_place_data.push_back({initializer_index, field_offset, field_data.size()});
+    return true;
+  };
+
+  bool valid = true;
+  int initializer_index = 0;
+  const auto filter_graph = [&](int field_number, gsl::span<const uint8_t> field_data, int64_t field_offset,
+                                std::string& output) {
+    if (field_number != GraphProto::kInitializerFieldNumber) {
+      return false;
+    }
+
+    std::string tensor;
+    const auto filter_this_tensor = [&](int tensor_field_number, gsl::span<const uint8_t> tensor_field_data,
+                                        int64_t tensor_field_offset, std::string& tensor_output) {
+      return filter_tensor(initializer_index, tensor_field_number, tensor_field_data, tensor_field_offset,
+                           tensor_output);
+    };
+    valid = valid && FilterMessage(field_data, field_offset, tensor, filter_this_tensor);
+    AppendLengthDelimitedField(field_number, tensor, output);
+    ++initializer_index;
+    return true;
+  };
+
+  const auto filter_model = [&](int field_number, gsl::span<const uint8_t> field_data, int64_t field_offset,
+                                std::string& output) {
+    if (field_number != ModelProto::kGraphFieldNumber) {
+      return false;
+    }
+
+    std::string graph;
+    valid = valid && FilterMessage(field_data, field_offset, graph, filter_graph);
+    AppendLengthDelimitedField(field_number, graph, output);
+    return true;
+  };
+
+  std::string model;
+  return FilterMessage(data, 0, model, filter_model) && valid && model_proto.ParseFromString(model);
+}
+
+// Load the model in `model_path` with the raw data of its large initializers referenced in place, as external data in
+// the model file itself. Only the graph structure is parsed, and the initializer data is mapped from the file when the
+// session state is created, instead of being held by the ModelProto at the same time.
+Status LoadWithInitializersInPlace(int fd, const PathString& model_path, ModelProto& model_proto, bool& loaded) {
+  loaded = false;
+
+  size_t file_size = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(fd, file_size));
+  if (file_size == 0 || file_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return Status::OK();
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  if (!Env::Default().MapFileIntoMemory(model_path.c_str(), 0, file_size, mapped_file).IsOK()) {
+    return Status::OK();
+  }
+
+  std::vector<InPlaceInitializerData> in_place_data;
+  if (!ParseModelWithoutInitializerData(gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_file.get()), file_size),
+                                        model_proto, in_place_data)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+
+  // the external data locations are relative to the directory of the model
+  const std::string model_file_name = ToUTF8String(std::filesystem::path(model_path).filename().native());
+  auto& initializers = *model_proto.mutable_graph()->mutable_initializer();
+  for (const auto& entry : in_place_data) {
+    auto& tensor = initializers[entry.initializer_index];
+    tensor.set_data_location(TensorProto_DataLocation_EXTERNAL);
+    auto* location = tensor.add_external_data();
+    location->set_key("location");
+    location->set_value(model_file_name);
+    auto* offset = tensor.add_external_data();
+    offset->set_key("offset");
+    offset->set_value(std::to_string(entry.offset));
+    auto* length = tensor.add_external_data();
+    length->set_key("length");
+    length->set_value(std::to_string(entry.length));
+  }
+
+  loaded = true;
+  return Status::OK();
+}
+}  // namespace
+
 Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                    const logging::Logger& logger, const ModelOptions& options) {
   return Load(fd, PathString{}, p_model, local_registries, logger, options);
@@ -734,7 +890,14 @@ Status Model::Load(int fd, const PathString& model_path, std::shared_ptr<Model>&
                    const ModelOptions& options) {
   ModelProto model_proto;
 
-  ORT_RETURN_IF_ERROR(Load(fd, model_proto));
+  bool loaded = false;
+  if (options.load_initializers_in_place && !model_path.empty()) {
+    ORT_RETURN_IF_ERROR(LoadWithInitializersInPlace(fd, model_path, model_proto, loaded));
+  }
+
+  if (!loaded) {
+    ORT_RETURN_IF_ERROR(Load(fd, model_proto));
+  }
 
   p_model = std::make_shared<Model>(std::move(model_proto), model_path, local_registries, logger, options);
 
@@ -36,6 +36,11 @@ struct ModelOptions {
   // be returned.
   bool strict_shape_type_inference;
 
+  // If true, a model loaded from a file doesn't copy the raw data of its large initializers into the ModelProto.
+  // They are referenced as external data in the model file instead, and mapped from it when the session state is
+  // created.
+  bool load_initializers_in_place = false;
+
   ModelOptions(bool allow_released_opsets_only, bool strict_shape_type_inference)
       : allow_released_opsets_only(allow_released_opsets_only),
         strict_shape_type_inference(strict_shape_type_inference) {}
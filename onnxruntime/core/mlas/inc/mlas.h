@@ -94,6 +94,16 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Bfloat16 precision GEMM (SBGEMM) is implemented with NEON BF16 on ARM64
+// Linux and with AMX-BF16 on AMD64. MlasBf16AccelerationSupported() reports
+// whether the current processor can run it.
+//
+
+#if (defined(__aarch64__) && defined(__linux__)) || defined(MLAS_TARGET_AMD64)
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -118,6 +128,7 @@ namespace onnxruntime {
         class ThreadPool;
     };
     struct MLFloat16;
+    struct BFloat16;
 };  // namespace onnxruntime
 
 using MLAS_THREADPOOL = onnxruntime::concurrency::ThreadPool;
@@ -161,6 +172,7 @@ enum MLAS_ACTIVATION_KIND {
     MlasLogisticActivation,
     MlasClipActivation,
     MlasHardSigmoidActivation,
+    MlasGeluActivation,
     MlasActivationKindCount,
 };
 
@@ -199,6 +211,27 @@ MlasActivation(
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Operations applied to the output tiles of a single precision gemm
+ *        while they are still resident in cache:
+ *
+ *        C := Activation(alpha * op(A) * op(B) + beta * C + Bias) + Residual
+ *
+ *        Every member is optional.
+ */
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias = nullptr;                /**< Supplies the N elements of the per column bias vector */
+    const MLAS_ACTIVATION* Activation = nullptr; /**< Supplies the activation applied after the bias */
+    const float* Residual = nullptr;            /**< Supplies the M x N matrix added after the activation */
+    size_t ldr = 0;                             /**< Supplies the first dimension of matrix Residual */
+};
+
+/**
+ * @brief Opaque SGEMM kernel generated at runtime for the shape of a matrix B
+ *        packed by MlasGemmPackB. See MlasSgemmJitKernelCreate.
+ */
+struct MLAS_SGEMM_JIT_KERNEL;
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -212,6 +245,9 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr; /**< Optional operations fused into the output tiles */
+    const MLAS_SGEMM_JIT_KERNEL* JitKernel = nullptr; /**< Optional kernel generated for the packed B, used
+                                                           when A is not transposed, alpha is 1 and beta is 0 */
 };
 
 /**
@@ -685,6 +721,38 @@ MlasGemmPackBSize(
     size_t K
     );
 
+/**
+ * @brief Returns true if SGEMM kernels can be generated at runtime on this
+ *        platform (x86-64 with AVX2/FMA3 on Windows and Linux).
+ */
+bool
+MLASCALL
+MlasSgemmJitIsSupported(
+    void
+    );
+
+/**
+ * @brief Returns a SGEMM kernel specialized for a matrix B of N columns and K
+ *        rows packed by MlasGemmPackB, to be supplied in
+ *        MLAS_SGEMM_DATA_PARAMS::JitKernel. Kernels are cached by shape and
+ *        shared. Returns nullptr if kernel generation is not supported.
+ */
+MLAS_SGEMM_JIT_KERNEL*
+MLASCALL
+MlasSgemmJitKernelCreate(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief Releases a kernel returned by MlasSgemmJitKernelCreate.
+ */
+void
+MLASCALL
+MlasSgemmJitKernelFree(
+    MLAS_SGEMM_JIT_KERNEL* Kernel
+    );
+
 void
 MLASCALL
 MlasGemmPackB(
@@ -696,6 +764,87 @@ MlasGemmPackB(
     void* PackedB
     );
 
+/**
+ * @brief Returns the number of blocks of 1x16 values of matrix B that have a
+ *        non-zero value. Only these blocks are packed by MlasSparseSgemmPackB.
+ *
+ * @param TransB  Supplies the transpose operation for matrix B.
+ * @param N       Supplies the number of columns of matrix B.
+ * @param K       Supplies the number of rows of matrix B.
+ * @param B       Supplies the address of matrix B.
+ * @param ldb     Supplies the first dimension of matrix B.
+ */
+size_t
+MLASCALL
+MlasSparseSgemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+/**
+ * @brief Returns the size in bytes of the block sparse packing buffer of a
+ *        matrix B with BlockCount non-zero blocks, or 0 if B is too large.
+ */
+size_t
+MLASCALL
+MlasSparseSgemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t BlockCount
+    );
+
+/**
+ * @brief Packs the non-zero blocks of matrix B in the block sparse format used
+ *        by MlasSparseSgemm. PackedB should be aligned to 64 bytes.
+ */
+void
+MLASCALL
+MlasSparseSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockCount,
+    void* PackedB
+    );
+
+/**
+ * @brief Computes C = alpha * A * B for a matrix B packed by
+ *        MlasSparseSgemmPackB. The work is proportional to the number of
+ *        non-zero blocks of B.
+ *
+ * @param M           Supplies the number of rows of matrix A and matrix C.
+ * @param N           Supplies the number of columns of matrix B and matrix C.
+ * @param K           Supplies the number of columns of matrix A and the number
+ *                    of rows of matrix B.
+ * @param A           Supplies the address of matrix A.
+ * @param lda         Supplies the first dimension of matrix A.
+ * @param PackedB     Supplies the address of the packed matrix B.
+ * @param C           Supplies the address of matrix C.
+ * @param ldc         Supplies the first dimension of matrix C.
+ * @param alpha       Supplies the scalar multiplier.
+ * @param ThreadPool  Supplies the thread pool object to use, else nullptr if
+ *                    the base library threading support should be used.
+ */
+void
+MLASCALL
+MlasSparseSgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    float alpha,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -754,11 +903,26 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
 };
 
+//
+// Output tile of the Winograd minimal filtering algorithm for 3x3 stride 1
+// convolutions. Larger tiles do fewer multiplies per output but lose more
+// single precision accuracy, so the caller selects the largest tile that its
+// accuracy tolerance permits.
+//
+
+enum MLAS_CONV_WINOGRAD_TILE {
+    MlasConvWinogradNone = 0,
+    MlasConvWinogradF2x2 = 2,
+    MlasConvWinogradF4x4 = 4,
+    MlasConvWinogradF6x6 = 6,
+};
+
 struct MLAS_CONV_PARAMETERS {
     const MLAS_ACTIVATION* Activation;
     size_t Dimensions;
@@ -786,6 +950,12 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t OutputTile;
+            size_t TileCountH;
+            size_t TileCountW;
+            size_t TilesPerBlock;
+        } Winograd;
     } u;
 };
 
@@ -805,7 +975,8 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                MLAS_CONV_WINOGRAD_TILE WinogradTile = MlasConvWinogradNone);
 
 void
 MLASCALL
@@ -816,7 +987,44 @@ MlasConv(
     const float* Bias,
     float* WorkingBuffer,
     float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const float* WinogradPackedFilter = nullptr
+    );
+
+/**
+ * @brief Returns the number of floats of a filter transformed by
+ *        MlasConvWinogradPackFilter, or 0 if the tile is MlasConvWinogradNone.
+ *
+ * @param WinogradTile  The output tile passed to MlasConvPrepare.
+ * @param GroupCount    The number of channel groups.
+ * @param InputChannels The number of input channels per group.
+ * @param FilterCount   The number of filters per group.
+ */
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+/**
+ * @brief Transforms a [GroupCount * FilterCount, InputChannels, 3, 3] filter
+ *        for the Winograd convolution algorithm. The transform only depends on
+ *        the filter, so callers with constant weights do it once and pass the
+ *        result to every MlasConv call that MlasConvPrepare assigned to
+ *        MlasConvAlgorithmWinograd.
+ */
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
     );
 
 void
@@ -940,6 +1148,55 @@ MlasConvSymDepthwise(
     const MLAS_CONV_SYM_PARAMS& Params
     );
 
+//
+// Direct quantized integer convolution routines for two dimensional channels
+// last inputs. The input image is read in place instead of through an im2col
+// buffer and the filter is in HWIO format. The output is the int32 accumulator
+// buffer of [OutputCount, OutputChannels] that the caller requantizes.
+//
+
+struct MLAS_CONV_DIRECT_QUANT_PARAMS {
+    const void* Input;
+    int32_t InputZeroPoint;
+    bool InputIsSigned;
+    const void* Filter;
+    int32_t FilterZeroPoint;
+    bool FilterIsSigned;
+    int32_t* Output;
+    size_t InputChannels;
+    size_t OutputChannels;
+    size_t InputShape[2];
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[2];
+    size_t StrideShape[2];
+    size_t OutputShape[2];
+    size_t OutputStart;
+    size_t OutputCount;
+};
+
+void
+MLASCALL
+MlasConvDirectQuant(
+    const MLAS_CONV_DIRECT_QUANT_PARAMS& Params
+    );
+
+/**
+ * @brief Returns the stride M of the direct quantized conv kernel
+ *
+ * The kernel computes a row segment of output pixels at a time, so a
+ * partition of at least this many outputs keeps the filter tap reuse. See
+ * MlasConvDirectQuant.
+ *
+ * @return
+*/
+inline
+int32_t
+MlasConvDirectQuantGetKernelOutputCnt()
+{
+    return 16;
+}
+
 //
 // Pooling routines.
 //
@@ -1025,6 +1282,58 @@ MlasComputeTanh(
     size_t N
     );
 
+//
+// Elementwise binary routines.
+//
+
+enum MLAS_ELTWISE_BINARY_KIND {
+    MlasEltwiseAdd,
+    MlasEltwiseSub,
+    MlasEltwiseMul,
+    MlasEltwiseDiv,
+};
+
+//
+// Computes Output[n] = InputA[n * StrideA] op InputB[n * StrideB]. Strides of
+// zero (a broadcast scalar) and one (a contiguous vector) are vectorized.
+//
+
+void
+MLASCALL
+MlasEltwiseBinary(
+    MLAS_ELTWISE_BINARY_KIND Kind,
+    const float* InputA,
+    size_t StrideA,
+    const float* InputB,
+    size_t StrideB,
+    float* Output,
+    size_t N
+    );
+
+//
+// Normalizes a row of N elements formed as Input + Skip + Bias (Skip and Bias
+// are optional). Computes layer normalization, or RMS normalization if
+// Simplified is true, in which case Shift is ignored. If non-null, SumOutput
+// receives the formed row, and Mean and InvStdDev receive the statistics.
+//
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    float* SumOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -1087,6 +1396,44 @@ MlasTranspose(
     size_t N
     );
 
+//
+// Transposes an M x N matrix whose rows are InputStride elements apart to an
+// N x M matrix whose rows are OutputStride elements apart.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t InputStride,
+    uint8_t* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    size_t InputStride,
+    uint16_t* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t InputStride,
+    uint32_t* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1433,6 +1780,114 @@ constexpr size_t FP16_SIZE = sizeof(uint16_t);
 bool MLASCALL
 MlasFp16AccelerationSupported();
 
+/**
+ * @brief Whether MlasHalfGemmBatch has a vectorized kernel for the current CPU,
+ *        the NEON fp16 kernel on ARM64 or the F16C kernel on x64 with AVX2.
+*/
+bool MLASCALL
+MlasHalfGemmAccelerationSupported();
+
+//
+// Transcendental routines for 16 bit floating point data. The values are
+// widened to single precision a block at a time, processed by the single
+// precision kernels and narrowed again while the block is still in cache.
+//
+
+using MLAS_BF16 = onnxruntime::BFloat16;
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    );
+
+/**
+ * @brief Computes the softmax or log softmax of each of the N rows of D
+ *        elements. The exponentials and the row sums are accumulated in
+ *        single precision. Supports in place updates of the output buffer.
+ */
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief Interface for half gemm post processors.
  *
@@ -1635,7 +2090,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1829,6 +2284,9 @@ MlasNhwcAvgPool(
 
 #endif
 
+//
+// Query is laid out as BxNxSxH, key and value as BxN_kvxLxH and output as BxSxNxH.
+//
 struct MlasFlashAttentionThreadedArgs {
     int batch_size;
     int num_heads;
@@ -1846,6 +2304,35 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+
+    //
+    // Number of key and value heads. Groups of num_heads / kv_num_heads query heads share a key and value head.
+    // 0 means num_heads.
+    //
+    int kv_num_heads = 0;
+    //
+    // Number of rows per head in the key and value buffers, e.g. the capacity of a KV cache that is read in place.
+    // 0 means kv_sequence_length.
+    //
+    int kv_buffer_sequence_length = 0;
+    //
+    // Number of elements between the batches of query, e.g. for packed QKV. 0 means num_heads x S x H.
+    //
+    size_t query_batch_stride = 0;
+    //
+    // Number of valid keys per batch, at most kv_sequence_length. nullptr means kv_sequence_length for every batch.
+    //
+    const int32_t* kv_sequence_lengths = nullptr;
+    //
+    // Whether query row s only attends to the keys at positions up to past + s, where past is the number of keys
+    // before the first query row, given per batch by past_sequence_lengths (nullptr means 0).
+    //
+    bool causal = false;
+    const int32_t* past_sequence_lengths = nullptr;
+    //
+    // If positive, a query row only attends to the last local_window_size + 1 keys it can attend to.
+    //
+    int local_window_size = -1;
 };
 
 /**
@@ -406,6 +406,55 @@ Return Value:
     }
 }
 
+static
+void
+MlasGeluRow(
+    float* Buffer,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exact (erf based) GELU activation in place:
+
+        y = 0.5 * x * (1 + erf(x / sqrt(2)))
+
+Arguments:
+
+    Buffer - Supplies the vector to transform.
+
+    N - Supplies the number of elements of the vector.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t ChunkSize = 256;
+    constexpr float InvSqrt2 = 0.70710678118654752440f;
+    float Temp[ChunkSize];
+
+    while (N > 0) {
+
+        const size_t Count = std::min(N, ChunkSize);
+
+        for (size_t i = 0; i < Count; i++) {
+            Temp[i] = Buffer[i] * InvSqrt2;
+        }
+
+        MlasComputeErf(Temp, Temp, Count);
+
+        for (size_t i = 0; i < Count; i++) {
+            Buffer[i] = 0.5f * Buffer[i] * (1.0f + Temp[i]);
+        }
+
+        Buffer += Count;
+        N -= Count;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -512,6 +561,20 @@ Return Value:
             break;
         }
 
+        case MlasGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            while (M-- > 0) {
+                MlasGeluRow(Buffer, N);
+                Buffer += ldc;
+            }
+
+            break;
+        }
+
         case MlasActivationKindCount:
         {
             MLAS_THROW_EX(std::runtime_error, "bad mlas activation kind");
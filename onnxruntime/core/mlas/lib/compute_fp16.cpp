@@ -0,0 +1,521 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_fp16.cpp
+
+Abstract:
+
+    This module implements the exponential, hyperbolic tangent, error
+    function, logistic and softmax routines for the half precision (fp16) and
+    bfloat16 (bf16) data types.
+
+    The values are widened to single precision one block at a time, the block
+    is processed by the single precision kernels selected for the platform and
+    then narrowed back to the 16 bit type. A block fits in the L1 cache, so the
+    conversions do not make an extra pass over memory, and the accumulations of
+    softmax are done in single precision.
+
+--*/
+
+#include "mlasi.h"
+#include "mlas_float16.h"
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+#include "fp16_common.h"
+#endif
+
+//
+// Number of elements processed per block.
+//
+
+constexpr size_t MLAS_16BIT_BLOCK_SIZE = 1024;
+
+//
+// Conversions between the 16 bit types and single precision.
+//
+
+template <typename T>
+struct MLAS_16BIT_CONVERSION;
+
+template <>
+struct MLAS_16BIT_CONVERSION<MLAS_FP16> {
+    static void Widen(const uint16_t* Source, float* Destination, size_t N)
+    {
+        MlasConvertHalfToFloatBuffer(Source, Destination, N);
+    }
+
+    static void Narrow(const float* Source, uint16_t* d, size_t N)
+    {
+        size_t i = 0;
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+        for (; i + 4 <= N; i += 4) {
+            vst1_u16(d + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(Source + i))));
+        }
+#endif
+
+        for (; i < N; i++) {
+            d[i] = MLAS_Float2Half(Source[i]);
+        }
+    }
+};
+
+template <>
+struct MLAS_16BIT_CONVERSION<MLAS_BF16> {
+    static void Widen(const uint16_t* s, float* Destination, size_t N)
+    {
+        for (size_t i = 0; i < N; i++) {
+            fp32_bits v;
+            v.u = uint32_t(s[i]) << 16;
+            Destination[i] = v.f;
+        }
+    }
+
+    static void Narrow(const float* Source, uint16_t* d, size_t N)
+    {
+        for (size_t i = 0; i < N; i++) {
+            fp32_bits v;
+            v.f = Source[i];
+            if ((v.u & 0x7fffffffu) > 0x7f800000u) {
+                // quiet the NaN, keeping the sign
+                d[i] = uint16_t((v.u >> 16) | 0x0040u);
+            } else {
+                // round to nearest even
+                d[i] = uint16_t((v.u + 0x7fffu + ((v.u >> 16) & 1u)) >> 16);
+            }
+        }
+    }
+};
+
+template <typename T>
+void
+MlasCompute16BitUnary(
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* Routine,
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a single precision elementwise routine to a buffer of
+    the 16 bit floating point type T.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Routine - Supplies the single precision routine.
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Buffer[MLAS_16BIT_BLOCK_SIZE];
+
+    while (N > 0) {
+
+        const size_t Count = std::min(N, MLAS_16BIT_BLOCK_SIZE);
+
+        MLAS_16BIT_CONVERSION<T>::Widen(Input, Buffer, Count);
+        Routine(Buffer, Buffer, Count);
+        MLAS_16BIT_CONVERSION<T>::Narrow(Buffer, Output, Count);
+
+        Input += Count;
+        Output += Count;
+        N -= Count;
+    }
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_FP16>(MlasComputeExp, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_BF16>(MlasComputeExp, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_FP16>(MlasComputeTanh, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_BF16>(MlasComputeTanh, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_FP16>(MlasComputeErf, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_BF16>(MlasComputeErf, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_FP16>(MlasComputeLogistic, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N
+    )
+{
+    MlasCompute16BitUnary<MLAS_BF16>(MlasComputeLogistic, reinterpret_cast<const uint16_t*>(Input),
+                                      reinterpret_cast<uint16_t*>(Output), N);
+}
+
+//
+// Define the parameters to execute segments of a 16 bit softmax operation on
+// worker threads.
+//
+
+template <typename T>
+struct MLAS_SOFTMAX_16BIT_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    bool LogSoftmax;
+    bool SmoothSoftmax;
+    const uint16_t* Input;
+    uint16_t* Output;
+    size_t N;
+    size_t D;
+};
+
+template <typename T>
+void
+MlasComputeSoftmax16BitRow(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function of one row.
+
+    Rows that fit in a single block are widened once. Longer rows are widened
+    block by block in three passes: the maximum, the sum of the exponentials
+    and the output, so the exponentials are never rounded to the 16 bit type
+    before they are normalized.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of elements of the row.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    SmoothSoftmax - Supplies true if a smooth factor is used in softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Buffer[MLAS_16BIT_BLOCK_SIZE];
+
+    const bool SingleBlock = (D <= MLAS_16BIT_BLOCK_SIZE);
+
+    //
+    // Find the maximum value for the row.
+    //
+
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    for (size_t d = 0; d < D; d += MLAS_16BIT_BLOCK_SIZE) {
+
+        const size_t Count = std::min(D - d, MLAS_16BIT_BLOCK_SIZE);
+
+        MLAS_16BIT_CONVERSION<T>::Widen(Input + d, Buffer, Count);
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+        Maximum = std::max(Maximum, GetMlasPlatform().ReduceMaximumF32Kernel(Buffer, Count));
+#else
+        Maximum = std::max(Maximum, MlasReduceMaximumF32Kernel(Buffer, Count));
+#endif
+    }
+
+    float NegativeMaximum = -Maximum;
+    if (SmoothSoftmax && NegativeMaximum > 0.0f) {
+        NegativeMaximum = 0.0f;
+    }
+
+    //
+    // Compute the sum of the exponential functions for the row. The
+    // exponentials are kept for a softmax of a single block.
+    //
+
+    float Accumulation = 0.0f;
+
+    for (size_t d = 0; d < D; d += MLAS_16BIT_BLOCK_SIZE) {
+
+        const size_t Count = std::min(D - d, MLAS_16BIT_BLOCK_SIZE);
+
+        if (!SingleBlock) {
+            MLAS_16BIT_CONVERSION<T>::Widen(Input + d, Buffer, Count);
+        }
+
+        float* Temp = (SingleBlock && !LogSoftmax) ? Buffer : nullptr;
+
+#if defined(MLAS_TARGET_AMD64)
+        Accumulation += GetMlasPlatform().ComputeSumExpF32Kernel(Buffer, Temp, Count, &NegativeMaximum);
+#else
+        Accumulation += MlasComputeSumExpF32Kernel(Buffer, Temp, Count, &NegativeMaximum);
+#endif
+    }
+
+    if (SmoothSoftmax) {
+        Accumulation += expf(NegativeMaximum);
+    }
+
+    //
+    // Compute the output for the row.
+    //
+
+    for (size_t d = 0; d < D; d += MLAS_16BIT_BLOCK_SIZE) {
+
+        const size_t Count = std::min(D - d, MLAS_16BIT_BLOCK_SIZE);
+
+        if (!SingleBlock) {
+            MLAS_16BIT_CONVERSION<T>::Widen(Input + d, Buffer, Count);
+        }
+
+        if (LogSoftmax) {
+
+            float Parameters[] = {NegativeMaximum, std::log(Accumulation)};
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+            GetMlasPlatform().ComputeLogSoftmaxOutputF32Kernel(Buffer, Buffer, Count, Parameters);
+#else
+            MlasComputeLogSoftmaxOutputF32Kernel(Buffer, Buffer, Count, Parameters);
+#endif
+
+        } else {
+
+            if (!SingleBlock) {
+#if defined(MLAS_TARGET_AMD64)
+                GetMlasPlatform().ComputeSumExpF32Kernel(Buffer, Buffer, Count, &NegativeMaximum);
+#else
+                MlasComputeSumExpF32Kernel(Buffer, Buffer, Count, &NegativeMaximum);
+#endif
+            }
+
+            float Parameters[] = {1.0f / Accumulation};
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+            GetMlasPlatform().ComputeSoftmaxOutputF32Kernel(Buffer, Count, Parameters);
+#else
+            MlasComputeSoftmaxOutputF32Kernel(Buffer, Count, Parameters);
+#endif
+        }
+
+        MLAS_16BIT_CONVERSION<T>::Narrow(Buffer, Output + d, Count);
+    }
+}
+
+template <typename T>
+void
+MlasComputeSoftmax16BitThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    16 bit softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_16BIT_WORK_BLOCK<T>*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    const size_t D = WorkBlock->D;
+
+    const uint16_t* Input = WorkBlock->Input + n * D;
+    uint16_t* Output = WorkBlock->Output + n * D;
+
+    while (CountN > 0) {
+
+        MlasComputeSoftmax16BitRow<T>(Input, Output, D, WorkBlock->LogSoftmax, WorkBlock->SmoothSoftmax);
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+template <typename T>
+void
+MlasComputeSoftmax16Bit(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MLAS_SOFTMAX_16BIT_WORK_BLOCK<T> WorkBlock;
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.SmoothSoftmax = SmoothSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Use the same thread partitioning as the single precision softmax.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasComputeSoftmax16BitThreaded<T>, &WorkBlock, ThreadCountN, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasComputeSoftmax16Bit<MLAS_FP16>(reinterpret_cast<const uint16_t*>(Input), reinterpret_cast<uint16_t*>(Output),
+                                       N, D, LogSoftmax, SmoothSoftmax, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_BF16* Input,
+    MLAS_BF16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    bool SmoothSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasComputeSoftmax16Bit<MLAS_BF16>(reinterpret_cast<const uint16_t*>(Input), reinterpret_cast<uint16_t*>(Output),
+                                       N, D, LogSoftmax, SmoothSoftmax, ThreadPool);
+}
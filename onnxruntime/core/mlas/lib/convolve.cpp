@@ -828,7 +828,8 @@ MlasConv(
     const float* Bias,
     float* WorkingBuffer,
     float* Output,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const float* WinogradPackedFilter
     )
 /*++
 
@@ -855,6 +856,10 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    WinogradPackedFilter - Supplies the filter transformed by
+        MlasConvWinogradPackFilter. This is required if MlasConvPrepare
+        selected MlasConvAlgorithmWinograd, else it is ignored.
+
 Return Value:
 
     None.
@@ -874,6 +879,10 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    if (Algorithm == MlasConvAlgorithmWinograd && WinogradPackedFilter == nullptr) {
+        MLAS_THROW_EX(std::invalid_argument, "winograd convolution requires the packed filter");
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -920,6 +929,7 @@ Return Value:
 
         const float* filter = Filter;
         const float* bias = Bias;
+        const float* packed_filter = WinogradPackedFilter;
 
         for (size_t group = 0; group < GroupCount; group++) {
 
@@ -976,6 +986,21 @@ Return Value:
                     break;
                 }
 
+                case MlasConvAlgorithmWinograd:
+                {
+                    MlasConvWinograd(Parameters, Input, packed_filter, WorkingBuffer, Output,
+                        ThreadPool);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
                 case MlasConvAlgorithmDepthwise:
@@ -1012,6 +1037,12 @@ Return Value:
                 bias += FilterCount;
             }
 
+            if (packed_filter != nullptr) {
+                packed_filter += MlasConvWinogradPackFilterSize(
+                    MLAS_CONV_WINOGRAD_TILE(Parameters->u.Winograd.OutputTile), 1,
+                    Parameters->InputChannels, FilterCount);
+            }
+
             filter += FilterGroupSize;
             Input += InputGroupSize;
             Output += OutputGroupSize;
@@ -1041,7 +1072,8 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    MLAS_CONV_WINOGRAD_TILE WinogradTile
     )
 /*++
 
@@ -1088,6 +1120,13 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    WinogradTile - Supplies the Winograd output tile permitted by the accuracy
+        tolerance of the caller, else MlasConvWinogradNone to only use the
+        GEMM based algorithms. The Winograd algorithm is selected for
+        3x3 stride 1 convolutions with enough channels and the caller must
+        then supply the filter transformed by MlasConvWinogradPackFilter for
+        the same tile.
+
 Return Value:
 
     None.
@@ -1211,6 +1250,11 @@ Return Value:
         }
     }
 
+    if (WinogradTile != MlasConvWinogradNone &&
+        MlasConvWinogradPrepare(Parameters, WinogradTile, WorkingBufferSize, ThreadPool)) {
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
@@ -0,0 +1,222 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    eltwise.cpp
+
+Abstract:
+
+    This module implements routines to compute elementwise binary operations
+    (add, subtract, multiply and divide) where either input may be broadcast
+    as a scalar.
+
+--*/
+
+#include "mlasi.h"
+
+struct MLAS_ELTWISE_ADD_OPERATION {
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 A, MLAS_FLOAT32X4 B)
+    {
+        return MlasAddFloat32x4(A, B);
+    }
+
+    static MLAS_FORCEINLINE float Scalar(float A, float B)
+    {
+        return A + B;
+    }
+};
+
+struct MLAS_ELTWISE_SUB_OPERATION {
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 A, MLAS_FLOAT32X4 B)
+    {
+        return MlasSubtractFloat32x4(A, B);
+    }
+
+    static MLAS_FORCEINLINE float Scalar(float A, float B)
+    {
+        return A - B;
+    }
+};
+
+struct MLAS_ELTWISE_MUL_OPERATION {
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 A, MLAS_FLOAT32X4 B)
+    {
+        return MlasMultiplyFloat32x4(A, B);
+    }
+
+    static MLAS_FORCEINLINE float Scalar(float A, float B)
+    {
+        return A * B;
+    }
+};
+
+struct MLAS_ELTWISE_DIV_OPERATION {
+    static MLAS_FORCEINLINE MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 A, MLAS_FLOAT32X4 B)
+    {
+        return MlasDivideFloat32x4(A, B);
+    }
+
+    static MLAS_FORCEINLINE float Scalar(float A, float B)
+    {
+        return A / B;
+    }
+};
+
+template<typename Operation, bool IsScalarA, bool IsScalarB>
+void
+MlasEltwiseBinaryKernel(
+    const float* InputA,
+    const float* InputB,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the binary operation to vectors of elements, where
+    an input flagged as scalar supplies the same element for every output.
+
+Arguments:
+
+    InputA - Supplies the first input buffer.
+
+    InputB - Supplies the second input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScalarVectorA = IsScalarA ? MlasBroadcastFloat32x4(InputA) : MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 ScalarVectorB = IsScalarB ? MlasBroadcastFloat32x4(InputB) : MlasZeroFloat32x4();
+
+    while (N >= 16) {
+
+        for (size_t i = 0; i < 16; i += 4) {
+            MLAS_FLOAT32X4 A = IsScalarA ? ScalarVectorA : MlasLoadFloat32x4(InputA + i);
+            MLAS_FLOAT32X4 B = IsScalarB ? ScalarVectorB : MlasLoadFloat32x4(InputB + i);
+            MlasStoreFloat32x4(Output + i, Operation::Vector(A, B));
+        }
+
+        InputA += IsScalarA ? 0 : 16;
+        InputB += IsScalarB ? 0 : 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 A = IsScalarA ? ScalarVectorA : MlasLoadFloat32x4(InputA);
+        MLAS_FLOAT32X4 B = IsScalarB ? ScalarVectorB : MlasLoadFloat32x4(InputB);
+        MlasStoreFloat32x4(Output, Operation::Vector(A, B));
+
+        InputA += IsScalarA ? 0 : 4;
+        InputB += IsScalarB ? 0 : 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = Operation::Scalar(*InputA, *InputB);
+
+        InputA += IsScalarA ? 0 : 1;
+        InputB += IsScalarB ? 0 : 1;
+        N -= 1;
+    }
+}
+
+template<typename Operation>
+void
+MlasEltwiseBinaryOperation(
+    const float* InputA,
+    size_t StrideA,
+    const float* InputB,
+    size_t StrideB,
+    float* Output,
+    size_t N
+    )
+{
+    if (StrideA == 1 && StrideB == 1) {
+        MlasEltwiseBinaryKernel<Operation, false, false>(InputA, InputB, Output, N);
+    } else if (StrideA == 0 && StrideB == 1) {
+        MlasEltwiseBinaryKernel<Operation, true, false>(InputA, InputB, Output, N);
+    } else if (StrideA == 1 && StrideB == 0) {
+        MlasEltwiseBinaryKernel<Operation, false, true>(InputA, InputB, Output, N);
+    } else {
+
+        for (size_t n = 0; n < N; n++) {
+            Output[n] = Operation::Scalar(*InputA, *InputB);
+            InputA += StrideA;
+            InputB += StrideB;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasEltwiseBinary(
+    MLAS_ELTWISE_BINARY_KIND Kind,
+    const float* InputA,
+    size_t StrideA,
+    const float* InputB,
+    size_t StrideB,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output[n] = InputA[n * StrideA] op InputB[n * StrideB]
+    for n in [0, N). A stride of zero broadcasts a single element and a stride
+    of one is a contiguous vector; both are vectorized. Other strides are
+    processed one element at a time.
+
+Arguments:
+
+    Kind - Supplies the binary operation.
+
+    InputA - Supplies the first input buffer.
+
+    StrideA - Supplies the element stride of the first input.
+
+    InputB - Supplies the second input buffer.
+
+    StrideB - Supplies the element stride of the second input.
+
+    Output - Supplies the contiguous output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasEltwiseAdd:
+            MlasEltwiseBinaryOperation<MLAS_ELTWISE_ADD_OPERATION>(InputA, StrideA, InputB, StrideB, Output, N);
+            break;
+        case MlasEltwiseSub:
+            MlasEltwiseBinaryOperation<MLAS_ELTWISE_SUB_OPERATION>(InputA, StrideA, InputB, StrideB, Output, N);
+            break;
+        case MlasEltwiseMul:
+            MlasEltwiseBinaryOperation<MLAS_ELTWISE_MUL_OPERATION>(InputA, StrideA, InputB, StrideB, Output, N);
+            break;
+        case MlasEltwiseDiv:
+            MlasEltwiseBinaryOperation<MLAS_ELTWISE_DIV_OPERATION>(InputA, StrideA, InputB, StrideB, Output, N);
+            break;
+    }
+}
@@ -1,7 +1,34 @@
+#include <algorithm>
 #include <numeric>
 
 #include "mlasi.h"
 
+namespace {
+
+//
+// Row = Row * Scale.
+//
+MLAS_FORCEINLINE
+void
+MlasFlashAttentionScaleRow(
+    float* Row,
+    size_t N,
+    float Scale
+)
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    size_t n = 0;
+    for (; n + 4 <= N; n += 4) {
+        MlasStoreFloat32x4(Row + n, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Row + n), ScaleVector));
+    }
+    for (; n < N; ++n) {
+        Row[n] *= Scale;
+    }
+}
+
+}  // namespace
+
 void
 MlasFlashAttentionThreaded(
     void* argptr,
@@ -25,6 +52,15 @@ MlasFlashAttentionThreaded(
     const float* value = args->value;
     float* output = args->output;
 
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t kv_buffer_sequence_length = args->kv_buffer_sequence_length > 0
+                                              ? static_cast<ptrdiff_t>(args->kv_buffer_sequence_length)
+                                              : kv_sequence_length;
+    ptrdiff_t query_batch_stride = args->query_batch_stride > 0
+                                       ? static_cast<ptrdiff_t>(args->query_batch_stride)
+                                       : num_heads * q_sequence_length * qk_head_size;
+    ptrdiff_t local_window_size = static_cast<ptrdiff_t>(args->local_window_size);
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
 #endif
@@ -50,34 +86,63 @@ MlasFlashAttentionThreaded(
         batch_idx /= q_chunk_count;
         ptrdiff_t head_idx = batch_idx % num_heads;
         batch_idx /= num_heads;
+        // groups of query heads share a key and value head
+        ptrdiff_t kv_head_idx = head_idx / (num_heads / kv_num_heads);
 
         char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
         float* l = reinterpret_cast<float*>(buffer_current_thread);
         float* m = l + q_block_size;
         for (ptrdiff_t t = 0; t < q_block_size; ++t) {
             m[t] = std::numeric_limits<float>::lowest();
+            l[t] = 0.0f;
         }
         float* intermediate = m + q_block_size;
         float* temp_output = intermediate + q_block_size * kv_block_size;
+        std::fill_n(temp_output, q_block_size * v_head_size, 0.0f);
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+
+        //
+        // The keys query row irow attends to are [KeyBegin(irow), KeyEnd(irow)).
+        //
+        ptrdiff_t kv_length = args->kv_sequence_lengths != nullptr
+                                  ? std::min(static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx]),
+                                             kv_sequence_length)
+                                  : kv_sequence_length;
+        ptrdiff_t past_length = args->past_sequence_lengths != nullptr
+                                    ? static_cast<ptrdiff_t>(args->past_sequence_lengths[batch_idx])
+                                    : 0;
+        auto KeyEnd = [&](ptrdiff_t irow) {
+            return args->causal ? std::min(past_length + q_idx + irow + 1, kv_length) : kv_length;
+        };
+        auto KeyBegin = [&](ptrdiff_t irow) {
+            return local_window_size > 0 ? std::max<ptrdiff_t>(KeyEnd(irow) - local_window_size - 1, 0) : 0;
+        };
+
+        // blocks of keys no row of the query block attends to are skipped
+        ptrdiff_t kv_begin = (KeyBegin(0) / kv_block_size) * kv_block_size;
+        ptrdiff_t kv_end = KeyEnd(row_size_q_valid - 1);
+
+        ptrdiff_t h = batch_idx * kv_num_heads + kv_head_idx;
+        const float* inputQ = query + batch_idx * query_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+
+        for (ptrdiff_t ir = kv_begin; ir < kv_end; ir += kv_block_size) {
             /*
-                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
+                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]).T
+                S = masked(S)
                 old_m = m
                 m = max(m, rowmax(S))
                 diff = old_m - m
                 S = exp(S - m)
                 l = exp(diff) * l + rowsum(S)
-                O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
+                O = diag(exp(diff)) * O + S * V[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const float* inputK = key + (h * kv_buffer_sequence_length + ir) * qk_head_size;
+            const float* inputV = value + (h * kv_buffer_sequence_length + ir) * v_head_size;
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,33 +161,40 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                ptrdiff_t col_begin = std::max<ptrdiff_t>(KeyBegin(irow) - ir, 0);
+                ptrdiff_t col_end = std::min<ptrdiff_t>(KeyEnd(irow) - ir, static_cast<ptrdiff_t>(row_size_kv_capped));
+                if (col_begin >= col_end) {
+                    // the row attends to no key of this block
+                    std::fill_n(p, row_size_kv_capped, 0.0f);
+                    continue;
+                }
+                std::fill(p, p + col_begin, std::numeric_limits<float>::lowest());
+                std::fill(p + col_end, p + row_size_kv_capped, std::numeric_limits<float>::lowest());
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p + col_begin, static_cast<size_t>(col_end - col_begin));
 #else
-                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = MlasReduceMaximumF32Kernel(p + col_begin, static_cast<size_t>(col_end - col_begin));
 #endif
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
                 negmax = -m[irow];
                 m_diff -= m[irow];  // old - new (less than 0)
 
+                // exp() of the masked scores is 0
 #if defined(MLAS_TARGET_AMD64)
                 float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
 #else
                 float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block of the row, l and O are 0, so there is no need to scale them
+                if (l[irow] != 0.0f) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
-
-                    for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                        temp_output[irow * v_head_size + icol] = exp_diff * temp_output[irow * v_head_size + icol];
-                    }
+                    MlasFlashAttentionScaleRow(temp_output + irow * v_head_size, static_cast<size_t>(v_head_size), exp_diff);
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,18 +207,17 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
         float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
-        // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
-            for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
-                output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
-            }
+            // a row that attends to no key, e.g. a padded one, is 0
+            const float* src = temp_output + irow * v_head_size;
+            std::copy_n(src, v_head_size, output_row);
+            MlasFlashAttentionScaleRow(output_row, static_cast<size_t>(v_head_size), l[irow] != 0.0f ? 1.0f / l[irow] : 0.0f);
             output_row += num_heads * v_head_size;
         }
     }
@@ -32,6 +32,12 @@ MlasFp16AccelerationSupported()
 #endif
 }
 
+bool MLASCALL
+MlasHalfGemmAccelerationSupported()
+{
+    return MlasHalfGemmGetDispatch() != &MlasHalfGemmDispatchDefault;
+}
+
 
 void
 MLASCALL
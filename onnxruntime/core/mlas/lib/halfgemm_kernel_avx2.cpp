@@ -0,0 +1,300 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for x64 processors
+    with AVX2, FMA3 and F16C. The fp16 operands are widened to single
+    precision as they are loaded, the products are accumulated in single
+    precision and the results are narrowed again when they are stored.
+
+--*/
+
+#include "mlasi.h"
+#include "mlas_float16.h"
+#include "halfgemm.h"
+
+#include <cstring>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 4;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+MLAS_FORCEINLINE
+__m256
+MlasLoadHalf8Avx2(
+    const _mlas_fp16_* src
+    )
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+MLAS_FORCEINLINE
+__m256
+MlasLoadPartialHalf8Avx2(
+    const _mlas_fp16_* src,
+    size_t len
+    )
+{
+    _mlas_fp16_ buf[8] = {};
+    std::memcpy(buf, src, len * sizeof(_mlas_fp16_));
+    return MlasLoadHalf8Avx2(buf);
+}
+
+MLAS_FORCEINLINE
+void
+MlasStoreHalf8Avx2(
+    _mlas_fp16_* dest,
+    __m256 value
+    )
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+}
+
+MLAS_FORCEINLINE
+void
+MlasStorePartialHalf8Avx2(
+    _mlas_fp16_* dest,
+    __m256 value,
+    size_t len
+    )
+{
+    _mlas_fp16_ buf[8];
+    MlasStoreHalf8Avx2(buf, value);
+    std::memcpy(dest, buf, len * sizeof(_mlas_fp16_));
+}
+
+/**
+ * @brief Computes a block of RowCount rows and up to 16 columns of the output.
+ *        With Partial, CountN may be less than 16 and the columns past it are
+ *        neither read nor written.
+*/
+template<size_t RowCount, bool Partial>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Block(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode
+    )
+{
+    const size_t CountN0 = Partial ? std::min(CountN, size_t{8}) : 8;
+    const size_t CountN1 = Partial ? CountN - CountN0 : 8;
+
+    auto load_row = [&](const _mlas_fp16_* src, __m256& v0, __m256& v1) {
+        if (Partial) {
+            v0 = MlasLoadPartialHalf8Avx2(src, CountN0);
+            v1 = CountN1 > 0 ? MlasLoadPartialHalf8Avx2(src + 8, CountN1) : _mm256_setzero_ps();
+        } else {
+            v0 = MlasLoadHalf8Avx2(src);
+            v1 = MlasLoadHalf8Avx2(src + 8);
+        }
+    };
+
+    __m256 Accumulators[RowCount][2];
+    for (size_t r = 0; r < RowCount; r++) {
+        Accumulators[r][0] = _mm256_setzero_ps();
+        Accumulators[r][1] = _mm256_setzero_ps();
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        __m256 b0, b1;
+        load_row(B, b0, b1);
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 a = _mm256_set1_ps(_cvtsh_ss(A[r * lda + k]));
+            Accumulators[r][0] = _mm256_fmadd_ps(a, b0, Accumulators[r][0]);
+            Accumulators[r][1] = _mm256_fmadd_ps(a, b1, Accumulators[r][1]);
+        }
+        B += ldb;
+    }
+
+    __m256 bias0 = _mm256_setzero_ps();
+    __m256 bias1 = _mm256_setzero_ps();
+    if (ZeroMode && Bias != nullptr) {
+        load_row(Bias, bias0, bias1);
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        _mlas_fp16_* c = C + r * ldc;
+        __m256 c0 = bias0;
+        __m256 c1 = bias1;
+        if (!ZeroMode) {
+            load_row(c, c0, c1);
+        }
+        c0 = _mm256_add_ps(Accumulators[r][0], c0);
+        c1 = _mm256_add_ps(Accumulators[r][1], c1);
+        if (Partial) {
+            MlasStorePartialHalf8Avx2(c, c0, CountN0);
+            if (CountN1 > 0) {
+                MlasStorePartialHalf8Avx2(c + 8, c1, CountN1);
+            }
+        } else {
+            MlasStoreHalf8Avx2(c, c0);
+            MlasStoreHalf8Avx2(c + 8, c1);
+        }
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode
+    )
+{
+    while (CountN >= 16) {
+        MlasHalfGemmKernelAvx2Block<RowCount, false>(16, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+        C += 16;
+        B += 16;
+        if (Bias != nullptr) {
+            Bias += 16;
+        }
+        CountN -= 16;
+    }
+
+    if (CountN > 0) {
+        MlasHalfGemmKernelAvx2Block<RowCount, true>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+    }
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2HalfAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+    )
+{
+    while (len >= 8) {
+        MlasStoreHalf8Avx2(dest, _mm256_loadu_ps(src));
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        dest[i] = MLAS_Float2Half(src[i]);
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2DAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        CvtFloat2HalfAvx2(dest, src, CntRow * CntCol);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2HalfAvx2(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx2(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2DAvx2(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx2Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx2Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx2Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx2Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0 // partial panels are staged through local buffers, nothing is read beyond the end
+};
@@ -0,0 +1,224 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute layer normalization and RMS
+    normalization of a row, optionally fused with the residual (skip) and bias
+    additions that precede the normalization in transformer models.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasLayerNormLoadValue(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    size_t n
+    )
+{
+    MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(Input + n);
+
+    if (Skip != nullptr) {
+        Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Skip + n));
+    }
+
+    if (Bias != nullptr) {
+        Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Bias + n));
+    }
+
+    return Value;
+}
+
+void
+MLASCALL
+MlasLayerNormalization(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    float* SumOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes a row of N elements.
+
+    The row is first formed as Input + Skip + Bias, where Skip and Bias are
+    optional. The statistics of the row are accumulated in the same pass that
+    forms the row, and the formed row is kept in the output buffer so that the
+    second pass reads it from cache instead of reading the inputs again.
+
+    For layer normalization the output is (x - mean) / sqrt(variance + Epsilon)
+    * Scale + Shift. For RMS normalization (Simplified) the output is
+    x / sqrt(mean(x * x) + Epsilon) * Scale and Shift is ignored.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the residual row added to the input.
+
+    Bias - Optionally supplies the bias row added to the input.
+
+    Scale - Supplies the scale (gamma) row.
+
+    Shift - Optionally supplies the shift (beta) row.
+
+    Output - Supplies the output row.
+
+    SumOutput - Optionally supplies the buffer that receives Input + Skip +
+        Bias.
+
+    N - Supplies the number of elements in the row.
+
+    Epsilon - Supplies the value added to the variance for numerical
+        stability.
+
+    Simplified - Supplies true to compute RMS normalization.
+
+    Mean - Optionally receives the mean of the row.
+
+    InvStdDev - Optionally receives the reciprocal of the standard deviation
+        (or root mean square) of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Form the row and accumulate the sum and the sum of squares.
+    //
+
+    const bool IsFused = Skip != nullptr || Bias != nullptr;
+    float* Staging = (SumOutput != nullptr) ? SumOutput : Output;
+
+    MLAS_FLOAT32X4 Sum0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Sum1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquares0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquares1 = MlasZeroFloat32x4();
+
+    size_t n = 0;
+
+    for (; n + 8 <= N; n += 8) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLayerNormLoadValue(Input, Skip, Bias, n);
+        MLAS_FLOAT32X4 Value1 = MlasLayerNormLoadValue(Input, Skip, Bias, n + 4);
+
+        if (IsFused) {
+            MlasStoreFloat32x4(Staging + n, Value0);
+            MlasStoreFloat32x4(Staging + n + 4, Value1);
+        }
+
+        Sum0 = MlasAddFloat32x4(Sum0, Value0);
+        Sum1 = MlasAddFloat32x4(Sum1, Value1);
+        SumSquares0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquares0);
+        SumSquares1 = MlasMultiplyAddFloat32x4(Value1, Value1, SumSquares1);
+    }
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Value0 = MlasLayerNormLoadValue(Input, Skip, Bias, n);
+
+        if (IsFused) {
+            MlasStoreFloat32x4(Staging + n, Value0);
+        }
+
+        Sum0 = MlasAddFloat32x4(Sum0, Value0);
+        SumSquares0 = MlasMultiplyAddFloat32x4(Value0, Value0, SumSquares0);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Sum0, Sum1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquares0, SumSquares1));
+
+    for (; n < N; n++) {
+
+        float Value = Input[n];
+
+        if (Skip != nullptr) {
+            Value += Skip[n];
+        }
+
+        if (Bias != nullptr) {
+            Value += Bias[n];
+        }
+
+        if (IsFused) {
+            Staging[n] = Value;
+        }
+
+        Sum += Value;
+        SumSquares += Value * Value;
+    }
+
+    const float MeanValue = Sum / float(N);
+    const float Variance = Simplified ? SumSquares / float(N) : SumSquares / float(N) - MeanValue * MeanValue;
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row. Simplified normalization has no mean to subtract.
+    //
+
+    const float* Source = IsFused ? Staging : Input;
+    const float Center = Simplified ? 0.0f : MeanValue;
+
+    if (Simplified) {
+        Shift = nullptr;
+    }
+
+    MLAS_FLOAT32X4 CenterVector = MlasBroadcastFloat32x4(Center);
+    MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDevValue);
+
+    for (n = 0; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Value = MlasSubtractFloat32x4(MlasLoadFloat32x4(Source + n), CenterVector);
+        Value = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(Value, InvStdDevVector), MlasLoadFloat32x4(Scale + n));
+
+        if (Shift != nullptr) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Shift + n));
+        }
+
+        MlasStoreFloat32x4(Output + n, Value);
+    }
+
+    for (; n < N; n++) {
+
+        float Value = (Source[n] - Center) * InvStdDevValue * Scale[n];
+
+        if (Shift != nullptr) {
+            Value += Shift[n];
+        }
+
+        Output[n] = Value;
+    }
+}
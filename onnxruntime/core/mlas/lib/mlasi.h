@@ -191,6 +191,8 @@ class MLASCPUIDInfo
 
     bool HasArmNeon_I8MM() const { return has_arm_neon_i8mm_; }
 
+    bool HasArmSVE() const { return has_arm_sve_; }
+
     bool HasArmSVE_I8MM() const { return has_arm_sve_i8mm_; }
 
     bool HasArmNeon_BF16() const { return has_arm_neon_bf16_; }
@@ -201,6 +203,7 @@ class MLASCPUIDInfo
     bool has_arm_neon_dot_{false};
     bool has_fp16_{false};
     bool has_arm_neon_i8mm_{false};
+    bool has_arm_sve_{false};
     bool has_arm_sve_i8mm_{false};
     bool has_arm_neon_bf16_{false};
 };
@@ -762,6 +765,10 @@ extern "C" {
 #else
     MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelZero;
     MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelAdd;
+#if defined(__aarch64__) && defined(__linux__)
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelSveZero;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelSveAdd;
+#endif
 #if defined(__aarch64__) && defined(__linux__)
     MLAS_SBGEMM_FLOAT_KERNEL MlasSbgemmKernelZero;
     MLAS_SBGEMM_FLOAT_KERNEL MlasSbgemmKernelAdd;
@@ -898,7 +905,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -920,7 +927,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
     );
 
 //
@@ -991,6 +999,8 @@ struct MLAS_SQNBIT_GEMM_DISPATCH;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon;
 
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchSve;
+
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2vnni;
@@ -999,6 +1009,24 @@ extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchWasmSimd;
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx;
+
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1084,6 +1112,8 @@ struct MLAS_PLATFORM {
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8S8Dispatch;
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8U8Dispatch;
 #elif defined(MLAS_TARGET_ARM64)
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelZero;
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelAdd;
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8U8Dispatch;
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8S8Dispatch;
     const MLAS_GEMM_QUANT_DISPATCH* GemmS8S8Dispatch;
@@ -1151,6 +1181,11 @@ struct MLAS_PLATFORM {
     const MLAS_Q8Q4GEMM_DISPATCH* Q8Q4GemmDispatch{nullptr};
 
     const MLAS_SQNBIT_GEMM_DISPATCH* SQNBitGemmDispatch{nullptr};
+
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+#endif
 };
 
 inline
@@ -1301,6 +1336,46 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd convolution routines.
+//
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Shape specialized SGEMM kernels generated at runtime.
+//
+
+bool
+MlasSgemmJitOperation(
+    const MLAS_SGEMM_JIT_KERNEL* Kernel,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
@@ -2028,7 +2103,12 @@ MlasMultiplyAddFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2, MLAS_FL
 #elif defined(MLAS_VSX_INTRINSICS)
     return vec_madd(Vector1, Vector2, Vector3);
 #elif defined(MLAS_WASM_SIMD_INTRINSICS)
+#if defined(__wasm_relaxed_simd__)
+    // fused where the host has FMA, so the result may differ in the last bit between hosts
+    return wasm_f32x4_relaxed_madd(Vector1, Vector2, Vector3);
+#else
     return wasm_f32x4_add(wasm_f32x4_mul(Vector1, Vector2), Vector3);
+#endif
 #elif defined(MLAS_LSX_INTRINSICS)
     return __lsx_vfmadd_s(Vector1, Vector2, Vector3);
 #else
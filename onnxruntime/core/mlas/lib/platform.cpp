@@ -17,9 +17,23 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <mutex>
 
+#if defined(MLAS_TARGET_ARM64) && defined(__linux__)
+#include <sys/prctl.h>
+// N.B. Support building with older versions of sys/prctl.h that do not define
+// the SVE vector length controls.
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
+#endif
+
 #if defined(MLAS_TARGET_POWER) 
 #if defined(__linux__)
 #include <sys/auxv.h>
@@ -59,6 +73,10 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -80,6 +98,7 @@ MLASCPUIDInfo::MLASCPUIDInfo()
     has_fp16_ = has_arm_neon_dot_;
 
     has_arm_neon_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_I8MM) != 0);
+    has_arm_sve_ = ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0);
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
@@ -196,6 +215,76 @@ MlasInitAMX()
 #endif
 }
 
+//
+// Maximum instruction set the platform may dispatch to, given by the
+// ORT_MLAS_MAXIMUM_ISA environment variable.
+//
+
+enum MLAS_DISPATCH_ISA {
+    MlasDispatchIsaSse,
+    MlasDispatchIsaAvx,
+    MlasDispatchIsaAvx2,
+    MlasDispatchIsaAvx512,
+    MlasDispatchIsaAmx,
+};
+
+static
+MLAS_DISPATCH_ISA
+MlasGetDispatchIsaLimit(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the maximum instruction set that the platform
+    initialization may select kernels for. Capping the instruction set allows
+    the kernels of different instruction sets to be compared on one machine.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    The instruction set limit, or MlasDispatchIsaAmx if the environment
+    variable is not set or is not one of "sse", "avx", "avx2", "avx512" or
+    "amx".
+
+--*/
+{
+#if defined(_WIN32)
+    char Value[16];
+    const DWORD Length = GetEnvironmentVariableA("ORT_MLAS_MAXIMUM_ISA", Value, sizeof(Value));
+    if (Length == 0 || Length >= sizeof(Value)) {
+        return MlasDispatchIsaAmx;
+    }
+#else
+    const char* Value = getenv("ORT_MLAS_MAXIMUM_ISA");
+    if (Value == nullptr) {
+        return MlasDispatchIsaAmx;
+    }
+#endif
+
+    static const struct {
+        const char* Name;
+        MLAS_DISPATCH_ISA Isa;
+    } IsaNames[] = {
+        {"sse", MlasDispatchIsaSse},
+        {"avx", MlasDispatchIsaAvx},
+        {"avx2", MlasDispatchIsaAvx2},
+        {"avx512", MlasDispatchIsaAvx512},
+    };
+
+    for (const auto& IsaName : IsaNames) {
+        if (strcmp(Value, IsaName.Name) == 0) {
+            return IsaName.Isa;
+        }
+    }
+
+    return MlasDispatchIsaAmx;
+}
+
 #endif // MLAS_TARGET_AMD64_IX86
 
 #ifdef MLAS_TARGET_LARCH64
@@ -298,6 +387,20 @@ Return Value:
     __cpuid(1, Cpuid1[0], Cpuid1[1], Cpuid1[2], Cpuid1[3]);
 #endif
 
+    //
+    // Hide the processor features above the requested instruction set limit.
+    //
+
+    const MLAS_DISPATCH_ISA IsaLimit = MlasGetDispatchIsaLimit();
+
+    if (IsaLimit < MlasDispatchIsaAvx) {
+        Cpuid1[2] &= ~0x18000000u;
+    }
+
+    if (IsaLimit < MlasDispatchIsaAvx2) {
+        Cpuid1[2] &= ~0x1000u;
+    }
+
 #if defined(_MSC_VER)
 
     //
@@ -356,6 +459,14 @@ Return Value:
             __cpuid_count(7, 0, Cpuid7[0], Cpuid7[1], Cpuid7[2], Cpuid7[3]);
 #endif
 
+            if (IsaLimit < MlasDispatchIsaAvx512) {
+                Cpuid7[1] &= ~0x10000u;
+            }
+
+            if (IsaLimit < MlasDispatchIsaAmx) {
+                Cpuid7[3] &= ~((1u << 22) | (1u << 24) | (1u << 25));
+            }
+
             if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
 
                 this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAvx2;
@@ -384,6 +495,15 @@ Return Value:
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
                 this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
 
+                //
+                // Check if the processor supports F16C, which converts the
+                // fp16 operands of the half precision GEMM.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
+
                 //
                 // Check if the processor supports Hybrid core architecture.
                 //
@@ -479,6 +599,15 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+
+                        //
+                        // Check if the processor supports AMX-BF16 and
+                        // AVX512F, which converts the operands to bf16.
+                        //
+                        if ((Cpuid7[3] & 0b1 << 22) != 0 &&
+                            (Cpuid7[1] & 0x10000) != 0 && (xcr0 & 0xE0) == 0xE0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
+                        }
                     }
                 }
 #endif // __APPLE__
@@ -496,6 +625,9 @@ Return Value:
 
 #if defined(MLAS_TARGET_ARM64)
 
+    this->GemmFloatKernelZero = MlasSgemmKernelZero;
+    this->GemmFloatKernelAdd = MlasSgemmKernelAdd;
+
     this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchNeon;
     this->GemmU8S8Dispatch = &MlasGemmX8S8DispatchNeon;
     this->GemmS8S8Dispatch = &MlasGemmX8S8DispatchNeon;
@@ -545,6 +677,26 @@ Return Value:
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
     }
+
+    //
+    // Check if the processor supports SVE with vectors wider than 128 bits.
+    // The NEON kernels are tuned for 128-bit vectors, so the vector length
+    // agnostic SVE kernels are only used when they process more data per
+    // instruction, e.g. the 256-bit vectors of Neoverse V1.
+    //
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmSVE()) {
+        const int SveVectorLength = prctl(PR_SVE_GET_VL);
+        if (SveVectorLength > 0 && (SveVectorLength & PR_SVE_VL_LEN_MASK) >= 32) {
+            this->GemmFloatKernelZero = MlasSgemmKernelSveZero;
+            this->GemmFloatKernelAdd = MlasSgemmKernelSveAdd;
+
+            // MlasSQNBitGemmDispatchSve falls back to the NEON kernels that
+            // depend on dot product instructions
+            if (HasDotProductInstructions) {
+                this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchSve;
+            }
+        }
+    }
 #endif
 
 #endif // MLAS_TARGET_ARM64
@@ -588,6 +740,10 @@ Return Value:
 
 #endif // MLAS_TARGET_POWER
 
+#if defined(MLAS_TARGET_WASM_SIMD)
+    this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchWasmSimd;
+#endif
+
 #if defined(MLAS_TARGET_LARCH64)
 
     //
@@ -0,0 +1,305 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qconv_direct.cpp
+
+Abstract:
+
+    This module implements the direct quantized integer convolution routines
+    for two dimensional channels last (NHWC) inputs.
+
+    Unlike the im2col/QGEMM path, the input image is read in place: for every
+    filter tap, each output pixel of a row segment accumulates the dot product
+    of its input pixel vector with the HWIO filter slice of that tap. The row
+    segment is sized so that its accumulators and the filter slice stay
+    resident in the L1 cache while the input rows stream through.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of int32 accumulators of a row segment that are kept resident in the
+// L1 cache.
+//
+
+constexpr size_t MLAS_CONV_DIRECT_QUANT_ACCUMULATOR_COUNT = 4096;
+
+template <typename InputType, typename FilterType>
+MLAS_FORCEINLINE
+void
+MlasConvDirectQuantAccumulatePixel(
+    const InputType* Input,
+    int32_t InputZeroPoint,
+    const FilterType* Filter,
+    int32_t FilterZeroPoint,
+    int32_t* Output,
+    size_t InputChannels,
+    size_t OutputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine accumulates the product of a single input pixel vector with a
+    filter tap of shape [InputChannels, OutputChannels] into a row of
+    OutputChannels accumulators.
+
+Arguments:
+
+    Input - Supplies the input pixel vector of length InputChannels.
+
+    InputZeroPoint - Supplies the zero point offset of the input tensor.
+
+    Filter - Supplies the filter tap in IO format.
+
+    FilterZeroPoint - Supplies the zero point offset of the filter tensor.
+
+    Output - Supplies the accumulators of the output pixel.
+
+    InputChannels - Supplies the number of input channels.
+
+    OutputChannels - Supplies the number of output channels.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t f = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i ZeroVector = _mm_setzero_si128();
+    const __m128i FilterZeroPointVector = _mm_set1_epi16(int16_t(FilterZeroPoint));
+
+    auto LoadFilter = [&](const FilterType* filter) {
+        __m128i FilterVector = _mm_loadl_epi64((const __m128i*)filter);
+        if (std::is_signed<FilterType>::value) {
+            FilterVector = _mm_srai_epi16(_mm_unpacklo_epi8(ZeroVector, FilterVector), 8);
+        } else {
+            FilterVector = _mm_unpacklo_epi8(FilterVector, ZeroVector);
+        }
+        return _mm_sub_epi16(FilterVector, FilterZeroPointVector);
+    };
+
+    for (; f + 8 <= OutputChannels; f += 8) {
+        __m128i Accumulator0 = _mm_loadu_si128((const __m128i*)&Output[f]);
+        __m128i Accumulator1 = _mm_loadu_si128((const __m128i*)&Output[f + 4]);
+        const FilterType* filter = Filter + f;
+        size_t c = 0;
+
+        //
+        // Process pairs of input channels: interleave the two filter rows so
+        // that PMADDWD forms x[c] * w[c][f] + x[c+1] * w[c+1][f] per lane.
+        //
+
+        for (; c + 2 <= InputChannels; c += 2) {
+            const int32_t InputValue0 = int32_t(Input[c]) - InputZeroPoint;
+            const int32_t InputValue1 = int32_t(Input[c + 1]) - InputZeroPoint;
+            const __m128i InputPair =
+                _mm_set1_epi32(int32_t((uint32_t(InputValue1) << 16) | (uint32_t(InputValue0) & 0xFFFF)));
+
+            const __m128i FilterVector0 = LoadFilter(filter);
+            const __m128i FilterVector1 = LoadFilter(filter + OutputChannels);
+
+            Accumulator0 = _mm_add_epi32(Accumulator0,
+                _mm_madd_epi16(_mm_unpacklo_epi16(FilterVector0, FilterVector1), InputPair));
+            Accumulator1 = _mm_add_epi32(Accumulator1,
+                _mm_madd_epi16(_mm_unpackhi_epi16(FilterVector0, FilterVector1), InputPair));
+
+            filter += 2 * OutputChannels;
+        }
+
+        if (c < InputChannels) {
+            const int32_t InputValue0 = int32_t(Input[c]) - InputZeroPoint;
+            const __m128i InputPair = _mm_set1_epi32(InputValue0 & 0xFFFF);
+            const __m128i FilterVector0 = LoadFilter(filter);
+
+            Accumulator0 = _mm_add_epi32(Accumulator0,
+                _mm_madd_epi16(_mm_unpacklo_epi16(FilterVector0, ZeroVector), InputPair));
+            Accumulator1 = _mm_add_epi32(Accumulator1,
+                _mm_madd_epi16(_mm_unpackhi_epi16(FilterVector0, ZeroVector), InputPair));
+        }
+
+        _mm_storeu_si128((__m128i*)&Output[f], Accumulator0);
+        _mm_storeu_si128((__m128i*)&Output[f + 4], Accumulator1);
+    }
+
+#elif defined(MLAS_NEON_INTRINSICS)
+
+    const uint8x8_t FilterZeroPointVector = vdup_n_u8(uint8_t(FilterZeroPoint));
+
+    for (; f + 8 <= OutputChannels; f += 8) {
+        int32x4_t Accumulator0 = vld1q_s32(&Output[f]);
+        int32x4_t Accumulator1 = vld1q_s32(&Output[f + 4]);
+        const FilterType* filter = Filter + f;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+            const int16_t InputValue = int16_t(int32_t(Input[c]) - InputZeroPoint);
+            const uint8x8_t FilterVector = vld1_u8(reinterpret_cast<const uint8_t*>(filter));
+
+            int16x8_t FilterVector16;
+            if (std::is_signed<FilterType>::value) {
+                FilterVector16 = vsubl_s8(vreinterpret_s8_u8(FilterVector),
+                                          vreinterpret_s8_u8(FilterZeroPointVector));
+            } else {
+                FilterVector16 = vreinterpretq_s16_u16(vsubl_u8(FilterVector, FilterZeroPointVector));
+            }
+
+            Accumulator0 = vmlal_n_s16(Accumulator0, vget_low_s16(FilterVector16), InputValue);
+            Accumulator1 = vmlal_n_s16(Accumulator1, vget_high_s16(FilterVector16), InputValue);
+
+            filter += OutputChannels;
+        }
+
+        vst1q_s32(&Output[f], Accumulator0);
+        vst1q_s32(&Output[f + 4], Accumulator1);
+    }
+
+#endif
+
+    for (; f < OutputChannels; f++) {
+        int32_t Accumulator = Output[f];
+        const FilterType* filter = Filter + f;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+            Accumulator += (int32_t(Input[c]) - InputZeroPoint) * (int32_t(*filter) - FilterZeroPoint);
+            filter += OutputChannels;
+        }
+
+        Output[f] = Accumulator;
+    }
+}
+
+template <typename InputType, typename FilterType>
+void
+MlasConvDirectQuantKernel(
+    const MLAS_CONV_DIRECT_QUANT_PARAMS& Params
+    )
+{
+    const InputType* Input = static_cast<const InputType*>(Params.Input);
+    const FilterType* Filter = static_cast<const FilterType*>(Params.Filter);
+    const int32_t InputZeroPoint = Params.InputZeroPoint;
+    const int32_t FilterZeroPoint = Params.FilterZeroPoint;
+
+    const size_t InputChannels = Params.InputChannels;
+    const size_t OutputChannels = Params.OutputChannels;
+    const size_t InputHeight = Params.InputShape[0];
+    const size_t InputWidth = Params.InputShape[1];
+    const size_t KernelHeight = Params.KernelShape[0];
+    const size_t KernelWidth = Params.KernelShape[1];
+    const size_t OutputWidth = Params.OutputShape[1];
+    const size_t FilterTapSize = InputChannels * OutputChannels;
+
+    const size_t SegmentWidth =
+        std::max<size_t>(1, MLAS_CONV_DIRECT_QUANT_ACCUMULATOR_COUNT / OutputChannels);
+
+    int32_t* Output = Params.Output;
+    size_t OutputIndex = Params.OutputStart;
+    size_t OutputCount = Params.OutputCount;
+
+    std::fill_n(Output, OutputCount * OutputChannels, 0);
+
+    while (OutputCount > 0) {
+
+        //
+        // Process a segment of output pixels from the same output row.
+        //
+
+        const size_t oh = OutputIndex / OutputWidth;
+        const size_t ow = OutputIndex % OutputWidth;
+        const size_t SegmentCount = std::min({OutputCount, OutputWidth - ow, SegmentWidth});
+
+        for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+            //
+            // Padded input pixels are equal to the input zero point and do not
+            // contribute to the accumulators, so taps that fall outside the
+            // input image are skipped.
+            //
+
+            const size_t ih = oh * Params.StrideShape[0] + ky * Params.DilationShape[0] - Params.Padding[0];
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            const InputType* InputRow = Input + ih * InputWidth * InputChannels;
+
+            for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+                const FilterType* FilterTap = Filter + (ky * KernelWidth + kx) * FilterTapSize;
+
+                for (size_t i = 0; i < SegmentCount; i++) {
+
+                    const size_t iw = (ow + i) * Params.StrideShape[1] + kx * Params.DilationShape[1] - Params.Padding[1];
+
+                    if (iw >= InputWidth) {
+                        continue;
+                    }
+
+                    MlasConvDirectQuantAccumulatePixel(InputRow + iw * InputChannels, InputZeroPoint,
+                                                       FilterTap, FilterZeroPoint,
+                                                       Output + i * OutputChannels,
+                                                       InputChannels, OutputChannels);
+                }
+            }
+        }
+
+        Output += SegmentCount * OutputChannels;
+        OutputIndex += SegmentCount;
+        OutputCount -= SegmentCount;
+    }
+}
+
+void
+MLASCALL
+MlasConvDirectQuant(
+    const MLAS_CONV_DIRECT_QUANT_PARAMS& Params
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the direct quantized integer convolution of a two
+    dimensional channels last image.
+
+    The output pixels in the range [OutputStart, OutputStart + OutputCount) of
+    the flattened output image are computed as int32 accumulators of
+    (Input - InputZeroPoint) * (Filter - FilterZeroPoint). The caller is
+    responsible for adding the bias and requantizing the accumulators.
+
+    The filter tensor is organized in HWIO format, so each filter tap is a
+    matrix of [InputChannels, OutputChannels].
+
+Arguments:
+
+    Params - Supplies the structure that contains the convolution parameters.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Params.InputIsSigned) {
+        if (Params.FilterIsSigned) {
+            MlasConvDirectQuantKernel<int8_t, int8_t>(Params);
+        } else {
+            MlasConvDirectQuantKernel<int8_t, uint8_t>(Params);
+        }
+    } else {
+        if (Params.FilterIsSigned) {
+            MlasConvDirectQuantKernel<uint8_t, int8_t>(Params);
+        } else {
+            MlasConvDirectQuantKernel<uint8_t, uint8_t>(Params);
+        }
+    }
+}
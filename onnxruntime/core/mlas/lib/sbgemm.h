@@ -30,8 +30,6 @@ Abstract:
         MLAS_SBGEMM_STRIDES Strides{128, 128, 256};
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #pragma once
 
 #include <cassert>
@@ -39,6 +37,15 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+#if defined(MLAS_TARGET_AMD64)
+//
+// There is no native bfloat16 type, bf16 values are stored as their raw bits.
+//
+typedef uint16_t bfloat16_t;
+#endif
+
 /**
  * @brief Define the default striding parameters for
  *        the bfloat16 precision gemm operation
@@ -134,7 +141,9 @@ MlasSBGemmPackedOperation(size_t M, size_t RangeStartN, size_t RangeCountN, size
             bool ZeroMode = (k == 0);
             CountK = std::min(K - k, PackedStrideK);
 
-            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + CountK * SliceStartN;
+            // the columns of a K slice are packed in groups of CountK rows, padded to PackedK
+            const size_t AlignedCountK = (CountK + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
+            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + AlignedCountK * SliceStartN;
             float* c = C + n;
             const float* pbias = ((nullptr == Bias) ? nullptr : Bias + RangeStartN + n);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, pb, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -162,7 +171,8 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
     size_t StrideK = Strides.K;
 
     if (N >= K) {
-        while (StrideK / 2 >= K) {
+        // the B panel is padded to PackedK rows, which must fit in the buffer
+        while (StrideK / 2 >= K && StrideK / 2 >= KernelType::PackedK) {
             StrideN *= 2;
             StrideK /= 2;
         }
@@ -291,6 +301,9 @@ MlasSBGemmGetDispatch()
 {
 #if defined(MLAS_TARGET_ARM64)
     return &MlasSBGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    // nullptr when the processor does not support AMX-BF16
+    return GetMlasPlatform().SBGemmDispatch;
 #else
     std::cerr << "SBGemm Kernel is supported only on ARM64 platform.";
     exit(1);
@@ -396,4 +409,4 @@ MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t Bat
         }
     );
 }
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
@@ -0,0 +1,395 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AMX-BF16.
+
+    A is converted to bf16 on the fly, B is converted and packed into the
+    VNNI layout of AMX tiles: every row of a 16x16 B tile holds pairs of
+    consecutive K values of the 16 columns.
+
+--*/
+
+#include <cstring>
+
+#include "mlasi.h"
+#include "sbgemm.h"
+#include "amx_common.h"
+
+#if defined(MLAS_TARGET_AMD64)
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 32
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 2 * TILE_M;  // max # rows the kernel processes at once
+    static constexpr size_t PackedK = TILE_K;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+static_assert(MLAS_SBGEMM_KERNEL_AMX::PackedN % TILE_N == 0, "B is packed in groups of TILE_N columns");
+static_assert(MLAS_SBGEMM_KERNEL_AMX::Strides.K % TILE_K == 0, "K slices must be made of whole tiles");
+
+bool MLASCALL
+MlasBf16AccelerationSupported()
+{
+    return GetMlasPlatform().SBGemmDispatch != nullptr;
+}
+
+//
+// The tile instructions are emitted as inline assembly that the compiler
+// cannot see through, so memory accessed by them is synchronized explicitly.
+//
+MLAS_FORCEINLINE
+void
+MlasAmxMemoryBarrier()
+{
+#if !defined(_WIN32)
+    __asm__ volatile("" ::: "memory");
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasSBGemmAmxTileConfig()
+{
+    static thread_local struct tileconfig_t tc = {0};
+    struct tileconfig_t current_tc = {0};
+    tile_storeconfig(&current_tc);
+    MlasAmxMemoryBarrier();
+
+    if (tc.palette_id == 0 || std::memcmp(&current_tc, &tc, sizeof(tileconfig_t)) != 0) {
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = TILE_M;
+            tc.colb[t] = 64;
+        }
+
+        MlasAmxMemoryBarrier();
+        tile_loadconfig(&tc);
+    }
+}
+
+/*
+    Rounds fp32 values to nearest even bf16. The bf16 value is returned in
+    the upper 16 bits of each 32-bit lane.
+*/
+MLAS_FORCEINLINE
+__m512i
+MlasSBGemmRoundToBf16(__m512 Value)
+{
+    const __m512i Bits = _mm512_castps_si512(Value);
+    const __m512i Lsb = _mm512_and_si512(_mm512_srli_epi32(Bits, 16), _mm512_set1_epi32(1));
+    const __m512i Rounded = _mm512_add_epi32(Bits, _mm512_add_epi32(Lsb, _mm512_set1_epi32(0x7FFF)));
+
+    // keep NaNs NaN instead of rounding them to infinity
+    const __mmask16 IsNan = _mm512_cmp_ps_mask(Value, Value, _CMP_UNORD_Q);
+    return _mm512_mask_mov_epi32(Rounded, IsNan, _mm512_or_si512(Bits, _mm512_set1_epi32(0x00400000)));
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmAmxMask(size_t Count)
+{
+    return Count >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << Count) - 1);
+}
+
+/*
+    This routine converts fp32 to bf16 and copies elements from the source
+    matrix to the destination packed buffer.
+
+    Columns are packed in groups of TILE_N. Within a group, each TILE_K rows
+    form one tile of TILE_K/2 rows, whose row r holds the pairs
+    (B[2r][n], B[2r+1][n]) of the columns n of the group. The remaining rows
+    and columns are padded with zeros.
+*/
+static void
+MlasSBGemmConvertCopyPackB(bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    const size_t AlignedK = (CountK + TILE_K - 1) & ~size_t(TILE_K - 1);
+
+    for (size_t n = 0; n < CountN; n += TILE_N) {
+        const __mmask16 MaskN = MlasSBGemmAmxMask(CountN - n);
+
+        for (size_t k = 0; k < AlignedK; k += 2) {
+            __m512 Row0 = _mm512_setzero_ps();
+            __m512 Row1 = _mm512_setzero_ps();
+            if (k < CountK) {
+                Row0 = _mm512_maskz_loadu_ps(MaskN, B + k * ldb + n);
+            }
+            if (k + 1 < CountK) {
+                Row1 = _mm512_maskz_loadu_ps(MaskN, B + (k + 1) * ldb + n);
+            }
+
+            const __m512i Low = _mm512_srli_epi32(MlasSBGemmRoundToBf16(Row0), 16);
+            const __m512i High = _mm512_and_si512(MlasSBGemmRoundToBf16(Row1), _mm512_set1_epi32(int32_t(0xFFFF0000)));
+            _mm512_storeu_si512(D, _mm512_or_si512(Low, High));
+            D += 2 * TILE_N;
+        }
+    }
+}
+
+/*
+    This routine converts up to 2*TILE_M rows of A to bf16. Each row of the
+    destination holds AlignedK values, padded with zeros.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertA(bfloat16_t* D, size_t ldd, const float* A, size_t lda, size_t CountM, size_t CountK, size_t AlignedK)
+{
+    for (size_t m = 0; m < CountM; m++) {
+        for (size_t k = 0; k < AlignedK; k += 16) {
+            const __mmask16 MaskK = k < CountK ? MlasSBGemmAmxMask(CountK - k) : __mmask16(0);
+            const __m512 Row = _mm512_maskz_loadu_ps(MaskK, A + k);
+            const __m256i Converted = _mm512_cvtepi32_epi16(_mm512_srli_epi32(MlasSBGemmRoundToBf16(Row), 16));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(D + k), Converted);
+        }
+        A += lda;
+        D += ldd;
+    }
+}
+
+/**
+ * @brief Location of a 16x16 accumulator tile.
+ *
+ * Full tiles are loaded from and stored to C directly, partial tiles go
+ * through a local buffer.
+ */
+struct MLAS_SBGEMM_AMX_TILE {
+    float* C;
+    size_t ldc;
+    size_t CountM;
+    size_t CountN;
+    float* Buffer;
+
+    bool IsFull() const { return CountM == TILE_M && CountN == TILE_N; }
+
+    /**
+     * @brief Prepares the initial value of the tile, returns the address and stride to load it from.
+     * @param Init  Whether the tile starts from Bias (or zero) instead of C
+     */
+    const float* Prepare(bool Init, const float* Bias, size_t& Stride) const
+    {
+        if (!Init && IsFull()) {
+            Stride = ldc * sizeof(float);
+            return C;
+        }
+
+        const __mmask16 MaskN = MlasSBGemmAmxMask(CountN);
+        const __m512 BiasRow = (Bias != nullptr) ? _mm512_maskz_loadu_ps(MaskN, Bias) : _mm512_setzero_ps();
+        for (size_t m = 0; m < TILE_M; m++) {
+            __m512 Row = BiasRow;
+            if (!Init && m < CountM) {
+                Row = _mm512_maskz_loadu_ps(MaskN, C + m * ldc);
+            }
+            _mm512_storeu_ps(Buffer + m * TILE_N, Row);
+        }
+        Stride = TILE_N * sizeof(float);
+        return Buffer;
+    }
+
+    float* StoreAddress(size_t& Stride) const
+    {
+        if (IsFull()) {
+            Stride = ldc * sizeof(float);
+            return C;
+        }
+        Stride = TILE_N * sizeof(float);
+        return Buffer;
+    }
+
+    void Finish() const
+    {
+        if (IsFull()) {
+            return;
+        }
+        const __mmask16 MaskN = MlasSBGemmAmxMask(CountN);
+        for (size_t m = 0; m < CountM; m++) {
+            _mm512_mask_storeu_ps(C + m * ldc, MaskN, _mm512_loadu_ps(Buffer + m * TILE_N));
+        }
+    }
+};
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    const size_t AlignedN = (CountN + MLAS_SBGEMM_KERNEL_AMX::PackedN - 1) & ~(MLAS_SBGEMM_KERNEL_AMX::PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+    size_t K_block_size;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackB(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB += AlignedN * K_block_size;
+    }
+}
+
+template <>
+void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(
+    const size_t CountM,
+    const size_t CountN,
+    const size_t CountK,
+    const float* A,
+    const size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const bool ZeroMode
+)
+{
+    constexpr size_t StrideK = MLAS_SBGEMM_KERNEL_AMX::Strides.K;
+    constexpr size_t RowsPerBlock = MLAS_SBGEMM_KERNEL_AMX::KernelMaxM;
+
+    MLAS_DECLSPEC_ALIGN(bfloat16_t PanelA[RowsPerBlock * StrideK], 64);
+    MLAS_DECLSPEC_ALIGN(float TileBuffer[4][TILE_M * TILE_N], 64);
+
+    MlasSBGemmAmxTileConfig();
+
+    // B is packed in slices of StrideK rows, see MlasSBGemmConvertPackB
+    const size_t AlignedN = (CountN + TILE_N - 1) & ~size_t(TILE_N - 1);
+
+    for (size_t m = 0; m < CountM; m += RowsPerBlock) {
+        const size_t RowsM = std::min(CountM - m, RowsPerBlock);
+        const bool TwoRowTiles = RowsM > TILE_M;
+
+        for (size_t k = 0; k < CountK; k += StrideK) {
+            const size_t SliceK = std::min(CountK - k, StrideK);
+            const size_t AlignedK = (SliceK + TILE_K - 1) & ~size_t(TILE_K - 1);
+
+            MlasSBGemmConvertA(PanelA, StrideK, A + m * lda + k, lda, RowsM, SliceK, AlignedK);
+            if (RowsM < RowsPerBlock && RowsM != TILE_M) {
+                // rows of a partial tile are still loaded, their results are discarded
+                std::fill_n(PanelA + RowsM * StrideK, (RowsPerBlock - RowsM) * StrideK, bfloat16_t(0));
+            }
+
+            const bfloat16_t* SliceB = B + AlignedN * k;
+            const bool Init = ZeroMode && k == 0;
+
+            for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+                const size_t ColsN = std::min(CountN - n, size_t(2 * TILE_N));
+                const bool TwoColTiles = ColsN > TILE_N;
+
+                const bfloat16_t* b0 = SliceB + n * AlignedK;
+                const bfloat16_t* b1 = b0 + TILE_N * AlignedK;
+                float* c = C + m * ldc + n;
+                const float* bias = Bias != nullptr ? Bias + n : nullptr;
+
+                //
+                // Tiles 0 - 3 accumulate a 32x32 block of C, tiles 4, 5 hold
+                // 32 rows of A and tiles 6, 7 hold 32 columns of B:
+                //        B T6  B T7
+                //  A T4    T0    T1
+                //  A T5    T2    T3
+                //
+                const MLAS_SBGEMM_AMX_TILE Tile0{c, ldc, std::min(RowsM, size_t(TILE_M)), std::min(ColsN, size_t(TILE_N)), TileBuffer[0]};
+                const MLAS_SBGEMM_AMX_TILE Tile1{c + TILE_N, ldc, Tile0.CountM, ColsN - Tile0.CountN, TileBuffer[1]};
+                const MLAS_SBGEMM_AMX_TILE Tile2{c + TILE_M * ldc, ldc, RowsM - Tile0.CountM, Tile0.CountN, TileBuffer[2]};
+                const MLAS_SBGEMM_AMX_TILE Tile3{c + TILE_M * ldc + TILE_N, ldc, Tile2.CountM, Tile1.CountN, TileBuffer[3]};
+
+                size_t Stride;
+                const float* Source = Tile0.Prepare(Init, bias, Stride);
+                MlasAmxMemoryBarrier();
+                tile_loadd(TMM0, Source, Stride);
+                if (TwoColTiles) {
+                    Source = Tile1.Prepare(Init, bias != nullptr ? bias + TILE_N : nullptr, Stride);
+                    MlasAmxMemoryBarrier();
+                    tile_loadd(TMM1, Source, Stride);
+                }
+                if (TwoRowTiles) {
+                    Source = Tile2.Prepare(Init, bias, Stride);
+                    MlasAmxMemoryBarrier();
+                    tile_loadd(TMM2, Source, Stride);
+                    if (TwoColTiles) {
+                        Source = Tile3.Prepare(Init, bias != nullptr ? bias + TILE_N : nullptr, Stride);
+                        MlasAmxMemoryBarrier();
+                        tile_loadd(TMM3, Source, Stride);
+                    }
+                }
+
+                for (size_t kk = 0; kk < AlignedK; kk += TILE_K) {
+                    tile_loadd(TMM4, PanelA + kk, StrideK * sizeof(bfloat16_t));
+                    tile_loadd(TMM6, b0 + kk * TILE_N, 2 * TILE_N * sizeof(bfloat16_t));
+                    tile_dpbf16ps(TMM0, TMM4, TMM6);
+                    if (TwoColTiles) {
+                        tile_loadd(TMM7, b1 + kk * TILE_N, 2 * TILE_N * sizeof(bfloat16_t));
+                        tile_dpbf16ps(TMM1, TMM4, TMM7);
+                    }
+                    if (TwoRowTiles) {
+                        tile_loadd(TMM5, PanelA + TILE_M * StrideK + kk, StrideK * sizeof(bfloat16_t));
+                        tile_dpbf16ps(TMM2, TMM5, TMM6);
+                        if (TwoColTiles) {
+                            tile_dpbf16ps(TMM3, TMM5, TMM7);
+                        }
+                    }
+                }
+
+                float* Destination = Tile0.StoreAddress(Stride);
+                tile_stored(TMM0, Destination, Stride);
+                if (TwoColTiles) {
+                    Destination = Tile1.StoreAddress(Stride);
+                    tile_stored(TMM1, Destination, Stride);
+                }
+                if (TwoRowTiles) {
+                    Destination = Tile2.StoreAddress(Stride);
+                    tile_stored(TMM2, Destination, Stride);
+                    if (TwoColTiles) {
+                        Destination = Tile3.StoreAddress(Stride);
+                        tile_stored(TMM3, Destination, Stride);
+                    }
+                }
+                MlasAmxMemoryBarrier();
+
+                Tile0.Finish();
+                if (TwoColTiles) {
+                    Tile1.Finish();
+                }
+                if (TwoRowTiles) {
+                    Tile2.Finish();
+                    if (TwoColTiles) {
+                        Tile3.Finish();
+                    }
+                }
+            }
+        }
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0  // kernel never reads beyond the packed buffer
+};
+#endif  // defined(MLAS_TARGET_AMD64)
@@ -0,0 +1,842 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sconv_winograd.cpp
+
+Abstract:
+
+    This module implements the single precision Winograd minimal filtering
+    algorithm F(m x m, 3 x 3) for 3x3 stride 1 convolutions.
+
+    The filter is transformed to Alpha x Alpha matrices U (Alpha = m + 2),
+    each input tile to Alpha x Alpha matrices V, the Alpha * Alpha element
+    wise products are summed over the input channels by one GEMM per element
+    and the result is transformed back to an m x m output tile. The output
+    tiles are processed in blocks so the transformed tiles of a block stay in
+    the cache between the transforms and the GEMMs.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of floats of the per thread working buffer that bounds
+// the number of tiles processed per block.
+//
+
+constexpr size_t MLAS_CONV_WINOGRAD_BLOCK_BUFFER_SIZE = 128 * 1024;
+
+constexpr size_t MLAS_CONV_WINOGRAD_MINIMUM_TILES_PER_BLOCK = 8;
+
+constexpr size_t MLAS_CONV_WINOGRAD_MAXIMUM_TILES_PER_BLOCK = 64;
+
+//
+// Define the minimum number of input channels and filters that amortize the
+// transforms. Narrower convolutions are dominated by the transforms and use
+// the GEMM based algorithms.
+//
+
+constexpr size_t MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS = 16;
+
+//
+// Define the transform matrices of the supported output tiles. The
+// interpolation points are 0, +-1, +-2, +-1/2 and infinity.
+//
+
+template<size_t OutputTile>
+struct MLAS_CONV_WINOGRAD_TRANSFORM;
+
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<2> {
+    static constexpr size_t Alpha = 4;
+
+    static constexpr float BT[4][4] = {
+        {1.0f, 0.0f, -1.0f, 0.0f},
+        {0.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, -1.0f},
+    };
+
+    static constexpr float G[4][3] = {
+        {1.0f, 0.0f, 0.0f},
+        {0.5f, 0.5f, 0.5f},
+        {0.5f, -0.5f, 0.5f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    static constexpr float AT[2][4] = {
+        {1.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, -1.0f},
+    };
+};
+
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<4> {
+    static constexpr size_t Alpha = 6;
+
+    static constexpr float BT[6][6] = {
+        {4.0f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, -4.0f, -4.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, 4.0f, -4.0f, -1.0f, 1.0f, 0.0f},
+        {0.0f, -2.0f, -1.0f, 2.0f, 1.0f, 0.0f},
+        {0.0f, 2.0f, -1.0f, -2.0f, 1.0f, 0.0f},
+        {0.0f, 4.0f, 0.0f, -5.0f, 0.0f, 1.0f},
+    };
+
+    static constexpr float G[6][3] = {
+        {1.0f / 4.0f, 0.0f, 0.0f},
+        {-1.0f / 6.0f, -1.0f / 6.0f, -1.0f / 6.0f},
+        {-1.0f / 6.0f, 1.0f / 6.0f, -1.0f / 6.0f},
+        {1.0f / 24.0f, 1.0f / 12.0f, 1.0f / 6.0f},
+        {1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 6.0f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    static constexpr float AT[4][6] = {
+        {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f},
+        {0.0f, 1.0f, 1.0f, 4.0f, 4.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f},
+    };
+};
+
+template<>
+struct MLAS_CONV_WINOGRAD_TRANSFORM<6> {
+    static constexpr size_t Alpha = 8;
+
+    static constexpr float BT[8][8] = {
+        {1.0f, 0.0f, -21.0f / 4.0f, 0.0f, 21.0f / 4.0f, 0.0f, -1.0f, 0.0f},
+        {0.0f, 1.0f, 1.0f, -17.0f / 4.0f, -17.0f / 4.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 1.0f, 17.0f / 4.0f, -17.0f / 4.0f, -1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f / 2.0f, 1.0f / 4.0f, -5.0f / 2.0f, -5.0f / 4.0f, 2.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f / 2.0f, 1.0f / 4.0f, 5.0f / 2.0f, -5.0f / 4.0f, -2.0f, 1.0f, 0.0f},
+        {0.0f, 2.0f, 4.0f, -5.0f / 2.0f, -5.0f, 1.0f / 2.0f, 1.0f, 0.0f},
+        {0.0f, -2.0f, 4.0f, 5.0f / 2.0f, -5.0f, -1.0f / 2.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 0.0f, 21.0f / 4.0f, 0.0f, -21.0f / 4.0f, 0.0f, 1.0f},
+    };
+
+    static constexpr float G[8][3] = {
+        {1.0f, 0.0f, 0.0f},
+        {-2.0f / 9.0f, -2.0f / 9.0f, -2.0f / 9.0f},
+        {-2.0f / 9.0f, 2.0f / 9.0f, -2.0f / 9.0f},
+        {1.0f / 90.0f, 1.0f / 45.0f, 2.0f / 45.0f},
+        {1.0f / 90.0f, -1.0f / 45.0f, 2.0f / 45.0f},
+        {32.0f / 45.0f, 16.0f / 45.0f, 8.0f / 45.0f},
+        {32.0f / 45.0f, -16.0f / 45.0f, 8.0f / 45.0f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    static constexpr float AT[6][8] = {
+        {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 1.0f / 2.0f, -1.0f / 2.0f, 0.0f},
+        {0.0f, 1.0f, 1.0f, 4.0f, 4.0f, 1.0f / 4.0f, 1.0f / 4.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f / 8.0f, -1.0f / 8.0f, 0.0f},
+        {0.0f, 1.0f, 1.0f, 16.0f, 16.0f, 1.0f / 16.0f, 1.0f / 16.0f, 0.0f},
+        {0.0f, 1.0f, -1.0f, 32.0f, -32.0f, 1.0f / 32.0f, -1.0f / 32.0f, 1.0f},
+    };
+};
+
+//
+// Define the parameters to execute blocks of tiles of a Winograd convolution
+// on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* PackedFilter;
+    float* WorkingBuffer;
+    float* Output;
+    ptrdiff_t ThreadCount;
+};
+
+template<size_t OutputTile>
+void
+MlasConvWinogradPackFilterTile(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine computes U = G g G^T for each filter and input channel and
+    stores the element (i, j) of every U as a FilterCount x InputChannels
+    matrix, which is the A operand of the GEMM for that element.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor.
+
+    PackedFilter - Supplies the buffer that receives the transformed filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_CONV_WINOGRAD_TRANSFORM<OutputTile>;
+    constexpr size_t Alpha = Transform::Alpha;
+
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* filter = Filter + ((g * FilterCount + f) * InputChannels + c) * 9;
+
+                float Temp[Alpha][3];
+
+                for (size_t i = 0; i < Alpha; i++) {
+                    for (size_t s = 0; s < 3; s++) {
+                        Temp[i][s] = Transform::G[i][0] * filter[0 * 3 + s] +
+                                     Transform::G[i][1] * filter[1 * 3 + s] +
+                                     Transform::G[i][2] * filter[2 * 3 + s];
+                    }
+                }
+
+                float* packed = PackedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < Alpha; i++) {
+                    for (size_t j = 0; j < Alpha; j++) {
+                        packed[(i * Alpha + j) * MatrixSize] = Temp[i][0] * Transform::G[j][0] +
+                                                               Temp[i][1] * Transform::G[j][1] +
+                                                               Temp[i][2] * Transform::G[j][2];
+                    }
+                }
+            }
+        }
+
+        PackedFilter += Alpha * Alpha * MatrixSize;
+    }
+}
+
+template<size_t OutputTile>
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    float* TransformedInput,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes V = B^T d B for each input tile d of the block and
+    input channel and stores the element (i, j) of every V as an
+    InputChannels x TilesPerBlock matrix, which is the B operand of the GEMM
+    for that element.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    TransformedInput - Supplies the buffer that receives the transformed
+        input tiles.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_CONV_WINOGRAD_TRANSFORM<OutputTile>;
+    constexpr size_t Alpha = Transform::Alpha;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountW = Parameters->u.Winograd.TileCountW;
+    const size_t TilesPerBlock = Parameters->u.Winograd.TilesPerBlock;
+    const size_t MatrixSize = InputChannels * TilesPerBlock;
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t TileIndex = TileStart + t;
+        const size_t ih0 = (TileIndex / TileCountW) * OutputTile - PaddingTop;
+        const size_t iw0 = (TileIndex % TileCountW) * OutputTile - PaddingLeft;
+
+        //
+        // Tiles that are fully inside of the input tensor are read directly,
+        // else the padding and the elements past the edges read as zeros.
+        //
+
+        const bool Interior = (ih0 + Alpha <= InputHeight && ih0 < InputHeight) &&
+                              (iw0 + Alpha <= InputWidth && iw0 < InputWidth);
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* input = Input + c * InputSize;
+
+            float d[Alpha][Alpha];
+
+            for (size_t i = 0; i < Alpha; i++) {
+
+                const size_t ih = ih0 + i;
+
+                for (size_t j = 0; j < Alpha; j++) {
+
+                    const size_t iw = iw0 + j;
+
+                    if (Interior || (ih < InputHeight && iw < InputWidth)) {
+                        d[i][j] = input[ih * InputWidth + iw];
+                    } else {
+                        d[i][j] = 0.0f;
+                    }
+                }
+            }
+
+            float Temp[Alpha][Alpha];
+
+            for (size_t i = 0; i < Alpha; i++) {
+                for (size_t j = 0; j < Alpha; j++) {
+                    float Sum = 0.0f;
+                    for (size_t k = 0; k < Alpha; k++) {
+                        Sum += Transform::BT[i][k] * d[k][j];
+                    }
+                    Temp[i][j] = Sum;
+                }
+            }
+
+            float* transformed = TransformedInput + c * TilesPerBlock + t;
+
+            for (size_t i = 0; i < Alpha; i++) {
+                for (size_t j = 0; j < Alpha; j++) {
+                    float Sum = 0.0f;
+                    for (size_t k = 0; k < Alpha; k++) {
+                        Sum += Temp[i][k] * Transform::BT[j][k];
+                    }
+                    transformed[(i * Alpha + j) * MatrixSize] = Sum;
+                }
+            }
+        }
+    }
+}
+
+template<size_t OutputTile>
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* TransformedOutput,
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Y = A^T M A for each tile of the block and filter
+    and stores the part of Y that is inside of the output tensor.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    TransformedOutput - Supplies the GEMM results of the block.
+
+    Output - Supplies the output tensor of the batch and group.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Transform = MLAS_CONV_WINOGRAD_TRANSFORM<OutputTile>;
+    constexpr size_t Alpha = Transform::Alpha;
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileCountW = Parameters->u.Winograd.TileCountW;
+    const size_t TilesPerBlock = Parameters->u.Winograd.TilesPerBlock;
+    const size_t MatrixSize = FilterCount * TilesPerBlock;
+    const float Beta = Parameters->Beta;
+
+    for (size_t t = 0; t < TileCount; t++) {
+
+        const size_t TileIndex = TileStart + t;
+        const size_t oh0 = (TileIndex / TileCountW) * OutputTile;
+        const size_t ow0 = (TileIndex % TileCountW) * OutputTile;
+        const size_t CountH = std::min(OutputTile, OutputHeight - oh0);
+        const size_t CountW = std::min(OutputTile, OutputWidth - ow0);
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* transformed = TransformedOutput + f * TilesPerBlock + t;
+
+            float m[Alpha][Alpha];
+
+            for (size_t i = 0; i < Alpha; i++) {
+                for (size_t j = 0; j < Alpha; j++) {
+                    m[i][j] = transformed[(i * Alpha + j) * MatrixSize];
+                }
+            }
+
+            float Temp[OutputTile][Alpha];
+
+            for (size_t i = 0; i < OutputTile; i++) {
+                for (size_t j = 0; j < Alpha; j++) {
+                    float Sum = 0.0f;
+                    for (size_t k = 0; k < Alpha; k++) {
+                        Sum += Transform::AT[i][k] * m[k][j];
+                    }
+                    Temp[i][j] = Sum;
+                }
+            }
+
+            float* output = Output + f * OutputSize + oh0 * OutputWidth + ow0;
+
+            for (size_t i = 0; i < CountH; i++) {
+                for (size_t j = 0; j < CountW; j++) {
+                    float Sum = 0.0f;
+                    for (size_t k = 0; k < Alpha; k++) {
+                        Sum += Temp[i][k] * Transform::AT[j][k];
+                    }
+                    if (Beta != 0.0f) {
+                        Sum += Beta * output[i * OutputWidth + j];
+                    }
+                    output[i * OutputWidth + j] = Sum;
+                }
+            }
+        }
+    }
+}
+
+template<size_t OutputTile>
+void
+MlasConvWinogradOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    float* WorkingBuffer,
+    float* Output,
+    size_t TileStart,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine executes the Winograd convolution for a range of tiles of
+    one batch and group.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    PackedFilter - Supplies the transformed filter of the group.
+
+    WorkingBuffer - Supplies the thread local slice of the working buffer.
+
+    Output - Supplies the output tensor of the batch and group.
+
+    TileStart - Supplies the index of the first tile.
+
+    TileCount - Supplies the number of tiles.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t Alpha = MLAS_CONV_WINOGRAD_TRANSFORM<OutputTile>::Alpha;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TilesPerBlock = Parameters->u.Winograd.TilesPerBlock;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + Alpha * Alpha * InputChannels * TilesPerBlock;
+
+    while (TileCount > 0) {
+
+        const size_t CountTiles = std::min(TileCount, TilesPerBlock);
+
+        MlasConvWinogradTransformInput<OutputTile>(Parameters, Input, TransformedInput,
+            TileStart, CountTiles);
+
+        //
+        // Multiply each element of the transformed filters by the element of
+        // the transformed tiles and sum over the input channels.
+        //
+
+        for (size_t xi = 0; xi < Alpha * Alpha; xi++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTiles,
+                InputChannels, 1.0f, PackedFilter + xi * FilterCount * InputChannels,
+                InputChannels, TransformedInput + xi * InputChannels * TilesPerBlock,
+                TilesPerBlock, 0.0f, TransformedOutput + xi * FilterCount * TilesPerBlock,
+                TilesPerBlock);
+        }
+
+        MlasConvWinogradTransformOutput<OutputTile>(Parameters, TransformedOutput, Output,
+            TileStart, CountTiles);
+
+        TileStart += CountTiles;
+        TileCount -= CountTiles;
+    }
+}
+
+template<size_t OutputTile>
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of
+    blocks of tiles of a Winograd convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    constexpr size_t Alpha = MLAS_CONV_WINOGRAD_TRANSFORM<OutputTile>::Alpha;
+
+    const size_t TilesPerBlock = Parameters->u.Winograd.TilesPerBlock;
+    const size_t TileCount = Parameters->u.Winograd.TileCountH * Parameters->u.Winograd.TileCountW;
+    const size_t BlockCount = MlasDivRoundup(TileCount, TilesPerBlock);
+
+    size_t BlockStart;
+    size_t BlockRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, BlockCount, &BlockStart, &BlockRemaining);
+
+    if (BlockRemaining == 0) {
+        return;
+    }
+
+    const size_t TileStart = BlockStart * TilesPerBlock;
+    const size_t TileEnd = std::min(TileCount, (BlockStart + BlockRemaining) * TilesPerBlock);
+
+    const size_t ThreadBufferSize = Alpha * Alpha *
+        (Parameters->InputChannels + Parameters->FilterCount) * TilesPerBlock;
+
+    MlasConvWinogradOperation<OutputTile>(Parameters, WorkBlock->Input, WorkBlock->PackedFilter,
+        WorkBlock->WorkingBuffer + Index * ThreadBufferSize, WorkBlock->Output, TileStart,
+        TileEnd - TileStart);
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd convolution for one batch and group.
+    The caller applies the bias and the activation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor of the batch and group.
+
+    PackedFilter - Supplies the filter of the group transformed by
+        MlasConvWinogradPackFilter.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor of the batch and group.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = PackedFilter;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.ThreadCount = Parameters->ThreadCount;
+
+    MLAS_THREADED_ROUTINE* ThreadedRoutine;
+
+    switch (Parameters->u.Winograd.OutputTile) {
+        case 2:
+            ThreadedRoutine = MlasConvWinogradThreaded<2>;
+            break;
+        case 4:
+            ThreadedRoutine = MlasConvWinogradThreaded<4>;
+            break;
+        case 6:
+            ThreadedRoutine = MlasConvWinogradThreaded<6>;
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas winograd output tile");
+    }
+
+    MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, WorkBlock.ThreadCount, ThreadPool);
+}
+
+bool
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether the Winograd algorithm applies to the
+    convolution and if so, computes its parameters and working buffer size.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WinogradTile - Supplies the output tile permitted by the accuracy
+        tolerance of the caller.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the convolution uses the Winograd algorithm, else false.
+
+--*/
+{
+    const size_t OutputTile = size_t(WinogradTile);
+
+    if (OutputTile != 2 && OutputTile != 4 && OutputTile != 6) {
+        return false;
+    }
+
+    if (Parameters->Dimensions != 2 ||
+        Parameters->KernelShape[0] != 3 || Parameters->KernelShape[1] != 3 ||
+        Parameters->StrideShape[0] != 1 || Parameters->StrideShape[1] != 1 ||
+        Parameters->DilationShape[0] != 1 || Parameters->DilationShape[1] != 1) {
+        return false;
+    }
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return false;
+    }
+
+    //
+    // Outputs smaller than a tile waste most of the transformed elements.
+    //
+
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+
+    if (OutputHeight < OutputTile || OutputWidth < OutputTile) {
+        return false;
+    }
+
+    const size_t Alpha = OutputTile + 2;
+    const size_t TileCountH = MlasDivRoundup(OutputHeight, OutputTile);
+    const size_t TileCountW = MlasDivRoundup(OutputWidth, OutputTile);
+    const size_t TileCount = TileCountH * TileCountW;
+
+    //
+    // Size the block of tiles so that the transformed tiles of a block fit in
+    // the per thread working buffer.
+    //
+
+    size_t TilesPerBlock = MLAS_CONV_WINOGRAD_BLOCK_BUFFER_SIZE /
+        (Alpha * Alpha * (InputChannels + FilterCount));
+
+    TilesPerBlock = std::max(TilesPerBlock, MLAS_CONV_WINOGRAD_MINIMUM_TILES_PER_BLOCK);
+    TilesPerBlock = std::min(TilesPerBlock, MLAS_CONV_WINOGRAD_MAXIMUM_TILES_PER_BLOCK);
+    TilesPerBlock = std::min(TilesPerBlock, TileCount);
+
+    const size_t BlockCount = MlasDivRoundup(TileCount, TilesPerBlock);
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = ThreadCount;
+    Parameters->u.Winograd.OutputTile = OutputTile;
+    Parameters->u.Winograd.TileCountH = TileCountH;
+    Parameters->u.Winograd.TileCountW = TileCountW;
+    Parameters->u.Winograd.TilesPerBlock = TilesPerBlock;
+
+    *WorkingBufferSize = size_t(ThreadCount) * Alpha * Alpha * (InputChannels + FilterCount) * TilesPerBlock;
+
+    return true;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of floats of a filter transformed by
+    MlasConvWinogradPackFilter.
+
+Arguments:
+
+    WinogradTile - Supplies the output tile passed to MlasConvPrepare.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of floats of the transformed filter, else zero if the
+    output tile is not supported.
+
+--*/
+{
+    const size_t OutputTile = size_t(WinogradTile);
+
+    if (OutputTile != 2 && OutputTile != 4 && OutputTile != 6) {
+        return 0;
+    }
+
+    const size_t Alpha = OutputTile + 2;
+
+    return GroupCount * Alpha * Alpha * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    MLAS_CONV_WINOGRAD_TILE WinogradTile,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter for the Winograd convolution
+    algorithm.
+
+Arguments:
+
+    WinogradTile - Supplies the output tile passed to MlasConvPrepare.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor.
+
+    PackedFilter - Supplies the buffer that receives the transformed filter
+        sized by MlasConvWinogradPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (WinogradTile) {
+        case MlasConvWinogradF2x2:
+            MlasConvWinogradPackFilterTile<2>(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+            break;
+        case MlasConvWinogradF4x4:
+            MlasConvWinogradPackFilterTile<4>(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+            break;
+        case MlasConvWinogradF6x6:
+            MlasConvWinogradPackFilterTile<6>(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas winograd output tile");
+    }
+}
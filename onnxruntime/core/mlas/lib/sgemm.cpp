@@ -26,6 +26,13 @@ Abstract:
 
 #define MLAS_SGEMM_TRANSA_ROWS              12
 
+//
+// Define the largest dimension of the matrices of a batched SGEMM operation
+// that is partitioned by matrix instead of by rows or columns of a matrix.
+//
+
+#define MLAS_SGEMM_SMALL_BATCH_MAXIMUM_DIMENSION    64
+
 //
 // Define the parameters to execute segments of a SGEMM operation on worker
 // threads.
@@ -1003,6 +1010,96 @@ Return Value:
 
 #endif
 
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue operations to a tile of the output
+    matrix that has been fully accumulated.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue operations. The bias and residual
+        addresses are relative to the origin of the output matrix.
+
+    C - Supplies the address of the tile of matrix C.
+
+    StartM - Supplies the row of the tile in the output matrix.
+
+    StartN - Supplies the column of the tile in the output matrix.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Epilogue->Bias != nullptr) {
+
+        const float* Bias = Epilogue->Bias + StartN;
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= CountN; n += 4) {
+                MlasStoreFloat32x4(c + n, MlasAddFloat32x4(MlasLoadFloat32x4(c + n), MlasLoadFloat32x4(Bias + n)));
+            }
+
+            for (; n < CountN; n++) {
+                c[n] += Bias[n];
+            }
+
+            c += ldc;
+        }
+    }
+
+    if (Epilogue->Activation != nullptr &&
+        Epilogue->Activation->ActivationKind != MlasIdentityActivation) {
+        MlasActivation(Epilogue->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+
+    if (Epilogue->Residual != nullptr) {
+
+        const size_t ldr = Epilogue->ldr;
+        const float* r = Epilogue->Residual + StartM * ldr + StartN;
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= CountN; n += 4) {
+                MlasStoreFloat32x4(c + n, MlasAddFloat32x4(MlasLoadFloat32x4(c + n), MlasLoadFloat32x4(r + n)));
+            }
+
+            for (; n < CountN; n++) {
+                c[n] += r[n];
+            }
+
+            c += ldc;
+            r += ldr;
+        }
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1112,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0
     )
 /*++
 
@@ -1051,6 +1151,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Optionally supplies the epilogue operations to apply to each
+        block of rows after the kernel has produced it. Only supplied for the
+        last slice along the K dimension.
+
+    StartM - Supplies the row of matrix C in the output matrix.
+
+    StartN - Supplies the column of matrix C in the output matrix.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1063,6 +1171,12 @@ Return Value:
 
 #if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)
         RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+#elif defined(MLAS_TARGET_ARM64)
+        if (ZeroMode) {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        } else {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelAdd(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        }
 #else
         if (ZeroMode) {
             RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
@@ -1071,6 +1185,11 @@ Return Value:
         }
 #endif
 
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, StartM, StartN, RowsHandled, CountN, ldc);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1212,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1131,6 +1251,10 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations to apply to the output
+        matrix once it has been computed. The bias and residual addresses are
+        relative to the origin of matrix C.
+
 Return Value:
 
     None.
@@ -1147,6 +1271,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+        }
         return;
     }
 
@@ -1170,6 +1297,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -1177,6 +1307,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -1205,6 +1338,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -1267,6 +1403,8 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1285,7 +1423,7 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode, SliceEpilogue, 0, n);
 
             } else {
 
@@ -1299,6 +1437,7 @@ Return Value:
                     //
 
                     size_t RowsTransposed = std::min(RowsRemaining, size_t(MLAS_SGEMM_TRANSA_ROWS));
+                    const size_t StartM = M - RowsRemaining;
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
@@ -1309,7 +1448,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, StartM, n);
                 }
             }
 
@@ -1332,7 +1472,8 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1372,6 +1513,10 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the operations to apply to the output
+        matrix once it has been computed. The bias and residual addresses are
+        relative to the origin of matrix C.
+
 Return Value:
 
     None.
@@ -1380,6 +1525,19 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    //
+    // Handle the special case of K equals zero. Apply the beta multiplier to
+    // the output matrix and exit.
+    //
+
+    if (K == 0) {
+        MlasSgemmMultiplyBeta(C, M, RangeCountN, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, RangeCountN, ldc);
+        }
+        return;
+    }
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
@@ -1411,6 +1569,8 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1420,7 +1580,7 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode, SliceEpilogue, 0, n);
 
             } else {
 
@@ -1434,6 +1594,7 @@ Return Value:
                     //
 
                     size_t RowsTransposed = std::min(RowsRemaining, size_t(MLAS_SGEMM_TRANSA_ROWS));
+                    const size_t StartM = M - RowsRemaining;
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
@@ -1444,7 +1605,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, StartM, n);
                 }
             }
 
@@ -1453,6 +1615,226 @@ Return Value:
     }
 }
 
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSmallKernel(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t N,
+    size_t K,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of the product of matrix A and an
+    unpacked, untransposed matrix B. Each block of eight columns is accumulated
+    in registers by broadcasting the elements of A and loading the rows of B in
+    place.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 AlphaBroadcast = MlasBroadcastFloat32x4(alpha);
+    const MLAS_FLOAT32X4 BetaBroadcast = MlasBroadcastFloat32x4(beta);
+
+    auto StoreOutput = [&](float* c, MLAS_FLOAT32X4 Accumulator) {
+        MLAS_FLOAT32X4 Output = MlasMultiplyFloat32x4(Accumulator, AlphaBroadcast);
+        if (beta != 0.0f) {
+            Output = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(c), BetaBroadcast, Output);
+        }
+        MlasStoreFloat32x4(c, Output);
+    };
+
+    size_t n = 0;
+
+    for (; n + 8 <= N; n += 8) {
+
+        MLAS_FLOAT32X4 Accumulators[RowCount][2];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r][0] = MlasZeroFloat32x4();
+            Accumulators[r][1] = MlasZeroFloat32x4();
+        }
+
+        const float* b = B + n;
+
+        for (size_t k = 0; k < K; k++) {
+
+            const MLAS_FLOAT32X4 BElements0 = MlasLoadFloat32x4(b);
+            const MLAS_FLOAT32X4 BElements1 = MlasLoadFloat32x4(b + 4);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const MLAS_FLOAT32X4 AElement = MlasBroadcastFloat32x4(A[r * lda + k]);
+                Accumulators[r][0] = MlasMultiplyAddFloat32x4(BElements0, AElement, Accumulators[r][0]);
+                Accumulators[r][1] = MlasMultiplyAddFloat32x4(BElements1, AElement, Accumulators[r][1]);
+            }
+
+            b += ldb;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            StoreOutput(C + r * ldc + n, Accumulators[r][0]);
+            StoreOutput(C + r * ldc + n + 4, Accumulators[r][1]);
+        }
+    }
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = MlasZeroFloat32x4();
+        }
+
+        const float* b = B + n;
+
+        for (size_t k = 0; k < K; k++) {
+
+            const MLAS_FLOAT32X4 BElements = MlasLoadFloat32x4(b);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r] = MlasMultiplyAddFloat32x4(BElements, A[r * lda + k], Accumulators[r]);
+            }
+
+            b += ldb;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            StoreOutput(C + r * ldc + n, Accumulators[r]);
+        }
+    }
+
+    for (; n < N; n++) {
+
+        float Accumulators[RowCount] = {};
+
+        const float* b = B + n;
+
+        for (size_t k = 0; k < K; k++) {
+
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r] += A[r * lda + k] * b[0];
+            }
+
+            b += ldb;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            float* c = C + r * ldc + n;
+            *c = (beta != 0.0f) ? alpha * Accumulators[r] + beta * *c : alpha * Accumulators[r];
+        }
+    }
+}
+
+void
+MlasSgemmSmallOperation(
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* DataParams
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation for a small matrix of a batch with untransposed and unpacked
+    matrices A and B.
+
+    Matrices narrower than a column panel of the platform kernels are
+    multiplied with matrix B read in place: packing would pad every row of
+    matrix B to the width of the panel while the wide kernels mostly run with
+    masked stores. Other matrices use the generic single threaded path.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    DataParams - Supplies the data position and layout of the matrices.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* A = DataParams->A;
+    const float* B = DataParams->B;
+    float* C = DataParams->C;
+    const size_t lda = DataParams->lda;
+    const size_t ldb = DataParams->ldb;
+    const size_t ldc = DataParams->ldc;
+    const float alpha = DataParams->alpha;
+    const float beta = DataParams->beta;
+
+    if (N >= MLAS_SGEMM_STRIDEN_THREAD_ALIGN || K == 0) {
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc,
+            DataParams->Epilogue);
+        return;
+    }
+
+    size_t m = 0;
+
+    for (; m + 4 <= M; m += 4) {
+        MlasSgemmSmallKernel<4>(A + m * lda, lda, B, ldb, C + m * ldc, ldc, N, K, alpha, beta);
+    }
+
+    switch (M - m) {
+        case 3:
+            MlasSgemmSmallKernel<3>(A + m * lda, lda, B, ldb, C + m * ldc, ldc, N, K, alpha, beta);
+            break;
+        case 2:
+            MlasSgemmSmallKernel<2>(A + m * lda, lda, B, ldb, C + m * ldc, ldc, N, K, alpha, beta);
+            break;
+        case 1:
+            MlasSgemmSmallKernel<1>(A + m * lda, lda, B, ldb, C + m * ldc, ldc, N, K, alpha, beta);
+            break;
+    }
+
+    if (DataParams->Epilogue != nullptr) {
+        MlasSgemmApplyEpilogue(DataParams->Epilogue, C, 0, 0, M, N, ldc);
+    }
+}
+
 void
 MlasSgemmThreaded(
     const ptrdiff_t ThreadCountM,
@@ -1536,11 +1918,48 @@ Return Value:
     const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
     float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
 
-    if (DataParams->BIsPacked) {
+    //
+    // Rebase the epilogue operands to the origin of the partition.
+    //
+
+    MLAS_SGEMM_EPILOGUE RangeEpilogue;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+
+    if (DataParams->Epilogue != nullptr) {
+
+        RangeEpilogue = *DataParams->Epilogue;
+
+        if (RangeEpilogue.Bias != nullptr) {
+            RangeEpilogue.Bias += RangeStartN;
+        }
+
+        if (RangeEpilogue.Residual != nullptr) {
+            RangeEpilogue.Residual += RangeStartM * RangeEpilogue.ldr + RangeStartN;
+        }
+
+        Epilogue = &RangeEpilogue;
+    }
+
+    //
+    // Use the kernel generated for the shape of the packed matrix B if one was
+    // supplied and the operation is a plain product.
+    //
+
+    if (DataParams->BIsPacked && DataParams->JitKernel != nullptr && TransA == CblasNoTrans &&
+        DataParams->alpha == 1.0f && DataParams->beta == 0.0f &&
+        MlasSgemmJitOperation(DataParams->JitKernel, RangeCountM, RangeStartN, RangeCountN, K, A, lda,
+            DataParams->B, C, ldc)) {
+
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, RangeCountM, RangeCountN, ldc);
+        }
+
+    } else if (DataParams->BIsPacked) {
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            Epilogue);
 
     } else {
 
@@ -1549,7 +1968,7 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc, Epilogue);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -1592,6 +2011,42 @@ MlasGemmBatch(
         TargetThreadCount = MaximumThreadCount;
     }
 
+    //
+    // Partition a batch of small matrices by matrix. Each thread multiplies a
+    // contiguous range of the batch, and the number of threads is based on the
+    // complexity of the whole batch instead of one matrix.
+    //
+
+    if (BatchSize > 1 && M <= MLAS_SGEMM_SMALL_BATCH_MAXIMUM_DIMENSION &&
+        N <= MLAS_SGEMM_SMALL_BATCH_MAXIMUM_DIMENSION && K <= MLAS_SGEMM_SMALL_BATCH_MAXIMUM_DIMENSION) {
+
+        const double BatchComplexity = Complexity * double(BatchSize);
+
+        ptrdiff_t BatchThreadCount = ptrdiff_t(BatchComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+        BatchThreadCount = std::min(BatchThreadCount, MaximumThreadCount);
+        BatchThreadCount = std::min(BatchThreadCount, ptrdiff_t(BatchSize));
+
+        MlasTrySimpleParallel(ThreadPool, BatchThreadCount, [=](ptrdiff_t tid) {
+
+            size_t GemmStart;
+            size_t GemmCount;
+
+            MlasPartitionWork(tid, BatchThreadCount, BatchSize, &GemmStart, &GemmCount);
+
+            for (size_t GemmIdx = GemmStart; GemmIdx < GemmStart + GemmCount; GemmIdx++) {
+
+                if (TransA == CblasNoTrans && TransB == CblasNoTrans && !Data[GemmIdx].BIsPacked) {
+                    MlasSgemmSmallOperation(M, N, K, &Data[GemmIdx]);
+                } else {
+                    MlasSgemmThreaded(1, 1, TransA, TransB, M, N, K, &Data[GemmIdx], 0);
+                }
+            }
+        });
+
+        return;
+    }
+
     //
     // Segment the operation across multiple threads.
     //
@@ -0,0 +1,892 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_jit.cpp
+
+Abstract:
+
+    This module implements the shape specialized single precision matrix/matrix
+    multiply kernels that are generated at runtime for a packed matrix B.
+
+    The packed layout of MlasGemmPackB is fixed once N and K are known, so the
+    generator bakes the number of K slices, the trip counts of the K loops, the
+    column block strides and the right edge mask into straight line AVX2/FMA3
+    code. Each generated kernel accumulates the full K dimension of a 6x16
+    tile in registers and writes the output tile exactly once.
+
+    Generated kernels are cached per (N, K) shape and shared by all users of the
+    same shape in the process.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#if defined(MLAS_TARGET_AMD64) && (defined(_WIN32) || defined(__linux__))
+#define MLAS_SGEMM_JIT_SUPPORTED
+#endif
+
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+//
+// Define the arguments passed to a generated kernel. The generated code reads
+// the fields at the offsets asserted below.
+//
+
+struct MLAS_SGEMM_JIT_ARGS {
+    const float* A;
+    const float* PackedB;
+    float* C;
+    size_t CountM;
+    size_t lda;                 // in bytes
+    size_t ldc;                 // in bytes
+    size_t BlockStart;          // first column block of 16 columns
+    size_t BlockCount;          // number of complete column blocks
+    size_t IncludeTail;         // non-zero to process the partial column block
+    const int32_t* TailMask;
+};
+
+static_assert(offsetof(MLAS_SGEMM_JIT_ARGS, A) == 0, "field offset used by generated code");
+static_assert(offsetof(MLAS_SGEMM_JIT_ARGS, CountM) == 24, "field offset used by generated code");
+static_assert(offsetof(MLAS_SGEMM_JIT_ARGS, TailMask) == 72, "field offset used by generated code");
+
+typedef void (MLAS_SGEMM_JIT_ROUTINE)(const MLAS_SGEMM_JIT_ARGS* Args);
+
+struct MLAS_SGEMM_JIT_KERNEL {
+    size_t N;
+    size_t K;
+    size_t ReferenceCount;
+    void* Code;
+    size_t CodeSize;
+    MLAS_SGEMM_JIT_ROUTINE* Routine;
+    int32_t TailMask[16];
+};
+
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+
+namespace {
+
+//
+// Minimal x86-64 assembler for the instructions used by the generated kernels.
+// All memory operands are encoded as [base + index * scale + disp32].
+//
+
+enum MLAS_JIT_GPR : uint8_t {
+    Rax = 0, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi, R8, R9, R10, R11, R12, R13, R14, R15,
+    NoIndex = 0xFF,
+};
+
+struct MLAS_JIT_MEM {
+    uint8_t Base;
+    uint8_t Index;
+    uint8_t Scale;
+    int32_t Displacement;
+};
+
+MLAS_JIT_MEM
+Mem(uint8_t Base, int32_t Displacement = 0)
+{
+    return {Base, NoIndex, 1, Displacement};
+}
+
+MLAS_JIT_MEM
+Mem(uint8_t Base, uint8_t Index, uint8_t Scale, int32_t Displacement = 0)
+{
+    return {Base, Index, Scale, Displacement};
+}
+
+class MLAS_JIT_ASSEMBLER {
+public:
+    std::vector<uint8_t> Code;
+
+    size_t Position() const { return Code.size(); }
+
+    void Byte(uint8_t b) { Code.push_back(b); }
+
+    void Dword(int32_t d)
+    {
+        for (int i = 0; i < 4; i++) {
+            Byte(uint8_t(uint32_t(d) >> (8 * i)));
+        }
+    }
+
+    static uint8_t IndexBits(const MLAS_JIT_MEM& m) { return m.Index == NoIndex ? 0 : m.Index; }
+
+    void ModRmMem(uint8_t Reg, const MLAS_JIT_MEM& m)
+    {
+        const uint8_t ScaleBits = (m.Scale == 8) ? 3 : (m.Scale == 4) ? 2 : (m.Scale == 2) ? 1 : 0;
+        const uint8_t Index = (m.Index == NoIndex) ? 4 : (m.Index & 7);
+        Byte(uint8_t(0x80 | ((Reg & 7) << 3) | 4));
+        Byte(uint8_t((ScaleBits << 6) | (Index << 3) | (m.Base & 7)));
+        Dword(m.Displacement);
+    }
+
+    void Rex(bool W, uint8_t Reg, uint8_t Index, uint8_t Base)
+    {
+        Byte(uint8_t(0x40 | (W ? 8 : 0) | ((Reg >> 3) << 2) | ((Index >> 3) << 1) | (Base >> 3)));
+    }
+
+    //
+    // General purpose register instructions (64-bit operand size).
+    //
+
+    void OpRegMem(uint8_t Opcode, uint8_t Reg, const MLAS_JIT_MEM& m)
+    {
+        Rex(true, Reg, IndexBits(m), m.Base);
+        Byte(Opcode);
+        ModRmMem(Reg, m);
+    }
+
+    void OpRegReg(uint8_t Opcode, uint8_t Reg, uint8_t Rm)
+    {
+        Rex(true, Reg, 0, Rm);
+        Byte(Opcode);
+        Byte(uint8_t(0xC0 | ((Reg & 7) << 3) | (Rm & 7)));
+    }
+
+    void Mov(uint8_t Dst, const MLAS_JIT_MEM& m) { OpRegMem(0x8B, Dst, m); }
+    void Mov(uint8_t Dst, uint8_t Src) { OpRegReg(0x8B, Dst, Src); }
+    void Lea(uint8_t Dst, const MLAS_JIT_MEM& m) { OpRegMem(0x8D, Dst, m); }
+    void Add(uint8_t Dst, uint8_t Src) { OpRegReg(0x03, Dst, Src); }
+    void Test(uint8_t Dst, uint8_t Src) { OpRegReg(0x85, Src, Dst); }
+
+    void Group1Imm(uint8_t Extension, uint8_t Dst, int32_t Imm)
+    {
+        Rex(true, 0, 0, Dst);
+        Byte(0x81);
+        Byte(uint8_t(0xC0 | (Extension << 3) | (Dst & 7)));
+        Dword(Imm);
+    }
+
+    void Add(uint8_t Dst, int32_t Imm) { Group1Imm(0, Dst, Imm); }
+    void Sub(uint8_t Dst, int32_t Imm) { Group1Imm(5, Dst, Imm); }
+    void Cmp(uint8_t Dst, int32_t Imm) { Group1Imm(7, Dst, Imm); }
+
+    void Imul(uint8_t Dst, uint8_t Src, int32_t Imm)
+    {
+        OpRegReg(0x69, Dst, Src);
+        Dword(Imm);
+    }
+
+    void MovImm(uint8_t Dst, int32_t Imm)
+    {
+        Rex(true, 0, 0, Dst);
+        Byte(0xC7);
+        Byte(uint8_t(0xC0 | (Dst & 7)));
+        Dword(Imm);
+    }
+
+    void MovImm(const MLAS_JIT_MEM& m, int32_t Imm)
+    {
+        OpRegMem(0xC7, 0, m);
+        Dword(Imm);
+    }
+
+    void Dec(uint8_t Dst)
+    {
+        Rex(true, 0, 0, Dst);
+        Byte(0xFF);
+        Byte(uint8_t(0xC8 | (Dst & 7)));
+    }
+
+    void Dec(const MLAS_JIT_MEM& m) { OpRegMem(0xFF, 1, m); }
+
+    void Push(uint8_t Reg)
+    {
+        if (Reg >= 8) {
+            Byte(0x41);
+        }
+        Byte(uint8_t(0x50 | (Reg & 7)));
+    }
+
+    void Pop(uint8_t Reg)
+    {
+        if (Reg >= 8) {
+            Byte(0x41);
+        }
+        Byte(uint8_t(0x58 | (Reg & 7)));
+    }
+
+    void Ret() { Byte(0xC3); }
+
+    //
+    // Branches use 32-bit displacements. Forward branches return the position
+    // of the displacement that is later patched by Bind.
+    //
+
+    enum MLAS_JIT_CONDITION : uint8_t {
+        Below = 0x82, AboveOrEqual = 0x83, Equal = 0x84, NotEqual = 0x85,
+    };
+
+    size_t Jcc(MLAS_JIT_CONDITION Condition, size_t Target = SIZE_MAX)
+    {
+        Byte(0x0F);
+        Byte(Condition);
+        return Displacement(Target);
+    }
+
+    size_t Jmp(size_t Target = SIZE_MAX)
+    {
+        Byte(0xE9);
+        return Displacement(Target);
+    }
+
+    size_t Displacement(size_t Target)
+    {
+        const size_t Patch = Position();
+        Dword(Target == SIZE_MAX ? 0 : int32_t(int64_t(Target) - int64_t(Patch + 4)));
+        return Patch;
+    }
+
+    void Bind(size_t Patch)
+    {
+        const int32_t Rel = int32_t(int64_t(Position()) - int64_t(Patch + 4));
+        std::memcpy(&Code[Patch], &Rel, sizeof(Rel));
+    }
+
+    //
+    // AVX instructions using the three byte VEX prefix.
+    //
+
+    enum MLAS_JIT_VEX_MAP : uint8_t { Map0F = 1, Map0F38 = 2 };
+    enum MLAS_JIT_VEX_PP : uint8_t { PpNone = 0, Pp66 = 1 };
+
+    void Vex(MLAS_JIT_VEX_MAP Map, MLAS_JIT_VEX_PP Pp, bool L256, uint8_t Reg, uint8_t Vvvv, uint8_t Index,
+             uint8_t Base)
+    {
+        Byte(0xC4);
+        Byte(uint8_t(((~Reg >> 3) & 1) << 7 | ((~Index >> 3) & 1) << 6 | ((~Base >> 3) & 1) << 5 | Map));
+        Byte(uint8_t(((~Vvvv & 15) << 3) | (L256 ? 4 : 0) | Pp));
+    }
+
+    void VexRegMem(uint8_t Opcode, MLAS_JIT_VEX_MAP Map, MLAS_JIT_VEX_PP Pp, bool L256, uint8_t Reg, uint8_t Vvvv,
+                   const MLAS_JIT_MEM& m)
+    {
+        Vex(Map, Pp, L256, Reg, Vvvv, IndexBits(m), m.Base);
+        Byte(Opcode);
+        ModRmMem(Reg, m);
+    }
+
+    void VexRegReg(uint8_t Opcode, MLAS_JIT_VEX_MAP Map, MLAS_JIT_VEX_PP Pp, uint8_t Reg, uint8_t Vvvv, uint8_t Rm)
+    {
+        Vex(Map, Pp, true, Reg, Vvvv, 0, Rm);
+        Byte(Opcode);
+        Byte(uint8_t(0xC0 | ((Reg & 7) << 3) | (Rm & 7)));
+    }
+
+    void Vxorps(uint8_t Dst) { VexRegReg(0x57, Map0F, PpNone, Dst, Dst, Dst); }
+    void Vmovups(uint8_t Dst, const MLAS_JIT_MEM& m) { VexRegMem(0x10, Map0F, PpNone, true, Dst, 0, m); }
+    void Vmovups(const MLAS_JIT_MEM& m, uint8_t Src) { VexRegMem(0x11, Map0F, PpNone, true, Src, 0, m); }
+    void VmovupsXmm(uint8_t Dst, const MLAS_JIT_MEM& m) { VexRegMem(0x10, Map0F, PpNone, false, Dst, 0, m); }
+    void VmovupsXmm(const MLAS_JIT_MEM& m, uint8_t Src) { VexRegMem(0x11, Map0F, PpNone, false, Src, 0, m); }
+    void Vbroadcastss(uint8_t Dst, const MLAS_JIT_MEM& m) { VexRegMem(0x18, Map0F38, Pp66, true, Dst, 0, m); }
+    void Vfmadd231ps(uint8_t Dst, uint8_t Src1, uint8_t Src2) { VexRegReg(0xB8, Map0F38, Pp66, Dst, Src1, Src2); }
+    void Vmaskmovps(const MLAS_JIT_MEM& m, uint8_t Mask, uint8_t Src)
+    {
+        VexRegMem(0x2E, Map0F38, Pp66, true, Src, Mask, m);
+    }
+
+    void Vzeroupper()
+    {
+        Byte(0xC5);
+        Byte(0xF8);
+        Byte(0x77);
+    }
+};
+
+//
+// Register assignment of the generated kernel.
+//
+
+constexpr uint8_t RegArgs = Rbx;
+constexpr uint8_t RegA = R8;
+constexpr uint8_t RegC = R9;
+constexpr uint8_t RegLda = R10;
+constexpr uint8_t RegLdc = R11;
+constexpr uint8_t RegCountM = R12;
+constexpr uint8_t RegPackedB = R13;
+constexpr uint8_t RegBlockFull = R14;
+constexpr uint8_t RegBlockLast = R15;
+constexpr uint8_t RegBlockCount = Rbp;
+constexpr uint8_t RegCColumn = Rsi;
+constexpr uint8_t RegB = Rdi;
+constexpr uint8_t RegARow0 = Rax;
+constexpr uint8_t RegARow3 = Rcx;
+constexpr uint8_t RegCountK = Rdx;
+
+constexpr int32_t MLAS_SGEMM_JIT_MAX_ROWS = 6;
+constexpr int32_t MLAS_SGEMM_JIT_UNROLLK = 4;
+constexpr int32_t MLAS_SGEMM_JIT_BLOCK_BYTES = 16 * sizeof(float);
+
+class MLAS_SGEMM_JIT_GENERATOR {
+public:
+    MLAS_SGEMM_JIT_GENERATOR(size_t N, size_t K) : N_(N), K_(K)
+    {
+        AlignedN_ = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+        SliceCount_ = (K + MLAS_SGEMM_PACKED_STRIDEK - 1) / MLAS_SGEMM_PACKED_STRIDEK;
+        LastCountK_ = K - (SliceCount_ - 1) * MLAS_SGEMM_PACKED_STRIDEK;
+        TailN_ = N % 16;
+    }
+
+    std::vector<uint8_t> Generate();
+
+private:
+#if defined(_WIN32)
+    static constexpr int32_t FrameSize = 8 + 10 * 16 + 8;
+#else
+    static constexpr int32_t FrameSize = 8;
+#endif
+
+    size_t N_;
+    size_t K_;
+    size_t AlignedN_;
+    size_t SliceCount_;
+    size_t LastCountK_;
+    size_t TailN_;
+    MLAS_JIT_ASSEMBLER Asm_;
+
+    int32_t SliceBytes() const { return int32_t(AlignedN_ * MLAS_SGEMM_PACKED_STRIDEK * sizeof(float)); }
+
+    MLAS_JIT_MEM RowA(int32_t Row, int32_t Displacement) const
+    {
+        const uint8_t Base = (Row < 3) ? RegARow0 : RegARow3;
+        switch (Row % 3) {
+            case 0:
+                return Mem(Base, Displacement);
+            case 1:
+                return Mem(Base, RegLda, 1, Displacement);
+            default:
+                return Mem(Base, RegLda, 2, Displacement);
+        }
+    }
+
+    MLAS_JIT_MEM RowC(int32_t Row, int32_t Displacement) const
+    {
+        const uint8_t Base = (Row < 3) ? RegCColumn : RegARow3;
+        switch (Row % 3) {
+            case 0:
+                return Mem(Base, Displacement);
+            case 1:
+                return Mem(Base, RegLdc, 1, Displacement);
+            default:
+                return Mem(Base, RegLdc, 2, Displacement);
+        }
+    }
+
+    static uint8_t Accumulator(int32_t Row, int32_t Half) { return uint8_t(Row * 2 + Half); }
+
+    void EmitRowThreeAddress(uint8_t Dst, uint8_t Base, uint8_t Stride)
+    {
+        Asm_.Lea(Dst, Mem(Base, Stride, 2));
+        Asm_.Add(Dst, Stride);
+    }
+
+    void EmitMultiplySteps(int32_t Rows, int32_t Halves, int32_t Steps)
+    {
+        for (int32_t k = 0; k < Steps; k++) {
+            for (int32_t h = 0; h < Halves; h++) {
+                Asm_.Vmovups(uint8_t(12 + h), Mem(RegB, k * MLAS_SGEMM_JIT_BLOCK_BYTES + h * 32));
+            }
+            for (int32_t r = 0; r < Rows; r++) {
+                const uint8_t Broadcast = uint8_t(14 + (r & 1));
+                Asm_.Vbroadcastss(Broadcast, RowA(r, k * int32_t(sizeof(float))));
+                for (int32_t h = 0; h < Halves; h++) {
+                    Asm_.Vfmadd231ps(Accumulator(r, h), uint8_t(12 + h), Broadcast);
+                }
+            }
+        }
+    }
+
+    void EmitSlice(int32_t Rows, int32_t Halves, size_t CountK)
+    {
+        if (Rows > 3) {
+            EmitRowThreeAddress(RegARow3, RegARow0, RegLda);
+        }
+
+        const int32_t Iterations = int32_t(CountK / MLAS_SGEMM_JIT_UNROLLK);
+        const int32_t Remainder = int32_t(CountK % MLAS_SGEMM_JIT_UNROLLK);
+
+        if (Iterations > 0) {
+            Asm_.MovImm(RegCountK, Iterations);
+            const size_t Loop = Asm_.Position();
+            EmitMultiplySteps(Rows, Halves, MLAS_SGEMM_JIT_UNROLLK);
+            Asm_.Add(RegB, MLAS_SGEMM_JIT_UNROLLK * MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Add(RegARow0, MLAS_SGEMM_JIT_UNROLLK * int32_t(sizeof(float)));
+            if (Rows > 3) {
+                Asm_.Add(RegARow3, MLAS_SGEMM_JIT_UNROLLK * int32_t(sizeof(float)));
+            }
+            Asm_.Dec(RegCountK);
+            Asm_.Jcc(MLAS_JIT_ASSEMBLER::NotEqual, Loop);
+        }
+
+        if (Remainder > 0) {
+            EmitMultiplySteps(Rows, Halves, Remainder);
+            Asm_.Add(RegB, Remainder * MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Add(RegARow0, Remainder * int32_t(sizeof(float)));
+        }
+    }
+
+    void EmitTile(int32_t Rows, bool Tail)
+    {
+        const int32_t Halves = (Tail && TailN_ <= 8) ? 1 : 2;
+
+        for (int32_t r = 0; r < Rows; r++) {
+            for (int32_t h = 0; h < Halves; h++) {
+                Asm_.Vxorps(Accumulator(r, h));
+            }
+        }
+
+        //
+        // Complete slices of MLAS_SGEMM_PACKED_STRIDEK rows share the same
+        // layout, so loop over them at runtime.
+        //
+
+        Asm_.Mov(RegARow0, RegA);
+
+        if (SliceCount_ > 1) {
+            Asm_.Lea(RegB, Mem(RegPackedB, RegBlockFull, 1));
+            Asm_.MovImm(Mem(Rsp, 0), int32_t(SliceCount_ - 1));
+            const size_t Loop = Asm_.Position();
+            EmitSlice(Rows, Halves, MLAS_SGEMM_PACKED_STRIDEK);
+            Asm_.Add(RegB, SliceBytes() - MLAS_SGEMM_PACKED_STRIDEK * MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Dec(Mem(Rsp, 0));
+            Asm_.Jcc(MLAS_JIT_ASSEMBLER::NotEqual, Loop);
+        }
+
+        Asm_.Lea(RegB, Mem(RegPackedB, RegBlockLast, 1, int32_t(SliceCount_ - 1) * SliceBytes()));
+        EmitSlice(Rows, Halves, LastCountK_);
+
+        //
+        // Store the output tile.
+        //
+
+        if (Rows > 3) {
+            EmitRowThreeAddress(RegARow3, RegCColumn, RegLdc);
+        }
+
+        if (!Tail) {
+            for (int32_t r = 0; r < Rows; r++) {
+                Asm_.Vmovups(RowC(r, 0), Accumulator(r, 0));
+                Asm_.Vmovups(RowC(r, 32), Accumulator(r, 1));
+            }
+            return;
+        }
+
+        const int32_t MaskedHalf = (TailN_ > 8) ? 1 : 0;
+        const bool FullFirstHalf = (TailN_ >= 8);
+
+        if (TailN_ != 8) {
+            Asm_.Mov(RegCountK, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, TailMask))));
+            Asm_.Vmovups(15, Mem(RegCountK, MaskedHalf * 32));
+        }
+
+        for (int32_t r = 0; r < Rows; r++) {
+            if (FullFirstHalf) {
+                Asm_.Vmovups(RowC(r, 0), Accumulator(r, 0));
+            }
+            if (TailN_ != 8) {
+                Asm_.Vmaskmovps(RowC(r, MaskedHalf * 32), 15, Accumulator(r, MaskedHalf));
+            }
+        }
+    }
+
+    void EmitRowTile(int32_t Rows)
+    {
+        //
+        // Compute the starting column and packed B offsets of the column range.
+        //
+
+        Asm_.Mov(RegCountK, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, BlockStart))));
+        Asm_.Imul(RegBlockFull, RegCountK, MLAS_SGEMM_PACKED_STRIDEK * MLAS_SGEMM_JIT_BLOCK_BYTES);
+        Asm_.Imul(RegBlockLast, RegCountK, int32_t(LastCountK_) * MLAS_SGEMM_JIT_BLOCK_BYTES);
+        Asm_.Imul(RegCColumn, RegCountK, MLAS_SGEMM_JIT_BLOCK_BYTES);
+        Asm_.Add(RegCColumn, RegC);
+
+        if (N_ >= 16) {
+            Asm_.Mov(RegBlockCount, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, BlockCount))));
+            Asm_.Test(RegBlockCount, RegBlockCount);
+            const size_t SkipBlocks = Asm_.Jcc(MLAS_JIT_ASSEMBLER::Equal);
+            const size_t Loop = Asm_.Position();
+            EmitTile(Rows, false);
+            Asm_.Add(RegCColumn, MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Add(RegBlockFull, MLAS_SGEMM_PACKED_STRIDEK * MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Add(RegBlockLast, int32_t(LastCountK_) * MLAS_SGEMM_JIT_BLOCK_BYTES);
+            Asm_.Dec(RegBlockCount);
+            Asm_.Jcc(MLAS_JIT_ASSEMBLER::NotEqual, Loop);
+            Asm_.Bind(SkipBlocks);
+        }
+
+        if (TailN_ != 0) {
+            Asm_.Mov(RegCountK, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, IncludeTail))));
+            Asm_.Test(RegCountK, RegCountK);
+            const size_t SkipTail = Asm_.Jcc(MLAS_JIT_ASSEMBLER::Equal);
+            EmitTile(Rows, true);
+            Asm_.Bind(SkipTail);
+        }
+    }
+};
+
+std::vector<uint8_t>
+MLAS_SGEMM_JIT_GENERATOR::Generate()
+{
+    static constexpr uint8_t SavedRegisters[] = {Rbx, Rbp, Rsi, Rdi, R12, R13, R14, R15};
+
+    for (uint8_t Reg : SavedRegisters) {
+        Asm_.Push(Reg);
+    }
+
+    Asm_.Sub(Rsp, FrameSize);
+
+#if defined(_WIN32)
+    for (uint8_t i = 0; i < 10; i++) {
+        Asm_.VmovupsXmm(Mem(Rsp, 8 + 16 * i), uint8_t(6 + i));
+    }
+    Asm_.Mov(RegArgs, Rcx);
+#else
+    Asm_.Mov(RegArgs, Rdi);
+#endif
+
+    Asm_.Mov(RegA, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, A))));
+    Asm_.Mov(RegPackedB, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, PackedB))));
+    Asm_.Mov(RegC, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, C))));
+    Asm_.Mov(RegCountM, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, CountM))));
+    Asm_.Mov(RegLda, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, lda))));
+    Asm_.Mov(RegLdc, Mem(RegArgs, int32_t(offsetof(MLAS_SGEMM_JIT_ARGS, ldc))));
+
+    //
+    // Process blocks of six rows.
+    //
+
+    const size_t RowLoop = Asm_.Position();
+    Asm_.Cmp(RegCountM, MLAS_SGEMM_JIT_MAX_ROWS);
+    const size_t RemainingRows = Asm_.Jcc(MLAS_JIT_ASSEMBLER::Below);
+    EmitRowTile(MLAS_SGEMM_JIT_MAX_ROWS);
+    EmitRowThreeAddress(RegA, RegA, RegLda);
+    EmitRowThreeAddress(RegA, RegA, RegLda);
+    EmitRowThreeAddress(RegC, RegC, RegLdc);
+    EmitRowThreeAddress(RegC, RegC, RegLdc);
+    Asm_.Sub(RegCountM, MLAS_SGEMM_JIT_MAX_ROWS);
+    Asm_.Jmp(RowLoop);
+    Asm_.Bind(RemainingRows);
+
+    //
+    // Process the remaining rows with a tile specialized for the row count.
+    //
+
+    std::vector<size_t> Done;
+
+    for (int32_t Rows = MLAS_SGEMM_JIT_MAX_ROWS - 1; Rows > 0; Rows--) {
+        Asm_.Cmp(RegCountM, Rows);
+        const size_t Next = Asm_.Jcc(MLAS_JIT_ASSEMBLER::NotEqual);
+        EmitRowTile(Rows);
+        Done.push_back(Asm_.Jmp());
+        Asm_.Bind(Next);
+    }
+
+    for (size_t Patch : Done) {
+        Asm_.Bind(Patch);
+    }
+
+    Asm_.Vzeroupper();
+
+#if defined(_WIN32)
+    for (uint8_t i = 0; i < 10; i++) {
+        Asm_.VmovupsXmm(uint8_t(6 + i), Mem(Rsp, 8 + 16 * i));
+    }
+#endif
+
+    Asm_.Add(Rsp, FrameSize);
+
+    for (size_t i = std::size(SavedRegisters); i > 0; i--) {
+        Asm_.Pop(SavedRegisters[i - 1]);
+    }
+
+    Asm_.Ret();
+
+    return std::move(Asm_.Code);
+}
+
+void*
+MlasSgemmJitMapCode(
+    const std::vector<uint8_t>& Code
+    )
+{
+#if defined(_WIN32)
+    void* Memory = VirtualAlloc(nullptr, Code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (Memory == nullptr) {
+        return nullptr;
+    }
+    std::memcpy(Memory, Code.data(), Code.size());
+    DWORD OldProtect;
+    if (!VirtualProtect(Memory, Code.size(), PAGE_EXECUTE_READ, &OldProtect)) {
+        VirtualFree(Memory, 0, MEM_RELEASE);
+        return nullptr;
+    }
+    FlushInstructionCache(GetCurrentProcess(), Memory, Code.size());
+#else
+    void* Memory = mmap(nullptr, Code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Memory == MAP_FAILED) {
+        return nullptr;
+    }
+    std::memcpy(Memory, Code.data(), Code.size());
+    if (mprotect(Memory, Code.size(), PROT_READ | PROT_EXEC) != 0) {
+        munmap(Memory, Code.size());
+        return nullptr;
+    }
+#endif
+    return Memory;
+}
+
+void
+MlasSgemmJitUnmapCode(
+    void* Code,
+    size_t CodeSize
+    )
+{
+#if defined(_WIN32)
+    MLAS_UNREFERENCED_PARAMETER(CodeSize);
+    VirtualFree(Code, 0, MEM_RELEASE);
+#else
+    munmap(Code, CodeSize);
+#endif
+}
+
+std::mutex MlasSgemmJitCacheMutex;
+std::map<std::pair<size_t, size_t>, MLAS_SGEMM_JIT_KERNEL*> MlasSgemmJitCache;
+
+}  // namespace
+
+#endif
+
+bool
+MLASCALL
+MlasSgemmJitIsSupported(
+    void
+    )
+{
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+    return GetMlasPlatform().GemmFloatKernel == MlasGemmFloatKernelFma3 ||
+           GetMlasPlatform().GemmFloatKernel == MlasGemmFloatKernelAvx512F;
+#else
+    return false;
+#endif
+}
+
+MLAS_SGEMM_JIT_KERNEL*
+MLASCALL
+MlasSgemmJitKernelCreate(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the kernel specialized for a matrix B of the supplied
+    shape that has been packed by MlasGemmPackB. The kernel is generated on the
+    first request for the shape and shared by later requests.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the kernel, or nullptr if kernel generation is not supported on
+    this platform or for this shape. The caller releases the kernel with
+    MlasSgemmJitKernelFree.
+
+--*/
+{
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+    //
+    // Limit the offsets inside the packed buffer to 32-bit displacements.
+    //
+
+    if (!MlasSgemmJitIsSupported() || N == 0 || K == 0 || MlasGemmPackBSize(N, K) >= (size_t(1) << 30)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> Lock(MlasSgemmJitCacheMutex);
+
+    auto& Cached = MlasSgemmJitCache[{N, K}];
+
+    if (Cached == nullptr) {
+
+        std::vector<uint8_t> Code = MLAS_SGEMM_JIT_GENERATOR(N, K).Generate();
+        void* Memory = MlasSgemmJitMapCode(Code);
+
+        if (Memory == nullptr) {
+            MlasSgemmJitCache.erase({N, K});
+            return nullptr;
+        }
+
+        auto* Kernel = new MLAS_SGEMM_JIT_KERNEL;
+        Kernel->N = N;
+        Kernel->K = K;
+        Kernel->ReferenceCount = 0;
+        Kernel->Code = Memory;
+        Kernel->CodeSize = Code.size();
+        Kernel->Routine = reinterpret_cast<MLAS_SGEMM_JIT_ROUTINE*>(Memory);
+        for (size_t i = 0; i < 16; i++) {
+            Kernel->TailMask[i] = (i < N % 16) ? -1 : 0;
+        }
+
+        Cached = Kernel;
+    }
+
+    Cached->ReferenceCount++;
+
+    return Cached;
+#else
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(K);
+    return nullptr;
+#endif
+}
+
+void
+MLASCALL
+MlasSgemmJitKernelFree(
+    MLAS_SGEMM_JIT_KERNEL* Kernel
+    )
+/*++
+
+Routine Description:
+
+    This routine releases a kernel returned by MlasSgemmJitKernelCreate.
+
+Arguments:
+
+    Kernel - Supplies the kernel to release.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+    if (Kernel == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(MlasSgemmJitCacheMutex);
+
+    if (--Kernel->ReferenceCount == 0) {
+        MlasSgemmJitCache.erase({Kernel->N, Kernel->K});
+        MlasSgemmJitUnmapCode(Kernel->Code, Kernel->CodeSize);
+        delete Kernel;
+    }
+#else
+    MLAS_UNREFERENCED_PARAMETER(Kernel);
+#endif
+}
+
+bool
+MlasSgemmJitOperation(
+    const MLAS_SGEMM_JIT_KERNEL* Kernel,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes C = A * B for a range of columns of a packed matrix B
+    using a generated kernel.
+
+Arguments:
+
+    Kernel - Supplies the kernel generated for the shape of matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B. This must
+        be a multiple of MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    C - Supplies the address of matrix C at the starting column.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    Returns true if the operation was computed, else false if the kernel does
+    not match the shape of the operation.
+
+--*/
+{
+#if defined(MLAS_SGEMM_JIT_SUPPORTED)
+    if (Kernel->K != K || RangeStartN % 16 != 0 || RangeStartN + RangeCountN > Kernel->N) {
+        return false;
+    }
+
+    const bool IncludeTail = (RangeStartN + RangeCountN == Kernel->N) && (Kernel->N % 16 != 0);
+
+    if (!IncludeTail && RangeCountN % 16 != 0) {
+        return false;
+    }
+
+    MLAS_SGEMM_JIT_ARGS Args;
+    Args.A = A;
+    Args.PackedB = static_cast<const float*>(PackedB);
+    Args.C = C - RangeStartN;
+    Args.CountM = M;
+    Args.lda = lda * sizeof(float);
+    Args.ldc = ldc * sizeof(float);
+    Args.BlockStart = RangeStartN / 16;
+    Args.BlockCount = RangeCountN / 16;
+    Args.IncludeTail = IncludeTail ? 1 : 0;
+    Args.TailMask = Kernel->TailMask;
+
+    Kernel->Routine(&Args);
+
+    return true;
+#else
+    MLAS_UNREFERENCED_PARAMETER(Kernel);
+    MLAS_UNREFERENCED_PARAMETER(M);
+    MLAS_UNREFERENCED_PARAMETER(RangeStartN);
+    MLAS_UNREFERENCED_PARAMETER(RangeCountN);
+    MLAS_UNREFERENCED_PARAMETER(K);
+    MLAS_UNREFERENCED_PARAMETER(A);
+    MLAS_UNREFERENCED_PARAMETER(lda);
+    MLAS_UNREFERENCED_PARAMETER(PackedB);
+    MLAS_UNREFERENCED_PARAMETER(C);
+    MLAS_UNREFERENCED_PARAMETER(ldc);
+    return false;
+#endif
+}
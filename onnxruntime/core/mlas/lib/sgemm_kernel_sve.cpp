@@ -0,0 +1,384 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_kernel_sve.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision matrix/matrix
+    multiply operation (SGEMM) using ARM SVE.
+
+    The kernels are vector length agnostic and consume the B panels packed
+    by MlasSgemmCopyPackB or MlasSgemmTransposePackB, which are 16 columns
+    wide. A panel is covered by one vector when the vector length is at least
+    512 bits, else by two vectors. The kernels are only selected for vector
+    lengths of at least 256 bits.
+
+--*/
+
+#if defined(__aarch64__) && defined(__linux__)
+
+#include <arm_sve.h>
+
+#include "mlasi.h"
+
+//
+// Multiplies the panel columns held by a vector of B with a row of A and
+// accumulates the row output. The vector of A holds four elements of the row
+// replicated in every 128-bit segment.
+//
+
+#define MlasSgemmSveMultiplyAddLane(Lane)                                       \
+    {                                                                           \
+        const svfloat32_t BElements0 = svld1_f32(PanelPred0, b + Lane * 16);    \
+        Row0Block0 = svmla_lane_f32(Row0Block0, BElements0, Row0AElements, Lane); \
+        if constexpr (RowCount > 1) {                                           \
+            Row1Block0 = svmla_lane_f32(Row1Block0, BElements0, Row1AElements, Lane); \
+        }                                                                       \
+        if constexpr (RowCount > 2) {                                           \
+            Row2Block0 = svmla_lane_f32(Row2Block0, BElements0, Row2AElements, Lane); \
+            Row3Block0 = svmla_lane_f32(Row3Block0, BElements0, Row3AElements, Lane); \
+        }                                                                       \
+        if constexpr (SplitPanel) {                                             \
+            const svfloat32_t BElements1 = svld1_f32(PanelPred1, b + Lane * 16 + VectorLength); \
+            Row0Block1 = svmla_lane_f32(Row0Block1, BElements1, Row0AElements, Lane); \
+            if constexpr (RowCount > 1) {                                       \
+                Row1Block1 = svmla_lane_f32(Row1Block1, BElements1, Row1AElements, Lane); \
+            }                                                                   \
+            if constexpr (RowCount > 2) {                                       \
+                Row2Block1 = svmla_lane_f32(Row2Block1, BElements1, Row2AElements, Lane); \
+                Row3Block1 = svmla_lane_f32(Row3Block1, BElements1, Row3AElements, Lane); \
+            }                                                                   \
+        }                                                                       \
+    }
+
+//
+// Multiplies the panel columns held by a vector of B with a single element
+// of A for each row and accumulates the row output.
+//
+
+#define MlasSgemmSveMultiplyAddScalar(BlockIndex)                               \
+    {                                                                           \
+        Row0Block##BlockIndex = svmla_n_f32_x(PanelPred##BlockIndex, Row0Block##BlockIndex, BElements##BlockIndex, a[0]); \
+        if constexpr (RowCount > 1) {                                           \
+            Row1Block##BlockIndex = svmla_n_f32_x(PanelPred##BlockIndex, Row1Block##BlockIndex, BElements##BlockIndex, a[lda]); \
+        }                                                                       \
+        if constexpr (RowCount > 2) {                                           \
+            Row2Block##BlockIndex = svmla_n_f32_x(PanelPred##BlockIndex, Row2Block##BlockIndex, BElements##BlockIndex, a[lda * 2]); \
+            Row3Block##BlockIndex = svmla_n_f32_x(PanelPred##BlockIndex, Row3Block##BlockIndex, BElements##BlockIndex, a[lda * 3]); \
+        }                                                                       \
+    }
+
+//
+// Stores a vector of the row output to matrix C: either multiplied by alpha or
+// multiplied by alpha and added to the existing contents of matrix C.
+//
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmSveStoreBlock(
+    svbool_t StorePred,
+    float* c,
+    svfloat32_t Accumulator,
+    float alpha
+    )
+{
+    if constexpr (ZeroMode) {
+        svst1_f32(StorePred, c, svmul_n_f32_x(StorePred, Accumulator, alpha));
+    } else {
+        svst1_f32(StorePred, c, svmla_n_f32_x(StorePred, svld1_f32(StorePred, c), Accumulator, alpha));
+    }
+}
+
+template<size_t RowCount, bool SplitPanel, bool ZeroMode>
+MLAS_FORCEINLINE
+size_t
+MlasSgemmSveProcessCount(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount row block of the output matrix.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+
+    const svbool_t AllTrue = svptrue_b32();
+    const svbool_t PanelPred0 = svwhilelt_b32_u64(0, 16);
+    const svbool_t PanelPred1 = svwhilelt_b32_u64(VectorLength, 16);
+
+    if constexpr (!SplitPanel) {
+        MLAS_UNREFERENCED_PARAMETER(PanelPred1);
+    }
+
+    do {
+
+        svfloat32_t Row0Block0 = svdup_n_f32(0.0f);
+        svfloat32_t Row0Block1 = svdup_n_f32(0.0f);
+        svfloat32_t Row1Block0 = svdup_n_f32(0.0f);
+        svfloat32_t Row1Block1 = svdup_n_f32(0.0f);
+        svfloat32_t Row2Block0 = svdup_n_f32(0.0f);
+        svfloat32_t Row2Block1 = svdup_n_f32(0.0f);
+        svfloat32_t Row3Block0 = svdup_n_f32(0.0f);
+        svfloat32_t Row3Block1 = svdup_n_f32(0.0f);
+
+        //
+        // Compute the 16xRowCount output block, four rows of matrix B at a
+        // time.
+        //
+
+        const float* a = A;
+        const float* b = B;
+        size_t k = CountK;
+
+        while (k >= 4) {
+
+            svfloat32_t Row0AElements = svld1rq_f32(AllTrue, a);
+            svfloat32_t Row1AElements = Row0AElements;
+            svfloat32_t Row2AElements = Row0AElements;
+            svfloat32_t Row3AElements = Row0AElements;
+
+            if constexpr (RowCount > 1) {
+                Row1AElements = svld1rq_f32(AllTrue, a + lda);
+            }
+
+            if constexpr (RowCount > 2) {
+                Row2AElements = svld1rq_f32(AllTrue, a + lda * 2);
+                Row3AElements = svld1rq_f32(AllTrue, a + lda * 3);
+            }
+
+            MlasSgemmSveMultiplyAddLane(0);
+            MlasSgemmSveMultiplyAddLane(1);
+            MlasSgemmSveMultiplyAddLane(2);
+            MlasSgemmSveMultiplyAddLane(3);
+
+            a += 4;
+            b += 16 * 4;
+            k -= 4;
+        }
+
+        while (k > 0) {
+
+            const svfloat32_t BElements0 = svld1_f32(PanelPred0, b);
+            MlasSgemmSveMultiplyAddScalar(0);
+
+            if constexpr (SplitPanel) {
+                const svfloat32_t BElements1 = svld1_f32(PanelPred1, b + VectorLength);
+                MlasSgemmSveMultiplyAddScalar(1);
+            }
+
+            a += 1;
+            b += 16;
+            k -= 1;
+        }
+
+        //
+        // Store the output block, masking off the columns beyond CountN.
+        //
+
+        const size_t CountNThisPanel = std::min(CountN, size_t(16));
+        const svbool_t StorePred0 = svwhilelt_b32_u64(0, CountNThisPanel);
+        const svbool_t StorePred1 = svwhilelt_b32_u64(VectorLength, CountNThisPanel);
+
+        if constexpr (!SplitPanel) {
+            MLAS_UNREFERENCED_PARAMETER(StorePred1);
+        }
+
+        MlasSgemmSveStoreBlock<ZeroMode>(StorePred0, C, Row0Block0, alpha);
+        if constexpr (SplitPanel) {
+            MlasSgemmSveStoreBlock<ZeroMode>(StorePred1, C + VectorLength, Row0Block1, alpha);
+        }
+
+        if constexpr (RowCount > 1) {
+            MlasSgemmSveStoreBlock<ZeroMode>(StorePred0, C + ldc, Row1Block0, alpha);
+            if constexpr (SplitPanel) {
+                MlasSgemmSveStoreBlock<ZeroMode>(StorePred1, C + ldc + VectorLength, Row1Block1, alpha);
+            }
+        }
+
+        if constexpr (RowCount > 2) {
+            MlasSgemmSveStoreBlock<ZeroMode>(StorePred0, C + ldc * 2, Row2Block0, alpha);
+            MlasSgemmSveStoreBlock<ZeroMode>(StorePred0, C + ldc * 3, Row3Block0, alpha);
+            if constexpr (SplitPanel) {
+                MlasSgemmSveStoreBlock<ZeroMode>(StorePred1, C + ldc * 2 + VectorLength, Row2Block1, alpha);
+                MlasSgemmSveStoreBlock<ZeroMode>(StorePred1, C + ldc * 3 + VectorLength, Row3Block1, alpha);
+            }
+        }
+
+        C += CountNThisPanel;
+        B += 16 * CountK;
+        CountN -= CountNThisPanel;
+
+    } while (CountN > 0);
+
+    return RowCount;
+}
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+size_t
+MlasSgemmKernelSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    //
+    // A 16 column panel needs two vectors unless the vector length is at
+    // least 512 bits.
+    //
+
+    if (svcntw() < 16) {
+        if (CountM >= 4) {
+            return MlasSgemmSveProcessCount<4, true, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        } else if (CountM >= 2) {
+            return MlasSgemmSveProcessCount<2, true, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        } else {
+            return MlasSgemmSveProcessCount<1, true, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        }
+    } else {
+        if (CountM >= 4) {
+            return MlasSgemmSveProcessCount<4, false, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        } else if (CountM >= 2) {
+            return MlasSgemmSveProcessCount<2, false, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        } else {
+            return MlasSgemmSveProcessCount<1, false, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelSveZero(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows. The output matrix is overwritten with the product.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmKernelSve<true>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelSveAdd(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows. The product is accumulated into the output matrix.
+
+Arguments:
+
+    See MlasSgemmKernelSveZero.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmKernelSve<false>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+#endif  // defined(__aarch64__) && defined(__linux__)
@@ -0,0 +1,480 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sparse_sgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a sparse matrix B that is packed in a block sparse
+    format.
+
+    Matrix B is divided into blocks of one row and 16 columns. Blocks that are
+    all zero are dropped, and the remaining blocks are stored as dense rows of
+    16 values, grouped by column block. The packed buffer is laid out as:
+
+        uint32_t BlockColumnStart[ColumnBlocks + 1];
+        uint32_t BlockRow[BlockCount];
+        float Values[BlockCount][16];   (aligned to 64 bytes)
+
+    Each output tile of rows of A by 16 columns of C is accumulated in
+    registers over the blocks of its column block only, so the work is
+    proportional to the number of non-zero blocks. This suits weights pruned
+    by whole input channels or by groups of output channels.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of a block.
+//
+
+constexpr size_t MLAS_SPARSE_SGEMM_BLOCK_N = 16;
+
+//
+// Define the alignment of the block values in the packed buffer.
+//
+
+constexpr size_t MLAS_SPARSE_SGEMM_VALUES_ALIGNMENT = 64;
+
+//
+// Define the number of rows of A that are multiplied with the same blocks.
+//
+
+constexpr size_t MLAS_SPARSE_SGEMM_TILE_M = 2;
+
+static
+size_t
+MlasSparseSgemmColumnBlocks(
+    size_t N
+    )
+{
+    return (N + MLAS_SPARSE_SGEMM_BLOCK_N - 1) / MLAS_SPARSE_SGEMM_BLOCK_N;
+}
+
+static
+size_t
+MlasSparseSgemmValuesOffset(
+    size_t N,
+    size_t BlockCount
+    )
+{
+    const size_t IndexBytes = (MlasSparseSgemmColumnBlocks(N) + 1 + BlockCount) * sizeof(uint32_t);
+
+    return (IndexBytes + MLAS_SPARSE_SGEMM_VALUES_ALIGNMENT - 1) & ~(MLAS_SPARSE_SGEMM_VALUES_ALIGNMENT - 1);
+}
+
+MLAS_FORCEINLINE
+float
+MlasSparseSgemmLoadB(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    return (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+}
+
+size_t
+MLASCALL
+MlasSparseSgemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine counts the blocks of matrix B that have a non-zero value.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the number of non-zero blocks.
+
+--*/
+{
+    size_t BlockCount = 0;
+
+    for (size_t n0 = 0; n0 < N; n0 += MLAS_SPARSE_SGEMM_BLOCK_N) {
+
+        const size_t CountN = std::min(N - n0, MLAS_SPARSE_SGEMM_BLOCK_N);
+
+        for (size_t k = 0; k < K; k++) {
+            for (size_t n = 0; n < CountN; n++) {
+                if (MlasSparseSgemmLoadB(TransB, B, ldb, k, n0 + n) != 0.0f) {
+                    BlockCount++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return BlockCount;
+}
+
+size_t
+MLASCALL
+MlasSparseSgemmPackBSize(
+    size_t N,
+    size_t K,
+    size_t BlockCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the size in bytes of the packed buffer of a matrix B
+    with BlockCount non-zero blocks.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BlockCount - Supplies the number of non-zero blocks from
+        MlasSparseSgemmCountBlocks.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer, or zero if the matrix is
+    too large to be indexed by the packed format.
+
+--*/
+{
+    if (K > std::numeric_limits<uint32_t>::max() ||
+        BlockCount > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    return MlasSparseSgemmValuesOffset(N, BlockCount) +
+           BlockCount * MLAS_SPARSE_SGEMM_BLOCK_N * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSparseSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t BlockCount,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the non-zero blocks of matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    BlockCount - Supplies the number of non-zero blocks from
+        MlasSparseSgemmCountBlocks.
+
+    PackedB - Supplies the address of a buffer of MlasSparseSgemmPackBSize
+        bytes, aligned to 64 bytes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t ColumnBlocks = MlasSparseSgemmColumnBlocks(N);
+
+    uint32_t* BlockColumnStart = reinterpret_cast<uint32_t*>(PackedB);
+    uint32_t* BlockRow = BlockColumnStart + ColumnBlocks + 1;
+    float* Values = reinterpret_cast<float*>(
+        reinterpret_cast<uint8_t*>(PackedB) + MlasSparseSgemmValuesOffset(N, BlockCount));
+
+    size_t Block = 0;
+
+    for (size_t cb = 0; cb < ColumnBlocks; cb++) {
+
+        const size_t n0 = cb * MLAS_SPARSE_SGEMM_BLOCK_N;
+        const size_t CountN = std::min(N - n0, MLAS_SPARSE_SGEMM_BLOCK_N);
+
+        BlockColumnStart[cb] = uint32_t(Block);
+
+        for (size_t k = 0; k < K; k++) {
+
+            bool IsZero = true;
+
+            for (size_t n = 0; n < CountN; n++) {
+                if (MlasSparseSgemmLoadB(TransB, B, ldb, k, n0 + n) != 0.0f) {
+                    IsZero = false;
+                    break;
+                }
+            }
+
+            if (IsZero) {
+                continue;
+            }
+
+            float* BlockValues = Values + Block * MLAS_SPARSE_SGEMM_BLOCK_N;
+
+            for (size_t n = 0; n < MLAS_SPARSE_SGEMM_BLOCK_N; n++) {
+                BlockValues[n] = (n < CountN) ? MlasSparseSgemmLoadB(TransB, B, ldb, k, n0 + n) : 0.0f;
+            }
+
+            BlockRow[Block] = uint32_t(k);
+            Block++;
+        }
+    }
+
+    BlockColumnStart[ColumnBlocks] = uint32_t(Block);
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSparseSgemmKernel(
+    const float* A,
+    size_t lda,
+    const uint32_t* BlockRow,
+    const float* Values,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of a column block of the output.
+
+Arguments:
+
+    A - Supplies the address of the first row of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    BlockRow - Supplies the rows of the blocks of the column block.
+
+    Values - Supplies the values of the blocks of the column block.
+
+    BlockCount - Supplies the number of blocks of the column block.
+
+    C - Supplies the address of the first row and column of the output.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountN - Supplies the number of columns of the column block.
+
+    alpha - Supplies the scalar multiplier.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators[r][i] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (size_t b = 0; b < BlockCount; b++) {
+
+        const float* BlockValues = Values + b * MLAS_SPARSE_SGEMM_BLOCK_N;
+
+        const MLAS_FLOAT32X4 B0 = MlasLoadFloat32x4(BlockValues);
+        const MLAS_FLOAT32X4 B1 = MlasLoadFloat32x4(BlockValues + 4);
+        const MLAS_FLOAT32X4 B2 = MlasLoadFloat32x4(BlockValues + 8);
+        const MLAS_FLOAT32X4 B3 = MlasLoadFloat32x4(BlockValues + 12);
+
+        const size_t k = BlockRow[b];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const MLAS_FLOAT32X4 AElement = MlasBroadcastFloat32x4(A + r * lda + k);
+            Accumulators[r][0] = MlasMultiplyAddFloat32x4(AElement, B0, Accumulators[r][0]);
+            Accumulators[r][1] = MlasMultiplyAddFloat32x4(AElement, B1, Accumulators[r][1]);
+            Accumulators[r][2] = MlasMultiplyAddFloat32x4(AElement, B2, Accumulators[r][2]);
+            Accumulators[r][3] = MlasMultiplyAddFloat32x4(AElement, B3, Accumulators[r][3]);
+        }
+    }
+
+    const MLAS_FLOAT32X4 Alpha = MlasBroadcastFloat32x4(alpha);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        float* c = C + r * ldc;
+
+        if (CountN == MLAS_SPARSE_SGEMM_BLOCK_N) {
+            for (size_t i = 0; i < 4; i++) {
+                MlasStoreFloat32x4(c + i * 4, MlasMultiplyFloat32x4(Accumulators[r][i], Alpha));
+            }
+        } else {
+            MLAS_DECLSPEC_ALIGN(float Row[MLAS_SPARSE_SGEMM_BLOCK_N], 16);
+            for (size_t i = 0; i < 4; i++) {
+                MlasStoreFloat32x4(Row + i * 4, MlasMultiplyFloat32x4(Accumulators[r][i], Alpha));
+            }
+            std::copy_n(Row, CountN, c);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSparseSgemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    float alpha,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes C = alpha * A * B for a matrix B packed by
+    MlasSparseSgemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const size_t ColumnBlocks = MlasSparseSgemmColumnBlocks(N);
+
+    const uint32_t* BlockColumnStart = reinterpret_cast<const uint32_t*>(PackedB);
+    const uint32_t* BlockRow = BlockColumnStart + ColumnBlocks + 1;
+    const size_t BlockCount = BlockColumnStart[ColumnBlocks];
+    const float* Values = reinterpret_cast<const float*>(
+        reinterpret_cast<const uint8_t*>(PackedB) + MlasSparseSgemmValuesOffset(N, BlockCount));
+
+    //
+    // Compute the number of target threads given the number of multiplies
+    // of the non-zero blocks. Each thread computes a range of tiles of
+    // MLAS_SPARSE_SGEMM_TILE_M rows by one column block.
+    //
+
+    const size_t RowTiles = (M + MLAS_SPARSE_SGEMM_TILE_M - 1) / MLAS_SPARSE_SGEMM_TILE_M;
+    const size_t TileCount = RowTiles * ColumnBlocks;
+
+    const double Complexity = double(M) * double(BlockCount) * double(MLAS_SPARSE_SGEMM_BLOCK_N);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= TileCount) {
+        TargetThreadCount = ptrdiff_t(TileCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t TileIndex;
+        size_t TileRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TileCount, &TileIndex, &TileRemaining);
+
+        for (; TileRemaining > 0; TileIndex++, TileRemaining--) {
+
+            //
+            // Iterate over the rows within a column block, so that the blocks
+            // of the column block stay in cache.
+            //
+
+            const size_t cb = TileIndex / RowTiles;
+            const size_t m = (TileIndex % RowTiles) * MLAS_SPARSE_SGEMM_TILE_M;
+            const size_t n0 = cb * MLAS_SPARSE_SGEMM_BLOCK_N;
+            const size_t CountN = std::min(N - n0, MLAS_SPARSE_SGEMM_BLOCK_N);
+
+            const size_t BlockStart = BlockColumnStart[cb];
+            const size_t ColumnBlockCount = BlockColumnStart[cb + 1] - BlockStart;
+
+            const float* a = A + m * lda;
+            const uint32_t* rows = BlockRow + BlockStart;
+            const float* values = Values + BlockStart * MLAS_SPARSE_SGEMM_BLOCK_N;
+            float* c = C + m * ldc + n0;
+
+            if (M - m >= MLAS_SPARSE_SGEMM_TILE_M) {
+                MlasSparseSgemmKernel<MLAS_SPARSE_SGEMM_TILE_M>(a, lda, rows, values, ColumnBlockCount, c, ldc,
+                                                                 CountN, alpha);
+            } else {
+                MlasSparseSgemmKernel<1>(a, lda, rows, values, ColumnBlockCount, c, ldc, CountN, alpha);
+            }
+        }
+    });
+}
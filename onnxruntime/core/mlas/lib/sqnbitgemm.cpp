@@ -30,6 +30,8 @@ enum SQNBitGemmVariant {
 
     SQNBitGemmVariant_BitWidth4_CompFp32 = 0,
     SQNBitGemmVariant_BitWidth4_CompInt8,
+    SQNBitGemmVariant_BitWidth2_CompFp32,
+    SQNBitGemmVariant_BitWidth3_CompFp32,
 
     // End of valid variants
 
@@ -55,6 +57,14 @@ GetSQNBitGemmVariant(
         }
     }
 
+    if ((BlkBitWidth == 2 || BlkBitWidth == 3) &&
+        (BlkLen == 16 || BlkLen == 32 || BlkLen == 64 || BlkLen == 128 || BlkLen == 256)) {
+        if (ComputeType == CompFp32 ||
+            ComputeType == CompUndef) {  // treat CompUndef (undefined) as CompFp32
+            return BlkBitWidth == 2 ? SQNBitGemmVariant_BitWidth2_CompFp32 : SQNBitGemmVariant_BitWidth3_CompFp32;
+        }
+    }
+
     return SQNBitGemmVariantInvalid;
 }
 
@@ -84,6 +94,10 @@ MlasIsSQNBitGemmAvailable(
               (Dispatch->SQ4BitGemmKernel_CompInt8 != nullptr && Dispatch->QuantizeARow_CompInt8 != nullptr) ||
               (Dispatch->SQ4BitGemmKernel_BlkSum_CompInt8 != nullptr && Dispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr);
         }
+        case SQNBitGemmVariant_BitWidth2_CompFp32:
+        case SQNBitGemmVariant_BitWidth3_CompFp32: {
+            return Dispatch->QNBitBlkDequantBForSgemm_CompFp32 != nullptr;
+        }
         default: {
             return false;
         }
@@ -194,6 +208,12 @@ MlasSQNBitGemmPackQuantBDataSize(
         );
     }
 
+    if ((BlkBitWidth == 2 || BlkBitWidth == 3) && Dispatch->QNBitBlkDequantBForSgemm_CompFp32 != nullptr) {
+        // 2-bit and 3-bit B data is used in its original layout.
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        return N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    }
+
     return 0;
 }
 
@@ -263,6 +283,14 @@ MlasSQNBitGemmPackQuantBData(
             );
             return;
         }
+    } else if ((BlkBitWidth == 2 || BlkBitWidth == 3) && QuantBData != nullptr) {
+        // 2-bit and 3-bit B data is used in its original layout.
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        std::copy_n(
+            static_cast<const std::byte*>(QuantBData),
+            N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen),
+            static_cast<std::byte*>(PackedQuantBDataAndOrBlkSumWorkspace)
+        );
     }
 }
 
@@ -404,6 +432,104 @@ SQ4BitGemm_CompFp32(
             auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
                 a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f, true
             );
+#elif defined(MLAS_TARGET_ARM64)
+            auto RowsHandled = GetMlasPlatform().GemmFloatKernelZero(
+                a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f
+            );
+#else
+            auto RowsHandled = MlasSgemmKernelZero(a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f);
+#endif
+
+            if (bias) {
+                AddBiasForGemm(bias, c_blk, RowsHandled, CountN, ldc);
+            }
+            if (DataParams->PostProcessor != nullptr) {
+                DataParams->PostProcessor->Process(
+                    DataParams->C, RangeStartM + RangeCountM - RowsRemaining, RangeStartN + n,
+                    RowsHandled, CountN, ldc
+                );
+            }
+
+            c_blk += ldc * RowsHandled;
+            a_row += lda * RowsHandled;
+            RowsRemaining -= RowsHandled;
+        }
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemm_CompFp32(
+    const size_t BlkLen,
+    const size_t K,
+    const MLAS_SQNBIT_GEMM_DATA_PARAMS* const DataParams,
+    void* const PerGemmWorkspace,
+    const size_t RangeStartM,
+    const size_t RangeCountM,
+    const size_t RangeStartN,
+    const size_t RangeCountN
+)
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    MLAS_UNREFERENCED_PARAMETER(PerGemmWorkspace);
+
+    const size_t lda = DataParams->lda;
+    const size_t ldc = DataParams->ldc;
+
+    const size_t k_blks = MlasDivRoundup(K, BlkLen);
+    const size_t ldb = k_blks * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t k_blks_zp_bytes = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(k_blks);
+
+    const float* A = DataParams->A + RangeStartM * lda;
+
+    const std::byte* QuantBData = static_cast<const std::byte*>(DataParams->PackedQuantBData) + RangeStartN * ldb;
+    const float* QuantBScale = DataParams->QuantBScale + RangeStartN * k_blks;
+    const std::byte* QuantBZeroPoint =
+        (DataParams->QuantBZeroPoint == nullptr)
+            ? nullptr
+            : static_cast<const std::byte*>(DataParams->QuantBZeroPoint) + RangeStartN * k_blks_zp_bytes;
+
+    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+
+    const float* Bias = (DataParams->Bias == nullptr) ? nullptr : DataParams->Bias + RangeStartN;
+
+    //
+    // There is no M1 kernel for these bit widths. Dequantize a slice of B and use the Sgemm kernel for all M.
+    //
+
+    constexpr size_t StrideN = 32;
+    size_t bufsize = K * StrideN * sizeof(float);
+    MlasThreadedBufAlloc(bufsize);
+    auto* dequant_b = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+    size_t CountN;
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+        CountN = std::min(RangeCountN - n, StrideN);
+
+        const float* a_row = A;
+        const std::byte* b_col = QuantBData + n * ldb;
+        const float* b_col_scale = QuantBScale + n * k_blks;
+        const std::byte* b_col_zp =
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * k_blks_zp_bytes;
+        float* c_blk = C + n;
+        const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+        GetMlasPlatform().SQNBitGemmDispatch->QNBitBlkDequantBForSgemm_CompFp32(
+            BlkBitWidth, BlkLen,
+            dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
+        );
+
+        size_t RowsRemaining = RangeCountM;
+        while (RowsRemaining > 0) {
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)
+            auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
+                a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f, true
+            );
+#elif defined(MLAS_TARGET_ARM64)
+            auto RowsHandled = GetMlasPlatform().GemmFloatKernelZero(
+                a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f
+            );
 #else
             auto RowsHandled = MlasSgemmKernelZero(a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f);
 #endif
@@ -635,6 +761,9 @@ constexpr auto OperationMap = []() {
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].InitializeWorkspace = InitializeWorkspace_CompInt8;
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].SQNBitGemm = SQ4BitGemm_CompInt8;
 
+    ops[SQNBitGemmVariant_BitWidth2_CompFp32].SQNBitGemm = SQLowBitGemm_CompFp32<2>;
+    ops[SQNBitGemmVariant_BitWidth3_CompFp32].SQNBitGemm = SQLowBitGemm_CompFp32<3>;
+
     return ops;
 }();
 }  // namespace
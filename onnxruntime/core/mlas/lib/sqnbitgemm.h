@@ -74,7 +74,8 @@ constexpr MLAS_FORCEINLINE size_t
 MlasQNBitZeroPointsForBlksSizeInBytes(size_t BlkCount)
 {
     if constexpr (BlkBitWidth <= 4) {
-        return MlasDivRoundup(BlkCount, 2);  // 2 blocks per byte
+        // zero points are packed the same way as the block data, e.g., 2 blocks per byte for 4-bit
+        return MlasDivRoundup(BlkCount * BlkBitWidth, 8);
     } else {
         return BlkCount;
     }
@@ -230,6 +231,38 @@ struct MLAS_SQNBIT_GEMM_DISPATCH {
 
     Q4BitBlkDequantBForSgemm_CompFp32_Fn* Q4BitBlkDequantBForSgemm_CompFp32 = nullptr;
 
+    /**
+     * @brief Dequantize B into the format expected by the Sgemm kernel.
+     *        B is a quantized 2-bit or 3-bit integer matrix that is block quantized and column major.
+     *        The quantized values of a block are packed densely, least significant bits first, so a 3-bit value
+     *        may span two bytes. Zero points, if given, are packed the same way.
+     *        This is equivalent to dequantizing B and then running MlasSgemmCopyPackB.
+     *
+     * @param       BlkBitWidth         Number of bits in a quantized value. Either 2 or 3.
+     * @param       BlkLen              Number of values in a block.
+     * @param[out]  FpData              Supplies the output buffer for the dequantized B float data.
+     *                                  It should have enough space for (CountN + 16 - 1) / 16 * 16 * CountK elements.
+     * @param       QuantBData          Supplies the quantized B matrix block data.
+     * @param       QuantBScale         Supplies the quantized B matrix block scale values.
+     * @param       QuantBZeroPoint     Supplies the quantized B matrix block zero point values. Optional.
+     * @param       CountN              Number of columns of B.
+     * @param       CountK              Number of rows of B.
+     * @param       BlockStrideQuantB   Number of blocks between adjacent columns of the quantized B matrix.
+     */
+    typedef void(QNBitBlkDequantBForSgemm_CompFp32_Fn)(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        float* FpData,
+        const std::byte* QuantBData,
+        const float* QuantBScale,
+        const std::byte* QuantBZeroPoint,
+        size_t CountN,
+        size_t CountK,
+        size_t BlockStrideQuantB
+    );
+
+    QNBitBlkDequantBForSgemm_CompFp32_Fn* QNBitBlkDequantBForSgemm_CompFp32 = nullptr;
+
     //
     // CompInt8 kernel function prototypes.
     //
@@ -21,6 +21,7 @@ Abstract:
 
 #include "sqnbitgemm.h"
 #include "sqnbitgemm_kernel_avx_common.h"
+#include "sqnbitgemm_kernel_lowbit_fp32.h"
 #include "sqnbitgemm_kernel_avx_common_int8.h"
 #include "sqnbitgemm_kernel_avx512_int8_blklen16.h"
 #include "sqnbitgemm_kernel_avx512_int8_blklen32.h"
@@ -364,6 +365,7 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512 = []() {
 
     d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32_avx512;
     d.Q4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32_avx2;
+    d.QNBitBlkDequantBForSgemm_CompFp32 = QNBitBlkDequantBForSgemm_CompFp32;
 
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx512;
     d.QuantizeARowComputeBlkSum_CompInt8 = QuantizeARow_CompInt8_avx512;
@@ -0,0 +1,181 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_lowbit_fp32.h
+
+Abstract:
+
+    This module implements the B dequantization to Sgemm packed format for
+    2-bit and 3-bit SQNBitGemm with CompFp32.
+
+    The implementation is intentionally written without intrinsics. It is
+    included by the ISA specific kernel translation units so that it gets
+    compiled (and auto-vectorized) with the flags of each target ISA.
+
+    Values of a block are stored densely, least significant bits first:
+      2-bit: 4 values per byte.
+      3-bit: 8 values per 3 bytes, a value may span two bytes.
+    BlkLen is at least 16, so each block starts on a byte boundary.
+
+--*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "sqnbitgemm.h"
+
+namespace
+{
+
+MLAS_FORCEINLINE uint32_t
+QNBitLoadZeroPoint(const std::byte* ZeroPointCol, size_t BlkBitWidth, size_t BlkIdx)
+{
+    const size_t BitOffset = BlkIdx * BlkBitWidth;
+    const std::byte* Ptr = ZeroPointCol + BitOffset / 8;
+    const size_t Shift = BitOffset % 8;
+
+    uint32_t Value = std::to_integer<uint32_t>(Ptr[0]);
+    if (Shift + BlkBitWidth > 8) {
+        // the zero point spans two bytes, which both exist given the packed size of the zero points
+        Value |= std::to_integer<uint32_t>(Ptr[1]) << 8;
+    }
+
+    return (Value >> Shift) & ((uint32_t{1} << BlkBitWidth) - 1);
+}
+
+/**
+ * @brief Dequantizes `Count` values (a multiple of 8) starting at a byte boundary of one column of B
+ *        and writes them to Dst with a stride of `DstStride` floats.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+QNBitDequantValues(
+    const std::byte* QuantBData,
+    size_t Count,
+    float Scale,
+    float ZeroPoint,
+    float* Dst,
+    size_t DstStride
+)
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    constexpr uint32_t Mask = (uint32_t{1} << BlkBitWidth) - 1;
+    const float Offset = -ZeroPoint * Scale;
+
+    for (size_t i = 0; i < Count; i += 8) {
+        // 8 values occupy BlkBitWidth bytes
+        uint32_t Packed = 0;
+        for (size_t b = 0; b < BlkBitWidth; ++b) {
+            Packed |= std::to_integer<uint32_t>(QuantBData[b]) << (8 * b);
+        }
+        QuantBData += BlkBitWidth;
+
+        float Values[8];
+        for (size_t j = 0; j < 8; ++j) {
+            Values[j] = static_cast<float>((Packed >> (BlkBitWidth * j)) & Mask) * Scale + Offset;
+        }
+        for (size_t j = 0; j < 8; ++j) {
+            Dst[(i + j) * DstStride] = Values[j];
+        }
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+QNBitBlkDequantBForSgemm_CompFp32_Impl(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    constexpr size_t GemmFloatKernelWidth16 = 16;  // mlas GemmFloatKernel requires B with width 16
+    constexpr float DefaultZeroPoint = static_cast<float>(1 << (BlkBitWidth - 1));
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    // the values of the last, partial block beyond CountK are dequantized into this scratch space
+    float Tail[256];
+    assert(BlkLen <= 256);
+
+    for (size_t n = 0; n < CountN; n += GemmFloatKernelWidth16) {
+        const size_t CountCols = std::min(CountN - n, GemmFloatKernelWidth16);
+        float* DstPanel = FpData + n * CountK;
+
+        if (CountCols < GemmFloatKernelWidth16) {
+            // zero out the padding columns of the last panel
+            std::memset(DstPanel, 0, CountK * GemmFloatKernelWidth16 * sizeof(float));
+        }
+
+        for (size_t nn = 0; nn < CountCols; ++nn) {
+            const std::byte* QuantBDataCol = QuantBData + (n + nn) * StrideQuantBData;
+            const float* QuantBScaleCol = QuantBScale + (n + nn) * BlockCountK;
+            const std::byte* QuantBZeroPointCol =
+                (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + (n + nn) * StrideQuantBZeroPoint;
+
+            for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+                const float Scale = QuantBScaleCol[k_blk_idx];
+                const float ZeroPoint =
+                    (QuantBZeroPointCol == nullptr)
+                        ? DefaultZeroPoint
+                        : static_cast<float>(QNBitLoadZeroPoint(QuantBZeroPointCol, BlkBitWidth, k_blk_idx));
+
+                const size_t kklen = std::min(CountK - k, BlkLen);
+                const std::byte* QuantBDataBlk = QuantBDataCol + k_blk_idx * BlkDataSize;
+                float* Dst = DstPanel + k * GemmFloatKernelWidth16 + nn;
+
+                if (kklen == BlkLen) {
+                    QNBitDequantValues<BlkBitWidth>(QuantBDataBlk, BlkLen, Scale, ZeroPoint, Dst, GemmFloatKernelWidth16);
+                } else {
+                    const size_t kklen8 = MlasDivRoundup(kklen, 8) * 8;
+                    QNBitDequantValues<BlkBitWidth>(QuantBDataBlk, kklen8, Scale, ZeroPoint, Tail, 1);
+                    for (size_t kk = 0; kk < kklen; ++kk) {
+                        Dst[kk * GemmFloatKernelWidth16] = Tail[kk];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+QNBitBlkDequantBForSgemm_CompFp32(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    if (BlkBitWidth == 2) {
+        QNBitBlkDequantBForSgemm_CompFp32_Impl<2>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    } else {
+        assert(BlkBitWidth == 3);
+        QNBitBlkDequantBForSgemm_CompFp32_Impl<3>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    }
+}
+
+}  // namespace
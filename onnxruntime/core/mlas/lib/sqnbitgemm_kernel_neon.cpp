@@ -20,6 +20,7 @@ Abstract:
 #include <cassert>
 
 #include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_lowbit_fp32.h"
 #include "sqnbitgemm_kernel_neon.h"
 #include "sqnbitgemm_q8_block.h"
 
@@ -186,9 +187,26 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon = []() {
 
     d.SQ4BitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQ4BitGemmM1Kernel_CompFp32;
     d.Q4BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::Q4BitBlkDequantBForSgemm_CompFp32;
+    d.QNBitBlkDequantBForSgemm_CompFp32 = QNBitBlkDequantBForSgemm_CompFp32;
 
     d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8;
     d.QuantizeARow_CompInt8 = sqnbitgemm_neon::QuantizeARow_CompInt8;
 
     return d;
 }();
+
+#if defined(__linux__)
+
+//
+// The SVE dispatch uses the NEON B packing and replaces the CompInt8 kernel.
+//
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchSve = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d = MlasSQNBitGemmDispatchNeon;
+
+    d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_sve::SQ4BitGemmKernel_CompInt8;
+
+    return d;
+}();
+
+#endif  // defined(__linux__)
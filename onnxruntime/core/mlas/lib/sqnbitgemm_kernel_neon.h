@@ -142,3 +142,36 @@ LoadFloatData(const float* src, size_t count, float32x4_t (&dst)[Capacity / 4])
 }
 
 }  // namespace sqnbitgemm_neon
+
+#if defined(__linux__)
+
+namespace sqnbitgemm_sve
+{
+
+//
+// Function declarations for SQNBitGemm ARM SVE kernel entry points.
+// The SVE kernels use the NEON B packing and are implemented in files that
+// are compiled with SVE support.
+//
+
+// CompInt8 declarations
+
+size_t
+SQ4BitGemmKernel_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+);
+
+}  // namespace sqnbitgemm_sve
+
+#endif  // defined(__linux__)
@@ -0,0 +1,352 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_sve_int8.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for ARM SVE specific to
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE CompInt8.
+
+    The kernels are vector length agnostic. B is packed by
+    SQ4BitGemmPackQuantBData in the same layout as for the NEON kernels, so
+    the SVE dispatch only replaces the compute kernel.
+
+--*/
+
+#if defined(__aarch64__) && defined(__linux__)
+
+#include <arm_sve.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_neon.h"
+#include "sqnbitgemm_q8_block.h"
+
+namespace sqnbitgemm_sve
+{
+
+namespace
+{
+
+//
+// Loads packed 4-bit B values and expands them to int8 values less the zero point.
+//
+// SQ4BitGemmPackQuantBData packs each 32 element sub-block of B into 16 bytes where byte i holds element i in the
+// low nibble and element i + 16 in the high nibble. TableIndices selects the source byte and Shifts selects the nibble
+// of each vector element so that the elements are in their original order.
+//
+MLAS_FORCEINLINE svint8_t
+LoadBValues(
+    svbool_t PackedPred,
+    const std::byte* QuantBDataPtr,
+    svuint8_t TableIndices,
+    svuint8_t Shifts,
+    int8_t ZeroPoint
+)
+{
+    const svbool_t AllTrue = svptrue_b8();
+
+    const svuint8_t bv_packed = svld1_u8(PackedPred, reinterpret_cast<const uint8_t*>(QuantBDataPtr));
+    svuint8_t bv = svtbl_u8(bv_packed, TableIndices);
+    bv = svand_n_u8_x(AllTrue, svlsr_u8_x(AllTrue, bv, Shifts), 0x0F);
+
+    return svsub_n_s8_x(AllTrue, svreinterpret_s8_u8(bv), ZeroPoint);
+}
+
+//
+// Applies Op to each (row, column) of the output tile.
+//
+#define SQ4BitGemmSveForEachTileElement(Op) \
+    Op(0, 0)                                \
+    if constexpr (NumCols > 1) {            \
+        Op(0, 1)                            \
+    }                                       \
+    if constexpr (NumRows > 1) {            \
+        Op(1, 0)                            \
+        Op(2, 0)                            \
+        Op(3, 0)                            \
+        if constexpr (NumCols > 1) {        \
+            Op(1, 1)                        \
+            Op(2, 1)                        \
+            Op(3, 1)                        \
+        }                                   \
+    }
+
+//
+// Computes a NumRows by NumCols tile of the output matrix, where NumRows is 1 or 4 and NumCols is 1 or 2.
+//
+template <size_t NumRows, size_t NumCols, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemm_CompInt8_ComputeRxC(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    const float* BiasPtr,
+    float* SumPtr,
+    size_t BlockCountK,
+    size_t StrideQuantA,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    size_t ldc
+)
+{
+    static_assert(NumRows == 1 || NumRows == 4);
+    static_assert(NumCols == 1 || NumCols == 2);
+
+    constexpr size_t BlkBitWidth = 4;
+
+    const svbool_t AllTrue32 = svptrue_b32();
+
+    // elements per step, a whole number of 32 element sub-blocks
+    const size_t Step = svcntb() & ~size_t{31};
+
+    const svuint8_t Lanes = svindex_u8(0, 1);
+    const svbool_t AllTrue8 = svptrue_b8();
+    const svuint8_t TableIndices = svorr_u8_x(
+        AllTrue8,
+        svlsl_n_u8_x(AllTrue8, svlsr_n_u8_x(AllTrue8, Lanes, 5), 4),
+        svand_n_u8_x(AllTrue8, Lanes, 15)
+    );
+    const svuint8_t Shifts = svlsl_n_u8_x(
+        AllTrue8, svand_n_u8_x(AllTrue8, svlsr_n_u8_x(AllTrue8, Lanes, 4), 1), 2
+    );
+
+    const std::byte* QuantAPtr = QuantARowPtr;
+    const std::byte* QuantBDataPtr = QuantBDataColPtr;
+    const float* QuantBScalePtr = QuantBScaleColPtr;
+    const std::byte* QuantBZeroPointPtr = QuantBZeroPointColPtr;
+
+    svfloat32_t acc00 = svdup_n_f32(0.0f), acc01 = svdup_n_f32(0.0f);
+    svfloat32_t acc10 = svdup_n_f32(0.0f), acc11 = svdup_n_f32(0.0f);
+    svfloat32_t acc20 = svdup_n_f32(0.0f), acc21 = svdup_n_f32(0.0f);
+    svfloat32_t acc30 = svdup_n_f32(0.0f), acc31 = svdup_n_f32(0.0f);
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        float ScaleA[NumRows];
+        const int8_t* QuantADataPtr[NumRows];
+        for (size_t r = 0; r < NumRows; ++r) {
+            const std::byte* QuantABlk = QuantAPtr + StrideQuantA * r;
+            ScaleA[r] = Q8BlkScale(QuantABlk);
+            QuantADataPtr[r] = Q8BlkData(QuantABlk);
+        }
+
+        float ScaleB[NumCols];
+        int8_t ZeroPointB[NumCols];
+        for (size_t c = 0; c < NumCols; ++c) {
+            ScaleB[c] = QuantBScalePtr[StrideQuantBScale * c];
+            if constexpr (HasZeroPoint) {
+                const std::byte QuantBZeroPointByte = QuantBZeroPointPtr[StrideQuantBZeroPoint * c];
+                ZeroPointB[c] = ((k_blk_idx & 1) == 0)
+                                    ? std::to_integer<int8_t>(QuantBZeroPointByte & std::byte{0x0F})
+                                    : std::to_integer<int8_t>(QuantBZeroPointByte >> 4);
+            } else {
+                ZeroPointB[c] = 8;
+            }
+        }
+
+        svint32_t dot00 = svdup_n_s32(0), dot01 = svdup_n_s32(0);
+        svint32_t dot10 = svdup_n_s32(0), dot11 = svdup_n_s32(0);
+        svint32_t dot20 = svdup_n_s32(0), dot21 = svdup_n_s32(0);
+        svint32_t dot30 = svdup_n_s32(0), dot31 = svdup_n_s32(0);
+
+        for (size_t kk = 0; kk < BlkLen; kk += Step) {
+            // inactive elements of A are loaded as zero and do not contribute to the dot products
+            const size_t StepLen = std::min(Step, BlkLen - kk);
+            const svbool_t PredA = svwhilelt_b8_u64(0, StepLen);
+            const svbool_t PredB = svwhilelt_b8_u64(0, StepLen / 2);
+
+            // load B
+            const svint8_t bv0 = LoadBValues(PredB, QuantBDataPtr + kk / 2, TableIndices, Shifts, ZeroPointB[0]);
+            svint8_t bv1 = bv0;
+            if constexpr (NumCols > 1) {
+                bv1 = LoadBValues(
+                    PredB, QuantBDataPtr + StrideQuantBData + kk / 2, TableIndices, Shifts, ZeroPointB[NumCols - 1]
+                );
+            }
+
+            // load A
+            const svint8_t av0 = svld1_s8(PredA, QuantADataPtr[0] + kk);
+            svint8_t av1 = av0, av2 = av0, av3 = av0;
+            if constexpr (NumRows > 1) {
+                av1 = svld1_s8(PredA, QuantADataPtr[NumRows > 1 ? 1 : 0] + kk);
+                av2 = svld1_s8(PredA, QuantADataPtr[NumRows > 1 ? 2 : 0] + kk);
+                av3 = svld1_s8(PredA, QuantADataPtr[NumRows > 1 ? 3 : 0] + kk);
+            }
+
+            // quantized dot product
+#define SQ4BitGemmSveDot(r, c) dot##r##c = svdot_s32(dot##r##c, av##r, bv##c);
+            SQ4BitGemmSveForEachTileElement(SQ4BitGemmSveDot)
+#undef SQ4BitGemmSveDot
+        }
+
+        // convert to float, multiply by the combined scale and update the accumulators
+#define SQ4BitGemmSveAccumulate(r, c)                                                                        \
+    acc##r##c = svmla_n_f32_x(                                                                               \
+        AllTrue32, acc##r##c, svcvt_f32_s32_x(AllTrue32, dot##r##c), ScaleA[r % NumRows] * ScaleB[c % NumCols] \
+    );
+        SQ4BitGemmSveForEachTileElement(SQ4BitGemmSveAccumulate)
+#undef SQ4BitGemmSveAccumulate
+
+        // increment block pointers
+
+        QuantAPtr += Q8BlkSize(BlkLen);
+        QuantBDataPtr += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        QuantBScalePtr += 1;
+
+        if constexpr (HasZeroPoint) {
+            QuantBZeroPointPtr += ((k_blk_idx & 1) == 0) ? 0 : 1;
+        }
+    }
+
+#define SQ4BitGemmSveStore(r, c)                                       \
+    SumPtr[ldc * r + c] = svaddv_f32(AllTrue32, acc##r##c);            \
+    if (BiasPtr != nullptr) {                                          \
+        SumPtr[ldc * r + c] += BiasPtr[c];                             \
+    }
+    SQ4BitGemmSveForEachTileElement(SQ4BitGemmSveStore)
+#undef SQ4BitGemmSveStore
+}
+
+#undef SQ4BitGemmSveForEachTileElement
+
+template <bool HasZeroPoint>
+void
+SQ4BitGemmKernel_CompInt8_BlkLenAtLeast32(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    assert(BlkLen >= 32 && BlkLen % 32 == 0);
+
+    const size_t StrideQuantA = BlockCountK * Q8BlkSize(BlkLen);
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    const std::byte* QuantARowPtr = QuantA;
+
+    float* SumRowPtr = C;
+
+    size_t m_remaining = CountM;
+    while (m_remaining > 0) {
+        const bool FourRows = m_remaining > 3;
+
+        const std::byte* QuantBDataColPtr = QuantBData;
+        const float* QuantBScaleColPtr = QuantBScale;
+        const std::byte* QuantBZeroPointColPtr = QuantBZeroPoint;
+
+        const float* BiasPtr = Bias;
+
+        float* SumPtr = SumRowPtr;
+
+        size_t n_remaining = CountN;
+        while (n_remaining > 0) {
+            const size_t NumCols = n_remaining > 1 ? 2 : 1;
+
+#define SQ4BitGemmSveCompute(Rows, Cols)                                                                           \
+    SQ4BitGemm_CompInt8_ComputeRxC<Rows, Cols, HasZeroPoint>(                                                    \
+        BlkLen, QuantARowPtr, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, BiasPtr, SumPtr,       \
+        BlockCountK, StrideQuantA, StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint, ldc                \
+    )
+            if (FourRows) {
+                if (NumCols == 2) {
+                    SQ4BitGemmSveCompute(4, 2);
+                } else {
+                    SQ4BitGemmSveCompute(4, 1);
+                }
+            } else {
+                if (NumCols == 2) {
+                    SQ4BitGemmSveCompute(1, 2);
+                } else {
+                    SQ4BitGemmSveCompute(1, 1);
+                }
+            }
+#undef SQ4BitGemmSveCompute
+
+            // Move to next columns
+            QuantBDataColPtr += NumCols * StrideQuantBData;
+            QuantBScaleColPtr += NumCols * StrideQuantBScale;
+            if constexpr (HasZeroPoint) {
+                QuantBZeroPointColPtr += NumCols * StrideQuantBZeroPoint;
+            }
+
+            BiasPtr += BiasPtr != nullptr ? NumCols : 0;
+            SumPtr += NumCols;
+
+            n_remaining -= NumCols;
+        }
+
+        // Move to next rows
+        const size_t NumRows = FourRows ? 4 : 1;
+        QuantARowPtr += NumRows * StrideQuantA;
+        SumRowPtr += NumRows * ldc;
+
+        m_remaining -= NumRows;
+    }
+}
+
+}  // namespace
+
+size_t
+SQ4BitGemmKernel_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    // a 16 element block does not fill a vector, the NEON kernel is used instead
+    if (BlkLen < 32) {
+        return sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, CountK, BlockCountK, ldc, Bias
+        );
+    }
+
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmKernel_CompInt8_BlkLenAtLeast32<true>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    } else {
+        SQ4BitGemmKernel_CompInt8_BlkLenAtLeast32<false>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    }
+
+    return CountM;
+}
+
+}  // namespace sqnbitgemm_sve
+
+#endif  // defined(__aarch64__) && defined(__linux__)
@@ -0,0 +1,357 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_wasmsimd.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for WebAssembly SIMD128 specific to
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE CompFp32.
+
+    The quantized B data is used in its original layout: the values of a
+    block are stored two per byte, the even ones in the low nibbles.
+
+--*/
+
+#include <algorithm>
+#include <cassert>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_lowbit_fp32.h"
+
+namespace sqnbitgemm_wasmsimd
+{
+
+namespace
+{
+
+constexpr size_t BlkBitWidth = 4;
+
+// the number of values of a block that are unpacked at once
+constexpr size_t SubBlkLen = 16;
+
+size_t
+SQ4BitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    return N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+}
+
+void
+SQ4BitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+
+    std::copy_n(QuantBDataBegin, SQ4BitGemmPackQuantBDataSize(N, K, BlkLen, ComputeType), PackedQuantBDataBegin);
+}
+
+MLAS_FORCEINLINE float
+LoadZeroPoint(const std::byte* QuantBZeroPointCol, size_t BlkIdx)
+{
+    if (QuantBZeroPointCol == nullptr) {
+        return 8.0f;
+    }
+
+    const std::byte ZeroPointPacked = QuantBZeroPointCol[BlkIdx / 2];
+    const std::byte ZeroPoint = (BlkIdx & 1) ? (ZeroPointPacked >> 4) : (ZeroPointPacked & std::byte{0x0F});
+    return static_cast<float>(std::to_integer<uint8_t>(ZeroPoint));
+}
+
+/**
+ * @brief Unpacks the 16 values held by 8 bytes of a block and dequantizes them to
+ *        Values[i] = { v[4i], v[4i + 1], v[4i + 2], v[4i + 3] } * Scale + Offset.
+ */
+MLAS_FORCEINLINE void
+UnpackSubBlk(
+    const std::byte* QuantBData,
+    MLAS_FLOAT32X4 Scale,
+    MLAS_FLOAT32X4 Offset,
+    MLAS_FLOAT32X4 (&Values)[4]
+)
+{
+    const v128_t Packed = wasm_v128_load64_zero(QuantBData);
+    const v128_t Low = wasm_v128_and(Packed, wasm_i8x16_splat(0x0F));
+    const v128_t High = wasm_u8x16_shr(Packed, 4);
+    const v128_t Bytes = wasm_i8x16_shuffle(Low, High, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+
+    const v128_t Words0 = wasm_u16x8_extend_low_u8x16(Bytes);
+    const v128_t Words1 = wasm_u16x8_extend_high_u8x16(Bytes);
+    Values[0] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_low_u16x8(Words0));
+    Values[1] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_high_u16x8(Words0));
+    Values[2] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_low_u16x8(Words1));
+    Values[3] = wasm_f32x4_convert_i32x4(wasm_u32x4_extend_high_u16x8(Words1));
+
+    for (size_t i = 0; i < 4; ++i) {
+        Values[i] = MlasMultiplyAddFloat32x4(Values[i], Scale, Offset);
+    }
+}
+
+template <size_t NCols>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth4_CompFp32(
+    size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+
+    MLAS_FLOAT32X4 Acc[NCols][4];
+    for (size_t i = 0; i < NCols; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            Acc[i][j] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        MLAS_FLOAT32X4 Scale[NCols];
+        MLAS_FLOAT32X4 Offset[NCols];
+        for (size_t i = 0; i < NCols; ++i) {
+            const float s = QuantBScaleColPtr[i * StrideQuantBScale + k_blk_idx];
+            const float zp = LoadZeroPoint(
+                (QuantBZeroPointColPtr == nullptr) ? nullptr : QuantBZeroPointColPtr + i * StrideQuantBZeroPoint,
+                k_blk_idx
+            );
+            Scale[i] = MlasBroadcastFloat32x4(s);
+            Offset[i] = MlasBroadcastFloat32x4(-zp * s);
+        }
+
+        for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen) {
+            const size_t kklen = std::min(k_blk_len - kk, SubBlkLen);
+            const float* a = ARowPtr + k + kk;
+
+            // the values of B past CountK are multiplied by zeros
+            MLAS_FLOAT32X4 AValues[4];
+            if (kklen == SubBlkLen) {
+                for (size_t j = 0; j < 4; ++j) {
+                    AValues[j] = MlasLoadFloat32x4(a + 4 * j);
+                }
+            } else {
+                float ABuffer[SubBlkLen] = {};
+                std::copy_n(a, kklen, ABuffer);
+                for (size_t j = 0; j < 4; ++j) {
+                    AValues[j] = MlasLoadFloat32x4(ABuffer + 4 * j);
+                }
+            }
+
+            for (size_t i = 0; i < NCols; ++i) {
+                MLAS_FLOAT32X4 BValues[4];
+                UnpackSubBlk(
+                    QuantBDataColPtr + i * StrideQuantBData + k_blk_idx * BlkDataSize + kk / 2,
+                    Scale[i], Offset[i], BValues
+                );
+                for (size_t j = 0; j < 4; ++j) {
+                    Acc[i][j] = MlasMultiplyAddFloat32x4(AValues[j], BValues[j], Acc[i][j]);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < NCols; ++i) {
+        const MLAS_FLOAT32X4 Sum = MlasAddFloat32x4(MlasAddFloat32x4(Acc[i][0], Acc[i][1]),
+                                                    MlasAddFloat32x4(Acc[i][2], Acc[i][3]));
+        SumPtr[i] = MlasReduceAddFloat32x4(Sum) + ((BiasPtr != nullptr) ? BiasPtr[i] : 0.0f);
+    }
+}
+
+void
+SQ4BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t NCols4 = 4;
+
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockStrideQuantB;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    const std::byte* QuantBDataColPtr = QuantBData;
+    const float* QuantBScaleColPtr = QuantBScale;
+    const std::byte* QuantBZeroPointColPtr = QuantBZeroPoint;
+    const float* BiasPtr = Bias;
+    float* SumPtr = C;
+
+    auto advance = [&](size_t Cols) {
+        QuantBDataColPtr += Cols * StrideQuantBData;
+        QuantBScaleColPtr += Cols * StrideQuantBScale;
+        if (QuantBZeroPointColPtr != nullptr) {
+            QuantBZeroPointColPtr += Cols * StrideQuantBZeroPoint;
+        }
+        BiasPtr = (BiasPtr != nullptr) ? BiasPtr + Cols : nullptr;
+        SumPtr += Cols;
+    };
+
+    size_t n = 0;
+    for (; n + NCols4 <= CountN; n += NCols4) {
+        ComputeDotProducts_BlkBitWidth4_CompFp32<NCols4>(
+            BlkLen, A, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint, BiasPtr
+        );
+        advance(NCols4);
+    }
+
+    for (; n < CountN; ++n) {
+        ComputeDotProducts_BlkBitWidth4_CompFp32<1>(
+            BlkLen, A, QuantBDataColPtr, QuantBScaleColPtr, QuantBZeroPointColPtr, SumPtr, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint, BiasPtr
+        );
+        advance(1);
+    }
+}
+
+MLAS_FORCEINLINE void
+Transpose4x4(MLAS_FLOAT32X4& a0, MLAS_FLOAT32X4& a1, MLAS_FLOAT32X4& a2, MLAS_FLOAT32X4& a3)
+{
+    const v128_t b0 = wasm_i32x4_shuffle(a0, a1, 0, 4, 1, 5);  // a0_0 a1_0 a0_1 a1_1
+    const v128_t b1 = wasm_i32x4_shuffle(a0, a1, 2, 6, 3, 7);  // a0_2 a1_2 a0_3 a1_3
+    const v128_t b2 = wasm_i32x4_shuffle(a2, a3, 0, 4, 1, 5);  // a2_0 a3_0 a2_1 a3_1
+    const v128_t b3 = wasm_i32x4_shuffle(a2, a3, 2, 6, 3, 7);  // a2_2 a3_2 a2_3 a3_3
+
+    a0 = wasm_i32x4_shuffle(b0, b2, 0, 1, 4, 5);  // a0_0 a1_0 a2_0 a3_0
+    a1 = wasm_i32x4_shuffle(b0, b2, 2, 3, 6, 7);  // a0_1 a1_1 a2_1 a3_1
+    a2 = wasm_i32x4_shuffle(b1, b3, 0, 1, 4, 5);  // a0_2 a1_2 a2_2 a3_2
+    a3 = wasm_i32x4_shuffle(b1, b3, 2, 3, 6, 7);  // a0_3 a1_3 a2_3 a3_3
+}
+
+void
+Q4BitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB
+)
+{
+    constexpr size_t GemmFloatKernelWidth16 = 16;  // mlas GemmFloatKernel requires B with width 16
+    constexpr size_t NCols4 = 4;
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockStrideQuantB * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    for (size_t n = 0; n < CountN; n += GemmFloatKernelWidth16) {
+        float* DstPanel = FpData + n * CountK;
+
+        // Four columns are dequantized at once and transposed into four rows of the panel. The columns past CountN
+        // are the zero padding of the last panel.
+        for (size_t nn = 0; nn < GemmFloatKernelWidth16; nn += NCols4) {
+            for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+                const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+                MLAS_FLOAT32X4 Scale[NCols4];
+                MLAS_FLOAT32X4 Offset[NCols4];
+                for (size_t i = 0; i < NCols4; ++i) {
+                    const size_t col = n + nn + i;
+                    if (col < CountN) {
+                        const float s = QuantBScale[col * BlockStrideQuantB + k_blk_idx];
+                        const float zp = LoadZeroPoint(
+                            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + col * StrideQuantBZeroPoint,
+                            k_blk_idx
+                        );
+                        Scale[i] = MlasBroadcastFloat32x4(s);
+                        Offset[i] = MlasBroadcastFloat32x4(-zp * s);
+                    } else {
+                        Scale[i] = MlasZeroFloat32x4();
+                        Offset[i] = MlasZeroFloat32x4();
+                    }
+                }
+
+                for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen) {
+                    MLAS_FLOAT32X4 Values[NCols4][4];
+                    for (size_t i = 0; i < NCols4; ++i) {
+                        const size_t col = n + nn + i;
+                        if (col < CountN) {
+                            UnpackSubBlk(
+                                QuantBData + col * StrideQuantBData + k_blk_idx * BlkDataSize + kk / 2,
+                                Scale[i], Offset[i], Values[i]
+                            );
+                        } else {
+                            for (size_t j = 0; j < 4; ++j) {
+                                Values[i][j] = MlasZeroFloat32x4();
+                            }
+                        }
+                    }
+
+                    const size_t RowsRemaining = std::min(k_blk_len - kk, SubBlkLen);
+                    for (size_t j = 0; j < 4 && 4 * j < RowsRemaining; ++j) {
+                        Transpose4x4(Values[0][j], Values[1][j], Values[2][j], Values[3][j]);
+                        for (size_t r = 0; r < 4 && 4 * j + r < RowsRemaining; ++r) {
+                            float* Dst = DstPanel + (k + kk + 4 * j + r) * GemmFloatKernelWidth16 + nn;
+                            MlasStoreFloat32x4(Dst, Values[r][j]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+}  // namespace sqnbitgemm_wasmsimd
+
+//
+// Kernel dispatch structure definition.
+//
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchWasmSimd = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = sqnbitgemm_wasmsimd::SQ4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = sqnbitgemm_wasmsimd::SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = sqnbitgemm_wasmsimd::SQ4BitGemmM1Kernel_CompFp32;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_wasmsimd::Q4BitBlkDequantBForSgemm_CompFp32;
+    d.QNBitBlkDequantBForSgemm_CompFp32 = QNBitBlkDequantBForSgemm_CompFp32;
+
+    return d;
+}();
@@ -545,7 +545,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint32_t* Input,
+    size_t InputStride,
     uint32_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -560,8 +562,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -592,9 +600,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -603,15 +611,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -628,9 +636,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -639,13 +647,13 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
@@ -671,7 +679,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint16_t* Input,
+    size_t InputStride,
     uint16_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -686,8 +696,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -717,9 +733,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -728,15 +744,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -753,9 +769,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -764,13 +780,13 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
@@ -780,7 +796,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint8_t* Input,
+    size_t InputStride,
     uint8_t* Output,
+    size_t OutputStride,
     size_t M,
     size_t N
     )
@@ -795,8 +813,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    InputStride - Supplies the number of elements between the rows of the
+        input matrix.
+
     Output - Supplies the output buffer.
 
+    OutputStride - Supplies the number of elements between the rows of the
+        output matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -823,24 +847,24 @@ Return Value:
         size_t m = M;
         while (m >= 16) {
 
-            MlasTranspose16x16Block(s, N, d, M);
+            MlasTranspose16x16Block(s, InputStride, d, OutputStride);
 
-            s += N * 16;
+            s += InputStride * 16;
             d += 16;
             m -= 16;
         }
 
         while (m > 0) {
 
-            MlasTranspose16xNVector(s, 1, d, M);
+            MlasTranspose16xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 16;
-        Output += M * 16;
+        Output += OutputStride * 16;
         n -= 16;
     }
 #endif
@@ -854,9 +878,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8x8Block(s, N, d, M);
+            MlasTranspose8x8Block(s, InputStride, d, OutputStride);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -865,15 +889,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose8xNVector(s, 1, d, M);
+            MlasTranspose8xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 8;
-        Output += M * 8;
+        Output += OutputStride * 8;
         n -= 8;
     }
 
@@ -890,9 +914,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8xNVector(s, N, d, 1);
+            MlasTranspose8xNVector(s, InputStride, d, 1);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -901,13 +925,13 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
@@ -926,3 +950,39 @@ MlasTranspose(
         M,
         N);
 }
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
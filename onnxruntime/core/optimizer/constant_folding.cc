@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <limits>
 
 #include "core/optimizer/constant_folding.h"
@@ -11,6 +12,8 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace onnxruntime::common;
 
@@ -20,12 +23,14 @@ ConstantFolding::ConstantFolding(const IExecutionProvider& execution_provider,
                                  bool skip_dequantize_linear,
                                  const ConfigOptions& config_options,
                                  const InlinedHashSet<std::string_view>& compatible_execution_providers,
-                                 const InlinedHashSet<std::string>& excluded_initializers) noexcept
+                                 const InlinedHashSet<std::string>& excluded_initializers,
+                                 concurrency::ThreadPool* intra_op_thread_pool) noexcept
     : GraphTransformer("ConstantFolding", compatible_execution_providers),
       skip_dequantize_linear_(skip_dequantize_linear),
       config_options_(config_options),
       excluded_initializers_(excluded_initializers),
-      execution_provider_(execution_provider) {
+      execution_provider_(execution_provider),
+      intra_op_thread_pool_(intra_op_thread_pool) {
 }
 
 // We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
@@ -131,8 +136,277 @@ static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Log
   return status;
 }
 
+Status ConstantFolding::FoldConstantNodesInParallel(Graph& graph, bool& modified,
+                                                    const logging::Logger& logger) const {
+#if !defined(DISABLE_SPARSE_TENSORS)
+  std::function<bool(const std::string&)> is_sparse_initializer_check = [&graph](const std::string& name) -> bool {
+    return graph.IsSparseInitializer(name);
+  };
+#else
+  std::function<bool(const std::string&)> is_sparse_initializer_check = [](std::string const&) { return false; };
+#endif
+
+  // Shape and If nodes, and DequantizeLinear nodes of QDQ node units, are folded by their special cases in ApplyImpl.
+  const auto can_fold_node = [this](const Node& node) {
+    if (node.OpType() == "Shape" || node.OpType() == "If" ||
+        (skip_dequantize_linear_ && node.OpType() == "DequantizeLinear") ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType()) ||
+        node.ContainsSubgraph()) {
+      return false;
+    }
+
+    for (const auto* output_def : node.OutputDefs()) {
+      if (!output_def->Exists() || output_def->TypeAsProto() == nullptr ||
+          !utils::HasTensorType(*output_def->TypeAsProto())) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Build the DAG of nodes whose inputs are constant initializers or outputs of other nodes in the DAG. A node is
+  // in the level after the deepest of its producers, so the nodes of a level only depend on earlier levels.
+  std::vector<std::vector<Node*>> levels;
+  InlinedHashMap<NodeIndex, size_t> node_levels;
+  InlinedHashMap<std::string, size_t> initializer_uses;
+  {
+    GraphViewer graph_viewer(graph);
+    for (NodeIndex i : graph_viewer.GetNodesInTopologicalOrder()) {
+      auto* node = graph.GetNode(i);
+      if (!node || !can_fold_node(*node)) {
+        continue;
+      }
+
+      InlinedVector<const Node*> producers(node->InputDefs().size(), nullptr);
+      for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+        if (static_cast<size_t>(edge->GetDstArgIndex()) < producers.size()) {
+          producers[edge->GetDstArgIndex()] = &edge->GetNode();
+        }
+      }
+
+      size_t level = 0;
+      bool inputs_are_constant = true;
+      for (size_t input_idx = 0; input_idx < producers.size() && inputs_are_constant; ++input_idx) {
+        const auto* input_def = node->InputDefs()[input_idx];
+        if (!input_def->Exists()) {
+          continue;
+        }
+
+        if (producers[input_idx] != nullptr) {
+          auto producer_level = node_levels.find(producers[input_idx]->Index());
+          inputs_are_constant = producer_level != node_levels.end();
+          if (inputs_are_constant) {
+            level = std::max(level, producer_level->second + 1);
+          }
+        } else {
+          inputs_are_constant = graph_utils::GetConstantInitializer(graph, input_def->Name(), true) != nullptr &&
+                                excluded_initializers_.count(input_def->Name()) == 0;
+        }
+      }
+
+      if (!inputs_are_constant) {
+        continue;
+      }
+
+      node_levels.emplace(node->Index(), level);
+      if (levels.size() <= level) {
+        levels.resize(level + 1);
+      }
+      levels[level].push_back(node);
+      for (size_t input_idx = 0; input_idx < producers.size(); ++input_idx) {
+        if (producers[input_idx] == nullptr && node->InputDefs()[input_idx]->Exists()) {
+          ++initializer_uses[node->InputDefs()[input_idx]->Name()];
+        }
+      }
+    }
+  }
+
+  // The constant initializers are converted once for all the nodes that read them, and the computed values are kept
+  // as OrtValues until all the nodes that read them have run. A value that is still read by a node that is not folded
+  // here, or is a graph output, becomes an initializer.
+  InlinedHashSet<std::string_view> graph_outputs;
+  for (const auto* output_def : graph.GetOutputs()) {
+    graph_outputs.insert(output_def->Name());
+  }
+
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  std::unordered_map<std::string, OrtValue> values;
+  InlinedHashMap<std::string, size_t> value_uses;
+  const auto release_value = [&values](InlinedHashMap<std::string, size_t>& uses, const std::string& name) {
+    auto it = uses.find(name);
+    if (it != uses.end() && --it->second == 0) {
+      values.erase(name);
+      uses.erase(it);
+    }
+  };
+  const auto release_initializers = [&](const Node& node) {
+    for (const auto* input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        release_value(initializer_uses, input_def->Name());
+      }
+    }
+  };
+
+  struct FoldTask {
+    Node* node;
+    std::unique_ptr<OptimizerExecutionFrame::Info> info;
+    std::unique_ptr<const OpKernel> kernel;
+    std::vector<int> fetch_mlvalue_idxs;
+    std::vector<OrtValue> fetches;
+    Status status;
+  };
+
+  std::vector<Node*> folded_nodes;
+  for (const auto& level_nodes : levels) {
+    // Kernels are created sequentially as a node is temporarily assigned to the CPU EP to create its kernel.
+    std::vector<FoldTask> tasks;
+    tasks.reserve(level_nodes.size());
+    for (Node* node : level_nodes) {
+      std::unordered_map<std::string, OrtValue> node_inputs;
+      bool have_inputs = true;
+      for (const auto* input_def : node->InputDefs()) {
+        if (!input_def->Exists()) {
+          continue;
+        }
+
+        auto value = values.find(input_def->Name());
+        if (value == values.end()) {
+          // an input computed by a node that was not folded is not available
+          const auto* initializer = graph_utils::GetConstantInitializer(graph, input_def->Name(), true);
+          if (initializer == nullptr) {
+            have_inputs = false;
+            break;
+          }
+
+          OrtValue ort_value;
+          ORT_RETURN_IF_ERROR(utils::TensorProtoToOrtValue(Env::Default(), graph.ModelPath(), *initializer,
+                                                           cpu_allocator, ort_value));
+          value = values.emplace(input_def->Name(), std::move(ort_value)).first;
+        }
+        node_inputs.emplace(input_def->Name(), value->second);
+      }
+
+      std::unique_ptr<OptimizerExecutionFrame::Info> info;
+      std::unique_ptr<const OpKernel> kernel;
+      if (have_inputs) {
+        info = std::make_unique<OptimizerExecutionFrame::Info>(std::vector<const Node*>{node}, node_inputs,
+                                                               graph.ModelPath(), execution_provider_,
+                                                               is_sparse_initializer_check);
+        if (node->GetExecutionProviderType() != kCpuExecutionProvider) {
+          auto ep_type = node->GetExecutionProviderType();
+          node->SetExecutionProviderType(kCpuExecutionProvider);
+          kernel = info->CreateKernel(node, config_options_);
+          node->SetExecutionProviderType(ep_type);
+        } else {
+          kernel = info->CreateKernel(node, config_options_);
+        }
+      }
+
+      if (kernel == nullptr) {
+        // the node and the nodes that read its outputs are left for the node by node constant folding
+        release_initializers(*node);
+        continue;
+      }
+
+      std::vector<int> fetch_mlvalue_idxs;
+      for (const auto* node_out : node->OutputDefs()) {
+        fetch_mlvalue_idxs.push_back(info->GetMLValueIndex(node_out->Name()));
+      }
+      tasks.push_back({node, std::move(info), std::move(kernel), std::move(fetch_mlvalue_idxs), {}, Status::OK()});
+    }
+
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        intra_op_thread_pool_, static_cast<std::ptrdiff_t>(tasks.size()), [&tasks, &logger](std::ptrdiff_t i) {
+          FoldTask& task = tasks[i];
+          ORT_TRY {
+            OptimizerExecutionFrame frame(*task.info, task.fetch_mlvalue_idxs);
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 6387)
+#endif
+            OpKernelContext op_kernel_context(&frame, task.kernel.get(), /*stream*/ nullptr, nullptr, logger);
+            task.status = task.kernel->Compute(&op_kernel_context);
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+            if (task.status.IsOK()) {
+              task.status = frame.GetOutputs(task.fetches);
+            }
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              task.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+            });
+          }
+        });
+
+    for (auto& task : tasks) {
+      ORT_RETURN_IF_ERROR(task.status);
+      Node& node = *task.node;
+      ORT_ENFORCE(task.fetches.size() == node.OutputDefs().size());
+
+      for (size_t fetch_idx = 0; fetch_idx < task.fetches.size(); ++fetch_idx) {
+        size_t uses = graph_outputs.count(node.OutputDefs()[fetch_idx]->Name());
+        for (auto edge = node.OutputEdgesBegin(); edge != node.OutputEdgesEnd(); ++edge) {
+          uses += static_cast<size_t>(edge->GetSrcArgIndex()) == fetch_idx ? 1 : 0;
+        }
+        if (uses > 0) {
+          const std::string& name = node.OutputDefs()[fetch_idx]->Name();
+          values.insert_or_assign(name, std::move(task.fetches[fetch_idx]));
+          value_uses[name] = uses;
+        }
+      }
+
+      release_initializers(node);
+      for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+        release_value(value_uses, edge->GetNode().OutputDefs()[edge->GetSrcArgIndex()]->Name());
+      }
+      folded_nodes.push_back(&node);
+    }
+  }
+
+  if (folded_nodes.empty()) {
+    return Status::OK();
+  }
+
+  for (Node* node : folded_nodes) {
+    for (auto* constant_arg_out : node->MutableOutputDefs()) {
+      auto value = values.find(constant_arg_out->Name());
+      if (value == values.end()) {
+        continue;  // only read by other folded nodes
+      }
+
+      const Tensor& out_tensor = value->second.Get<Tensor>();
+      ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
+
+      ONNX_NAMESPACE::TensorShapeProto result_shape;
+      for (auto& dim : out_tensor.Shape().GetDims()) {
+        result_shape.add_dim()->set_dim_value(dim);
+      }
+
+      constant_arg_out->SetShape(result_shape);
+      graph.AddInitializedTensor(out_tensorproto);
+    }
+  }
+
+  for (Node* node : folded_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+
+  LOGS(logger, VERBOSE) << "Folded " << folded_nodes.size() << " constant nodes in " << levels.size() << " levels.";
+  modified = true;
+  return Status::OK();
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   bool have_updated_nodes = false;
+  if (config_options_.GetConfigOrDefault(kOrtSessionOptionsEnableParallelConstantFolding, "0") == "1") {
+    ORT_RETURN_IF_ERROR(FoldConstantNodesInParallel(graph, have_updated_nodes, logger));
+    modified = modified || have_updated_nodes;
+  }
+
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
@@ -148,7 +422,8 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       continue;
     }
 
-    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    // the subgraphs of a node only read the initializers of their parent graph, so they are folded concurrently
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger, intra_op_thread_pool_));
 
     // Updating a node may allow shape inferencing to infer output shapes of following nodes,
     // so re-run the shape inferencing. use have_updated_nodes as that only applies to this Graph
@@ -7,6 +7,7 @@
 #include "core/framework/ort_value.h"
 #include <memory>
 #include "core/framework/execution_provider.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -21,20 +22,28 @@ class ConstantFolding : public GraphTransformer {
   /*! Constant folding will not be applied to nodes that have one of initializers from excluded_initializers as input.
       For pre-training, the trainable weights are those initializers to be excluded.
       \param execution_provider Execution provider instance to execute constant folding.
+      \param intra_op_thread_pool Thread pool that runs independent constant nodes in parallel when
+      kOrtSessionOptionsEnableParallelConstantFolding is enabled. The nodes run sequentially if it is nullptr.
   */
   ConstantFolding(const IExecutionProvider& execution_provider,
                   bool skip_dequantize_linear,
                   const ConfigOptions& config_options,
                   const InlinedHashSet<std::string_view>& compatible_execution_providers = {},
-                  const InlinedHashSet<std::string>& excluded_initializers = {}) noexcept;
+                  const InlinedHashSet<std::string>& excluded_initializers = {},
+                  concurrency::ThreadPool* intra_op_thread_pool = nullptr) noexcept;
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  // Folds the DAG of nodes that only depend on constant initializers level by level, running the nodes of a level
+  // in parallel. Nodes it can not fold are left for the node by node folding in ApplyImpl.
+  Status FoldConstantNodesInParallel(Graph& graph, bool& modified, const logging::Logger& logger) const;
+
   bool skip_dequantize_linear_;
   const ConfigOptions& config_options_;
   const InlinedHashSet<std::string> excluded_initializers_;
   const IExecutionProvider& execution_provider_;
+  concurrency::ThreadPool* intra_op_thread_pool_;
 };
 
 }  // namespace onnxruntime
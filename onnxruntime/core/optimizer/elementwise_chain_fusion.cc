@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+#include "core/graph/graph_utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns whether FusedElementwise supports the type on the execution provider of the node.
+bool IsSupportedType(const NodeArg& def, const Node& node) {
+  const auto* type = def.Type();
+  if (type == nullptr) {
+    return false;
+  }
+  return *type == "tensor(float)" ||
+         (*type == "tensor(float16)" && node.GetExecutionProviderType() == kCudaExecutionProvider);
+}
+
+// Returns whether the node can be evaluated by FusedElementwise, i.e. it is one of the supported float
+// elementwise operators and it is assigned to a compatible execution provider.
+bool IsFusibleNode(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (!graph_utils::IsSupportedProvider(node, compatible_providers)) {
+    return false;
+  }
+
+  const bool is_supported_op =
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13});
+  if (!is_supported_op || node.OutputDefs().size() != 1) {
+    return false;
+  }
+
+  for (const auto* def : node.InputDefs()) {
+    if (!def->Exists() || !IsSupportedType(*def, node)) {
+      return false;
+    }
+  }
+  return IsSupportedType(*node.OutputDefs()[0], node);
+}
+
+}  // namespace
+
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node != nullptr) {
+      ORT_RETURN_IF_ERROR(Recurse(*p_node, modified, graph_level, logger));
+    }
+  }
+
+  // Visit the nodes from the graph outputs backwards, so each region starts at the last node of a chain.
+  for (auto root_it = node_topology_list.rbegin(); root_it != node_topology_list.rend(); ++root_it) {
+    Node* p_root = graph.GetNode(*root_it);
+    if (p_root == nullptr || !IsFusibleNode(*p_root, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+    Node& root = *p_root;
+    const bool is_cuda = root.GetExecutionProviderType() == kCudaExecutionProvider;
+
+    // Absorb a producer once all of its consumers are in the region. A producer that is rejected because one of
+    // its consumers is not absorbed yet is visited again from that consumer.
+    InlinedHashSet<NodeIndex> region{root.Index()};
+    InlinedVector<const Node*> to_visit{&root};
+    while (!to_visit.empty()) {
+      const Node& node = *to_visit.back();
+      to_visit.pop_back();
+      for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+        const Node& producer = edge->GetNode();
+        if (region.count(producer.Index()) != 0 || !IsFusibleNode(producer, GetCompatibleExecutionProviders()) ||
+            producer.GetExecutionProviderType() != root.GetExecutionProviderType() ||
+            graph.NodeProducesGraphOutput(producer) || (is_cuda && region.size() >= kMaxCudaInstructions)) {
+          continue;
+        }
+
+        bool all_consumers_in_region = true;
+        for (auto consumer = producer.OutputNodesBegin(); consumer != producer.OutputNodesEnd(); ++consumer) {
+          if (region.count(consumer->Index()) == 0) {
+            all_consumers_in_region = false;
+            break;
+          }
+        }
+        if (all_consumers_in_region) {
+          region.insert(producer.Index());
+          to_visit.push_back(&producer);
+        }
+      }
+    }
+
+    if (region.size() < 2) {
+      continue;
+    }
+
+    // List the instructions in topological order, and the inputs of the region in the order they are first read.
+    InlinedVector<Node*> nodes;
+    for (auto node_index : node_topology_list) {
+      if (region.count(node_index) != 0) {
+        nodes.push_back(graph.GetNode(node_index));
+      }
+    }
+
+    InlinedHashMap<const NodeArg*, int64_t> results;  // instruction of each intermediate value
+    for (size_t i = 0; i < nodes.size(); i++) {
+      results.emplace(nodes[i]->OutputDefs()[0], static_cast<int64_t>(i));
+    }
+
+    std::vector<NodeArg*> fused_inputs;
+    InlinedHashMap<const NodeArg*, int64_t> input_indices;
+    for (Node* node : nodes) {
+      for (NodeArg* def : node->MutableInputDefs()) {
+        if (results.count(def) == 0 && input_indices.count(def) == 0) {
+          input_indices.emplace(def, static_cast<int64_t>(fused_inputs.size()));
+          fused_inputs.push_back(def);
+        }
+      }
+    }
+
+    if (is_cuda && fused_inputs.size() > kMaxCudaInputs) {
+      continue;
+    }
+
+    const int64_t num_inputs = static_cast<int64_t>(fused_inputs.size());
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    for (const Node* node : nodes) {
+      ops.push_back(node->OpType());
+      for (size_t i = 0; i < 2; i++) {
+        if (i >= node->InputDefs().size()) {
+          operands.push_back(-1);
+          continue;
+        }
+        const NodeArg* def = node->InputDefs()[i];
+        auto result = results.find(def);
+        operands.push_back(result != results.end() ? num_inputs + result->second : input_indices.at(def));
+      }
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(root.Name() + "/ElementwiseChainFusion/"),
+                                     "FusedElementwise",
+                                     "fused elementwise chain",
+                                     fused_inputs,
+                                     root.MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    fused_node.SetExecutionProviderType(root.GetExecutionProviderType());
+
+    // Connect the producers of the region inputs and the consumers of the region output to the fused node.
+    for (const Node* node : nodes) {
+      for (const auto& edge : graph_utils::GraphEdge::GetNodeInputEdges(*node)) {
+        if (region.count(edge.src_node) == 0) {
+          const NodeArg* def = node->InputDefs()[edge.dst_arg_index];
+          graph.AddEdge(edge.src_node, fused_node.Index(), edge.src_arg_index,
+                        static_cast<int>(input_indices.at(def)));
+        }
+      }
+    }
+    for (const auto& edge : graph_utils::GraphEdge::GetNodeOutputEdges(root)) {
+      graph.AddEdge(fused_node.Index(), edge.dst_node, 0, edge.dst_arg_index);
+    }
+
+    for (Node* node : nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseChainFusion
+
+Fuses connected regions of float elementwise operators (Add, Sub, Mul, Div, Sigmoid, Tanh, Relu, Exp, Erf, Neg,
+Abs, Sqrt, Reciprocal) into a single com.microsoft FusedElementwise node, which evaluates the region tile by tile
+on CPU, or in a single kernel launch on CUDA, instead of writing every intermediate tensor to memory. On CUDA the
+float16 operators are fused too.
+
+A region grows from its output node towards the producers of its inputs. A producer is only absorbed if all of its
+consumers are in the region already and its output is not a graph output, so the region has a single output and
+fusing it can not create a cycle. The outputs of the intermediate nodes then do not need to be materialized. All the
+nodes of a region are assigned to the same execution provider.
+
+The transformer only runs when enabled through the session config option
+kOrtSessionOptionsEnableElementwiseChainFusion, as it may prevent other fusions of the same nodes.
+*/
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  // The largest region fused for the CUDA EP, whose kernel keeps all the values of an element in registers.
+  static constexpr size_t kMaxCudaInstructions = 32;
+  static constexpr size_t kMaxCudaInputs = 8;
+
+  ElementwiseChainFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Returns the axes of the Reduce node, from its attribute or its constant input. Returns false if they are not known.
+bool GetReduceAxes(const Graph& graph, const Node& reduce_node, bool axes_as_input, InlinedVector<int64_t>& axes) {
+  if (!axes_as_input) {
+    const auto* axes_attr = graph_utils::GetNodeAttribute(reduce_node, "axes");
+    if (axes_attr == nullptr) {
+      return false;
+    }
+    axes.assign(axes_attr->ints().begin(), axes_attr->ints().end());
+    return true;
+  }
+
+  const auto& input_defs = reduce_node.InputDefs();
+  return input_defs.size() > 1 && input_defs[1]->Exists() &&
+         optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[1], axes);
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+      continue;
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+    if (axis_attr != nullptr && axis_attr->i() != 0) {
+      continue;
+    }
+
+    const NodeArg& data = *node.InputDefs()[0];
+    const NodeArg& indices = *node.InputDefs()[1];
+    const NodeArg& gathered = *node.OutputDefs()[0];
+    if (data.TypeAsProto() == nullptr ||
+        data.TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT ||
+        indices.Shape() == nullptr || indices.Shape()->dim_size() < 1 || gathered.Shape() == nullptr) {
+      continue;
+    }
+
+    Node& reduce_node = *graph.GetNode(node.OutputNodesBegin()->Index());
+    const bool is_sum = graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceSum", {1, 11, 13});
+    const bool is_mean = graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceMean", {1, 11, 13, 18});
+    if ((!is_sum && !is_mean) || reduce_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        reduce_node.InputDefs()[0] != &gathered ||
+        !optimizer_utils::IsAttributeWithExpectedValue(reduce_node, "keepdims", static_cast<int64_t>(0))) {
+      continue;
+    }
+
+    // The bags are the rows along the last axis of the indices, which is the only reduced axis.
+    InlinedVector<int64_t> axes;
+    const bool axes_as_input = reduce_node.SinceVersion() >= (is_sum ? 13 : 18);
+    const int64_t rank = gathered.Shape()->dim_size();
+    const int64_t bag_axis = indices.Shape()->dim_size() - 1;
+    if (!GetReduceAxes(graph, reduce_node, axes_as_input, axes) || axes.size() != 1 ||
+        (axes[0] < 0 ? axes[0] + rank : axes[0]) != bag_axis) {
+      continue;
+    }
+
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused Gather and " + reduce_node.OpType(),
+                                             {node.MutableInputDefs()[0], node.MutableInputDefs()[1]},
+                                             {},
+                                             nullptr,
+                                             kMSDomain);
+    embedding_bag_node.AddAttribute("mode", std::string(is_sum ? "sum" : "mean"));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    graph_utils::FinalizeNodeFusion(graph, {node, reduce_node}, embedding_bag_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
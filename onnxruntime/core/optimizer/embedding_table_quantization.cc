@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_table_quantization.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "core/framework/float16.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+struct QuantizedTable {
+  NodeArg* data;
+  NodeArg* scales;
+  NodeArg* biases;
+};
+
+// Quantizes every row of the [num_embeddings, embedding_dim] table to q = round((x - bias) / scale) over the full
+// range of the bits, using the float16 scale and bias of the row. Returns false if the table has a value that is not
+// in the range of float16.
+bool QuantizeTable(Graph& graph, const TensorProto& table_proto, int64_t bits, QuantizedTable& quantized) {
+  Initializer table{table_proto, graph.ModelPath()};
+  const int64_t num_embeddings = table.dims()[0];
+  const int64_t embedding_dim = table.dims()[1];
+  const int64_t row_bytes = (embedding_dim * bits + 7) / 8;
+  const int64_t values_per_byte = 8 / bits;
+  const float levels = static_cast<float>((1 << bits) - 1);
+  const float* table_data = table.data<float>();
+  if (!std::all_of(table_data, table_data + table.size(), [](float x) { return std::fabs(x) <= 65504.0f; })) {
+    return false;
+  }
+
+  std::vector<uint8_t> data(static_cast<size_t>(num_embeddings * row_bytes), 0);
+  std::vector<MLFloat16> scales(static_cast<size_t>(num_embeddings));
+  std::vector<MLFloat16> biases(static_cast<size_t>(num_embeddings));
+  for (int64_t r = 0; r < num_embeddings; ++r) {
+    const float* row = table_data + r * embedding_dim;
+    const auto [min_it, max_it] = std::minmax_element(row, row + embedding_dim);
+    const float min_val = embedding_dim > 0 ? *min_it : 0.0f;
+    const float max_val = embedding_dim > 0 ? *max_it : 0.0f;
+
+    // The values are quantized with the rounded parameters, which are the ones the rows are dequantized with.
+    biases[r] = MLFloat16(min_val);
+    const float bias = biases[r].ToFloat();
+    scales[r] = MLFloat16((max_val - bias) / levels);
+    const float scale = scales[r].ToFloat();
+
+    uint8_t* q_row = data.data() + r * row_bytes;
+    for (int64_t k = 0; k < embedding_dim; ++k) {
+      const float q = scale > 0.0f ? std::nearbyint((row[k] - bias) / scale) : 0.0f;
+      const auto q_val = static_cast<uint8_t>(std::clamp(q, 0.0f, levels));
+      q_row[k / values_per_byte] |= static_cast<uint8_t>(q_val << ((k % values_per_byte) * bits));
+    }
+  }
+
+  auto add_initializer = [&graph, &table_proto](const std::string& suffix, TensorProto_DataType data_type,
+                                                InlinedVector<int64_t> dims, const void* raw_data, size_t bytes) {
+    TensorProto proto;
+    proto.set_name(graph.GenerateNodeArgName(table_proto.name() + suffix));
+    proto.set_data_type(data_type);
+    for (int64_t dim : dims) {
+      proto.add_dims(dim);
+    }
+    utils::SetRawDataInTensorProto(proto, raw_data, bytes);
+    return &graph_utils::AddInitializer(graph, proto);
+  };
+
+  quantized.data = add_initializer("_quantized", TensorProto_DataType_UINT8, {num_embeddings, row_bytes},
+                                   data.data(), data.size());
+  quantized.scales = add_initializer("_scales", TensorProto_DataType_FLOAT16, {num_embeddings},
+                                     scales.data(), scales.size() * sizeof(MLFloat16));
+  quantized.biases = add_initializer("_biases", TensorProto_DataType_FLOAT16, {num_embeddings},
+                                     biases.data(), biases.size() * sizeof(MLFloat16));
+  return true;
+}
+
+}  // namespace
+
+bool EmbeddingTableQuantization::IsLookup(const Node& node) const {
+  if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+    return false;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "EmbeddingBag", {1}, kMSDomain)) {
+    return true;
+  }
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    return false;
+  }
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  return axis_attr == nullptr || axis_attr->i() == 0;
+}
+
+Status EmbeddingTableQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                             const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsLookup(node)) {
+      continue;
+    }
+
+    const NodeArg& table_arg = *node.InputDefs()[0];
+    const TensorProto* table_proto = graph.GetConstantInitializer(table_arg.Name(), false);
+    if (table_proto == nullptr || table_proto->data_type() != TensorProto_DataType_FLOAT ||
+        table_proto->dims_size() != 2 || table_proto->dims(0) * table_proto->dims(1) < min_elements_ ||
+        graph.IsOutput(&table_arg)) {
+      continue;
+    }
+
+    // The float table is only removed if all its consumers are replaced.
+    const auto consumers = graph.GetConsumerNodes(table_arg.Name());
+    const bool all_lookups = std::all_of(consumers.begin(), consumers.end(), [this, &table_arg](const Node* consumer) {
+      return IsLookup(*consumer) && consumer->InputDefs()[1] != &table_arg;
+    });
+    QuantizedTable quantized;
+    if (!all_lookups || !QuantizeTable(graph, *table_proto, bits_, quantized)) {
+      continue;
+    }
+
+    const int64_t embedding_dim = table_proto->dims(1);
+    for (const Node* consumer : consumers) {
+      Node& lookup = *graph.GetNode(consumer->Index());
+      std::string mode = "none";
+      if (lookup.OpType() == "EmbeddingBag") {
+        const auto* mode_attr = graph_utils::GetNodeAttribute(lookup, "mode");
+        mode = mode_attr != nullptr ? mode_attr->s() : "sum";
+      }
+
+      Node& gather_node = graph.AddNode(graph.GenerateNodeName("GatherRowQuantized"),
+                                        "GatherRowQuantized",
+                                        "quantized " + lookup.OpType(),
+                                        {quantized.data, lookup.MutableInputDefs()[1], quantized.scales,
+                                         quantized.biases},
+                                        {},
+                                        nullptr,
+                                        kMSDomain);
+      gather_node.AddAttribute("bits", bits_);
+      gather_node.AddAttribute("embedding_dim", embedding_dim);
+      gather_node.AddAttribute("mode", mode);
+      gather_node.SetExecutionProviderType(lookup.GetExecutionProviderType());
+
+      const std::array<std::reference_wrapper<Node>, 1> lookup_nodes{lookup};
+      graph_utils::FinalizeNodeFusion(graph, lookup_nodes, gather_node);
+    }
+
+    // The float table has no consumer left.
+    graph.RemoveInitializedTensor(table_arg.Name());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
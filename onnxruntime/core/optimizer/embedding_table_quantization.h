@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class EmbeddingTableQuantization
+
+Transformer that quantizes the large float embedding tables looked up by Gather along axis 0 or by EmbeddingBag
+row by row, with 8, 4 or 2 bits per value and a float16 scale and bias per row, and replaces the lookups by
+GatherRowQuantized, which dequantizes the rows that are looked up and pools them for EmbeddingBag. It cuts the memory
+of the tables by 4, 8 or 16 times, at the cost of the quantization error, so it has to be enabled explicitly.
+
+A table is quantized if it is a constant initializer of rank 2 with at least min_elements values, and all its
+consumers are lookups of its rows.
+*/
+class EmbeddingTableQuantization : public GraphTransformer {
+ public:
+  // Smaller tables do not use enough memory to be worth the quantization error.
+  static constexpr int64_t kDefaultMinElements = int64_t{1} << 20;
+
+  EmbeddingTableQuantization(int64_t bits, int64_t min_elements = kDefaultMinElements,
+                             const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingTableQuantization", compatible_execution_providers),
+        bits_(bits),
+        min_elements_(min_elements) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool IsLookup(const Node& node) const;
+
+  int64_t bits_;
+  int64_t min_elements_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gemm_float8_fusion.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloat8(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+  const auto elem_type = type->tensor_type().elem_type();
+  return elem_type == TensorProto_DataType_FLOAT8E4M3FN || elem_type == TensorProto_DataType_FLOAT8E5M2;
+}
+
+// Whether the DequantizeLinear producing the input input_index of the MatMul can be fused: it dequantizes a float 8
+// tensor with constant float scales and no zero point, and only feeds the MatMul.
+const Node* GetFusableDequantizeLinear(const Graph& graph, const Node& matmul, int input_index) {
+  const Node* dq = graph_utils::GetInputNode(matmul, input_index);
+  if (dq == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*dq, "DequantizeLinear", {19, 21}) ||
+      dq->GetExecutionProviderType() != matmul.GetExecutionProviderType() ||
+      !optimizer_utils::CheckOutputEdges(graph, *dq, 1)) {
+    return nullptr;
+  }
+
+  const auto& inputs = dq->InputDefs();
+  if (!IsFloat8(*inputs[0])) {
+    return nullptr;
+  }
+
+  const TensorProto* scale = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+  if (scale == nullptr || scale->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+
+  if (inputs.size() > 2 && inputs[2]->Exists()) {
+    const TensorProto* zero_point = graph_utils::GetConstantInitializer(graph, inputs[2]->Name());
+    if (zero_point == nullptr) {
+      return nullptr;
+    }
+    // +0 or -0
+    const Initializer zero_point_values{*zero_point, graph.ModelPath()};
+    const auto bytes = zero_point_values.DataAsByteSpan();
+    if (!std::all_of(bytes.begin(), bytes.end(), [](uint8_t byte) { return (byte & 0x7f) == 0; })) {
+      return nullptr;
+    }
+  }
+
+  const auto* block_size_attr = graph_utils::GetNodeAttribute(*dq, "block_size");
+  if (block_size_attr != nullptr && block_size_attr->i() != 0) {
+    return nullptr;
+  }
+  return dq;
+}
+
+// Adds the transposed [N, K] copy of the constant [K, N] float 8 matrix.
+NodeArg& AddTransposedMatrix(Graph& graph, const TensorProto& matrix_proto) {
+  const Initializer matrix{matrix_proto, graph.ModelPath()};
+  const int64_t K = matrix.dims()[0];
+  const int64_t N = matrix.dims()[1];
+  const auto values = matrix.DataAsByteSpan();
+  std::vector<uint8_t> transposed(values.size());
+  for (int64_t k = 0; k < K; ++k) {
+    for (int64_t n = 0; n < N; ++n) {
+      transposed[n * K + k] = values[k * N + n];
+    }
+  }
+
+  TensorProto proto;
+  proto.set_name(graph.GenerateNodeArgName(matrix_proto.name() + "_transposed"));
+  proto.set_data_type(matrix_proto.data_type());
+  proto.add_dims(N);
+  proto.add_dims(K);
+  utils::SetRawDataInTensorProto(proto, transposed.data(), transposed.size());
+  return graph_utils::AddInitializer(graph, proto);
+}
+
+}  // namespace
+
+Status GemmFloat8Fusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                   const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& matmul = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(matmul, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(matmul, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* dq_a = GetFusableDequantizeLinear(graph, matmul, 0);
+    const Node* dq_b = GetFusableDequantizeLinear(graph, matmul, 1);
+    if (dq_a == nullptr || dq_b == nullptr || dq_a == dq_b) {
+      continue;
+    }
+
+    NodeArg& a_arg = *dq_a->MutableInputDefs()[0];
+    NodeArg& scale_a_arg = *dq_a->MutableInputDefs()[1];
+    NodeArg& b_arg = *dq_b->MutableInputDefs()[0];
+    NodeArg& scale_b_arg = *dq_b->MutableInputDefs()[1];
+
+    // cublasLt does not multiply two E5M2 matrices.
+    if (a_arg.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_FLOAT8E5M2 &&
+        b_arg.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_FLOAT8E5M2) {
+      continue;
+    }
+
+    // The weight is a constant matrix, quantized per tensor or per column.
+    const TensorProto* b_proto = graph_utils::GetConstantInitializer(graph, b_arg.Name());
+    if (b_proto == nullptr || b_proto->dims_size() != 2 || graph.IsOutput(&b_arg)) {
+      continue;
+    }
+    const int64_t K = b_proto->dims(0);
+    const int64_t N = b_proto->dims(1);
+    if (!optimizer_utils::IsScalar(scale_b_arg)) {
+      const auto* scale_b_shape = scale_b_arg.Shape();
+      const auto* axis_attr = graph_utils::GetNodeAttribute(*dq_b, "axis");
+      const int64_t axis = axis_attr != nullptr ? axis_attr->i() : 1;
+      if (scale_b_shape == nullptr || scale_b_shape->dim_size() != 1 ||
+          !utils::HasDimValue(scale_b_shape->dim(0)) || scale_b_shape->dim(0).dim_value() != N ||
+          (axis != 1 && axis != -1)) {
+        continue;
+      }
+    }
+
+    // The activation is quantized per tensor, its last dimension is K.
+    const auto* a_shape = a_arg.Shape();
+    if (!optimizer_utils::IsScalar(scale_a_arg) || a_shape == nullptr || a_shape->dim_size() < 2 ||
+        !utils::HasDimValue(a_shape->dim(a_shape->dim_size() - 1)) ||
+        a_shape->dim(a_shape->dim_size() - 1).dim_value() != K) {
+      continue;
+    }
+
+    // The leading dimensions of the float 8 matrices must be multiples of 16 for cublasLt.
+    if (K % 16 != 0 || N % 16 != 0) {
+      continue;
+    }
+
+    NodeArg& b_transposed_arg = AddTransposedMatrix(graph, *b_proto);
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    const std::string b_name = b_arg.Name();
+
+    Node& gemm = graph.AddNode(graph.GenerateNodeName("GemmFloat8"),
+                               "GemmFloat8",
+                               "float 8 fusion of " + matmul.Name(),
+                               {&a_arg, &b_transposed_arg, &empty_arg, &scale_a_arg, &scale_b_arg},
+                               {},
+                               nullptr,
+                               kMSDomain);
+    gemm.AddAttribute("transA", static_cast<int64_t>(0));
+    gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    gemm.AddAttribute("dtype", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+    gemm.SetExecutionProviderType(matmul.GetExecutionProviderType());
+
+    Node& dq_a_node = *graph.GetNode(dq_a->Index());
+    Node& dq_b_node = *graph.GetNode(dq_b->Index());
+    graph_utils::FinalizeNodeFusion(graph, {dq_a_node, dq_b_node, matmul}, gemm);
+
+    if (graph.GetConsumerNodes(b_name).empty()) {
+      graph.RemoveInitializedTensor(b_name);
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
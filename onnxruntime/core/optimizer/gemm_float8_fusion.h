@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmFloat8Fusion
+
+Rewrite the float 8 (E4M3FN or E5M2) QDQ pattern of a MatMul to the GemmFloat8 contrib operator, which runs the
+product of the float 8 tensors on the tensor cores through cublasLt instead of dequantizing them first:
+
+  MatMul(DequantizeLinear(a, scale_a), DequantizeLinear(b, scale_b)) -> GemmFloat8(a, transpose(b), scale_a, scale_b)
+
+a is an activation of rank 2 or more quantized per tensor, b is a constant [K, N] weight quantized per tensor or per
+column (axis 1). The scales are constant floats and the zero points are absent or zero. The weight is transposed
+once, as cublasLt only takes float 8 matrices in the "TN" layout, and K and N must be multiples of 16.
+
+GemmFloat8 requires a GPU with float 8 tensor cores (compute capability 8.9 or higher), which the graph can not
+check. The fusion is therefore disabled by default, see kOrtSessionOptionsEnableGemmFloat8Fusion.
+*/
+class GemmFloat8Fusion : public GraphTransformer {
+ public:
+  GemmFloat8Fusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmFloat8Fusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #include "core/optimizer/graph_transformer.h"
 
+#include "core/platform/threadpool.h"
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -26,4 +28,43 @@ Status GraphTransformer::Apply(Graph& graph, bool& modified, const logging::Logg
   return status;
 }
 
+Status GraphTransformer::Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger,
+                                 concurrency::ThreadPool* thread_pool) const {
+  auto& subgraph_map = node.GetAttributeNameToMutableSubgraphMap();
+  if (subgraph_map.size() < 2 || concurrency::ThreadPool::DegreeOfParallelism(thread_pool) < 2) {
+    return Recurse(node, modified, graph_level, logger);
+  }
+
+  InlinedVector<Graph*> subgraphs;
+  subgraphs.reserve(subgraph_map.size());
+  for (auto& entry : subgraph_map) {
+    subgraphs.push_back(entry.second);
+  }
+
+  // each subgraph gets its own flag and status, the subgraphs are only written by their own task
+  InlinedVector<uint8_t> subgraph_modified(subgraphs.size(), 0);
+  InlinedVector<Status> statuses(subgraphs.size());
+  const int subgraph_level = graph_level + 1;
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(subgraphs.size()), [&](std::ptrdiff_t i) {
+        ORT_TRY {
+          bool subgraph_was_modified = false;
+          statuses[i] = ApplyImpl(*subgraphs[i], subgraph_was_modified, subgraph_level, logger);
+          subgraph_modified[i] = subgraph_was_modified;
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+          });
+        }
+      });
+
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    modified = modified || subgraph_modified[i] != 0;
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
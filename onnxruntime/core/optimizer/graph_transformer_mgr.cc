@@ -26,14 +26,29 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  // a transformer that made no change when it last ran would make no change again if the graph has not been modified
+  // since then, so it is skipped. for each transformer, this is the number of modifications of the graph when it last
+  // ran without making a change, or -1.
+  const size_t num_transformers = transformers->second.size();
+  InlinedVector<int64_t> unchanged_at_modification(num_transformers, -1);
+  int64_t num_modifications = 0;
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
-      if (step > 0 && transformer->ShouldOnlyApplyOnce())
+    for (size_t i = 0; i < num_transformers; ++i) {
+      const auto& transformer = transformers->second[i];
+      if (step > 0 && (transformer->ShouldOnlyApplyOnce() || unchanged_at_modification[i] == num_modifications))
         continue;
 
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
+      if (modified) {
+        ++num_modifications;
+        unchanged_at_modification[i] = -1;
+      } else {
+        unchanged_at_modification[i] = num_modifications;
+      }
+
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
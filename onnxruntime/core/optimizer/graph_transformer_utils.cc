@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <variant>
 
+#include "core/common/string_utils.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
 #include "core/optimizer/nhwc_transformer.h"
@@ -34,7 +35,11 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/embedding_table_quantization.h"
+#include "core/optimizer/gemm_float8_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/free_dim_override_transformer.h"
@@ -44,16 +49,20 @@
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_norm_fusion.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identical_children_consolidation.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/label_encoder_fusion.h"
 #include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/loop_invariant_code_motion.h"
 #include "core/optimizer/matmul_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/memory_aware_node_order.h"
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
@@ -66,14 +75,18 @@
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
 #include "core/optimizer/qdq_transformer/qdq_propagation.h"
 #include "core/optimizer/qdq_transformer/qdq_s8_to_u8.h"
+#include "core/optimizer/qdq_transformer/qlinear_fused_matmul_fusion.h"
 #include "core/optimizer/qdq_transformer/relu_quantizelinear.h"
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rocm_blas_alt_impl.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_propagation.h"
+#include "core/optimizer/tensor_parallel_transformer.h"
 #include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #ifdef ENABLE_TRAINING
@@ -103,6 +116,18 @@ static void FilterTransformers(InlinedVector<std::unique_ptr<GraphTransformer>>&
       transformers.end());
 }
 
+#if !defined(DISABLE_CONTRIB_OPS) && (!defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD))
+// The EPs choose the accuracy level of the MatMulNBits nodes the QDQ transformer creates for them, unless the session
+// sets it.
+static MatMulNBitsFormatsByEp GetQDQMatMulNBitsFormats(const SessionOptions& session_options,
+                                                       const MatMulNBitsFormatsByEp& matmul_nbits_formats) {
+  if (session_options.config_options.GetConfigEntry(kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel).has_value()) {
+    return {};
+  }
+  return matmul_nbits_formats;
+}
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD)
 
 std::string GenerateRuleBasedTransformerName(TransformerLevel level) {
@@ -190,7 +215,8 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
     const IExecutionProvider& cpu_execution_provider, /*required by constant folding*/
     const InlinedHashSet<std::string>& rules_and_transformers_to_disable,
     [[maybe_unused]] concurrency::ThreadPool* intra_op_thread_pool,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+    [[maybe_unused]] const MatMulNBitsFormatsByEp& matmul_nbits_formats) {
   InlinedVector<std::unique_ptr<GraphTransformer>> transformers;
   const bool disable_quant_qdq =
       session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsDisableQuantQDQ, "0") == "1";
@@ -225,15 +251,31 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       for (const auto& p : session_options.initializers_to_share_map) {
         excluded_initializers.insert(p.first);
       }
+      // initializers that are updated after the session is initialized must not be shared or folded
+      InlinedHashSet<std::string> updatable_initializers;
+      const std::string updatable_initializers_string =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUpdatableInitializers, "");
+      for (const auto& name : utils::SplitString(updatable_initializers_string, ",")) {
+        excluded_initializers.emplace(name);
+        updatable_initializers.emplace(name);
+      }
       const InlinedHashSet<std::string_view> no_limit_empty_ep_list = {};
       transformers.emplace_back(std::make_unique<ConstantSharing>(no_limit_empty_ep_list, excluded_initializers));
       transformers.emplace_back(std::make_unique<CommonSubexpressionElimination>());
+      transformers.emplace_back(std::make_unique<LoopInvariantCodeMotion>());
       transformers.emplace_back(std::make_unique<ConstantFolding>(cpu_execution_provider, !disable_quant_qdq,
-                                                                  session_options.config_options));
+                                                                  session_options.config_options,
+                                                                  InlinedHashSet<std::string_view>{},
+                                                                  updatable_initializers,
+                                                                  intra_op_thread_pool));
       transformers.emplace_back(std::make_unique<MatMulAddFusion>());
       transformers.emplace_back(std::make_unique<ReshapeFusion>());
       transformers.emplace_back(std::make_unique<FreeDimensionOverrideTransformer>(
           session_options.free_dimension_overrides));
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableSymbolicShapePropagation,
+                                                            "0") == "1") {
+        transformers.emplace_back(std::make_unique<SymbolicShapePropagation>());
+      }
 
       if (!disable_quant_qdq) {
         transformers.emplace_back(std::make_unique<QDQPropagationTransformer>());
@@ -272,12 +314,28 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                             QDQIsInt8Allowed() ? "1" : "0") == "1";
       const bool enable_gelu_approximation =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGeluApproximation, "0") == "1";
+      const bool enable_elementwise_chain_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseChainFusion,
+                                                            "0") == "1";
+      const int64_t embedding_table_quantization_bits = ParseStringWithClassicLocale<int64_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEmbeddingTableQuantizationBits, "0"));
+      const bool enable_group_query_attention_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGroupQueryAttentionFusion,
+                                                            "0") == "1";
+      [[maybe_unused]] const bool enable_gemm_float8_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGemmFloat8Fusion, "0") == "1";
+      [[maybe_unused]] const int64_t tensor_parallel_size = ParseStringWithClassicLocale<int64_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsTensorParallelSize, "1"));
+      [[maybe_unused]] const int64_t tensor_parallel_rank = ParseStringWithClassicLocale<int64_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsTensorParallelRank, "0"));
 
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_cuda_rocm_eps = {onnxruntime::kCpuExecutionProvider,
                                                                   onnxruntime::kCudaExecutionProvider,
                                                                   onnxruntime::kRocmExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_eps = {onnxruntime::kCpuExecutionProvider,
+                                                             onnxruntime::kCudaExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_cuda_dml_rocm_eps = {onnxruntime::kCpuExecutionProvider,
                                                                       onnxruntime::kCudaExecutionProvider,
                                                                       onnxruntime::kRocmExecutionProvider,
@@ -295,6 +353,16 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                                                onnxruntime::kJsExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_dml_eps = {onnxruntime::kCpuExecutionProvider,
                                                             onnxruntime::kDmlExecutionProvider};
+      // the JS EP implements the fused normalization and gelu kernels, so a single shader runs for each of them
+      const InlinedHashSet<std::string_view> cpu_cuda_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                     onnxruntime::kCudaExecutionProvider,
+                                                                     onnxruntime::kRocmExecutionProvider,
+                                                                     onnxruntime::kJsExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_dml_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                         onnxruntime::kCudaExecutionProvider,
+                                                                         onnxruntime::kRocmExecutionProvider,
+                                                                         onnxruntime::kDmlExecutionProvider,
+                                                                         onnxruntime::kJsExecutionProvider};
       const int64_t qdq_matmulnbits_accuracy_level =
           ParseStringWithClassicLocale<int64_t>(
               session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel,
@@ -312,11 +380,16 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
         if (!qdq_is_int8_allowed) {
           transformers.emplace_back(std::make_unique<QDQS8ToU8Transformer>(avx2_precision_mode, cpu_ep));
         }
+        // Runs before the QDQ selectors, which would convert the MatMul of the chain on its own.
+        transformers.emplace_back(std::make_unique<QLinearFusedMatMulFusion>(cpu_ep));
         transformers.emplace_back(std::make_unique<QDQSelectorActionTransformer>(qdq_is_int8_allowed,
                                                                                  SatApplyContextVariant{},
                                                                                  qdq_matmulnbits_accuracy_level,
                                                                                  intra_op_thread_pool,
-                                                                                 p_buffered_tensors));
+                                                                                 p_buffered_tensors,
+                                                                                 GetQDQMatMulNBitsFormats(
+                                                                                     session_options,
+                                                                                     matmul_nbits_formats)));
       }
 
       transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_ep));
@@ -326,20 +399,32 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_rocm_acl_armnn_js_eps));
 
       transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_eps));
-      transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_eps));
-      transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_js_eps));
+      transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_js_eps));
+      transformers.emplace_back(std::make_unique<GroupNormFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<RotaryEmbeddingFusion>(cpu_cuda_eps));
+      if (enable_group_query_attention_fusion) {
+        transformers.emplace_back(std::make_unique<GroupQueryAttentionFusion>(cpu_cuda_eps));
+      }
       transformers.emplace_back(std::make_unique<EmbedLayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherSliceToSplitFusion>(cpu_cuda_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherToSliceFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(cpu_ep));
+      // Runs after EmbeddingBagFusion, so the pooling of the bags is fused with the dequantization.
+      if (embedding_table_quantization_bits == 8 || embedding_table_quantization_bits == 4 ||
+          embedding_table_quantization_bits == 2) {
+        transformers.emplace_back(std::make_unique<EmbeddingTableQuantization>(
+            embedding_table_quantization_bits, EmbeddingTableQuantization::kDefaultMinElements, cpu_ep));
+      }
 
       transformers.emplace_back(std::make_unique<MatmulTransposeFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<BiasGeluFusion>(cpu_cuda_dml_rocm_eps));
 
-      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_js_eps));
 
-      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_dml_rocm_eps));
-      transformers.emplace_back(std::make_unique<QuickGeluFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_dml_rocm_js_eps));
+      transformers.emplace_back(std::make_unique<QuickGeluFusion>(cpu_cuda_dml_rocm_js_eps));
 
       // GeluApproximation has side effects which may change results. It needs to be manually enabled,
       // or alternatively the model can be updated offline using a model conversion script
@@ -365,6 +450,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 #endif
 
       transformers.emplace_back(std::make_unique<MatMulScaleFusion>(cpu_cuda_dml_rocm_eps));
+#if !defined(DISABLE_FLOAT8_TYPES)
+      if (enable_gemm_float8_fusion) {
+        transformers.emplace_back(std::make_unique<GemmFloat8Fusion>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      }
+#endif
       transformers.emplace_back(std::make_unique<MatMulActivationFusion>(dml_ep));
 
 #ifdef MLAS_TARGET_AMD64_IX86
@@ -377,6 +468,19 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<MatMulNBitsFusion>(cpu_ep));
 #endif  // !defined(ORT_NEURAL_SPEED)
 
+      // Runs after the pattern fusions above, so it only picks up the elementwise nodes that they left.
+      if (enable_elementwise_chain_fusion) {
+        transformers.emplace_back(std::make_unique<ElementwiseChainFusion>(cpu_cuda_eps));
+      }
+
+#if defined(ORT_USE_NCCL)
+      // Runs after the attention and activation fusions, it shards the fused nodes.
+      if (tensor_parallel_size > 1) {
+        transformers.emplace_back(std::make_unique<TensorParallelTransformer>(
+            tensor_parallel_rank, tensor_parallel_size, cuda_rocm_eps));
+      }
+#endif
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
       // The QDQFinalCleanupTransformer must run AFTER other transformers that fuse Q/DQ nodes. Otherwise, their
       // fusions might be prevented if this one removes a Q/DQ node too early.
@@ -388,7 +492,9 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 #ifndef DISABLE_CONTRIB_OPS
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
-        transformers.emplace_back(std::make_unique<NchwcTransformer>());
+        const bool enable_nchwc_layout_cost_model =
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableNchwcLayoutCostModel, "0") == "1";
+        transformers.emplace_back(std::make_unique<NchwcTransformer>(enable_nchwc_layout_cost_model));
       }
 
       auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
@@ -405,6 +511,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
 #endif
 
+      // Runs last, so the order covers the nodes left by all the other transformers.
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableMemoryAwareNodeOrder, "0") == "1") {
+        transformers.emplace_back(std::make_unique<MemoryAwareNodeOrder>());
+      }
     } break;
 
     default:
@@ -427,7 +537,8 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
     const IExecutionProvider& cpu_execution_provider,
     const InlinedHashSet<std::string>& rules_and_transformers_to_disable,
     [[maybe_unused]] concurrency::ThreadPool* intra_op_thread_pool,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+    [[maybe_unused]] const MatMulNBitsFormatsByEp& matmul_nbits_formats) {
   InlinedVector<std::unique_ptr<GraphTransformer>> transformers;
   const bool saving = std::holds_alternative<SatRuntimeOptimizationSaveContext>(apply_context);
 
@@ -453,7 +564,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
                                                                                  apply_context,
                                                                                  qdq_matmulnbits_accuracy_level,
                                                                                  intra_op_thread_pool,
-                                                                                 p_buffered_tensors));
+                                                                                 p_buffered_tensors,
+                                                                                 GetQDQMatMulNBitsFormats(
+                                                                                     session_options,
+                                                                                     matmul_nbits_formats)));
       }
 
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_ep, apply_context));
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_norm_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Whether the input is a constant float initializer of count values that are all equal to value.
+bool IsConstantFilledWith(const Graph& graph, const NodeArg& input_arg, int64_t count, float value) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  Initializer initializer{*tensor_proto, graph.ModelPath()};
+  if (static_cast<int64_t>(initializer.size()) != count) {
+    return false;
+  }
+
+  const auto values = initializer.DataAsSpan<float>();
+  return std::all_of(values.begin(), values.end(), [value](float v) { return v == value; });
+}
+
+// The other input of a Mul or Add of input when it is a constant float initializer with one value per channel of an
+// NCHW tensor, i.e. of shape (C, 1, 1) or (1, C, 1, 1).
+const TensorProto* GetPerChannelInitializer(const Graph& graph, const Node& node, const NodeArg& input,
+                                            int64_t num_channels) {
+  const NodeArg* other_input = node.InputDefs()[0] == &input ? node.InputDefs()[1] : node.InputDefs()[0];
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, other_input->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return nullptr;
+  }
+
+  const auto& dims = tensor_proto->dims();
+  const bool per_channel =
+      (dims.size() == 3 && dims[0] == num_channels && dims[1] == 1 && dims[2] == 1) ||
+      (dims.size() == 4 && dims[0] == 1 && dims[1] == num_channels && dims[2] == 1 && dims[3] == 1);
+  return per_channel ? tensor_proto : nullptr;
+}
+
+// The only consumer of the output of the node, nullptr if there is none or several, or if it runs on another EP.
+Node* GetOnlyChild(Graph& graph, const Node& node, const char* op_type,
+                   std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion> versions) {
+  if (!optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return nullptr;
+  }
+
+  const Node& child = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(child, op_type, versions) ||
+      child.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  return graph.GetNode(child.Index());
+}
+
+}  // namespace
+
+Status GroupNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& instance_norm = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(instance_norm, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(instance_norm, "InstanceNormalization", {1, 6}) ||
+        !graph_utils::IsSupportedProvider(instance_norm, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // Reshape (N, C, H, W) to (N, G, -1)
+    const Node* reshape_in_ptr = graph_utils::GetInputNode(instance_norm, 0);
+    if (reshape_in_ptr == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape_in_ptr, "Reshape", {5, 13, 14, 19, 21}) ||
+        reshape_in_ptr->GetExecutionProviderType() != instance_norm.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, *reshape_in_ptr, 1)) {
+      continue;
+    }
+    Node& reshape_in = *graph.GetNode(reshape_in_ptr->Index());
+
+    NodeArg* input = reshape_in.MutableInputDefs()[0];
+    const TensorShapeProto* input_shape = input->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() != 4 || !utils::HasDimValue(input_shape->dim(1)) ||
+        input->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+    const int64_t num_channels = input_shape->dim(1).dim_value();
+
+    InlinedVector<int64_t> group_shape;
+    if (!optimizer_utils::AppendTensorFromInitializer(graph, *reshape_in.InputDefs()[1], group_shape) ||
+        group_shape.size() != 3 || group_shape[2] != -1) {
+      continue;
+    }
+    const auto* allow_zero = graph_utils::GetNodeAttribute(reshape_in, "allowzero");
+    const bool copies_batch_size = group_shape[0] == 0 && (allow_zero == nullptr || allow_zero->i() == 0);
+    if (!copies_batch_size &&
+        !(utils::HasDimValue(input_shape->dim(0)) && input_shape->dim(0).dim_value() == group_shape[0])) {
+      continue;
+    }
+    const int64_t num_groups = group_shape[1];
+    if (num_groups <= 0 || num_channels % num_groups != 0) {
+      continue;
+    }
+
+    // the InstanceNormalization normalizes each group without an affine transform
+    if (!IsConstantFilledWith(graph, *instance_norm.InputDefs()[1], num_groups, 1.0f) ||
+        !IsConstantFilledWith(graph, *instance_norm.InputDefs()[2], num_groups, 0.0f)) {
+      continue;
+    }
+
+    // Reshape back to (N, C, H, W), with the Shape of the input or the static shape of the input
+    Node* reshape_out = GetOnlyChild(graph, instance_norm, "Reshape", {5, 13, 14, 19, 21});
+    if (reshape_out == nullptr || reshape_out->InputDefs()[0] != instance_norm.OutputDefs()[0]) {
+      continue;
+    }
+    Node* shape_node = nullptr;
+    if (const Node* shape_input = graph_utils::GetInputNode(*reshape_out, 1); shape_input != nullptr) {
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(*shape_input, "Shape", {1, 13, 15, 19, 21}) ||
+          shape_input->InputDefs()[0] != input ||
+          graph_utils::GetNodeAttribute(*shape_input, "start") != nullptr ||
+          graph_utils::GetNodeAttribute(*shape_input, "end") != nullptr) {
+        continue;
+      }
+      shape_node = graph.GetNode(shape_input->Index());
+    } else {
+      InlinedVector<int64_t> output_shape;
+      if (!optimizer_utils::AppendTensorFromInitializer(graph, *reshape_out->InputDefs()[1], output_shape) ||
+          output_shape.size() != 4) {
+        continue;
+      }
+      bool is_input_shape = true;
+      for (int i = 0; i < 4; i++) {
+        is_input_shape = is_input_shape && utils::HasDimValue(input_shape->dim(i)) &&
+                         input_shape->dim(i).dim_value() == output_shape[i];
+      }
+      if (!is_input_shape) {
+        continue;
+      }
+    }
+
+    // Mul by gamma and Add beta, per channel
+    Node* mul = GetOnlyChild(graph, *reshape_out, "Mul", {7, 13, 14});
+    const TensorProto* gamma = mul == nullptr
+                                   ? nullptr
+                                   : GetPerChannelInitializer(graph, *mul, *reshape_out->OutputDefs()[0], num_channels);
+    if (gamma == nullptr) {
+      continue;
+    }
+    Node* add = GetOnlyChild(graph, *mul, "Add", {7, 13, 14});
+    const TensorProto* beta = add == nullptr
+                                  ? nullptr
+                                  : GetPerChannelInitializer(graph, *add, *mul->OutputDefs()[0], num_channels);
+    if (beta == nullptr) {
+      continue;
+    }
+
+    // SiLU: Mul(y, Sigmoid(y))
+    Node* sigmoid = nullptr;
+    Node* swish_mul = nullptr;
+    if (!graph.NodeProducesGraphOutput(*add) && add->GetOutputEdgesCount() == 2) {
+      for (auto it = add->OutputNodesBegin(); it != add->OutputNodesEnd(); ++it) {
+        if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Sigmoid", {6, 13})) {
+          sigmoid = graph.GetNode(it->Index());
+        }
+      }
+      if (sigmoid != nullptr) {
+        swish_mul = GetOnlyChild(graph, *sigmoid, "Mul", {7, 13, 14});
+      }
+      const NodeArg* add_output = add->OutputDefs()[0];
+      if (swish_mul == nullptr || sigmoid->GetExecutionProviderType() != add->GetExecutionProviderType() ||
+          !(swish_mul->InputDefs()[0] == add_output || swish_mul->InputDefs()[1] == add_output)) {
+        sigmoid = nullptr;
+        swish_mul = nullptr;
+      }
+    }
+
+    // the GroupNorm takes gamma and beta of shape (C)
+    auto add_per_channel_initializer = [&](const TensorProto& tensor_proto) -> NodeArg& {
+      TensorProto new_tensor_proto(tensor_proto);
+      new_tensor_proto.clear_dims();
+      new_tensor_proto.add_dims(num_channels);
+      new_tensor_proto.set_name(graph.GenerateNodeArgName("GroupNormFusion_" + tensor_proto.name()));
+      return graph_utils::AddInitializer(graph, new_tensor_proto);
+    };
+    NodeArg& gamma_arg = add_per_channel_initializer(*gamma);
+    NodeArg& beta_arg = add_per_channel_initializer(*beta);
+
+    Node& group_norm = graph.AddNode(graph.GenerateNodeName("GroupNorm"),
+                                     "GroupNorm",
+                                     "fused InstanceNormalization of the groups of channels",
+                                     {input, &gamma_arg, &beta_arg},
+                                     {},
+                                     nullptr,
+                                     kMSDomain);
+    const auto* epsilon = graph_utils::GetNodeAttribute(instance_norm, "epsilon");
+    group_norm.AddAttribute("epsilon", epsilon == nullptr ? 1e-5f : epsilon->f());
+    group_norm.AddAttribute("groups", num_groups);
+    group_norm.AddAttribute("activation", static_cast<int64_t>(swish_mul != nullptr ? 1 : 0));
+    group_norm.AddAttribute("channels_last", static_cast<int64_t>(0));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    group_norm.SetExecutionProviderType(instance_norm.GetExecutionProviderType());
+
+    if (swish_mul != nullptr) {
+      graph_utils::FinalizeNodeFusion(graph,
+                                      {reshape_in, instance_norm, *reshape_out, *mul, *add, *sigmoid, *swish_mul},
+                                      group_norm);
+    } else {
+      graph_utils::FinalizeNodeFusion(graph, {reshape_in, instance_norm, *reshape_out, *mul, *add}, group_norm);
+    }
+
+    // the Shape of the input is dead unless something else reads it
+    if (shape_node != nullptr && shape_node->GetOutputEdgesCount() == 0 &&
+        !graph.NodeProducesGraphOutput(*shape_node)) {
+      graph.RemoveNode(shape_node->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
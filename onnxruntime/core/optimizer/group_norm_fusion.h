@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupNormFusion
+Fuse the group normalization that the exporters decompose into the GroupNorm contrib op in the NCHW layout:
+  Reshape(N, G, -1) -> InstanceNormalization(scale = 1, B = 0) -> Reshape(N, C, H, W) -> Mul(gamma) -> Add(beta)
+The SiLU of the result, Sigmoid and Mul, is fused too.
+*/
+class GroupNormFusion : public GraphTransformer {
+ public:
+  GroupNormFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupNormFusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,526 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_query_attention_fusion.h"
+
+#include <algorithm>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+const Node* GetProducer(const Graph& graph, const NodeArg* arg) {
+  return graph.GetProducerNode(arg->Name());
+}
+
+bool IsTranspose(const Node* node, const std::vector<int64_t>& perm) {
+  return node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Transpose", {1, 13}) &&
+         optimizer_utils::IsAttributeWithExpectedValues(*node, "perm", perm);
+}
+
+bool IsUnsqueezeOnAxis(const Graph& graph, const Node* node, int64_t axis) {
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Unsqueeze", {1, 11, 13})) {
+    return false;
+  }
+  if (node->SinceVersion() < 13) {
+    return optimizer_utils::IsAttributeWithExpectedValues(*node, "axes", {axis});
+  }
+  InlinedVector<int64_t> axes;
+  return node->InputDefs().size() > 1 &&
+         optimizer_utils::AppendTensorFromInitializer(graph, *node->InputDefs()[1], axes, true) &&
+         axes.size() == 1 && axes[0] == axis;
+}
+
+// Reads a constant scalar of any floating point type.
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || !optimizer_utils::IsScalar(arg)) {
+    return false;
+  }
+
+  Initializer initializer(*tensor_proto, graph.ModelPath());
+  switch (initializer.data_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      value = *initializer.data<float>();
+      return true;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      value = initializer.data<MLFloat16>()->ToFloat();
+      return true;
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      value = initializer.data<BFloat16>()->ToFloat();
+      return true;
+    default:
+      return false;
+  }
+}
+
+struct ProjectionMatch {
+  const NodeArg* input = nullptr;  // projection of shape (batch_size, sequence_length, num_heads * head_size)
+  const Node* rotary = nullptr;    // 4D RotaryEmbedding of the query or the key
+  int64_t hidden_size = 0;
+  InlinedVector<const Node*> nodes;
+};
+
+// Matches [RotaryEmbedding](Transpose(Reshape(input), perm=[0, 2, 1, 3])), which splits a projection in heads.
+bool MatchProjection(const Graph& graph, const NodeArg& arg, bool has_rotary, ProjectionMatch& match) {
+  const Node* node = GetProducer(graph, &arg);
+  if (has_rotary) {
+    if (node == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "RotaryEmbedding", {1}, kMSDomain) ||
+        !optimizer_utils::CheckOutputEdges(graph, *node, 1)) {
+      return false;
+    }
+    for (const char* attr_name : {"interleaved", "rotary_embedding_dim", "is_packed_batching"}) {
+      const auto* attr = graph_utils::GetNodeAttribute(*node, attr_name);
+      if (attr != nullptr && attr->i() != 0) {
+        return false;
+      }
+    }
+    match.rotary = node;
+    match.nodes.push_back(node);
+    node = GetProducer(graph, node->InputDefs()[0]);
+  }
+
+  if (!IsTranspose(node, {0, 2, 1, 3}) || !optimizer_utils::CheckOutputEdges(graph, *node, 1)) {
+    return false;
+  }
+  match.nodes.push_back(node);
+
+  const Node* reshape = GetProducer(graph, node->InputDefs()[0]);
+  if (reshape == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5, 13, 14}) ||
+      !optimizer_utils::CheckOutputEdges(graph, *reshape, 1)) {
+    return false;
+  }
+  match.nodes.push_back(reshape);
+
+  match.input = reshape->InputDefs()[0];
+  const auto* shape = match.input->Shape();
+  if (shape == nullptr || shape->dim_size() != 3 || !utils::HasDimValue(shape->dim(2))) {
+    return false;
+  }
+  match.hidden_size = shape->dim(2).dim_value();
+  return true;
+}
+
+// Matches the optional repeat_kv of the keys or the values, Reshape(Expand(Unsqueeze(x, axes=2))), and returns the
+// Concat that appends the new keys or values to the past ones.
+const Node* MatchPastConcat(const Graph& graph, const NodeArg& arg, InlinedVector<const Node*>& nodes) {
+  const Node* node = GetProducer(graph, &arg);
+  if (node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Reshape", {5, 13, 14})) {
+    const Node* expand = GetProducer(graph, node->InputDefs()[0]);
+    if (expand == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*expand, "Expand", {8, 13})) {
+      return nullptr;
+    }
+    const Node* unsqueeze = GetProducer(graph, expand->InputDefs()[0]);
+    if (!IsUnsqueezeOnAxis(graph, unsqueeze, 2)) {
+      return nullptr;
+    }
+    for (const Node* repeat_node : {node, expand, unsqueeze}) {
+      if (!optimizer_utils::CheckOutputEdges(graph, *repeat_node, 1)) {
+        return nullptr;
+      }
+      nodes.push_back(repeat_node);
+    }
+    node = GetProducer(graph, unsqueeze->InputDefs()[0]);
+  }
+
+  // The Concat produces the present key or value, so it may be a graph output but must have no other consumer.
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Concat", {4, 11, 13}) ||
+      node->InputDefs().size() != 2 || node->GetOutputEdgesCount() != 1 ||
+      (!optimizer_utils::IsAttributeWithExpectedValue(*node, "axis", static_cast<int64_t>(2)) &&
+       !optimizer_utils::IsAttributeWithExpectedValue(*node, "axis", static_cast<int64_t>(-2)))) {
+    return nullptr;
+  }
+  return node;
+}
+
+// Finds the 2D int64 attention_mask input of the graph that the additive mask is computed from.
+const NodeArg* FindAttentionMask(const Graph& graph, const NodeArg& mask) {
+  const auto& graph_inputs = graph.GetInputs();
+  InlinedVector<const NodeArg*> candidates;
+  InlinedVector<const NodeArg*> to_visit{&mask};
+  InlinedHashSet<const NodeArg*> visited{&mask};
+  while (!to_visit.empty()) {
+    const NodeArg* arg = to_visit.back();
+    to_visit.pop_back();
+    if (std::find(graph_inputs.begin(), graph_inputs.end(), arg) != graph_inputs.end()) {
+      const auto* shape = arg->Shape();
+      if (arg->Type() != nullptr && *arg->Type() == "tensor(int64)" && shape != nullptr && shape->dim_size() == 2) {
+        candidates.push_back(arg);
+      }
+      continue;
+    }
+
+    const Node* producer = GetProducer(graph, arg);
+    if (producer == nullptr) {
+      continue;
+    }
+    for (const NodeArg* input : producer->InputDefs()) {
+      if (input->Exists() && visited.insert(input).second) {
+        to_visit.push_back(input);
+      }
+    }
+  }
+
+  // The causal mask usually reads the shape of input_ids as well, so prefer the input named after the mask.
+  for (const NodeArg* candidate : candidates) {
+    if (candidate->Name() == "attention_mask") {
+      return candidate;
+    }
+  }
+  return candidates.size() == 1 ? candidates[0] : nullptr;
+}
+
+// The CPU kernel only supports float and the CUDA kernel only supports half precision.
+bool IsSupportedDataType(const std::string& provider, const NodeArg& arg) {
+  if (arg.Type() == nullptr) {
+    return false;
+  }
+  if (provider == kCudaExecutionProvider) {
+    return *arg.Type() == "tensor(float16)" || *arg.Type() == "tensor(bfloat16)";
+  }
+  return *arg.Type() == "tensor(float)";
+}
+
+// Connects the producers of the inputs of a new node, and registers it as the producer of its outputs.
+void ConnectNewNode(Graph& graph, Node& node) {
+  for (size_t i = 0; i < node.InputDefs().size(); i++) {
+    const NodeArg* input = node.InputDefs()[i];
+    const Node* producer = input->Exists() ? GetProducer(graph, input) : nullptr;
+    if (producer != nullptr) {
+      graph.AddEdge(producer->Index(), node.Index(), optimizer_utils::IndexOfNodeOutput(*producer, *input),
+                    static_cast<int>(i));
+    }
+  }
+  for (const NodeArg* output : node.OutputDefs()) {
+    graph.UpdateProducerNode(output->Name(), node.Index());
+  }
+}
+
+NodeArg& AddScalarInitializer(Graph& graph, const std::string& name, ONNX_NAMESPACE::TensorProto_DataType data_type,
+                              int64_t value) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(name));
+  tensor_proto.set_data_type(data_type);
+  if (data_type == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+    tensor_proto.add_int32_data(static_cast<int32_t>(value));
+  } else {
+    tensor_proto.add_int64_data(value);
+  }
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+struct SequenceLengths {
+  NodeArg* seqlens_k;              // number of tokens in each sequence minus one, of shape (batch_size)
+  NodeArg* total_sequence_length;  // scalar
+};
+
+// Adds the nodes computing the seqlens_k and total_sequence_length inputs of GroupQueryAttention from the mask:
+//   seqlens_k = ReduceSum(Cast(mask, int32), axes=[1]) - 1
+//   total_sequence_length = Cast(Gather(Shape(mask), 1), int32)
+SequenceLengths AddSequenceLengths(Graph& graph, NodeArg& mask, const std::string& provider) {
+  ONNX_NAMESPACE::TypeProto int32_type;
+  int32_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+  ONNX_NAMESPACE::TypeProto int64_type;
+  int64_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  auto add_node = [&](const std::string& op_type, const std::vector<NodeArg*>& inputs,
+                      const ONNX_NAMESPACE::TypeProto& output_type) -> Node& {
+    NodeArg& output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(mask.Name() + "_" + op_type), &output_type);
+    Node& node = graph.AddNode(graph.GenerateNodeName("GroupQueryAttentionFusion/" + op_type), op_type,
+                               "sequence lengths for group query attention", inputs, {&output});
+    node.SetExecutionProviderType(provider);
+    ConnectNewNode(graph, node);
+    return node;
+  };
+
+  Node& mask_int32 = add_node("Cast", {&mask}, int32_type);
+  mask_int32.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_INT32));
+
+  // ReduceSum takes the axes as an input since opset 13.
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_opset = domain_to_version.find(kOnnxDomain);
+  const bool axes_as_input = onnx_opset != domain_to_version.end() && onnx_opset->second >= 13;
+  std::vector<NodeArg*> reduce_sum_inputs{mask_int32.MutableOutputDefs()[0]};
+  if (axes_as_input) {
+    ONNX_NAMESPACE::TensorProto axes;
+    axes.set_name(graph.GenerateNodeArgName("seqlens_k_axes"));
+    axes.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    axes.add_dims(1);
+    axes.add_int64_data(1);
+    reduce_sum_inputs.push_back(&graph_utils::AddInitializer(graph, axes));
+  }
+  Node& total_tokens = add_node("ReduceSum", reduce_sum_inputs, int32_type);
+  if (!axes_as_input) {
+    total_tokens.AddAttribute("axes", std::vector<int64_t>{1});
+  }
+  total_tokens.AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  NodeArg& one = AddScalarInitializer(graph, "one", ONNX_NAMESPACE::TensorProto_DataType_INT32, 1);
+  Node& seqlens_k = add_node("Sub", {total_tokens.MutableOutputDefs()[0], &one}, int32_type);
+
+  Node& mask_shape = add_node("Shape", {&mask}, int64_type);
+  NodeArg& sequence_axis = AddScalarInitializer(graph, "sequence_axis", ONNX_NAMESPACE::TensorProto_DataType_INT64, 1);
+  Node& total_length = add_node("Gather", {mask_shape.MutableOutputDefs()[0], &sequence_axis}, int64_type);
+  Node& total_length_int32 = add_node("Cast", {total_length.MutableOutputDefs()[0]}, int32_type);
+  total_length_int32.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_INT32));
+
+  return {seqlens_k.MutableOutputDefs()[0], total_length_int32.MutableOutputDefs()[0]};
+}
+
+// Adds a RotaryEmbedding of the 3D projection with the position ids and caches of the matched 4D RotaryEmbedding.
+NodeArg* AddRotaryEmbedding(Graph& graph, const Node& rotary, const NodeArg& input) {
+  NodeArg& output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(input.Name() + "_rotary"),
+                                             input.TypeAsProto());
+  const auto& rotary_inputs = rotary.InputDefs();
+  Node& node = graph.AddNode(graph.GenerateNodeName(rotary.Name()), "RotaryEmbedding",
+                             "rotary embedding for group query attention",
+                             {const_cast<NodeArg*>(&input), const_cast<NodeArg*>(rotary_inputs[1]),
+                              const_cast<NodeArg*>(rotary_inputs[2]), const_cast<NodeArg*>(rotary_inputs[3])},
+                             {&output}, nullptr, kMSDomain);
+  node.SetExecutionProviderType(rotary.GetExecutionProviderType());
+  ConnectNewNode(graph, node);
+  return &output;
+}
+
+// Removes the nodes that no longer have consumers, as well as their producers that become unused in turn.
+void RemoveUnusedNodes(Graph& graph, InlinedVector<NodeIndex> candidates) {
+  while (!candidates.empty()) {
+    const NodeIndex index = candidates.back();
+    candidates.pop_back();
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || graph.NodeProducesGraphOutput(*node)) {
+      continue;
+    }
+    for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+      candidates.push_back(edge->GetNode().Index());
+    }
+    graph.RemoveNode(index);
+  }
+}
+
+}  // namespace
+
+Status GroupQueryAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashMap<const NodeArg*, SequenceLengths> sequence_lengths;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed
+    }
+
+    Node& softmax = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, softmax, 1)) {
+      continue;
+    }
+    // The scores are 4D, so the softmax must be over the last axis. Before opset 13 the axis defaults to 1.
+    const auto* softmax_axis = graph_utils::GetNodeAttribute(softmax, "axis");
+    if (softmax_axis == nullptr ? softmax.SinceVersion() < 13
+                                : (softmax_axis->i() != -1 && softmax_axis->i() != 3)) {
+      continue;
+    }
+
+    const Node* mask_add = GetProducer(graph, softmax.InputDefs()[0]);
+    if (mask_add == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*mask_add, "Add", {7, 13, 14}) ||
+        !optimizer_utils::CheckOutputEdges(graph, *mask_add, 1)) {
+      continue;
+    }
+
+    // Scores are MatMul(q, k^T) / c or MatMul(q, k^T) * c.
+    const Node* scale_node = nullptr;
+    const NodeArg* mask = nullptr;
+    const NodeArg* qk_output = nullptr;
+    float scale = 0.0f;
+    for (int scores_index = 0; scores_index < 2 && qk_output == nullptr; scores_index++) {
+      scale_node = GetProducer(graph, mask_add->InputDefs()[scores_index]);
+      if (scale_node == nullptr || !optimizer_utils::CheckOutputEdges(graph, *scale_node, 1)) {
+        continue;
+      }
+      mask = mask_add->InputDefs()[1 - scores_index];
+      float value = 0.0f;
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(*scale_node, "Div", {7, 13, 14})) {
+        if (GetScalarConstant(graph, *scale_node->InputDefs()[1], value) && value != 0.0f) {
+          scale = 1.0f / value;
+          qk_output = scale_node->InputDefs()[0];
+        }
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*scale_node, "Mul", {7, 13, 14})) {
+        for (int constant_index = 0; constant_index < 2 && qk_output == nullptr; constant_index++) {
+          if (GetScalarConstant(graph, *scale_node->InputDefs()[constant_index], value)) {
+            scale = value;
+            qk_output = scale_node->InputDefs()[1 - constant_index];
+          }
+        }
+      }
+    }
+    if (qk_output == nullptr) {
+      continue;
+    }
+
+    const Node* qk = GetProducer(graph, qk_output);
+    if (qk == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*qk, "MatMul", {1, 9, 13}) ||
+        !optimizer_utils::CheckOutputEdges(graph, *qk, 1)) {
+      continue;
+    }
+    const Node* k_transpose = GetProducer(graph, qk->InputDefs()[1]);
+    if (!IsTranspose(k_transpose, {0, 1, 3, 2}) || !optimizer_utils::CheckOutputEdges(graph, *k_transpose, 1)) {
+      continue;
+    }
+
+    const Node& pv = *softmax.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(pv, "MatMul", {1, 9, 13}) ||
+        pv.InputDefs()[0] != softmax.OutputDefs()[0] || !optimizer_utils::CheckOutputEdges(graph, pv, 1)) {
+      continue;
+    }
+    const Node& output_transpose = *pv.OutputNodesBegin();
+    if (!IsTranspose(&output_transpose, {0, 2, 1, 3}) ||
+        !optimizer_utils::CheckOutputEdges(graph, output_transpose, 1)) {
+      continue;
+    }
+    const Node& output_reshape = *output_transpose.OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(output_reshape, "Reshape", {5, 13, 14})) {
+      continue;
+    }
+
+    InlinedVector<const Node*> repeat_nodes;
+    const Node* key_concat = MatchPastConcat(graph, *k_transpose->InputDefs()[0], repeat_nodes);
+    const Node* value_concat = MatchPastConcat(graph, *pv.InputDefs()[1], repeat_nodes);
+    if (key_concat == nullptr || value_concat == nullptr) {
+      continue;
+    }
+
+    ProjectionMatch query;
+    ProjectionMatch key;
+    ProjectionMatch value;
+    if (!MatchProjection(graph, *qk->InputDefs()[0], true, query) ||
+        !MatchProjection(graph, *key_concat->InputDefs()[1], true, key) ||
+        !MatchProjection(graph, *value_concat->InputDefs()[1], false, value)) {
+      continue;
+    }
+
+    // The query and the key must be rotated with the same positions, and the caches give the head size.
+    const auto& query_rotary_inputs = query.rotary->InputDefs();
+    const auto& key_rotary_inputs = key.rotary->InputDefs();
+    if (query_rotary_inputs.size() != 4 || key_rotary_inputs.size() != 4 ||
+        query_rotary_inputs[1] != key_rotary_inputs[1] || query_rotary_inputs[2] != key_rotary_inputs[2] ||
+        query_rotary_inputs[3] != key_rotary_inputs[3]) {
+      continue;
+    }
+    const auto* cos_cache = graph_utils::GetConstantInitializer(graph, query_rotary_inputs[2]->Name());
+    if (cos_cache == nullptr || cos_cache->dims_size() != 2) {
+      continue;
+    }
+    const int64_t head_size = cos_cache->dims(1) * 2;
+    if (head_size == 0 || query.hidden_size % head_size != 0 || key.hidden_size % head_size != 0 ||
+        value.hidden_size != key.hidden_size) {
+      continue;
+    }
+    const int64_t num_heads = query.hidden_size / head_size;
+    const int64_t kv_num_heads = key.hidden_size / head_size;
+    if (kv_num_heads == 0 || num_heads % kv_num_heads != 0) {
+      continue;
+    }
+
+    const std::string& provider = softmax.GetExecutionProviderType();
+    if (!IsSupportedDataType(provider, *query.input)) {
+      continue;
+    }
+
+    InlinedVector<const Node*> nodes{&softmax, mask_add, scale_node, qk, k_transpose, key_concat, value_concat,
+                                     &pv, &output_transpose, &output_reshape};
+    nodes.insert(nodes.end(), repeat_nodes.begin(), repeat_nodes.end());
+    for (const ProjectionMatch* projection : {&query, &key, &value}) {
+      nodes.insert(nodes.end(), projection->nodes.begin(), projection->nodes.end());
+    }
+    if (std::any_of(nodes.begin(), nodes.end(),
+                    [&provider](const Node* node) { return node->GetExecutionProviderType() != provider; })) {
+      continue;
+    }
+
+    const NodeArg* attention_mask = FindAttentionMask(graph, *mask);
+    if (attention_mask == nullptr) {
+      continue;
+    }
+
+    auto lengths = sequence_lengths.find(attention_mask);
+    if (lengths == sequence_lengths.end()) {
+      lengths = sequence_lengths.emplace(attention_mask,
+                                         AddSequenceLengths(graph, *const_cast<NodeArg*>(attention_mask), provider))
+                    .first;
+    }
+
+    NodeArg* rotated_query = AddRotaryEmbedding(graph, *query.rotary, *query.input);
+    NodeArg* rotated_key = AddRotaryEmbedding(graph, *key.rotary, *key.input);
+
+    Node& mutable_key_concat = *graph.GetNode(key_concat->Index());
+    Node& mutable_value_concat = *graph.GetNode(value_concat->Index());
+    Node& mutable_output_reshape = *graph.GetNode(output_reshape.Index());
+    Node& gqa = graph.AddNode(graph.GenerateNodeName(softmax.Name() + "/GroupQueryAttentionFusion/"),
+                              "GroupQueryAttention",
+                              "fused group query attention",
+                              {rotated_query,
+                               rotated_key,
+                               const_cast<NodeArg*>(value.input),
+                               mutable_key_concat.MutableInputDefs()[0],
+                               mutable_value_concat.MutableInputDefs()[0],
+                               lengths->second.seqlens_k,
+                               lengths->second.total_sequence_length},
+                              {mutable_output_reshape.MutableOutputDefs()[0],
+                               mutable_key_concat.MutableOutputDefs()[0],
+                               mutable_value_concat.MutableOutputDefs()[0]},
+                              nullptr,
+                              kMSDomain);
+    gqa.AddAttribute("num_heads", num_heads);
+    gqa.AddAttribute("kv_num_heads", kv_num_heads);
+    gqa.AddAttribute("scale", scale);
+    gqa.SetExecutionProviderType(provider);
+    ConnectNewNode(graph, gqa);
+
+    // Move the consumers of the attention output and of the present key and value that are not fused.
+    InlinedHashSet<NodeIndex> fused_nodes;
+    for (const Node* node : nodes) {
+      fused_nodes.insert(node->Index());
+    }
+    int output_index = 0;
+    for (const Node* node : {&output_reshape, key_concat, value_concat}) {
+      for (const auto& edge : graph_utils::GraphEdge::GetNodeOutputEdges(*node)) {
+        if (fused_nodes.count(edge.dst_node) == 0) {
+          graph.AddEdge(gqa.Index(), edge.dst_node, output_index, edge.dst_arg_index);
+        }
+      }
+      output_index++;
+    }
+
+    const Node* mask_producer = GetProducer(graph, mask);
+    const NodeIndex mask_producer_index = mask_producer != nullptr ? mask_producer->Index() : 0;
+    for (NodeIndex index : fused_nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *graph.GetNode(index));
+    }
+    for (NodeIndex index : fused_nodes) {
+      graph.RemoveNode(index);
+    }
+
+    // The causal mask is shared by all the layers, so it is only removed once the last attention is fused.
+    if (mask_producer != nullptr) {
+      RemoveUnusedNodes(graph, {mask_producer_index});
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
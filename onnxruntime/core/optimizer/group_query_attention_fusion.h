@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupQueryAttentionFusion
+
+Rewrite the self attention of decoder models exported from PyTorch (Llama, Mistral, Phi-3 and similar) to the
+GroupQueryAttention contrib operator. It runs after RotaryEmbeddingFusion and matches:
+
+  q = RotaryEmbedding(Transpose(Reshape(q_proj)))
+  k = Concat(past_key, RotaryEmbedding(Transpose(Reshape(k_proj))))        -> present_key
+  v = Concat(past_value, Transpose(Reshape(v_proj)))                        -> present_value
+  Reshape(Transpose(MatMul(Softmax(MatMul(q, Transpose(repeat_kv(k))) / c + mask), repeat_kv(v))))
+
+where repeat_kv is either absent or Reshape(Expand(Unsqueeze(x, axes=2))). The sequence lengths are computed from
+the 2D attention_mask input of the model.
+
+GroupQueryAttention applies a causal mask and treats the mask as the number of valid tokens in each sequence, so the
+fusion is only exact for causal models without padding in the batch, and for either a prompt without past or the
+generation of one token at a time. It is therefore disabled by default, see
+kOrtSessionOptionsEnableGroupQueryAttentionFusion.
+*/
+class GroupQueryAttentionFusion : public GraphTransformer {
+ public:
+  GroupQueryAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupQueryAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer_streaming_transformer.h"
+
+#include <string>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Whether the input of the node is one of the weights its kernels read like any other input.
+bool IsStreamableInput(const Node& node, int input_index) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedMatMul", {1}, kMSDomain)) {
+    return input_index <= 1;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11, 13})) {
+    return input_index <= 2;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "ConvTranspose", {1, 11})) {
+    return input_index == 1 || input_index == 2;
+  }
+  // embedding tables
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    return input_index == 0;
+  }
+  return false;
+}
+
+struct WeightUse {
+  Node* node;
+  int input_index;
+};
+
+// The uses of the weight if all of them can be streamed.
+bool GetStreamableUses(const Graph& graph, const std::string& name,
+                       const InlinedHashSet<std::string_view>& compatible_providers, std::vector<WeightUse>& uses) {
+  for (const Node* consumer : graph.GetConsumerNodes(name)) {
+    if (!graph_utils::IsSupportedProvider(*consumer, compatible_providers)) {
+      return false;
+    }
+    for (const auto* implicit_input : consumer->ImplicitInputDefs()) {
+      if (implicit_input->Name() == name) {
+        return false;
+      }
+    }
+    const auto& inputs = consumer->InputDefs();
+    for (int i = 0, end = static_cast<int>(inputs.size()); i < end; ++i) {
+      if (inputs[i]->Name() != name) {
+        continue;
+      }
+      if (!IsStreamableInput(*consumer, i)) {
+        return false;
+      }
+      uses.push_back({graph.GetNode(consumer->Index()), i});
+    }
+  }
+  return !uses.empty();
+}
+
+}  // namespace
+
+Status InitializerStreamingTransformer::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                                  const logging::Logger& /*logger*/) const {
+  // Collect the weights first, the copies add consumers.
+  std::vector<std::pair<std::string, std::vector<WeightUse>>> streamed_weights;
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    size_t size_in_bytes = 0;
+    if (!graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false) ||
+        !utils::GetSizeInBytesFromTensorProto<0>(*tensor_proto, &size_in_bytes).IsOK() ||
+        size_in_bytes < min_streamed_bytes_ || graph.IsOutput(graph.GetNodeArg(name))) {
+      continue;
+    }
+
+    std::vector<WeightUse> uses;
+    if (GetStreamableUses(graph, name, GetCompatibleExecutionProviders(), uses)) {
+      streamed_weights.emplace_back(name, std::move(uses));
+    }
+  }
+
+  for (const auto& [name, uses] : streamed_weights) {
+    NodeArg& weight_arg = *graph.GetNodeArg(name);
+    for (const auto& use : uses) {
+      Node& consumer = *use.node;
+
+      // The copy is made while the producers of the consumer run.
+      InlinedHashSet<NodeIndex> prefetch_after;
+      for (auto producer = consumer.InputNodesBegin(); producer != consumer.InputNodesEnd(); ++producer) {
+        for (auto it = producer->InputNodesBegin(); it != producer->InputNodesEnd(); ++it) {
+          prefetch_after.insert(it->Index());
+        }
+      }
+
+      NodeArg& copy_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name + "_device"),
+                                                   weight_arg.TypeAsProto());
+      Node& copy = graph.AddNode(graph.GenerateNodeName(name + "_MemcpyFromHost"),
+                                 "MemcpyFromHost",
+                                 "Streams " + name + " to the device of " + consumer.Name(),
+                                 {&weight_arg},
+                                 {&copy_arg});
+      copy.SetExecutionProviderType(consumer.GetExecutionProviderType());
+      // also replaces the input of the consumer
+      graph.AddEdge(copy.Index(), consumer.Index(), 0, use.input_index);
+      for (const auto node_index : prefetch_after) {
+        graph.AddControlEdge(node_index, copy.Index());
+      }
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class InitializerStreamingTransformer
+
+Keep the large weights of the nodes of a device execution provider in host memory and copy them to the device just
+ahead of their use, so that a model larger than the device memory can run (kOrtSessionOptionsStreamInitializersFromHost).
+
+A MemcpyFromHost is inserted between each streamed weight and its consumer. The planner then keeps the weight in the
+pinned memory of the execution provider, and treats its device copy as an intermediate value: the copy is allocated
+when it is made, and freed after its consumer ran.
+The copy waits for the producers of the producers of its consumer, with control edges, so it is made while the
+previous node runs instead of at the start of the run. It overlaps with the computation when the nodes of the device
+are spread over several streams (kOrtSessionOptionsConfigMaxStreamsPerDevice).
+
+Runs after the MemcpyTransformer, on the main graph. Only the weights of MatMul, Gemm, Conv, ConvTranspose and Gather
+are streamed, the kernels of other operators may require constant inputs.
+*/
+class InitializerStreamingTransformer : public GraphTransformer {
+ public:
+  InitializerStreamingTransformer(const InlinedHashSet<std::string_view>& compatible_execution_providers,
+                                  size_t min_streamed_bytes = 1024 * 1024) noexcept
+      : GraphTransformer("InitializerStreamingTransformer", compatible_execution_providers),
+        min_streamed_bytes_(min_streamed_bytes) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  // weights smaller than this stay on the device
+  size_t min_streamed_bytes_;
+};
+
+}  // namespace onnxruntime
@@ -5,7 +5,12 @@
 
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+
 #include "core/common/common.h"
+#include "core/common/logging/logging.h"
 #include "core/optimizer/transpose_optimization/ort_transpose_optimization.h"
 #include "core/optimizer/transpose_optimization/ort_optimizer_utils.h"
 
@@ -94,6 +99,208 @@ bool ConvertNodeLayout(const api::NodeRef& node) {
 
   return layout_sensitive_ops.count(node.OpType()) != 0;
 }
+
+// True if TransformLayoutForEP wraps the node with layout Transposes.
+bool IsLayoutConversionCandidate(const api::GraphRef& graph, const api::NodeRef& node, std::string_view ep_type) {
+  return node.GetExecutionProviderType() == ep_type &&
+         ConvertNodeLayout(node) &&
+         node.GetAttributeIntDefault("channels_last", 0) != 1 &&
+         graph.GetValueInfo(node.Inputs()[0])->Shape().has_value();
+}
+
+// Elementwise ops that the layout Transposes are pushed through, so an NHWC region can grow over them.
+bool IsLayoutTransparentOp(const api::NodeRef& node) {
+  static const std::unordered_set<std::string_view> transparent_ops{
+      "Add", "Cast", "Clip", "Concat", "Div", "Erf", "HardSigmoid", "HardSwish", "Identity",
+      "LeakyRelu", "Max", "Min", "Mul", "Relu", "Sigmoid", "Sub", "Sum", "Tanh"};
+  return node.Domain() == kOnnxDomain && transparent_ops.count(node.OpType()) != 0;
+}
+
+size_t ElementSize(api::DataType dtype) {
+  switch (dtype) {
+    case api::DataType::FLOAT16:
+    case api::DataType::BFLOAT16:
+    case api::DataType::INT16:
+    case api::DataType::UINT16:
+      return 2;
+    case api::DataType::FLOAT:
+    case api::DataType::INT32:
+    case api::DataType::UINT32:
+      return 4;
+    case api::DataType::DOUBLE:
+    case api::DataType::INT64:
+    case api::DataType::UINT64:
+    case api::DataType::COMPLEX64:
+      return 8;
+    case api::DataType::COMPLEX128:
+      return 16;
+    default:
+      return 1;
+  }
+}
+
+// The size of a value in bytes. Symbolic dims count as 1 and a value of unknown rank as empty.
+size_t ValueBytes(const api::GraphRef& graph, std::string_view name) {
+  auto value_info = graph.GetValueInfo(name);
+  auto shape = value_info->Shape();
+  if (!shape.has_value()) {
+    return 0;
+  }
+
+  size_t size = ElementSize(value_info->DType());
+  for (int64_t dim : *shape) {
+    if (dim >= 0) {
+      size *= static_cast<size_t>(dim);
+    }
+  }
+  return size;
+}
+
+// Finds the layout conversion candidates that are not worth converting.
+//
+// The candidates and the transparent ops of the EP are grouped in regions of connected nodes, and a region is
+// converted to NHWC only if it saves more memory traffic than the layout Transposes left at its boundary cost. The
+// saving is that of the Conv nodes: for a float input cuDNN runs its tensor core kernels in NHWC, and converts an NCHW
+// input and output to it and back internally. A Transpose reads and writes its whole input.
+std::unordered_set<int64_t> FindLayoutNodesToSkip(const api::GraphRef& graph,
+                                                  const std::vector<std::unique_ptr<api::NodeRef>>& nodes,
+                                                  std::string_view ep_type) {
+  std::vector<const api::NodeRef*> region_nodes;
+  std::vector<bool> is_candidate;
+  std::unordered_map<int64_t, size_t> node_positions;
+  for (const auto& node : nodes) {
+    const bool candidate = IsLayoutConversionCandidate(graph, *node, ep_type);
+    if (candidate || (node->GetExecutionProviderType() == ep_type && IsLayoutTransparentOp(*node))) {
+      node_positions[node->Id()] = region_nodes.size();
+      region_nodes.push_back(node.get());
+      is_candidate.push_back(candidate);
+    }
+  }
+
+  std::vector<size_t> parents(region_nodes.size());
+  std::iota(parents.begin(), parents.end(), size_t{0});
+  auto find_region = [&parents](size_t i) {
+    while (parents[i] != i) {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  };
+
+  // only the input and output 0 of a layout sensitive op change layout
+  auto layout_inputs = [&](size_t i) {
+    auto inputs = region_nodes[i]->Inputs();
+    inputs.resize(is_candidate[i] ? 1 : inputs.size());
+    return inputs;
+  };
+  auto layout_outputs = [&](size_t i) {
+    auto outputs = region_nodes[i]->Outputs();
+    outputs.resize(is_candidate[i] ? 1 : outputs.size());
+    return outputs;
+  };
+  auto producer_position = [&](std::string_view input) -> std::optional<size_t> {
+    auto producer = graph.GetNodeProducingOutput(input);
+    if (producer == nullptr) {
+      return std::nullopt;
+    }
+    auto it = node_positions.find(producer->Id());
+    return it == node_positions.end() ? std::nullopt : std::optional<size_t>{it->second};
+  };
+
+  for (size_t i = 0; i < region_nodes.size(); ++i) {
+    for (std::string_view input : layout_inputs(i)) {
+      auto producer = input.empty() ? std::nullopt : producer_position(input);
+      if (producer.has_value()) {
+        parents[find_region(i)] = find_region(*producer);
+      }
+    }
+  }
+
+  struct RegionCost {
+    bool has_candidate{false};
+    size_t num_nodes{0};
+    size_t saved_bytes{0};
+    size_t transpose_bytes{0};
+    std::unordered_set<std::string_view> boundary_values;
+  };
+  std::unordered_map<size_t, RegionCost> regions;
+
+  auto is_float = [](api::DataType dtype) {
+    return dtype == api::DataType::FLOAT || dtype == api::DataType::FLOAT16 || dtype == api::DataType::BFLOAT16;
+  };
+
+  for (size_t i = 0; i < region_nodes.size(); ++i) {
+    const api::NodeRef& node = *region_nodes[i];
+    const size_t region = find_region(i);
+    RegionCost& cost = regions[region];
+    ++cost.num_nodes;
+
+    auto add_boundary_value = [&](std::string_view value) {
+      if (cost.boundary_values.insert(value).second) {
+        cost.transpose_bytes += 2 * ValueBytes(graph, value);
+      }
+    };
+
+    const auto inputs = layout_inputs(i);
+    const auto outputs = layout_outputs(i);
+    if (is_candidate[i]) {
+      cost.has_candidate = true;
+      if ((node.OpType() == "Conv" || node.OpType() == "ConvTranspose") &&
+          is_float(graph.GetValueInfo(inputs[0])->DType())) {
+        cost.saved_bytes += 2 * (ValueBytes(graph, inputs[0]) + ValueBytes(graph, outputs[0]));
+      }
+    }
+
+    for (std::string_view input : inputs) {
+      if (input.empty() || graph.GetConstant(input) != nullptr) {
+        continue;
+      }
+
+      auto producer = producer_position(input);
+      if (!producer.has_value() || find_region(*producer) != region) {
+        add_boundary_value(input);
+      }
+    }
+
+    for (std::string_view output : outputs) {
+      if (output.empty()) {
+        continue;
+      }
+
+      auto consumers = graph.GetValueConsumers(output);
+      bool leaves_region = !consumers->comprehensive;
+      for (const auto& consumer : consumers->nodes) {
+        auto it = node_positions.find(consumer->Id());
+        leaves_region = leaves_region || it == node_positions.end() || find_region(it->second) != region;
+      }
+
+      if (leaves_region) {
+        add_boundary_value(output);
+      }
+    }
+  }
+
+  std::unordered_set<int64_t> nodes_to_skip;
+  for (const auto& [region, cost] : regions) {
+    if (!cost.has_candidate) {
+      continue;
+    }
+
+    const bool convert = cost.saved_bytes > cost.transpose_bytes;
+    LOGS_DEFAULT(VERBOSE) << "Layout region of " << cost.num_nodes << " nodes for " << ep_type
+                          << ": saves " << cost.saved_bytes << " bytes, Transposes cost " << cost.transpose_bytes
+                          << " bytes. " << (convert ? "Converting it to NHWC." : "Leaving it in NCHW.");
+    if (!convert) {
+      for (size_t i = 0; i < region_nodes.size(); ++i) {
+        if (is_candidate[i] && find_region(i) == region) {
+          nodes_to_skip.insert(region_nodes[i]->Id());
+        }
+      }
+    }
+  }
+
+  return nodes_to_skip;
+}
 }  // namespace
 
 // Layout sensitive NCHW ops. TransformLayoutForEP will wrap these with Transpose nodes to convert the input
@@ -129,9 +336,14 @@ Status TransformLayoutForEP(Graph& graph, bool& modified, const IExecutionProvid
   // sub graph recurse will be added later
   auto api_graph = MakeApiGraph(graph, cpu_allocator, /*new_node_ep*/ nullptr);
 
+  std::unordered_set<int64_t> nodes_to_skip;
+  if (execution_provider.ConvertLayoutByCost()) {
+    nodes_to_skip = FindLayoutNodesToSkip(*api_graph, api_graph->Nodes(), execution_provider.Type());
+  }
+
   // to convert to NHWC we need to wrap layout sensitive nodes to Transpose from NCHW to NHWC and back.
   for (auto& node : api_graph->Nodes()) {
-    if (node->GetExecutionProviderType() != execution_provider.Type()) {
+    if (node->GetExecutionProviderType() != execution_provider.Type() || nodes_to_skip.count(node->Id()) != 0) {
       continue;
     }
 
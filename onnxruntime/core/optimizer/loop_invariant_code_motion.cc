@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/loop_invariant_code_motion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Whether the value is unchanged across the iterations of the body, given the body values already moved to the
+// parent graph. Constant initializers of the body can be moved as well if their name is free in the parent graph.
+bool IsInvariantInput(Graph& parent_graph, const Graph& body, const NodeArg& input,
+                      const InlinedHashSet<std::string>& hoisted_values) {
+  const auto& name = input.Name();
+  if (hoisted_values.count(name) != 0) {
+    return true;
+  }
+
+  if (body.GetProducerNode(name) != nullptr || graph_utils::IsGraphInput(body, &input)) {
+    return false;
+  }
+
+  if (body.IsInitializedTensor(name)) {
+    return graph_utils::IsConstantInitializer(body, name, false) &&
+           parent_graph.GetNodeArgIncludingParentGraphs(name) == nullptr;
+  }
+
+  return body.IsOuterScopeValue(name);
+}
+
+bool CanHoist(Graph& parent_graph, const Graph& body, const Node& node,
+              const InlinedHashSet<std::string>& hoisted_values) {
+  if (node.ContainsSubgraph() ||
+      node.OpType() == "QuantizeLinear" || node.OpType() == "DequantizeLinear" ||
+      !optimizer_utils::IsOperationDeterministic(node.Domain(), node.OpType())) {
+    return false;
+  }
+
+  for (const NodeArg* output : node.OutputDefs()) {
+    if (output->Exists() &&
+        (body.IsOutput(output) ||
+         parent_graph.GetNodeArgIncludingParentGraphs(output->Name()) != nullptr)) {
+      return false;
+    }
+  }
+
+  for (const NodeArg* input : node.InputDefs()) {
+    if (input->Exists() && !IsInvariantInput(parent_graph, body, *input, hoisted_values)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Whether the trip count and the initial condition of the Loop node are constants that run the body at least once.
+// The hoisted nodes are computed even if the loop doesn't run, and their inputs may only be valid when it does.
+// A missing trip count or condition doesn't stop the loop.
+bool RunsAtLeastOnce(const Graph& graph, const Node& loop_node) {
+  const auto& inputs = loop_node.InputDefs();
+  constexpr bool check_outer_scope = true;
+  if (inputs[0]->Exists()) {
+    const auto* trip_count = graph.GetConstantInitializer(inputs[0]->Name(), check_outer_scope);
+    if (trip_count == nullptr || trip_count->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+      return false;
+    }
+    Initializer value{*trip_count, graph.ModelPath()};
+    if (value.size() != 1 || *value.data<int64_t>() <= 0) {
+      return false;
+    }
+  }
+
+  if (inputs.size() > 1 && inputs[1]->Exists()) {
+    const auto* cond = graph.GetConstantInitializer(inputs[1]->Name(), check_outer_scope);
+    if (cond == nullptr || cond->data_type() != ONNX_NAMESPACE::TensorProto_DataType_BOOL) {
+      return false;
+    }
+    Initializer value{*cond, graph.ModelPath()};
+    if (value.size() != 1 || !*value.data<bool>()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool HoistInvariantNodes(Graph& parent_graph, Graph& body, const Node& loop_node, const logging::Logger& logger) {
+  InlinedHashSet<std::string> hoisted_values;
+  bool modified = false;
+
+  GraphViewer body_viewer(body);
+  for (NodeIndex node_index : body_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = body.GetNode(node_index);
+    if (node == nullptr || !CanHoist(parent_graph, body, *node, hoisted_values)) {
+      continue;
+    }
+
+    InlinedVector<NodeArg*> inputs;
+    inputs.reserve(node->InputDefs().size());
+    for (const NodeArg* input : node->InputDefs()) {
+      const auto& name = input->Name();
+      if (input->Exists() && hoisted_values.count(name) == 0 && body.IsInitializedTensor(name)) {
+        // The remaining consumers in the body read the initializer as an outer scope value from now on.
+        const ONNX_NAMESPACE::TensorProto initializer(*graph_utils::GetConstantInitializer(body, name, false));
+        body.RemoveInitializedTensor(name);
+        graph_utils::AddInitializer(parent_graph, initializer);
+        hoisted_values.insert(name);
+      }
+      inputs.push_back(&parent_graph.GetOrCreateNodeArg(name, input->TypeAsProto()));
+    }
+
+    InlinedVector<NodeArg*> outputs;
+    outputs.reserve(node->OutputDefs().size());
+    for (const NodeArg* output : node->OutputDefs()) {
+      outputs.push_back(&parent_graph.GetOrCreateNodeArg(output->Name(), output->TypeAsProto()));
+      if (output->Exists()) {
+        hoisted_values.insert(output->Name());
+      }
+    }
+
+    Node& hoisted_node = parent_graph.AddNode(parent_graph.GenerateNodeName(node->Name()), node->OpType(),
+                                              node->Description(), inputs, outputs, &node->GetAttributes(),
+                                              node->Domain());
+    hoisted_node.SetExecutionProviderType(node->GetExecutionProviderType());
+
+    LOGS(logger, VERBOSE) << "LoopInvariantCodeMotion: moved " << node->OpType() << " node " << node->Name()
+                          << " out of the body of " << loop_node.OpType() << " node " << loop_node.Name();
+
+    graph_utils::RemoveNodeOutputEdges(body, *node);
+    body.RemoveNode(node_index);
+    modified = true;
+  }
+
+  return modified;
+}
+
+}  // namespace
+
+Status LoopInvariantCodeMotion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    // Process the nested bodies first so their invariant nodes can move further up from this body.
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    const bool is_loop = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Loop", {1, 11, 13, 16, 19, 21});
+    if (!is_loop && !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Scan", {8, 9, 11, 16, 19, 21})) {
+      continue;
+    }
+
+    if (is_loop && !RunsAtLeastOnce(graph, *node)) {
+      continue;
+    }
+
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    Graph* body = node->GetMutableGraphAttribute("body");
+    if (body != nullptr && HoistInvariantNodes(graph, *body, *node, logger)) {
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
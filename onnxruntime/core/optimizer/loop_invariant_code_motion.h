@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LoopInvariantCodeMotion
+
+Move the nodes of a Loop or Scan body that only depend on outer scope values, constant initializers of the body or
+other such nodes to the graph containing the Loop or Scan node, so they are computed once instead of once per
+iteration. Their outputs become outer scope values of the body, i.e. implicit inputs of the Loop or Scan node.
+
+Nodes that produce body outputs, contain subgraphs, are not deterministic or are QuantizeLinear/DequantizeLinear
+(to keep the QDQ node units of the body intact) are not moved. Nested bodies are processed first, so invariant nodes
+move up as many levels as they can.
+
+The moved nodes run even when the body doesn't, so a Loop is only processed if its trip count and initial condition
+are constants that run the body at least once.
+*/
+class LoopInvariantCodeMotion : public GraphTransformer {
+ public:
+  LoopInvariantCodeMotion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LoopInvariantCodeMotion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
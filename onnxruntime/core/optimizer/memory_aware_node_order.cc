@@ -0,0 +1,241 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/memory_aware_node_order.h"
+
+#include <algorithm>
+
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Estimates the size of a tensor from its inferred type and shape. Dims that are not statically known count as 1.
+size_t EstimateSizeInBytes(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED) {
+    return 0;
+  }
+
+  SafeInt<size_t> size = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType()->Size();
+  const auto* shape = arg.Shape();
+  if (shape != nullptr) {
+    for (const auto& dim : shape->dim()) {
+      if (dim.has_dim_value()) {
+        size *= static_cast<size_t>(dim.dim_value());
+      }
+    }
+  }
+  return size;
+}
+
+// The tensors that each node allocates and reads, to estimate the live tensor bytes along an execution order.
+// Graph inputs, initializers and outer scope values are not counted as they are alive during the whole execution.
+class MemoryModel {
+ public:
+  explicit MemoryModel(const Graph& graph) : nodes_(static_cast<size_t>(graph.MaxNodeIndex())) {
+    InlinedHashMap<const NodeArg*, size_t> value_ids;
+    for (const auto& node : graph.Nodes()) {
+      auto& info = nodes_[node.Index()];
+      for (const NodeArg* output : node.OutputDefs()) {
+        if (output->Exists()) {
+          value_ids.emplace(output, values_.size());
+          info.outputs.push_back(values_.size());
+          values_.push_back({EstimateSizeInBytes(*output), 0, graph.IsOutput(output)});
+        }
+      }
+    }
+
+    for (const auto& node : graph.Nodes()) {
+      auto& info = nodes_[node.Index()];
+      auto add_input = [&](const NodeArg* input) {
+        auto value_id = value_ids.find(input);
+        if (value_id != value_ids.end() &&
+            std::find(info.inputs.begin(), info.inputs.end(), value_id->second) == info.inputs.end()) {
+          info.inputs.push_back(value_id->second);
+          values_[value_id->second].num_consumers++;
+        }
+      };
+      for (const NodeArg* input : node.InputDefs()) {
+        add_input(input);
+      }
+      for (const NodeArg* input : node.ImplicitInputDefs()) {
+        add_input(input);
+      }
+    }
+
+    Reset();
+  }
+
+  void Reset() {
+    remaining_consumers_.clear();
+    for (const auto& value : values_) {
+      remaining_consumers_.push_back(value.num_consumers);
+    }
+    live_bytes_ = 0;
+    peak_bytes_ = 0;
+  }
+
+  // Change of the live tensor bytes once the node is executed.
+  int64_t GetDelta(NodeIndex node_index) const {
+    const auto& info = nodes_[node_index];
+    int64_t delta = 0;
+    for (size_t output : info.outputs) {
+      if (values_[output].num_consumers != 0 || values_[output].is_graph_output) {
+        delta += static_cast<int64_t>(values_[output].size);
+      }
+    }
+    for (size_t input : info.inputs) {
+      if (remaining_consumers_[input] == 1 && !values_[input].is_graph_output) {
+        delta -= static_cast<int64_t>(values_[input].size);
+      }
+    }
+    return delta;
+  }
+
+  void Execute(NodeIndex node_index) {
+    const auto& info = nodes_[node_index];
+    for (size_t output : info.outputs) {
+      live_bytes_ += values_[output].size;
+    }
+    peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+
+    for (size_t output : info.outputs) {
+      if (values_[output].num_consumers == 0 && !values_[output].is_graph_output) {
+        live_bytes_ -= values_[output].size;
+      }
+    }
+    for (size_t input : info.inputs) {
+      if (--remaining_consumers_[input] == 0 && !values_[input].is_graph_output) {
+        live_bytes_ -= values_[input].size;
+      }
+    }
+  }
+
+  size_t GetPeakBytes() const { return peak_bytes_; }
+
+ private:
+  struct Value {
+    size_t size;
+    int num_consumers;
+    bool is_graph_output;
+  };
+
+  struct NodeInfo {
+    InlinedVector<size_t> outputs;
+    InlinedVector<size_t> inputs;  // distinct values produced by the nodes of the graph
+  };
+
+  std::vector<Value> values_;
+  std::vector<NodeInfo> nodes_;
+  std::vector<int> remaining_consumers_;
+  size_t live_bytes_ = 0;
+  size_t peak_bytes_ = 0;
+};
+
+size_t EstimatePeakBytes(MemoryModel& model, gsl::span<const NodeIndex> order) {
+  model.Reset();
+  for (NodeIndex node_index : order) {
+    model.Execute(node_index);
+  }
+  return model.GetPeakBytes();
+}
+
+// Builds a topological order that greedily executes the node with the smallest increase of the live tensor bytes
+// among the nodes that are ready, and falls back to the current order to break ties.
+std::vector<NodeIndex> GetMemoryAwareOrder(const Graph& graph, MemoryModel& model,
+                                           gsl::span<const NodeIndex> current_order) {
+  const size_t max_node_index = static_cast<size_t>(graph.MaxNodeIndex());
+  std::vector<size_t> rank(max_node_index);
+  for (size_t i = 0; i < current_order.size(); i++) {
+    rank[current_order[i]] = i;
+  }
+
+  // Control edges are part of the input edges, so they are respected as well.
+  std::vector<size_t> pending_producers(max_node_index);
+  std::vector<InlinedVector<NodeIndex>> consumers(max_node_index);
+  InlinedVector<NodeIndex> ready;
+  for (NodeIndex node_index : current_order) {
+    const Node& node = *graph.GetNode(node_index);
+    InlinedHashSet<NodeIndex> producers;
+    for (auto edge = node.InputEdgesBegin(); edge != node.InputEdgesEnd(); ++edge) {
+      if (producers.insert(edge->GetNode().Index()).second) {
+        consumers[edge->GetNode().Index()].push_back(node_index);
+      }
+    }
+    pending_producers[node_index] = producers.size();
+    if (producers.empty()) {
+      ready.push_back(node_index);
+    }
+  }
+
+  model.Reset();
+  std::vector<NodeIndex> order;
+  order.reserve(current_order.size());
+  while (!ready.empty()) {
+    auto best = std::min_element(ready.begin(), ready.end(), [&](NodeIndex lhs, NodeIndex rhs) {
+      const int64_t lhs_delta = model.GetDelta(lhs);
+      const int64_t rhs_delta = model.GetDelta(rhs);
+      return lhs_delta != rhs_delta ? lhs_delta < rhs_delta : rank[lhs] < rank[rhs];
+    });
+    const NodeIndex node_index = *best;
+    ready.erase(best);
+
+    model.Execute(node_index);
+    order.push_back(node_index);
+    for (NodeIndex consumer : consumers[node_index]) {
+      if (--pending_producers[consumer] == 0) {
+        ready.push_back(consumer);
+      }
+    }
+  }
+
+  return order;
+}
+
+}  // namespace
+
+Status MemoryAwareNodeOrder::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+  bool has_priorities = false;
+  for (auto& node : graph.Nodes()) {
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+    has_priorities = has_priorities || node.Priority() != 0;
+  }
+
+  // The priorities may come from an earlier run of this transformer or encode an order chosen for another purpose,
+  // e.g. recomputation in training.
+  if (has_priorities || graph.NumberOfNodes() < 2) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& current_order = graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED);
+
+  MemoryModel model(graph);
+  const size_t current_peak = EstimatePeakBytes(model, current_order);
+  const std::vector<NodeIndex> order = GetMemoryAwareOrder(graph, model, current_order);
+  ORT_RETURN_IF_NOT(order.size() == current_order.size(), "The graph has a cycle.");
+  const size_t peak = EstimatePeakBytes(model, order);
+
+  LOGS(logger, VERBOSE) << "MemoryAwareNodeOrder: estimated peak of the live tensors in graph " << graph.Name()
+                        << " is " << peak << " bytes, and " << current_peak << " bytes in the current order.";
+  if (peak >= current_peak) {
+    return Status::OK();
+  }
+
+  // Kahn's algorithm with the priority-based order executes the ready node with the lowest priority first, so using
+  // the positions in the order as priorities reproduces it.
+  for (size_t i = 0; i < order.size(); i++) {
+    graph.GetNode(order[i])->SetPriority(static_cast<int>(i));
+  }
+  modified = true;
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
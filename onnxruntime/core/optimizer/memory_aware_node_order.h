@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MemoryAwareNodeOrder
+
+Transformer that chooses the execution order of the nodes to reduce the peak size of the live intermediate tensors,
+e.g. by finishing one branch of a U-Net before starting the next one.
+
+The order is built greedily: among the nodes whose inputs are available, the node that increases the live tensor
+bytes the least is executed first. The tensor sizes come from the inferred shapes, with dims that are not statically
+known counted as 1. The order is recorded in the node priorities, so it is only followed with
+ExecutionOrder::PRIORITY_BASED, and it is only applied if its estimated peak is lower than the one of the current
+priority-based order. Graphs whose nodes already have priorities are left unchanged.
+*/
+class MemoryAwareNodeOrder : public GraphTransformer {
+ public:
+  MemoryAwareNodeOrder() noexcept : GraphTransformer("MemoryAwareNodeOrder") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
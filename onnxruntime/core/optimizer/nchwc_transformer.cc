@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <deque>
+#include <utility>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
@@ -1222,14 +1224,280 @@ void NchwcTransformerImpl::Finalize(bool& modified) {
   }
 }
 
+// Estimates the cost of running each region of connected nodes that the NCHWc
+// transformer can convert in NCHW format and in NCHWc format, including the
+// reorders needed at the boundary of the region, and returns the Conv and
+// pooling nodes of the regions that are cheaper in NCHW format. The remaining
+// nodes of such a region are not converted either as they are only converted
+// when their inputs are already in NCHWc format.
+//
+// Costs are expressed in passes over one float element of memory. The NCHW
+// convolution pays for the im2col buffer that is written and read for each
+// non-pointwise kernel, while NCHWc convolutions read the input directly but
+// compute the channels padded to the block size. A region whose shapes are not
+// all statically known is converted as before.
+class NchwcLayoutPlanner {
+ public:
+  NchwcLayoutPlanner(const Graph& graph) noexcept : graph_(graph) {}
+
+  InlinedHashSet<NodeIndex> PlanNchwNodes(gsl::span<const NodeIndex> node_topology);
+
+ private:
+  // Cost of a multiply-accumulate relative to a memory pass, assuming the FMA
+  // throughput of the SGEMM and NCHWc kernels is about 16 times the L2 bandwidth.
+  static constexpr double kMacCost = 1.0 / 16.0;
+
+  // NCHWc kernels are register blocked over the channel blocks, so compute
+  // bound convolutions also run somewhat faster than the SGEMM path.
+  static constexpr double kNchwcMacEfficiency = 0.8;
+
+  // ReorderInput/ReorderOutput and im2col read and write every element once.
+  static constexpr double kCopyCost = 2.0;
+
+  struct RegionCost {
+    double nchw_cost{0.0};
+    double nchwc_cost{0.0};
+    bool is_known{true};
+    InlinedVector<NodeIndex> seed_nodes;
+    InlinedHashSet<const NodeArg*> reordered_args;
+  };
+
+  static bool IsNchwcCandidate(const Node& node);
+  static bool IsConv(const Node& node);
+  static bool IsPool(const Node& node);
+  static bool GetElementCount(const NodeArg& arg, int64_t& count);
+  bool AddConvCost(const Node& node, RegionCost& cost) const;
+  NodeIndex FindRegion(NodeIndex index);
+
+  const Graph& graph_;
+  InlinedHashMap<NodeIndex, NodeIndex> regions_;
+};
+
+bool NchwcLayoutPlanner::IsConv(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain);
+}
+
+bool NchwcLayoutPlanner::IsPool(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11});
+}
+
+bool NchwcLayoutPlanner::IsNchwcCandidate(const Node& node) {
+  // These are the operators that NchwcTransformerImpl::Transform converts.
+  return node.GetExecutionProviderType() == kCpuExecutionProvider &&
+         (IsConv(node) || IsPool(node) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9, 14}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {9, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10, 11, 13}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1}));
+}
+
+bool NchwcLayoutPlanner::GetElementCount(const NodeArg& arg, int64_t& count) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  count = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return false;
+    }
+    count *= dim.dim_value();
+  }
+  return true;
+}
+
+bool NchwcLayoutPlanner::AddConvCost(const Node& node, RegionCost& cost) const {
+  const auto& input_defs = node.InputDefs();
+  const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      conv_W_tensor_proto->dims_size() != 4) {
+    return false;
+  }
+
+  const auto* output_shape = node.OutputDefs()[0]->Shape();
+  int64_t output_count;
+  if (!GetElementCount(*node.OutputDefs()[0], output_count) || output_shape->dim_size() != 4) {
+    return false;
+  }
+
+  const int64_t output_channels = conv_W_tensor_proto->dims(0);
+  const int64_t input_channels = conv_W_tensor_proto->dims(1);
+  const int64_t kernel_size = conv_W_tensor_proto->dims(2) * conv_W_tensor_proto->dims(3);
+  if (output_channels <= 0 || output_shape->dim(1).dim_value() != output_channels) {
+    return false;
+  }
+
+  int64_t group_count = 1;
+  const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+  if (group_attr != nullptr && utils::HasInt(*group_attr)) {
+    group_count = group_attr->i();
+  }
+
+  const double macs = static_cast<double>(output_count) * static_cast<double>(input_channels * kernel_size);
+
+  // The NCHW convolution uses the input directly for pointwise kernels without
+  // padding or striding and im2col otherwise.
+  bool is_pointwise = kernel_size == 1;
+  const auto* pads_attr = graph_utils::GetNodeAttribute(node, "pads");
+  const auto* strides_attr = graph_utils::GetNodeAttribute(node, "strides");
+  if (pads_attr != nullptr) {
+    is_pointwise = is_pointwise && std::all_of(pads_attr->ints().begin(), pads_attr->ints().end(),
+                                               [](int64_t pad) { return pad == 0; });
+  }
+  if (strides_attr != nullptr) {
+    is_pointwise = is_pointwise && std::all_of(strides_attr->ints().begin(), strides_attr->ints().end(),
+                                               [](int64_t stride) { return stride == 1; });
+  }
+  const double im2col_count = is_pointwise ? 0.0 : macs * static_cast<double>(group_count) / output_channels;
+  cost.nchw_cost += macs * kMacCost + im2col_count * kCopyCost;
+
+  // The NCHWc convolution computes the output channels padded to the block
+  // size, and the input channels too unless the NCHW input is used directly.
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  const auto align = [nchwc_block_size](int64_t channels) {
+    return (channels + nchwc_block_size - 1) / nchwc_block_size * nchwc_block_size;
+  };
+  double nchwc_macs = macs * static_cast<double>(align(output_channels)) / output_channels;
+  if (group_count == 1 && input_channels >= nchwc_block_size) {
+    nchwc_macs = nchwc_macs * static_cast<double>(align(input_channels)) / input_channels;
+  }
+  cost.nchwc_cost += nchwc_macs * kMacCost * kNchwcMacEfficiency;
+  return true;
+}
+
+NodeIndex NchwcLayoutPlanner::FindRegion(NodeIndex index) {
+  NodeIndex root = index;
+  while (regions_[root] != root) {
+    root = regions_[root];
+  }
+  while (regions_[index] != root) {
+    index = std::exchange(regions_[index], root);
+  }
+  return root;
+}
+
+InlinedHashSet<NodeIndex> NchwcLayoutPlanner::PlanNchwNodes(gsl::span<const NodeIndex> node_topology) {
+  // Group the candidate nodes into regions connected by their edges.
+  for (auto index : node_topology) {
+    const Node* node = graph_.GetNode(index);
+    if (node != nullptr && IsNchwcCandidate(*node)) {
+      regions_[index] = index;
+    }
+  }
+  for (auto index : node_topology) {
+    if (regions_.count(index) == 0) {
+      continue;
+    }
+    const Node& node = *graph_.GetNode(index);
+    for (auto it = node.InputNodesBegin(); it != node.InputNodesEnd(); ++it) {
+      if (regions_.count(it->Index()) != 0) {
+        const NodeIndex producer_region = FindRegion(it->Index());
+        regions_[producer_region] = FindRegion(index);
+      }
+    }
+  }
+
+  InlinedHashMap<NodeIndex, RegionCost> region_costs;
+  for (auto index : node_topology) {
+    if (regions_.count(index) == 0) {
+      continue;
+    }
+    const Node& node = *graph_.GetNode(index);
+    const NodeIndex region = FindRegion(index);
+    RegionCost& cost = region_costs[region];
+
+    bool uses_nchw_input = false;
+    if (IsConv(node)) {
+      cost.is_known = AddConvCost(node, cost) && cost.is_known;
+      cost.seed_nodes.push_back(index);
+
+      // A Conv with few input channels reads the NCHW input directly.
+      const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+      const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+      uses_nchw_input = graph_.GetInitializedTensor(node.InputDefs()[1]->Name(), conv_W_tensor_proto) &&
+                        conv_W_tensor_proto->dims_size() == 4 &&
+                        conv_W_tensor_proto->dims(1) < static_cast<int64_t>(MlasNchwcGetBlockSize()) &&
+                        (group_attr == nullptr || !utils::HasInt(*group_attr) || group_attr->i() == 1);
+    } else if (IsPool(node)) {
+      cost.seed_nodes.push_back(index);
+    }
+
+    // Inputs from outside the region are reordered once to NCHWc format.
+    for (size_t i = 0; i < node.InputDefs().size(); i++) {
+      const NodeArg* input_def = node.InputDefs()[i];
+      if (!input_def->Exists() || (i == 0 && uses_nchw_input) || (IsConv(node) && i > 0 && i < 3) ||
+          graph_utils::NodeArgIsConstant(graph_, *input_def) || graph_.IsInitializedTensor(input_def->Name())) {
+        continue;
+      }
+      const Node* producer = graph_.GetProducerNode(input_def->Name());
+      if (producer != nullptr && regions_.count(producer->Index()) != 0 &&
+          FindRegion(producer->Index()) == region) {
+        continue;
+      }
+      int64_t count;
+      if (!GetElementCount(*input_def, count)) {
+        cost.is_known = false;
+      } else if (cost.reordered_args.insert(input_def).second) {
+        cost.nchwc_cost += static_cast<double>(count) * kCopyCost;
+      }
+    }
+
+    // Outputs used outside the region are reordered back to NCHW format.
+    for (const NodeArg* output_def : node.OutputDefs()) {
+      bool is_used_outside = graph_.IsOutput(output_def);
+      for (const Node* consumer : graph_.GetConsumerNodes(output_def->Name())) {
+        is_used_outside = is_used_outside || regions_.count(consumer->Index()) == 0 ||
+                          FindRegion(consumer->Index()) != region;
+      }
+      int64_t count;
+      if (!is_used_outside) {
+        continue;
+      } else if (!GetElementCount(*output_def, count)) {
+        cost.is_known = false;
+      } else {
+        cost.nchwc_cost += static_cast<double>(count) * kCopyCost;
+      }
+    }
+  }
+
+  InlinedHashSet<NodeIndex> nchw_nodes;
+  for (const auto& region_cost : region_costs) {
+    const RegionCost& cost = region_cost.second;
+    if (cost.is_known && cost.nchwc_cost >= cost.nchw_cost) {
+      nchw_nodes.insert(cost.seed_nodes.begin(), cost.seed_nodes.end());
+    }
+  }
+  return nchw_nodes;
+}
+
 Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   NchwcTransformerImpl impl(graph);
   GraphViewer graph_viewer(graph);
+  const auto& node_topology = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashSet<NodeIndex> nchw_nodes;
+  if (enable_layout_cost_model_) {
+    nchw_nodes = NchwcLayoutPlanner(graph).PlanNchwNodes(node_topology);
+    if (!nchw_nodes.empty()) {
+      LOGS(logger, VERBOSE) << "Keeping " << nchw_nodes.size() << " Conv and pooling nodes in NCHW format as "
+                            << "the reorders cost more than NCHWc saves.";
+    }
+  }
 
-  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+  for (auto index : node_topology) {
     auto& node = *graph.GetNode(index);
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
-    if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider && nchw_nodes.count(index) == 0) {
       impl.Transform(node);
     }
   }
@@ -13,13 +13,21 @@ namespace onnxruntime {
 
 Transformer that optimizes the graph by using NCHWc nodes instead of NCHW nodes
 and inserts nodes to reorder tensors as needed.
+
+If enable_layout_cost_model is true, regions of connected nodes that the
+transformer can convert are only converted if the estimated cost of the NCHWc
+nodes and the reorders at the boundary of the region is lower than the cost of
+the NCHW nodes.
 */
 class NchwcTransformer : public GraphTransformer {
  public:
-  NchwcTransformer() noexcept : GraphTransformer("NchwcTransformer") {}
+  explicit NchwcTransformer(bool enable_layout_cost_model = false) noexcept
+      : GraphTransformer("NchwcTransformer"), enable_layout_cost_model_(enable_layout_cost_model) {}
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  bool enable_layout_cost_model_;
 };
 
 }  // namespace onnxruntime
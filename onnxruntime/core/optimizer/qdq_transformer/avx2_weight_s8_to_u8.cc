@@ -24,6 +24,7 @@ static const std::unordered_map<std::string, struct OperatorWeightInfo> s8_overf
     {"MatMulIntegerToFloat", {{1}, kMSDomain, 1, 5}},
     {"DynamicQuantizeMatMul", {{1}, kMSDomain, 1, 3}},
     {"QGemm", {{1}, kMSDomain, 3, 5}},
+    {"QLinearFusedMatMul", {{1}, kMSDomain, 3, 5}},
     {"MatMulInteger", {{10}, kOnnxDomain, 1, 3}},
     {"QLinearMatMul", {{10}, kOnnxDomain, 3, 5}},
     {"QLinearConv", {{10}, kOnnxDomain, 3, 5}},
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer/qlinear_fused_matmul_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/qdq_transformer/qdq_util.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool Is8BitInteger(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+  const auto elem_type = type->tensor_type().elem_type();
+  return elem_type == ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_INT8;
+}
+
+bool IsInt8(const NodeArg& arg) {
+  return arg.TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_INT8;
+}
+
+// Gets the value of the activation attribute of QLinearFusedMatMul for a Relu or an exact Gelu node.
+bool GetFusedActivation(const Node& node, std::string& activation) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14})) {
+    activation = "Relu";
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain)) {
+    activation = "Gelu";
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {20})) {
+    const auto* approximate = graph_utils::GetNodeAttribute(node, "approximate");
+    if (approximate == nullptr || approximate->s() == "none") {
+      activation = "Gelu";
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// The weight must be a constant 2D initializer whose scale and zero point are constant scalars, or are constant 1D
+// tensors of size N quantizing the columns.
+bool IsSupportedWeightDQ(const Graph& graph, const Node& dq_node, const QDQ::GetConstantInitializerFn& get_constant,
+                         int64_t& num_columns) {
+  const auto& input_defs = dq_node.InputDefs();
+  if (input_defs.size() != QDQ::InputIndex::TOTAL_COUNT || !Is8BitInteger(*input_defs[QDQ::InputIndex::INPUT_ID])) {
+    return false;
+  }
+
+  const auto* weight = graph_utils::GetConstantInitializer(graph, input_defs[QDQ::InputIndex::INPUT_ID]->Name());
+  if (weight == nullptr || weight->dims_size() != 2) {
+    return false;
+  }
+  num_columns = weight->dims(1);
+
+  if (QDQ::IsDQSupported(dq_node, get_constant)) {
+    return true;
+  }
+
+  const auto* block_size = graph_utils::GetNodeAttribute(dq_node, "block_size");
+  if (block_size != nullptr && block_size->i() != 0) {
+    return false;
+  }
+  const auto* axis = graph_utils::GetNodeAttribute(dq_node, "axis");
+  if (axis != nullptr && axis->i() != 1 && axis->i() != -1) {
+    return false;
+  }
+
+  for (int input_index : {QDQ::InputIndex::SCALE_ID, QDQ::InputIndex::ZERO_POINT_ID}) {
+    const auto* param = get_constant(input_defs[input_index]->Name());
+    if (param == nullptr || param->dims_size() != 1 || param->dims(0) != num_columns) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool IsSupportedBias(const Graph& graph, const NodeArg& bias, int64_t num_columns) {
+  const auto* bias_tensor = graph_utils::GetConstantInitializer(graph, bias.Name());
+  return bias_tensor != nullptr &&
+         bias_tensor->data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+         bias_tensor->dims_size() == 1 && bias_tensor->dims(0) == num_columns;
+}
+
+}  // namespace
+
+Status QLinearFusedMatMulFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                           const logging::Logger& logger) const {
+  const QDQ::GetConstantInitializerFn get_constant = [&graph](const std::string& name) {
+    return graph_utils::GetConstantInitializer(graph, name);
+  };
+
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;  // node was removed as part of an earlier fusion
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    // Match the chain backwards from the Q node, so the other nodes it consumes are already final.
+    Node& q_node = *node;
+    if (!QDQ::MatchQNode(q_node) || !graph_utils::IsSupportedProvider(q_node, GetCompatibleExecutionProviders()) ||
+        !QDQ::IsDQSupported(q_node, get_constant) ||
+        !Is8BitInteger(*q_node.InputDefs()[QDQ::InputIndex::ZERO_POINT_ID])) {
+      continue;
+    }
+
+    auto get_single_consumer_producer = [&](const Node& consumer, int input_index) -> Node* {
+      const Node* producer = graph_utils::GetInputNode(consumer, input_index);
+      if (producer == nullptr || !optimizer_utils::CheckOutputEdges(graph, *producer, 1) ||
+          producer->GetExecutionProviderType() != q_node.GetExecutionProviderType()) {
+        return nullptr;
+      }
+      return graph.GetNode(producer->Index());
+    };
+
+    Node* next = get_single_consumer_producer(q_node, 0);
+    std::string activation;
+    Node* activation_node = nullptr;
+    if (next != nullptr && GetFusedActivation(*next, activation)) {
+      activation_node = next;
+      next = get_single_consumer_producer(*activation_node, 0);
+    }
+
+    Node* add_node = nullptr;
+    if (next != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*next, "Add", {7, 13, 14})) {
+      add_node = next;
+      // The bias can be either input of the Add.
+      const Node* add_input_0 = graph_utils::GetInputNode(*add_node, 0);
+      const int matmul_input_index = add_input_0 != nullptr && add_input_0->OpType() == "MatMul" ? 0 : 1;
+      next = get_single_consumer_producer(*add_node, matmul_input_index);
+    }
+
+    // DQ -> MatMul -> Q alone is converted to QLinearMatMul by the QDQ selectors.
+    // The float values, and so the scales, must be float as the kernel only supports these.
+    if (next == nullptr || (activation_node == nullptr && add_node == nullptr) ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*next, "MatMul", {1, 9, 13}) ||
+        next->OutputDefs()[0]->TypeAsProto() == nullptr ||
+        next->OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      continue;
+    }
+    Node& matmul_node = *next;
+
+    const Node* dq_a = graph_utils::GetInputNode(matmul_node, 0);
+    const Node* dq_b = graph_utils::GetInputNode(matmul_node, 1);
+    int64_t num_columns = 0;
+    if (dq_a == nullptr || dq_b == nullptr || dq_a == dq_b ||
+        !QDQ::MatchDQNode(*dq_a) || !QDQ::MatchDQNode(*dq_b) ||
+        dq_a->GetExecutionProviderType() != q_node.GetExecutionProviderType() ||
+        dq_b->GetExecutionProviderType() != q_node.GetExecutionProviderType() ||
+        !QDQ::IsDQSupported(*dq_a, get_constant) ||
+        !Is8BitInteger(*dq_a->InputDefs()[QDQ::InputIndex::INPUT_ID]) ||
+        !IsSupportedWeightDQ(graph, *dq_b, get_constant, num_columns)) {
+      continue;
+    }
+
+    // The int8 activation kernel only supports an int8 weight.
+    Node& dq_a_node = *graph.GetNode(dq_a->Index());
+    Node& dq_b_node = *graph.GetNode(dq_b->Index());
+    const auto& dq_a_inputs = dq_a_node.MutableInputDefs();
+    const auto& dq_b_inputs = dq_b_node.MutableInputDefs();
+    if (IsInt8(*dq_a_inputs[QDQ::InputIndex::INPUT_ID]) && !IsInt8(*dq_b_inputs[QDQ::InputIndex::INPUT_ID])) {
+      continue;
+    }
+
+    NodeArg* bias = nullptr;
+    if (add_node != nullptr) {
+      const auto& add_inputs = add_node->MutableInputDefs();
+      bias = add_inputs[0] == matmul_node.OutputDefs()[0] ? add_inputs[1] : add_inputs[0];
+      if (!IsSupportedBias(graph, *bias, num_columns)) {
+        continue;
+      }
+    }
+
+    InlinedVector<NodeArg*> input_defs{
+        dq_a_inputs[QDQ::InputIndex::INPUT_ID],
+        dq_a_inputs[QDQ::InputIndex::SCALE_ID],
+        dq_a_inputs[QDQ::InputIndex::ZERO_POINT_ID],
+        dq_b_inputs[QDQ::InputIndex::INPUT_ID],
+        dq_b_inputs[QDQ::InputIndex::SCALE_ID],
+        dq_b_inputs[QDQ::InputIndex::ZERO_POINT_ID],
+        q_node.MutableInputDefs()[QDQ::InputIndex::SCALE_ID],
+        q_node.MutableInputDefs()[QDQ::InputIndex::ZERO_POINT_ID]};
+    if (bias != nullptr) {
+      input_defs.push_back(bias);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(matmul_node.Name() + "_qlinear_fused"),
+                                     "QLinearFusedMatMul",
+                                     "Fused DQ -> MatMul -> Add -> activation -> Q",
+                                     input_defs,
+                                     q_node.MutableOutputDefs(),
+                                     nullptr,
+                                     kMSDomain);
+    if (!activation.empty()) {
+      fused_node.AddAttribute("activation", activation);
+    }
+    fused_node.SetExecutionProviderType(q_node.GetExecutionProviderType());
+
+    const NodeIndex dq_a_index = dq_a_node.Index();
+    const NodeIndex dq_b_index = dq_b_node.Index();
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_remove{matmul_node};
+    if (add_node != nullptr) {
+      nodes_to_remove.push_back(*add_node);
+    }
+    if (activation_node != nullptr) {
+      nodes_to_remove.push_back(*activation_node);
+    }
+    nodes_to_remove.push_back(q_node);
+    for (Node& node_to_remove : nodes_to_remove) {
+      graph_utils::RemoveNodeOutputEdges(graph, node_to_remove);
+      graph.RemoveNode(node_to_remove.Index());
+    }
+
+    // The DQ nodes may still feed other node units.
+    for (NodeIndex dq_index : {dq_a_index, dq_b_index}) {
+      const Node* dq_node = graph.GetNode(dq_index);
+      if (dq_node != nullptr && dq_node->GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(*dq_node)) {
+        graph.RemoveNode(dq_index);
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QLinearFusedMatMulFusion
+
+Fuse DQ -> MatMul -> [Add] -> [Relu|Gelu] -> Q into a com.microsoft QLinearFusedMatMul node, which runs the MatMul as
+an 8-bit GEMM and applies the bias, the activation and the requantization to the int32 accumulators, instead of the
+float MatMul and elementwise ops that are left between the node units otherwise.
+
+The bias must be a constant float initializer of shape [N]. The scales and zero points of the DQ and Q nodes must be
+constant scalars, except for the ones of a constant 2D weight, which can be per-column. Only chains with a bias or an
+activation are fused, as DQ -> MatMul -> Q is already converted to QLinearMatMul by the QDQ selectors.
+*/
+class QLinearFusedMatMulFusion : public GraphTransformer {
+ public:
+  QLinearFusedMatMulFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QLinearFusedMatMulFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 
@@ -281,8 +282,10 @@ Status MatMulReplaceWithQLinear::Run(Graph& graph, const NodesToOptimize& select
 DQMatMulToMatMulNBitsAction::DQMatMulToMatMulNBitsAction(
     int64_t accuracy_level,
     concurrency::ThreadPool* intra_op_thread_pool,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors)
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+    const MatMulNBitsFormatsByEp& matmul_nbits_formats)
     : accuracy_level_{accuracy_level},
+      matmul_nbits_formats_{matmul_nbits_formats},
       domain_{kMSDomain},
       op_type_{"MatMulNBits"},
       value_moves_{[]() {
@@ -294,6 +297,12 @@ DQMatMulToMatMulNBitsAction::DQMatMulToMatMulNBitsAction(
       intra_op_thread_pool_{intra_op_thread_pool},
       p_buffered_tensors_{p_buffered_tensors} {
   ORT_ENFORCE(accuracy_level_ >= 0 && accuracy_level_ <= 4, "MatMulNBits accuracy level must be between 0 and 4");
+  for (const auto& [ep_type, formats] : matmul_nbits_formats_) {
+    for (const auto& format : formats) {
+      ORT_ENFORCE(format.accuracy_level >= 0 && format.accuracy_level <= 4,
+                  "MatMulNBits accuracy level of ", ep_type, " must be between 0 and 4");
+    }
+  }
 }
 
 NodeAttributes
@@ -306,10 +315,24 @@ DQMatMulToMatMulNBitsAction::ExtraAttributes(const RuntimeState& runtime_state)
 
   utils::SetNodeAttribute(utils::MakeAttribute("K", weight_shape->dim(0).dim_value()), extra_attributes);
   utils::SetNodeAttribute(utils::MakeAttribute("N", weight_shape->dim(1).dim_value()), extra_attributes);
-  utils::SetNodeAttribute(utils::MakeAttribute("accuracy_level", accuracy_level_), extra_attributes);
   // currently only 4bits is supported. In the future, derive bits from DQ's weight type.
-  utils::SetNodeAttribute(utils::MakeAttribute("bits", static_cast<int64_t>(4)), extra_attributes);
-  utils::SetNodeAttribute(utils::MakeAttribute("block_size", attrs.at("block_size").i()), extra_attributes);
+  const int64_t bits = 4;
+  const int64_t block_size = attrs.at("block_size").i();
+
+  int64_t accuracy_level = accuracy_level_;
+  if (auto it = matmul_nbits_formats_.find(runtime_state.selected_nodes.Target().GetExecutionProviderType());
+      it != matmul_nbits_formats_.end()) {
+    auto format = std::find_if(it->second.begin(), it->second.end(), [&](const MatMulNBitsFormat& f) {
+      return f.bits == bits && f.block_size == block_size;
+    });
+    if (format != it->second.end()) {
+      accuracy_level = format->accuracy_level;
+    }
+  }
+
+  utils::SetNodeAttribute(utils::MakeAttribute("accuracy_level", accuracy_level), extra_attributes);
+  utils::SetNodeAttribute(utils::MakeAttribute("bits", bits), extra_attributes);
+  utils::SetNodeAttribute(utils::MakeAttribute("block_size", block_size), extra_attributes);
 
   return extra_attributes;
 }
@@ -10,6 +10,7 @@
 
 #include "core/optimizer/selectors_actions/actions.h"
 #include "core/platform/threadpool.h"
+#include "core/framework/execution_provider.h"
 #include "core/framework/tensor.h"
 
 namespace onnxruntime {
@@ -83,11 +84,14 @@ struct MatMulReplaceWithQLinear : public Action {
   BinaryReplaceWithQLinear qlinear_matmul_replacer_;
 };
 
-// used together with DQMatMulNodeGroupSelector, which does the sanity check
+// used together with DQMatMulNodeGroupSelector, which does the sanity check.
+// The accuracy level of the MatMulNBits node is the one the EP of the node prefers for its format in
+// matmul_nbits_formats, or accuracy_level if the EP has no format for it.
 struct DQMatMulToMatMulNBitsAction : public ReplaceWithNew {
   DQMatMulToMatMulNBitsAction(int64_t accuracy_level,
                               concurrency::ThreadPool* intra_op_thread_pool,
-                              std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors);
+                              std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+                              const MatMulNBitsFormatsByEp& matmul_nbits_formats = {});
 
  private:
   std::string OpType(const RuntimeState&) const override { return op_type_; }
@@ -102,6 +106,7 @@ struct DQMatMulToMatMulNBitsAction : public ReplaceWithNew {
   Status ProcessNewNode(Graph&, const NodesToOptimize&, Node&) const override;
 
   const int64_t accuracy_level_;
+  const MatMulNBitsFormatsByEp matmul_nbits_formats_;
   const std::string domain_;
   const std::string op_type_;
   const std::vector<NodeAndMoveInfo> value_moves_;
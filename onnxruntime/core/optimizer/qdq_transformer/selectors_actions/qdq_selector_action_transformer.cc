@@ -260,7 +260,8 @@ void MatMulQDQRules(SelectorActionRegistry& qdq_selector_action_registry, bool i
 void DQMatMulToMatMulNBitsRules(SelectorActionRegistry& qdq_selector_action_registry,
                                 int64_t qdq_matmulnbits_accuracy_level,
                                 concurrency::ThreadPool* intra_op_thread_pool,
-                                std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors) {
+                                std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+                                const MatMulNBitsFormatsByEp& matmul_nbits_formats) {
   // 2 nodes. DQ -> MatMul. DQ is the second input to MatMul.
   // DQ's weight is int4/uint4. DQ's scale is float/float16.
   // DQ is block-quantized along axis 0, with block_size >= 16 and as 2's power.
@@ -269,7 +270,8 @@ void DQMatMulToMatMulNBitsRules(SelectorActionRegistry& qdq_selector_action_regi
   std::unique_ptr<Action> action =
       std::make_unique<QDQ::DQMatMulToMatMulNBitsAction>(qdq_matmulnbits_accuracy_level,
                                                          intra_op_thread_pool,
-                                                         p_buffered_tensors);
+                                                         p_buffered_tensors,
+                                                         matmul_nbits_formats);
 
 #if !defined(ORT_MINIMAL_BUILD)
   std::unique_ptr<NodeSelector> selector = std::make_unique<QDQ::DQMatMulToMatMulNBitsSelector>();
@@ -330,7 +332,8 @@ SelectorActionRegistry CreateSelectorActionRegistry(
     bool is_int8_allowed,
     int64_t qdq_matmulnbits_accuracy_level,
     concurrency::ThreadPool* intra_op_thread_pool,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+    const MatMulNBitsFormatsByEp& matmul_nbits_formats) {
   SelectorActionRegistry qdq_selector_action_registry;
   SplitQDQRules(qdq_selector_action_registry);
   DropQDQNodesRules(qdq_selector_action_registry);
@@ -345,7 +348,8 @@ SelectorActionRegistry CreateSelectorActionRegistry(
   DQMatMulToMatMulNBitsRules(qdq_selector_action_registry,
                              qdq_matmulnbits_accuracy_level,
                              intra_op_thread_pool,
-                             p_buffered_tensors);
+                             p_buffered_tensors,
+                             matmul_nbits_formats);
 
   return qdq_selector_action_registry;
 }
@@ -357,11 +361,12 @@ QDQSelectorActionTransformer::QDQSelectorActionTransformer(
     const SatApplyContextVariant& apply_context,
     int64_t qdq_matmulnbits_accuracy_level,
     concurrency::ThreadPool* intra_op_thread_pool,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors)
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors,
+    const MatMulNBitsFormatsByEp& matmul_nbits_formats)
     : SelectorActionTransformer{
           "QDQSelectorActionTransformer",
           CreateSelectorActionRegistry(is_int8_allowed, qdq_matmulnbits_accuracy_level,
-                                       intra_op_thread_pool, p_buffered_tensors),
+                                       intra_op_thread_pool, p_buffered_tensors, matmul_nbits_formats),
           apply_context,
           // this transformer is only compatible with the CPU and DML EP
           {kCpuExecutionProvider, kDmlExecutionProvider}} {
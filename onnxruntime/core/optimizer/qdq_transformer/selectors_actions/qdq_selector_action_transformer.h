@@ -7,6 +7,7 @@
 #include <memory>
 #include <unordered_map>
 
+#include "core/framework/execution_provider.h"
 #include "core/optimizer/selectors_actions/selector_action_transformer.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
@@ -23,6 +24,9 @@ inline constexpr bool QDQIsInt8Allowed() {
 
 /**
 Transformer that fuses QDQ and fp32 ops into quantized ops.
+
+The MatMulNBits nodes it creates from DQ -> MatMul use the accuracy level that the EP of the node prefers for the
+format of the weights in matmul_nbits_formats, and qdq_matmulnbits_accuracy_level for the other nodes.
 */
 class QDQSelectorActionTransformer : public SelectorActionTransformer {
  public:
@@ -30,7 +34,8 @@ class QDQSelectorActionTransformer : public SelectorActionTransformer {
                                const SatApplyContextVariant& apply_context = {},
                                int64_t qdq_matmulnbits_accuracy_level = 4,
                                concurrency::ThreadPool* intra_op_thread_pool = nullptr,
-                               std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr);
+                               std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors = nullptr,
+                               const MatMulNBitsFormatsByEp& matmul_nbits_formats = {});
 };
 
 }  // namespace onnxruntime
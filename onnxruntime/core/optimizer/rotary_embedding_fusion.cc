@@ -0,0 +1,367 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/rotary_embedding_fusion.h"
+
+#include <cstring>
+#include <utility>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Reads a constant input holding a single int64 value.
+bool GetSingleConstantValue(const Graph& graph, const NodeArg& arg, int64_t& value) {
+  InlinedVector<int64_t> data;
+  if (!optimizer_utils::AppendTensorFromInitializer(graph, arg, data, true) || data.size() != 1) {
+    return false;
+  }
+  value = data[0];
+  return true;
+}
+
+// Matches a Slice of a 4D tensor along its last axis with constant starts and ends and a unit step.
+bool GetLastAxisSlice(const Graph& graph, const Node& slice, int64_t& start, int64_t& end) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(slice, "Slice", {10, 11, 13})) {
+    return false;
+  }
+
+  const auto& inputs = slice.InputDefs();
+  int64_t axis = 0;
+  if (inputs.size() < 4 || !inputs[3]->Exists() || !GetSingleConstantValue(graph, *inputs[3], axis) ||
+      (axis != -1 && axis != 3)) {
+    return false;
+  }
+
+  int64_t step = 1;
+  if (inputs.size() > 4 && inputs[4]->Exists() && (!GetSingleConstantValue(graph, *inputs[4], step) || step != 1)) {
+    return false;
+  }
+
+  return GetSingleConstantValue(graph, *inputs[1], start) && GetSingleConstantValue(graph, *inputs[2], end);
+}
+
+struct CacheMatch {
+  const Node* unsqueeze;
+  const Node* gather;
+  const Node* slice;  // optional Slice of the first rows of the cache
+  const ONNX_NAMESPACE::TensorProto* cache;
+  const NodeArg* position_ids;
+};
+
+// Matches Unsqueeze(Gather(cache, position_ids), axes=1), where cache is a constant 2D initializer of shape
+// (max_sequence_length, head_size), optionally sliced to its first rows before the Gather.
+bool MatchCache(const Graph& graph, const NodeArg& arg, CacheMatch& match) {
+  const Node* unsqueeze = graph.GetProducerNode(arg.Name());
+  if (unsqueeze == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*unsqueeze, "Unsqueeze", {1, 11, 13})) {
+    return false;
+  }
+  if (unsqueeze->SinceVersion() < 13) {
+    if (!optimizer_utils::IsAttributeWithExpectedValues(*unsqueeze, "axes", {1})) {
+      return false;
+    }
+  } else {
+    int64_t axis = 0;
+    if (unsqueeze->InputDefs().size() < 2 || !GetSingleConstantValue(graph, *unsqueeze->InputDefs()[1], axis) ||
+        axis != 1) {
+      return false;
+    }
+  }
+
+  const Node* gather = graph.GetProducerNode(unsqueeze->InputDefs()[0]->Name());
+  if (gather == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*gather, "Gather", {1, 11, 13})) {
+    return false;
+  }
+  const auto* axis_attr = graph_utils::GetNodeAttribute(*gather, "axis");
+  if (axis_attr != nullptr && axis_attr->i() != 0) {
+    return false;
+  }
+  const NodeArg* position_ids = gather->InputDefs()[1];
+  if (position_ids->Type() == nullptr || *position_ids->Type() != "tensor(int64)") {
+    return false;
+  }
+
+  // Slicing cache[:n] before gathering the positions selects the same rows as gathering from the full cache.
+  const NodeArg* data = gather->InputDefs()[0];
+  const Node* slice = graph.GetProducerNode(data->Name());
+  if (slice != nullptr) {
+    int64_t start = 0;
+    int64_t axis = 0;
+    int64_t step = 1;
+    const auto& slice_inputs = slice->InputDefs();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(*slice, "Slice", {10, 11, 13}) ||
+        slice_inputs.size() < 4 || !slice_inputs[3]->Exists() ||
+        !GetSingleConstantValue(graph, *slice_inputs[1], start) || start != 0 ||
+        !GetSingleConstantValue(graph, *slice_inputs[3], axis) || axis != 0 ||
+        (slice_inputs.size() > 4 && slice_inputs[4]->Exists() &&
+         (!GetSingleConstantValue(graph, *slice_inputs[4], step) || step != 1))) {
+      return false;
+    }
+    data = slice_inputs[0];
+  }
+
+  const auto* cache = graph_utils::GetConstantInitializer(graph, data->Name());
+  if (cache == nullptr || cache->dims_size() != 2 || cache->dims(0) == 0 || cache->dims(1) % 2 != 0) {
+    return false;
+  }
+
+  match = {unsqueeze, gather, slice, cache, position_ids};
+  return true;
+}
+
+// Matches rotate_half(x) = Concat(Neg(Slice(x, half:)), Slice(x, :half)) along the last axis, and returns x.
+const NodeArg* MatchRotateHalf(const Graph& graph, const Node& concat, int64_t head_size,
+                               InlinedVector<const Node*>& nodes) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(concat, "Concat", {4, 11, 13}) ||
+      concat.InputDefs().size() != 2 ||
+      (!optimizer_utils::IsAttributeWithExpectedValue(concat, "axis", static_cast<int64_t>(-1)) &&
+       !optimizer_utils::IsAttributeWithExpectedValue(concat, "axis", static_cast<int64_t>(3)))) {
+    return nullptr;
+  }
+
+  const Node* neg = graph.GetProducerNode(concat.InputDefs()[0]->Name());
+  const Node* second_half = graph.GetProducerNode(concat.InputDefs()[1]->Name());
+  if (neg == nullptr || second_half == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*neg, "Neg", {6, 13})) {
+    return nullptr;
+  }
+  const Node* first_half = graph.GetProducerNode(neg->InputDefs()[0]->Name());
+  if (first_half == nullptr) {
+    return nullptr;
+  }
+
+  const int64_t half = head_size / 2;
+  int64_t start = 0;
+  int64_t end = 0;
+  if (!GetLastAxisSlice(graph, *first_half, start, end) || start != half || end < head_size) {
+    return nullptr;
+  }
+  if (!GetLastAxisSlice(graph, *second_half, start, end) || start != 0 || end != half) {
+    return nullptr;
+  }
+
+  const NodeArg* x = first_half->InputDefs()[0];
+  if (second_half->InputDefs()[0] != x) {
+    return nullptr;
+  }
+
+  for (const Node* node : {&concat, neg, first_half, second_half}) {
+    if (!optimizer_utils::CheckOutputEdges(graph, *node, 1)) {
+      return nullptr;
+    }
+    nodes.push_back(node);
+  }
+  return x;
+}
+
+// Returns whether both halves of each row of the cache hold the same values.
+bool HasRepeatedHalves(const Initializer& cache) {
+  const auto bytes = cache.DataAsByteSpan();
+  const size_t rows = narrow<size_t>(cache.dims()[0]);
+  const size_t half_row_bytes = bytes.size() / rows / 2;
+  for (size_t row = 0; row < rows; row++) {
+    const uint8_t* data = bytes.data() + row * half_row_bytes * 2;
+    if (std::memcmp(data, data + half_row_bytes, half_row_bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Adds the first half of each row of the cache as a new initializer, or returns the one added for an earlier match.
+NodeArg& GetOrAddHalfCache(Graph& graph, const ONNX_NAMESPACE::TensorProto& cache,
+                           InlinedHashMap<std::string, NodeArg*>& half_caches) {
+  auto it = half_caches.find(cache.name());
+  if (it != half_caches.end()) {
+    return *it->second;
+  }
+
+  Initializer initializer(cache, graph.ModelPath());
+  const auto bytes = initializer.DataAsByteSpan();
+  const size_t rows = narrow<size_t>(cache.dims(0));
+  const size_t half_row_bytes = bytes.size() / rows / 2;
+  std::vector<uint8_t> half(rows * half_row_bytes);
+  for (size_t row = 0; row < rows; row++) {
+    std::memcpy(half.data() + row * half_row_bytes, bytes.data() + row * half_row_bytes * 2, half_row_bytes);
+  }
+
+  ONNX_NAMESPACE::TensorProto half_cache;
+  half_cache.set_name(graph.GenerateNodeArgName(cache.name() + "_half"));
+  half_cache.set_data_type(cache.data_type());
+  half_cache.add_dims(cache.dims(0));
+  half_cache.add_dims(cache.dims(1) / 2);
+  utils::SetRawDataInTensorProto(half_cache, half.data(), half.size());
+
+  NodeArg& half_cache_arg = graph_utils::AddInitializer(graph, half_cache);
+  half_caches.emplace(cache.name(), &half_cache_arg);
+  return half_cache_arg;
+}
+
+// Returns whether two dims are known to be equal.
+bool IsSameDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& a,
+               const ONNX_NAMESPACE::TensorShapeProto_Dimension& b) {
+  if (utils::HasDimValue(a) && utils::HasDimValue(b)) {
+    return a.dim_value() == b.dim_value();
+  }
+  return utils::HasDimParam(a) && utils::HasDimParam(b) && a.dim_param() == b.dim_param();
+}
+
+// The lookups broadcast against x, while RotaryEmbedding reads position_ids of shape (batch_size, sequence_length)
+// and a single position as the offset of the first token, so position_ids must have exactly the dims of x.
+bool HasPositionIdsOfX(const NodeArg& position_ids, const ONNX_NAMESPACE::TensorShapeProto& x_shape) {
+  const auto* shape = position_ids.Shape();
+  return shape != nullptr && shape->dim_size() == 2 && IsSameDim(shape->dim(0), x_shape.dim(0)) &&
+         IsSameDim(shape->dim(1), x_shape.dim(2));
+}
+
+// The CPU kernel only supports float.
+bool IsSupportedDataType(const Node& node, const NodeArg& x) {
+  if (x.Type() == nullptr) {
+    return false;
+  }
+  if (node.GetExecutionProviderType() == kCudaExecutionProvider) {
+    return *x.Type() == "tensor(float)" || *x.Type() == "tensor(float16)" || *x.Type() == "tensor(bfloat16)";
+  }
+  return *x.Type() == "tensor(float)";
+}
+
+// Removes the nodes that no longer have consumers, as well as their producers that become unused in turn.
+void RemoveUnusedNodes(Graph& graph, InlinedVector<NodeIndex> candidates) {
+  while (!candidates.empty()) {
+    const NodeIndex index = candidates.back();
+    candidates.pop_back();
+    Node* node = graph.GetNode(index);
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || graph.NodeProducesGraphOutput(*node)) {
+      continue;
+    }
+    for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+      candidates.push_back(edge->GetNode().Index());
+    }
+    graph.RemoveNode(index);
+  }
+}
+
+}  // namespace
+
+Status RotaryEmbeddingFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashMap<std::string, NodeArg*> half_caches;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) {
+      continue;  // node was removed
+    }
+
+    Node& add = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(add, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add, "Add", {7, 13, 14}) ||
+        !graph_utils::IsSupportedProvider(add, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* mul_0 = graph.GetProducerNode(add.InputDefs()[0]->Name());
+    const Node* mul_1 = graph.GetProducerNode(add.InputDefs()[1]->Name());
+    if (mul_0 == nullptr || mul_1 == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*mul_0, "Mul", {7, 13, 14}) ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*mul_1, "Mul", {7, 13, 14}) ||
+        !optimizer_utils::CheckOutputEdges(graph, *mul_0, 1) || !optimizer_utils::CheckOutputEdges(graph, *mul_1, 1)) {
+      continue;
+    }
+
+    // Look for x * cos in one Mul and rotate_half(x) * sin in the other, with the operands in either order.
+    const NodeArg* x = nullptr;
+    CacheMatch cos{};
+    CacheMatch sin{};
+    InlinedVector<const Node*> rotate_half_nodes;
+    for (const auto& [cos_mul, sin_mul] : {std::make_pair(mul_0, mul_1), std::make_pair(mul_1, mul_0)}) {
+      for (size_t cos_index = 0; cos_index < 2 && x == nullptr; cos_index++) {
+        if (!MatchCache(graph, *cos_mul->InputDefs()[cos_index], cos)) {
+          continue;
+        }
+        for (size_t sin_index = 0; sin_index < 2 && x == nullptr; sin_index++) {
+          const Node* concat = graph.GetProducerNode(sin_mul->InputDefs()[1 - sin_index]->Name());
+          if (concat == nullptr || !MatchCache(graph, *sin_mul->InputDefs()[sin_index], sin) ||
+              sin.position_ids != cos.position_ids || sin.cache->dims(1) != cos.cache->dims(1)) {
+            continue;
+          }
+          rotate_half_nodes.clear();
+          const NodeArg* rotated = MatchRotateHalf(graph, *concat, cos.cache->dims(1), rotate_half_nodes);
+          if (rotated != nullptr && rotated == cos_mul->InputDefs()[1 - cos_index]) {
+            x = rotated;
+          }
+        }
+      }
+      if (x != nullptr) {
+        break;
+      }
+    }
+    if (x == nullptr) {
+      continue;
+    }
+
+    const int64_t head_size = cos.cache->dims(1);
+    const auto* x_shape = x->Shape();
+    if (x_shape == nullptr || x_shape->dim_size() != 4 ||
+        (utils::HasDimValue(x_shape->dim(3)) && x_shape->dim(3).dim_value() != head_size) ||
+        !HasPositionIdsOfX(*cos.position_ids, *x_shape) || !IsSupportedDataType(add, *x)) {
+      continue;
+    }
+
+    if (!HasRepeatedHalves(Initializer(*cos.cache, graph.ModelPath())) ||
+        !HasRepeatedHalves(Initializer(*sin.cache, graph.ModelPath()))) {
+      continue;
+    }
+
+    NodeArg& cos_half = GetOrAddHalfCache(graph, *cos.cache, half_caches);
+    NodeArg& sin_half = GetOrAddHalfCache(graph, *sin.cache, half_caches);
+
+    Node& rotary = graph.AddNode(graph.GenerateNodeName(add.Name() + "/RotaryEmbeddingFusion/"),
+                                 "RotaryEmbedding",
+                                 "fused rotary embedding",
+                                 {const_cast<NodeArg*>(x), const_cast<NodeArg*>(cos.position_ids), &cos_half,
+                                  &sin_half},
+                                 add.MutableOutputDefs(),
+                                 nullptr,
+                                 kMSDomain);
+    rotary.SetExecutionProviderType(add.GetExecutionProviderType());
+
+    for (int i = 0; i < 2; i++) {
+      const NodeArg* input = rotary.InputDefs()[i];
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if (producer != nullptr) {
+        graph.AddEdge(producer->Index(), rotary.Index(), optimizer_utils::IndexOfNodeOutput(*producer, *input), i);
+      }
+    }
+    for (const auto& edge : graph_utils::GraphEdge::GetNodeOutputEdges(add)) {
+      graph.AddEdge(rotary.Index(), edge.dst_node, 0, edge.dst_arg_index);
+    }
+
+    InlinedVector<NodeIndex> nodes_to_remove{add.Index(), mul_0->Index(), mul_1->Index()};
+    for (const Node* node : rotate_half_nodes) {
+      nodes_to_remove.push_back(node->Index());
+    }
+    for (NodeIndex index : nodes_to_remove) {
+      Node* node = graph.GetNode(index);
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(index);
+    }
+
+    // The cos and sin lookups are usually shared by the query and the key, so they are only removed once unused.
+    RemoveUnusedNodes(graph, {cos.unsqueeze->Index(), sin.unsqueeze->Index()});
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
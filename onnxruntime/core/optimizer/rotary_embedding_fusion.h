@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class RotaryEmbeddingFusion
+
+Rewrite the rotary position embedding of decoder models exported from PyTorch, a.k.a. Llama style RoPE, to the
+RotaryEmbedding contrib operator:
+
+  x * Unsqueeze(Gather(cos_cache, position_ids)) + rotate_half(x) * Unsqueeze(Gather(sin_cache, position_ids))
+
+where rotate_half(x) is Concat(Neg(Slice(x, half:)), Slice(x, :half)) along the head dimension and x has the shape
+(batch_size, num_heads, sequence_length, head_size). The caches are constant initializers that repeat the same
+frequencies in both halves of the head, and are replaced by their first halves.
+*/
+class RotaryEmbeddingFusion : public GraphTransformer {
+ public:
+  RotaryEmbeddingFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("RotaryEmbeddingFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/symbolic_shape_propagation.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "core/framework/symbolic_dim_expr.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+using DimExprs = InlinedVector<std::optional<SymbolicDimExpr>>;
+
+// Expressions of the dims of the value. std::nullopt if its rank is unknown.
+std::optional<DimExprs> GetDimExprs(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return std::nullopt;
+  }
+
+  DimExprs dims;
+  for (const auto& dim : arg->Shape()->dim()) {
+    dims.push_back(SymbolicDimExpr::FromDim(dim));
+  }
+  return dims;
+}
+
+bool GetConstantInput(const Graph& graph, const Node& node, size_t input_index, InlinedVector<int64_t>& values) {
+  const auto& input_defs = node.InputDefs();
+  return input_index < input_defs.size() && input_defs[input_index]->Exists() &&
+         optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[input_index], values);
+}
+
+bool HasInput(const Node& node, size_t input_index) {
+  return input_index < node.InputDefs().size() && node.InputDefs()[input_index]->Exists();
+}
+
+std::optional<int64_t> NormalizeAxis(int64_t axis, size_t rank) {
+  const int64_t signed_rank = static_cast<int64_t>(rank);
+  if (axis < -signed_rank || axis >= signed_rank) {
+    return std::nullopt;
+  }
+  return axis < 0 ? axis + signed_rank : axis;
+}
+
+std::optional<DimExprs> InferConcat(const Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  const auto input = GetDimExprs(node.InputDefs()[0]);
+  if (axis_attr == nullptr || !input.has_value()) {
+    return std::nullopt;
+  }
+  const auto axis = NormalizeAxis(axis_attr->i(), input->size());
+  if (!axis.has_value()) {
+    return std::nullopt;
+  }
+
+  DimExprs output(input->size());
+  SymbolicDimExpr sum;
+  for (const NodeArg* input_def : node.InputDefs()) {
+    const auto dims = GetDimExprs(input_def);
+    if (!dims.has_value() || dims->size() != input->size() || !(*dims)[*axis].has_value()) {
+      return std::nullopt;
+    }
+    sum += *(*dims)[*axis];
+  }
+  output[*axis] = sum;
+  return output;
+}
+
+std::optional<DimExprs> InferPad(const Graph& graph, const Node& node) {
+  InlinedVector<int64_t> pads;
+  if (node.SinceVersion() < 11) {
+    const auto* pads_attr = graph_utils::GetNodeAttribute(node, "pads");
+    if (pads_attr == nullptr) {
+      return std::nullopt;
+    }
+    pads.assign(pads_attr->ints().begin(), pads_attr->ints().end());
+  } else if (HasInput(node, 3) || !GetConstantInput(graph, node, 1, pads)) {
+    return std::nullopt;  // pads of a subset of the axes are not handled
+  }
+
+  auto output = GetDimExprs(node.InputDefs()[0]);
+  if (!output.has_value() || pads.size() != 2 * output->size()) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < output->size(); i++) {
+    if ((*output)[i].has_value()) {
+      *(*output)[i] += SymbolicDimExpr(pads[i] + pads[i + output->size()]);
+    }
+  }
+  return output;
+}
+
+std::optional<DimExprs> InferSlice(const Graph& graph, const Node& node) {
+  InlinedVector<int64_t> starts, ends, axes, steps;
+  auto output = GetDimExprs(node.InputDefs()[0]);
+  if (!output.has_value() || !GetConstantInput(graph, node, 1, starts) || !GetConstantInput(graph, node, 2, ends) ||
+      starts.size() != ends.size() ||
+      (HasInput(node, 3) && !GetConstantInput(graph, node, 3, axes)) ||
+      (HasInput(node, 4) && !GetConstantInput(graph, node, 4, steps)) ||
+      (!axes.empty() && axes.size() != starts.size())) {
+    return std::nullopt;
+  }
+
+  for (size_t i = 0; i < starts.size(); i++) {
+    const auto axis = NormalizeAxis(axes.empty() ? static_cast<int64_t>(i) : axes[i], output->size());
+    if (!axis.has_value()) {
+      return std::nullopt;
+    }
+
+    auto& dim = (*output)[*axis];
+    const int64_t start = starts[i];
+    const int64_t end = ends[i];
+    // INT_MAX or INT64_MAX are used for slicing to the end of the dim.
+    const bool to_end = end >= std::numeric_limits<int32_t>::max();
+    const bool is_step_one = steps.empty() || (steps.size() == starts.size() && steps[i] == 1);
+    if (!dim.has_value() || dim->IsConstant() || !is_step_one) {
+      dim.reset();  // shape inference handles the dims with a value
+    } else if (start >= 0 && to_end) {
+      *dim -= SymbolicDimExpr(start);
+    } else if (start >= 0 && end < 0) {
+      *dim += SymbolicDimExpr(end - start);
+    } else if (start < 0 && to_end) {
+      dim = SymbolicDimExpr(-start);
+    } else if (start < 0 && end < 0) {
+      dim = SymbolicDimExpr(std::max<int64_t>(end - start, 0));
+    } else {
+      dim.reset();
+    }
+  }
+  return output;
+}
+
+std::optional<DimExprs> InferReshape(const Graph& graph, const Node& node) {
+  InlinedVector<int64_t> shape;
+  const auto input = GetDimExprs(node.InputDefs()[0]);
+  if (!input.has_value() || !GetConstantInput(graph, node, 1, shape)) {
+    return std::nullopt;
+  }
+  const auto* allow_zero = graph_utils::GetNodeAttribute(node, "allowzero");
+  const bool copy_zero_dims = allow_zero == nullptr || allow_zero->i() == 0;
+
+  // The size of the -1 dim is the number of elements of the input divided by the other dims of the output. It is
+  // affine if the symbolic dims of the input that are not copied to the output are at most one affine expression.
+  DimExprs output(shape.size());
+  InlinedVector<SymbolicDimExpr> symbolic_input_dims;
+  int64_t constant_input_size = 1;
+  for (const auto& dim : *input) {
+    if (!dim.has_value()) {
+      return std::nullopt;
+    }
+    if (dim->IsConstant()) {
+      constant_input_size *= dim->Constant();
+    } else {
+      symbolic_input_dims.push_back(*dim);
+    }
+  }
+
+  std::optional<size_t> inferred_dim;
+  int64_t constant_output_size = 1;
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (shape[i] == -1) {
+      inferred_dim = i;
+      continue;
+    }
+    if (shape[i] == 0 && copy_zero_dims) {
+      if (i >= input->size()) {
+        return std::nullopt;
+      }
+      output[i] = (*input)[i];
+    } else {
+      output[i] = SymbolicDimExpr(shape[i]);
+    }
+
+    if (output[i]->IsConstant()) {
+      constant_output_size *= output[i]->Constant();
+    } else {
+      auto match = std::find(symbolic_input_dims.begin(), symbolic_input_dims.end(), *output[i]);
+      if (match == symbolic_input_dims.end()) {
+        return std::nullopt;
+      }
+      symbolic_input_dims.erase(match);
+    }
+  }
+
+  if (!inferred_dim.has_value() || symbolic_input_dims.size() > 1 || constant_output_size == 0) {
+    return std::nullopt;
+  }
+  SymbolicDimExpr inferred = symbolic_input_dims.empty() ? SymbolicDimExpr(1) : symbolic_input_dims[0];
+  inferred *= constant_input_size;
+  if (!inferred.DivideExactly(constant_output_size)) {
+    return std::nullopt;
+  }
+  output[*inferred_dim] = inferred;
+  return output;
+}
+
+std::optional<DimExprs> InferTile(const Graph& graph, const Node& node) {
+  InlinedVector<int64_t> repeats;
+  auto output = GetDimExprs(node.InputDefs()[0]);
+  if (!output.has_value() || !GetConstantInput(graph, node, 1, repeats) || repeats.size() != output->size()) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < output->size(); i++) {
+    if ((*output)[i].has_value()) {
+      *(*output)[i] *= repeats[i];
+    }
+  }
+  return output;
+}
+
+std::optional<DimExprs> InferOutputDims(const Graph& graph, const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13})) {
+    return InferConcat(node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pad", {2, 11, 13, 18, 19, 21})) {
+    return InferPad(graph, node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {10, 11, 13})) {
+    return InferSlice(graph, node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5, 13, 14, 19, 21})) {
+    return InferReshape(graph, node);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tile", {6, 13})) {
+    return InferTile(graph, node);
+  }
+  return std::nullopt;
+}
+
+// Names the dims of the first output that shape inference left unknown. Returns true if any dim was named.
+bool PropagateSymbolicDims(const Graph& graph, Node& node) {
+  const auto dims = InferOutputDims(graph, node);
+  NodeArg* output = node.MutableOutputDefs()[0];
+  if (!dims.has_value() || !output->Exists() ||
+      (output->Shape() != nullptr && output->Shape()->dim_size() != static_cast<int>(dims->size()))) {
+    return false;
+  }
+
+  ONNX_NAMESPACE::TensorShapeProto shape;
+  if (output->Shape() != nullptr) {
+    shape = *output->Shape();
+  } else {
+    for (size_t i = 0; i < dims->size(); i++) {
+      shape.add_dim();
+    }
+  }
+
+  bool named = false;
+  for (size_t i = 0; i < dims->size(); i++) {
+    auto& dim = *shape.mutable_dim(static_cast<int>(i));
+    if ((*dims)[i].has_value() && !utils::HasDimValue(dim) && !utils::HasDimParam(dim) &&
+        (!(*dims)[i]->IsConstant() || (*dims)[i]->Constant() >= 0)) {
+      (*dims)[i]->ToDim(dim);
+      named = true;
+    }
+  }
+
+  if (named) {
+    output->SetShape(shape);
+  }
+  return named;
+}
+
+}  // namespace
+
+Status SymbolicShapePropagation::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                           const logging::Logger& logger) const {
+  // Shape inference carries the new dim_params through the other nodes, so the dims depending on them are only
+  // known after the graph is resolved again.
+  constexpr int kMaxPasses = 16;
+  for (int pass = 0; pass < kMaxPasses; pass++) {
+    bool pass_modified = false;
+    GraphViewer graph_viewer(graph);
+    for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+      Node* node = graph.GetNode(node_index);
+      if (node == nullptr) {
+        continue;
+      }
+
+      if (pass == 0) {
+        ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+      }
+
+      if (PropagateSymbolicDims(graph, *node)) {
+        LOGS(logger, VERBOSE) << "SymbolicShapePropagation: named the dims of " << node->OutputDefs()[0]->Name();
+        pass_modified = true;
+      }
+    }
+
+    if (!pass_modified) {
+      break;
+    }
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
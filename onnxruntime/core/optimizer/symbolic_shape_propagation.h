@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SymbolicShapePropagation
+
+Transformer that names the output dims that ONNX shape inference leaves unknown because they depend on dims with a
+dim_param, using affine expressions of the named dims (see SymbolicDimExpr). E.g. the Concat of [batch, seq] and
+[batch, 1] along axis 1 gets the shape [batch, seq + 1].
+
+The dims are computed for Concat, Pad, Reshape with a -1 in its shape, Slice with a step of 1 and Tile, with
+constant pads, shapes, starts, ends, axes, steps and repeats. A Slice whose bounds are relative to the end of a
+dim, e.g. x[:, -1:], is assumed not to be clamped, i.e. the dim is assumed to be at least as large as the bounds.
+Shape inference then carries the new dim_params through the other nodes, so the memory planner can reuse buffers
+whose sizes are the same expressions even though the shapes are dynamic.
+*/
+class SymbolicShapePropagation : public GraphTransformer {
+ public:
+  SymbolicShapePropagation() noexcept : GraphTransformer("SymbolicShapePropagation") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
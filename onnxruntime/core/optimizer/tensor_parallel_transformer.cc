@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/tensor_parallel_transformer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// The element types the AllReduce of the partial results supports.
+bool IsShardableType(int32_t data_type) {
+  return data_type == TensorProto_DataType_FLOAT || data_type == TensorProto_DataType_FLOAT16 ||
+         data_type == TensorProto_DataType_DOUBLE;
+}
+
+// The constant initializer of the given rank behind arg, if the node using it is its only consumer.
+const TensorProto* GetShardableWeight(const Graph& graph, const NodeArg& arg, int rank) {
+  if (!arg.Exists() || graph.IsOutput(&arg) || graph.GetConsumerNodes(arg.Name()).size() != 1) {
+    return nullptr;
+  }
+  const TensorProto* weight = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (weight == nullptr || weight->dims_size() != rank || !IsShardableType(weight->data_type()) ||
+      std::any_of(weight->dims().begin(), weight->dims().end(), [](int64_t dim) { return dim <= 0; })) {
+    return nullptr;
+  }
+  return weight;
+}
+
+// The hidden activations of a shard replace the ones of the full model, their node must be the only consumer.
+bool HasSingleConsumer(const Graph& graph, const Node& node) {
+  return node.GetOutputEdgesCount() == 1 && !graph.NodeProducesGraphOutput(node);
+}
+
+bool IsShardableActivation(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {20}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "BiasGelu", {1}, kMSDomain) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain);
+}
+
+TensorProto MakeShard(Graph& graph, const TensorProto& weight, const std::string& suffix, TensorShapeVector dims,
+                      const std::vector<uint8_t>& data) {
+  TensorProto shard;
+  shard.set_name(graph.GenerateNodeArgName(weight.name() + suffix));
+  shard.set_data_type(weight.data_type());
+  for (const auto dim : dims) {
+    shard.add_dims(dim);
+  }
+  utils::SetRawDataInTensorProto(shard, data.data(), data.size());
+  return shard;
+}
+
+// The columns (last dimension) of the rank in each of the stride sections of the weight. The stride is 3 for the
+// weight of an Attention, whose columns are the ones of Q, K and V.
+TensorProto ShardByColumn(Graph& graph, const TensorProto& weight_proto, int64_t rank, int64_t world_size,
+                          int64_t stride) {
+  const Initializer weight{weight_proto, graph.ModelPath()};
+  const auto bytes = weight.DataAsByteSpan();
+  const size_t element_size = bytes.size() / weight.size();
+  TensorShapeVector dims(weight.dims().begin(), weight.dims().end());
+  const int64_t columns = dims.back();
+  const int64_t rows = static_cast<int64_t>(weight.size()) / columns;
+  const size_t section_bytes = static_cast<size_t>(columns / stride) * element_size;
+  const size_t shard_bytes = section_bytes / static_cast<size_t>(world_size);
+
+  std::vector<uint8_t> data;
+  data.reserve(bytes.size() / static_cast<size_t>(world_size));
+  for (int64_t row = 0; row < rows; ++row) {
+    const uint8_t* row_data = bytes.data() + static_cast<size_t>(row * columns) * element_size;
+    for (int64_t section = 0; section < stride; ++section) {
+      const uint8_t* shard_data =
+          row_data + static_cast<size_t>(section) * section_bytes + static_cast<size_t>(rank) * shard_bytes;
+      data.insert(data.end(), shard_data, shard_data + shard_bytes);
+    }
+  }
+
+  dims.back() = columns / world_size;
+  return MakeShard(graph, weight_proto, "_column_rank_" + std::to_string(rank), std::move(dims), data);
+}
+
+// The rows (first dimension) of the rank.
+TensorProto ShardByRow(Graph& graph, const TensorProto& weight_proto, int64_t rank, int64_t world_size) {
+  const Initializer weight{weight_proto, graph.ModelPath()};
+  const auto bytes = weight.DataAsByteSpan();
+  const size_t shard_bytes = bytes.size() / static_cast<size_t>(world_size);
+  const uint8_t* shard_data = bytes.data() + static_cast<size_t>(rank) * shard_bytes;
+  const std::vector<uint8_t> data(shard_data, shard_data + shard_bytes);
+
+  TensorShapeVector dims(weight.dims().begin(), weight.dims().end());
+  dims.front() /= world_size;
+  return MakeShard(graph, weight_proto, "_row_rank_" + std::to_string(rank), std::move(dims), data);
+}
+
+void ReplaceWeight(Graph& graph, Node& node, int input_index, const TensorProto& shard) {
+  const std::string weight_name = node.InputDefs()[input_index]->Name();
+  NodeArg& shard_arg = graph_utils::AddInitializer(graph, shard);
+  graph_utils::ReplaceNodeInput(node, input_index, shard_arg);
+  graph.RemoveInitializedTensor(weight_name);
+}
+
+// Sums the partial results of the row parallel MatMul over the ranks before its consumers use them.
+void InsertAllReduce(Graph& graph, Node& matmul) {
+  NodeArg& partial_arg = *matmul.MutableOutputDefs()[0];
+  ONNX_NAMESPACE::TypeProto type = *partial_arg.TypeAsProto();
+  NodeArg& reduced_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(partial_arg.Name() + "_all_reduce"),
+                                                  &type);
+  Node& all_reduce = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "_AllReduce"),
+                                   "AllReduce",
+                                   "tensor parallel reduction of " + matmul.Name(),
+                                   {&partial_arg},
+                                   {&reduced_arg},
+                                   nullptr,
+                                   kMSDomain);
+  all_reduce.SetExecutionProviderType(matmul.GetExecutionProviderType());
+  graph_utils::ReplaceDownstreamNodeInput(graph, matmul, 0, all_reduce, 0);
+  graph.AddEdge(matmul.Index(), all_reduce.Index(), 0, 0);
+}
+
+// MatMul(x, W), W split by row, whose result is reduced over the ranks.
+const TensorProto* GetRowParallelWeight(const Graph& graph, const Node& matmul, const NodeArg& input,
+                                        const std::string& provider, int64_t rows) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+      matmul.GetExecutionProviderType() != provider || matmul.InputDefs()[0] != &input ||
+      matmul.GetOutputEdgesCount() == 0 || graph.NodeProducesGraphOutput(matmul)) {
+    return nullptr;
+  }
+  const TensorProto* weight = GetShardableWeight(graph, *matmul.InputDefs()[1], 2);
+  return weight != nullptr && weight->dims(0) == rows ? weight : nullptr;
+}
+
+}  // namespace
+
+/*
+  MatMul(x, W1) [-> Add(b1)] -> activation [with bias b1] -> MatMul(W2)
+  W1 and b1 are split by column, W2 by row.
+*/
+bool TensorParallelTransformer::ShardMLP(Graph& graph, Node& matmul, InlinedVector<Node*>& nodes_to_clear_shape) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+      !HasSingleConsumer(graph, matmul)) {
+    return false;
+  }
+  const std::string& provider = matmul.GetExecutionProviderType();
+  const TensorProto* w1 = GetShardableWeight(graph, *matmul.InputDefs()[1], 2);
+  if (w1 == nullptr || w1->dims(1) % world_size_ != 0) {
+    return false;
+  }
+  const int64_t hidden_size = w1->dims(1);
+  const auto is_hidden_bias = [&](const TensorProto* bias) { return bias != nullptr && bias->dims(0) == hidden_size; };
+
+  Node* next = graph.GetNode(matmul.OutputNodesBegin()->Index());
+  Node* add = nullptr;
+  int add_bias_index = 0;
+  const TensorProto* add_bias = nullptr;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(*next, "Add", {7, 13, 14})) {
+    add = next;
+    add_bias_index = add->InputDefs()[0] == matmul.OutputDefs()[0] ? 1 : 0;
+    add_bias = GetShardableWeight(graph, *add->InputDefs()[add_bias_index], 1);
+    if (add->GetExecutionProviderType() != provider || !HasSingleConsumer(graph, *add) || !is_hidden_bias(add_bias)) {
+      return false;
+    }
+    next = graph.GetNode(add->OutputNodesBegin()->Index());
+  }
+
+  Node& activation = *next;
+  const NodeArg* hidden = (add != nullptr ? add : &matmul)->OutputDefs()[0];
+  if (!IsShardableActivation(activation) || activation.GetExecutionProviderType() != provider ||
+      activation.InputDefs()[0] != hidden || !HasSingleConsumer(graph, activation)) {
+    return false;
+  }
+  const auto& activation_inputs = activation.InputDefs();
+  const TensorProto* activation_bias = nullptr;
+  if (activation_inputs.size() > 1 && activation_inputs[1]->Exists()) {
+    activation_bias = GetShardableWeight(graph, *activation_inputs[1], 1);
+    if (!is_hidden_bias(activation_bias)) {
+      return false;
+    }
+  }
+
+  Node& matmul2 = *graph.GetNode(activation.OutputNodesBegin()->Index());
+  const TensorProto* w2 = GetRowParallelWeight(graph, matmul2, *activation.OutputDefs()[0], provider, hidden_size);
+  if (w2 == nullptr) {
+    return false;
+  }
+
+  ReplaceWeight(graph, matmul, 1, ShardByColumn(graph, *w1, rank_, world_size_, 1));
+  if (add != nullptr) {
+    ReplaceWeight(graph, *add, add_bias_index, ShardByColumn(graph, *add_bias, rank_, world_size_, 1));
+    nodes_to_clear_shape.push_back(add);
+  }
+  if (activation_bias != nullptr) {
+    ReplaceWeight(graph, activation, 1, ShardByColumn(graph, *activation_bias, rank_, world_size_, 1));
+  }
+  ReplaceWeight(graph, matmul2, 1, ShardByRow(graph, *w2, rank_, world_size_));
+  InsertAllReduce(graph, matmul2);
+  nodes_to_clear_shape.insert(nodes_to_clear_shape.end(), {&matmul, &activation});
+  return true;
+}
+
+/*
+  Attention(x, Wqkv, bqkv) -> MatMul(Wo)
+  Each rank computes num_heads / world_size heads: the columns of Wqkv and bqkv are split in each of the Q, K and V
+  sections, Wo is split by row.
+*/
+bool TensorParallelTransformer::ShardAttention(Graph& graph, Node& attention,
+                                               InlinedVector<Node*>& nodes_to_clear_shape) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(attention, "Attention", {1}, kMSDomain) ||
+      !HasSingleConsumer(graph, attention)) {
+    return false;
+  }
+
+  // past, attention_bias and past_sequence_length, and present, have a head dimension.
+  const auto& inputs = attention.InputDefs();
+  for (size_t i = 4; i < inputs.size(); ++i) {
+    if (inputs[i]->Exists()) {
+      return false;
+    }
+  }
+  const auto& outputs = attention.OutputDefs();
+  if (outputs.size() > 1 && outputs[1]->Exists()) {
+    return false;
+  }
+
+  const auto* qkv_hidden_sizes = graph_utils::GetNodeAttribute(attention, "qkv_hidden_sizes");
+  const auto* num_heads_attr = graph_utils::GetNodeAttribute(attention, "num_heads");
+  if ((qkv_hidden_sizes != nullptr && qkv_hidden_sizes->ints_size() > 0) || num_heads_attr == nullptr ||
+      num_heads_attr->i() % world_size_ != 0) {
+    return false;
+  }
+
+  const TensorProto* weight = GetShardableWeight(graph, *inputs[1], 2);
+  if (weight == nullptr || weight->dims(1) % (3 * world_size_) != 0) {
+    return false;
+  }
+  const int64_t qkv_size = weight->dims(1);
+  const TensorProto* bias = nullptr;
+  if (inputs.size() > 2 && inputs[2]->Exists()) {
+    bias = GetShardableWeight(graph, *inputs[2], 1);
+    if (bias == nullptr || bias->dims(0) != qkv_size) {
+      return false;
+    }
+  }
+
+  Node& matmul = *graph.GetNode(attention.OutputNodesBegin()->Index());
+  const TensorProto* output_weight =
+      GetRowParallelWeight(graph, matmul, *outputs[0], attention.GetExecutionProviderType(), qkv_size / 3);
+  if (output_weight == nullptr) {
+    return false;
+  }
+
+  ReplaceWeight(graph, attention, 1, ShardByColumn(graph, *weight, rank_, world_size_, 3));
+  if (bias != nullptr) {
+    ReplaceWeight(graph, attention, 2, ShardByColumn(graph, *bias, rank_, world_size_, 3));
+  }
+  attention.AddAttribute("num_heads", num_heads_attr->i() / world_size_);
+  ReplaceWeight(graph, matmul, 1, ShardByRow(graph, *output_weight, rank_, world_size_));
+  InsertAllReduce(graph, matmul);
+  nodes_to_clear_shape.push_back(&attention);
+  return true;
+}
+
+Status TensorParallelTransformer::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                            const logging::Logger& /*logger*/) const {
+  if (world_size_ <= 1) {
+    return Status::OK();
+  }
+  ORT_RETURN_IF_NOT(rank_ >= 0 && rank_ < world_size_, "Invalid tensor parallel rank ", rank_, " for ", world_size_,
+                    " ranks.");
+
+  // The subgraphs are not sharded, their weights may be used by the outer scope too.
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedVector<Node*> nodes_to_clear_shape;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (ShardAttention(graph, node, nodes_to_clear_shape) || ShardMLP(graph, node, nodes_to_clear_shape)) {
+      modified = true;
+    }
+  }
+
+  // The hidden dimension of the outputs of the sharded nodes is divided by the number of ranks, their shapes are
+  // inferred again when the graph is resolved.
+  for (auto* node : nodes_to_clear_shape) {
+    for (auto* output : node->MutableOutputDefs()) {
+      output->ClearShape();
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
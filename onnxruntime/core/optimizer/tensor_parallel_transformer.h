@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TensorParallelTransformer
+
+Shard the weights of the MLP and attention blocks of a transformer model over the ranks of a tensor parallel group,
+following the Megatron-LM scheme, so that a model too large for one GPU runs as one session per rank:
+
+  MLP:        MatMul(x, W1) [-> Add(b1)] -> activation -> MatMul(W2)
+  attention:  Attention(x, Wqkv, bqkv) -> MatMul(Wo)
+
+The first weight (W1 and its bias, or the heads of Wqkv and bqkv) is split by column and the second one (W2, Wo) by
+row. Each rank computes a slice of the hidden activations and a partial result of the second MatMul, which an
+AllReduce of the collective contrib ops sums over the ranks. The biases of the second MatMuls are added after the
+reduction and are left as they are.
+
+This is the inference counterpart of the MegatronTransformer of training: each rank only keeps its shard of the
+initializers, and the ranks of the group have to run the same model with their own rank (see
+kOrtSessionOptionsTensorParallelRank), the one of their NCCL communicator.
+*/
+class TensorParallelTransformer : public GraphTransformer {
+ public:
+  TensorParallelTransformer(int64_t rank, int64_t world_size,
+                            const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TensorParallelTransformer", compatible_execution_providers),
+        rank_(rank),
+        world_size_(world_size) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  bool ShardMLP(Graph& graph, Node& matmul, InlinedVector<Node*>& nodes_to_clear_shape) const;
+  bool ShardAttention(Graph& graph, Node& attention, InlinedVector<Node*>& nodes_to_clear_shape) const;
+
+  int64_t rank_;
+  int64_t world_size_;
+};
+
+}  // namespace onnxruntime
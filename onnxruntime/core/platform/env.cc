@@ -34,6 +34,14 @@ std::ostream& operator<<(std::ostream& os, gsl::span<const LogicalProcessors> af
 
 Env::Env() = default;
 
+common::Status Env::ReadFileRegionsIntoBuffers(_In_z_ const ORTCHAR_T* file_path,
+                                               gsl::span<const FileRegionRead> reads) const {
+  for (const auto& read : reads) {
+    ORT_RETURN_IF_ERROR(ReadFileIntoBuffer(file_path, read.offset, read.length, read.buffer));
+  }
+  return common::Status::OK();
+}
+
 std::pair<int, std::string> GetErrnoInfo() {
   auto err = errno;
   std::string msg;
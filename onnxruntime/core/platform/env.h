@@ -91,6 +91,10 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // Size the blocks of ParallelFor loops from the cost per iteration measured in earlier runs of the same loop
+  // instead of only from the cost given by the caller.
+  bool adaptive_block_sizing_ = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -149,6 +153,31 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// <summary>
+  /// The API returns the logical processors of each NUMA node, indexed by node number.
+  /// The processor ids are the same as the ones used for thread affinities (0-based).
+  /// </summary>
+  /// <returns>Logical processors per NUMA node, or an empty vector if the NUMA topology is unknown</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodeProcessors() const { return {}; }
+
+  /// <summary>
+  /// Allocates memory whose pages are placed on the given NUMA node.
+  /// The memory must be released with FreeOnNumaNode using the same size.
+  /// </summary>
+  /// <returns>The memory, or nullptr if the allocation failed or NUMA placement is not supported</returns>
+  virtual void* AllocateOnNumaNode(size_t /*size*/, int /*numa_node*/) const { return nullptr; }
+
+  virtual void FreeOnNumaNode(void* /*p*/, size_t /*size*/) const {}
+
+  /// <summary>
+  /// The API returns the logical processors of the highest performance core class on a hybrid CPU,
+  /// e.g. the P-cores of a CPU with P-cores and E-cores.
+  /// The processor ids are the same as the ones used for thread affinities (0-based).
+  /// </summary>
+  /// <returns>Logical processors of the performance cores, or an empty vector if all cores are of the same class
+  /// or the core classes are unknown</returns>
+  virtual LogicalProcessors GetPerformanceCoreProcessors() const { return {}; }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -179,6 +208,25 @@ class Env {
   virtual common::Status ReadFileIntoBuffer(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                             gsl::span<char> buffer) const = 0;
 
+  /**
+   * A region of a file and the buffer to copy it into, see ReadFileRegionsIntoBuffers().
+   */
+  struct FileRegionRead {
+    FileOffsetType offset;
+    size_t length;
+    gsl::span<char> buffer;
+  };
+
+  /**
+   * Copies several regions of the file into the provided buffers.
+   * The reads of the regions may be in flight at the same time, which hides the latency of the storage when there
+   * are many of them. The default implementation calls ReadFileIntoBuffer() for each region.
+   * @param file_path The path to the file.
+   * @param reads The regions to read and their buffers.
+   */
+  virtual common::Status ReadFileRegionsIntoBuffers(_In_z_ const ORTCHAR_T* file_path,
+                                                    gsl::span<const FileRegionRead> reads) const;
+
   using MappedMemoryPtr = std::unique_ptr<char[], OrtCallbackInvoker>;
 
   /**
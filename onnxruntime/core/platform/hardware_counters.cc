@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+#include <sstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+
+const char* HardwareCounters::CounterName(Counter counter) {
+  switch (counter) {
+    case kCycles:
+      return "cycles";
+    case kInstructions:
+      return "instructions";
+    case kLlcMisses:
+      return "llc_misses";
+    case kDtlbMisses:
+      return "dtlb_misses";
+    case kFpOps:
+      return "fp_ops";
+    default:
+      return "unknown";
+  }
+}
+
+#if defined(__linux__)
+
+namespace {
+
+struct CounterEvent {
+  HardwareCounters::Counter counter;
+  uint32_t type;
+  uint64_t config;
+};
+
+int OpenCounter(const CounterEvent& event, pid_t tid, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::vector<pid_t> GetThreadIds() {
+  std::vector<pid_t> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return tids;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+
+}  // namespace
+
+Status HardwareCounters::Create(uint64_t fp_ops_raw_event, std::unique_ptr<HardwareCounters>& counters) {
+  counters.reset();
+
+  // the group leader comes first, a thread is only counted if it can be opened
+  std::vector<CounterEvent> events = {
+      {kCycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {kInstructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      // the generic cache miss event counts the misses of the last level cache on most CPUs
+      {kLlcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {kDtlbMisses, PERF_TYPE_HW_CACHE,
+       PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+  };
+  if (fp_ops_raw_event != 0) {
+    events.push_back({kFpOps, PERF_TYPE_RAW, fp_ops_raw_event});
+  }
+
+  std::unique_ptr<HardwareCounters> result(new HardwareCounters());
+  std::vector<CounterEvent> available_events;
+  for (const pid_t tid : GetThreadIds()) {
+    ThreadCounters thread;
+    if (available_events.empty()) {
+      // the first thread finds the counters the CPU and the kernel provide
+      const int leader = OpenCounter(events[0], tid, -1);
+      if (leader < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the hardware counters with perf_event_open: ",
+                               std::strerror(errno), ". Check /proc/sys/kernel/perf_event_paranoid.");
+      }
+      thread.fds.push_back(leader);
+      available_events.push_back(events[0]);
+      for (size_t i = 1; i < events.size(); ++i) {
+        const int fd = OpenCounter(events[i], tid, leader);
+        if (fd >= 0) {
+          thread.fds.push_back(fd);
+          available_events.push_back(events[i]);
+        }
+      }
+    } else {
+      for (const auto& event : available_events) {
+        const int fd = OpenCounter(event, tid, thread.fds.empty() ? -1 : thread.fds[0]);
+        if (fd < 0) {
+          break;
+        }
+        thread.fds.push_back(fd);
+      }
+      if (thread.fds.size() != available_events.size()) {
+        // e.g. the thread exited in the meantime
+        for (const int fd : thread.fds) {
+          close(fd);
+        }
+        continue;
+      }
+    }
+    result->threads_.push_back(std::move(thread));
+  }
+
+  ORT_RETURN_IF(result->threads_.empty(), "No thread to open the hardware counters of.");
+  for (const auto& event : available_events) {
+    result->available_[event.counter] = true;
+    result->group_counters_.push_back(event.counter);
+  }
+
+  counters = std::move(result);
+  return Status::OK();
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (const auto& thread : threads_) {
+    // close the members of the group before its leader
+    for (auto fd = thread.fds.rbegin(); fd != thread.fds.rend(); ++fd) {
+      close(*fd);
+    }
+  }
+}
+
+HardwareCounters::Values HardwareCounters::Read() const {
+  Values values{};
+  // PERF_FORMAT_GROUP: the number of values, then the values in the order the counters were opened
+  std::vector<uint64_t> buffer(1 + group_counters_.size());
+  const auto size = static_cast<ssize_t>(buffer.size() * sizeof(uint64_t));
+  for (const auto& thread : threads_) {
+    if (read(thread.fds[0], buffer.data(), buffer.size() * sizeof(uint64_t)) != size ||
+        buffer[0] != group_counters_.size()) {
+      continue;
+    }
+    for (size_t i = 0; i < group_counters_.size(); ++i) {
+      values[group_counters_[i]] += buffer[1 + i];
+    }
+  }
+  return values;
+}
+
+#else
+
+Status HardwareCounters::Create(uint64_t /*fp_ops_raw_event*/, std::unique_ptr<HardwareCounters>& counters) {
+  counters.reset();
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Hardware counters are only supported on Linux.");
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounters::Values HardwareCounters::Read() const {
+  return Values{};
+}
+
+#endif
+
+std::string HardwareCounters::ToJson(const Values& begin, const Values& end) const {
+  std::ostringstream json;
+  json << "{";
+  bool is_first = true;
+  for (int i = 0; i < kNumCounters; ++i) {
+    if (!available_[i]) {
+      continue;
+    }
+    json << (is_first ? "" : ",") << "\"" << CounterName(static_cast<Counter>(i)) << "\":" << (end[i] - begin[i]);
+    is_first = false;
+  }
+  json << "}";
+  return json.str();
+}
+
+}  // namespace onnxruntime
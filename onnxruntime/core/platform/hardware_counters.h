@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+ * Hardware performance counters (PMU) of the threads of the process, read with perf_event_open on Linux.
+ *
+ * The counters are opened for every thread that exists when they are created, e.g. the threads of the intra-op and
+ * inter-op thread pools, and Read() returns their sum. The difference of two reads is thus the work done by all the
+ * threads in between, including work not related to the caller if other threads are busy concurrently.
+ * Threads created later are not counted. Only user space is counted.
+ */
+class HardwareCounters {
+ public:
+  enum Counter {
+    kCycles = 0,
+    kInstructions,
+    kLlcMisses,
+    kDtlbMisses,
+    // there is no generic event for floating point operations, it is only counted with a raw event of the CPU
+    kFpOps,
+    kNumCounters
+  };
+
+  using Values = std::array<uint64_t, kNumCounters>;
+
+  static const char* CounterName(Counter counter);
+
+  /**
+   * Open the counters on all the threads of the process.
+   * @param fp_ops_raw_event The raw event (perf_event_attr.config for PERF_TYPE_RAW) that counts floating point
+   *                         operations on this CPU, or 0 to not count them.
+   * @param counters Set to the counters, or nullptr if the platform or the kernel doesn't provide them, e.g. when
+   *                 perf_event_paranoid forbids it.
+   * Counters the CPU doesn't provide are left out, see IsAvailable().
+   */
+  static Status Create(uint64_t fp_ops_raw_event, std::unique_ptr<HardwareCounters>& counters);
+
+  ~HardwareCounters();
+
+  bool IsAvailable(Counter counter) const { return available_[counter]; }
+
+  // The sum of the counters of all the threads. Counters that are not available are 0.
+  Values Read() const;
+
+  // The difference of two reads as a json object of the available counters, e.g. {"cycles":1200,"instructions":800}
+  std::string ToJson(const Values& begin, const Values& end) const;
+
+ private:
+  HardwareCounters() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HardwareCounters);
+
+  struct ThreadCounters {
+    // the group leader is the first fd, the values of the group are read through it
+    std::vector<int> fds;
+  };
+
+  std::array<bool, kNumCounters> available_{};
+  // the counter of every entry of a group, in the order of the read values
+  std::vector<Counter> group_counters_;
+  std::vector<ThreadCounters> threads_;
+};
+
+}  // namespace onnxruntime
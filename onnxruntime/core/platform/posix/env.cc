@@ -31,8 +31,10 @@ limitations under the License.
 #endif
 #include <unistd.h>
 
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -324,6 +326,114 @@ class PosixEnv : public Env {
 #endif
   }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  // Parses a sysfs cpu/node list such as "0-3,8,10-11".
+  static std::vector<int> ParseSysfsIdList(const std::string& list) {
+    std::vector<int> ids;
+    std::string item;
+    std::istringstream items(list);
+    while (std::getline(items, item, ',')) {
+      if (item.empty() || item == "\n") continue;
+      const auto dash = item.find('-');
+      const int from = std::stoi(item.substr(0, dash));
+      const int to = dash == std::string::npos ? from : std::stoi(item.substr(dash + 1));
+      for (int id = from; id <= to; ++id) ids.push_back(id);
+    }
+    return ids;
+  }
+
+  static std::optional<std::string> ReadSysfsLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) return std::nullopt;
+    return line;
+  }
+
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override {
+    std::vector<LogicalProcessors> ret;
+    ORT_TRY {
+      const auto online = ReadSysfsLine("/sys/devices/system/node/online");
+      if (!online) return ret;
+      for (int node : ParseSysfsIdList(*online)) {
+        const auto cpus = ReadSysfsLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!cpus) continue;
+        if (static_cast<size_t>(node) >= ret.size()) ret.resize(static_cast<size_t>(node) + 1);
+        ret[node] = ParseSysfsIdList(*cpus);
+      }
+    }
+    ORT_CATCH(const std::exception&) {
+      // malformed sysfs content, treat the topology as unknown
+      ret.clear();
+    }
+    return ret;
+  }
+
+  LogicalProcessors GetPerformanceCoreProcessors() const override {
+    LogicalProcessors ret;
+    ORT_TRY {
+      // Intel hybrid CPUs expose the P-cores as their own PMU
+      if (const auto core_cpus = ReadSysfsLine("/sys/devices/cpu_core/cpus")) {
+        if (ReadSysfsLine("/sys/devices/cpu_atom/cpus")) {
+          return ParseSysfsIdList(*core_cpus);
+        }
+      }
+
+      // otherwise use the relative capacity the scheduler assigns to each processor, e.g. on big.LITTLE
+      const auto online = ReadSysfsLine("/sys/devices/system/cpu/online");
+      if (!online) return ret;
+      int max_capacity = -1;
+      bool all_equal = true;
+      for (int cpu : ParseSysfsIdList(*online)) {
+        const auto capacity_str = ReadSysfsLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpu_capacity");
+        if (!capacity_str) return {};
+        const int capacity = std::stoi(*capacity_str);
+        if (max_capacity >= 0 && capacity != max_capacity) all_equal = false;
+        if (capacity > max_capacity) {
+          max_capacity = capacity;
+          ret.clear();
+        }
+        if (capacity == max_capacity) ret.push_back(cpu);
+      }
+      if (all_equal) ret.clear();
+    }
+    ORT_CATCH(const std::exception&) {
+      ret.clear();
+    }
+    return ret;
+  }
+
+  void* AllocateOnNumaNode(size_t size, int numa_node) const override {
+#if defined(SYS_mbind)
+    if (size == 0 || numa_node < 0) return nullptr;
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+
+    // MPOL_BIND from <numaif.h>, which is part of libnuma and not necessarily installed
+    constexpr int kMpolBind = 2;
+    constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMaskWord + 1, 0);
+    node_mask[numa_node / kBitsPerMaskWord] |= 1UL << (numa_node % kBitsPerMaskWord);
+    // the kernel expects the number of bits in the mask plus one
+    const unsigned long max_node = node_mask.size() * kBitsPerMaskWord + 1;
+    if (syscall(SYS_mbind, p, size, kMpolBind, node_mask.data(), max_node, 0) != 0) {
+      munmap(p, size);
+      return nullptr;
+    }
+    return p;
+#else
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return nullptr;
+#endif
+  }
+
+  void FreeOnNumaNode(void* p, size_t size) const override {
+    if (p != nullptr) {
+      munmap(p, size);
+    }
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -423,6 +533,55 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status ReadFileRegionsIntoBuffers(const ORTCHAR_T* file_path,
+                                    gsl::span<const FileRegionRead> reads) const override {
+    ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
+    for (const auto& read : reads) {
+      ORT_RETURN_IF_NOT(read.offset >= 0, "offset < 0");
+      ORT_RETURN_IF_NOT(read.length <= read.buffer.size(), "length > buffer.size()");
+    }
+
+    ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
+    if (!file_descriptor.IsValid()) {
+      return ReportSystemError("open", file_path);
+    }
+
+#if defined(POSIX_FADV_WILLNEED)
+    // The kernel starts reading all the regions in the background, so the reads below mostly wait for the region
+    // at hand instead of issuing one request to the storage after the other. It is only a hint, errors are ignored.
+    for (const auto& read : reads) {
+      if (read.length > 0) {
+        posix_fadvise(file_descriptor.Get(), read.offset, static_cast<off_t>(read.length), POSIX_FADV_WILLNEED);
+      }
+    }
+#endif
+
+    for (const auto& read : reads) {
+      size_t total_bytes_read = 0;
+      while (total_bytes_read < read.length) {
+        constexpr size_t k_max_bytes_to_read = 1 << 30;  // read at most 1GB each time
+        const size_t bytes_to_read = std::min(read.length - total_bytes_read, k_max_bytes_to_read);
+
+        const ssize_t bytes_read =
+            TempFailureRetry(pread, file_descriptor.Get(), read.buffer.data() + total_bytes_read, bytes_to_read,
+                             static_cast<off_t>(read.offset + total_bytes_read));
+
+        if (bytes_read == -1) {
+          return ReportSystemError("pread", file_path);
+        }
+
+        if (bytes_read == 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "ReadFileRegionsIntoBuffers - unexpected end of file. ",
+                                 "File: ", file_path, ", offset: ", read.offset, ", length: ", read.length);
+        }
+
+        total_bytes_read += bytes_read;
+      }
+    }
+
+    return Status::OK();
+  }
+
   Status MapFileIntoMemory(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                            MappedMemoryPtr& mapped_memory) const override {
     ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
@@ -16,11 +16,14 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #include <climits>
 #include <process.h>
 #include <fcntl.h>
@@ -307,6 +310,58 @@ int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodeProcessors() const {
+  std::vector<LogicalProcessors> ret;
+  const int num_processors = static_cast<int>(global_processor_info_map_.size());
+  for (int global_processor_id = 0; global_processor_id < num_processors; ++global_processor_id) {
+    const auto& info = global_processor_info_map_.at(global_processor_id);
+    PROCESSOR_NUMBER processor_number = {};
+    processor_number.Group = static_cast<WORD>(info.group_id);
+    processor_number.Number = static_cast<BYTE>(info.local_processor_id);
+    USHORT node = 0;
+    if (!GetNumaProcessorNodeEx(&processor_number, &node)) {
+      return {};
+    }
+    if (node >= ret.size()) {
+      ret.resize(static_cast<size_t>(node) + 1);
+    }
+    ret[node].push_back(global_processor_id);
+  }
+  return ret;
+}
+
+void* WindowsEnv::AllocateOnNumaNode(size_t size, int numa_node) const {
+  if (size == 0 || numa_node < 0) {
+    return nullptr;
+  }
+  return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                            static_cast<DWORD>(numa_node));
+}
+
+void WindowsEnv::FreeOnNumaNode(void* p, size_t /*size*/) const {
+  if (p != nullptr) {
+    VirtualFree(p, 0, MEM_RELEASE);
+  }
+}
+
+LogicalProcessors WindowsEnv::GetPerformanceCoreProcessors() const {
+  LogicalProcessors ret;
+  if (core_efficiency_classes_.empty()) {
+    return ret;
+  }
+  const auto [min_class, max_class] = std::minmax_element(core_efficiency_classes_.begin(),
+                                                          core_efficiency_classes_.end());
+  if (*min_class == *max_class) {
+    return ret;
+  }
+  for (size_t i = 0; i < cores_.size(); ++i) {
+    if (core_efficiency_classes_[i] == *max_class) {
+      ret.insert(ret.end(), cores_[i].begin(), cores_[i].end());
+    }
+  }
+  return ret;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -405,6 +460,116 @@ Status WindowsEnv::ReadFileIntoBuffer(_In_z_ const ORTCHAR_T* const file_path, c
   return Status::OK();
 }
 
+Status WindowsEnv::ReadFileRegionsIntoBuffers(_In_z_ const ORTCHAR_T* file_path,
+                                              gsl::span<const FileRegionRead> reads) const {
+  ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
+
+  // the regions are read in chunks of at most 1GB, the most a single ReadFile can read
+  struct Chunk {
+    FileOffsetType offset;
+    DWORD length;
+    char* buffer;
+  };
+  std::vector<Chunk> chunks;
+  for (const auto& read : reads) {
+    ORT_RETURN_IF_NOT(read.offset >= 0, "offset < 0");
+    ORT_RETURN_IF_NOT(read.length <= read.buffer.size(), "length > buffer.size()");
+    constexpr size_t k_max_bytes_to_read = 1 << 30;
+    for (size_t chunk_offset = 0; chunk_offset < read.length; chunk_offset += k_max_bytes_to_read) {
+      chunks.push_back({read.offset + static_cast<FileOffsetType>(chunk_offset),
+                        static_cast<DWORD>(std::min(read.length - chunk_offset, k_max_bytes_to_read)),
+                        read.buffer.data() + chunk_offset});
+    }
+  }
+
+  if (chunks.empty()) {
+    return Status::OK();
+  }
+
+  CREATEFILE2_EXTENDED_PARAMETERS parameters{};
+  parameters.dwSize = sizeof(parameters);
+  parameters.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+  parameters.dwFileFlags = FILE_FLAG_OVERLAPPED;
+  wil::unique_hfile file_handle{CreateFile2(file_path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &parameters)};
+  if (file_handle.get() == INVALID_HANDLE_VALUE) {
+    const auto error_code = GetLastError();
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "open file ", ToUTF8String(Basename(file_path)), " fail, errcode = ",
+                           error_code, " - ", std::system_category().message(error_code));
+  }
+
+  // Up to kMaxReadsInFlight overlapped reads are in flight. A slot waits for its read to complete before it issues
+  // the next one.
+  struct ReadSlot {
+    OVERLAPPED overlapped;
+    wil::unique_event_nothrow event;
+    const Chunk* chunk;
+  };
+  constexpr size_t kMaxReadsInFlight = 32;
+  std::vector<ReadSlot> slots(std::min(kMaxReadsInFlight, chunks.size()));
+  for (auto& slot : slots) {
+    slot.chunk = nullptr;
+    slot.event.reset(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    if (!slot.event) {
+      const auto error_code = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CreateEvent fail, errcode = ", error_code, " - ",
+                             std::system_category().message(error_code));
+    }
+  }
+
+  auto issue_read = [&](ReadSlot& slot, const Chunk& chunk) -> Status {
+    slot.overlapped = {};
+    slot.overlapped.Offset = static_cast<DWORD>(chunk.offset);
+    slot.overlapped.OffsetHigh = static_cast<DWORD>(chunk.offset >> 32);
+    slot.overlapped.hEvent = slot.event.get();
+    if (!ReadFile(file_handle.get(), chunk.buffer, chunk.length, nullptr, &slot.overlapped) &&
+        GetLastError() != ERROR_IO_PENDING) {
+      const auto error_code = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "ReadFile ", ToUTF8String(Basename(file_path)), " fail, errcode = ",
+                             error_code, " - ", std::system_category().message(error_code));
+    }
+    slot.chunk = &chunk;
+    return Status::OK();
+  };
+
+  auto complete_read = [&](ReadSlot& slot) -> Status {
+    const Chunk* chunk = std::exchange(slot.chunk, nullptr);
+    DWORD bytes_read;
+    if (!GetOverlappedResult(file_handle.get(), &slot.overlapped, &bytes_read, TRUE)) {
+      const auto error_code = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "ReadFile ", ToUTF8String(Basename(file_path)), " fail, errcode = ",
+                             error_code, " - ", std::system_category().message(error_code));
+    }
+    if (bytes_read != chunk->length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "ReadFile ", ToUTF8String(Basename(file_path)),
+                             " fail: unexpected end");
+    }
+    return Status::OK();
+  };
+
+  Status status = Status::OK();
+  for (size_t i = 0; i < chunks.size() && status.IsOK(); ++i) {
+    auto& slot = slots[i % slots.size()];
+    if (slot.chunk != nullptr) {
+      status = complete_read(slot);
+    }
+    if (status.IsOK()) {
+      status = issue_read(slot, chunks[i]);
+    }
+  }
+
+  // the reads in flight write to the buffers and the slots, so they complete before returning, even after an error
+  for (auto& slot : slots) {
+    if (slot.chunk != nullptr) {
+      Status read_status = complete_read(slot);
+      if (status.IsOK()) {
+        status = std::move(read_status);
+      }
+    }
+  }
+
+  return status;
+}
+
 Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
                                      FileOffsetType offset,
                                      size_t length,
@@ -925,6 +1090,7 @@ void WindowsEnv::InitializeCpuInfo() {
         }
       }
       cores_.push_back(std::move(core_global_proc_ids));
+      core_efficiency_classes_.push_back(processor_info->Processor.EfficiencyClass);
       core_id++;
     }
     iter += size;
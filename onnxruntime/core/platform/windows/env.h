@@ -56,12 +56,18 @@ class WindowsEnv : public Env {
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
   int GetL2CacheSize() const override;
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override;
+  void* AllocateOnNumaNode(size_t size, int numa_node) const override;
+  void FreeOnNumaNode(void* p, size_t size) const override;
+  LogicalProcessors GetPerformanceCoreProcessors() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
   common::Status GetFileLength(int fd, /*out*/ size_t& file_size) const override;
   Status ReadFileIntoBuffer(_In_z_ const ORTCHAR_T* const file_path, const FileOffsetType offset, const size_t length,
                             const gsl::span<char> buffer) const override;
+  Status ReadFileRegionsIntoBuffers(_In_z_ const ORTCHAR_T* file_path,
+                                    gsl::span<const FileRegionRead> reads) const override;
   Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
                            FileOffsetType offset,
                            size_t length,
@@ -114,6 +120,11 @@ class WindowsEnv : public Env {
    * }
    */
   std::vector<LogicalProcessors> cores_;
+  /*
+   * "core_efficiency_classes_" holds the efficiency class of each core in "cores_".
+   * On hybrid CPUs, cores with a higher efficiency class have higher performance.
+   */
+  std::vector<BYTE> core_efficiency_classes_;
 
   int l2_cache_size_;
   /*
@@ -1,9 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/providers/common.h"
@@ -388,6 +396,19 @@ void CreateEmptyFile(const std::string& filename) {
 
 #endif  // defined(COREML_ENABLE_MLPROGRAM)
 
+// Update `hash` with `size` bytes of `data`.
+void UpdateHash(const void* data, size_t size, uint32_t (&hash)[4]) {
+  // MurmurHash3 takes an int length, hash large buffers in chunks
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk_size = std::min(size, kMaxChunkSize);
+    MurmurHash3::x86_128(bytes, narrow<int>(chunk_size), hash[0], &hash);
+    bytes += chunk_size;
+    size -= chunk_size;
+  } while (size > 0);
+}
+
 std::string GetModelOutputPath(bool create_ml_program) {
   // path is used to create the ML Package directory for ML Program, and for the model directly otherwise.
   auto path = util::GetTemporaryFilePath();
@@ -436,7 +457,8 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
     std::string weights_id = mlpackage_->addItem(tmp_dir, "weights", "com.microsoft.OnnxRuntime",
                                                  "CoreML Model Weights");
     auto weights_info = mlpackage_->findItem(weights_id);
-    weights_file_writer_ = std::make_unique<StorageWriter>(weights_info->path() + "/weight.bin");
+    weights_file_path_ = weights_info->path() + "/weight.bin";
+    weights_file_writer_ = std::make_unique<StorageWriter>(weights_file_path_);
 #else
     // should never happen due to handling in coreml_execution_provider.cc
     // throw here so all other code in this class can assume create_ml_program_ is only ever true in a build
@@ -924,11 +946,21 @@ Status ModelBuilder::SaveModel() {
   }
 #endif
 
+  // serialize deterministically (the order of the map entries is fixed) so the model can be used as a cache key
+  std::string serialized_model;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&serialized_model);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    ORT_RETURN_IF_NOT(coreml_model_->SerializeToCodedStream(&coded_stream), "Serializing the CoreML model failed.");
+  }
+
   // scope this so the stream is closed and flushed by the ofstream dtor
   {
     LOGS(logger_, INFO) << "Writing CoreML Model to " << output_path;
     std::ofstream stream(output_path, std::ofstream::out | std::ofstream::binary);
-    ORT_RETURN_IF_NOT(coreml_model_->SerializeToOstream(&stream), "Saving the CoreML model failed. Path=", output_path);
+    stream.write(serialized_model.data(), serialized_model.size());
+    ORT_RETURN_IF_NOT(stream.good(), "Saving the CoreML model failed. Path=", output_path);
   }
 
 #if defined(COREML_ENABLE_MLPROGRAM)
@@ -939,6 +971,38 @@ Status ModelBuilder::SaveModel() {
   weights_file_writer_.reset();
 #endif
 
+  if (coreml_flags_ & COREML_FLAG_ENABLE_MODEL_CACHE) {
+    ORT_RETURN_IF_ERROR(CreateModelCacheKey(serialized_model));
+  }
+
+  return Status::OK();
+}
+
+Status ModelBuilder::CreateModelCacheKey(const std::string& serialized_model) {
+  // the compiled model only depends on the content of the model and the weights, not on their paths.
+  uint32_t hash[4] = {0, 0, 0, 0};
+  UpdateHash(serialized_model.data(), serialized_model.size(), hash);
+
+#if defined(COREML_ENABLE_MLPROGRAM)
+  if (create_ml_program_) {
+    const auto weights_file_path = ToPathString(weights_file_path_);
+    size_t weights_size = 0;
+    ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(weights_file_path.c_str(), weights_size));
+    if (weights_size > 0) {
+      Env::MappedMemoryPtr weights;
+      ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(weights_file_path.c_str(), 0, weights_size, weights));
+      UpdateHash(weights.get(), weights_size, hash);
+    }
+  }
+#endif
+
+  std::ostringstream key;
+  key << (create_ml_program_ ? "mlprogram_" : "neuralnetwork_") << std::hex << std::setfill('0');
+  for (const uint32_t value : hash) {
+    key << std::setw(8) << value;
+  }
+
+  model_cache_key_ = key.str();
   return Status::OK();
 }
 
@@ -976,7 +1040,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
                                     get_sanitized_io_info(std::move(input_output_info_)),
                                     std::move(scalar_outputs_),
                                     std::move(int64_outputs_),
-                                    logger_, coreml_flags_);
+                                    logger_, coreml_flags_, model_cache_key_);
   } else
 #endif
   {
@@ -986,7 +1050,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
                                     std::move(input_output_info_),
                                     std::move(scalar_outputs_),
                                     std::move(int64_outputs_),
-                                    logger_, coreml_flags_);
+                                    logger_, coreml_flags_, model_cache_key_);
   }
 
   return model->LoadModel();  // load using CoreML API, including compilation
@@ -206,6 +206,9 @@ class ModelBuilder {
   // Record the onnx int64 type output names
   void AddInt64Output(const std::string& output_name);
 
+  // Create the key of the compiled model in the model cache from the saved model (COREML_FLAG_ENABLE_MODEL_CACHE)
+  Status CreateModelCacheKey(const std::string& serialized_model);
+
   const GraphViewer& graph_viewer_;
   const logging::Logger& logger_;
   const int32_t coreml_version_;
@@ -220,6 +223,7 @@ class ModelBuilder {
   std::unordered_set<std::string> scalar_outputs_;
   std::unordered_set<std::string> int64_outputs_;
   std::unordered_map<std::string, OnnxTensorInfo> input_output_info_;
+  std::string model_cache_key_;  // empty unless COREML_FLAG_ENABLE_MODEL_CACHE is set
 
   std::unordered_map<std::string, int> initializer_usage_;
   std::unordered_set<std::string> skipped_inputs_;
@@ -235,6 +239,7 @@ class ModelBuilder {
   COREML_SPEC::MILSpec::Block* mlprogram_main_block_{nullptr};  // Block that all the operations are added to
   std::unique_ptr<MPL::ModelPackage> mlpackage_;
   std::unique_ptr<MILBlob::Blob::StorageWriter> weights_file_writer_;
+  std::string weights_file_path_;
 
   // Values must start with [a-zA-A_]
   // Additionally they can't be in a list of reserved words.
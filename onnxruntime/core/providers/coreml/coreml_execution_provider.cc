@@ -206,57 +206,52 @@ common::Status CoreMLExecutionProvider::Compile(const std::vector<FusedNodeAndGr
                                    });
       }
 
-      // From this point we will need to take the exclusive lock on the model until the Predict is
-      // performed, to block other threads to perform Predict on the same model
-      // TODO, investigate concurrent runs for different executions from the same model
-      {
-        std::unique_lock<OrtMutex> lock(model->GetMutex());
-        std::unordered_map<std::string, coreml::OnnxTensorInfo> outputs;
-        outputs.reserve(model_outputs.size());
-
-        coreml::GetOutputTensorMutableRawDataFn get_output_tensor_mutable_raw_data_fn =
-            [&ctx, &model_outputs](const std::string& name,
-                                   int32_t requested_onnx_tensor_element_type,
-                                   gsl::span<const int64_t> static_shape) -> void* {
-          const auto model_output_it = std::find(model_outputs.begin(), model_outputs.end(), name);
-          ORT_ENFORCE(model_output_it != model_outputs.end(), "Failed to find CoreML model output name: ", name);
-
-          const auto output_idx = gsl::narrow_cast<size_t>(std::distance(model_outputs.begin(), model_output_it));
-          auto output_tensor = ctx.GetOutput(output_idx, static_shape.data(), static_shape.size());
-
-          const auto type_and_shape_info = output_tensor.GetTensorTypeAndShapeInfo();
-          const auto actual_element_type = type_and_shape_info.GetElementType();
-          ORT_ENFORCE(utils::CApiElementTypeFromProtoType(requested_onnx_tensor_element_type) == actual_element_type,
-                      "Requested and actual output tensor element types do not match. Requested: ",
-                      utils::CApiElementTypeFromProtoType(requested_onnx_tensor_element_type),
-                      ", actual: ", actual_element_type);
-
-          return output_tensor.GetTensorMutableRawData();
-        };
-
-        for (size_t i = 0; i < model_outputs.size(); i++) {
-          const auto& output_name = model_outputs[i];
-          const auto& output_info = model->GetInputOutputInfo(output_name);
-          auto output_shape = output_info.shape;
-          auto output_type = output_info.data_type;
-
-          // Since CoreML EP use {1} MLMultiArray as scalar, if the model output should have empty shape
-          // We are going to replace the {1} shape of the output back to {}
-          if (model->IsScalarOutput(output_name)) {
-            output_shape.clear();
-          }
-
-          // Since CoreML EP only accepts int32 output type and onnx requires int64 output,
-          // We are going to set the model output (from int32) ->int64
-          if (model->IsInt64Output(output_name)) {
-            output_type = ONNX_NAMESPACE::TensorProto_DataType_INT64;
-          }
-
-          outputs.emplace(output_name, coreml::OnnxTensorInfo{output_type, output_shape});
+      // Model::Predict serializes the predictions with the model when the OS can't run them concurrently
+      std::unordered_map<std::string, coreml::OnnxTensorInfo> outputs;
+      outputs.reserve(model_outputs.size());
+
+      coreml::GetOutputTensorMutableRawDataFn get_output_tensor_mutable_raw_data_fn =
+          [&ctx, &model_outputs](const std::string& name,
+                                 int32_t requested_onnx_tensor_element_type,
+                                 gsl::span<const int64_t> static_shape) -> void* {
+        const auto model_output_it = std::find(model_outputs.begin(), model_outputs.end(), name);
+        ORT_ENFORCE(model_output_it != model_outputs.end(), "Failed to find CoreML model output name: ", name);
+
+        const auto output_idx = gsl::narrow_cast<size_t>(std::distance(model_outputs.begin(), model_output_it));
+        auto output_tensor = ctx.GetOutput(output_idx, static_shape.data(), static_shape.size());
+
+        const auto type_and_shape_info = output_tensor.GetTensorTypeAndShapeInfo();
+        const auto actual_element_type = type_and_shape_info.GetElementType();
+        ORT_ENFORCE(utils::CApiElementTypeFromProtoType(requested_onnx_tensor_element_type) == actual_element_type,
+                    "Requested and actual output tensor element types do not match. Requested: ",
+                    utils::CApiElementTypeFromProtoType(requested_onnx_tensor_element_type),
+                    ", actual: ", actual_element_type);
+
+        return output_tensor.GetTensorMutableRawData();
+      };
+
+      for (size_t i = 0; i < model_outputs.size(); i++) {
+        const auto& output_name = model_outputs[i];
+        const auto& output_info = model->GetInputOutputInfo(output_name);
+        auto output_shape = output_info.shape;
+        auto output_type = output_info.data_type;
+
+        // Since CoreML EP use {1} MLMultiArray as scalar, if the model output should have empty shape
+        // We are going to replace the {1} shape of the output back to {}
+        if (model->IsScalarOutput(output_name)) {
+          output_shape.clear();
         }
 
-        return model->Predict(inputs, outputs, get_output_tensor_mutable_raw_data_fn);
+        // Since CoreML EP only accepts int32 output type and onnx requires int64 output,
+        // We are going to set the model output (from int32) ->int64
+        if (model->IsInt64Output(output_name)) {
+          output_type = ONNX_NAMESPACE::TensorProto_DataType_INT64;
+        }
+
+        outputs.emplace(output_name, coreml::OnnxTensorInfo{output_type, output_shape});
       }
+
+      return model->Predict(inputs, outputs, get_output_tensor_mutable_raw_data_fn);
     };
 
     node_compute_funcs.push_back(compute_info);
@@ -53,13 +53,17 @@ class Model {
         std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
         std::unordered_set<std::string>&& scalar_outputs,
         std::unordered_set<std::string>&& int64_outputs,
-        const logging::Logger& logger, uint32_t coreml_flags);
+        const logging::Logger& logger, uint32_t coreml_flags,
+        const std::string& model_cache_key = {});
 
   ~Model();
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Model);
 
+  // Compile and load the model. When `model_cache_key` is not empty the compiled model is reused from, or added to,
+  // the model cache (COREML_FLAG_ENABLE_MODEL_CACHE).
   Status LoadModel();
 
+  // Predictions run concurrently when the OS supports the async prediction API, and are serialized otherwise.
   Status Predict(const std::unordered_map<std::string, OnnxTensorData>& inputs,
                  const std::unordered_map<std::string, OnnxTensorInfo>& outputs,
                  const GetOutputTensorMutableRawDataFn& get_output_tensor_mutable_raw_data_fn);
@@ -72,9 +76,6 @@ class Model {
     return Contains(int64_outputs_, output_name);
   }
 
-  // Mutex for exclusive lock to this model object
-  OrtMutex& GetMutex() { return mutex_; }
-
   // Input and output names in the ORT fused node's order.
   // Names may have been adjusted from the originals due to CoreML naming rules.
   // We do inputs/outputs based on order at the ONNX level so this doesn't matter.
@@ -101,6 +102,7 @@ class Model {
   std::unordered_set<std::string> scalar_outputs_;
   std::unordered_set<std::string> int64_outputs_;
 
+  // serializes the predictions when they can't run concurrently
   OrtMutex mutex_;
 };
 
@@ -245,6 +245,56 @@ Status CopyMLMultiArrayBuffer(const void* mlmultiarray_buffer, void* tensor_buff
   }
   return Status::OK();
 }
+
+// Location of the compiled model with `model_cache_key` in the model cache, or nil if there is no caches directory.
+// The compiled models are kept per OS version, as the compilation depends on the CoreML framework.
+NSURL* _Nullable GetCachedCompiledModelURL(NSString* _Nonnull model_cache_key) {
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  NSURL* caches_directory_url = [[file_manager URLsForDirectory:NSCachesDirectory
+                                                      inDomains:NSUserDomainMask] firstObject];
+  if (caches_directory_url == nil) {
+    return nil;
+  }
+
+  NSCharacterSet* invalid_characters = [[NSCharacterSet alphanumericCharacterSet] invertedSet];
+  NSString* os_version = [[[[NSProcessInfo processInfo] operatingSystemVersionString]
+      componentsSeparatedByCharactersInSet:invalid_characters] componentsJoinedByString:@"_"];
+
+  NSURL* model_cache_url = [caches_directory_url URLByAppendingPathComponent:@"onnxruntime-coreml" isDirectory:YES];
+  NSURL* os_version_url = [model_cache_url URLByAppendingPathComponent:os_version isDirectory:YES];
+  return [os_version_url URLByAppendingPathComponent:[model_cache_key stringByAppendingString:@".mlmodelc"]
+                                         isDirectory:YES];
+}
+
+// Move the compiled model at `compiled_model_url` to `cached_model_url` in the model cache.
+// The compiled models of the other OS versions can't be used anymore and are removed.
+bool AddCompiledModelToCache(NSURL* _Nonnull compiled_model_url, NSURL* _Nonnull cached_model_url,
+                             const logging::Logger& logger) {
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  NSURL* os_version_url = [cached_model_url URLByDeletingLastPathComponent];
+  NSURL* model_cache_url = [os_version_url URLByDeletingLastPathComponent];
+  NSError* error = nil;
+
+  NSArray<NSURL*>* cached_os_versions = [file_manager contentsOfDirectoryAtURL:model_cache_url
+                                                    includingPropertiesForKeys:nil
+                                                                       options:0
+                                                                         error:nil];
+  for (NSURL* cached_os_version_url in cached_os_versions) {
+    if (![[cached_os_version_url lastPathComponent] isEqualToString:[os_version_url lastPathComponent]]) {
+      [file_manager removeItemAtURL:cached_os_version_url error:nil];
+    }
+  }
+
+  if (![file_manager createDirectoryAtURL:os_version_url withIntermediateDirectories:YES attributes:nil error:&error] ||
+      ![file_manager moveItemAtURL:compiled_model_url toURL:cached_model_url error:&error]) {
+    // e.g. another session added the same model first
+    LOGS(logger, INFO) << "Failed to add the compiled model to the model cache: " << [[cached_model_url path] UTF8String]
+                       << (error != nil ? MakeString(", error: ", [[error localizedDescription] UTF8String]) : "");
+    return false;
+  }
+
+  return true;
+}
 }  // namespace
 
 NS_ASSUME_NONNULL_BEGIN
@@ -256,13 +306,15 @@ NS_ASSUME_NONNULL_BEGIN
 @interface CoreMLExecution : NSObject {
   NSString* coreml_model_path_;
   NSString* compiled_model_path_;
+  NSString* _Nullable model_cache_key_;
   const logging::Logger* logger_;
   uint32_t coreml_flags_;
 }
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags;
+                coreml_flags:(uint32_t)coreml_flags
+             model_cache_key:(const std::string&)model_cache_key;
 - (void)cleanup;
 - (void)dealloc;
 - (Status)loadModel API_AVAILABLE_COREML3;
@@ -270,6 +322,10 @@ NS_ASSUME_NONNULL_BEGIN
                   outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
     getOutputTensorDataFn:(const GetOutputTensorMutableRawDataFn&)get_output_tensor_mutable_raw_data_fn
     API_AVAILABLE_COREML3;
+- (Status)setOutputBackings:(MLPredictionOptions*)options
+                      outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
+        getOutputTensorDataFn:(const GetOutputTensorMutableRawDataFn&)get_output_tensor_mutable_raw_data_fn
+    API_AVAILABLE_COREML6;
 
 @property(nullable) MLModel* model API_AVAILABLE_COREML3;
 
@@ -279,9 +335,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype)initWithPath:(const std::string&)path
                       logger:(const logging::Logger&)logger
-                coreml_flags:(uint32_t)coreml_flags {
+                coreml_flags:(uint32_t)coreml_flags
+             model_cache_key:(const std::string&)model_cache_key {
   if (self = [super init]) {
     coreml_model_path_ = util::Utf8StringToNSString(path.c_str());
+    model_cache_key_ = model_cache_key.empty() ? nil : util::Utf8StringToNSString(model_cache_key.c_str());
     logger_ = &logger;
     coreml_flags_ = coreml_flags;
   }
@@ -333,6 +391,25 @@ NS_ASSUME_NONNULL_BEGIN
   // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
   // background. We will have to check for completion in `predict` and block until it is done.
   NSError* error = nil;
+  MLModelConfiguration* config = [[MLModelConfiguration alloc] init];
+  config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
+                            ? MLComputeUnitsCPUOnly
+                            : MLComputeUnitsAll;
+
+  NSURL* cached_model_url = model_cache_key_ != nil ? GetCachedCompiledModelURL(model_cache_key_) : nil;
+  if (cached_model_url != nil && [[NSFileManager defaultManager] fileExistsAtPath:[cached_model_url path]]) {
+    _model = [MLModel modelWithContentsOfURL:cached_model_url configuration:config error:&error];
+    if (_model != nil) {
+      LOGS(*logger_, INFO) << "Loaded the compiled model from the model cache: " << [[cached_model_url path] UTF8String];
+      return Status::OK();
+    }
+
+    LOGS(*logger_, WARNING) << "Failed to load the compiled model from the model cache, compiling the model again"
+                            << (error != nil ? MakeString(", error: ", [[error localizedDescription] UTF8String]) : "");
+    [[NSFileManager defaultManager] removeItemAtURL:cached_model_url error:nil];
+    error = nil;
+  }
+
   NSURL* compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
 
   if (error != nil) {
@@ -340,12 +417,13 @@ NS_ASSUME_NONNULL_BEGIN
                            [[error localizedDescription] UTF8String]);
   }
 
-  compiled_model_path_ = [compileUrl path];
+  if (cached_model_url != nil && AddCompiledModelToCache(compileUrl, cached_model_url, *logger_)) {
+    // the compiled model is owned by the cache and outlives this execution
+    compileUrl = cached_model_url;
+  } else {
+    compiled_model_path_ = [compileUrl path];
+  }
 
-  MLModelConfiguration* config = [MLModelConfiguration alloc];
-  config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
-                            ? MLComputeUnitsCPUOnly
-                            : MLComputeUnitsAll;
   _model = [MLModel modelWithContentsOfURL:compileUrl configuration:config error:&error];
 
   if (error != nil || _model == nil) {
@@ -370,14 +448,34 @@ NS_ASSUME_NONNULL_BEGIN
     ORT_RETURN_IF_ERROR(CreateInputFeatureProvider(inputs, *logger_, &input_features, conversion_buffers));
 
     MLPredictionOptions* options = [[MLPredictionOptions alloc] init];
-    NSError* error = nil;
-    id<MLFeatureProvider> output_features = [_model predictionFromFeatures:input_features
-                                                                   options:options
-                                                                     error:&error];
+    if (HAS_COREML6_OR_LATER) {
+      ORT_RETURN_IF_ERROR([self setOutputBackings:options
+                                          outputs:outputs
+                            getOutputTensorDataFn:get_output_tensor_mutable_raw_data_fn]);
+    }
 
-    if (error != nil) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error executing model: ",
-                             [[error localizedDescription] UTF8String]);
+    __block NSError* error = nil;
+    __block id<MLFeatureProvider> output_features = nil;
+    if (HAS_COREML7_OR_LATER) {
+      // the async API allows concurrent predictions with the model
+      dispatch_semaphore_t prediction_done = dispatch_semaphore_create(0);
+      [_model predictionFromFeatures:input_features
+                             options:options
+                   completionHandler:^(id<MLFeatureProvider> _Nullable prediction, NSError* _Nullable prediction_error) {
+                     output_features = prediction;
+                     error = prediction_error;
+                     dispatch_semaphore_signal(prediction_done);
+                   }];
+      dispatch_semaphore_wait(prediction_done, DISPATCH_TIME_FOREVER);
+    } else {
+      output_features = [_model predictionFromFeatures:input_features
+                                               options:options
+                                                 error:&error];
+    }
+
+    if (error != nil || output_features == nil) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error executing model",
+                             (error != nil) ? MakeString(": ", [[error localizedDescription] UTF8String]) : "");
     }
 
     for (const auto& [output_name, output_tensor_info] : outputs) {
@@ -426,10 +524,13 @@ NS_ASSUME_NONNULL_BEGIN
         // `getBytesWithHandler` replaces deprecated `.dataPointer` on new versions
         if (@available(macOS 12.3, iOS 15.4, *)) {
           [data getBytesWithHandler:^(const void* bytes, NSInteger size) {
-            copy_status = CopyMLMultiArrayBuffer(bytes, output_buffer, data,
-                                                 num_blocks, block_size, stride, tensor_info);
+            // nothing to copy when CoreML wrote the output to the ORT tensor (output backing)
+            if (bytes != output_buffer) {
+              copy_status = CopyMLMultiArrayBuffer(bytes, output_buffer, data,
+                                                   num_blocks, block_size, stride, tensor_info);
+            }
           }];
-        } else {
+        } else if (data.dataPointer != output_buffer) {
           copy_status = CopyMLMultiArrayBuffer(data.dataPointer, output_buffer, data,
                                                num_blocks, block_size, stride, tensor_info);
         }
@@ -447,6 +548,75 @@ NS_ASSUME_NONNULL_BEGIN
   return status;
 }
 
+// Let CoreML write the outputs directly to the ORT output tensors, when their shape and type are known before the
+// prediction and match the model description.
+- (Status)setOutputBackings:(MLPredictionOptions*)options
+                      outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
+        getOutputTensorDataFn:(const GetOutputTensorMutableRawDataFn&)get_output_tensor_mutable_raw_data_fn {
+  NSMutableDictionary<NSString*, id>* output_backings = [NSMutableDictionary dictionaryWithCapacity:outputs.size()];
+  NSDictionary<NSString*, MLFeatureDescription*>* output_descriptions = _model.modelDescription.outputDescriptionsByName;
+
+  for (const auto& [output_name, output_tensor_info] : outputs) {
+    const auto& shape = output_tensor_info.shape;
+    // scalars are [1] in CoreML, and int64 outputs are converted from int32
+    if (shape.empty() || !IsStaticShape(shape)) {
+      continue;
+    }
+
+    MLMultiArrayDataType data_type;
+    if (output_tensor_info.data_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+      data_type = MLMultiArrayDataTypeFloat32;
+    } else if (output_tensor_info.data_type == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+      data_type = MLMultiArrayDataTypeInt32;
+    } else {
+      continue;
+    }
+
+    NSString* name = util::Utf8StringToNSString(output_name.c_str());
+    MLMultiArrayConstraint* constraint = output_descriptions[name].multiArrayConstraint;
+    if (constraint == nil || constraint.dataType != data_type || constraint.shape.count != shape.size()) {
+      continue;
+    }
+
+    NSMutableArray* shape_array = [NSMutableArray arrayWithCapacity:shape.size()];
+    bool shape_matches = true;
+    for (size_t i = 0; i < shape.size(); ++i) {
+      shape_matches = shape_matches && constraint.shape[i].longLongValue == shape[i];
+      [shape_array addObject:[NSNumber numberWithLongLong:shape[i]]];
+    }
+
+    if (!shape_matches) {
+      continue;
+    }
+
+    NSMutableArray* strides_array = [NSMutableArray arrayWithCapacity:shape.size()];
+    int64_t stride = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+      [strides_array insertObject:[NSNumber numberWithLongLong:stride] atIndex:0];
+      stride *= shape[i - 1];
+    }
+
+    void* output_buffer = get_output_tensor_mutable_raw_data_fn(output_name, output_tensor_info.data_type, shape);
+
+    NSError* error = nil;
+    MLMultiArray* output_backing = [[MLMultiArray alloc] initWithDataPointer:output_buffer
+                                                                       shape:shape_array
+                                                                    dataType:data_type
+                                                                     strides:strides_array
+                                                                 deallocator:^(void* /* bytes */) {
+                                                                 }
+                                                                       error:&error];
+    ORT_RETURN_IF(error != nil || output_backing == nil,
+                  "Failed to create the output backing of: ", output_name,
+                  (error != nil) ? MakeString(", error: ", [[error localizedDescription] UTF8String]) : "");
+
+    output_backings[name] = output_backing;
+  }
+
+  options.outputBackings = output_backings;
+  return Status::OK();
+}
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -501,10 +671,14 @@ Status GetMLMultiArrayCopyInfo(const MLMultiArray* _Nonnull array,
 // This class will bridge Model (c++) with CoreMLExecution (objective c++)
 class Execution {
  public:
-  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags);
+  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+            const std::string& model_cache_key);
   ~Execution() {};
 
   Status LoadModel();
+
+  // Whether Predict can be called concurrently, with the async prediction API
+  bool SupportsConcurrentPredictions() const;
   Status Predict(const std::unordered_map<std::string, OnnxTensorData>& inputs,
                  const std::unordered_map<std::string, OnnxTensorInfo>& outputs,
                  const GetOutputTensorMutableRawDataFn& get_output_tensor_mutable_raw_data_fn);
@@ -514,14 +688,24 @@ class Execution {
   CoreMLExecution* execution_;
 };
 
-Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags) {
+Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags,
+                     const std::string& model_cache_key) {
   @autoreleasepool {
     execution_ = [[CoreMLExecution alloc] initWithPath:path
                                                 logger:logger
-                                          coreml_flags:coreml_flags];
+                                          coreml_flags:coreml_flags
+                                       model_cache_key:model_cache_key];
   }
 }
 
+bool Execution::SupportsConcurrentPredictions() const {
+  if (HAS_COREML7_OR_LATER) {
+    return true;
+  }
+
+  return false;
+}
+
 Status Execution::LoadModel() {
   if (model_loaded) {
     return Status::OK();
@@ -562,8 +746,9 @@ Model::Model(const std::string& path,
              std::unordered_set<std::string>&& scalar_outputs,
              std::unordered_set<std::string>&& int64_outputs,
              const logging::Logger& logger,
-             uint32_t coreml_flags)
-    : execution_(std::make_unique<Execution>(path, logger, coreml_flags)),
+             uint32_t coreml_flags,
+             const std::string& model_cache_key)
+    : execution_(std::make_unique<Execution>(path, logger, coreml_flags, model_cache_key)),
       model_input_names_(std::move(model_input_names)),
       model_output_names_(std::move(model_output_names)),
       input_output_info_(std::move(input_output_info)),
@@ -580,6 +765,11 @@ Status Model::LoadModel() {
 Status Model::Predict(const std::unordered_map<std::string, OnnxTensorData>& inputs,
                       const std::unordered_map<std::string, OnnxTensorInfo>& outputs,
                       const GetOutputTensorMutableRawDataFn& get_output_tensor_mutable_raw_data_fn) {
+  if (execution_->SupportsConcurrentPredictions()) {
+    return execution_->Predict(inputs, outputs, get_output_tensor_mutable_raw_data_fn);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
   return execution_->Predict(inputs, outputs, get_output_tensor_mutable_raw_data_fn);
 }
 }  // namespace coreml
@@ -151,6 +151,9 @@ struct Sigmoid : public ElementWiseRangedTransform<T> {
 template <>
 void Sigmoid<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
 
+template <>
+void Sigmoid<MLFloat16>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
 template <typename T>
 struct Softsign : public ElementWiseRangedTransform<T> {
   Status Init(const onnxruntime::NodeAttributes&) {
@@ -201,6 +204,9 @@ struct Tanh : public ElementWiseRangedTransform<T> {
 template <>
 void Tanh<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
 
+template <>
+void Tanh<MLFloat16>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
 template <typename T>
 struct ThresholdedRelu : public ElementWiseRangedTransform<T> {
   ORT_GET_FLOAT_ATTR_AND_RETURN(alpha);
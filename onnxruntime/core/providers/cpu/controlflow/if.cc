@@ -270,6 +270,8 @@ Status If::Compute(OpKernelContext* ctx) const {
   auto attribute = condition ? "then_branch" : "else_branch";
   auto* session_state = ctx_internal->SubgraphSessionState(attribute);
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for '", attribute, "' attribute.");
+  // the branch may be initialized lazily
+  ORT_RETURN_IF_ERROR(session_state->EnsureFinalized());
 
   const auto& info = condition ? then_info_ : else_info_;
   IfImpl impl{*ctx_internal, *session_state, *info};
@@ -438,7 +440,8 @@ Status IfImpl::Execute(const FeedsFetchesManager& ffm) {
 
   status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                   ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(),
-                                  context_.Logger(), context_.GetComputeStream());
+                                  context_.Logger(), context_.GetComputeStream(),
+                                  /*sync_subgraph_fetches*/ false, context_.GetOperatorThreadPool());
 
   ORT_RETURN_IF_ERROR(status);
 
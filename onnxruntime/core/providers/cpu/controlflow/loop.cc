@@ -23,6 +23,7 @@
 #include "core/framework/TensorSeq.h"
 #include "core/providers/utils.h"
 
+#include <algorithm>
 #include <gsl/gsl>
 
 #ifdef _MSC_VER
@@ -193,6 +194,11 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  const Node* condition_producer = subgraph.GetProducerNode(subgraph_output_names[0]);
+  passes_condition_through = subgraph_output_names[0] == subgraph_input_names[1] ||
+                             (condition_producer != nullptr && condition_producer->OpType() == "Identity" &&
+                              condition_producer->InputDefs()[0]->Name() == subgraph_input_names[1]);
 }
 
 class LoopImpl {
@@ -211,11 +217,20 @@ class LoopImpl {
 
  private:
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  void SaveOutputsAndUpdateFeeds(std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // With a fixed trip count the Loop outputs of the scan outputs are allocated in the first iteration, and the
+  // subgraph writes the scan outputs of each iteration to their slice of the Loop outputs.
+  Status AllocateScanOutput(int scan_output_index, const TensorShape& per_iteration_shape);
+  OrtValue GetScanOutputSlice(int scan_output_index, int64_t iteration) const;
+  void SetupScanOutputFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                              std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+  // copies the scan outputs that the subgraph didn't write to their slice, e.g. an input of the subgraph
+  Status SaveScanOutputs(const std::vector<OrtValue>& fetches, int64_t iteration);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -232,6 +247,11 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // the Loop runs for exactly max_trip_count_ iterations
+  bool fixed_trip_count_ = false;
+  // the Loop outputs for the scan outputs when fixed_trip_count_ is set
+  std::vector<Tensor*> scan_outputs_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -359,6 +379,16 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
   utils::FinalizeFeedFetchCopyInfo(*ffm, feed_locations, fetch_locations);
 
+  // the condition is known on CPU when the subgraph passes it through, so unless a loop carried var or a scan output
+  // is copied from a device to CPU the next iteration can be queued on the stream without waiting for this one.
+  if (info_->passes_condition_through) {
+    const auto& fetch_copy_info = ffm->GetFetchesDeviceCopyInfo();
+    info_->sync_subgraph_fetches = std::any_of(
+        fetch_copy_info.cbegin() + 1, fetch_copy_info.cend(), [](const MLValueCopyInfo& copy_info) {
+          return copy_info.target_device.Type() == OrtDevice::CPU && copy_info.source_device.Type() != OrtDevice::CPU;
+        });
+  }
+
   feeds_fetches_manager_ = std::move(ffm);
 
   return Status::OK();
@@ -432,7 +462,14 @@ Status LoopImpl::Initialize() {
   iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(cpu_allocator, 0, iter_num_rank != 0);
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank != 0);
 
-  loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+  const auto num_scan_outputs = static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars;
+  fixed_trip_count_ = info_.passes_condition_through && max_trip_count_tensor != nullptr && condition_ &&
+                      max_trip_count_ > 0 && num_scan_outputs > 0;
+  if (fixed_trip_count_) {
+    scan_outputs_.resize(num_scan_outputs, nullptr);
+  } else {
+    loop_output_tensors_.resize(num_scan_outputs);
+  }
 
   return status;
 }
@@ -455,14 +492,25 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
+void LoopImpl::SaveOutputsAndUpdateFeeds(std::vector<OrtValue>& last_outputs,
                                          std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
-  // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
+  // move cond and loop carried vars. start at 1 to skip iter_num in input.
+  // cond is also held by condition_mlvalue_.
   for (ptrdiff_t i = 1; i < info_.num_subgraph_inputs; ++i) {
-    next_inputs[i] = last_outputs[i - 1];
+    next_inputs[i] = std::move(last_outputs[i - 1]);
+  }
+
+  if (!info_.sync_subgraph_fetches) {
+    // the copy of the passed through 'cond' to CPU may not have completed
+    next_inputs[1] = condition_mlvalue_;
+  }
+
+  if (fixed_trip_count_) {
+    // the scan outputs were written to the Loop outputs.
+    return;
   }
 
   // save loop outputs as we have to concatenate at the end
@@ -492,11 +540,102 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+Status LoopImpl::AllocateScanOutput(int scan_output_index, const TensorShape& per_iteration_shape) {
+  std::vector<int64_t> dims;
+  dims.reserve(1 + per_iteration_shape.NumDimensions());
+
+  // first dimension is number of iterations
+  dims.push_back(max_trip_count_);
+  const auto per_iteration_dims = per_iteration_shape.GetDims();
+  std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+
+  Tensor* output = context_.Output(info_.num_loop_carried_vars + scan_output_index, TensorShape(dims));
+  ORT_RETURN_IF(output == nullptr, "Failed to allocate Loop output ", info_.num_loop_carried_vars + scan_output_index);
+  scan_outputs_[scan_output_index] = output;
+
+  return Status::OK();
+}
+
+OrtValue LoopImpl::GetScanOutputSlice(int scan_output_index, int64_t iteration) const {
+  Tensor& output = *scan_outputs_[scan_output_index];
+  const size_t bytes_per_iteration = output.SizeInBytes() / static_cast<size_t>(max_trip_count_);
+
+  OrtValue slice;
+  Tensor::InitOrtValue(output.DataType(), output.Shape().Slice(1),
+                       static_cast<gsl::byte*>(output.MutableDataRaw()) + iteration * bytes_per_iteration,
+                       output.Location(), slice);
+  return slice;
+}
+
+void LoopImpl::SetupScanOutputFetches(int64_t iteration, std::vector<OrtValue>& fetches,
+                                      std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  fetches.resize(info_.num_subgraph_outputs);
+
+  for (int j = 0, end = static_cast<int>(scan_outputs_.size()); j < end; ++j) {
+    const size_t fetch_index = static_cast<size_t>(info_.num_loop_carried_vars) + j + 1;  // skip cond
+
+    // forward the allocation of the scan output to its slice of the Loop output. the Loop output is allocated in the
+    // first iteration, adding the trip count dimension. if the slice is not on the device the subgraph writes the
+    // output to, SaveScanOutputs copies it there.
+    fetch_allocators[fetch_index] = [this, j, iteration](const TensorShape& shape, const OrtDevice& location,
+                                                         OrtValue& ort_value, bool& allocated) {
+      if (scan_outputs_[j] == nullptr) {
+        ORT_RETURN_IF_ERROR(AllocateScanOutput(j, shape));
+      }
+
+      OrtValue slice = GetScanOutputSlice(j, iteration);
+      const auto& slice_data = slice.Get<Tensor>();
+      if (slice_data.Shape() != shape) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                               " Expected:", slice_data.Shape(), " Got:", shape);
+      }
+
+      if (slice_data.Location().device == location) {
+        ort_value = std::move(slice);
+        allocated = true;
+      }
+
+      return Status::OK();
+    };
+  }
+}
+
+Status LoopImpl::SaveScanOutputs(const std::vector<OrtValue>& fetches, int64_t iteration) {
+  for (int j = 0, end = static_cast<int>(scan_outputs_.size()); j < end; ++j) {
+    const OrtValue& fetch = fetches[static_cast<size_t>(info_.num_loop_carried_vars) + j + 1];  // skip cond
+    ORT_RETURN_IF_NOT(fetch.IsTensor(), "All scan outputs MUST be tensors");
+    const auto& iteration_data = fetch.Get<Tensor>();
+
+    if (scan_outputs_[j] == nullptr) {
+      ORT_RETURN_IF_ERROR(AllocateScanOutput(j, iteration_data.Shape()));
+    }
+
+    OrtValue slice = GetScanOutputSlice(j, iteration);
+    auto& slice_data = *slice.GetMutable<Tensor>();
+    if (iteration_data.DataRaw() == slice_data.DataRaw()) {
+      continue;
+    }
+
+    if (iteration_data.Shape() != slice_data.Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                             " Expected:", slice_data.Shape(), " Got:", iteration_data.Shape());
+    }
+
+    std::vector<OrtValue> per_iteration_output{fetch};
+    Stream* ort_stream = context_.GetComputeStream();
+    ORT_RETURN_IF_ERROR(concat_output_func_(ort_stream ? ort_stream->GetHandle() : nullptr, per_iteration_output,
+                                            slice_data.MutableDataRaw(), slice_data.SizeInBytes()));
+  }
+
+  return Status::OK();
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
 
   CreateInitialFeeds(feeds);
 
@@ -508,15 +647,26 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    if (fixed_trip_count_) {
+      SetupScanOutputFetches(iter_num_value, fetches, fetch_allocators);
+    }
+
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
-                                    // have to perofrm a stream sync to make sure the data arrived.
-                                    true);
+                                    // have to perofrm a stream sync to make sure the data arrived, unless the
+                                    // subgraph passes the condition through.
+                                    info_.sync_subgraph_fetches, context_.GetOperatorThreadPool());
     ORT_RETURN_IF_ERROR(status);
 
-    condition_mlvalue_ = fetches[0];
+    if (info_.sync_subgraph_fetches) {
+      condition_mlvalue_ = fetches[0];
+    }
+
+    if (fixed_trip_count_) {
+      ORT_RETURN_IF_ERROR(SaveScanOutputs(fetches, iter_num_value));
+    }
 
     ++iter_num_value;
   }
@@ -593,7 +743,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
     }
 
-    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs && !fixed_trip_count_; ++i) {
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
       per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
@@ -38,6 +38,14 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // the 'cond' output of the subgraph is its 'cond' input, so the Loop runs for the whole trip count when the
+    // condition starts as true
+    bool passes_condition_through;
+
+    // the stream is synchronized after each iteration so the 'cond' output and the other outputs copied to CPU can
+    // be read. set by SetupSubgraphExecutionInfo.
+    bool sync_subgraph_fetches = true;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
@@ -272,7 +272,8 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     // Create Executor and run graph.
     status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger(),
-                                    context.GetComputeStream());
+                                    context.GetComputeStream(),
+                                    /*sync_subgraph_fetches*/ false, context.GetOperatorThreadPool());
 
     ORT_RETURN_IF_ERROR(status);
 
@@ -11,6 +11,8 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // NUMA node to place the allocator's memory on, -1 for no NUMA placement.
+  int numa_node{-1};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -31,6 +33,7 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
+  std::vector<MatMulNBitsFormat> GetMatMulNBitsFormats() const override;
 
  private:
   CPUExecutionProviderInfo info_;
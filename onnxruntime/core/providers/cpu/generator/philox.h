@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace philox {
+
+// Philox4x32-10, the counter-based generator of Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", which
+// is also what the CUDA kernels draw from (curand's Philox_4x32_10). Each 128 bit counter is turned into a block of
+// four 32 bit random words, independently of any other counter, so a tensor can be filled in any order and split
+// between any number of threads and still get the same values for a given seed.
+//
+// The counter of block `i` of a stream is {lo(i), hi(i), lo(offset), hi(offset)} and the key is the seed, so every
+// (seed, offset) pair given by PhiloxGenerator::NextPhiloxSeeds() is a stream of 2^64 blocks of its own.
+
+constexpr size_t kWordsPerBlock = 4;
+
+// The number of blocks that are computed together. The rounds are written over arrays of this many lanes so that
+// the compiler generates them with vector instructions.
+constexpr size_t kLanes = 8;
+
+using Block = std::array<uint32_t, kWordsPerBlock>;
+
+namespace detail {
+constexpr uint32_t kMultiplier0 = 0xD2511F53;
+constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+constexpr uint32_t kWeyl0 = 0x9E3779B9;
+constexpr uint32_t kWeyl1 = 0xBB67AE85;
+constexpr int kRounds = 10;
+}  // namespace detail
+
+// Computes the blocks [first_block, first_block + kLanes) of the stream of (seed, offset).
+// words[w][l] is word w of block first_block + l.
+inline void ComputeBlocks(uint64_t seed, uint64_t offset, uint64_t first_block,
+                          uint32_t (&words)[kWordsPerBlock][kLanes]) {
+  uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+  for (size_t l = 0; l < kLanes; ++l) {
+    const uint64_t block = first_block + l;
+    c0[l] = static_cast<uint32_t>(block);
+    c1[l] = static_cast<uint32_t>(block >> 32);
+    c2[l] = static_cast<uint32_t>(offset);
+    c3[l] = static_cast<uint32_t>(offset >> 32);
+  }
+
+  uint32_t k0 = static_cast<uint32_t>(seed);
+  uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+  for (int round = 0; round < detail::kRounds; ++round) {
+    for (size_t l = 0; l < kLanes; ++l) {
+      const uint64_t product0 = uint64_t{detail::kMultiplier0} * c0[l];
+      const uint64_t product1 = uint64_t{detail::kMultiplier1} * c2[l];
+      const uint32_t n0 = static_cast<uint32_t>(product1 >> 32) ^ c1[l] ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(product0 >> 32) ^ c3[l] ^ k1;
+      c1[l] = static_cast<uint32_t>(product1);
+      c3[l] = static_cast<uint32_t>(product0);
+      c0[l] = n0;
+      c2[l] = n2;
+    }
+    k0 += detail::kWeyl0;
+    k1 += detail::kWeyl1;
+  }
+
+  std::copy(std::begin(c0), std::end(c0), words[0]);
+  std::copy(std::begin(c1), std::end(c1), words[1]);
+  std::copy(std::begin(c2), std::end(c2), words[2]);
+  std::copy(std::begin(c3), std::end(c3), words[3]);
+}
+
+// The Philox4x32-10 block of a single counter and key.
+inline Block ComputeBlock(const Block& counter, uint64_t key) {
+  uint32_t words[kWordsPerBlock][kLanes];
+  const uint64_t block = counter[0] | (uint64_t{counter[1]} << 32);
+  const uint64_t offset = counter[2] | (uint64_t{counter[3]} << 32);
+  ComputeBlocks(key, offset, block, words);
+  return {words[0][0], words[1][0], words[2][0], words[3][0]};
+}
+
+// A float in [0, 1) from the high 24 bits of a word.
+inline float ToUniformFloat(uint32_t word) {
+  return static_cast<float>(word >> 8) * (1.0f / 16777216.0f);
+}
+
+// A double in [0, 1) from the high 53 bits of two words.
+inline double ToUniformDouble(uint32_t high, uint32_t low) {
+  const uint64_t bits = (uint64_t{high} << 32) | low;
+  return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Fills `out` with the values that `transform` makes of the random words. Block i of the stream of `seeds` makes the
+// values out[i * kValuesPerBlock, (i + 1) * kValuesPerBlock): `transform(const Block& block, T* values)` writes
+// kValuesPerBlock values.
+template <typename T, size_t kValuesPerBlock, typename Transform>
+void Fill(std::pair<uint64_t, uint64_t> seeds, gsl::span<T> out, concurrency::ThreadPool* thread_pool,
+          const Transform& transform) {
+  static_assert(kValuesPerBlock > 0 && kValuesPerBlock <= kWordsPerBlock);
+  constexpr size_t kValuesPerGroup = kValuesPerBlock * kLanes;
+
+  const size_t size = out.size();
+  const std::ptrdiff_t num_groups = static_cast<std::ptrdiff_t>((size + kValuesPerGroup - 1) / kValuesPerGroup);
+  const TensorOpCost cost{0, static_cast<double>(sizeof(T) * kValuesPerGroup), 20.0 * kLanes};
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_groups, cost,
+      [seeds, out, size, &transform](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        uint32_t words[kWordsPerBlock][kLanes];
+        for (std::ptrdiff_t group = begin; group < end; ++group) {
+          const size_t first_block = static_cast<size_t>(group) * kLanes;
+          ComputeBlocks(seeds.first, seeds.second, first_block, words);
+          for (size_t l = 0; l < kLanes; ++l) {
+            const size_t first_value = (first_block + l) * kValuesPerBlock;
+            if (first_value >= size) {
+              break;
+            }
+
+            const Block block{words[0][l], words[1][l], words[2][l], words[3][l]};
+            if (first_value + kValuesPerBlock <= size) {
+              transform(block, out.data() + first_value);
+            } else {
+              T values[kValuesPerBlock];
+              transform(block, values);
+              std::copy_n(values, size - first_value, out.data() + first_value);
+            }
+          }
+        }
+      });
+}
+
+// Uniformly distributed values in [low, high).
+template <typename T>
+void FillUniform(std::pair<uint64_t, uint64_t> seeds, T low, T high, gsl::span<T> out,
+                 concurrency::ThreadPool* thread_pool) {
+  const T range = high - low;
+  if constexpr (std::is_same_v<T, double>) {
+    Fill<T, 2>(seeds, out, thread_pool, [low, range](const Block& block, T* values) {
+      values[0] = low + range * ToUniformDouble(block[0], block[1]);
+      values[1] = low + range * ToUniformDouble(block[2], block[3]);
+    });
+  } else {
+    static_assert(std::is_same_v<T, float>);
+    Fill<T, 4>(seeds, out, thread_pool, [low, range](const Block& block, T* values) {
+      for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        values[i] = low + range * ToUniformFloat(block[i]);
+      }
+    });
+  }
+}
+
+// Normally distributed values, from uniform pairs with the Box-Muller transform.
+template <typename T>
+void FillNormal(std::pair<uint64_t, uint64_t> seeds, T mean, T scale, gsl::span<T> out,
+                concurrency::ThreadPool* thread_pool) {
+  constexpr T kTwoPi = static_cast<T>(6.283185307179586);
+
+  // u1 is taken from (0, 1] so that its log is finite
+  auto box_muller = [mean, scale](T u1, T u2, T* values) {
+    const T radius = scale * std::sqrt(T{-2} * std::log(u1));
+    values[0] = mean + radius * std::cos(kTwoPi * u2);
+    values[1] = mean + radius * std::sin(kTwoPi * u2);
+  };
+
+  if constexpr (std::is_same_v<T, double>) {
+    Fill<T, 2>(seeds, out, thread_pool, [&box_muller](const Block& block, T* values) {
+      box_muller(1.0 - ToUniformDouble(block[0], block[1]), ToUniformDouble(block[2], block[3]), values);
+    });
+  } else {
+    static_assert(std::is_same_v<T, float>);
+    Fill<T, 4>(seeds, out, thread_pool, [&box_muller](const Block& block, T* values) {
+      box_muller(1.0f - ToUniformFloat(block[0]), ToUniformFloat(block[1]), values);
+      box_muller(1.0f - ToUniformFloat(block[2]), ToUniformFloat(block[3]), values + 2);
+    });
+  }
+}
+
+}  // namespace philox
+}  // namespace onnxruntime
@@ -28,6 +28,7 @@ limitations under the License.
 #include "core/common/eigen_common_wrapper.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/providers/cpu/generator/philox.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
 
@@ -126,11 +127,10 @@ ONNX_CPU_OPERATOR_KERNEL(
                         BuildKernelDefConstraintsFromTypeList<EnabledMultinomialOutputTypes>()),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
-
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                  concurrency::ThreadPool* thread_pool, Tensor& Y);
+static Status RandomUniformCompute(float low, float high, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                   concurrency::ThreadPool* thread_pool, Tensor& Y);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -138,8 +138,7 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, ctx->GetOperatorThreadPool(), Y);
 
   return status;
 }
@@ -147,8 +146,7 @@ Status RandomNormal::Compute(OpKernelContext* ctx) const {
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, ctx->GetOperatorThreadPool(), Y);
 
   return status;
 }
@@ -169,8 +167,7 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
+  status = RandomNormalCompute(mean_, scale_, generator_, dtype, ctx->GetOperatorThreadPool(), *Y);
 
   return status;
 }
@@ -190,8 +187,7 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
+  status = RandomUniformCompute(low_, high_, generator_, dtype, ctx->GetOperatorThreadPool(), *Y);
 
   return status;
 }
@@ -346,23 +342,27 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
   return static_cast<TensorProto::DataType>(dtype);
 }
 
+// each call to Compute() draws from a stream of its own, see philox.h
+static std::pair<uint64_t, uint64_t> NextSeeds(PhiloxGenerator& generator) {
+  return generator.NextPhiloxSeeds(1);
+}
+
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
-                                  TensorProto::DataType dtype, Tensor& Y) {
+                                  PhiloxGenerator& generator,
+                                  TensorProto::DataType dtype,
+                                  concurrency::ThreadPool* thread_pool, Tensor& Y) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, float>()) {
-        GenerateData<float, std::normal_distribution<float>>(
-            generator, std::normal_distribution<float>{mean, scale}, Y);
+        philox::FillNormal<float>(NextSeeds(generator), mean, scale, Y.MutableDataAsSpan<float>(), thread_pool);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, double>()) {
-        GenerateData<double, std::normal_distribution<double>>(
-            generator, std::normal_distribution<double>{mean, scale}, Y);
+        philox::FillNormal<double>(NextSeeds(generator), mean, scale, Y.MutableDataAsSpan<double>(), thread_pool);
         handled = true;
       }
       break;
@@ -379,23 +379,22 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxGenerator& generator,
                                    TensorProto::DataType dtype,
+                                   concurrency::ThreadPool* thread_pool,
                                    Tensor& Y) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, float>()) {
-        GenerateData<float, std::uniform_real_distribution<float>>(
-            generator, std::uniform_real_distribution<float>{low, high}, Y);
+        philox::FillUniform<float>(NextSeeds(generator), low, high, Y.MutableDataAsSpan<float>(), thread_pool);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, double>()) {
-        GenerateData<double, std::uniform_real_distribution<double>>(
-            generator, std::uniform_real_distribution<double>{low, high}, Y);
+        philox::FillUniform<double>(NextSeeds(generator), low, high, Y.MutableDataAsSpan<double>(), thread_pool);
         handled = true;
       }
       break;
@@ -411,15 +410,6 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
-  T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
-  }
-}
-
 template Status MultinomialComputeShared<int64_t>(AllocatorPtr& alloc,
                                                   const Tensor& X,
                                                   const int64_t batch_size,
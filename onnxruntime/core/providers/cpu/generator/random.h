@@ -8,6 +8,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/random_generator.h"
 #include "core/framework/random_seed.h"
 #include "core/platform/ort_mutex.h"
 
@@ -22,20 +23,23 @@ Status MultinomialComputeShared(AllocatorPtr& alloc,
                                 std::default_random_engine& generator,
                                 Tensor& Y);
 
+// the seed attribute of a random op, or if it is not provided, one that is generated from the global seed.
+inline uint64_t GetRandomOpSeed(const OpKernelInfo& info) {
+  float seed = 0.f;
+  if (info.GetAttr<float>("seed", &seed).IsOK()) {
+    return static_cast<uint64_t>(seed);
+  }
+
+  // node index is added to the global seed to avoid two nodes generating the same sequence of random data
+  return static_cast<uint64_t>(utils::GetRandomSeed() + info.node().Index());
+}
+
 class RandomNormal final : public OpKernel {
  public:
-  RandomNormal(const OpKernelInfo& info) : OpKernel(info) {
+  RandomNormal(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomOpSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    } else {
-      // node index is added to the global seed to avoid two nodes generating the same sequence of random data
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(utils::GetRandomSeed() + info.node().Index())};
-    }
 
     int64_t dtype;
     ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
@@ -54,29 +58,19 @@ class RandomNormal final : public OpKernel {
   float mean_;
   float scale_;
 
-  // generator_ is updated with every call to Compute().
-  // use generator_mutex_ to ensure Compute() can be called concurrently.
-  // this is to ensure that a model with random generators is deterministic and still can be executed in parallel.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // the offset of generator_ is advanced with every call to Compute(), under the generator's own lock, so that
+  // Compute() can be called concurrently and a model with random generators is still deterministic.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_;
   TensorShape shape_;
 };
 
 class RandomNormalLike final : public OpKernel {
  public:
-  RandomNormalLike(const OpKernelInfo& info) : OpKernel(info) {
+  RandomNormalLike(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomOpSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("mean", &mean_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("scale", &scale_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    } else {
-      // node index is added to the global seed to avoid two nodes generating the same sequence of random data
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(utils::GetRandomSeed() + info.node().Index())};
-    }
 
     int64_t dtype;
     if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
@@ -92,26 +86,17 @@ class RandomNormalLike final : public OpKernel {
   float mean_;
   float scale_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  // optional and may be inferred
 };
 
 class RandomUniform final : public OpKernel {
  public:
-  RandomUniform(const OpKernelInfo& info) : OpKernel(info) {
+  RandomUniform(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomOpSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
 
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    } else {
-      // node index is added to the global seed to avoid two nodes generating the same sequence of random data
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(utils::GetRandomSeed() + info.node().Index())};
-    }
 
     int64_t dtype;
     ORT_ENFORCE(info.GetAttr<int64_t>("dtype", &dtype).IsOK());
@@ -130,26 +115,17 @@ class RandomUniform final : public OpKernel {
   float high_;
   float low_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_;
   TensorShape shape_;
 };
 
 class RandomUniformLike final : public OpKernel {
  public:
-  RandomUniformLike(const OpKernelInfo& info) : OpKernel(info) {
+  RandomUniformLike(const OpKernelInfo& info) : OpKernel(info), generator_(GetRandomOpSeed(info)) {
     ORT_ENFORCE(info.GetAttr<float>("high", &high_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("low", &low_).IsOK());
-    // read optional seed attribute and generate if not provided
-    float seed = 0.f;
-    if (info.GetAttr<float>("seed", &seed).IsOK()) {
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(seed)};
-    } else {
-      // node index is added to the global seed to avoid two nodes generating the same sequence of random data
-      generator_ = std::default_random_engine{gsl::narrow_cast<uint32_t>(utils::GetRandomSeed() + info.node().Index())};
-    }
 
     int64_t dtype;
     if (info.GetAttr<int64_t>("dtype", &dtype).IsOK()) {
@@ -165,9 +141,8 @@ class RandomUniformLike final : public OpKernel {
   float high_;
   float low_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
-  mutable std::default_random_engine generator_;
-  mutable onnxruntime::OrtMutex generator_mutex_;
+  // see comments for generator_ in RandomNormal class.
+  mutable PhiloxGenerator generator_;
   ONNX_NAMESPACE::TensorProto::DataType dtype_ = ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_UNDEFINED;  // optional and may be inferred
 };
 
@@ -199,7 +174,9 @@ class Multinomial final : public OpKernel {
  private:
   int64_t num_samples_;
 
-  // see comments for generator_ and generator_mutex_ in RandomNormal class.
+  // generator_ is updated with every call to Compute().
+  // use generator_mutex_ to ensure Compute() can be called concurrently.
+  // this is to ensure that a model with random generators is deterministic and still can be executed in parallel.
   mutable std::default_random_engine generator_;
   mutable onnxruntime::OrtMutex generator_mutex_;
   ONNX_NAMESPACE::TensorProto::DataType output_dtype_;
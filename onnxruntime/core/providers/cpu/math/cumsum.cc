@@ -2,51 +2,94 @@
 // Licensed under the MIT License.
 
 #include "cumsum.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "core/providers/common.h"
-#include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
 
 using namespace onnxruntime;
 
 namespace {
 // static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(onnxruntime::narrow<size_t>(rank), 0);
-  starts[onnxruntime::narrow<size_t>(axis)] = index;
-  return starts;
-}
+
+// Scans the columns [column_begin, column_end) of the dim rows of inner values of input, the rows being the slices of
+// the axis. Each row is the sum of the previous row and an input row, so the columns are added with vectorized loops.
 template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
+void ScanColumns(const T* input, T* output, int64_t dim, int64_t inner, int64_t column_begin, int64_t column_end,
+                 bool exclusive, bool reverse) {
+  for (int64_t k = 0; k < dim; ++k) {
+    const int64_t index = reverse ? dim - 1 - k : k;
+    T* output_row = output + index * inner;
+    if (k == 0) {
+      // If (exclusive == true) the first slice is always 0, else it is a copy of the input
+      if (exclusive) {
+        std::fill(output_row + column_begin, output_row + column_end, T{});
+      } else {
+        std::copy(input + index * inner + column_begin, input + index * inner + column_end, output_row + column_begin);
+      }
+      continue;
+    }
+
+    // Each output slice is the sum of corresponding input slice and the previous output slice
+    const int64_t previous = reverse ? index + 1 : index - 1;
+    const T* input_row = input + (exclusive ? previous : index) * inner;
+    const T* previous_row = output + previous * inner;
+    for (int64_t c = column_begin; c < column_end; ++c) {
+      output_row[c] = previous_row[c] + input_row[c];
+    }
   }
 }
-template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
+
+// Scans count contiguous values on top of carry, and returns the carry of the values that follow them.
+template <typename T, bool Reverse>
+T ScanContiguous(const T* input, T* output, int64_t count, T carry, bool exclusive) {
+  const auto at = [count](int64_t k) { return Reverse ? count - 1 - k : k; };
+  int64_t k = 0;
+  // The prefix sums of 4 values are computed apart from the carry, so that the chain of additions to the carry is one
+  // addition per 4 values instead of one per value.
+  for (; k + 4 <= count; k += 4) {
+    const T x0 = input[at(k)];
+    const T x1 = input[at(k + 1)];
+    const T x2 = input[at(k + 2)];
+    const T x3 = input[at(k + 3)];
+    const T p1 = x0 + x1;
+    const T p2 = p1 + x2;
+    const T p3 = p2 + x3;
+    if (exclusive) {
+      output[at(k)] = carry;
+      output[at(k + 1)] = carry + x0;
+      output[at(k + 2)] = carry + p1;
+      output[at(k + 3)] = carry + p2;
+    } else {
+      output[at(k)] = carry + x0;
+      output[at(k + 1)] = carry + p1;
+      output[at(k + 2)] = carry + p2;
+      output[at(k + 3)] = carry + p3;
+    }
+    carry += p3;
+  }
+  for (; k < count; ++k) {
+    const T x = input[at(k)];
+    output[at(k)] = exclusive ? carry : carry + x;
+    carry += x;
   }
+  return carry;
 }
+
 template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
-  }
+T ScanContiguous(const T* input, T* output, int64_t count, T carry, bool exclusive, bool reverse) {
+  return reverse ? ScanContiguous<T, true>(input, output, count, carry, exclusive)
+                 : ScanContiguous<T, false>(input, output, count, carry, exclusive);
 }
+
+// The rows shorter than this are scanned by a single thread.
+constexpr int64_t kMinParallelScanBlockSize = 16384;
+
 }  // namespace
 
 namespace onnxruntime {
@@ -200,65 +243,85 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   int64_t axis = 0;
   ORT_THROW_IF_ERROR(cumsum_op::GetAxis(axis_tensor, rank, axis));
 
-  auto dim(output_tensor.Shape()[onnxruntime::narrow<size_t>(axis)]);  // dimension size for the axis
-  TensorShape slice_shape(input->Shape());                             // the shape of one slice of input/output for the given value of the axis
-  slice_shape[onnxruntime::narrow<size_t>(axis)] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(onnxruntime::narrow<size_t>(rank), 1);  // steps for the slice -- always set to 1
-
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    if (index < dim) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
+  // The input is viewed as outer blocks of dim slices of the axis, of inner values each.
+  const int64_t dim = output_shape[onnxruntime::narrow<size_t>(axis)];  // dimension size for the axis
+  const int64_t outer = output_shape.SizeToDimension(onnxruntime::narrow<size_t>(axis));
+  const int64_t inner = output_shape.SizeFromDimension(onnxruntime::narrow<size_t>(axis) + 1);
+  const T* input_data = input->Data<T>();
+  T* output_data = output_tensor.MutableData<T>();
+  const bool exclusive = exclusive_ != 0;
+  const bool reverse = reverse_ != 0;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  const TensorOpCost cost{static_cast<double>(dim * sizeof(T)), static_cast<double>(dim * sizeof(T)),
+                          static_cast<double>(dim)};
+
+  if (inner > 1) {
+    // The columns of all the outer blocks are split between the threads.
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(outer * inner), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (int64_t begin = first; begin < last;) {
+            const int64_t block = begin / inner;
+            const int64_t end = std::min<int64_t>(last, (block + 1) * inner);
+            ::ScanColumns<T>(input_data + block * dim * inner, output_data + block * dim * inner, dim, inner,
+                             begin - block * inner, end - block * inner, exclusive, reverse);
+            begin = end;
+          }
+        });
+    return Status::OK();
+  }
 
-    if (index >= 0) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
-    }
+  // The axis is contiguous. With fewer rows than threads, long rows are split into blocks that are scanned in two
+  // passes: the sums of the blocks first, then the blocks on top of the sums of the blocks before them.
+  const int64_t degree_of_parallelism = concurrency::ThreadPool::DegreeOfParallelism(tp);
+  const int64_t blocks_per_row =
+      outer >= degree_of_parallelism
+          ? 1
+          : std::max<int64_t>(1, std::min<int64_t>((degree_of_parallelism + outer - 1) / outer,
+                                                   dim / kMinParallelScanBlockSize));
+  if (blocks_per_row == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(outer), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row < last; ++row) {
+            ::ScanContiguous<T>(input_data + row * dim, output_data + row * dim, dim, T{}, exclusive, reverse);
+          }
+        });
+    return Status::OK();
+  }
 
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
+  const int64_t block_size = (dim + blocks_per_row - 1) / blocks_per_row;
+  const auto num_blocks = static_cast<std::ptrdiff_t>(outer * blocks_per_row);
+  const auto block_extent = [&](std::ptrdiff_t block, int64_t& offset, int64_t& count) {
+    const int64_t begin = (block % blocks_per_row) * block_size;
+    offset = (block / blocks_per_row) * dim + begin;
+    count = std::min(block_size, dim - begin);
+  };
+
+  std::vector<T> carries(onnxruntime::narrow<size_t>(num_blocks));
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    int64_t offset = 0;
+    int64_t count = 0;
+    block_extent(block, offset, count);
+    carries[block] = ConstEigenVectorArrayMap<T>(input_data + offset, onnxruntime::narrow<Eigen::Index>(count)).sum();
+  });
+
+  // The carry of a block is the sum of the blocks before it in the direction of the scan.
+  for (int64_t row = 0; row < outer; ++row) {
+    T carry{};
+    for (int64_t k = 0; k < blocks_per_row; ++k) {
+      T& block_carry = carries[row * blocks_per_row + (reverse ? blocks_per_row - 1 - k : k)];
+      const T block_sum = block_carry;
+      block_carry = carry;
+      carry += block_sum;
     }
   }
 
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    int64_t offset = 0;
+    int64_t count = 0;
+    block_extent(block, offset, count);
+    ::ScanContiguous<T>(input_data + offset, output_data + offset, count, carries[block], exclusive, reverse);
+  });
+
   return Status::OK();
 }
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "einsum_auxiliary_ops.h"
+#include "core/mlas/inc/mlas.h"
 
 using namespace onnxruntime::common;
 
@@ -47,6 +48,27 @@ Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
   return Status::OK();
 }
 
+// The batch is handed to MLAS in one call so that batches of small matrices are partitioned across the threads by
+// matrix instead of running one matrix at a time.
+template <>
+Status MatMul<float>(const float* input_1_data, const float* input_2_data, float* output_data,
+                     size_t left_stride, size_t right_stride, size_t output_stride,
+                     size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp,
+                     void* /*einsum_cuda_assets*/) {
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(num_batches);
+  for (size_t i = 0; i < num_batches; ++i) {
+    data[i].A = input_1_data + i * left_stride;
+    data[i].lda = K;
+    data[i].B = input_2_data + i * right_stride;
+    data[i].ldb = N;
+    data[i].C = output_data + i * output_stride;
+    data[i].ldc = N;
+  }
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), num_batches, tp);
+  return Status::OK();
+}
+
 // CPU specific ReduceSum helper
 template <typename T>
 std::unique_ptr<Tensor> ReduceSum(const Tensor& input, gsl::span<const int64_t> reduce_axes,
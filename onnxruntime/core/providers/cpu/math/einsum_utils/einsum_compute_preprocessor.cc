@@ -56,6 +56,10 @@ const std::vector<int64_t>& EinsumComputePreprocessor::GetMappedSubscriptIndices
   return subscript_indices_to_output_indices_;
 }
 
+const std::vector<std::vector<int64_t>>& EinsumComputePreprocessor::GetInputSubscriptIndices() const {
+  return input_subscript_indices_;
+}
+
 int64_t EinsumComputePreprocessor::GetNumSubscriptIndices() const {
   return num_subscript_indices_;
 }
@@ -76,9 +76,8 @@ struct EinsumEquationPreprocessor {
   }
 
   // Holds the pre-processed equation string
-  // In theory, we could re-write the einsum equation to lower overall cost of intermediate arrays
-  // See numpy.einsum_path for details/examples
-  // These are very advanced optimizations that we don't require for the average use-case
+  // The equation is not re-written to lower the cost of the intermediate arrays, instead the order in which the
+  // operands are contracted is chosen once their shapes are known (see einsum_contraction_path.h)
   std::string einsum_preprocessed_equation_;
 
   // In explicit form, holds the left side of the einsum equation
@@ -139,6 +138,9 @@ class EinsumComputePreprocessor final {
   // For each subscript index, hold the index it corresponds to in the output's shape
   const std::vector<int64_t>& GetMappedSubscriptIndicesToOutputindices() const;
 
+  // For each input, the subscript indices of its dims
+  const std::vector<std::vector<int64_t>>& GetInputSubscriptIndices() const;
+
   // Get the number of subscript indices (subscript labels) in the einsum equation
   int64_t GetNumSubscriptIndices() const;
 
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "einsum_contraction_path.h"
+
+#include <limits>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+namespace EinsumOp {
+
+namespace {
+
+using Labels = std::vector<bool>;
+
+class ContractionPathSearch {
+ public:
+  ContractionPathSearch(gsl::span<const int64_t> label_dims, const Labels& output_labels)
+      : label_dims_(label_dims), output_labels_(output_labels) {}
+
+  // The cost of contracting operands[first] and operands[second], and the labels of the result
+  double Contract(const std::vector<Labels>& operands, size_t first, size_t second, Labels& result) const {
+    const size_t num_labels = label_dims_.size();
+    result.assign(num_labels, false);
+    double cost = 1.;
+    for (size_t l = 0; l < num_labels; ++l) {
+      if (!operands[first][l] && !operands[second][l]) {
+        continue;
+      }
+
+      cost *= static_cast<double>(label_dims_[l]);
+      bool is_kept = output_labels_[l];
+      for (size_t i = 0; !is_kept && i < operands.size(); ++i) {
+        is_kept = i != first && i != second && operands[i][l];
+      }
+      result[l] = is_kept;
+    }
+    return cost;
+  }
+
+  double Size(const Labels& labels) const {
+    double size = 1.;
+    for (size_t l = 0; l < labels.size(); ++l) {
+      if (labels[l]) {
+        size *= static_cast<double>(label_dims_[l]);
+      }
+    }
+    return size;
+  }
+
+  // Tries every order of the remaining operands and keeps the cheapest one that costs less than best_cost.
+  void SearchOptimal(std::vector<Labels>& operands, double cost, ContractionPath& path,
+                     double& best_cost, ContractionPath& best_path) const {
+    if (operands.size() == 1) {
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_path = path;
+      }
+      return;
+    }
+
+    Labels result;
+    for (size_t first = 0; first < operands.size(); ++first) {
+      for (size_t second = first + 1; second < operands.size(); ++second) {
+        const double pair_cost = cost + Contract(operands, first, second, result);
+        if (pair_cost >= best_cost) {
+          continue;
+        }
+
+        auto remaining = operands;
+        remaining[first] = result;
+        remaining.erase(remaining.begin() + second);
+        path.emplace_back(first, second);
+        SearchOptimal(remaining, pair_cost, path, best_cost, best_path);
+        path.pop_back();
+      }
+    }
+  }
+
+  // Contracts, at each step, the pair whose result grows the least over its operands, and of those the cheapest.
+  ContractionPath SearchGreedy(std::vector<Labels> operands) const {
+    ContractionPath path;
+    Labels result;
+    while (operands.size() > 1) {
+      std::pair<size_t, size_t> best_pair{0, 1};
+      double best_growth = std::numeric_limits<double>::infinity();
+      double best_cost = std::numeric_limits<double>::infinity();
+      Labels best_result;
+      for (size_t first = 0; first < operands.size(); ++first) {
+        for (size_t second = first + 1; second < operands.size(); ++second) {
+          const double cost = Contract(operands, first, second, result);
+          const double growth = Size(result) - Size(operands[first]) - Size(operands[second]);
+          if (growth < best_growth || (growth == best_growth && cost < best_cost)) {
+            best_pair = {first, second};
+            best_growth = growth;
+            best_cost = cost;
+            best_result = result;
+          }
+        }
+      }
+
+      operands[best_pair.first] = std::move(best_result);
+      operands.erase(operands.begin() + best_pair.second);
+      path.push_back(best_pair);
+    }
+    return path;
+  }
+
+ private:
+  gsl::span<const int64_t> label_dims_;
+  const Labels& output_labels_;
+};
+
+}  // namespace
+
+ContractionPath ComputeContractionPath(const std::vector<std::vector<bool>>& operand_labels,
+                                       gsl::span<const int64_t> label_dims,
+                                       const std::vector<bool>& output_labels) {
+  ORT_ENFORCE(output_labels.size() == label_dims.size(), "Einsum op: Every label must have a dim value");
+
+  const ContractionPathSearch search(label_dims, output_labels);
+  if (operand_labels.size() > kMaxOperandsForOptimalContractionPath) {
+    return search.SearchGreedy(operand_labels);
+  }
+
+  auto operands = operand_labels;
+  ContractionPath path;
+  ContractionPath best_path;
+  double best_cost = std::numeric_limits<double>::infinity();
+  search.SearchOptimal(operands, 0., path, best_cost, best_path);
+  return best_path;
+}
+
+}  // namespace EinsumOp
+
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This module hosts the search for the order in which Einsum contracts its operands, in the spirit of
+// numpy.einsum_path and opt_einsum.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <gsl/gsl>
+
+namespace onnxruntime {
+
+namespace EinsumOp {
+
+// The pairs of operands to contract, in order. A pair holds the positions (first < second) of the operands in the
+// list of the operands that remain: the result of the contraction takes the place of the first one and the second one
+// is removed from the list.
+using ContractionPath = std::vector<std::pair<size_t, size_t>>;
+
+// Up to this many operands, every order is tried. Beyond it, the order is chosen greedily.
+constexpr size_t kMaxOperandsForOptimalContractionPath = 5;
+
+/** Returns the contraction order of the lowest cost, the cost being the number of multiply-adds of all the pairwise
+ * contractions, which also bounds the size of the intermediate results. Of the orders of the same cost, the left to
+ * right one is preferred.
+ * operand_labels[i][l] tells if subscript index l is a label of operand i, label_dims[l] is the dim value of l and
+ * output_labels[l] tells if l is a label of the output. A label is summed over as soon as no other remaining operand
+ * nor the output has it.
+ */
+ContractionPath ComputeContractionPath(const std::vector<std::vector<bool>>& operand_labels,
+                                       gsl::span<const int64_t> label_dims,
+                                       const std::vector<bool>& output_labels);
+
+}  // namespace EinsumOp
+
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "einsum_typed_compute_processor.h"
+#include "einsum_contraction_path.h"
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
@@ -398,28 +399,92 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     }
   }
 
-  // Process the operands in a pair-wise fashion
+  // Process the operands in a pair-wise fashion, in the order of the lowest cost
   {
-    bool is_final_pair = false;
-    // Keep processing each input pair-wise
-    for (int input = 1; input < num_inputs; ++input) {
+    struct Operand {
+      std::unique_ptr<const Tensor> owned;  // set for the intermediate results
+      const Tensor* tensor;
+      TensorShape shape;
+      std::vector<bool> labels;  // the subscript indices that are yet to be reduced
+    };
+
+    const auto& input_subscript_indices = einsum_compute_preprocessor_.GetInputSubscriptIndices();
+    const auto& subscript_indices_to_output_indices =
+        einsum_compute_preprocessor_.GetMappedSubscriptIndicesToOutputindices();
+    const size_t num_labels = onnxruntime::narrow<size_t>(num_subscript_labels);
+
+    std::vector<Operand> operands;
+    operands.reserve(num_inputs);
+    TensorShapeVector label_dims(num_labels, 1);
+    for (int input = 0; input < num_inputs; ++input) {
+      Operand operand;
+      if (input == 0) {
+        // Use either the result of the reduction above, the preprocessed input or the raw input
+        operand.tensor = result ? result.get() : raw_inputs[0];
+        operand.shape = result ? result->Shape() : homogenized_input_dims[0];
+        operand.owned = std::move(result);
+      } else {
+        operand.tensor = preprocessed_inputs[input] ? preprocessed_inputs[input].get() : raw_inputs[input];
+        operand.shape = homogenized_input_dims[input];
+      }
+
+      operand.labels.assign(num_labels, false);
+      for (int64_t subscript_index : input_subscript_indices[input]) {
+        // the dims that only the first input has are reduced already
+        operand.labels[onnxruntime::narrow<size_t>(subscript_index)] =
+            input != 0 || mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(subscript_index)] != 0;
+      }
+
+      const auto dims = homogenized_input_dims[input].GetDims();
+      for (size_t l = 0; l < num_labels; ++l) {
+        label_dims[l] = std::max(label_dims[l], dims[l]);
+      }
+      operands.push_back(std::move(operand));
+    }
+
+    std::vector<bool> output_labels(num_labels);
+    std::vector<std::vector<bool>> operand_labels;
+    operand_labels.reserve(operands.size());
+    for (size_t l = 0; l < num_labels; ++l) {
+      output_labels[l] = subscript_indices_to_output_indices[l] != -1;
+    }
+    for (const auto& operand : operands) {
+      operand_labels.push_back(operand.labels);
+    }
+
+    const auto path = EinsumOp::ComputeContractionPath(operand_labels, label_dims, output_labels);
+    for (size_t step = 0; step < path.size(); ++step) {
+      const auto [first, second] = path[step];
+      Operand& left = operands[first];
+      Operand& right = operands[second];
+
+      // Reduce the dims that no other operand, nor the output, has
       TensorShapeVector reduced_dims;
-      reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
-      for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(dim)] == input) {
-          // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
-          reduced_dims.push_back(dim);
+      reduced_dims.reserve(num_labels);  // num_labels is the upper bound. No harm in over-reserving by a small margin.
+      std::vector<bool> labels(num_labels, false);
+      for (size_t l = 0; l < num_labels; ++l) {
+        if (!left.labels[l] && !right.labels[l]) {
+          continue;
+        }
+
+        bool is_kept = output_labels[l];
+        for (size_t i = 0; !is_kept && i < operands.size(); ++i) {
+          is_kept = i != first && i != second && operands[i].labels[l];
+        }
+        if (is_kept) {
+          labels[l] = true;
+        } else {
+          reduced_dims.push_back(static_cast<int64_t>(l));
         }
       }
-      if (input == num_inputs - 1) {
-        is_final_pair = true;
-      }
-      // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
-                                      preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
-                                      homogenized_input_dims[input],
-                                      reduced_dims, is_final_pair);
+
+      auto pair_result = PairwiseOperandProcess(*left.tensor, left.shape, *right.tensor, right.shape,
+                                                reduced_dims, step == path.size() - 1);
+      left.tensor = pair_result.get();
+      left.shape = pair_result->Shape();
+      left.owned = std::move(pair_result);
+      left.labels = std::move(labels);
+      operands.erase(operands.begin() + second);
     }
   }
 
@@ -464,8 +464,142 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
                                      AllocateTensorFunc allocate_tensor,
                                      const ProcessBroadcastSpanFuncs& funcs);
 
+// Broadcasts two inputs of Add/Sub/Mul/Div by planning the loops up front and processing each innermost run with
+// MLAS. Output axes of size 1 are dropped and neighboring axes are folded together when both inputs stay contiguous
+// (or stay broadcast) across them, so the innermost run is as long as possible and each input has an element stride
+// of 0 or 1 within it. The remaining outer axes are walked with an odometer and the runs are parallelized.
+//
+// Returns false without producing any output if the general broadcasting path should be used instead, which is the
+// case when the inputs fold to a single span (that path already parallelizes within the span) or the output is empty.
+template <typename T>
+static bool EltwiseBroadcastTwo(OpKernelContext& /*context*/, MLAS_ELTWISE_BINARY_KIND /*kind*/) {
+  return false;
+}
+
+template <>
+bool EltwiseBroadcastTwo<float>(OpKernelContext& context, MLAS_ELTWISE_BINARY_KIND kind) {
+  const Tensor& input0 = *context.Input<Tensor>(0);
+  const Tensor& input1 = *context.Input<Tensor>(1);
+  const auto dims0 = input0.Shape().GetDims();
+  const auto dims1 = input1.Shape().GetDims();
+  const size_t rank = std::max(dims0.size(), dims1.size());
+
+  TensorShapeVector output_dims(rank);
+  InlinedVector<size_t> strides0(rank);
+  InlinedVector<size_t> strides1(rank);
+  size_t stride0 = 1;
+  size_t stride1 = 1;
+  for (size_t i = rank; i-- > 0;) {
+    const int64_t dim0 = i + dims0.size() >= rank ? dims0[i + dims0.size() - rank] : 1;
+    const int64_t dim1 = i + dims1.size() >= rank ? dims1[i + dims1.size() - rank] : 1;
+    if (dim0 == 0 || dim1 == 0 || (dim0 != dim1 && dim0 != 1 && dim1 != 1)) {
+      // let the general path handle empty output and report invalid shapes
+      return false;
+    }
+
+    output_dims[i] = std::max(dim0, dim1);
+    strides0[i] = dim0 == 1 ? 0 : stride0;
+    strides1[i] = dim1 == 1 ? 0 : stride1;
+    stride0 *= static_cast<size_t>(dim0);
+    stride1 *= static_cast<size_t>(dim1);
+  }
+
+  // fold the axes, innermost first. folded_* are stored innermost first too.
+  InlinedVector<size_t> folded_dims;
+  InlinedVector<size_t> folded_strides0;
+  InlinedVector<size_t> folded_strides1;
+  for (size_t i = rank; i-- > 0;) {
+    const size_t dim = static_cast<size_t>(output_dims[i]);
+    if (dim == 1) {
+      continue;
+    }
+
+    if (!folded_dims.empty()) {
+      const size_t inner_dim = folded_dims.back();
+      const bool fold0 = strides0[i] == folded_strides0.back() * inner_dim;
+      const bool fold1 = strides1[i] == folded_strides1.back() * inner_dim;
+      if (fold0 && fold1) {
+        folded_dims.back() *= dim;
+        continue;
+      }
+    }
+
+    folded_dims.push_back(dim);
+    folded_strides0.push_back(strides0[i]);
+    folded_strides1.push_back(strides1[i]);
+  }
+
+  if (folded_dims.size() <= 1) {
+    return false;
+  }
+
+  Tensor& output = *context.Output(0, TensorShape(output_dims));
+  const float* input0_data = input0.Data<float>();
+  const float* input1_data = input1.Data<float>();
+  float* output_data = output.MutableData<float>();
+
+  // split long runs so that there is enough work to share when there are only a few outer iterations
+  constexpr size_t kMaximumRunSize = 16384;
+  const size_t inner_size = folded_dims[0];
+  const size_t num_blocks = (inner_size + kMaximumRunSize - 1) / kMaximumRunSize;
+  const size_t block_size = (inner_size + num_blocks - 1) / num_blocks;
+  const size_t outer_size = narrow<size_t>(output.Shape().Size()) / inner_size;
+  const size_t num_outer_axes = folded_dims.size() - 1;
+
+  auto work = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    size_t outer = static_cast<size_t>(first) / num_blocks;
+    size_t block = static_cast<size_t>(first) % num_blocks;
+
+    InlinedVector<size_t> index(num_outer_axes);
+    size_t offset0 = 0;
+    size_t offset1 = 0;
+    size_t output_offset = outer * inner_size;
+    for (size_t k = 0; k < num_outer_axes; ++k) {
+      index[k] = outer % folded_dims[k + 1];
+      outer /= folded_dims[k + 1];
+      offset0 += index[k] * folded_strides0[k + 1];
+      offset1 += index[k] * folded_strides1[k + 1];
+    }
+
+    for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+      const size_t start = block * block_size;
+      const size_t count = std::min(block_size, inner_size - start);
+      MlasEltwiseBinary(kind,
+                        input0_data + offset0 + start * folded_strides0[0], folded_strides0[0],
+                        input1_data + offset1 + start * folded_strides1[0], folded_strides1[0],
+                        output_data + output_offset + start, count);
+
+      if (++block == num_blocks) {
+        block = 0;
+        output_offset += inner_size;
+        for (size_t k = 0; k < num_outer_axes; ++k) {
+          offset0 += folded_strides0[k + 1];
+          offset1 += folded_strides1[k + 1];
+          if (++index[k] < folded_dims[k + 1]) {
+            break;
+          }
+          offset0 -= folded_dims[k + 1] * folded_strides0[k + 1];
+          offset1 -= folded_dims[k + 1] * folded_strides1[k + 1];
+          index[k] = 0;
+        }
+      }
+    }
+  };
+
+  const double block_elements = static_cast<double>(block_size);
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(outer_size * num_blocks),
+      TensorOpCost{2.0 * sizeof(float) * block_elements, sizeof(float) * block_elements, block_elements}, work);
+
+  return true;
+}
+
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
+  if (EltwiseBroadcastTwo<T>(*context, MlasEltwiseAdd)) {
+    return Status::OK();
+  }
+
   // BroadcastHelper received as argument may differ from 'helper' when parallelizing within a span
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
@@ -484,6 +618,10 @@ Status Add<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Sub<T>::Compute(OpKernelContext* context) const {
+  if (EltwiseBroadcastTwo<T>(*context, MlasEltwiseSub)) {
+    return Status::OK();
+  }
+
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
         per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() - per_iter_bh.EigenInput1<T>().array();
@@ -501,6 +639,10 @@ Status Sub<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Mul<T>::Compute(OpKernelContext* context) const {
+  if (EltwiseBroadcastTwo<T>(*context, MlasEltwiseMul)) {
+    return Status::OK();
+  }
+
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
         per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() * per_iter_bh.EigenInput1<T>().array();
@@ -518,6 +660,10 @@ Status Mul<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Div<T>::Compute(OpKernelContext* context) const {
+  if (EltwiseBroadcastTwo<T>(*context, MlasEltwiseDiv)) {
+    return Status::OK();
+  }
+
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
         per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() / per_iter_bh.EigenInput1<T>().array();
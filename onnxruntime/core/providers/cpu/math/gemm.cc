@@ -138,6 +138,24 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+bool GemmRestorePackBFp32(const Tensor& tensor_b,
+                          bool trans_b,
+                          size_t packed_b_size,
+                          TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+  if (packed_b_size == 0 || MlasGemmPackBSize(N, K) != packed_b_size) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+  return true;
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -189,7 +207,6 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 #if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
 #pragma GCC diagnostic pop
 #endif
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
   bool support_mlas = false;
   if (c_shape == nullptr) {
     support_mlas = true;
@@ -198,7 +215,8 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
   } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
     support_mlas = true;
   }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
+  if (MlasHalfGemmAccelerationSupported() && trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas &&
+      alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
     MLAS_HALF_GEMM_DATA_PARAMS data;
     data.A = a_data;
     data.lda = K;
@@ -212,7 +230,6 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
     MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
     return;
   }
-#endif
   // Fallback to Eigen
   // Broadcast the bias as needed if bias is given
   GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
@@ -284,6 +301,23 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::RestorePrePackedState(const Tensor& /*tensor*/, int /*input_idx*/,
+                                      gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                      /*out*/ bool& restored) {
+  restored = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::RestorePrePackedState(const Tensor& tensor, int input_idx,
+                                          gsl::span<const size_t> prepacked_buffer_sizes,
+                                          /*out*/ bool& restored) {
+  restored = input_idx == 1 && prepacked_buffer_sizes.size() == 1 &&
+             GemmRestorePackBFp32(tensor, trans_B_ != CblasNoTrans, prepacked_buffer_sizes[0], b_shape_);
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -408,24 +442,44 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
+  // A bias of shape (N,) or (1, N) and the activation are applied by the MLAS sgemm epilogue while the
+  // output tiles are still in cache. Other bias shapes are broadcast to the output before the multiply.
+  const bool bias_per_column = c_data != nullptr && beta_ == 1.0f && c_shape->Size() == N &&
+                               (c_shape->NumDimensions() == 1 || (*c_shape)[0] == 1);
+
+  MLAS_SGEMM_EPILOGUE epilogue;
+  epilogue.Bias = bias_per_column ? c_data : nullptr;
+  epilogue.Activation = mlas_activation_.has_value() ? &*mlas_activation_ : nullptr;
+
+  if (B && epilogue.Bias == nullptr && epilogue.Activation == nullptr) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
   } else {
-    GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    MlasGemm(
-        trans_A_,
-        static_cast<size_t>(M),
-        static_cast<size_t>(N),
-        static_cast<size_t>(K),
-        alpha_,
-        A->Data<float>(),
-        static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-        packed_b_.get(),
-        c_data != nullptr ? beta_ : 0.0f,
-        y_data,
-        static_cast<size_t>(N),
-        thread_pool);
+    float beta = 0.0f;
+    if (c_data != nullptr && !bias_per_column) {
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+      beta = beta_;
+    }
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+    if (B) {
+      data.B = B->Data<float>();
+      data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+    } else {
+      data.B = static_cast<const float*>(packed_b_.get());
+      data.BIsPacked = true;
+    }
+    data.C = y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.alpha = alpha_;
+    data.beta = beta;
+    data.Epilogue = &epilogue;
+
+    MlasGemm(trans_A_, B ? trans_B_ : CblasNoTrans,
+             static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+             data, thread_pool);
   }
 
   ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <optional>
+
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -28,6 +31,10 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedState(const Tensor& tensor, int input_idx,
+                               gsl::span<const size_t> prepacked_buffer_sizes,
+                               /*out*/ bool& restored) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -44,6 +51,9 @@ class Gemm : protected GemmBase, public OpKernel {
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+  // For fused gemm + activation that is computed by the MLAS sgemm epilogue, used instead of activation_
+  std::optional<MLAS_ACTIVATION> mlas_activation_;
+
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
 
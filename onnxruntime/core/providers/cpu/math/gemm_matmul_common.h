@@ -14,4 +14,11 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Sets up b_shape as GemmPackBFp32 would for tensor_b, for a buffer it packed earlier.
+// Returns false if GemmPackBFp32 would not pack tensor_b into a buffer of packed_b_size bytes.
+bool GemmRestorePackBFp32(const Tensor& tensor_b,
+                          bool trans_b,
+                          size_t packed_b_size,
+                          TensorShape& b_shape);
+
 };  // namespace onnxruntime
@@ -132,7 +132,7 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -171,6 +171,57 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+void MatMul<float>::CreateSgemmJitKernel() {
+  if (!use_sgemm_jit_ || b_shape_.NumDimensions() != 2) {
+    return;
+  }
+
+  // b_shape_ is the shape of B as stored, so a transposed B is N x K.
+  const bool trans_b = trans_b_attr_ != 0;
+  const size_t K = static_cast<size_t>(trans_b ? b_shape_[1] : b_shape_[0]);
+  const size_t N = static_cast<size_t>(trans_b ? b_shape_[0] : b_shape_[1]);
+  sgemm_jit_kernel_.reset(MlasSgemmJitKernelCreate(N, K));
+}
+
+bool MatMul<float>::SparsePackB(AllocatorPtr& alloc, const Tensor& tensor_b, size_t& packed_b_size) {
+  // MlasSparseSgemm supports neither a transposed A nor batches of B
+  if (sparse_sgemm_min_sparsity_ <= 0.0f || trans_a_attr_ != 0 || trans_batch_a_ || trans_batch_b_ ||
+      tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const bool trans_b = trans_b_attr_ != 0;
+  const size_t K = static_cast<size_t>(trans_b ? tensor_b.Shape()[1] : tensor_b.Shape()[0]);
+  const size_t N = static_cast<size_t>(trans_b ? tensor_b.Shape()[0] : tensor_b.Shape()[1]);
+  if (K == 0 || N == 0) {
+    return false;
+  }
+
+  const auto trans = trans_b ? CblasTrans : CblasNoTrans;
+  const size_t ldb = trans_b ? K : N;
+  const size_t block_count = MlasSparseSgemmCountBlocks(trans, N, K, tensor_b.Data<float>(), ldb);
+
+  // blocks are one row of K by 16 columns of N
+  const double total_blocks = static_cast<double>(K) * static_cast<double>((N + 15) / 16);
+  if (static_cast<double>(block_count) > (1.0 - sparse_sgemm_min_sparsity_) * total_blocks) {
+    return false;
+  }
+
+  packed_b_size = MlasSparseSgemmPackBSize(N, K, block_count);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  // zero the alignment padding so that the hash of the buffer is deterministic when it is shared
+  memset(packed_b_.get(), 0, packed_b_size);
+  MlasSparseSgemmPackB(trans, N, K, tensor_b.Data<float>(), ldb, block_count, packed_b_.get());
+
+  b_shape_ = tensor_b.Shape();
+  b_is_sparse_ = true;
+  return true;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -179,22 +230,29 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
-    size_t dim1 = 0;
-    size_t dim2 = 0;
-    TensorShape b_shape = tensor.Shape();
-
-    if (b_shape.NumDimensions() == 2) {
-      dim1 = static_cast<size_t>(b_shape[0]);
-      dim2 = static_cast<size_t>(b_shape[1]);
-    }
-
-    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
-      is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
-    } else
+    if (SparsePackB(alloc, tensor, packed_b_size)) {
+      is_packed = true;
+    } else {
+#if defined(MLAS_SBGEMM_SUPPORTED)
+      size_t dim1 = 0;
+      size_t dim2 = 0;
+      TensorShape b_shape = tensor.Shape();
+
+      if (b_shape.NumDimensions() == 2) {
+        dim1 = static_cast<size_t>(b_shape[0]);
+        dim2 = static_cast<size_t>(b_shape[1]);
+      }
+
+      if (UseFastMathMode(dim1 * dim2)) {
+        is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      } else
 #endif
-    {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      {
+        is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+        if (is_packed) {
+          CreateSgemmJitKernel();
+        }
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -219,6 +277,33 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::RestorePrePackedState(const Tensor& tensor, int input_idx,
+                                            gsl::span<const size_t> prepacked_buffer_sizes,
+                                            /*out*/ bool& restored) {
+  restored = false;
+  if (input_idx != 1 || prepacked_buffer_sizes.size() != 1) {
+    return Status::OK();
+  }
+
+  // whether B is packed as sparse depends on its values
+  if (sparse_sgemm_min_sparsity_ > 0.0f) {
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // the bfloat16 packed layout is always pre-packed
+  if (tensor.Shape().NumDimensions() == 2 && UseFastMathMode(static_cast<size_t>(tensor.Shape().Size()))) {
+    return Status::OK();
+  }
+#endif
+
+  restored = GemmRestorePackBFp32(tensor, trans_b_attr_ != 0, prepacked_buffer_sizes[0], b_shape_);
+  if (restored) {
+    CreateSgemmJitKernel();
+  }
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -256,8 +341,17 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
-  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
+
+  if (b_is_sparse_) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSparseSgemm(M, N, K, a_data + helper.LeftOffsets()[i], lda, packed_b_.get(),
+                      y_data + helper.OutputOffsets()[i], N, alpha_attr_, thread_pool);
+    }
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  if (UseFastMathMode(N * K)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsfp32 = !(bool(packed_b_));
@@ -286,6 +380,7 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
+      data[i].JitKernel = data[i].BIsPacked ? sgemm_jit_kernel_.get() : nullptr;
     }
     MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
                   M, N, K, data.data(), max_len, thread_pool);
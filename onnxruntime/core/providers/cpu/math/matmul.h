@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -30,10 +31,25 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
+#if defined(MLAS_TARGET_AMD64)
+    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathAmxBfloat16);
+#else
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
+#endif
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
 #endif
+
+    const std::string sgemm_jit = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasSgemmJit, "0");
+    ORT_ENFORCE(sgemm_jit == "0" || sgemm_jit == "1",
+                "Invalid value for ", kOrtSessionOptionsMlasSgemmJit, ": ", sgemm_jit);
+    use_sgemm_jit_ = (sgemm_jit == "1") && MlasSgemmJitIsSupported();
+
+    const std::string sparse_sgemm_min_sparsity =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasSparseSgemmMinSparsity, "0");
+    ORT_ENFORCE(TryParseStringWithClassicLocale(sparse_sgemm_min_sparsity, sparse_sgemm_min_sparsity_) &&
+                    sparse_sgemm_min_sparsity_ >= 0.0f && sparse_sgemm_min_sparsity_ <= 1.0f,
+                "Invalid value for ", kOrtSessionOptionsMlasSparseSgemmMinSparsity, ": ", sparse_sgemm_min_sparsity);
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -43,12 +59,30 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status RestorePrePackedState(const Tensor& tensor, int input_idx,
+                               gsl::span<const size_t> prepacked_buffer_sizes,
+                               /*out*/ bool& restored) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // Kernel generated for the shape of the pre-packed B when the mlas.sgemm_jit option is set.
+  bool use_sgemm_jit_ = false;
+  std::unique_ptr<MLAS_SGEMM_JIT_KERNEL, decltype(&MlasSgemmJitKernelFree)> sgemm_jit_kernel_{nullptr,
+                                                                                              MlasSgemmJitKernelFree};
+
+  void CreateSgemmJitKernel();
+
+  // Minimum fraction of zero 1x16 blocks of a constant 2D B for it to be packed for MlasSparseSgemm, 0 if disabled.
+  float sparse_sgemm_min_sparsity_ = 0.0f;
+  // Whether packed_b_ holds B in the block sparse format of MlasSparseSgemmPackB.
+  bool b_is_sparse_ = false;
+
+  bool SparsePackB(AllocatorPtr& alloc, const Tensor& tensor_b, size_t& packed_b_size);
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -56,12 +90,19 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
-  bool use_fastmath_mode_;
-  // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
+  bool use_fastmath_mode_ = false;
+  // sbgemm kernels work on blocks with weights pre-packed in bf16 pairs
   // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead
   const size_t kFastMathModeKernelsizeThreshold = 32;
+
+  // Whether a B with b_size elements is multiplied, and pre-packed, with the bfloat16 gemm.
+  // It supports neither transposes nor alpha.
+  bool UseFastMathMode(size_t b_size) const {
+    return use_fastmath_mode_ && trans_a_attr_ == 0 && trans_b_attr_ == 0 && alpha_attr_ == 1.0f &&
+           b_size >= kFastMathModeKernelsizeThreshold;
+  }
 #endif
 };
 
@@ -58,6 +58,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Softmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     LogSoftmax,
     1,
@@ -108,6 +115,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    LogSoftmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
 // opset-12 and below
 template <typename T>
 Status Softmax<T>::ComputeImpl(const Tensor& input, Tensor& output, size_t axis,
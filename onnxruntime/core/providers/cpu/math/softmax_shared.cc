@@ -24,6 +24,7 @@
 #include <cmath>
 #include <gsl/gsl>
 
+#include "core/framework/float16.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -103,4 +104,16 @@ common::Status SoftmaxCPU<float>(size_t N,
   return Status::OK();
 }
 
+template <>
+common::Status SoftmaxCPU<MLFloat16>(size_t N,
+                                     size_t D,
+                                     const MLFloat16* Xdata,
+                                     MLFloat16* Ydata,
+                                     bool logarithmic,
+                                     onnxruntime::concurrency::ThreadPool* thread_pool) {
+  // the rows are widened and normalized in single precision by MLAS
+  MlasComputeSoftmax(Xdata, Ydata, N, D, logarithmic, false, thread_pool);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
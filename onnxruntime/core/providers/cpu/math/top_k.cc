@@ -25,6 +25,7 @@
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
 #include <core/common/safeint.h>
 
 namespace onnxruntime {
@@ -140,6 +141,118 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Long contiguous rows with a small k are selected in two phases: a pass over the row keeps the candidates that are
+// at least as good as a threshold estimated from a sample of the row, and the top k are then selected among the
+// candidates. The threshold is the value of a rank in the sample such that the row has k values at least as good
+// with a very high probability, while the candidates are still a small fraction of the row.
+constexpr int64_t kMinThresholdFilterAxis = 4096;
+// k must be at most 1/kMinThresholdFilterRatio of the row.
+constexpr int64_t kMinThresholdFilterRatio = 16;
+constexpr int64_t kThresholdFilterSampleSize = 1024;
+// Smaller k are found as quickly by the heap, whose top is rarely replaced.
+constexpr unsigned kMinThresholdFilterK = 16;
+// Rows at least this long are filtered by several threads when there are fewer rows than threads.
+constexpr int64_t kMinParallelThresholdFilterAxis = 65536;
+
+// Estimates the threshold of the row of n values. Returns false if the sample has a NaN, which does not order.
+template <class Comparator>
+static bool EstimateTopKThreshold(const Comparator& comparer, const typename Comparator::DataType* row, int64_t n,
+                                  unsigned k, std::vector<typename Comparator::DataType>& sample,
+                                  typename Comparator::DataType& threshold) {
+  const int64_t sample_size = std::min(n, kThresholdFilterSampleSize);
+  const int64_t stride = n / sample_size;
+  sample.resize(onnxruntime::narrow<size_t>(sample_size));
+  bool has_nan = false;
+  for (int64_t i = 0; i < sample_size; ++i) {
+    const auto value = row[i * stride];
+    sample[onnxruntime::narrow<size_t>(i)] = value;
+    has_nan |= value != value;
+  }
+  if (has_nan) {
+    return false;
+  }
+
+  // About k * sample_size / n values of the sample are expected to be in the top k of the row. The margin makes
+  // it very unlikely that the threshold is better than the k-th value of the row, which falls back to the full sort.
+  const int64_t rank = std::min<int64_t>(sample_size - 1, k * sample_size / n + 16);
+  std::nth_element(sample.begin(), sample.begin() + rank, sample.end(),
+                   [&comparer](const auto& lhs, const auto& rhs) { return comparer.CompareValueOnly(lhs, rhs); });
+  threshold = sample[onnxruntime::narrow<size_t>(rank)];
+  return true;
+}
+
+// Writes the indices in [begin, end) whose values are at least as good as the threshold to candidates, and returns
+// their number. The loop has no data dependent branch, so it runs at the speed of the loads. NaN values are counted
+// in num_nan.
+template <class Comparator>
+static int64_t FilterTopKCandidates(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                                    int64_t begin, int64_t end, typename Comparator::DataType threshold,
+                                    int64_t* candidates, int64_t& num_nan) {
+  int64_t count = 0;
+  int64_t nan_count = 0;
+  for (int64_t idx = begin; idx < end; ++idx) {
+    const auto value = input_data[idx];
+    candidates[count] = idx;
+    count += (comparer.CompareValueOnly(value, threshold) || value == threshold) ? 1 : 0;
+    nan_count += value != value ? 1 : 0;
+  }
+  num_nan = nan_count;
+  return count;
+}
+
+// Selects the top k elements of the contiguous row at row_offset among the candidates of a threshold. Returns false,
+// without selecting them, if there are fewer than k candidates or NaN values. The candidates are split in chunks
+// filtered by the threads of tp, if any.
+template <class Comparator>
+static bool SelectTopKWithThreshold(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                                    int64_t row_offset, int64_t n, const unsigned k, bool sort_top_k,
+                                    std::vector<typename Comparator::DataType>& sample,
+                                    std::vector<int64_t>& data_holder, concurrency::ThreadPool* tp) {
+  typename Comparator::DataType threshold;
+  if (!EstimateTopKThreshold(comparer, input_data + row_offset, n, k, sample, threshold)) {
+    return false;
+  }
+
+  int64_t* candidates = data_holder.data();
+  int64_t count = 0;
+  int64_t num_nan = 0;
+  const auto num_chunks = tp == nullptr ? 1 : std::min<ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(tp),
+                                                                   onnxruntime::narrow<ptrdiff_t>(n / 16384));
+  if (num_chunks <= 1) {
+    count = FilterTopKCandidates(comparer, input_data, row_offset, row_offset + n, threshold, candidates, num_nan);
+  } else {
+    // Every chunk writes its candidates at the start of its own range of data_holder, which are then moved together.
+    const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+    std::vector<int64_t> chunk_counts(num_chunks);
+    std::vector<int64_t> chunk_nans(num_chunks);
+    concurrency::ThreadPool::TrySimpleParallelFor(tp, num_chunks, [&](std::ptrdiff_t chunk) {
+      const int64_t begin = chunk * chunk_size;
+      const int64_t end = std::min(n, begin + chunk_size);
+      chunk_counts[chunk] = FilterTopKCandidates(comparer, input_data, row_offset + begin, row_offset + end,
+                                                 threshold, candidates + begin, chunk_nans[chunk]);
+    });
+    for (ptrdiff_t chunk = 0; chunk < num_chunks; ++chunk) {
+      if (count != chunk * chunk_size) {
+        std::copy_n(candidates + chunk * chunk_size, chunk_counts[chunk], candidates + count);
+      }
+      count += chunk_counts[chunk];
+      num_nan += chunk_nans[chunk];
+    }
+  }
+
+  if (num_nan > 0 || count < k) {
+    return false;
+  }
+
+  // All the values that are at least as good as the k-th value of the row are candidates, so the top k of the
+  // candidates, with the lower index first among equal values, are the top k of the row.
+  std::nth_element(candidates, candidates + (k - 1), candidates + count, comparer);
+  if (sort_top_k) {
+    std::sort(candidates, candidates + k, comparer);
+  }
+  return true;
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -179,9 +292,45 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   //            k = [ 1, 2, 4, 6, 8, 16, 24, 32, 48, 64, 128 ]
   bool use_priority_queue = k != 1 && (k < 4 || (std::log2(k) / std::log2(num_blocks)) < 0.725);
 
+  // the values of the rows are contiguous and a row is long enough for the threshold to leave few candidates
+  const bool use_threshold_filter = std::is_arithmetic_v<typename Comparator::DataType> && block_slice == 1 &&
+                                    k >= kMinThresholdFilterK && num_blocks >= kMinThresholdFilterAxis &&
+                                    k <= num_blocks / kMinThresholdFilterRatio;
+
   std::function<void(std::ptrdiff_t batch)> find_top_k;
 
-  if (k == 1) {
+  if (use_threshold_filter) {
+    // with fewer rows than threads, the rows are selected one after the other and the threads filter every row
+    concurrency::ThreadPool* filter_threadpool = nullptr;
+    if (rows < tp_threads && num_blocks >= kMinParallelThresholdFilterAxis) {
+      filter_threadpool = threadpool;
+      num_threads = 1;
+    }
+
+    find_top_k =
+        [num_threads, rows, num_blocks, k, sorted, input_data, cols, filter_threadpool,
+         &values_map, &indices_map](std::ptrdiff_t batch) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch, onnxruntime::narrow<size_t>(num_threads), onnxruntime::narrow<size_t>(rows));
+          Comparator comparer(input_data);
+
+          std::vector<typename Comparator::DataType> sample;
+          std::vector<int64_t> data_holder(onnxruntime::narrow<size_t>(num_blocks));
+
+          for (auto i = work.start; i < work.end; ++i) {
+            auto row_offset = i * cols;
+            if (!SelectTopKWithThreshold(comparer, input_data, row_offset, num_blocks, k, sorted, sample,
+                                         data_holder, filter_threadpool)) {
+              SelectTopK<Comparator>(comparer, row_offset, num_blocks, 1, 0, k, sorted, data_holder);
+            }
+
+            for (int64_t l = 0; l < k; ++l) {
+              int64_t idx = data_holder[onnxruntime::narrow<size_t>(l)];
+              values_map(i, onnxruntime::narrow<size_t>(l)) = input_data[idx];
+              indices_map(i, onnxruntime::narrow<size_t>(l)) = idx - row_offset;
+            }
+          }
+        };
+  } else if (k == 1) {
     // just need to compare values and not indexes as the first instance of the best value is always selected
     find_top_k =
         [num_threads, rows, block_slice, num_blocks, input_data, cols,
@@ -32,15 +32,10 @@ Status LabelEncoder::Compute(OpKernelContext* context) const {
 
     auto input = gsl::make_span(X.Data<std::string>(), onnxruntime::narrow<size_t>(shape.Size()));
     auto output = gsl::make_span(Y.MutableData<int64_t>(), onnxruntime::narrow<size_t>(shape.Size()));
-    auto out = output.begin();
 
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
-    std::for_each(input.begin(), input.end(), [&out, &map_end, this](const std::string& value) {
+    ParallelMapElements(context->GetOperatorThreadPool(), input, output, [this](const std::string& value) {
       auto map_to = string_to_int_map_.find(value);
-      *out = map_to == map_end ? default_int_ : map_to->second;
-      ++out;
+      return map_to == string_to_int_map_.end() ? default_int_ : map_to->second;
     });
   } else {
     if (!Y.IsDataTypeString())
@@ -48,15 +43,13 @@ Status LabelEncoder::Compute(OpKernelContext* context) const {
 
     auto input = gsl::make_span(X.Data<int64_t>(), onnxruntime::narrow<size_t>(shape.Size()));
     auto output = gsl::make_span(Y.MutableData<std::string>(), onnxruntime::narrow<size_t>(shape.Size()));
-    auto out = output.begin();
-
-    const auto map_end = int_to_string_map_.end();
 
-    std::for_each(input.begin(), input.end(), [&out, &map_end, this](const int64_t& value) {
-      auto map_to = int_to_string_map_.find(value);
-      *out = map_to == map_end ? default_string_ : map_to->second;
-      ++out;
-    });
+    const auto num_classes = static_cast<int64_t>(classes_.size());
+    ParallelMapElements(context->GetOperatorThreadPool(), input, output,
+                        [this, num_classes](int64_t value) -> const std::string& {
+                          return value >= 0 && value < num_classes ? classes_[onnxruntime::narrow<size_t>(value)]
+                                                                   : default_string_;
+                        });
   }
 
   return Status::OK();
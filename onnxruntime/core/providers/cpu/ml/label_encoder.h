@@ -25,21 +25,20 @@ class LabelEncoder final : public OpKernel {
     auto num_entries = string_classes.size();
 
     string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
 
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
+      string_to_int_map_[string_classes[i]] = i;
     }
+
+    // the label of a class is its index in the classes
+    classes_ = std::move(string_classes);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  InlinedHashMap<std::string, int64_t> string_to_int_map_;
+  std::vector<std::string> classes_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -74,14 +73,10 @@ class LabelEncoder_2 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    ParallelMapElements(context->GetOperatorThreadPool(), input, output, [this](const TKey& key) -> const TValue& {
+      const auto found = map_.find(key);
+      return found == map_.end() ? default_value_ : found->second;
+    });
     return Status::OK();
   }
 
@@ -213,14 +208,10 @@ class LabelEncoder_4 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    ParallelMapElements(context->GetOperatorThreadPool(), input, output, [this](const TKey& key) -> const TValue& {
+      const auto found = map_.find(key);
+      return found == map_.end() ? default_value_ : found->second;
+    });
     return Status::OK();
   }
 
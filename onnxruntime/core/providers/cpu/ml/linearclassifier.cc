@@ -36,6 +36,10 @@ LinearClassifier::LinearClassifier(const OpKernelInfo& info)
 
   using_strings_ = !classlabels_strings_.empty();
   class_count_ = static_cast<ptrdiff_t>(intercepts_.size());
+
+  if (class_count_ > 0) {
+    packed_coefficients_.Pack(info, coefficients_, narrow<size_t>(class_count_), coefficients_.size() / class_count_);
+  }
 }
 
 // Use GEMM for the calculations, with broadcasting of intercepts
@@ -60,60 +64,89 @@ void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
               "Scores output is incorrect size. Expected:", scores_output_size,
               " Found:", scores_output_data.size());
 
-  TensorShape intercepts_shape({num_targets});
-  onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        num_batches, num_targets, num_features,
-                                        1.f, input_data, coefficients.data(), 1.f,
-                                        intercepts.data(), &intercepts_shape,
-                                        scores_output_data.data(),
-                                        threadpool);
-
-  float* score = scores_output_data.data();
-  float* end_scores = score + (num_batches * num_targets);  // we haven't added extra targets yet so iterate the original scores
-
-  if (num_targets == 1) {
-    if (using_strings_) {
-      std::string* y_out = labels_output.MutableData<std::string>();
-      bool use_class_labels = classlabels_strings_.size() == 2;
-      std::string positive_label = use_class_labels ? classlabels_strings_[1] : "1";
-      std::string negative_label = use_class_labels ? classlabels_strings_[0] : "0";
-
-      while (score < end_scores) {
-        *y_out++ = (*score++ > 0) ? positive_label
-                                  : negative_label;
+  const bool is_packed = packed_coefficients_.IsPackedFor(narrow<size_t>(num_targets), narrow<size_t>(num_features));
+  if (!is_packed) {
+    TensorShape intercepts_shape({num_targets});
+    onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                          num_batches, num_targets, num_features,
+                                          1.f, input_data, coefficients.data(), 1.f,
+                                          intercepts.data(), &intercepts_shape,
+                                          scores_output_data.data(),
+                                          threadpool);
+  }
+
+  // the labels of the batches [first, last), from the scores before the post transform
+  auto write_labels = [&](ptrdiff_t first, ptrdiff_t last) {
+    const float* score = scores_output_data.data() + first * num_targets;
+
+    if (num_targets == 1) {
+      if (using_strings_) {
+        std::string* y_out = labels_output.MutableData<std::string>();
+        bool use_class_labels = classlabels_strings_.size() == 2;
+        std::string positive_label = use_class_labels ? classlabels_strings_[1] : "1";
+        std::string negative_label = use_class_labels ? classlabels_strings_[0] : "0";
+
+        for (ptrdiff_t i = first; i < last; ++i) {
+          y_out[i] = (*score++ > 0) ? positive_label
+                                    : negative_label;
+        }
+      } else {
+        int64_t* y_out = labels_output.MutableData<int64_t>();
+        bool use_class_labels = classlabels_ints_.size() == 2;
+        int64_t positive_label = use_class_labels ? classlabels_ints_[1] : 1;
+        int64_t negative_label = use_class_labels ? classlabels_ints_[0] : 0;
+
+        for (ptrdiff_t i = first; i < last; ++i) {
+          y_out[i] = (*score++ > 0) ? positive_label
+                                    : negative_label;
+        }
       }
     } else {
-      int64_t* y_out = labels_output.MutableData<int64_t>();
-      bool use_class_labels = classlabels_ints_.size() == 2;
-      int64_t positive_label = use_class_labels ? classlabels_ints_[1] : 1;
-      int64_t negative_label = use_class_labels ? classlabels_ints_[0] : 0;
-
-      while (score < end_scores) {
-        *y_out++ = (*score++ > 0) ? positive_label
-                                  : negative_label;
-      }
-    }
-  } else {
-    for (int64_t i = 0; i < num_batches; ++i) {
-      int maxclass = 0;
-      float maxweight = *score++;
-
-      for (int j = 1; j < num_targets; ++j, ++score) {
-        if (*score > maxweight) {
-          maxweight = *score;
-          maxclass = j;
+      for (ptrdiff_t i = first; i < last; ++i) {
+        int maxclass = 0;
+        float maxweight = *score++;
+
+        for (int j = 1; j < num_targets; ++j, ++score) {
+          if (*score > maxweight) {
+            maxweight = *score;
+            maxclass = j;
+          }
         }
-      }
 
-      if (using_strings_) {
-        labels_output.MutableData<std::string>()[i] = classlabels_strings_[maxclass];
-      } else {
-        labels_output.MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
+        if (using_strings_) {
+          labels_output.MutableData<std::string>()[i] = classlabels_strings_[maxclass];
+        } else {
+          labels_output.MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
+        }
       }
     }
+  };
+
+  // the expansion of the single score of the binary case to two scores is done once for all the batches
+  const bool transform_blocks = is_packed && post_transform != POST_EVAL_TRANSFORM::NONE && !add_second_class;
+
+  if (is_packed) {
+    // Each block of batches is scored, labeled and transformed while its scores are still in cache.
+    concurrency::ThreadPool::TryParallelFor(
+        threadpool, num_batches,
+        TensorOpCost{static_cast<double>(num_features * sizeof(float)),
+                     static_cast<double>(num_targets * sizeof(float)),
+                     static_cast<double>(2 * num_features * num_targets)},
+        [&](ptrdiff_t first, ptrdiff_t last) {
+          float* block_scores = scores_output_data.data() + first * num_targets;
+          packed_coefficients_.Compute(narrow<size_t>(last - first), 1.f, input_data + first * num_features, 0.f,
+                                       intercepts.data(), block_scores, nullptr);
+          write_labels(first, last);
+          if (transform_blocks) {
+            ml::batched_update_scores_inplace(gsl::make_span(block_scores, SafeInt<size_t>(last - first) * num_targets),
+                                              last - first, num_targets, post_transform, -1, false, nullptr);
+          }
+        });
+  } else {
+    write_labels(0, num_batches);
   }
 
-  if (post_transform != POST_EVAL_TRANSFORM::NONE || add_second_class) {
+  if (!transform_blocks && (post_transform != POST_EVAL_TRANSFORM::NONE || add_second_class)) {
     ml::batched_update_scores_inplace(scores_output_data, num_batches, num_targets, post_transform,
                                       add_second_class ? 1 : -1, false,
                                       threadpool);
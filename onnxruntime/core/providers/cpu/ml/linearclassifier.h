@@ -32,6 +32,7 @@ class LinearClassifier final : public OpKernel {
   bool using_strings_;
   std::vector<float> coefficients_;
   std::vector<float> intercepts_;
+  PackedGemmB packed_coefficients_;
   std::vector<std::string> classlabels_strings_;
   std::vector<int64_t> classlabels_ints_;
 };
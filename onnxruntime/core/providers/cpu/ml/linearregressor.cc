@@ -26,6 +26,11 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 
   // use the intercepts_ if they're valid
   use_intercepts_ = intercepts_.size() == static_cast<size_t>(num_targets_);
+
+  if (num_targets_ > 0) {
+    packed_coefficients_.Pack(info, coefficients_, narrow<size_t>(num_targets_),
+                              coefficients_.size() / narrow<size_t>(num_targets_));
+  }
 }
 
 // Use GEMM for the calculations, with broadcasting of intercepts
@@ -37,13 +42,33 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 // Output: X * coefficients_^T + intercepts_: [num_batches, num_targets]
 template <typename T>
 static Status ComputeImpl(const Tensor& input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
-                          const std::vector<float>& coefficients,
+                          const std::vector<float>& coefficients, const PackedGemmB& packed_coefficients,
                           const std::vector<float>* intercepts, Tensor& output,
                           POST_EVAL_TRANSFORM post_transform,
                           concurrency::ThreadPool* threadpool) {
   const T* input_data = input.Data<T>();
   T* output_data = output.MutableData<T>();
 
+  if (packed_coefficients.IsPackedFor(narrow<size_t>(num_targets), narrow<size_t>(num_features))) {
+    // Each block of batches is transformed while its scores are still in cache.
+    concurrency::ThreadPool::TryParallelFor(
+        threadpool, num_batches,
+        TensorOpCost{static_cast<double>(num_features * sizeof(T)),
+                     static_cast<double>(num_targets * sizeof(T)),
+                     static_cast<double>(2 * num_features * num_targets)},
+        [&](ptrdiff_t first, ptrdiff_t last) {
+          T* block_output = output_data + first * num_targets;
+          packed_coefficients.Compute(narrow<size_t>(last - first), 1.f, input_data + first * num_features, 0.f,
+                                      intercepts != nullptr ? intercepts->data() : nullptr, block_output, nullptr);
+          if (post_transform != POST_EVAL_TRANSFORM::NONE) {
+            ml::batched_update_scores_inplace(gsl::make_span(block_output, SafeInt<size_t>(last - first) * num_targets),
+                                              last - first, num_targets, post_transform, -1, false, nullptr);
+          }
+        });
+
+    return Status::OK();
+  }
+
   if (intercepts != nullptr) {
     TensorShape intercepts_shape({num_targets});
     onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
@@ -91,7 +116,7 @@ Status LinearRegressor::Compute(OpKernelContext* ctx) const {
   switch (element_type) {
     case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
       status = ComputeImpl<float>(X, num_batches, num_features, narrow<ptrdiff_t>(num_targets_), coefficients_,
-                                  use_intercepts_ ? &intercepts_ : nullptr,
+                                  packed_coefficients_, use_intercepts_ ? &intercepts_ : nullptr,
                                   Y, post_transform_, tp);
 
       break;
@@ -524,5 +524,67 @@ void batched_update_scores_inplace(gsl::span<T> scores, int64_t num_batches_in,
     }
   }
 }
+
+// output[i] = map_fn(input[i]) for the elements of the input, in parallel blocks of a large input. map_fn is a hash
+// table lookup, e.g. of a category or of a label.
+template <typename TIn, typename TOut, typename MapFn>
+void ParallelMapElements(concurrency::ThreadPool* threadpool, gsl::span<const TIn> input, gsl::span<TOut> output,
+                         const MapFn& map_fn) {
+  ORT_ENFORCE(input.size() == output.size());
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TIn)), static_cast<double>(sizeof(TOut)), 32.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output[i] = map_fn(input[i]);
+        }
+      });
+}
+
+// A constant matrix B [n, k] from the attributes of a kernel, e.g. the coefficients of a linear model or the support
+// vectors of a SVM, packed once when the kernel is created for the MLAS SGEMMs A [m, k] * B^T of each run.
+class PackedGemmB {
+ public:
+  // B is left unpacked if it doesn't have n * k values, or if MLAS doesn't pack B on this platform.
+  void Pack(const OpKernelInfo& info, gsl::span<const float> b, size_t n, size_t k) {
+    const size_t packed_size = n > 0 && k > 0 && b.size() == n * k ? MlasGemmPackBSize(n, k) : 0;
+    AllocatorPtr alloc = packed_size > 0 ? info.GetAllocator(OrtMemTypeDefault) : nullptr;
+    if (alloc == nullptr) {
+      return;
+    }
+
+    packed_ = IAllocator::MakeUniquePtr<void>(alloc, packed_size, true);
+    MlasGemmPackB(CblasTrans, n, k, b.data(), k, packed_.get());
+    n_ = n;
+    k_ = k;
+  }
+
+  bool IsPackedFor(size_t n, size_t k) const { return packed_ != nullptr && n == n_ && k == k_; }
+
+  // c [m, n] = alpha * a [m, k] * B^T + beta * c, plus the bias [n] of each column if it isn't nullptr.
+  void Compute(size_t m, float alpha, const float* a, float beta, const float* bias, float* c,
+               concurrency::ThreadPool* threadpool) const {
+    MLAS_SGEMM_EPILOGUE epilogue;
+    epilogue.Bias = bias;
+
+    MLAS_SGEMM_DATA_PARAMS data;
+    data.A = a;
+    data.lda = k_;
+    data.B = static_cast<const float*>(packed_.get());
+    data.BIsPacked = true;
+    data.C = c;
+    data.ldc = n_;
+    data.alpha = alpha;
+    data.beta = beta;
+    data.Epilogue = bias != nullptr ? &epilogue : nullptr;
+    MlasGemm(CblasNoTrans, CblasTrans, m, n_, k_, data, threadpool);
+  }
+
+ private:
+  IAllocatorUniquePtr<void> packed_;
+  size_t n_{0};
+  size_t k_{0};
+};
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -63,10 +63,12 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   if (vector_count_ > 0) {
     feature_count_ = support_vectors_.size() / vector_count_;  // length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
+    pack_kernel_vectors(info, support_vectors_, narrow<size_t>(vector_count_), narrow<size_t>(feature_count_));
   } else {
     feature_count_ = coefficients_.size() / class_count_;  // liblinear mode
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
+    pack_kernel_vectors(info, coefficients_, narrow<size_t>(class_count_), narrow<size_t>(feature_count_));
   }
 
   ORT_ENFORCE(classlabels_strings_.size() > 0 || classlabels_ints_.size() > 0);
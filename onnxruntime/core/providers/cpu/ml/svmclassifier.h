@@ -30,6 +30,15 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
+  // Packs the vectors [n, k] that batched_kernel_dot combines with the input, the support vectors or the
+  // coefficients of a linear SVM, for the kernels computed with a GEMM.
+  void pack_kernel_vectors(const OpKernelInfo& info, const std::vector<float>& vectors, size_t n, size_t k) {
+    if (kernel_type_ != KERNEL::RBF) {
+      packed_vectors_.Pack(info, vectors, n, k);
+      packed_vectors_data_ = vectors.data();
+    }
+  }
+
   template <typename T>
   void batched_kernel_dot(const gsl::span<const T> a, const gsl::span<const T> b,
                           ptrdiff_t m, ptrdiff_t n, ptrdiff_t k,
@@ -39,28 +48,25 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
-
-        cur_batch += k;  // move to start of next batch
-      }
+      // each column is a support vector of 'k' features
+      ConstEigenMatrixMap<T> support_vectors(b.data(), k, n);
+
+      // broadcast the support vectors against the k features in each batch. output is one value per support vector
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m,
+          TensorOpCost{static_cast<double>(k * sizeof(T)), static_cast<double>(n * sizeof(T)),
+                       static_cast<double>(3 * n * k)},
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t batch = first; batch < last; ++batch) {
+              EigenVectorArrayMap<T> cur_out(out.data() + batch * n, n);
+              cur_out = (support_vectors.colwise() - ConstEigenVectorMap<T>(a.data() + batch * k, k))
+                            .colwise()
+                            .squaredNorm()
+                            .transpose()
+                            .array();
+              cur_out = (cur_out * -gamma_).exp();
+            }
+          });
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -73,12 +79,20 @@ class SVMCommon {
         c = coef0_;
       }
 
-      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        m, n, k,
-                                        alpha, a.data(), b.data(), beta,
-                                        c != 0.f ? &c : nullptr, &shape_C,
-                                        out.data(),
-                                        threadpool);
+      if (b.data() == packed_vectors_data_ && packed_vectors_.IsPackedFor(narrow<size_t>(n), narrow<size_t>(k))) {
+        if (c != 0.f) {
+          std::fill(out.begin(), out.end(), c);
+        }
+        packed_vectors_.Compute(narrow<size_t>(m), alpha, a.data(), c != 0.f ? beta : 0.f, nullptr, out.data(),
+                                threadpool);
+      } else {
+        onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                          m, n, k,
+                                          alpha, a.data(), b.data(), beta,
+                                          c != 0.f ? &c : nullptr, &shape_C,
+                                          out.data(),
+                                          threadpool);
+      }
 
       if (kernel_type_ == KERNEL::POLY) {
         auto map_out = EigenVectorArrayMap<T>(out.data(), out.size());
@@ -100,11 +114,14 @@ class SVMCommon {
   float gamma_{0.f};
   float coef0_{0.f};
   float degree_{0.f};
+  PackedGemmB packed_vectors_;
+  const float* packed_vectors_data_{nullptr};
 };
 
 class SVMClassifier final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
   using SVMCommon::get_kernel_type;
+  using SVMCommon::pack_kernel_vectors;
   using SVMCommon::set_kernel_type;
 
  public:
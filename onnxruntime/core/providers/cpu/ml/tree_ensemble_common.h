@@ -6,7 +6,10 @@
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "tree_ensemble_compact_layout.h"
 #include "tree_ensemble_helper.h"
+#include "tree_ensemble_quick_scorer.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -47,6 +50,13 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  // Evaluates the trees of large ensembles of deep trees with bit vectors instead of walking them.
+  TreeEnsembleQuickScorer<InputType, ThresholdType> quick_scorer_;
+  bool use_quick_scorer_ = false;
+  // Value of kOrtSessionOptionsTreeEnsembleCompactLayout, and the layout it requests.
+  std::string compact_layout_option_ = "0";
+  TreeEnsembleCompactLayout<InputType, ThresholdType> compact_layout_;
+  bool use_compact_layout_ = false;
 
  public:
   TreeEnsembleCommon() {}
@@ -86,6 +96,13 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
+  // Evaluates all the trees on every row in turn. make_leaf_finder returns a functor, used by one thread, setting the
+  // leaf reached by a row in every tree.
+  template <typename AGG, typename MakeLeafFinder>
+  void ComputeAggByRows(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                        int64_t* label_data, int64_t N, int64_t stride, const AGG& agg,
+                        const MakeLeafFinder& make_leaf_finder) const;
+
  private:
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
@@ -104,6 +121,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "nodes_values_as_tensor", nodes_values_as_tensor));
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "target_weights_as_tensor", target_weights_as_tensor));
 #endif
+  compact_layout_option_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsTreeEnsembleCompactLayout, "0");
 
   return Init(
       80,
@@ -338,6 +356,21 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  ORT_RETURN_IF_NOT(compact_layout_option_ == "0" || compact_layout_option_ == "1" || compact_layout_option_ == "2",
+                    "Invalid value for ", kOrtSessionOptionsTreeEnsembleCompactLayout, ": ", compact_layout_option_);
+  use_quick_scorer_ = false;
+  use_compact_layout_ = false;
+  if (same_mode_) {
+    auto first_branch = std::find_if(nodes_.begin(), nodes_.end(),
+                                     [](const TreeNodeElement<ThresholdType>& node) { return node.is_not_leaf(); });
+    if (first_branch != nodes_.end()) {
+      use_compact_layout_ = compact_layout_option_ != "0" &&
+                            compact_layout_.Init(nodes_, roots_, first_branch->mode(), max_feature_id_,
+                                                 compact_layout_option_ == "2");
+      use_quick_scorer_ = !use_compact_layout_ && quick_scorer_.Init(roots_, first_branch->mode(), max_feature_id_);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -455,6 +488,36 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
+  // A single row is still better evaluated by walking the trees in parallel when there are enough of them.
+  if ((use_quick_scorer_ || use_compact_layout_) && (N > 1 || n_trees_ <= parallel_tree_ || max_num_threads == 1)) {
+    // The rows with a missing value are evaluated by walking the trees.
+    auto find_leaves = [this](const InputType* row, const TreeNodeElement<ThresholdType>** leaves) {
+      for (size_t j = 0; j < roots_.size(); ++j) {
+        leaves[j] = ProcessTreeNodeLeave(roots_[j], row);
+      }
+    };
+    if (use_compact_layout_) {
+      ComputeAggByRows(ttp, x_data, z_data, label_data, N, stride, agg, [this, &find_leaves]() {
+        return [this, &find_leaves, bins = std::vector<uint16_t>(compact_layout_.NumBins())](
+                   const InputType* row, const TreeNodeElement<ThresholdType>** leaves) mutable {
+          if (!compact_layout_.ComputeLeaves(row, bins.data(), leaves)) {
+            find_leaves(row, leaves);
+          }
+        };
+      });
+    } else {
+      ComputeAggByRows(ttp, x_data, z_data, label_data, N, stride, agg, [this, &find_leaves]() {
+        return [this, &find_leaves, bit_vectors = std::vector<uint64_t>(roots_.size())](
+                   const InputType* row, const TreeNodeElement<ThresholdType>** leaves) mutable {
+          if (!quick_scorer_.ComputeLeaves(row, bit_vectors.data(), leaves)) {
+            find_leaves(row, leaves);
+          }
+        };
+      });
+    }
+    return;
+  }
+
   if (n_targets_or_classes_ == 1) {
     if (N == 1) {
       ScoreValue<ThresholdType> score = {0, 0};
@@ -669,6 +732,54 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG, typename MakeLeafFinder>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggByRows(
+    concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data, int64_t* label_data, int64_t N,
+    int64_t stride, const AGG& agg, const MakeLeafFinder& make_leaf_finder) const {
+  // The trees are aggregated in the same order as in ComputeAgg, so the scores are the same.
+  auto compute_rows = [this, &agg, &make_leaf_finder, x_data, z_data, label_data, stride](std::ptrdiff_t begin,
+                                                                                          std::ptrdiff_t end) {
+    const size_t n_trees = roots_.size();
+    auto find_leaves = make_leaf_finder();
+    std::vector<const TreeNodeElement<ThresholdType>*> leaves(n_trees);
+    InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+    for (std::ptrdiff_t i = begin; i < end; ++i) {
+      find_leaves(x_data + i * stride, leaves.data());
+
+      if (n_targets_or_classes_ == 1) {
+        ScoreValue<ThresholdType> score = {0, 0};
+        for (size_t j = 0; j < n_trees; ++j) {
+          agg.ProcessTreeNodePrediction1(score, *leaves[j]);
+        }
+        agg.FinalizeScores1(z_data + i, score, label_data == nullptr ? nullptr : (label_data + i));
+      } else {
+        std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
+        for (size_t j = 0; j < n_trees; ++j) {
+          agg.ProcessTreeNodePrediction(scores, *leaves[j], weights_);
+        }
+        agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
+                           label_data == nullptr ? nullptr : (label_data + i));
+      }
+    }
+  };
+
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+  if (N <= parallel_N_ || max_num_threads == 1) {
+    compute_rows(0, onnxruntime::narrow<std::ptrdiff_t>(N));
+  } else {
+    auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [&compute_rows, num_threads, N](ptrdiff_t batch_num) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads),
+                                                             onnxruntime::narrow<ptrdiff_t>(N));
+          compute_rows(work.start, work.end);
+        });
+  }
+}
+
 #define TREE_FIND_VALUE(CMP)                                                                           \
   if (has_missing_tracks_) {                                                                           \
     while (root->is_not_leaf()) {                                                                      \
@@ -820,6 +931,8 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "nodes_values_as_tensor", nodes_values_as_tensor));
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "class_weights_as_tensor", class_weights_as_tensor));
 #endif
+  this->compact_layout_option_ =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsTreeEnsembleCompactLayout, "0");
 
   return Init(
       80,
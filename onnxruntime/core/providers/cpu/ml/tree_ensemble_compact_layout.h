@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Node of TreeEnsembleCompactLayout. Threshold is either the type of the thresholds or uint16_t for the index of the
+// threshold among the sorted thresholds of its feature.
+template <typename Threshold>
+struct CompactTreeNode {
+  static constexpr uint16_t kLeaf = std::numeric_limits<uint16_t>::max();
+
+  uint32_t true_node;   // index of the true branch, the false branch is the next node
+  uint16_t feature_id;  // kLeaf for a leaf
+  Threshold threshold;
+};
+
+// Copy of the decision nodes of an ensemble in a smaller layout, so the nodes of large ensembles are more likely to
+// stay in the caches while the rows are evaluated: 12 bytes per node for float thresholds and 8 bytes per node with
+// binned thresholds, instead of the 24 bytes of TreeNodeElement. The nodes keep the depth first order of
+// TreeEnsembleCommon::nodes_, where the false branch is the next node, so a leaf is found in nodes_ at the same index.
+//
+// With binned thresholds, every feature of a row is replaced once by the number of distinct thresholds of the feature
+// below it, which is compared to the index of the node threshold instead of the threshold itself. E.g. x <= t_k holds
+// for the k-th smallest distinct threshold t_k if and only if fewer than k + 1 thresholds are smaller than x. The
+// results are the same as with the thresholds.
+//
+// The nodes must all use the same mode, and there must be fewer than 65535 features. Binning also requires one of
+// BRANCH_LEQ, BRANCH_LT, BRANCH_GTE or BRANCH_GT, and fewer than 65535 distinct thresholds per feature. The rows with a
+// missing value are left to the usual traversal, which handles the missing value tracks.
+template <typename InputType, typename ThresholdType>
+class TreeEnsembleCompactLayout {
+ public:
+  // Returns false if the ensemble cannot be encoded.
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+            const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+            NODE_MODE mode, int64_t max_feature_id, bool bin_thresholds) {
+    if (nodes.empty() || max_feature_id >= CompactTreeNode<uint16_t>::kLeaf ||
+        nodes.size() >= std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+
+    mode_ = mode;
+    n_features_ = static_cast<size_t>(max_feature_id) + 1;
+    leaves_ = nodes.data();
+    roots_.clear();
+    for (const auto* root : roots) {
+      roots_.push_back(static_cast<uint32_t>(root - nodes.data()));
+    }
+
+    binned_ = bin_thresholds && (mode == NODE_MODE::BRANCH_LEQ || mode == NODE_MODE::BRANCH_LT ||
+                                 mode == NODE_MODE::BRANCH_GTE || mode == NODE_MODE::BRANCH_GT);
+    if (binned_) {
+      binned_ = InitBins(nodes);
+    }
+
+    nodes_.clear();
+    binned_nodes_.clear();
+    for (const auto& node : nodes) {
+      const bool is_leaf = !node.is_not_leaf();
+      if (!is_leaf && (node.mode() != mode || node.feature_id < 0)) {
+        return false;
+      }
+
+      const uint32_t true_node = is_leaf ? 0 : static_cast<uint32_t>(node.truenode_or_weight.ptr - nodes.data());
+      const uint16_t feature_id = is_leaf ? CompactTreeNode<uint16_t>::kLeaf : static_cast<uint16_t>(node.feature_id);
+      if (binned_) {
+        uint16_t bin = 0;
+        if (!is_leaf) {
+          const auto* begin = bin_edges_.data() + bin_offsets_[node.feature_id];
+          const auto* end = bin_edges_.data() + bin_offsets_[node.feature_id + 1];
+          bin = static_cast<uint16_t>(std::lower_bound(begin, end, node.value_or_unique_weight) - begin);
+        }
+        binned_nodes_.push_back({true_node, feature_id, bin});
+      } else {
+        nodes_.push_back({true_node, feature_id, is_leaf ? ThresholdType{} : node.value_or_unique_weight});
+      }
+    }
+    return true;
+  }
+
+  // Number of elements of the buffer ComputeLeaves needs for the bins of a row.
+  size_t NumBins() const { return binned_ ? n_features_ : 0; }
+
+  // Sets the leaf reached by the row in every tree. Returns false, without setting the leaves, if the row has a
+  // missing value.
+  bool ComputeLeaves(const InputType* x_data, uint16_t* bins, const TreeNodeElement<ThresholdType>** leaves) const {
+    if constexpr (std::is_floating_point_v<InputType>) {
+      for (size_t feature = 0; feature < n_features_; ++feature) {
+        if (std::isnan(x_data[feature])) {
+          return false;
+        }
+      }
+    }
+
+    if (!binned_) {
+      switch (mode_) {
+        case NODE_MODE::BRANCH_LEQ:
+          FindLeaves(nodes_, x_data, std::less_equal<>(), leaves);
+          break;
+        case NODE_MODE::BRANCH_LT:
+          FindLeaves(nodes_, x_data, std::less<>(), leaves);
+          break;
+        case NODE_MODE::BRANCH_GTE:
+          FindLeaves(nodes_, x_data, std::greater_equal<>(), leaves);
+          break;
+        case NODE_MODE::BRANCH_GT:
+          FindLeaves(nodes_, x_data, std::greater<>(), leaves);
+          break;
+        case NODE_MODE::BRANCH_EQ:
+          FindLeaves(nodes_, x_data, std::equal_to<>(), leaves);
+          break;
+        case NODE_MODE::BRANCH_NEQ:
+          FindLeaves(nodes_, x_data, std::not_equal_to<>(), leaves);
+          break;
+        case NODE_MODE::LEAF:  // every tree is a single leaf
+          FindLeaves(nodes_, x_data, std::equal_to<>(), leaves);
+          break;
+      }
+      return true;
+    }
+
+    // x <= t and x > t compare the number of thresholds below x, x < t and x >= t the number of thresholds up to x.
+    const bool strict = mode_ == NODE_MODE::BRANCH_LT || mode_ == NODE_MODE::BRANCH_GTE;
+    for (size_t feature = 0; feature < n_features_; ++feature) {
+      const auto* begin = bin_edges_.data() + bin_offsets_[feature];
+      const auto* end = bin_edges_.data() + bin_offsets_[feature + 1];
+      const auto* bin = strict ? std::upper_bound(begin, end, x_data[feature])
+                               : std::lower_bound(begin, end, x_data[feature]);
+      bins[feature] = static_cast<uint16_t>(bin - begin);
+    }
+    if (mode_ == NODE_MODE::BRANCH_LEQ || mode_ == NODE_MODE::BRANCH_LT) {
+      FindLeaves(binned_nodes_, bins, std::less_equal<>(), leaves);
+    } else {
+      FindLeaves(binned_nodes_, bins, std::greater<>(), leaves);
+    }
+    return true;
+  }
+
+ private:
+  bool InitBins(const std::vector<TreeNodeElement<ThresholdType>>& nodes) {
+    std::vector<std::vector<ThresholdType>> thresholds(n_features_);
+    for (const auto& node : nodes) {
+      if (node.is_not_leaf() && node.feature_id >= 0 && static_cast<size_t>(node.feature_id) < n_features_) {
+        thresholds[node.feature_id].push_back(node.value_or_unique_weight);
+      }
+    }
+
+    bin_offsets_.assign(1, 0);
+    bin_edges_.clear();
+    for (auto& feature_thresholds : thresholds) {
+      std::sort(feature_thresholds.begin(), feature_thresholds.end());
+      feature_thresholds.erase(std::unique(feature_thresholds.begin(), feature_thresholds.end()),
+                               feature_thresholds.end());
+      if (feature_thresholds.size() >= std::numeric_limits<uint16_t>::max()) {
+        return false;
+      }
+      bin_edges_.insert(bin_edges_.end(), feature_thresholds.begin(), feature_thresholds.end());
+      bin_offsets_.push_back(bin_edges_.size());
+    }
+    return true;
+  }
+
+  template <typename Threshold, typename Value, typename Compare>
+  void FindLeaves(const std::vector<CompactTreeNode<Threshold>>& nodes, const Value* x_data, Compare compare,
+                  const TreeNodeElement<ThresholdType>** leaves) const {
+    const CompactTreeNode<Threshold>* data = nodes.data();
+    for (size_t tree = 0; tree < roots_.size(); ++tree) {
+      uint32_t index = roots_[tree];
+      while (data[index].feature_id != CompactTreeNode<Threshold>::kLeaf) {
+        const auto& node = data[index];
+        index = compare(x_data[node.feature_id], node.threshold) ? node.true_node : index + 1;
+      }
+      leaves[tree] = leaves_ + index;
+    }
+  }
+
+  NODE_MODE mode_ = NODE_MODE::LEAF;
+  bool binned_ = false;
+  size_t n_features_ = 0;
+  std::vector<uint32_t> roots_;
+  std::vector<CompactTreeNode<ThresholdType>> nodes_;
+  std::vector<CompactTreeNode<uint16_t>> binned_nodes_;
+  // Distinct thresholds of every feature in increasing order, starting at bin_offsets_[feature].
+  std::vector<size_t> bin_offsets_;
+  std::vector<ThresholdType> bin_edges_;
+  // TreeEnsembleCommon::nodes_, whose leaves have the aggregated weights.
+  const TreeNodeElement<ThresholdType>* leaves_ = nullptr;
+};
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Evaluates all the trees of an ensemble on one row without walking the trees, following QuickScorer
+// (Lucchese et al., "QuickScorer: a Fast Algorithm to Rank Documents with Additive Ensembles of Regression Trees").
+//
+// The leaves of every tree are numbered from left to right, the true branch being on the left, and every tree has a
+// bit vector of its leaves that may still be reached. A node whose condition is false removes the leaves of its true
+// branch from the bit vector of its tree, and the leaf reached by the row is then the first leaf left. The conditions
+// are sorted by feature and threshold, so the false ones of a feature are a prefix of its conditions, which are
+// scanned without any data dependent branch besides the end of the prefix.
+//
+// It only supports trees with at most 64 leaves whose nodes all use BRANCH_LEQ or all use BRANCH_LT. A node shared
+// by several parents counts once per parent. The rows with a missing value are left to the usual traversal, which
+// handles the missing value tracks.
+template <typename InputType, typename ThresholdType>
+class TreeEnsembleQuickScorer {
+ public:
+  // Trees shallower than this are traversed quickly enough without bit vectors.
+  static constexpr int64_t kMinTreeDepth = 4;
+  // The conditions of small ensembles are not worth scanning for every row.
+  static constexpr size_t kMinTrees = 16;
+
+  // Builds the layout of the ensemble. Returns false if the ensemble is not supported, or would not be faster to
+  // evaluate with bit vectors.
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>*>& roots, NODE_MODE mode, int64_t max_feature_id) {
+    if (roots.size() < kMinTrees || (mode != NODE_MODE::BRANCH_LEQ && mode != NODE_MODE::BRANCH_LT)) {
+      return false;
+    }
+
+    struct Condition {
+      int64_t feature_id;
+      ThresholdType threshold;
+      uint32_t tree;
+      uint64_t mask;
+    };
+    std::vector<Condition> conditions;
+    leaf_offsets_.assign(1, 0);
+    leaves_.clear();
+    int64_t max_depth = 0;
+
+    for (size_t tree = 0; tree < roots.size(); ++tree) {
+      // Depth first traversal, visiting the true branch first so the leaves are numbered from left to right.
+      struct Visit {
+        const TreeNodeElement<ThresholdType>* node;
+        int64_t depth;
+        size_t condition;  // index of the condition of the parent whose true branch ends at this node, if any
+      };
+      InlinedVector<Visit> stack{{roots[tree], 0, SIZE_MAX}};
+      InlinedVector<size_t> first_leaf;  // first leaf of the true branch of each condition of the tree
+      const size_t tree_first_condition = conditions.size();
+      const size_t tree_first_leaf = leaves_.size();
+      while (!stack.empty()) {
+        const Visit visit = stack.back();
+        stack.pop_back();
+        max_depth = std::max(max_depth, visit.depth);
+
+        // The leaves of the true branch of the parent condition are all numbered once its false branch is reached.
+        if (visit.condition != SIZE_MAX) {
+          const size_t begin = first_leaf[visit.condition - tree_first_condition];
+          const size_t end = leaves_.size() - tree_first_leaf;
+          conditions[visit.condition].mask = ~(LeafRange(end) & ~LeafRange(begin));
+        }
+
+        if (!visit.node->is_not_leaf()) {
+          if (leaves_.size() - tree_first_leaf == 64) {
+            return false;
+          }
+          leaves_.push_back(visit.node);
+        } else {
+          // A tree with at most 64 leaves has at most 63 conditions, which also stops on a cycle.
+          if (visit.node->mode() != mode || visit.node->feature_id < 0 || visit.node->feature_id > max_feature_id ||
+              conditions.size() - tree_first_condition == 63) {
+            return false;
+          }
+          const size_t condition = conditions.size();
+          conditions.push_back({visit.node->feature_id, visit.node->value_or_unique_weight,
+                                static_cast<uint32_t>(tree), 0});
+          first_leaf.push_back(leaves_.size() - tree_first_leaf);
+          // The false branch is visited once all the leaves of the true branch are numbered.
+          stack.push_back({visit.node + 1, visit.depth + 1, condition});
+          stack.push_back({visit.node->truenode_or_weight.ptr, visit.depth + 1, SIZE_MAX});
+        }
+      }
+      leaf_offsets_.push_back(leaves_.size());
+    }
+
+    if (max_depth < kMinTreeDepth) {
+      return false;
+    }
+
+    std::vector<size_t> order(conditions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&conditions](size_t a, size_t b) {
+      return conditions[a].feature_id < conditions[b].feature_id ||
+             (conditions[a].feature_id == conditions[b].feature_id &&
+              conditions[a].threshold < conditions[b].threshold);
+    });
+
+    strict_ = mode == NODE_MODE::BRANCH_LT;
+    feature_offsets_.assign(static_cast<size_t>(max_feature_id) + 2, 0);
+    thresholds_.resize(conditions.size());
+    trees_.resize(conditions.size());
+    masks_.resize(conditions.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      const Condition& condition = conditions[order[i]];
+      thresholds_[i] = condition.threshold;
+      trees_[i] = condition.tree;
+      masks_[i] = condition.mask;
+      ++feature_offsets_[static_cast<size_t>(condition.feature_id) + 1];
+    }
+    std::partial_sum(feature_offsets_.begin(), feature_offsets_.end(), feature_offsets_.begin());
+    return true;
+  }
+
+  size_t NumTrees() const { return leaf_offsets_.size() - 1; }
+
+  // Sets the leaf reached by the row in every tree. bit_vectors is a buffer of NumTrees() elements.
+  // Returns false, without setting the leaves, if the row has a missing value.
+  bool ComputeLeaves(const InputType* x_data, uint64_t* bit_vectors,
+                     const TreeNodeElement<ThresholdType>** leaves) const {
+    const size_t n_features = feature_offsets_.size() - 1;
+    if constexpr (std::is_floating_point_v<InputType>) {
+      for (size_t feature = 0; feature < n_features; ++feature) {
+        if (std::isnan(x_data[feature])) {
+          return false;
+        }
+      }
+    }
+
+    const size_t n_trees = NumTrees();
+    std::fill(bit_vectors, bit_vectors + n_trees, ~uint64_t{0});
+    for (size_t feature = 0; feature < n_features; ++feature) {
+      const InputType val = x_data[feature];
+      size_t i = feature_offsets_[feature];
+      const size_t end = feature_offsets_[feature + 1];
+      if (strict_) {
+        for (; i < end && !(val < thresholds_[i]); ++i) {
+          bit_vectors[trees_[i]] &= masks_[i];
+        }
+      } else {
+        for (; i < end && !(val <= thresholds_[i]); ++i) {
+          bit_vectors[trees_[i]] &= masks_[i];
+        }
+      }
+    }
+
+    for (size_t tree = 0; tree < n_trees; ++tree) {
+      leaves[tree] = leaves_[leaf_offsets_[tree] + FirstLeaf(bit_vectors[tree])];
+    }
+    return true;
+  }
+
+ private:
+  // Bits of the leaves before the given one.
+  static uint64_t LeafRange(size_t end) { return end >= 64 ? ~uint64_t{0} : (uint64_t{1} << end) - 1; }
+
+  static size_t FirstLeaf(uint64_t bit_vector) {
+    // The leaf reached by the row is never removed, so the bit vector is not zero.
+    size_t leaf = 0;
+    while ((bit_vector & 1) == 0) {
+      bit_vector >>= 1;
+      ++leaf;
+    }
+    return leaf;
+  }
+
+  bool strict_ = false;
+  // Conditions sorted by feature and then by threshold. The conditions of a feature start at feature_offsets_[feature].
+  std::vector<size_t> feature_offsets_;
+  std::vector<ThresholdType> thresholds_;
+  std::vector<uint32_t> trees_;
+  std::vector<uint64_t> masks_;
+  // Leaves of every tree from left to right. The leaves of a tree start at leaf_offsets_[tree].
+  std::vector<size_t> leaf_offsets_;
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves_;
+};
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
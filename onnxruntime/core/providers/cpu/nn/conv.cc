@@ -72,16 +72,12 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
-  BufferUniquePtr col_buffer;
+  IAllocatorUniquePtr<void> col_buffer;
 
   // Pointwise convolutions can use the original input tensor in place,
   // otherwise a temporary buffer is required for the im2col transform.
   if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
-    AllocatorPtr alloc;
-    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
-    auto* col_data = alloc->Alloc(sizeof(T) * SafeInt<size_t>(col_buffer_size));
-    col_buffer = BufferUniquePtr(col_data, BufferDeleter(std::move(alloc)));
+    col_buffer = context->GetScratchBuffer(sizeof(T) * SafeInt<size_t>(col_buffer_size));
   }
 
   T* col_buffer_data = static_cast<T*>(col_buffer.get());
@@ -153,6 +149,49 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* /*prepacked_weights*/) {
+  is_packed = false;
+
+  if (input_idx != 1 || winograd_tile_ == MlasConvWinogradNone) {
+    return Status::OK();
+  }
+
+  // Only 3x3 stride 1 convolutions without dilations use the Winograd algorithm.
+  const auto& W_shape = tensor.Shape();
+  if (W_shape.NumDimensions() != 4 || W_shape[2] != 3 || W_shape[3] != 3 || conv_attrs_.group <= 0 ||
+      W_shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+  for (auto stride : conv_attrs_.strides) {
+    if (stride != 1) {
+      return Status::OK();
+    }
+  }
+  for (auto dilation : conv_attrs_.dilations) {
+    if (dilation != 1) {
+      return Status::OK();
+    }
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t input_channels = narrow<size_t>(W_shape[1]);
+  const size_t filter_count = narrow<size_t>(W_shape[0] / conv_attrs_.group);
+
+  const size_t packed_w_size = MlasConvWinogradPackFilterSize(winograd_tile_, group_count, input_channels,
+                                                              filter_count);
+  if (packed_w_size == 0) {
+    return Status::OK();
+  }
+
+  winograd_packed_w_ = IAllocator::MakeUniquePtr<float>(alloc, packed_w_size, true);
+  MlasConvWinogradPackFilter(winograd_tile_, group_count, input_channels, filter_count, tensor.Data<float>(),
+                             winograd_packed_w_.get());
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
@@ -192,9 +231,6 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     return Status::OK();
   }
 
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
-
   auto Xdata = X->DataAsSpan<float>();
   const auto* Bdata = B != nullptr ? B->Data<float>() : nullptr;
   auto Ydata = Y->MutableDataAsSpan<float>();
@@ -231,11 +267,10 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &activation_,
                     &WorkingBufferSize,
                     Beta,
-                    thread_pool);
+                    thread_pool,
+                    winograd_packed_w_ != nullptr ? winograd_tile_ : MlasConvWinogradNone);
 
-    auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
-                                               : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
+    auto working_buffer = context->GetScratchBuffer(sizeof(float) * SafeInt<size_t>(WorkingBufferSize));
 
     MlasConv(&Parameters,
              Xdata.data(),
@@ -243,7 +278,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata.data(),
-             thread_pool);
+             thread_pool,
+             winograd_packed_w_.get());
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -254,7 +290,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     const SafeInt<int64_t> kernel_dim = SafeInt<int64_t>(C) / conv_attrs_.group * kernel_size;
     const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-    auto col_data = IAllocator::MakeUniquePtr<float>(alloc, narrow<size_t>(col_buffer_size));
+    auto col_buffer = context->GetScratchBuffer(sizeof(float) * SafeInt<size_t>(col_buffer_size));
+    float* col_data = static_cast<float*>(col_buffer.get());
     auto w_data = W->DataAsSpan<float>();
     for (int image_id = 0; image_id < N; ++image_id) {
       for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
@@ -268,7 +305,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             dilations.data(),
             pads.data(),
             narrow<int>(kernel_shape.size()),
-            col_data.get());
+            col_data);
 
         math::Gemm<float>(
             CblasNoTrans,
@@ -278,7 +315,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
             narrow<ptrdiff_t>(kernel_dim),
             1,
             &w_data[group_id * W_offset],
-            col_data.get(),
+            col_data,
             Beta,
             &Ydata[group_id * Y_offset],
             thread_pool);
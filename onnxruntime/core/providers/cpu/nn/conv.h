@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,14 +27,30 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+
+    const auto winograd_tile = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasConvWinogradTile, "0");
+    ORT_ENFORCE(winograd_tile == "0" || winograd_tile == "2" || winograd_tile == "4" || winograd_tile == "6",
+                "Invalid value for ", kOrtSessionOptionsMlasConvWinogradTile, ": ", winograd_tile);
+    winograd_tile_ = static_cast<MLAS_CONV_WINOGRAD_TILE>(std::stoi(winograd_tile));
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // The filter transformed once for the Winograd algorithm, which MLAS selects for 3x3 stride 1
+  // convolutions with enough channels when a tile is configured. The filter itself is kept for
+  // the shapes that MLAS runs with the GEMM based algorithms.
+  MLAS_CONV_WINOGRAD_TILE winograd_tile_ = MlasConvWinogradNone;
+  IAllocatorUniquePtr<float> winograd_packed_w_;
 };
 
 }  // namespace onnxruntime
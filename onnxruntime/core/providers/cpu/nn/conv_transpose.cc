@@ -254,6 +254,14 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
   float* Ydata = p.Y->MutableData<float>();
   TensorShape output_shape = p.Y->Shape().Slice(2);
 
+  const bool is_2d = p.X->Shape().NumDimensions() == 4;
+  const int64_t output_channels_per_group = p.num_output_channels / conv_transpose_attrs_.group;
+  // the columns of an output channel, and what accumulating them costs
+  const int64_t col_channel_size = kernel_size * input_image_size;
+  const TensorOpCost col2im_cost{static_cast<double>(col_channel_size * sizeof(float)),
+                                 static_cast<double>(output_size * sizeof(float)),
+                                 static_cast<double>(col_channel_size + output_size)};
+
   for (auto image_id = 0; image_id < p.N; ++image_id) {
     for (int group_id = 0; group_id < conv_transpose_attrs_.group; ++group_id) {
       // Weight term
@@ -270,45 +278,52 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
           col_buffer_data,
           thread_pool);
 
-      if (p.X->Shape().NumDimensions() == 4) {
-        math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            p.num_output_channels / conv_transpose_attrs_.group,
-            p.Y->Shape()[2],
-            p.Y->Shape()[3],
-            p.kernel_shape[0],
-            p.kernel_shape[1],
-            p.dilations[0],
-            p.dilations[1],
-            p.pads[0],
-            p.pads[1],
-            p.pads[2],
-            p.pads[3],
-            p.strides[0],
-            p.strides[1],
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      } else {
-        math::Col2imNd<float, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            output_shape.GetDims().data(),
-            p.input_shape.GetDims().data(),
-            kernel_dim,
-            Y_offset,
-            p.kernel_shape.data(),
-            p.strides.data(),
-            p.dilations.data(),
-            p.pads.data(),
-            static_cast<int>(p.kernel_shape.size()),
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      }
-    }
-
-    if (p.B != nullptr) {
-      auto Ymatrix = EigenMatrixMap<float>(Ydata, onnxruntime::narrow<size_t>(output_size), onnxruntime::narrow<size_t>(p.num_output_channels));
-      auto Bvec = ConstEigenVectorMap<float>(p.B->Data<float>(), onnxruntime::narrow<size_t>(p.num_output_channels));
-      Ymatrix.rowwise() += Bvec.transpose();
+      // The output channels don't overlap in col2im, so they are accumulated in parallel, with their bias.
+      float* Ygroup = Ydata + group_id * Y_offset;
+      const float* Bgroup = p.B != nullptr ? p.B->Data<float>() + group_id * output_channels_per_group : nullptr;
+      concurrency::ThreadPool::TryParallelFor(
+          thread_pool, onnxruntime::narrow<ptrdiff_t>(output_channels_per_group), col2im_cost,
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            if (is_2d) {
+              math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
+                  col_buffer_data + first * col_channel_size,
+                  last - first,
+                  p.Y->Shape()[2],
+                  p.Y->Shape()[3],
+                  p.kernel_shape[0],
+                  p.kernel_shape[1],
+                  p.dilations[0],
+                  p.dilations[1],
+                  p.pads[0],
+                  p.pads[1],
+                  p.pads[2],
+                  p.pads[3],
+                  p.strides[0],
+                  p.strides[1],
+                  Ygroup + first * output_size,
+                  &CPUMathUtil::Instance());
+            } else {
+              math::Col2imNd<float, CPUMathUtil, StorageOrder::NCHW>(
+                  col_buffer_data + first * col_channel_size,
+                  output_shape.GetDims().data(),
+                  p.input_shape.GetDims().data(),
+                  (last - first) * kernel_size,
+                  (last - first) * output_size,
+                  p.kernel_shape.data(),
+                  p.strides.data(),
+                  p.dilations.data(),
+                  p.pads.data(),
+                  static_cast<int>(p.kernel_shape.size()),
+                  Ygroup + first * output_size,
+                  &CPUMathUtil::Instance());
+            }
+            if (Bgroup != nullptr) {
+              for (ptrdiff_t c = first; c < last; ++c) {
+                EigenVectorArrayMap<float>(Ygroup + c * output_size, onnxruntime::narrow<size_t>(output_size)) +=
+                    Bgroup[c];
+              }
+            }
+          });
     }
 
     Xdata += X_offset * conv_transpose_attrs_.group;
@@ -6,8 +6,8 @@
 #include "core/common/narrow.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/random_generator.h"
-#include <chrono>
-#include <random>
+#include <optional>
+#include "core/providers/cpu/generator/philox.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -18,14 +18,14 @@ class Dropout final : public OpKernel {
   Dropout(const OpKernelInfo& info) : OpKernel{info} {
     int64_t seed = 0;
     if (info.GetAttr<int64_t>("seed", &seed).IsOK()) {
-      generator_ = std::make_unique<RandomGenerator>(seed);
+      generator_.emplace(static_cast<uint64_t>(seed));
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  mutable std::unique_ptr<RandomGenerator> generator_;
+  mutable std::optional<PhiloxGenerator> generator_;
 };
 
 namespace {
@@ -84,12 +84,14 @@ Status Dropout<T1, T2>::Compute(OpKernelContext* context) const {
 
     // generate mask
     {
-      RandomGenerator& generator = generator_ != nullptr ? *generator_.get() : RandomGenerator::Default();
-      std::default_random_engine rng(gsl::narrow_cast<std::default_random_engine::result_type>(generator.NextSeed()));
-      std::uniform_real_distribution<float> dist{0.0f, 1.0f};
-      mask_arr = Eigen::ArrayX<bool>::NullaryExpr(
-          mask_arr.size(),
-          [ratio_value, &dist, &rng]() { return dist(rng) >= ratio_value; });
+      PhiloxGenerator& generator = generator_.has_value() ? *generator_ : PhiloxGenerator::Default();
+      philox::Fill<bool, philox::kWordsPerBlock>(
+          generator.NextPhiloxSeeds(1), mask_span, context->GetOperatorThreadPool(),
+          [ratio_value](const philox::Block& block, bool* values) {
+            for (size_t i = 0; i < philox::kWordsPerBlock; ++i) {
+              values[i] = philox::ToUniformFloat(block[i]) >= ratio_value;
+            }
+          });
     }
 
     Y_arr = mask_arr.cast<T1>() * X_arr / (1.0f - ratio_value);
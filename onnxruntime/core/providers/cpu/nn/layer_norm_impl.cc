@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -18,6 +19,44 @@ LayerNormImpl::LayerNormImpl(const OpKernelInfo& op_kernel_info, bool simplified
 }
 
 namespace {
+template <typename T>
+void ComputeJob(const T* p_input, const T* scale_data, const T* bias_data, T* p_output, int64_t norm_size,
+                float epsilon, bool simplified, T& mean, T& inv_std_dev) {
+  T mean_square = 0;
+  mean = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / norm_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    if (simplified) {
+      p_output[h] = p_input[h] / mean_square * scale_data[h];
+    } else if (nullptr == bias_data) {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+    } else {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+    }
+  }
+
+  inv_std_dev = 1 / mean_square;
+}
+
+// fp32 rows are normalized by MLAS in a single read of the input followed by a vectorized scaling pass.
+void ComputeJob(const float* p_input, const float* scale_data, const float* bias_data, float* p_output,
+                int64_t norm_size, float epsilon, bool simplified, float& mean, float& inv_std_dev) {
+  MlasLayerNormalization(p_input, nullptr, nullptr, scale_data, bias_data, p_output, nullptr,
+                         onnxruntime::narrow<size_t>(norm_size), epsilon, simplified, &mean, &inv_std_dev);
+}
+
 template <typename T, typename U>
 Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, bool simplified) {
   // Inputs
@@ -80,38 +119,18 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
         const T* p_input = X_data + task_idx * norm_size;
         T* p_output = Y_data + task_idx * norm_size;
 
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
-          } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-          }
-        }
+        T mean_value;
+        T inv_std_dev_value;
+        ComputeJob(p_input, scale_data, bias_data, p_output, norm_size, epsilon, simplified, mean_value,
+                   inv_std_dev_value);
 
         if (mean_data != nullptr) {
           // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-          mean_data[task_idx] = gsl::narrow_cast<U>(mean);
+          mean_data[task_idx] = gsl::narrow_cast<U>(mean_value);
         }
 
         if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(inv_std_dev_value);
         }
       },
       0);
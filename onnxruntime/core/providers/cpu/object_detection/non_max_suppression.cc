@@ -13,10 +13,13 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
+#include <algorithm>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +121,96 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+  inline bool operator<(const BoxInfoPtr& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+// The corners and the areas of boxes, in one array per coordinate so that a box is compared with many boxes at once.
+struct BoxCorners {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Resize(size_t size) {
+    x_min.resize(size);
+    y_min.resize(size);
+    x_max.resize(size);
+    y_max.resize(size);
+    area.resize(size);
+  }
+
+  // The corners as SuppressByIOU computes them.
+  void Set(size_t i, const float* box, int64_t center_point_box) {
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min[i], x_max[i]);
+      MaxMin(box[0], box[2], y_min[i], y_max[i]);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min[i] = box[0] - width_half;
+      x_max[i] = box[0] + width_half;
+      y_min[i] = box[1] - height_half;
+      y_max[i] = box[1] + height_half;
+    }
+    area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+  }
+
+  void Append(const BoxCorners& boxes, size_t i) {
+    x_min.push_back(boxes.x_min[i]);
+    y_min.push_back(boxes.y_min[i]);
+    x_max.push_back(boxes.x_max[i]);
+    y_max.push_back(boxes.y_max[i]);
+    area.push_back(boxes.area[i]);
+  }
+};
+
+// Whether the IoU of box i of boxes with one of the selected boxes exceeds the threshold. The selected boxes are
+// compared in blocks without branches, so that the comparisons are vectorized.
+bool SuppressBySelectedBoxes(const BoxCorners& boxes, size_t i, const BoxCorners& selected, float iou_threshold) {
+  const float area = boxes.area[i];
+  if (area <= .0f) {
+    return false;
+  }
+
+  const float x_min = boxes.x_min[i];
+  const float y_min = boxes.y_min[i];
+  const float x_max = boxes.x_max[i];
+  const float y_max = boxes.y_max[i];
+  const size_t count = selected.area.size();
+  constexpr size_t kBlockSize = 16;
+  for (size_t start = 0; start < count; start += kBlockSize) {
+    const size_t end = std::min(count, start + kBlockSize);
+    int suppressed = 0;
+    for (size_t j = start; j < end; ++j) {
+      const float width = std::min(x_max, selected.x_max[j]) - std::max(x_min, selected.x_min[j]);
+      const float height = std::min(y_max, selected.y_max[j]) - std::max(y_min, selected.y_min[j]);
+      const float intersection_area = width * height;
+      const float union_area = area + selected.area[j] - intersection_area;
+      suppressed |= (width > .0f) & (height > .0f) & (intersection_area > .0f) & (selected.area[j] > .0f) &
+                    (union_area > .0f) & (intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -135,75 +228,84 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
+  // The corners of the boxes are shared by all the classes of their batch.
+  const size_t total_boxes = narrow<size_t>(pc.num_batches_ * pc.num_boxes_);
+  BoxCorners corners;
+  corners.Resize(total_boxes);
+  for (size_t i = 0; i < total_boxes; ++i) {
+    corners.Set(i, boxes_data + 4 * i, center_point_box);
+  }
+
+  // Each class of each batch is suppressed independently, and their selections are concatenated in order.
+  const std::ptrdiff_t num_tasks = narrow<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<SelectedIndex>> selected_indices_per_task(narrow<size_t>(num_tasks));
+  const size_t max_selected = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_);
+  const TensorOpCost cost{static_cast<double>(pc.num_boxes_ * sizeof(float)), 0.0,
+                          static_cast<double>(pc.num_boxes_) * 16.0};
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), num_tasks, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<BoxInfoPtr> candidate_boxes;
+        BoxCorners selected_boxes;
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t batch_index = task / pc.num_classes_;
+          const int64_t class_index = task % pc.num_classes_;
+          const size_t batch_box_offset = narrow<size_t>(batch_index * pc.num_boxes_);
+          std::vector<SelectedIndex>& selected_indices = selected_indices_per_task[narrow<size_t>(task)];
+
+          // Filter by score_threshold_
+          candidate_boxes.clear();
+          candidate_boxes.reserve(pc.num_boxes_);
+          const auto* class_scores = scores_data + task * pc.num_boxes_;
+          if (pc.score_threshold_ != nullptr) {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              if (*class_scores > score_threshold) {
+                candidate_boxes.emplace_back(*class_scores, box_index);
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              candidate_boxes.emplace_back(*class_scores, box_index);
+            }
           }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+          if (candidate_boxes.empty()) {
+            continue;
           }
+          std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(),
+                                                                                std::move(candidate_boxes));
+
+          selected_boxes.Resize(0);
+          // Get the next box with top score, filter by iou_threshold
+          while (!sorted_boxes.empty() && selected_boxes.area.size() < max_selected) {
+            const BoxInfoPtr& next_top_score = sorted_boxes.top();
+            const size_t box = batch_box_offset + narrow<size_t>(next_top_score.index_);
+
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+            // threshold
+            if (!SuppressBySelectedBoxes(corners, box, selected_boxes, iou_threshold)) {
+              selected_boxes.Append(corners, box);
+              selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+            }
+            sorted_boxes.pop();
+          }  // while
         }
+      });
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
-        }
-        sorted_boxes.pop();
-      }  // while
-    }  // for class_index
-  }  // for batch_index
+  size_t num_selected = 0;
+  for (const auto& selected_indices : selected_indices_per_task) {
+    num_selected += selected_indices.size();
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (const auto& selected_indices : selected_indices_per_task) {
+    output_data = std::copy(selected_indices.begin(), selected_indices.end(), output_data);
+  }
 
   return Status::OK();
 }
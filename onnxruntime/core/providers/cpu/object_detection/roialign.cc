@@ -163,97 +163,88 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
   int64_t pooled_height = output_shape[2];
   int64_t pooled_width = output_shape[3];
 
+  // The work is split in (roi, channel) pairs so that a few large rois still keep all the threads busy. A thread
+  // computes the sampling table of a roi once for the channels of that roi it is given.
   // 100 is a random chosed value, need be tuned
-  double cost = static_cast<double>(channels * pooled_width * pooled_height * 100);
-
-  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois), cost, [&](ptrdiff_t n, ptrdiff_t end) {
-    for (; n != end; ++n) {
-      int64_t index_n = n * channels * pooled_width * pooled_height;
-
-      const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
-      const auto roi_batch_ind = batch_indices_ptr[n];
-
-      // Do not using rounding; this implementation detail is critical
-      T offset = half_pixel ? (T)0.5 : (T)0.0;
-      T roi_start_w = offset_bottom_rois[0] * spatial_scale - offset;
-      T roi_start_h = offset_bottom_rois[1] * spatial_scale - offset;
-      T roi_end_w = offset_bottom_rois[2] * spatial_scale - offset;
-      T roi_end_h = offset_bottom_rois[3] * spatial_scale - offset;
-
-      T roi_width = roi_end_w - roi_start_w;
-      T roi_height = roi_end_h - roi_start_h;
-      if (!half_pixel) {
-        // Force malformed ROIs to be 1x1
-        roi_width = std::max(roi_width, (T)1.);
-        roi_height = std::max(roi_height, (T)1.);
+  double cost = static_cast<double>(pooled_width * pooled_height * 100);
+
+  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois * channels), cost, [&](ptrdiff_t first, ptrdiff_t end) {
+    std::vector<PreCalc<T>> pre_calc;
+    int64_t count = 1;
+    int64_t samples_per_bin = 0;
+    int64_t n = -1;
+
+    for (ptrdiff_t unit = first; unit != end; ++unit) {
+      const int64_t c = unit % channels;
+      if (n != unit / channels) {
+        n = unit / channels;
+        const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
+
+        // Do not using rounding; this implementation detail is critical
+        T offset = half_pixel ? (T)0.5 : (T)0.0;
+        T roi_start_w = offset_bottom_rois[0] * spatial_scale - offset;
+        T roi_start_h = offset_bottom_rois[1] * spatial_scale - offset;
+        T roi_end_w = offset_bottom_rois[2] * spatial_scale - offset;
+        T roi_end_h = offset_bottom_rois[3] * spatial_scale - offset;
+
+        T roi_width = roi_end_w - roi_start_w;
+        T roi_height = roi_end_h - roi_start_h;
+        if (!half_pixel) {
+          // Force malformed ROIs to be 1x1
+          roi_width = std::max(roi_width, (T)1.);
+          roi_height = std::max(roi_height, (T)1.);
+        }
+
+        T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+        T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+        // We use roi_bin_grid to sample the grid and mimic integral
+        int64_t roi_bin_grid_h =  // e.g., = 2
+            (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_height / pooled_height));
+        int64_t roi_bin_grid_w =
+            (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
+
+        // We do average (integral) pooling inside a bin
+        count = std::max(roi_bin_grid_h * roi_bin_grid_w, static_cast<int64_t>(1));  // e.g. = 4
+        samples_per_bin = roi_bin_grid_h * roi_bin_grid_w;
+
+        // we want to precalculate indices and weights shared by all channels,
+        // this is the key point of optimization
+        pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
+        PreCalcForBilinearInterpolate(height, width, pooled_height, pooled_width, roi_bin_grid_h, roi_bin_grid_w,
+                                      roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
+                                      roi_bin_grid_w, pre_calc);
       }
 
-      T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
-      T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
-
-      // We use roi_bin_grid to sample the grid and mimic integral
-      int64_t roi_bin_grid_h = (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
-      int64_t roi_bin_grid_w =
-          (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
-
-      // We do average (integral) pooling inside a bin
-      const int64_t count = std::max(roi_bin_grid_h * roi_bin_grid_w, static_cast<int64_t>(1));  // e.g. = 4
-
-      // we want to precalculate indices and weights shared by all channels,
-      // this is the key point of optimization
-      std::vector<PreCalc<T>> pre_calc(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
-      PreCalcForBilinearInterpolate(height, width, pooled_height, pooled_width, roi_bin_grid_h, roi_bin_grid_w,
-                                    roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
-                                    roi_bin_grid_w, pre_calc);
-
-      for (int64_t c = 0; c < channels; c++) {
-        int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-        const T* offset_bottom_data =
-            bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-        int64_t pre_calc_index = 0;
-
-        for (int64_t ph = 0; ph < pooled_height; ph++) {
-          for (int64_t pw = 0; pw < pooled_width; pw++) {
-            int64_t index = index_n_c + ph * pooled_width + pw;
-
-            T output_val = 0.;
-            if (mode == RoiAlignMode::avg) {  // avg pooling
-              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                  const auto& pc = pre_calc[onnxruntime::narrow<size_t>(pre_calc_index)];
-                  output_val += pc.w1 * offset_bottom_data[pc.pos1] + pc.w2 * offset_bottom_data[pc.pos2] +
-                                pc.w3 * offset_bottom_data[pc.pos3] + pc.w4 * offset_bottom_data[pc.pos4];
-
-                  pre_calc_index += 1;
-                }
-              }
-              output_val /= count;
-            } else {  // max pooling
-              bool max_flag = false;
-              for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
-                for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                  const auto& pc = pre_calc[onnxruntime::narrow<size_t>(pre_calc_index)];
-                  T val = std::max(
-                      std::max(std::max(pc.w1 * offset_bottom_data[pc.pos1], pc.w2 * offset_bottom_data[pc.pos2]),
-                               pc.w3 * offset_bottom_data[pc.pos3]),
-                      pc.w4 * offset_bottom_data[pc.pos4]);
-                  if (!max_flag) {
-                    output_val = val;
-                    max_flag = true;
-                  } else {
-                    output_val = std::max(output_val, val);
-                  }
-
-                  pre_calc_index += 1;
-                }
-              }
-            }
-
-            top_data[index] = output_val;
-          }  // for pw
-        }  // for ph
-      }  // for c
-    }  // for n
+      const T* offset_bottom_data =
+          bottom_data + static_cast<int64_t>((batch_indices_ptr[n] * channels + c) * height * width);
+      T* offset_top_data = top_data + (n * channels + c) * pooled_width * pooled_height;
+      const PreCalc<T>* pc = pre_calc.data();
+      const int64_t num_bins = pooled_height * pooled_width;
+
+      if (mode == RoiAlignMode::avg) {  // avg pooling
+        for (int64_t bin = 0; bin < num_bins; bin++) {
+          T output_val = 0.;
+          for (int64_t i = 0; i < samples_per_bin; i++, pc++) {
+            output_val += pc->w1 * offset_bottom_data[pc->pos1] + pc->w2 * offset_bottom_data[pc->pos2] +
+                          pc->w3 * offset_bottom_data[pc->pos3] + pc->w4 * offset_bottom_data[pc->pos4];
+          }
+          offset_top_data[bin] = output_val / count;
+        }
+      } else {  // max pooling
+        for (int64_t bin = 0; bin < num_bins; bin++) {
+          T output_val = 0.;
+          for (int64_t i = 0; i < samples_per_bin; i++, pc++) {
+            T val = std::max(
+                std::max(std::max(pc->w1 * offset_bottom_data[pc->pos1], pc->w2 * offset_bottom_data[pc->pos2]),
+                         pc->w3 * offset_bottom_data[pc->pos3]),
+                pc->w4 * offset_bottom_data[pc->pos4]);
+            output_val = i == 0 ? val : std::max(output_val, val);
+          }
+          offset_top_data[bin] = output_val;
+        }
+      }
+    }
   });
 }
 }  // namespace
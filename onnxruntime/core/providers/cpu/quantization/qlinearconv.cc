@@ -10,6 +10,7 @@
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -20,6 +21,11 @@ class QLinearConv : public OpKernel {
  public:
   explicit QLinearConv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     channels_last_ = (info.GetAttrOrDefault<int64_t>("channels_last", static_cast<int64_t>(0)) != 0);
+
+    const auto direct_conv = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasQLinearConvDirect, "0");
+    ORT_ENFORCE(direct_conv == "0" || direct_conv == "1",
+                "Invalid value for ", kOrtSessionOptionsMlasQLinearConvDirect, ": ", direct_conv);
+    use_direct_conv_ = (direct_conv == "1");
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -273,6 +279,14 @@ class QLinearConv : public OpKernel {
     return false;
   }
 
+  // Determine if the MlasConvDirectQuant path can be used for a filter of the
+  // given shape. The kernel reads the HWIO reordered filter, so the filter is
+  // not packed for QGEMM when this returns true.
+  bool IsDirectConvCandidate(gsl::span<const int64_t> W_dims) const {
+    return use_direct_conv_ && conv_attrs_.group == 1 && W_dims.size() == 4 &&
+           W_dims[2] == W_dims[3] && (W_dims[2] == 3 || W_dims[2] == 5);
+  }
+
   // Reorder filter storage format from MCK1..Kn to K1...KnCM
   static void ReorderFilter(const uint8_t* input,
                             uint8_t* output,
@@ -299,6 +313,7 @@ class QLinearConv : public OpKernel {
   bool is_symmetric_conv_{false};
   bool is_symmetric_gemm_{false};
   bool channels_last_{false};
+  bool use_direct_conv_{false};
   std::vector<int32_t> column_sums_;
 };
 
@@ -414,8 +429,9 @@ Status QLinearConv<ActType>::PrePack(const Tensor& tensor, int input_idx, Alloca
     return Status::OK();
   }
 
-  // Don't pack the filter buffer if the MlasConvDepthwise path is used.
-  if (group_input_channels != 1 || group_output_channels != 1) {
+  // Don't pack the filter buffer if the MlasConvDepthwise or MlasConvDirectQuant
+  // path is used.
+  if ((group_input_channels != 1 || group_output_channels != 1) && !IsDirectConvCandidate(shape)) {
     packed_W_size_ = MlasGemmPackBSize(group_output_channels,
                                        kernel_dim,
                                        std::is_same<ActType, int8_t>::value,
@@ -611,6 +627,11 @@ Status QLinearConv<ActType>::Compute(OpKernelContext* context) const {
     group_count = 1;
   }
 
+  // Test for the direct convolution path, which reads the input in place and
+  // the filter in HWIO order.
+  const bool use_direct_conv = !is_symmetric_conv_ && !is_depthwise_conv && reordered_W != nullptr &&
+                               IsDirectConvCandidate(W_shape.GetDims());
+
   const int64_t X_offset = C * input_image_size;
   const int64_t Y_offset = M * output_image_size;
   const int64_t kernel_dim = group_input_channels * kernel_size;
@@ -650,7 +671,7 @@ Status QLinearConv<ActType>::Compute(OpKernelContext* context) const {
   bool use_indirection_buffer = false;
   if (is_depthwise_conv) {
     use_indirection_buffer = true;
-  } else if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+  } else if (!use_direct_conv && (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding())) {
     if (is_symmetric_conv_) {
       use_indirection_buffer = true;
     } else {
@@ -702,6 +723,8 @@ Status QLinearConv<ActType>::Compute(OpKernelContext* context) const {
     }
   } else if (is_depthwise_conv) {
     compute_stride = MlasConvDepthwiseGetKernelOutputCnt();
+  } else if (use_direct_conv) {
+    compute_stride = MlasConvDirectQuantGetKernelOutputCnt();
   } else {
     if (is_symmetric_gemm_) {
       compute_stride = MlasSymmQgemmGetKernelOutputCnt();
@@ -878,6 +901,28 @@ Status QLinearConv<ActType>::Compute(OpKernelContext* context) const {
             static_cast<size_t>(M),
             static_cast<size_t>(output_count),
             static_cast<size_t>(kernel_size));
+      } else if (use_direct_conv) {
+        MLAS_CONV_DIRECT_QUANT_PARAMS direct_params = {};
+        direct_params.Input = input_data;
+        direct_params.InputZeroPoint = X_zero_point_value;
+        direct_params.InputIsSigned = std::is_signed<ActType>::value;
+        direct_params.Filter = reordered_W;
+        direct_params.FilterZeroPoint = is_W_signed ? static_cast<int8_t>(W_zero_point_value) : W_zero_point_value;
+        direct_params.FilterIsSigned = is_W_signed;
+        direct_params.Output = worker_gemm_output;
+        direct_params.InputChannels = static_cast<size_t>(C);
+        direct_params.OutputChannels = static_cast<size_t>(M);
+        for (size_t i = 0; i < 2; i++) {
+          direct_params.InputShape[i] = static_cast<size_t>(input_shape[i]);
+          direct_params.KernelShape[i] = static_cast<size_t>(kernel_shape[i]);
+          direct_params.DilationShape[i] = static_cast<size_t>(dilations[i]);
+          direct_params.Padding[i] = static_cast<size_t>(pads[i]);
+          direct_params.StrideShape[i] = static_cast<size_t>(strides[i]);
+          direct_params.OutputShape[i] = static_cast<size_t>(output_shape[i]);
+        }
+        direct_params.OutputStart = static_cast<size_t>(output_start);
+        direct_params.OutputCount = static_cast<size_t>(output_count);
+        MlasConvDirectQuant(direct_params);
       } else {
         for (int64_t group_id = 0; group_id < group_count; ++group_id) {
           // Prepare the im2col transformation or use the input buffer directly for
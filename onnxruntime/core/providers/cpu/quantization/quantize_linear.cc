@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include <core/common/safeint.h>
 #include "core/framework/element_type_lists.h"
 #include "core/framework/float8.h"
@@ -9,6 +11,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/qmath.h"
 
 namespace onnxruntime {
@@ -265,6 +268,27 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 template <typename T, typename OutT, bool is_4bit>
 struct DequantizeLinearApply;
 
+/**
+ * @brief Runs fn(row, begin, end) on the segments [begin, end) of the M x K rows of N elements of the flattened
+ *        tensor, split between the threads of the pool. fn dequantizes the elements of one row with the same
+ *        scale (per-axis) or scale row (blocked), so its loop is vectorized.
+ */
+template <typename T, typename OutT, typename Fn>
+void ParDequantizeRows(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N, const Fn& fn) {
+  const std::ptrdiff_t total_size = static_cast<std::ptrdiff_t>(M * K * N);
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, total_size,
+      TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(OutT)), 2.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t i = static_cast<size_t>(first); i < static_cast<size_t>(last);) {
+          const size_t row = i / N;
+          const size_t end = std::min(static_cast<size_t>(last), (row + 1) * N);
+          fn(row, i - row * N, end - row * N);
+          i = end;
+        }
+      });
+}
+
 // The dimensions before quantize axis and after quantize axis can be flattened.
 // After flattening, the tensor can be represented by a rank-3 tensor.
 // If the quantization happens on the first or last axis, the flattened tensor is
@@ -275,6 +299,7 @@ struct DequantizeLinearApply<T, OutT, false> {
   /**
    * @brief Calculate per-tensor/layer or per-axis quantization of DequantizeLinear on the
    *        flattened tensors.
+   * @param[in]    thread_pool            thread pool the rows are split between
    * @param[in]    M                      size of dimensions before the quantize axis
    * @param[in]    K                      dimension on the quantize axis
    * @param[in]    N                      size of dimensions after the quantize axis
@@ -284,22 +309,23 @@ struct DequantizeLinearApply<T, OutT, false> {
    * @param[out]   output                 same shape as input
    * @param[in]    zero_point             same shape as scale
    */
-  void op(size_t M, size_t K, size_t N, const T* input,
+  void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N, const T* input,
           const OutT* scale, OutT* output, const T* zero_point) {
-    for (size_t m = 0; m < M; m++) {
-      for (size_t k = 0; k < K; k++) {
-        auto zp = zero_point ? static_cast<int32_t>(zero_point[k]) : 0;
-        auto sc = static_cast<float>(scale[k]);
-        for (size_t n = 0; n < N; n++) {
-          *output++ = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(*input++) - zp) * sc);
-        }
+    ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {
+      const size_t k = row % K;
+      const auto zp = zero_point ? static_cast<int32_t>(zero_point[k]) : 0;
+      const auto sc = static_cast<float>(scale[k]);
+      const T* row_input = input + row * N;
+      OutT* row_output = output + row * N;
+      for (size_t n = begin; n < end; n++) {
+        row_output[n] = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(row_input[n]) - zp) * sc);
       }
-    }
+    });
   }
 
   /**
    * @brief Calculate blocked quantization of DequantizeLinear on the flattened tensors.
-   *        TODO(fajin): add mlas kernel to utilize multithreading, refer MlasDequantizeBlockwise.
+   * @param[in]    thread_pool            thread pool the rows are split between
    * @param[in]    M                      size of dimensions before the quantize axis
    * @param[in]    K                      dimension of the quantize axis
    * @param[in]    N                      size of dimensions after the quantize axis
@@ -310,150 +336,94 @@ struct DequantizeLinearApply<T, OutT, false> {
    * @param[out]   output                 same shape as input
    * @param[in]    zero_point             same shape as scale
    */
-  void op(size_t M, size_t K, size_t N, size_t quant_block_size,
+  void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N, size_t quant_block_size,
           const T* input, const OutT* scale, OutT* output, const T* zero_point) {
-    if (zero_point) {
-      for (size_t m = 0; m < M; m++) {
-        for (size_t bd = 0; bd < K; bd += quant_block_size) {
-          for (size_t qb = 0, qb_end = std::min(quant_block_size, K - bd); qb < qb_end; ++qb) {
-            // within the quantize block, the zero point and scale are the same.
-            for (size_t bs = 0; bs < N; bs++) {
-              auto zp = static_cast<int32_t>(zero_point[bs]);
-              auto sc = static_cast<float>(scale[bs]);
-              *output++ = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(*input++) - zp) * sc);
-            }
-          }
-
-          // move to the next quantize block
-          zero_point += N;
-          scale += N;
+    const size_t quant_block_count = (K + quant_block_size - 1) / quant_block_size;
+    ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {
+      // within the quantize block, the zero point and scale are the same.
+      const size_t param_offset = ((row / K) * quant_block_count + (row % K) / quant_block_size) * N;
+      const OutT* row_scale = scale + param_offset;
+      const T* row_input = input + row * N;
+      OutT* row_output = output + row * N;
+      if (zero_point) {
+        const T* row_zero_point = zero_point + param_offset;
+        for (size_t n = begin; n < end; n++) {
+          const auto zp = static_cast<int32_t>(row_zero_point[n]);
+          row_output[n] = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(row_input[n]) - zp) *
+                                            static_cast<float>(row_scale[n]));
         }
-      }
-    } else {
-      for (size_t m = 0; m < M; m++) {
-        for (size_t bd = 0; bd < K; bd += quant_block_size) {
-          for (size_t qb = 0, qb_end = std::min(quant_block_size, K - bd); qb < qb_end; ++qb) {
-            // within the quantize block, the zero point and scale are the same.
-            for (size_t bs = 0; bs < N; bs++) {
-              auto sc = static_cast<float>(scale[bs]);
-              *output++ = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(*input++)) * sc);
-            }
-          }
-
-          // move to the next quantize block
-          scale += N;
+      } else {
+        for (size_t n = begin; n < end; n++) {
+          row_output[n] = static_cast<OutT>(static_cast<float>(static_cast<int32_t>(row_input[n])) *
+                                            static_cast<float>(row_scale[n]));
         }
       }
-    }
+    });
   }
 };
 
 template <typename T, typename OutT>
 struct DequantizeLinearApply<T, OutT, true> {
   // per-tensor/layer or per-axis quantization
-  void op(size_t M, size_t K, size_t N,
+  void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N,
           const T* input, const OutT* scale, OutT* output, const T* zero_point) {
-    size_t input_index = 0;
-
-    for (size_t m = 0; m < M; m++) {
-      for (size_t bd = 0; bd < K; bd++) {
-        size_t bd_i = bd >> 1;  /*bd / 2*/
-        size_t bd_j = bd & 0x1; /*bd % 2*/
-        auto zp = zero_point ? static_cast<int32_t>(zero_point[bd_i].GetElem(bd_j)) : 0;
-        auto sc = static_cast<float>(scale[bd]);
-
-        for (size_t bs = 0; bs < N; bs++) {
-          size_t input_i = input_index >> 1;
-          size_t input_j = input_index & 0x1;
-          int32_t val = static_cast<int32_t>(input[input_i].GetElem(input_j));
-          *output++ = static_cast<OutT>(static_cast<float>(val - zp) * sc);
-          input_index += 1;
-        }
+    ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {
+      const size_t k = row % K;
+      const auto zp = zero_point ? static_cast<int32_t>(zero_point[k >> 1].GetElem(k & 0x1)) : 0;
+      const auto sc = static_cast<float>(scale[k]);
+      for (size_t input_index = row * N + begin, input_end = row * N + end; input_index < input_end; ++input_index) {
+        int32_t val = static_cast<int32_t>(input[input_index >> 1].GetElem(input_index & 0x1));
+        output[input_index] = static_cast<OutT>(static_cast<float>(val - zp) * sc);
       }
-    }
-
-    assert(input_index == M * K * N);
+    });
   }
 
   // Blocked quantization
-  // TODO(fajin) : add mlas kernel to utilize multithreading, refer MlasDequantizeBlockwise.
-  void op(size_t M, size_t K, size_t N, size_t quant_block_size,
+  void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N, size_t quant_block_size,
           const T* input, const OutT* scale, OutT* output, const T* zero_point) {
-    size_t input_index = 0;
-
-    if (zero_point) {
-      size_t zp_index = 0;
-
-      for (size_t n = 0; n < M; n++) {
-        for (size_t bd = 0; bd < K; bd += quant_block_size) {
-          for (size_t qb = 0, qb_end = std::min(quant_block_size, K - bd); qb < qb_end; ++qb) {
-            auto q_zp_index = zp_index;
-            for (size_t bs = 0; bs < N; ++bs, ++input_index, ++q_zp_index) {
-              auto zp = static_cast<int32_t>(zero_point[q_zp_index >> 1].GetElem(q_zp_index & 0x1));
-              auto sc = static_cast<float>(scale[bs]);
-
-              int32_t val = static_cast<int32_t>(input[input_index >> 1].GetElem(input_index & 0x1));
-              *output++ = static_cast<OutT>(static_cast<float>(val - zp) * sc);
-            }
-          }
-
-          scale += N;
-          zp_index += N;
-        }
+    const size_t quant_block_count = (K + quant_block_size - 1) / quant_block_size;
+    ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {
+      // the zero points are packed like the input, and indexed like the scales
+      const size_t param_offset = ((row / K) * quant_block_count + (row % K) / quant_block_size) * N;
+      const OutT* row_scale = scale + param_offset;
+      for (size_t n = begin; n < end; ++n) {
+        const size_t input_index = row * N + n;
+        const size_t zp_index = param_offset + n;
+        const auto zp = zero_point ? static_cast<int32_t>(zero_point[zp_index >> 1].GetElem(zp_index & 0x1)) : 0;
+        int32_t val = static_cast<int32_t>(input[input_index >> 1].GetElem(input_index & 0x1));
+        output[input_index] = static_cast<OutT>(static_cast<float>(val - zp) * static_cast<float>(row_scale[n]));
       }
-    } else {
-      for (size_t n = 0; n < M; n++) {
-        for (size_t bd = 0; bd < K; bd += quant_block_size) {
-          for (size_t qb = 0, qb_end = std::min(quant_block_size, K - bd); qb < qb_end; ++qb) {
-            for (size_t bs = 0; bs < N; ++bs, ++input_index) {
-              auto sc = static_cast<float>(scale[bs]);
-
-              int32_t val = static_cast<int32_t>(input[input_index >> 1].GetElem(input_index & 0x1));
-              *output++ = static_cast<OutT>(static_cast<float>(val) * sc);
-            }
-          }
-
-          scale += N;
-        }
-      }
-    }
-
-    assert(input_index == M * K * N);
+    });
   }
 };
 
 #if !defined(DISABLE_FLOAT8_TYPES)
 
-#define DEQUANTIZE_LINEAR_APPLY_FLOAT8(T)                                                       \
-  template <typename OutT>                                                                      \
-  struct DequantizeLinearApply<T, OutT, false> {                                                \
-    /* Per-tensor/layer or per-axis quantization */                                             \
-    void op(size_t M, size_t K, size_t N,                                                       \
-            const T* input, const OutT* scale, OutT* output, const T*) {                        \
-      for (size_t m = 0; m < M; m++) {                                                          \
-        for (size_t bd = 0; bd < K; bd++) {                                                     \
-          auto sc = scale[bd];                                                                  \
-          for (size_t bs = 0; bs < N; bs++, input++) {                                          \
-            *output++ = static_cast<OutT>(input->ToFloat() * sc);                               \
-          }                                                                                     \
-        }                                                                                       \
-      }                                                                                         \
-    }                                                                                           \
-    /* Blocked quantization */                                                                  \
-    void op(size_t M, size_t K, size_t N, size_t quant_block_size,                              \
-            const T* input, const OutT* scale, OutT* output, const T*) {                        \
-      for (size_t m = 0; m < M; m++) {                                                          \
-        for (size_t bd = 0; bd < K; bd += quant_block_size) {                                   \
-          for (size_t qb = 0, qb_end = std::min(quant_block_size, K - bd); qb < qb_end; ++qb) { \
-            for (size_t bs = 0; bs < N; bs++, input++) {                                        \
-              auto sc = static_cast<float>(scale[bs]);                                          \
-              *output++ = static_cast<OutT>(input->ToFloat() * sc);                             \
-            }                                                                                   \
-          }                                                                                     \
-          scale += N;                                                                           \
-        }                                                                                       \
-      }                                                                                         \
-    }                                                                                           \
+#define DEQUANTIZE_LINEAR_APPLY_FLOAT8(T)                                                                   \
+  template <typename OutT>                                                                                  \
+  struct DequantizeLinearApply<T, OutT, false> {                                                            \
+    /* Per-tensor/layer or per-axis quantization */                                                         \
+    void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N,                             \
+            const T* input, const OutT* scale, OutT* output, const T*) {                                    \
+      ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {          \
+        auto sc = scale[row % K];                                                                           \
+        for (size_t n = row * N + begin, n_end = row * N + end; n < n_end; n++) {                           \
+          output[n] = static_cast<OutT>(input[n].ToFloat() * sc);                                           \
+        }                                                                                                   \
+      });                                                                                                   \
+    }                                                                                                       \
+    /* Blocked quantization */                                                                              \
+    void op(concurrency::ThreadPool* thread_pool, size_t M, size_t K, size_t N, size_t quant_block_size,    \
+            const T* input, const OutT* scale, OutT* output, const T*) {                                    \
+      const size_t quant_block_count = (K + quant_block_size - 1) / quant_block_size;                       \
+      ParDequantizeRows<T, OutT>(thread_pool, M, K, N, [&](size_t row, size_t begin, size_t end) {          \
+        const OutT* row_scale = scale + ((row / K) * quant_block_count + (row % K) / quant_block_size) * N; \
+        for (size_t n = begin; n < end; n++) {                                                              \
+          auto sc = static_cast<float>(row_scale[n]);                                                       \
+          output[row * N + n] = static_cast<OutT>(input[row * N + n].ToFloat() * sc);                       \
+        }                                                                                                   \
+      });                                                                                                   \
+    }                                                                                                       \
   };
 
 DEQUANTIZE_LINEAR_APPLY_FLOAT8(Float8E4M3FN)
@@ -496,19 +466,22 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
 
   const auto to = x_scale.GetElementType();
   const T* input = x.Data<T>();
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   constexpr bool is_4bit = boost::mp11::mp_contains<TypeList<Int4x2, UInt4x2>, T>::value;
 
   if (to == ONNX_NAMESPACE::TensorProto::FLOAT) {
     const float* scale = x_scale.Data<float>();
     float* output = y.MutableData<float>();
     if (block_size_) {
-      DequantizeLinearApply<T, float, is_4bit>().op(static_cast<size_t>(process_block_count),
+      DequantizeLinearApply<T, float, is_4bit>().op(thread_pool,
+                                                    static_cast<size_t>(process_block_count),
                                                     static_cast<size_t>(broadcast_dim),
                                                     static_cast<size_t>(process_block_size),
                                                     static_cast<size_t>(block_size_),
                                                     input, scale, output, zero_point);
     } else {
-      DequantizeLinearApply<T, float, is_4bit>().op(static_cast<size_t>(process_block_count),
+      DequantizeLinearApply<T, float, is_4bit>().op(thread_pool,
+                                                    static_cast<size_t>(process_block_count),
                                                     static_cast<size_t>(broadcast_dim),
                                                     static_cast<size_t>(process_block_size),
                                                     input, scale, output, zero_point);
@@ -517,13 +490,15 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
     const MLFloat16* scale = x_scale.Data<MLFloat16>();
     MLFloat16* output = y.MutableData<MLFloat16>();
     if (block_size_) {
-      DequantizeLinearApply<T, MLFloat16, is_4bit>().op(static_cast<size_t>(process_block_count),
+      DequantizeLinearApply<T, MLFloat16, is_4bit>().op(thread_pool,
+                                                        static_cast<size_t>(process_block_count),
                                                         static_cast<size_t>(broadcast_dim),
                                                         static_cast<size_t>(process_block_size),
                                                         static_cast<size_t>(block_size_),
                                                         input, scale, output, zero_point);
     } else {
-      DequantizeLinearApply<T, MLFloat16, is_4bit>().op(static_cast<size_t>(process_block_count),
+      DequantizeLinearApply<T, MLFloat16, is_4bit>().op(thread_pool,
+                                                        static_cast<size_t>(process_block_count),
                                                         static_cast<size_t>(broadcast_dim),
                                                         static_cast<size_t>(process_block_size),
                                                         input, scale, output, zero_point);
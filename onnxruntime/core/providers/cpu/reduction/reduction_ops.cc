@@ -788,6 +788,15 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
       reduced_dims, input_axes.empty() ? axes_ : input_axes,
       fast_shape, output_shape, fast_axes, keepdims_ != 0, noop_with_empty_axes);
 
+  if (fast_kind == FastReduceKind::kR && IsFastReduceKindAvailable(FastReduceKind::kKR, which_fast_reduce)) {
+    // A reduction on all dimensions is the KR reduction of a single row, which is split between the threads.
+    const TensorShapeVector row_shape{1, fast_shape[0]};
+    Tensor* output = ctx->Output(0, output_shape);
+    ValidateFastReduceKR(row_shape, *output);
+    case_kr(*input, row_shape, *output, ctx->GetOperatorThreadPool());
+    return true;
+  }
+
   if (which_fast_reduce != FastReduceKind::kNone) {
     if (IsFastReduceKindAvailable(fast_kind, which_fast_reduce)) {
       Tensor* output = ctx->Output(0, output_shape);
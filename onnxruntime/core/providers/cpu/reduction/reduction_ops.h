@@ -17,6 +17,8 @@
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
 #include "core/common/safeint.h"
 #include <cmath>
+#include <functional>
+#include <utility>
 
 namespace onnxruntime {
 
@@ -206,6 +208,59 @@ class ReduceAggregator : public ReduceAggregatorBase {
           }
         });
   }
+
+  // Number of chunks every row of a KR reduction is split in. The rows are only split when there are fewer rows
+  // than threads, in chunks long enough to be worth a task.
+  static int64_t FastReduceKRChunks(int64_t n_rows, int64_t n_cols, concurrency::ThreadPool* tp) {
+    constexpr int64_t min_chunk_size = 4096;
+    const int64_t n_threads = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    if (n_rows >= n_threads) {
+      return 1;
+    }
+    return std::max<int64_t>(1, std::min((n_threads + n_rows - 1) / n_rows, n_cols / min_chunk_size));
+  }
+
+  // KR reduction. f_chunk reduces a contiguous part of a row into a partial value, f_merge merges a partial value
+  // into another one and f_final turns the partial value of a whole row into the reduced value. The rows are reduced
+  // by different threads, or split in chunks reduced by different threads when the rows are few and long.
+  template <typename FCHUNK, typename FMERGE, typename FFINAL>
+  static void CommonFastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                 Tensor& output, concurrency::ThreadPool* tp,
+                                 FCHUNK f_chunk, FMERGE f_merge, FFINAL f_final) {
+    using TPARTIAL = decltype(f_chunk(static_cast<const T*>(nullptr), int64_t{0}));
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t n_rows = fast_shape[0];
+    int64_t stridei = fast_shape[1];
+    int64_t n_chunks = FastReduceKRChunks(n_rows, stridei, tp);
+
+    if (n_chunks == 1) {
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(n_rows), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out, f_chunk, f_final](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t d = first; d < last; ++d) {
+              out[d] = f_final(f_chunk(data + d * stridei, stridei));
+            }
+          });
+      return;
+    }
+
+    int64_t chunk_size = (stridei + n_chunks - 1) / n_chunks;
+    std::vector<TPARTIAL> partials(SafeInt<size_t>(n_rows) * n_chunks);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(n_rows * n_chunks),
+        [data, stridei, n_chunks, chunk_size, f_chunk, &partials](std::ptrdiff_t i) {
+          int64_t begin = (i % n_chunks) * chunk_size;
+          partials[i] = f_chunk(data + (i / n_chunks) * stridei + begin, std::min(chunk_size, stridei - begin));
+        });
+    for (int64_t d = 0; d < n_rows; ++d) {
+      TPARTIAL value = partials[d * n_chunks];
+      for (int64_t c = 1; c < n_chunks; ++c) {
+        f_merge(value, partials[d * n_chunks + c]);
+      }
+      out[d] = f_final(value);
+    }
+  }
 };
 
 template <typename T>
@@ -231,16 +286,11 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
-          for (ptrdiff_t d = first; d < last; ++d) {
-            out[d] = aggall(data + d * stridei, stridei);
-          }
-        });
+    ReduceAggregator<T, T>::CommonFastReduceKR(
+        input, fast_shape, output, tp,
+        [](const T* p, int64_t size) -> T { return aggall(p, size); },
+        [](T& value, const T& partial) { value += partial; },
+        [](const T& value) -> T { return value; });
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -293,13 +343,81 @@ template <typename T, typename TVAL = T>
 class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
  public:
   inline ReduceAggregatorSumSquare(int64_t N, const T&) : ReduceAggregator<T, TVAL>(N, 0) {}
+  static T aggall(const T* from_data, int64_t size) {
+    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).squaredNorm();
+  }
   inline TVAL aggall(const T* from_data) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).squaredNorm();
+    return aggall(from_data, this->N_);
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregator<T, TVAL>::CommonFastReduceKR(
+        input, fast_shape, output, tp,
+        [](const T* p, int64_t size) -> T { return aggall(p, size); },
+        [](T& value, const T& partial) { value += partial; },
+        [](const T& value) -> TVAL { return static_cast<TVAL>(value); });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    int64_t N = fast_shape[1];
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+
+    int64_t n_rows = fast_shape[0];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+          EigenVectorArrayMap<TVAL>(out + begin, end - begin) =
+              ConstEigenVectorArrayMap<T>(data + begin, end - begin).square().template cast<TVAL>();
+          for (int64_t row = 1; row < n_rows; ++row) {
+            EigenVectorArrayMap<TVAL>(out + begin, end - begin) +=
+                ConstEigenVectorArrayMap<T>(data + row * N + begin, end - begin).square().template cast<TVAL>();
+          }
+        });
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    int64_t strideo = fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t last) {
+          for (ptrdiff_t d = begin; d < last; ++d) {
+            EigenVectorMap<TVAL>(out + d * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                ConstEigenMatrixMap<T>(
+                    data + d * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                    .array()
+                    .square()
+                    .rowwise()
+                    .sum()
+                    .template cast<TVAL>();
+          }
+        });
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregator<T, TVAL>::CommonFastReduceRKR(
+        input, fast_shape, output, tp,
+        [=](const T*) -> TVAL { return 0; },
+        [=](TVAL& value, const T* p, int64_t size) {
+          value += static_cast<TVAL>(aggall(p, size));
+        });
+  }
 };
 
 template <typename T>
@@ -391,6 +509,20 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (!std::is_same_v<bool, T>) {
+      if (ReduceAggregator<T, T>::FastReduceKRChunks(fast_shape[0], fast_shape[1], tp) > 1) {
+        ReduceAggregator<T, T>::CommonFastReduceKR(
+            input, fast_shape, output, tp,
+            [](const T* p, int64_t size) -> T { return aggall(p, size); },
+            [](T& value, const T& partial) {
+              if (partial > value)
+                value = partial;
+            },
+            [](const T& value) -> T { return value; });
+        return;
+      }
+    }
+
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -500,6 +632,91 @@ class ReduceAggregatorArgMinMax : public ReduceAggregator<T, TVAL> {
   inline void enforce(const ResultsNoTransposePrepareForReduce& res) {
     ORT_ENFORCE(res.projected_index.size() == 0, "Only one axis is allowed for reduction.");
   }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+ protected:
+  // f_replace(v, best) tells if value v replaces the best value found so far, which decides between the first and
+  // the last index of the extremum.
+  template <typename FREPLACE>
+  static void CommonFastReduceArgKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                    Tensor& output, concurrency::ThreadPool* tp, FREPLACE f_replace) {
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+        [data, stridei, out, f_replace](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t d = first; d < last; ++d) {
+            const T* p = data + d * stridei;
+            T best = p[0];
+            int64_t arg = 0;
+            for (int64_t i = 1; i < stridei; ++i) {
+              if (f_replace(p[i], best)) {
+                best = p[i];
+                arg = i;
+              }
+            }
+            out[d] = static_cast<TVAL>(arg);
+          }
+        });
+  }
+
+  template <typename FREPLACE>
+  static void CommonFastReduceArgRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                    Tensor& output, concurrency::ThreadPool* tp, FREPLACE f_replace) {
+    int64_t N = fast_shape[1];
+    int64_t n_rows = fast_shape[0];
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    std::vector<T> best(data, data + N);
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+        [data, out, N, n_rows, f_replace, &best](ptrdiff_t begin, ptrdiff_t end) {
+          ReduceColumns(data, n_rows, N, begin, end, best.data(), out, f_replace);
+        });
+  }
+
+  template <typename FREPLACE>
+  static void CommonFastReduceArgKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                     Tensor& output, concurrency::ThreadPool* tp, FREPLACE f_replace) {
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    int64_t strideo = fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+        [data, fast_shape, stridei, strideo, out, f_replace](ptrdiff_t begin, ptrdiff_t last) {
+          std::vector<T> best(onnxruntime::narrow<size_t>(strideo));
+          for (ptrdiff_t d = begin; d < last; ++d) {
+            const T* p = data + d * stridei;
+            std::copy(p, p + strideo, best.begin());
+            ReduceColumns(p, fast_shape[1], strideo, 0, strideo, best.data(), out + d * strideo, f_replace);
+          }
+        });
+  }
+
+ private:
+  // Index of the extremum of the columns [begin, end) of a matrix with n_rows rows and N columns, best holds the
+  // first row of the columns.
+  template <typename FREPLACE>
+  static void ReduceColumns(const T* data, int64_t n_rows, int64_t N, int64_t begin, int64_t end,
+                            T* best, TVAL* out, FREPLACE f_replace) {
+    std::fill(out + begin, out + end, static_cast<TVAL>(0));
+    const T* p = data + N;
+    for (int64_t row = 1; row < n_rows; ++row, p += N) {
+      for (int64_t j = begin; j < end; ++j) {
+        if (f_replace(p[j], best[j])) {
+          best[j] = p[j];
+          out[j] = static_cast<TVAL>(row);
+        }
+      }
+    }
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -517,6 +734,22 @@ class ReduceAggregatorArgMax : public ReduceAggregatorArgMinMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKR(input, fast_shape, output, tp, std::greater<T>());
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgRK(input, fast_shape, output, tp, std::greater<T>());
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKRK(input, fast_shape, output, tp, std::greater<T>());
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -536,6 +769,22 @@ class ReduceAggregatorArgMaxLastIndex : public ReduceAggregatorArgMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKR(input, fast_shape, output, tp, std::greater_equal<T>());
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgRK(input, fast_shape, output, tp, std::greater_equal<T>());
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKRK(input, fast_shape, output, tp, std::greater_equal<T>());
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -553,6 +802,22 @@ class ReduceAggregatorArgMin : public ReduceAggregatorArgMinMax<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKR(input, fast_shape, output, tp, std::less<T>());
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgRK(input, fast_shape, output, tp, std::less<T>());
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKRK(input, fast_shape, output, tp, std::less<T>());
+  }
 };
 
 template <typename T, typename TVAL = int64_t>
@@ -572,6 +837,22 @@ class ReduceAggregatorArgMinLastIndex : public ReduceAggregatorArgMin<T, TVAL> {
     }
     ++this->index_;
   }
+
+  // Fast reduction
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKR(input, fast_shape, output, tp, std::less_equal<T>());
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgRK(input, fast_shape, output, tp, std::less_equal<T>());
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorArgMinMax<T, TVAL>::CommonFastReduceArgKRK(input, fast_shape, output, tp, std::less_equal<T>());
+  }
 };
 
 template <typename T>
@@ -601,6 +882,20 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
+    if constexpr (!std::is_same_v<bool, T>) {
+      if (ReduceAggregator<T, T>::FastReduceKRChunks(fast_shape[0], fast_shape[1], tp) > 1) {
+        ReduceAggregator<T, T>::CommonFastReduceKR(
+            input, fast_shape, output, tp,
+            [](const T* p, int64_t size) -> T { return aggall(p, size); },
+            [](T& value, const T& partial) {
+              if (partial < value)
+                value = partial;
+            },
+            [](const T& value) -> T { return value; });
+        return;
+      }
+    }
+
     const T* data = input.Data<T>();
     T* out = output.MutableData<T>();
     int64_t stridei = fast_shape[1];
@@ -774,6 +1069,102 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction, only for floating point types since splitting a row in chunks changes the rounding of the
+  // integer exponentials.
+  static inline FastReduceKind WhichFastReduce() {
+    if constexpr (std::is_floating_point_v<T>) {
+      return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK;
+    } else {
+      return FastReduceKind::kNone;
+    }
+  }
+
+  // Same result as aggall: the maximum of a row is subtracted from its values before the exponentials are summed.
+  // A chunk is reduced into its maximum and the sum of the exponentials relative to it.
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregator<T, T>::CommonFastReduceKR(
+        input, fast_shape, output, tp,
+        [](const T* p, int64_t size) -> std::pair<T, T> {
+          T max = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(p, onnxruntime::narrow<size_t>(size)).maxCoeff();
+          T sum = 0;
+          for (int64_t i = 0; i < size; ++i) {
+            sum += reduce_exp(p[i] - max);
+          }
+          return {max, sum};
+        },
+        [](std::pair<T, T>& value, const std::pair<T, T>& partial) {
+          const T max = partial.first > value.first ? partial.first : value.first;
+          // A chunk whose maximum is -inf only contains -inf and adds nothing to the sum.
+          auto rescale = [max](const std::pair<T, T>& v) -> T {
+            if (v.first == max) {
+              return v.second;
+            }
+            return reduce_isinf(v.first) ? static_cast<T>(0) : v.second * reduce_exp(v.first - max);
+          };
+          value.second = rescale(value) + rescale(partial);
+          value.first = max;
+        },
+        [](const std::pair<T, T>& value) -> T { return reduce_log<T>(value.second) + value.first; });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    int64_t N = fast_shape[1];
+    int64_t n_rows = fast_shape[0];
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    std::vector<T> max(onnxruntime::narrow<size_t>(N));
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+        [data, out, N, n_rows, &max](ptrdiff_t begin, ptrdiff_t end) {
+          ReduceColumns(data, n_rows, N, begin, end, max.data(), out);
+        });
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    int64_t strideo = fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t last) {
+          std::vector<T> max(onnxruntime::narrow<size_t>(strideo));
+          for (ptrdiff_t d = begin; d < last; ++d) {
+            ReduceColumns(data + d * stridei, fast_shape[1], strideo, 0, strideo, max.data(), out + d * strideo);
+          }
+        });
+  }
+
+ private:
+  // Reduces the columns [begin, end) of a matrix with n_rows rows and N columns, with the maximums computed like
+  // update0 does, so the values are the same as NoTransposeReduce2Loops's.
+  static void ReduceColumns(const T* data, int64_t n_rows, int64_t N, int64_t begin, int64_t end, T* max, T* out) {
+    for (int64_t j = begin; j < end; ++j) {
+      max[j] = reduce_isinf(data[j]) ? static_cast<T>(0) : data[j];
+      out[j] = 0;
+    }
+    const T* p = data;
+    for (int64_t row = 0; row < n_rows; ++row, p += N) {
+      for (int64_t j = begin; j < end; ++j) {
+        if (!(reduce_isinf(p[j]) || reduce_isnan(p[j]) || p[j] < max[j]))
+          max[j] = p[j];
+      }
+    }
+    p = data;
+    for (int64_t row = 0; row < n_rows; ++row, p += N) {
+      for (int64_t j = begin; j < end; ++j) {
+        out[j] += reduce_exp(p[j] - max[j]);
+      }
+    }
+    for (int64_t j = begin; j < end; ++j) {
+      out[j] = reduce_log<T>(out[j]) + max[j];
+    }
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
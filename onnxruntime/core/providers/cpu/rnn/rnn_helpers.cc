@@ -103,6 +103,16 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+bool ComputeDirectionsConcurrently(concurrency::ThreadPool* thread_pool, int batch_size, int hidden_size,
+                                   int num_gates) {
+  // largest number of multiply-adds of the recurrent GEMM of a step whose direction is computed by a single thread
+  constexpr int64_t kMaxStepGemmSize = int64_t{1} << 20;
+  constexpr int kMaxBatchSize = 4;
+  const int64_t step_gemm_size = int64_t{batch_size} * num_gates * hidden_size * hidden_size;
+  return concurrency::ThreadPool::DegreeOfParallelism(thread_pool) >= 2 && batch_size <= kMaxBatchSize &&
+         step_gemm_size <= kMaxStepGemmSize;
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>> NameToArgUsageMap{
     {"affine", {true, true}},
@@ -286,6 +286,14 @@ inline void ComputeGemm(const int M,
               thread_pool);
 }
 
+// The two directions of a bidirectional RNN are independent. With small batches the GEMM of every step is too small
+// to be split efficiently between the threads, which mostly wait for each other, so the directions are computed at
+// the same time by two threads instead, each of them without a thread pool.
+// Returns true if the directions should be computed that way. num_gates is the number of gates computed by the
+// recurrent GEMM of a step, e.g. 4 for LSTM.
+bool ComputeDirectionsConcurrently(concurrency::ThreadPool* thread_pool, int batch_size, int hidden_size,
+                                   int num_gates);
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -3,10 +3,13 @@
 
 #include "core/providers/cpu/signal/dft.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <functional>
 #include <limits>
+#include <optional>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
@@ -48,276 +51,322 @@ static bool is_complex_valued_signal(const onnxruntime::TensorShape& shape) {
   return shape.NumDimensions() > 2 && shape[shape.NumDimensions() - 1] == 2;
 }
 
-constexpr static bool is_power_of_2(size_t size) {
-  unsigned n_bits = 0;
-  while (size != 0) {
-    n_bits += size & 1;
-    size = size >> 1;
-  }
-  return n_bits == 1;
-}
-
-static const unsigned char BitReverseTable256[] = {
-    0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0, 0x08, 0x88, 0x48,
-    0xC8, 0x28, 0xA8, 0x68, 0xE8, 0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8, 0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4,
-    0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4, 0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C,
-    0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC, 0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2, 0x12, 0x92, 0x52, 0xD2,
-    0x32, 0xB2, 0x72, 0xF2, 0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A,
-    0xFA, 0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6, 0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6, 0x0E, 0x8E,
-    0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE, 0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE, 0x01, 0x81, 0x41, 0xC1, 0x21,
-    0xA1, 0x61, 0xE1, 0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1, 0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9,
-    0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9, 0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5, 0x15, 0x95, 0x55,
-    0xD5, 0x35, 0xB5, 0x75, 0xF5, 0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED, 0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD,
-    0x7D, 0xFD, 0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3, 0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3, 0x0B,
-    0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB, 0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB, 0x07, 0x87, 0x47, 0xC7,
-    0x27, 0xA7, 0x67, 0xE7, 0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7, 0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F,
-    0xEF, 0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF};
-
-template <typename T>
-static inline T bit_reverse(T num, unsigned significant_bits) {
-  if (significant_bits > 32) {
-    ORT_THROW("Unsupported bit size.");
-  }
-  uint32_t num_32 = static_cast<uint32_t>(num);
-  uint32_t rev = (BitReverseTable256[num_32 & 0xff] << 24) | (BitReverseTable256[(num_32 >> 8) & 0xff] << 16) |
-                 (BitReverseTable256[(num_32 >> 16) & 0xff] << 8) | (BitReverseTable256[(num_32 >> 24) & 0xff]);
-  return static_cast<T>(((uint64_t)rev) >> (32 - significant_bits));
-}
+namespace {
 
 template <typename T>
-static T compute_angular_velocity(size_t number_of_samples, bool inverse) {
-  // Calculate fundamental angular velocity
-  static constexpr T pi = static_cast<T>(M_PI);
-  static constexpr T tau = 2 * pi;
-  T inverse_switch = inverse ? 1.f : -1.f;
-  T angular_velocity = inverse_switch * tau / number_of_samples;
-  return angular_velocity;
+std::complex<T> ComputeTwiddle(size_t index, size_t length, bool inverse) {
+  // The angle is computed in double so that the twiddles of long float transforms stay accurate.
+  const double angle = (inverse ? 2.0 : -2.0) * M_PI * static_cast<double>(index) / static_cast<double>(length);
+  return std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
 }
 
+// Mixed radix FFT of the lengths whose prime factors are 2, 3, 5 and 7. The transform is decomposed recursively in
+// time, with radix 4 passes first, and the twiddles of the length are computed once by the constructor. The inverse
+// transform is not scaled.
 template <typename T>
-static std::complex<T> compute_exponential(size_t index, const T angular_velocity) {
-  const T angle = static_cast<T>(index) * angular_velocity;
-  return std::complex<T>(cos(angle), sin(angle));
-}
+class MixedRadixFft {
+ public:
+  MixedRadixFft(size_t length, bool inverse) : length_(length), inverse_(inverse) {
+    ORT_ENFORCE(Factorize(length, &factors_), "The FFT length ", length, " has prime factors larger than 7.");
+    twiddles_.resize(length);
+    for (size_t i = 0; i < length; i++) {
+      twiddles_[i] = ComputeTwiddle<T>(i, length, inverse);
+    }
+  }
 
-template <typename T, typename U>
-static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, size_t X_offset, size_t X_stride,
-                         size_t Y_offset, size_t Y_stride, int64_t axis, size_t dft_length, const Tensor* window,
-                         bool is_onesided, bool inverse, InlinedVector<std::complex<T>>& V,
-                         InlinedVector<std::complex<T>>& temp_output) {
-  // Get shape and significant bits
-  const auto& X_shape = X->Shape();
-  size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
-  unsigned significant_bits = static_cast<unsigned>(log2(dft_length));
+  // Whether the length is a product of 2, 3, 5 and 7. The radixes are appended to factors, if any, each followed by
+  // the length that remains to transform after it.
+  static bool Factorize(size_t length, InlinedVector<size_t>* factors) {
+    if (length == 0) {
+      return false;
+    }
 
-  // Get data
-  auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
-  // Get window
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
+    size_t radix = 4;
+    while (length > 1) {
+      while (length % radix != 0) {
+        switch (radix) {
+          case 4:
+            radix = 2;
+            break;
+          case 2:
+            radix = 3;
+            break;
+          case 3:
+            radix = 5;
+            break;
+          case 5:
+            radix = 7;
+            break;
+          default:
+            return false;
+        }
+      }
+      length /= radix;
+      if (factors != nullptr) {
+        factors->push_back(radix);
+        factors->push_back(length);
+      }
+    }
+    return true;
   }
 
-  size_t Y_data_stride = 1;
-  std::complex<T>* Y_data;
-  if (is_onesided) {
-    if (temp_output.size() != dft_length) {
-      temp_output.resize(dft_length);
+  // Transforms the length_ contiguous values of input into output, which must not overlap.
+  void Transform(const std::complex<T>* input, std::complex<T>* output) const {
+    if (factors_.empty()) {
+      output[0] = input[0];
+      return;
     }
-    Y_data = temp_output.data();
-  } else {
-    Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-    Y_data_stride = Y_stride;
+    Work(output, input, 1, factors_.data());
   }
 
-  auto angular_velocity = compute_angular_velocity<T>(dft_length, inverse);
+ private:
+  void Work(std::complex<T>* output, const std::complex<T>* input, size_t stride, const size_t* factors) const {
+    const size_t radix = factors[0];
+    const size_t m = factors[1];
+    std::complex<T>* const output_end = output + radix * m;
 
-  // Create vandermonde matrix V ordered with the bit-reversed permutation
-  if (V.size() != dft_length) {
-    V.resize(dft_length);
-    for (size_t i = 0; i < dft_length; i++) {
-      size_t bit_reversed_index = bit_reverse(i, significant_bits);
-      V[bit_reversed_index] = compute_exponential(i, angular_velocity);
+    // the radix interleaved sub-sequences of the input are transformed into consecutive blocks of m outputs
+    if (m == 1) {
+      for (std::complex<T>* out = output; out != output_end; ++out, input += stride) {
+        *out = *input;
+      }
+    } else {
+      for (std::complex<T>* out = output; out != output_end; out += m, input += stride) {
+        Work(out, input, stride * radix, factors + 2);
+      }
     }
-  }
 
-  for (size_t i = 0; i < dft_length; i++) {
-    size_t bit_reversed_index = bit_reverse(i, significant_bits);
-    auto x = (bit_reversed_index < number_of_samples) ? *(X_data + bit_reversed_index * X_stride) : 0;
-    auto window_element = window_data ? *(window_data + bit_reversed_index) : 1;
-    *(Y_data + i * Y_data_stride) = std::complex<T>(1, 0) * x * window_element;
+    switch (radix) {
+      case 2:
+        Butterfly2(output, stride, m);
+        break;
+      case 4:
+        Butterfly4(output, stride, m);
+        break;
+      default:
+        ButterflyGeneric(output, stride, m, radix);
+        break;
+    }
   }
 
-  // Run fft_radix2
-  unsigned current_significant_bits = 0;
-  for (size_t i = 2; i <= dft_length; i <<= 1) {
-    size_t midpoint = i >> 1;
-    current_significant_bits++;
-
-    for (size_t k = 0; k < midpoint; k++) {
-      auto first_idx = bit_reverse(k, current_significant_bits);
-      auto second_idx = bit_reverse(midpoint + k, current_significant_bits);
-      for (size_t j = 0; j < dft_length; j += i) {
-        auto even_index = k + j;
-        auto odd_index = k + j + midpoint;
-        std::complex<T>* even = (Y_data + even_index * Y_data_stride);
-        std::complex<T>* odd = (Y_data + odd_index * Y_data_stride);
-        std::complex<T> first = *even + (V[first_idx] * *odd);
-        std::complex<T> second = *even + (V[second_idx] * *odd);
-        *even = first;
-        *odd = second;
-      }
+  void Butterfly2(std::complex<T>* output, size_t stride, size_t m) const {
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> t = output[k + m] * twiddles_[k * stride];
+      output[k + m] = output[k] - t;
+      output[k] += t;
     }
   }
 
-  // Scale the output if inverse
-  if (inverse) {
-    for (size_t i = 0; i < dft_length; i++) {
-      std::complex<T>& val = *(Y_data + i * Y_data_stride);
-      val /= static_cast<T>(dft_length);
+  void Butterfly4(std::complex<T>* output, size_t stride, size_t m) const {
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> t1 = output[k + m] * twiddles_[k * stride];
+      const std::complex<T> t2 = output[k + 2 * m] * twiddles_[2 * k * stride];
+      const std::complex<T> t3 = output[k + 3 * m] * twiddles_[3 * k * stride];
+      const std::complex<T> even_difference = output[k] - t2;
+      const std::complex<T> even_sum = output[k] + t2;
+      const std::complex<T> odd_sum = t1 + t3;
+      // the odd difference rotated by a quarter turn, -i in the forward direction and +i in the inverse direction
+      const std::complex<T> odd_difference = inverse_ ? std::complex<T>(-(t1 - t3).imag(), (t1 - t3).real())
+                                                      : std::complex<T>((t1 - t3).imag(), -(t1 - t3).real());
+      output[k] = even_sum + odd_sum;
+      output[k + m] = even_difference + odd_difference;
+      output[k + 2 * m] = even_sum - odd_sum;
+      output[k + 3 * m] = even_difference - odd_difference;
     }
   }
 
-  if (is_onesided) {
-    const size_t output_size = (dft_length >> 1) + 1;
-    auto destination = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-    for (size_t i = 0; i < output_size; i++) {
-      *(destination + Y_stride * i) = *(Y_data + i * Y_data_stride);
+  // The O(radix^2) butterfly of the radixes 3, 5 and 7.
+  void ButterflyGeneric(std::complex<T>* output, size_t stride, size_t m, size_t radix) const {
+    std::complex<T> scratch[7];
+    for (size_t u = 0; u < m; u++) {
+      for (size_t q = 0; q < radix; q++) {
+        scratch[q] = output[u + q * m];
+      }
+
+      for (size_t q = 0, k = u; q < radix; q++, k += m) {
+        const size_t twiddle_step = stride * k;
+        size_t twiddle_index = 0;
+        std::complex<T> sum = scratch[0];
+        for (size_t p = 1; p < radix; p++) {
+          twiddle_index += twiddle_step;
+          if (twiddle_index >= length_) {
+            twiddle_index -= length_;
+          }
+          sum += scratch[p] * twiddles_[twiddle_index];
+        }
+        output[k] = sum;
+      }
     }
   }
 
-  return Status::OK();
-}
+  size_t length_;
+  bool inverse_;
+  InlinedVector<size_t> factors_;
+  std::vector<std::complex<T>> twiddles_;
+};
 
+// The buffers that a thread reuses across the transforms of a DftPlan.
+template <typename T>
+struct DftScratch {
+  std::vector<std::complex<T>> input;
+  std::vector<std::complex<T>> output;
+  std::vector<std::complex<T>> convolution;
+};
+
+// The precomputed state of the DFTs of one length in one direction, shared by all the transforms of a Compute:
+//  - the lengths whose prime factors are at most 7 are transformed with MixedRadixFft,
+//  - the other lengths with Bluestein's algorithm, as a convolution computed with power of 2 FFTs,
+//  - the real signals of even length are packed into complex signals of half the length, whose transform is split
+//    back into the transform of the real signal.
 template <typename T>
-T next_power_of_2(T in) {
-  in--;
-  T out = 1;
-  while (out <= in) {
-    out <<= 1;
+class DftPlan {
+ public:
+  DftPlan(size_t length, bool inverse, bool is_real_input) : length_(length), inverse_(inverse) {
+    if (is_real_input && length % 2 == 0 && MixedRadixFft<T>::Factorize(length / 2, nullptr)) {
+      half_fft_.emplace(length / 2, inverse);
+      real_twiddles_.resize(length / 2 + 1);
+      for (size_t k = 0; k <= length / 2; k++) {
+        real_twiddles_[k] = ComputeTwiddle<T>(k, length, inverse);
+      }
+    } else if (MixedRadixFft<T>::Factorize(length, nullptr)) {
+      fft_.emplace(length, inverse);
+    } else {
+      // x[k] = chirp[k] * sum(x[n] * chirp[n] * conj(chirp[k - n])), a convolution of length 2 * length - 1
+      size_t convolution_length = 1;
+      while (convolution_length < 2 * length - 1) {
+        convolution_length <<= 1;
+      }
+      convolution_fft_.emplace(convolution_length, false);
+      convolution_ifft_.emplace(convolution_length, true);
+
+      chirp_.resize(length);
+      for (size_t n = 0; n < length; n++) {
+        // n^2 mod 2 * length keeps the angle of the chirp small
+        const size_t n_squared = static_cast<size_t>((static_cast<uint64_t>(n) * n) % (2 * length));
+        chirp_[n] = ComputeTwiddle<T>(n_squared, 2 * length, inverse);
+      }
+
+      std::vector<std::complex<T>> b(convolution_length);
+      b[0] = std::conj(chirp_[0]);
+      for (size_t n = 1; n < length; n++) {
+        b[n] = std::conj(chirp_[n]);
+        b[convolution_length - n] = b[n];
+      }
+      b_fft_.resize(convolution_length);
+      convolution_fft_->Transform(b.data(), b_fft_.data());
+    }
   }
-  return out;
-}
 
-template <typename T, typename U>
-static Status dft_bluestein_z_chirp(
-    OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp, size_t X_offset, size_t X_stride, size_t Y_offset, size_t Y_stride,
-    int64_t axis, size_t dft_length, const Tensor* window, bool inverse, InlinedVector<std::complex<T>>& V,
-    InlinedVector<std::complex<T>>& temp_output) {
-  static constexpr T pi = static_cast<T>(M_PI);
-
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-
-  size_t N = static_cast<size_t>(dft_length);
-  size_t M = next_power_of_2(2 * N - 1);
-  auto dft_input_shape = onnxruntime::TensorShape({1, (int64_t)M, 2});
-  T scale = inverse ? 1.f / N : 1.f;
-  T direction = inverse ? 1.f : -1.f;
-
-  bool should_recreate_b_fft = b_fft.Shape().Size() != dft_input_shape.Size();
-  bool should_recreate_chirp = chirp.Shape().Size() != dft_input_shape.Size();
-  bool should_recreate = should_recreate_b_fft || should_recreate_chirp;
-  if (should_recreate) {
-    auto b = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-    b_fft = onnxruntime::Tensor(Y->DataType(), dft_input_shape, alloc);
-    chirp = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-
-    std::complex<T>* b_data = reinterpret_cast<std::complex<T>*>(b.MutableDataRaw());
-    std::complex<T>* b_fft_data = reinterpret_cast<std::complex<T>*>(b_fft.MutableDataRaw());
-    std::complex<T>* chirp_data = reinterpret_cast<std::complex<T>*>(chirp.MutableDataRaw());
-    memset(reinterpret_cast<void*>(b_data), 0, b.SizeInBytes());
-    memset(reinterpret_cast<void*>(b_fft_data), 0, b_fft.SizeInBytes());
-    memset(reinterpret_cast<void*>(chirp_data), 0, chirp.SizeInBytes());
-
-    for (size_t n = 0; n < N; n++) {
-      std::complex<T>& chirp_n = *(chirp_data + n);
-      // chirp
-      auto exponent = direction * pi * n * n / N;
-      chirp_n = std::complex<T>(cos(exponent), sin(exponent));
-
-      // b
-      std::complex<T>& b_n = *(b_data + n);
-      b_n = std::conj(chirp_n);
+  // Transforms the first number_of_samples values of x, read every x_stride elements and zero padded to the length
+  // of the plan, and writes the first output_size values of the transform every y_stride elements of y.
+  template <typename U>
+  void Compute(const U* x, size_t x_stride, size_t number_of_samples, const T* window, std::complex<T>* y,
+               size_t y_stride, size_t output_size, DftScratch<T>& scratch) const {
+    const size_t samples = std::min(number_of_samples, length_);
+    const T scale = inverse_ ? static_cast<T>(1) / static_cast<T>(length_) : static_cast<T>(1);
+
+    if constexpr (std::is_same_v<U, T>) {
+      if (half_fft_.has_value()) {
+        ComputeReal(x, x_stride, samples, window, y, y_stride, output_size, scale, scratch);
+        return;
+      }
     }
 
-    for (size_t n = M - N + 1; n < M; n++) {
-      std::complex<T>& b_n = *(b_data + n);
-      std::complex<T>& b_m_minus_n = *(b_data + M - n);
-      b_n = b_m_minus_n;
+    scratch.input.assign(length_, std::complex<T>());
+    for (size_t n = 0; n < samples; n++) {
+      scratch.input[n] = std::complex<T>(x[n * x_stride]) * (window != nullptr ? window[n] : static_cast<T>(1));
     }
 
-    // Forward FFT radix2 for the "b" signal
-    // This will be cached and reused!
-    ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &b, &b_fft, 0, 1, 0, 1, 1, M, nullptr,
-                                                        false, false, V, temp_output)));
-  }
+    scratch.output.resize(length_);
+    if (fft_.has_value()) {
+      fft_->Transform(scratch.input.data(), scratch.output.data());
+    } else {
+      const size_t convolution_length = b_fft_.size();
+      scratch.convolution.assign(convolution_length, std::complex<T>());
+      for (size_t n = 0; n < length_; n++) {
+        scratch.convolution[n] = scratch.input[n] * chirp_[n];
+      }
 
-  // Get data
-  auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
-  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
-  }
+      std::vector<std::complex<T>>& a_fft = scratch.input;
+      a_fft.resize(convolution_length);
+      convolution_fft_->Transform(scratch.convolution.data(), a_fft.data());
+      for (size_t i = 0; i < convolution_length; i++) {
+        a_fft[i] *= b_fft_[i];
+      }
+      convolution_ifft_->Transform(a_fft.data(), scratch.convolution.data());
 
-  auto a = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-  auto a_fft = onnxruntime::Tensor(Y->DataType(), dft_input_shape, alloc);
-  std::complex<T>* a_data = reinterpret_cast<std::complex<T>*>(a.MutableDataRaw());
-  std::complex<T>* a_fft_data = reinterpret_cast<std::complex<T>*>(a_fft.MutableDataRaw());
-  std::complex<T>* b_fft_data = reinterpret_cast<std::complex<T>*>(b_fft.MutableDataRaw());
-  std::complex<T>* chirp_data = reinterpret_cast<std::complex<T>*>(chirp.MutableDataRaw());
-  memset(reinterpret_cast<void*>(a_data), 0, a.SizeInBytes());
+      const T convolution_scale = static_cast<T>(1) / static_cast<T>(convolution_length);
+      for (size_t k = 0; k < length_; k++) {
+        scratch.output[k] = scratch.convolution[k] * chirp_[k] * convolution_scale;
+      }
+    }
 
-  const auto& X_shape = X->Shape();
-  size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
-
-  // Prepare "a" signal
-  for (size_t n = 0; n < number_of_samples; n++) {
-    std::complex<T>& a_n = *(a_data + n);
-    std::complex<T>& chirp_n = *(chirp_data + n);
-    auto window_n = window_data ? *(window_data + n) : 1;
-    a_n = *(X_data + n * X_stride);  // input
-    a_n *= window_n;
-    a_n *= chirp_n;
+    for (size_t k = 0; k < output_size; k++) {
+      y[k * y_stride] = scratch.output[k] * scale;
+    }
   }
 
-  // Forward FFT radix2 for the "a" signal
-  ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &a, &a_fft, 0, 1, 0, 1, 1, M, nullptr,
-                                                      false, false, V, temp_output)));
+ private:
+  void ComputeReal(const T* x, size_t x_stride, size_t samples, const T* window, std::complex<T>* y, size_t y_stride,
+                   size_t output_size, T scale, DftScratch<T>& scratch) const {
+    // z[n] = x[2n] + i * x[2n + 1], of which Z = E + i * O with E and O the transforms of the even and odd samples
+    const size_t half_length = length_ / 2;
+    scratch.input.assign(half_length, std::complex<T>());
+    for (size_t n = 0; n < samples; n++) {
+      const T value = x[n * x_stride] * (window != nullptr ? window[n] : static_cast<T>(1));
+      if (n % 2 == 0) {
+        scratch.input[n / 2].real(value);
+      } else {
+        scratch.input[n / 2].imag(value);
+      }
+    }
 
-  for (size_t i = 0; i < M; i++) {
-    std::complex<T>& a_i = *(a_fft_data + i);
-    std::complex<T>& b_i = *(b_fft_data + i);
-    a_i *= b_i;
-  }
+    scratch.output.resize(half_length);
+    half_fft_->Transform(scratch.input.data(), scratch.output.data());
+
+    // E and O of real signals are Hermitian, so E[k] = (Z[k] + conj(Z[h - k])) / 2 and
+    // O[k] = (Z[k] - conj(Z[h - k])) / 2i, and X[k] = E[k] + w^k * O[k].
+    const std::complex<T>* z = scratch.output.data();
+    const size_t unique_size = std::min(output_size, half_length + 1);
+    for (size_t k = 0; k < unique_size; k++) {
+      const std::complex<T> z_k = z[k % half_length];
+      const std::complex<T> z_mirror = std::conj(z[(half_length - k) % half_length]);
+      const std::complex<T> even = (z_k + z_mirror) * static_cast<T>(0.5);
+      const std::complex<T> odd = (z_k - z_mirror) * std::complex<T>(0, static_cast<T>(-0.5));
+      y[k * y_stride] = (even + real_twiddles_[k] * odd) * scale;
+    }
 
-  // Inverse FFT radix2 for the "a" signal
-  ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &a_fft, &a, 0, 1, 0, 1, 1, M, nullptr,
-                                                      false, true, V, temp_output)));
-  const auto& Y_shape = Y->Shape();
-  size_t dft_output_size = static_cast<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
-
-  for (size_t i = 0; i < dft_output_size; i++) {
-    std::complex<T>& chirp_i = *(chirp_data + i);
-    std::complex<T>& out = *(Y_data + i * Y_stride);
-    std::complex<T>& c_i = *(a_data + i);
-    if (i > 0) {
-      // The inverse fft is computed using the same cached vandermonde matrix (V) created by the
-      // forward fft. This reversal causes the output to be reversed as well.
-      // Therefore we undo the reversal when writing the output back out.
-      c_i = *(a_data + M - i);
+    // the rest of the transform of a real signal is conjugate symmetric
+    for (size_t k = unique_size; k < output_size; k++) {
+      y[k * y_stride] = std::conj(y[(length_ - k) * y_stride]);
     }
-    out = c_i * chirp_i * scale;
   }
-  return Status::OK();
+
+  size_t length_;
+  bool inverse_;
+  std::optional<MixedRadixFft<T>> fft_;
+  std::optional<MixedRadixFft<T>> half_fft_;
+  std::vector<std::complex<T>> real_twiddles_;
+  std::optional<MixedRadixFft<T>> convolution_fft_;
+  std::optional<MixedRadixFft<T>> convolution_ifft_;
+  std::vector<std::complex<T>> chirp_;
+  std::vector<std::complex<T>> b_fft_;
+};
+
+// The cost of one transform of the plan for the thread pool.
+template <typename T, typename U>
+TensorOpCost DftCost(size_t length, size_t output_size) {
+  const double log_length = std::log2(static_cast<double>(std::max<size_t>(length, 2)));
+  return TensorOpCost{static_cast<double>(length * sizeof(U)),
+                      static_cast<double>(output_size * sizeof(std::complex<T>)),
+                      5.0 * static_cast<double>(length) * log_length};
 }
 
+}  // namespace
+
 template <typename T, typename U>
-static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp,
-                                         int64_t axis, int64_t dft_length, const Tensor* window, bool is_onesided, bool inverse,
-                                         InlinedVector<std::complex<T>>& V,
-                                         InlinedVector<std::complex<T>>& temp_output) {
+static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X, Tensor* Y, int64_t axis,
+                                         int64_t dft_length, bool inverse) {
   // Get shape
   const auto& X_shape = X->Shape();
   const auto& Y_shape = Y->Shape();
@@ -332,44 +381,43 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
     batch_and_signal_rank -= 1;
   }
 
-  // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
-    size_t X_offset = 0;
-    size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
-    size_t cumulative_packed_stride = total_dfts;
-    size_t temp = i;
-    for (size_t r = 0; r < batch_and_signal_rank; r++) {
-      if (r == static_cast<size_t>(axis)) {
-        continue;
-      }
-      cumulative_packed_stride /= onnxruntime::narrow<size_t>(X_shape[r]);
-      auto index = temp / cumulative_packed_stride;
-      temp -= (index * cumulative_packed_stride);
-      X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
-    }
-
-    size_t Y_offset = 0;
-    size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
-    cumulative_packed_stride = total_dfts;
-    temp = i;
-    for (size_t r = 0; r < batch_and_signal_rank; r++) {
-      if (r == static_cast<size_t>(axis)) {
-        continue;
-      }
-      cumulative_packed_stride /= onnxruntime::narrow<size_t>(X_shape[r]);
-      auto index = temp / cumulative_packed_stride;
-      temp -= (index * cumulative_packed_stride);
-      Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
-    }
-
-    if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
-      ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
-                                            is_onesided, inverse, V, temp_output)));
-    } else {
-      ORT_RETURN_IF_ERROR(
-          (dft_bluestein_z_chirp<T, U>(ctx, X, Y, b_fft, chirp, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window, inverse, V, temp_output)));
-    }
-  }
+  const size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+  const size_t output_size = static_cast<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+  const size_t X_stride =
+      onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+  const auto* X_data = reinterpret_cast<const U*>(X->DataRaw());
+  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+
+  // the output size is the onesided size if needed
+  const DftPlan<T> plan(onnxruntime::narrow<size_t>(dft_length), inverse, std::is_same_v<U, T>);
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+      DftCost<T, U>(onnxruntime::narrow<size_t>(dft_length), output_size),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        DftScratch<T> scratch;
+        for (size_t i = static_cast<size_t>(first); i < static_cast<size_t>(last); i++) {
+          // Calculate x/y offsets
+          size_t X_offset = 0;
+          size_t Y_offset = 0;
+          size_t cumulative_packed_stride = total_dfts;
+          size_t temp = i;
+          for (size_t r = 0; r < batch_and_signal_rank; r++) {
+            if (r == static_cast<size_t>(axis)) {
+              continue;
+            }
+            cumulative_packed_stride /= onnxruntime::narrow<size_t>(X_shape[r]);
+            auto index = temp / cumulative_packed_stride;
+            temp -= (index * cumulative_packed_stride);
+            X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
+            Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
+          }
+
+          plan.Compute(X_data + X_offset, X_stride, number_of_samples, nullptr, Y_data + Y_offset, Y_stride,
+                       output_size, scratch);
+        }
+      });
 
   return Status::OK();
 }
@@ -408,17 +456,13 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   // Get data type
   auto data_type = X->DataType();
 
-  Tensor b_fft, chirp;
   auto element_size = data_type->Size();
   if (element_size == sizeof(float)) {
-    InlinedVector<std::complex<float>> V;
-    InlinedVector<std::complex<float>> temp_output;
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                    is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, X, Y, axis, number_of_samples, inverse)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(ctx, X, Y, axis, number_of_samples,
+                                                                                  inverse)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -427,14 +471,11 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
           data_type);
     }
   } else if (element_size == sizeof(double)) {
-    InlinedVector<std::complex<double>> V;
-    InlinedVector<std::complex<double>> temp_output;
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                      is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, X, Y, axis, number_of_samples, inverse)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(ctx, X, Y, axis, number_of_samples,
+                                                                                    inverse)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -519,39 +560,29 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   // Get/create the output mutable data
   auto output_spectra_shape = onnxruntime::TensorShape({batch_size, n_dfts, dft_output_size, 2});
   auto Y = ctx->Output(0, output_spectra_shape);
-  auto Y_data = reinterpret_cast<T*>(Y->MutableDataRaw());
-
-  // Get/create the signal mutable data
-  auto* signal_data = const_cast<U*>(reinterpret_cast<const U*>(signal->DataRaw()));
-
-  // Define tensor shapes for each dft run
-  constexpr int64_t output_components = 2;
-  auto dft_input_shape = onnxruntime::TensorShape({1, window_size, signal_components});
-  auto dft_output_shape = onnxruntime::TensorShape({1, dft_output_size, output_components});
-
-  Tensor b_fft, chirp;
-  InlinedVector<std::complex<T>> V;
-  InlinedVector<std::complex<T>> temp_output;
-
-  // Run each dft of each batch as if it was a real-valued batch size 1 dft operation
-  for (int64_t batch_idx = 0; batch_idx < batch_size; batch_idx++) {
-    for (int64_t i = 0; i < n_dfts; i++) {
-      auto input_frame_begin =
-          signal_data + (batch_idx * signal_size * signal_components) + (i * frame_step * signal_components);
-
-      auto output_frame_begin = Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
-                                (i * dft_output_size * output_components);
-
-      // Tensors do not own the backing memory, so no worries on destruction
-      auto input = onnxruntime::Tensor(signal->DataType(), dft_input_shape, input_frame_begin, signal->Location(), 0);
-
-      auto output = onnxruntime::Tensor(Y->DataType(), dft_output_shape, output_frame_begin, Y->Location(), 0);
-
-      // Run individual dft
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
-                                                            false, V, temp_output)));
-    }
-  }
+  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+
+  // Get the signal and window data
+  const auto* signal_data = reinterpret_cast<const U*>(signal->DataRaw());
+  const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+
+  // Run the dfts of all the frames of all the batches with one plan
+  const DftPlan<T> plan(onnxruntime::narrow<size_t>(window_size), false, std::is_same_v<U, T>);
+  const auto total_dfts = batch_size * n_dfts;
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+      DftCost<T, U>(onnxruntime::narrow<size_t>(window_size), onnxruntime::narrow<size_t>(dft_output_size)),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        DftScratch<T> scratch;
+        for (std::ptrdiff_t dft_idx = first; dft_idx < last; dft_idx++) {
+          const int64_t batch_idx = dft_idx / n_dfts;
+          const int64_t i = dft_idx % n_dfts;
+          const U* input_frame_begin = signal_data + (batch_idx * signal_size) + (i * frame_step);
+          std::complex<T>* output_frame_begin = Y_data + dft_idx * dft_output_size;
+          plan.Compute(input_frame_begin, 1, onnxruntime::narrow<size_t>(window_size), window_data, output_frame_begin,
+                       1, onnxruntime::narrow<size_t>(dft_output_size), scratch);
+        }
+      });
 
   return Status::OK();
 }
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <type_traits>
 
@@ -15,6 +16,7 @@
 #include "core/framework/data_types.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
@@ -178,19 +180,48 @@ template <>
 struct EigenCastType<BFloat16> {
   using type = Eigen::bfloat16;
 };
+// Runs cast_range(begin, end) over ranges of the count elements of a tensor, in parallel when the tensor is large
+// enough for the intra-op thread pool of the kernel.
+template <typename SrcType, typename DstType, typename CastRange>
+void ParallelCast(const OpKernelContext& context, std::ptrdiff_t count, CastRange&& cast_range) {
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), count,
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      std::forward<CastRange>(cast_range));
+}
+
 // generic tensor X -> Y
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCaster {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     using SrcEigenCastType = typename EigenCastType<SrcType>::type;
     using DstEigenCastType = typename EigenCastType<DstType>::type;
 
     const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
-    const auto in_vector =
-        ConstEigenVectorMap<SrcEigenCastType>(reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>()), shape_size);
-    auto out_vector =
-        EigenVectorMap<DstEigenCastType>(reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>()), shape_size);
-    out_vector = in_vector.template cast<DstEigenCastType>();
+    const auto* in_data = reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>());
+    auto* out_data = reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>());
+    ParallelCast<SrcType, DstType>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      const auto in_vector = ConstEigenVectorMap<SrcEigenCastType>(in_data + begin, end - begin);
+      auto out_vector = EigenVectorMap<DstEigenCastType>(out_data + begin, end - begin);
+      out_vector = in_vector.template cast<DstEigenCastType>();
+    });
+  }
+};
+
+// tensor BFloat16 -> float
+// The bits of a bfloat16 are the upper half of the bits of its float, so the widening is a shift that is vectorized.
+template <>
+struct TensorCaster<BFloat16, float> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    const auto* in_data = in.Data<BFloat16>();
+    auto* out_data = out.MutableData<float>();
+    ParallelCast<BFloat16, float>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i < end; ++i) {
+        const uint32_t bits = static_cast<uint32_t>(in_data[i].val) << 16;
+        std::memcpy(out_data + i, &bits, sizeof(bits));
+      }
+    });
   }
 };
 
@@ -225,13 +256,15 @@ struct TensorCaster<std::string, DstType> {
 // tensor X -> float 8
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCasterNoSat {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
     const auto* in_data = in.Data<SrcType>();
     auto* out_data = out.MutableData<DstType>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      out_data[i] = DstType(static_cast<float>(in_data[i]), false);
-    }
+    ParallelCast<SrcType, DstType>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i < end; ++i) {
+        out_data[i] = DstType(static_cast<float>(in_data[i]), false);
+      }
+    });
   }
 };
 
@@ -259,11 +292,13 @@ struct TensorCasterNoSat<std::string, DstType> {
 // tensor MLFloat16 -> float
 template <>
 struct TensorCaster<MLFloat16, float> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     auto out_data = out.MutableData<float>();
     auto in_data = in.Data<MLFloat16>();
-    const size_t shape_size = narrow<size_t>(shape.Size());
-    MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
+    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+    ParallelCast<MLFloat16, float>(context, shape_size, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertHalfToFloatBuffer(&in_data[begin].val, out_data + begin, narrow<size_t>(end - begin));
+    });
   }
 };
 
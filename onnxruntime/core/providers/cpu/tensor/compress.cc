@@ -50,7 +50,7 @@ Status Compress::Compute(OpKernelContext* ctx) const {
     }
   }
 
-  std::vector<int64_t> output_dims(input_dimensions.begin(), input_dimensions.end());
+  TensorShapeVector output_dims(input_dimensions.begin(), input_dimensions.end());
   if (has_axis_) {
     output_dims[onnxruntime::narrow<size_t>(axis)] = positive_condition_count;
   } else {
@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/concat.h"
 
+#include <algorithm>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/copy.h"
@@ -252,6 +254,40 @@ Status ConcatBase::ComputeImpl(Prepare& p, OpKernelContext* ctx) const {
   int input_count = static_cast<int>(p.inputs.size());
   int64_t initial_output_offset = 0;  // initial offset for each input
 
+  // when the dimensions before the axis are all 1, e.g. for a sequence of tensors concatenated along axis 0, each
+  // input is a contiguous block of the output. copy the blocks in parallel across the inputs, as a strided copy
+  // for each of many small inputs is mostly dispatch overhead.
+  const auto output_dims = p.output_tensor->Shape().GetDims();
+  if (!p.is_string_type &&
+      std::all_of(output_dims.begin(), output_dims.begin() + onnxruntime::narrow<ptrdiff_t>(p.axis),
+                  [](int64_t dim) { return dim == 1; })) {
+    const size_t element_size = p.output_tensor->DataType()->Size();
+    InlinedVector<size_t, Prepare::kExpectedNumberOfInputs> output_offsets;
+    output_offsets.reserve(input_count);
+    size_t output_offset = 0;
+    for (const auto& prep : p.inputs) {
+      output_offsets.push_back(output_offset);
+      output_offset += onnxruntime::narrow<size_t>(prep.num_elements) * element_size;
+    }
+
+    auto* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+    const auto bytes_per_input = static_cast<double>(output_offset) / input_count;
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), input_count, {bytes_per_input, bytes_per_input, 1.0},
+        [&p, &output_offsets, output, element_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t input_index = first; input_index < last; ++input_index) {
+            const auto& prep = p.inputs[input_index];
+            // the allocation planner may have produced the input in its place in the output already
+            if (prep.num_elements != 0 && prep.tensor->DataRaw() != output + output_offsets[input_index]) {
+              memcpy(output + output_offsets[input_index], prep.tensor->DataRaw(),
+                     onnxruntime::narrow<size_t>(prep.num_elements) * element_size);
+            }
+          }
+        });
+
+    return Status::OK();
+  }
+
   auto output_strides_full = StridesForTensor(*p.output_tensor);
   // Note that output_strides_full is only used later when is_stack_ is true, so it's safe to move
   auto output_strides_for_copy = is_stack_ ? StridesForStack(output_strides_full, p.axis) : std::move(output_strides_full);
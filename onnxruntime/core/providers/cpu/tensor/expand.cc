@@ -7,19 +7,25 @@
 
 namespace onnxruntime {
 
-#define REG_EXPAND_KERNEL(TYPE)                                                    \
-  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                        \
-      Expand,                                                                      \
-      8,                                                                           \
-      12,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
-      Expand<TYPE>);                                                               \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      Expand,                                                                      \
-      13,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder().MayStridedOutput(0, 0)
+#else
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder()
+#endif
+
+#define REG_EXPAND_KERNEL(TYPE)                                                          \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                              \
+      Expand,                                                                            \
+      8,                                                                                 \
+      12,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      Expand<TYPE>);                                                                     \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                        \
+      Expand,                                                                            \
+      13,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       Expand<TYPE>);
 
 REG_EXPAND_KERNEL(float)
@@ -35,6 +41,29 @@ REG_EXPAND_KERNEL(uint64_t)
 REG_EXPAND_KERNEL(bool)
 REG_EXPAND_KERNEL(MLFloat16)
 
+#ifdef ENABLE_STRIDED_TENSORS
+namespace {
+// The strides of the view of the input with the output shape: the broadcast dimensions have a stride of 0.
+TensorShapeVector ComputeExpandedStrides(const TensorShape& input_shape, gsl::span<const int64_t> input_strides,
+                                         const TensorShape& output_shape) {
+  const size_t rank = output_shape.NumDimensions();
+  const size_t input_rank = input_shape.NumDimensions();
+  TensorShapeVector output_strides(rank, 0);
+  if (input_rank == 0 || input_shape.Size() == 1) {
+    return output_strides;
+  }
+
+  const size_t offset = rank - input_rank;
+  for (size_t dim = offset; dim < rank; ++dim) {
+    if (input_shape[dim - offset] == output_shape[dim]) {
+      output_strides[dim] = input_strides[dim - offset];
+    }
+  }
+  return output_strides;
+}
+}  // namespace
+#endif
+
 template <typename T>
 Status Expand<T>::Compute(OpKernelContext* context) const {
   const auto* input_tensor = context->Input<Tensor>(0);
@@ -46,7 +75,7 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
 
   const auto* shape_tensor = context->Input<Tensor>(1);
   const auto* shape_dims = shape_tensor->Data<int64_t>();
-  std::vector<int64_t> output_shape{shape_dims, shape_dims + shape_tensor->Shape().Size()};
+  TensorShapeVector output_shape(shape_dims, shape_dims + shape_tensor->Shape().Size());
 
   if (input_shape.size() > output_shape.size()) {
     output_shape.insert(output_shape.begin(), input_shape.size() - output_shape.size(), 1);
@@ -69,6 +98,15 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
 
   TensorShape output_tensor_shape(output_shape);
   auto* output_tensor = context->Output(0, output_tensor_shape);
+#ifdef ENABLE_STRIDED_TENSORS
+  // The planner makes the output a view of the input when all of its consumers read strided tensors.
+  if (output_tensor->DataRaw() == input_tensor->DataRaw()) {
+    output_tensor->SetShapeAndStrides(output_tensor_shape,
+                                      ComputeExpandedStrides(input_tensor->Shape(), input_tensor->Strides(),
+                                                             output_tensor_shape));
+    return Status::OK();
+  }
+#endif
   auto* output_data = output_tensor->MutableData<T>();
   auto* output_dims = output_shape.data();
   auto output_dims_size = static_cast<int64_t>(output_shape.size());
@@ -79,9 +117,9 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
     return Status::OK();
   }
 
-  std::unique_ptr<int64_t[]> input_dim_group = std::make_unique<int64_t[]>(onnxruntime::narrow<size_t>(max_dims_size));
-  std::unique_ptr<int64_t[]> output_dim_group = std::make_unique<int64_t[]>(onnxruntime::narrow<size_t>(max_dims_size));
-  std::unique_ptr<int64_t[]> expand_dim_size = std::make_unique<int64_t[]>(onnxruntime::narrow<size_t>(max_dims_size));
+  TensorShapeVector input_dim_group(onnxruntime::narrow<size_t>(max_dims_size));
+  TensorShapeVector output_dim_group(onnxruntime::narrow<size_t>(max_dims_size));
+  TensorShapeVector expand_dim_size(onnxruntime::narrow<size_t>(max_dims_size));
   auto dim_group_start = max_dims_size;
 
   for (int64_t input_dims_iter = input_dims_size - 1,
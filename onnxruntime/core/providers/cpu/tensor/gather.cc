@@ -3,6 +3,7 @@
 
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+#include "core/providers/cpu/tensor/gather_rows.h"
 #include "core/common/common.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
@@ -65,7 +66,7 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   const auto input_rank = input_data_shape.NumDimensions();
   p.axis = HandleNegativeAxis(axis_, narrow<int64_t>(input_rank));
 
-  std::vector<int64_t> shape;
+  TensorShapeVector shape;
   shape.reserve(input_rank - 1 + indices_shape.NumDimensions());
 
   // replace the dimension for p.axis with the shape from the indices
@@ -78,7 +79,7 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   for (int64_t i = p.axis + 1; i < static_cast<int64_t>(input_rank); ++i)
     shape.push_back(input_data_shape[narrow<size_t>(i)]);
 
-  p.output_tensor = context->Output(0, TensorShape(std::move(shape)));
+  p.output_tensor = context->Output(0, TensorShape(shape));
 
   return Status::OK();
 }
@@ -117,12 +118,25 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
       reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
           reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
     } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
+      gather_rows::CopyRow(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
     }
   };
+
+  // The rows of the next indices are prefetched while the current row is copied, e.g. the rows of an embedding
+  // table looked up by a large batch of indices.
+  auto prefetch = [&](int64_t index) {
+    int64_t batch = index / N;
+    Tin idx = indices_data[index % N];
+    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+    gather_rows::PrefetchRow(src_base + batch * data_batch_bytes + idx * block_size, narrow<size_t>(block_size));
+  };
+
   concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
+                                          [&lambda, &prefetch, is_string_type](ptrdiff_t first, ptrdiff_t last) {
+                                            for (ptrdiff_t index = first; index < last; ++index) {
+                                              if (!is_string_type && index + gather_rows::kPrefetchDistance < last) {
+                                                prefetch(index + gather_rows::kPrefetchDistance);
+                                              }
                                               lambda(index);
                                             }
                                           });
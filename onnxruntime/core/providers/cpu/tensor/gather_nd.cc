@@ -68,7 +68,7 @@ Status GatherNDBase::PrepareForCompute(const TensorShape& input_shape, const Ten
   const auto num_batches = input_shape.SizeToDimension(SafeInt<size_t>(batch_dims_));
   const auto input_batch_stride = input_shape.SizeFromDimension(SafeInt<size_t>(batch_dims_));
   const auto num_slices_per_batch = num_slices / num_batches;
-  std::vector<int64_t> sizes_from_slice_dims(onnxruntime::narrow<size_t>(num_slice_dims));
+  TensorShapeVector sizes_from_slice_dims(onnxruntime::narrow<size_t>(num_slice_dims));
   for (int64_t i = 0; i < num_slice_dims; ++i) {
     sizes_from_slice_dims[onnxruntime::narrow<size_t>(i)] = input_shape.SizeFromDimension(SafeInt<size_t>(batch_dims_) + i + 1);
   }
@@ -142,11 +142,11 @@ Status GatherND::Compute(OpKernelContext* context) const {
                            "last dimension of indices must not be larger than rank of input tensor");
   }
 
-  std::vector<int64_t> shape(indices_shape.GetDims().begin(), indices_shape.GetDims().end() - 1);
+  TensorShapeVector shape(indices_shape.GetDims().begin(), indices_shape.GetDims().end() - 1);
   shape.insert(shape.end(), input_shape.GetDims().begin() + onnxruntime::narrow<std::ptrdiff_t>(last_indices_dimension),
                input_shape.GetDims().end());
 
-  auto* output_tensor = context->Output(0, TensorShape(std::move(shape)));
+  auto* output_tensor = context->Output(0, TensorShape(shape));
 
   // Bail out early in case the output is going to be empty
   if (output_tensor->Shape().Size() == 0) {
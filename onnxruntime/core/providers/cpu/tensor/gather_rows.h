@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace onnxruntime {
+namespace gather_rows {
+
+// Number of rows ahead of the current one whose data is prefetched. The rows of an embedding table selected by the
+// indices are scattered, so the copies are bound by the memory latency rather than by the bandwidth unless the loads
+// of the next rows are issued early.
+constexpr std::ptrdiff_t kPrefetchDistance = 8;
+
+inline void PrefetchRow(const void* row, size_t row_bytes) {
+  // The first cache lines are enough to hide the latency, the hardware prefetcher follows the rest of the row.
+  constexpr size_t kMaxPrefetchBytes = 256;
+  const char* data = static_cast<const char*>(row);
+  const size_t bytes = row_bytes < kMaxPrefetchBytes ? row_bytes : kMaxPrefetchBytes;
+  for (size_t offset = 0; offset < bytes; offset += 64) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(data + offset, 0, 0);
+#elif defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+    _mm_prefetch(data + offset, _MM_HINT_NTA);
+#else
+    (void)data;
+#endif
+  }
+}
+
+// Copies a row of bytes. The small row sizes of the embedding tables are dispatched to copies of a constant size,
+// which the compilers inline as a few vector loads and stores instead of calling memcpy for every row.
+inline void CopyRow(void* dst, const void* src, size_t row_bytes) {
+  switch (row_bytes) {
+    case 4:
+      std::memcpy(dst, src, 4);
+      break;
+    case 8:
+      std::memcpy(dst, src, 8);
+      break;
+    case 16:
+      std::memcpy(dst, src, 16);
+      break;
+    case 32:
+      std::memcpy(dst, src, 32);
+      break;
+    case 64:
+      std::memcpy(dst, src, 64);
+      break;
+    case 128:
+      std::memcpy(dst, src, 128);
+      break;
+    case 256:
+      std::memcpy(dst, src, 256);
+      break;
+    case 512:
+      std::memcpy(dst, src, 512);
+      break;
+    default:
+      std::memcpy(dst, src, row_bytes);
+      break;
+  }
+}
+
+}  // namespace gather_rows
+}  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/tensor/grid_sample.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/TensorSeq.h"
 #include "core/providers/common.h"
@@ -91,36 +94,48 @@ void GsGetCubicCoeffs(T x, T coeffs[4]) {
 }
 
 template <typename T>
-T GsBicubicInterpolate(T p[4][4], T x, T y) {
-  T v[4] = {};
-  T coeffs[4] = {};
-  GsGetCubicCoeffs(x, coeffs);
-  for (int64_t i = 0; i < 4; i++) {
-    v[i] = coeffs[0] * p[i][0] + coeffs[1] * p[i][1] + coeffs[2] * p[i][2] + coeffs[3] * p[i][3];
-  }
-  GsGetCubicCoeffs(y, coeffs);
-  return static_cast<T>(coeffs[0] * v[0] + coeffs[1] * v[1] + coeffs[2] * v[2] + coeffs[3] * v[3]);
-}
-
-template <typename T>
-T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
-  T pixel = {};  // default 0
+std::ptrdiff_t GridSample<T>::PixelOffset(int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
   if (padding_mode_ == Zeros) {
-    if (c >= 0 && c < W && r >= 0 && r < H) {
-      pixel = image[r * W + c];
+    if (c < 0 || c >= W || r < 0 || r >= H) {
+      return -1;
     }
   } else if (padding_mode_ == Border) {
     c = std::clamp<int64_t>(c, 0, W - 1);
     r = std::clamp<int64_t>(r, 0, H - 1);
-    pixel = image[r * W + c];
   } else {  // (padding_mode_ == Reflection)
     c = static_cast<int64_t>(GsReflect(static_cast<T>(c), border[0], border[2]));
     r = static_cast<int64_t>(GsReflect(static_cast<T>(r), border[1], border[3]));
-    pixel = image[r * W + c];
   }
-  return pixel;
+  return static_cast<std::ptrdiff_t>(r * W + c);
 }
 
+namespace {
+
+// The pixel at an offset given by PixelOffset.
+template <typename T>
+T PixelAt(const T* image, std::ptrdiff_t offset) {
+  return offset >= 0 ? image[offset] : T{};
+}
+
+// What a 2-D output location samples, computed once and used by all the channels.
+template <typename T>
+struct GsLinearSample {
+  std::ptrdiff_t offsets[4];  // (y1, x1), (y1, x2), (y2, x1), (y2, x2)
+  T dx1, dx2, dy1, dy2;
+};
+
+template <typename T>
+struct GsCubicSample {
+  std::ptrdiff_t offsets[4][4];  // [H][W]
+  T coeffs_x[4];
+  T coeffs_y[4];
+};
+
+// Output locations of a channel that are sampled at a time.
+constexpr std::ptrdiff_t kGsTileSize = 1024;
+
+}  // namespace
+
 template <typename T>
 T GridSample<T>::PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const {
   T pixel = {};  // default 0
@@ -203,62 +218,136 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, x_max, y_max};  // l-t-r-b
 
-    concurrency::ThreadPool* tp = H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
+    // What every output location samples is computed once per image, with the padding resolved, and is then
+    // applied to all the channels, a tile of output locations at a time.
+    concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+    const auto num_locations = onnxruntime::narrow<std::ptrdiff_t>(H_out * W_out);
+    const std::ptrdiff_t num_tiles = (num_locations + kGsTileSize - 1) / kGsTileSize;
+    const std::ptrdiff_t num_units = onnxruntime::narrow<std::ptrdiff_t>(C) * num_tiles;
+
+    std::vector<std::ptrdiff_t> nearest_samples;
+    std::vector<GsLinearSample<T>> linear_samples;
+    std::vector<GsCubicSample<T>> cubic_samples;
+    if (mode_ == Nearest) {
+      nearest_samples.resize(num_locations);
+    } else if (mode_ == Linear) {
+      linear_samples.resize(num_locations);
+    } else {
+      cubic_samples.resize(num_locations);
+    }
+
     for (int64_t n = 0; n < N; n++) {
       const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
-
-            for (int64_t oy = 0; oy < H_out; oy++) {
-              for (int64_t ox = 0; ox < W_out; ox++) {
-                const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
-                T* Y_gridpoint = Y_data + oy * W_out + ox;
-                auto nx = gridpoint[0];  // normalized location
-                auto ny = gridpoint[1];
-                auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-
-                if (mode_ == Nearest) {
-                  x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                  y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                  // x, y are integers in all padding modes
-                  *Y_gridpoint = PixelAtGrid(X_data, static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
-                } else if (mode_ == Linear) {
-                  int64_t x1 = static_cast<int64_t>(std::floor(x));
-                  int64_t y1 = static_cast<int64_t>(std::floor(y));
-                  int64_t x2 = x1 + 1;
-                  int64_t y2 = y1 + 1;
-
-                  T p11 = PixelAtGrid(X_data, y1, x1, H_in, W_in, border);
-                  T p12 = PixelAtGrid(X_data, y1, x2, H_in, W_in, border);
-                  T p21 = PixelAtGrid(X_data, y2, x1, H_in, W_in, border);
-                  T p22 = PixelAtGrid(X_data, y2, x2, H_in, W_in, border);
-
-                  T dx2 = static_cast<T>(x2) - x;
-                  T dx1 = x - static_cast<T>(x1);
-                  T dy2 = static_cast<T>(y2) - y;
-                  T dy1 = y - static_cast<T>(y1);
-                  *Y_gridpoint = dy2 * (dx2 * p11 + dx1 * p12) + dy1 * (dx2 * p21 + dx1 * p22);
-                } else if (mode_ == Cubic) {
-                  int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
-                  int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
-
-                  T p[4][4] = {};  // [H][W]
-                  for (int64_t h = 0; h < 4; h++) {
-                    for (int64_t w = 0; w < 4; w++) {
-                      p[h][w] = PixelAtGrid(X_data, h + y0, w + x0, H_in, W_in, border);
-                    }
-                  }
-                  T dx = static_cast<T>(x - x0 - 1);
-                  T dy = static_cast<T>(y - y0 - 1);
-                  *Y_gridpoint = GsBicubicInterpolate(p, dx, dy);
-                }
+
+      // compute(i, x, y) fills the sampling table of output location i, which samples the input at (x, y)
+      auto for_each_location = [&](size_t sample_size, const auto& compute) {
+        const TensorOpCost cost{static_cast<double>(2 * sizeof(T)), static_cast<double>(sample_size), 50.0};
+        concurrency::ThreadPool::TryParallelFor(
+            tp, num_locations, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+              for (std::ptrdiff_t i = first; i < last; i++) {
+                const T* gridpoint = grid_data + i * 2;
+                auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+                auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+                compute(i, x, y);
+              }
+            });
+      };
+
+      // sample(X_data, Y_data, first, last) computes the output locations [first, last) of a channel
+      auto for_each_tile = [&](size_t sample_size, size_t pixels_per_sample, const auto& sample) {
+        const double tile_size = static_cast<double>(kGsTileSize);
+        const TensorOpCost cost{static_cast<double>(sample_size + pixels_per_sample * sizeof(T)) * tile_size,
+                                static_cast<double>(sizeof(T)) * tile_size,
+                                static_cast<double>(2 * pixels_per_sample) * tile_size};
+        concurrency::ThreadPool::TryParallelFor(
+            tp, num_units, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+              for (std::ptrdiff_t unit = first; unit < last; unit++) {
+                const int64_t c = unit / num_tiles;
+                const std::ptrdiff_t first_location = (unit % num_tiles) * kGsTileSize;
+                const std::ptrdiff_t last_location = std::min(first_location + kGsTileSize, num_locations);
+                const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
+                T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
+                sample(X_data, Y_data, first_location, last_location);
               }
+            });
+      };
+
+      if (mode_ == Nearest) {
+        for_each_location(sizeof(std::ptrdiff_t), [&](std::ptrdiff_t i, T x, T y) {
+          x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
+          y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
+          // x, y are integers in all padding modes
+          nearest_samples[i] = PixelOffset(static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
+        });
+        for_each_tile(sizeof(std::ptrdiff_t), 1,
+                      [&](const T* X_data, T* Y_data, std::ptrdiff_t first, std::ptrdiff_t last) {
+                        const std::ptrdiff_t* samples = nearest_samples.data();
+                        for (std::ptrdiff_t i = first; i < last; i++) {
+                          Y_data[i] = PixelAt(X_data, samples[i]);
+                        }
+                      });
+      } else if (mode_ == Linear) {
+        for_each_location(sizeof(GsLinearSample<T>), [&](std::ptrdiff_t i, T x, T y) {
+          int64_t x1 = static_cast<int64_t>(std::floor(x));
+          int64_t y1 = static_cast<int64_t>(std::floor(y));
+          int64_t x2 = x1 + 1;
+          int64_t y2 = y1 + 1;
+
+          auto& sample = linear_samples[i];
+          sample.offsets[0] = PixelOffset(y1, x1, H_in, W_in, border);
+          sample.offsets[1] = PixelOffset(y1, x2, H_in, W_in, border);
+          sample.offsets[2] = PixelOffset(y2, x1, H_in, W_in, border);
+          sample.offsets[3] = PixelOffset(y2, x2, H_in, W_in, border);
+          sample.dx2 = static_cast<T>(x2) - x;
+          sample.dx1 = x - static_cast<T>(x1);
+          sample.dy2 = static_cast<T>(y2) - y;
+          sample.dy1 = y - static_cast<T>(y1);
+        });
+        for_each_tile(sizeof(GsLinearSample<T>), 4,
+                      [&](const T* X_data, T* Y_data, std::ptrdiff_t first, std::ptrdiff_t last) {
+                        const GsLinearSample<T>* samples = linear_samples.data();
+                        for (std::ptrdiff_t i = first; i < last; i++) {
+                          const auto& sample = samples[i];
+                          T p11 = PixelAt(X_data, sample.offsets[0]);
+                          T p12 = PixelAt(X_data, sample.offsets[1]);
+                          T p21 = PixelAt(X_data, sample.offsets[2]);
+                          T p22 = PixelAt(X_data, sample.offsets[3]);
+                          Y_data[i] = sample.dy2 * (sample.dx2 * p11 + sample.dx1 * p12) +
+                                      sample.dy1 * (sample.dx2 * p21 + sample.dx1 * p22);
+                        }
+                      });
+      } else if (mode_ == Cubic) {
+        for_each_location(sizeof(GsCubicSample<T>), [&](std::ptrdiff_t i, T x, T y) {
+          int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
+          int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
+
+          auto& sample = cubic_samples[i];
+          for (int64_t h = 0; h < 4; h++) {
+            for (int64_t w = 0; w < 4; w++) {
+              sample.offsets[h][w] = PixelOffset(h + y0, w + x0, H_in, W_in, border);
             }
-          });
+          }
+          GsGetCubicCoeffs(static_cast<T>(x - x0 - 1), sample.coeffs_x);
+          GsGetCubicCoeffs(static_cast<T>(y - y0 - 1), sample.coeffs_y);
+        });
+        for_each_tile(sizeof(GsCubicSample<T>), 16,
+                      [&](const T* X_data, T* Y_data, std::ptrdiff_t first, std::ptrdiff_t last) {
+                        const GsCubicSample<T>* samples = cubic_samples.data();
+                        for (std::ptrdiff_t i = first; i < last; i++) {
+                          const auto& sample = samples[i];
+                          const T* coeffs = sample.coeffs_x;
+                          T v[4];
+                          for (int64_t h = 0; h < 4; h++) {
+                            const std::ptrdiff_t* offsets = sample.offsets[h];
+                            v[h] = coeffs[0] * PixelAt(X_data, offsets[0]) + coeffs[1] * PixelAt(X_data, offsets[1]) +
+                                   coeffs[2] * PixelAt(X_data, offsets[2]) + coeffs[3] * PixelAt(X_data, offsets[3]);
+                          }
+                          coeffs = sample.coeffs_y;
+                          Y_data[i] = static_cast<T>(coeffs[0] * v[0] + coeffs[1] * v[1] + coeffs[2] * v[2] +
+                                                     coeffs[3] * v[3]);
+                        }
+                      });
+      }
     }
   } else if (data_dims == 3) {
     // sample 3d;
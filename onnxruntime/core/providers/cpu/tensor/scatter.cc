@@ -11,6 +11,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/scatter_utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #if defined(ENABLE_TRAINING_OPS)
 #include "orttraining/training_ops/cpu/tensor/gather_elements_grad_impl.h"
@@ -266,7 +267,7 @@ template <class Tdata, typename FuncT>
 Status ScatterData(
     const FuncT& func,
     const Tensor* data_input, const std::vector<int64_t>& indices_data, const Tensor* updates_input, int64_t axis,
-    Tensor* data_output) {
+    Tensor* data_output, concurrency::ThreadPool* tp) {
   const TensorShape& input_data_shape = data_input->Shape();
 
   const auto input_elements = input_data_shape.Size();
@@ -336,7 +337,8 @@ Status ScatterData(
   }
 
   const auto* update_data = static_cast<const Tdata*>(updates_input->DataRaw());
-  // For every update we compute the destination offset and copy it there
+  // For every update we compute the destination offset
+  std::vector<size_t> dst_offsets(narrow<size_t>(num_indices));
   for (int64_t index = 0; index < num_indices;) {
     const auto axis_idx = indices_data[narrow<size_t>(index)];
 
@@ -352,7 +354,7 @@ Status ScatterData(
       }
     }
 
-    func(dst_base + dst_offset, update_data + index);
+    dst_offsets[narrow<size_t>(index)] = dst_offset;
 
     if (++index == num_indices) {
       break;
@@ -371,28 +373,32 @@ Status ScatterData(
       dim_counters[narrow<size_t>(i)] = 0;
     }
   }
+
+  // Then apply the updates. The ones that go to the same element are applied in order.
+  ParallelScatterBySlot(tp, dst_offsets, narrow<size_t>(input_elements), 1.,
+                        [&](size_t index) { func(dst_base + dst_offsets[index], update_data + index); });
   return Status::OK();
 }
 
 template <typename TData>
 struct ScatterDataDispatchTarget {
   Status operator()(const Tensor* data_input, const std::vector<int64_t>& indices_data, const Tensor* updates_input, int64_t axis,
-                    const std::string& reduction, Tensor* data_output) const {
+                    const std::string& reduction, Tensor* data_output, concurrency::ThreadPool* tp) const {
     if (reduction == "add")
       return ScatterData<TData>(
-          Func_Add<TData>(), data_input, indices_data, updates_input, axis, data_output);
+          Func_Add<TData>(), data_input, indices_data, updates_input, axis, data_output, tp);
     else if (reduction == "mul")
       return ScatterData<TData>(
-          Func_Mul<TData>(), data_input, indices_data, updates_input, axis, data_output);
+          Func_Mul<TData>(), data_input, indices_data, updates_input, axis, data_output, tp);
     else if (reduction == "min")
       return ScatterData<TData>(
-          Func_Min<TData>(), data_input, indices_data, updates_input, axis, data_output);
+          Func_Min<TData>(), data_input, indices_data, updates_input, axis, data_output, tp);
     else if (reduction == "max")
       return ScatterData<TData>(
-          Func_Max<TData>(), data_input, indices_data, updates_input, axis, data_output);
+          Func_Max<TData>(), data_input, indices_data, updates_input, axis, data_output, tp);
     else  // if (reduction == "none")
       return ScatterData<TData>(
-          Func_Assignment<TData>(), data_input, indices_data, updates_input, axis, data_output);
+          Func_Assignment<TData>(), data_input, indices_data, updates_input, axis, data_output, tp);
   }
 };
 
@@ -462,7 +468,7 @@ Status Scatter<EnabledDataTypes>::Compute(OpKernelContext* context) const {
 
   utils::MLTypeCallDispatcherFromTypeList<EnabledDataTypes> dispatcher{data_type};
   status = dispatcher.template InvokeRet<Status, ScatterDataDispatchTarget>(
-      data_input, indices_data, updates_input, axis, this->reduction_, data_output);
+      data_input, indices_data, updates_input, axis, this->reduction_, data_output, context->GetOperatorThreadPool());
 
   return status;
 }
@@ -483,7 +489,7 @@ Status GatherElementsGradImpl(const Tensor* indices_input, const Tensor* updates
                               const int64_t axis, Tensor* data_output) {
   std::vector<int64_t> indices_data{};
   ORT_RETURN_IF_ERROR(GetIndices<Tin>(*data_output, *indices_input, axis, indices_data));
-  return ScatterData<Tdata>(Func_Add<Tdata>(), data_output, indices_data, updates_input, axis, data_output);
+  return ScatterData<Tdata>(Func_Add<Tdata>(), data_output, indices_data, updates_input, axis, data_output, nullptr);
 }
 
 #define GATHER_ELEMENTS_GRAD_IMPL_SPECIALIZED(Tin, Tdata) \
@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
+#include "core/providers/cpu/tensor/scatter_utils.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -25,6 +26,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     11,
     12,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("T",
                         BuildKernelDefConstraintsFromTypeList<EnabledScatterNDDataTypes>()),
     ScatterND);
@@ -34,6 +36,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     13,
     15,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("T",
                         BuildKernelDefConstraintsFromTypeList<EnabledScatterNDDataTypes>()),
     ScatterND);
@@ -43,6 +46,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     16,
     17,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("T",
                         BuildKernelDefConstraintsFromTypeList<EnabledScatterNDDataTypes>()),
     ScatterND);
@@ -51,6 +55,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     ScatterND,
     18,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("T",
                         BuildKernelDefConstraintsFromTypeList<EnabledScatterNDDataTypes>()),
     ScatterND);
@@ -396,13 +401,27 @@ struct ScatterNDDispatchTarget {
         } break;
       }
     };
-    concurrency::ThreadPool::TryParallelFor(
-        tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
-        [&lambda](ptrdiff_t first, ptrdiff_t last) {
-          for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-            lambda(i);
-          }
-        });
+
+    if (reduction == ScatterND::Reduction::None) {
+      // the indices of the updates don't repeat, so every update goes to a slice of its own
+      concurrency::ThreadPool::TryParallelFor(
+          tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
+          [&lambda](ptrdiff_t first, ptrdiff_t last) {
+            for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
+              lambda(i);
+            }
+          });
+    } else if (prepare.element_to_copy > 0) {
+      // the reductions combine the updates of the same slice, in order, so the slices are split between the threads
+      const auto num_slices = onnxruntime::narrow<size_t>(context->Input<Tensor>(0)->Shape().Size()) /
+                              onnxruntime::narrow<size_t>(prepare.element_to_copy);
+      std::vector<size_t> slices(prepare.element_offsets.size());
+      for (size_t i = 0; i < slices.size(); ++i) {
+        slices[i] = onnxruntime::narrow<size_t>(prepare.element_offsets[i] / prepare.element_to_copy);
+      }
+      ParallelScatterBySlot(tp, slices, num_slices, static_cast<double>(prepare.element_to_copy),
+                            [&lambda](size_t i) { lambda(static_cast<int64_t>(i)); });
+    }
     return Status::OK();
   }
 };
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+
+#include <gsl/gsl>
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+/**
+ * Applies the updates of a scatter op in parallel, without two threads ever writing the same element.
+ *
+ * Update i writes the destination slot slots[i], one of num_slots, and apply(i) applies it. The slots are split in
+ * ranges between the threads, and every thread goes over all the updates, in order, and applies the ones that write
+ * its range. The result is that of applying the updates one after another, even when several of them write the same
+ * slot, which is what the reductions of ScatterND and ScatterElements rely on.
+ *
+ * cost_per_update is the cost of apply(), in cycles.
+ */
+template <typename Apply>
+void ParallelScatterBySlot(concurrency::ThreadPool* tp, gsl::span<const size_t> slots, size_t num_slots,
+                           double cost_per_update, const Apply& apply) {
+  const size_t num_updates = slots.size();
+  const auto num_partitions = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp));
+  if (num_partitions <= 1 || num_updates <= 1 || num_slots <= 1) {
+    for (size_t i = 0; i < num_updates; ++i) {
+      apply(i);
+    }
+    return;
+  }
+
+  // every partition reads all the slots and applies its share of the updates
+  const TensorOpCost cost{static_cast<double>(num_updates * sizeof(size_t)), 0,
+                          static_cast<double>(num_updates) * (1. + cost_per_update / num_partitions)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_partitions), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const size_t begin = num_slots * static_cast<size_t>(first) / num_partitions;
+        const size_t end = num_slots * static_cast<size_t>(last) / num_partitions;
+        for (size_t i = 0; i < num_updates; ++i) {
+          if (slots[i] >= begin && slots[i] < end) {
+            apply(i);
+          }
+        }
+      });
+}
+
+}  // namespace onnxruntime
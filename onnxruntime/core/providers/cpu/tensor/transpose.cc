@@ -4,6 +4,7 @@
 #include "core/providers/cpu/tensor/transpose.h"
 
 #include <memory>
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/utils.h"
 #include "core/framework/transpose_helper.h"
@@ -58,9 +59,9 @@ using EnabledDataTypesOpset21 = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST(kCpuExecutio
 
 struct MultiIndex {
   size_t n_axes;
-  std::vector<size_t> index;
-  std::vector<size_t> upper_bound;
-  std::vector<int64_t> stride;
+  InlinedVector<size_t> index;
+  InlinedVector<size_t> upper_bound;
+  TensorShapeVector stride;
 
   /* There is one MultiIndex instance per axis in the tensor.
    * The array keeps track of the position of a pointer walking through the data.
@@ -367,6 +368,10 @@ static Status TransposeImpl(const gsl::span<const size_t>& permutations, const T
     return Status::OK();
   }
 
+  if (BlockedTranspose(permutations, input, output, input_shape_override, tp)) {
+    return Status::OK();
+  }
+
   // fall back to default implementation
   return DoUntypedTranspose(permutations, input, output, input_shape_override);
 }
@@ -450,21 +455,46 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // A strided input, e.g. a view made by Expand, is copied through its permuted strides.
+  if (!X.IsContiguous()) {
+    const auto input_strides = X.Strides();
+    TensorShapeVector src_strides(rank);
+    TensorShapeVector dst_strides(rank);
+    int64_t dst_stride = 1;
+    for (size_t i = rank; i > 0; --i) {
+      src_strides[i - 1] = input_strides[(*p_perm)[i - 1]];
+      dst_strides[i - 1] = dst_stride;
+      dst_stride *= output_dims[i - 1];
+    }
+    return DispatchStridedCopy<EnabledDataTypesAllOpsets>(ctx->GetOperatorThreadPool(), Y, 0, dst_strides,
+                                                          output_shape, X, 0, src_strides);
+  }
+#endif
+
   return DoTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool());
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder().MayStridedInput(0)
+#else
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    CREATE_TRANSPOSE_KERNEL_DEF.TypeConstraint("T",
+                                               BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     13,
     20,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    CREATE_TRANSPOSE_KERNEL_DEF.TypeConstraint("T",
+                                               BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 // Opset 21 added support for float8e4m3fnuz, float8e5m2, float8e5m2fnuz, int4 and uint4.
@@ -472,7 +502,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     21,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
+    CREATE_TRANSPOSE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
     Transpose);
 
 }  // namespace onnxruntime
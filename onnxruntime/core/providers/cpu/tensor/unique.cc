@@ -2,9 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/unique.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <numeric>
 #include <core/common/safeint.h>
 #include <gsl/gsl>
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
 #include "core/providers/op_kernel_type_control.h"
@@ -144,61 +148,72 @@ class Subtensor {
   std::vector<T> items_;
 };
 
+// unique values compare with operator<, with the NaNs after all the other values
+template <typename T>
+static bool UniqueValueLess(const T& lhs, const T& rhs) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return !std::isnan(lhs) && (std::isnan(rhs) || lhs < rhs);
+  } else {
+    return lhs < rhs;
+  }
+}
+
 template <typename T>
 static void CreateFlattenedOutput(OpKernelContext& context,
-                                  const std::map<const T, int64_t>& offsets,         // map sorted key to unsorted idx
-                                  const std::vector<std::vector<int64_t>>& indices,  // unsorted
+                                  const InlinedHashMap<T, int64_t>& unique_indices,  // map value to unsorted idx
+                                  const std::vector<int64_t>& first_indices,         // unsorted
+                                  const std::vector<int64_t>& unique_counts,         // unsorted
                                   const std::vector<int64_t>& inverse_index,         // unsorted
                                   bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
-  Tensor& Y = *context.Output(0, {num_unique});
-  Tensor* indices_out = context.Output(1, {num_unique});
+  const size_t num_unique = first_indices.size();
+  Tensor& Y = *context.Output(0, {static_cast<int64_t>(num_unique)});
+  Tensor* indices_out = context.Output(1, {static_cast<int64_t>(num_unique)});
   Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(inverse_index.size())});
-  Tensor* counts = context.Output(3, {num_unique});
+  Tensor* counts = context.Output(3, {static_cast<int64_t>(num_unique)});
 
-  auto Y_data = Y.MutableDataAsSpan<T>();
-  gsl::span<int64_t> indices_data = indices_out != nullptr ? indices_out->MutableDataAsSpan<int64_t>()
-                                                           : gsl::span<int64_t>();
-  gsl::span<int64_t> inverse_indices_data = inverse_indices != nullptr ? inverse_indices->MutableDataAsSpan<int64_t>()
-                                                                       : gsl::span<int64_t>();
-  gsl::span<int64_t> counts_data = counts != nullptr ? counts->MutableDataAsSpan<int64_t>()
-                                                     : gsl::span<int64_t>();
+  // the values in the order of their first occurrence. the map doesn't change anymore so its elements don't move.
+  std::vector<const T*> values(num_unique);
+  for (const auto& entry : unique_indices) {
+    values[onnxruntime::narrow<size_t>(entry.second)] = &entry.first;
+  }
 
-  // iterate using 'offsets' which is sorted, but contains the offset of the unsorted entry
-  auto offsets_iter = offsets.begin();
-  for (int64_t i = 0, end = num_unique; i < end; ++i, ++offsets_iter) {
-    // write sequentially if we want sorted output, use the unsorted_idx if not
-    auto unsorted_idx = offsets_iter->second;
-    auto output_idx = sorted ? i : unsorted_idx;
+  // the unsorted idx of each output. only the unique values are sorted, not the whole input.
+  std::vector<int64_t> order(num_unique);
+  std::iota(order.begin(), order.end(), int64_t{0});
+  if (sorted) {
+    std::sort(order.begin(), order.end(), [&values](int64_t lhs, int64_t rhs) {
+      return UniqueValueLess(*values[onnxruntime::narrow<size_t>(lhs)], *values[onnxruntime::narrow<size_t>(rhs)]);
+    });
+  }
 
-    Y_data[onnxruntime::narrow<size_t>(output_idx)] = offsets_iter->first;
+  auto Y_data = Y.MutableDataAsSpan<T>();
+  for (size_t i = 0; i < num_unique; ++i) {
+    const auto unsorted_idx = onnxruntime::narrow<size_t>(order[i]);
+    Y_data[i] = *values[unsorted_idx];
 
     if (indices_out) {
-      indices_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].front();
+      indices_out->MutableData<int64_t>()[i] = first_indices[unsorted_idx];
     }
 
     if (counts) {
-      counts_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].size();
+      counts->MutableData<int64_t>()[i] = unique_counts[unsorted_idx];
     }
   }
 
   if (inverse_indices) {
+    int64_t* inverse_indices_data = inverse_indices->MutableData<int64_t>();
     if (sorted) {
       // need to convert unsorted entries in the inverse index to their sorted values
-      std::vector<int64_t> unsorted_to_sorted;
-      unsorted_to_sorted.resize(onnxruntime::narrow<size_t>(num_unique));
-      int64_t sorted_idx = 0;
-      for (const auto& offset : offsets) {
-        unsorted_to_sorted[onnxruntime::narrow<size_t>(offset.second)] = sorted_idx++;
+      std::vector<int64_t> unsorted_to_sorted(num_unique);
+      for (size_t i = 0; i < num_unique; ++i) {
+        unsorted_to_sorted[onnxruntime::narrow<size_t>(order[i])] = static_cast<int64_t>(i);
       }
 
       for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[onnxruntime::narrow<size_t>(i)] = unsorted_to_sorted[onnxruntime::narrow<size_t>(inverse_index[i])];
+        inverse_indices_data[i] = unsorted_to_sorted[onnxruntime::narrow<size_t>(inverse_index[i])];
       }
     } else {
-      for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[i] = inverse_index[i];
-      }
+      std::copy(inverse_index.begin(), inverse_index.end(), inverse_indices_data);
     }
   }
 }
@@ -308,30 +323,27 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
   auto data = input.DataAsSpan<T>();
 
   if (flatten_) {
-    std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
-    std::vector<std::vector<int64_t>> indices;
+    // the values are hashed in the order of their first occurrence, and only the unique values are sorted
+    InlinedHashMap<T, int64_t> unique_indices;  // unsorted idx of each unique value
+    std::vector<int64_t> first_indices;
+    std::vector<int64_t> unique_counts;
     std::vector<int64_t> inverse_index;
 
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
     inverse_index.reserve(data.size());
 
-    int64_t num_unique = 0;
-
     for (int64_t i = 0, end = input.Shape().Size(); i < end; ++i) {
-      auto entry = offsets.find(data[onnxruntime::narrow<size_t>(i)]);
-      if (entry == offsets.end()) {
-        offsets[data[onnxruntime::narrow<size_t>(i)]] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
+      const auto num_unique = static_cast<int64_t>(first_indices.size());
+      auto entry = unique_indices.try_emplace(data[onnxruntime::narrow<size_t>(i)], num_unique);
+      if (entry.second) {
+        first_indices.push_back(i);
+        unique_counts.push_back(1);
       } else {
-        size_t indices_idx = onnxruntime::narrow<size_t>(entry->second);
-        indices[indices_idx].push_back(i);
-        inverse_index.push_back(onnxruntime::narrow<int64_t>(indices_idx));
+        ++unique_counts[onnxruntime::narrow<size_t>(entry.first->second)];
       }
+      inverse_index.push_back(entry.first->second);
     }
 
-    CreateFlattenedOutput(context, offsets, indices, inverse_index, sort_);
+    CreateFlattenedOutput(context, unique_indices, first_indices, unique_counts, inverse_index, sort_);
   } else {
     const auto& input_shape = input.Shape();
     const int64_t input_dims = static_cast<int64_t>(input_shape.NumDimensions());
@@ -101,14 +101,18 @@ void UpsampleBilinear(const int32_t batch_size,
   BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width,
                                            height_scale, width_scale, roi,
                                            alloc, get_original_coordinate, true);
+  // The output rows of all the channels are split between the threads, so that images with few channels, e.g. RGB,
+  // still use all of them.
   for (int32_t n = 0; n < batch_size; ++n) {
-    concurrency::ThreadPool::TrySimpleParallelFor(
-        tp, num_channels,
-        [&](std::ptrdiff_t c) {
-          const T* const Xdata =
-              XdataBase + (n * num_channels + static_cast<int32_t>(c)) * (input_height * input_width);
-          T* const Ydata = YdataBase + (n * num_channels + static_cast<int32_t>(c)) * (output_height * output_width);
-          for (int32_t y = 0; y < output_height; ++y) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(num_channels) * output_height,
+        static_cast<double>(output_width * 8),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const int32_t c = static_cast<int32_t>(i / output_height);
+            const int32_t y = static_cast<int32_t>(i % output_height);
+            const T* const Xdata = XdataBase + (n * num_channels + c) * (input_height * input_width);
+            T* const Ydata = YdataBase + (n * num_channels + c) * (output_height * output_width);
             for (int32_t x = 0; x < output_width; ++x) {
               const int32_t output_offset = output_width * y + x;
               // when use_extrapolation is set and original index of x or y is out of the dim range
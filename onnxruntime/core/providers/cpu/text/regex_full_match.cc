@@ -3,6 +3,8 @@
 
 #include "regex_full_match.h"
 #include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 ONNX_CPU_OPERATOR_KERNEL(
@@ -22,13 +24,24 @@ Status RegexFullMatch::Compute(OpKernelContext* context) const {
   const auto input_data = input_tensor->template DataAsSpan<std::string>();
   auto* output_tensor = context->Output(0, input_tensor->Shape());
   auto output_data = output_tensor->template MutableDataAsSpan<bool>();
-  auto output_iter = output_data.begin();
-  auto input_iter = input_data.begin();
-  while (input_iter != input_data.end()) {
-    *output_iter = RE2::FullMatch(*input_iter, re_);
-    input_iter++;
-    output_iter++;
+  if (input_data.empty()) {
+    return Status::OK();
   }
+
+  // RE2 is thread safe, so the strings are matched in parallel. The cost of a match grows with the string length.
+  size_t total_bytes = 0;
+  for (const auto& s : input_data) {
+    total_bytes += s.size();
+  }
+  const double bytes_per_string = static_cast<double>(total_bytes) / static_cast<double>(input_data.size());
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(input_data.size()),
+      TensorOpCost{bytes_per_string, 1.0, 16.0 * bytes_per_string + 64.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output_data[i] = RE2::FullMatch(input_data[i], re_);
+        }
+      });
   return Status::OK();
 }
 
@@ -3,7 +3,9 @@
 
 #include "string_normalizer.h"
 #include "core/common/common.h"
+#include "core/common/narrow.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 // Used below HAS_DEPRECATED_DECLARATIONS
 #include "onnxruntime_config.h"
 
@@ -527,54 +529,79 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
 
   // Compute the largest widestring buffer needed.
   size_t max_wide_buffer_len = 0;
+  size_t total_bytes = 0;
   for (const auto& s : input_span) {
     size_t wchars = 0;
     // Checks for invalid UTF-8 characters on Windows
     ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(s, wchars));
     max_wide_buffer_len = std::max(max_wide_buffer_len, wchars);
+    total_bytes += s.size();
   }
 
-  // Reuse reserved space
-  std::wstring wchar_buffer;
-  wchar_buffer.reserve(max_wide_buffer_len);
+  // The strings are converted in batches split between the threads, each batch with its own converter and buffer.
+  // A batch has at least kMinBytesPerBatch bytes on average so small inputs are not worth the threads.
+  constexpr size_t kMinBytesPerBatch = 16 * 1024;
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+  const size_t num_batches = std::max<size_t>(
+      1, std::min<size_t>({static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool)),
+                           total_bytes / kMinBytesPerBatch, input_span.size()}));
+
+  // Runs fn(i, batch_converter, wchar_buffer) for every i in [0, count).
+  auto for_each_batch = [&](size_t count, const auto& fn) -> Status {
+    const size_t batches = std::min(num_batches, std::max<size_t>(count, 1));
+    InlinedVector<Status> statuses(batches);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, narrow<std::ptrdiff_t>(batches), [&](std::ptrdiff_t batch) {
+          const auto work = concurrency::ThreadPool::PartitionWork(batch, batches, count);
+          Utf8Converter batch_converter;
+          std::wstring wchar_buffer;
+          wchar_buffer.reserve(max_wide_buffer_len);
+          for (auto i = work.start; i < work.end; ++i) {
+            statuses[batch] = fn(i, batch_converter, wchar_buffer);
+            if (!statuses[batch].IsOK()) {
+              return;
+            }
+          }
+        });
+    for (const auto& status : statuses) {
+      ORT_RETURN_IF_ERROR(status);
+    }
+    return Status::OK();
+  };
+
+  auto change_case = [&](const std::string& s, std::string& dest, Utf8Converter& batch_converter,
+                         std::wstring& wchar_buffer) -> Status {
+    wchar_buffer.resize(max_wide_buffer_len);
+    ORT_RETURN_IF_ERROR(batch_converter.ConvertToWideChar(s, wchar_buffer));
+    locale.ChangeCase(case_change_action_, wchar_buffer);
+
+    size_t utf8_buffer_len = batch_converter.ComputeRequiredSizeToUtf8(wchar_buffer);
+    dest.resize(utf8_buffer_len);
+    return batch_converter.ConvertToUtf8(wchar_buffer, dest);
+  };
 
   // Output everything and change case as required
   auto output_no_filtering = [&](const TensorShape& output_shape) {
     auto output_tensor = ctx->Output(0, output_shape);
     auto const output_data = output_tensor->MutableData<std::string>();
-    for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-      const std::string& s = input_span[i];
-      wchar_buffer.resize(max_wide_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-      locale.ChangeCase(case_change_action_, wchar_buffer);
-
-      auto& dest = output_data[i];
-      size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-      dest.resize(utf8_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
-    }
-    return Status::OK();
+    return for_each_batch(input_span.size(), [&](size_t i, Utf8Converter& batch_converter,
+                                                 std::wstring& wchar_buffer) {
+      return change_case(input_span[i], output_data[i], batch_converter, wchar_buffer);
+    });
   };
 
   auto output_filtered = [&](const TensorShape& output_shape, gsl::span<const size_t> filtered_indices) {
     auto output_tensor = ctx->Output(0, output_shape);
     auto output_data = output_tensor->MutableData<std::string>();
-    for (size_t i : filtered_indices) {
-      const std::string& s = input_span[i];
+    return for_each_batch(filtered_indices.size(), [&](size_t i, Utf8Converter& batch_converter,
+                                                       std::wstring& wchar_buffer) {
+      const std::string& s = input_span[filtered_indices[i]];
       if (case_change_action_ != NONE) {
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(case_change_action_, wchar_buffer);
-
-        auto& dest = *output_data++;
-        size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-        dest.resize(utf8_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
-      } else {
-        *output_data++ = s;
+        return change_case(s, output_data[i], batch_converter, wchar_buffer);
       }
-    }
-    return Status::OK();
+      output_data[i] = s;
+      return Status::OK();
+    });
   };
 
   Status status;
@@ -611,14 +638,20 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       // Case insensitive filtering is performed by converting the input strings
       // to compare_caseaction_. For that we convert to wchar_t UNICODE.
       // Otherwise, we need to pull ICU library on all platforms.
+      InlinedVector<uint8_t> is_stopword(input_span.size());
+      ORT_RETURN_IF_ERROR(for_each_batch(input_span.size(), [&](size_t i, Utf8Converter& batch_converter,
+                                                                std::wstring& wchar_buffer) {
+        wchar_buffer.resize(max_wide_buffer_len);
+        ORT_RETURN_IF_ERROR(batch_converter.ConvertToWideChar(input_span[i], wchar_buffer));
+        locale.ChangeCase(compare_caseaction_, wchar_buffer);
+        is_stopword[i] = wstopwords_.count(wchar_buffer) != 0;
+        return Status::OK();
+      }));
+
       InlinedVector<size_t> filtered_strings_indices;
       filtered_strings_indices.reserve(input_span.size());
       for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-        const std::string& s = input_span[i];
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(compare_caseaction_, wchar_buffer);
-        if (wstopwords_.count(wchar_buffer) == 0) {
+        if (!is_stopword[i]) {
           filtered_strings_indices.push_back(i);
         }
       }
@@ -2,8 +2,14 @@
 // Licensed under the MIT License.
 
 #include "cuda_allocator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/framework/stream_handles.h"
 #include "cuda_common.h"
 #include "gpu_data_transfer.h"
+#include "nvtx_profile.h"
 
 namespace onnxruntime {
 
@@ -43,6 +49,7 @@ void* CUDAAllocator::Alloc(size_t size) {
   CheckDevice(true);
   void* p = nullptr;
   if (size > 0) {
+    profile::NvtxScopedRange alloc_range("cudaMalloc", profile::Color::Amber, size);
     // BFCArena was updated recently to handle the exception and adjust the request size
     CUDA_CALL_THROW(cudaMalloc((void**)&p, size));
   }
@@ -55,6 +62,136 @@ void CUDAAllocator::Free(void* p) {
   cudaFree(p);         // do not throw error since it's OK for cudaFree to fail during shutdown
 }
 
+CUDAMemPoolAllocator::CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold,
+                                           size_t mem_limit)
+    : CUDAAllocator(device_id, name), mem_limit_(mem_limit) {
+  SetDevice(true);
+  // a pool of its own rather than the default pool of the device, so the release threshold and the statistics are
+  // the ones of this allocator
+  cudaMemPoolProps props{};
+  props.allocType = cudaMemAllocationTypePinned;
+  props.handleTypes = cudaMemHandleTypeNone;
+  props.location.type = cudaMemLocationTypeDevice;
+  props.location.id = device_id;
+  CUDA_CALL_THROW(cudaMemPoolCreate(&pool_, &props));
+
+  cuuint64_t threshold = release_threshold;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+
+  stats_.bytes_limit = mem_limit_ == std::numeric_limits<size_t>::max() ? 0 : static_cast<int64_t>(mem_limit_);
+}
+
+CUDAMemPoolAllocator::~CUDAMemPoolAllocator() {
+  // the pool is released once the buffers still in use, e.g. the outputs of a run, are freed
+  cudaMemPoolDestroy(pool_);
+}
+
+bool CUDAMemPoolAllocator::IsSupported(OrtDevice::DeviceId device_id) {
+  int supported = 0;
+  return cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, device_id) == cudaSuccess &&
+         supported != 0;
+}
+
+void* CUDAMemPoolAllocator::AllocOnCudaStream(size_t size, cudaStream_t stream) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  SetDevice(true);
+  CheckDevice(true);
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    if (size > mem_limit_ || static_cast<size_t>(stats_.bytes_in_use) > mem_limit_ - size) {
+      ORT_THROW("Failed to allocate memory for requested buffer of size ", size, ". ", stats_.bytes_in_use,
+                " bytes are in use and gpu_mem_limit is ", mem_limit_, " bytes.");
+    }
+    stats_.bytes_in_use += size;
+  }
+
+  void* p = nullptr;
+  cudaError_t cuda_err = cudaMallocFromPoolAsync(&p, size, pool_, stream);
+  if (cuda_err == cudaSuccess && stream == nullptr) {
+    // buffers allocated without a stream may be used by any stream
+    cuda_err = cudaStreamSynchronize(nullptr);
+    if (cuda_err != cudaSuccess) {
+      cudaFreeAsync(p, nullptr);
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (cuda_err != cudaSuccess) {
+    stats_.bytes_in_use -= size;
+    CUDA_CALL_THROW(cuda_err);
+  }
+
+  allocations_[p] = Allocation{stream, size};
+  stats_.num_allocs++;
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  stats_.max_alloc_size = std::max(stats_.max_alloc_size, static_cast<int64_t>(size));
+  return p;
+}
+
+void* CUDAMemPoolAllocator::Alloc(size_t size) {
+  return AllocOnCudaStream(size, nullptr);
+}
+
+void* CUDAMemPoolAllocator::AllocOnStream(size_t size, Stream* stream, WaitNotificationFn /*wait_fn*/) {
+  if (stream == nullptr || stream->GetHandle() == nullptr || stream->GetDevice() != Info().device) {
+    return Alloc(size);
+  }
+  return AllocOnCudaStream(size, static_cast<cudaStream_t>(stream->GetHandle()));
+}
+
+void CUDAMemPoolAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  cudaStream_t stream = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = allocations_.find(p);
+    ORT_ENFORCE(it != allocations_.end(), "Freeing a buffer that was not allocated by this allocator.");
+    stream = it->second.stream;
+    stats_.bytes_in_use -= it->second.size;
+    allocations_.erase(it);
+  }
+
+  SetDevice(false);
+  if (stream == nullptr) {
+    // the streams that used the buffer are not known, wait for them like cudaFree does
+    cudaDeviceSynchronize();
+  }
+  cudaFreeAsync(p, stream);  // do not throw error since it's OK for the free to fail during shutdown
+}
+
+void CUDAMemPoolAllocator::ReleaseStreamBuffers(Stream* stream) {
+  if (stream == nullptr || stream->GetHandle() == nullptr) {
+    return;
+  }
+
+  // The stream may be destroyed before the buffers still in use, e.g. the outputs of the run, are freed.
+  const auto cuda_stream = static_cast<cudaStream_t>(stream->GetHandle());
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& allocation : allocations_) {
+    if (allocation.second.stream == cuda_stream) {
+      allocation.second.stream = nullptr;
+    }
+  }
+}
+
+void CUDAMemPoolAllocator::GetStats(AllocatorStats* stats) {
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+  }
+
+  cuuint64_t reserved = 0;
+  if (cudaMemPoolGetAttribute(pool_, cudaMemPoolAttrReservedMemCurrent, &reserved) == cudaSuccess) {
+    stats->total_allocated_bytes = static_cast<int64_t>(reserved);
+  }
+}
+
 void* CUDAExternalAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
@@ -6,6 +6,7 @@
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
 
 namespace onnxruntime {
 
@@ -19,11 +20,53 @@ class CUDAAllocator : public IAllocator {
   void* Alloc(size_t size) override;
   void Free(void* p) override;
 
- private:
+ protected:
   void CheckDevice(bool throw_when_fail) const;
   void SetDevice(bool throw_when_fail) const;
 };
 
+// Allocator backed by a CUDA stream ordered memory pool (cudaMallocFromPoolAsync), used instead of the BFC arena
+// when use_cuda_mempool is set.
+// A buffer allocated on a stream is freed on that stream with cudaFreeAsync, so the pool reuses it for the following
+// work of the stream without synchronizing the device, and for the work of other streams once the free completed.
+// The unused memory of the pool above release_threshold is returned to the device when a stream is synchronized,
+// e.g. at the end of a run, which lets the sessions and processes sharing the GPU use it.
+class CUDAMemPoolAllocator : public CUDAAllocator {
+ public:
+  CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold, size_t mem_limit);
+  ~CUDAMemPoolAllocator() override;
+
+  // Whether the device supports stream ordered memory pools.
+  static bool IsSupported(OrtDevice::DeviceId device_id);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  bool IsStreamAware() const override { return true; }
+  void* AllocOnStream(size_t size, Stream* stream, WaitNotificationFn wait_fn) override;
+  void ReleaseStreamBuffers(Stream* stream) override;
+
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAMemPoolAllocator);
+
+  void* AllocOnCudaStream(size_t size, cudaStream_t stream);
+
+  struct Allocation {
+    // nullptr for the buffers allocated without a stream, and the ones of the streams whose run is done
+    cudaStream_t stream;
+    size_t size;
+  };
+
+  cudaMemPool_t pool_{nullptr};
+  const size_t mem_limit_;
+
+  mutable OrtMutex lock_;
+  InlinedHashMap<void*, Allocation> allocations_;
+  AllocatorStats stats_;
+};
+
 class CUDAExternalAllocator : public CUDAAllocator {
   typedef void* (*ExternalAlloc)(size_t size);
   typedef void (*ExternalFree)(void* p);
@@ -320,6 +320,16 @@ DataLayout CUDAExecutionProvider::GetPreferredLayout() const {
   return this->IsNHWCPreferred() ? DataLayout::NHWC : DataLayout::NCHW;
 }
 
+std::vector<MatMulNBitsFormat> CUDAExecutionProvider::GetMatMulNBitsFormats() const {
+  // The block sizes of the fp16 GEMV kernel of MatMulNBits, of which 16, 32 and 64 also have the tensor core GEMM
+  // that B is prepacked for on SM80+. The kernels don't depend on the accuracy level.
+  std::vector<MatMulNBitsFormat> formats;
+  for (const int64_t block_size : {16, 32, 64, 128}) {
+    formats.push_back({4, block_size, 0});
+  }
+  return formats;
+}
+
 CUDAExecutionProvider::~CUDAExecutionProvider() {
   // clean up thread local context caches
   {
@@ -2614,6 +2624,31 @@ OrtDevice CUDAExecutionProvider::GetOrtDeviceByMemType(OrtMemType mem_type) cons
   return default_device_;
 }
 
+AllocatorPtr CUDAExecutionProvider::CreateDefaultAllocator() const {
+  if (info_.use_cuda_mempool && !info_.external_allocator_info.UseExternalAllocator()) {
+    if (info_.enable_cuda_graph) {
+      // the allocations of a captured graph would be recorded as memory nodes of the graph
+      LOGS_DEFAULT(WARNING) << "use_cuda_mempool is ignored when enable_cuda_graph is set. The BFC arena is used.";
+    } else if (!CUDAMemPoolAllocator::IsSupported(info_.device_id)) {
+      LOGS_DEFAULT(WARNING) << "CUDA device " << info_.device_id
+                            << " does not support memory pools, use_cuda_mempool is ignored. The BFC arena is used.";
+    } else {
+      AllocatorCreationInfo default_memory_info(
+          [release_threshold = info_.cuda_mempool_release_threshold,
+           mem_limit = info_.gpu_mem_limit](OrtDevice::DeviceId id) {
+            return std::make_unique<CUDAMemPoolAllocator>(id, CUDA, release_threshold, mem_limit);
+          },
+          info_.device_id,
+          // the pool reuses and releases the memory itself
+          false);
+      return CreateAllocator(default_memory_info);
+    }
+  }
+
+  return CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
+                             info_.external_allocator_info, info_.default_memory_arena_cfg);
+}
+
 std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
   AllocatorCreationInfo pinned_memory_info(
       [](OrtDevice::DeviceId) {
@@ -2626,8 +2661,7 @@ std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
       // at the risk the lifetime isn't managed correctly if one of those devices go away.
       0);
   return std::vector<AllocatorPtr>{
-      CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
-                          info_.external_allocator_info, info_.default_memory_arena_cfg),
+      CreateDefaultAllocator(),
       CreateAllocator(pinned_memory_info),
   };
 }
@@ -39,6 +39,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   DataLayout GetPreferredLayout() const override;
 
+  bool ConvertLayoutByCost() const override { return info_.nhwc_cost_model; }
+
+  std::vector<MatMulNBitsFormat> GetMatMulNBitsFormats() const override;
+
   const void* GetExecutionHandle() const noexcept override {
     // The CUDA interface does not return anything interesting.
     return nullptr;
@@ -112,6 +116,9 @@ class CUDAExecutionProvider : public IExecutionProvider {
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
 
  private:
+  // The memory pool allocator if use_cuda_mempool is set and usable, else the allocator of CreateCudaAllocator.
+  AllocatorPtr CreateDefaultAllocator() const;
+
   CUDAExecutionProviderInfo info_;
   cudaDeviceProp device_prop_;
   bool external_stream_ = false;
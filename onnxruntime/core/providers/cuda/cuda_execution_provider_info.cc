@@ -36,6 +36,9 @@ constexpr const char* kUseEPLevelUnifiedStream = "use_ep_level_unified_stream";
 constexpr const char* kUseTF32 = "use_tf32";
 constexpr const char* kFuseConvBias = "fuse_conv_bias";
 constexpr const char* kSdpaKernel = "sdpa_kernel";
+constexpr const char* kUseCudaMemPool = "use_cuda_mempool";
+constexpr const char* kCudaMemPoolReleaseThreshold = "cuda_mempool_release_threshold";
+constexpr const char* kNhwcCostModel = "nhwc_cost_model";
 
 }  // namespace provider_option_names
 }  // namespace cuda
@@ -121,6 +124,9 @@ CUDAExecutionProviderInfo CUDAExecutionProviderInfo::FromProviderOptions(const P
           .AddAssignmentToReference(cuda::provider_option_names::kUseTF32, info.use_tf32)
           .AddAssignmentToReference(cuda::provider_option_names::kSdpaKernel, info.sdpa_kernel)
           .AddAssignmentToReference(cuda::provider_option_names::kFuseConvBias, info.fuse_conv_bias)
+          .AddAssignmentToReference(cuda::provider_option_names::kUseCudaMemPool, info.use_cuda_mempool)
+          .AddAssignmentToReference(cuda::provider_option_names::kCudaMemPoolReleaseThreshold, info.cuda_mempool_release_threshold)
+          .AddAssignmentToReference(cuda::provider_option_names::kNhwcCostModel, info.nhwc_cost_model)
           .AddValueParser(
               cuda::provider_option_names::kTunableOpEnable,
               [&info](const std::string& value_str) -> Status {
@@ -176,6 +182,9 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const CUDAExecution
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
       {cuda::provider_option_names::kSdpaKernel, MakeStringWithClassicLocale(info.sdpa_kernel)},
       {cuda::provider_option_names::kFuseConvBias, MakeStringWithClassicLocale(info.fuse_conv_bias)},
+      {cuda::provider_option_names::kUseCudaMemPool, MakeStringWithClassicLocale(info.use_cuda_mempool)},
+      {cuda::provider_option_names::kCudaMemPoolReleaseThreshold, MakeStringWithClassicLocale(info.cuda_mempool_release_threshold)},
+      {cuda::provider_option_names::kNhwcCostModel, MakeStringWithClassicLocale(info.nhwc_cost_model)},
   };
 
   return options;
@@ -200,6 +209,9 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const OrtCUDAProvid
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
       {cuda::provider_option_names::kFuseConvBias, MakeStringWithClassicLocale(info.fuse_conv_bias)},
       {cuda::provider_option_names::kSdpaKernel, MakeStringWithClassicLocale(info.sdpa_kernel)},
+      {cuda::provider_option_names::kUseCudaMemPool, MakeStringWithClassicLocale(info.use_cuda_mempool)},
+      {cuda::provider_option_names::kCudaMemPoolReleaseThreshold, MakeStringWithClassicLocale(info.cuda_mempool_release_threshold)},
+      {cuda::provider_option_names::kNhwcCostModel, MakeStringWithClassicLocale(info.nhwc_cost_model)},
   };
 
   return options;
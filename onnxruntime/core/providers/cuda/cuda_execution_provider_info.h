@@ -82,6 +82,15 @@ struct CUDAExecutionProviderInfo {
 
   int sdpa_kernel{0};
 
+  // Use a stream ordered memory pool instead of the BFC arena. The unused memory above the release threshold is
+  // returned to the device when a stream is synchronized.
+  bool use_cuda_mempool{false};
+  size_t cuda_mempool_release_threshold{std::numeric_limits<size_t>::max()};
+
+  // With prefer_nhwc, convert only the regions of layout sensitive nodes where the NHWC kernels are estimated to save
+  // more than the Transposes around them cost.
+  bool nhwc_cost_model{false};
+
   static CUDAExecutionProviderInfo FromProviderOptions(const ProviderOptions& options);
   static ProviderOptions ToProviderOptions(const CUDAExecutionProviderInfo& info);
   static ProviderOptions ToProviderOptions(const OrtCUDAProviderOptionsV2& info);
@@ -115,6 +124,9 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
     onnxruntime::HashCombine(info.sdpa_kernel, value);
+    onnxruntime::HashCombine(info.use_cuda_mempool, value);
+    onnxruntime::HashCombine(info.cuda_mempool_release_threshold, value);
+    onnxruntime::HashCombine(info.nhwc_cost_model, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
@@ -4,6 +4,7 @@
 #include "core/providers/cuda/cuda_graph.h"
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/nvtx_profile.h"
 #include <cuda_runtime_api.h>
 #include <driver_types.h>
 
@@ -54,9 +55,19 @@ void CUDAGraphManager::CaptureBegin(CudaGraphAnnotation_t cuda_graph_annotation_
   // and streams, `cudaStreamCaptureModeGlobal` needs to be changed to
   // `cudaStreamCaptureModeThreadLocal`
   CUDA_CALL_THROW(cudaStreamBeginCapture(stream_, cudaStreamCaptureModeGlobal));
+
+  if (profile::IsNvtxRangesEnabled()) {
+    const std::string message = MakeString("CUDA graph capture ", cuda_graph_annotation_id);
+    capture_range_id_ = profile::NvtxStartRange(message.c_str(), profile::Color::Magenta);
+  }
 }
 
 void CUDAGraphManager::CaptureEnd(CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  if (capture_range_id_ != 0) {
+    profile::NvtxEndRange(capture_range_id_);
+    capture_range_id_ = 0;
+  }
+
   cudaGraph_t graph = NULL;
   CUDA_CALL_THROW(cudaStreamEndCapture(stream_, &graph));
   if (graph == NULL) {
@@ -77,6 +88,10 @@ Status CUDAGraphManager::Replay(CudaGraphAnnotation_t cuda_graph_annotation_id)
   // CUDA EP maintains a separate cuda graph per thread
   LOGS_DEFAULT(INFO) << "Replaying CUDA graph on stream " << stream_ << " with cuda_graph_annotation_id "
                      << cuda_graph_annotation_id;
+  const std::string replay_message = profile::IsNvtxRangesEnabled()
+                                         ? MakeString("CUDA graph replay ", cuda_graph_annotation_id)
+                                         : std::string();
+  profile::NvtxScopedRange replay_range(replay_message.c_str(), profile::Color::Magenta);
 
   cudaGraphExec_t graph_exec = cuda_graph_set_.Get(cuda_graph_annotation_id);
   CUDA_RETURN_IF_ERROR(cudaGraphLaunch(graph_exec, stream_));
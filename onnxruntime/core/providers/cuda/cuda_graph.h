@@ -50,6 +50,9 @@ struct CUDAGraphManager {
   CudaGraphAnnotation_t cuda_graph_annotation_id_ = kCudaGraphAnnotationDefault;
 
   cudaStream_t stream_ = nullptr;  // Does not own the stream
+
+  // the NVTX range of the capture in progress, 0 if there is none
+  uint64_t capture_range_id_ = 0;
 };
 
 using CUDAGraph = CUDAGraphManager;
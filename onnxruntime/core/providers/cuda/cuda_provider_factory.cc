@@ -18,9 +18,7 @@
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/math/unary_elementwise_ops_impl.h"
 
-#ifdef ENABLE_NVTX_PROFILE
-#include "nvtx_profile.h"
-#endif
+#include "core/providers/cuda/nvtx_profile.h"
 
 using namespace onnxruntime;
 
@@ -168,6 +166,19 @@ struct ProviderInfo_CUDA_Impl final : ProviderInfo_CUDA {
   }
 #endif
 
+  void Nvtx__EnableRanges(bool enable) override { profile::EnableNvtxRanges(enable); }
+  void Nvtx__PushRange(const char* message, uint32_t color, uint64_t payload) override {
+    profile::NvtxPushRange(message, static_cast<profile::Color>(color), payload);
+  }
+  void Nvtx__PopRange() override { profile::NvtxPopRange(); }
+  uint64_t Nvtx__StartRange(const char* message, uint32_t color, uint64_t payload) override {
+    return profile::NvtxStartRange(message, static_cast<profile::Color>(color), payload);
+  }
+  void Nvtx__EndRange(uint64_t range_id) override { profile::NvtxEndRange(range_id); }
+  void Nvtx__Mark(const char* message, uint32_t color) override {
+    profile::NvtxMark(message, static_cast<profile::Color>(color));
+  }
+
 #ifdef ENABLE_NVTX_PROFILE
   void NvtxRangeCreator__BeginImpl(profile::NvtxRangeCreator* p) override { p->BeginImpl(); }
   void NvtxRangeCreator__EndImpl(profile::NvtxRangeCreator* p) override { p->EndImpl(); }
@@ -228,6 +239,9 @@ struct CUDA_Provider : Provider {
     info.use_ep_level_unified_stream = params->use_ep_level_unified_stream != 0;
     info.use_tf32 = params->use_tf32 != 0;
     info.sdpa_kernel = params->sdpa_kernel;
+    info.use_cuda_mempool = params->use_cuda_mempool != 0;
+    info.cuda_mempool_release_threshold = params->cuda_mempool_release_threshold;
+    info.nhwc_cost_model = params->nhwc_cost_model != 0;
 
     return std::make_shared<CUDAProviderFactory>(info);
   }
@@ -263,6 +277,9 @@ struct CUDA_Provider : Provider {
     cuda_options.use_ep_level_unified_stream = internal_options.use_ep_level_unified_stream;
     cuda_options.use_tf32 = internal_options.use_tf32;
     cuda_options.sdpa_kernel = internal_options.sdpa_kernel;
+    cuda_options.use_cuda_mempool = internal_options.use_cuda_mempool;
+    cuda_options.cuda_mempool_release_threshold = internal_options.cuda_mempool_release_threshold;
+    cuda_options.nhwc_cost_model = internal_options.nhwc_cost_model;
     cuda_options.fuse_conv_bias = internal_options.fuse_conv_bias;
   }
 
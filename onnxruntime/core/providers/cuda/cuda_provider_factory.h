@@ -46,6 +46,14 @@ struct ProviderInfo_CUDA {
   virtual onnxruntime::cuda::INcclService& GetINcclService() = 0;
 #endif
 
+  // the NVTX ranges of the framework, see profile::EnableNvtxRanges
+  virtual void Nvtx__EnableRanges(bool enable) = 0;
+  virtual void Nvtx__PushRange(const char* message, uint32_t color, uint64_t payload) = 0;
+  virtual void Nvtx__PopRange() = 0;
+  virtual uint64_t Nvtx__StartRange(const char* message, uint32_t color, uint64_t payload) = 0;
+  virtual void Nvtx__EndRange(uint64_t range_id) = 0;
+  virtual void Nvtx__Mark(const char* message, uint32_t color) = 0;
+
 #ifdef ENABLE_NVTX_PROFILE
   virtual void NvtxRangeCreator__BeginImpl(profile::NvtxRangeCreator* p) = 0;
   virtual void NvtxRangeCreator__EndImpl(profile::NvtxRangeCreator* p) = 0;
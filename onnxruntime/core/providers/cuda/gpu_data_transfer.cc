@@ -5,6 +5,7 @@
 
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
+#include "core/providers/cuda/nvtx_profile.h"
 
 namespace onnxruntime {
 GPUDataTransfer::GPUDataTransfer() {}
@@ -18,6 +19,8 @@ bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_
 
 common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst) const {
   size_t bytes = src.SizeInBytes();
+  // the payload of the range is the number of bytes copied
+  profile::NvtxScopedRange copy_range("CopyTensor", profile::Color::Red, bytes);
   const void* src_data = src.DataRaw();
   void* dst_data = dst.MutableDataRaw();
 
@@ -51,6 +54,7 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst) const
 
 common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const {
   size_t bytes = src.SizeInBytes();
+  profile::NvtxScopedRange copy_range("CopyTensorAsync", profile::Color::Red, bytes);
   const void* src_data = src.DataRaw();
   void* dst_data = dst.MutableDataRaw();
 
@@ -83,4 +87,60 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const {
+  size_t total_bytes = 0;
+  for (const auto& pair : src_dst_pairs) {
+    total_bytes += pair.src.get().SizeInBytes();
+  }
+  profile::NvtxScopedRange copy_range("CopyTensors", profile::Color::Red, total_bytes);
+
+  // the copies queued on the default stream so far. they are waited for before returning, also on failure, as
+  // the caller may release the buffers once this returns.
+  bool queued = false;
+  auto copy = [&](const SrcDstPair& pair) -> Status {
+    const Tensor& src = pair.src;
+    Tensor& dst = pair.dst;
+    if (pair.src_stream) {
+      return CopyTensorAsync(src, dst, *pair.src_stream);
+    }
+
+    const void* src_data = src.DataRaw();
+    void* dst_data = dst.MutableDataRaw();
+    const size_t bytes = src.SizeInBytes();
+    const bool src_is_gpu = src.Location().device.Type() == OrtDevice::GPU;
+    const bool dst_is_gpu = dst.Location().device.Type() == OrtDevice::GPU;
+    if (!src_is_gpu && !dst_is_gpu) {
+      // copying between cpu memory. the source may be the destination of a queued copy
+      if (queued) {
+        CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
+        queued = false;
+      }
+      memcpy(dst_data, src_data, bytes);
+    } else if (dst_data != src_data) {
+      const auto kind = dst_is_gpu ? (src_is_gpu ? cudaMemcpyDeviceToDevice : cudaMemcpyHostToDevice)
+                                   : cudaMemcpyDeviceToHost;
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, kind, nullptr));
+      queued = true;
+    }
+    return Status::OK();
+  };
+
+  Status status;
+  for (const auto& pair : src_dst_pairs) {
+    status = copy(pair);
+    if (!status.IsOK()) {
+      break;
+    }
+  }
+
+  if (queued) {
+    const auto sync_result = cudaStreamSynchronize(nullptr);
+    if (status.IsOK()) {
+      CUDA_RETURN_IF_ERROR(sync_result);
+    }
+  }
+
+  return status;
+}
+
 }  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include "core/common/status.h"
 #include "core/providers/cuda/nn/conv.h"
 #include "core/common/span_utils.h"
+#include "core/framework/tuning_context.h"
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cuda/tensor/transpose.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
@@ -47,6 +48,42 @@ size_t GetMaxWorkspaceSize(cudnnHandle_t handle, const CudnnConvState<cudnnConvo
   return max_ws_size;
 }
 
+// The algos found by the exhaustive search are kept in the TuningResultsManager of the execution provider, so they are
+// part of its TuningResults and reused by the sessions that load them, e.g. through the tuning results cache.
+static constexpr const char* kCudnnConvFwdOpSignature = "CudnnConvolutionForward";
+
+static std::string GetConvFwdParamsSignature(cudnnDataType_t data_type, bool channels_last, bool w_in_nhwc,
+                                             bool use_tf32, bool use_max_workspace,
+                                             gsl::span<const int64_t> x_dims, gsl::span<const int64_t> w_dims,
+                                             gsl::span<const int64_t> pads, gsl::span<const int64_t> strides,
+                                             gsl::span<const int64_t> dilations, int64_t group) {
+  std::ostringstream oss;
+  auto append = [&oss](const char* name, gsl::span<const int64_t> values) {
+    oss << "_" << name;
+    for (size_t i = 0; i < values.size(); ++i) {
+      oss << (i == 0 ? "" : "x") << values[i];
+    }
+  };
+  oss << static_cast<int>(data_type) << (channels_last ? "_NHWC" : "_NCHW") << (w_in_nhwc ? "_WNHWC" : "_WNCHW");
+  append("x", x_dims);
+  append("w", w_dims);
+  append("p", pads);
+  append("s", strides);
+  append("d", dilations);
+  oss << "_g" << group << "_tf32" << use_tf32 << "_ws" << (use_max_workspace ? "max" : "default");
+  return oss.str();
+}
+
+// The best id of a result holds the algo and the math type it was found with.
+static int EncodeConvFwdAlgo(const cudnnConvolutionFwdAlgoPerf_t& perf) {
+  return static_cast<int>(perf.algo) | (static_cast<int>(perf.mathType) << 8);
+}
+
+static void DecodeConvFwdAlgo(int best_id, cudnnConvolutionFwdAlgoPerf_t& perf) {
+  perf.algo = static_cast<cudnnConvolutionFwdAlgo_t>(best_id & 0xff);
+  perf.mathType = static_cast<cudnnMathType_t>(best_id >> 8);
+}
+
 Status SliceOutUnwantedOutputSection(cudaStream_t stream,
                                      const void* input_data, gsl::span<const int64_t> input_dims,
                                      void* output_data,
@@ -317,6 +354,18 @@ Status Conv<T, NHWC>::UpdateState(OpKernelContext* context, bool bias_expected)
       ORT_ENFORCE(cudnn_conv_algo > -1 && cudnn_conv_algo < 3, "cudnn_conv_algo should be 0, 1 or 2, but got ", cudnn_conv_algo);
       switch (cudnn_conv_algo) {
         case 0: {
+          TuningResultsManager& tuning_results = cuda_ep->GetTuningContext()->GetTuningResultsManager();
+          const std::string params_signature = GetConvFwdParamsSignature(
+              CudnnTensor::GetDataType<CudaT>(), channels_last, w_in_nhwc, UseTF32(),
+              cuda_ep->GetCudnnConvUseMaxWorkspace(), x_dims_cudnn, w_dims, pads, strides, dilations,
+              conv_attrs_.group);
+          const int best_id = tuning_results.Lookup(kCudnnConvFwdOpSignature, params_signature);
+          if (best_id >= 0) {
+            DecodeConvFwdAlgo(best_id, perf);
+            CUDNN_RETURN_IF_ERROR(GetWorkspaceSize(GetCudnnHandle(context), s_, perf.algo, &perf.memory));
+            break;
+          }
+
           static constexpr int num_algos = CUDNN_CONVOLUTION_FWD_ALGO_COUNT;
           size_t max_ws_size = cuda_ep->GetCudnnConvUseMaxWorkspace() ? GetMaxWorkspaceSize(GetCudnnHandle(context), s_, kAllAlgos, num_algos)
                                                                       : AlgoSearchWorkspaceSize;
@@ -337,6 +386,7 @@ Status Conv<T, NHWC>::UpdateState(OpKernelContext* context, bool bias_expected)
               &perf,
               algo_search_workspace.get(),
               max_ws_size));
+          tuning_results.Add(kCudnnConvFwdOpSignature, params_signature, EncodeConvFwdAlgo(perf));
           break;
         }
         case 1:
@@ -1,15 +1,73 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#ifdef ENABLE_NVTX_PROFILE
 #include "nvtx_profile.h"
 #include "core/common/common.h"
+#include <atomic>
 #include <nvtx3/nvToolsExt.h>
 #include <nvtx3/nvToolsExtCuda.h>
 
 namespace onnxruntime {
 namespace profile {
 
+namespace {
+#ifdef ENABLE_NVTX_PROFILE
+std::atomic<bool> nvtx_ranges_enabled{true};
+#else
+std::atomic<bool> nvtx_ranges_enabled{false};
+#endif
+
+nvtxEventAttributes_t MakeEventAttributes(const char* message, Color color, uint64_t payload) {
+  nvtxEventAttributes_t event_attributes{};
+  event_attributes.version = NVTX_VERSION;
+  event_attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  event_attributes.colorType = NVTX_COLOR_ARGB;
+  event_attributes.color = static_cast<uint32_t>(color);
+  event_attributes.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  event_attributes.message.ascii = message;
+  if (payload != 0) {
+    event_attributes.payloadType = NVTX_PAYLOAD_TYPE_UNSIGNED_INT64;
+    event_attributes.payload.ullValue = payload;
+  }
+  return event_attributes;
+}
+}  // namespace
+
+// The framework forwards its ranges to the functions below through ProviderInfo_CUDA and keeps its own flag, which
+// it only sets after enabling the ranges here. The ranges in this library are emitted while this flag is set.
+bool IsNvtxRangesEnabled() {
+  return nvtx_ranges_enabled.load(std::memory_order_relaxed);
+}
+
+bool EnableNvtxRanges(bool enable) {
+  nvtx_ranges_enabled = enable;
+  return true;
+}
+
+void NvtxPushRange(const char* message, Color color, uint64_t payload) {
+  const auto event_attributes = MakeEventAttributes(message, color, payload);
+  nvtxRangePushEx(&event_attributes);
+}
+
+void NvtxPopRange() {
+  nvtxRangePop();
+}
+
+uint64_t NvtxStartRange(const char* message, Color color, uint64_t payload) {
+  const auto event_attributes = MakeEventAttributes(message, color, payload);
+  return nvtxRangeStartEx(&event_attributes);
+}
+
+void NvtxEndRange(uint64_t range_id) {
+  nvtxRangeEnd(range_id);
+}
+
+void NvtxMark(const char* message, Color color) {
+  const auto event_attributes = MakeEventAttributes(message, color, 0);
+  nvtxMarkEx(&event_attributes);
+}
+
+#ifdef ENABLE_NVTX_PROFILE
 void NvtxRangeCreator::BeginImpl() {
   // enable only for debug builds because this function is for profiling only.
   nvtxEventAttributes_t eventAttrib;
@@ -59,7 +117,7 @@ void NvtxMarkerCreator::Mark() {
   nvtxMarkEx(&eventAttrib);
 }
 
+#endif
+
 }  // namespace profile
 }  // namespace onnxruntime
-
-#endif
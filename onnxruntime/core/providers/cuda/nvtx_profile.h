@@ -6,8 +6,6 @@
 // They can be used to plot the time intervals of forward and backward passes.
 // They can also be used to plot the time span of a specific operator.
 // When writing this file, Nvidia only supports this tool on Linux.
-#ifdef ENABLE_NVTX_PROFILE
-
 #pragma once
 
 #include <cinttypes>
@@ -42,6 +40,71 @@ enum class Color : uint32_t {
   Yellow = 0x00ffff00,
 };
 
+// The ranges below are compiled into every build and emit nothing until they are enabled at runtime, e.g. with the
+// session option session.enable_nvtx_ranges. Builds with ENABLE_NVTX_PROFILE enable them by default. The NVTX calls
+// are made by the CUDA execution provider, the framework forwards its ranges to it.
+bool IsNvtxRangesEnabled();
+
+// Enables or disables the ranges of the framework and the CUDA execution provider.
+// Returns false if they cannot be enabled because the CUDA execution provider is not available.
+bool EnableNvtxRanges(bool enable);
+
+// Pushes a range on the range stack of the calling thread. A non-zero payload is attached to the range, it is the
+// correlation id of the run for the ranges of the framework.
+void NvtxPushRange(const char* message, Color color, uint64_t payload = 0);
+void NvtxPopRange();
+
+// Starts a range that may end on another thread, or out of the order of the range stack.
+// Returns the id to end it with.
+uint64_t NvtxStartRange(const char* message, Color color, uint64_t payload = 0);
+void NvtxEndRange(uint64_t range_id);
+
+void NvtxMark(const char* message, Color color);
+
+// A range pushed for the lifetime of the object if the ranges are enabled when it is created.
+class NvtxScopedRange final {
+ public:
+  NvtxScopedRange(const char* message, Color color, uint64_t payload = 0)
+      : pushed_(IsNvtxRangesEnabled()) {
+    if (pushed_) {
+      NvtxPushRange(message, color, payload);
+    }
+  }
+
+  ~NvtxScopedRange() {
+    if (pushed_) {
+      NvtxPopRange();
+    }
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NvtxScopedRange);
+
+ private:
+  const bool pushed_;
+};
+
+// Returns the correlation id of the run on the calling thread, or 0 if there is none or the ranges are disabled.
+// The framework assigns the id to every run while the ranges are enabled, it is the payload of the ranges of the run
+// and the correlation_id arg of its events in the profiler trace. Only available in the framework.
+uint64_t CurrentNvtxCorrelationId();
+
+// Assigns a new correlation id to the run on the calling thread and pushes its range, if the ranges are enabled,
+// for the lifetime of the object. Only available in the framework.
+class NvtxRunScope final {
+ public:
+  explicit NvtxRunScope(const std::string& name);
+  ~NvtxRunScope();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NvtxRunScope);
+
+  uint64_t CorrelationId() const { return correlation_id_; }
+
+ private:
+  uint64_t correlation_id_{0};
+  uint64_t parent_correlation_id_{0};
+};
+
+#ifdef ENABLE_NVTX_PROFILE
 class RangeCreatorBase {
  public:
   RangeCreatorBase(const std::string message, const Color color)
@@ -134,7 +197,7 @@ class NvtxMarkerCreator final {
   const Color color_;
 };
 
+#endif
+
 }  // namespace profile
 }  // namespace onnxruntime
-
-#endif
\ No newline at end of file
@@ -28,6 +28,19 @@ static Status ValidateCudaVersion(const std::string& value) {
   return Status::OK();
 }
 
+static std::string GetDriverVersion() {
+  int version;
+  CUDA_CALL_THROW(cudaDriverGetVersion(&version));
+  return std::to_string(version);
+}
+
+static Status ValidateDriverVersion(const std::string& value) {
+  auto current = GetDriverVersion();
+  ORT_RETURN_IF(current != value, "CUDA driver version mismatch: tuning results produced with CUDA driver ", value,
+                ", onnxruntime currently run with CUDA driver ", current);
+  return Status::OK();
+}
+
 std::string CudaTuningResultsValidator::GetOrtBuildConfig() const {
   std::ostringstream oss;
 #ifdef ENABLE_TRITON
@@ -52,6 +65,7 @@ Status CudaTuningResultsValidator::ValidateDeviceModel(const std::string& value)
 
 CudaTuningResultsValidator::CudaTuningResultsValidator(CUDAExecutionProvider* ep) : ep_(ep) {
   RegisterValidator("CUDA_VERSION", GetCudaVersion, ValidateCudaVersion);
+  RegisterValidator("DRIVER_VERSION", GetDriverVersion, ValidateDriverVersion);
   RegisterValidator(
       "DEVICE_MODEL",
       [this]() { return GetDeviceModel(); },
@@ -58,26 +58,100 @@ namespace Dml
         m_context(context),
         m_subAllocator(std::move(subAllocator))
     {
+    #ifndef _GAMING_XBOX
+        // The budget is only a hint, the allocator works without it
+        ComPtr<IDXGIFactory4> dxgiFactory;
+        if (SUCCEEDED(CreateDXGIFactory2(0, IID_PPV_ARGS(&dxgiFactory))))
+        {
+            dxgiFactory->EnumAdapterByLuid(device->GetAdapterLuid(), IID_PPV_ARGS(&m_adapter));
+        }
+    #endif
     }
 
     /*static*/ gsl::index BucketizedBufferAllocator::GetBucketIndexFromSize(uint64_t size)
     {
         assert(size != 0);
 
-        // Each bucket is twice as large as the previous one, in ascending order
-        gsl::index index = static_cast<gsl::index>(ceil(log2(size)));
-        assert((1ull << index) >= size); // This must be true unless there were some strange rounding issues
-
         // The smallest bucket is 2^n bytes large, where n = c_minResourceSizeExponent
-        index = std::max<gsl::index>(index, c_minResourceSizeExponent);
-        index -= c_minResourceSizeExponent;
+        if (size <= (1ull << c_minResourceSizeExponent))
+        {
+            return 0;
+        }
+
+        // Find the power of two below the size, and the bucket of that power of two which fits it
+        uint32_t exponent = c_minResourceSizeExponent;
+        while ((2ull << exponent) <= size)
+        {
+            ++exponent;
+        }
+
+        const uint64_t base = 1ull << exponent;
+        const uint64_t step = base / c_bucketsPerPowerOfTwo;
+        const uint64_t subIndex = (size - base + step - 1) / step;
+
+        gsl::index index = static_cast<gsl::index>((exponent - c_minResourceSizeExponent) * c_bucketsPerPowerOfTwo + subIndex);
+        assert(GetBucketSizeFromIndex(index) >= size);
 
         return index;
     }
 
     /*static*/ uint64_t BucketizedBufferAllocator::GetBucketSizeFromIndex(gsl::index index)
     {
-        return (1ull << (index + c_minResourceSizeExponent));
+        const uint64_t base = 1ull << (index / c_bucketsPerPowerOfTwo + c_minResourceSizeExponent);
+        return base + (index % c_bucketsPerPowerOfTwo) * (base / c_bucketsPerPowerOfTwo);
+    }
+
+    bool BucketizedBufferAllocator::IsOverBudget(uint64_t size) const
+    {
+    #ifndef _GAMING_XBOX
+        // On a UMA adapter the local segment group is the memory shared with the system
+        DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo = {};
+        if (m_adapter && SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo)))
+        {
+            return memoryInfo.CurrentUsage + size > memoryInfo.Budget;
+        }
+    #endif
+
+        return false;
+    }
+
+    ComPtr<DmlResourceWrapper> BucketizedBufferAllocator::AllocResource(uint64_t size)
+    {
+        // The budget is only queried when the pool could be trimmed, as new allocations are rare once it is warm
+        if (m_pooledBytes > 0 && IsOverBudget(size))
+        {
+            Trim();
+        }
+
+        return m_subAllocator->Alloc(onnxruntime::narrow<size_t>(size));
+    }
+
+    void BucketizedBufferAllocator::ReleaseResource(DmlResourceWrapper* resource)
+    {
+        if (!m_context->IsClosed())
+        {
+            // Free the underlying allocation once queued work has completed.
+    #ifdef _GAMING_XBOX
+            m_context->QueueReference(WRAP_GRAPHICS_UNKNOWN(resource->GetD3D12Resource()).Get());
+    #else
+            m_context->QueueReference(resource->GetD3D12Resource());
+    #endif
+        }
+    }
+
+    void BucketizedBufferAllocator::Trim()
+    {
+        for (auto& bucket : m_pool)
+        {
+            for (auto& resource : bucket.resources)
+            {
+                ReleaseResource(resource.resource.Get());
+            }
+
+            bucket.resources.clear();
+        }
+
+        m_pooledBytes = 0;
     }
 
     void* BucketizedBufferAllocator::Alloc(size_t size)
@@ -114,7 +188,7 @@ namespace Dml
             if (bucket->resources.empty())
             {
                 // No more resources in this bucket - allocate a new one
-                resourceWrapper = m_subAllocator->Alloc(onnxruntime::narrow<size_t>(bucketSize));
+                resourceWrapper = AllocResource(bucketSize);
                 resourceId = ++m_currentResourceId;
             }
             else
@@ -123,13 +197,14 @@ namespace Dml
                 resourceWrapper = std::move(bucket->resources.back().resource);
                 resourceId = bucket->resources.back().resourceId;
                 bucket->resources.pop_back();
+                m_pooledBytes -= bucketSize;
             }
         }
         else
         {
             // The allocation will not be pooled.  Construct a new one
             bucketSize = (size + 3) & ~3;
-            resourceWrapper = m_subAllocator->Alloc(onnxruntime::narrow<size_t>(bucketSize));
+            resourceWrapper = AllocResource(bucketSize);
             resourceId = ++m_currentResourceId;
         }
 
@@ -183,20 +258,11 @@ namespace Dml
 
             Resource resource = {allocInfo->DetachResourceWrapper(), pooledResourceId};
             bucket->resources.push_back(resource);
+            m_pooledBytes += GetBucketSizeFromIndex(bucketIndex);
         }
         else
         {
-            if (!m_context->IsClosed())
-            {
-                // Free the underlying allocation once queued work has completed.
-    #ifdef _GAMING_XBOX
-                m_context->QueueReference(WRAP_GRAPHICS_UNKNOWN(allocInfo->GetResource()).Get());
-    #else
-                m_context->QueueReference(allocInfo->GetResource());
-    #endif
-            }
-
-            allocInfo->DetachResourceWrapper();
+            ReleaseResource(allocInfo->DetachResourceWrapper().Get());
         }
 
     #if _DEBUG
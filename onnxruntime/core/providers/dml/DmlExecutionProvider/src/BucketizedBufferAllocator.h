@@ -8,6 +8,10 @@
 #include "DmlResourceWrapper.h"
 #include "AllocationInfo.h"
 
+#ifndef _GAMING_XBOX
+#include <dxgi1_4.h>
+#endif
+
 namespace Dml
 {
     class DmlSubAllocator;
@@ -25,6 +29,8 @@ namespace Dml
     // maintains a set of fixed-size buckets, with each bucket containing one or more D3D12 buffers of that fixed size.
     // All requested allocation sizes are rounded up to the nearest bucket size, which ensures minimal fragmentation
     // while providing an upper bound on the amount of memory "wasted" with each allocation.
+    // The pooled buffers are released when the video memory used by the process reaches its budget, so that they
+    // don't take the memory of new allocations (e.g. on integrated GPUs sharing the system memory).
     class BucketizedBufferAllocator : public onnxruntime::IAllocator
     {
     public:
@@ -46,6 +52,9 @@ namespace Dml
 
         void SetDefaultRoundingMode(AllocatorRoundingMode roundingMode);
 
+        // Releases the pooled buffers which aren't in use, once the queued work has completed.
+        void Trim();
+
     public: // onnxruntime::IAllocator
         void* Alloc(size_t size, AllocatorRoundingMode roundingMode);
         void* Alloc(size_t size) final;
@@ -53,10 +62,11 @@ namespace Dml
 
     private:
         static const uint32_t c_minResourceSizeExponent = 16; // 2^16 = 64KB
+        static const uint32_t c_bucketsPerPowerOfTwo = 4;
 
         // The pool consists of a number of buckets, and each bucket contains a number of resources of the same size.
-        // The resources in each bucket are always sized as a power of two, and each bucket contains resources twice
-        // as large as the previous bucket.
+        // Each power of two is split into c_bucketsPerPowerOfTwo buckets of evenly spaced sizes (e.g. 1MB, 1.25MB,
+        // 1.5MB and 1.75MB), which bounds the memory wasted by the rounding to 25% instead of 100%.
         struct Resource
         {
             ComPtr<DmlResourceWrapper> resource;
@@ -74,6 +84,11 @@ namespace Dml
         friend class AllocationInfo;
         void FreeResource(void* p, uint64_t resourceId);
 
+        // Allocates a new resource, trimming the pool first if the allocation would exceed the video memory budget
+        ComPtr<DmlResourceWrapper> AllocResource(uint64_t size);
+        bool IsOverBudget(uint64_t size) const;
+        void ReleaseResource(DmlResourceWrapper* resource);
+
         ComPtr<ID3D12Device> m_device;
         D3D12_HEAP_PROPERTIES m_heapProperties;
         D3D12_HEAP_FLAGS m_heapFlags;
@@ -81,6 +96,7 @@ namespace Dml
         D3D12_RESOURCE_STATES m_initialState;
 
         std::vector<Bucket> m_pool;
+        uint64_t m_pooledBytes = 0;
         size_t m_currentAllocationId = 0;
         uint64_t m_currentResourceId = 0;
 
@@ -92,6 +108,11 @@ namespace Dml
         ComPtr<ExecutionContext> m_context;
         std::unique_ptr<DmlSubAllocator> m_subAllocator;
 
+    #ifndef _GAMING_XBOX
+        // Adapter of the device, to query the video memory budget. Null if it isn't available.
+        ComPtr<IDXGIAdapter3> m_adapter;
+    #endif
+
     #ifndef NDEBUG
         // Useful for debugging; keeps track of all allocations that haven't been freed yet
         std::map<size_t, AllocationInfo*> m_outstandingAllocationsById;
@@ -2,6 +2,7 @@
 
 #include "DmlGraphFusionHelper.h"
 #include "DmlRuntimeFusedGraphKernel.h"
+#include "core/framework/murmurhash3.h"
 
 using namespace Windows::AI::MachineLearning::Adapter;
 
@@ -517,6 +518,60 @@ namespace DmlGraphFusionHelper
         return partitionNodePropsMap;
     }
 
+    // Hash the description of the graph and how it maps to the inputs of the fused node, which is all the compiled
+    // operator depends on. Returns false if the graph can't be serialized, it is then compiled without caching.
+    static bool TryGetCompiledGraphKey(
+        const GraphDescBuilder::GraphDesc& graphDesc,
+        DML_EXECUTION_FLAGS executionFlags,
+        const std::unordered_map<uint32_t, uint32_t>* serializedGraphInputIndexToSubgraphInputIndex,
+        const std::unordered_map<std::string_view, uint32_t>* serializedGraphLargeConstantNameToSubgraphInputIndex,
+        /*out*/ ExecutionProviderImpl::CompiledGraphKey& key)
+    {
+        flatbuffers::DetachedBuffer serializedGraph;
+        try
+        {
+            serializedGraph = SerializeDmlGraph(graphDesc);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+
+        key = {static_cast<uint32_t>(executionFlags), graphDesc.reuseCommandList ? 1u : 0u, 0, 0};
+        auto update = [&key](const void* data, size_t size)
+        {
+            onnxruntime::MurmurHash3::x86_128(data, gsl::narrow<int>(size), key[0], key.data());
+        };
+
+        update(serializedGraph.data(), serializedGraph.size());
+
+        if (serializedGraphInputIndexToSubgraphInputIndex)
+        {
+            std::map<uint32_t, uint32_t> inputIndices(
+                serializedGraphInputIndexToSubgraphInputIndex->begin(),
+                serializedGraphInputIndexToSubgraphInputIndex->end());
+            for (const auto& [graphInputIndex, subgraphInputIndex] : inputIndices)
+            {
+                const uint32_t indices[] = {graphInputIndex, subgraphInputIndex};
+                update(indices, sizeof(indices));
+            }
+        }
+
+        if (serializedGraphLargeConstantNameToSubgraphInputIndex)
+        {
+            std::map<std::string_view, uint32_t> constantIndices(
+                serializedGraphLargeConstantNameToSubgraphInputIndex->begin(),
+                serializedGraphLargeConstantNameToSubgraphInputIndex->end());
+            for (const auto& [constantName, subgraphInputIndex] : constantIndices)
+            {
+                update(constantName.data(), constantName.size());
+                update(&subgraphInputIndex, sizeof(subgraphInputIndex));
+            }
+        }
+
+        return true;
+    }
+
     Microsoft::WRL::ComPtr<IDMLCompiledOperator> TryCreateCompiledOperator(
         const GraphDescBuilder::GraphDesc& graphDesc,
         const onnxruntime::IndexedSubGraph& indexedSubGraph,
@@ -527,6 +582,34 @@ namespace DmlGraphFusionHelper
         const uint32_t fusedNodeInputCount = gsl::narrow_cast<uint32_t>(indexedSubGraph.GetMetaDef()->inputs.size());
         const uint32_t fusedNodeOutputCount = gsl::narrow_cast<uint32_t>(indexedSubGraph.GetMetaDef()->outputs.size());
 
+        DML_EXECUTION_FLAGS executionFlags = DML_EXECUTION_FLAG_NONE;
+        if (graphDesc.reuseCommandList)
+        {
+            executionFlags |= DML_EXECUTION_FLAG_DESCRIPTORS_VOLATILE;
+        }
+
+        // Query DML execution provider to see if metacommands is enabled
+        if (!providerImpl->MetacommandsEnabled())
+        {
+            executionFlags |= DML_EXECUTION_FLAG_DISABLE_META_COMMANDS;
+        }
+
+        ExecutionProviderImpl::CompiledGraphKey compiledGraphKey;
+        const bool cacheCompiledGraph = TryGetCompiledGraphKey(
+            graphDesc,
+            executionFlags,
+            serializedGraphInputIndexToSubgraphInputIndex,
+            serializedGraphLargeConstantNameToSubgraphInputIndex,
+            compiledGraphKey);
+
+        if (cacheCompiledGraph)
+        {
+            if (auto compiledOperator = providerImpl->FindCompiledGraph(compiledGraphKey))
+            {
+                return compiledOperator;
+            }
+        }
+
         // convert DML EP GraphDesc into DML_GRAPH_DESC and create IDMLCompiledOperator
         ComPtr<IDMLDevice> device;
         ORT_THROW_IF_FAILED(providerImpl->GetDmlDevice(device.GetAddressOf()));
@@ -553,19 +636,6 @@ namespace DmlGraphFusionHelper
             dmlOutputEdges,
             dmlIntermediateEdges);
 
-        DML_EXECUTION_FLAGS executionFlags = DML_EXECUTION_FLAG_NONE;
-        if (graphDesc.reuseCommandList)
-        {
-            executionFlags |= DML_EXECUTION_FLAG_DESCRIPTORS_VOLATILE;
-        }
-
-        // Query DML execution provider to see if metacommands is enabled
-        if (!providerImpl->MetacommandsEnabled())
-        {
-            executionFlags |= DML_EXECUTION_FLAG_DISABLE_META_COMMANDS;
-        }
-
-
         ComPtr<IDMLDevice1> device1;
         ORT_THROW_IF_FAILED(device.As(&device1));
 
@@ -581,6 +651,11 @@ namespace DmlGraphFusionHelper
             return nullptr;
         }
 
+        if (cacheCompiledGraph)
+        {
+            providerImpl->AddCompiledGraph(compiledGraphKey, compiledExecutionPlanOperator);
+        }
+
         return compiledExecutionPlanOperator;
     }
 
@@ -1143,6 +1143,29 @@ namespace Dml
         return m_areMetacommandsEnabled;
     }
 
+    ComPtr<IDMLCompiledOperator> ExecutionProviderImpl::FindCompiledGraph(const CompiledGraphKey& key) const
+    {
+        std::lock_guard<std::mutex> lock(m_compiledGraphsMutex);
+        auto it = std::find_if(m_compiledGraphs.begin(), m_compiledGraphs.end(), [&key](const auto& entry) { return entry.first == key; });
+        if (it == m_compiledGraphs.end())
+        {
+            return nullptr;
+        }
+
+        m_compiledGraphs.splice(m_compiledGraphs.begin(), m_compiledGraphs, it);
+        return m_compiledGraphs.front().second;
+    }
+
+    void ExecutionProviderImpl::AddCompiledGraph(const CompiledGraphKey& key, ComPtr<IDMLCompiledOperator> compiledOperator) const
+    {
+        std::lock_guard<std::mutex> lock(m_compiledGraphsMutex);
+        m_compiledGraphs.emplace_front(key, std::move(compiledOperator));
+        if (m_compiledGraphs.size() > m_maxCompiledGraphCount)
+        {
+            m_compiledGraphs.pop_back();
+        }
+    }
+
     bool ExecutionProviderImpl::CpuSyncSpinningEnabled() const noexcept
     {
         return m_cpuSyncSpinningEnabled;
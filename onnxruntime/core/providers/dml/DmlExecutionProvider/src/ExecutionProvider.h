@@ -8,6 +8,10 @@
 #include "core/providers/dml/DmlExecutionProvider/src/IExecutionProvider.h"
 #include "core/providers/dml/DmlExecutionProvider/src/DmlReusedCommandListState.h"
 
+#include <array>
+#include <list>
+#include <mutex>
+
 #include <wrl/client.h>
 #include <wrl/implements.h>
 
@@ -182,6 +186,12 @@ namespace Dml
         onnxruntime::common::Status OnSessionInitializationEnd();
         std::vector<onnxruntime::AllocatorPtr> CreatePreferredAllocators();
 
+        // Fused graphs compiled by this provider, keyed by a hash of their description and execution flags, so that
+        // identical partitions and the shapes seen before by a runtime fused graph aren't compiled again.
+        using CompiledGraphKey = std::array<uint32_t, 4>;
+        ComPtr<IDMLCompiledOperator> FindCompiledGraph(const CompiledGraphKey& key) const;
+        void AddCompiledGraph(const CompiledGraphKey& key, ComPtr<IDMLCompiledOperator> compiledOperator) const;
+
     private:
         void Initialize(ID3D12CommandQueue* queue, ExecutionProvider& executionProvider);
 
@@ -219,6 +229,11 @@ namespace Dml
         bool m_closed = false;
         mutable std::chrono::time_point<std::chrono::steady_clock> m_lastUploadFlushTime;
         static constexpr std::chrono::milliseconds m_batchFlushInterval = std::chrono::milliseconds(10);
+
+        // Most recently used first
+        mutable std::mutex m_compiledGraphsMutex;
+        mutable std::list<std::pair<CompiledGraphKey, ComPtr<IDMLCompiledOperator>>> m_compiledGraphs;
+        static constexpr size_t m_maxCompiledGraphCount = 32;
     };
 
     class DataTransfer : public onnxruntime::IDataTransfer
@@ -332,6 +347,18 @@ namespace Dml
             return m_impl->CreatePreferredAllocators();
         }
 
+        std::vector<onnxruntime::MatMulNBitsFormat> GetMatMulNBitsFormats() const final override
+        {
+            // MatMulNBits dequantizes B within its DML graph, which runs the same for every block size, and it
+            // ignores the accuracy level.
+            std::vector<onnxruntime::MatMulNBitsFormat> formats;
+            for (const int64_t blockSize : {16, 32, 64, 128, 256})
+            {
+                formats.push_back({4, blockSize, 0});
+            }
+            return formats;
+        }
+
         bool IsGraphCaptureEnabled() const override
         {
             return m_impl->GraphCaptureEnabled();
@@ -2,7 +2,10 @@
 // Licensed under the MIT License
 #include <fstream>
 #include <algorithm>
+#include <iomanip>
 #include <iterator>
+#include <map>
+#include <sstream>
 #include <unordered_map>
 #include <set>
 #include <filesystem>
@@ -12,6 +15,7 @@
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/common/safeint.h"
 #include "core/common/logging/severity.h"
+#include "core/framework/murmurhash3.h"
 #include "migraphx_execution_provider.h"
 #include "migraphx_execution_provider_utils.h"
 #include "migraphx_allocator.h"
@@ -109,6 +113,16 @@ MIGraphXExecutionProvider::MIGraphXExecutionProvider(const MIGraphXExecutionProv
   HIP_CALL_THROW(hipSetDevice(info_.device_id));
   t_ = migraphx::target(info.target_device.c_str());
 
+  // the compiled programs cached in a directory are only reused on the same GPU architecture and software versions
+  hipDeviceProp_t device_prop;
+  HIP_CALL_THROW(hipGetDeviceProperties(&device_prop, info_.device_id));
+  compiled_program_key_ = std::string{device_prop.gcnArchName} + "_hip" + std::to_string(HIP_VERSION) + "_" +
+                          info.target_device;
+#if defined(MIGRAPHX_VERSION_MAJOR)
+  compiled_program_key_ += "_migraphx" + std::to_string(MIGRAPHX_VERSION_MAJOR) + "." +
+                           std::to_string(MIGRAPHX_VERSION_MINOR) + "." + std::to_string(MIGRAPHX_VERSION_PATCH);
+#endif
+
   // whether fp16 is enable
   const std::string fp16_enable_env = onnxruntime::GetEnvironmentVar(migraphx_env_vars::kFP16Enable);
   if (!fp16_enable_env.empty()) {
@@ -1115,6 +1129,40 @@ void save_compiled_model(migraphx::program& prog, bool save_enable, std::string
   }
 }
 
+// With a directory as the path of the compiled programs, each program is cached in its own file in it, named after a
+// hash of the subgraph, of the input shapes it is compiled for, of the quantization and of compiled_program_key.
+// Any other path names a single program file.
+std::string get_compiled_program_path(const std::string& path, const std::string& onnx_string,
+                                      const std::map<std::string, std::vector<std::size_t>>& input_shapes,
+                                      const std::string& compiled_program_key, bool fp16_enable, bool int8_enable) {
+  std::error_code ec;
+  if (path.empty() || !std::filesystem::is_directory(path, ec)) {
+    return path;
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_data = [&hash](const void* data, std::size_t size) {
+    MurmurHash3::x86_128(data, gsl::narrow_cast<int32_t>(size), hash[0], &hash);
+  };
+  hash_data(onnx_string.data(), onnx_string.size());
+  for (const auto& [name, lens] : input_shapes) {
+    const std::size_t rank = lens.size();
+    hash_data(name.data(), name.size());
+    hash_data(&rank, sizeof(rank));
+    hash_data(lens.data(), rank * sizeof(std::size_t));
+  }
+  const std::string options = compiled_program_key + (fp16_enable ? "_fp16" : "") + (int8_enable ? "_int8" : "");
+  hash_data(options.data(), options.size());
+
+  std::ostringstream file_name;
+  file_name << std::hex << std::setfill('0');
+  for (uint32_t h : hash) {
+    file_name << std::setw(8) << h;
+  }
+  file_name << ".mxr";
+  return (std::filesystem::path(path) / file_name.str()).string();
+}
+
 Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused_nodes,
                                           std::vector<NodeComputeInfo>& node_compute_funcs) {
   migraphx::onnx_options options;
@@ -1152,7 +1200,9 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
     migraphx::program prog;
 
     if (!no_input_shape) {
-      if (!load_precompiled_model(prog, load_compiled_model_, std::string{load_compiled_path_})) {
+      const std::string load_path = get_compiled_program_path(load_compiled_path_, onnx_string_buffer, {},
+                                                               compiled_program_key_, fp16_enable_, int8_enable_);
+      if (!load_precompiled_model(prog, load_compiled_model_, load_path)) {
         LOGS_DEFAULT(INFO) << "No Input shapes detected quantizing model";
         prog = migraphx::parse_onnx_buffer(onnx_string_buffer, options);
 
@@ -1193,7 +1243,9 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
         prog.compile(t_, co);
         LOGS_DEFAULT(INFO) << "Model Compile: Complete" << std::endl;
 
-        save_compiled_model(prog, save_compiled_model_, save_compiled_path_);
+        save_compiled_model(prog, save_compiled_model_,
+                            get_compiled_program_path(save_compiled_path_, onnx_string_buffer, {},
+                                                      compiled_program_key_, fp16_enable_, int8_enable_));
       }
 
       auto prog_output_shapes = prog.get_output_shapes();
@@ -1246,6 +1298,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
       // from input data
       bool input_shape_match = true;
       migraphx::program_parameter_shapes param_shapes;
+      std::map<std::string, std::vector<std::size_t>> input_shapes;
       if (no_input_shape) {
         LOGS_DEFAULT(VERBOSE) << "Missing input shape setting input parameters again" << std::endl;
         for (auto& it : map_input_name_index) {
@@ -1256,6 +1309,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
           const auto tensor_shape = tensor_info.GetShape();
           std::vector<std::size_t> ort_lens(tensor_shape.begin(), tensor_shape.end());
           cmp_options.set_input_parameter_shape(name, ort_lens);
+          input_shapes[name] = ort_lens;
           input_shape_match = false;
         }
       } else {
@@ -1285,6 +1339,7 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
                 cmp_options.set_input_parameter_shape(name, ort_lens);
                 input_shape_match = false;
               }
+              input_shapes[name] = std::move(ort_lens);
             }
           }
         }
@@ -1293,7 +1348,10 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
       // input shapes are different, needs to re-parse onnx and
       // re-compile the program
       if (!input_shape_match) {
-        if (!load_precompiled_model(prog, load_compiled_model_, std::string{load_compiled_path_})) {
+        const std::string load_path = get_compiled_program_path(mgx_state->load_compiled_path, onnx_string,
+                                                                 input_shapes, compiled_program_key_, fp16_enable,
+                                                                 int8_enable);
+        if (!load_precompiled_model(prog, mgx_state->load_compiled_mode, load_path)) {
           LOGS_DEFAULT(VERBOSE) << "No Input shapes mismatch detected. Recompiling" << std::endl;
 #ifndef ENABLE_TRAINING_CORE
 #if HIP_VERSION_MAJOR > 6 || (HIP_VERSION_MAJOR == 6 && HIP_VERSION_MINOR >= 2)
@@ -1356,7 +1414,9 @@ Status MIGraphXExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>&
           co.set_exhaustive_tune_flag(exhaustive_tune_);
           prog.compile(t, co);
 
-          save_compiled_model(prog, mgx_state->save_compiled_mode, mgx_state->save_compiled_path);
+          save_compiled_model(prog, mgx_state->save_compiled_mode,
+                              get_compiled_program_path(mgx_state->save_compiled_path, onnx_string, input_shapes,
+                                                        compiled_program_key_, fp16_enable, int8_enable));
         }
 
         mgx_state->prog = prog;
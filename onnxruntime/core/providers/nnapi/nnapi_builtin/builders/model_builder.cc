@@ -644,6 +644,18 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
           nnapi_model_->compilation_, static_cast<int32_t>(exe_pref_)),
       "on setPreference");
 
+  // setCaching is only available since API level 29
+  if (!compilation_cache_dir_.empty() && nnapi_.ANeuralNetworksCompilation_setCaching != nullptr) {
+    constexpr size_t kCacheTokenSize = 32;  // ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN
+    ORT_RETURN_IF_NOT(compilation_cache_token_.size() == kCacheTokenSize,
+                      "The NNAPI compilation cache token must have ", kCacheTokenSize, " bytes");
+    RETURN_STATUS_ON_ERROR_WITH_NOTE(
+        nnapi_.ANeuralNetworksCompilation_setCaching(
+            nnapi_model_->compilation_, compilation_cache_dir_.c_str(),
+            reinterpret_cast<const uint8_t*>(compilation_cache_token_.data())),
+        "on setCaching");
+  }
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_.ANeuralNetworksCompilation_finish(nnapi_model_->compilation_),
       "on compilation finish");
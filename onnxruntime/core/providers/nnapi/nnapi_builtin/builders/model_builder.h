@@ -75,6 +75,14 @@ class ModelBuilder {
   // It is off by default
   void SetUseFp16(bool use_fp16) { use_fp16_ = use_fp16; }
 
+  // Let NNAPI cache the compiled model in cache_dir, under the cache token, a string of
+  // ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN (32) bytes that identifies the model
+  // It is off by default, and when NNAPI is older than API level 29
+  void SetCompilationCache(std::string cache_dir, std::string cache_token) {
+    compilation_cache_dir_ = std::move(cache_dir);
+    compilation_cache_token_ = std::move(cache_token);
+  }
+
   // Set NNAPI execution preference
   // Default preference is PREFER_FAST_SINGLE_ANSWER
   void SetExecutePreference(
@@ -123,6 +131,8 @@ class ModelBuilder {
 
   bool use_nchw_{false};
   bool use_fp16_{false};
+  std::string compilation_cache_dir_;
+  std::string compilation_cache_token_;
   android::nn::wrapper::ExecutePreference exe_pref_{
       android::nn::wrapper::ExecutePreference::PREFER_FAST_SINGLE_ANSWER};
 
@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/string_utils.h"
+#include "core/framework/compiled_partition_cache.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/node_unit.h"
 #include "core/graph/graph_viewer.h"
@@ -280,6 +281,13 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<FusedNodeAndGra
     nnapi::ModelBuilder builder(graph_viewer, *nnapi_handle_, nnapi_target_devices_, target_device_option_);
     builder.SetUseNCHW(nnapi_flags_ & NNAPI_FLAG_USE_NCHW);
     builder.SetUseFp16(nnapi_flags_ & NNAPI_FLAG_USE_FP16);
+    if (const auto* cache = GetCompiledPartitionCache(); cache != nullptr) {
+      // The device selection and the relaxation to fp16 change the compiled model. The key is 32 hex digits, which
+      // is the size of an NNAPI cache token.
+      const auto compile_options = MakeString(nnapi_flags_, ";", static_cast<int>(target_device_option_));
+      builder.SetCompilationCache(cache->GetEpDirectory(Type()).string(),
+                                  CompiledPartitionCache::ComputeKey(graph_viewer, Type(), compile_options));
+    }
 
     std::unique_ptr<nnapi::Model> nnapi_model;
     ORT_RETURN_IF_ERROR(builder.Compile(nnapi_model));
@@ -431,8 +431,11 @@ void BackendManager::Compute(OrtKernelContext* context) {
     use_dynamic_backend = false;
   } else if (use_dynamic_backend && subgraph_context_.has_dynamic_input_shape) {
     std::vector<std::vector<int64_t>> tensor_shapes = GetInputTensorShapes(ctx);
-    auto key = MakeMapKeyString(tensor_shapes, GetGlobalContext().device_type);
     std::shared_ptr<IBackend> dynamic_backend;
+    // Compute can be called concurrently. The lock is held while a backend is compiled so that a shape is only
+    // compiled once.
+    std::unique_lock<std::mutex> lock(backend_map_mutex_);
+    auto key = MakeMapKeyString(tensor_shapes, GetGlobalContext().device_type);
     auto search = backend_map_.find(key);
     if (search == backend_map_.end()) {
       LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
@@ -472,10 +475,19 @@ void BackendManager::Compute(OrtKernelContext* context) {
         }
 #endif
       }
-      backend_map_.insert({key, dynamic_backend});
+      if (backend_map_.size() >= kMaxDynamicBackends) {
+        LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
+                           << "Releasing dynamic backend for key: " << backend_lru_.back();
+        backend_map_.erase(backend_lru_.back());
+        backend_lru_.pop_back();
+      }
+      backend_lru_.push_front(key);
+      backend_map_.insert({key, DynamicBackend{dynamic_backend, backend_lru_.begin()}});
     } else {
-      dynamic_backend = search->second;
+      dynamic_backend = search->second.backend;
+      backend_lru_.splice(backend_lru_.begin(), backend_lru_, search->second.lru_entry);
     }
+    lock.unlock();
 
     dynamic_backend->Infer(context);
   } else {
@@ -4,8 +4,10 @@
 #pragma once
 
 #include <vector>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/providers/openvino/ov_interface.h"
@@ -49,7 +51,17 @@ class BackendManager {
 
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
-  std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
+  // backends compiled for the concrete input shapes of a dynamic model, when the device doesn't support dynamic shapes.
+  // the least recently used backend is released once there are kMaxDynamicBackends, so that models seeing many
+  // different shapes don't keep a compiled model per shape on the device.
+  struct DynamicBackend {
+    std::shared_ptr<IBackend> backend;
+    std::list<std::string>::iterator lru_entry;
+  };
+  static constexpr size_t kMaxDynamicBackends = 16;
+  std::map<std::string, DynamicBackend> backend_map_;
+  std::list<std::string> backend_lru_;  // most recently used first
+  std::mutex backend_map_mutex_;
   SubGraphContext subgraph_context_;
   GlobalContext global_context_;
   EPCtxHandler ep_ctx_handle_{};
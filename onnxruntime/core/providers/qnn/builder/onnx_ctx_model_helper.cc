@@ -3,6 +3,7 @@
 
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
 #include "core/graph/constants.h"
+#include "core/platform/env.h"
 #include "core/providers/qnn/builder/qnn_model.h"
 
 #include <iostream>
@@ -91,7 +92,8 @@ Status CreateNodeArgs(const std::vector<std::string>& names,
 Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
                                 const onnxruntime::PathString& ctx_onnx_model_path,
                                 QnnBackendManager* qnn_backend_manager,
-                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                bool share_ep_contexts) {
   ORT_RETURN_IF_NOT(EPCONTEXT_OP == main_context_node.OpType(), "Should only filter in the EPContext node.");
   NodeAttrHelper node_helper(main_context_node);
   bool is_embed_mode = node_helper.Get(EMBED_MODE, true);
@@ -100,7 +102,8 @@ Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
     return qnn_backend_manager->LoadCachedQnnContextFromBuffer(const_cast<char*>(context_binary.c_str()),
                                                                static_cast<uint64_t>(context_binary.length()),
                                                                main_context_node.Name(),
-                                                               qnn_models);
+                                                               qnn_models,
+                                                               share_ep_contexts);
   }
 
   std::filesystem::path folder_path = std::filesystem::path(ctx_onnx_model_path).parent_path();
@@ -131,34 +134,31 @@ Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context does not exist or is not accessible.");
   }
 
+  // Map the file instead of reading it, QNN creates the context from the mapped pages without another copy of the
+  // binary on the heap.
+  const Env& env = Env::Default();
   size_t buffer_size{0};
-  std::ifstream cache_file(context_binary_path.string().c_str(), std::ifstream::binary);
-  ORT_RETURN_IF(!cache_file || !cache_file.good(), "Failed to open cache file.");
-
-  cache_file.seekg(0, cache_file.end);
-  buffer_size = static_cast<size_t>(cache_file.tellg());
+  ORT_RETURN_IF_ERROR(env.GetFileLength(context_binary_path.native().c_str(), buffer_size));
   ORT_RETURN_IF(0 == buffer_size, "Empty cache file encountered.");
 
-  cache_file.seekg(0, cache_file.beg);
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(buffer_size);
-  ORT_RETURN_IF(nullptr == buffer, "Failed to allocate memory for cache file.");
-  // Load file into buffer
-  const auto& read_result = cache_file.read(buffer.get(), buffer_size);
-  ORT_RETURN_IF(!read_result, "Failed to read contents from cached context file.");
-  cache_file.close();
+  Env::MappedMemoryPtr buffer;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(context_binary_path.native().c_str(), 0, buffer_size, buffer));
   return qnn_backend_manager->LoadCachedQnnContextFromBuffer(buffer.get(),
                                                              static_cast<uint64_t>(buffer_size),
                                                              main_context_node.Name(),
-                                                             qnn_models);
+                                                             qnn_models,
+                                                             share_ep_contexts);
 }
 
 Status LoadQnnCtxFromOnnxGraph(const onnxruntime::GraphViewer& graph_viewer,
                                const onnxruntime::PathString& ctx_onnx_model_path,
                                QnnBackendManager* qnn_backend_manager,
                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
-                               const logging::Logger& logger) {
+                               const logging::Logger& logger,
+                               bool share_ep_contexts) {
   for (const auto& ep_context_node : graph_viewer.Nodes()) {
-    Status status = GetEpContextFromMainNode(ep_context_node, ctx_onnx_model_path, qnn_backend_manager, qnn_models);
+    Status status = GetEpContextFromMainNode(ep_context_node, ctx_onnx_model_path, qnn_backend_manager, qnn_models,
+                                             share_ep_contexts);
 
     // This is the protocol with customer that status with INVALID_GRAPH will be generated if failed to load context model
     if (!status.IsOK()) {
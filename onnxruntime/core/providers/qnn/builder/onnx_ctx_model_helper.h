@@ -51,13 +51,15 @@ bool ValidateContextCacheFilePath(bool is_qnn_ctx_model,
 Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
                                 const onnxruntime::PathString& ctx_onnx_model_path,
                                 QnnBackendManager* qnn_backend_manager,
-                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models);
+                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                bool share_ep_contexts = false);
 
 Status LoadQnnCtxFromOnnxGraph(const onnxruntime::GraphViewer& graph_viewer,
                                const onnxruntime::PathString& ctx_onnx_model_path,
                                QnnBackendManager* qnn_backend_manager,
                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
-                               const logging::Logger& logger);
+                               const logging::Logger& logger,
+                               bool share_ep_contexts = false);
 
 Status CreateEPContextNodes(Model* model,
                             unsigned char* buffer,
@@ -18,6 +18,7 @@
 #include "core/common/logging/capture.h"
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
 #include "core/providers/qnn/builder/qnn_configs_helper.h"
+#include "core/providers/qnn/qnn_allocator.h"
 
 #ifdef _WIN32
 #include <winmeta.h>
@@ -597,7 +598,8 @@ std::unique_ptr<unsigned char[]> QnnBackendManager::GetContextBinaryBuffer(uint6
 
 Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
                                                          std::string node_name,
-                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                                         bool share_ep_contexts) {
   bool result = nullptr == qnn_sys_interface_.systemContextCreate ||
                 nullptr == qnn_sys_interface_.systemContextGetBinaryInfo ||
                 nullptr == qnn_sys_interface_.systemContextFree;
@@ -660,6 +662,10 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
     for (uint32_t i = 0; i < graph_count; ++i) {
       std::string graph_name(graphs_info[i].graphInfoV1.graphName);
       auto qnn_model_pos = qnn_models.find(graph_name);
+      if (qnn_model_pos == qnn_models.end() && share_ep_contexts) {
+        // the graph of another session sharing this context
+        qnn_model_pos = qnn_models.emplace(graph_name, std::make_unique<qnn::QnnModel>(*logger_, this)).first;
+      }
       ORT_RETURN_IF(qnn_model_pos == qnn_models.end(), graph_name + " does not match any EPContext node names.");
       ORT_RETURN_IF_ERROR(qnn_model_pos->second->DeserializeGraphInfoFromBinaryInfo(graphs_info[i], context));
     }
@@ -678,6 +684,10 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
 Status QnnBackendManager::SetupBackend(const logging::Logger& logger, bool load_from_cached_context) {
   if (backend_setup_completed_) {
     LOGS(logger, VERBOSE) << "Backend setup already!";
+    // the backend may be shared with a session that didn't load a context binary
+    if (load_from_cached_context && system_lib_handle_ == nullptr) {
+      ORT_RETURN_IF_ERROR(LoadQnnSystemLib());
+    }
     return Status::OK();
   }
 
@@ -1342,9 +1352,92 @@ const std::string QnnBackendManager::ExtractQnnScalarValue(const Qnn_Scalar_t& s
 }
 
 QnnBackendManager::~QnnBackendManager() {
+  DeregisterAllMemHandles();
   ReleaseResources();
 }
 
+Status QnnBackendManager::GetOrRegisterMemHandle(Qnn_ContextHandle_t context, void* address, int fd,
+                                                 const Qnn_Tensor_t& qnn_tensor, Qnn_MemHandle_t& mem_handle) {
+  const Qnn_DataType_t data_type = GetQnnTensorDataType(qnn_tensor);
+  const uint32_t rank = GetQnnTensorRank(qnn_tensor);
+  uint32_t* dims = GetQnnTensorDims(qnn_tensor);
+
+  bool first_registration = true;
+  {
+    std::lock_guard<OrtMutex> lock(mem_handles_mutex_);
+    auto it = mem_handles_.find({address, context});
+    if (it != mem_handles_.end()) {
+      if (it->second.data_type == data_type &&
+          it->second.dims == std::vector<uint32_t>(dims, dims + rank)) {
+        mem_handle = it->second.mem_handle;
+        return Status::OK();
+      }
+
+      // the memory holds a tensor of another shape now
+      ORT_RETURN_IF(QNN_SUCCESS != qnn_interface_.memDeRegister(&it->second.mem_handle, 1),
+                    "Failed to deregister the shared memory from QNN.");
+      mem_handles_.erase(it);
+    }
+
+    for (const auto& entry : mem_handles_) {
+      if (entry.first.first == address) {
+        first_registration = false;
+        break;
+      }
+    }
+
+    Qnn_MemDescriptor_t mem_descriptor = QNN_MEM_DESCRIPTOR_INIT;
+    mem_descriptor.memShape = {rank, dims, nullptr};
+    mem_descriptor.dataType = data_type;
+    mem_descriptor.memType = QNN_MEM_TYPE_ION;
+    mem_descriptor.ionInfo.fd = fd;
+
+    Qnn_MemHandle_t registered_handle = nullptr;
+    const auto rt = qnn_interface_.memRegister(context, &mem_descriptor, 1, &registered_handle);
+    ORT_RETURN_IF(QNN_SUCCESS != rt, "Failed to register the shared memory with QNN. Error: ",
+                  QnnErrorHandleToString(rt));
+
+    mem_handles_.emplace(std::make_pair(address, context),
+                         RegisteredMemHandle{registered_handle, data_type, std::vector<uint32_t>(dims, dims + rank)});
+    mem_handle = registered_handle;
+  }
+
+  if (first_registration) {
+    ORT_RETURN_IF_ERROR(HtpSharedMemoryAllocator::AddAllocationCleanUp(address, this, [this, address]() {
+      ORT_IGNORE_RETURN_VALUE(DeregisterMemHandles(address));
+    }));
+  }
+
+  return Status::OK();
+}
+
+Status QnnBackendManager::DeregisterMemHandles(void* address) {
+  std::lock_guard<OrtMutex> lock(mem_handles_mutex_);
+  bool failed = false;
+  for (auto it = mem_handles_.begin(); it != mem_handles_.end();) {
+    if (it->first.first == address) {
+      failed |= QNN_SUCCESS != qnn_interface_.memDeRegister(&it->second.mem_handle, 1);
+      it = mem_handles_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  ORT_RETURN_IF(failed, "Failed to deregister the shared memory from QNN.");
+  return Status::OK();
+}
+
+void QnnBackendManager::DeregisterAllMemHandles() {
+  std::lock_guard<OrtMutex> lock(mem_handles_mutex_);
+  for (auto& [key, registered] : mem_handles_) {
+    HtpSharedMemoryAllocator::RemoveAllocationCleanUp(key.first, this);
+    if (QNN_SUCCESS != qnn_interface_.memDeRegister(&registered.mem_handle, 1)) {
+      LOGS_DEFAULT(WARNING) << "Failed to deregister the shared memory from QNN.";
+    }
+  }
+  mem_handles_.clear();
+}
+
 void* QnnBackendManager::LoadLib(const char* file_name, int flags, std::string& error_msg) {
 #ifdef _WIN32
   DWORD as_is, to_be;
@@ -11,9 +11,11 @@
 #include <dlfcn.h>
 #endif
 
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "HTP/QnnHtpDevice.h"
 #include "QnnLog.h"
@@ -22,6 +24,7 @@
 #include "core/common/status.h"
 #include "core/common/logging/logging.h"
 #include "core/common/path_string.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/qnn/builder/qnn_def.h"
 
 namespace onnxruntime {
@@ -87,9 +90,12 @@ class QnnBackendManager {
 
   std::unique_ptr<unsigned char[]> GetContextBinaryBuffer(uint64_t& written_buffer_size);
 
+  // With share_ep_contexts, the graphs of the binary that don't match a model of `qnn_models` are added to it
+  // instead of failing, to be used by other sessions.
   Status LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
                                         std::string node_name,
-                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models);
+                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                        bool share_ep_contexts = false);
 
   Status SetupBackend(const logging::Logger& logger, bool load_from_cached_context);
 
@@ -159,6 +165,11 @@ class QnnBackendManager {
 
   Status DestroyHTPPowerConfigID(uint32_t htp_power_config_id);
 
+  // Get the QNN memory handle of the shared memory `fd` holding the data of `qnn_tensor` at `address`, registering it
+  // with `context` the first time. The handle is deregistered when the memory is freed.
+  Status GetOrRegisterMemHandle(Qnn_ContextHandle_t context, void* address, int fd, const Qnn_Tensor_t& qnn_tensor,
+                                Qnn_MemHandle_t& mem_handle);
+
  private:
   void* LoadLib(const char* file_name, int flags, std::string& error_msg);
 
@@ -211,6 +222,9 @@ class QnnBackendManager {
                                     std::ofstream& outfile, bool tracelogging_provider_ep_enabled);
   Status ExtractProfilingEventExtended(QnnProfile_EventId_t profile_event_id, const std::string& eventLevel,
                                        std::ofstream& outfile, bool tracelogging_provider_ep_enabled);
+  Status DeregisterMemHandles(void* address);
+  void DeregisterAllMemHandles();
+
   static const std::string& GetUnitString(QnnProfile_EventUnit_t unitType);
   static const std::unordered_map<QnnProfile_EventUnit_t, std::string>& GetUnitStringMap();
   static const std::string GetEventTypeString(QnnProfile_EventType_t eventType);
@@ -241,6 +255,15 @@ class QnnBackendManager {
   Qnn_LogHandle_t log_handle_ = nullptr;
   Qnn_DeviceHandle_t device_handle_ = nullptr;
   std::vector<Qnn_ContextHandle_t> contexts_;
+
+  struct RegisteredMemHandle {
+    Qnn_MemHandle_t mem_handle;
+    Qnn_DataType_t data_type;
+    std::vector<uint32_t> dims;
+  };
+  // memory handles of the shared memory registered with QNN, by address and context
+  std::map<std::pair<void*, Qnn_ContextHandle_t>, RegisteredMemHandle> mem_handles_;
+  OrtMutex mem_handles_mutex_;
   ProfilingLevel profiling_level_etw_;
   ProfilingLevel profiling_level_;
   ProfilingLevel profiling_level_merge_;
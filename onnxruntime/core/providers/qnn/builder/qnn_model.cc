@@ -13,6 +13,7 @@
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
 #include "core/providers/qnn/builder/qnn_utils.h"
+#include "core/providers/qnn/qnn_allocator.h"
 
 namespace onnxruntime {
 namespace qnn {
@@ -112,7 +113,8 @@ Status QnnModel::ComposeGraph(const GraphViewer& graph_viewer,
                                                       initializer_inputs_,
                                                       qnn_backend_manager_->GetQnnBackendType());
   bool rt = true;
-  rt = qnn_model_wrapper.CreateQnnGraph(qnn_backend_manager_->GetQnnContext(), graph_name, graph_configs);
+  context_ = qnn_backend_manager_->GetQnnContext();
+  rt = qnn_model_wrapper.CreateQnnGraph(context_, graph_name, graph_configs);
   if (!rt) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to initialize qnn_model_wrapper.");
   }
@@ -178,6 +180,24 @@ Status QnnModel::SetupQnnInputOutput() {
   return Status::OK();
 }
 
+Status QnnModel::SetQnnTensorBuffer(Qnn_Tensor_t& qnn_tensor, void* data, uint32_t data_size) {
+  void* allocation_base = nullptr;
+  int fd = -1;
+  size_t allocation_size = 0;
+  // the HTP accesses the shared memory of a tensor in place when the tensor is the whole allocation
+  if (HtpSharedMemoryAllocator::GetAllocationInfo(data, allocation_base, fd, allocation_size) &&
+      allocation_base == data) {
+    Qnn_MemHandle_t mem_handle = nullptr;
+    ORT_RETURN_IF_ERROR(qnn_backend_manager_->GetOrRegisterMemHandle(context_, data, fd, qnn_tensor, mem_handle));
+    SetQnnTensorMemType(qnn_tensor, QNN_TENSORMEMTYPE_MEMHANDLE);
+    SetQnnTensorMemHandle(qnn_tensor, mem_handle);
+    return Status::OK();
+  }
+
+  SetQnnTensorClientBuf(qnn_tensor, data, data_size);
+  return Status::OK();
+}
+
 Status QnnModel::ExecuteGraph(const Ort::KernelContext& context) {
   LOGS(logger_, VERBOSE) << "QnnModel::ExecuteGraphs";
   const size_t num_inputs = context.GetInputCount();
@@ -208,8 +228,8 @@ Status QnnModel::ExecuteGraph(const Ort::KernelContext& context) {
                       "ORT Tensor data size does not match QNN tensor data size.");
 
     qnn_inputs.push_back(qnn_input_info.tensor_wrapper->GetQnnTensor());
-    SetQnnTensorClientBuf(qnn_inputs.back(),
-                          const_cast<void*>(ort_input_tensor.GetTensorData<void>()), qnn_input_info.tensor_byte_size);
+    ORT_RETURN_IF_ERROR(SetQnnTensorBuffer(qnn_inputs.back(), const_cast<void*>(ort_input_tensor.GetTensorData<void>()),
+                                           qnn_input_info.tensor_byte_size));
   }
 
   std::vector<Qnn_Tensor_t> qnn_outputs;
@@ -228,8 +248,8 @@ Status QnnModel::ExecuteGraph(const Ort::KernelContext& context) {
                       "ORT Tensor data size does not match QNN tensor data size");
 
     qnn_outputs.push_back(qnn_output_info.tensor_wrapper->GetQnnTensor());
-    SetQnnTensorClientBuf(qnn_outputs.back(),
-                          const_cast<void*>(ort_output_tensor.GetTensorData<void>()), qnn_output_info.tensor_byte_size);
+    ORT_RETURN_IF_ERROR(SetQnnTensorBuffer(qnn_outputs.back(), ort_output_tensor.GetTensorMutableData<void>(),
+                                           qnn_output_info.tensor_byte_size));
   }
 
   LOGS(logger_, VERBOSE) << "Start execute QNN graph:" << graph_info_->Name();
@@ -310,6 +330,7 @@ Status QnnModel::SetupTensors(std::vector<QnnTensorInfo>& qnn_tensor_infos,
 
 Status QnnModel::DeserializeGraphInfoFromBinaryInfo(const QnnSystemContext_GraphInfo_t& qnn_sys_ctx_graph_info,
                                                     const Qnn_ContextHandle_t& context) {
+  context_ = context;
   std::vector<QnnTensorWrapper> input_tensor_wrappers;
   std::vector<QnnTensorWrapper> output_tensor_wrappers;
 
@@ -118,6 +118,9 @@ class QnnModel {
 
   QnnBackendType GetQnnBackendType() { return qnn_backend_type_; }
 
+  // Point `qnn_tensor` to the data of an ORT tensor, through a memory handle if it is in HTP shared memory.
+  Status SetQnnTensorBuffer(Qnn_Tensor_t& qnn_tensor, void* data, uint32_t data_size);
+
   size_t GetInputOutputIndex(const std::string& name, const std::unordered_map<std::string, OnnxTensorInfo>& io_info) const {
     auto it = io_info.find(name);
     ORT_ENFORCE(it != io_info.end(), "Input/Output name not found.");
@@ -128,6 +131,8 @@ class QnnModel {
   const logging::Logger& logger_;
   std::unique_ptr<GraphInfo> graph_info_;
   QnnBackendManager* qnn_backend_manager_ = nullptr;
+  // the context of the graph, the shared memory of the inputs and outputs is registered with it
+  Qnn_ContextHandle_t context_ = nullptr;
   // <input_name, input_index>, initializer inputs are excluded, keep the input index here
   std::unordered_map<std::string, size_t> model_input_index_map_;
   std::unordered_map<std::string, size_t> model_output_index_map_;
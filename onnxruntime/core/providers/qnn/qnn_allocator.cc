@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/qnn/qnn_allocator.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace qnn {
+
+namespace {
+
+struct AllocationInfo {
+  size_t size;
+  int fd;
+  std::unordered_map<const void*, std::function<void()>> clean_ups;
+};
+
+// The allocations of all the HtpSharedMemoryAllocator instances, ordered by address to find the allocation of an
+// address inside of it.
+struct AllocationRegistry {
+  OrtMutex mutex;
+  std::map<const char*, AllocationInfo> allocations;
+
+  static AllocationRegistry& Instance() {
+    static AllocationRegistry registry;
+    return registry;
+  }
+};
+
+}  // namespace
+
+HtpSharedMemoryAllocator::HtpSharedMemoryAllocator(std::shared_ptr<RpcMemLibrary> rpcmem_lib)
+    : IAllocator{OrtMemoryInfo{QNN_HTP_SHARED, OrtAllocatorType::OrtDeviceAllocator,
+                               OrtDevice{OrtDevice::CPU, OrtDevice::MemType::QNN_HTP_SHARED, 0}, 0,
+                               OrtMemTypeDefault}},
+      rpcmem_lib_{std::move(rpcmem_lib)} {
+}
+
+void* HtpSharedMemoryAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  void* p = rpcmem_lib_->Alloc(size);
+  ORT_ENFORCE(p != nullptr, "rpcmem_alloc failed to allocate ", size, " bytes.");
+
+  const int fd = rpcmem_lib_->ToFd(p);
+  if (fd < 0) {
+    rpcmem_lib_->Free(p);
+    ORT_THROW("rpcmem_to_fd failed for an allocation of ", size, " bytes.");
+  }
+
+  auto& registry = AllocationRegistry::Instance();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  registry.allocations.emplace(static_cast<const char*>(p), AllocationInfo{size, fd, {}});
+  return p;
+}
+
+void HtpSharedMemoryAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  std::unordered_map<const void*, std::function<void()>> clean_ups;
+  {
+    auto& registry = AllocationRegistry::Instance();
+    std::lock_guard<OrtMutex> lock(registry.mutex);
+    auto it = registry.allocations.find(static_cast<const char*>(p));
+    ORT_ENFORCE(it != registry.allocations.end(), "The buffer wasn't allocated by HtpSharedMemoryAllocator.");
+    clean_ups = std::move(it->second.clean_ups);
+    registry.allocations.erase(it);
+  }
+
+  // the clean ups may take the locks of their owners, so they run without the lock of the registry
+  for (auto& [owner, clean_up] : clean_ups) {
+    clean_up();
+  }
+
+  rpcmem_lib_->Free(p);
+}
+
+bool HtpSharedMemoryAllocator::GetAllocationInfo(const void* address, void*& allocation_base, int& fd,
+                                                 size_t& allocation_size) {
+  auto& registry = AllocationRegistry::Instance();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  if (registry.allocations.empty()) {
+    return false;
+  }
+
+  const char* p = static_cast<const char*>(address);
+  auto it = registry.allocations.upper_bound(p);
+  if (it == registry.allocations.begin()) {
+    return false;
+  }
+
+  --it;
+  if (p >= it->first + it->second.size) {
+    return false;
+  }
+
+  allocation_base = const_cast<char*>(it->first);
+  fd = it->second.fd;
+  allocation_size = it->second.size;
+  return true;
+}
+
+Status HtpSharedMemoryAllocator::AddAllocationCleanUp(void* allocation_base, const void* owner,
+                                                      std::function<void()>&& clean_up) {
+  auto& registry = AllocationRegistry::Instance();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  auto it = registry.allocations.find(static_cast<const char*>(allocation_base));
+  ORT_RETURN_IF(it == registry.allocations.end(), "The buffer wasn't allocated by HtpSharedMemoryAllocator.");
+  it->second.clean_ups[owner] = std::move(clean_up);
+  return Status::OK();
+}
+
+void HtpSharedMemoryAllocator::RemoveAllocationCleanUp(void* allocation_base, const void* owner) {
+  auto& registry = AllocationRegistry::Instance();
+  std::lock_guard<OrtMutex> lock(registry.mutex);
+  auto it = registry.allocations.find(static_cast<const char*>(allocation_base));
+  if (it != registry.allocations.end()) {
+    it->second.clean_ups.erase(owner);
+  }
+}
+
+}  // namespace qnn
+}  // namespace onnxruntime
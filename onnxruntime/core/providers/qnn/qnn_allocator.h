@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "core/framework/allocator.h"
+#include "core/providers/qnn/rpcmem_library.h"
+
+namespace onnxruntime {
+namespace qnn {
+
+// Allocates the tensors shared between the CPU and the HTP in rpcmem. The QNN EP registers such a buffer with QNN
+// the first time it is an input or output of a QNN graph, then the HTP reads and writes it in place.
+// Use it to allocate the inputs and outputs bound with IOBinding (OrtMemoryInfo named QNN_HTP_SHARED).
+class HtpSharedMemoryAllocator : public IAllocator {
+ public:
+  explicit HtpSharedMemoryAllocator(std::shared_ptr<RpcMemLibrary> rpcmem_lib);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  // Find the allocation of this allocator containing `address`. Returns false if `address` isn't shared memory.
+  static bool GetAllocationInfo(const void* address, void*& allocation_base, int& fd, size_t& allocation_size);
+
+  // Run `clean_up` when the allocation starting at `allocation_base` is freed, e.g. to deregister it from QNN.
+  // `owner` identifies the clean up, the owner removes it with RemoveAllocationCleanUp if it is destroyed first.
+  static Status AddAllocationCleanUp(void* allocation_base, const void* owner, std::function<void()>&& clean_up);
+  static void RemoveAllocationCleanUp(void* allocation_base, const void* owner);
+
+ private:
+  std::shared_ptr<RpcMemLibrary> rpcmem_lib_;
+};
+
+}  // namespace qnn
+}  // namespace onnxruntime
@@ -22,6 +22,7 @@
 #include "core/providers/qnn/builder/qnn_node_group.h"
 #include "core/providers/qnn/builder/qnn_def.h"
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
+#include "core/providers/qnn/shared_context.h"
 #include "core/framework/run_options.h"
 
 #ifdef _WIN32
@@ -206,6 +207,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     // User can set this context_node_name_prefix for each split pieces to avoid that happens.
     context_node_name_prefix_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionEpContextNodeNamePrefix, "");
     LOGS_DEFAULT(VERBOSE) << "User specified QNN context node name prefix: " << context_node_name_prefix_;
+
+    share_ep_contexts_ = session_options->config_options.GetConfigOrDefault(
+                             kOrtSessionOptionShareEpContexts, "0") == "1";
+    LOGS_DEFAULT(VERBOSE) << "User specified option - share EP contexts across sessions: " << share_ep_contexts_;
   }
 
   static const std::string BACKEND_PATH = "backend_path";
@@ -385,7 +390,21 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     LOGS_DEFAULT(VERBOSE) << "User specified enable_htp_fp16_precision: " << enable_HTP_FP16_precision_;
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
+  static const std::string QNN_HTP_SHARED_MEMORY_ALLOCATOR = "enable_htp_shared_memory_allocator";
+  auto htp_shared_memory_allocator_pos = provider_options_map.find(QNN_HTP_SHARED_MEMORY_ALLOCATOR);
+  if (htp_shared_memory_allocator_pos != provider_options_map.end()) {
+    if ("1" == htp_shared_memory_allocator_pos->second) {
+      enable_htp_shared_memory_allocator_ = true;
+    } else if ("0" == htp_shared_memory_allocator_pos->second) {
+      enable_htp_shared_memory_allocator_ = false;
+    } else {
+      LOGS_DEFAULT(VERBOSE) << "Invalid enable_htp_shared_memory_allocator: " << htp_shared_memory_allocator_pos->second
+                            << " only 0 or 1 allowed. Set to 0.";
+    }
+    LOGS_DEFAULT(VERBOSE) << "User specified enable_htp_shared_memory_allocator: " << enable_htp_shared_memory_allocator_;
+  }
+
+  qnn_backend_manager_ = std::make_shared<qnn::QnnBackendManager>(
       std::move(backend_path),
       profiling_level_etw,
       profiling_level,
@@ -395,6 +414,23 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
       device_id_,
       htp_arch,
       soc_model);
+
+  if (share_ep_contexts_) {
+    // the options of the first session sharing the EP contexts apply to the backend
+    qnn_backend_manager_ = SharedContext::GetInstance().GetOrSetSharedQnnBackendManager(qnn_backend_manager_);
+  }
+}
+
+std::vector<AllocatorPtr> QNNExecutionProvider::CreatePreferredAllocators() {
+  std::vector<AllocatorPtr> allocators{};
+  if (enable_htp_shared_memory_allocator_) {
+    // the rpcmem library is only available on Qualcomm devices, load it when the allocator is requested
+    if (!rpcmem_library_) {
+      rpcmem_library_ = std::make_shared<qnn::RpcMemLibrary>();
+    }
+    allocators.emplace_back(std::make_shared<qnn::HtpSharedMemoryAllocator>(rpcmem_library_));
+  }
+  return allocators;
 }
 
 QNNExecutionProvider::~QNNExecutionProvider() {
@@ -578,7 +614,14 @@ QNNExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer
 
   // It will load the QnnSystem lib if is_qnn_ctx_model=true, and
   // delay the Qnn context creation to Compile() using the cached context binary
-  auto rt = qnn_backend_manager_->SetupBackend(logger, is_qnn_ctx_model);
+  Status rt;
+  if (share_ep_contexts_) {
+    // the shared backend outlives this session, it logs with the default logger
+    std::lock_guard<OrtMutex> lock(SharedContext::GetInstance().LoadMutex());
+    rt = qnn_backend_manager_->SetupBackend(logging::LoggingManager::DefaultLogger(), is_qnn_ctx_model);
+  } else {
+    rt = qnn_backend_manager_->SetupBackend(logger, is_qnn_ctx_model);
+  }
   if (Status::OK() != rt) {
     LOGS(logger, ERROR) << "QNN SetupBackend failed " << rt.ErrorMessage();
     return result;
@@ -810,18 +853,40 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
     // for this session (created from an EP context model), the graph_meta_id is new
     std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> qnn_models;
 
+    std::unique_lock<OrtMutex> shared_lock;
+    if (share_ep_contexts_) {
+      shared_lock = std::unique_lock<OrtMutex>(SharedContext::GetInstance().LoadMutex());
+    }
+
     std::vector<int> main_context_pos_list;
     ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
                                                 logger, main_context_pos_list, qnn_models));
 
+    // Take the graphs that another session loaded from the same context binary
+    std::unordered_set<std::string> shared_graph_names;
+    if (share_ep_contexts_) {
+      for (auto& [name, qnn_model] : qnn_models) {
+        if (auto shared_qnn_model = SharedContext::GetInstance().GetSharedQnnModel(name)) {
+          qnn_model = std::move(shared_qnn_model);
+          shared_graph_names.insert(name);
+        }
+      }
+    }
+
     for (auto main_context_pos : main_context_pos_list) {
       const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
+      if (shared_graph_names.count(main_ctx_graph_viewer.Nodes().begin()->Name()) > 0) {
+        LOGS(logger, VERBOSE) << "Use the QNN context shared by another session for "
+                              << main_ctx_graph_viewer.Nodes().begin()->Name();
+        continue;
+      }
       // Create QNN context from the cached binary, deserialize the QNN graph from the binary
       ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
                                                        context_cache_path,
                                                        qnn_backend_manager_.get(),
                                                        qnn_models,
-                                                       logger));
+                                                       logger,
+                                                       share_ep_contexts_));
     }
 
     for (auto fused_node_and_graph : fused_nodes_and_graphs) {
@@ -842,6 +907,15 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
       ORT_RETURN_IF_ERROR(CreateComputeFunc(node_compute_funcs, logger));
     }
 
+    // Keep the graphs of the context binaries that this session doesn't use for the next sessions
+    if (share_ep_contexts_) {
+      for (auto& [name, qnn_model] : qnn_models) {
+        if (qnn_model != nullptr) {
+          SharedContext::GetInstance().AddSharedQnnModel(name, std::move(qnn_model), qnn_backend_manager_);
+        }
+      }
+    }
+
     return Status::OK();
   }
 
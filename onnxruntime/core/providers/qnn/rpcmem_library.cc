@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/qnn/rpcmem_library.h"
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace qnn {
+
+namespace {
+
+const PathChar* GetRpcMemLibraryName() {
+#if defined(_WIN32)
+  return ORT_TSTR("libcdsprpc.dll");
+#else
+  return ORT_TSTR("libcdsprpc.so");
+#endif
+}
+
+}  // namespace
+
+RpcMemLibrary::RpcMemLibrary() {
+  const Env& env = Env::Default();
+  ORT_THROW_IF_ERROR(env.LoadDynamicLibrary(GetRpcMemLibraryName(), false, &library_handle_));
+
+  void* symbol = nullptr;
+  ORT_THROW_IF_ERROR(env.GetSymbolFromLibrary(library_handle_, "rpcmem_alloc", &symbol));
+  alloc_ = reinterpret_cast<decltype(alloc_)>(symbol);
+  ORT_THROW_IF_ERROR(env.GetSymbolFromLibrary(library_handle_, "rpcmem_free", &symbol));
+  free_ = reinterpret_cast<decltype(free_)>(symbol);
+  ORT_THROW_IF_ERROR(env.GetSymbolFromLibrary(library_handle_, "rpcmem_to_fd", &symbol));
+  to_fd_ = reinterpret_cast<decltype(to_fd_)>(symbol);
+}
+
+RpcMemLibrary::~RpcMemLibrary() {
+  if (library_handle_ != nullptr) {
+    ORT_IGNORE_RETURN_VALUE(Env::Default().UnloadDynamicLibrary(library_handle_));
+  }
+}
+
+}  // namespace qnn
+}  // namespace onnxruntime
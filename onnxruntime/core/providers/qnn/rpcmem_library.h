@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace qnn {
+
+// The rpcmem API of the Qualcomm FastRPC library, loaded at runtime. Memory allocated with it is shared between the
+// CPU and the HTP, so QNN uses it without copying it to the memory of the HTP.
+class RpcMemLibrary {
+ public:
+  // See rpcmem.h of the Hexagon SDK
+  static constexpr int kHeapIdSystem = 25;
+  static constexpr uint32_t kDefaultFlags = 1;
+
+  RpcMemLibrary();
+  ~RpcMemLibrary();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RpcMemLibrary);
+
+  void* Alloc(size_t size) const {
+    return alloc_(kHeapIdSystem, kDefaultFlags, static_cast<int>(size));
+  }
+
+  void Free(void* buffer) const { free_(buffer); }
+
+  // file descriptor of the shared memory of a buffer returned by Alloc
+  int ToFd(void* buffer) const { return to_fd_(buffer); }
+
+ private:
+  void* library_handle_ = nullptr;
+  void* (*alloc_)(int heap_id, uint32_t flags, int size) = nullptr;
+  void (*free_)(void* buffer) = nullptr;
+  int (*to_fd_)(void* buffer) = nullptr;
+};
+
+}  // namespace qnn
+}  // namespace onnxruntime
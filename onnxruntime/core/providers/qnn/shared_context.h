@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/qnn/builder/qnn_backend_manager.h"
+#include "core/providers/qnn/builder/qnn_model.h"
+
+namespace onnxruntime {
+
+// The QNN backend and the QNN graphs shared by the sessions created with kOrtSessionOptionShareEpContexts.
+// All those sessions use the backend manager of the first one, so the contexts loaded from a context binary
+// (and the weights of its graphs) exist once on the device.
+class SharedContext {
+ public:
+  static SharedContext& GetInstance() {
+    static SharedContext instance;
+    return instance;
+  }
+
+  // Return the shared backend manager if a session still uses it, otherwise share `qnn_backend_manager`.
+  std::shared_ptr<qnn::QnnBackendManager> GetOrSetSharedQnnBackendManager(
+      std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    if (auto shared = qnn_backend_manager_.lock()) {
+      return shared;
+    }
+    qnn_backend_manager_ = qnn_backend_manager;
+    return qnn_backend_manager;
+  }
+
+  // Take the graph named `name` if a previous session loaded it from a context binary without using it.
+  std::unique_ptr<qnn::QnnModel> GetSharedQnnModel(const std::string& name) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    auto it = shared_qnn_models_.find(name);
+    if (it == shared_qnn_models_.end()) {
+      return nullptr;
+    }
+    auto qnn_model = std::move(it->second);
+    shared_qnn_models_.erase(it);
+    if (shared_qnn_models_.empty()) {
+      models_qnn_backend_manager_.reset();
+    }
+    return qnn_model;
+  }
+
+  // Keep a graph of a context binary for the next sessions. The backend manager of the graph is kept alive until
+  // a session takes it.
+  void AddSharedQnnModel(const std::string& name, std::unique_ptr<qnn::QnnModel> qnn_model,
+                         std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    models_qnn_backend_manager_ = std::move(qnn_backend_manager);
+    shared_qnn_models_[name] = std::move(qnn_model);
+  }
+
+  // Held while a session sets up the shared backend or loads context binaries into it.
+  OrtMutex& LoadMutex() { return load_mtx_; }
+
+ private:
+  SharedContext() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedContext);
+
+  OrtMutex mtx_;
+  OrtMutex load_mtx_;
+  std::weak_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  // declared before the graphs so that they are released first
+  std::shared_ptr<qnn::QnnBackendManager> models_qnn_backend_manager_;
+  std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> shared_qnn_models_;
+};
+
+}  // namespace onnxruntime
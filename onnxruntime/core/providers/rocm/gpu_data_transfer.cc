@@ -83,4 +83,54 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const {
+  // the copies queued on the default stream so far. they are waited for before returning, also on failure, as
+  // the caller may release the buffers once this returns.
+  bool queued = false;
+  auto copy = [&](const SrcDstPair& pair) -> Status {
+    const Tensor& src = pair.src;
+    Tensor& dst = pair.dst;
+    if (pair.src_stream) {
+      return CopyTensorAsync(src, dst, *pair.src_stream);
+    }
+
+    const void* src_data = src.DataRaw();
+    void* dst_data = dst.MutableDataRaw();
+    const size_t bytes = src.SizeInBytes();
+    const bool src_is_gpu = src.Location().device.Type() == OrtDevice::GPU;
+    const bool dst_is_gpu = dst.Location().device.Type() == OrtDevice::GPU;
+    if (!src_is_gpu && !dst_is_gpu) {
+      // copying between cpu memory. the source may be the destination of a queued copy
+      if (queued) {
+        HIP_RETURN_IF_ERROR(hipStreamSynchronize(nullptr));
+        queued = false;
+      }
+      memcpy(dst_data, src_data, bytes);
+    } else if (dst_data != src_data) {
+      const auto kind = dst_is_gpu ? (src_is_gpu ? hipMemcpyDeviceToDevice : hipMemcpyHostToDevice)
+                                   : hipMemcpyDeviceToHost;
+      HIP_RETURN_IF_ERROR(hipMemcpyAsync(dst_data, src_data, bytes, kind, nullptr));
+      queued = true;
+    }
+    return Status::OK();
+  };
+
+  Status status;
+  for (const auto& pair : src_dst_pairs) {
+    status = copy(pair);
+    if (!status.IsOK()) {
+      break;
+    }
+  }
+
+  if (queued) {
+    const auto sync_result = hipStreamSynchronize(nullptr);
+    if (status.IsOK()) {
+      HIP_RETURN_IF_ERROR(sync_result);
+    }
+  }
+
+  return status;
+}
+
 }  // namespace onnxruntime
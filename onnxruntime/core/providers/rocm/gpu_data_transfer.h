@@ -19,6 +19,9 @@ class GPUDataTransfer : public IDataTransfer {
   using IDataTransfer::CopyTensor;
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const override;
   common::Status CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const override;
+
+  // queues the synchronous copies on the default stream and waits for all of them at once
+  common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override;
 };
 
 }  // namespace onnxruntime
@@ -3082,6 +3082,12 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       timing_cache_path = GetTimingCachePath(global_cache_path_, compute_capability_);
     }
     {
+      // The engine cache may be shared with other processes. Hold its file lock, so that only the first process builds
+      // the engine and the others deserialize it. It is taken before the API lock, like in compute_func.
+      std::unique_ptr<TensorrtCacheFileLock> cache_lock;
+      if (engine_cache_enable_) {
+        cache_lock = std::make_unique<TensorrtCacheFileLock>(cache_path_prefix);
+      }
       // ifstream file check, engine serialization/deserialization and engine build are in critical section. It needs lock protection to prevent race condition when inferencing with multithreading.
       auto lock = GetApiLock();
 
@@ -3199,9 +3205,11 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
               LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
             }
           } else {
-            std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-            file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
-            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized engine " + engine_cache_path;
+            if (WriteCacheFile(engine_cache_path, reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size())) {
+              LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized engine " + engine_cache_path;
+            } else {
+              LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write engine cache " + engine_cache_path;
+            }
           }
         }
         // serialize and save timing cache
@@ -3456,8 +3464,13 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       weight_stripped_engine_refit_ = true;
     }
 
+    // The engine cache may be shared with other processes. Its file lock is held while the cache is read, and while
+    // the engine is rebuilt and serialized, so that an engine built by another process is loaded instead of built again.
+    std::unique_ptr<TensorrtCacheFileLock> cache_lock;
+
     // Load serialized engine
     if (trt_state->engine_cache_enable && trt_engine == nullptr) {
+      cache_lock = std::make_unique<TensorrtCacheFileLock>(cache_path_prefix);
       std::ifstream engine_file(engine_cache_path, std::ios::binary | std::ios::in);
       std::ifstream profile_file(profile_cache_path, std::ios::binary | std::ios::in);
       if (engine_file && !trt_state->engine_decryption_enable && profile_file) {
@@ -3530,6 +3543,43 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       }
     }
 
+    // Another process sharing the engine cache may have built an engine for these shapes since it was loaded
+    if (engine_update && trt_state->engine_cache_enable && !trt_state->engine_decryption_enable && !weight_stripped_engine_refit_) {
+      if (cache_lock == nullptr) {
+        cache_lock = std::make_unique<TensorrtCacheFileLock>(cache_path_prefix);
+      }
+      std::ifstream engine_file(engine_cache_path, std::ios::binary | std::ios::in);
+      std::ifstream profile_file(profile_cache_path, std::ios::binary | std::ios::in);
+      if (engine_file && profile_file) {
+        auto cached_shape_ranges = DeserializeProfileV2(profile_file);
+        if (ProfileCoversShapeRanges(cached_shape_ranges, shape_ranges)) {
+          engine_file.seekg(0, std::ios::end);
+          size_t engine_size = engine_file.tellg();
+          engine_file.seekg(0, std::ios::beg);
+          std::unique_ptr<char[]> engine_buf{new char[engine_size]};
+          engine_file.read((char*)engine_buf.get(), engine_size);
+
+          // Destroy the IExecutionContext objects before destroying an engine object, otherwise it will lead to undefined behavior.
+          trt_state->context->reset();
+          trt_state->engine->reset();
+          *(trt_state->engine) = std::unique_ptr<nvinfer1::ICudaEngine>(
+              trt_state->runtime->deserializeCudaEngine(engine_buf.get(), engine_size));
+          if (!(*(trt_state->engine))) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                   "TensorRT EP could not deserialize engine from cache: " + engine_cache_path);
+          }
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] DeSerialized " + engine_cache_path + " built by another session instead of rebuilding it";
+          // The optimization profiles are updated from the shape ranges before the next rebuild
+          shape_ranges = std::move(cached_shape_ranges);
+          trt_engine = trt_state->engine->get();
+          engine_update = false;
+          context_update = true;
+        }
+      }
+    } else if (engine_update && trt_state->engine_cache_enable && cache_lock == nullptr) {
+      cache_lock = std::make_unique<TensorrtCacheFileLock>(cache_path_prefix);
+    }
+
     // Regenerate engine
     if (engine_update) {
       // Destroy the IExecutionContext objects before destroying an engine object, otherwise it will lead to undefined behavior.
@@ -3690,9 +3740,11 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
             LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
           }
         } else {
-          std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-          file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
+          if (WriteCacheFile(engine_cache_path, reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size())) {
+            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
+          } else {
+            LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write engine cache " + engine_cache_path;
+          }
         }
       }
 
@@ -3733,6 +3785,9 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       }
     }
 
+    // The engine is ready, don't hold the other processes during inference
+    cache_lock.reset();
+
     if (context_update) {
       if (trt_state->context_memory_sharing_enable) {
 #if NV_TENSORRT_MAJOR < 10
@@ -15,6 +15,15 @@
 #include "core/common/path_string.h"
 #include "core/framework/murmurhash3.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace onnxruntime {
@@ -147,11 +156,11 @@ void SerializeProfile(const std::string& file_name, std::unordered_map<std::stri
   builder.Finish();
 
   // Save flexbuffer
-  std::ofstream file(file_name, std::ios::binary | std::ios::out);
   auto buf = builder.GetBuffer();
   size_t size = builder.GetSize();
-  file.write(reinterpret_cast<const char*>(&buf[0]), size);
-  file.close();
+  if (!WriteCacheFile(file_name, reinterpret_cast<const char*>(&buf[0]), size)) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write profile " << file_name;
+  }
 }
 
 // Deserialize engine profile
@@ -182,6 +191,27 @@ std::unordered_map<std::string, std::unordered_map<size_t, std::pair<int64_t, in
   return shape_ranges;
 }
 
+/*
+ * Write a cache file under a temporary name and rename it, so that the other sessions and processes sharing the
+ * cache never read a partially written file. Return false if the file could not be written.
+ */
+bool WriteCacheFile(const std::string& file_name, const char* data, size_t size) {
+  const std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream file(tmp_file_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.write(data, size)) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  fs::rename(tmp_file_name, file_name, ec);
+  if (ec) {
+    fs::remove(tmp_file_name, ec);
+    return false;
+  }
+  return true;
+}
+
 /*
  * Seralize engine profile. (This function starts from ORT 1.15)
  *
@@ -511,6 +541,103 @@ void RemoveCachesByType(const std::string& root, std::string file_extension) {
   }
 }
 
+/*
+ * Exclusive lock of an engine cache, held while checking, building and serializing the engine.
+ *
+ * The lock is taken on the file "<cache path prefix>.lock", so that the sessions of all the processes sharing the
+ * engine cache directory serialize their builds: the first one builds the engine and the others load it from the
+ * cache instead of building it again. The lock is released by the destructor, or by the OS if the process dies.
+ * If the lock file can't be opened (e.g. read-only cache), the builds are not serialized across processes.
+ */
+class TensorrtCacheFileLock {
+ public:
+  explicit TensorrtCacheFileLock(const std::string& cache_path_prefix) {
+    const std::string lock_path = cache_path_prefix + ".lock";
+#ifdef _WIN32
+    handle_ = CreateFileW(ToPathString(lock_path).c_str(), GENERIC_READ | GENERIC_WRITE,
+                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+                          FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      OVERLAPPED overlapped{};
+      if (!LockFileEx(handle_, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        CloseHandle(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+      }
+    }
+    if (handle_ == INVALID_HANDLE_VALUE) {
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not lock " << lock_path << ", the engine may be built by several processes";
+    }
+#else
+    fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd_ != -1) {
+      int ret;
+      do {
+        ret = flock(fd_, LOCK_EX);
+      } while (ret == -1 && errno == EINTR);
+      if (ret == -1) {
+        close(fd_);
+        fd_ = -1;
+      }
+    }
+    if (fd_ == -1) {
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not lock " << lock_path << ", the engine may be built by several processes";
+    }
+#endif
+  }
+
+  ~TensorrtCacheFileLock() {
+#ifdef _WIN32
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      OVERLAPPED overlapped{};
+      UnlockFileEx(handle_, 0, MAXDWORD, MAXDWORD, &overlapped);
+      CloseHandle(handle_);
+    }
+#else
+    if (fd_ != -1) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+#endif
+  }
+
+  TensorrtCacheFileLock(const TensorrtCacheFileLock&) = delete;
+  TensorrtCacheFileLock& operator=(const TensorrtCacheFileLock&) = delete;
+
+ private:
+#ifdef _WIN32
+  HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+  int fd_ = -1;
+#endif
+};
+
+/*
+ * Whether the shape ranges of a cached engine profile (.profile) include the given shape ranges,
+ * i.e. whether the cached engine can run every shape the given ranges were collected from.
+ */
+bool ProfileCoversShapeRanges(std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::vector<int64_t>>>>& cached_shape_ranges,
+                              std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::vector<int64_t>>>>& shape_ranges) {
+  for (const auto& [tensor_name, dim_ranges] : shape_ranges) {
+    auto cached_tensor_it = cached_shape_ranges.find(tensor_name);
+    if (cached_tensor_it == cached_shape_ranges.end()) {
+      return false;
+    }
+    for (const auto& [dim, ranges] : dim_ranges) {
+      auto cached_dim_it = cached_tensor_it->second.find(dim);
+      if (cached_dim_it == cached_tensor_it->second.end() || cached_dim_it->second.size() != ranges.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < ranges.size(); ++i) {
+        // [min, max, opt]
+        if (cached_dim_it->second[i][0] > ranges[i][0] || cached_dim_it->second[i][1] < ranges[i][1]) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 /**
  * <summary>
  * Helper class to generate engine id via model name/model content/env metadata
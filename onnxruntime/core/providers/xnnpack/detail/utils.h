@@ -13,10 +13,13 @@
 #include "core/framework/node_unit.h"
 #include "core/framework/op_kernel.h"
 #include "core/graph/indexed_sub_graph.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 
 #include "xnnpack.h"
 
+struct pthreadpool;
+
 namespace onnxruntime {
 class GraphViewer;
 class NodeUnit;
@@ -79,6 +82,31 @@ bool IsPaddingTypeSupported(AutoPadType auto_pad);
 
 using XnnpackOperator = std::unique_ptr<struct xnn_operator, XnnpackOperatorDeleter>;
 
+// Stop the spinning of the workers of ORT's intra-op thread pool while XNNPACK runs on its own pthreadpool.
+// Otherwise the ORT workers that spin waiting for the next parallel loop compete for the cores with the XNNPACK
+// workers. They resume spinning once the XNNPACK computation is done.
+class IntraOpSpinningPause {
+ public:
+  IntraOpSpinningPause(const OpKernelContext& context, const pthreadpool* xnnpack_threadpool)
+      : threadpool_{xnnpack_threadpool != nullptr ? context.GetOperatorThreadPool() : nullptr} {
+    if (concurrency::ThreadPool::DegreeOfParallelism(threadpool_) > 1) {
+      threadpool_->DisableSpinning();
+    } else {
+      threadpool_ = nullptr;
+    }
+  }
+
+  ~IntraOpSpinningPause() {
+    if (threadpool_ != nullptr) {
+      threadpool_->EnableSpinning();
+    }
+  }
+
+ private:
+  concurrency::ThreadPool* threadpool_;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IntraOpSpinningPause);
+};
+
 std::unique_ptr<IndexedSubGraph::MetaDef> FuseActivation(const NodeUnit& conv_unit, const NodeUnit& activation,
                                                          const GraphViewer& graph);
 std::unique_ptr<IndexedSubGraph::MetaDef> FuseQDQGroup(const NodeUnit& unit_node);
@@ -223,6 +223,7 @@ Status Softmax::Compute(OpKernelContext* ctx) const {
                            " returned ", status);
   }
 
+  IntraOpSpinningPause pause_spinning(*ctx, threadpool);
   status = xnn_run_operator(op0_.get(), threadpool);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
@@ -273,6 +273,7 @@ Status AveragePool::Compute(OpKernelContext* context) const {
                            " returned ", status);
   }
 
+  IntraOpSpinningPause pause_spinning(*context, threadpool);
   status = xnn_run_operator(op0_.get(), threadpool);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
@@ -291,6 +291,7 @@ Status Resize::ComputeInternal(OpKernelContext* ctx, const Tensor* input,
                            OpTypeToString(op_type_), " returned ", status);
   }
 
+  IntraOpSpinningPause pause_spinning(*ctx, threadpool);
   status = xnn_run_operator(op0_.get(), threadpool);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
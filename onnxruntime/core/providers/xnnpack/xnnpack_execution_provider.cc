@@ -10,6 +10,7 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/node_unit.h"
 #include "core/graph/function_utils.h"
+#include "core/providers/partitioning_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
@@ -17,6 +18,7 @@
 #include "core/providers/xnnpack/detail/utils.h"
 #include "core/providers/xnnpack/detail/node_support_checker.h"
 #include "core/providers/xnnpack/xnnpack_init.h"
+#include "core/providers/xnnpack/xnnpack_subgraph.h"
 
 namespace onnxruntime {
 
@@ -155,7 +157,8 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
 using namespace xnnpack;
 
 XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProviderInfo& info)
-    : IExecutionProvider{kXnnpackExecutionProvider} {
+    : IExecutionProvider{kXnnpackExecutionProvider},
+      enable_subgraph_{info.enable_subgraph} {
   int xnn_thread_pool_size = info.xnn_thread_pool_size;
   int ort_thread_pool_size = info.session_options ? info.session_options->intra_op_param.thread_pool_size : 1;
   bool allow_intra_op_spinning = (info.session_options == nullptr) ||
@@ -163,12 +166,12 @@ XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProvide
                                   info.session_options->config_options.GetConfigOrDefault(
                                       kOrtSessionOptionsConfigAllowIntraOpSpinning, "1") == "1");
   if (xnn_thread_pool_size > 1 && allow_intra_op_spinning && ort_thread_pool_size > 1) {
-    LOGS_DEFAULT(WARNING)
-        << "The XNNPACK EP utilizes an internal pthread-based thread pool for multi-threading."
-           "If ORT's thread pool size is > 1 and spinning is enabled, "
-           "there will be contention between the two thread pools, and performance will suffer."
-           "Please set either intra_op_param.allow_spinning to 0 in the SessionOption config params,"
-           "or the ORT intra-op threadpool size to 1.";
+    LOGS_DEFAULT(INFO)
+        << "The XNNPACK EP utilizes an internal pthread-based thread pool for multi-threading. "
+           "The spinning of ORT's intra-op thread pool is paused while the XNNPACK kernels run, "
+           "but the nodes assigned to other EPs still spin when they complete. "
+           "Set intra_op_param.allow_spinning to 0 in the SessionOption config params "
+           "if the XNNPACK and CPU nodes are interleaved.";
   }
 
   if (xnn_thread_pool_size == 0) {
@@ -176,7 +179,8 @@ XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProvide
   }
 
   if (xnn_thread_pool_size > 1) {
-    // pthreadpool is independent of ort-threadpoool, so we had better disable cpu spinning for ort-threadpool.
+    // pthreadpool is independent of ort-threadpoool. the XNNPACK kernels stop the spinning of ort-threadpool while
+    // they run on it, see IntraOpSpinningPause.
     xnnpack_thread_pool_ = pthreadpool_create(static_cast<size_t>(xnn_thread_pool_size));
   }
 }
@@ -342,18 +346,152 @@ std::vector<std::unique_ptr<ComputeCapability>> XnnpackExecutionProvider::GetCap
     }
   }
 
-  // FUTURE: finding nodes to compile can be inserted here and added to the ComputeCapability instances returned.
   // GraphPartitioner can handle a mix of static and compiled kernels.
+#if !defined(ORT_MINIMAL_BUILD)
+  if (enable_subgraph_) {
+    AddSubgraphCapabilities(graph, capabilities);
+  }
+#endif
 
   return capabilities;
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+void XnnpackExecutionProvider::AddSubgraphCapabilities(
+    const GraphViewer& graph, std::vector<std::unique_ptr<ComputeCapability>>& capabilities) const {
+  // Only the second call, after the layout transformation, is compiled: the layout sensitive nodes must be in NHWC.
+  bool is_second_call = false;
+  for (const Node& node : graph.Nodes()) {
+    is_second_call = is_second_call || node.GetExecutionProviderType() == Type();
+  }
+  if (!is_second_call) {
+    return;
+  }
+
+  // A capability is compiled as a whole, e.g. a Conv with the activation fused into it.
+  std::unordered_map<const Node*, size_t> node_to_capability;
+  std::unordered_set<const Node*> supported_nodes;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    const auto& capability_nodes = capabilities[i]->sub_graph->nodes;
+    bool supported = true;
+    for (NodeIndex index : capability_nodes) {
+      const Node* node = graph.GetNode(index);
+      node_to_capability[node] = i;
+      supported = supported && XnnpackSubgraph::IsNodeSupported(*node, graph);
+    }
+    if (supported) {
+      for (NodeIndex index : capability_nodes) {
+        supported_nodes.insert(graph.GetNode(index));
+      }
+    }
+  }
+
+  // the nodes we have no kernel for, like Add or a Relu that could not be fused, can be in a subgraph too
+  for (const Node& node : graph.Nodes()) {
+    if (node.GetExecutionProviderType().empty() && node_to_capability.count(&node) == 0 &&
+        XnnpackSubgraph::IsNodeSupported(node, graph)) {
+      supported_nodes.insert(&node);
+    }
+  }
+
+  const auto gen_metadef_name = [&]() {
+    HashValue model_hash;
+    int metadef_id = metadef_id_generator_.GenerateId(graph, model_hash);
+    return MakeString("XNNPACK_", model_hash, "_", metadef_id);
+  };
+
+  auto partitions = utils::CreateSupportedPartitions(graph, supported_nodes, {}, gen_metadef_name, "XNNPACK", Type(),
+                                                     nullptr, /*drop_constant_initializers*/ true);
+
+  std::vector<bool> replaced(capabilities.size(), false);
+  std::vector<std::unique_ptr<ComputeCapability>> compiled;
+  for (auto& partition : partitions) {
+    const auto& partition_nodes = partition->sub_graph->nodes;
+    // a single node runs as well with its kernel
+    if (partition_nodes.size() < 2) {
+      continue;
+    }
+
+    const InlinedHashSet<NodeIndex> partition_node_set(partition_nodes.begin(), partition_nodes.end());
+    InlinedHashSet<size_t> covered_capabilities;
+    bool covers_whole_capabilities = true;
+    for (NodeIndex index : partition_nodes) {
+      auto it = node_to_capability.find(graph.GetNode(index));
+      if (it == node_to_capability.end()) {
+        continue;
+      }
+      covered_capabilities.insert(it->second);
+      for (NodeIndex capability_node : capabilities[it->second]->sub_graph->nodes) {
+        covers_whole_capabilities = covers_whole_capabilities && partition_node_set.count(capability_node) > 0;
+      }
+    }
+
+    if (!covers_whole_capabilities) {
+      continue;
+    }
+
+    for (size_t i : covered_capabilities) {
+      replaced[i] = true;
+    }
+    compiled.push_back(std::move(partition));
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < capabilities.size(); ++i) {
+    if (!replaced[i]) {
+      capabilities[kept++] = std::move(capabilities[i]);
+    }
+  }
+  capabilities.resize(kept);
+
+  LOGS_DEFAULT(VERBOSE) << "XNNPACK EP compiles " << compiled.size() << " partitions into XNNPACK subgraphs";
+  for (auto& capability : compiled) {
+    capabilities.push_back(std::move(capability));
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+common::Status XnnpackExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                                                 std::vector<NodeComputeInfo>& node_compute_funcs) {
+  for (const auto& fused_node_and_graph : fused_nodes_and_graphs) {
+    const Node& fused_node = fused_node_and_graph.fused_node;
+
+    std::unique_ptr<XnnpackSubgraph> subgraph;
+    ORT_RETURN_IF_ERROR(XnnpackSubgraph::Create(fused_node_and_graph.filtered_graph, fused_node,
+                                                xnnpack_thread_pool_, subgraph));
+    subgraphs_.emplace(fused_node.Name(), std::move(subgraph));
+
+    NodeComputeInfo compute_info;
+    compute_info.create_state_func = [this](ComputeContext* context, FunctionState* state) {
+      *state = subgraphs_.at(context->node_name).get();
+      return 0;
+    };
+
+    compute_info.release_state_func = [](FunctionState state) {
+      // the `state` is a XnnpackSubgraph owned by the EP
+      ORT_UNUSED_PARAMETER(state);
+    };
+
+    compute_info.compute_func = [](FunctionState state, const OrtApi* /* api */, OrtKernelContext* context) {
+      return static_cast<XnnpackSubgraph*>(state)->Compute(context);
+    };
+
+    node_compute_funcs.push_back(std::move(compute_info));
+  }
+
+  return Status::OK();
+}
+#endif
+
 std::shared_ptr<KernelRegistry> XnnpackExecutionProvider::GetKernelRegistry() const {
   static std::shared_ptr<KernelRegistry> registry = xnnpack::RegisterKernels();
   return registry;
 }
 
 XnnpackExecutionProvider::~XnnpackExecutionProvider() {
+  // delete the runtimes before XNNPACK is deinitialized
+  subgraphs_.clear();
   xnn_deinitialize();
   pthreadpool_destroy(xnnpack_thread_pool_);
 }
@@ -4,16 +4,26 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include "core/framework/execution_provider.h"
+#include "core/framework/model_metadef_id_generator.h"
 #include "core/graph/constants.h"
 #include "core/providers/providers.h"
 #include "core/framework/session_options.h"
 
 struct pthreadpool;
 namespace onnxruntime {
-// placeholder for future use. no options currently
+namespace xnnpack {
+class XnnpackSubgraph;
+}
+
 struct XnnpackExecutionProviderInfo {
   int xnn_thread_pool_size{0};
+  // compile the partitions of supported float nodes into XNNPACK subgraphs instead of running one kernel per node
+  bool enable_subgraph{false};
   const SessionOptions* session_options{nullptr};
   XnnpackExecutionProviderInfo() = default;
 
@@ -22,6 +32,9 @@ struct XnnpackExecutionProviderInfo {
     if (auto it = po.find("intra_op_num_threads"); it != po.end()) {
       xnn_thread_pool_size = std::stoi(it->second);
     }
+    if (auto it = po.find("enable_subgraph"); it != po.end()) {
+      enable_subgraph = it->second == "1";
+    }
   }
 };
 
@@ -36,6 +49,11 @@ class XnnpackExecutionProvider : public IExecutionProvider {
 
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  common::Status Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+#endif
+
   DataLayout GetPreferredLayout() const override { return DataLayout::NHWC; }
 
   FusionStyle GetFusionStyle() const override { return FusionStyle::FilteredGraphViewer; }
@@ -50,7 +68,16 @@ class XnnpackExecutionProvider : public IExecutionProvider {
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
 
  private:
+#if !defined(ORT_MINIMAL_BUILD)
+  // Replace the capabilities of the partitions of nodes supported by XnnpackSubgraph with one compiled capability.
+  void AddSubgraphCapabilities(const GraphViewer& graph,
+                               std::vector<std::unique_ptr<ComputeCapability>>& capabilities) const;
+#endif
+
   pthreadpool* xnnpack_thread_pool_{nullptr};
+  bool enable_subgraph_{false};
+  ModelMetadefIdGenerator metadef_id_generator_;
+  std::unordered_map<std::string, std::unique_ptr<xnnpack::XnnpackSubgraph>> subgraphs_;
 };
 
 }  // namespace onnxruntime
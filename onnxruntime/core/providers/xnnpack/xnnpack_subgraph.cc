@@ -0,0 +1,478 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/xnnpack_subgraph.h"
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_node_proto_helper.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/nn/pool_attributes.h"
+#include "core/providers/xnnpack/detail/utils.h"
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+
+bool IsFloatTensorWithStaticShape(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+      shape == nullptr || shape->dim_size() > XNN_MAX_TENSOR_DIMS) {
+    return false;
+  }
+
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<size_t> GetDims(const NodeArg& arg) {
+  std::vector<size_t> dims;
+  for (const auto& dim : arg.Shape()->dim()) {
+    dims.push_back(narrow<size_t>(dim.dim_value()));
+  }
+  return dims;
+}
+
+size_t GetRank(const NodeArg& arg) {
+  return narrow<size_t>(arg.Shape()->dim_size());
+}
+
+bool IsConstantWithRank(const GraphViewer& graph, const NodeArg& arg, size_t rank) {
+  return graph.IsConstantInitializer(arg.Name(), true) && GetRank(arg) == rank;
+}
+
+bool HasExistingInput(const Node& node, size_t index) {
+  const auto& inputs = node.InputDefs();
+  return inputs.size() > index && inputs[index]->Exists();
+}
+
+// min/max of a Relu or Clip node, or of an activation fused into a Conv or pooling node
+std::pair<float, float> GetOutputMinMax(const Node& node, const GraphViewer& graph) {
+  float output_min = -INFINITY;
+  float output_max = INFINITY;
+
+  ProtoHelperNodeContext nc(node);
+  OpNodeProtoHelper info(&nc);
+  if (node.OpType() == "Relu") {
+    output_min = 0.f;
+  } else if (node.OpType() == "Clip") {
+    if (node.SinceVersion() < 11) {
+      output_min = info.GetAttrOrDefault<float>("min", output_min);
+      output_max = info.GetAttrOrDefault<float>("max", output_max);
+    } else {
+      if (HasExistingInput(node, 1)) {
+        Initializer min(*graph.GetConstantInitializer(node.InputDefs()[1]->Name(), true), graph.ModelPath());
+        output_min = min.DataAsSpan<float>()[0];
+      }
+      if (HasExistingInput(node, 2)) {
+        Initializer max(*graph.GetConstantInitializer(node.InputDefs()[2]->Name(), true), graph.ModelPath());
+        output_max = max.DataAsSpan<float>()[0];
+      }
+    }
+  } else if (std::vector<float> activation_params;
+             info.GetAttrs<float>("activation_params", activation_params).IsOK() && activation_params.size() == 2) {
+    output_min = activation_params[0];
+    output_max = activation_params[1];
+  }
+
+  return {output_min, output_max};
+}
+
+bool IsNhwcNodeSupported(const Node& node, const GraphViewer& graph) {
+  const auto& inputs = node.InputDefs();
+  if (GetRank(*inputs[0]) != 4) {
+    return false;
+  }
+
+  ProtoHelperNodeContext nc(node);
+  OpNodeProtoHelper info(&nc);
+  const auto& op_type = node.OpType();
+  if (op_type == "Conv") {
+    AutoPadType auto_pad = StringToAutoPadType(info.GetAttrOrDefault<std::string>("auto_pad", "NOTSET"));
+    return IsPaddingTypeSupported(auto_pad) &&
+           IsConstantWithRank(graph, *inputs[1], 4) &&
+           (!HasExistingInput(node, 2) || IsConstantWithRank(graph, *inputs[2], 1));
+  }
+
+  if (op_type == "MaxPool" || op_type == "AveragePool") {
+    PoolAttributes pool_attrs(info, op_type, node.SinceVersion());
+    return pool_attrs.kernel_shape.size() == 2 &&
+           pool_attrs.ceil_mode == 0 &&
+           IsPaddingTypeSupported(pool_attrs.auto_pad) &&
+           (op_type == "MaxPool" || (!pool_attrs.count_include_pad && pool_attrs.default_dilations));
+  }
+
+  return false;
+}
+
+bool IsOnnxNodeSupported(const Node& node, const GraphViewer& graph) {
+  const auto& inputs = node.InputDefs();
+  const auto& op_type = node.OpType();
+
+  ProtoHelperNodeContext nc(node);
+  OpNodeProtoHelper info(&nc);
+  if (op_type == "Gemm") {
+    if (info.GetAttrOrDefault<int64_t>("transA", 0) != 0 ||
+        info.GetAttrOrDefault<float>("alpha", 1.f) != 1.f ||
+        info.GetAttrOrDefault<float>("beta", 1.f) != 1.f ||
+        GetRank(*inputs[0]) != 2 || !IsConstantWithRank(graph, *inputs[1], 2)) {
+      return false;
+    }
+
+    // the bias must be a vector of the output channels
+    if (HasExistingInput(node, 2)) {
+      const auto trans_b = info.GetAttrOrDefault<int64_t>("transB", 0);
+      const auto N = GetDims(*inputs[1])[trans_b ? 0 : 1];
+      const auto C_dims = GetDims(*inputs[2]);
+      size_t C_size = 1;
+      for (auto dim : C_dims) {
+        C_size *= dim;
+      }
+      return graph.IsConstantInitializer(inputs[2]->Name(), true) &&
+             C_size == N && !C_dims.empty() && C_dims.back() == N;
+    }
+
+    return true;
+  }
+
+  if (op_type == "MatMul") {
+    return GetRank(*inputs[0]) >= 2 && IsConstantWithRank(graph, *inputs[1], 2);
+  }
+
+  if (op_type == "Softmax") {
+    const auto rank = static_cast<int64_t>(GetRank(*inputs[0]));
+    const auto axis = info.GetAttrOrDefault<int64_t>("axis", node.SinceVersion() < 13 ? 1 : -1);
+    return rank > 0 && HandleNegativeAxis(axis, rank) == rank - 1;
+  }
+
+  if (op_type == "Clip") {
+    return node.SinceVersion() < 11 ||
+           ((!HasExistingInput(node, 1) || graph.IsConstantInitializer(inputs[1]->Name(), true)) &&
+            (!HasExistingInput(node, 2) || graph.IsConstantInitializer(inputs[2]->Name(), true)));
+  }
+
+  return op_type == "Relu" || op_type == "Add" || op_type == "Mul";
+}
+
+// Defines the values and the nodes of a partition in an xnn_subgraph.
+class SubgraphBuilder {
+ public:
+  SubgraphBuilder(const GraphViewer& graph, xnn_subgraph_t subgraph, std::vector<std::vector<float>>& static_data)
+      : graph_{graph}, subgraph_{subgraph}, static_data_{static_data} {}
+
+  Status DefineExternalValue(const NodeArg& arg, uint32_t external_id, uint32_t flags) {
+    uint32_t id = XNN_INVALID_VALUE_ID;
+    ORT_RETURN_IF_ERROR(DefineValue(GetDims(arg), nullptr, external_id, flags, id));
+    value_ids_[arg.Name()] = id;
+    return Status::OK();
+  }
+
+  Status DefineNode(const Node& node) {
+    uint32_t input_id = XNN_INVALID_VALUE_ID;
+    uint32_t output_id = XNN_INVALID_VALUE_ID;
+    ORT_RETURN_IF_ERROR(GetInputId(*node.InputDefs()[0], input_id));
+    ORT_RETURN_IF_ERROR(GetOutputId(*node.OutputDefs()[0], output_id));
+
+    const auto [output_min, output_max] = GetOutputMinMax(node, graph_);
+    const auto& op_type = node.OpType();
+    xnn_status status = xnn_status_unsupported_parameter;
+    if (op_type == "Conv") {
+      ORT_RETURN_IF_ERROR(DefineConv(node, input_id, output_id, output_min, output_max, status));
+    } else if (op_type == "MaxPool" || op_type == "AveragePool") {
+      ProtoHelperNodeContext nc(node);
+      OpNodeProtoHelper info(&nc);
+      PoolAttributes pool_attrs(info, op_type, node.SinceVersion());
+      const uint32_t flags = pool_attrs.auto_pad == AutoPadType::SAME_UPPER ? XNN_FLAG_TENSORFLOW_SAME_PADDING : 0;
+      // pads are [top, left, bottom, right]
+      const auto& pads = pool_attrs.pads;
+      if (op_type == "MaxPool") {
+        status = xnn_define_max_pooling_2d(
+            subgraph_,
+            narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+            narrow<uint32_t>(pool_attrs.kernel_shape[0]), narrow<uint32_t>(pool_attrs.kernel_shape[1]),
+            narrow<uint32_t>(pool_attrs.strides[0]), narrow<uint32_t>(pool_attrs.strides[1]),
+            narrow<uint32_t>(pool_attrs.dilations[0]), narrow<uint32_t>(pool_attrs.dilations[1]),
+            output_min, output_max, input_id, output_id, flags);
+      } else {
+        status = xnn_define_average_pooling_2d(
+            subgraph_,
+            narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+            narrow<uint32_t>(pool_attrs.kernel_shape[0]), narrow<uint32_t>(pool_attrs.kernel_shape[1]),
+            narrow<uint32_t>(pool_attrs.strides[0]), narrow<uint32_t>(pool_attrs.strides[1]),
+            output_min, output_max, input_id, output_id, flags);
+      }
+    } else if (op_type == "Gemm" || op_type == "MatMul") {
+      ORT_RETURN_IF_ERROR(DefineFullyConnected(node, input_id, output_id, status));
+    } else if (op_type == "Softmax") {
+      status = xnn_define_softmax(subgraph_, input_id, output_id, 0);
+    } else if (op_type == "Relu" || op_type == "Clip") {
+      status = xnn_define_clamp(subgraph_, output_min, output_max, input_id, output_id, 0);
+    } else if (op_type == "Add" || op_type == "Mul") {
+      uint32_t input1_id = XNN_INVALID_VALUE_ID;
+      ORT_RETURN_IF_ERROR(GetInputId(*node.InputDefs()[1], input1_id));
+      auto define_fn = op_type == "Add" ? xnn_define_add2 : xnn_define_multiply2;
+      status = define_fn(subgraph_, output_min, output_max, input_id, input1_id, output_id, 0);
+    }
+
+    ORT_RETURN_IF_NOT(status == xnn_status_success, "Failed to define the XNNPACK node for ", op_type, " node '",
+                      node.Name(), "'. Status: ", status);
+    return Status::OK();
+  }
+
+ private:
+  Status DefineValue(const std::vector<size_t>& dims, const float* data, uint32_t external_id, uint32_t flags,
+                     uint32_t& id) {
+    xnn_status status = xnn_define_tensor_value(subgraph_, xnn_datatype_fp32, dims.size(), dims.data(), data,
+                                                external_id, flags, &id);
+    ORT_RETURN_IF_NOT(status == xnn_status_success, "xnn_define_tensor_value returned ", status);
+    return Status::OK();
+  }
+
+  Status DefineStaticValue(const std::string& key, const std::vector<size_t>& dims, std::vector<float> data,
+                           uint32_t& id) {
+    static_data_.push_back(std::move(data));
+    ORT_RETURN_IF_ERROR(DefineValue(dims, static_data_.back().data(), XNN_INVALID_VALUE_ID, 0, id));
+    value_ids_[key] = id;
+    return Status::OK();
+  }
+
+  std::vector<float> ReadInitializer(const NodeArg& arg) const {
+    Initializer initializer(*graph_.GetConstantInitializer(arg.Name(), true), graph_.ModelPath());
+    const auto data = initializer.DataAsSpan<float>();
+    return std::vector<float>(data.begin(), data.end());
+  }
+
+  // an external value, the output of a previous node, or a constant initializer
+  Status GetInputId(const NodeArg& arg, uint32_t& id) {
+    if (auto it = value_ids_.find(arg.Name()); it != value_ids_.end()) {
+      id = it->second;
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_NOT(graph_.IsConstantInitializer(arg.Name(), true), "Value '", arg.Name(),
+                      "' is not defined in the XNNPACK subgraph");
+    return DefineStaticValue(arg.Name(), GetDims(arg), ReadInitializer(arg), id);
+  }
+
+  // the outputs of the partition were defined as external values
+  Status GetOutputId(const NodeArg& arg, uint32_t& id) {
+    if (auto it = value_ids_.find(arg.Name()); it != value_ids_.end()) {
+      id = it->second;
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_ERROR(DefineValue(GetDims(arg), nullptr, XNN_INVALID_VALUE_ID, 0, id));
+    value_ids_[arg.Name()] = id;
+    return Status::OK();
+  }
+
+  Status DefineConv(const Node& node, uint32_t input_id, uint32_t output_id, float output_min, float output_max,
+                    xnn_status& status) {
+    const auto& inputs = node.InputDefs();
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+
+    // ONNX filter is {M, C/group, kH, kW}, XNNPACK expects {M, kH, kW, C/group}
+    const auto filter_dims = GetDims(*inputs[1]);
+    const size_t M = filter_dims[0], C_per_group = filter_dims[1], kH = filter_dims[2], kW = filter_dims[3];
+    const std::string filter_key = inputs[1]->Name() + "/OHWI";
+    uint32_t filter_id = XNN_INVALID_VALUE_ID;
+    if (auto it = value_ids_.find(filter_key); it != value_ids_.end()) {
+      filter_id = it->second;
+    } else {
+      const auto oihw = ReadInitializer(*inputs[1]);
+      std::vector<float> ohwi(oihw.size());
+      for (size_t m = 0; m < M; ++m) {
+        for (size_t c = 0; c < C_per_group; ++c) {
+          for (size_t hw = 0; hw < kH * kW; ++hw) {
+            ohwi[(m * kH * kW + hw) * C_per_group + c] = oihw[(m * C_per_group + c) * kH * kW + hw];
+          }
+        }
+      }
+      ORT_RETURN_IF_ERROR(DefineStaticValue(filter_key, {M, kH, kW, C_per_group}, std::move(ohwi), filter_id));
+    }
+
+    uint32_t bias_id = XNN_INVALID_VALUE_ID;
+    if (HasExistingInput(node, 2)) {
+      ORT_RETURN_IF_ERROR(GetInputId(*inputs[2], bias_id));
+    }
+
+    const auto group = narrow<size_t>(info.GetAttrOrDefault<int64_t>("group", 1));
+    const auto strides = info.GetAttrsOrDefault<int64_t>("strides", {1, 1});
+    const auto dilations = info.GetAttrsOrDefault<int64_t>("dilations", {1, 1});
+    AutoPadType auto_pad = StringToAutoPadType(info.GetAttrOrDefault<std::string>("auto_pad", "NOTSET"));
+    // explicit pads are [top, left, bottom, right]
+    auto pads = info.GetAttrsOrDefault<int64_t>("pads", {0, 0, 0, 0});
+    if (auto_pad != AutoPadType::NOTSET) {
+      pads = {0, 0, 0, 0};
+    }
+    const uint32_t flags = auto_pad == AutoPadType::SAME_UPPER ? XNN_FLAG_TENSORFLOW_SAME_PADDING : 0;
+
+    status = xnn_define_convolution_2d(
+        subgraph_,
+        narrow<uint32_t>(pads[0]), narrow<uint32_t>(pads[3]), narrow<uint32_t>(pads[2]), narrow<uint32_t>(pads[1]),
+        narrow<uint32_t>(kH), narrow<uint32_t>(kW),
+        narrow<uint32_t>(strides[0]), narrow<uint32_t>(strides[1]),
+        narrow<uint32_t>(dilations[0]), narrow<uint32_t>(dilations[1]),
+        narrow<uint32_t>(group), C_per_group, M / group,
+        output_min, output_max, input_id, filter_id, bias_id, output_id, flags);
+    return Status::OK();
+  }
+
+  Status DefineFullyConnected(const Node& node, uint32_t input_id, uint32_t output_id, xnn_status& status) {
+    const auto& inputs = node.InputDefs();
+    ProtoHelperNodeContext nc(node);
+    OpNodeProtoHelper info(&nc);
+
+    // XNNPACK expects the filter as {N, K} unless it is transposed
+    uint32_t flags = XNN_FLAG_TRANSPOSE_WEIGHTS;
+    if (node.OpType() == "Gemm" && info.GetAttrOrDefault<int64_t>("transB", 0) != 0) {
+      flags = 0;
+    }
+
+    uint32_t filter_id = XNN_INVALID_VALUE_ID;
+    ORT_RETURN_IF_ERROR(GetInputId(*inputs[1], filter_id));
+
+    uint32_t bias_id = XNN_INVALID_VALUE_ID;
+    if (node.OpType() == "Gemm" && HasExistingInput(node, 2)) {
+      const std::string bias_key = inputs[2]->Name() + "/N";
+      if (auto it = value_ids_.find(bias_key); it != value_ids_.end()) {
+        bias_id = it->second;
+      } else {
+        auto bias = ReadInitializer(*inputs[2]);
+        const size_t N = bias.size();
+        ORT_RETURN_IF_ERROR(DefineStaticValue(bias_key, {N}, std::move(bias), bias_id));
+      }
+    }
+
+    status = xnn_define_fully_connected(subgraph_, -INFINITY, INFINITY, input_id, filter_id, bias_id, output_id,
+                                        flags);
+    return Status::OK();
+  }
+
+  const GraphViewer& graph_;
+  xnn_subgraph_t subgraph_;
+  std::vector<std::vector<float>>& static_data_;
+  std::unordered_map<std::string, uint32_t> value_ids_;
+};
+
+}  // namespace
+
+bool XnnpackSubgraph::IsNodeSupported(const Node& node, const GraphViewer& graph) {
+  for (const auto* input : node.InputDefs()) {
+    if (input->Exists() && !IsFloatTensorWithStaticShape(*input)) {
+      return false;
+    }
+  }
+
+  // optional outputs like the indices of MaxPool are not supported
+  const auto& outputs = node.OutputDefs();
+  if (outputs.empty() || !outputs[0]->Exists() || !IsFloatTensorWithStaticShape(*outputs[0])) {
+    return false;
+  }
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    if (outputs[i]->Exists()) {
+      return false;
+    }
+  }
+
+  if (node.Domain() == kMSInternalNHWCDomain) {
+    return IsNhwcNodeSupported(node, graph);
+  }
+
+  if (node.Domain() == kOnnxDomain) {
+    return IsOnnxNodeSupported(node, graph);
+  }
+
+  return false;
+}
+
+Status XnnpackSubgraph::Create(const GraphViewer& graph, const Node& fused_node, pthreadpool* threadpool,
+                               std::unique_ptr<XnnpackSubgraph>& subgraph) {
+  std::unique_ptr<XnnpackSubgraph> result{new XnnpackSubgraph()};
+  const auto& inputs = fused_node.InputDefs();
+  const auto& outputs = fused_node.OutputDefs();
+  const size_t num_external_values = inputs.size() + outputs.size();
+
+  xnn_subgraph_t xnn_subgraph = nullptr;
+  xnn_status status = xnn_create_subgraph(narrow<uint32_t>(num_external_values), 0, &xnn_subgraph);
+  ORT_RETURN_IF_NOT(status == xnn_status_success, "xnn_create_subgraph returned ", status);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> subgraph_holder{xnn_subgraph, xnn_delete_subgraph};
+
+  SubgraphBuilder builder{graph, xnn_subgraph, result->static_data_};
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    ORT_RETURN_IF_ERROR(builder.DefineExternalValue(*inputs[i], narrow<uint32_t>(i), XNN_VALUE_FLAG_EXTERNAL_INPUT));
+    const auto dims = GetDims(*inputs[i]);
+    result->input_shapes_.emplace_back(dims.begin(), dims.end());
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    ORT_RETURN_IF_ERROR(builder.DefineExternalValue(*outputs[i], narrow<uint32_t>(inputs.size() + i),
+                                                    XNN_VALUE_FLAG_EXTERNAL_OUTPUT));
+    const auto dims = GetDims(*outputs[i]);
+    result->output_shapes_.emplace_back(dims.begin(), dims.end());
+  }
+
+  for (NodeIndex index : graph.GetNodesInTopologicalOrder()) {
+    ORT_RETURN_IF_ERROR(builder.DefineNode(*graph.GetNode(index)));
+  }
+
+  xnn_runtime_t runtime = nullptr;
+  // the workers of the pthreadpool don't spin after the runtime finished, the next nodes may run on ORT's threads
+  const uint32_t runtime_flags = threadpool != nullptr ? XNN_FLAG_YIELD_WORKERS : 0;
+  status = xnn_create_runtime_v2(xnn_subgraph, threadpool, runtime_flags, &runtime);
+  ORT_RETURN_IF_NOT(status == xnn_status_success, "xnn_create_runtime_v2 returned ", status);
+  result->runtime_.reset(runtime);
+  result->threadpool_ = threadpool;
+
+  result->external_values_.resize(num_external_values);
+  for (size_t i = 0; i < num_external_values; ++i) {
+    result->external_values_[i].id = narrow<uint32_t>(i);
+  }
+
+  subgraph = std::move(result);
+  return Status::OK();
+}
+
+Status XnnpackSubgraph::Compute(OrtKernelContext* context) {
+  Ort::KernelContext ctx(context);
+  const size_t num_inputs = input_shapes_.size();
+  for (size_t i = 0; i < num_inputs; ++i) {
+    auto input = ctx.GetInput(i);
+    // the runtime was created for the shapes seen when the partition was compiled
+    ORT_RETURN_IF_NOT(input.GetTensorTypeAndShapeInfo().GetShape() == input_shapes_[i],
+                      "The shape of input ", i, " differs from the static shape the XNNPACK subgraph was created with");
+    external_values_[i].data = const_cast<void*>(input.GetTensorRawData());
+  }
+
+  for (size_t i = 0; i < output_shapes_.size(); ++i) {
+    auto output = ctx.GetOutput(i, output_shapes_[i]);
+    external_values_[num_inputs + i].data = output.GetTensorMutableRawData();
+  }
+
+  xnn_status status = xnn_setup_runtime(runtime_.get(), external_values_.size(), external_values_.data());
+  ORT_RETURN_IF_NOT(status == xnn_status_success, "xnn_setup_runtime returned ", status);
+
+  IntraOpSpinningPause pause_spinning(*reinterpret_cast<const OpKernelContext*>(context), threadpool_);
+  status = xnn_invoke_runtime(runtime_.get());
+  ORT_RETURN_IF_NOT(status == xnn_status_success, "xnn_invoke_runtime returned ", status);
+
+  return Status::OK();
+}
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/session/onnxruntime_c_api.h"
+
+#include "xnnpack.h"
+
+struct pthreadpool;
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+
+namespace xnnpack {
+
+// A partition of the graph compiled into a single XNNPACK subgraph and runtime, instead of one xnn operator per
+// kernel. XNNPACK fuses the activations into the preceding nodes, plans the memory of the intermediate values,
+// and keeps them in NHWC between the nodes of the partition.
+//
+// Only float nodes with inputs and outputs of static shapes are supported, so that the runtime can be created when
+// the partition is compiled.
+class XnnpackSubgraph {
+ public:
+  // Whether the node can be defined in an XNNPACK subgraph.
+  static bool IsNodeSupported(const Node& node, const GraphViewer& graph);
+
+  // Define the nodes of `graph`, the filtered graph of `fused_node`, and create their runtime.
+  static Status Create(const GraphViewer& graph, const Node& fused_node, pthreadpool* threadpool,
+                       std::unique_ptr<XnnpackSubgraph>& subgraph);
+
+  Status Compute(OrtKernelContext* context);
+
+ private:
+  XnnpackSubgraph() = default;
+
+  struct XnnpackRuntimeDeleter {
+    void operator()(xnn_runtime* p) const {
+      if (p != nullptr) {
+        xnn_delete_runtime(p);
+      }
+    }
+  };
+
+  std::unique_ptr<xnn_runtime, XnnpackRuntimeDeleter> runtime_;
+  pthreadpool* threadpool_{nullptr};
+
+  // shapes of the inputs and outputs of the fused node
+  std::vector<std::vector<int64_t>> input_shapes_;
+  std::vector<std::vector<int64_t>> output_shapes_;
+
+  // the inputs and then the outputs of the fused node, their ids are their indices
+  std::vector<xnn_external_value> external_values_;
+
+  // weights in the layout XNNPACK expects. they must outlive the runtime.
+  std::vector<std::vector<float>> static_data_;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
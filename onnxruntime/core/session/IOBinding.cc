@@ -2,8 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/session/IOBinding.h"
+
+#include <algorithm>
+
 #include "core/common/logging/logging.h"
+#include "core/framework/data_types.h"
 #include "core/framework/session_state.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
 
@@ -38,6 +43,14 @@ common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_
 
   ORT_ENFORCE(mapped_feed_names_.size() == feed_names_.size(), "Size mismatch:", mapped_feed_names_.size(), "!=", feed_names_.size(), " index=", it.first->second, " it.second=", it.second);
 
+  // a value bound by the caller restarts the stream of its state
+  for (auto& state : states_) {
+    if (state.input_name == name) {
+      state.input_is_output = false;
+      state.next_output = OrtValue();
+    }
+  }
+
   return Status::OK();
 }
 
@@ -45,6 +58,10 @@ void IOBinding::ClearInputs() {
   mapped_feed_names_.clear();
   feed_names_.clear();
   feeds_.clear();
+  for (auto& state : states_) {
+    state.input_is_output = false;
+    state.next_output = OrtValue();
+  }
 }
 
 static common::Status SyncProviders(const SessionState::NameNodeInfoMapType& node_info_map,
@@ -87,6 +104,55 @@ common::Status IOBinding::BindOutput(const std::string& name, OrtDevice device)
   return BindOutputImpl(name, {}, device);
 }
 
+common::Status IOBinding::BindOutput(const std::string& name, OutputAllocator allocator) {
+  ORT_RETURN_IF_NOT(allocator, "An allocator is required to bind output ", name);
+
+  MLDataType element_type = nullptr;
+  for (const auto* output : session_state_.GetGraphViewer().GetOutputs()) {
+    if (output->Name() == name) {
+      const auto* type_proto = output->TypeAsProto();
+      ORT_RETURN_IF_NOT(type_proto != nullptr && utils::HasTensorType(*type_proto),
+                        "Only tensor outputs can be bound to an allocator. Output: ", name);
+      element_type = DataTypeImpl::TypeFromProto(*type_proto)->AsTensorType()->GetElementType();
+      break;
+    }
+  }
+  ORT_RETURN_IF_NOT(element_type != nullptr, "Invalid output name: ", name);
+
+  const SessionState& session_state = session_state_;
+  auto custom_allocator = [&session_state, name, element_type, allocator = std::move(allocator)](
+                              const TensorShape& shape, const OrtDevice& device, OrtValue& value,
+                              bool& allocated) -> Status {
+    auto device_allocator = session_state.GetAllocator(device);
+    ORT_RETURN_IF_NOT(device_allocator, "Failed to find allocator for device ", device.ToString());
+
+    OrtValue provided;
+    ORT_RETURN_IF_ERROR(allocator(shape, element_type, device_allocator->Info(), provided));
+    if (!provided.IsAllocated()) {
+      allocated = false;
+      return Status::OK();
+    }
+
+    ORT_RETURN_IF_NOT(provided.IsTensor(), "The allocator of output ", name, " did not provide a tensor.");
+    const auto& tensor = provided.Get<Tensor>();
+    ORT_RETURN_IF_NOT(tensor.DataType() == element_type, "The allocator of output ", name, " provided a tensor of type ",
+                      DataTypeImpl::ToString(tensor.DataType()), " instead of ", DataTypeImpl::ToString(element_type));
+    ORT_RETURN_IF_NOT(tensor.Shape() == shape, "The allocator of output ", name, " provided a tensor of shape ",
+                      tensor.Shape(), " instead of ", shape);
+    ORT_RETURN_IF_NOT(tensor.Location().device == device, "The allocator of output ", name,
+                      " provided a tensor on device ", tensor.Location().device.ToString(), " instead of ",
+                      device.ToString());
+
+    value = std::move(provided);
+    allocated = true;
+    return Status::OK();
+  };
+
+  ORT_RETURN_IF_ERROR(BindOutputImpl(name, {}, {}));
+  output_allocators_.insert_or_assign(mapped_output_names_[name], std::move(custom_allocator));
+  return Status::OK();
+}
+
 common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device) {
   auto it = mapped_output_names_.emplace(name, output_names_.size());
   size_t index = it.first->second;
@@ -98,16 +164,78 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
     outputs_[index] = ml_value;
     outputs_device_info_[index] = device;
   }
+  // a new binding replaces the allocator of the output, if any
+  output_allocators_.erase(index);
   ORT_ENFORCE(mapped_output_names_.size() == output_names_.size(), "Size mismatch", mapped_output_names_.size(), "!=", output_names_.size());
 
   return Status::OK();
 }
 
+common::Status IOBinding::BindState(const std::string& input_name, const std::string& output_name) {
+  const auto& graph_viewer = session_state_.GetGraphViewer();
+  const auto find_type = [](const std::vector<const NodeArg*>& args, const std::string& name) -> MLDataType {
+    for (const auto* arg : args) {
+      if (arg->Name() == name) {
+        return arg->TypeAsProto() != nullptr ? DataTypeImpl::TypeFromProto(*arg->TypeAsProto()) : nullptr;
+      }
+    }
+    return nullptr;
+  };
+  const MLDataType input_type = find_type(graph_viewer.GetInputs(), input_name);
+  const MLDataType output_type = find_type(graph_viewer.GetOutputs(), output_name);
+  ORT_RETURN_IF_NOT(input_type != nullptr, "Invalid state input name: ", input_name);
+  ORT_RETURN_IF_NOT(output_type != nullptr, "Invalid state output name: ", output_name);
+  ORT_RETURN_IF_NOT(input_type == output_type, "The state input ", input_name, " and output ", output_name,
+                    " have different types");
+
+  auto it = std::find_if(states_.begin(), states_.end(), [&](const State& state) {
+    return state.input_name == input_name || state.output_name == output_name;
+  });
+  ORT_RETURN_IF_NOT(it == states_.end(), "The input ", it->input_name, " or the output ", it->output_name,
+                    " is already bound to a state");
+
+  ORT_RETURN_IF_ERROR(BindOutputImpl(output_name, {}, {}));
+  states_.push_back({input_name, output_name});
+  return Status::OK();
+}
+
+common::Status IOBinding::PrepareStates() {
+  for (auto& state : states_) {
+    auto input = mapped_feed_names_.find(state.input_name);
+    ORT_RETURN_IF_NOT(input != mapped_feed_names_.end(), "The initial value of the state input ", state.input_name,
+                      " must be bound before the first run");
+    const size_t output_index = mapped_output_names_.at(state.output_name);
+    const OrtValue& value = feeds_[input->second];
+    outputs_[output_index] = state.next_output;
+    if (value.IsTensor()) {
+      outputs_device_info_[output_index] = value.Get<Tensor>().Location().device;
+    }
+  }
+  return Status::OK();
+}
+
+void IOBinding::AdvanceStates() {
+  for (auto& state : states_) {
+    OrtValue& input = feeds_[mapped_feed_names_.at(state.input_name)];
+    const OrtValue& output = outputs_[mapped_output_names_.at(state.output_name)];
+    // the value bound by the caller is never overwritten. the shape of the state may also change, e.g. when a
+    // stream starts, in which case the next output gets a new buffer.
+    const bool reuse_input = state.input_is_output && input.IsTensor() && output.IsTensor() &&
+                             input.Get<Tensor>().Shape() == output.Get<Tensor>().Shape() &&
+                             input.Get<Tensor>().Location().device == output.Get<Tensor>().Location().device;
+    state.next_output = reuse_input ? input : OrtValue();
+    input = output;
+    state.input_is_output = true;
+  }
+}
+
 void IOBinding::ClearOutputs() {
   mapped_output_names_.clear();
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  output_allocators_.clear();
+  states_.clear();
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
@@ -2,11 +2,13 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "core/framework/execution_provider.h"
+#include "core/framework/iexecutor.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ort_value.h"
@@ -71,6 +73,37 @@ class IOBinding {
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  /**
+   * Provides the memory of an output once its final shape is known, e.g. a slot of a ring buffer.
+   *
+   * @param shape Shape of the output.
+   * @param element_type Element type of the output.
+   * @param location Memory info of the device the output is produced on. value must be a tensor on that device.
+   * @param value Set to a tensor of the given shape and element type that uses the caller's memory.
+   *        Leave it unallocated to let the session allocate the output.
+   */
+  using OutputAllocator = std::function<common::Status(const TensorShape& shape, MLDataType element_type,
+                                                       const OrtMemoryInfo& location, OrtValue& value)>;
+
+  /**
+   * Bind an output name to an allocator that is called with the final shape of the output during Run().
+   * The output is written in place into the memory it provides: it is not copied to another device, so it stays
+   * on the device of the node that produces it.
+   * The allocator is not called if the output is not produced by a node, e.g. if it is a graph input or an
+   * initializer. The session allocates the output in that case.
+   */
+  common::Status BindOutput(const std::string& name, OutputAllocator allocator);
+
+  /**
+   * Bind an output to an input as the state of a streaming model, e.g. the hidden state of an LSTM or the cache of a
+   * convolution over time. After every Run() the output becomes the input of the next run by pointer, without a copy.
+   * The output is produced on the device of the input, and the previous state is reused as the buffer of the next
+   * output when the shape of the state does not change, so the state alternates between two buffers.
+   * The initial state must be bound with BindInput() before the first run. Binding the input again restarts the
+   * stream from the new value. Values of the state kept by the caller after the next run may be overwritten.
+   */
+  common::Status BindState(const std::string& input_name, const std::string& output_name);
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
    */
@@ -91,7 +124,7 @@ class IOBinding {
   /**
    * clear inputs or outputs. IOBinding is stateful. There are cases we need to reset its state.
    */
-  void ClearOutputs();
+  void ClearOutputs();  // also clears the states
   void ClearInputs();
   IOBinding(const SessionState& session_state);
 
@@ -106,6 +139,18 @@ class IOBinding {
   std::unordered_map<std::string, size_t> mapped_output_names_;
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
+  // allocators of the outputs bound with an OutputAllocator. key is the index in outputs_
+  std::unordered_map<size_t, IExecutor::CustomAllocator> output_allocators_;
+
+  struct State {
+    std::string input_name;
+    std::string output_name;
+    // true if the input is the output of the previous run rather than a value bound by the caller
+    bool input_is_output = false;
+    // buffer of the output of the next run, if any. it is the state before the current one.
+    OrtValue next_output;
+  };
+  std::vector<State> states_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
@@ -114,5 +159,10 @@ class IOBinding {
 
   // The implementation for the BindOutput() overloads
   common::Status BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device);
+
+  // Called by InferenceSession before and after a successful run to bind the outputs of the states to their buffers
+  // and then pass them to the inputs.
+  common::Status PrepareStates();
+  void AdvanceStates();
 };
 }  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/async_run_queue.h"
+
+namespace onnxruntime {
+
+void AsyncRunQueue::Submit(int priority, std::function<void()> run) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    pending_runs_.push(PendingRun{priority, next_sequence_number_++, std::move(run)});
+  }
+
+  DispatchPendingRuns();
+}
+
+size_t AsyncRunQueue::NumPendingRuns() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return pending_runs_.size();
+}
+
+void AsyncRunQueue::DispatchPendingRuns() {
+  std::vector<std::function<void()>> admitted;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    while (!pending_runs_.empty() && num_active_runs_ < max_concurrent_runs_) {
+      // priority_queue::top is const, the run is moved out right before it is popped
+      admitted.push_back(std::move(const_cast<PendingRun&>(pending_runs_.top()).run));
+      pending_runs_.pop();
+      ++num_active_runs_;
+    }
+  }
+
+  for (auto& run : admitted) {
+    schedule_([this, run = std::move(run)]() {
+      run();
+      {
+        std::lock_guard<OrtMutex> lock(mutex_);
+        --num_active_runs_;
+      }
+      DispatchPendingRuns();
+    });
+  }
+}
+
+}  // namespace onnxruntime
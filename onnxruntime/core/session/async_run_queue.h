@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Admission control for asynchronous runs.
+ *
+ * At most max_concurrent_runs runs are dispatched at a time. Runs that are submitted while that many are executing
+ * wait in a queue, ordered by priority (higher first) and then in submission order.
+ *
+ * Thread-safe.
+ */
+class AsyncRunQueue {
+ public:
+  using ScheduleFn = std::function<void(std::function<void()>)>;
+
+  // schedule is called, without holding a lock, to start the runs that are admitted.
+  AsyncRunQueue(size_t max_concurrent_runs, ScheduleFn schedule)
+      : max_concurrent_runs_(max_concurrent_runs), schedule_(std::move(schedule)) {}
+
+  void Submit(int priority, std::function<void()> run);
+
+  size_t NumPendingRuns() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AsyncRunQueue);
+
+  struct PendingRun {
+    int priority;
+    uint64_t sequence_number;
+    std::function<void()> run;
+
+    bool operator<(const PendingRun& other) const {
+      // std::priority_queue pops the largest element
+      return priority != other.priority ? priority < other.priority : sequence_number > other.sequence_number;
+    }
+  };
+
+  // Dispatches pending runs while there is capacity for them.
+  void DispatchPendingRuns();
+
+  const size_t max_concurrent_runs_;
+  ScheduleFn schedule_;
+
+  mutable OrtMutex mutex_;
+  std::priority_queue<PendingRun> pending_runs_;
+  uint64_t next_sequence_number_{0};
+  size_t num_active_runs_{0};
+};
+
+}  // namespace onnxruntime
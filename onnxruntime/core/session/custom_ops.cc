@@ -16,6 +16,7 @@
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/op_kernel_info.h"
+#include "core/framework/prepacked_weights.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
@@ -46,6 +47,7 @@ static constexpr uint32_t min_ort_version_with_custom_version = 17;
 #if ENABLE_CUSTOM_OP_API
 static constexpr uint32_t min_ort_version_with_compute_v2_support = 16;
 static constexpr uint32_t min_ort_version_with_shape_inference = 17;
+static constexpr uint32_t min_ort_version_with_prepack_support = 20;
 #endif
 
 #if !defined(DISABLE_FLOAT8_TYPES)
@@ -311,6 +313,30 @@ static OrtStatusPtr ExecuteIfCustomOpsApiEnabled(const T&) {
 }
 #endif
 
+// The pre-packed weights of an initializer that are shared between sessions, with the allocator of their buffers.
+struct OrtSharedPrePackedWeightCache {
+  onnxruntime::PrePackedWeights* weights;
+  onnxruntime::AllocatorPtr allocator;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::SharedPrePackedWeightCache_StoreWeightData,
+                    _Inout_ OrtSharedPrePackedWeightCache* prepacked_weight_cache,
+                    _In_reads_(num_buffers) void** buffer_data_ptrs,
+                    _In_reads_(num_buffers) const size_t* buffer_data_sizes, _In_ size_t num_buffers) {
+  return ExecuteIfCustomOpsApiEnabled([&]() -> OrtStatusPtr {
+    if (prepacked_weight_cache == nullptr || (num_buffers > 0 && (!buffer_data_ptrs || !buffer_data_sizes))) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Invalid pre-packed weight cache or buffers");
+    }
+    auto& weights = *prepacked_weight_cache->weights;
+    onnxruntime::AllocatorPtr allocator = prepacked_weight_cache->allocator;
+    for (size_t i = 0; i < num_buffers; ++i) {
+      weights.buffers_.emplace_back(buffer_data_ptrs[i], [allocator](void* p) { allocator->Free(p); });
+      weights.buffer_sizes_.push_back(buffer_data_sizes[i]);
+    }
+    return nullptr;
+  });
+}
+
 ORT_API_STATUS_IMPL(OrtApis::ShapeInferContext_GetInputCount, _In_ const OrtShapeInferContext* context,
                     _Out_ size_t* out) {
   return ExecuteIfCustomOpsApiEnabled([&]() -> OrtStatusPtr {
@@ -793,6 +819,47 @@ struct CustomOpKernel : OpKernel {
     op_.KernelDestroy(op_kernel_);
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override {
+    is_packed = false;
+    if (op_.version < min_ort_version_with_prepack_support || !op_.KernelPrePackWeight) {
+      return Status::OK();
+    }
+
+    OrtValue value;
+    Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), const_cast<void*>(tensor.DataRaw()), tensor.Location(),
+                         value);
+
+    // the kernel frees the buffers it keeps with the allocator, so the wrapper lives as long as the kernel
+    OrtSharedPrePackedWeightCache cache{prepacked_weights, alloc};
+    prepack_allocators_.push_back(std::make_unique<OrtAllocatorImplWrappingIAllocator>(std::move(alloc)));
+
+    bool packed = false;
+    OrtAllocator* allocator = prepack_allocators_.back().get();
+    ORT_RETURN_IF_ERROR(ToStatus(op_.KernelPrePackWeight(op_kernel_, &value, input_idx, allocator,
+                                                         prepacked_weights != nullptr ? &cache : nullptr, &packed)));
+    is_packed = packed;
+    return Status::OK();
+  }
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override {
+    used_shared_buffers = false;
+    if (op_.version < min_ort_version_with_prepack_support || !op_.KernelSetSharedPrePackedWeight) {
+      return Status::OK();
+    }
+
+    InlinedVector<const void*> buffer_data_ptrs;
+    buffer_data_ptrs.reserve(prepacked_buffers.size());
+    for (const auto& buffer : prepacked_buffers) {
+      buffer_data_ptrs.push_back(buffer.get());
+    }
+    ORT_RETURN_IF_ERROR(ToStatus(op_.KernelSetSharedPrePackedWeight(op_kernel_, buffer_data_ptrs.data(),
+                                                                    buffer_data_ptrs.size(), input_idx)));
+    used_shared_buffers = true;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* ctx) const override {
     if (op_.version >= min_ort_version_with_compute_v2_support &&
         op_.KernelComputeV2) {
@@ -809,6 +876,7 @@ struct CustomOpKernel : OpKernel {
 
   const OrtCustomOp& op_;
   void* op_kernel_;
+  std::vector<std::unique_ptr<OrtAllocatorImplWrappingIAllocator>> prepack_allocators_;
 };
 
 #if !defined(ORT_MINIMAL_BUILD)
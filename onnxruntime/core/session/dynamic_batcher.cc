@@ -0,0 +1,331 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <cstring>
+
+#include "core/framework/error_code_helper.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+bool IsBatchableTensor(const OrtValue& value) {
+  if (!value.IsAllocated() || !value.IsTensor()) {
+    return false;
+  }
+
+  const auto& tensor = value.Get<Tensor>();
+  return !tensor.IsDataTypeString() && tensor.Location().device.Type() == OrtDevice::CPU &&
+         tensor.Shape().NumDimensions() > 0;
+}
+
+TensorShape WithBatchSize(const TensorShape& shape, size_t batch_size) {
+  auto dims = shape.AsShapeVector();
+  dims[0] = static_cast<int64_t>(batch_size);
+  return TensorShape(dims);
+}
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(size_t max_batch_size, std::chrono::microseconds max_wait,
+                               AllocatorPtr cpu_allocator, RunFn run_fn, const logging::Logger& logger)
+    : max_batch_size_(max_batch_size),
+      max_wait_(max_wait),
+      cpu_allocator_(std::move(cpu_allocator)),
+      run_fn_(std::move(run_fn)),
+      logger_(logger) {
+  worker_ = std::thread([this]() { WorkerLoop(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+void DynamicBatcher::Enqueue(gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+                             gsl::span<const char* const> fetch_names, gsl::span<OrtValue*> fetches,
+                             RunAsyncCallbackFn callback, void* user_data) {
+  Request request{feed_names, feeds, fetch_names, fetches, callback, user_data,
+                  GetBatchSize(feed_names, feeds, fetch_names), std::chrono::steady_clock::now()};
+  if (request.batch_size > max_batch_size_) {
+    request.batch_size = 0;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    queue_.push_back(request);
+  }
+  cv_.notify_one();
+}
+
+size_t DynamicBatcher::GetBatchSize(gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+                                    gsl::span<const char* const> fetch_names) {
+  if (feeds.empty() || feed_names.size() != feeds.size()) {
+    return 0;
+  }
+
+  for (const char* name : feed_names) {
+    if (name == nullptr) {
+      return 0;
+    }
+  }
+
+  for (const char* name : fetch_names) {
+    if (name == nullptr) {
+      return 0;
+    }
+  }
+
+  int64_t batch_size = -1;
+  for (const OrtValue* feed : feeds) {
+    if (feed == nullptr || !IsBatchableTensor(*feed)) {
+      return 0;
+    }
+
+    const int64_t rows = feed->Get<Tensor>().Shape()[0];
+    if (rows <= 0 || (batch_size != -1 && rows != batch_size)) {
+      return 0;
+    }
+    batch_size = rows;
+  }
+
+  return static_cast<size_t>(batch_size);
+}
+
+bool DynamicBatcher::CanBatchTogether(const Request& a, const Request& b) {
+  if (a.batch_size == 0 || b.batch_size == 0 ||
+      a.feeds.size() != b.feeds.size() || a.fetches.size() != b.fetches.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.feeds.size(); ++i) {
+    if (std::strcmp(a.feed_names[i], b.feed_names[i]) != 0) {
+      return false;
+    }
+
+    const auto& a_tensor = a.feeds[i]->Get<Tensor>();
+    const auto& b_tensor = b.feeds[i]->Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() ||
+        a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < a.fetch_names.size(); ++i) {
+    if (std::strcmp(a.fetch_names[i], b.fetch_names[i]) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+size_t DynamicBatcher::QueuedRowsForFirstRequest() const {
+  const Request& first = queue_.front();
+  size_t rows = first.batch_size;
+  for (auto it = std::next(queue_.begin()); it != queue_.end() && rows < max_batch_size_; ++it) {
+    if (CanBatchTogether(first, *it)) {
+      rows += it->batch_size;
+    }
+  }
+
+  return rows;
+}
+
+void DynamicBatcher::WorkerLoop() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // stop_ is set and there is nothing left to run
+      break;
+    }
+
+    // give other requests the chance to join the first one, unless the batch is already full.
+    if (queue_.front().batch_size != 0) {
+      const auto deadline = queue_.front().enqueue_time + max_wait_;
+      while (!stop_ && QueuedRowsForFirstRequest() < max_batch_size_) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+          break;
+        }
+        cv_.wait_for(lock, deadline - now);
+      }
+    }
+
+    std::vector<Request> batch;
+    batch.push_back(queue_.front());
+    queue_.pop_front();
+    size_t rows = batch.front().batch_size;
+    for (auto it = queue_.begin(); it != queue_.end() && rows < max_batch_size_;) {
+      if (CanBatchTogether(batch.front(), *it) && rows + it->batch_size <= max_batch_size_) {
+        rows += it->batch_size;
+        batch.push_back(*it);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    lock.unlock();
+    if (batch.size() == 1) {
+      RunAlone(batch.front());
+    } else {
+      RunBatch(batch);
+    }
+    lock.lock();
+  }
+}
+
+common::Status DynamicBatcher::RunGuarded(gsl::span<const char* const> feed_names,
+                                          gsl::span<const OrtValue* const> feeds,
+                                          gsl::span<const char* const> fetch_names, gsl::span<OrtValue*> fetches) {
+  Status status = Status::OK();
+  ORT_TRY {
+    status = run_fn_(feed_names, feeds, fetch_names, fetches);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+  ORT_CATCH(...) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+  }
+
+  return status;
+}
+
+void DynamicBatcher::RunAlone(Request& request) {
+  Status status = RunGuarded(request.feed_names, request.feeds, request.fetch_names, request.fetches);
+  request.callback(request.user_data, request.fetches.data(), status.IsOK() ? request.fetches.size() : 0,
+                   ToOrtStatus(status));
+}
+
+void DynamicBatcher::RunBatch(std::vector<Request>& requests) {
+  const Request& first = requests.front();
+  size_t total_rows = 0;
+  for (const auto& request : requests) {
+    total_rows += request.batch_size;
+  }
+
+  Status status = Status::OK();
+  std::vector<Status> request_statuses(requests.size());
+
+  ORT_TRY {
+    // concatenate the inputs along dim 0
+    InlinedVector<OrtValue> batched_feeds(first.feeds.size());
+    InlinedVector<const OrtValue*> batched_feed_ptrs;
+    batched_feed_ptrs.reserve(first.feeds.size());
+    for (size_t i = 0; i < first.feeds.size(); ++i) {
+      const auto& first_tensor = first.feeds[i]->Get<Tensor>();
+      Tensor::InitOrtValue(first_tensor.DataType(), WithBatchSize(first_tensor.Shape(), total_rows), cpu_allocator_,
+                           batched_feeds[i]);
+      auto* dst = static_cast<char*>(batched_feeds[i].GetMutable<Tensor>()->MutableDataRaw());
+      for (const auto& request : requests) {
+        const auto& tensor = request.feeds[i]->Get<Tensor>();
+        std::memcpy(dst, tensor.DataRaw(), tensor.SizeInBytes());
+        dst += tensor.SizeInBytes();
+      }
+      batched_feed_ptrs.push_back(&batched_feeds[i]);
+    }
+
+    InlinedVector<OrtValue*> batched_fetch_ptrs(first.fetches.size(), nullptr);
+    status = RunGuarded(first.feed_names, batched_feed_ptrs, first.fetch_names, batched_fetch_ptrs);
+
+    InlinedVector<std::unique_ptr<OrtValue>> batched_fetches;
+    batched_fetches.reserve(batched_fetch_ptrs.size());
+    for (OrtValue* fetch : batched_fetch_ptrs) {
+      batched_fetches.emplace_back(fetch);
+    }
+
+    if (status.IsOK()) {
+      status = SplitOutputs(gsl::span<const OrtValue* const>(batched_fetch_ptrs.data(), batched_fetch_ptrs.size()),
+                            total_rows, requests, request_statuses);
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
+
+  if (!status.IsOK()) {
+    LOGS(logger_, INFO) << "Running " << requests.size() << " requests as a batch failed, running them one by one. "
+                        << status.ErrorMessage();
+    for (auto& request : requests) {
+      RunAlone(request);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    auto& request = requests[i];
+    const auto& request_status = request_statuses[i];
+    request.callback(request.user_data, request.fetches.data(), request_status.IsOK() ? request.fetches.size() : 0,
+                     ToOrtStatus(request_status));
+  }
+}
+
+common::Status DynamicBatcher::SplitOutputs(gsl::span<const OrtValue* const> batched_fetches, size_t total_rows,
+                                            std::vector<Request>& requests,
+                                            std::vector<common::Status>& request_statuses) {
+  for (const OrtValue* fetch : batched_fetches) {
+    ORT_RETURN_IF_NOT(fetch != nullptr && IsBatchableTensor(*fetch) &&
+                          fetch->Get<Tensor>().Shape()[0] == static_cast<int64_t>(total_rows),
+                      "An output can't be split along its batch dimension.");
+  }
+
+  size_t row_offset = 0;
+  for (size_t r = 0; r < requests.size(); ++r) {
+    auto& request = requests[r];
+    auto& request_status = request_statuses[r];
+
+    // output values are only handed to the caller once all of them are filled in.
+    InlinedVector<std::unique_ptr<OrtValue>> new_fetches(request.fetches.size());
+    for (size_t i = 0; i < batched_fetches.size() && request_status.IsOK(); ++i) {
+      const auto& batched = batched_fetches[i]->Get<Tensor>();
+      const size_t row_bytes = batched.SizeInBytes() / total_rows;
+      const TensorShape shape = WithBatchSize(batched.Shape(), request.batch_size);
+
+      void* dst = nullptr;
+      if (request.fetches[i] != nullptr) {
+        Tensor* tensor = request.fetches[i]->IsTensor() ? request.fetches[i]->GetMutable<Tensor>() : nullptr;
+        if (tensor == nullptr || tensor->DataType() != batched.DataType() || tensor->Shape() != shape ||
+            tensor->Location().device.Type() != OrtDevice::CPU) {
+          request_status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The pre-allocated value for output ",
+                                           request.fetch_names[i], " doesn't match the output. Expected a CPU tensor ",
+                                           "with shape ", shape);
+          break;
+        }
+        dst = tensor->MutableDataRaw();
+      } else {
+        new_fetches[i] = std::make_unique<OrtValue>();
+        Tensor::InitOrtValue(batched.DataType(), shape, cpu_allocator_, *new_fetches[i]);
+        dst = new_fetches[i]->GetMutable<Tensor>()->MutableDataRaw();
+      }
+
+      std::memcpy(dst, static_cast<const char*>(batched.DataRaw()) + row_offset * row_bytes,
+                  request.batch_size * row_bytes);
+    }
+
+    if (request_status.IsOK()) {
+      for (size_t i = 0; i < new_fetches.size(); ++i) {
+        if (new_fetches[i]) {
+          request.fetches[i] = new_fetches[i].release();
+        }
+      }
+    }
+
+    row_offset += request.batch_size;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+/**
+ * Combines concurrent asynchronous runs into batched runs.
+ *
+ * Requests are queued and executed on a dedicated thread. Once a request is queued, the batcher waits up to
+ * max_wait for more requests that can join it, or until max_batch_size rows are available. Requests that can be
+ * batched together are concatenated along dim 0, run once, and the outputs are split into the caller's fetches.
+ *
+ * Requests can be batched together if they use the same input and output names in the same order and their inputs
+ * are CPU tensors of a fixed size element type, with matching element types and the same dims except for dim 0, which
+ * has to be the same for all inputs of a request. Inputs are not padded, so e.g. sequences of different lengths end
+ * up in different batches.
+ *
+ * If the outputs of a batched run can't be split along dim 0 (e.g. an output doesn't have a batch dimension), or the
+ * batched run fails, the requests are run one by one instead.
+ *
+ * Like InferenceSession::RunAsync, the names, feeds and fetches of a request must stay valid until its callback is
+ * called. Pending requests are run before the batcher is destroyed.
+ */
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<common::Status(gsl::span<const char* const> feed_names,
+                                             gsl::span<const OrtValue* const> feeds,
+                                             gsl::span<const char* const> fetch_names,
+                                             gsl::span<OrtValue*> fetches)>;
+
+  // cpu_allocator is used for the concatenated inputs and for outputs the caller didn't pre-allocate.
+  DynamicBatcher(size_t max_batch_size, std::chrono::microseconds max_wait, AllocatorPtr cpu_allocator,
+                 RunFn run_fn, const logging::Logger& logger);
+
+  ~DynamicBatcher();
+
+  void Enqueue(gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+               gsl::span<const char* const> fetch_names, gsl::span<OrtValue*> fetches,
+               RunAsyncCallbackFn callback, void* user_data);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    gsl::span<const char* const> feed_names;
+    gsl::span<const OrtValue* const> feeds;
+    gsl::span<const char* const> fetch_names;
+    gsl::span<OrtValue*> fetches;
+    RunAsyncCallbackFn callback;
+    void* user_data;
+    // number of rows, or 0 if the request can't be batched
+    size_t batch_size;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  static size_t GetBatchSize(gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+                             gsl::span<const char* const> fetch_names);
+  static bool CanBatchTogether(const Request& a, const Request& b);
+
+  // Number of rows of the queued requests that can be batched with the first one. Requires mutex_.
+  size_t QueuedRowsForFirstRequest() const;
+
+  void WorkerLoop();
+
+  void RunBatch(std::vector<Request>& requests);
+  void RunAlone(Request& request);
+  common::Status RunGuarded(gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+                            gsl::span<const char* const> fetch_names, gsl::span<OrtValue*> fetches);
+  common::Status SplitOutputs(gsl::span<const OrtValue* const> batched_fetches, size_t total_rows,
+                              std::vector<Request>& requests, std::vector<common::Status>& request_statuses);
+
+  const size_t max_batch_size_;
+  const std::chrono::microseconds max_wait_;
+  AllocatorPtr cpu_allocator_;
+  RunFn run_fn_;
+  const logging::Logger& logger_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::deque<Request> queue_;
+  bool stop_{false};
+
+  std::thread worker_;
+};
+
+}  // namespace onnxruntime
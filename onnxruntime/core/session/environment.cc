@@ -137,6 +137,9 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int64_t thread_cache_max_bytes = -1L;
+    int arena_type = -1;
+    int huge_page_mode = -1;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -154,10 +157,28 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_max_bytes = arena_cfg->thread_cache_max_bytes;
+
+      arena_type = arena_cfg->arena_type;
+      if (!(arena_type == -1 || arena_type == 0 || arena_type == 1)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Received invalid value for arena type."
+                               " Valid values can be either 0, 1 or -1.");
+      }
+
+      huge_page_mode = arena_cfg->huge_page_mode;
+      if (!(huge_page_mode >= -1 && huge_page_mode <= 2)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Received invalid value for huge page mode."
+                               " Valid values can be either 0, 1, 2 or -1.");
+      }
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
                             initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+    l_arena_cfg.thread_cache_max_bytes = thread_cache_max_bytes;
+    l_arena_cfg.arena_type = arena_type;
+    l_arena_cfg.huge_page_mode = huge_page_mode;
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
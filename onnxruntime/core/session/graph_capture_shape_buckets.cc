@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/graph_capture_shape_buckets.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+#include "core/framework/tensor.h"
+#include "core/session/IOBinding.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+// Annotation id of the runs that are not captured, see kCudaGraphAnnotationSkip.
+constexpr const char* kSkipGraphAnnotation = "-1";
+
+bool IsPaddableTensor(const OrtValue& value) {
+  if (!value.IsAllocated() || !value.IsTensor()) {
+    return false;
+  }
+
+  const auto& tensor = value.Get<Tensor>();
+  return !tensor.IsDataTypeString() && tensor.Location().device.Type() == OrtDevice::CPU;
+}
+
+const NodeArg* FindDef(const std::vector<const NodeArg*>& defs, const std::string& name) {
+  auto it = std::find_if(defs.begin(), defs.end(), [&name](const NodeArg* def) { return def->Name() == name; });
+  return it == defs.end() ? nullptr : *it;
+}
+
+// Copies the elements of src whose indices are within both shapes to the same indices of dst.
+void CopyOverlap(const Tensor& src, Tensor& dst) {
+  const auto& src_dims = src.Shape().GetDims();
+  const auto& dst_dims = dst.Shape().GetDims();
+  const size_t rank = src_dims.size();
+  const size_t element_size = src.DataType()->Size();
+
+  InlinedVector<int64_t> dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    dims[i] = std::min(src_dims[i], dst_dims[i]);
+    if (dims[i] <= 0) {
+      return;
+    }
+  }
+
+  const size_t row_bytes = (rank == 0 ? 1 : static_cast<size_t>(dims[rank - 1])) * element_size;
+  const auto* src_data = static_cast<const char*>(src.DataRaw());
+  auto* dst_data = static_cast<char*>(dst.MutableDataRaw());
+  if (rank <= 1) {
+    std::memcpy(dst_data, src_data, row_bytes);
+    return;
+  }
+
+  // row offsets in elements for every dim but the last one
+  InlinedVector<size_t> src_pitches(rank), dst_pitches(rank);
+  src_pitches[rank - 1] = dst_pitches[rank - 1] = 1;
+  for (size_t i = rank - 1; i > 0; --i) {
+    src_pitches[i - 1] = src_pitches[i] * static_cast<size_t>(src_dims[i]);
+    dst_pitches[i - 1] = dst_pitches[i] * static_cast<size_t>(dst_dims[i]);
+  }
+
+  InlinedVector<int64_t> index(rank - 1, 0);
+  while (true) {
+    size_t src_offset = 0, dst_offset = 0;
+    for (size_t i = 0; i + 1 < rank; ++i) {
+      src_offset += static_cast<size_t>(index[i]) * src_pitches[i];
+      dst_offset += static_cast<size_t>(index[i]) * dst_pitches[i];
+    }
+    std::memcpy(dst_data + dst_offset * element_size, src_data + src_offset * element_size, row_bytes);
+
+    size_t dim = rank - 1;
+    while (dim > 0 && ++index[dim - 1] == dims[dim - 1]) {
+      index[dim - 1] = 0;
+      --dim;
+    }
+    if (dim == 0) {
+      break;
+    }
+  }
+}
+
+// Zero pads src into dst, which is at least as large in every dim.
+void Pad(const Tensor& src, Tensor& dst) {
+  if (src.Shape() != dst.Shape()) {
+    std::memset(dst.MutableDataRaw(), 0, dst.SizeInBytes());
+  }
+  CopyOverlap(src, dst);
+}
+}  // namespace
+
+Status GraphCaptureShapeBuckets::ParseBuckets(const std::string& config, Buckets& buckets) {
+  buckets.clear();
+  for (const auto& entry : utils::SplitString(config, ";")) {
+    const auto separator = entry.find(':');
+    ORT_RETURN_IF(separator == std::string_view::npos || separator == 0,
+                  "Expected dim_param:size,size,... in the graph capture shape buckets: ", config);
+
+    std::vector<int64_t> sizes;
+    for (const auto& size_str : utils::SplitString(entry.substr(separator + 1), ",")) {
+      int64_t size = 0;
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(std::string(size_str), size) && size > 0 &&
+                            (sizes.empty() || size > sizes.back()),
+                        "Bucket sizes must be positive and increasing in the graph capture shape buckets: ", config);
+      sizes.push_back(size);
+    }
+    ORT_RETURN_IF(sizes.empty(), "No bucket size for ", entry, " in the graph capture shape buckets: ", config);
+    buckets.emplace_back(std::string(entry.substr(0, separator)), std::move(sizes));
+  }
+  return Status::OK();
+}
+
+GraphCaptureShapeBuckets::GraphCaptureShapeBuckets(InferenceSession& session, Buckets buckets,
+                                                   const OrtDevice& device, AllocatorPtr cpu_allocator)
+    : session_(session), buckets_(std::move(buckets)), device_(device), cpu_allocator_(std::move(cpu_allocator)) {
+}
+
+GraphCaptureShapeBuckets::~GraphCaptureShapeBuckets() = default;
+
+size_t GraphCaptureShapeBuckets::NumGraphs() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return graphs_.size();
+}
+
+bool GraphCaptureShapeBuckets::GetPaddedShapes(gsl::span<const std::string> feed_names,
+                                               gsl::span<const OrtValue> feeds,
+                                               std::vector<TensorShape>& padded_shapes,
+                                               std::unordered_map<std::string, int64_t>& dim_params) const {
+  const auto* input_defs = session_.GetModelInputs().second;
+  if (input_defs == nullptr) {
+    return false;
+  }
+
+  padded_shapes.clear();
+  dim_params.clear();
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const NodeArg* def = FindDef(*input_defs, feed_names[i]);
+    if (def == nullptr || !IsPaddableTensor(feeds[i])) {
+      return false;
+    }
+
+    auto dims = feeds[i].Get<Tensor>().Shape().AsShapeVector();
+    const auto* def_shape = def->Shape();
+    if (def_shape != nullptr && def_shape->dim_size() == static_cast<int>(dims.size())) {
+      for (size_t d = 0; d < dims.size(); ++d) {
+        const auto& dim = def_shape->dim(static_cast<int>(d));
+        if (!dim.has_dim_param()) {
+          continue;
+        }
+        auto bucket = std::find_if(buckets_.begin(), buckets_.end(),
+                                   [&dim](const auto& b) { return b.first == dim.dim_param(); });
+        if (bucket == buckets_.end()) {
+          continue;
+        }
+
+        // inputs sharing a dim_param are padded together
+        auto inserted = dim_params.emplace(dim.dim_param(), dims[d]);
+        if (!inserted.second && inserted.first->second != dims[d]) {
+          return false;
+        }
+        auto size = std::lower_bound(bucket->second.begin(), bucket->second.end(), dims[d]);
+        if (size == bucket->second.end()) {
+          return false;
+        }
+        dims[d] = *size;
+      }
+    }
+    padded_shapes.emplace_back(dims);
+  }
+  return true;
+}
+
+TensorShape GraphCaptureShapeBuckets::CroppedShape(const std::string& output_name, const TensorShape& shape,
+                                                   const std::unordered_map<std::string, int64_t>& dim_params) const {
+  const auto* output_defs = session_.GetModelOutputs().second;
+  const NodeArg* def = output_defs != nullptr ? FindDef(*output_defs, output_name) : nullptr;
+  if (def == nullptr || def->Shape() == nullptr ||
+      def->Shape()->dim_size() != static_cast<int>(shape.NumDimensions())) {
+    return shape;
+  }
+
+  auto dims = shape.AsShapeVector();
+  for (size_t d = 0; d < dims.size(); ++d) {
+    const auto& dim = def->Shape()->dim(static_cast<int>(d));
+    auto size = dim.has_dim_param() ? dim_params.find(dim.dim_param()) : dim_params.end();
+    if (size != dim_params.end()) {
+      dims[d] = std::min(dims[d], size->second);
+    }
+  }
+  return TensorShape(dims);
+}
+
+Status GraphCaptureShapeBuckets::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>& fetches) {
+  std::vector<TensorShape> padded_shapes;
+  std::unordered_map<std::string, int64_t> dim_params;
+  if (!GetPaddedShapes(feed_names, feeds, padded_shapes, dim_params)) {
+    return RunEagerly(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  std::pair<std::vector<std::string>, std::vector<int64_t>> key;
+  key.first.assign(feed_names.begin(), feed_names.end());
+  key.first.emplace_back();  // separates the feed names from the output names
+  key.first.insert(key.first.end(), output_names.begin(), output_names.end());
+  for (const auto& shape : padded_shapes) {
+    key.second.push_back(static_cast<int64_t>(shape.NumDimensions()));
+    const auto dims = shape.GetDims();
+    key.second.insert(key.second.end(), dims.begin(), dims.end());
+  }
+
+  Graph* graph = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = graphs_.find(key);
+    if (it != graphs_.end()) {
+      graph = it->second.get();
+    } else if (graphs_.size() < kMaxGraphs) {
+      std::unique_ptr<Graph> new_graph;
+      ORT_RETURN_IF_ERROR(CreateGraph(feed_names, feeds, output_names, padded_shapes, new_graph));
+      new_graph->annotation_id = static_cast<int>(graphs_.size()) + 1;
+      graph = graphs_.emplace(std::move(key), std::move(new_graph)).first->second.get();
+    }
+  }
+
+  if (graph == nullptr) {
+    return RunEagerly(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  std::lock_guard<OrtMutex> lock(graph->mutex);
+  return RunGraph(run_options, *graph, feeds, output_names, dim_params, fetches);
+}
+
+Status GraphCaptureShapeBuckets::CreateGraph(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                             gsl::span<const std::string> output_names,
+                                             const std::vector<TensorShape>& padded_shapes,
+                                             std::unique_ptr<Graph>& graph) {
+  graph = std::make_unique<Graph>();
+  ORT_RETURN_IF_ERROR(session_.NewIOBinding(&graph->binding));
+
+  graph->inputs.resize(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& feed = feeds[i].Get<Tensor>();
+    Tensor::InitOrtValue(feed.DataType(), padded_shapes[i], cpu_allocator_, graph->inputs[i]);
+    // allocates the buffer of the input on the device it is consumed on, which every run copies the padded input to
+    ORT_RETURN_IF_ERROR(graph->binding->BindInput(feed_names[i], graph->inputs[i]));
+  }
+
+  for (const auto& output_name : output_names) {
+    ORT_RETURN_IF_ERROR(graph->binding->BindOutput(output_name, device_));
+  }
+  graph->outputs.resize(output_names.size());
+  return Status::OK();
+}
+
+Status GraphCaptureShapeBuckets::RunGraph(const RunOptions& run_options, Graph& graph,
+                                          gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                          const std::unordered_map<std::string, int64_t>& dim_params,
+                                          std::vector<OrtValue>& fetches) {
+  const auto& data_transfer = session_.GetDataTransferManager();
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    Tensor& padded = *graph.inputs[i].GetMutable<Tensor>();
+    Pad(feeds[i].Get<Tensor>(), padded);
+    // the bound value shares its buffer with the padded input if the input is consumed on the CPU
+    OrtValue bound = graph.binding->GetInputs()[i];
+    Tensor& bound_tensor = *bound.GetMutable<Tensor>();
+    if (bound_tensor.DataRaw() != padded.DataRaw()) {
+      ORT_RETURN_IF_ERROR(data_transfer.CopyTensor(padded, bound_tensor));
+    }
+  }
+  ORT_RETURN_IF_ERROR(graph.binding->SynchronizeInputs());
+
+  RunOptions graph_run_options = run_options;
+  ORT_RETURN_IF_ERROR(graph_run_options.config_options.AddConfigEntry(
+      kOrtRunOptionsConfigCudaGraphAnnotation, std::to_string(graph.annotation_id).c_str()));
+  ORT_RETURN_IF_ERROR(session_.Run(graph_run_options, *graph.binding));
+  ORT_RETURN_IF_ERROR(graph.binding->SynchronizeOutputs());
+
+  const bool preallocated = fetches.size() == output_names.size();
+  if (!preallocated) {
+    fetches.clear();
+    fetches.resize(output_names.size());
+  }
+
+  const auto& outputs = graph.binding->GetOutputs();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const Tensor* output = &outputs[i].Get<Tensor>();
+    if (output->Location().device.Type() != OrtDevice::CPU) {
+      OrtValue& copy = graph.outputs[i];
+      if (!copy.IsAllocated() || copy.Get<Tensor>().Shape() != output->Shape()) {
+        Tensor::InitOrtValue(output->DataType(), output->Shape(), cpu_allocator_, copy);
+      }
+      ORT_RETURN_IF_ERROR(data_transfer.CopyTensor(*output, *copy.GetMutable<Tensor>()));
+      output = &copy.Get<Tensor>();
+    }
+
+    const TensorShape shape = CroppedShape(output_names[i], output->Shape(), dim_params);
+    OrtValue& fetch = fetches[i];
+    if (preallocated && fetch.IsAllocated()) {
+      ORT_RETURN_IF_NOT(fetch.IsTensor() && fetch.Get<Tensor>().Shape() == shape &&
+                            fetch.Get<Tensor>().DataType() == output->DataType() &&
+                            fetch.Get<Tensor>().Location().device.Type() == OrtDevice::CPU,
+                        "Pre-allocated output ", output_names[i], " must be a CPU tensor of shape ", shape);
+    } else {
+      Tensor::InitOrtValue(output->DataType(), shape, cpu_allocator_, fetch);
+    }
+    CopyOverlap(*output, *fetch.GetMutable<Tensor>());
+  }
+  return Status::OK();
+}
+
+Status GraphCaptureShapeBuckets::RunEagerly(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                            gsl::span<const OrtValue> feeds,
+                                            gsl::span<const std::string> output_names,
+                                            std::vector<OrtValue>& fetches) {
+  RunOptions eager_run_options = run_options;
+  ORT_RETURN_IF_ERROR(eager_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation,
+                                                                      kSkipGraphAnnotation));
+  return session_.Run(eager_run_options, feed_names, feeds, output_names, &fetches);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+class IOBinding;
+class Tensor;
+
+/**
+ * Runs a session whose graph is captured by its execution provider (e.g. CUDA graphs with enable_cuda_graph) with
+ * inputs of varying shapes.
+ *
+ * A captured graph replays the kernels with the shapes and buffer addresses of the run it was captured on. The dims
+ * of the model inputs named by one of the bucketed dim_params are rounded up to the smallest bucket size, and the
+ * inputs are zero padded into the input buffers of an IOBinding kept per combination of padded shapes. Each of them
+ * gets its own graph annotation id (kOrtRunOptionsConfigCudaGraphAnnotation), so the first run of a combination
+ * captures a graph and the next ones replay it on the same buffers. The dims of the outputs named by a bucketed
+ * dim_param are cropped back to the size of the run.
+ *
+ * The padding has to be neutral for the model, e.g. the padded tokens of a BERT model are masked out by the zeros of
+ * the padded attention mask.
+ *
+ * Runs are executed eagerly, without graph annotation, if a bucketed dim is larger than its largest bucket, the feeds
+ * are not all CPU tensors of a fixed size element type, or kMaxGraphs graphs are already captured. Outputs are
+ * returned as CPU tensors.
+ */
+class GraphCaptureShapeBuckets {
+ public:
+  // Bucket sizes of every bucketed dim_param, in increasing order.
+  using Buckets = std::vector<std::pair<std::string, std::vector<int64_t>>>;
+
+  // Each graph keeps its inputs and outputs alive on the device.
+  static constexpr size_t kMaxGraphs = 32;
+
+  // Parses "dim_param:size,size,...;dim_param:size,...".
+  static common::Status ParseBuckets(const std::string& config, Buckets& buckets);
+
+  // device is where the outputs of the captured graphs are bound. cpu_allocator is used for the padded inputs and
+  // the outputs returned to the caller.
+  GraphCaptureShapeBuckets(InferenceSession& session, Buckets buckets, const OrtDevice& device,
+                           AllocatorPtr cpu_allocator);
+
+  ~GraphCaptureShapeBuckets();
+
+  common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                     std::vector<OrtValue>& fetches);
+
+  // Number of combinations of padded shapes with a graph.
+  size_t NumGraphs() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphCaptureShapeBuckets);
+
+  struct Graph {
+    int annotation_id;
+    std::unique_ptr<IOBinding> binding;
+    // padded copies of the feeds, in the order of the feed names
+    std::vector<OrtValue> inputs;
+    // CPU copies of the outputs bound on a device
+    std::vector<OrtValue> outputs;
+    // Runs of a graph share its buffers.
+    OrtMutex mutex;
+  };
+
+  // Padded shapes of the feeds, and the size of the bucketed dim_params. Returns false if the run can't use a graph.
+  bool GetPaddedShapes(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                       std::vector<TensorShape>& padded_shapes,
+                       std::unordered_map<std::string, int64_t>& dim_params) const;
+
+  // Shape of an output with the bucketed dims cropped to their size in the run.
+  TensorShape CroppedShape(const std::string& output_name, const TensorShape& shape,
+                           const std::unordered_map<std::string, int64_t>& dim_params) const;
+
+  common::Status CreateGraph(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                             gsl::span<const std::string> output_names, const std::vector<TensorShape>& padded_shapes,
+                             std::unique_ptr<Graph>& graph);
+
+  common::Status RunGraph(const RunOptions& run_options, Graph& graph, gsl::span<const OrtValue> feeds,
+                          gsl::span<const std::string> output_names,
+                          const std::unordered_map<std::string, int64_t>& dim_params, std::vector<OrtValue>& fetches);
+
+  common::Status RunEagerly(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                            gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                            std::vector<OrtValue>& fetches);
+
+  InferenceSession& session_;
+  const Buckets buckets_;
+  const OrtDevice device_;
+  AllocatorPtr cpu_allocator_;
+
+  mutable OrtMutex mutex_;
+  // Graphs by feed names, output names and padded shapes of the feeds.
+  std::map<std::pair<std::vector<std::string>, std::vector<int64_t>>, std::unique_ptr<Graph>> graphs_;
+};
+
+}  // namespace onnxruntime
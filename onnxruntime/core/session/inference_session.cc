@@ -4,7 +4,14 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <list>
 #include <string>
@@ -20,6 +27,7 @@
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/compiled_partition_cache.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -29,18 +37,24 @@
 #include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/kernel_type_str_resolver_utils.h"
 #include "core/framework/mldata_type_utils.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/framework/tensor_external_data_info.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/run_allocation_report.h"
+#include "core/framework/stream_execution_context.h"
 #include "core/framework/transform_layout_functions.h"
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
+#include "core/optimizer/initializer_streaming_transformer.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
@@ -57,6 +71,7 @@
 #endif
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/providers/cuda/nvtx_profile.h"
 #ifdef USE_DML  // TODO: This is necessary for the workaround in TransformGraph
 #include "core/providers/dml/DmlExecutionProvider/src/DmlGraphFusionTransformer.h"
 #include "core/providers/dml/DmlExecutionProvider/src/DmlRuntimeGraphFusionTransformer.h"
@@ -69,6 +84,7 @@
 #include "core/session/user_logging_sink.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/lora_adapters.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "core/util/protobuf_parsing_utils.h"
@@ -244,6 +260,114 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// Reads kOrtSessionOptionsConfigNumaNode. Returns -1 if it's not set or the node doesn't exist.
+int GetNumaNodeFromConfig(const SessionOptions& session_options, const logging::Logger& logger) {
+  const std::string value = session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaNode, "-1");
+  int numa_node = -1;
+  if (!TryParseStringWithClassicLocale(value, numa_node) || numa_node < -1) {
+    LOGS(logger, WARNING) << "Invalid value '" << value << "' for " << kOrtSessionOptionsConfigNumaNode
+                          << ". NUMA placement is disabled.";
+    return -1;
+  }
+
+  if (numa_node >= 0) {
+    const auto numa_node_processors = Env::Default().GetNumaNodeProcessors();
+    if (static_cast<size_t>(numa_node) >= numa_node_processors.size() || numa_node_processors[numa_node].empty()) {
+      LOGS(logger, WARNING) << "NUMA node " << numa_node << " was not found. NUMA placement is disabled.";
+      return -1;
+    }
+  }
+
+  return numa_node;
+}
+
+// Returns the physical cores in 'cores' whose logical processors are all in 'processors'. Falls back to one core per
+// logical processor if the physical cores are unknown, or none of them is entirely in 'processors'.
+std::vector<LogicalProcessors> GetCoresWithin(const std::vector<LogicalProcessors>& cores,
+                                              const LogicalProcessors& processors) {
+  const InlinedHashSet<int> processor_set(processors.begin(), processors.end());
+  InlinedHashSet<int> known_processors;
+  std::vector<LogicalProcessors> ret;
+  for (const auto& core : cores) {
+    known_processors.insert(core.begin(), core.end());
+    if (!core.empty() && std::all_of(core.begin(), core.end(),
+                                     [&processor_set](int processor) { return processor_set.count(processor) > 0; })) {
+      ret.push_back(core);
+    }
+  }
+  if (ret.empty()) {
+    for (int processor : processors) {
+      if (known_processors.empty() || known_processors.count(processor) > 0) {
+        ret.push_back(LogicalProcessors{processor});
+      }
+    }
+  }
+  return ret;
+}
+
+// Returns the cores that kOrtSessionOptionsConfigNumaNode and kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly
+// restrict the intra-op threads to, or an empty vector if the threads are not restricted.
+std::vector<LogicalProcessors> GetIntraOpCores(int numa_node, bool performance_cores_only,
+                                               const logging::Logger& logger) {
+  std::vector<LogicalProcessors> ret;
+  auto cores = Env::Default().GetDefaultThreadAffinities();
+  if (numa_node >= 0) {
+    cores = GetCoresWithin(cores, Env::Default().GetNumaNodeProcessors()[numa_node]);
+    ret = cores;
+  }
+  if (performance_cores_only) {
+    const auto performance_processors = Env::Default().GetPerformanceCoreProcessors();
+    if (performance_processors.empty()) {
+      LOGS(logger, WARNING) << "No performance cores were found. " << kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly
+                            << " is ignored.";
+    } else {
+      ret = GetCoresWithin(cores, performance_processors);
+    }
+  }
+  return ret;
+}
+
+// Returns the intra-op thread affinities, in the kOrtSessionOptionsConfigIntraOpThreadAffinities format, that pin
+// one thread per core of 'cores'. 'thread_pool_size' is the requested number of threads, 0 for one thread per core.
+// Updates it to the number of threads. Returns an empty string if the threads can't be pinned.
+std::string GetThreadAffinitiesForCores(const std::vector<LogicalProcessors>& cores, int& thread_pool_size) {
+  if (thread_pool_size == 0) {
+    thread_pool_size = static_cast<int>(cores.size());
+  }
+  if (thread_pool_size <= 1 || static_cast<size_t>(thread_pool_size) > cores.size()) {
+    return {};
+  }
+
+  // the first core is left to the calling thread, which is the first member of the thread pool
+  std::ostringstream affinities;
+  for (int i = 1; i < thread_pool_size; ++i) {
+    if (i > 1) affinities << ";";
+    const auto& core = cores[i];
+    for (size_t j = 0; j < core.size(); ++j) {
+      if (j > 0) affinities << ",";
+      affinities << core[j] + 1;
+    }
+  }
+  return affinities.str();
+}
+
+// Whether a Run with these options behaves like one with the default options, so it can join a batched run.
+bool IsDefaultRunOptions(const RunOptions* run_options) {
+  return run_options == nullptr ||
+         (run_options->run_log_severity_level == -1 && run_options->run_tag.empty() && !run_options->terminate &&
+          !run_options->only_execute_path_to_fetches && run_options->config_options.configurations.empty());
+}
+
+Status GetRunPriority(const RunOptions& run_options, int& priority) {
+  priority = 0;
+  const std::string value = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigRunPriority, "");
+  if (!value.empty() && !TryParseStringWithClassicLocale(value, priority)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ", kOrtRunOptionsConfigRunPriority,
+                           ": ", value);
+  }
+  return Status::OK();
+}
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -320,6 +444,15 @@ static Status FinalizeSessionOptions(const SessionOptions& user_provided_session
   finalized_session_options = user_provided_session_options;
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // MemoryAwareNodeOrder records its order in the node priorities, which only the priority-based order follows.
+  if (finalized_session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableMemoryAwareNodeOrder,
+                                                                  "0") == "1" &&
+      finalized_session_options.execution_order == ExecutionOrder::DEFAULT) {
+    finalized_session_options.execution_order = ExecutionOrder::PRIORITY_BASED;
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
   return Status::OK();
 }
 
@@ -485,6 +618,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
   }
 
   use_per_session_threads_ = session_options.use_per_session_threads;
+  numa_node_ = GetNumaNodeFromConfig(session_options_, *session_logger_);
   force_spinning_stop_between_runs_ = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigForceSpinningStop, "0") == "1";
 
   if (use_per_session_threads_) {
@@ -507,6 +641,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.allow_spinning = allow_intra_op_spinning;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
+        to.adaptive_block_sizing_ =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAdaptiveBlockSizing, "0") == "1";
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
@@ -514,6 +650,21 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
+        } else {
+          const bool performance_cores_only = session_options_.config_options.GetConfigOrDefault(
+                                                  kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly, "0") == "1";
+          const auto cores = GetIntraOpCores(numa_node_, performance_cores_only, *session_logger_);
+          if (!cores.empty()) {
+            int thread_pool_size = to.thread_pool_size;
+            to.affinity_str = GetThreadAffinitiesForCores(cores, thread_pool_size);
+            if (!to.affinity_str.empty()) {
+              to.thread_pool_size = thread_pool_size;
+              LOGS(*session_logger_, INFO) << "Intra-op threads are pinned to: " << to.affinity_str;
+            } else {
+              LOGS(*session_logger_, WARNING) << "Intra-op threads could not be pinned to the "
+                                              << cores.size() << " selected core(s)";
+            }
+          }
         }
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
@@ -704,6 +855,27 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  // runs the pending requests
+  dynamic_batcher_.reset();
+
+  if (lazy_subgraph_warm_up_thread_.joinable()) {
+    stop_lazy_subgraph_warm_up_ = true;
+    lazy_subgraph_warm_up_thread_.join();
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  if (is_inited_ && !is_clone_) {
+    ORT_TRY {
+      SaveTuningResultsToCache();
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "Error saving the tuning results to the cache: " << e.what();
+      });
+    }
+  }
+#endif
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -839,6 +1011,14 @@ common::Status InferenceSession::RegisterExecutionProvider(const std::shared_ptr
   }
 
   p_exec_provider->SetLogger(session_logger_);
+
+  const std::string compiled_partition_cache_dir =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsEpCompiledPartitionCacheDir, "");
+  if (!compiled_partition_cache_dir.empty()) {
+    p_exec_provider->SetCompiledPartitionCache(
+        std::make_shared<const CompiledPartitionCache>(ToPathString(compiled_partition_cache_dir)));
+  }
+
   session_profiler_.AddEpProfilers(p_exec_provider->GetProfiler());
   return execution_providers_.Add(provider_type, p_exec_provider);
 }
@@ -990,9 +1170,13 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    ModelOptions model_opts(true, strict_shape_type_inference);
+    // the initializers would reference the original model file from the saved optimized model
+    model_opts.load_initializers_in_place =
+        session_options_.optimized_model_filepath.empty() &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsLoadInitializersInPlace, "0") == "1";
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_,
-                                    ModelOptions(true, strict_shape_type_inference));
+                                    *session_logger_, model_opts);
   };
 
   common::Status st = LoadWithLoader(loader, "model_loading_uri");
@@ -1324,16 +1508,29 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(copy_transformer, *session_logger_, graph));
   }
 
+  // Stream the large weights of the device nodes from host memory, after the copies of the initializers shared with
+  // other providers are made.
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsStreamInitializersFromHost, "0") == "1") {
+    InitializerStreamingTransformer streaming_transformer{{kCudaExecutionProvider, kRocmExecutionProvider}};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(streaming_transformer, *session_logger_, graph));
+  }
+
 #ifdef ENABLE_TRAINING
   // Enable memory optimizations.
-  // Only applicable for training scenarios.
+  // Applicable for training scenarios, and for inference if a memory budget is specified.
   {
     const std::string memory_optimizer_config_file =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerApplyConfig, "");
     const std::string probe_config =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerProbeConfig, "0:0");
-
-    MemoryOptimizer mem_transformer{memory_optimizer_config_file, probe_config};
+    const std::string inference_memory_budget_str =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerInferenceBudget, "-1");
+    int64_t inference_memory_budget = -1;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(inference_memory_budget_str, inference_memory_budget),
+                      "Invalid value for ", kOrtSessionOptionsMemoryOptimizerInferenceBudget, ": ",
+                      inference_memory_budget_str);
+
+    MemoryOptimizer mem_transformer{memory_optimizer_config_file, probe_config, inference_memory_budget};
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(mem_transformer, *session_logger_, graph));
   }
 #endif
@@ -1364,10 +1561,39 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+static Status MapOrtModelBytes(const PathString& model_uri,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_bytes) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_bytes));
+
+  bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
+
+        // the initializers can use the model bytes directly if the file stays mapped for the lifetime of the session.
+        // the mapping is page aligned, so the aligned initializer data in the flatbuffer is aligned in memory.
+        const bool use_ort_model_bytes_for_initializers =
+            session_options_.config_options.GetConfigOrDefault(
+                kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+        if (use_ort_model_bytes_for_initializers) {
+          const auto status = MapOrtModelBytes(model_location_, ort_format_model_bytes_,
+                                               ort_format_model_mapped_bytes_);
+          if (status.IsOK()) {
+            return Status::OK();
+          }
+
+          LOGS(*session_logger_, WARNING) << "Failed to map the ORT format model into memory, its bytes are copied: "
+                                          << status.ErrorMessage();
+        }
+
         ORT_RETURN_IF_ERROR(
             LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
         return Status::OK();
@@ -1395,6 +1621,295 @@ Status InferenceSession::LoadOrtModel(const void* model_data, int model_data_len
   });
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+static std::string HashToHex(const uint32_t (&hash)[4]) {
+  std::ostringstream hex;
+  hex << std::hex << std::setfill('0');
+  for (uint32_t word : hash) {
+    hex << std::setw(8) << word;
+  }
+  return hex.str();
+}
+
+// Collects the locations of the external data of the initializers in the graph and its subgraphs.
+static Status CollectExternalDataLocations(const ONNX_NAMESPACE::GraphProto& graph_proto,
+                                           std::set<std::basic_string<ORTCHAR_T>>& locations) {
+  for (const auto& initializer : graph_proto.initializer()) {
+    if (utils::HasExternalData(initializer)) {
+      std::unique_ptr<ExternalDataInfo> external_data_info;
+      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(initializer.external_data(), external_data_info));
+      locations.insert(external_data_info->GetRelPath());
+    }
+  }
+  for (const auto& node : graph_proto.node()) {
+    for (const auto& attribute : node.attribute()) {
+      if (attribute.has_g()) {
+        ORT_RETURN_IF_ERROR(CollectExternalDataLocations(attribute.g(), locations));
+      }
+      for (const auto& subgraph : attribute.graphs()) {
+        ORT_RETURN_IF_ERROR(CollectExternalDataLocations(subgraph, locations));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetOptimizedModelCachePath(bool have_cpu_ep, std::filesystem::path& cache_path) const {
+  cache_path.clear();
+  const auto& config_options = session_options_.config_options;
+  const std::string cache_dir = config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "");
+  if (cache_dir.empty()) {
+    return Status::OK();
+  }
+
+  const char* reason_not_used = nullptr;
+  if (!session_options_.optimized_model_filepath.empty()) {
+    reason_not_used = "the optimized model is saved to SessionOptions.optimized_model_filepath";
+  } else if (!ort_format_model_bytes_.empty()) {
+    reason_not_used = "the model is in ORT format";
+  } else if (HasLocalSchema()) {
+    reason_not_used = "the session uses custom op schemas";
+  } else if (!config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMinimalBuildOptimizations, "").empty()) {
+    reason_not_used = "minimal build optimizations are configured";
+  }
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+  if (!session_options_.external_initializers.empty() || !session_options_.external_initializer_files_mmap.empty()) {
+    reason_not_used = "the session injects external initializers";
+  }
+#endif
+  if (reason_not_used != nullptr) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used as " << reason_not_used << ".";
+    return Status::OK();
+  }
+
+  // the model and everything that affects how it is optimized and partitioned
+  const auto model_proto = model_->ToProto();
+  std::string model_bytes;
+  if (!model_proto.SerializeToString(&model_bytes) ||
+      model_bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used as the model can not be serialized.";
+    return Status::OK();
+  }
+
+  uint32_t model_hash[4];
+  MurmurHash3::x86_128(model_bytes.data(), static_cast<int>(model_bytes.size()), 0, model_hash);
+  std::string().swap(model_bytes);
+
+  std::ostringstream key;
+  key << "ort_version:" << ORT_VERSION << ";ort_model_version:" << kOrtModelVersion
+      << ";model:" << HashToHex(model_hash)
+      << ";graph_optimization_level:" << static_cast<int>(session_options_.graph_optimization_level);
+
+  // The model proto only refers to its external data, which the cached model holds the optimized values of, so the
+  // key includes the path, size and modification time of each external data file.
+  std::set<std::basic_string<ORTCHAR_T>> external_data_locations;
+  ORT_RETURN_IF_ERROR_SESSIONID_(CollectExternalDataLocations(model_proto.graph(), external_data_locations));
+  for (const auto& location : external_data_locations) {
+    if (location == utils::kTensorProtoMemoryAddressTag) {
+      LOGS(*session_logger_, INFO) << "The optimized model cache is not used as the model has external data in memory.";
+      return Status::OK();
+    }
+
+    std::error_code error;
+    const auto external_data_path = std::filesystem::absolute(model_->ModelPath().parent_path() / location, error);
+    const auto external_data_size = error ? 0 : std::filesystem::file_size(external_data_path, error);
+    const auto external_data_time = error ? std::filesystem::file_time_type{}
+                                          : std::filesystem::last_write_time(external_data_path, error);
+    if (error) {
+      LOGS(*session_logger_, INFO) << "The optimized model cache is not used as the external data file "
+                                   << PathToUTF8String(location) << " can not be read: " << error.message();
+      return Status::OK();
+    }
+    key << ";external_data:" << PathToUTF8String(external_data_path.native()) << "," << external_data_size << ","
+        << external_data_time.time_since_epoch().count();
+  }
+
+  // what the hardware specific optimizations depend on
+  key << ";nchwc_block_size:" << MlasNchwcGetBlockSize();
+#ifdef MLAS_TARGET_AMD64_IX86
+  key << ";u8s8_overflow:" << MlasPlatformU8S8Overflow();
+#endif
+
+  std::set<std::string> disabled_optimizers(optimizers_to_disable_.begin(), optimizers_to_disable_.end());
+  for (const auto& name : disabled_optimizers) {
+    key << ";disabled_optimizer:" << name;
+  }
+
+  std::map<std::string, std::string> configurations(config_options.configurations.begin(),
+                                                    config_options.configurations.end());
+  configurations.erase(kOrtSessionOptionsConfigOptimizedModelCacheDir);
+  for (const auto& [config_key, config_value] : configurations) {
+    key << ";config:" << config_key << "=" << config_value;
+  }
+
+  for (const auto& free_dimension_override : session_options_.free_dimension_overrides) {
+    key << ";free_dimension:" << free_dimension_override.dim_identifier << ","
+        << static_cast<int>(free_dimension_override.dim_identifier_type) << "=" << free_dimension_override.dim_value;
+  }
+
+  // the execution providers in priority order, with the implicitly added CPU EP last
+  for (const auto& execution_provider : execution_providers_) {
+    key << ";ep:" << execution_provider->Type();
+    const ProviderOptions provider_options = execution_provider->GetProviderOptions();
+    std::map<std::string, std::string> sorted_options(provider_options.begin(), provider_options.end());
+    for (const auto& [option_key, option_value] : sorted_options) {
+      key << "," << option_key << "=" << option_value;
+    }
+  }
+  if (!have_cpu_ep) {
+    key << ";ep:" << kCpuExecutionProvider;
+  }
+
+  const std::string key_string = key.str();
+  uint32_t key_hash[4];
+  MurmurHash3::x86_128(key_string.data(), static_cast<int>(key_string.size()), 0, key_hash);
+
+  cache_path = std::filesystem::path(ToPathString(cache_dir)) / ToPathString(HashToHex(key_hash) + ".ort");
+  return Status::OK();
+}
+
+void InferenceSession::LoadOptimizedModelFromCache(const std::filesystem::path& cache_path) {
+  std::error_code error;
+  if (!std::filesystem::exists(cache_path, error)) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache has no entry " << ToUTF8String(cache_path.native());
+    return;
+  }
+
+  std::shared_ptr<Model> onnx_model = model_;
+  Status status = LoadOrtModelBytes(cache_path.native(), ort_format_model_bytes_, ort_format_model_bytes_data_holder_);
+  if (status.IsOK()) {
+    status = LoadOrtModelFromBytes();
+  }
+
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model cache entry "
+                                    << ToUTF8String(cache_path.native()) << ". The model is optimized again. "
+                                    << status.ErrorMessage();
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    model_ = std::move(onnx_model);
+    ORT_IGNORE_RETURN_VALUE(SaveModelMetadata(*model_));
+    return;
+  }
+
+  LOGS(*session_logger_, INFO) << "Loaded the optimized model from the cache entry "
+                               << ToUTF8String(cache_path.native());
+}
+
+common::Status InferenceSession::SaveOptimizedModelToCache(const std::filesystem::path& cache_path) const {
+  for (const auto& node : model_->MainGraph().Nodes()) {
+    if (node.NodeType() == Node::Type::Fused) {
+      LOGS(*session_logger_, INFO) << "The optimized model is not cached as it contains nodes compiled by "
+                                   << node.GetExecutionProviderType();
+      return Status::OK();
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(cache_path.parent_path(), error);
+  ORT_RETURN_IF(error, "Failed to create the optimized model cache directory ",
+                ToUTF8String(cache_path.parent_path().native()), ": ", error.message());
+
+  std::filesystem::path temporary_path = cache_path;
+  temporary_path += ToPathString(".tmp" + std::to_string(Env::Default().GetSelfPid()) + "_" + std::to_string(session_id_));
+  Status status = SaveToOrtFormat(temporary_path);
+  if (status.IsOK()) {
+    std::filesystem::rename(temporary_path, cache_path, error);
+    if (error) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to add the optimized model cache entry ",
+                               ToUTF8String(cache_path.native()), ": ", error.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    std::filesystem::remove(temporary_path, error);
+  }
+  return status;
+}
+
+std::filesystem::path InferenceSession::GetTuningResultsCachePath(const TuningResults& tuning_results) const {
+  const std::string cache_dir = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigTuningResultsCacheDir, "");
+  if (cache_dir.empty()) {
+    return {};
+  }
+
+  // the ORT version, the device and the libraries the results were tuned with
+  std::map<std::string, std::string> validators(tuning_results.validators.begin(), tuning_results.validators.end());
+  std::ostringstream key;
+  key << "ep:" << tuning_results.ep;
+  for (const auto& [validator_key, validator_value] : validators) {
+    key << ";" << validator_key << "=" << validator_value;
+  }
+
+  const std::string key_string = key.str();
+  uint32_t key_hash[4];
+  MurmurHash3::x86_128(key_string.data(), static_cast<int>(key_string.size()), 0, key_hash);
+
+  return std::filesystem::path(ToPathString(cache_dir)) /
+         ToPathString(tuning_results.ep + "_" + HashToHex(key_hash) + ".json");
+}
+
+void InferenceSession::LoadTuningResultsFromCache() {
+  std::vector<TuningResults> tuning_results;
+  for (const auto& provider : execution_providers_) {
+    const auto* tuning_ctx = provider->GetTuningContext();
+    if (tuning_ctx == nullptr) {
+      continue;
+    }
+
+    const auto cache_path = GetTuningResultsCachePath(tuning_ctx->GetTuningResults());
+    if (cache_path.empty()) {
+      return;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::exists(cache_path, error)) {
+      LOGS(*session_logger_, INFO) << "The tuning results cache has no entry " << ToUTF8String(cache_path.native());
+      continue;
+    }
+
+    TuningResults cached_results;
+    Status status = inference_session_utils::LoadTuningResultsFromFile(cache_path, cached_results);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to load the tuning results cache entry "
+                                      << ToUTF8String(cache_path.native()) << ". " << status.ErrorMessage();
+      continue;
+    }
+
+    LOGS(*session_logger_, INFO) << "Loaded the tuning results of " << cached_results.ep << " from the cache entry "
+                                 << ToUTF8String(cache_path.native());
+    tuning_results.push_back(std::move(cached_results));
+  }
+
+  if (!tuning_results.empty()) {
+    Status status = SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to set the cached tuning results. " << status.ErrorMessage();
+    }
+  }
+}
+
+void InferenceSession::SaveTuningResultsToCache() const {
+  for (const auto& tuning_results : GetTuningResults()) {
+    if (tuning_results.results.empty()) {
+      continue;
+    }
+
+    const auto cache_path = GetTuningResultsCachePath(tuning_results);
+    if (cache_path.empty()) {
+      return;
+    }
+
+    Status status = inference_session_utils::SaveTuningResultsToFile(tuning_results, cache_path);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to save the tuning results of " << tuning_results.ep
+                                      << " to the cache. " << status.ErrorMessage();
+    }
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes) {
   std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
 
@@ -1411,7 +1926,10 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   }
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
+  return LoadOrtModelFromBytes();
+}
 
+Status InferenceSession::LoadOrtModelFromBytes() {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier), "ORT model verification failed.");
@@ -1671,6 +2189,9 @@ common::Status InferenceSession::Initialize() {
     env.GetTelemetryProvider().LogSessionCreationStart();
 
     bool have_cpu_ep = false;
+#if !defined(ORT_MINIMAL_BUILD)
+    std::filesystem::path optimized_model_cache_path;
+#endif
 
     {
       std::lock_guard<onnxruntime::OrtMutex> initial_guard(session_mutex_);
@@ -1686,6 +2207,14 @@ common::Status InferenceSession::Initialize() {
       }
 
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
+
+#if !defined(ORT_MINIMAL_BUILD)
+      // a cached optimized model replaces the loaded one before anything refers to its graph
+      ORT_RETURN_IF_ERROR_SESSIONID_(GetOptimizedModelCachePath(have_cpu_ep, optimized_model_cache_path));
+      if (!optimized_model_cache_path.empty()) {
+        LoadOptimizedModelFromCache(optimized_model_cache_path);
+      }
+#endif
     }
 
     // Verify that there are no external initializers in the graph if external data is disabled.
@@ -1705,6 +2234,7 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.numa_node = numa_node_;
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1745,6 +2275,25 @@ common::Status InferenceSession::Initialize() {
         session_options_,
         prepacked_weights_container_);
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableMetrics, "0") == "1") {
+      session_metrics_ = std::make_unique<SessionMetrics>();
+      session_state_->SetMetrics(session_metrics_.get());
+    }
+
+    session_state_->SetProfileMemory(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileMemory, "0") == "1");
+
+#ifdef ENABLE_NVTX_PROFILE
+    constexpr const char* kNvtxRangesDefault = "1";
+#else
+    constexpr const char* kNvtxRangesDefault = "0";
+#endif
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableNvtxRanges,
+                                                           kNvtxRangesDefault) == "1" &&
+        !profile::EnableNvtxRanges(true)) {
+      LOGS(*session_logger_, WARNING) << "NVTX ranges are not enabled, they need the CUDA execution provider.";
+    }
+
     bool use_env_allocators =
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators, "0") == "1";
     if (use_env_allocators) {
@@ -2009,6 +2558,14 @@ common::Status InferenceSession::Initialize() {
 
       // Update temporary copies of metadata, input- and output definitions to the same state as the resolved graph
       ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+
+      if (!optimized_model_cache_path.empty()) {
+        // the session does not fail if its optimized model can not be cached
+        Status cache_status = SaveOptimizedModelToCache(optimized_model_cache_path);
+        if (!cache_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to cache the optimized model. " << cache_status.ErrorMessage();
+        }
+      }
 #else   // !defined(ORT_MINIMAL_BUILD)
       ORT_RETURN_IF_ERROR_SESSIONID_(
           ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -2081,11 +2638,16 @@ common::Status InferenceSession::Initialize() {
     if (found_tuning_results) {
       ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true));
     }
+
+    LoadTuningResultsFromCache();
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    // before the session accepts runs, as it validates the configs of the runs
+    ORT_RETURN_IF_ERROR(InitializeRunState());
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -2103,6 +2665,18 @@ common::Status InferenceSession::Initialize() {
         graph.DomainToVersionMap(), graph.Name(), model_->MetaData(),
         telemetry_.event_name_, execution_providers_.GetIds(), model_has_fp16_inputs, false);
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazySubgraphInitialization,
+                                                           "0") == "1" &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazySubgraphWarmUp, "0") == "1") {
+      lazy_subgraph_warm_up_thread_ = std::thread([this]() {
+        auto warm_up_status = session_state_->FinalizeDeferredSubgraphs(stop_lazy_subgraph_warm_up_);
+        if (!warm_up_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Initializing subgraphs in the background failed: "
+                                          << warm_up_status.ErrorMessage();
+        }
+      });
+    }
+
     LOGS(*session_logger_, INFO) << "Session successfully initialized.";
   }
   ORT_CATCH(const NotImplementedException& ex) {
@@ -2141,6 +2715,182 @@ common::Status InferenceSession::Initialize() {
 #pragma warning(pop)
 #endif
 
+Status InferenceSession::InitializeRunState() {
+  const std::string max_batch_size_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0");
+  const std::string max_wait_us_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicroseconds, "1000");
+  size_t max_batch_size = 0;
+  int64_t max_wait_us = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_batch_size_str, max_batch_size),
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, ": ",
+                    max_batch_size_str);
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_wait_us_str, max_wait_us) && max_wait_us >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxWaitMicroseconds, ": ",
+                    max_wait_us_str);
+  const std::string max_async_runs_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigMaxConcurrentAsyncRuns, "0");
+  size_t max_async_runs = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_async_runs_str, max_async_runs),
+                    "Invalid value for ", kOrtSessionOptionsConfigMaxConcurrentAsyncRuns, ": ", max_async_runs_str);
+
+  const std::string max_degree_of_parallelism_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism, "0");
+  ORT_RETURN_IF_NOT(
+      TryParseStringWithClassicLocale(max_degree_of_parallelism_str, intra_op_max_degree_of_parallelism_) &&
+          intra_op_max_degree_of_parallelism_ >= 0,
+      "Invalid value for ", kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism, ": ",
+      max_degree_of_parallelism_str);
+  parallel_section_per_run_ =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelSectionPerRun, "0") == "1";
+  if (max_async_runs > 0) {
+    async_run_queue_ = std::make_unique<AsyncRunQueue>(max_async_runs, [this](std::function<void()> run) {
+      concurrency::ThreadPool::Schedule(GetIntraOpThreadPoolToUse(), std::move(run));
+    });
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  const std::string record_inputs_directory = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsRecordInputsDirectory, "");
+  if (!record_inputs_directory.empty()) {
+    const std::string every_n_runs_str = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsRecordInputsEveryNRuns, "100");
+    const std::string max_samples_str = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsRecordInputsMaxSamples, "1000");
+    size_t every_n_runs = 0;
+    size_t max_samples = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(every_n_runs_str, every_n_runs) && every_n_runs > 0,
+                      "Invalid value for ", kOrtSessionOptionsRecordInputsEveryNRuns, ": ", every_n_runs_str);
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_samples_str, max_samples),
+                      "Invalid value for ", kOrtSessionOptionsRecordInputsMaxSamples, ": ", max_samples_str);
+    input_recorder_ = std::make_unique<InputRecorder>(ToPathString(record_inputs_directory),
+                                                      every_n_runs, max_samples, *session_logger_);
+  }
+#endif
+
+  const std::string sample_every_n_runs_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigProfilingSampleEveryNRuns, "0");
+  const std::string sample_latency_threshold_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigProfilingSampleLatencyThresholdMs, "0");
+  const std::string sample_buffer_size_str = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigProfilingSampleBufferSize, "100000");
+  profiling::Profiler::SamplingOptions sampling_options;
+  double sample_latency_threshold_ms = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(sample_every_n_runs_str, sampling_options.every_n_runs),
+                    "Invalid value for ", kOrtSessionOptionsConfigProfilingSampleEveryNRuns, ": ",
+                    sample_every_n_runs_str);
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(sample_latency_threshold_str, sample_latency_threshold_ms) &&
+                        sample_latency_threshold_ms >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigProfilingSampleLatencyThresholdMs, ": ",
+                    sample_latency_threshold_str);
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(sample_buffer_size_str, sampling_options.ring_buffer_size) &&
+                        sampling_options.ring_buffer_size > 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigProfilingSampleBufferSize, ": ",
+                    sample_buffer_size_str);
+  sampling_options.latency_threshold_us = static_cast<int64_t>(sample_latency_threshold_ms * 1000);
+  if (sampling_options.every_n_runs > 0 || sampling_options.latency_threshold_us > 0) {
+    ORT_RETURN_IF(session_profiler_.IsEnabled(), "Sampled profiling (",
+                  kOrtSessionOptionsConfigProfilingSampleEveryNRuns, ", ",
+                  kOrtSessionOptionsConfigProfilingSampleLatencyThresholdMs, ") can't be combined with profiling.");
+    session_profiler_.StartSampling(sampling_options);
+  }
+
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileHardwareCounters, "0") ==
+      "1") {
+    const std::string fp_event_str = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigProfileHardwareCountersFpEvent, "0");
+    char* fp_event_end = nullptr;
+    const uint64_t fp_event = std::strtoull(fp_event_str.c_str(), &fp_event_end, 0);
+    ORT_RETURN_IF(fp_event_str.empty() || *fp_event_end != '\0', "Invalid value for ",
+                  kOrtSessionOptionsConfigProfileHardwareCountersFpEvent, ": ", fp_event_str);
+    std::unique_ptr<HardwareCounters> hardware_counters;
+    const auto counters_status = HardwareCounters::Create(fp_event, hardware_counters);
+    if (counters_status.IsOK()) {
+      session_profiler_.SetHardwareCounters(std::move(hardware_counters));
+    } else {
+      LOGS(*session_logger_, WARNING) << "Hardware counters are not profiled: " << counters_status.ErrorMessage();
+    }
+  }
+
+  if (max_batch_size > 1) {
+    dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+        max_batch_size, std::chrono::microseconds(max_wait_us), session_state_->GetAllocator(OrtDevice()),
+        [this](gsl::span<const char* const> feed_names, gsl::span<const OrtValue* const> feeds,
+               gsl::span<const char* const> fetch_names, gsl::span<OrtValue*> fetches) {
+          RunOptions run_options;
+          return Run(run_options, feed_names, feeds, fetch_names, fetches);
+        },
+        *session_logger_);
+  }
+
+  const std::string graph_capture_shape_buckets = session_options_.config_options.GetConfigOrDefault(
+      kOrtSessionOptionsConfigGraphCaptureShapeBuckets, "");
+  if (!graph_capture_shape_buckets.empty() && cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled()) {
+    GraphCaptureShapeBuckets::Buckets buckets;
+    ORT_RETURN_IF_ERROR(GraphCaptureShapeBuckets::ParseBuckets(graph_capture_shape_buckets, buckets));
+    graph_capture_shape_buckets_ = std::make_unique<GraphCaptureShapeBuckets>(
+        *this, std::move(buckets), cached_execution_provider_for_graph_replay_.GetDefaultDevice(),
+        session_state_->GetAllocator(OrtDevice()));
+  }
+
+  return Status::OK();
+}
+
+Status InferenceSession::Clone(const SessionOptions& session_options, std::unique_ptr<InferenceSession>& clone) const {
+  // taken under the lock, so that UpdateInitializers sees the clone
+  std::shared_ptr<SessionState> session_state;
+  {
+    std::lock_guard<OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session must be initialized before it is cloned.");
+    }
+    session_state = session_state_;
+  }
+  // the clones would run the execution providers concurrently, or replay the graphs captured by another session
+  ORT_RETURN_IF_NOT(is_concurrent_run_supported_,
+                    "A session whose execution providers don't support concurrent runs can't be cloned.");
+  ORT_RETURN_IF(cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled(),
+                "A session that captures graphs can't be cloned.");
+  // the execution plan depends on the execution mode
+  ORT_RETURN_IF_NOT(session_options.execution_mode == session_options_.execution_mode,
+                    "The execution mode of a clone must be the one of the session.");
+  // the kernels record their events to the profiler of the session state, which is the one of this session
+  ORT_RETURN_IF(session_options.enable_profiling ||
+                    session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileHardwareCounters,
+                                                                      "0") == "1",
+                "Profiling is not supported by a clone. Profile the session it is cloned from.");
+
+  auto new_session = std::make_unique<InferenceSession>(session_options, environment_);
+  new_session->model_ = model_;
+  new_session->model_location_ = model_location_;
+  const auto& provider_ids = execution_providers_.GetIds();
+  size_t provider_idx = 0;
+  for (const auto& provider : execution_providers_) {
+    ORT_RETURN_IF_ERROR(new_session->execution_providers_.Add(provider_ids[provider_idx++], provider));
+    // the managers own the data transfers and loaders they are given, so the clone gets its own
+    if (auto data_transfer = provider->GetDataTransfer()) {
+      ORT_RETURN_IF_ERROR(new_session->data_transfer_mgr_.RegisterDataTransfer(std::move(data_transfer)));
+    }
+    if (auto external_data_loader = provider->GetExternalDataLoader()) {
+      ORT_RETURN_IF_ERROR(
+          new_session->external_data_loader_mgr_.RegisterExternalDataLoader(std::move(external_data_loader)));
+    }
+  }
+
+  new_session->session_state_ = std::move(session_state);
+  new_session->is_clone_ = true;
+  ORT_RETURN_IF_ERROR(new_session->SaveModelMetadata(*model_));
+  ORT_RETURN_IF_ERROR(new_session->InitializeRunState());
+  ORT_RETURN_IF(new_session->session_profiler_.IsSampling(),
+                "Sampled profiling is not supported by a clone. Profile the session it is cloned from.");
+  new_session->is_model_loaded_ = true;
+  new_session->is_inited_ = true;
+
+  LOGS(*new_session->session_logger_, INFO) << "Session cloned from session " << session_id_ << ".";
+  clone = std::move(new_session);
+  return Status::OK();
+}
+
 int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
@@ -2426,6 +3176,7 @@ Status InferenceSession::PartialRun(onnxruntime::RunOptions& run_options,
       session_state_->IncrementGraphExecutionCounter();
     }
 #endif
+    std::shared_lock<std::shared_mutex> initializers_lock(initializers_mutex_);
     ORT_CHECK_AND_SET_RETVAL(utils::ExecutePartialGraph(*session_state_, feeds_fetches_manager, feeds, fetches,
                                                         run_logger, state, cache, run_options.terminate,
                                                         partial_graph_index,
@@ -2478,7 +3229,89 @@ struct ThreadPoolSpinningSwitch {
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
-                             const std::vector<OrtDevice>* p_fetches_device_info) {
+                             const std::vector<OrtDevice>* p_fetches_device_info,
+                             const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators) {
+  Status status;
+  if (!run_options.active_lora_adapters.empty()) {
+    // feed the parameters of the active adapters to the model inputs that weren't fed
+    std::vector<std::string> adapter_feed_names(feed_names.begin(), feed_names.end());
+    std::vector<OrtValue> adapter_feeds(feeds.begin(), feeds.end());
+    InlinedHashSet<std::string_view> fed_names(feed_names.begin(), feed_names.end());
+    for (const auto* adapter : run_options.active_lora_adapters) {
+      for (const auto& [name, value] : adapter->Parameters()) {
+        if (input_def_map_.find(name) != input_def_map_.end() && fed_names.insert(name).second) {
+          adapter_feed_names.push_back(name);
+          adapter_feeds.push_back(value);
+        }
+      }
+    }
+
+    status = RunImpl(run_options, adapter_feed_names, adapter_feeds, output_names, p_fetches, p_fetches_device_info,
+                     p_fetch_allocators, nullptr);
+  } else {
+    status = RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                     p_fetch_allocators, nullptr);
+  }
+#if !defined(ORT_MINIMAL_BUILD)
+  if (status.IsOK() && input_recorder_) {
+    input_recorder_->Record(feed_names, feeds);
+  }
+#endif
+  return status;
+}
+
+Status InferenceSession::PrepareRun(gsl::span<const std::string> feed_names,
+                                    gsl::span<const std::string> output_names,
+                                    std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager) const {
+  if (!is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, nullptr));
+  for (const auto& name : feed_names) {
+    if (input_def_map_.find(name) == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", name);
+    }
+  }
+
+  return FeedsFetchesManager::Create(feed_names, output_names, session_state_->GetOrtValueNameIdxMap(),
+                                     feeds_fetches_manager);
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches) {
+  if (!run_options.active_lora_adapters.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "LoRA adapters can't be active in a prepared run, whose input names are fixed.");
+  }
+
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  auto status = RunImpl(run_options, info.feed_names, feeds, info.output_names, p_fetches, nullptr, nullptr,
+                        &feeds_fetches_manager);
+#if !defined(ORT_MINIMAL_BUILD)
+  if (status.IsOK() && input_recorder_) {
+    input_recorder_->Record(info.feed_names, feeds);
+  }
+#endif
+  return status;
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators,
+                                 FeedsFetchesManager* prepared_feeds_fetches_manager) {
+  // runs with IOBinding or a graph annotation manage their graphs themselves
+  if (graph_capture_shape_buckets_ != nullptr && p_fetches_device_info == nullptr && p_fetch_allocators == nullptr &&
+      !run_options.config_options.GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation).has_value()) {
+    return graph_capture_shape_buckets_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
+  // decides whether the run is profiled in the sampled mode
+  profiling::Profiler::RunScope sampled_run(session_profiler_);
+  profile::NvtxRunScope nvtx_run(session_options_.session_logid);
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2544,8 +3377,14 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      std::optional<FeedsFetchesManager> owned_feeds_fetches_manager;
+      if (prepared_feeds_fetches_manager == nullptr) {
+        FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+        owned_feeds_fetches_manager.emplace(std::move(info));
+      }
+      FeedsFetchesManager& feeds_fetches_manager = prepared_feeds_fetches_manager != nullptr
+                                                       ? *prepared_feeds_fetches_manager
+                                                       : *owned_feeds_fetches_manager;
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
@@ -2604,14 +3443,37 @@ Status InferenceSession::Run(const RunOptions& run_options,
       DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
 #endif
 
+      int run_priority = 0;
+      ORT_CHECK_AND_SET_RETVAL(GetRunPriority(run_options, run_priority));
+
+      std::optional<RunAllocationReport> allocation_report;
+      if (run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigReportAllocations, "0") == "1") {
+        allocation_report.emplace();
+        allocation_report->Start(session_state_->GetAllocators());
+      }
+
       if (retval.IsOK()) {
+        RunPriorityGate::Scope priority_scope(run_priority_gate_, run_priority);
+        concurrency::ThreadPool::ScopedMaxDegreeOfParallelism max_degree_of_parallelism_scope(
+            intra_op_max_degree_of_parallelism_);
+        std::optional<concurrency::ThreadPool::ParallelSection> parallel_section;
+        if (parallel_section_per_run_) {
+          parallel_section.emplace(GetIntraOpThreadPoolToUse());
+        }
+        RunAllocationReport::Scope allocation_report_scope(allocation_report ? &*allocation_report : nullptr);
+        // the thread pools of the session, which are not those of the session state in a clone
+        const RunThreadPools thread_pools{GetIntraOpThreadPoolToUse(), GetInterOpThreadPoolToUse()};
+        std::shared_lock<std::shared_mutex> initializers_lock(initializers_mutex_);
         retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
                                      session_options_.execution_mode,
                                      run_options,
 #ifdef ORT_ENABLE_STREAM
                                      device_stream_collection_holder,
 #endif
-                                     run_logger);
+                                     run_logger,
+                                     &priority_scope,
+                                     p_fetch_allocators,
+                                     &thread_pools);
       }
 
       // info all execution providers InferenceSession:Run ended
@@ -2621,6 +3483,14 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_CHECK_AND_SET_RETVAL(status);
       }
 
+      if (allocation_report) {
+        allocation_report->Stop(session_state_->GetAllocators());
+        LOGS(run_logger, INFO) << "Allocations of the run: " << allocation_report->ToString();
+        if (session_metrics_) {
+          session_metrics_->RecordRunAllocations(*allocation_report);
+        }
+      }
+
       // Move stream cleanup from ExecuteGraph to here for cuda graph capture.
       // Cleanup will call cudaStreamSyncronize, which is not allowed for graph capture.
       // Note that graph capture ends when we call xp->OnRunEnd() in the above code so it is safe here.
@@ -2666,7 +3536,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
 
   // send out profiling events (optional)
   if (session_profiler_.IsEnabled()) {
-    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    if (nvtx_run.CorrelationId() != 0) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp,
+                                              {{"correlation_id", std::to_string(nvtx_run.CorrelationId())}});
+    } else {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    }
   }
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   TraceLoggingWriteStop(ortrun_activity, "OrtRun");
@@ -2682,7 +3557,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
       cached_execution_provider_for_graph_replay_.AllowGraphCaptureOnRun(graph_annotation_id) &&
       !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                p_fetch_allocators, prepared_feeds_fetches_manager));
   }
   return retval;
 }
@@ -2765,6 +3641,11 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           gsl::span<OrtValue*> fetches,
                                           RunAsyncCallbackFn callback,
                                           void* user_data) {
+  if (dynamic_batcher_ && IsDefaultRunOptions(run_options)) {
+    dynamic_batcher_->Enqueue(feed_names, feeds, fetch_names, fetches, callback, user_data);
+    return Status::OK();
+  }
+
   size_t num_fetches = fetch_names.size();
   auto* tp = GetIntraOpThreadPoolToUse();
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
@@ -2790,7 +3671,16 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
     }
     callback(user_data, fetches.data(), status.IsOK() ? num_fetches : 0, ToOrtStatus(status));
   };  // run_fn
-  concurrency::ThreadPool::Schedule(tp, run_fn);
+
+  if (async_run_queue_) {
+    int priority = 0;
+    if (run_options) {
+      ORT_RETURN_IF_ERROR(GetRunPriority(*run_options, priority));
+    }
+    async_run_queue_->Submit(priority, std::move(run_fn));
+  } else {
+    concurrency::ThreadPool::Schedule(tp, run_fn);
+  }
   return Status::OK();
 }
 
@@ -2882,8 +3772,18 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+
+  // outputs bound to an allocator get new memory from it in every run
+  for (const auto& entry : io_binding.output_allocators_) {
+    io_binding.outputs_[entry.first] = OrtValue();
+  }
+  ORT_RETURN_IF_ERROR(io_binding.PrepareStates());
+
+  ORT_RETURN_IF_ERROR(Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+                          &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo(),
+                          io_binding.output_allocators_.empty() ? nullptr : &io_binding.output_allocators_));
+  io_binding.AdvanceStates();
+  return Status::OK();
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -2891,8 +3791,88 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::WarmUp(const RunOptions& run_options,
+                                        const InlinedHashMap<std::string, TensorShapeVector>& input_shapes,
+                                        size_t num_runs, std::vector<int64_t>& run_durations_us) {
+  if (!is_inited_) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  for (const auto& entry : input_shapes) {
+    if (input_def_map_.find(entry.first) == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", entry.first);
+    }
+  }
+
+  AllocatorPtr cpu_allocator = session_state_->GetAllocator(OrtDevice());
+  ORT_RETURN_IF(cpu_allocator == nullptr, "No CPU allocator to create the warm up inputs.");
+
+  // the graph inputs have the free dimension overrides applied by Initialize
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  for (const NodeArg* input : session_state_->GetGraphViewer().GetInputs()) {
+    const auto& name = input->Name();
+    const auto& meta = input_def_map_.at(name);
+    if (meta.ml_data_type == nullptr || !meta.ml_data_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name,
+                             " is not a tensor. Only tensor inputs can be warmed up.");
+    }
+
+    TensorShape shape;
+    auto shape_it = input_shapes.find(name);
+    if (shape_it != input_shapes.end()) {
+      shape = TensorShape(shape_it->second);
+    } else if (input->Shape() != nullptr) {
+      shape = utils::GetTensorShapeFromTensorShapeProto(*input->Shape());
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name,
+                             " has no shape in the model. Give the shape of the input.");
+    }
+
+    for (size_t i = 0, end = shape.NumDimensions(); i < end; ++i) {
+      if (shape[i] < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Dimension ", i, " of input ", name,
+                               " is free. Give the shape of the input or override the dimension.");
+      }
+    }
+
+    const auto* elem_type = meta.ml_data_type->AsTensorType()->GetElementType();
+    OrtValue feed;
+    Tensor::InitOrtValue(elem_type, shape, cpu_allocator, feed);
+    auto* tensor = feed.GetMutable<Tensor>();
+    if (!tensor->IsDataTypeString()) {
+      memset(tensor->MutableDataRaw(), 0, tensor->SizeInBytes());
+    }
+
+    feed_names.push_back(name);
+    feeds.push_back(std::move(feed));
+  }
+
+  std::vector<std::string> output_names;
+  output_names.reserve(output_def_map_.size());
+  for (const NodeArg* output : session_state_->GetGraphViewer().GetOutputs()) {
+    output_names.push_back(output->Name());
+  }
+
+  run_durations_us.clear();
+  run_durations_us.reserve(num_runs);
+  for (size_t run = 0; run < num_runs; ++run) {
+    std::vector<OrtValue> fetches;
+    const TimePoint start = std::chrono::high_resolution_clock::now();
+    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, &fetches));
+    run_durations_us.push_back(static_cast<int64_t>(TimeDiffMicroSeconds(start)));
+    LOGS(*session_logger_, INFO) << "Warm up run " << run << " took " << run_durations_us.back() << " us.";
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
+  if (is_clone_) {
+    LOGS(*session_logger_, WARNING) << "Profiling is not supported by a clone. Profile the session it is cloned from.";
+    return;
+  }
   std::basic_ostringstream<T> ss;
   ss << file_prefix << "_" << GetCurrentTimeString<T>() << ".json";
   session_profiler_.StartProfiling(ss.str());
@@ -2909,6 +3889,10 @@ void InferenceSession::StartProfiling(const std::wstring& file_prefix) {
 #endif
 
 void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
+  if (is_clone_) {
+    LOGS(*session_logger_, WARNING) << "Profiling is not supported by a clone. Profile the session it is cloned from.";
+    return;
+  }
   session_profiler_.StartProfiling(logger_ptr);
 }
 
@@ -2929,6 +3913,133 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+void InferenceSession::SetProfilingSampleCallback(profiling::Profiler::SampleCallback callback) {
+  session_profiler_.SetSampleCallback(std::move(callback));
+}
+
+common::Status InferenceSession::GetMetrics(std::string& metrics_json) const {
+#if !defined(ORT_MINIMAL_BUILD)
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not initialized");
+  }
+  if (!session_metrics_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Metrics are not enabled. Set the session option ",
+                           kOrtSessionOptionsConfigEnableMetrics, " to \"1\" to enable them.");
+  }
+
+  auto histogram_to_json = [](const LatencyHistogram::Snapshot& snapshot) {
+    nlohmann::json buckets = nlohmann::json::array();
+    for (size_t i = 0; i < snapshot.bucket_counts.size(); ++i) {
+      if (snapshot.bucket_counts[i] != 0) {
+        buckets.push_back({LatencyHistogram::BucketUpperBound(i), snapshot.bucket_counts[i]});
+      }
+    }
+    return nlohmann::json{{"count", snapshot.count},
+                          {"sum_ns", snapshot.sum_ns},
+                          {"max_ns", snapshot.max_ns},
+                          {"p50_ns", snapshot.PercentileNs(50)},
+                          {"p90_ns", snapshot.PercentileNs(90)},
+                          {"p99_ns", snapshot.PercentileNs(99)},
+                          // [upper bound in ns, count] of the buckets that are not empty
+                          {"buckets", std::move(buckets)}};
+  };
+
+  nlohmann::json metrics;
+  nlohmann::json& nodes = metrics["nodes"] = nlohmann::json::object();
+  nlohmann::json& op_types = metrics["op_types"] = nlohmann::json::object();
+  session_metrics_->ForEachHistogram(
+      [&](const std::string& name, const LatencyHistogram::Snapshot& snapshot) {
+        nodes[name] = histogram_to_json(snapshot);
+      },
+      [&](const std::string& name, const LatencyHistogram::Snapshot& snapshot) {
+        op_types[name] = histogram_to_json(snapshot);
+      });
+
+  nlohmann::json& run_allocations = metrics["run_allocations"] = nlohmann::json::object();
+  for (const auto& [device, allocations] : session_metrics_->GetRunAllocations()) {
+    run_allocations[device] = {{"num_runs", allocations.num_runs},
+                               {"mean_peak_bytes", allocations.sum_peak_bytes / allocations.num_runs},
+                               {"max_peak_bytes", allocations.max_peak_bytes},
+                               {"num_allocations", allocations.num_allocations},
+                               {"num_runs_with_arena_extensions", allocations.num_runs_with_arena_extensions}};
+  }
+
+  nlohmann::json& allocators = metrics["allocators"] = nlohmann::json::array();
+  for (const auto& [device, allocator] : session_state_->GetAllocators()) {
+    AllocatorStats stats;
+    allocator->GetStats(&stats);
+    allocators.push_back({{"device", device.ToString()},
+                          {"bytes_in_use", stats.bytes_in_use},
+                          {"max_bytes_in_use", stats.max_bytes_in_use},
+                          {"total_allocated_bytes", stats.total_allocated_bytes},
+                          {"num_allocs", stats.num_allocs}});
+  }
+
+  // the number of tasks waiting in the queues of the threads, which is approximate while the pools are busy
+  metrics["thread_pools"] = {
+      {"intra_op", {{"num_pending_tasks", concurrency::ThreadPool::NumPendingTasks(GetIntraOpThreadPoolToUse())}}},
+      {"inter_op", {{"num_pending_tasks", concurrency::ThreadPool::NumPendingTasks(GetInterOpThreadPoolToUse())}}}};
+  // the scheduling statistics are collected while the session is profiled
+  const std::pair<const char*, const concurrency::ThreadPool*> thread_pools[] = {
+      {"intra_op", GetIntraOpThreadPoolToUse()}, {"inter_op", GetInterOpThreadPoolToUse()}};
+  for (const auto& [name, thread_pool] : thread_pools) {
+    auto stats = nlohmann::json::parse(concurrency::ThreadPool::GetProfilingStats(thread_pool), nullptr, false);
+    if (!stats.is_discarded()) {
+      metrics["thread_pools"][name]["scheduling"] = std::move(stats);
+    }
+  }
+
+  metrics_json = metrics.dump();
+  return Status::OK();
+#else
+  ORT_UNUSED_PARAMETER(metrics_json);
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Metrics are not supported in this build.");
+#endif
+}
+
+common::Status InferenceSession::UpdateInitializers(gsl::span<const std::string> names,
+                                                    gsl::span<const OrtValue> values) {
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session was not initialized");
+  }
+  if (names.size() != values.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Got ", names.size(), " initializer names and ",
+                           values.size(), " values.");
+  }
+
+  std::lock_guard<OrtMutex> l(session_mutex_);
+  // an update would change the clones too
+  if (is_clone_ || session_state_.use_count() > 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The initializers of a session that shares its session state with "
+                           "clones can't be updated.");
+  }
+
+  std::unique_lock<std::shared_mutex> initializers_lock(initializers_mutex_);
+  for (size_t i = 0; i < names.size(); ++i) {
+    const std::string& name = names[i];
+    if (!values[i].IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The new value of initializer ", name,
+                             " is not a tensor.");
+    }
+    // the session state holds the OrtValue of the caller, which other sessions may share too
+    if (session_options_.initializers_to_share_map.count(name) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Initializer ", name,
+                             " was added to the session options and can't be updated.");
+    }
+
+    bool found = false;
+    ORT_RETURN_IF_ERROR_SESSIONID_(session_state_->UpdateInitializer(name, values[i].Get<Tensor>(), found));
+    if (!found) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Initializer ", name,
+                             " is not used by the optimized model. If graph optimizations folded it, list it in the "
+                             "session option ", kOrtSessionOptionsConfigUpdatableInitializers, ".");
+    }
+    LOGS(*session_logger_, INFO) << "Updated initializer " << name;
+  }
+
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -3181,6 +4292,12 @@ common::Status InferenceSession::AddPredefinedTransformers(
     MinimalBuildOptimizationHandling minimal_build_optimization_handling,
     RecordRuntimeOptimizationProducedNodeOpSchemaFn record_runtime_optimization_produced_op_schema_fn) const {
   const auto& cpu_ep = *execution_providers_.Get(onnxruntime::kCpuExecutionProvider);
+  MatMulNBitsFormatsByEp matmul_nbits_formats;
+  for (const auto& ep : execution_providers_) {
+    if (auto formats = ep->GetMatMulNBitsFormats(); !formats.empty()) {
+      matmul_nbits_formats.emplace(ep->Type(), std::move(formats));
+    }
+  }
   for (int i = static_cast<int>(TransformerLevel::Level1); i <= static_cast<int>(TransformerLevel::MaxLevel); i++) {
     TransformerLevel level = static_cast<TransformerLevel>(i);
     if (graph_optimization_level >= level) {
@@ -3194,7 +4311,8 @@ common::Status InferenceSession::AddPredefinedTransformers(
           return optimizer_utils::GenerateTransformers(level, session_options_, cpu_ep,
                                                        optimizers_to_disable_,
                                                        GetIntraOpThreadPoolToUse(),
-                                                       session_state_->GetMutableBufferedTensors());
+                                                       session_state_->GetMutableBufferedTensors(),
+                                                       matmul_nbits_formats);
         } else {
           const auto sat_context =
               minimal_build_optimization_handling ==
@@ -3205,7 +4323,8 @@ common::Status InferenceSession::AddPredefinedTransformers(
           return optimizer_utils::GenerateTransformersForMinimalBuild(level, session_options_, sat_context, cpu_ep,
                                                                       optimizers_to_disable_,
                                                                       GetIntraOpThreadPoolToUse(),
-                                                                      session_state_->GetMutableBufferedTensors());
+                                                                      session_state_->GetMutableBufferedTensors(),
+                                                                      matmul_nbits_formats);
         }
       }();
 
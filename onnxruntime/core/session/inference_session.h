@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <filesystem>
 
@@ -19,6 +22,7 @@
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/external_data_loader_manager.h"
+#include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state.h"
@@ -29,7 +33,13 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
+#include "core/framework/run_priority_gate.h"
+#include "core/session/async_run_queue.h"
+#include "core/session/dynamic_batcher.h"
+#include "core/session/graph_capture_shape_buckets.h"
+#include "core/session/input_recorder.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -333,7 +343,9 @@ class InferenceSession {
   [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
                                    gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches,
-                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr);
+                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators =
+                                       nullptr);
 
   [[nodiscard]] common::Status Run(const RunOptions& run_options,
                                    gsl::span<const char* const> feed_names,
@@ -341,6 +353,19 @@ class InferenceSession {
                                    gsl::span<const char* const> fetch_names,
                                    gsl::span<OrtValue*> fetches);
 
+  /**
+   * Resolve the feed and fetch names of repeated runs once.
+   * The returned manager is passed to Run(const RunOptions&, FeedsFetchesManager&, ...) in place of the names.
+   * The shapes and types of the feeds are still validated on each run.
+   * @param feeds_fetches_manager Created manager. It must not be used by concurrent runs.
+   */
+  [[nodiscard]] common::Status PrepareRun(gsl::span<const std::string> feed_names,
+                                          gsl::span<const std::string> output_names,
+                                          std::unique_ptr<FeedsFetchesManager>& feeds_fetches_manager) const;
+
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                   gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches);
+
   [[nodiscard]] common::Status RunAsync(const RunOptions* run_options,
                                         gsl::span<const char* const> feed_names,
                                         gsl::span<const OrtValue* const> feeds,
@@ -381,6 +406,18 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Run the model on zero filled inputs before serving, so that the arenas, memory patterns, lazily packed weights,
+   * kernel algorithm searches and tuning, and the pages of mapped initializers are ready for the first real run.
+   * @param input_shapes Shapes of the inputs. The inputs not listed use the shapes of the model, where the free
+   *        dimensions must be set with SessionOptions::free_dimension_overrides.
+   * @param num_runs Number of runs. Graph capture needs more than one run before the graph is replayed.
+   * @param run_durations_us Duration of each run in microseconds.
+   */
+  [[nodiscard]] common::Status WarmUp(const RunOptions& run_options,
+                                      const InlinedHashMap<std::string, TensorShapeVector>& input_shapes,
+                                      size_t num_runs, std::vector<int64_t>& run_durations_us);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -492,6 +529,35 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+    * Set the callback the profiles of the runs sampled by the sampled profiling mode
+    * (kOrtSessionOptionsConfigProfilingSampleEveryNRuns, kOrtSessionOptionsConfigProfilingSampleLatencyThresholdMs)
+    * are handed to. It is called on the thread of the run, before the run returns.
+    */
+  void SetProfilingSampleCallback(profiling::Profiler::SampleCallback callback);
+
+  /**
+    * Get the metrics recorded since the session was initialized (kOrtSessionOptionsConfigEnableMetrics) as json:
+    * latency histograms per node and per op type, allocator statistics and thread pool queue depths.
+    * Not supported in a minimal build.
+    @param[out] metrics_json the metrics.
+    */
+  common::Status GetMetrics(std::string& metrics_json) const;
+
+  /**
+    * Replace the values of initializers of the initialized session, e.g. to swap in fine-tuned weights.
+    * The new values are copied into new buffers of the initializers and kernels that pre-packed an initializer
+    * pre-pack the new value. The optimized graph and the kernel instances are kept.
+    * Initializers that graph optimizations folded into other values can't be updated. Constant folding and
+    * sharing skip the initializers listed in kOrtSessionOptionsConfigUpdatableInitializers.
+    * Waits for the runs in progress to complete, and the runs that start meanwhile wait for the update.
+    * Not supported by a session that shares its session state with clones, see Clone().
+    @param names initializer names.
+    @param values new values, with the type and shape of the current values.
+    */
+  [[nodiscard]] common::Status UpdateInitializers(gsl::span<const std::string> names,
+                                                  gsl::span<const OrtValue> values);
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -535,6 +601,21 @@ class InferenceSession {
     return *session_state_;
   }
 
+  /**
+   * Create a session that runs the model of this initialized session without loading, optimizing, partitioning or
+   * initializing it again. The clone shares the graph, the execution providers and the session state (the kernels,
+   * the execution plans, the initializers and the pre-packed weights) with this session, and has its own thread
+   * pools and run state, e.g. to run on another NUMA node. This session must outlive its clones.
+   * @param session_options The options of the clone. They set its thread pools, the logger of its runs and the
+   *        configs of its runs. The options that the session state depends on, such as the graph optimization level,
+   *        are those of this session, and the messages of the session state go to the logger of this session.
+   *        Profiling is not supported, as the kernels record their events to the profiler of this session.
+   * @param clone Set to the new session.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Clone(const SessionOptions& session_options,
+                                     std::unique_ptr<InferenceSession>& clone) const;
+
   /**
    * Add a PrepackedWeightsContainer instance to the session so as to store the pre-packed weights
    *  of shared initializers to be shared across sessions.
@@ -629,6 +710,37 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const std::filesystem::path& filepath) const;
+
+  /**
+   * Get the path of the optimized model cache entry of this session.
+   * @param have_cpu_ep Whether the CPU EP was registered explicitly. It is added when it was not.
+   * @param cache_path Set to the cache entry, or to an empty path if the cache is disabled or can not be used.
+   */
+  common::Status GetOptimizedModelCachePath(bool have_cpu_ep, std::filesystem::path& cache_path) const;
+
+  /**
+   * Replace the loaded ONNX model with the ORT format model of a cache entry. The ONNX model is kept if the
+   * entry can not be loaded.
+   */
+  void LoadOptimizedModelFromCache(const std::filesystem::path& cache_path);
+
+  // Save the optimized model to a cache entry. The entry is written to a temporary file first and then renamed, so
+  // concurrent sessions never read a partial entry.
+  common::Status SaveOptimizedModelToCache(const std::filesystem::path& cache_path) const;
+
+  /**
+   * Get the path of the tuning results cache entry of an execution provider.
+   * @param tuning_results The current TuningResults of the execution provider, its validators are the key of the entry.
+   * @return The entry, or an empty path if the cache is disabled.
+   */
+  std::filesystem::path GetTuningResultsCachePath(const TuningResults& tuning_results) const;
+
+  // Load the tuning results cache entries of the execution providers that support TunableOp. Entries that can not be
+  // loaded are ignored.
+  void LoadTuningResultsFromCache();
+
+  // Save the TuningResults of the execution providers that support TunableOp to their tuning results cache entries.
+  void SaveTuningResultsToCache() const;
 #endif
 
   /**
@@ -650,6 +762,9 @@ class InferenceSession {
 
   [[nodiscard]] common::Status LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes);
 
+  // Create the model from ort_format_model_bytes_.
+  [[nodiscard]] common::Status LoadOrtModelFromBytes();
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -662,12 +777,24 @@ class InferenceSession {
 
   void TraceSessionOptions(const SessionOptions& session_options, bool captureState);
 
+  // Set up what the runs of the session need from the run related configs of the session options, once the session
+  // state exists.
+  [[nodiscard]] common::Status InitializeRunState();
+
   [[nodiscard]] common::Status CheckShapes(const std::string& input_name, const TensorShape& input_shape,
                                            const TensorShape& expected_shape, const char* input_output_moniker) const;
 
   [[nodiscard]] common::Status ValidateInputs(gsl::span<const std::string> feed_names,
                                               gsl::span<const OrtValue> feeds) const;
 
+  // Run with the names resolved in `prepared_feeds_fetches_manager`, or resolved for this call if it is nullptr.
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators,
+                                       FeedsFetchesManager* prepared_feeds_fetches_manager);
+
   [[nodiscard]] common::Status ValidateOutputs(gsl::span<const std::string> output_names,
                                                const std::vector<OrtValue>* p_fetches) const;
 
@@ -737,9 +864,47 @@ class InferenceSession {
   MemoryProfiler memory_profiler_;
 #endif
 
-  // Immutable state for each op in the model. Shared by all executors.
+  // Immutable state for each op in the model. Shared by all executors, and by the clones of the session.
   // It has a dependency on execution_providers_.
-  std::unique_ptr<SessionState> session_state_;
+  std::shared_ptr<SessionState> session_state_;
+
+  // Whether the session was created by Clone() and shares the session state of another session.
+  bool is_clone_ = false;
+
+  // Initializes lazily initialized subgraphs in the background (kOrtSessionOptionsConfigLazySubgraphWarmUp).
+  // Stopped and joined before anything it uses is destroyed.
+  std::thread lazy_subgraph_warm_up_thread_;
+  std::atomic<bool> stop_lazy_subgraph_warm_up_{false};
+
+  // Batches concurrent RunAsync calls (kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize).
+  // Destroyed before anything it uses.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
+  // Runs inputs of varying shapes on captured graphs of bucketed shapes
+  // (kOrtSessionOptionsConfigGraphCaptureShapeBuckets). Destroyed before anything it uses.
+  std::unique_ptr<GraphCaptureShapeBuckets> graph_capture_shape_buckets_;
+
+  // Lets runs of lower priority (kOrtRunOptionsConfigRunPriority) yield to runs of higher priority.
+  RunPriorityGate run_priority_gate_;
+
+  // The limit of the degree of parallelism of the parallel loops of a run
+  // (kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism). 0 if there is none.
+  int intra_op_max_degree_of_parallelism_{0};
+
+  // Whether each run opens a parallel section of the intra-op thread pool for its kernels
+  // (kOrtSessionOptionsConfigParallelSectionPerRun).
+  bool parallel_section_per_run_{false};
+
+  // Limits the number of concurrent RunAsync calls (kOrtSessionOptionsConfigMaxConcurrentAsyncRuns).
+  std::unique_ptr<AsyncRunQueue> async_run_queue_;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Samples the inputs of runs as test data sets (kOrtSessionOptionsRecordInputsDirectory).
+  std::unique_ptr<InputRecorder> input_recorder_;
+#endif
+
+  // Node latencies recorded by the session states (kOrtSessionOptionsConfigEnableMetrics).
+  std::unique_ptr<SessionMetrics> session_metrics_;
 
   // Threadpools per session. These are initialized and used for the entire duration of the session
   // when use_per_session_threads is true.
@@ -752,6 +917,9 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // NUMA node the session runs on (kOrtSessionOptionsConfigNumaNode), -1 if none.
+  int numa_node_ = -1;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
@@ -801,6 +969,10 @@ class InferenceSession {
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
   bool is_concurrent_run_supported_ = true;      // Graph execution in Run is GUARDED_BY(session_mutex_) if false
 
+  // Graph execution holds it shared and UpdateInitializers exclusively, as the initializers and the pre-packed
+  // weights of the kernels are read during the whole execution.
+  mutable std::shared_mutex initializers_mutex_;
+
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
   InterOpDomains interop_domains_;
 #endif
@@ -857,6 +1029,10 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // The mapped model file when a session is started with a model_uri and the initializers use the model bytes
+  // directly ("session.use_ort_model_bytes_for_initializers"). ort_format_model_bytes_data_holder_ is empty then.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
   // Container to store pre-packed weights to share between sessions.
@@ -889,6 +1065,10 @@ class InferenceSession {
       return cached_execution_provider_for_graph_replay_ != nullptr && graph_annotation_id != kGraphAnnotationSkip;
     }
 
+    OrtDevice GetDefaultDevice() const {
+      return cached_execution_provider_for_graph_replay_->GetOrtDeviceByMemType(OrtMemTypeDefault);
+    }
+
     Status ReplayGraph(int graph_annotation_id) {
       if (cached_execution_provider_for_graph_replay_) {
         return cached_execution_provider_for_graph_replay_->ReplayGraph(graph_annotation_id);
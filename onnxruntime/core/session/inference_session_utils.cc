@@ -5,6 +5,11 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <atomic>
+#include <fstream>
+
+#include "core/platform/env.h"
+
 namespace onnxruntime {
 
 //---------------------
@@ -110,6 +115,11 @@ void from_json(const json& j, TuningResults& trs) {
   j.at("validators").get_to(trs.validators);
 }
 
+// This function is called by nlohmann/json
+void to_json(json& j, const TuningResults& trs) {
+  j = json{{"ep", trs.ep}, {"results", trs.results}, {"validators", trs.validators}};
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -264,6 +274,56 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+Status LoadTuningResultsFromFile(const std::filesystem::path& file_path, TuningResults& results) {
+  std::ifstream file(file_path);
+  ORT_RETURN_IF(!file, "Failed to open ", ToUTF8String(file_path.native()));
+
+  Status status;
+  ORT_TRY {
+    json::parse(file).get_to(results);
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results in ", ToUTF8String(file_path.native()),
+                               " cannot be parsed. Error message: ", e.what());
+    });
+  }
+  return status;
+}
+
+Status SaveTuningResultsToFile(const TuningResults& results, const std::filesystem::path& file_path) {
+  std::error_code error;
+  std::filesystem::create_directories(file_path.parent_path(), error);
+  ORT_RETURN_IF(error, "Failed to create the directory ", ToUTF8String(file_path.parent_path().native()), ": ",
+                error.message());
+
+  static std::atomic<uint64_t> num_saved{0};
+  std::filesystem::path temporary_path = file_path;
+  temporary_path += ToPathString(".tmp" + std::to_string(Env::Default().GetSelfPid()) + "_" +
+                                 std::to_string(num_saved++));
+  Status status;
+  {
+    std::ofstream file(temporary_path, std::ios::trunc);
+    file << json(results).dump();
+    file.close();
+    if (file.fail()) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", ToUTF8String(temporary_path.native()));
+    }
+  }
+  if (status.IsOK()) {
+    std::filesystem::rename(temporary_path, file_path, error);
+    if (error) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the tuning results to ",
+                               ToUTF8String(file_path.native()), ": ", error.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    std::filesystem::remove(temporary_path, error);
+  }
+  return status;
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
@@ -9,6 +9,8 @@
 //
 // Includes to parse json session config from onnx model file
 //
+#include <filesystem>
+
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 #include "core/framework/session_options.h"
@@ -62,6 +64,13 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ std::vector<TuningResults>& results,
                                            /*out*/ bool& key_found);
 
+// Read the TuningResults of an execution provider from a json file written by SaveTuningResultsToFile().
+Status LoadTuningResultsFromFile(const std::filesystem::path& file_path, /*out*/ TuningResults& results);
+
+// Write the TuningResults of an execution provider to a json file. The file is written to a temporary file first and
+// then renamed, so concurrent sessions never read a partial file.
+Status SaveTuningResultsToFile(const TuningResults& results, const std::filesystem::path& file_path);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
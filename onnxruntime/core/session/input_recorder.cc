@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/input_recorder.h"
+
+#include <fstream>
+
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+void InputRecorder::Record(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds) {
+  if (num_runs_.fetch_add(1, std::memory_order_relaxed) % every_n_runs_ != 0) {
+    return;
+  }
+
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor() || feed.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+      LOGS(logger_, VERBOSE) << "Inputs of a run are not recorded as they are not all CPU tensors.";
+      return;
+    }
+  }
+
+  const size_t sample = num_samples_.fetch_add(1, std::memory_order_relaxed);
+  if (sample >= max_samples_) {
+    return;
+  }
+
+  auto status = WriteTestDataSet(sample, feed_names, feeds);
+  if (!status.IsOK()) {
+    LOGS(logger_, WARNING) << "Failed to record the inputs of a run: " << status.ErrorMessage();
+  }
+}
+
+Status InputRecorder::WriteTestDataSet(size_t sample, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds) const {
+  const auto test_data_set = directory_ / ("test_data_set_" + std::to_string(sample));
+  std::error_code error;
+  std::filesystem::create_directories(test_data_set, error);
+  ORT_RETURN_IF(error, "Failed to create ", test_data_set.string(), ": ", error.message());
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    // the name of the tensor matches the input, whatever the order of the inputs of the model
+    const auto tensor_proto = utils::TensorToTensorProto(feeds[i].Get<Tensor>(), feed_names[i]);
+    const auto file_path = test_data_set / ("input_" + std::to_string(i) + ".pb");
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file.good() && tensor_proto.SerializeToOstream(&file), "Failed to write ", file_path.string());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
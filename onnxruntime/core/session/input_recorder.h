@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+/**
+ * Samples the inputs of runs into test data sets (<directory>/test_data_set_<n>/input_<i>.pb), the format
+ * onnxruntime_perf_test and onnx_test_runner load test data from (kOrtSessionOptionsRecordInputsDirectory).
+ *
+ * Thread-safe.
+ */
+class InputRecorder {
+ public:
+  InputRecorder(std::filesystem::path directory, size_t every_n_runs, size_t max_samples,
+                const logging::Logger& logger)
+      : directory_(std::move(directory)), every_n_runs_(every_n_runs), max_samples_(max_samples), logger_(logger) {}
+
+  // Counts a run and records its feeds if it is sampled. Errors are logged, the run does not fail.
+  void Record(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InputRecorder);
+
+  Status WriteTestDataSet(size_t sample, gsl::span<const std::string> feed_names,
+                          gsl::span<const OrtValue> feeds) const;
+
+  const std::filesystem::path directory_;
+  const size_t every_n_runs_;
+  const size_t max_samples_;
+  const logging::Logger& logger_;
+
+  std::atomic<size_t> num_runs_{0};
+  std::atomic<size_t> num_samples_{0};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/lora_adapters.h"
+
+#include <limits>
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace lora {
+
+Status LoraAdapter::Load(const std::filesystem::path& file_path) {
+  const Env& env = Env::Default();
+
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(file_path.c_str(), num_bytes));
+  ORT_RETURN_IF(num_bytes == 0 || num_bytes > static_cast<size_t>(std::numeric_limits<int>::max()),
+                "Invalid size of the adapter file ", file_path, ": ", num_bytes, " bytes");
+
+  Env::MappedMemoryPtr mapped_bytes;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(file_path.c_str(), 0, num_bytes, mapped_bytes));
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_RETURN_IF_NOT(model_proto.ParseFromArray(mapped_bytes.get(), static_cast<int>(num_bytes)),
+                    "Failed to parse the adapter file ", file_path);
+
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  const auto& initializers = model_proto.graph().initializer();
+  parameters_.reserve(initializers.size());
+  for (const auto& tensor_proto : initializers) {
+    OrtValue value;
+    ORT_RETURN_IF_ERROR(utils::TensorProtoToOrtValue(env, file_path, tensor_proto, cpu_allocator, value));
+    ORT_RETURN_IF_NOT(parameters_.emplace(tensor_proto.name(), std::move(value)).second,
+                      "Duplicate parameter ", tensor_proto.name(), " in the adapter file ", file_path);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace lora
+}  // namespace onnxruntime
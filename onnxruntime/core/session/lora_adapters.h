@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace lora {
+
+/**
+ * The parameters of a LoRA adapter, e.g. the low rank A and B matrices of each adapted MatMul, by name.
+ *
+ * In the runs it is active for (OrtRunOptions::active_lora_adapters) the parameters are fed to the model inputs of
+ * the same names that the caller didn't feed, so a model exported with the adapter weights as inputs serves any
+ * number of adapters over one copy of its base weights in one session.
+ *
+ * Immutable once loaded, so it can be active in concurrent runs of several sessions.
+ */
+class LoraAdapter {
+ public:
+  LoraAdapter() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LoraAdapter);
+
+  // Loads the parameters from an ONNX model file, whose initializers are the parameters. The file is mapped into
+  // memory to be parsed, and the parameters are in CPU memory.
+  Status Load(const std::filesystem::path& file_path);
+
+  const InlinedHashMap<std::string, OrtValue>& Parameters() const noexcept { return parameters_; }
+
+ private:
+  InlinedHashMap<std::string, OrtValue> parameters_;
+};
+
+}  // namespace lora
+}  // namespace onnxruntime
@@ -31,6 +31,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/lora_adapters.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
 #include "core/framework/data_types.h"
@@ -869,6 +870,194 @@ ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const
   API_IMPL_END
 }
 
+struct OrtPreparedRun {
+  const ::onnxruntime::InferenceSession* session_;
+  std::unique_ptr<::onnxruntime::FeedsFetchesManager> feeds_fetches_manager_;
+  // reused by every run so that only the values change between the runs
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_len) const char* const* output_names, size_t output_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> input_name_vec;
+  input_name_vec.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    input_name_vec.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_name_vec;
+  output_name_vec.reserve(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output_names[i] == nullptr || output_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_name_vec.emplace_back(output_names[i]);
+  }
+
+  auto prepared_run = std::make_unique<OrtPreparedRun>();
+  prepared_run->session_ = session;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->PrepareRun(input_name_vec, output_name_vec,
+                                                      prepared_run->feeds_fetches_manager_));
+  prepared_run->feeds_.reserve(input_len);
+  prepared_run->fetches_.reserve(output_len);
+
+  *out = prepared_run.release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run, _In_ const OrtValue* const* inputs,
+                    _Inout_ OrtValue** outputs) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  if (prepared_run->session_ != session) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "The OrtPreparedRun was created for another session.");
+  }
+
+  auto& feeds_fetches_manager = *prepared_run->feeds_fetches_manager_;
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  const size_t num_feeds = info.feed_names.size();
+  const size_t num_fetches = info.output_names.size();
+
+  auto& feeds = prepared_run->feeds_;
+  auto& fetches = prepared_run->fetches_;
+  // drop the values of this run whatever the outcome, the caller owns them
+  auto clear_values = gsl::finally([&feeds, &fetches]() {
+    feeds.clear();
+    fetches.clear();
+  });
+
+  for (size_t i = 0; i != num_feeds; ++i) {
+    if (inputs[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                   MakeString("NULL input supplied for input ", info.feed_names[i]).c_str());
+    }
+    feeds.emplace_back(*inputs[i]);
+  }
+
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (outputs[i] != nullptr) {
+      fetches.emplace_back(*outputs[i]);
+    } else {
+      fetches.emplace_back();
+    }
+  }
+
+  Status status;
+  if (run_options) {
+    status = session->Run(*run_options, feeds_fetches_manager, feeds, &fetches);
+  } else {
+    const RunOptions default_run_options;
+    status = session->Run(default_run_options, feeds_fetches_manager, feeds, &fetches);
+  }
+  ORT_API_RETURN_IF_STATUS_NOT_OK(status);
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (outputs[i] == nullptr) {
+      fetch_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetches[i]));
+    } else {
+      fetch_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (outputs[i] == nullptr) {
+      outputs[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run) {
+  delete prepared_run;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::WarmUpSession, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const int64_t* const* input_shapes,
+                    _In_reads_(input_len) const size_t* input_shape_lens, size_t input_len, size_t num_runs,
+                    _Out_writes_opt_(num_runs) int64_t* run_durations_us) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  InlinedHashMap<std::string, TensorShapeVector> shapes;
+  shapes.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    shapes[input_names[i]] = TensorShapeVector(input_shapes[i], input_shapes[i] + input_shape_lens[i]);
+  }
+
+  std::vector<int64_t> durations;
+  if (run_options) {
+    ORT_API_RETURN_IF_STATUS_NOT_OK(session->WarmUp(*run_options, shapes, num_runs, durations));
+  } else {
+    const RunOptions default_run_options;
+    ORT_API_RETURN_IF_STATUS_NOT_OK(session->WarmUp(default_run_options, shapes, num_runs, durations));
+  }
+
+  if (run_durations_us != nullptr) {
+    std::copy(durations.begin(), durations.end(), run_durations_us);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionSetProfilingSampleCallback, _Inout_ OrtSession* sess,
+                    _In_opt_ OrtProfilingSampleCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  if (callback == nullptr) {
+    session->SetProfilingSampleCallback(nullptr);
+  } else {
+    session->SetProfilingSampleCallback([callback, user_data](const std::string& trace_json, int64_t run_duration_us) {
+      callback(user_data, trace_json.c_str(), trace_json.size(), run_duration_us);
+    });
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateLoraAdapter, _In_ const ORTCHAR_T* adapter_file_path,
+                    _Outptr_ OrtLoraAdapter** out) {
+  API_IMPL_BEGIN
+  auto adapter = std::make_unique<::onnxruntime::lora::LoraAdapter>();
+  ORT_API_RETURN_IF_STATUS_NOT_OK(adapter->Load(adapter_file_path));
+  *out = reinterpret_cast<OrtLoraAdapter*>(adapter.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleaseLoraAdapter, _Frees_ptr_opt_ OrtLoraAdapter* adapter) {
+  delete reinterpret_cast<::onnxruntime::lora::LoraAdapter*>(adapter);
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsAddActiveLoraAdapter, _Inout_ OrtRunOptions* options,
+                    _In_ const OrtLoraAdapter* adapter) {
+  API_IMPL_BEGIN
+  if (adapter == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "adapter is nullptr");
+  }
+  options->active_lora_adapters.push_back(reinterpret_cast<const ::onnxruntime::lora::LoraAdapter*>(adapter));
+  return nullptr;
+  API_IMPL_END
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -941,6 +1130,48 @@ ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_p
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToAllocator, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ OrtOutputAllocatorFn allocator_fn, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (allocator_fn == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "allocator_fn must not be null");
+  }
+
+  auto allocator = [allocator_fn, user_data](const TensorShape& shape, MLDataType element_type,
+                                             const OrtMemoryInfo& location, OrtValue& value) -> Status {
+    OrtValue* output = nullptr;
+    const auto dims = shape.GetDims();
+    const std::unique_ptr<OrtStatus, decltype(&OrtApis::ReleaseStatus)> status(
+        allocator_fn(user_data, dims.data(), dims.size(), MLDataTypeToOnnxRuntimeTensorElementDataType(element_type),
+                     &location, &output),
+        OrtApis::ReleaseStatus);
+    ORT_RETURN_IF_ERROR(ToStatus(status.get()));
+    if (output != nullptr) {
+      std::unique_ptr<OrtValue> owned_output(output);
+      value = std::move(*owned_output);
+    }
+    return Status::OK();
+  };
+
+  auto st = binding_ptr->binding_->BindOutput(name, std::move(allocator));
+  if (!st.IsOK()) {
+    return ToOrtStatus(st);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                    _In_ const char* output_name) {
+  API_IMPL_BEGIN
+  auto st = binding_ptr->binding_->BindState(input_name, output_name);
+  if (!st.IsOK()) {
+    return ToOrtStatus(st);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputNames, _In_ const OrtIoBinding* binding_ptr, _In_ OrtAllocator* allocator,
                     _Out_ char** buffer, _Outptr_result_maybenull_ size_t** lengths, _Out_ size_t* count) {
   API_IMPL_BEGIN
@@ -1363,6 +1594,38 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string metrics_json;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetMetrics(metrics_json));
+  *out = StrDup(metrics_json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::UpdateSessionInitializers, _Inout_ OrtSession* sess,
+                    _In_reads_(num_initializers) const char* const* initializer_names,
+                    _In_reads_(num_initializers) const OrtValue* const* initializers, size_t num_initializers) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  InlinedVector<std::string> names;
+  InlinedVector<OrtValue> values;
+  names.reserve(num_initializers);
+  values.reserve(num_initializers);
+  for (size_t i = 0; i < num_initializers; ++i) {
+    if (initializer_names[i] == nullptr || initializers[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "initializer names and values must not be null");
+    }
+    names.emplace_back(initializer_names[i]);
+    values.push_back(*initializers[i]);
+  }
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->UpdateInitializers(names, values));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2229,6 +2492,12 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_bytes") == 0) {
+      cfg->thread_cache_max_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "arena_type") == 0) {
+      cfg->arena_type = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "huge_page_mode") == 0) {
+      cfg->huge_page_mode = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2730,6 +2999,20 @@ static constexpr OrtApi ort_api_1_to_20 = {
     &OrtApis::KernelInfoGetAllocator,
     &OrtApis::AddExternalInitializersFromFilesInMemory,
     // End of Version 18 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::SessionGetMetrics,
+    &OrtApis::BindOutputToAllocator,
+    &OrtApis::UpdateSessionInitializers,
+    &OrtApis::BindState,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::WarmUpSession,
+    &OrtApis::SessionSetProfilingSampleCallback,
+    &OrtApis::CreateLoraAdapter,
+    &OrtApis::ReleaseLoraAdapter,
+    &OrtApis::RunOptionsAddActiveLoraAdapter,
+    &OrtApis::SharedPrePackedWeightCache_StoreWeightData,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
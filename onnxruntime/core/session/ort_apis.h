@@ -523,4 +523,44 @@ ORT_API_STATUS_IMPL(SessionOptionsAppendExecutionProvider_VitisAI, _In_ OrtSessi
 ORT_API_STATUS_IMPL(KernelContext_GetScratchBuffer, _In_ const OrtKernelContext* context, _In_ const OrtMemoryInfo* mem_info, _In_ size_t count_or_bytes, _Outptr_ void** out);
 
 ORT_API_STATUS_IMPL(KernelInfoGetAllocator, _In_ const OrtKernelInfo* info, _In_ OrtMemType mem_type, _Outptr_ OrtAllocator** out);
+
+ORT_API_STATUS_IMPL(SessionGetMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(BindOutputToAllocator, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ OrtOutputAllocatorFn allocator_fn, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(UpdateSessionInitializers, _Inout_ OrtSession* sess,
+                    _In_reads_(num_initializers) const char* const* initializer_names,
+                    _In_reads_(num_initializers) const OrtValue* const* initializers, size_t num_initializers);
+
+ORT_API_STATUS_IMPL(BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                    _In_ const char* output_name);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* session,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_len) const char* const* output_names, size_t output_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run, _In_ const OrtValue* const* inputs,
+                    _Inout_ OrtValue** outputs);
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run);
+
+ORT_API_STATUS_IMPL(WarmUpSession, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const int64_t* const* input_shapes,
+                    _In_reads_(input_len) const size_t* input_shape_lens, size_t input_len, size_t num_runs,
+                    _Out_writes_opt_(num_runs) int64_t* run_durations_us);
+
+ORT_API_STATUS_IMPL(SessionSetProfilingSampleCallback, _Inout_ OrtSession* session,
+                    _In_opt_ OrtProfilingSampleCallbackFn callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(CreateLoraAdapter, _In_ const ORTCHAR_T* adapter_file_path, _Outptr_ OrtLoraAdapter** out);
+ORT_API(void, ReleaseLoraAdapter, _Frees_ptr_opt_ OrtLoraAdapter* adapter);
+ORT_API_STATUS_IMPL(RunOptionsAddActiveLoraAdapter, _Inout_ OrtRunOptions* options,
+                    _In_ const OrtLoraAdapter* adapter);
+
+ORT_API_STATUS_IMPL(SharedPrePackedWeightCache_StoreWeightData,
+                    _Inout_ OrtSharedPrePackedWeightCache* prepacked_weight_cache,
+                    _In_reads_(num_buffers) void** buffer_data_ptrs,
+                    _In_reads_(num_buffers) const size_t* buffer_data_sizes, _In_ size_t num_buffers);
 }  // namespace OrtApis
@@ -11,7 +11,9 @@
 #include "core/session/allocator_adapters.h"
 #include "core/session/user_logging_sink.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/framework/provider_shutdown.h"
+#include "core/platform/env_var_utils.h"
 #include "core/platform/logging/make_platform_default_log_sink.h"
 
 using namespace onnxruntime;
@@ -21,6 +23,12 @@ std::unique_ptr<OrtEnv> OrtEnv::p_instance_;
 int OrtEnv::ref_count_ = 0;
 onnxruntime::OrtMutex OrtEnv::m_;
 
+namespace {
+// Set to 1 to send the log messages to the sink on a background thread, so the threads that log don't wait for the
+// messages to be written. See AsyncSink.
+constexpr const char* kAsyncLoggingEnvVar = "ORT_ASYNC_LOGGING";
+}  // namespace
+
 OrtEnv::OrtEnv(std::unique_ptr<onnxruntime::Environment> value1)
     : value_(std::move(value1)) {
 }
@@ -47,6 +55,9 @@ OrtEnv* OrtEnv::GetInstance(const OrtEnv::LoggingManagerConstructionInfo& lm_inf
     } else {
       sink = MakePlatformDefaultLogSink();
     }
+    if (ParseEnvironmentVariableWithDefault<bool>(kAsyncLoggingEnvVar, false)) {
+      sink = std::make_unique<AsyncSink>(std::move(sink));
+    }
     auto etwOverrideSeverity = logging::OverrideLevelWithEtw(static_cast<Severity>(lm_info.default_warning_level));
     sink = EnhanceSinkWithEtw(std::move(sink), static_cast<Severity>(lm_info.default_warning_level),
                               etwOverrideSeverity);
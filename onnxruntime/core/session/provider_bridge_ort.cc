@@ -48,9 +48,7 @@
 #include "orttraining/core/framework/torch/refcount_tracker.h"
 #endif
 #endif
-#ifdef ENABLE_NVTX_PROFILE
 #include "core/providers/cuda/nvtx_profile.h"
-#endif
 #if defined(ORT_USE_NCCL) && defined(ENABLE_TRAINING)
 #include "orttraining/training_ops/cuda/communication/nccl_service.h"
 #include "orttraining/core/framework/distributed_run_context.h"
@@ -2101,8 +2099,86 @@ void cudaMemcpy_HostToDevice(void* dst, const void* src, size_t count) {
   ORT_THROW("cudaMemcpy_HostToDevice is not implemented.");
 }
 
-#ifdef ENABLE_NVTX_PROFILE
 namespace profile {
+namespace {
+// the CUDA provider while the ranges are enabled, which makes the NVTX calls of the framework
+std::atomic<ProviderInfo_CUDA*> nvtx_provider{nullptr};
+std::atomic<uint64_t> last_nvtx_correlation_id{0};
+thread_local uint64_t current_nvtx_correlation_id = 0;
+}  // namespace
+
+bool IsNvtxRangesEnabled() {
+  return nvtx_provider.load(std::memory_order_relaxed) != nullptr;
+}
+
+bool EnableNvtxRanges(bool enable) {
+  if (!enable) {
+    if (auto* info = nvtx_provider.exchange(nullptr)) {
+      info->Nvtx__EnableRanges(false);
+    }
+    return true;
+  }
+
+  auto* info = TryGetProviderInfo_CUDA();
+  if (info == nullptr) {
+    return false;
+  }
+  info->Nvtx__EnableRanges(true);
+  nvtx_provider = info;
+  return true;
+}
+
+void NvtxPushRange(const char* message, Color color, uint64_t payload) {
+  if (auto* info = nvtx_provider.load(std::memory_order_relaxed)) {
+    info->Nvtx__PushRange(message, static_cast<uint32_t>(color), payload);
+  }
+}
+
+void NvtxPopRange() {
+  if (auto* info = nvtx_provider.load(std::memory_order_relaxed)) {
+    info->Nvtx__PopRange();
+  }
+}
+
+uint64_t NvtxStartRange(const char* message, Color color, uint64_t payload) {
+  if (auto* info = nvtx_provider.load(std::memory_order_relaxed)) {
+    return info->Nvtx__StartRange(message, static_cast<uint32_t>(color), payload);
+  }
+  return 0;
+}
+
+void NvtxEndRange(uint64_t range_id) {
+  if (auto* info = nvtx_provider.load(std::memory_order_relaxed)) {
+    info->Nvtx__EndRange(range_id);
+  }
+}
+
+void NvtxMark(const char* message, Color color) {
+  if (auto* info = nvtx_provider.load(std::memory_order_relaxed)) {
+    info->Nvtx__Mark(message, static_cast<uint32_t>(color));
+  }
+}
+
+uint64_t CurrentNvtxCorrelationId() {
+  return current_nvtx_correlation_id;
+}
+
+NvtxRunScope::NvtxRunScope(const std::string& name) : parent_correlation_id_(current_nvtx_correlation_id) {
+  if (IsNvtxRangesEnabled()) {
+    correlation_id_ = ++last_nvtx_correlation_id;
+    NvtxPushRange(name.empty() ? "Run" : ("Run " + name).c_str(), Color::White, correlation_id_);
+  }
+  current_nvtx_correlation_id = correlation_id_;
+}
+
+NvtxRunScope::~NvtxRunScope() {
+  if (correlation_id_ != 0) {
+    NvtxPopRange();
+  }
+  current_nvtx_correlation_id = parent_correlation_id_;
+}
+
+#ifdef ENABLE_NVTX_PROFILE
 void NvtxRangeCreator::BeginImpl() {
   GetProviderInfo_CUDA().NvtxRangeCreator__BeginImpl(this);
 }
@@ -2110,8 +2186,8 @@ void NvtxRangeCreator::BeginImpl() {
 void NvtxRangeCreator::EndImpl() {
   GetProviderInfo_CUDA().NvtxRangeCreator__EndImpl(this);
 }
-}  // namespace profile
 #endif
+}  // namespace profile
 
 #if defined(USE_CUDA) && defined(ORT_USE_NCCL) && defined(USE_NCCL_P2P) && defined(ENABLE_TRAINING)
 namespace cuda {
@@ -763,28 +763,29 @@ void Col2im<float, CPUMathUtil, StorageOrder::NCHW>(const float* data_col, int64
   auto* dst_end = data_im + hwc;
   // Begin of src channel data
   for (auto* dst = data_im; dst < dst_end; dst += hw) {
-    // Current kernel element starting vertical offset in dst data
-    int64_t h_offset = -pad_t * width;
-    int64_t h_offset_end = h_offset + kernel_h * dilation_h * width;
-    for (; h_offset < h_offset_end; h_offset += dilation_h * width) {
-      // Current kernel element starting horizontal offset in dst data
-      int64_t w_offset = -pad_l;
-      int64_t w_offset_end = w_offset + kernel_w * dilation_w;
-      for (; w_offset < w_offset_end; w_offset += dilation_w) {
-        // End of src channel data
-        auto* src_ce = src + output_hw;
-        // Dst row offset
-        for (int64_t h = h_offset; src < src_ce; h += stride_h * width) {
-          // End of src row data
-          auto* src_we = src + output_w;
-          if (is_a_ge_zero_and_a_lt_b(h, hw)) {
-            for (int64_t w = w_offset; src < src_we; src++, w += stride_w) {
-              if (is_a_ge_zero_and_a_lt_b(w, width)) {
-                dst[h + w] += *src;
-              }
+    for (int64_t kh = 0; kh < kernel_h; ++kh) {
+      // Current kernel element starting vertical offset in dst data
+      const int64_t h_offset = kh * dilation_h - pad_t;
+      for (int64_t kw = 0; kw < kernel_w; ++kw) {
+        // Current kernel element starting horizontal offset in dst data
+        const int64_t w_offset = kw * dilation_w - pad_l;
+        // The src columns [ow_begin, ow_end) land in the dst row, the others in the padding
+        const int64_t ow_begin = w_offset < 0 ? std::min(output_w, (stride_w - 1 - w_offset) / stride_w) : 0;
+        const int64_t ow_end = std::max(ow_begin, std::min(output_w, (width - w_offset + stride_w - 1) / stride_w));
+        for (int64_t oh = 0; oh < output_h; ++oh, src += output_w) {
+          const int64_t h = h_offset + oh * stride_h;
+          if (!is_a_ge_zero_and_a_lt_b(h, height)) {
+            continue;
+          }
+          float* dst_row = dst + h * width;
+          if (stride_w == 1) {
+            for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+              dst_row[w_offset + ow] += src[ow];
             }
           } else {
-            src = src_we;
+            for (int64_t ow = ow_begin; ow < ow_end; ++ow) {
+              dst_row[w_offset + ow * stride_w] += src[ow];
+            }
           }
         }
       }
@@ -25,6 +25,10 @@ struct OrtThreadPoolParams {
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
 
+  // If it is true, thread pool will size the blocks of a loop from the cost per iteration measured in earlier runs
+  // of the same loop
+  bool adaptive_block_sizing_ = false;
+
   unsigned int stack_size = 0;
 
   // A utf-8 string of affinity settings, format be like:
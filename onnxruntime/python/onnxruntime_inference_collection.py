@@ -204,7 +204,9 @@ class Session:
         Compute the predictions.
 
         :param output_names: name of the outputs
-        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param input_feed: dictionary ``{ input_name: input_value }``. Numpy arrays, objects exposing
+            ``__array_interface__`` and, in builds with DLPack support, objects exposing ``__dlpack__``
+            (torch, cupy, jax, ...) are used without a copy when they are contiguous.
         :param run_options: See :class:`onnxruntime.RunOptions`.
         :return: list of results, every result is either a numpy array,
             a sparse tensor, a list or a dictionary.
@@ -228,6 +230,27 @@ class Session:
                 return self._sess.run(output_names, input_feed, run_options)
             raise
 
+    def prepare_run(self, input_names, output_names=None):
+        """
+        Prepares runs of the session with fixed input and output names, for servers calling the same
+        session from many threads. The names are resolved once and the GIL is only held to convert the
+        inputs and the outputs.
+
+        :param input_names: names of the inputs, in the order their values are passed to ``run``
+        :param output_names: names of the outputs, all the outputs of the model if None
+        :return: an object whose ``run(inputs, run_options=None)`` method takes the list of input values
+            and returns the outputs as :meth:`run` does.
+
+        ::
+
+            prepared = sess.prepare_run([input_name], [output_name])
+            prepared.run([x])
+        """
+        self._validate_input(list(input_names))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.prepare_run(list(input_names), list(output_names))
+
     def run_async(self, output_names, input_feed, callback, user_data, run_options=None):
         """
         Compute the predictions asynchronously in a separate cxx thread from ort intra-op threadpool.
@@ -814,6 +837,21 @@ class OrtValue:
         """
         return self._ortvalue.numpy()
 
+    def __dlpack__(self, stream=None):
+        """
+        Returns a DLPack capsule over the memory of the tensor, without a copy (part of the ``__dlpack__``
+        protocol), e.g. ``torch.from_dlpack(ort_value)`` for the outputs of
+        :meth:`InferenceSession.run_with_ort_values`. The OrtValue memory stays alive until the consumer
+        releases it. Only available in builds with DLPack support.
+        """
+        return self._ortvalue.__dlpack__(stream)
+
+    def __dlpack_device__(self):
+        """
+        Returns a tuple of integers, (device, device index) (part of the ``__dlpack__`` protocol).
+        """
+        return self._ortvalue.__dlpack_device__()
+
     def update_inplace(self, np_arr):
         """
         Update the OrtValue in place with a new Numpy array. The numpy contents
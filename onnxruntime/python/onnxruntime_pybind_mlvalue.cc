@@ -992,6 +992,31 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
     // This should just increase the ref counts of the underlying shared_ptrs in the native OrtValue
     // and the ref count will be decreased when the OrtValue used for Run() is destroyed upon exit.
     *p_mlvalue = *value.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+#ifdef ENABLE_TRAINING
+  } else if (!accept_only_numpy_array && PyObject_HasAttrString(value.ptr(), "__dlpack__")) {
+    // A tensor of another framework (torch, cupy, jax, ...). Its memory is used in place through the DLPack
+    // protocol, and the OrtValue keeps it alive until it is released.
+    // DLPack has no boolean type before v0.8, so boolean inputs are exported as uint8 and need the model type.
+    bool is_bool_tensor = false;
+    if (input_def_list != nullptr) {
+      CheckIfInputIsSequenceType(name_input, input_def_list, type_proto);
+      is_bool_tensor = type_proto.has_tensor_type() &&
+                       type_proto.tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_BOOL;
+    }
+    py::object dlpack_tensor = value.attr("__dlpack__")();
+    *p_mlvalue = FromDlpack(dlpack_tensor.ptr(), is_bool_tensor);
+#endif
+  } else if (!accept_only_numpy_array && PyObject_HasAttrString(value.ptr(), "__array_interface__")) {
+    // An object exposing its memory through the numpy array interface. numpy creates a view on the memory, which is
+    // used in place when it is contiguous, instead of copying the object element by element as an iterable.
+    PyArrayObject* arr = reinterpret_cast<PyArrayObject*>(PyArray_FromAny(value.ptr(), nullptr, 0, 0, 0, nullptr));
+    if (!arr) {
+      throw std::runtime_error("Could not create tensor from the array interface of input " + name_input);
+    }
+
+    // The allocator owns the view, which keeps the object alive
+    auto pybind_alloc = std::make_shared<OrtPybindSingleUseAllocator>(arr, name_input, alloc->Info());
+    CreateTensorMLValueOwned(pybind_alloc, alloc, p_mlvalue);
   } else if (!accept_only_numpy_array) {
     auto iterator = PyObject_GetIter(value.ptr());
     if (iterator == NULL) {
@@ -62,6 +62,7 @@ namespace onnxruntime {
 
 #include <iterator>
 #include <algorithm>
+#include <mutex>
 
 namespace onnxruntime {
 namespace python {
@@ -1196,6 +1197,10 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
         if (flags_str.find("COREML_FLAG_CREATE_MLPROGRAM") != std::string::npos) {
           coreml_flags |= COREMLFlags::COREML_FLAG_CREATE_MLPROGRAM;
         }
+
+        if (flags_str.find("COREML_FLAG_ENABLE_MODEL_CACHE") != std::string::npos) {
+          coreml_flags |= COREMLFlags::COREML_FLAG_ENABLE_MODEL_CACHE;
+        }
       }
     }
 
@@ -1511,6 +1516,115 @@ void addGlobalMethods(py::module& m) {
 #endif
 }
 
+// Converts the outputs of a Run() to python objects. The GIL must be held.
+static py::list FetchesToPyList(const std::vector<OrtValue>& fetches) {
+  py::list result;
+  size_t pos = 0;
+  for (const auto& fet : fetches) {
+    if (fet.IsAllocated()) {
+      if (fet.IsTensor()) {
+        result.append(AddTensorAsPyObj(fet, nullptr, nullptr));
+      } else if (fet.IsSparseTensor()) {
+        result.append(GetPyObjectFromSparseTensor(pos, fet, nullptr));
+      } else {
+        result.append(AddNonTensorAsPyObj(fet, nullptr, nullptr));
+      }
+    } else {  // Send back None because the corresponding OrtValue was empty
+      result.append(py::none());
+    }
+    ++pos;
+  }
+  return result;
+}
+
+// Runs of a session with fixed input and output names, for servers that call run() from many python threads.
+// The names and the model input definitions are resolved once, the inputs are passed in the order of the names,
+// and the feed and fetch vectors of completed runs are reused by later ones. The GIL is held only to convert the
+// inputs on entry and the outputs on exit.
+class PyPreparedRun {
+ public:
+  PyPreparedRun(PyInferenceSession* sess, std::vector<std::string> input_names, std::vector<std::string> output_names)
+      : sess_(sess), input_names_(std::move(input_names)), output_names_(std::move(output_names)) {
+    auto inputs = sess_->GetSessionHandle()->GetModelInputs();
+    if (!inputs.first.IsOK() || !inputs.second) {
+      throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+    }
+    input_defs_ = inputs.second;
+  }
+
+  py::list Run(const py::sequence& inputs, const RunOptions* run_options) {
+    if (inputs.size() != input_names_.size()) {
+      throw std::runtime_error("Expected " + std::to_string(input_names_.size()) + " inputs, got " +
+                               std::to_string(inputs.size()));
+    }
+
+    // The buffers are released with the GIL held, as the feeds may own python objects.
+    std::unique_ptr<RunBuffers> buffers = AcquireBuffers();
+    auto& feeds = buffers->feeds;
+    auto& fetches = buffers->fetches;
+    feeds.resize(input_names_.size());
+    for (size_t i = 0; i < input_names_.size(); ++i) {
+      py::object value = inputs[i];
+      if (value.is_none()) {
+        throw std::runtime_error("Input " + input_names_[i] + " is None. Prepare the run without optional inputs "
+                                 "that are not fed.");
+      }
+      CreateGenericMLValue(input_defs_, GetAllocator(), input_names_[i], value, &feeds[i]);
+      ThrowIfPyErrOccured();
+    }
+
+    common::Status status;
+    {
+      // release GIL to allow multiple python threads to invoke Run() in parallel.
+      py::gil_scoped_release release;
+      const RunOptions default_run_options;
+      status = sess_->GetSessionHandle()->Run(run_options != nullptr ? *run_options : default_run_options,
+                                              input_names_, feeds, output_names_, &fetches);
+    }
+    OrtPybindThrowIfError(status);
+
+    py::list result = FetchesToPyList(fetches);
+    ReleaseBuffers(std::move(buffers));
+    return result;
+  }
+
+ private:
+  struct RunBuffers {
+    std::vector<OrtValue> feeds;
+    std::vector<OrtValue> fetches;
+  };
+
+  std::unique_ptr<RunBuffers> AcquireBuffers() {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    if (free_buffers_.empty()) {
+      auto buffers = std::make_unique<RunBuffers>();
+      buffers->feeds.reserve(input_names_.size());
+      buffers->fetches.reserve(output_names_.size());
+      return buffers;
+    }
+
+    auto buffers = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffers;
+  }
+
+  // The values are released, the capacity of the vectors is kept.
+  void ReleaseBuffers(std::unique_ptr<RunBuffers> buffers) {
+    buffers->feeds.clear();
+    buffers->fetches.clear();
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    free_buffers_.push_back(std::move(buffers));
+  }
+
+  PyInferenceSession* sess_;
+  const std::vector<std::string> input_names_;
+  const std::vector<std::string> output_names_;
+  const InputDefList* input_defs_ = nullptr;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<RunBuffers>> free_buffers_;
+};
+
 void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registration_fn) {
   py::enum_<GraphOptimizationLevel>(m, "GraphOptimizationLevel")
       .value("ORT_DISABLE_ALL", GraphOptimizationLevel::ORT_DISABLE_ALL)
@@ -1580,6 +1694,12 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_max_bytes") {
+            ort_arena_cfg->thread_cache_max_bytes = kvp.second.cast<int64_t>();
+          } else if (key == "arena_type") {
+            ort_arena_cfg->arena_type = kvp.second.cast<int>();
+          } else if (key == "huge_page_mode") {
+            ort_arena_cfg->huge_page_mode = kvp.second.cast<int>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1591,7 +1711,10 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_max_bytes", &OrtArenaCfg::thread_cache_max_bytes)
+      .def_readwrite("arena_type", &OrtArenaCfg::arena_type)
+      .def_readwrite("huge_page_mode", &OrtArenaCfg::huge_page_mode);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -1950,6 +2073,10 @@ including arg name, arg type (contains both type and shape).)pbdoc")
             }
             return arr; }, "node shape (assuming the node holds a tensor)");
 
+  py::class_<PyPreparedRun>(m, "PreparedRun", R"pbdoc(Runs of a session with fixed input and output names.)pbdoc")
+      .def("run", &PyPreparedRun::Run, py::arg("inputs"), py::arg("run_options") = nullptr,
+           R"pbdoc(Runs the session with the input values in the order of the prepared input names.)pbdoc");
+
   py::class_<SessionObjectInitializer> sessionObjectInitializer(m, "SessionObjectInitializer");
   py::class_<PyInferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       // In Python3, a Python bytes object will be passed to C++ functions that accept std::string or char*
@@ -2036,23 +2163,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
                }
              }
 
-             py::list result;
-             size_t pos = 0;
-             for (const auto& fet : fetches) {
-               if (fet.IsAllocated()) {
-                 if (fet.IsTensor()) {
-                   result.append(AddTensorAsPyObj(fet, nullptr, nullptr));
-                 } else if (fet.IsSparseTensor()) {
-                   result.append(GetPyObjectFromSparseTensor(pos, fet, nullptr));
-                 } else {
-                   result.append(AddNonTensorAsPyObj(fet, nullptr, nullptr));
-                 }
-               } else {  // Send back None because the corresponding OrtValue was empty
-                 result.append(py::none());
-               }
-               ++pos;
-             }
-             return result;
+             return FetchesToPyList(fetches);
            })
       .def("run_async",
            [](PyInferenceSession* sess,
@@ -2128,6 +2239,13 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         }
         return fetches;
       })
+      .def(
+          "prepare_run",
+          [](PyInferenceSession* sess, std::vector<std::string> input_names, std::vector<std::string> output_names) {
+            return std::make_unique<PyPreparedRun>(sess, std::move(input_names), std::move(output_names));
+          },
+          py::keep_alive<0, 1>(),
+          R"pbdoc(Returns a PreparedRun for the given input and output names.)pbdoc")
       .def("run_with_ortvaluevector", [](PyInferenceSession* sess, RunOptions run_options, const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds, const std::vector<std::string>& fetch_names, std::vector<OrtValue>& fetches, const std::vector<OrtDevice>& fetch_devices) -> void {
         // release GIL to allow multiple python threads to invoke Run() in parallel.
         py::gil_scoped_release release;
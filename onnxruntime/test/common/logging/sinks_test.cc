@@ -3,6 +3,7 @@
 
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -218,3 +219,37 @@ TEST(LoggingTests, TestGetRemoveSingleSink) {
   EXPECT_EQ(removed_sink.get(), single_mock_sink);  // Check it's the same sink
   EXPECT_FALSE(sink.HasOnlyOneSink());              // Should be empty now
 }
+
+/// <summary>
+/// Tests that the async sink sends all the messages to the wrapped sink, in order.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kWARNING;
+  constexpr int num_messages = 100;
+
+  std::vector<std::string> messages;
+  MockSink* sink_ptr = new MockSink();
+  EXPECT_CALL(*sink_ptr, SendImpl(testing::_, logid, testing::_))
+      .Times(num_messages)
+      .WillRepeatedly(testing::Invoke([&messages](const Timestamp&, const std::string&, const Capture& message) {
+        EXPECT_EQ(message.Severity(), Severity::kWARNING);
+        EXPECT_STREQ(message.Category(), "ArbitraryCategory");
+        messages.push_back(message.Message());
+      }));
+
+  AsyncSink* async_sink = new AsyncSink(std::unique_ptr<ISink>{sink_ptr});
+  LoggingManager manager{std::unique_ptr<ISink>{async_sink}, min_log_level, false, InstanceType::Temporal};
+  auto logger = manager.CreateLogger(logid);
+
+  for (int i = 0; i < num_messages; ++i) {
+    LOGS_CATEGORY(*logger, WARNING, "ArbitraryCategory") << "Warning " << i;
+  }
+
+  async_sink->Flush();
+  EXPECT_EQ(async_sink->DroppedMessageCount(), 0u);
+  ASSERT_EQ(messages.size(), static_cast<size_t>(num_messages));
+  for (int i = 0; i < num_messages; ++i) {
+    EXPECT_EQ(messages[i], "Warning " + std::to_string(i));
+  }
+}
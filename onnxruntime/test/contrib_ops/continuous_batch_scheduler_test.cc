@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "contrib_ops/cpu/transformers/continuous_batch_scheduler.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::ContinuousBatchScheduler;
+using contrib::transformers::FinishedRequest;
+using contrib::transformers::PagedKVCache;
+using contrib::transformers::PrefixKVCache;
+using contrib::transformers::ScheduledSequence;
+
+namespace {
+
+constexpr int kHeadSize = 2;
+constexpr int kBlockSize = 4;
+constexpr int kEosTokenId = 0;
+
+// A toy decoder: the key of a token is its id, and the next token is derived from the keys of every token in the
+// cache, so a sequence whose cache was lost or misplaced (for example across preemption) produces other tokens.
+int32_t RunToyModel(PagedKVCache<float>& cache, const ScheduledSequence& sequence) {
+  std::vector<float> key(kHeadSize);
+  for (size_t i = 0; i < sequence.input_ids.size(); i++) {
+    std::fill(key.begin(), key.end(), static_cast<float>(sequence.input_ids[i]));
+    cache.WriteToken(sequence.sequence_id, 0, sequence.first_position + static_cast<int>(i), key.data(), key.data());
+  }
+
+  const int length = cache.SequenceLength(sequence.sequence_id);
+  std::vector<float> keys(static_cast<size_t>(length) * kHeadSize);
+  std::vector<float> values(keys.size());
+  cache.GatherLayer(sequence.sequence_id, 0, length, keys.data(), values.data());
+  int64_t sum = 0;
+  for (int t = 0; t < length; t++) {
+    sum += static_cast<int64_t>(keys[t * kHeadSize]) * (t + 1);
+  }
+  return static_cast<int32_t>(sum % 97);
+}
+
+// Runs the requests to completion and returns the generated tokens per request id. A prefix cache is used when
+// max_cached_blocks is not negative.
+std::map<int64_t, std::vector<int32_t>> RunRequests(int num_blocks, int max_batch_size,
+                                                    const std::vector<std::vector<int32_t>>& prompts,
+                                                    int max_new_tokens, size_t* max_running = nullptr,
+                                                    int max_cached_blocks = -1, size_t* computed_tokens = nullptr) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, num_blocks);
+  std::unique_ptr<PrefixKVCache<float>> prefix_cache;
+  if (max_cached_blocks >= 0) {
+    prefix_cache = std::make_unique<PrefixKVCache<float>>(cache, max_cached_blocks);
+  }
+  ContinuousBatchScheduler<float> scheduler(cache, max_batch_size, kEosTokenId, prefix_cache.get());
+  for (size_t i = 0; i < prompts.size(); i++) {
+    scheduler.AddRequest(static_cast<int64_t>(i), prompts[i], max_new_tokens);
+  }
+
+  std::map<int64_t, std::vector<int32_t>> outputs;
+  std::vector<ScheduledSequence> batch;
+  std::vector<FinishedRequest> finished;
+  while (scheduler.HasPendingWork()) {
+    EXPECT_TRUE(scheduler.Schedule(batch).IsOK());
+    EXPECT_FALSE(batch.empty());
+    EXPECT_LE(batch.size(), static_cast<size_t>(max_batch_size));
+    if (max_running != nullptr) {
+      *max_running = std::max(*max_running, batch.size());
+    }
+
+    std::vector<int32_t> next_tokens;
+    for (const auto& sequence : batch) {
+      next_tokens.push_back(RunToyModel(cache, sequence));
+      if (computed_tokens != nullptr) {
+        *computed_tokens += sequence.input_ids.size();
+      }
+    }
+    finished.clear();
+    scheduler.CompleteStep(next_tokens, finished);
+    for (auto& request : finished) {
+      outputs[request.request_id] = std::move(request.output_ids);
+    }
+  }
+
+  if (prefix_cache != nullptr) {
+    prefix_cache->Clear();
+  }
+  EXPECT_EQ(cache.NumFreeBlocks(), num_blocks);
+  return outputs;
+}
+
+const std::vector<std::vector<int32_t>> kPrompts = {
+    {5, 8, 13}, {21, 34, 55, 89, 1, 2, 3}, {4}, {7, 7, 7, 7, 7}, {11, 12, 13, 14, 15, 16, 17, 18, 19}, {42, 43}};
+
+}  // namespace
+
+TEST(ContinuousBatchSchedulerTest, RequestsJoinAndLeaveBatch) {
+  // one request at a time is the reference
+  const auto expected = RunRequests(64, 1, kPrompts, 10);
+  ASSERT_EQ(expected.size(), kPrompts.size());
+
+  size_t max_running = 0;
+  EXPECT_EQ(RunRequests(64, 3, kPrompts, 10, &max_running), expected);
+  EXPECT_EQ(max_running, 3u);
+}
+
+TEST(ContinuousBatchSchedulerTest, PreemptsWhenCacheIsFull) {
+  const auto expected = RunRequests(64, 1, kPrompts, 12);
+
+  // the cache holds a few sequences at most, so running sequences are preempted and recomputed
+  EXPECT_EQ(RunRequests(7, 6, kPrompts, 12), expected);
+}
+
+TEST(ContinuousBatchSchedulerTest, ReusesCachedPromptPrefix) {
+  const std::vector<int32_t> system_prompt = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  std::vector<std::vector<int32_t>> prompts;
+  for (int32_t i = 1; i <= 6; i++) {
+    prompts.push_back(system_prompt);
+    prompts.back().insert(prompts.back().end(), static_cast<size_t>(i), 10 + i);
+  }
+
+  size_t computed_tokens = 0;
+  const auto expected = RunRequests(64, 1, prompts, 8, nullptr, -1, &computed_tokens);
+
+  // the two full blocks of the system prompt are computed once
+  size_t computed_with_cache = 0;
+  EXPECT_EQ(RunRequests(64, 1, prompts, 8, nullptr, 16, &computed_with_cache), expected);
+  EXPECT_EQ(computed_with_cache, computed_tokens - (prompts.size() - 1) * 2 * kBlockSize);
+
+  // cached blocks are evicted for running sequences and new requests when the cache is small
+  EXPECT_EQ(RunRequests(9, 3, prompts, 8, nullptr, 16), expected);
+}
+
+TEST(ContinuousBatchSchedulerTest, FinishesOnEndOfSequence) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, 8);
+  ContinuousBatchScheduler<float> scheduler(cache, 4, kEosTokenId);
+  scheduler.AddRequest(1, std::vector<int32_t>{3, 4}, 100);
+  scheduler.AddRequest(2, std::vector<int32_t>{5}, 100);
+
+  std::vector<ScheduledSequence> batch;
+  std::vector<FinishedRequest> finished;
+  ASSERT_TRUE(scheduler.Schedule(batch).IsOK());
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[0].first_position, 0);
+  EXPECT_EQ(batch[0].input_ids.size(), 2u);
+
+  scheduler.CompleteStep(std::vector<int32_t>{kEosTokenId, 9}, finished);
+  ASSERT_EQ(finished.size(), 1u);
+  EXPECT_EQ(finished[0].request_id, 1);
+  EXPECT_EQ(finished[0].output_ids, std::vector<int32_t>{kEosTokenId});
+  EXPECT_EQ(scheduler.NumRunning(), 1u);
+
+  // the remaining sequence decodes one token at its next position
+  ASSERT_TRUE(scheduler.Schedule(batch).IsOK());
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0].request_id, 2);
+  EXPECT_EQ(batch[0].first_position, 1);
+  ASSERT_EQ(batch[0].input_ids.size(), 1u);
+  EXPECT_EQ(batch[0].input_ids[0], 9);
+}
+
+TEST(ContinuousBatchSchedulerTest, RequestLargerThanCacheFails) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, 2);
+  ContinuousBatchScheduler<float> scheduler(cache, 4, kEosTokenId);
+  scheduler.AddRequest(1, std::vector<int32_t>(3 * kBlockSize, 1), 1);
+
+  std::vector<ScheduledSequence> batch;
+  EXPECT_FALSE(scheduler.Schedule(batch).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
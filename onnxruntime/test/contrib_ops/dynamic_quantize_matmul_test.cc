@@ -4,6 +4,7 @@
 #include "core/common/span_utils.h"
 #include "core/framework/tensor.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/framework/test_utils.h"
 #include "test/optimizer/graph_transform_test_builder.h"
@@ -87,17 +88,26 @@ void TestDynamicQuantizeMatMul(bool is_matrix_b_constant,
                                bool per_column = false,
                                bool has_zp = true,
                                bool has_bias = false,
-                               bool empty_input = false) {
+                               bool empty_input = false,
+                               int64_t num_rows = 4,
+                               bool block_scale = false) {
   // create rand inputs
   RandomValueGenerator random{1668426375};
 
-  int64_t M = empty_input ? 1 : 4;
+  int64_t M = empty_input ? 1 : num_rows;
   int64_t N = 128;
   int64_t K = 128;
   std::vector<int64_t> A_dims{empty_input ? 0 : M, K};
   std::vector<int64_t> B_dims{K, N};
   std::vector<int64_t> Y_dims{empty_input ? 0 : M, K};
   std::vector<float> A_data = random.Uniform<float>(A_dims, -1.0f, 1.0f);
+  if (block_scale) {
+    // every row spans the range of A, so every block of rows has the scale and zero point of the whole of A
+    for (int64_t m = 0; m < M; ++m) {
+      A_data[m * K] = -1.0f;
+      A_data[m * K + 1] = 1.0f;
+    }
+  }
   std::vector<T> B_data;
   std::vector<T> tmp_B_data = random.Uniform<T>(B_dims,
                                                 (std::is_same_v<T, int8_t>) ? std::numeric_limits<int8_t>::lowest() / 2 : std::numeric_limits<uint8_t>::lowest(),
@@ -141,6 +151,19 @@ void TestDynamicQuantizeMatMul(bool is_matrix_b_constant,
                                     per_column, has_zp, has_bias);
   test.AddOutput<float>("Y", Y_dims, Y_data);
   test.SetOutputRelErr("Y", 0.02f);
+
+  if (block_scale) {
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasDynamicQuantizeMatMulBlockScale, "1"));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+    return;
+  }
+
   test.Run();
 }
 
@@ -203,6 +226,16 @@ TEST(DynamicQuantizeMatMul, HasZeroPoint_HasBias_test_U8) {
   RunDynamicQuantizeMatMulTest<uint8_t, true, true>();
 }
 
+// enough rows to quantize and multiply A by blocks of rows
+TEST(DynamicQuantizeMatMul, RowBlocks) {
+  for (bool block_scale : {false, true}) {
+    for (bool per_column : {false, true}) {
+      TestDynamicQuantizeMatMul<uint8_t>(true, per_column, true, true, false, 300, block_scale);
+      TestDynamicQuantizeMatMul<int8_t>(false, per_column, true, false, false, 300, block_scale);
+    }
+  }
+}
+
 TEST(DynamicQuantizeMatMul, UInt8_test_with_empty_input) {
   std::vector<int64_t> A_dims{0, 2};
   std::vector<int64_t> B_dims{2, 2};
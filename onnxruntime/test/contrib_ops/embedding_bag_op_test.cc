@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(EmbeddingBagTest, Sum) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "sum");
+  test.AddInput<float>("data", {4, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f});
+  test.AddInput<int64_t>("indices", {2, 3}, {0, 2, 2, 3, -4, 1});
+  test.AddOutput<float>("output", {2, 2}, {11.0f, 14.0f, 11.0f, 14.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanNestedBags) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("data", {3, 1, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<int32_t>("indices", {2, 1, 2}, {0, 1, 2, 2});
+  test.AddOutput<float>("output", {2, 1, 1, 2}, {2.0f, 3.0f, 5.0f, 6.0f});
+  test.Run();
+}
+
+// Bags longer than the prefetch distance, with rows of a size that is copied with a constant size.
+TEST(EmbeddingBagTest, LongBags) {
+  constexpr int64_t num_rows = 50;
+  constexpr int64_t row_size = 16;
+  constexpr int64_t num_bags = 7;
+  constexpr int64_t bag_size = 20;
+  std::vector<float> data(num_rows * row_size);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<float>(i % 23) * 0.25f - 2.0f;
+  }
+  std::vector<int64_t> indices(num_bags * bag_size);
+  std::vector<float> output(num_bags * row_size, 0.0f);
+  for (int64_t b = 0; b < num_bags; b++) {
+    for (int64_t j = 0; j < bag_size; j++) {
+      const int64_t idx = (b * 31 + j * 17) % num_rows;
+      indices[b * bag_size + j] = idx;
+      for (int64_t k = 0; k < row_size; k++) {
+        output[b * row_size + k] += data[idx * row_size + k];
+      }
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {num_rows, row_size}, data);
+  test.AddInput<int64_t>("indices", {num_bags, bag_size}, indices);
+  test.AddOutput<float>("output", {num_bags, row_size}, output);
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 2});
+  test.AddOutput<float>("output", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
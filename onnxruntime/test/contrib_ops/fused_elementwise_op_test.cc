@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Relu(x + bias) * x with a bias that is broadcast over the rows.
+TEST(FusedElementwiseTest, BroadcastChain) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1, 3, 0});
+
+  test.AddInput<float>("x", {2, 3}, {-1.0f, 2.0f, 3.0f, 0.5f, -2.0f, 1.0f});
+  test.AddInput<float>("bias", {3}, {0.5f, -1.0f, 1.0f});
+  test.AddOutput<float>("Y", {2, 3}, {0.0f, 2.0f, 12.0f, 0.5f, 0.0f, 2.0f});
+  test.Run();
+}
+
+// x * Exp(scale) with a scale per row, so Exp is evaluated once per row over runs longer than a tile.
+TEST(FusedElementwiseTest, UniformInstruction) {
+  constexpr int64_t rows = 2;
+  constexpr int64_t columns = 1500;
+  std::vector<float> x(rows * columns);
+  std::vector<float> scale = {-0.5f, 0.25f};
+  std::vector<float> y(x.size());
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < columns; j++) {
+      x[i * columns + j] = static_cast<float>(j % 17) - 8.0f;
+      y[i * columns + j] = x[i * columns + j] * std::exp(scale[i]);
+    }
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Exp", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{1, -1, 0, 2});
+  test.AddInput<float>("x", {rows, columns}, x);
+  test.AddInput<float>("scale", {rows, 1}, scale);
+  test.AddOutput<float>("Y", {rows, columns}, y);
+  test.Run();
+}
+
+#ifdef USE_CUDA
+// x * Sigmoid(x * scale) in float16, with a scale per channel of a {N, C, H, W} input.
+TEST(FusedElementwiseTest, Float16BroadcastChain) {
+  const std::vector<int64_t> x_dims = {2, 3, 2, 2};
+  std::vector<float> x(24);
+  const std::vector<float> scale = {0.5f, -1.0f, 2.0f};
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<float>(i % 7) * 0.25f - 0.75f;
+    const float scaled = x[i] * scale[(i / 4) % 3];
+    y[i] = x[i] / (1.0f + std::exp(-scaled));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Mul", "Sigmoid", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1, 0, 3});
+  test.AddInput<MLFloat16>("x", x_dims, FloatsToMLFloat16s(x));
+  test.AddInput<MLFloat16>("scale", {3, 1, 1}, FloatsToMLFloat16s(scale));
+  test.AddOutput<MLFloat16>("Y", x_dims, FloatsToMLFloat16s(y));
+  test.SetOutputTolerance(0.005f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+#endif
+
+TEST(FusedElementwiseTest, InvalidOperand) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // the first instruction reads the result of the second one
+  test.AddAttribute("ops", std::vector<std::string>{"Neg", "Abs"});
+  test.AddAttribute("operands", std::vector<int64_t>{2, -1, 0, -1});
+  test.AddInput<float>("x", {2}, {1.0f, -1.0f});
+  test.AddOutput<float>("Y", {2}, {1.0f, 1.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid operand");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
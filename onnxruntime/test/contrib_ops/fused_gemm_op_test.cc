@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+float ReferenceActivation(const std::string& activation, float alpha, float beta, float x) {
+  if (activation == "Relu") {
+    return std::max(x, 0.0f);
+  } else if (activation == "LeakyRelu") {
+    return x >= 0.0f ? x : alpha * x;
+  } else if (activation == "Tanh") {
+    return std::tanh(x);
+  } else if (activation == "Sigmoid") {
+    return 1.0f / (1.0f + std::exp(-x));
+  } else if (activation == "HardSigmoid") {
+    return std::min(std::max(alpha * x + beta, 0.0f), 1.0f);
+  }
+  return x;
+}
+
+void RunFusedGemmTest(const std::string& activation, int64_t M, int64_t N, int64_t K, bool trans_b,
+                      const std::vector<int64_t>& c_dims, bool b_is_initializer) {
+  constexpr float alpha = 0.1f;
+  constexpr float beta = 0.4f;
+
+  std::vector<float> a(M * K), b(K * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.25f;
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.5f;
+  }
+
+  const int64_t c_size = c_dims.size() == 1 ? c_dims[0] : c_dims[0] * c_dims[1];
+  std::vector<float> c(c_size);
+  for (size_t i = 0; i < c.size(); i++) {
+    c[i] = static_cast<float>(static_cast<int>(i % 3) - 1) * 0.75f;
+  }
+
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * (trans_b ? b[n * K + k] : b[k * N + n]);
+      }
+      sum += c_size == N ? c[n] : c[m * N + n];
+      y[m * N + n] = ReferenceActivation(activation, alpha, beta, sum);
+    }
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", int64_t{0});
+  test.AddAttribute("transB", int64_t{trans_b ? 1 : 0});
+  test.AddAttribute("activation", activation);
+  if (activation == "LeakyRelu" || activation == "HardSigmoid") {
+    test.AddAttribute("activation_alpha", alpha);
+  }
+  if (activation == "HardSigmoid") {
+    test.AddAttribute("activation_beta", beta);
+  }
+
+  test.AddInput<float>("A", {M, K}, a);
+  test.AddInput<float>("B", trans_b ? std::vector<int64_t>{N, K} : std::vector<int64_t>{K, N}, b, b_is_initializer);
+  test.AddInput<float>("C", c_dims, c);
+  test.AddOutput<float>("Y", {M, N}, y);
+  test.SetOutputAbsErr("Y", 1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+// The activation and the per column bias are applied by the MLAS sgemm epilogue.
+TEST(FusedGemmOpTest, ActivationWithBias) {
+  for (const char* activation : {"Relu", "LeakyRelu", "Tanh", "Sigmoid", "HardSigmoid"}) {
+    for (bool b_is_initializer : {false, true}) {
+      RunFusedGemmTest(activation, 5, 19, 7, false, {19}, b_is_initializer);
+      RunFusedGemmTest(activation, 5, 19, 7, true, {1, 19}, b_is_initializer);
+      RunFusedGemmTest(activation, 3, 33, 40, false, {3, 33}, b_is_initializer);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
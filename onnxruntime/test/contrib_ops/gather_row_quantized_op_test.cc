@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <string>
+#include <vector>
+
+#include "core/framework/float16.h"
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Packs the quantized values of every row from the lowest bits up.
+std::vector<uint8_t> PackRows(const std::vector<int>& values, int64_t embedding_dim, int64_t bits) {
+  const int64_t num_rows = static_cast<int64_t>(values.size()) / embedding_dim;
+  const int64_t row_bytes = (embedding_dim * bits + 7) / 8;
+  const int64_t values_per_byte = 8 / bits;
+  std::vector<uint8_t> packed(num_rows * row_bytes, 0);
+  for (int64_t r = 0; r < num_rows; ++r) {
+    for (int64_t k = 0; k < embedding_dim; ++k) {
+      packed[r * row_bytes + k / values_per_byte] |=
+          static_cast<uint8_t>(values[r * embedding_dim + k] << ((k % values_per_byte) * bits));
+    }
+  }
+  return packed;
+}
+
+}  // namespace
+
+TEST(GatherRowQuantizedTest, Int8Rows) {
+  OpTester test("GatherRowQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("bits", 8);
+  test.AddAttribute<int64_t>("embedding_dim", 2);
+  test.AddInput<uint8_t>("data", {3, 2}, {0, 255, 10, 20, 4, 2});
+  test.AddInput<int64_t>("indices", {2, 2}, {2, 0, -2, 2});
+  test.AddInput<float>("scales", {3}, {0.5f, 1.0f, 2.0f});
+  test.AddInput<float>("biases", {3}, {0.0f, -1.0f, 1.0f});
+  test.AddOutput<float>("output", {2, 2, 2}, {9.0f, 5.0f, 0.0f, 127.5f, 9.0f, 19.0f, 9.0f, 5.0f});
+  test.Run();
+}
+
+TEST(GatherRowQuantizedTest, Int4SumWithHalfScales) {
+  constexpr int64_t embedding_dim = 3;
+  const std::vector<int> values = {1, 15, 7, 0, 3, 8, 12, 2, 5};
+  const std::vector<float> scales = {0.25f, 0.5f, 2.0f};
+  const std::vector<float> biases = {-1.0f, 0.5f, 0.0f};
+  const std::vector<int64_t> indices = {0, 2, 1, 1};
+  std::vector<float> output(2 * embedding_dim, 0.0f);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const int64_t r = indices[i];
+    for (int64_t k = 0; k < embedding_dim; ++k) {
+      output[(i / 2) * embedding_dim + k] += static_cast<float>(values[r * embedding_dim + k]) * scales[r] + biases[r];
+    }
+  }
+
+  OpTester test("GatherRowQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("bits", 4);
+  test.AddAttribute<int64_t>("embedding_dim", embedding_dim);
+  test.AddAttribute<std::string>("mode", "sum");
+  test.AddInput<uint8_t>("data", {3, 2}, PackRows(values, embedding_dim, 4));
+  test.AddInput<int64_t>("indices", {2, 2}, indices);
+  test.AddInput<MLFloat16>("scales", {3}, FloatsToMLFloat16s(scales));
+  test.AddInput<MLFloat16>("biases", {3}, FloatsToMLFloat16s(biases));
+  test.AddOutput<float>("output", {2, embedding_dim}, output);
+  test.Run();
+}
+
+// Bags longer than the prefetch distance.
+TEST(GatherRowQuantizedTest, Int2Mean) {
+  constexpr int64_t num_rows = 13;
+  constexpr int64_t embedding_dim = 5;
+  constexpr int64_t num_bags = 3;
+  constexpr int64_t bag_size = 11;
+  std::vector<int> values(num_rows * embedding_dim);
+  std::vector<float> scales(num_rows);
+  std::vector<float> biases(num_rows);
+  for (int64_t r = 0; r < num_rows; ++r) {
+    for (int64_t k = 0; k < embedding_dim; ++k) {
+      values[r * embedding_dim + k] = static_cast<int>((r + 3 * k) % 4);
+    }
+    scales[r] = 0.125f * static_cast<float>(r + 1);
+    biases[r] = static_cast<float>(r % 3) - 1.0f;
+  }
+
+  std::vector<int32_t> indices(num_bags * bag_size);
+  std::vector<float> output(num_bags * embedding_dim, 0.0f);
+  for (int64_t b = 0; b < num_bags; ++b) {
+    for (int64_t j = 0; j < bag_size; ++j) {
+      const int32_t r = static_cast<int32_t>((b * 5 + j * 7) % num_rows);
+      indices[b * bag_size + j] = r;
+      for (int64_t k = 0; k < embedding_dim; ++k) {
+        output[b * embedding_dim + k] +=
+            (static_cast<float>(values[r * embedding_dim + k]) * scales[r] + biases[r]) / bag_size;
+      }
+    }
+  }
+
+  OpTester test("GatherRowQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("bits", 2);
+  test.AddAttribute<int64_t>("embedding_dim", embedding_dim);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<uint8_t>("data", {num_rows, 2}, PackRows(values, embedding_dim, 2));
+  test.AddInput<int32_t>("indices", {num_bags, bag_size}, indices);
+  test.AddInput<float>("scales", {num_rows}, scales);
+  test.AddInput<float>("biases", {num_rows}, biases);
+  test.AddOutput<float>("output", {num_bags, embedding_dim}, output);
+  test.Run();
+}
+
+TEST(GatherRowQuantizedTest, InvalidIndex) {
+  OpTester test("GatherRowQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("embedding_dim", 2);
+  test.AddInput<uint8_t>("data", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<int64_t>("indices", {1}, {2});
+  test.AddInput<float>("scales", {2}, {1.0f, 1.0f});
+  test.AddInput<float>("biases", {2}, {0.0f, 0.0f});
+  test.AddOutput<float>("output", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+TEST(GatherRowQuantizedTest, InvalidRowBytes) {
+  OpTester test("GatherRowQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("bits", 4);
+  test.AddAttribute<int64_t>("embedding_dim", 6);
+  test.AddInput<uint8_t>("data", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<int64_t>("indices", {1}, {0});
+  test.AddInput<float>("scales", {2}, {1.0f, 1.0f});
+  test.AddInput<float>("biases", {2}, {0.0f, 0.0f});
+  test.AddOutput<float>("output", {1, 6}, std::vector<float>(6, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "bytes per row");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
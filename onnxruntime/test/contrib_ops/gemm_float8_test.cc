@@ -118,6 +118,44 @@ TEST(GemmFloat8OpTest, Float8E4M3FNToFloat8E4M3FN) {
   TestGemmFloat8WithFloat8<Float8E4M3FN, Float8E4M3FN>(static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN));
 }
 
+TEST(GemmFloat8OpTest, Float8E4M3FNBatchScalePerColumn) {
+  if (!HasCudaEnvironment(890)) {
+    LOGS_DEFAULT(WARNING) << "Hardware NOT support Matrix Multiplication for FLOAT8";
+    return;
+  }
+  constexpr int64_t K = 16;
+  constexpr int64_t N = 16;
+  // A is a batch of [3, K] matrices, B is the identity, so Y = scaleA * A * scaleB of the columns.
+  std::vector<float> a_values(2 * 3 * K);
+  std::vector<float> b_values(N * K, 0.f);
+  std::vector<float> scale_b(N);
+  std::vector<float> expected(a_values.size());
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(static_cast<int>(i % 9) - 4);
+  }
+  for (int64_t n = 0; n < N; ++n) {
+    b_values[n * K + n] = 1.f;
+    scale_b[n] = static_cast<float>(n + 1);
+  }
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    expected[i] = 2.f * a_values[i] * scale_b[i % N];
+  }
+
+  OpTester test("GemmFloat8", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("dtype", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+  test.AddInput<Float8E4M3FN>("A", {2, 3, K}, _TypedCvt<Float8E4M3FN>(a_values));
+  test.AddInput<Float8E4M3FN>("B", {N, K}, _TypedCvt<Float8E4M3FN>(b_values));
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<float>("scaleA", {}, {2.f});
+  test.AddInput<float>("scaleB", {N}, scale_b);
+  test.AddOutput<float>("Y", {2, 3, N}, expected);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 #endif
 
 #endif
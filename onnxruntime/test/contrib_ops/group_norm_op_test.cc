@@ -782,10 +782,11 @@ TEST(GroupNormTest, GroupNorm_128) {
       test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
     }
 
-    // Test float32, with activation
+    // Test float32, with activation. The CPU EP supports both layouts.
     enable_cuda = HasCudaEnvironment(0);
-    if (enable_cuda || enable_rocm || enable_dml) {
+    {
       std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
       if (enable_cuda && channels_last != 0) {
         execution_providers.push_back(DefaultCudaExecutionProvider());
       }
@@ -796,11 +797,6 @@ TEST(GroupNormTest, GroupNorm_128) {
         execution_providers.push_back(DefaultDmlExecutionProvider());
       }
 
-      // Don't run the test if no providers are supported
-      if (execution_providers.empty()) {
-        continue;
-      }
-
       OpTester test("GroupNorm", 1, onnxruntime::kMSDomain);
       test.AddAttribute<float>("epsilon", 1e-05f);
       test.AddAttribute<int64_t>("groups", 32);
@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Runs GroupQueryAttention with a quantized k-v cache on the CPU. The key and value are generated from integer codes
+// times the static scales, so they survive quantization exactly and the output equals float attention over them.
+void RunGroupQueryAttentionQuantizedKVCacheTest(int bit_width, int scale_block_count, bool is_prompt) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 16;
+  const int sequence_length = is_prompt ? 3 : 1;
+  const int past_sequence_length = is_prompt ? 0 : 4;
+  // the second batch of the token generation has a shorter past, the rest of its past buffer is padding
+  const std::vector<int32_t> seqlens_k = is_prompt ? std::vector<int32_t>{2, 2} : std::vector<int32_t>{4, 2};
+  const int total_sequence_length = is_prompt ? sequence_length : past_sequence_length + 1;
+  const int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
+  const int block_size = head_size / scale_block_count;
+  const int row_bytes = bit_width == 4 ? head_size / 2 : head_size;
+  const int max_code = bit_width == 4 ? 7 : 20;
+
+  std::default_random_engine generator(static_cast<unsigned>(bit_width * 10 + scale_block_count));
+  std::uniform_real_distribution<float> real_distribution(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> code_distribution(-max_code, max_code);
+
+  std::vector<float> k_scale(kv_num_heads * scale_block_count);
+  std::vector<float> v_scale(kv_num_heads * scale_block_count);
+  for (size_t i = 0; i < k_scale.size(); i++) {
+    k_scale[i] = 0.02f * static_cast<float>(i % 3 + 1);
+    v_scale[i] = 0.03f * static_cast<float>(i % 2 + 1);
+  }
+
+  // codes of the present cache in BNSH layout, padding rows are 0
+  std::vector<int> k_codes(batch_size * kv_num_heads * present_sequence_length * head_size, 0);
+  std::vector<int> v_codes(k_codes.size(), 0);
+  for (int b = 0; b < batch_size; b++) {
+    const int valid_length = seqlens_k[b] + 1;
+    for (int n = 0; n < kv_num_heads; n++) {
+      for (int t = 0; t < valid_length; t++) {
+        for (int h = 0; h < head_size; h++) {
+          const size_t index =
+              ((static_cast<size_t>(b) * kv_num_heads + n) * present_sequence_length + t) * head_size + h;
+          k_codes[index] = code_distribution(generator);
+          v_codes[index] = code_distribution(generator);
+        }
+      }
+    }
+  }
+
+  auto pack = [&](const std::vector<int>& codes, int sequence) {
+    std::vector<uint8_t> packed(batch_size * kv_num_heads * sequence * row_bytes, 0);
+    for (int bn = 0; bn < batch_size * kv_num_heads; bn++) {
+      for (int t = 0; t < sequence; t++) {
+        for (int h = 0; h < head_size; h++) {
+          const int code = codes[(static_cast<size_t>(bn) * present_sequence_length + t) * head_size + h];
+          uint8_t* row = packed.data() + (static_cast<size_t>(bn) * sequence + t) * row_bytes;
+          if (bit_width == 8) {
+            row[h] = static_cast<uint8_t>(static_cast<int8_t>(code));
+          } else {
+            row[h / 2] |= static_cast<uint8_t>((code & 0x0F) << (h % 2 == 0 ? 0 : 4));
+          }
+        }
+      }
+    }
+    return packed;
+  };
+
+  auto dequantize = [&](const std::vector<int>& codes, const std::vector<float>& scale, int b, int n, int t, int h) {
+    const size_t index = ((static_cast<size_t>(b) * kv_num_heads + n) * present_sequence_length + t) * head_size + h;
+    return static_cast<float>(codes[index]) * scale[n * scale_block_count + h / block_size];
+  };
+
+  // new key and value in BSNH layout, taken at the position of each batch's new tokens
+  std::vector<float> query(batch_size * sequence_length * num_heads * head_size);
+  for (auto& q : query) {
+    q = real_distribution(generator);
+  }
+  std::vector<float> key(batch_size * sequence_length * kv_num_heads * head_size);
+  std::vector<float> value(key.size());
+  for (int b = 0; b < batch_size; b++) {
+    const int first_new_token = is_prompt ? 0 : seqlens_k[b];
+    for (int s = 0; s < sequence_length; s++) {
+      for (int n = 0; n < kv_num_heads; n++) {
+        for (int h = 0; h < head_size; h++) {
+          const size_t index = ((static_cast<size_t>(b) * sequence_length + s) * kv_num_heads + n) * head_size + h;
+          key[index] = dequantize(k_codes, k_scale, b, n, first_new_token + s, h);
+          value[index] = dequantize(v_codes, v_scale, b, n, first_new_token + s, h);
+        }
+      }
+    }
+  }
+
+  // causal attention in float over the dequantized cache, output in BSNH layout
+  const float alpha = 1.0f / std::sqrt(static_cast<float>(head_size));
+  std::vector<float> output(query.size());
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const int kv_head = n / (num_heads / kv_num_heads);
+      for (int s = 0; s < sequence_length; s++) {
+        const int causal_length = is_prompt ? s + 1 : seqlens_k[b] + 1;
+        const float* q = query.data() + ((static_cast<size_t>(b) * sequence_length + s) * num_heads + n) * head_size;
+        std::vector<double> probs(causal_length);
+        double max_score = -1e30;
+        for (int t = 0; t < causal_length; t++) {
+          double score = 0.0;
+          for (int h = 0; h < head_size; h++) {
+            score += static_cast<double>(q[h]) * dequantize(k_codes, k_scale, b, kv_head, t, h);
+          }
+          probs[t] = score * alpha;
+          max_score = std::max(max_score, probs[t]);
+        }
+        double sum = 0.0;
+        for (auto& p : probs) {
+          p = std::exp(p - max_score);
+          sum += p;
+        }
+        for (int h = 0; h < head_size; h++) {
+          double o = 0.0;
+          for (int t = 0; t < causal_length; t++) {
+            o += probs[t] / sum * dequantize(v_codes, v_scale, b, kv_head, t, h);
+          }
+          output[((static_cast<size_t>(b) * sequence_length + s) * num_heads + n) * head_size + h] =
+              static_cast<float>(o);
+        }
+      }
+    }
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", num_heads);
+  tester.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  tester.AddAttribute<int64_t>("kv_cache_bit_width", bit_width);
+
+  const std::vector<int64_t> scale_dims = scale_block_count == 1
+                                              ? std::vector<int64_t>{kv_num_heads}
+                                              : std::vector<int64_t>{kv_num_heads, scale_block_count};
+  const std::vector<int64_t> past_dims = {batch_size, kv_num_heads, past_sequence_length, row_bytes};
+  const std::vector<int64_t> present_dims = {batch_size, kv_num_heads, present_sequence_length, row_bytes};
+  const std::vector<uint8_t> past_key = pack(k_codes, past_sequence_length);
+  const std::vector<uint8_t> past_value = pack(v_codes, past_sequence_length);
+  const std::vector<uint8_t> present_key = pack(k_codes, present_sequence_length);
+  const std::vector<uint8_t> present_value = pack(v_codes, present_sequence_length);
+
+  auto add_cache_input = [&](const char* name, const std::vector<uint8_t>& data) {
+    if (is_prompt) {
+      tester.AddOptionalInputEdge<float>();
+    } else if (bit_width == 8) {
+      tester.AddInput<int8_t>(name, past_dims, std::vector<int8_t>(data.begin(), data.end()));
+    } else {
+      tester.AddInput<uint8_t>(name, past_dims, data);
+    }
+  };
+  auto add_cache_output = [&](const char* name, const std::vector<uint8_t>& data) {
+    if (bit_width == 8) {
+      tester.AddOutput<int8_t>(name, present_dims, std::vector<int8_t>(data.begin(), data.end()));
+    } else {
+      tester.AddOutput<uint8_t>(name, present_dims, data);
+    }
+  };
+
+  tester.AddInput<float>("query", {batch_size, sequence_length, num_heads * head_size}, query);
+  tester.AddInput<float>("key", {batch_size, sequence_length, kv_num_heads * head_size}, key);
+  tester.AddInput<float>("value", {batch_size, sequence_length, kv_num_heads * head_size}, value);
+  add_cache_input("past_key", past_key);
+  add_cache_input("past_value", past_value);
+  tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<float>("k_scale", scale_dims, k_scale);
+  tester.AddInput<float>("v_scale", scale_dims, v_scale);
+
+  tester.AddOutput<float>("output", {batch_size, sequence_length, num_heads * head_size}, output);
+  add_cache_output("present_key", present_key);
+  add_cache_output("present_value", present_value);
+  tester.SetOutputTolerance(1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(GroupQueryAttentionTest, QuantizedKVCacheInt8_Prompt) {
+  RunGroupQueryAttentionQuantizedKVCacheTest(8, 1, true);
+}
+
+TEST(GroupQueryAttentionTest, QuantizedKVCacheInt8_TokenGeneration) {
+  RunGroupQueryAttentionQuantizedKVCacheTest(8, 1, false);
+}
+
+TEST(GroupQueryAttentionTest, QuantizedKVCacheInt4_Blockwise_Prompt) {
+  RunGroupQueryAttentionQuantizedKVCacheTest(4, 4, true);
+}
+
+TEST(GroupQueryAttentionTest, QuantizedKVCacheInt4_Blockwise_TokenGeneration) {
+  RunGroupQueryAttentionQuantizedKVCacheTest(4, 4, false);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
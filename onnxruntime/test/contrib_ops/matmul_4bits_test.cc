@@ -15,6 +15,7 @@
 #include "core/mlas/inc/mlas_q4.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/framework/test_utils.h"
 #include "test/optimizer/graph_transform_test_builder.h"
@@ -81,6 +82,10 @@ struct TestOptions {
   bool has_g_idx{false};
   bool has_bias{false};
 
+  // the number of channels of A with large values and the session option that multiplies them in float
+  int64_t num_outlier_channels{0};
+  std::optional<std::string> outlier_threshold{};
+
   std::optional<float> output_abs_error{};
 };
 
@@ -91,7 +96,8 @@ std::ostream& operator<<(std::ostream& os, const TestOptions& opts) {
             << ", has_zero_point:" << opts.has_zero_point
             << ", zp_is_4bit:" << opts.zp_is_4bit
             << ", has_g_idx:" << opts.has_g_idx
-            << ", has_bias:" << opts.has_bias;
+            << ", has_bias:" << opts.has_bias
+            << ", num_outlier_channels:" << opts.num_outlier_channels;
 }
 
 template <typename T1>
@@ -113,6 +119,12 @@ void RunTest(const TestOptions& opts,
   RandomValueGenerator random{1234};
   std::vector<float> input0_vals(random.Gaussian<float>(AsSpan({M, K}), 0.0f, 0.25f));
   std::vector<float> input1_f_vals(random.Gaussian<float>(AsSpan({K, N}), 0.0f, 0.25f));
+  for (int64_t c = 0; c < opts.num_outlier_channels; c++) {
+    const int64_t k = (c * 37 + 5) % K;
+    for (int64_t m = 0; m < M; m++) {
+      input0_vals[m * K + k] += (m % 2 == 0 ? 40.0f : -40.0f);
+    }
+  }
 
 #if 0  // for Debugging
   std::vector<float> input1_f_vals_trans(N * K);
@@ -257,6 +269,125 @@ void RunTest(const TestOptions& opts,
     test.ConfigEps(std::move(explicit_eps));
   }
 
+  SessionOptions so;
+  if (opts.outlier_threshold.has_value()) {
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasMatMulNBitsInt8OutlierThreshold,
+                                                      opts.outlier_threshold->c_str()));
+    test.Config(so);
+  }
+
+  test.RunWithConfig();
+}
+
+// Packs `bits`-bit values densely, least significant bits first, as expected by MatMulNBits for 2 and 3 bits.
+void PackNBits(const std::vector<uint8_t>& vals, int64_t bits, uint8_t* dst) {
+  for (size_t i = 0; i < vals.size(); ++i) {
+    const size_t bit_offset = i * narrow<size_t>(bits);
+    const uint32_t v = static_cast<uint32_t>(vals[i]) << (bit_offset % 8);
+    dst[bit_offset / 8] |= static_cast<uint8_t>(v & 0xff);
+    if (v > 0xff) {
+      dst[bit_offset / 8 + 1] |= static_cast<uint8_t>(v >> 8);
+    }
+  }
+}
+
+// Tests MatMulNBits with 2-bit or 3-bit B on the CPU EP. The quantized values are generated directly because
+// MlasQuantizeBlockwise() only supports 4 bits.
+void RunLowBitTest(int64_t bits, const TestOptions& opts) {
+  SCOPED_TRACE(opts);
+  SCOPED_TRACE(bits);
+
+  const int64_t M = opts.M,
+                K = opts.K,
+                N = opts.N;
+  const int64_t n_blocks = (K + opts.block_size - 1) / opts.block_size;
+  const int64_t blob_size = opts.block_size * bits / 8;
+  const int64_t zp_bytes_per_col = (n_blocks * bits + 7) / 8;
+
+  RandomValueGenerator random{1234};
+  std::vector<float> input0_vals(random.Gaussian<float>(AsSpan({M, K}), 0.0f, 0.25f));
+  std::vector<float> scales(random.Uniform<float>(AsSpan({N * n_blocks}), 0.01f, 0.1f));
+  std::vector<uint8_t> zp_vals(random.Uniform<uint8_t>(AsSpan({N, n_blocks}), 0, uint8_t(1 << bits)));
+
+  std::vector<uint8_t> input1_vals(N * n_blocks * blob_size, 0);
+  std::vector<uint8_t> zp(N * zp_bytes_per_col, 0);
+  std::vector<float> input1_f_vals(N * K);  // dequantized B, NxK
+  for (int64_t n = 0; n < N; ++n) {
+    std::vector<uint8_t> q_col(random.Uniform<uint8_t>(AsSpan({n_blocks * opts.block_size}), 0, uint8_t(1 << bits)));
+    PackNBits(q_col, bits, input1_vals.data() + n * n_blocks * blob_size);
+    PackNBits(std::vector<uint8_t>(zp_vals.begin() + n * n_blocks, zp_vals.begin() + (n + 1) * n_blocks),
+              bits, zp.data() + n * zp_bytes_per_col);
+    for (int64_t k = 0; k < K; ++k) {
+      const int64_t blk = k / opts.block_size;
+      const float zero_point = opts.has_zero_point ? static_cast<float>(zp_vals[n * n_blocks + blk])
+                                                   : static_cast<float>(1 << (bits - 1));
+      input1_f_vals[n * K + k] = (static_cast<float>(q_col[k]) - zero_point) * scales[n * n_blocks + blk];
+    }
+  }
+
+  const std::vector<int64_t> bias_shape = {N};
+  const auto bias = [&]() -> std::optional<std::vector<float>> {
+    if (opts.has_bias) {
+      return random.Uniform(bias_shape, 1.0f, 5.0f);
+    }
+    return std::nullopt;
+  }();
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += input0_vals[m * K + k] * input1_f_vals[n * K + k];
+      }
+      expected_vals[m * N + n] = sum + (bias.has_value() ? (*bias)[n] : 0.0f);
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", opts.block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("accuracy_level", opts.accuracy_level);
+
+  test.AddInput<float>("A", {M, K}, input0_vals, false);
+  test.AddInput<uint8_t>("B", {N, n_blocks, blob_size}, input1_vals, true);
+  test.AddInput<float>("scales", {N * n_blocks}, scales, true);
+
+  if (!opts.has_zero_point) {
+    test.AddOptionalInputEdge<uint8_t>();
+  } else if (opts.zp_is_4bit) {
+    // "zp_is_4bit" means the zero points are packed with the same bit width as B
+    test.AddInput<uint8_t>("zero_points", {static_cast<int64_t>(zp.size())}, zp, true);
+  } else {
+    std::vector<float> zp_f(zp_vals.begin(), zp_vals.end());
+    test.AddInput<float>("zero_points", {N * n_blocks}, zp_f, true);
+  }
+
+  if (opts.has_g_idx) {
+    std::vector<int32_t> g_idx(n_blocks * opts.block_size);
+    for (size_t i = 0; i < g_idx.size(); i++) {
+      g_idx[i] = narrow<int32_t>(static_cast<int64_t>(i) / opts.block_size);
+    }
+    test.AddInput<int32_t>("g_idx", {static_cast<int64_t>(g_idx.size())}, g_idx, true);
+  } else {
+    test.AddOptionalInputEdge<int32_t>();
+  }
+
+  if (bias.has_value()) {
+    test.AddInput<float>("bias", bias_shape, *bias, true);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+
+  test.AddOutput<float>("Y", {M, N}, expected_vals);
+  test.SetOutputAbsErr("Y", 0.01f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> explicit_eps;
+  explicit_eps.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(explicit_eps));
+
   test.RunWithConfig();
 }
 
@@ -320,6 +451,69 @@ TEST(MatMulNBits, Float32) {
   }
 }
 
+// a few channels of A are much larger than the others, as in the activations of LLMs
+TEST(MatMulNBits, Float32Int8OutlierChannels) {
+  for (auto K : {128, 1024, 93}) {
+    for (auto block_size : {32, 128}) {
+      for (bool has_zero_point : {false, true}) {
+        TestOptions opts{};
+        opts.M = 8, opts.N = 64, opts.K = K;
+        opts.block_size = block_size;
+        opts.accuracy_level = 4;
+        opts.has_zero_point = has_zero_point;
+        opts.num_outlier_channels = 4;
+        opts.outlier_threshold = "6";
+        opts.output_abs_error = 0.1f;
+
+        std::vector<std::unique_ptr<IExecutionProvider>> explicit_eps;
+        explicit_eps.emplace_back(DefaultCpuExecutionProvider());
+        RunTest<float>(opts, std::move(explicit_eps));
+      }
+    }
+  }
+}
+
+TEST(MatMulNBits, Float32LowBits) {
+  for (auto bits : {2, 3}) {
+    for (auto M : {1, 2, 67}) {
+      for (auto N : {1, 17, 64}) {
+        for (auto K : {16, 93, 256}) {
+          for (auto block_size : {16, 32, 128}) {
+            for (auto accuracy_level : {0, 4}) {
+              TestOptions base_opts{};
+              base_opts.M = M, base_opts.N = N, base_opts.K = K;
+              base_opts.block_size = block_size;
+              base_opts.accuracy_level = accuracy_level;
+
+              RunLowBitTest(bits, base_opts);
+
+              {
+                TestOptions opts = base_opts;
+                opts.has_zero_point = true;
+                opts.has_bias = true;
+                RunLowBitTest(bits, opts);
+              }
+
+              {
+                TestOptions opts = base_opts;
+                opts.has_zero_point = true, opts.zp_is_4bit = false;
+                RunLowBitTest(bits, opts);
+              }
+
+              {
+                TestOptions opts = base_opts;
+                opts.has_zero_point = true;
+                opts.has_g_idx = true;
+                RunLowBitTest(bits, opts);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 
 namespace {
@@ -392,6 +586,23 @@ TEST(MatMulNBits, Float16) {
   }
 }
 
+#ifdef USE_CUDA
+// shapes of the tensor core GEMM with B prepacked for SM80 and later GPUs, with 4-bit zero points
+TEST(MatMulNBits, Float16Sm80Prepacked) {
+  for (auto M : {2, 16, 17, 100}) {
+    for (auto N : {32, 288}) {
+      for (auto K : {64, 256, 1024}) {
+        for (auto block_size : {16, 32, 64}) {
+          for (auto has_zero_point : {false, true}) {
+            RunTest(M, N, K, block_size, 0, has_zero_point, true);
+          }
+        }
+      }
+    }
+  }
+}
+#endif  // USE_CUDA
+
 TEST(MatMulNBits, Float16Large) {
 #ifdef USE_DML
   // For some reason, the A10 machine that runs these tests during CI has a much bigger error than all retail
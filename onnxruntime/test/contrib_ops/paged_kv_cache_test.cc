@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "contrib_ops/cpu/transformers/paged_kv_cache.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::PagedKVCache;
+
+namespace {
+
+constexpr int kNumLayers = 2;
+constexpr int kNumHeads = 2;
+constexpr int kHeadSize = 4;
+constexpr int kBlockSize = 4;
+
+// Value written for a token, so that the contents of every sequence can be checked after forks and reorders.
+float TokenValue(int tag, int layer, int head, int position, int h, bool is_value) {
+  return static_cast<float>(tag * 10000 + layer * 1000 + head * 100 + position * 10 + h) * (is_value ? -1.0f : 1.0f);
+}
+
+void AppendAndWrite(PagedKVCache<float>& cache, int sequence_id, int token_count, int tag) {
+  const int first_position = cache.SequenceLength(sequence_id);
+  ASSERT_TRUE(cache.AppendTokens(sequence_id, token_count).IsOK());
+  std::vector<float> key(kNumHeads * kHeadSize);
+  std::vector<float> value(key.size());
+  for (int position = first_position; position < first_position + token_count; position++) {
+    for (int layer = 0; layer < kNumLayers; layer++) {
+      for (int head = 0; head < kNumHeads; head++) {
+        for (int h = 0; h < kHeadSize; h++) {
+          key[head * kHeadSize + h] = TokenValue(tag, layer, head, position, h, false);
+          value[head * kHeadSize + h] = TokenValue(tag, layer, head, position, h, true);
+        }
+      }
+      cache.WriteToken(sequence_id, layer, position, key.data(), value.data());
+    }
+  }
+}
+
+// Checks that position p of the sequence holds the token written with tags[p].
+void ExpectSequence(const PagedKVCache<float>& cache, int sequence_id, const std::vector<int>& tags) {
+  const int length = static_cast<int>(tags.size());
+  ASSERT_EQ(cache.SequenceLength(sequence_id), length);
+  std::vector<float> key(kNumHeads * length * kHeadSize);
+  std::vector<float> value(key.size());
+  for (int layer = 0; layer < kNumLayers; layer++) {
+    cache.GatherLayer(sequence_id, layer, length, key.data(), value.data());
+    for (int head = 0; head < kNumHeads; head++) {
+      for (int position = 0; position < length; position++) {
+        for (int h = 0; h < kHeadSize; h++) {
+          const size_t index = (static_cast<size_t>(head) * length + position) * kHeadSize + h;
+          ASSERT_EQ(key[index], TokenValue(tags[position], layer, head, position, h, false));
+          ASSERT_EQ(value[index], TokenValue(tags[position], layer, head, position, h, true));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(PagedKVCacheTest, AllocatesBlocksOnDemand) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), kNumLayers, kNumHeads, kHeadSize, kBlockSize, 8);
+  const int sequence = cache.AddSequence();
+
+  AppendAndWrite(cache, sequence, 5, 1);
+  EXPECT_EQ(cache.BlockTable(sequence).size(), 2u);
+  EXPECT_EQ(cache.NumFreeBlocks(), 6);
+
+  AppendAndWrite(cache, sequence, 3, 1);
+  EXPECT_EQ(cache.BlockTable(sequence).size(), 2u);
+  ExpectSequence(cache, sequence, std::vector<int>(8, 1));
+
+  cache.ReleaseSequence(sequence);
+  EXPECT_EQ(cache.NumFreeBlocks(), 8);
+}
+
+TEST(PagedKVCacheTest, OutOfBlocks) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), kNumLayers, kNumHeads, kHeadSize, kBlockSize, 2);
+  const int sequence = cache.AddSequence();
+
+  AppendAndWrite(cache, sequence, 6, 1);
+  EXPECT_FALSE(cache.AppendTokens(sequence, 3).IsOK());
+
+  // the failed append leaves the sequence unchanged
+  EXPECT_EQ(cache.SequenceLength(sequence), 6);
+  ExpectSequence(cache, sequence, std::vector<int>(6, 1));
+}
+
+TEST(PagedKVCacheTest, ForkCopiesSharedBlockOnWrite) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), kNumLayers, kNumHeads, kHeadSize, kBlockSize, 8);
+  const int parent = cache.AddSequence();
+  AppendAndWrite(cache, parent, 6, 1);
+
+  const int child = cache.ForkSequence(parent);
+  EXPECT_EQ(cache.NumFreeBlocks(), 6);
+  EXPECT_EQ(cache.BlockReferenceCount(cache.BlockTable(parent)[0]), 2);
+
+  // the child writes into the shared partial block, which is copied, while the full block stays shared
+  AppendAndWrite(cache, child, 1, 2);
+  EXPECT_EQ(cache.NumFreeBlocks(), 5);
+  EXPECT_EQ(cache.BlockTable(child)[0], cache.BlockTable(parent)[0]);
+  EXPECT_NE(cache.BlockTable(child)[1], cache.BlockTable(parent)[1]);
+
+  AppendAndWrite(cache, parent, 1, 3);
+  ExpectSequence(cache, parent, {1, 1, 1, 1, 1, 1, 3});
+  ExpectSequence(cache, child, {1, 1, 1, 1, 1, 1, 2});
+
+  cache.ReleaseSequence(parent);
+  cache.ReleaseSequence(child);
+  EXPECT_EQ(cache.NumFreeBlocks(), 8);
+}
+
+TEST(PagedKVCacheTest, ReorderSequencesSharesBlocks) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), kNumLayers, kNumHeads, kHeadSize, kBlockSize, 16);
+  std::vector<int> beams;
+  for (int i = 0; i < 3; i++) {
+    beams.push_back(cache.AddSequence());
+    AppendAndWrite(cache, beams[i], 5, i + 1);
+  }
+  EXPECT_EQ(cache.NumFreeBlocks(), 10);
+
+  // beam 0 is selected twice and beam 1 is dropped
+  const std::vector<int32_t> beam_indices = {2, 0, 0};
+  cache.ReorderSequences(beams, beam_indices);
+  EXPECT_EQ(cache.NumFreeBlocks(), 12);
+
+  for (int i = 0; i < 3; i++) {
+    AppendAndWrite(cache, beams[i], 1, 7 + i);
+  }
+  ExpectSequence(cache, beams[0], {3, 3, 3, 3, 3, 7});
+  ExpectSequence(cache, beams[1], {1, 1, 1, 1, 1, 8});
+  ExpectSequence(cache, beams[2], {1, 1, 1, 1, 1, 9});
+
+  for (int beam : beams) {
+    cache.ReleaseSequence(beam);
+  }
+  EXPECT_EQ(cache.NumFreeBlocks(), 16);
+}
+
+TEST(PagedKVCacheTest, AttentionThroughBlockTable) {
+  constexpr int num_query_heads = 4;
+  constexpr int length = 11;
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, kNumHeads, kHeadSize, kBlockSize, 8);
+
+  // interleave two sequences so that the blocks of each are not contiguous
+  const int other = cache.AddSequence();
+  const int sequence = cache.AddSequence();
+  std::default_random_engine generator(7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  std::vector<float> keys(kNumHeads * length * kHeadSize);
+  std::vector<float> values(keys.size());
+  std::vector<float> key(kNumHeads * kHeadSize);
+  std::vector<float> value(key.size());
+  for (int position = 0; position < length; position++) {
+    for (int id : {other, sequence}) {
+      for (size_t i = 0; i < key.size(); i++) {
+        key[i] = distribution(generator);
+        value[i] = distribution(generator);
+      }
+      ASSERT_TRUE(cache.AppendTokens(id, 1).IsOK());
+      cache.WriteToken(id, 0, position, key.data(), value.data());
+    }
+    for (int head = 0; head < kNumHeads; head++) {
+      for (int h = 0; h < kHeadSize; h++) {
+        keys[(head * length + position) * kHeadSize + h] = key[head * kHeadSize + h];
+        values[(head * length + position) * kHeadSize + h] = value[head * kHeadSize + h];
+      }
+    }
+  }
+
+  std::vector<float> query(num_query_heads * kHeadSize);
+  for (auto& q : query) {
+    q = distribution(generator);
+  }
+  const float scale = 0.5f;
+  std::vector<float> output(query.size());
+  contrib::transformers::PagedKVCacheAttention(cache, sequence, 0, query.data(), num_query_heads, scale,
+                                               output.data());
+
+  for (int query_head = 0; query_head < num_query_heads; query_head++) {
+    const int head = query_head / (num_query_heads / kNumHeads);
+    std::vector<double> probs(length);
+    double sum = 0.0;
+    for (int t = 0; t < length; t++) {
+      double score = 0.0;
+      for (int h = 0; h < kHeadSize; h++) {
+        score += query[query_head * kHeadSize + h] * keys[(head * length + t) * kHeadSize + h];
+      }
+      probs[t] = std::exp(score * scale);
+      sum += probs[t];
+    }
+    for (int h = 0; h < kHeadSize; h++) {
+      double expected = 0.0;
+      for (int t = 0; t < length; t++) {
+        expected += probs[t] / sum * values[(head * length + t) * kHeadSize + h];
+      }
+      EXPECT_NEAR(output[query_head * kHeadSize + h], expected, 1e-5);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "contrib_ops/cpu/transformers/prefix_kv_cache.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::PagedKVCache;
+using contrib::transformers::PrefixKVCache;
+
+namespace {
+
+constexpr int kHeadSize = 2;
+constexpr int kBlockSize = 4;
+
+// Computes a prompt from `first_position` on, where the key and value of a token are its id.
+void RunPrompt(PagedKVCache<float>& cache, int sequence_id, const std::vector<int32_t>& token_ids,
+               int first_position) {
+  ASSERT_TRUE(cache.AppendTokens(sequence_id, static_cast<int>(token_ids.size()) - first_position).IsOK());
+  std::vector<float> key(kHeadSize);
+  for (size_t i = first_position; i < token_ids.size(); i++) {
+    std::fill(key.begin(), key.end(), static_cast<float>(token_ids[i]));
+    cache.WriteToken(sequence_id, 0, static_cast<int>(i), key.data(), key.data());
+  }
+}
+
+void ExpectKeys(const PagedKVCache<float>& cache, int sequence_id, const std::vector<int32_t>& token_ids) {
+  const int length = static_cast<int>(token_ids.size());
+  ASSERT_EQ(cache.SequenceLength(sequence_id), length);
+  std::vector<float> keys(static_cast<size_t>(length) * kHeadSize);
+  std::vector<float> values(keys.size());
+  cache.GatherLayer(sequence_id, 0, length, keys.data(), values.data());
+  for (int i = 0; i < length; i++) {
+    ASSERT_EQ(keys[i * kHeadSize], static_cast<float>(token_ids[i]));
+    ASSERT_EQ(values[i * kHeadSize + 1], static_cast<float>(token_ids[i]));
+  }
+}
+
+}  // namespace
+
+TEST(PrefixKVCacheTest, ReusesCachedPrefix) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, 16);
+  PrefixKVCache<float> prefix_cache(cache, 16);
+
+  const std::vector<int32_t> first = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  int cached_length = -1;
+  const int first_sequence = prefix_cache.AddSequence(first, cached_length);
+  EXPECT_EQ(cached_length, 0);
+  RunPrompt(cache, first_sequence, first, cached_length);
+  prefix_cache.Insert(first_sequence, first);
+  EXPECT_EQ(prefix_cache.NumCachedBlocks(), 2);
+
+  // shares the first two blocks, and then diverges
+  const std::vector<int32_t> second = {1, 2, 3, 4, 5, 6, 7, 8, 42, 43, 44};
+  const int second_sequence = prefix_cache.AddSequence(second, cached_length);
+  EXPECT_EQ(cached_length, 8);
+  EXPECT_EQ(cache.BlockTable(second_sequence)[1], cache.BlockTable(first_sequence)[1]);
+  RunPrompt(cache, second_sequence, second, cached_length);
+  ExpectKeys(cache, second_sequence, second);
+
+  // the blocks stay cached when their sequences are released
+  cache.ReleaseSequence(first_sequence);
+  cache.ReleaseSequence(second_sequence);
+  EXPECT_EQ(cache.NumFreeBlocks(), 14);
+
+  // a prompt that differs in the first block has no cached prefix
+  const std::vector<int32_t> third = {1, 2, 3, 0, 5, 6, 7, 8, 9};
+  prefix_cache.AddSequence(third, cached_length);
+  EXPECT_EQ(cached_length, 0);
+}
+
+TEST(PrefixKVCacheTest, LeavesLastTokenToCompute) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, 8);
+  PrefixKVCache<float> prefix_cache(cache, 8);
+
+  const std::vector<int32_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8};
+  int cached_length = -1;
+  const int sequence = prefix_cache.AddSequence(prompt, cached_length);
+  RunPrompt(cache, sequence, prompt, cached_length);
+  prefix_cache.Insert(sequence, prompt);
+  EXPECT_EQ(prefix_cache.NumCachedBlocks(), 2);
+
+  // the same prompt reuses the first block only, so the last token is run through the model
+  const int repeated = prefix_cache.AddSequence(prompt, cached_length);
+  EXPECT_EQ(cached_length, 4);
+  RunPrompt(cache, repeated, prompt, cached_length);
+  ExpectKeys(cache, repeated, prompt);
+}
+
+TEST(PrefixKVCacheTest, EvictsLeastRecentlyUsed) {
+  PagedKVCache<float> cache(std::make_shared<CPUAllocator>(), 1, 1, kHeadSize, kBlockSize, 16);
+  PrefixKVCache<float> prefix_cache(cache, 3);
+
+  const std::vector<int32_t> first = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  const std::vector<int32_t> second = {11, 12, 13, 14, 15};
+  int cached_length = -1;
+  for (const auto* prompt : {&first, &second}) {
+    const int sequence = prefix_cache.AddSequence(*prompt, cached_length);
+    RunPrompt(cache, sequence, *prompt, cached_length);
+    prefix_cache.Insert(sequence, *prompt);
+    cache.ReleaseSequence(sequence);
+  }
+  EXPECT_EQ(prefix_cache.NumCachedBlocks(), 3);
+  EXPECT_EQ(cache.NumFreeBlocks(), 13);
+
+  // using the first prompt again makes the block of the second one the least recently used
+  const int sequence = prefix_cache.AddSequence(first, cached_length);
+  EXPECT_EQ(cached_length, 8);
+  cache.ReleaseSequence(sequence);
+
+  const std::vector<int32_t> third = {21, 22, 23, 24, 25};
+  const int third_sequence = prefix_cache.AddSequence(third, cached_length);
+  RunPrompt(cache, third_sequence, third, cached_length);
+  prefix_cache.Insert(third_sequence, third);
+  cache.ReleaseSequence(third_sequence);
+  EXPECT_EQ(prefix_cache.NumCachedBlocks(), 3);
+
+  prefix_cache.AddSequence(first, cached_length);
+  EXPECT_EQ(cached_length, 8);
+  prefix_cache.AddSequence(second, cached_length);
+  EXPECT_EQ(cached_length, 0);
+
+  prefix_cache.Clear();
+  EXPECT_EQ(prefix_cache.NumCachedBlocks(), 0);
+  EXPECT_EQ(cache.NumFreeBlocks(), 14);  // the sequence of the first prompt above still holds two blocks
+}
+
+}  // namespace test
+}  // namespace onnxruntime
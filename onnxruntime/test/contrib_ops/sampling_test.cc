@@ -1,12 +1,24 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/softmax_shared.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "contrib_ops/cpu/transformers/generation_device_helper.h"
+#include "contrib_ops/cpu/transformers/sampling_cpu_helper.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/util/include/asserts.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -163,5 +175,210 @@ TEST(SamplingTest, Gpt2Sampling_CPU) {
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
 #endif
+
+namespace {
+constexpr size_t kSampleRowBatchSize = 4;
+constexpr size_t kSampleRowVocabSize = 600;
+
+// Rows from flat to peaked distributions. The flat ones have nuclei of more than
+// SamplingCpuHelper::kInitialNucleusCandidates tokens.
+std::vector<float> CreateSampleRowScores() {
+  std::mt19937 random(1234);
+  std::vector<float> scores;
+  for (float stddev : {0.1f, 1.0f, 3.0f, 10.0f}) {
+    std::normal_distribution<float> normal(0.0f, stddev);
+    for (size_t i = 0; i < kSampleRowVocabSize; i++) {
+      scores.push_back(normal(random));
+    }
+  }
+  return scores;
+}
+
+contrib::transformers::IGenerationParameters CreateSampleRowParameters() {
+  contrib::transformers::IGenerationParameters parameters{};
+  parameters.batch_size = static_cast<int>(kSampleRowBatchSize);
+  parameters.vocab_size = static_cast<int>(kSampleRowVocabSize);
+  parameters.filter_value = -std::numeric_limits<float>::infinity();
+  parameters.top_p = 1.0f;
+  parameters.min_tokens_to_keep = 1;
+  return parameters;
+}
+
+// The top-k filtering as in HuggingFace TopKLogitsWarper.
+void ReferenceTopKFilter(gsl::span<float> row, const contrib::transformers::IGenerationParameters& parameters) {
+  if (parameters.top_k <= 0 || static_cast<size_t>(parameters.top_k) >= row.size()) {
+    return;
+  }
+  std::vector<size_t> order(row.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&row](size_t a, size_t b) { return row[a] > row[b]; });
+  for (size_t i = static_cast<size_t>(parameters.top_k); i < order.size(); i++) {
+    row[order[i]] = parameters.filter_value;
+  }
+}
+
+// The top-p filtering of the former Sample(), which sorted the whole row and filtered by the cumulative softmax of
+// the sorted scores.
+void ReferenceTopPFilter(gsl::span<float> row, const contrib::transformers::IGenerationParameters& parameters) {
+  const size_t vocab_size = row.size();
+  std::function<bool(float, float)> predicator;
+  if (parameters.custom_sampling) {
+    predicator = std::greater<float>();
+  } else {
+    predicator = std::less<float>();
+  }
+  std::vector<size_t> sorted_indices(vocab_size);
+  std::iota(sorted_indices.begin(), sorted_indices.end(), 0);
+  std::sort(sorted_indices.begin(), sorted_indices.end(),
+            [&row, &predicator](size_t a, size_t b) { return predicator(row[a], row[b]); });
+  std::vector<float> sorted_scores(row.begin(), row.end());
+  std::sort(sorted_scores.begin(), sorted_scores.end(), predicator);
+
+  std::vector<float> cumulative_probs(vocab_size);
+  ASSERT_STATUS_OK(SoftmaxCPU<float>(1, vocab_size, sorted_scores.data(), cumulative_probs.data(), false, nullptr));
+
+  std::vector<size_t> filtered;
+  if (parameters.custom_sampling) {
+    if (cumulative_probs[0] > parameters.top_p) {
+      filtered.push_back(sorted_indices[1]);
+    }
+    for (size_t j = 1; j < vocab_size - 1; j++) {
+      cumulative_probs[j] += cumulative_probs[j - 1];
+      if (cumulative_probs[j] > parameters.top_p) {
+        filtered.push_back(sorted_indices[j + 1]);
+      }
+    }
+  } else {
+    if (cumulative_probs[0] <= 1 - parameters.top_p) {
+      filtered.push_back(sorted_indices[0]);
+    }
+    for (size_t j = 1; j < vocab_size - static_cast<size_t>(parameters.min_tokens_to_keep); j++) {
+      cumulative_probs[j] += cumulative_probs[j - 1];
+      if (cumulative_probs[j] <= 1 - parameters.top_p) {
+        filtered.push_back(sorted_indices[j]);
+      }
+    }
+  }
+  for (size_t index : filtered) {
+    row[index] = parameters.filter_value;
+  }
+}
+
+// The draw of the former MultinomialComputeShared() over the filtered scores.
+int32_t ReferenceMultinomial(gsl::span<const float> row, double uniform) {
+  float max_logit = std::numeric_limits<float>::lowest();
+  for (float score : row) {
+    if (std::isfinite(score)) {
+      max_logit = std::max(max_logit, score);
+    }
+  }
+  std::vector<double> cdf(row.size());
+  double running_total = 0.0;
+  for (size_t j = 0; j < row.size(); j++) {
+    if (std::isfinite(row[j])) {
+      running_total += std::exp(static_cast<double>(row[j]) - static_cast<double>(max_logit));
+    }
+    cdf[j] = running_total;
+  }
+  return static_cast<int32_t>(std::distance(cdf.begin(),
+                                            std::upper_bound(cdf.begin(), cdf.end(), uniform * running_total)));
+}
+
+// Runs SampleRow on each row and checks the filtered scores and the next tokens against the top-k filtering of
+// HuggingFace followed by the top-p filtering and the draw of the former implementation, with the same draws of
+// U(0, 1) from a fixed seed. Returns the number of tokens kept in each row.
+std::vector<size_t> CheckSampleRow(const contrib::transformers::IGenerationParameters& parameters) {
+  const std::vector<float> scores = CreateSampleRowScores();
+  std::vector<float> probs(scores.size());
+  EXPECT_STATUS_OK(SoftmaxCPU<float>(kSampleRowBatchSize, kSampleRowVocabSize, scores.data(), probs.data(), false,
+                                     nullptr));
+
+  std::default_random_engine generator(static_cast<unsigned>(parameters.seed));
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  std::vector<float> kept_scores(kSampleRowVocabSize);
+  std::vector<int32_t> indices(kSampleRowVocabSize);
+  std::vector<size_t> kept_counts;
+  auto is_kept = [&parameters](float score) { return score != parameters.filter_value; };
+  for (size_t b = 0; b < kSampleRowBatchSize; b++) {
+    const double uniform = distribution(generator);
+    const auto row_begin = scores.begin() + static_cast<ptrdiff_t>(b * kSampleRowVocabSize);
+
+    std::vector<float> row(row_begin, row_begin + kSampleRowVocabSize);
+    const int32_t next_token = contrib::SamplingCpuHelper::SampleRow<float>(
+        gsl::make_span(row), gsl::make_span(probs).subspan(b * kSampleRowVocabSize, kSampleRowVocabSize),
+        gsl::make_span(kept_scores), gsl::make_span(indices), uniform, &parameters);
+
+    std::vector<float> expected_row(row_begin, row_begin + kSampleRowVocabSize);
+    ReferenceTopKFilter(gsl::make_span(expected_row), parameters);
+    // top-p applies to the scores that top-k leaves
+    std::vector<size_t> candidates;
+    std::vector<float> candidate_scores;
+    for (size_t j = 0; j < kSampleRowVocabSize; j++) {
+      if (is_kept(expected_row[j])) {
+        candidates.push_back(j);
+        candidate_scores.push_back(expected_row[j]);
+      }
+    }
+    ReferenceTopPFilter(gsl::make_span(candidate_scores), parameters);
+    for (size_t i = 0; i < candidates.size(); i++) {
+      expected_row[candidates[i]] = candidate_scores[i];
+    }
+    const int32_t expected_next_token = ReferenceMultinomial(expected_row, uniform);
+
+    EXPECT_EQ(row, expected_row) << "row " << b;
+    EXPECT_EQ(next_token, expected_next_token) << "row " << b;
+    EXPECT_TRUE(is_kept(row[next_token])) << "row " << b;
+    kept_counts.push_back(static_cast<size_t>(std::count_if(row.begin(), row.end(), is_kept)));
+  }
+  return kept_counts;
+}
+}  // namespace
+
+TEST(SamplingTest, SampleRowTopK) {
+  auto parameters = CreateSampleRowParameters();
+  parameters.top_k = 20;
+  for (size_t kept : CheckSampleRow(parameters)) {
+    EXPECT_EQ(kept, 20u);
+  }
+}
+
+TEST(SamplingTest, SampleRowTopP) {
+  auto parameters = CreateSampleRowParameters();
+  for (int seed : {0, 1, 42}) {
+    parameters.seed = seed;
+    for (float top_p : {0.5f, 0.9f, 0.99f}) {
+      parameters.top_p = top_p;
+      CheckSampleRow(parameters);
+    }
+  }
+}
+
+TEST(SamplingTest, SampleRowTopKAndTopP) {
+  auto parameters = CreateSampleRowParameters();
+  parameters.top_k = 50;
+  parameters.top_p = 0.8f;
+  for (size_t kept : CheckSampleRow(parameters)) {
+    EXPECT_LE(kept, 50u);
+  }
+}
+
+TEST(SamplingTest, SampleRowCustomSampling) {
+  auto parameters = CreateSampleRowParameters();
+  parameters.custom_sampling = true;
+  for (float top_p : {0.0f, 0.5f, 0.9f}) {
+    parameters.top_p = top_p;
+    CheckSampleRow(parameters);
+  }
+}
+
+TEST(SamplingTest, SampleRowMinTokensToKeep) {
+  auto parameters = CreateSampleRowParameters();
+  parameters.top_p = 0.01f;
+  parameters.min_tokens_to_keep = 5;
+  for (size_t kept : CheckSampleRow(parameters)) {
+    EXPECT_GE(kept, 5u);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -158,6 +158,30 @@ TEST(SkipGroupNormTest, SkipGroupNorm_with_bias) {
       test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
     }
   }
+
+  // The CPU EP runs the float32 version.
+  {
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+
+    OpTester test("SkipGroupNorm", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<float>("epsilon", 1e-05f);
+    test.AddAttribute<int64_t>("groups", 4);
+    test.AddAttribute<int64_t>("activation", 0);
+
+    test.AddInput<float>("X", dims_nhwc, input_data_nhwc);
+    test.AddInput<float>("gamma", {C}, gamma_data);
+    test.AddInput<float>("beta", {C}, beta_data);
+    test.AddInput<float>("skip", dims_nhwc, skip_data_nhwc);
+    test.AddInput<float>("bias", {C}, bias_data);
+
+    constexpr float rel_error = 0.0f;
+    constexpr float abs_error = 0.02f;
+    test.AddOutput<float>("Y", dims_nhwc, norm_data_nhwc, false, rel_error, abs_error);
+    test.AddOutput<float>("S", dims_nhwc, add_out_data_nhwc, false, rel_error, abs_error);
+
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
 }
 
 TEST(SkipGroupNormTest, SkipGroupNorm_no_bias_broadcast_skip) {
@@ -288,6 +312,37 @@ TEST(SkipGroupNormTest, SkipGroupNorm_no_bias_broadcast_skip) {
 
         test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
       }
+
+      // The CPU EP runs the float32 version.
+      {
+        std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+        execution_providers.push_back(DefaultCpuExecutionProvider());
+
+        OpTester test("SkipGroupNorm", 1, onnxruntime::kMSDomain);
+        test.AddAttribute<float>("epsilon", 1e-05f);
+        test.AddAttribute<int64_t>("groups", 8);
+        test.AddAttribute<int64_t>("activation", 0);
+        test.AddAttribute<int64_t>("channels_last", channels_last);
+
+        test.AddInput<float>("X", dims_nhwc, input_data_nhwc);
+        test.AddInput<float>("gamma", {C}, gamma_data);
+        test.AddInput<float>("beta", {C}, beta_data);
+        if (skip_dim == 2) {
+          test.AddInput<float>("skip", {B, C}, skip_data);
+        } else {
+          test.AddInput<float>("skip", {B, 1, 1, C}, skip_data);
+        }
+
+        constexpr float rel_error = 0.0f;
+        constexpr float abs_error = 0.02f;
+        test.AddOutput<float>("Y", dims_nhwc, norm_data_nhwc, false, rel_error, abs_error);
+
+        if (has_add_out) {
+          test.AddOutput<float>("S", dims_nhwc, add_out_data_nhwc, false, rel_error, abs_error);
+        }
+
+        test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+      }
     }
   }
 }
@@ -0,0 +1,251 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int kNumHeads = 2;
+constexpr int kKvNumHeads = 1;
+constexpr int kHeadSize = 8;
+constexpr int kSparseBlockSize = 16;
+constexpr int kMaxBlocks = 4;
+constexpr int kMaxSequenceLength = kMaxBlocks * kSparseBlockSize;
+constexpr int kNumLayouts = 2;
+
+// Two layouts of 4x4 blocks. Each of them has an empty block row, and a block column that no row attends to:
+//   [[1, 0, 0, 0],    [[1, 0, 0, 0],
+//    [0, 0, 0, 0],     [1, 1, 0, 0],
+//    [1, 0, 1, 0],     [0, 0, 0, 0],
+//    [1, 0, 0, 1]]     [0, 1, 0, 1]]
+const std::vector<int32_t> kBlockRowIndices = {0, 1, 1, 3, 5,
+                                               0, 1, 3, 3, 5};
+const std::vector<int32_t> kBlockColIndices = {0, 0, 2, 0, 3,
+                                               0, 0, 1, 1, 3};
+
+struct SparseAttentionTestData {
+  // query of all the positions with shape (max_sequence_length, num_heads * head_size), and key and value with shape
+  // (max_sequence_length, head_size) as there is a single batch and a single kv head
+  std::vector<float> query;
+  std::vector<float> key;
+  std::vector<float> value;
+};
+
+SparseAttentionTestData CreateSparseAttentionTestData() {
+  std::default_random_engine generator(7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  auto generate = [&](size_t size) {
+    std::vector<float> data(size);
+    for (auto& element : data) {
+      element = distribution(generator);
+    }
+    return data;
+  };
+
+  SparseAttentionTestData data;
+  data.query = generate(static_cast<size_t>(kMaxSequenceLength) * kNumHeads * kHeadSize);
+  data.key = generate(static_cast<size_t>(kMaxSequenceLength) * kHeadSize);
+  data.value = generate(static_cast<size_t>(kMaxSequenceLength) * kHeadSize);
+  return data;
+}
+
+// The output of the query at a position, for every head, computed by masking the keys outside the blocks of its
+// layout like the dense kernel did. A query that sees no key of its layout attends to all its causal keys equally.
+std::vector<float> ComputeReferenceOutput(const SparseAttentionTestData& data, int position) {
+  const double scale = 1.0 / std::sqrt(static_cast<double>(kHeadSize));
+  std::vector<float> output(static_cast<size_t>(kNumHeads) * kHeadSize);
+  for (int head = 0; head < kNumHeads; head++) {
+    const int layout = head % kNumLayouts;
+    const int32_t* row_indices = kBlockRowIndices.data() + layout * (kMaxBlocks + 1);
+    const int32_t* col_indices = kBlockColIndices.data() + layout * (kMaxBlocks + 1);
+    const int block_row = position / kSparseBlockSize;
+
+    std::vector<int> keys;
+    for (int t = 0; t <= position; t++) {
+      for (int j = row_indices[block_row]; j < row_indices[block_row + 1]; j++) {
+        if (col_indices[j] == t / kSparseBlockSize) {
+          keys.push_back(t);
+        }
+      }
+    }
+
+    std::vector<double> weights;
+    if (keys.empty()) {
+      for (int t = 0; t <= position; t++) {
+        keys.push_back(t);
+      }
+      weights.assign(keys.size(), 1.0 / static_cast<double>(keys.size()));
+    } else {
+      const float* q = data.query.data() + (static_cast<size_t>(position) * kNumHeads + head) * kHeadSize;
+      double max_score = -std::numeric_limits<double>::infinity();
+      for (int t : keys) {
+        double score = 0.0;
+        for (int h = 0; h < kHeadSize; h++) {
+          score += static_cast<double>(q[h]) * data.key[static_cast<size_t>(t) * kHeadSize + h];
+        }
+        weights.push_back(score * scale);
+        max_score = std::max(max_score, weights.back());
+      }
+
+      double sum = 0.0;
+      for (auto& weight : weights) {
+        weight = std::exp(weight - max_score);
+        sum += weight;
+      }
+      for (auto& weight : weights) {
+        weight /= sum;
+      }
+    }
+
+    for (int h = 0; h < kHeadSize; h++) {
+      double sum = 0.0;
+      for (size_t i = 0; i < keys.size(); i++) {
+        sum += weights[i] * data.value[static_cast<size_t>(keys[i]) * kHeadSize + h];
+      }
+      output[static_cast<size_t>(head) * kHeadSize + h] = static_cast<float>(sum);
+    }
+  }
+  return output;
+}
+
+std::unique_ptr<Model> CreateSparseAttentionModel() {
+  auto model = std::make_unique<Model>("sparse_attention", false, ModelMetaData(), PathString(),
+                                       IOnnxRuntimeOpSchemaRegistryList(),
+                                       std::unordered_map<std::string, int>{{kOnnxDomain, 12}, {kMSDomain, 1}},
+                                       std::vector<ONNX_NAMESPACE::FunctionProto>{},
+                                       DefaultLoggingManager().DefaultLogger());
+  auto& graph = model->MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+
+  std::vector<NodeArg*> inputs;
+  for (const char* name : {"query", "key", "value", "past_key", "past_value"}) {
+    inputs.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+  for (const char* name : {"block_row_indices", "block_col_indices", "total_sequence_length",
+                           "key_total_sequence_lengths"}) {
+    inputs.push_back(&graph.GetOrCreateNodeArg(name, &int32_tensor));
+  }
+
+  std::vector<NodeArg*> outputs;
+  for (const char* name : {"output", "present_key", "present_value"}) {
+    outputs.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+
+  auto& node = graph.AddNode("sparse_attention", "SparseAttention", "", inputs, outputs, nullptr, kMSDomain);
+  node.AddAttribute("num_heads", static_cast<int64_t>(kNumHeads));
+  node.AddAttribute("kv_num_heads", static_cast<int64_t>(kKvNumHeads));
+  node.AddAttribute("sparse_block_size", static_cast<int64_t>(kSparseBlockSize));
+
+  EXPECT_STATUS_OK(graph.Resolve());
+  return model;
+}
+
+// Runs SparseAttention on the CPU for the positions [past_length, past_length + sequence_length), with the key and
+// value of the previous positions in the past buffers, and checks the output against the reference.
+void RunSparseAttentionTest(int past_length, int sequence_length) {
+  const SparseAttentionTestData data = CreateSparseAttentionTestData();
+  const int total_length = past_length + sequence_length;
+
+  SessionOptions so;
+  so.session_logid = "SparseAttentionTest";
+  InferenceSession session{so, GetEnvironment()};
+  std::string serialized_model;
+  ASSERT_TRUE(CreateSparseAttentionModel()->ToProto().SerializeToString(&serialized_model));
+  std::stringstream model_stream(serialized_model);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  auto slice = [](const std::vector<float>& values, int begin, int end, int row_size) {
+    return std::vector<float>(values.begin() + static_cast<ptrdiff_t>(begin) * row_size,
+                              values.begin() + static_cast<ptrdiff_t>(end) * row_size);
+  };
+  std::vector<float> past_key(static_cast<size_t>(kMaxSequenceLength) * kHeadSize, 0.0f);
+  std::vector<float> past_value(past_key.size(), 0.0f);
+  std::copy_n(data.key.begin(), static_cast<size_t>(past_length) * kHeadSize, past_key.begin());
+  std::copy_n(data.value.begin(), static_cast<size_t>(past_length) * kHeadSize, past_value.begin());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  auto create_value = [&](const std::vector<int64_t>& dims, const auto& values) {
+    OrtValue value;
+    CreateMLValue(allocator, dims, values, &value);
+    return value;
+  };
+
+  const OrtValue past_key_value = create_value({1, kKvNumHeads, kMaxSequenceLength, kHeadSize}, past_key);
+  const OrtValue past_value_value = create_value({1, kKvNumHeads, kMaxSequenceLength, kHeadSize}, past_value);
+  NameMLValMap feeds;
+  feeds.emplace("query", create_value({1, sequence_length, kNumHeads * kHeadSize},
+                                      slice(data.query, past_length, total_length, kNumHeads * kHeadSize)));
+  feeds.emplace("key", create_value({1, sequence_length, kKvNumHeads * kHeadSize},
+                                    slice(data.key, past_length, total_length, kHeadSize)));
+  feeds.emplace("value", create_value({1, sequence_length, kKvNumHeads * kHeadSize},
+                                      slice(data.value, past_length, total_length, kHeadSize)));
+  feeds.emplace("past_key", past_key_value);
+  feeds.emplace("past_value", past_value_value);
+  feeds.emplace("block_row_indices", create_value({kNumLayouts, kMaxBlocks + 1}, kBlockRowIndices));
+  feeds.emplace("block_col_indices", create_value({kNumLayouts, kMaxBlocks + 1}, kBlockColIndices));
+  feeds.emplace("total_sequence_length", create_value({}, std::vector<int32_t>{total_length}));
+  feeds.emplace("key_total_sequence_lengths", create_value({1}, std::vector<int32_t>{total_length}));
+
+  // the present buffers have to be the past ones
+  const std::vector<std::string> output_names{"output", "present_key", "present_value"};
+  std::vector<OrtValue> fetches{OrtValue(), past_key_value, past_value_value};
+  ASSERT_STATUS_OK(session.Run(RunOptions(), feeds, output_names, &fetches));
+
+  const auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(output.size(), static_cast<size_t>(sequence_length) * kNumHeads * kHeadSize);
+  for (int s = 0; s < sequence_length; s++) {
+    const std::vector<float> expected = ComputeReferenceOutput(data, past_length + s);
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_NEAR(output[s * expected.size() + i], expected[i], 1e-4f)
+          << "position " << past_length + s << ", element " << i;
+    }
+  }
+
+  const auto present_key = fetches[1].Get<Tensor>().DataAsSpan<float>();
+  const auto present_value = fetches[2].Get<Tensor>().DataAsSpan<float>();
+  for (size_t i = 0; i < static_cast<size_t>(total_length) * kHeadSize; i++) {
+    ASSERT_EQ(present_key[i], data.key[i]);
+    ASSERT_EQ(present_value[i], data.value[i]);
+  }
+}
+
+}  // namespace
+
+// The prompt covers both empty block rows, and the last block row partially.
+TEST(SparseAttentionTest, EmptyBlockRowsAndColumns_Prompt) {
+  RunSparseAttentionTest(0, 50);
+}
+
+// The first new token is in the block row that is empty in the second layout, the second one in the last block row.
+TEST(SparseAttentionTest, EmptyBlockRowsAndColumns_TokenGeneration) {
+  RunSparseAttentionTest(40, 1);
+  RunSparseAttentionTest(50, 1);
+}
+
+// The new tokens start in the middle of a block row and end in the next one.
+TEST(SparseAttentionTest, EmptyBlockRowsAndColumns_PastAndNewTokens) {
+  RunSparseAttentionTest(20, 16);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
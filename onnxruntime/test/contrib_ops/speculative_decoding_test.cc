@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/speculative_decoding.h"
+
+namespace onnxruntime {
+namespace test {
+
+using namespace contrib::transformers;
+
+TEST(SpeculativeDecodingTest, PromptLookupDraft) {
+  std::vector<int32_t> draft(3);
+
+  // the trailing bigram (7, 8) appeared before and was followed by 9, 10, 11
+  const std::vector<int32_t> sequence = {1, 7, 8, 9, 10, 11, 2, 7, 8};
+  ASSERT_EQ(ProposePromptLookupDraft(sequence, 2, draft), 3);
+  EXPECT_EQ(draft, (std::vector<int32_t>{9, 10, 11}));
+
+  // the most recent match wins, and the draft stops at the end of the sequence
+  const std::vector<int32_t> repeated = {5, 1, 2, 5, 3, 5};
+  ASSERT_EQ(ProposePromptLookupDraft(repeated, 2, draft), 2);
+  EXPECT_EQ(draft[0], 3);
+  EXPECT_EQ(draft[1], 5);
+
+  const std::vector<int32_t> unique = {1, 2, 3, 4};
+  EXPECT_EQ(ProposePromptLookupDraft(unique, 3, draft), 0);
+}
+
+TEST(SpeculativeDecodingTest, VerifyDraftGreedy) {
+  const std::vector<int32_t> draft = {4, 5, 6};
+  EXPECT_EQ(VerifyDraftGreedy(draft, std::vector<int32_t>{4, 5, 6, 7}), 3);
+  EXPECT_EQ(VerifyDraftGreedy(draft, std::vector<int32_t>{4, 9, 6, 7}), 1);
+  EXPECT_EQ(VerifyDraftGreedy(draft, std::vector<int32_t>{1, 5, 6, 7}), 0);
+}
+
+TEST(SpeculativeDecodingTest, VerifyDraftSamplingKeepsDistribution) {
+  // The first token after verification shall follow the decoder's distribution whatever the draft is.
+  constexpr int vocab_size = 4;
+  const std::vector<float> probs = {0.1f, 0.2f, 0.3f, 0.4f, 0.25f, 0.25f, 0.25f, 0.25f};
+  const std::vector<int32_t> draft = {2};
+  std::default_random_engine generator(11);
+
+  constexpr int trials = 200000;
+  std::vector<int> counts(vocab_size, 0);
+  for (int i = 0; i < trials; i++) {
+    int32_t next_token = -1;
+    const int accepted = VerifyDraftSampling(draft, probs, vocab_size, generator, next_token);
+    ASSERT_TRUE(accepted == 0 || accepted == 1);
+    ++counts[accepted == 1 ? draft[0] : next_token];
+  }
+
+  for (int v = 0; v < vocab_size; v++) {
+    EXPECT_NEAR(static_cast<double>(counts[v]) / trials, probs[v], 0.005) << "token " << v;
+  }
+}
+
+TEST(SpeculativeDecodingTest, TruncateGptPastState) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  const TensorShape present_shape({2, 2, 3, 5, 4});
+  OrtValue present;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), present_shape, allocator, present);
+  float* present_data = present.GetMutable<Tensor>()->MutableData<float>();
+  for (int64_t i = 0; i < present_shape.Size(); i++) {
+    present_data[i] = static_cast<float>(i);
+  }
+
+  OrtValue past;
+  TruncateGptPastState<float>(present, 3, allocator, past);
+  const Tensor& past_tensor = past.Get<Tensor>();
+  ASSERT_EQ(past_tensor.Shape(), TensorShape({2, 2, 3, 3, 4}));
+
+  const float* past_data = past_tensor.Data<float>();
+  for (int64_t chunk = 0; chunk < 2 * 2 * 3; chunk++) {
+    for (int64_t i = 0; i < 3 * 4; i++) {
+      ASSERT_EQ(past_data[chunk * 12 + i], present_data[chunk * 20 + i]);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -864,5 +864,50 @@ TEST(ContribOpTest, Tokenizer_EmptyInput) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
+
+// Enough rows for the strings to be tokenized in several batches, with literal and regular expression separators
+// and with a tokenexp. Every row has a different number of words so the rows of all the batches are padded.
+TEST(ContribOpTest, TokenizerManyRows) {
+  constexpr int64_t N = 8;
+  constexpr int64_t C = 64;
+  std::vector<std::string> input;
+  std::vector<std::vector<std::string>> words(N * C);
+  size_t max_words = 0;
+  for (int64_t i = 0; i < N * C; ++i) {
+    std::string s;
+    const int64_t num_words = 20 + (i * 7) % 31;
+    for (int64_t w = 0; w < num_words; ++w) {
+      std::string word(static_cast<size_t>(1 + (i + w) % 9), static_cast<char>('a' + (i * w) % 26));
+      s += word;
+      s += (w % 3 == 0) ? ", " : (w % 3 == 1 ? " " : ";");
+      words[i].push_back(std::move(word));
+    }
+    max_words = std::max(max_words, words[i].size());
+    input.push_back(std::move(s));
+  }
+
+  std::vector<std::string> output;
+  for (const auto& row : words) {
+    output.insert(output.end(), row.begin(), row.end());
+    output.insert(output.end(), max_words - row.size(), padval);
+  }
+
+  std::vector<int64_t> dims{N, C};
+  std::vector<int64_t> output_dims{N, C, static_cast<int64_t>(max_words)};
+  for (const auto& separators : {std::vector<std::string>{", ", " ", ";"}, std::vector<std::string>{"[,; ]+"}}) {
+    OpTester test("Tokenizer", opset_ver, domain);
+    InitTestAttr(test, false, separators, 1);
+    test.AddInput<std::string>("T", dims, input);
+    test.AddOutput<std::string>("Y", output_dims, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("Tokenizer", opset_ver, domain);
+    InitTestAttr(test, false, {}, 1, "[a-z]+");
+    test.AddInput<std::string>("T", dims, input);
+    test.AddOutput<std::string>("Y", output_dims, output);
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
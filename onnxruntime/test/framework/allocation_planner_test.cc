@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -386,6 +388,11 @@ class PlannerTest : public ::testing::Test {
   void SetNodePartitionConfigFilePath(const char* config_file_path) {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
+  void SetMaxStreamsPerDevice(const char* max_streams_per_device) {
+    ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kOrtSessionOptionsConfigMaxStreamsPerDevice,
+                                                                    max_streams_per_device));
+  }
+  void SetExecutionMode(ExecutionMode execution_mode) { sess_options_->execution_mode = execution_mode; }
   std::unique_ptr<::onnxruntime::KernelDef>& GetStdKernel() { return std_kernel_; }
 #ifdef USE_CUDA
   void MemcpyToHostInCuda_TransposeInCudaAndCpu(const char* partitionConfigFile = nullptr) {
@@ -442,6 +449,9 @@ TEST_F(PlannerTest, ChainTest) {
   CheckAllocKind(Y, AllocKind::kReuse);
   CheckAllocKind(Z, AllocKind::kAllocateOutput);
 
+  // the kernels of the single stream are run without the stream scheduling
+  EXPECT_TRUE(plan_->is_single_stream_of_kernels);
+
   CheckFreed(0, {});
   CheckFreed(1, {});
   CheckFreed(2, {B});
@@ -714,6 +724,85 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+TEST_F(PlannerTest, ReuseAcrossElementTypesTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+  std::string node1("node1"), node2("node2"), node3("node3"), node4("node4");
+
+  // create the fp16 args first so Arg() returns them
+  ONNX_NAMESPACE::TypeProto float16_type;
+  float16_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
+  GetGraph().GetOrCreateNodeArg(X3, &float16_type);
+  GetGraph().GetOrCreateNodeArg(X4, &float16_type);
+
+  auto cast_kernel = KernelDefBuilder().SetName("Cast").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
+
+  // graph structure: X1 -> Transpose -> X2 (float) -> Cast -> X3 (fp16) -> Transpose -> X4 (fp16) -> Cast -> X5
+  std::vector<onnxruntime::NodeArg*> x1_args{Arg(X1)}, x2_args{Arg(X2)}, x3_args{Arg(X3)}, x4_args{Arg(X4)}, x5_args{Arg(X5)};
+  AddNode(*GetStdKernel(), node1, x1_args, x2_args);
+  AddNode(*cast_kernel, node2, x2_args, x3_args)
+      ->AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16));
+  AddNode(*GetStdKernel(), node3, x3_args, x4_args);
+  AddNode(*cast_kernel, node4, x4_args, x5_args)
+      ->AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+
+  // simulate shape-inference results:
+  Shape shape1{4, 8};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan();
+
+  // X4 (fp16) fits in the buffer of X2 (float), which is freed after node2
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+}
+
+TEST_F(PlannerTest, ConcatInputsInOutputBufferTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+  std::string node1("node1"), node2("node2"), node3("node3"), node4("node4");
+
+  auto concat_kernel = KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
+
+  // graph structure: X1 -> Transpose -> X2, X1 -> Transpose -> X3, Concat(X2, X3) -> X4 -> Transpose -> X5
+  std::vector<onnxruntime::NodeArg*> x1_args{Arg(X1)}, x2_args{Arg(X2)}, x3_args{Arg(X3)};
+  std::vector<onnxruntime::NodeArg*> x4_args{Arg(X4)}, x5_args{Arg(X5)};
+  std::vector<onnxruntime::NodeArg*> concat_args{Arg(X2), Arg(X3)};
+  AddNode(*GetStdKernel(), node1, x1_args, x2_args);
+  AddNode(*GetStdKernel(), node2, x1_args, x3_args);
+  AddNode(*concat_kernel, node3, concat_args, x4_args)->AddAttribute("axis", static_cast<int64_t>(0));
+  AddNode(*GetStdKernel(), node4, x4_args, x5_args);
+
+  // simulate shape-inference results:
+  Shape input_shape{2, 4};
+  Shape output_shape{4, 4};
+  SetShape({{X1, &input_shape.value}, {X2, &input_shape.value}, {X3, &input_shape.value},
+            {X4, &output_shape.value}, {X5, &output_shape.value}});
+
+  CreatePlan();
+
+  // X2 and X3 are produced in the two halves of the buffer of X4
+  CheckAllocKind(X2, AllocKind::kReuseSubBuffer);
+  CheckAllocKind(X3, AllocKind::kReuseSubBuffer);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+
+  int x2_index, x3_index, x4_index;
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(X2, x2_index));
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(X3, x3_index));
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(X4, x4_index));
+  const auto& x2_plan = GetPlan().allocation_plan[x2_index];
+  const auto& x3_plan = GetPlan().allocation_plan[x3_index];
+  EXPECT_EQ(x2_plan.reused_buffer, x4_index);
+  EXPECT_EQ(x2_plan.reused_buffer_offset, 0u);
+  EXPECT_EQ(x3_plan.reused_buffer, x4_index);
+  EXPECT_EQ(x3_plan.reused_buffer_offset, 8 * sizeof(float));
+  EXPECT_EQ(x3_plan.reused_buffer_shape, (TensorShapeVector{4, 4}));
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
@@ -1348,6 +1437,43 @@ TEST_F(PlannerTest, MultiStream1StreamWaitFor2Streams) {
   EXPECT_NE(strstr(typeid(*GetState().GetExecutionPlan()->execution_plan[2]->steps_[4]).name(), "LaunchKernelStep"), nullptr) << "4th step: LaunchKernelStep for node 3";
 }
 
+// Test stream partition for the graph:
+// node1   node2
+//   \       /
+//    \     /
+//      node3
+// All 3 nodes are CUDA EP. With 2 streams per device, node1 and node3 are in stream0, node2 is in stream1.
+TEST_F(PlannerTest, MultiStreamIndependentBranches) {
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernel = KernelDefBuilder().SetName("Transpose").Provider(kCudaExecutionProvider).SinceVersion(1, 10).Build();
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernelAdd = KernelDefBuilder().SetName("Add").Provider(kCudaExecutionProvider).SinceVersion(1, 10).Build();
+  std::string Graph_input("Graph_input"), Arg1("Arg1"), Arg2("Arg2"), Arg3("Arg3"), node1("node1"), node2("node2"), node3("node3");
+  std::vector<onnxruntime::NodeArg*> input1{Arg(Graph_input)}, output1{Arg(Arg1)}, output2{Arg(Arg2)}, input3{Arg(Arg1), Arg(Arg2)}, output3{Arg(Arg3)};
+  AddNode(*cudaKernel, node1, input1, output1);
+  AddNode(*cudaKernel, node2, input1, output2);
+  AddNode(*cudaKernelAdd, node3, input3, output3);
+
+  CUDAExecutionProviderInfo epi;
+  onnxruntime::ProviderInfo_CUDA& ep = onnxruntime::GetProviderInfo_CUDA();
+  auto epFactory = ep.CreateExecutionProviderFactory(epi);
+  std::unique_ptr<IExecutionProvider> execution_provider = epFactory->CreateProvider();
+  ORT_THROW_IF_ERROR(GetExecutionProviders().Add("CUDAExecutionProvider", std::move(execution_provider)));
+
+  SetMaxStreamsPerDevice("2");
+  CreatePlan({}, false);
+
+  const auto* plan = GetState().GetExecutionPlan();
+  EXPECT_EQ(plan->execution_plan.size(), 2) << "2 logic streams";
+  EXPECT_EQ(plan->node_stream_map_[0], 0u) << "node1 starts stream 0";
+  EXPECT_EQ(plan->node_stream_map_[1], 1u) << "node2 is an independent branch in stream 1";
+  EXPECT_EQ(plan->node_stream_map_[2], 0u) << "node3 continues stream 0 after node1";
+  EXPECT_NE(strstr(typeid(*plan->execution_plan[0]->steps_.back()).name(), "LaunchKernelStep"), nullptr) << "last step of stream 0: LaunchKernelStep for node 3";
+  bool waits_for_stream1 = false;
+  for (const auto& step : plan->execution_plan[0]->steps_) {
+    waits_for_stream1 = waits_for_stream1 || strstr(typeid(*step).name(), "WaitOnEPStep") != nullptr;
+  }
+  EXPECT_TRUE(waits_for_stream1) << "node3 waits for the output of node2 in stream 1";
+}
+
 // Test execution plan for the graph:
 // stream 0: node1 (MemcpyToHost, CUDA EP) -> node3 (Transpose, CUDA EP)
 // stream 1: node2 (CPU EP)
@@ -1999,6 +2125,54 @@ TEST_F(PlannerTest, TestMultiStreamMismatchDevice) {
   status = sess.Initialize();
   ASSERT_TRUE(!status.IsOK());
 }
+
+// Test that in parallel execution mode the downstream steps and the streams are ordered by the estimated cost
+// of the work left on them, for the graph:
+// stream 0: node1 -> (node2 in stream 1, node3 in stream 2)
+// stream 1: node2
+// stream 2: node3 -> node4 -> node5
+TEST_F(PlannerTest, ParallelPlanCriticalPathOrder) {
+  const char* config_file_path = "./parallel_plan_critical_path_order.json";
+  {
+    std::ofstream config_file(config_file_path);
+    ASSERT_TRUE(config_file.is_open());
+    config_file << R"({"type":"DeviceBasedPartitioner",)"
+                << R"("streams":[["node1"],["node2"],["node3","node4","node5"]],)"
+                << R"("devices":["0","0","0"]})";
+  }
+
+  std::string X("X"), Y1("Y1"), Y2("Y2"), Z1("Z1"), Z2("Z2"), Z3("Z3");
+  std::string node1("node1"), node2("node2"), node3("node3"), node4("node4"), node5("node5");
+  std::vector<onnxruntime::NodeArg*> x{Arg(X)}, y1{Arg(Y1)}, y2{Arg(Y2)}, z1{Arg(Z1)}, z2{Arg(Z2)}, z3{Arg(Z3)};
+  AddNode(*GetStdKernel(), node1, x, y1);
+  AddNode(*GetStdKernel(), node2, y1, y2);
+  AddNode(*GetStdKernel(), node3, y1, z1);
+  AddNode(*GetStdKernel(), node4, z1, z2);
+  AddNode(*GetStdKernel(), node5, z2, z3);
+
+  SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+  SetNodePartitionConfigFilePath(config_file_path);
+  CreatePlan({}, false);
+
+  const auto* plan = GetState().GetExecutionPlan();
+  ASSERT_EQ(plan->execution_plan.size(), 3u);
+  EXPECT_FALSE(plan->is_single_stream_of_kernels);
+
+  // stream 0 leads to the longest chain, stream 2 has more kernels than stream 1
+  ASSERT_EQ(plan->stream_dispatch_order.size(), 3u);
+  EXPECT_EQ(plan->stream_dispatch_order[0], 0u);
+  EXPECT_EQ(plan->stream_dispatch_order[1], 2u);
+  EXPECT_EQ(plan->stream_dispatch_order[2], 1u);
+
+  // node1 triggers node3 before node2
+  ASSERT_EQ(plan->downstream_map.size(), 1u);
+  const auto& downstreams = plan->downstream_map.begin()->second;
+  ASSERT_EQ(downstreams.size(), 2u);
+  EXPECT_EQ(downstreams[0].first, 2u);
+  EXPECT_EQ(downstreams[1].first, 1u);
+
+  std::remove(config_file_path);
+}
 #endif
 
 #if defined(USE_CUDA) && defined(ORT_ENABLE_STREAM)
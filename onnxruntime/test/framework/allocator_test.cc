@@ -3,6 +3,8 @@
 #include <absl/base/config.h>
 
 #include "core/framework/allocator.h"
+#include "core/framework/numa_allocator.h"
+#include "core/platform/env.h"
 
 #include "test_utils.h"
 #include "gtest/gtest.h"
@@ -110,5 +112,27 @@ TEST(AllocatorTest, TestOverflowChecks) {
   EXPECT_TRUE(IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(num_elements, element_size - (kAllocAlignment / num_elements), &size));
   EXPECT_FALSE(IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(num_elements, element_size, &size));
 }
+
+TEST(AllocatorTest, NumaAllocatorTest) {
+  // node 0 exists wherever NUMA placement is supported. the allocator falls back to the default allocator otherwise.
+  NumaAllocator allocator(0);
+  EXPECT_STREQ(allocator.Info().name, CPU);
+  EXPECT_EQ(allocator.Info().alloc_type, OrtAllocatorType::OrtDeviceAllocator);
+
+  for (size_t size : {size_t{1}, size_t{1024}, size_t{1} << 20}) {
+    void* bytes = allocator.Alloc(size);
+    ASSERT_NE(bytes, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(bytes) % kAllocAlignment, 0u);
+    // test the bytes are ok for read/write
+    memset(bytes, -1, size);
+    allocator.Free(bytes);
+  }
+  allocator.Free(nullptr);
+
+  const auto numa_node_processors = Env::Default().GetNumaNodeProcessors();
+  if (!numa_node_processors.empty()) {
+    EXPECT_FALSE(numa_node_processors[0].empty());
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <functional>
+#include <vector>
+
+#include "core/session/async_run_queue.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(AsyncRunQueueTest, AdmitsRunsByPriority) {
+  // runs are started by the test, so it controls when they complete
+  std::vector<std::function<void()>> scheduled;
+  AsyncRunQueue queue(1, [&scheduled](std::function<void()> run) { scheduled.push_back(std::move(run)); });
+
+  std::vector<int> order;
+  queue.Submit(0, [&order]() { order.push_back(0); });
+  queue.Submit(0, [&order]() { order.push_back(1); });
+  queue.Submit(5, [&order]() { order.push_back(2); });
+  queue.Submit(0, [&order]() { order.push_back(3); });
+  queue.Submit(5, [&order]() { order.push_back(4); });
+
+  // only the first run is admitted until it completes
+  ASSERT_EQ(scheduled.size(), 1u);
+  EXPECT_EQ(queue.NumPendingRuns(), 4u);
+
+  for (size_t i = 0; i < scheduled.size(); ++i) {
+    auto run = scheduled[i];
+    run();
+  }
+
+  EXPECT_EQ(scheduled.size(), 5u);
+  EXPECT_EQ(queue.NumPendingRuns(), 0u);
+  EXPECT_EQ(order, std::vector<int>({0, 2, 4, 1, 3}));
+}
+
+TEST(AsyncRunQueueTest, AdmitsUpToTheLimit) {
+  std::vector<std::function<void()>> scheduled;
+  AsyncRunQueue queue(2, [&scheduled](std::function<void()> run) { scheduled.push_back(std::move(run)); });
+
+  for (int i = 0; i < 3; ++i) {
+    queue.Submit(0, []() {});
+  }
+
+  EXPECT_EQ(scheduled.size(), 2u);
+  EXPECT_EQ(queue.NumPendingRuns(), 1u);
+
+  auto run = scheduled[1];
+  run();
+  EXPECT_EQ(scheduled.size(), 3u);
+  EXPECT_EQ(queue.NumPendingRuns(), 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -7,6 +7,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -481,5 +483,124 @@ TEST(BFCArenaTest, TestExtendStrategy) {
   ASSERT_EQ(extend_delta_bytes, extend_limit);
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  OrtArenaCfg config(0, 0, -1, -1, -1, -1L);
+  config.thread_cache_max_bytes = 1 << 20;
+  AllocatorCreationInfo device_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  auto allocator = CreateAllocator(device_info);
+  BFCArena& a = *static_cast<BFCArena*>(allocator.get());
+
+  // a freed small chunk is reused for a request of the same size class without going back to the bins
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p1, p2);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+  a.Free(p2);
+
+  // large allocations bypass the cache
+  void* large = a.Alloc(4 * 1024 * 1024);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_use, 1024) << "only the cached 1K chunk should still be accounted as in use";
+
+  // overflowing the cache hands chunks back to the bins
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a.Alloc(128 * 1024));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_use, 1 << 20);
+
+  // Shrink flushes all caches
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             256 * 1024);
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<void*>> live(kNumThreads);
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &live, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        size_t size = 64 + ((i * 7919 + t * 104729) % (64 * 1024));
+        void* p = a.Alloc(size);
+        ASSERT_NE(p, nullptr);
+        // touch the whole buffer so that overlapping chunks would be caught by sanitizers
+        memset(p, t, size);
+        live[t].push_back(p);
+        if (live[t].size() > 8) {
+          a.Free(live[t].front());
+          live[t].erase(live[t].begin());
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // free from a different thread than the one that allocated
+  for (auto& ptrs : live) {
+    for (void* p : ptrs) {
+      a.Free(p);
+    }
+  }
+
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestHugePages) {
+  constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+  for (auto mode : {ArenaHugePageMode::kTransparent, ArenaHugePageMode::kExplicit}) {
+    BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+               BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+               BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+               BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES, mode);
+
+    constexpr size_t kSize = 3 * 1024 * 1024;
+    void* p = a.Alloc(kSize);
+    ASSERT_NE(p, nullptr);
+    memset(p, 1, kSize);
+
+    AllocatorStats stats;
+    a.GetStats(&stats);
+    // regions are rounded up to whole huge pages
+    EXPECT_EQ(stats.total_allocated_bytes % kHugePageSize, 0);
+#if defined(__linux__)
+    // huge pages may not be available, in which case the arena falls back to regular pages
+    EXPECT_TRUE(stats.huge_page_bytes == 0 || stats.huge_page_bytes == stats.total_allocated_bytes);
+#else
+    EXPECT_EQ(stats.huge_page_bytes, 0);
+#endif
+
+    a.Free(p);
+    EXPECT_EQ(a.Shrink(), Status::OK());
+    a.GetStats(&stats);
+    EXPECT_EQ(stats.total_allocated_bytes, 0);
+    EXPECT_EQ(stats.huge_page_bytes, 0);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "core/framework/data_transfer_manager.h"
+#include "core/framework/tensor.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Copies from CPU to the CPU device with the given id, and records the size of each batch it is given.
+class RecordingDataTransfer : public IDataTransfer {
+ public:
+  explicit RecordingDataTransfer(OrtDevice::DeviceId device_id) : device_id_{device_id} {}
+
+  bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override {
+    return src_device.Type() == OrtDevice::CPU && dst_device.Type() == OrtDevice::CPU &&
+           dst_device.Id() == device_id_;
+  }
+
+  Status CopyTensor(const Tensor& src, Tensor& dst) const override {
+    memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+    return Status::OK();
+  }
+
+  Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override {
+    batch_sizes.push_back(src_dst_pairs.size());
+    return IDataTransfer::CopyTensors(src_dst_pairs);
+  }
+
+  mutable std::vector<size_t> batch_sizes;
+
+ private:
+  OrtDevice::DeviceId device_id_;
+};
+}  // namespace
+
+TEST(DataTransferManagerTest, CopyTensorsBatchesPerDataTransfer) {
+  DataTransferManager manager;
+  auto transfer_to_1 = std::make_unique<RecordingDataTransfer>(1);
+  auto transfer_to_2 = std::make_unique<RecordingDataTransfer>(2);
+  const auto& batches_to_1 = transfer_to_1->batch_sizes;
+  const auto& batches_to_2 = transfer_to_2->batch_sizes;
+  ASSERT_STATUS_OK(manager.RegisterDataTransfer(std::move(transfer_to_1)));
+  ASSERT_STATUS_OK(manager.RegisterDataTransfer(std::move(transfer_to_2)));
+
+  const OrtMemoryInfo cpu_info("Cpu", OrtDeviceAllocator);
+  const OrtMemoryInfo device_1_info("Cpu", OrtDeviceAllocator, OrtDevice(OrtDevice::CPU, OrtDevice::MemType::DEFAULT, 1));
+  const OrtMemoryInfo device_2_info("Cpu", OrtDeviceAllocator, OrtDevice(OrtDevice::CPU, OrtDevice::MemType::DEFAULT, 2));
+
+  float src_data[4] = {1.f, 2.f, 3.f, 4.f};
+  float dst_data[4] = {};
+  const auto float_type = DataTypeImpl::GetType<float>();
+  std::vector<Tensor> src_tensors;
+  std::vector<Tensor> dst_tensors;
+  for (int i = 0; i < 4; ++i) {
+    src_tensors.emplace_back(float_type, TensorShape({1}), &src_data[i], cpu_info);
+    // alternate between the devices, so the pairs of each data transfer aren't next to each other
+    dst_tensors.emplace_back(float_type, TensorShape({1}), &dst_data[i], i % 2 == 0 ? device_1_info : device_2_info);
+  }
+
+  std::vector<IDataTransfer::SrcDstPair> pairs;
+  for (int i = 0; i < 4; ++i) {
+    pairs.push_back({src_tensors[i], dst_tensors[i], nullptr});
+  }
+  ASSERT_STATUS_OK(manager.CopyTensors(pairs));
+
+  EXPECT_EQ(batches_to_1, std::vector<size_t>{2});
+  EXPECT_EQ(batches_to_2, std::vector<size_t>{2});
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(dst_data[i], src_data[i]);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/framework/allocator.h"
+#include "core/framework/error_code_helper.h"
+#include "core/framework/tensor.h"
+#include "core/session/dynamic_batcher.h"
+#include "core/session/ort_apis.h"
+#include "test/test_environment.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+struct RunRecorder {
+  std::atomic<int> num_runs{0};
+  std::vector<int64_t> rows_per_run;
+  // returns a scalar output, which can't be split into the requests of a batch
+  bool scalar_output = false;
+};
+
+// Output "Y" is 2 * input "X".
+DynamicBatcher::RunFn MakeRunFn(RunRecorder& recorder, AllocatorPtr allocator) {
+  return [&recorder, allocator](gsl::span<const char* const>, gsl::span<const OrtValue* const> feeds,
+                                gsl::span<const char* const>, gsl::span<OrtValue*> fetches) {
+    const auto& x = feeds[0]->Get<Tensor>();
+    recorder.rows_per_run.push_back(x.Shape().NumDimensions() > 0 ? x.Shape()[0] : 1);
+    ++recorder.num_runs;
+
+    auto y = std::make_unique<OrtValue>();
+    const TensorShape y_shape = recorder.scalar_output ? TensorShape({}) : x.Shape();
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), y_shape, allocator, *y);
+    const auto x_data = x.DataAsSpan<float>();
+    auto y_data = y->GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    for (size_t i = 0; i < y_data.size(); ++i) {
+      y_data[i] = 2 * x_data[i];
+    }
+
+    fetches[0] = y.release();
+    return Status::OK();
+  };
+}
+
+struct Request {
+  Request(std::vector<float> x_values, const TensorShape& shape, AllocatorPtr allocator) : values(std::move(x_values)) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), shape, values.data(), allocator->Info(), x);
+    feeds[0] = &x;
+  }
+
+  ~Request() {
+    if (owns_output) {
+      delete fetches[0];
+    }
+  }
+
+  std::vector<float> values;
+  OrtValue x;
+  const char* feed_names[1] = {"X"};
+  const OrtValue* feeds[1] = {};
+  const char* fetch_names[1] = {"Y"};
+  OrtValue* fetches[1] = {};
+  // whether fetches[0] is allocated by the batcher rather than pre-allocated by the test
+  bool owns_output = true;
+
+  std::atomic<bool> called{false};
+  size_t num_outputs = 0;
+  Status status;
+};
+
+void Callback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status_ptr) {
+  auto* request = static_cast<Request*>(user_data);
+  request->num_outputs = num_outputs;
+  request->status = ToStatus(status_ptr);
+  OrtApis::ReleaseStatus(status_ptr);
+  EXPECT_EQ(outputs, request->fetches);
+  request->called = true;
+}
+
+void Enqueue(DynamicBatcher& batcher, Request& request) {
+  batcher.Enqueue(request.feed_names, request.feeds, request.fetch_names, request.fetches, Callback, &request);
+}
+
+void ExpectDoubled(const Request& request) {
+  ASSERT_TRUE(request.called);
+  ASSERT_TRUE(request.status.IsOK()) << request.status.ErrorMessage();
+  ASSERT_EQ(request.num_outputs, 1u);
+  const auto& y = request.fetches[0]->Get<Tensor>();
+  EXPECT_EQ(y.Shape(), request.x.Get<Tensor>().Shape());
+  const auto y_data = y.DataAsSpan<float>();
+  ASSERT_EQ(y_data.size(), request.values.size());
+  for (size_t i = 0; i < y_data.size(); ++i) {
+    EXPECT_EQ(y_data[i], 2 * request.values[i]);
+  }
+}
+}  // namespace
+
+TEST(DynamicBatcherTest, BatchesCompatibleRequests) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  RunRecorder recorder;
+
+  Request a({1, 2, 3, 4}, {2, 2}, allocator);
+  Request b({5, 6}, {1, 2}, allocator);
+  Request c({7, 8, 9, 10, 11, 12}, {3, 2}, allocator);
+
+  // the output of c is pre-allocated by the caller
+  float c_output[6] = {};
+  OrtValue c_y;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), {3, 2}, c_output, allocator->Info(), c_y);
+  c.fetches[0] = &c_y;
+  c.owns_output = false;
+
+  {
+    // the batch is full once all requests are queued, so it doesn't wait for max_wait.
+    DynamicBatcher batcher(6, std::chrono::seconds(60), allocator, MakeRunFn(recorder, allocator),
+                           DefaultLoggingManager().DefaultLogger());
+    Enqueue(batcher, a);
+    Enqueue(batcher, b);
+    Enqueue(batcher, c);
+  }
+
+  EXPECT_EQ(recorder.num_runs, 1);
+  EXPECT_EQ(recorder.rows_per_run, std::vector<int64_t>({6}));
+  ExpectDoubled(a);
+  ExpectDoubled(b);
+  ExpectDoubled(c);
+  EXPECT_EQ(c.fetches[0], &c_y);
+  EXPECT_EQ(c_output[5], 24.f);
+}
+
+TEST(DynamicBatcherTest, RunsIncompatibleRequestsAlone) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  RunRecorder recorder;
+
+  Request a({1, 2}, {1, 2}, allocator);
+  Request b({3, 4, 5}, {1, 3}, allocator);
+  // a scalar input has no batch dimension
+  Request c({6}, {}, allocator);
+
+  {
+    DynamicBatcher batcher(8, std::chrono::milliseconds(10), allocator, MakeRunFn(recorder, allocator),
+                           DefaultLoggingManager().DefaultLogger());
+    Enqueue(batcher, a);
+    Enqueue(batcher, b);
+    Enqueue(batcher, c);
+  }
+
+  EXPECT_EQ(recorder.num_runs, 3);
+  ExpectDoubled(a);
+  ExpectDoubled(b);
+  ExpectDoubled(c);
+}
+
+TEST(DynamicBatcherTest, FallsBackIfOutputsCantBeSplit) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  RunRecorder recorder;
+  recorder.scalar_output = true;
+
+  Request a({1, 2}, {1, 2}, allocator);
+  Request b({3, 4}, {1, 2}, allocator);
+
+  {
+    DynamicBatcher batcher(2, std::chrono::seconds(60), allocator, MakeRunFn(recorder, allocator),
+                           DefaultLoggingManager().DefaultLogger());
+    Enqueue(batcher, a);
+    Enqueue(batcher, b);
+  }
+
+  // one batched run, then each request on its own
+  EXPECT_EQ(recorder.rows_per_run, std::vector<int64_t>({2, 1, 1}));
+  for (const Request* request : {&a, &b}) {
+    ASSERT_TRUE(request->called);
+    EXPECT_TRUE(request->status.IsOK());
+    EXPECT_EQ(request->fetches[0]->Get<Tensor>().Shape(), TensorShape({}));
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -117,6 +117,21 @@ TEST_F(ExecutionFrameTest, TensorAllocationTest) {
   ASSERT_TRUE(tensor2);
   ASSERT_EQ(tensor2->Shape(), shape2);
   ASSERT_EQ(tensor2->Data<float>(), p_tensor->Data<float>());
+
+  // test the released scratch buffers are handed out again when they are large enough
+  void* scratch_data = nullptr;
+  {
+    auto scratch = frame.GetScratchBuffer(memory_info, 256);
+    ASSERT_TRUE(scratch);
+    scratch_data = scratch.get();
+    auto other_scratch = frame.GetScratchBuffer(memory_info, 64);
+    ASSERT_NE(other_scratch.get(), scratch_data);
+  }
+  {
+    auto scratch = frame.GetScratchBuffer(memory_info, 128);
+    ASSERT_EQ(scratch.get(), scratch_data);
+  }
+  ASSERT_FALSE(frame.GetScratchBuffer(memory_info, 0));
 }
 
 TEST_F(ExecutionFrameTest, OutputShapeValidationTest) {
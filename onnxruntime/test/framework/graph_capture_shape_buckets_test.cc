@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/graph_capture_shape_buckets.h"
+#include "core/session/inference_session.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Y = Relu(X) and Z = ReduceSum(X, axes=[1], keepdims=0), with X of shape [batch, sequence].
+std::string CreateModel() {
+  onnxruntime::Model model("graph_capture_shape_buckets", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("sequence");
+  ONNX_NAMESPACE::TypeProto z_type;
+  z_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  z_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &x_type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &z_type);
+  graph.AddNode("relu", "Relu", "", {&x}, {&y});
+  auto& reduce = graph.AddNode("reduce", "ReduceSum", "", {&x}, {&z});
+  reduce.AddAttribute("axes", std::vector<int64_t>{1});
+  reduce.AddAttribute("keepdims", int64_t{0});
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+void RunAndCheck(GraphCaptureShapeBuckets& buckets, int64_t batch, int64_t sequence) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<float> x_data(static_cast<size_t>(batch * sequence));
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  OrtValue x;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), {batch, sequence}, x_data.data(), allocator->Info(), x);
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y", "Z"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(buckets.Run(RunOptions(), feed_names, gsl::span<const OrtValue>(&x, 1), output_names, fetches));
+  ASSERT_EQ(fetches.size(), 2u);
+
+  const auto& y = fetches[0].Get<Tensor>();
+  const auto& z = fetches[1].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape({batch, sequence}));
+  ASSERT_EQ(z.Shape(), TensorShape({batch}));
+  for (int64_t b = 0; b < batch; ++b) {
+    float sum = 0.f;
+    for (int64_t s = 0; s < sequence; ++s) {
+      const float value = x_data[static_cast<size_t>(b * sequence + s)];
+      EXPECT_EQ(y.Data<float>()[b * sequence + s], std::max(value, 0.f));
+      sum += value;
+    }
+    EXPECT_EQ(z.Data<float>()[b], sum);
+  }
+}
+}  // namespace
+
+TEST(GraphCaptureShapeBucketsTest, ParseBuckets) {
+  GraphCaptureShapeBuckets::Buckets buckets;
+  ASSERT_STATUS_OK(GraphCaptureShapeBuckets::ParseBuckets("sequence:64,128,256;batch:1,2,4", buckets));
+  ASSERT_EQ(buckets.size(), 2u);
+  EXPECT_EQ(buckets[0].first, "sequence");
+  EXPECT_EQ(buckets[0].second, std::vector<int64_t>({64, 128, 256}));
+  EXPECT_EQ(buckets[1].first, "batch");
+  EXPECT_EQ(buckets[1].second, std::vector<int64_t>({1, 2, 4}));
+
+  EXPECT_FALSE(GraphCaptureShapeBuckets::ParseBuckets("sequence", buckets).IsOK());
+  EXPECT_FALSE(GraphCaptureShapeBuckets::ParseBuckets(":64", buckets).IsOK());
+  EXPECT_FALSE(GraphCaptureShapeBuckets::ParseBuckets("sequence:", buckets).IsOK());
+  EXPECT_FALSE(GraphCaptureShapeBuckets::ParseBuckets("sequence:128,64", buckets).IsOK());
+  EXPECT_FALSE(GraphCaptureShapeBuckets::ParseBuckets("sequence:0,64", buckets).IsOK());
+}
+
+// Graph capture is not available on the CPU EP, which ignores the graph annotations, but the inputs are padded into
+// the buffers of their bucket and the outputs cropped the same way.
+TEST(GraphCaptureShapeBucketsTest, PadsToBucketsAndCropsOutputs) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  const std::string model_data = CreateModel();
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  GraphCaptureShapeBuckets::Buckets buckets;
+  ASSERT_STATUS_OK(GraphCaptureShapeBuckets::ParseBuckets("sequence:4,8", buckets));
+  GraphCaptureShapeBuckets graph_capture(session, std::move(buckets), OrtDevice(),
+                                         std::make_shared<CPUAllocator>());
+
+  RunAndCheck(graph_capture, 2, 3);
+  EXPECT_EQ(graph_capture.NumGraphs(), 1u);
+  // same bucket, the graph and its buffers are reused
+  RunAndCheck(graph_capture, 2, 4);
+  RunAndCheck(graph_capture, 2, 1);
+  EXPECT_EQ(graph_capture.NumGraphs(), 1u);
+  RunAndCheck(graph_capture, 2, 6);
+  EXPECT_EQ(graph_capture.NumGraphs(), 2u);
+  // longer than the largest bucket, runs eagerly
+  RunAndCheck(graph_capture, 2, 9);
+  EXPECT_EQ(graph_capture.NumGraphs(), 2u);
+  // the batch isn't bucketed, so every batch size has its own graphs
+  RunAndCheck(graph_capture, 3, 5);
+  EXPECT_EQ(graph_capture.NumGraphs(), 3u);
+  RunAndCheck(graph_capture, 2, 3);
+  EXPECT_EQ(graph_capture.NumGraphs(), 3u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,7 +5,10 @@
 #include "core/session/inference_session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <chrono>
+#include <filesystem>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -19,6 +22,7 @@
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/external_data_loader.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
@@ -34,6 +38,7 @@
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_factory.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/nvtx_profile.h"
 #endif
 #ifdef USE_TENSORRT
 #include "core/providers/tensorrt/tensorrt_provider_options.h"
@@ -45,6 +50,7 @@
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/lora_adapters.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "dummy_provider.h"
@@ -496,6 +502,143 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  const std::filesystem::path cache_dir = "testdata/optimized_model_cache";
+  std::filesystem::remove_all(cache_dir);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    cache_dir.string().c_str()));
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+
+  auto initialize_session = [&](const SessionOptions& session_options) {
+    InferenceSessionWrapper session_object{session_options, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+  };
+  auto cache_entries = [&]() {
+    std::vector<std::filesystem::path> entries;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+      entries.push_back(entry.path());
+    }
+    return entries;
+  };
+
+  // the first session optimizes the model and adds it to the cache
+  initialize_session(so);
+  const auto entries = cache_entries();
+  ASSERT_EQ(entries.size(), 1u);
+  const auto entry = entries[0];
+  ASSERT_EQ(entry.extension(), ".ort");
+  const auto entry_time = std::filesystem::last_write_time(entry);
+  const auto entry_size = std::filesystem::file_size(entry);
+
+  // a session with the same key loads the entry and leaves it as is
+  initialize_session(so);
+  ASSERT_EQ(cache_entries().size(), 1u);
+  ASSERT_EQ(std::filesystem::last_write_time(entry), entry_time);
+
+  // a corrupted entry is replaced
+  {
+    std::ofstream corrupted(entry, std::ios::binary | std::ios::trunc);
+    corrupted << "not an ORT format model";
+  }
+  initialize_session(so);
+  ASSERT_EQ(std::filesystem::file_size(entry), entry_size);
+
+  // other optimization options use another entry
+  so.graph_optimization_level = TransformerLevel::Level2;
+  initialize_session(so);
+  ASSERT_EQ(cache_entries().size(), 2u);
+
+  std::filesystem::remove_all(cache_dir);
+}
+
+// Y = Abs(Concat(Relu(X + X), Neg(X), X * X)) along axis 1, with X of shape {1, 4}. All shapes are static, so the
+// allocation planner can produce the inputs of the Concat in their place in its output.
+static std::unique_ptr<Model> CreateChainIntoConcatModel() {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  auto model = std::make_unique<Model>("test", false, ModelMetaData(), PathString(),
+                                       IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                       model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto arg = [&graph, &tensor_float](const std::string& name) {
+    return &graph.GetOrCreateNodeArg(name, &tensor_float);
+  };
+
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  graph.AddNode("add", "Add", "X + X", {&x, &x}, {arg("doubled")});
+  graph.AddNode("relu", "Relu", "Relu", {arg("doubled")}, {arg("relu")});
+  graph.AddNode("neg", "Neg", "Neg", {&x}, {arg("neg")});
+  graph.AddNode("mul", "Mul", "X * X", {&x, &x}, {arg("square")});
+  graph.AddNode("concat", "Concat", "Concat", {arg("relu"), arg("neg"), arg("square")}, {arg("concat")})
+      .AddAttribute("axis", int64_t{1});
+  graph.AddNode("abs", "Abs", "Abs", {arg("concat")}, {arg("Y")});
+  ORT_ENFORCE(graph.Resolve().IsOK());
+  return model;
+}
+
+// The inputs of a Concat produced in its output buffer give the same output as with memory reuse disabled.
+TEST(InferenceSessionTests, ConcatInputsInOutputBuffer) {
+  std::string model_bytes;
+  ASSERT_TRUE(CreateChainIntoConcatModel()->ToProto().SerializeToString(&model_bytes));
+
+  const std::vector<float> x{-2.0f, -0.5f, 1.0f, 3.0f};
+  std::vector<float> expected_values;
+  for (float v : x) {
+    expected_values.push_back(std::max(v + v, 0.0f));
+  }
+  for (float v : x) {
+    expected_values.push_back(std::abs(-v));
+  }
+  for (float v : x) {
+    expected_values.push_back(v * v);
+  }
+
+  for (bool enable_mem_reuse : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ConcatInputsInOutputBuffer";
+    so.graph_optimization_level = TransformerLevel::Default;
+    so.enable_mem_reuse = enable_mem_reuse;
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_bytes.data(), static_cast<int>(model_bytes.size())));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+#ifndef ENABLE_TRAINING
+    const auto& allocation_plan = session_object.GetSessionState().GetExecutionPlan()->allocation_plan;
+    const auto num_sub_buffers = std::count_if(allocation_plan.begin(), allocation_plan.end(),
+                                               [](const AllocPlanPerValue& value_plan) {
+                                                 return value_plan.alloc_kind == AllocKind::kReuseSubBuffer;
+                                               });
+    EXPECT_EQ(num_sub_buffers, enable_mem_reuse ? 3 : 0);
+#endif
+
+    auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+    OrtValue x_value;
+    CreateMLValue<float>(cpu_allocator, {1, 4}, x, &x_value);
+    NameMLValMap feeds{{"X", x_value}};
+    std::vector<std::string> output_names{"Y"};
+    // the second run uses the memory pattern of the first one
+    for (int run = 0; run < 2; ++run) {
+      std::vector<OrtValue> fetches;
+      ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &fetches));
+      VerifyOutputs(fetches, {1, 12}, expected_values);
+    }
+  }
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -741,6 +884,148 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions2) {
 #endif
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithMemoryTimeline) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithMemoryTimeline";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_memory_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfileMemory, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+
+  bool has_live_tensor_counter = false;
+  bool has_allocator_counter = false;
+  bool has_memory_peak = false;
+  while (std::getline(profile, line)) {
+    const bool is_counter = line.find(R"("ph" : "C")") != string::npos;
+    has_live_tensor_counter = has_live_tensor_counter || (is_counter && line.find("live_tensor_bytes") != string::npos);
+    has_allocator_counter = has_allocator_counter || (is_counter && line.find("allocator_bytes_in_use") != string::npos);
+    if (line.find(R"("name" :"memory_peak")") != string::npos) {
+      has_memory_peak = true;
+      // input X and output Y of the Mul node, 6 floats each
+      EXPECT_NE(line.find(R"("peak_bytes" : "48")"), string::npos) << line;
+      EXPECT_NE(line.find(R"({"name":"Y")"), string::npos) << line;
+    }
+  }
+
+  ASSERT_TRUE(has_live_tensor_counter);
+  ASSERT_TRUE(has_allocator_counter);
+  ASSERT_TRUE(has_memory_peak);
+}
+
+#ifdef USE_CUDA
+TEST(InferenceSessionTests, CheckRunProfilerWithNvtxRanges) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithNvtxRanges";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_nvtx_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableNvtxRanges, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_TRUE(profile::IsNvtxRangesEnabled());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+  // the ranges are process wide, don't leave them enabled for the other tests
+  profile::EnableNvtxRanges(false);
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+
+  bool has_model_run_correlation_id = false;
+  bool has_node_correlation_id = false;
+  while (std::getline(profile, line)) {
+    const bool has_correlation_id = line.find(R"("correlation_id" : ")") != string::npos;
+    if (line.find(R"("name" :"model_run")") != string::npos) {
+      has_model_run_correlation_id = has_correlation_id;
+    } else if (line.find("_kernel_time") != string::npos) {
+      has_node_correlation_id = has_node_correlation_id || has_correlation_id;
+    }
+  }
+
+  ASSERT_TRUE(has_model_run_correlation_id);
+  ASSERT_TRUE(has_node_correlation_id);
+}
+#endif
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(InferenceSessionTests, ReportRunAllocations) {
+  SessionOptions so;
+
+  so.session_logid = "ReportRunAllocations";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableMetrics, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigReportAllocations, "1"));
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  std::string metrics;
+  ASSERT_STATUS_OK(session_object.GetMetrics(metrics));
+  // only the runs with the run option are reported, they allocate at least the output Y of 6 floats
+  EXPECT_NE(metrics.find(R"("run_allocations":{)"), string::npos) << metrics;
+  EXPECT_NE(metrics.find(R"("num_runs":2)"), string::npos) << metrics;
+  EXPECT_EQ(metrics.find(R"("max_peak_bytes":0)"), string::npos) << metrics;
+}
+#endif
+
+TEST(InferenceSessionTests, CheckRunProfilerSampled) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerSampled";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfilingSampleEveryNRuns, "2"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<std::string> traces;
+  session_object.SetProfilingSampleCallback([&traces](const std::string& trace_json, int64_t run_duration_us) {
+    EXPECT_GE(run_duration_us, 0);
+    traces.push_back(trace_json);
+  });
+
+  RunOptions run_options;
+  for (int i = 0; i < 4; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // the 1st and the 3rd run are sampled, each with its own events
+  ASSERT_EQ(traces.size(), size_t{2});
+  for (const auto& trace : traces) {
+    EXPECT_EQ(trace.front(), '[');
+    EXPECT_NE(trace.find("model_run"), string::npos) << trace;
+    EXPECT_NE(trace.find("_kernel_time"), string::npos) << trace;
+    EXPECT_EQ(trace.find("model_run"), trace.rfind("model_run")) << trace;
+  }
+
+  // outside of a run the profiler is not enabled and no file is written
+  EXPECT_FALSE(session_object.GetProfiling().IsEnabled());
+  EXPECT_TRUE(session_object.EndProfiling().empty());
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -1073,6 +1358,663 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestBindOutputToAllocator) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestBindOutputToAllocator";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &ml_value);
+  ASSERT_STATUS_OK(io_binding->BindInput("X", ml_value));
+
+  // the output is written into the slots of a ring buffer in turn
+  constexpr size_t num_slots = 2;
+  constexpr size_t slot_size = 6;
+  std::vector<float> ring_buffer(num_slots * slot_size);
+  size_t next_slot = 0;
+  ASSERT_STATUS_OK(io_binding->BindOutput(
+      "Y", [&](const TensorShape& shape, MLDataType element_type, const OrtMemoryInfo& location, OrtValue& value) {
+        EXPECT_EQ(shape, TensorShape(dims_mul_x));
+        EXPECT_EQ(element_type, DataTypeImpl::GetType<float>());
+        float* slot = ring_buffer.data() + (next_slot++ % num_slots) * slot_size;
+        Tensor::InitOrtValue(element_type, shape, slot, location, value);
+        return Status::OK();
+      }));
+
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  for (size_t run = 0; run < 3; ++run) {
+    ASSERT_STATUS_OK(session_object.Run(*io_binding));
+    const auto& outputs = io_binding->GetOutputs();
+    ASSERT_EQ(outputs.size(), 1u);
+    EXPECT_EQ(outputs[0].Get<Tensor>().Data<float>(), ring_buffer.data() + (run % num_slots) * slot_size);
+    VerifyOutputs(outputs, {3, 2}, expected_values_mul_y);
+  }
+
+  // binding a value replaces the allocator
+  OrtValue output;
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y", output));
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  EXPECT_EQ(next_slot, 3u);
+  VerifyOutputs(io_binding->GetOutputs(), {3, 2}, expected_values_mul_y);
+
+  ASSERT_FALSE(io_binding->BindOutput("Z", [](const TensorShape&, MLDataType, const OrtMemoryInfo&, OrtValue&) {
+                            return Status::OK();
+                          }).IsOK());
+}
+
+TEST(InferenceSessionTests, TestUpdateInitializers) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& weight_arg = graph.GetOrCreateNodeArg("W", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "MatMul", "MatMul", {&input_arg, &weight_arg}, {&output_arg});
+
+  ONNX_NAMESPACE::TensorProto weight;
+  weight.set_name("W");
+  weight.add_dims(2);
+  weight.add_dims(2);
+  weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (float v : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    weight.add_float_data(v);
+  }
+  graph.AddInitializedTensor(weight);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestUpdateInitializers";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue identity;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {1.0f, 0.0f, 0.0f, 1.0f}, &identity);
+  NameMLValMap feeds{{"A", identity}};
+  std::vector<std::string> output_names{"Y"};
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+
+  OrtValue new_weight;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &new_weight);
+  std::vector<std::string> names{"W"};
+  std::vector<OrtValue> values{new_weight};
+  ASSERT_STATUS_OK(session_object.UpdateInitializers(names, values));
+
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f});
+
+  // the type and shape have to match the current value
+  OrtValue wrong_shape;
+  CreateMLValue<float>(cpu_allocator, {4}, {1.0f, 2.0f, 3.0f, 4.0f}, &wrong_shape);
+  values = {wrong_shape};
+  ASSERT_FALSE(session_object.UpdateInitializers(names, values).IsOK());
+
+  names = {"unknown"};
+  values = {new_weight};
+  ASSERT_FALSE(session_object.UpdateInitializers(names, values).IsOK());
+}
+
+// Y = A + W, with the 2x2 initializer W = {1, 2, 3, 4}. Add doesn't pre-pack, so W stays an initializer.
+static std::unique_ptr<Model> CreateAddWeightModel() {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  auto model = std::make_unique<Model>("test", false, ModelMetaData(), PathString(),
+                                       IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                       model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& weight_arg = graph.GetOrCreateNodeArg("W", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "Add", "Add", {&input_arg, &weight_arg}, {&output_arg});
+
+  ONNX_NAMESPACE::TensorProto weight;
+  weight.set_name("W");
+  weight.add_dims(2);
+  weight.add_dims(2);
+  weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (float v : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    weight.add_float_data(v);
+  }
+  graph.AddInitializedTensor(weight);
+  ORT_ENFORCE(graph.Resolve().IsOK());
+  return model;
+}
+
+static void RunAddWeightModel(InferenceSession& session_object, const std::vector<float>& expected_values) {
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue zeros;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {0.0f, 0.0f, 0.0f, 0.0f}, &zeros);
+  NameMLValMap feeds{{"A", zeros}};
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &fetches));
+  VerifyOutputs(fetches, {2, 2}, expected_values);
+}
+
+static std::string ReadFileBytes(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// The initializer is backed by the external data file, which must not be written.
+TEST(InferenceSessionTests, TestUpdateInitializersWithExternalData) {
+  const std::filesystem::path model_path = ORT_TSTR("update_initializers_external_data.onnx");
+  const std::filesystem::path data_path = ORT_TSTR("update_initializers_external_data.bin");
+  auto model = CreateAddWeightModel();
+  ASSERT_STATUS_OK(Model::SaveWithExternalInitializers(*model, model_path, data_path, 0));
+  const std::string data_before = ReadFileBytes(data_path);
+  ASSERT_FALSE(data_before.empty());
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestUpdateInitializersWithExternalData";
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_path.native()));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    RunAddWeightModel(session_object, {1.0f, 2.0f, 3.0f, 4.0f});
+
+    auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+    OrtValue new_weight;
+    CreateMLValue<float>(cpu_allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &new_weight);
+    std::vector<std::string> names{"W"};
+    std::vector<OrtValue> values{new_weight};
+    ASSERT_STATUS_OK(session_object.UpdateInitializers(names, values));
+    RunAddWeightModel(session_object, {5.0f, 6.0f, 7.0f, 8.0f});
+  }
+
+  EXPECT_EQ(ReadFileBytes(data_path), data_before);
+  std::filesystem::remove(model_path);
+  std::filesystem::remove(data_path);
+}
+
+// The optimized model holds the values of the external data, so a modified external data file uses another entry.
+TEST(InferenceSessionTests, OptimizedModelCacheWithExternalData) {
+  const std::filesystem::path cache_dir = "testdata/optimized_model_cache_external_data";
+  const std::filesystem::path model_path = ORT_TSTR("optimized_model_cache_external_data.onnx");
+  const std::filesystem::path data_path = ORT_TSTR("optimized_model_cache_external_data.bin");
+  std::filesystem::remove_all(cache_dir);
+  auto model = CreateAddWeightModel();
+  ASSERT_STATUS_OK(Model::SaveWithExternalInitializers(*model, model_path, data_path, 0));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCacheWithExternalData";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    cache_dir.string().c_str()));
+  auto run_session = [&](const std::vector<float>& expected_values) {
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(model_path.native()));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    RunAddWeightModel(session_object, expected_values);
+  };
+  auto cache_entry_count = [&]() {
+    return std::distance(std::filesystem::directory_iterator(cache_dir), std::filesystem::directory_iterator{});
+  };
+
+  run_session({1.0f, 2.0f, 3.0f, 4.0f});
+  run_session({1.0f, 2.0f, 3.0f, 4.0f});
+  ASSERT_EQ(cache_entry_count(), 1);
+
+  // modify W in place, which leaves the model file as is
+  const float old_weight[] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const float new_weight[] = {5.0f, 6.0f, 7.0f, 8.0f};
+  std::string data = ReadFileBytes(data_path);
+  const auto weight_offset = data.find(std::string(reinterpret_cast<const char*>(old_weight), sizeof(old_weight)));
+  ASSERT_NE(weight_offset, std::string::npos);
+  data.replace(weight_offset, sizeof(new_weight), reinterpret_cast<const char*>(new_weight), sizeof(new_weight));
+  const auto data_time = std::filesystem::last_write_time(data_path);
+  {
+    std::ofstream data_file(data_path, std::ios::binary | std::ios::trunc);
+    data_file << data;
+  }
+  std::filesystem::last_write_time(data_path, data_time + std::chrono::seconds(1));
+
+  run_session({5.0f, 6.0f, 7.0f, 8.0f});
+  ASSERT_EQ(cache_entry_count(), 2);
+
+  std::filesystem::remove_all(cache_dir);
+  std::filesystem::remove(model_path);
+  std::filesystem::remove(data_path);
+}
+
+// The memory of an initializer added to the session options is the caller's, and is left as it is.
+// Reads external data into CPU tensors from any number of threads at once, so the session loads the initializers
+// in parallel when kOrtSessionOptionsConfigParallelInitializerLoading is set.
+class ConcurrentCpuExternalDataLoader : public IExternalDataLoader {
+ public:
+  explicit ConcurrentCpuExternalDataLoader(std::atomic<int>& num_loads) : num_loads_(num_loads) {}
+
+  bool CanLoad(const OrtMemoryInfo& target_memory_info) const override {
+    return target_memory_info.device.Type() == OrtDevice::CPU;
+  }
+
+  bool SupportsConcurrentLoads() const override { return true; }
+
+  common::Status LoadTensor(const Env& /*env*/, const std::filesystem::path& data_file_path,
+                            FileOffsetType data_offset, SafeInt<size_t> data_length, Tensor& tensor) const override {
+    ORT_RETURN_IF_NOT(static_cast<size_t>(data_length) == tensor.SizeInBytes(), "Unexpected external data length.");
+    std::ifstream file(data_file_path, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(data_offset));
+    file.read(static_cast<char*>(tensor.MutableDataRaw()), static_cast<std::streamsize>(tensor.SizeInBytes()));
+    ORT_RETURN_IF_NOT(file.good(), "Failed to read external data from ", data_file_path);
+    ++num_loads_;
+    return Status::OK();
+  }
+
+ private:
+  std::atomic<int>& num_loads_;
+};
+
+class ConcurrentLoadCpuExecutionProvider : public CPUExecutionProvider {
+ public:
+  explicit ConcurrentLoadCpuExecutionProvider(std::atomic<int>& num_loads)
+      : CPUExecutionProvider(CPUExecutionProviderInfo{false}), num_loads_(num_loads) {}
+
+  std::unique_ptr<IExternalDataLoader> GetExternalDataLoader() const override {
+    return std::make_unique<ConcurrentCpuExternalDataLoader>(num_loads_);
+  }
+
+ private:
+  std::atomic<int>& num_loads_;
+};
+
+// The initializers loaded in parallel have the same values as the ones loaded one after another.
+TEST(InferenceSessionTests, ParallelInitializerLoading) {
+  constexpr int kNumWeights = 16;
+  const std::filesystem::path model_path = ORT_TSTR("parallel_initializer_loading.onnx");
+  const std::filesystem::path data_path = ORT_TSTR("parallel_initializer_loading.bin");
+
+  // Y = Sum(A, W0, ..., W15), with 4x4 initializers of distinct values
+  {
+    std::unordered_map<std::string, int> domain_to_version;
+    domain_to_version[onnxruntime::kOnnxDomain] = 13;
+    std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+    Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                model_specific_functions, DefaultLoggingManager().DefaultLogger());
+    onnxruntime::Graph& graph = model.MainGraph();
+    TypeProto tensor_float;
+    tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    std::vector<onnxruntime::NodeArg*> inputs{&graph.GetOrCreateNodeArg("A", &tensor_float)};
+    for (int i = 0; i < kNumWeights; ++i) {
+      ONNX_NAMESPACE::TensorProto weight;
+      weight.set_name("W" + std::to_string(i));
+      weight.add_dims(4);
+      weight.add_dims(4);
+      weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      for (int j = 0; j < 16; ++j) {
+        weight.add_float_data(static_cast<float>(i * 16 + j));
+      }
+      graph.AddInitializedTensor(weight);
+      inputs.push_back(&graph.GetOrCreateNodeArg(weight.name(), &tensor_float));
+    }
+    graph.AddNode("sum", "Sum", "Sum", inputs, {&graph.GetOrCreateNodeArg("Y", &tensor_float)});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(Model::SaveWithExternalInitializers(model, model_path, data_path, 0));
+  }
+
+  auto load_session = [&](bool parallel, std::map<std::string, std::vector<float>>& weights,
+                          std::vector<float>& output) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ParallelInitializerLoading";
+    so.graph_optimization_level = TransformerLevel::Default;
+    so.intra_op_param.thread_pool_size = 4;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelInitializerLoading,
+                                                      parallel ? "1" : "0"));
+    std::atomic<int> num_loads{0};
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(
+        std::make_unique<ConcurrentLoadCpuExecutionProvider>(num_loads)));
+    ASSERT_STATUS_OK(session_object.Load(model_path.native()));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    EXPECT_EQ(num_loads.load(), kNumWeights);
+
+    const auto& session_state = session_object.GetSessionState();
+    for (const auto& [ort_value_index, value] : session_state.GetInitializedTensors()) {
+      std::string name;
+      ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetName(ort_value_index, name));
+      const auto& tensor = value.Get<Tensor>();
+      weights[name].assign(tensor.Data<float>(), tensor.Data<float>() + tensor.Shape().Size());
+    }
+
+    auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+    OrtValue zeros;
+    CreateMLValue<float>(cpu_allocator, {4, 4}, std::vector<float>(16, 0.0f), &zeros);
+    NameMLValMap feeds{{"A", zeros}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &fetches));
+    const auto& y = fetches[0].Get<Tensor>();
+    output.assign(y.Data<float>(), y.Data<float>() + y.Shape().Size());
+  };
+
+  std::map<std::string, std::vector<float>> serial_weights, parallel_weights;
+  std::vector<float> serial_output, parallel_output;
+  load_session(false, serial_weights, serial_output);
+  load_session(true, parallel_weights, parallel_output);
+
+  ASSERT_EQ(serial_weights.size(), static_cast<size_t>(kNumWeights));
+  for (int i = 0; i < kNumWeights; ++i) {
+    const auto& weight = serial_weights["W" + std::to_string(i)];
+    ASSERT_EQ(weight.size(), 16u);
+    for (int j = 0; j < 16; ++j) {
+      EXPECT_EQ(weight[j], static_cast<float>(i * 16 + j));
+    }
+  }
+  EXPECT_EQ(parallel_weights, serial_weights);
+  EXPECT_EQ(parallel_output, serial_output);
+
+  std::filesystem::remove(model_path);
+  std::filesystem::remove(data_path);
+}
+
+TEST(InferenceSessionTests, TestUpdateInitializersOwnedByCaller) {
+  auto model = CreateAddWeightModel();
+  std::string model_data;
+  model->ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  std::vector<float> caller_data{10.0f, 20.0f, 30.0f, 40.0f};
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue caller_weight;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({2, 2}), caller_data.data(),
+                       cpu_allocator->Info(), caller_weight);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestUpdateInitializersOwnedByCaller";
+  ASSERT_STATUS_OK(so.AddInitializer("W", &caller_weight));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  RunAddWeightModel(session_object, {10.0f, 20.0f, 30.0f, 40.0f});
+
+  OrtValue new_weight;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &new_weight);
+  std::vector<std::string> names{"W"};
+  std::vector<OrtValue> values{new_weight};
+  ASSERT_FALSE(session_object.UpdateInitializers(names, values).IsOK());
+  EXPECT_THAT(caller_data, ::testing::ElementsAre(10.0f, 20.0f, 30.0f, 40.0f));
+  RunAddWeightModel(session_object, {10.0f, 20.0f, 30.0f, 40.0f});
+}
+
+// An update would change every session that shares the session state.
+TEST(InferenceSessionTests, TestUpdateInitializersOfClonedSession) {
+  auto model = CreateAddWeightModel();
+  std::string model_data;
+  model->ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestUpdateInitializersOfClonedSession";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue new_weight;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &new_weight);
+  std::vector<std::string> names{"W"};
+  std::vector<OrtValue> values{new_weight};
+
+  std::unique_ptr<InferenceSession> clone;
+  ASSERT_STATUS_OK(session_object.Clone(so, clone));
+  ASSERT_FALSE(session_object.UpdateInitializers(names, values).IsOK());
+  ASSERT_FALSE(clone->UpdateInitializers(names, values).IsOK());
+  RunAddWeightModel(*clone, {1.0f, 2.0f, 3.0f, 4.0f});
+
+  clone.reset();
+  ASSERT_STATUS_OK(session_object.UpdateInitializers(names, values));
+  RunAddWeightModel(session_object, {5.0f, 6.0f, 7.0f, 8.0f});
+}
+
+TEST(InferenceSessionTests, TestIOBindingState) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIOBindingState";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+  ASSERT_STATUS_OK(io_binding->BindState("X", "Y"));
+  ASSERT_FALSE(io_binding->BindState("X", "Y").IsOK());
+  ASSERT_FALSE(io_binding->BindState("Y", "X").IsOK());
+
+  // the initial state must be bound
+  ASSERT_FALSE(session_object.Run(*io_binding).IsOK());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue initial_state;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &initial_state);
+  ASSERT_STATUS_OK(io_binding->BindInput("X", initial_state));
+
+  // every run gets the output of the previous run as its input, which matches a run fed with that value
+  std::vector<const float*> buffers;
+  for (size_t run = 0; run < 4; ++run) {
+    NameMLValMap feeds{{"X", io_binding->GetInputs()[0]}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> expected;
+    ASSERT_STATUS_OK(session_object.Run(feeds, output_names, &expected));
+
+    ASSERT_STATUS_OK(session_object.Run(*io_binding));
+    const auto& outputs = io_binding->GetOutputs();
+    ASSERT_EQ(outputs.size(), 1u);
+    const float* output_data = outputs[0].Get<Tensor>().Data<float>();
+    EXPECT_EQ(io_binding->GetInputs()[0].Get<Tensor>().Data<float>(), output_data);
+    const auto& expected_tensor = expected[0].Get<Tensor>();
+    const auto expected_dims = expected_tensor.Shape().GetDims();
+    const auto expected_values = expected_tensor.DataAsSpan<float>();
+    VerifyOutputs(outputs, std::vector<int64_t>(expected_dims.begin(), expected_dims.end()),
+                  std::vector<float>(expected_values.begin(), expected_values.end()));
+    buffers.push_back(output_data);
+  }
+
+  // the initial state is not overwritten, and the state alternates between two buffers from the third run
+  EXPECT_EQ(initial_state.Get<Tensor>().Data<float>()[5], 6.0f);
+  EXPECT_EQ(buffers[2], buffers[0]);
+  EXPECT_EQ(buffers[3], buffers[1]);
+
+  // binding the input again restarts the stream
+  ASSERT_STATUS_OK(io_binding->BindInput("X", initial_state));
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  VerifyOutputs(io_binding->GetOutputs(), {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+}
+
+TEST(InferenceSessionTests, TestPreparedRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestPreparedRun";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<std::string> feed_names{"X"};
+  std::vector<std::string> output_names{"Y"};
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+  ASSERT_FALSE(session_object.PrepareRun(feed_names, std::vector<std::string>{"Z"}, feeds_fetches_manager).IsOK());
+  ASSERT_FALSE(session_object.PrepareRun(std::vector<std::string>{"Z"}, output_names, feeds_fetches_manager).IsOK());
+  ASSERT_STATUS_OK(session_object.PrepareRun(feed_names, output_names, feeds_fetches_manager));
+
+  // the prepared names are reused by every run, with new values
+  RunOptions run_options;
+  for (float scale : {1.0f, 2.0f, 3.0f}) {
+    std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    for (auto& value : values_mul_x) {
+      value *= scale;
+    }
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2}, values_mul_x,
+                         &ml_value);
+
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, *feeds_fetches_manager, AsSpan({ml_value}), &fetches));
+
+    std::vector<float> expected_values;
+    for (auto value : values_mul_x) {
+      expected_values.push_back(value * value);
+    }
+    VerifyOutputs(fetches, {3, 2}, expected_values);
+  }
+
+  // the values are still validated on each run
+  OrtValue wrong_shape;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f},
+                       &wrong_shape);
+  std::vector<OrtValue> fetches;
+  ASSERT_FALSE(session_object.Run(run_options, *feeds_fetches_manager, AsSpan({wrong_shape}), &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, TestWarmUp) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestWarmUp";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+
+  RunOptions run_options;
+  std::vector<int64_t> run_durations_us;
+  InlinedHashMap<std::string, TensorShapeVector> input_shapes{{"X", {3, 2}}};
+  ASSERT_FALSE(session_object.WarmUp(run_options, input_shapes, 2, run_durations_us).IsOK());
+
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_STATUS_OK(session_object.WarmUp(run_options, input_shapes, 2, run_durations_us));
+  ASSERT_EQ(run_durations_us.size(), 2u);
+  for (auto duration : run_durations_us) {
+    EXPECT_GE(duration, 0);
+  }
+
+  InlinedHashMap<std::string, TensorShapeVector> invalid_shapes{{"Z", {3, 2}}};
+  ASSERT_FALSE(session_object.WarmUp(run_options, invalid_shapes, 1, run_durations_us).IsOK());
+}
+
+TEST(InferenceSessionTests, TestLoraAdapter) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  // the adapter parameter W is an input of the model
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& weight_arg = graph.GetOrCreateNodeArg("W", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "MatMul", "MatMul", {&input_arg, &weight_arg}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  ONNX_NAMESPACE::ModelProto adapter_proto;
+  auto* weight = adapter_proto.mutable_graph()->add_initializer();
+  weight->set_name("W");
+  weight->add_dims(2);
+  weight->add_dims(2);
+  weight->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (float v : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    weight->add_float_data(v);
+  }
+
+  const auto adapter_path = std::filesystem::temp_directory_path() / "ort_test_lora_adapter.onnx";
+  {
+    std::ofstream adapter_file(adapter_path, std::ios::binary);
+    ASSERT_TRUE(adapter_proto.SerializeToOstream(&adapter_file));
+  }
+  lora::LoraAdapter adapter;
+  ASSERT_STATUS_OK(adapter.Load(adapter_path));
+  std::filesystem::remove(adapter_path);
+  ASSERT_EQ(adapter.Parameters().size(), 1u);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestLoraAdapter";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue identity;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {1.0f, 0.0f, 0.0f, 1.0f}, &identity);
+  std::vector<std::string> output_names{"Y"};
+
+  RunOptions run_options;
+  run_options.active_lora_adapters.push_back(&adapter);
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{{"A", identity}}, output_names, &fetches));
+  VerifyOutputs(fetches, {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+
+  // an input fed by the caller takes precedence over the adapter
+  OrtValue other_weight;
+  CreateMLValue<float>(cpu_allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &other_weight);
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{{"A", identity}, {"W", other_weight}}, output_names,
+                                      &fetches));
+  VerifyOutputs(fetches, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f});
+
+  // without the adapter the input is missing
+  fetches.clear();
+  ASSERT_FALSE(session_object.Run(RunOptions{}, NameMLValMap{{"A", identity}}, output_names, &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, TestRecordInputs) {
+  const auto record_dir = std::filesystem::temp_directory_path() / "ort_test_record_inputs";
+  std::filesystem::remove_all(record_dir);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestRecordInputs";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsRecordInputsDirectory,
+                                                    record_dir.string().c_str()));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsRecordInputsEveryNRuns, "2"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsRecordInputsMaxSamples, "2"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  for (int run = 0; run < 6; ++run) {
+    RunModel(session_object, run_options);
+  }
+
+  // runs 0 and 2 are recorded, run 4 is over the max number of samples
+  ASSERT_TRUE(std::filesystem::exists(record_dir / "test_data_set_0" / "input_0.pb"));
+  ASSERT_TRUE(std::filesystem::exists(record_dir / "test_data_set_1" / "input_0.pb"));
+  ASSERT_FALSE(std::filesystem::exists(record_dir / "test_data_set_2"));
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  std::ifstream file(record_dir / "test_data_set_0" / "input_0.pb", std::ios::binary);
+  ASSERT_TRUE(tensor_proto.ParseFromIstream(&file));
+  EXPECT_EQ(tensor_proto.name(), "X");
+  EXPECT_EQ(utils::GetTensorShapeFromTensorProto(tensor_proto), TensorShape({3, 2}));
+
+  file.close();
+  std::filesystem::remove_all(record_dir);
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -2120,6 +3062,113 @@ TEST(InferenceSessionTests, DISABLED_TestParallelExecutionWithCudaProvider) {
   ASSERT_TRUE(so_queried.execution_mode == ExecutionMode::ORT_SEQUENTIAL);
 }
 
+TEST(InferenceSessionTests, StageCopiesInPinnedMemory) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StageCopiesInPinnedMemory";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStageCopiesInPinnedMemory, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+  std::string model_data;
+  p_model->ToProto().SerializeToString(&model_data);
+  std::stringstream sstr(model_data);
+  ASSERT_STATUS_OK(session_object.Load(sstr));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // large enough for the copies to be staged, uploaded in several chunks
+  const int64_t dim = 1024;
+  std::vector<float> values_a(static_cast<size_t>(dim * dim));
+  std::vector<float> values_b(static_cast<size_t>(dim * dim), 0.f);
+  std::vector<float> expected_values_y(values_a.size());
+  for (int64_t i = 0; i < dim * dim; ++i) {
+    values_a[i] = static_cast<float>(i % 7);
+    expected_values_y[i] = 2.f * values_a[i];
+  }
+  for (int64_t i = 0; i < dim; ++i) {
+    values_b[i * dim + i] = 2.f;
+  }
+
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue a;
+  OrtValue b;
+  CreateMLValue<float>(cpu_allocator, {dim, dim}, values_a, &a);
+  CreateMLValue<float>(cpu_allocator, {dim, dim}, values_b, &b);
+  NameMLValMap feeds{{"A", a}, {"B", b}};
+  std::vector<std::string> output_names{"Y"};
+
+  // the second run reuses the pinned buffers, and writes to a pre-allocated output
+  for (bool preallocate_output : {false, true}) {
+    std::vector<OrtValue> fetches;
+    if (preallocate_output) {
+      fetches.resize(1);
+      CreateMLValue<float>(cpu_allocator, {dim, dim}, std::vector<float>(values_a.size()), &fetches[0]);
+    }
+    ASSERT_STATUS_OK(session_object.Run(RunOptions(), feeds, output_names, &fetches));
+    ASSERT_EQ(fetches[0].Get<Tensor>().Location().device, OrtDevice());
+    VerifyOutputs(fetches, {dim, dim}, expected_values_y);
+  }
+}
+
+TEST(InferenceSessionTests, TuningResultsCache) {
+  const std::filesystem::path cache_dir = "testdata/tuning_results_cache";
+  std::filesystem::remove_all(cache_dir);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TuningResultsCache";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigTuningResultsCacheDir,
+                                                    cache_dir.string().c_str()));
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+  std::string model_data;
+  p_model->ToProto().SerializeToString(&model_data);
+
+  auto initialize_session = [&](InferenceSession& session_object) {
+    ASSERT_STATUS_OK(session_object.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+    std::stringstream sstr(model_data);
+    ASSERT_STATUS_OK(session_object.Load(sstr));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  };
+  auto find_cuda_results = [](auto& trs) {
+    auto it = std::find_if(trs.begin(), trs.end(), [](const TuningResults& tr) {
+      return tr.ep == kCudaExecutionProvider;
+    });
+    return it == trs.end() ? nullptr : &*it;
+  };
+
+  // the results of a session are saved when it is destroyed
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    initialize_session(session_object);
+    auto trs = session_object.GetTuningResults();
+    auto* tr = find_cuda_results(trs);
+    ASSERT_NE(tr, nullptr);
+    tr->results["TestOp"]["TestParams"] = 3;
+    ASSERT_STATUS_OK(session_object.SetTuningResults(trs, /*error_on_invalid*/ true, /*auto_enable*/ false));
+  }
+  std::vector<std::filesystem::path> entries;
+  for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+    entries.push_back(entry.path());
+  }
+  ASSERT_EQ(entries.size(), 1u);
+  ASSERT_EQ(entries[0].extension(), ".json");
+
+  // and loaded by the next session on the same device
+  {
+    InferenceSession session_object{so, GetEnvironment()};
+    initialize_session(session_object);
+    const auto trs = session_object.GetTuningResults();
+    const auto* tr = find_cuda_results(trs);
+    ASSERT_NE(tr, nullptr);
+    ASSERT_EQ(tr->results.count("TestOp"), 1u);
+    ASSERT_EQ(tr->results.at("TestOp").at("TestParams"), 3);
+  }
+
+  std::filesystem::remove_all(cache_dir);
+}
+
 TEST(InferenceSessionTests, TestArenaShrinkageAfterRun) {
   OrtArenaCfg arena_cfg;
   arena_cfg.arena_extend_strategy = 1;  // kSameAsRequested
@@ -2644,6 +3693,79 @@ TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   }
 }
 
+// A clone shares the session state of the session it is cloned from and runs with its own thread pools.
+// The configs of the runs are validated before the session accepts runs.
+TEST(InferenceSessionTests, InvalidRunConfigFailsInitialize) {
+  for (const char* config_key : {kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize,
+                                 kOrtSessionOptionsConfigMaxConcurrentAsyncRuns,
+                                 kOrtSessionOptionsConfigProfilingSampleEveryNRuns}) {
+    SessionOptions so;
+    so.session_logid = "InvalidRunConfigFailsInitialize";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(config_key, "not a number"));
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_FALSE(session_object.Initialize().IsOK()) << config_key;
+
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                         {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    EXPECT_FALSE(session_object.Run(RunOptions{}, feeds, output_names, &fetches).IsOK()) << config_key;
+  }
+}
+
+TEST(InferenceSessionTests, CloneSharesSessionState) {
+  SessionOptions so;
+  so.session_logid = "CloneSharesSessionState";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+
+  std::unique_ptr<InferenceSession> clone;
+  ASSERT_FALSE(session_object.Clone(so, clone).IsOK());  // not initialized yet
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  SessionOptions parallel_so = so;
+  parallel_so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_FALSE(session_object.Clone(parallel_so, clone).IsOK());
+
+  // the kernels record their events to the profiler of the session
+  SessionOptions profiling_so = so;
+  profiling_so.enable_profiling = true;
+  ASSERT_FALSE(session_object.Clone(profiling_so, clone).IsOK());
+  SessionOptions sampling_so = so;
+  ASSERT_STATUS_OK(sampling_so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfilingSampleEveryNRuns, "1"));
+  ASSERT_FALSE(session_object.Clone(sampling_so, clone).IsOK());
+
+  SessionOptions clone_so = so;
+  clone_so.session_logid = "CloneSharesSessionStateClone";
+  clone_so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(session_object.Clone(clone_so, clone));
+  ASSERT_EQ(&clone->GetSessionState(), &session_object.GetSessionState());
+  ASSERT_FALSE(clone->Load(MODEL_URI).IsOK());
+  ASSERT_STATUS_OK(clone->Initialize());  // already initialized
+
+  RunOptions run_options;
+  RunModel(*clone, run_options);
+  RunModel(session_object, run_options);
+
+  // the clone has the data transfers of the execution providers, e.g. for IOBinding
+  auto cpu_allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue src;
+  CreateMLValue<float>(cpu_allocator, {2}, {1.0f, 2.0f}, &src);
+  Tensor dst(DataTypeImpl::GetType<float>(), TensorShape({2}), cpu_allocator);
+  ASSERT_STATUS_OK(clone->GetDataTransferManager().CopyTensor(src.Get<Tensor>(), dst));
+  EXPECT_EQ(dst.Data<float>()[0], 1.0f);
+  EXPECT_EQ(dst.Data<float>()[1], 2.0f);
+
+  // the clones of a clone share the same session state
+  std::unique_ptr<InferenceSession> second_clone;
+  ASSERT_STATUS_OK(clone->Clone(clone_so, second_clone));
+  ASSERT_EQ(&second_clone->GetSessionState(), &session_object.GetSessionState());
+  RunModel(*second_clone, run_options);
+}
+
 // Tests for sharing allocators between sessions
 class InferenceSessionTestSharingAllocator : public InferenceSessionWrapper {
  public:
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Creates a pattern group that can be told apart by the number of locations.
+MemoryPatternGroup MakePatternGroup(size_t num_locations) {
+  MemoryPatternGroup group;
+  group.locations.resize(num_locations);
+  group.patterns.resize(num_locations);
+  return group;
+}
+
+// Encodes a single input of shape {batch, seq_len}.
+InlinedVector<int64_t> InputDims(int64_t batch, int64_t seq_len) {
+  return {2, batch, seq_len};
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+  EXPECT_FALSE(cache.UsesShapeBuckets());
+  EXPECT_EQ(cache.Find(InputDims(1, 16)), nullptr);
+
+  cache.Insert(InputDims(1, 16), MakePatternGroup(1));
+  cache.Insert(InputDims(1, 32), MakePatternGroup(2));
+  EXPECT_EQ(cache.Size(), 2u);
+
+  auto entry = cache.Find(InputDims(1, 16));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.locations.size(), 1u);
+
+  entry = cache.Find(InputDims(1, 32));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.locations.size(), 2u);
+
+  // shapes that only differ in how the dims are split between inputs must not collide
+  const InlinedVector<int64_t> two_inputs{1, 1, 1, 16};
+  EXPECT_EQ(cache.Find(two_inputs), nullptr);
+  EXPECT_EQ(cache.Find(InputDims(1, 24)), nullptr);
+
+  // an existing pattern is kept
+  cache.Insert(InputDims(1, 16), MakePatternGroup(3));
+  EXPECT_EQ(cache.Find(InputDims(1, 16))->patterns.locations.size(), 1u);
+}
+
+TEST(MemoryPatternCacheTest, ShapeBuckets) {
+  MemoryPatternCache cache{0, 32};
+  EXPECT_TRUE(cache.UsesShapeBuckets());
+
+  cache.Insert(InputDims(1, 20), MakePatternGroup(1));
+
+  // smaller inputs in the same bucket can use the pattern
+  auto entry = cache.Find(InputDims(1, 18));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.locations.size(), 1u);
+  EXPECT_NE(cache.Find(InputDims(1, 20)), nullptr);
+
+  // larger inputs in the same bucket need a new pattern, which replaces the old one
+  EXPECT_EQ(cache.Find(InputDims(1, 30)), nullptr);
+  cache.Insert(InputDims(1, 30), MakePatternGroup(2));
+  EXPECT_EQ(cache.Size(), 1u);
+  entry = cache.Find(InputDims(1, 18));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.locations.size(), 2u);
+
+  // the replaced pattern stays valid for a holder
+  cache.Insert(InputDims(1, 32), MakePatternGroup(3));
+  EXPECT_EQ(entry->patterns.locations.size(), 2u);
+  EXPECT_EQ(cache.Find(InputDims(1, 18))->patterns.locations.size(), 3u);
+
+  // a different bucket, and a larger dim in the same bucket
+  EXPECT_EQ(cache.Find(InputDims(1, 33)), nullptr);
+  EXPECT_EQ(cache.Find(InputDims(2, 18)), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache{2};
+
+  cache.Insert(InputDims(1, 1), MakePatternGroup(1));
+  cache.Insert(InputDims(1, 2), MakePatternGroup(2));
+  auto first = cache.Find(InputDims(1, 1));
+  ASSERT_NE(first, nullptr);
+
+  cache.Insert(InputDims(1, 3), MakePatternGroup(3));
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_NE(cache.Find(InputDims(1, 1)), nullptr);
+  EXPECT_EQ(cache.Find(InputDims(1, 2)), nullptr);
+  EXPECT_NE(cache.Find(InputDims(1, 3)), nullptr);
+
+  // (1, 1) is now the least recently used entry
+  cache.Insert(InputDims(1, 4), MakePatternGroup(4));
+  EXPECT_EQ(cache.Find(InputDims(1, 1)), nullptr);
+  EXPECT_EQ(first->patterns.locations.size(), 1u);
+}
+
+TEST(MemoryPatternCacheTest, FrozenPlan) {
+  MemPatternPlanner planner{false};
+  planner.TraceAllocation(3, 64);
+  planner.TraceAllocation(5, 128);
+  planner.TraceFree(3);
+  planner.TraceAllocation(7, 32);
+
+  MemoryPatternGroup group;
+  group.locations.push_back(OrtDevice());
+  group.patterns.push_back(planner.GenerateMemPattern());
+
+  // nothing is frozen unless the cache freezes its patterns
+  MemoryPatternCache cache;
+  EXPECT_EQ(cache.Insert(InputDims(1, 16), group)->frozen_plan, nullptr);
+
+  MemoryPatternCache freezing_cache{0, 0, true};
+  auto entry = freezing_cache.Insert(InputDims(1, 16), group);
+  ASSERT_NE(entry->frozen_plan, nullptr);
+  const FrozenMemoryPlan& plan = *entry->frozen_plan;
+
+  for (int idx : {3, 5, 7}) {
+    const auto* placement = plan.GetPlacement(idx);
+    ASSERT_NE(placement, nullptr);
+    const auto* block = group.patterns[0].GetBlock(idx);
+    EXPECT_EQ(placement->location_index, 0);
+    EXPECT_EQ(placement->offset, block->offset_);
+    EXPECT_EQ(placement->size, block->size_);
+  }
+  EXPECT_EQ(plan.GetPlacement(-1), nullptr);
+  EXPECT_EQ(plan.GetPlacement(4), nullptr);
+  EXPECT_EQ(plan.GetPlacement(100), nullptr);
+
+  // buffers released by one run are handed to the next
+  EXPECT_TRUE(plan.AcquireBuffers().empty());
+  FrozenMemoryPlan::Buffers buffers;
+  buffers.emplace_back(BufferUniquePtr(nullptr, BufferDeleter(nullptr)));
+  plan.ReleaseBuffers(std::move(buffers));
+  EXPECT_EQ(plan.AcquireBuffers().size(), 1u);
+  EXPECT_TRUE(plan.AcquireBuffers().empty());
+
+  // patterns with non-CPU memory are not frozen
+  group.locations[0] = OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0);
+  EXPECT_EQ(freezing_cache.Insert(InputDims(1, 32), std::move(group))->frozen_plan, nullptr);
+
+  // neither are patterns shared by a shape bucket
+  EXPECT_EQ(MemoryPatternCache(0, 32, true).Insert(InputDims(1, 16), MakePatternGroup(1))->frozen_plan, nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
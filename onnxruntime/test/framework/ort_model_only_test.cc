@@ -557,6 +557,13 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBufferNoCopyInitializersUseBuffer)
   RunOrtModel(test_info);
 }
 
+// Load the model from a file path, with the initializers using the memory mapped file
+TEST(OrtModelOnlyTests, LoadOrtFormatModelFromFileInitializersUseMappedFile) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1"));
+  RunOrtModel(test_info);
+}
+
 // regression test for 2 issues covered by PR #17000 (internally reported issue).
 // 1) allocation planner broke in minimal build when subgraph had no nodes.
 // 2) usage of a sequence data type caused an exception due to IsSparseTensor() throwing
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <fstream>
+
+#include "core/framework/allocator.h"
+#include "core/framework/prepacked_weights_file.h"
+#include "test/util/include/temp_dir.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+PrePackedWeights MakePackedWeights(AllocatorPtr allocator, const std::vector<size_t>& sizes, char fill) {
+  PrePackedWeights weights;
+  for (size_t size : sizes) {
+    if (size == 0) {
+      // a place-holder buffer
+      weights.buffers_.push_back(nullptr);
+    } else {
+      auto buffer = IAllocator::MakeUniquePtr<void>(allocator, size, true);
+      std::memset(buffer.get(), fill, size);
+      weights.buffers_.push_back(std::move(buffer));
+    }
+    weights.buffer_sizes_.push_back(size);
+  }
+  return weights;
+}
+
+bool BufferIsFilled(const void* buffer, size_t size, char fill) {
+  const auto* bytes = static_cast<const char*>(buffer);
+  for (size_t i = 0; i < size; ++i) {
+    if (bytes[i] != fill) return false;
+  }
+  return true;
+}
+}  // namespace
+
+TEST(PrepackedWeightsFileTest, SaveAndLoad) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("prepacked_weights_file_test_tmp_dir")};
+  const std::filesystem::path path = std::filesystem::path(tmp_dir.Path()) / "model.prepacked";
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+
+  {
+    PrepackedWeightsFile file;
+    file.Add("1/MatMul/1/B", 11, MakePackedWeights(allocator, {100}, 1));
+    file.Add("2/QLinearConv/3/W", 22, MakePackedWeights(allocator, {0, 4096, 3}, 2));
+    ASSERT_TRUE(file.Save(path).IsOK());
+  }
+
+  PrepackedWeightsFile file;
+  ASSERT_TRUE(file.Load(path).IsOK());
+  EXPECT_EQ(file.Size(), 2u);
+  EXPECT_EQ(file.Find("3/MatMul/1/B"), nullptr);
+
+  const auto* matmul = file.Find("1/MatMul/1/B");
+  ASSERT_NE(matmul, nullptr);
+  EXPECT_EQ(matmul->initializer_hash, 11u);
+  ASSERT_EQ(matmul->weights.buffer_sizes_, std::vector<size_t>{100});
+  EXPECT_TRUE(BufferIsFilled(matmul->weights.buffers_[0].get(), 100, 1));
+
+  const auto* conv = file.Find("2/QLinearConv/3/W");
+  ASSERT_NE(conv, nullptr);
+  EXPECT_EQ(conv->initializer_hash, 22u);
+  ASSERT_EQ(conv->weights.buffer_sizes_, (std::vector<size_t>{0, 4096, 3}));
+  EXPECT_EQ(conv->weights.buffers_[0].get(), nullptr);
+  for (size_t i = 1; i < 3; ++i) {
+    // buffers are aligned for the kernels
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(conv->weights.buffers_[i].get()) % 64, 0u);
+    EXPECT_TRUE(BufferIsFilled(conv->weights.buffers_[i].get(), conv->weights.buffer_sizes_[i], 2));
+  }
+}
+
+TEST(PrepackedWeightsFileTest, RejectsInvalidFiles) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("prepacked_weights_file_test_tmp_dir")};
+  const std::filesystem::path path = std::filesystem::path(tmp_dir.Path()) / "model.prepacked";
+
+  PrepackedWeightsFile file;
+  EXPECT_FALSE(file.Load(path).IsOK());
+
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "not a pre-packed weights file";
+  }
+  EXPECT_FALSE(file.Load(path).IsOK());
+  EXPECT_EQ(file.Size(), 0u);
+}
+
+TEST(PrepackedWeightsFileTest, LayoutTagIdentifiesBuild) {
+  const std::string tag = PrepackedWeightsFile::GetLayoutTag();
+  EXPECT_NE(tag.find("ort="), std::string::npos);
+  EXPECT_EQ(tag, PrepackedWeightsFile::GetLayoutTag());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
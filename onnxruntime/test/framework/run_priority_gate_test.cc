@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "core/framework/run_priority_gate.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(RunPriorityGateTest, LowerPriorityWaitsForHigherPriority) {
+  RunPriorityGate gate;
+  std::atomic<bool> low_priority_resumed{false};
+
+  auto high_priority = std::make_unique<RunPriorityGate::Scope>(gate, 1);
+  auto same_priority = std::make_unique<RunPriorityGate::Scope>(gate, 1);
+  // runs of the highest active priority don't wait
+  high_priority->YieldIfPreempted();
+  same_priority->YieldIfPreempted();
+
+  std::thread low_priority_run([&gate, &low_priority_resumed]() {
+    RunPriorityGate::Scope low_priority(gate, 0);
+    low_priority.YieldIfPreempted();
+    low_priority_resumed = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(low_priority_resumed);
+
+  // a run of priority 1 is still executing
+  high_priority.reset();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(low_priority_resumed);
+
+  same_priority.reset();
+  low_priority_run.join();
+  EXPECT_TRUE(low_priority_resumed);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/framework/session_metrics.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(LatencyHistogramTest, BucketBounds) {
+  for (size_t i = 0; i < LatencyHistogram::kNumBuckets; ++i) {
+    EXPECT_EQ(LatencyHistogram::BucketForValue(LatencyHistogram::BucketLowerBound(i)), i);
+    EXPECT_EQ(LatencyHistogram::BucketForValue(LatencyHistogram::BucketUpperBound(i)), i);
+    if (i > 0) {
+      EXPECT_EQ(LatencyHistogram::BucketLowerBound(i), LatencyHistogram::BucketUpperBound(i - 1) + 1);
+    }
+  }
+
+  EXPECT_EQ(LatencyHistogram::BucketForValue(LatencyHistogram::kMaxValueNs - 1), LatencyHistogram::kNumBuckets - 1);
+  EXPECT_EQ(LatencyHistogram::BucketForValue(LatencyHistogram::kMaxValueNs * 2), LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (uint64_t ns = 1; ns <= 100; ++ns) {
+    histogram.Record(ns * 1000);
+  }
+
+  const auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 100u);
+  EXPECT_EQ(snapshot.sum_ns, 5050u * 1000);
+  EXPECT_EQ(snapshot.max_ns, 100u * 1000);
+
+  // values are reported with a relative error of at most 1 / kSubBuckets
+  const auto expect_near = [](uint64_t actual, uint64_t expected) {
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected + expected / LatencyHistogram::kSubBuckets);
+  };
+  expect_near(snapshot.PercentileNs(50), 50 * 1000);
+  expect_near(snapshot.PercentileNs(90), 90 * 1000);
+  EXPECT_EQ(snapshot.PercentileNs(100), 100u * 1000);
+
+  EXPECT_EQ(LatencyHistogram().GetSnapshot().PercentileNs(50), 0u);
+}
+
+TEST(SessionMetricsTest, NodesShareOpTypeHistograms) {
+  SessionMetrics metrics;
+  auto add_0 = metrics.RegisterNode("add_0", "Add");
+  auto add_1 = metrics.RegisterNode("add_1", "Add");
+  auto mul_0 = metrics.RegisterNode("mul_0", "Mul");
+
+  EXPECT_NE(add_0.node, add_1.node);
+  EXPECT_EQ(add_0.op_type, add_1.op_type);
+  EXPECT_NE(add_0.op_type, mul_0.op_type);
+
+  add_0.node->Record(10);
+  add_0.op_type->Record(10);
+  add_1.node->Record(20);
+  add_1.op_type->Record(20);
+
+  std::vector<std::pair<std::string, uint64_t>> nodes;
+  std::vector<std::pair<std::string, uint64_t>> op_types;
+  metrics.ForEachHistogram(
+      [&nodes](const std::string& name, const LatencyHistogram::Snapshot& snapshot) {
+        nodes.emplace_back(name, snapshot.count);
+      },
+      [&op_types](const std::string& name, const LatencyHistogram::Snapshot& snapshot) {
+        op_types.emplace_back(name, snapshot.count);
+      });
+
+  using Counts = std::vector<std::pair<std::string, uint64_t>>;
+  EXPECT_EQ(nodes, (Counts{{"add_0", 1}, {"add_1", 1}, {"mul_0", 0}}));
+  EXPECT_EQ(op_types, (Counts{{"Add", 2}, {"Mul", 0}}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
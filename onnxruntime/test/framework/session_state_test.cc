@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <iostream>
+#include <set>
 #include <absl/base/config.h>
 
 #include "asserts.h"
@@ -530,6 +531,7 @@ static void PlaceAllNodesToCPUEP(Graph& graph) {
 struct PrepackingTestParam {
   bool test_subgraph;
   bool test_prepacking;
+  bool test_serial_prepacking = false;
 };
 
 class SessionStatePrepackingTest : public testing::TestWithParam<PrepackingTestParam> {};
@@ -572,6 +574,8 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   sess_options.enable_mem_reuse = true;
   sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] =
       test_param.test_prepacking ? "0" : "1";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisableParallelPrepacking] =
+      test_param.test_serial_prepacking ? "1" : "0";
 
   SessionState session_state(model.MainGraph(),
                              execution_providers,
@@ -605,6 +609,105 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   ASSERT_EQ(const_initialized_tensors.size(), size_t(test_param.test_prepacking ? 0 : 1));
 }
 
+// Builds a graph with the initializers
+// - w_shared, pre-packed by node_0 and node_1,
+// - w_kept, pre-packed by node_2 and read as is by an Add node,
+// - w_single, pre-packed by node_3,
+// and returns the names of the initializers left after the session state pre-packs them.
+static std::set<std::string> GetInitializersLeftAfterPrepacking(bool serial_prepacking) {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(PrePackingTest)
+      .SetDoc("Faking Node for PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  ORT_THROW_IF_ERROR(execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider)));
+
+  DataTransferManager dtm;
+  ExternalDataLoaderManager edlm;
+  profiling::Profiler profiler;
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 11;
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& input_arg = graph.GetOrCreateNodeArg("input", &type);
+  auto add_node = [&](const std::string& name, const std::string& op_type, const std::string& initializer_name) {
+    graph.AddNode(name, op_type, name, {&input_arg, &graph.GetOrCreateNodeArg(initializer_name, &type)},
+                  {&graph.GetOrCreateNodeArg(name + "_output", &type)});
+  };
+  add_node("node_0", "PrePackingTest", "w_shared");
+  add_node("node_1", "PrePackingTest", "w_shared");
+  add_node("node_2", "PrePackingTest", "w_kept");
+  add_node("add", "Add", "w_kept");
+  add_node("node_3", "PrePackingTest", "w_single");
+  for (const char* name : {"w_shared", "w_kept", "w_single"}) {
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.add_dims(1);
+    tensor.add_float_data(1.0f);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    tensor.set_name(name);
+    graph.AddInitializedTensor(tensor);
+  }
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  SessionOptions sess_options;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisableParallelPrepacking] =
+      serial_prepacking ? "1" : "0";
+
+  SessionState session_state(graph, execution_providers, tp.get(), nullptr, dtm, edlm,
+                             DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  KernelRegistryManager kernel_registry_manager;
+  ORT_THROW_IF_ERROR(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("PrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ORT_THROW_IF_ERROR(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) -> Status {
+                         out = std::make_unique<PrePackingTestOpKernel>(info);
+                         return Status::OK();
+                       })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  PlaceAllNodesToCPUEP(graph);
+  ORT_THROW_IF_ERROR(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+  EXPECT_EQ(session_state.GetNumberOfPrepacksCounter(), size_t(4));
+
+  std::set<std::string> names;
+  std::string name;
+  for (const auto& [ort_value_idx, value] : session_state.GetInitializedTensors()) {
+    ORT_THROW_IF_ERROR(session_state.GetOrtValueNameIdxMap().GetName(ort_value_idx, name));
+    EXPECT_TRUE(value.IsAllocated()) << name;
+    EXPECT_EQ(session_state.GetConstantInitializedTensors().count(ort_value_idx), size_t(1)) << name;
+    names.insert(name);
+  }
+  EXPECT_EQ(session_state.GetConstantInitializedTensors().size(), names.size());
+  return names;
+}
+
+// The parallel pre-packing releases the same initializers as the serial one.
+TEST(SessionStateTest, ParallelPrepackingReleasesInitializers) {
+  const auto serial_names = GetInitializersLeftAfterPrepacking(true);
+  const auto parallel_names = GetInitializersLeftAfterPrepacking(false);
+  EXPECT_EQ(serial_names, std::set<std::string>{"w_kept"});
+  EXPECT_EQ(parallel_names, serial_names);
+}
+
 class SessionStateTestSharedInitalizersWithPrePacking : public ::testing::Test {
  protected:
   ExecutionProviders execution_providers;
@@ -1003,7 +1106,9 @@ INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          testing::Values(PrepackingTestParam{false, false},
                                          PrepackingTestParam{false, true},
                                          PrepackingTestParam{true, false},
-                                         PrepackingTestParam{true, true}));
+                                         PrepackingTestParam{true, true},
+                                         PrepackingTestParam{false, true, true},
+                                         PrepackingTestParam{true, true, true}));
 #endif
 
 }  // namespace test
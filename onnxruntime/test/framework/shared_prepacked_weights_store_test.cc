@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+
+#include "core/framework/allocator.h"
+#include "core/framework/shared_prepacked_weights_store.h"
+#include "test/util/include/temp_dir.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+PrePackedWeights MakePackedWeights(AllocatorPtr allocator, size_t size, char fill) {
+  PrePackedWeights weights;
+  auto buffer = IAllocator::MakeUniquePtr<void>(allocator, size, true);
+  std::memset(buffer.get(), fill, size);
+  weights.buffers_.push_back(std::move(buffer));
+  weights.buffer_sizes_.push_back(size);
+  // a place-holder buffer
+  weights.buffers_.push_back(nullptr);
+  weights.buffer_sizes_.push_back(0);
+  return weights;
+}
+}  // namespace
+
+TEST(SharedPrepackedWeightsStoreTest, MapsSharedFiles) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("shared_prepacked_weights_store_test_tmp_dir")};
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  constexpr size_t size = 4096;
+
+  auto packed_weights = MakePackedWeights(allocator, size, 7);
+  const std::string key = "MatMulNBits+" + std::to_string(packed_weights.GetHash());
+
+  PrePackedWeights first;
+  {
+    SharedPrepackedWeightsStore store{tmp_dir.Path()};
+    ASSERT_TRUE(store.GetOrWriteWeight(key, packed_weights, first).IsOK());
+  }
+  // the mappings stay valid after the store is gone
+  ASSERT_EQ(first.buffers_.size(), 2u);
+  ASSERT_NE(first.buffers_[0].get(), nullptr);
+  EXPECT_NE(first.buffers_[0].get(), packed_weights.buffers_[0].get());
+  EXPECT_EQ(std::memcmp(first.buffers_[0].get(), packed_weights.buffers_[0].get(), size), 0);
+  EXPECT_EQ(first.buffers_[1].get(), nullptr);
+  EXPECT_EQ(first.buffer_sizes_, packed_weights.buffer_sizes_);
+
+  // a second store, as in another process, maps the existing file
+  SharedPrepackedWeightsStore store{tmp_dir.Path()};
+  PrePackedWeights second;
+  ASSERT_TRUE(store.GetOrWriteWeight(key, packed_weights, second).IsOK());
+  EXPECT_EQ(std::memcmp(second.buffers_[0].get(), packed_weights.buffers_[0].get(), size), 0);
+
+  // a file with different content is rejected
+  auto other_weights = MakePackedWeights(allocator, size, 8);
+  PrePackedWeights rejected;
+  EXPECT_FALSE(store.GetOrWriteWeight(key, other_weights, rejected).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
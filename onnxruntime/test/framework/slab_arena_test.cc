@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "core/framework/allocator_utils.h"
+#include "core/framework/arena_extend_strategy.h"
+#include "core/framework/slab_arena.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(SlabArenaTest, SizeClasses) {
+  size_t prev_class_bytes = 0;
+  for (size_t i = 0; i < SlabArena::kNumSizeClasses; ++i) {
+    const size_t class_bytes = SlabArena::SizeClassBytes(i);
+    EXPECT_GT(class_bytes, prev_class_bytes);
+    EXPECT_EQ(class_bytes % SlabArena::kMinSizeClassBytes, 0u);
+    EXPECT_EQ(SlabArena::SizeClassForBytes(class_bytes), i);
+    EXPECT_EQ(SlabArena::SizeClassForBytes(prev_class_bytes + 1), i);
+    // a request never wastes more than 25% of its block, apart from the smallest classes
+    if (i >= 4) {
+      EXPECT_LE(class_bytes - (prev_class_bytes + 1), class_bytes / 4);
+    }
+    prev_class_bytes = class_bytes;
+  }
+  EXPECT_EQ(prev_class_bytes, SlabArena::kMaxSizeClassBytes);
+}
+
+TEST(SlabArenaTest, AllocationsAndDeallocations) {
+  SlabArena a(std::make_unique<CPUAllocator>());
+
+  std::vector<void*> ptrs;
+  for (size_t s = 1; s < 2 * SlabArena::kMaxSizeClassBytes; s = s * 3 / 2 + 1) {
+    void* p = a.Alloc(s);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % SlabArena::kBlockHeaderBytes, 0u);
+    memset(p, 0xab, s);
+    ptrs.push_back(p);
+  }
+
+  std::vector<void*> sorted = ptrs;
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end()) << "no duplicated pointers";
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, static_cast<int64_t>(ptrs.size()));
+  EXPECT_GT(stats.bytes_in_use, 0);
+  EXPECT_GE(stats.total_allocated_bytes, stats.bytes_in_use);
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GT(stats.max_bytes_in_use, 0);
+  EXPECT_GE(stats.max_alloc_size, static_cast<int64_t>(SlabArena::kMaxSizeClassBytes));
+  EXPECT_EQ(a.Alloc(0), nullptr);
+}
+
+TEST(SlabArenaTest, ReusesFreedBlocks) {
+  SlabArena a(std::make_unique<CPUAllocator>());
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  void* p2 = a.Alloc(1000);
+  EXPECT_EQ(p1, p2);
+  a.Free(p2);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1) << "both allocations should come from the same slab";
+}
+
+TEST(SlabArenaTest, MemoryLimit) {
+  SlabArena a(std::make_unique<CPUAllocator>(), 4 * SlabArena::kSlabBytes);
+  void* p = a.Alloc(1024);
+  ASSERT_NE(p, nullptr);
+  EXPECT_THROW(a.Alloc(8 * SlabArena::kSlabBytes), OnnxRuntimeException);
+  a.Free(p);
+}
+
+TEST(SlabArenaTest, ConcurrentAllocations) {
+  SlabArena a(std::make_unique<CPUAllocator>());
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<std::pair<unsigned char*, size_t>> live;
+      for (int i = 0; i < 2000; ++i) {
+        size_t size = 1 + ((i * 7919 + t * 104729) % (256 * 1024));
+        auto* p = static_cast<unsigned char*>(a.Alloc(size));
+        ASSERT_NE(p, nullptr);
+        memset(p, t, size);
+        live.emplace_back(p, size);
+        if (live.size() > 16) {
+          // the block must not have been handed out to another thread in the meantime
+          auto [q, q_size] = live.front();
+          for (size_t j = 0; j < q_size; j += 4096) {
+            ASSERT_EQ(q[j], static_cast<unsigned char>(t));
+          }
+          a.Free(q);
+          live.erase(live.begin());
+        }
+      }
+      for (auto& entry : live) {
+        a.Free(entry.first);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(SlabArenaTest, CreateFromArenaCfg) {
+  OrtArenaCfg config;
+  config.arena_type = static_cast<int>(ArenaAllocatorType::kSlabArena);
+  AllocatorCreationInfo device_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  auto allocator = CreateAllocator(device_info);
+  ASSERT_NE(allocator, nullptr);
+  EXPECT_EQ(allocator->Info().alloc_type, OrtAllocatorType::OrtDeviceAllocator);
+
+  void* p = allocator->Alloc(4096);
+  ASSERT_NE(p, nullptr);
+  allocator->Free(p);
+
+  config.arena_type = 2;
+  AllocatorCreationInfo invalid_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  EXPECT_EQ(CreateAllocator(invalid_info), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
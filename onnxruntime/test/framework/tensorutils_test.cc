@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/framework/external_data_compression.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "test/util/include/asserts.h"
@@ -357,5 +358,94 @@ TEST(TensorProtoUtilsTest, ConstantTensorProtoWithExternalData) {
   TestConstantNodeConversionWithExternalData<float>(TensorProto_DataType_FLOAT);
   TestConstantNodeConversionWithExternalData<double>(TensorProto_DataType_DOUBLE);
 }
+
+TEST(TensorProtoUtilsTest, CanUseExternalDataInPlace) {
+  auto make_tensor_proto = [](TensorProto_DataType type, const std::string& location, int64_t offset) {
+    TensorProto tensor_proto;
+    tensor_proto.set_data_type(type);
+    tensor_proto.add_dims(4);
+    tensor_proto.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+    auto* entry = tensor_proto.mutable_external_data()->Add();
+    entry->set_key("location");
+    entry->set_value(location);
+    entry = tensor_proto.mutable_external_data()->Add();
+    entry->set_key("offset");
+    entry->set_value(std::to_string(offset));
+    return tensor_proto;
+  };
+
+  constexpr bool little_endian = endian::native == endian::little;
+  EXPECT_EQ(CanUseExternalDataInPlace(make_tensor_proto(TensorProto_DataType_FLOAT, "weights.bin", 4096)),
+            little_endian);
+  EXPECT_EQ(CanUseExternalDataInPlace(make_tensor_proto(TensorProto_DataType_FLOAT, "weights.bin", 12)),
+            little_endian);
+  EXPECT_FALSE(CanUseExternalDataInPlace(make_tensor_proto(TensorProto_DataType_FLOAT, "weights.bin", 6)));
+  EXPECT_FALSE(CanUseExternalDataInPlace(make_tensor_proto(TensorProto_DataType_DOUBLE, "weights.bin", 4)));
+  EXPECT_TRUE(CanUseExternalDataInPlace(make_tensor_proto(TensorProto_DataType_INT8, "weights.bin", 3)));
+
+  // data in memory doesn't need an endianness conversion
+  alignas(8) static const float data[4] = {1.f, 2.f, 3.f, 4.f};
+  const auto address = static_cast<int64_t>(reinterpret_cast<uintptr_t>(data));
+  EXPECT_TRUE(CanUseExternalDataInPlace(
+      make_tensor_proto(TensorProto_DataType_FLOAT, ToUTF8String(kTensorProtoMemoryAddressTag), address)));
+
+  // string data is never stored as raw external data
+  TensorProto string_tensor_proto = make_tensor_proto(TensorProto_DataType_STRING, "weights.bin", 0);
+  EXPECT_FALSE(CanUseExternalDataInPlace(string_tensor_proto));
+}
+
+TEST(TensorProtoUtilsTest, DecompressLz4Block) {
+  // the literals "abc", then a match of 9 bytes at offset 3, which overlaps the bytes it produces
+  const std::vector<char> block = {0x35, 'a', 'b', 'c', 0x03, 0x00};
+  std::string output(12, '\0');
+  ASSERT_STATUS_OK(DecompressLz4Block(block, gsl::make_span(output)));
+  EXPECT_EQ(output, "abcabcabcabc");
+
+  // the decompressed size must match
+  std::string short_output(11, '\0');
+  EXPECT_FALSE(DecompressLz4Block(block, gsl::make_span(short_output)).IsOK());
+  std::string long_output(13, '\0');
+  EXPECT_FALSE(DecompressLz4Block(block, gsl::make_span(long_output)).IsOK());
+
+  // a match can't start before the data
+  const std::vector<char> bad_offset = {0x35, 'a', 'b', 'c', 0x04, 0x00};
+  EXPECT_FALSE(DecompressLz4Block(bad_offset, gsl::make_span(output)).IsOK());
+
+  // the literals are cut short
+  const std::vector<char> truncated = {0x35, 'a', 'b'};
+  EXPECT_FALSE(DecompressLz4Block(truncated, gsl::make_span(output)).IsOK());
+}
+
+TEST(TensorProtoUtilsTest, UnpackTensorWithCompressedExternalData) {
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  const std::vector<uint8_t> block = {0x35, 'a', 'b', 'c', 0x03, 0x00};
+  TensorProto tensor_proto;
+  CreateTensorWithExternalData<uint8_t>(TensorProto_DataType_UINT8, block, filename, tensor_proto);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+  tensor_proto.set_dims(0, 12);
+  auto* entry = tensor_proto.mutable_external_data()->Add();
+  entry->set_key("length");
+  entry->set_value(std::to_string(block.size()));
+  entry = tensor_proto.mutable_external_data()->Add();
+  entry->set_key("compression");
+  entry->set_value("lz4");
+
+  std::vector<uint8_t> unpacked(12);
+  ASSERT_STATUS_OK(UnpackTensor(tensor_proto, std::filesystem::path(), unpacked.data(), unpacked.size()));
+  EXPECT_EQ(std::string(unpacked.begin(), unpacked.end()), "abcabcabcabc");
+
+  Tensor tensor(DataTypeImpl::GetType<uint8_t>(), TensorShape({12}), std::make_shared<CPUAllocator>());
+  ASSERT_STATUS_OK(DecompressExternalDataIntoTensor(Env::Default(), std::filesystem::path(), tensor_proto, tensor));
+  const auto decompressed = tensor.DataAsSpan<uint8_t>();
+  EXPECT_EQ(std::string(decompressed.begin(), decompressed.end()), "abcabcabcabc");
+
+  EXPECT_TRUE(HasCompressedExternalData(tensor_proto));
+  EXPECT_FALSE(CanUseExternalDataInPlace(tensor_proto));
+
+  // only the codecs that can be decompressed are accepted
+  entry->set_value("zstd");
+  EXPECT_FALSE(UnpackTensor(tensor_proto, std::filesystem::path(), unpacked.data(), unpacked.size()).IsOK());
+}
 }  // namespace test
 }  // namespace onnxruntime
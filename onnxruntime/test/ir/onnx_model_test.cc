@@ -2,7 +2,10 @@
 // Licensed under the MIT License.
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -189,6 +192,62 @@ TEST_F(ONNXModelsTest, TestModelsWithAnOpContainingAFunctionBody) {
   ASSERT_STATUS_OK(model->MainGraph().Resolve());
 }
 
+// the raw data of the large initializers should be referenced in the model file instead of copied when
+// ModelOptions::load_initializers_in_place is set. the small initializers keep their data.
+TEST_F(ONNXModelsTest, LoadInitializersInPlace) {
+  ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  model_proto.add_opset_import()->set_version(13);
+  auto* graph_proto = model_proto.mutable_graph();
+  graph_proto->set_name("graph");
+
+  const std::vector<float> large_data(1024, 1.5f);
+  const std::vector<float> small_data(4, 2.5f);
+  for (const auto& [name, data] : {std::make_pair("large", &large_data), std::make_pair("small", &small_data)}) {
+    auto* initializer = graph_proto->add_initializer();
+    initializer->set_name(name);
+    initializer->set_data_type(TensorProto_DataType_FLOAT);
+    initializer->add_dims(static_cast<int64_t>(data->size()));
+    initializer->set_raw_data(data->data(), data->size() * sizeof(float));
+  }
+
+  auto* node = graph_proto->add_node();
+  node->set_op_type("ReduceSum");
+  node->add_input("large");
+  node->add_output("large_sum");
+  node = graph_proto->add_node();
+  node->set_op_type("Add");
+  node->add_input("large_sum");
+  node->add_input("small");
+  node->add_output("Y");
+  auto* output = graph_proto->add_output();
+  output->set_name("Y");
+  output->mutable_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  const PathString model_path = ORT_TSTR("load_initializers_in_place.test_output.onnx");
+  {
+    std::ofstream model_file(model_path, std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_file));
+  }
+
+  ModelOptions options;
+  options.load_initializers_in_place = true;
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path, model, nullptr, *logger_, options));
+
+  const auto& graph = model->MainGraph();
+  for (const auto& [name, data] : {std::make_pair("large", &large_data), std::make_pair("small", &small_data)}) {
+    const TensorProto* initializer = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(name, initializer));
+    EXPECT_EQ(utils::HasExternalData(*initializer), data == &large_data);
+
+    std::vector<uint8_t> unpacked;
+    ASSERT_STATUS_OK(utils::UnpackInitializerData(*initializer, model_path, unpacked));
+    ASSERT_EQ(unpacked.size(), data->size() * sizeof(float));
+    EXPECT_EQ(std::memcmp(unpacked.data(), data->data(), unpacked.size()), 0);
+  }
+}
+
 // The following tests verify ORT can successfully load models which reference functions
 // present in the ModelProto aka model local functions. This feature was added to ONNX standard starting IRv8
 
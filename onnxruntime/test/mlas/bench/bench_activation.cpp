@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+//
+// Element-wise kernels count one operation per element and read and write each element once.
+//
+
+static void ReportElementwise(benchmark::State& state, size_t N, size_t element_size) {
+  ReportRoofline(state, static_cast<double>(N), static_cast<double>(2 * N * element_size));
+}
+
+void ACTIVATION(benchmark::State& state, MLAS_ACTIVATION_KIND kind) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  auto buffer = RandomVectorUniform(M * N, -5.0f, 5.0f);
+  auto bias = RandomVectorUniform(M, -1.0f, 1.0f);
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = kind;
+  switch (kind) {
+    case MlasLeakyReluActivation:
+      activation.Parameters.LeakyRelu.alpha = 0.2f;
+      break;
+    case MlasClipActivation:
+      activation.Parameters.Clip.minimum = -1.0f;
+      activation.Parameters.Clip.maximum = 1.0f;
+      break;
+    case MlasHardSigmoidActivation:
+      activation.Parameters.HardSigmoid.alpha = 0.2f;
+      activation.Parameters.HardSigmoid.beta = 0.5f;
+      break;
+    default:
+      break;
+  }
+
+  MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+
+  for (auto _ : state) {
+    MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+  }
+
+  ReportElementwise(state, M * N, sizeof(float));
+}
+
+template <void(MLASCALL* Routine)(const float*, float*, size_t)>
+void TRANSCENDENTAL(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -5.0f, 5.0f);
+  std::vector<float> output(N);
+
+  Routine(input.data(), output.data(), N);
+
+  for (auto _ : state) {
+    Routine(input.data(), output.data(), N);
+  }
+
+  ReportElementwise(state, N, sizeof(float));
+}
+
+static void ActivationSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  b->ArgsProduct({{1, 64}, {1024, 16384}});
+}
+
+static void TranscendentalSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N"});
+  b->Args({1024});
+  b->Args({65536});
+  b->Args({1 << 22});
+}
+
+BENCHMARK_CAPTURE(ACTIVATION, Relu, MlasReluActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, LeakyRelu, MlasLeakyReluActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Tanh, MlasTanhActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Logistic, MlasLogisticActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Clip, MlasClipActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, HardSigmoid, MlasHardSigmoidActivation)->Apply(ActivationSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Gelu, MlasGeluActivation)->Apply(ActivationSizes)->UseRealTime();
+
+BENCHMARK_TEMPLATE(TRANSCENDENTAL, MlasComputeExp)->Apply(TranscendentalSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSCENDENTAL, MlasComputeLogistic)->Apply(TranscendentalSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSCENDENTAL, MlasComputeTanh)->Apply(TranscendentalSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSCENDENTAL, MlasComputeErf)->Apply(TranscendentalSizes)->UseRealTime();
@@ -64,6 +64,8 @@ void COMPUTESOFTMAXINPLACE(benchmark::State& state) {
     MlasComputeSoftmax(input, output, N, D, false, false, tp.get());
   }
 
+  ReportRoofline(state, static_cast<double>(N) * D, 2.0 * N * D * sizeof(float));
+
   free(ptr.underlying_buffer);
 }
 
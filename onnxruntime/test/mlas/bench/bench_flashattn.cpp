@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static const std::vector<std::string> flashattn_bench_arg_names = {"B", "N", "S", "L", "H"};
+
+void FLASHATTENTION(benchmark::State& state) {
+  const int batch_size = static_cast<int>(state.range(0));
+  const int num_heads = static_cast<int>(state.range(1));
+  const int q_sequence_length = static_cast<int>(state.range(2));
+  const int kv_sequence_length = static_cast<int>(state.range(3));
+  const int head_size = static_cast<int>(state.range(4));
+
+  if (batch_size <= 0 || num_heads <= 0 || q_sequence_length <= 0 || kv_sequence_length <= 0 || head_size <= 0) {
+    throw std::invalid_argument("B, N, S, L and H must greater than 0!");
+  }
+
+  const size_t q_size = static_cast<size_t>(batch_size) * num_heads * q_sequence_length * head_size;
+  const size_t kv_size = static_cast<size_t>(batch_size) * num_heads * kv_sequence_length * head_size;
+  auto query = RandomVectorUniform(q_size, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(kv_size, -1.0f, 1.0f);
+  auto value = RandomVectorUniform(kv_size, -1.0f, 1.0f);
+  std::vector<float> output(q_size);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  // Block sizes chosen as the MultiHeadAttention kernel does for a 1MB L2 cache.
+  constexpr int l2_cache_size = 1 << 20;
+  MlasFlashAttentionThreadedArgs args;
+  args.batch_size = batch_size;
+  args.num_heads = num_heads;
+  args.q_sequence_length = q_sequence_length;
+  args.kv_sequence_length = kv_sequence_length;
+  args.qk_head_size = head_size;
+  args.v_head_size = head_size;
+  args.kv_block_size = std::max(l2_cache_size / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size)), 1);
+  args.q_block_size = std::min(std::min(args.kv_block_size, 2 * head_size), q_sequence_length);
+  args.kv_block_size = std::min(args.kv_block_size, kv_sequence_length);
+  args.scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+  args.thread_count = onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(head_size)) *
+                                sizeof(float);
+  std::vector<float> buffer(args.buffer_size_per_thread / sizeof(float) * args.thread_count);
+  args.buffer = buffer.data();
+  args.query = query.data();
+  args.key = key.data();
+  args.value = value.data();
+  args.output = output.data();
+
+  MlasFlashAttention(&args, tp.get());
+
+  for (auto _ : state) {
+    MlasFlashAttention(&args, tp.get());
+  }
+
+  // Q x K^T and the product with V each take 2 x S x L x H operations per head.
+  const double ops = 4.0 * batch_size * num_heads * q_sequence_length * kv_sequence_length * head_size;
+  ReportRoofline(state, ops, static_cast<double>((2 * q_size + 2 * kv_size) * sizeof(float)));
+}
+
+static void FlashAttentionSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(flashattn_bench_arg_names);
+  b->Args({1, 12, 128, 128, 64});
+  b->Args({1, 12, 512, 512, 64});
+  b->Args({1, 32, 1, 2048, 128});
+  b->Args({4, 16, 256, 256, 64});
+}
+
+BENCHMARK(FLASHATTENTION)->Apply(FlashAttentionSizes)->UseRealTime();
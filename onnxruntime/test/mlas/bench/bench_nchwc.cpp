@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+
+static std::unique_ptr<onnxruntime::concurrency::ThreadPool> CreateBenchThreadPool() {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  return std::unique_ptr<onnxruntime::concurrency::ThreadPool>(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+}
+
+//
+// Channel counts are rounded up to the NCHWc block size. The input and filter are random data already in the
+// NCHWc layouts, so only the convolution itself is timed.
+//
+
+void SCONV_NCHWC(benchmark::State& state, bool depthwise) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this platform");
+    return;
+  }
+
+  const int64_t batch_size = state.range(0);
+  const int64_t channels = (state.range(1) + block_size - 1) / block_size * block_size;
+  const int64_t filters = depthwise ? channels : (state.range(2) + block_size - 1) / block_size * block_size;
+  const int64_t height = state.range(3);
+  const int64_t width = state.range(4);
+  const int64_t kernel = state.range(5);
+  const int64_t stride = state.range(6);
+
+  if (batch_size <= 0 || channels <= 0 || filters <= 0 || height <= 0 || width <= 0) {
+    throw std::invalid_argument("N, C, F, H and W must greater than 0!");
+  }
+  if (kernel <= 0 || stride <= 0) {
+    throw std::invalid_argument("K and S must greater than 0!");
+  }
+
+  const int64_t pad = kernel / 2;
+  const int64_t output_height = (height + 2 * pad - kernel) / stride + 1;
+  const int64_t output_width = (width + 2 * pad - kernel) / stride + 1;
+  const int64_t group_count = depthwise ? channels : 1;
+
+  const int64_t input_shape[] = {batch_size, channels, height, width};
+  const int64_t output_shape[] = {batch_size, filters, output_height, output_width};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {pad, pad, pad, pad};
+  const int64_t stride_shape[] = {stride, stride};
+
+  const size_t input_size = static_cast<size_t>(batch_size * channels * height * width);
+  const size_t filter_size = static_cast<size_t>(filters * (channels / group_count) * kernel * kernel);
+  const size_t output_size = static_cast<size_t>(batch_size * filters * output_height * output_width);
+  auto input = RandomVectorUniform(input_size, -1.0f, 1.0f);
+  auto filter = RandomVectorUniform(filter_size, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(static_cast<size_t>(filters), -1.0f, 1.0f);
+  std::vector<float> output(output_size);
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasReluActivation;
+
+  auto tp = CreateBenchThreadPool();
+
+  auto conv = [&]() {
+    MlasNchwcConv(input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(group_count), input.data(), filter.data(), bias.data(), output.data(),
+                  &activation, true, tp.get());
+  };
+
+  conv();
+
+  for (auto _ : state) {
+    conv();
+  }
+
+  ReportRoofline(state, 2.0 * static_cast<double>(output_size) * (channels / group_count) * kernel * kernel,
+                 static_cast<double>((input_size + filter_size + output_size) * sizeof(float)));
+}
+
+void REORDER_NCHWC(benchmark::State& state, bool to_nchwc) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this platform");
+    return;
+  }
+
+  const int64_t channels = (state.range(0) + block_size - 1) / block_size * block_size;
+  const int64_t spatial = state.range(1);
+  if (channels <= 0 || spatial <= 0) {
+    throw std::invalid_argument("C and HW must greater than 0!");
+  }
+
+  const size_t size = static_cast<size_t>(channels * spatial);
+  auto source = RandomVectorUniform(size, -1.0f, 1.0f);
+  std::vector<float> destination(size);
+
+  const int64_t output_shape[] = {1, channels, 1, spatial};
+  auto tp = CreateBenchThreadPool();
+
+  auto reorder = [&]() {
+    if (to_nchwc) {
+      MlasReorderInputNchw(source.data(), destination.data(), static_cast<size_t>(channels),
+                           static_cast<size_t>(spatial));
+    } else {
+      MlasReorderOutputNchw(output_shape, source.data(), destination.data(), tp.get());
+    }
+  };
+
+  reorder();
+
+  for (auto _ : state) {
+    reorder();
+  }
+
+  ReportRoofline(state, 0.0, static_cast<double>(2 * size * sizeof(float)));
+}
+
+static void ConvSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "F", "H", "W", "K", "S"});
+  b->Args({1, 64, 64, 56, 56, 3, 1});
+  b->Args({1, 128, 128, 28, 28, 3, 1});
+  b->Args({1, 256, 256, 14, 14, 3, 1});
+  b->Args({1, 64, 256, 56, 56, 1, 1});
+  b->Args({1, 512, 128, 28, 28, 1, 1});
+  b->Args({1, 256, 512, 28, 28, 3, 2});
+}
+
+static void DepthwiseSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "F", "H", "W", "K", "S"});
+  b->Args({1, 32, 32, 112, 112, 3, 1});
+  b->Args({1, 144, 144, 56, 56, 3, 2});
+  b->Args({1, 384, 384, 14, 14, 3, 1});
+  b->Args({1, 960, 960, 7, 7, 5, 1});
+}
+
+static void ReorderSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "HW"});
+  b->ArgsProduct({{64, 256}, {196, 3136}});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHWC, Conv, false)->Apply(ConvSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHWC, Depthwise, true)->Apply(DepthwiseSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REORDER_NCHWC, InputNchw, true)->Apply(ReorderSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REORDER_NCHWC, OutputNchw, false)->Apply(ReorderSizes)->UseRealTime();
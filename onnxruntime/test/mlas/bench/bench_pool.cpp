@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> pool_bench_arg_names = {"N", "C", "H", "W", "K", "S"};
+
+//
+// Pooling counts one operation per input element of each window.
+//
+
+void POOL2D(benchmark::State& state, MLAS_POOLING_KIND kind, bool nchwc) {
+  const int64_t batch_size = state.range(0);
+  int64_t channels = state.range(1);
+  const int64_t height = state.range(2);
+  const int64_t width = state.range(3);
+  const int64_t kernel = state.range(4);
+  const int64_t stride = state.range(5);
+
+  if (batch_size <= 0 || channels <= 0 || height <= 0 || width <= 0) {
+    throw std::invalid_argument("N, C, H and W must greater than 0!");
+  }
+  if (kernel <= 0 || stride <= 0 || kernel > height || kernel > width) {
+    throw std::invalid_argument("K and S must greater than 0 and K must fit in the input!");
+  }
+
+  if (nchwc) {
+    const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+    if (block_size <= 1) {
+      state.SkipWithError("NCHWc is not supported on this platform");
+      return;
+    }
+    channels = (channels + block_size - 1) / block_size * block_size;
+  }
+
+  const int64_t output_height = (height - kernel) / stride + 1;
+  const int64_t output_width = (width - kernel) / stride + 1;
+
+  const int64_t input_shape[] = {batch_size, channels, height, width};
+  const int64_t output_shape[] = {batch_size, channels, output_height, output_width};
+  const int64_t kernel_shape[] = {kernel, kernel};
+  const int64_t padding[] = {0, 0, 0, 0};
+  const int64_t stride_shape[] = {stride, stride};
+
+  const size_t input_size = static_cast<size_t>(batch_size * channels * height * width);
+  const size_t output_size = static_cast<size_t>(batch_size * channels * output_height * output_width);
+  auto input = RandomVectorUniform(input_size, -1.0f, 1.0f);
+  std::vector<float> output(output_size);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto pool = [&]() {
+    if (nchwc) {
+      MlasNchwcPool(kind, input_shape, kernel_shape, nullptr, padding, stride_shape, output_shape,
+                    input.data(), output.data(), tp.get());
+    } else {
+      MlasPool(kind, 2, input_shape, kernel_shape, padding, stride_shape, output_shape,
+               input.data(), output.data(), tp.get());
+    }
+  };
+
+  pool();
+
+  for (auto _ : state) {
+    pool();
+  }
+
+  ReportRoofline(state, static_cast<double>(output_size * kernel * kernel),
+                 static_cast<double>((input_size + output_size) * sizeof(float)));
+}
+
+static void PoolSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(pool_bench_arg_names);
+  b->Args({1, 64, 112, 112, 3, 2});
+  b->Args({1, 256, 56, 56, 2, 2});
+  b->Args({1, 512, 28, 28, 3, 1});
+  b->Args({1, 2048, 7, 7, 7, 1});
+}
+
+BENCHMARK_CAPTURE(POOL2D, Max, MlasMaximumPooling, false)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, AverageExcludePad, MlasAveragePoolingExcludePad, false)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, AverageIncludePad, MlasAveragePoolingIncludePad, false)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, NchwcMax, MlasMaximumPooling, true)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, NchwcAverageExcludePad, MlasAveragePoolingExcludePad, true)->Apply(PoolSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL2D, NchwcAverageIncludePad, MlasAveragePoolingIncludePad, true)->Apply(PoolSizes)->UseRealTime();
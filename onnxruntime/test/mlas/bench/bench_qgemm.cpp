@@ -76,6 +76,9 @@ void QGEMM(benchmark::State& state, bool pack_b, bool a_is_signed) {
   for (auto _ : state) {
     MlasGemmBatch(gemm_shape, gemm_data_vec.data(), batch, tp.get());
   }
+
+  ReportRoofline(state, 2.0 * M * N * K * batch,
+                 static_cast<double>((M * K + N * K + M * N * sizeof(int32_t)) * batch));
 }
 
 static void QGemmSize(benchmark::internal::Benchmark* b) {
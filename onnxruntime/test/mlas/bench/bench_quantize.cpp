@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+template <typename OutputType>
+void QUANTIZELINEAR(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -10.0f, 10.0f);
+  std::vector<OutputType> output(N);
+  const float scale = 0.08f;
+  const OutputType zero_point = std::is_signed<OutputType>::value ? 0 : 128;
+
+  MlasQuantizeLinear(input.data(), output.data(), N, scale, zero_point);
+
+  for (auto _ : state) {
+    MlasQuantizeLinear(input.data(), output.data(), N, scale, zero_point);
+  }
+
+  ReportRoofline(state, static_cast<double>(N), static_cast<double>(N * (sizeof(float) + sizeof(OutputType))));
+}
+
+void QUANTIZELINEAR_INT4(benchmark::State& state, bool is_signed) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -10.0f, 10.0f);
+  std::vector<uint8_t> output((N + 1) / 2);
+  const float scale = 1.5f;
+
+  auto quantize = [&]() {
+    if (is_signed) {
+      MlasQuantizeLinearS4(input.data(), output.data(), N, scale, 0);
+    } else {
+      MlasQuantizeLinearU4(input.data(), output.data(), N, scale, 8);
+    }
+  };
+
+  quantize();
+
+  for (auto _ : state) {
+    quantize();
+  }
+
+  ReportRoofline(state, static_cast<double>(N), static_cast<double>(N * sizeof(float) + output.size()));
+}
+
+static void QuantizeSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N"});
+  b->Args({1024});
+  b->Args({65536});
+  b->Args({1 << 22});
+}
+
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, int8_t)->Apply(QuantizeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, uint8_t)->Apply(QuantizeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, int16_t)->Apply(QuantizeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, uint16_t)->Apply(QuantizeSizes)->UseRealTime();
+BENCHMARK_CAPTURE(QUANTIZELINEAR_INT4, S4, true)->Apply(QuantizeSizes)->UseRealTime();
+BENCHMARK_CAPTURE(QUANTIZELINEAR_INT4, U4, false)->Apply(QuantizeSizes)->UseRealTime();
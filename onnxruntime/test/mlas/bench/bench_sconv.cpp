@@ -136,6 +136,11 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
              Y.data(),
              nullptr);
   }
+
+  const int64_t kernel_size =
+      std::accumulate(kernel_shape.begin(), kernel_shape.end(), 1LL, std::multiplies<int64_t>());
+  ReportRoofline(state, 2.0 * static_cast<double>(y_size) * input_channels_per_group * kernel_size,
+                 static_cast<double>((X.size() + F.size() + Y.size()) * sizeof(float)));
 }
 
 static void ResNet50(benchmark::internal::Benchmark* b) {
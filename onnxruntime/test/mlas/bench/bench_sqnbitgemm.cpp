@@ -95,6 +95,10 @@ void RunSQNBitGemmBenchmark(size_t BlkLen,
   for (auto _ : state) {
     MlasSQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, ComputeType, &params, Workspace.get(), tp.get());
   }
+
+  ReportRoofline(state, 2.0 * M * N * K,
+                 static_cast<double>((M * K + M * N) * sizeof(float) + QuantBDataSizeInBytes +
+                                     QuantBScaleSize * sizeof(float) + QuantBZeroPoint.size()));
 }
 
 template <size_t BlkBitWidth>
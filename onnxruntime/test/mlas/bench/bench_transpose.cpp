@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+template <typename ElementType>
+void TRANSPOSE(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  std::vector<ElementType> input(M * N);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<ElementType>(i);
+  }
+  std::vector<ElementType> output(M * N);
+
+  MlasTranspose(input.data(), output.data(), M, N);
+
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), M, N);
+  }
+
+  ReportRoofline(state, 0.0, static_cast<double>(2 * M * N * sizeof(ElementType)));
+}
+
+static void TransposeSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  b->ArgsProduct({{64, 197, 1024}, {64, 768, 4096}});
+}
+
+BENCHMARK_TEMPLATE(TRANSPOSE, float)->Apply(TransposeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSPOSE, uint16_t)->Apply(TransposeSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSPOSE, uint8_t)->Apply(TransposeSizes)->UseRealTime();
@@ -2,8 +2,11 @@
 // Licensed under the MIT License.
 
 #include "bench_util.h"
+#include "core/platform/env_var_utils.h"
+#include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <string>
 
 std::vector<int64_t> BenchArgsVector(benchmark::State& state, size_t& start, size_t count) {
   std::vector<int64_t> shape;
@@ -22,3 +25,32 @@ std::vector<float> RandomVectorUniform(std::vector<int64_t> shape, float min_val
   }
   return RandomVectorUniform(static_cast<size_t>(sz), min_value, max_value);
 }
+
+void ReportRoofline(benchmark::State& state, double ops, double bytes) {
+  using onnxruntime::ParseEnvironmentVariableWithDefault;
+  static const double peak_ops = ParseEnvironmentVariableWithDefault<double>("MLAS_BENCH_PEAK_GFLOPS", 0.0) * 1e9;
+  static const double peak_bytes = ParseEnvironmentVariableWithDefault<double>("MLAS_BENCH_PEAK_GBPS", 0.0) * 1e9;
+  static const std::string isa = onnxruntime::Env::Default().GetEnvironmentVar("ORT_MLAS_MAXIMUM_ISA");
+
+  using benchmark::Counter;
+  if (ops > 0) {
+    state.counters["FLOP/s"] = Counter(ops, Counter::kIsIterationInvariantRate);
+  }
+  state.counters["Bytes/s"] = Counter(bytes, Counter::kIsIterationInvariantRate);
+
+  const double intensity = bytes > 0 ? ops / bytes : 0.0;
+  state.counters["AI"] = intensity;
+
+  if (peak_ops > 0 && ops > 0) {
+    state.counters["%PeakFLOP"] = Counter(ops * 100 / peak_ops, Counter::kIsIterationInvariantRate);
+  }
+  if (peak_bytes > 0) {
+    state.counters["%PeakBW"] = Counter(bytes * 100 / peak_bytes, Counter::kIsIterationInvariantRate);
+  }
+  if (peak_ops > 0 && peak_bytes > 0 && ops > 0) {
+    const double attainable = std::min(peak_ops, intensity * peak_bytes);
+    state.counters["%Roofline"] = Counter(ops * 100 / attainable, Counter::kIsIterationInvariantRate);
+  }
+
+  state.SetLabel("isa:" + (isa.empty() ? std::string("native") : isa));
+}
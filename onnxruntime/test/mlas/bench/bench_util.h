@@ -29,3 +29,10 @@ std::vector<ElementType> RandomVectorUniform(
 std::vector<float> RandomVectorUniform(std::vector<int64_t> shape, float min_value, float max_value);
 
 std::vector<int64_t> BenchArgsVector(benchmark::State& state, size_t& start, size_t count);
+
+// Adds the throughput counters of a kernel that performs `ops` arithmetic operations and moves `bytes` bytes of
+// memory per iteration: achieved FLOP/s and bytes/s, the arithmetic intensity (AI, operations per byte) and, when the
+// machine peaks are given by the MLAS_BENCH_PEAK_GFLOPS and MLAS_BENCH_PEAK_GBPS environment variables, the percent
+// of peak compute, of peak bandwidth and of the roofline bound min(peak compute, AI x peak bandwidth). The label
+// records the ORT_MLAS_MAXIMUM_ISA dispatch limit so runs with different limits can be compared.
+void ReportRoofline(benchmark::State& state, double ops, double bytes);
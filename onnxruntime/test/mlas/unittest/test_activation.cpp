@@ -204,7 +204,7 @@ class MlasActivationTest : public MlasTestBase {
     MLAS_ACTIVATION Activation;
     AliasedValue Buffer[_countof(TestData)];
 
-    for (unsigned kind = 0; kind < unsigned(MlasActivationKindCount); kind++) {
+    for (unsigned kind = 0; kind < unsigned(_countof(TestData[0])); kind++) {
       Activation.ActivationKind = MLAS_ACTIVATION_KIND(kind);
 
       if (Activation.ActivationKind == MlasLeakyReluActivation) {
@@ -253,6 +253,27 @@ class MlasActivationTest : public MlasTestBase {
             << std::setw(8) << std::setfill('0') << std::hex << TestData[i][kind].u;
       }
     }
+
+    //
+    // Test the GELU activation against the erf based definition.
+    //
+
+    Activation.ActivationKind = MlasGeluActivation;
+
+    std::vector<float> Values(301);
+    for (size_t i = 0; i < Values.size(); i++) {
+      Values[i] = -7.5f + 0.05f * static_cast<float>(i);
+    }
+
+    std::vector<float> Output(Values);
+    MlasActivation(&Activation, Output.data(), nullptr, 1, Output.size(), Output.size());
+
+    for (size_t i = 0; i < Values.size(); i++) {
+      const float x = Values[i];
+      const float expected = 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752440f));
+      EXPECT_NEAR(Output[i], expected, 1e-5f + 1e-5f * std::fabs(expected))
+          << ", GELU Activation, x=" << x;
+    }
   }
 };
 
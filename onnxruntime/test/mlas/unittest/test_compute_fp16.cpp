@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+//
+// Storage and conversions of the 16 bit types. The library routines are
+// compared against the single precision routines applied to the widened input.
+//
+
+struct MlasFp16Traits {
+  using MlasType = MLAS_FP16;
+  static constexpr const char* Name = "Fp16";
+  static constexpr float Tolerance = 1.0f / 1024.0f;
+
+  static float ToFloat(uint16_t v) { return MLAS_Half2Float(v); }
+  static uint16_t FromFloat(float f) { return MLAS_Float2Half(f); }
+};
+
+struct MlasBf16Traits {
+  using MlasType = MLAS_BF16;
+  static constexpr const char* Name = "Bf16";
+  static constexpr float Tolerance = 1.0f / 128.0f;
+
+  static float ToFloat(uint16_t v) {
+    const uint32_t bits = uint32_t(v) << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+  static uint16_t FromFloat(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return uint16_t((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+  }
+};
+
+template <typename Traits, bool Threaded>
+class MlasCompute16BitTest : public MlasTestBase {
+ private:
+  using MlasType = typename Traits::MlasType;
+
+  MLAS_THREADPOOL* threadpool_;
+
+  static const MlasType* AsMlas(const uint16_t* p) { return reinterpret_cast<const MlasType*>(p); }
+  static MlasType* AsMlas(uint16_t* p) { return reinterpret_cast<MlasType*>(p); }
+
+  void CheckClose(const std::vector<uint16_t>& Output, const std::vector<float>& Reference, const char* Routine,
+                  size_t N) {
+    for (size_t i = 0; i < Output.size(); i++) {
+      const float value = Traits::ToFloat(Output[i]);
+      const float diff = std::fabs(value - Reference[i]);
+      ASSERT_TRUE(diff <= Traits::Tolerance || diff <= std::fabs(Reference[i]) * Traits::Tolerance)
+          << Traits::Name << " " << Routine << " N=" << N << " i=" << i << ", got: " << value
+          << ", expecting: " << Reference[i];
+    }
+  }
+
+  void TestUnary(size_t N) {
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-8.0f, 8.0f);
+
+    std::vector<uint16_t> Input(N);
+    std::vector<float> InputFloat(N);
+    for (size_t i = 0; i < N; i++) {
+      Input[i] = Traits::FromFloat(distribution(generator));
+      InputFloat[i] = Traits::ToFloat(Input[i]);
+    }
+
+    std::vector<uint16_t> Output(N);
+    std::vector<float> Reference(N);
+
+    MlasComputeExp(AsMlas(Input.data()), AsMlas(Output.data()), N);
+    MlasComputeExp(InputFloat.data(), Reference.data(), N);
+    CheckClose(Output, Reference, "Exp", N);
+
+    MlasComputeTanh(AsMlas(Input.data()), AsMlas(Output.data()), N);
+    MlasComputeTanh(InputFloat.data(), Reference.data(), N);
+    CheckClose(Output, Reference, "Tanh", N);
+
+    MlasComputeErf(AsMlas(Input.data()), AsMlas(Output.data()), N);
+    MlasComputeErf(InputFloat.data(), Reference.data(), N);
+    CheckClose(Output, Reference, "Erf", N);
+
+    MlasComputeLogistic(AsMlas(Input.data()), AsMlas(Output.data()), N);
+    MlasComputeLogistic(InputFloat.data(), Reference.data(), N);
+    CheckClose(Output, Reference, "Logistic", N);
+
+    // in place
+    Output = Input;
+    MlasComputeLogistic(AsMlas(Output.data()), AsMlas(Output.data()), N);
+    CheckClose(Output, Reference, "Logistic in place", N);
+  }
+
+  void TestSoftmax(size_t N, size_t D, float MinimumValue, float MaximumValue) {
+    std::default_random_engine generator(static_cast<unsigned>(N * D));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    std::vector<uint16_t> Input(N * D);
+    std::vector<float> InputFloat(N * D);
+    for (size_t i = 0; i < N * D; i++) {
+      Input[i] = Traits::FromFloat(distribution(generator));
+      InputFloat[i] = Traits::ToFloat(Input[i]);
+    }
+
+    std::vector<uint16_t> Output(N * D);
+    std::vector<float> Reference(N * D);
+
+    for (bool LogSoftmax : {false, true}) {
+      for (bool SmoothSoftmax : {false, true}) {
+        MlasComputeSoftmax(AsMlas(Input.data()), AsMlas(Output.data()), N, D, LogSoftmax, SmoothSoftmax, threadpool_);
+        MlasComputeSoftmax(InputFloat.data(), Reference.data(), N, D, LogSoftmax, SmoothSoftmax, nullptr);
+        CheckClose(Output, Reference, LogSoftmax ? "LogSoftmax" : "Softmax", D);
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("Compute") + Traits::Name +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasCompute16BitTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t n : {1, 7, 16, 1023, 1024, 3001}) {
+      TestUnary(n);
+    }
+
+    for (size_t d = 1; d < 64; d += 5) {
+      TestSoftmax(1, d, -10.f, 10.f);
+    }
+
+    TestSoftmax(3, 128, 20.f, 30.f);
+    TestSoftmax(29, 95, -15.f, 19.f);
+
+    // rows that span multiple blocks
+    TestSoftmax(4, 1024, -10.f, 10.f);
+    TestSoftmax(5, 2500, -10.f, 10.f);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasCompute16BitTest<MlasFp16Traits, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasCompute16BitTest<MlasBf16Traits, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasCompute16BitTest<MlasFp16Traits, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasCompute16BitTest<MlasBf16Traits, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasConv2DWinogradTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferPackedFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorking;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(MLAS_CONV_WINOGRAD_TILE Tile, size_t BatchCount, size_t GroupCount, size_t InputChannels,
+            size_t InputHeight, size_t InputWidth, size_t FilterCount, size_t Padding, float Beta,
+            bool ExpectWinograd) {
+    const size_t OutputHeight = InputHeight + 2 * Padding - 2;
+    const size_t OutputWidth = InputWidth + 2 * Padding - 2;
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    const size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * 9;
+    const size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+    std::default_random_engine generator(static_cast<unsigned>(InputChannels * 131 + InputHeight * 17 + Tile));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto RandomBuffer = [&](MatrixGuardBuffer<float>& Buffer, size_t Elements) {
+      float* p = Buffer.GetBuffer(Elements);
+      for (size_t i = 0; i < Elements; i++) {
+        p[i] = distribution(generator);
+      }
+      return p;
+    };
+
+    const float* Input = RandomBuffer(BufferInput, InputElements);
+    const float* Filter = RandomBuffer(BufferFilter, FilterElements);
+    const float* Bias = RandomBuffer(BufferBias, GroupCount * FilterCount);
+    float* Output = RandomBuffer(BufferOutput, OutputElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+    for (size_t bg = 0; bg < BatchCount * GroupCount; bg++) {
+      const size_t g = bg % GroupCount;
+      for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t oh = 0; oh < OutputHeight; oh++) {
+          for (size_t ow = 0; ow < OutputWidth; ow++) {
+            double sum = Bias[g * FilterCount + f];
+            for (size_t c = 0; c < InputChannels; c++) {
+              for (size_t ky = 0; ky < 3; ky++) {
+                const size_t ih = oh + ky - Padding;
+                for (size_t kx = 0; kx < 3; kx++) {
+                  const size_t iw = ow + kx - Padding;
+                  if (ih < InputHeight && iw < InputWidth) {
+                    sum += double(Input[(bg * InputChannels + c) * InputSize + ih * InputWidth + iw]) *
+                           double(Filter[((g * FilterCount + f) * InputChannels + c) * 9 + ky * 3 + kx]);
+                  }
+                }
+              }
+            }
+            float* output = Output + (bg * FilterCount + f) * OutputSize + oh * OutputWidth + ow;
+            OutputReference[output - Output] = std::max(float(sum) + Beta * *output, 0.0f);
+          }
+        }
+      }
+    }
+
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {3, 3};
+    int64_t DilationShape[] = {1, 1};
+    int64_t PaddingShape[] = {int64_t(Padding), int64_t(Padding), int64_t(Padding), int64_t(Padding)};
+    int64_t StrideShape[] = {1, 1};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape, KernelShape, DilationShape,
+                    PaddingShape, StrideShape, OutputShape, FilterCount, &Activation, &WorkingBufferSize, Beta,
+                    threadpool_, Tile);
+
+    ASSERT_EQ(Parameters.Algorithm == MlasConvAlgorithmWinograd, ExpectWinograd)
+        << "tile " << Tile << " Cpg " << InputChannels << " Fpg " << FilterCount;
+
+    float* PackedFilter = BufferPackedFilter.GetBuffer(
+        MlasConvWinogradPackFilterSize(Tile, GroupCount, InputChannels, FilterCount));
+    MlasConvWinogradPackFilter(Tile, GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+
+    MlasConv(&Parameters, Input, Filter, Bias, BufferWorking.GetBuffer(WorkingBufferSize), Output, threadpool_,
+             PackedFilter);
+
+    // Larger tiles trade accuracy for fewer multiplies. The rounding error
+    // grows with the square root of the number of accumulated products.
+    const float TileTolerance = (Tile == MlasConvWinogradF2x2) ? 1e-6f : (Tile == MlasConvWinogradF4x4) ? 1e-5f : 1e-4f;
+    const float Tolerance = TileTolerance * std::sqrt(float(InputChannels * 9));
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      const float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= Tolerance)
+          << "tile " << Tile << " B" << BatchCount << "/G" << GroupCount << "/Cpg" << InputChannels << "/Fpg"
+          << FilterCount << "/H" << InputHeight << "/W" << InputWidth << "/Pad" << Padding << " beta " << Beta
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i] << " at " << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2dWinograd_Threaded" : "Conv2dWinograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasConv2DWinogradTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (MLAS_CONV_WINOGRAD_TILE Tile : {MlasConvWinogradF2x2, MlasConvWinogradF4x4, MlasConvWinogradF6x6}) {
+      Test(Tile, 1, 1, 16, 14, 14, 16, 1, 0.0f, true);
+      Test(Tile, 2, 1, 32, 17, 23, 24, 1, 0.0f, true);
+      Test(Tile, 1, 2, 16, 29, 11, 32, 0, 1.0f, true);
+      Test(Tile, 1, 1, 64, 56, 56, 64, 1, 0.0f, true);
+      // too few channels or an output smaller than a tile use the GEMM algorithms
+      Test(Tile, 1, 1, 8, 14, 14, 16, 1, 0.0f, false);
+      Test(Tile, 1, 1, 16, 3, 3, 16, 0, 0.0f, false);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasEltwiseBinaryTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInputA;
+  MatrixGuardBuffer<float> BufferInputB;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static float Reference(MLAS_ELTWISE_BINARY_KIND Kind, float A, float B) {
+    switch (Kind) {
+      case MlasEltwiseAdd:
+        return A + B;
+      case MlasEltwiseSub:
+        return A - B;
+      case MlasEltwiseMul:
+        return A * B;
+      default:
+        return A / B;
+    }
+  }
+
+  void Test(MLAS_ELTWISE_BINARY_KIND Kind, size_t N, size_t StrideA, size_t StrideB) {
+    const size_t SizeA = StrideA == 0 ? 1 : N * StrideA;
+    const size_t SizeB = StrideB == 0 ? 1 : N * StrideB;
+    float* InputA = BufferInputA.GetBuffer(SizeA);
+    float* InputB = BufferInputB.GetBuffer(SizeB);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    for (size_t i = 0; i < SizeA; i++) {
+      InputA[i] = float((i * 7) % 23) - 11.0f;
+    }
+    for (size_t i = 0; i < SizeB; i++) {
+      InputB[i] = float((i * 5) % 19) + 0.5f;
+    }
+
+    MlasEltwiseBinary(Kind, InputA, StrideA, InputB, StrideB, Output, N);
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Output[n], Reference(Kind, InputA[n * StrideA], InputB[n * StrideB]))
+          << "Kind " << int(Kind) << " N " << N << " strides " << StrideA << "," << StrideB << " at " << n;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("EltwiseBinary");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (auto Kind : {MlasEltwiseAdd, MlasEltwiseSub, MlasEltwiseMul, MlasEltwiseDiv}) {
+      for (size_t N : {1, 3, 4, 7, 15, 16, 17, 33, 255}) {
+        Test(Kind, N, 1, 1);
+        Test(Kind, N, 0, 1);
+        Test(Kind, N, 1, 0);
+        Test(Kind, N, 2, 3);
+        Test(Kind, N, 0, 0);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasEltwiseBinaryTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorkspace;
+  MLAS_THREADPOOL* threadpool_;
+
+  //
+  // Query is BxNxSxH, key and value are BxN_kvxLxH where only the first kv_lengths[b] of L are valid,
+  // output is BxSxNxH.
+  //
+  void ReferenceAttention(const float* Query, const float* Key, const float* Value, float* Output,
+                          size_t B, size_t N, size_t N_kv, size_t S, size_t L, size_t H, float Scale,
+                          const int32_t* KvLengths, bool Causal, const int32_t* PastLengths, int LocalWindowSize) {
+    std::vector<double> Scores(L);
+    for (size_t b = 0; b < B; b++) {
+      for (size_t n = 0; n < N; n++) {
+        const size_t n_kv = n / (N / N_kv);
+        const float* k = Key + (b * N_kv + n_kv) * L * H;
+        const float* v = Value + (b * N_kv + n_kv) * L * H;
+        for (size_t s = 0; s < S; s++) {
+          const float* q = Query + ((b * N + n) * S + s) * H;
+          float* o = Output + ((b * S + s) * N + n) * H;
+
+          const size_t past = PastLengths != nullptr ? static_cast<size_t>(PastLengths[b]) : 0;
+          const size_t kv_length = static_cast<size_t>(KvLengths[b]);
+          const size_t end = Causal ? (std::min)(past + s + 1, kv_length) : kv_length;
+          const size_t begin = (LocalWindowSize > 0 && end > static_cast<size_t>(LocalWindowSize) + 1)
+                                   ? end - LocalWindowSize - 1
+                                   : 0;
+
+          double MaximumValue = std::numeric_limits<double>::lowest();
+          for (size_t l = begin; l < end; l++) {
+            double dot = 0.0;
+            for (size_t h = 0; h < H; h++) {
+              dot += double(q[h]) * double(k[l * H + h]);
+            }
+            Scores[l] = dot * Scale;
+            MaximumValue = (std::max)(MaximumValue, Scores[l]);
+          }
+
+          double Sum = 0.0;
+          for (size_t l = begin; l < end; l++) {
+            Scores[l] = std::exp(Scores[l] - MaximumValue);
+            Sum += Scores[l];
+          }
+
+          for (size_t h = 0; h < H; h++) {
+            double Accumulator = 0.0;
+            for (size_t l = begin; l < end; l++) {
+              Accumulator += Scores[l] * double(v[l * H + h]);
+            }
+            o[h] = Sum > 0.0 ? float(Accumulator / Sum) : 0.0f;
+          }
+        }
+      }
+    }
+  }
+
+  void Test(size_t B, size_t N, size_t N_kv, size_t S, size_t L, size_t H, bool Causal, bool TokenGeneration,
+            int LocalWindowSize, int QBlockSize, int KvBlockSize) {
+    const size_t QuerySize = B * N * S * H;
+    const size_t KvSize = B * N_kv * L * H;
+    float* Query = BufferQuery.GetBuffer(QuerySize);
+    float* Key = BufferKey.GetBuffer(KvSize);
+    float* Value = BufferValue.GetBuffer(KvSize);
+    float* Output = BufferOutput.GetBuffer(QuerySize);
+    float* OutputReference = BufferOutputReference.GetBuffer(QuerySize);
+
+    std::default_random_engine generator(static_cast<unsigned>(QuerySize + KvSize));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < QuerySize; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < KvSize; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+
+    // every other batch has a shorter, padded key and value
+    std::vector<int32_t> KvLengths(B);
+    std::vector<int32_t> PastLengths(B);
+    for (size_t b = 0; b < B; b++) {
+      KvLengths[b] = static_cast<int32_t>(b % 2 == 0 ? L : (L + 1) / 2);
+      PastLengths[b] = KvLengths[b] - 1;
+    }
+
+    const float Scale = 1.0f / std::sqrt(static_cast<float>(H));
+    const int ThreadCount = Threaded ? 4 : 1;
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = static_cast<int>(B);
+    args.num_heads = static_cast<int>(N);
+    args.kv_num_heads = static_cast<int>(N_kv);
+    args.q_sequence_length = static_cast<int>(S);
+    args.kv_sequence_length = static_cast<int>(L);
+    args.qk_head_size = static_cast<int>(H);
+    args.v_head_size = static_cast<int>(H);
+    args.q_block_size = (std::min)(QBlockSize, static_cast<int>(S));
+    args.kv_block_size = KvBlockSize;
+    args.scale = Scale;
+    args.thread_count = ThreadCount;
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * KvBlockSize +
+                                   static_cast<size_t>(args.q_block_size) * H) *
+                                  sizeof(float);
+    args.buffer = BufferWorkspace.GetBuffer(args.buffer_size_per_thread / sizeof(float) * ThreadCount);
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+    args.kv_sequence_lengths = KvLengths.data();
+    args.causal = Causal;
+    args.past_sequence_lengths = TokenGeneration ? PastLengths.data() : nullptr;
+    args.local_window_size = LocalWindowSize;
+
+    MlasFlashAttention(&args, threadpool_);
+    ReferenceAttention(Query, Key, Value, OutputReference, B, N, N_kv, S, L, H, Scale, KvLengths.data(), Causal,
+                       TokenGeneration ? PastLengths.data() : nullptr, LocalWindowSize);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-5f;
+
+    for (size_t i = 0; i < QuerySize; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B/N/N_kv/S/L/H " << B << "/" << N << "/" << N_kv << "/" << S << "/" << L << "/" << H
+          << " causal:" << Causal << " window:" << LocalWindowSize << " blocks:" << QBlockSize << "/" << KvBlockSize
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (int QBlockSize : {1, 3, 16}) {
+      for (int KvBlockSize : {1, 4, 32}) {
+        // multi-head attention
+        Test(2, 4, 4, 9, 9, 16, false, false, -1, QBlockSize, KvBlockSize);
+        Test(2, 4, 4, 9, 9, 16, true, false, -1, QBlockSize, KvBlockSize);
+        Test(1, 2, 2, 5, 17, 8, false, false, -1, QBlockSize, KvBlockSize);
+        // grouped query attention: prompt, token generation, and local window
+        Test(2, 8, 2, 11, 11, 16, true, false, -1, QBlockSize, KvBlockSize);
+        Test(2, 8, 2, 1, 24, 16, true, true, -1, QBlockSize, KvBlockSize);
+        Test(2, 8, 4, 11, 11, 16, true, false, 3, QBlockSize, KvBlockSize);
+        Test(2, 8, 4, 1, 24, 16, true, true, 5, QBlockSize, KvBlockSize);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasLayerNormalizationTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferShift;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferSumOutput;
+
+  void Test(size_t N, bool UseSkip, bool UseBias, bool UseShift, bool UseSumOutput, bool Simplified) {
+    std::default_random_engine generator(
+        static_cast<unsigned>(N * 31 + UseSkip * 8 + UseBias * 4 + UseShift * 2 + Simplified));
+    std::uniform_real_distribution<float> distribution(-2.0f, 3.0f);
+    auto RandomBuffer = [&](MatrixGuardBuffer<float>& Buffer) {
+      float* p = Buffer.GetBuffer(N);
+      for (size_t i = 0; i < N; i++) {
+        p[i] = distribution(generator);
+      }
+      return p;
+    };
+
+    const float* Input = RandomBuffer(BufferInput);
+    const float* Skip = UseSkip ? RandomBuffer(BufferSkip) : nullptr;
+    const float* Bias = UseBias ? RandomBuffer(BufferBias) : nullptr;
+    const float* Scale = RandomBuffer(BufferScale);
+    const float* Shift = UseShift ? RandomBuffer(BufferShift) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N);
+    float* SumOutput = UseSumOutput ? BufferSumOutput.GetBuffer(N) : nullptr;
+    const float Epsilon = 1e-5f;
+
+    std::vector<double> Row(N);
+    double Sum = 0.0;
+    double SumSquares = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      Row[n] = double(Input[n]) + (Skip ? double(Skip[n]) : 0.0) + (Bias ? double(Bias[n]) : 0.0);
+      Sum += Row[n];
+      SumSquares += Row[n] * Row[n];
+    }
+    const double Mean = Sum / N;
+    const double Variance = Simplified ? SumSquares / N : SumSquares / N - Mean * Mean;
+    const double InvStdDev = 1.0 / std::sqrt(Variance + Epsilon);
+
+    float MeanOutput;
+    float InvStdDevOutput;
+    MlasLayerNormalization(Input, Skip, Bias, Scale, Shift, Output, SumOutput, N, Epsilon, Simplified,
+                           &MeanOutput, &InvStdDevOutput);
+
+    ASSERT_NEAR(MeanOutput, Mean, 1e-5 * (1.0 + std::abs(Mean))) << " N " << N;
+    ASSERT_NEAR(InvStdDevOutput, InvStdDev, 1e-4 * InvStdDev) << " N " << N;
+
+    for (size_t n = 0; n < N; n++) {
+      double Expected = (Row[n] - (Simplified ? 0.0 : Mean)) * InvStdDev * Scale[n];
+      if (Shift != nullptr && !Simplified) {
+        Expected += Shift[n];
+      }
+      ASSERT_NEAR(Output[n], Expected, 1e-4 * (1.0 + std::abs(Expected)))
+          << " N " << N << " skip " << UseSkip << " bias " << UseBias << " simplified " << Simplified << " at " << n;
+      if (SumOutput != nullptr) {
+        ASSERT_NEAR(SumOutput[n], Row[n], 1e-5 * (1.0 + std::abs(Row[n])));
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LayerNormalization");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t N : {1, 3, 4, 7, 8, 9, 16, 63, 768, 1027}) {
+      for (bool Simplified : {false, true}) {
+        Test(N, false, false, false, false, Simplified);
+        Test(N, false, false, true, false, Simplified);
+        Test(N, true, false, true, false, Simplified);
+        Test(N, true, true, true, false, Simplified);
+        Test(N, true, true, false, true, Simplified);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormalizationTest>::RegisterShortExecute();
+  }
+  return count;
+});
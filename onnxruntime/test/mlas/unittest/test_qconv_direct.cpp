@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <typename InputType, typename FilterType>
+class MlasConvDirectQuantTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<InputType> BufferInput;
+  MatrixGuardBuffer<FilterType> BufferFilter;
+  MatrixGuardBuffer<int32_t> BufferOutput;
+  MatrixGuardBuffer<int32_t> BufferOutputReference;
+
+  void Test(size_t InputChannels, size_t InputHeight, size_t InputWidth, size_t FilterCount, size_t KernelSize,
+            size_t Padding, size_t Stride, size_t Dilation) {
+    const size_t OutputHeight = (InputHeight + 2 * Padding - Dilation * (KernelSize - 1) - 1) / Stride + 1;
+    const size_t OutputWidth = (InputWidth + 2 * Padding - Dilation * (KernelSize - 1) - 1) / Stride + 1;
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    std::default_random_engine generator(static_cast<unsigned>(InputChannels * 131 + FilterCount * 7 + KernelSize));
+    std::uniform_int_distribution<int> distribution(std::numeric_limits<InputType>::min(),
+                                                    std::numeric_limits<InputType>::max());
+    std::uniform_int_distribution<int> filter_distribution(std::numeric_limits<FilterType>::min(),
+                                                           std::numeric_limits<FilterType>::max());
+
+    const int32_t InputZeroPoint = distribution(generator);
+    const int32_t FilterZeroPoint = filter_distribution(generator);
+
+    InputType* Input = BufferInput.GetBuffer(InputHeight * InputWidth * InputChannels);
+    for (size_t i = 0; i < InputHeight * InputWidth * InputChannels; i++) {
+      Input[i] = static_cast<InputType>(distribution(generator));
+    }
+
+    // HWIO
+    FilterType* Filter = BufferFilter.GetBuffer(KernelSize * KernelSize * InputChannels * FilterCount);
+    for (size_t i = 0; i < KernelSize * KernelSize * InputChannels * FilterCount; i++) {
+      Filter[i] = static_cast<FilterType>(filter_distribution(generator));
+    }
+
+    int32_t* Output = BufferOutput.GetBuffer(OutputSize * FilterCount);
+    int32_t* OutputReference = BufferOutputReference.GetBuffer(OutputSize * FilterCount);
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+      for (size_t ow = 0; ow < OutputWidth; ow++) {
+        for (size_t f = 0; f < FilterCount; f++) {
+          int32_t sum = 0;
+          for (size_t ky = 0; ky < KernelSize; ky++) {
+            const size_t ih = oh * Stride + ky * Dilation - Padding;
+            for (size_t kx = 0; kx < KernelSize; kx++) {
+              const size_t iw = ow * Stride + kx * Dilation - Padding;
+              for (size_t c = 0; c < InputChannels; c++) {
+                const int32_t x = (ih < InputHeight && iw < InputWidth)
+                                      ? int32_t(Input[(ih * InputWidth + iw) * InputChannels + c])
+                                      : InputZeroPoint;
+                const int32_t w = Filter[((ky * KernelSize + kx) * InputChannels + c) * FilterCount + f];
+                sum += (x - InputZeroPoint) * (w - FilterZeroPoint);
+              }
+            }
+          }
+          OutputReference[(oh * OutputWidth + ow) * FilterCount + f] = sum;
+        }
+      }
+    }
+
+    MLAS_CONV_DIRECT_QUANT_PARAMS Params = {};
+    Params.Input = Input;
+    Params.InputZeroPoint = InputZeroPoint;
+    Params.InputIsSigned = std::is_signed<InputType>::value;
+    Params.Filter = Filter;
+    Params.FilterZeroPoint = FilterZeroPoint;
+    Params.FilterIsSigned = std::is_signed<FilterType>::value;
+    Params.InputChannels = InputChannels;
+    Params.OutputChannels = FilterCount;
+    Params.InputShape[0] = InputHeight;
+    Params.InputShape[1] = InputWidth;
+    Params.KernelShape[0] = Params.KernelShape[1] = KernelSize;
+    Params.DilationShape[0] = Params.DilationShape[1] = Dilation;
+    Params.Padding[0] = Params.Padding[1] = Padding;
+    Params.StrideShape[0] = Params.StrideShape[1] = Stride;
+    Params.OutputShape[0] = OutputHeight;
+    Params.OutputShape[1] = OutputWidth;
+
+    // Compute the output in uneven slices to cover partial row segments.
+    for (size_t start = 0; start < OutputSize;) {
+      const size_t count = std::min<size_t>(OutputSize - start, 7 + start % 29);
+      Params.Output = Output + start * FilterCount;
+      Params.OutputStart = start;
+      Params.OutputCount = count;
+      MlasConvDirectQuant(Params);
+      start += count;
+    }
+
+    for (size_t i = 0; i < OutputSize * FilterCount; i++) {
+      ASSERT_EQ(Output[i], OutputReference[i])
+          << "C" << InputChannels << "/H" << InputHeight << "/W" << InputWidth << "/F" << FilterCount << "/K"
+          << KernelSize << "/Pad" << Padding << "/S" << Stride << "/D" << Dilation << " at " << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("ConvDirectQuant_") +
+                                        (std::is_signed<InputType>::value ? "S8" : "U8") +
+                                        (std::is_signed<FilterType>::value ? "S8" : "U8"));
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t k : {3, 5}) {
+      Test(1, 7, 9, 1, k, 1, 1, 1);
+      Test(3, 12, 11, 8, k, k / 2, 1, 1);
+      Test(16, 14, 14, 16, k, k / 2, 1, 1);
+      Test(17, 9, 13, 23, k, 0, 1, 1);
+      Test(32, 15, 15, 40, k, k / 2, 2, 1);
+      Test(24, 16, 16, 24, k, 2, 1, 2);
+      Test(8, 9, 200, 33, k, 1, 1, 1);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasConvDirectQuantTest<uint8_t, uint8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasConvDirectQuantTest<uint8_t, int8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasConvDirectQuantTest<int8_t, int8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasConvDirectQuantTest<int8_t, uint8_t>>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSgemmBatchSmallTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BatchSize, size_t M, size_t N, size_t K, bool TransB, float alpha, float beta,
+            bool UseEpilogue) {
+    std::default_random_engine generator(static_cast<unsigned>(BatchSize * 7 + M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto RandomBuffer = [&](MatrixGuardBuffer<float>& Buffer, size_t Elements) {
+      float* p = Buffer.GetBuffer(Elements);
+      for (size_t i = 0; i < Elements; i++) {
+        p[i] = distribution(generator);
+      }
+      return p;
+    };
+
+    // The matrices of the batch are padded to check that the leading dimensions are honored.
+    const size_t lda = K + 1;
+    const size_t ldb = (TransB ? K : N) + 3;
+    const size_t ldc = N + 2;
+    const size_t StrideA = M * lda;
+    const size_t StrideB = (TransB ? N : K) * ldb;
+    const size_t StrideC = M * ldc;
+
+    const float* A = RandomBuffer(BufferA, BatchSize * StrideA);
+    const float* B = RandomBuffer(BufferB, BatchSize * StrideB);
+    const float* Bias = RandomBuffer(BufferBias, N);
+    float* C = RandomBuffer(BufferC, BatchSize * StrideC);
+    float* CReference = BufferCReference.GetBuffer(BatchSize * StrideC);
+    std::copy_n(C, BatchSize * StrideC, CReference);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          double sum = 0.0;
+          for (size_t k = 0; k < K; k++) {
+            const float b = TransB ? B[i * StrideB + n * ldb + k] : B[i * StrideB + k * ldb + n];
+            sum += double(A[i * StrideA + m * lda + k]) * double(b);
+          }
+          float* c = CReference + i * StrideC + m * ldc + n;
+          float value = float(alpha * sum + (beta != 0.0f ? double(beta) * double(*c) : 0.0));
+          if (UseEpilogue) {
+            value = std::max(value + Bias[n], 0.0f);
+          }
+          *c = value;
+        }
+      }
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = Bias;
+    Epilogue.Activation = &Activation;
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + i * StrideA;
+      Data[i].lda = lda;
+      Data[i].B = B + i * StrideB;
+      Data[i].ldb = ldb;
+      Data[i].C = C + i * StrideC;
+      Data[i].ldc = ldc;
+      Data[i].alpha = alpha;
+      Data[i].beta = beta;
+      Data[i].Epilogue = UseEpilogue ? &Epilogue : nullptr;
+    }
+
+    MlasGemmBatch(CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize * StrideC; i++) {
+      ASSERT_TRUE(CloseEnough(C[i], CReference[i]))
+          << "Batch " << BatchSize << " M " << M << " N " << N << " K " << K << " TransB " << TransB << " alpha "
+          << alpha << " beta " << beta << " epilogue " << UseEpilogue << ", got: " << C[i]
+          << ", expecting: " << CReference[i] << " at " << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmBatchSmall_Threaded" : "SgemmBatchSmall_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmBatchSmallTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t M : {1, 2, 3, 4, 5, 7, 16, 64}) {
+      for (size_t N : {1, 3, 4, 7, 8, 12, 15, 16, 33, 64}) {
+        for (size_t K : {1, 5, 16, 64}) {
+          Test(37, M, N, K, false, 1.0f, 0.0f, false);
+        }
+      }
+    }
+
+    for (size_t N : {5, 8, 13, 40}) {
+      Test(100, 9, N, 21, false, 0.5f, 1.0f, false);
+      Test(100, 9, N, 21, false, 1.0f, -0.75f, true);
+      Test(100, 9, N, 21, true, 1.0f, 0.0f, false);
+      Test(100, 9, N, 21, true, 2.0f, 0.5f, true);
+    }
+
+    Test(1000, 8, 8, 8, false, 1.0f, 0.0f, true);
+    Test(3, 64, 64, 0, false, 1.0f, 0.5f, false);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmBatchSmallTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmBatchSmallTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Packed, bool Threaded>
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MLAS_THREADPOOL* threadpool_;
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float x) {
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return (std::max)(x, 0.0f);
+      case MlasLeakyReluActivation:
+        return x >= 0.0f ? x : x * Activation.Parameters.LeakyRelu.alpha;
+      case MlasTanhActivation:
+        return std::tanh(x);
+      case MlasGeluActivation:
+        return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752440f));
+      default:
+        return x;
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, float beta,
+            bool UseBias, const MLAS_ACTIVATION* Activation, bool UseResidual) {
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto RandomBuffer = [&](MatrixGuardBuffer<float>& Buffer, size_t Elements) {
+      float* p = Buffer.GetBuffer(Elements);
+      for (size_t i = 0; i < Elements; i++) {
+        p[i] = distribution(generator);
+      }
+      return p;
+    };
+
+    const size_t ldr = N + 3;
+    const float* A = RandomBuffer(BufferA, M * K);
+    const float* B = RandomBuffer(BufferB, K * N);
+    const float* Bias = RandomBuffer(BufferBias, N);
+    const float* Residual = RandomBuffer(BufferResidual, M * ldr);
+    float* C = RandomBuffer(BufferC, M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+          const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += double(a) * double(b);
+        }
+        float value = static_cast<float>(sum) + beta * C[m * N + n];
+        if (UseBias) {
+          value += Bias[n];
+        }
+        if (Activation != nullptr) {
+          value = ReferenceActivation(*Activation, value);
+        }
+        if (UseResidual) {
+          value += Residual[m * ldr + n];
+        }
+        CReference[m * N + n] = value;
+      }
+    }
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = UseBias ? Bias : nullptr;
+    Epilogue.Activation = Activation;
+    Epilogue.Residual = UseResidual ? Residual : nullptr;
+    Epilogue.ldr = ldr;
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = N;
+    Data.beta = beta;
+    Data.Epilogue = &Epilogue;
+
+    if (Packed) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    MlasGemm(TransA, Packed ? CblasNoTrans : TransB, M, N, K, Data, threadpool_);
+
+    for (size_t i = 0; i < M * N; i++) {
+      const float diff = std::fabs(C[i] - CReference[i]);
+      ASSERT_TRUE(diff <= 1e-4f || diff <= std::fabs(CReference[i]) * 1e-4f)
+          << "M/N/K " << M << "/" << N << "/" << K << " TransA/TransB " << TransA << "/" << TransB
+          << " beta " << beta << " bias " << UseBias << " activation "
+          << (Activation != nullptr ? int(Activation->ActivationKind) : -1) << " residual " << UseResidual
+          << ", got: " << C[i] << ", expecting: " << CReference[i] << " at " << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::string("SgemmEpilogue") + (Packed ? "_Packed" : "_NoPack") +
+                                        (Threaded ? "_Threaded" : "_SingleThread"));
+    return suite_name.c_str();
+  }
+
+  MlasSgemmEpilogueTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Relu;
+    Relu.ActivationKind = MlasReluActivation;
+
+    MLAS_ACTIVATION LeakyRelu;
+    LeakyRelu.ActivationKind = MlasLeakyReluActivation;
+    LeakyRelu.Parameters.LeakyRelu.alpha = 0.1f;
+
+    MLAS_ACTIVATION Gelu;
+    Gelu.ActivationKind = MlasGeluActivation;
+
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 37, 19}, {7, 1, 33}, {5, 16, 0}, {13, 17, 29}, {32, 96, 64}, {65, 300, 130}, {3, 513, 257},
+    };
+
+    for (const auto& Shape : Shapes) {
+      const size_t M = Shape[0];
+      const size_t N = Shape[1];
+      const size_t K = Shape[2];
+
+      for (CBLAS_TRANSPOSE TransA : {CblasNoTrans, CblasTrans}) {
+        for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+          Test(TransA, TransB, M, N, K, 0.0f, true, nullptr, false);
+          Test(TransA, TransB, M, N, K, 0.0f, true, &Relu, false);
+          Test(TransA, TransB, M, N, K, 1.0f, false, &LeakyRelu, true);
+          Test(TransA, TransB, M, N, K, 0.0f, true, &Gelu, true);
+          Test(TransA, TransB, M, N, K, 0.5f, true, &Gelu, false);
+        }
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
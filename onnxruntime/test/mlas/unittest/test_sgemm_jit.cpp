@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSgemmJitTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, size_t lda, size_t ldc, bool UseEpilogue) {
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto RandomBuffer = [&](MatrixGuardBuffer<float>& Buffer, size_t Elements) {
+      float* p = Buffer.GetBuffer(Elements);
+      for (size_t i = 0; i < Elements; i++) {
+        p[i] = distribution(generator);
+      }
+      return p;
+    };
+
+    const float* A = RandomBuffer(BufferA, M * lda);
+    const float* B = RandomBuffer(BufferB, K * N);
+    const float* Bias = RandomBuffer(BufferBias, N);
+    float* C = RandomBuffer(BufferC, M * ldc);
+    float* CReference = BufferCReference.GetBuffer(M * ldc);
+    std::copy_n(C, M * ldc, CReference);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = UseEpilogue ? Bias[n] : 0.0;
+        for (size_t k = 0; k < K; k++) {
+          sum += double(A[m * lda + k]) * double(B[k * N + n]);
+        }
+        CReference[m * ldc + n] = UseEpilogue ? std::max(float(sum), 0.0f) : float(sum);
+      }
+    }
+
+    void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+    MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+
+    MLAS_SGEMM_JIT_KERNEL* Kernel = MlasSgemmJitKernelCreate(N, K);
+    ASSERT_NE(Kernel, nullptr) << "N " << N << " K " << K;
+
+    // A second request for the same shape shares the cached kernel.
+    MLAS_SGEMM_JIT_KERNEL* SharedKernel = MlasSgemmJitKernelCreate(N, K);
+    ASSERT_EQ(Kernel, SharedKernel);
+    MlasSgemmJitKernelFree(SharedKernel);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = Bias;
+    Epilogue.Activation = &Activation;
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.B = static_cast<const float*>(PackedB);
+    Data.BIsPacked = true;
+    Data.C = C;
+    Data.ldc = ldc;
+    Data.Epilogue = UseEpilogue ? &Epilogue : nullptr;
+    Data.JitKernel = Kernel;
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, Data, threadpool_);
+
+    MlasSgemmJitKernelFree(Kernel);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        const size_t i = m * ldc + n;
+        ASSERT_TRUE(CloseEnough(C[i], CReference[i]))
+            << "M " << M << " N " << N << " K " << K << " epilogue " << UseEpilogue << ", got: " << C[i]
+            << ", expecting: " << CReference[i] << " at " << m << "," << n;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmJit_Threaded" : "SgemmJit_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmJitTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    if (!MlasSgemmJitIsSupported()) {
+      return;
+    }
+
+    for (size_t M : {1, 2, 3, 4, 5, 6, 7, 13, 64}) {
+      for (size_t N : {1, 7, 8, 9, 16, 17, 40, 64}) {
+        for (size_t K : {1, 3, 16, 255, 256, 257, 600}) {
+          Test(M, N, K, K, N, false);
+        }
+      }
+    }
+
+    Test(37, 200, 1024, 1030, 203, false);
+    Test(11, 64, 769, 769, 64, true);
+    Test(3, 1000, 512, 512, 1000, true);
+    Test(128, 77, 96, 96, 80, true);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmJitTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmJitTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
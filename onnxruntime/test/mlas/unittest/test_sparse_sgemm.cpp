@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSparseSgemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t N, size_t K, size_t lda, size_t ldc, bool TransB, float Sparsity, float alpha) {
+    std::default_random_engine generator(static_cast<unsigned>(M * 131 + N * 17 + K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> keep_distribution(0.0f, 1.0f);
+
+    float* A = BufferA.GetBuffer(M * lda);
+    for (size_t i = 0; i < M * lda; i++) {
+      A[i] = distribution(generator);
+    }
+
+    // zero whole rows of K, and some single values, of the logical K x N matrix B
+    float* B = BufferB.GetBuffer(K * N);
+    const size_t ldb = TransB ? K : N;
+    for (size_t k = 0; k < K; k++) {
+      const bool keep_row = keep_distribution(generator) >= Sparsity;
+      for (size_t n = 0; n < N; n++) {
+        const float value = (keep_row && keep_distribution(generator) >= 0.25f) ? distribution(generator) : 0.0f;
+        (TransB ? B[n * ldb + k] : B[k * ldb + n]) = value;
+      }
+    }
+
+    float* C = BufferC.GetBuffer(M * ldc);
+    float* CReference = BufferCReference.GetBuffer(M * ldc);
+    for (size_t i = 0; i < M * ldc; i++) {
+      C[i] = distribution(generator);
+    }
+    std::copy_n(C, M * ldc, CReference);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          sum += double(A[m * lda + k]) * double(TransB ? B[n * ldb + k] : B[k * ldb + n]);
+        }
+        CReference[m * ldc + n] = float(sum) * alpha;
+      }
+    }
+
+    const CBLAS_TRANSPOSE Trans = TransB ? CblasTrans : CblasNoTrans;
+    const size_t BlockCount = MlasSparseSgemmCountBlocks(Trans, N, K, B, ldb);
+    ASSERT_LE(BlockCount, K * ((N + 15) / 16));
+
+    const size_t PackedBSize = MlasSparseSgemmPackBSize(N, K, BlockCount);
+    ASSERT_NE(PackedBSize, size_t(0));
+    void* PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+    MlasSparseSgemmPackB(Trans, N, K, B, ldb, BlockCount, PackedB);
+
+    MlasSparseSgemm(M, N, K, A, lda, PackedB, C, ldc, alpha, threadpool_);
+
+    // the columns past N are not written
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        const size_t i = m * ldc + n;
+        ASSERT_TRUE(CloseEnough(C[i], CReference[i]))
+            << "M " << M << " N " << N << " K " << K << " TransB " << TransB << " sparsity " << Sparsity
+            << ", got: " << C[i] << ", expecting: " << CReference[i] << " at " << m << "," << n;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SparseSgemm_Threaded" : "SparseSgemm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSparseSgemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t M : {1, 2, 3, 16}) {
+      for (size_t N : {1, 15, 16, 17, 64}) {
+        for (size_t K : {1, 7, 64}) {
+          for (float Sparsity : {0.0f, 0.7f, 1.0f}) {
+            Test(M, N, K, K, N, false, Sparsity, 1.0f);
+            Test(M, N, K, K, N, true, Sparsity, 1.0f);
+          }
+        }
+      }
+    }
+
+    Test(37, 200, 512, 520, 203, false, 0.8f, 0.5f);
+    Test(64, 257, 128, 128, 257, true, 0.9f, 2.0f);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSparseSgemmTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSparseSgemmTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
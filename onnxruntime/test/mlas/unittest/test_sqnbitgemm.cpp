@@ -167,6 +167,55 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     }
   }
 
+  static uint32_t ExtractBits(const uint8_t* Data, size_t BitOffset) {
+    uint32_t v = Data[BitOffset / 8] >> (BitOffset % 8);
+    if (BitOffset % 8 + BlkBitWidth > 8) {
+      v |= static_cast<uint32_t>(Data[BitOffset / 8 + 1]) << (8 - BitOffset % 8);
+    }
+    return v & ((1u << BlkBitWidth) - 1);
+  }
+
+  // Generates random 2-bit or 3-bit quantized B data in the MatMulNBits layout, with every block densely packed.
+  // MlasQuantizeBlockwise() only supports 4-bit, so these bit widths are not quantized from a float B.
+  void GenerateLowBitQuantizedB(size_t N, size_t K,
+                                uint8_t*& QuantBData, float*& QuantBScale, uint8_t*& QuantBZeroPoint,
+                                bool Symmetric) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ZeroPointBytesPerCol = (BlockCountK * BlkBitWidth + 7) / 8;
+
+    QuantBData = BufferQuantBData.GetBuffer(N * BlockCountK * BlkLen * BlkBitWidth / 8);
+    // scales that are multiples of 1/4 keep the float results exact
+    QuantBScale = BufferQuantBScale.GetFilledBuffer(
+        N * BlockCountK,
+        [](float* start, size_t size) {
+          for (size_t i = 0; i < size; i++) {
+            start[i] = static_cast<float>(i % 5 + 1) * 0.25f;
+          }
+        });
+    QuantBZeroPoint = Symmetric ? nullptr : BufferQuantBZeroPoint.GetBuffer(N * ZeroPointBytesPerCol);
+  }
+
+  void DequantizeLowBitB(size_t N, size_t K,
+                         const uint8_t* QuantBData, const float* QuantBScale, const uint8_t* QuantBZeroPoint,
+                         float* DequantizedBData) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ZeroPointBytesPerCol = (BlockCountK * BlkBitWidth + 7) / 8;
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+
+    for (size_t n = 0; n < N; ++n) {
+      for (size_t k = 0; k < K; ++k) {
+        const size_t k_blk = k / BlkLen;
+        const uint8_t* blk_data = QuantBData + (n * BlockCountK + k_blk) * BlkDataSize;
+        const uint32_t q = ExtractBits(blk_data, (k % BlkLen) * BlkBitWidth);
+        const uint32_t zp = QuantBZeroPoint == nullptr
+                                ? (1u << (BlkBitWidth - 1))
+                                : ExtractBits(QuantBZeroPoint + n * ZeroPointBytesPerCol, k_blk * BlkBitWidth);
+        DequantizedBData[n * K + k] =
+            (static_cast<float>(q) - static_cast<float>(zp)) * QuantBScale[n * BlockCountK + k_blk];
+      }
+    }
+  }
+
   void CallReferenceGemm_CompFp32(size_t M,
                                   size_t N,
                                   size_t K,
@@ -177,9 +226,13 @@ class MlasSQNBitGemmTest : public MlasTestBase {
                                   const float* Bias,
                                   float* C) {
     float* DequantizedBData = BufferDequantizedB.GetBuffer(K * N);
-    MlasDequantizeBlockwise<float, BlkBitWidth>(
-        DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
-        static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    if constexpr (BlkBitWidth == 4) {
+      MlasDequantizeBlockwise<float, BlkBitWidth>(
+          DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
+          static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    } else {
+      DequantizeLowBitB(N, K, QuantBData, QuantBScale, QuantBZeroPoint, DequantizedBData);
+    }
     // Note: DequantizedBData is in column major layout.
 
     for (size_t m = 0; m < M; m++) {
@@ -244,7 +297,9 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     uint8_t* QuantBData = nullptr;
     float* QuantBScale = nullptr;
     uint8_t* QuantBZeroPoint = nullptr;
-    {
+    if constexpr (BlkBitWidth != 4) {
+      GenerateLowBitQuantizedB(N, K, QuantBData, QuantBScale, QuantBZeroPoint, Symmetric);
+    } else {
       size_t QuantBDataSizeInBytes, QuantBScaleSize, QuantBZeroPointSizeInBytes;
       MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, BlkLen, /* columnwise */ true,
                                         static_cast<int>(K), static_cast<int>(N),
@@ -292,7 +347,11 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     if (ComputeType == CompFp32) {
       CallReferenceGemm_CompFp32(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
     } else if (ComputeType == CompInt8) {
-      CallReferenceGemm_CompInt8(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
+      if constexpr (BlkBitWidth == 4) {
+        CallReferenceGemm_CompInt8(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
+      } else {
+        FAIL() << "CompInt8 is not implemented for " << BlkBitWidth << "-bit quantized B";
+      }
     } else {
       FAIL() << "Test is not implemented for compute type "
              << ComputeType << " (" << ComputeTypeName(ComputeType) << ")";
@@ -429,6 +488,13 @@ static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   count += SQNBitGemmShortExecuteTest<4, 128>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 256>::RegisterShortExecuteTests();
 
+  count += SQNBitGemmShortExecuteTest<2, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 128>::RegisterShortExecuteTests();
+
   return count;
 }
 
@@ -22,6 +22,32 @@ class MlasTransposeTest : public MlasTestBase {
     ASSERT_EQ(memcmp(Output, OutputReference, M * N * sizeof(ElementType)), 0) << " [" << M << "," << N << "]";
   }
 
+  void
+  TestStrided(size_t M, size_t N, size_t InputStride, size_t OutputStride) {
+    ElementType* Input = BufferInput.GetBuffer(M * InputStride);
+    ElementType* Output = BufferOutput.GetBuffer(N * OutputStride);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(N * OutputStride);
+
+    for (size_t i = 0; i < M * InputStride; i++) {
+      Input[i] = ElementType(i * 7 + 3);
+    }
+
+    // The padding after each output row must not be written.
+    std::fill_n(Output, N * OutputStride, ElementType(0x5a));
+    std::fill_n(OutputReference, N * OutputStride, ElementType(0x5a));
+
+    MlasTranspose(Input, InputStride, Output, OutputStride, M, N);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        OutputReference[n * OutputStride + m] = Input[m * InputStride + n];
+      }
+    }
+
+    ASSERT_EQ(memcmp(Output, OutputReference, N * OutputStride * sizeof(ElementType)), 0)
+        << " [" << M << "," << N << "] strides [" << InputStride << "," << OutputStride << "]";
+  }
+
   void ReferenceTranspose(const ElementType* Input, ElementType* Output, size_t M, size_t N) {
     for (size_t m = 0; m < M; m++) {
       for (size_t n = 0; n < N; n++) {
@@ -42,6 +68,13 @@ class MlasTransposeTest : public MlasTestBase {
         Test(m, n);
       }
     }
+
+    for (size_t m : {1, 3, 4, 8, 13, 16, 33, 64}) {
+      for (size_t n : {1, 2, 4, 7, 8, 16, 19, 64}) {
+        TestStrided(m, n, n + 5, m + 3);
+        TestStrided(m, n, 4 * n, 2 * m);
+      }
+    }
   }
 };
 
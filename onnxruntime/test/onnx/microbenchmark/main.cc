@@ -24,6 +24,8 @@
 const OrtApi* g_ort = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 OrtEnv* env = nullptr;
 
+void RegisterModelSuiteBenchmarks();
+
 using namespace onnxruntime;
 
 static void BM_CPUAllocator(benchmark::State& state) {
@@ -79,6 +81,7 @@ int main(int argc, char** argv) {
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
+  RegisterModelSuiteBenchmarks();
   ::benchmark::RunSpecifiedBenchmarks();
   g_ort->ReleaseEnv(env);
   return 0;
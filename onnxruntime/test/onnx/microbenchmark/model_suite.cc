@@ -0,0 +1,313 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Model level benchmarks of the suite of representative models listed in a manifest, see model_suite.txt.
+// The benchmarks are registered when ORT_BENCHMARK_MODEL_SUITE is set to the path of the manifest, e.g.
+//
+//   ORT_BENCHMARK_MODEL_SUITE=/data/model_suite/model_suite.txt ./onnxruntime_benchmark
+//       --benchmark_filter=ModelSuite --benchmark_format=json --benchmark_out=results.json
+//
+// Every model runs for every shape of the manifest on every execution provider of the build. The json output
+// has the hardware google benchmark detects (cpus, frequency, caches) in its context, with the version and
+// the build of onnxruntime, the cpu features and the version of the suite added to it.
+
+#include <benchmark/benchmark.h>
+#include <core/common/cpuid_info.h>
+#include <core/common/path_string.h>
+#include <core/session/onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct ModelSuiteEntry {
+  std::string name;
+  std::string model_class;
+  std::filesystem::path model_path;
+  // the values of the symbolic dimensions of the inputs, the ones not listed are 1
+  std::vector<std::pair<std::string, int64_t>> dims;
+};
+
+// Expand the dims of a manifest line, e.g. batch_size=1,8 sequence_length=128,512, to every combination.
+void ExpandDims(const std::vector<std::pair<std::string, std::vector<int64_t>>>& dim_values, size_t i,
+                std::vector<std::pair<std::string, int64_t>>& dims,
+                std::vector<std::vector<std::pair<std::string, int64_t>>>& combinations) {
+  if (i == dim_values.size()) {
+    combinations.push_back(dims);
+    return;
+  }
+  for (const int64_t value : dim_values[i].second) {
+    dims.emplace_back(dim_values[i].first, value);
+    ExpandDims(dim_values, i + 1, dims, combinations);
+    dims.pop_back();
+  }
+}
+
+bool ParseManifest(const std::filesystem::path& manifest_path, std::string& suite_version,
+                   std::vector<ModelSuiteEntry>& entries) {
+  std::ifstream manifest(manifest_path);
+  if (!manifest) {
+    std::cerr << "Failed to open the model suite manifest " << manifest_path << std::endl;
+    return false;
+  }
+
+  std::string line;
+  for (int line_number = 1; std::getline(manifest, line); ++line_number) {
+    std::istringstream fields(line);
+    std::string name;
+    if (!(fields >> name) || name[0] == '#') {
+      continue;
+    }
+    if (name == "suite_version") {
+      fields >> suite_version;
+      continue;
+    }
+
+    std::string model_class;
+    std::string model_file;
+    if (!(fields >> model_class >> model_file)) {
+      std::cerr << manifest_path << ":" << line_number << ": expected <name> <class> <model> [<dim>=<values>...]"
+                << std::endl;
+      return false;
+    }
+
+    std::vector<std::pair<std::string, std::vector<int64_t>>> dim_values;
+    std::string dim;
+    while (fields >> dim) {
+      const auto separator = dim.find('=');
+      if (separator == std::string::npos || separator == 0) {
+        std::cerr << manifest_path << ":" << line_number << ": invalid dim " << dim << std::endl;
+        return false;
+      }
+      std::vector<int64_t> values;
+      std::istringstream value_list(dim.substr(separator + 1));
+      std::string value;
+      while (std::getline(value_list, value, ',')) {
+        char* end = nullptr;
+        const long long parsed = std::strtoll(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || parsed <= 0) {
+          std::cerr << manifest_path << ":" << line_number << ": invalid value of " << dim << std::endl;
+          return false;
+        }
+        values.push_back(parsed);
+      }
+      dim_values.emplace_back(dim.substr(0, separator), std::move(values));
+    }
+
+    std::vector<std::pair<std::string, int64_t>> dims;
+    std::vector<std::vector<std::pair<std::string, int64_t>>> combinations;
+    ExpandDims(dim_values, 0, dims, combinations);
+    for (auto& combination : combinations) {
+      entries.push_back({name, model_class, manifest_path.parent_path() / model_file, std::move(combination)});
+    }
+  }
+  return true;
+}
+
+// Append the execution provider of its registered name, false if the benchmark doesn't know how to.
+bool AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& provider) {
+  if (provider == "CPUExecutionProvider") {
+    return true;
+  }
+  if (provider == "CUDAExecutionProvider") {
+    session_options.AppendExecutionProvider_CUDA(OrtCUDAProviderOptions{});
+  } else if (provider == "ROCMExecutionProvider") {
+    session_options.AppendExecutionProvider_ROCM(OrtROCMProviderOptions{});
+  } else if (provider == "TensorrtExecutionProvider") {
+    session_options.AppendExecutionProvider_TensorRT(OrtTensorRTProviderOptions{});
+  } else if (provider == "DmlExecutionProvider") {
+    session_options.AppendExecutionProvider("DML");
+  } else if (provider == "OpenVINOExecutionProvider") {
+    session_options.AppendExecutionProvider("OpenVINO");
+  } else if (provider == "QNNExecutionProvider") {
+    session_options.AppendExecutionProvider("QNN");
+  } else if (provider == "XnnpackExecutionProvider") {
+    session_options.AppendExecutionProvider("XNNPACK");
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Fill a tensor with ones, which are valid token ids, masks and indices as well as real data.
+bool FillWithOnes(Ort::Value& tensor, ONNXTensorElementDataType type, size_t num_elements) {
+  void* data = tensor.GetTensorMutableRawData();
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      std::fill_n(static_cast<float*>(data), num_elements, 1.0f);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      std::fill_n(static_cast<double*>(data), num_elements, 1.0);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+      std::fill_n(static_cast<uint16_t*>(data), num_elements, uint16_t{0x3C00});
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      std::fill_n(static_cast<uint16_t*>(data), num_elements, uint16_t{0x3F80});
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      std::fill_n(static_cast<int64_t*>(data), num_elements, int64_t{1});
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      std::fill_n(static_cast<int32_t*>(data), num_elements, int32_t{1});
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      std::fill_n(static_cast<uint8_t*>(data), num_elements, uint8_t{1});
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+void BM_ModelSuite(benchmark::State& state, const ModelSuiteEntry& entry, const std::string& provider) {
+  // the environment is shared with the one main() creates
+  static Ort::Env env;
+  try {
+    Ort::SessionOptions session_options;
+    if (!AppendExecutionProvider(session_options, provider)) {
+      state.SkipWithError(("The benchmark doesn't know how to use " + provider).c_str());
+      return;
+    }
+    Ort::Session session(env, entry.model_path.native().c_str(), session_options);
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    std::vector<Ort::AllocatedStringPtr> name_holders;
+    std::vector<const char*> input_names;
+    std::vector<Ort::Value> inputs;
+    for (size_t i = 0; i < session.GetInputCount(); ++i) {
+      name_holders.push_back(session.GetInputNameAllocated(i, allocator));
+      input_names.push_back(name_holders.back().get());
+
+      const auto type_info = session.GetInputTypeInfo(i);
+      if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+        state.SkipWithError((std::string("Input ") + input_names.back() + " is not a tensor").c_str());
+        return;
+      }
+      const auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+      std::vector<int64_t> shape = tensor_info.GetShape();
+      std::vector<const char*> symbolic_dims(shape.size());
+      tensor_info.GetSymbolicDimensions(symbolic_dims.data(), symbolic_dims.size());
+      size_t num_elements = 1;
+      for (size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] < 0) {
+          shape[d] = 1;
+          for (const auto& dim : entry.dims) {
+            if (dim.first == symbolic_dims[d]) {
+              shape[d] = dim.second;
+            }
+          }
+        }
+        num_elements *= static_cast<size_t>(shape[d]);
+      }
+
+      const auto type = tensor_info.GetElementType();
+      inputs.push_back(Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type));
+      if (!FillWithOnes(inputs.back(), type, num_elements)) {
+        state.SkipWithError((std::string("Unsupported type of input ") + input_names.back()).c_str());
+        return;
+      }
+    }
+
+    std::vector<const char*> output_names;
+    for (size_t i = 0; i < session.GetOutputCount(); ++i) {
+      name_holders.push_back(session.GetOutputNameAllocated(i, allocator));
+      output_names.push_back(name_holders.back().get());
+    }
+
+    // the first run allocates the buffers, initializes the kernels and tunes the execution providers
+    Ort::RunOptions run_options;
+    session.Run(run_options, input_names.data(), inputs.data(), inputs.size(), output_names.data(),
+                output_names.size());
+    for (auto _ : state) {
+      auto outputs = session.Run(run_options, input_names.data(), inputs.data(), inputs.size(),
+                                 output_names.data(), output_names.size());
+      benchmark::DoNotOptimize(outputs);
+    }
+    state.SetLabel(entry.model_class);
+  } catch (const Ort::Exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+std::string CpuFeatures() {
+  const auto& cpu_info = onnxruntime::CPUIDInfo::GetCPUIDInfo();
+  const std::pair<const char*, bool> features[] = {
+      {"sse3", cpu_info.HasSSE3()},
+      {"sse4.1", cpu_info.HasSSE4_1()},
+      {"avx", cpu_info.HasAVX()},
+      {"avx2", cpu_info.HasAVX2()},
+      {"f16c", cpu_info.HasF16C()},
+      {"avx512f", cpu_info.HasAVX512f()},
+      {"avx512_skylake", cpu_info.HasAVX512Skylake()},
+      {"avx512_bf16", cpu_info.HasAVX512_BF16()},
+      {"amx_bf16", cpu_info.HasAMX_BF16()},
+      {"neon_dot", cpu_info.HasArmNeonDot()},
+      {"neon_i8mm", cpu_info.HasArmNeon_I8MM()},
+      {"neon_bf16", cpu_info.HasArmNeon_BF16()},
+      {"sve", cpu_info.HasArmSVE()},
+      {"sve_i8mm", cpu_info.HasArmSVE_I8MM()},
+      {"fp16_vector", cpu_info.HasFp16VectorAcceleration()},
+      {"hybrid", cpu_info.IsHybrid()},
+  };
+  std::string result;
+  for (const auto& feature : features) {
+    if (feature.second) {
+      result += (result.empty() ? "" : ",") + std::string(feature.first);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+// Called by main() before the benchmarks run.
+void RegisterModelSuiteBenchmarks() {
+  const char* manifest = std::getenv("ORT_BENCHMARK_MODEL_SUITE");
+  if (manifest == nullptr || *manifest == '\0') {
+    return;
+  }
+
+  std::string suite_version = "unversioned";
+  // the benchmarks refer to the entries until the end of the process
+  static std::vector<ModelSuiteEntry> entries;
+  if (!ParseManifest(onnxruntime::ToPathString(manifest), suite_version, entries)) {
+    std::exit(1);
+  }
+
+  const std::vector<std::string> providers = Ort::GetAvailableProviders();
+  std::string provider_list;
+  for (const auto& provider : providers) {
+    provider_list += (provider_list.empty() ? "" : ",") + provider;
+  }
+  benchmark::AddCustomContext("ort_version", Ort::GetVersionString());
+  benchmark::AddCustomContext("ort_build_info", Ort::GetBuildInfoString());
+  benchmark::AddCustomContext("ort_execution_providers", provider_list);
+  benchmark::AddCustomContext("cpu_features", CpuFeatures());
+  benchmark::AddCustomContext("model_suite", manifest);
+  benchmark::AddCustomContext("model_suite_version", suite_version);
+
+  for (const auto& entry : entries) {
+    std::string shape_label;
+    for (const auto& dim : entry.dims) {
+      shape_label += "/" + dim.first + ":" + std::to_string(dim.second);
+    }
+    for (const auto& provider : providers) {
+      const std::string name = "ModelSuite/" + entry.name + "/" + provider + shape_label;
+      benchmark::RegisterBenchmark(name.c_str(), [&entry, provider](benchmark::State& state) {
+        BM_ModelSuite(state, entry, provider);
+      })->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+  }
+}
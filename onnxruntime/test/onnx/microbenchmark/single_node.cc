@@ -0,0 +1,406 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of CPU kernels in graphs of a single node that run through InferenceSession, e.g.
+//
+//   ./onnxruntime_benchmark --benchmark_filter=BM_SingleNode
+//
+// The time of an iteration is the time of InferenceSession::Run. The kernel_us counter is the time of the kernel
+// measured by the session metrics, and framework_us is the rest of the run: validating the feeds, allocating the
+// outputs and executing the plan.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <random>
+
+#include "core/framework/data_types.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/ort_env.h"
+#include <onnx/defs/attr_proto_util.h>
+
+using namespace onnxruntime;
+using namespace ONNX_NAMESPACE;
+extern OrtEnv* env;
+
+namespace {
+
+class SingleNodeBenchmark {
+ public:
+  SingleNodeBenchmark(const std::string& op_type, int opset) : op_type_(op_type), opset_(opset) {}
+
+  // An input fed to every run, with values drawn uniformly from [low, high).
+  template <typename T>
+  void AddInput(const std::string& name, const std::vector<int64_t>& shape, T low, T high) {
+    Input input{name, utils::ToTensorProtoElementType<T>(), shape, false, {}};
+    Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), TensorShape(shape), allocator_, input.value);
+    RandomFill(input.value.GetMutable<Tensor>()->MutableDataAsSpan<T>(), low, high);
+    inputs_.push_back(std::move(input));
+  }
+
+  // An input of constant values, which is an initializer of the graph.
+  template <typename T>
+  void AddInitializer(const std::string& name, const std::vector<int64_t>& shape, const std::vector<T>& values) {
+    Input input{name, utils::ToTensorProtoElementType<T>(), shape, true, {}};
+    Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), TensorShape(shape), allocator_, input.value);
+    std::copy(values.begin(), values.end(), input.value.GetMutable<Tensor>()->MutableData<T>());
+    inputs_.push_back(std::move(input));
+  }
+
+  // An optional input that is not given.
+  void AddMissingInput() {
+    inputs_.push_back(Input{});
+  }
+
+  void AddAttribute(AttributeProto attribute) {
+    attributes_[attribute.name()] = std::move(attribute);
+  }
+
+  void AddOutput(const std::string& name) {
+    output_names_.push_back(name);
+  }
+
+  void Run(benchmark::State& state);
+
+ private:
+  struct Input {
+    std::string name;  // empty if the input is missing
+    int32_t elem_type = 0;
+    std::vector<int64_t> shape;
+    bool is_initializer = false;
+    OrtValue value;
+  };
+
+  template <typename T>
+  static void RandomFill(gsl::span<T> data, T low, T high) {
+    std::mt19937 gen(42);
+    if constexpr (std::is_same_v<T, bool>) {
+      std::bernoulli_distribution dist;
+      std::generate(data.begin(), data.end(), [&]() { return dist(gen); });
+    } else if constexpr (std::is_integral_v<T>) {
+      std::uniform_int_distribution<T> dist(low, high - 1);
+      std::generate(data.begin(), data.end(), [&]() { return dist(gen); });
+    } else {
+      std::uniform_real_distribution<float> dist(static_cast<float>(low), static_cast<float>(high));
+      std::generate(data.begin(), data.end(), [&]() { return static_cast<T>(dist(gen)); });
+    }
+  }
+
+  Status CreateModel(std::string& model_data) const;
+  Status GetKernelTimeNs(const InferenceSession& session, int64_t& kernel_time_ns) const;
+
+  std::string op_type_;
+  int opset_;
+  AllocatorPtr allocator_ = std::make_shared<CPUAllocator>();
+  std::vector<Input> inputs_;
+  NodeAttributes attributes_;
+  std::vector<std::string> output_names_;
+};
+
+Status SingleNodeBenchmark::CreateModel(std::string& model_data) const {
+  auto logger = env->GetLoggingManager()->CreateLogger("single_node");
+  Model model("single_node", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, opset_}}, {}, *logger);
+  Graph& graph = model.MainGraph();
+
+  std::vector<NodeArg*> input_args;
+  for (const auto& input : inputs_) {
+    if (input.name.empty()) {
+      input_args.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+      continue;
+    }
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(input.elem_type);
+    for (const int64_t dim : input.shape) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    input_args.push_back(&graph.GetOrCreateNodeArg(input.name, &type));
+    if (input.is_initializer) {
+      const Tensor& tensor = input.value.Get<Tensor>();
+      TensorProto initializer;
+      initializer.set_name(input.name);
+      initializer.set_data_type(input.elem_type);
+      for (const int64_t dim : input.shape) {
+        initializer.add_dims(dim);
+      }
+      initializer.set_raw_data(tensor.DataRaw(), tensor.SizeInBytes());
+      graph.AddInitializedTensor(initializer);
+    }
+  }
+
+  std::vector<NodeArg*> output_args;
+  for (const auto& name : output_names_) {
+    output_args.push_back(&graph.GetOrCreateNodeArg(name, nullptr));
+  }
+
+  graph.AddNode("node", op_type_, "", input_args, output_args, &attributes_);
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+  if (!model.ToProto().SerializeToString(&model_data)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to serialize the model of ", op_type_);
+  }
+  return Status::OK();
+}
+
+Status SingleNodeBenchmark::GetKernelTimeNs(const InferenceSession& session, int64_t& kernel_time_ns) const {
+  std::string metrics_json;
+  ORT_RETURN_IF_ERROR(session.GetMetrics(metrics_json));
+  const auto metrics = nlohmann::json::parse(metrics_json, nullptr, false);
+  if (metrics.is_discarded() || !metrics.contains("nodes") || !metrics["nodes"].contains("node")) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The metrics of the session have no time for the node of ", op_type_);
+  }
+  kernel_time_ns = metrics["nodes"]["node"]["sum_ns"].get<int64_t>();
+  return Status::OK();
+}
+
+void SingleNodeBenchmark::Run(benchmark::State& state) {
+  std::string model_data;
+  SessionOptions session_options;
+  Status status = CreateModel(model_data);
+  if (status.IsOK()) {
+    status = session_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableMetrics, "1");
+  }
+  InferenceSession session(session_options, env->GetEnvironment());
+  if (status.IsOK()) {
+    status = session.Load(model_data.data(), static_cast<int>(model_data.size()));
+  }
+  if (status.IsOK()) {
+    status = session.Initialize();
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  for (const auto& input : inputs_) {
+    if (!input.name.empty() && !input.is_initializer) {
+      feed_names.push_back(input.name);
+      feeds.push_back(input.value);
+    }
+  }
+
+  // the first run allocates the buffers of the session
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  if (status.IsOK()) {
+    status = session.Run(run_options, feed_names, feeds, output_names_, &fetches);
+  }
+  int64_t kernel_time_begin_ns = 0;
+  if (status.IsOK()) {
+    status = GetKernelTimeNs(session, kernel_time_begin_ns);
+  }
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    fetches.clear();
+    status = session.Run(run_options, feed_names, feeds, output_names_, &fetches);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+  }
+  const auto run_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - begin)
+                               .count();
+
+  int64_t kernel_time_end_ns = 0;
+  status = GetKernelTimeNs(session, kernel_time_end_ns);
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+  const auto kernel_time_ns = kernel_time_end_ns - kernel_time_begin_ns;
+  state.counters["kernel_us"] = benchmark::Counter(static_cast<double>(kernel_time_ns) / 1000.0,
+                                                   benchmark::Counter::kAvgIterations);
+  state.counters["framework_us"] = benchmark::Counter(static_cast<double>(run_time_ns - kernel_time_ns) / 1000.0,
+                                                      benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+// data {d0, d1}, indices of axis 0 {d2}
+template <typename T>
+static void BM_SingleNode_Gather(benchmark::State& state) {
+  SingleNodeBenchmark b("Gather", 18);
+  b.AddInput<T>("data", {state.range(0), state.range(1)}, T(0), T(100));
+  b.AddInput<int64_t>("indices", {state.range(2)}, 0, state.range(0));
+  b.AddOutput("output");
+  b.Run(state);
+}
+
+BENCHMARK_TEMPLATE(BM_SingleNode_Gather, float)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({32000, 768, 128})
+    ->Args({32000, 4096, 1})
+    ->Args({1024, 1024, 1024});
+BENCHMARK_TEMPLATE(BM_SingleNode_Gather, int32_t)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({32000, 768, 128});
+
+// {d0, d1, d2, d3} transposed to {d0, d2, d1, d3}, as the heads of attention
+template <typename T>
+static void BM_SingleNode_Transpose(benchmark::State& state) {
+  SingleNodeBenchmark b("Transpose", 18);
+  b.AddInput<T>("data", {state.range(0), state.range(1), state.range(2), state.range(3)}, T(0), T(100));
+  b.AddAttribute(MakeAttribute("perm", std::vector<int64_t>{0, 2, 1, 3}));
+  b.AddOutput("transposed");
+  b.Run(state);
+}
+
+BENCHMARK_TEMPLATE(BM_SingleNode_Transpose, float)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 128, 12, 64})
+    ->Args({8, 512, 16, 64})
+    ->Args({1, 2048, 32, 128});
+BENCHMARK_TEMPLATE(BM_SingleNode_Transpose, int32_t)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({8, 512, 16, 64});
+
+// X {1, d0, d1, d2} resized by 2 in both spatial dims
+static void RunResize(benchmark::State& state, const std::string& mode) {
+  SingleNodeBenchmark b("Resize", 18);
+  b.AddInput<float>("X", {1, state.range(0), state.range(1), state.range(2)}, -1.0f, 1.0f);
+  b.AddMissingInput();
+  b.AddInitializer<float>("scales", {4}, {1.0f, 1.0f, 2.0f, 2.0f});
+  b.AddAttribute(MakeAttribute("mode", mode));
+  b.AddOutput("Y");
+  b.Run(state);
+}
+
+static void BM_SingleNode_ResizeLinear(benchmark::State& state) {
+  RunResize(state, "linear");
+}
+
+static void BM_SingleNode_ResizeNearest(benchmark::State& state) {
+  RunResize(state, "nearest");
+}
+
+BENCHMARK(BM_SingleNode_ResizeLinear)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({3, 224, 224})
+    ->Args({64, 56, 56})
+    ->Args({256, 32, 32});
+BENCHMARK(BM_SingleNode_ResizeNearest)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({3, 224, 224})
+    ->Args({64, 56, 56})
+    ->Args({256, 32, 32});
+
+// X {d0, d1} reduced along axis d2 with keepdims
+static void RunReduce(benchmark::State& state, const std::string& op_type) {
+  SingleNodeBenchmark b(op_type, 18);
+  b.AddInput<float>("X", {state.range(0), state.range(1)}, -1.0f, 1.0f);
+  b.AddInitializer<int64_t>("axes", {1}, {state.range(2)});
+  b.AddOutput("reduced");
+  b.Run(state);
+}
+
+static void BM_SingleNode_ReduceSum(benchmark::State& state) {
+  RunReduce(state, "ReduceSum");
+}
+
+static void BM_SingleNode_ReduceMean(benchmark::State& state) {
+  RunReduce(state, "ReduceMean");
+}
+
+static void BM_SingleNode_ReduceMax(benchmark::State& state) {
+  RunReduce(state, "ReduceMax");
+}
+
+static void ReduceShapes(benchmark::internal::Benchmark* b) {
+  b->UseRealTime()
+      ->Unit(benchmark::TimeUnit::kMicrosecond)
+      ->Args({1024, 1024, 1})
+      ->Args({1024, 1024, 0})
+      ->Args({4096, 128, 1})
+      ->Args({128, 4096, 0});
+}
+
+BENCHMARK(BM_SingleNode_ReduceSum)->Apply(ReduceShapes);
+BENCHMARK(BM_SingleNode_ReduceMean)->Apply(ReduceShapes);
+BENCHMARK(BM_SingleNode_ReduceMax)->Apply(ReduceShapes);
+
+// X {d0, d1} normalized along the last axis
+static void BM_SingleNode_LayerNormalization(benchmark::State& state) {
+  SingleNodeBenchmark b("LayerNormalization", 18);
+  b.AddInput<float>("X", {state.range(0), state.range(1)}, -1.0f, 1.0f);
+  b.AddInitializer<float>("scale", {state.range(1)}, std::vector<float>(static_cast<size_t>(state.range(1)), 1.0f));
+  b.AddInitializer<float>("bias", {state.range(1)}, std::vector<float>(static_cast<size_t>(state.range(1)), 0.0f));
+  b.AddAttribute(MakeAttribute("axis", int64_t{-1}));
+  b.AddOutput("Y");
+  b.Run(state);
+}
+
+BENCHMARK(BM_SingleNode_LayerNormalization)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({128, 768})
+    ->Args({2048, 1024})
+    ->Args({1, 4096});
+
+// X {d0, d1} along the last axis
+static void BM_SingleNode_Softmax(benchmark::State& state) {
+  SingleNodeBenchmark b("Softmax", 18);
+  b.AddInput<float>("X", {state.range(0), state.range(1)}, -10.0f, 10.0f);
+  b.AddAttribute(MakeAttribute("axis", int64_t{-1}));
+  b.AddOutput("Y");
+  b.Run(state);
+}
+
+BENCHMARK(BM_SingleNode_Softmax)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1536, 128})
+    ->Args({1, 32000})
+    ->Args({64, 32000});
+
+// the d2 largest of X {d0, d1} along the last axis
+static void BM_SingleNode_TopK(benchmark::State& state) {
+  SingleNodeBenchmark b("TopK", 18);
+  b.AddInput<float>("X", {state.range(0), state.range(1)}, -10.0f, 10.0f);
+  b.AddInitializer<int64_t>("K", {1}, {state.range(2)});
+  b.AddOutput("values");
+  b.AddOutput("indices");
+  b.Run(state);
+}
+
+BENCHMARK(BM_SingleNode_TopK)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 32000, 50})
+    ->Args({64, 1000, 5})
+    ->Args({1, 1000000, 100});
+
+// condition, X and Y {d0}
+template <typename T>
+static void BM_SingleNode_Where(benchmark::State& state) {
+  SingleNodeBenchmark b("Where", 18);
+  b.AddInput<bool>("condition", {state.range(0)}, false, true);
+  b.AddInput<T>("X", {state.range(0)}, T(0), T(100));
+  b.AddInput<T>("Y", {state.range(0)}, T(0), T(100));
+  b.AddOutput("output");
+  b.Run(state);
+}
+
+BENCHMARK_TEMPLATE(BM_SingleNode_Where, float)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(4096)
+    ->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_SingleNode_Where, int32_t)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1 << 20);
@@ -5,6 +5,10 @@
 #pragma warning(disable : 4244)
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <random>
 
 #include "gtest/gtest.h"
@@ -38,6 +42,10 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/embedding_table_quantization.h"
+#include "core/optimizer/gemm_float8_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gather_fusion.h"
@@ -46,20 +54,25 @@
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_norm_fusion.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/graph_transformer_config.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
+#include "core/optimizer/initializer_streaming_transformer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
 #include "core/optimizer/label_encoder_fusion.h"
+#include "core/optimizer/loop_invariant_code_motion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/memory_aware_node_order.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
 #include "core/optimizer/pad_fusion.h"
@@ -69,14 +82,18 @@
 #include "core/optimizer/quick_gelu_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
+#include "core/optimizer/rotary_embedding_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_propagation.h"
+#include "core/optimizer/tensor_parallel_transformer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/platform/env.h"
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math.h"
+#include "core/util/thread_utils.h"
 #include "test/capturing_sink.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/compare_ortvalue.h"
@@ -733,6 +750,175 @@ TEST_F(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+// A Loop whose body computes Relu(w * 2) on every iteration, with the given definitions of its trip count and
+// initial condition.
+static std::string LoopInvariantCodeMotionModel(const std::string& trip_count, const std::string& cond) {
+  return R"(
+    <
+      ir_version: 8,
+      opset_import: ["" : 16]
+    >
+    agraph (int64 m, bool c, float[4] x, float[4] w) => (float[4] y)
+    {
+      )" + trip_count + R"(
+      )" + cond + R"(
+      y = Loop (trip_count, cond, x) <body: graph = loop_body (int64 i, bool cond_in, float[4] x_in) =>
+                                                             (bool cond_out, float[4] x_out) {
+        cond_out = Identity (cond_in)
+        scale = Constant <value: tensor = float[1] {2.0}> ()
+        w_scaled = Mul (w, scale)
+        w_projected = Relu (w_scaled)
+        x_out = Add (x_in, w_projected)
+      }>
+    }
+  )";
+}
+
+// The Mul and Relu of the Loop body only depend on an outer scope value and a constant, so they are computed once
+// in the main graph. The Add reads the loop-carried value and stays in the body.
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotion) {
+  const std::string code = LoopInvariantCodeMotionModel(
+      "trip_count = Constant <value: tensor = int64 trip_count_value {3}> ()",
+      "cond = Constant <value: tensor = bool cond_value {1}> ()");
+
+  ONNX_NAMESPACE::OnnxParser parser(code.c_str());
+  ONNX_NAMESPACE::ModelProto model_proto;
+  auto parse_status = parser.Parse(model_proto);
+  ASSERT_TRUE(parse_status.IsOK()) << parse_status.ErrorMessage();
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(std::move(model_proto), model, nullptr, *logger_));
+  Graph& graph = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<LoopInvariantCodeMotion>(),
+                                                     TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph, false);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Loop"], 1);
+  EXPECT_TRUE(graph.IsInitializedTensor("scale"));
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Loop") {
+      const Graph& body = *node.GetGraphAttribute("body");
+      op_to_count = CountOpsInGraph(body, false);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+      EXPECT_EQ(op_to_count["Relu"], 0);
+      EXPECT_EQ(op_to_count["Identity"], 1);
+      EXPECT_EQ(op_to_count["Add"], 1);
+      EXPECT_FALSE(body.IsInitializedTensor("scale"));
+
+      const auto& implicit_inputs = node.ImplicitInputDefs();
+      EXPECT_TRUE(std::any_of(implicit_inputs.begin(), implicit_inputs.end(),
+                              [](const NodeArg* arg) { return arg->Name() == "w_projected"; }));
+    }
+  }
+}
+
+// Nothing is moved out of a Loop that may not run its body: the moved nodes would run anyway.
+TEST_F(GraphTransformationTests, LoopInvariantCodeMotionLoopMayNotRun) {
+  const std::pair<std::string, std::string> cases[] = {
+      // no iterations
+      {"trip_count = Constant <value: tensor = int64 trip_count_value {0}> ()",
+       "cond = Constant <value: tensor = bool cond_value {1}> ()"},
+      // initially false condition
+      {"trip_count = Constant <value: tensor = int64 trip_count_value {3}> ()",
+       "cond = Constant <value: tensor = bool cond_value {0}> ()"},
+      // trip count and condition known at run time only
+      {"trip_count = Identity (m)", "cond = Constant <value: tensor = bool cond_value {1}> ()"},
+      {"trip_count = Constant <value: tensor = int64 trip_count_value {3}> ()", "cond = Identity (c)"},
+  };
+
+  for (const auto& [trip_count, cond] : cases) {
+    const std::string code = LoopInvariantCodeMotionModel(trip_count, cond);
+    ONNX_NAMESPACE::OnnxParser parser(code.c_str());
+    ONNX_NAMESPACE::ModelProto model_proto;
+    auto parse_status = parser.Parse(model_proto);
+    ASSERT_TRUE(parse_status.IsOK()) << parse_status.ErrorMessage();
+
+    std::shared_ptr<Model> model;
+    ASSERT_STATUS_OK(Model::Load(std::move(model_proto), model, nullptr, *logger_));
+    Graph& graph = model->MainGraph();
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<LoopInvariantCodeMotion>(),
+                                                       TransformerLevel::Level1));
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph, false);
+    EXPECT_EQ(op_to_count["Mul"], 0) << trip_count << ", " << cond;
+    EXPECT_EQ(op_to_count["Relu"], 0) << trip_count << ", " << cond;
+  }
+}
+
+// Folds a DAG of constant nodes with several nodes per level on a thread pool. Only the folded value the MatMul
+// reads becomes an initializer.
+TEST_F(GraphTransformationTests, ConstantFoldingInParallel) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{4, 3}});
+    auto* a_arg = builder.MakeInitializer<float>({2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    auto* b_arg = builder.MakeInitializer<float>({2, 3}, {-1.f, 0.5f, 2.f, 0.f, 1.f, -2.f});
+    auto* transpose_a_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* transpose_add_out = builder.MakeIntermediate();
+    auto* sum_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Transpose", {a_arg}, {transpose_a_out});
+    builder.AddNode("Mul", {a_arg, b_arg}, {mul_out});
+    builder.AddNode("Add", {mul_out, a_arg}, {add_out});
+    builder.AddNode("Transpose", {add_out}, {transpose_add_out});
+    builder.AddNode("Add", {transpose_add_out, transpose_a_out}, {sum_out});
+    builder.AddNode("MatMul", {input_arg, sum_out}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Transpose"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Transpose"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 1);
+
+    for (const auto& node : graph.Nodes()) {
+      const auto* weight = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      TEST_RETURN_IF_NOT(weight != nullptr);
+      Initializer folded{*weight, graph.ModelPath()};
+      // transpose(a * b + a) + transpose(a)
+      const std::vector<float> expected{1.f, 8.f, 5.f, 15.f, 12.f, 0.f};
+      TEST_RETURN_IF_NOT(folded.dims().size() == 2 && folded.dims()[0] == 3 && folded.dims()[1] == 2);
+      TEST_RETURN_IF_NOT(std::vector<float>(folded.data<float>(), folded.data<float>() + folded.size()) == expected);
+    }
+    return Status::OK();
+  };
+
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  ConfigOptions config_options;
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsEnableParallelConstantFolding, "1"));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_,
+                                        std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/,
+                                                                          config_options,
+                                                                          InlinedHashSet<std::string_view>{},
+                                                                          InlinedHashSet<std::string>{},
+                                                                          thread_pool.get()),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingWithShapeToInitializer) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/constant_folding_with_shape_to_initializer.onnx";
   std::shared_ptr<Model> model;
@@ -4949,6 +5135,741 @@ TEST_F(GraphTransformationTests, CseWithConstantOfShape) {
                                         1, pre_graph_checker, post_graph_checker));
 }
 
+TEST_F(GraphTransformationTests, SymbolicShapePropagation) {
+  // Appends a step to a [batch, seq] sequence and drops its first step again, so the result has the shape of the input
+  // only if the dims of the intermediate values are named.
+  NodeArg* concat_out = nullptr;
+  NodeArg* slice_out = nullptr;
+  NodeArg* add_out = nullptr;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input = builder.MakeSymbolicInput<float>({"batch", "seq"});
+    auto* step = builder.MakeSymbolicInput<float>({"batch", int64_t{1}});
+    concat_out = builder.MakeIntermediate();
+    slice_out = builder.MakeIntermediate();
+    add_out = builder.MakeOutput();
+    builder.AddNode("Concat", {input, step}, {concat_out}).AddAttribute("axis", int64_t{1});
+    builder.AddNode("Slice", {concat_out, builder.MakeInitializer<int64_t>({1}, {1}),
+                              builder.MakeInitializer<int64_t>({1}, {std::numeric_limits<int64_t>::max()}),
+                              builder.MakeInitializer<int64_t>({1}, {1})},
+                    {slice_out});
+    builder.AddNode("Add", {slice_out, input}, {add_out});
+  };
+
+  auto get_dim_param = [](const NodeArg* arg, int index) {
+    const auto* shape = arg->Shape();
+    return shape != nullptr && shape->dim_size() > index ? shape->dim(index).dim_param() : std::string();
+  };
+
+  auto pre_graph_checker = [&](Graph&) {
+    TEST_RETURN_IF_NOT(get_dim_param(concat_out, 1).empty());
+    TEST_RETURN_IF_NOT(get_dim_param(slice_out, 1).empty());
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph&) {
+    TEST_RETURN_IF_NOT(get_dim_param(concat_out, 0) == "batch");
+    TEST_RETURN_IF_NOT(get_dim_param(concat_out, 1) == "seq + 1");
+    TEST_RETURN_IF_NOT(get_dim_param(slice_out, 1) == "seq");
+    TEST_RETURN_IF_NOT(get_dim_param(add_out, 1) == "seq");
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<SymbolicShapePropagation>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level1,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ElementwiseChainFusion) {
+  // Tanh((x + bias) * (x + bias)) - (x + bias), where x + bias is consumed three times within the chain
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3, 4}});
+      auto* bias_arg = builder.MakeInitializer<float>({4}, {0.1f, 0.2f, 0.3f, 0.4f});
+      auto* add_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeIntermediate();
+      auto* tanh_out = builder.MakeIntermediate();
+      auto* sub_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Mul", {add_out, add_out}, {mul_out});
+      builder.AddNode("Tanh", {mul_out}, {tanh_out});
+      builder.AddNode("Sub", {tanh_out, add_out}, {sub_out});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Sub"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count.size() == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 1);
+      for (auto& node : graph.Nodes()) {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 2);
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings_size() == 4);
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings(0) == "Add");
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings(3) == "Sub");
+        const std::vector<int64_t> expected_operands = {0, 1, 2, 2, 3, -1, 4, 2};
+        const auto& operands = attrs.at("operands").ints();
+        TEST_RETURN_IF_NOT(std::vector<int64_t>(operands.begin(), operands.end()) == expected_operands);
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseChainFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The output of Relu is also consumed outside of the chain, so the chain is split into two fused nodes.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3, 4}});
+      auto* bias_arg = builder.MakeInitializer<float>({4}, {0.1f, 0.2f, 0.3f, 0.4f});
+      auto* add_out = builder.MakeIntermediate();
+      auto* relu_out = builder.MakeIntermediate();
+      auto* exp_out = builder.MakeIntermediate();
+      auto* neg_out = builder.MakeOutput();
+      auto* identity_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Relu", {add_out}, {relu_out});
+      builder.AddNode("Exp", {relu_out}, {exp_out});
+      builder.AddNode("Neg", {exp_out}, {neg_out});
+      builder.AddNode("Identity", {relu_out}, {identity_out});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Relu"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count.size() == 2);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 2);
+      TEST_RETURN_IF_NOT(op_to_count["Identity"] == 1);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseChainFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // A float16 chain is only fused on the CUDA EP.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<MLFloat16>({{2, 3, 4}});
+      auto* bias_arg = builder.MakeInitializer<MLFloat16>(
+          {4}, {MLFloat16(0.1f), MLFloat16(0.2f), MLFloat16(0.3f), MLFloat16(0.4f)});
+      auto* add_out = builder.MakeIntermediate();
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+      builder.AddNode("Mul", {add_out, sigmoid_out}, {mul_out});
+    };
+
+    for (const char* provider : {kCpuExecutionProvider, kCudaExecutionProvider}) {
+      SCOPED_TRACE(provider);
+      const bool is_fused = std::string(provider) == kCudaExecutionProvider;
+
+      auto pre_graph_checker = [&](Graph& graph) {
+        for (auto& node : graph.Nodes()) node.SetExecutionProviderType(provider);
+        TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Sigmoid"] == 1);
+        return Status::OK();
+      };
+
+      auto post_graph_checker = [&](Graph& graph) {
+        auto op_to_count = CountOpsInGraph(graph);
+        TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == (is_fused ? 1 : 0));
+        TEST_RETURN_IF_NOT(op_to_count["Sigmoid"] == (is_fused ? 0 : 1));
+        for (auto& node : graph.Nodes()) {
+          TEST_RETURN_IF_NOT(node.GetExecutionProviderType() == provider);
+        }
+        return Status::OK();
+      };
+
+      std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseChainFusion>();
+      ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                            TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+    }
+  }
+}
+
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  // Gather of [batch_size, bag_size] rows followed by the ReduceSum of the bags, with the axes as an input
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* data_arg = builder.MakeInitializer<float>({10, 8}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 3}, {0, 9, 2, -1, 4, 4, 7, 1, 3, 5, 6, 8});
+      auto* axes_arg = builder.Make1DInitializer<int64_t>({1});
+      auto* gather_out = builder.MakeIntermediate();
+      auto* reduce_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {data_arg, indices_arg}, {gather_out}).AddAttribute("axis", static_cast<int64_t>(0));
+      builder.AddNode("ReduceSum", {gather_out, axes_arg}, {reduce_out})
+          .AddAttribute("keepdims", static_cast<int64_t>(0));
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ReduceSum"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count.size() == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.EmbeddingBag"] == 1);
+      for (auto& node : graph.Nodes()) {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("mode").s() == "sum");
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingBagFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // ReduceMean of the bags of [batch_size, num_features, bag_size] indices, with a negative axis
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* data_arg = builder.MakeInitializer<float>({10, 8}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({2, 2, 3}, 0, 9);
+      auto* gather_out = builder.MakeIntermediate();
+      auto* reduce_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {data_arg, indices_arg}, {gather_out});
+      auto& reduce_node = builder.AddNode("ReduceMean", {gather_out}, {reduce_out});
+      reduce_node.AddAttribute("axes", std::vector<int64_t>{-2});
+      reduce_node.AddAttribute("keepdims", static_cast<int64_t>(0));
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ReduceMean"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count.size() == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.EmbeddingBag"] == 1);
+      for (auto& node : graph.Nodes()) {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("mode").s() == "mean");
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingBagFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The reduced dim is kept, so the Gather and ReduceSum are left as they are.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* data_arg = builder.MakeInitializer<float>({10, 8}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 3}, 0, 9);
+      auto* axes_arg = builder.Make1DInitializer<int64_t>({1});
+      auto* gather_out = builder.MakeIntermediate();
+      auto* reduce_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {data_arg, indices_arg}, {gather_out});
+      builder.AddNode("ReduceSum", {gather_out, axes_arg}, {reduce_out});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ReduceSum"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ReduceSum"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.EmbeddingBag"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingBagFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+TEST_F(GraphTransformationTests, GroupNormFusion) {
+  // Reshape, InstanceNormalization of the groups, Reshape to the Shape of the input, Mul, Add and SiLU
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 8, 3, 3}});
+      auto* group_shape_arg = builder.Make1DInitializer<int64_t>({0, 4, -1});
+      auto* scale_arg = builder.Make1DInitializer<float>({1.0f, 1.0f, 1.0f, 1.0f});
+      auto* bias_arg = builder.Make1DInitializer<float>({0.0f, 0.0f, 0.0f, 0.0f});
+      auto* gamma_arg = builder.MakeInitializer<float>({8, 1, 1}, -1.0f, 1.0f);
+      auto* beta_arg = builder.MakeInitializer<float>({8, 1, 1}, -1.0f, 1.0f);
+      auto* reshape_out = builder.MakeIntermediate();
+      auto* instance_norm_out = builder.MakeIntermediate();
+      auto* shape_out = builder.MakeIntermediate();
+      auto* reshape_back_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeIntermediate();
+      auto* add_out = builder.MakeIntermediate();
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Reshape", {input_arg, group_shape_arg}, {reshape_out});
+      builder.AddNode("InstanceNormalization", {reshape_out, scale_arg, bias_arg}, {instance_norm_out})
+          .AddAttribute("epsilon", 1e-6f);
+      builder.AddNode("Shape", {input_arg}, {shape_out});
+      builder.AddNode("Reshape", {instance_norm_out, shape_out}, {reshape_back_out});
+      builder.AddNode("Mul", {reshape_back_out, gamma_arg}, {mul_out});
+      builder.AddNode("Add", {mul_out, beta_arg}, {add_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+      builder.AddNode("Mul", {add_out, sigmoid_out}, {output_arg});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["InstanceNormalization"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count.size() == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GroupNorm"] == 1);
+      for (auto& node : graph.Nodes()) {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("groups").i() == 4);
+        TEST_RETURN_IF_NOT(attrs.at("activation").i() == 1);
+        TEST_RETURN_IF_NOT(attrs.at("channels_last").i() == 0);
+        TEST_RETURN_IF_NOT(attrs.at("epsilon").f() == 1e-6f);
+        TEST_RETURN_IF_NOT(node.InputDefs()[1]->Shape()->dim_size() == 1);
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GroupNormFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The InstanceNormalization has an affine transform of its own, so nothing is fused.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 8, 3, 3}});
+      auto* group_shape_arg = builder.Make1DInitializer<int64_t>({2, 4, -1});
+      auto* output_shape_arg = builder.Make1DInitializer<int64_t>({2, 8, 3, 3});
+      auto* scale_arg = builder.Make1DInitializer<float>({1.0f, 2.0f, 1.0f, 1.0f});
+      auto* bias_arg = builder.Make1DInitializer<float>({0.0f, 0.0f, 0.0f, 0.0f});
+      auto* gamma_arg = builder.MakeInitializer<float>({8, 1, 1}, -1.0f, 1.0f);
+      auto* beta_arg = builder.MakeInitializer<float>({8, 1, 1}, -1.0f, 1.0f);
+      auto* reshape_out = builder.MakeIntermediate();
+      auto* instance_norm_out = builder.MakeIntermediate();
+      auto* reshape_back_out = builder.MakeIntermediate();
+      auto* mul_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Reshape", {input_arg, group_shape_arg}, {reshape_out});
+      builder.AddNode("InstanceNormalization", {reshape_out, scale_arg, bias_arg}, {instance_norm_out});
+      builder.AddNode("Reshape", {instance_norm_out, output_shape_arg}, {reshape_back_out});
+      builder.AddNode("Mul", {reshape_back_out, gamma_arg}, {mul_out});
+      builder.AddNode("Add", {mul_out, beta_arg}, {output_arg});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["InstanceNormalization"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["InstanceNormalization"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.GroupNorm"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GroupNormFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+TEST_F(GraphTransformationTests, EmbeddingTableQuantization) {
+  // A large table looked up by a Gather and an EmbeddingBag, and a small table that is left as it is
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* table_arg = builder.MakeInitializer<float>({64, 16}, -1.0f, 1.0f);
+      auto* small_table_arg = builder.MakeInitializer<float>({8, 4}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 3}, 0, 7);
+      auto* gather_out = builder.MakeOutput();
+      auto* bag_out = builder.MakeOutput();
+      auto* small_gather_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {table_arg, indices_arg}, {gather_out});
+      builder.AddNode("EmbeddingBag", {table_arg, indices_arg}, {bag_out}, kMSDomain)
+          .AddAttribute("mode", std::string("mean"));
+      builder.AddNode("Gather", {small_table_arg, indices_arg}, {small_gather_out});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 2);
+      TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 2U);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Gather"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.EmbeddingBag"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GatherRowQuantized"] == 2);
+      // The small table, and the quantized values, scales and biases that replace the large one.
+      TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 4U);
+      std::vector<std::string> modes;
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() != "GatherRowQuantized") {
+          continue;
+        }
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("bits").i() == 4);
+        TEST_RETURN_IF_NOT(attrs.at("embedding_dim").i() == 16);
+        modes.push_back(attrs.at("mode").s());
+        const auto* data = graph_utils::GetConstantInitializer(graph, node.InputDefs()[0]->Name());
+        TEST_RETURN_IF_NOT(data != nullptr && data->data_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+        TEST_RETURN_IF_NOT(data->dims(0) == 64 && data->dims(1) == 8);
+      }
+      std::sort(modes.begin(), modes.end());
+      TEST_RETURN_IF_NOT((modes == std::vector<std::string>{"mean", "none"}));
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingTableQuantization>(4, 512);
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The table is also consumed by a MatMul, so it is not quantized.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* table_arg = builder.MakeInitializer<float>({64, 16}, -1.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4}, 0, 63);
+      auto* input_arg = builder.MakeInput<float>({{2, 64}});
+      auto* gather_out = builder.MakeOutput();
+      auto* matmul_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {table_arg, indices_arg}, {gather_out});
+      builder.AddNode("MatMul", {input_arg, table_arg}, {matmul_out});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.GatherRowQuantized"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingTableQuantization>(8, 512);
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                          1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+#if !defined(DISABLE_FLOAT8_TYPES)
+TEST_F(GraphTransformationTests, GemmFloat8Fusion) {
+  constexpr int64_t K = 32;
+  constexpr int64_t N = 16;
+  std::vector<Float8E4M3FN> b_values;
+  for (int64_t i = 0; i < K * N; ++i) {
+    b_values.emplace_back(static_cast<float>(i % 13 - 6));
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* a_arg = builder.MakeInput<Float8E4M3FN>(std::vector<int64_t>{2, 3, K});
+    auto* scale_a_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* b_arg = builder.MakeInitializer<Float8E4M3FN>({K, N}, b_values);
+    auto* scale_b_arg = builder.Make1DInitializer<float>(std::vector<float>(N, 0.25f));
+    auto* dq_a_out = builder.MakeIntermediate();
+    auto* dq_b_out = builder.MakeIntermediate();
+    auto* matmul_out = builder.MakeOutput();
+
+    builder.AddNode("DequantizeLinear", {a_arg, scale_a_arg}, {dq_a_out});
+    builder.AddNode("DequantizeLinear", {b_arg, scale_b_arg}, {dq_b_out})
+        .AddAttribute("axis", static_cast<int64_t>(1));
+    builder.AddNode("MatMul", {dq_a_out, dq_b_out}, {matmul_out});
+  };
+
+  // The nodes are assigned to the CUDA EP, B is transposed.
+  {
+    auto pre_graph_checker = [&](Graph& graph) {
+      for (auto& node : graph.Nodes()) node.SetExecutionProviderType(kCudaExecutionProvider);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["DequantizeLinear"] == 2);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 1);
+      // The scales and the transposed B.
+      TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 3U);
+      for (auto& node : graph.Nodes()) {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("transA").i() == 0);
+        TEST_RETURN_IF_NOT(attrs.at("transB").i() == 1);
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 5U && !node.InputDefs()[2]->Exists());
+        const auto* b_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+        TEST_RETURN_IF_NOT(b_proto != nullptr && b_proto->dims(0) == N && b_proto->dims(1) == K);
+        const Initializer b_transposed{*b_proto, graph.ModelPath()};
+        const auto bytes = b_transposed.DataAsByteSpan();
+        for (int64_t k = 0; k < K; ++k) {
+          for (int64_t n = 0; n < N; ++n) {
+            TEST_RETURN_IF_NOT(bytes[n * K + k] == b_values[k * N + n].val);
+          }
+        }
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GemmFloat8Fusion>(
+        InlinedHashSet<std::string_view>{kCudaExecutionProvider});
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 19, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The nodes are assigned to the CPU EP, which has no GemmFloat8.
+  {
+    auto pre_graph_checker = [&](Graph& graph) {
+      for (auto& node : graph.Nodes()) node.SetExecutionProviderType(kCpuExecutionProvider);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 2);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GemmFloat8Fusion>(
+        InlinedHashSet<std::string_view>{kCudaExecutionProvider});
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 19, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+#endif  // !defined(DISABLE_FLOAT8_TYPES)
+
+#if defined(ORT_USE_NCCL)
+// The weights of rank 1 of 2: the columns [4, 8) of W1 and b1, and the rows [4, 8) of W2.
+TEST_F(GraphTransformationTests, TensorParallelMLP) {
+  std::vector<float> w1_values(4 * 8);
+  std::iota(w1_values.begin(), w1_values.end(), 0.0f);
+  std::vector<float> b1_values(8);
+  std::iota(b1_values.begin(), b1_values.end(), 100.0f);
+  std::vector<float> w2_values(8 * 4);
+  std::iota(w2_values.begin(), w2_values.end(), 200.0f);
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(std::vector<int64_t>{2, 3, 4});
+    auto* w1_arg = builder.MakeInitializer<float>({4, 8}, w1_values);
+    auto* b1_arg = builder.MakeInitializer<float>({8}, b1_values);
+    auto* w2_arg = builder.MakeInitializer<float>({8, 4}, w2_values);
+    auto* b2_arg = builder.MakeInitializer<float>({4}, std::vector<float>(4, 1.0f));
+    auto* matmul1_out = builder.MakeIntermediate();
+    auto* add1_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* matmul2_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, w1_arg}, {matmul1_out});
+    builder.AddNode("Add", {matmul1_out, b1_arg}, {add1_out});
+    builder.AddNode("Relu", {add1_out}, {relu_out});
+    builder.AddNode("MatMul", {relu_out, w2_arg}, {matmul2_out});
+    builder.AddNode("Add", {matmul2_out, b2_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    for (auto& node : graph.Nodes()) node.SetExecutionProviderType(kCudaExecutionProvider);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.AllReduce"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 2);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "AllReduce") {
+        // The second MatMul is reduced before its bias is added.
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0)->OpType() == "MatMul");
+        TEST_RETURN_IF_NOT(node.OutputNodesBegin()->OpType() == "Add");
+        continue;
+      }
+
+      const bool is_first = node.OpType() == "MatMul" && graph.IsInputsIncludingInitializers(node.InputDefs()[0]);
+      const bool is_bias = node.OpType() == "Add" && node.OutputNodesBegin() != node.OutputNodesEnd();
+      const bool is_second = node.OpType() == "MatMul" && !is_first;
+      if (!is_first && !is_bias && !is_second) {
+        continue;
+      }
+      const auto* proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      TEST_RETURN_IF_NOT(proto != nullptr);
+      const Initializer shard{*proto, graph.ModelPath()};
+      const auto values = shard.DataAsSpan<float>();
+      if (is_first) {
+        TEST_RETURN_IF_NOT(shard.dims().size() == 2U && shard.dims()[0] == 4 && shard.dims()[1] == 4);
+        for (int64_t row = 0; row < 4; ++row) {
+          for (int64_t column = 0; column < 4; ++column) {
+            TEST_RETURN_IF_NOT(values[row * 4 + column] == w1_values[row * 8 + 4 + column]);
+          }
+        }
+      } else if (is_bias) {
+        TEST_RETURN_IF_NOT(shard.dims().size() == 1U && shard.dims()[0] == 4);
+        TEST_RETURN_IF_NOT(std::equal(values.begin(), values.end(), b1_values.begin() + 4));
+      } else {
+        TEST_RETURN_IF_NOT(shard.dims().size() == 2U && shard.dims()[0] == 4 && shard.dims()[1] == 4);
+        TEST_RETURN_IF_NOT(std::equal(values.begin(), values.end(), w2_values.begin() + 16));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<TensorParallelTransformer>(
+      1, 2, InlinedHashSet<std::string_view>{kCudaExecutionProvider});
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// The heads [2, 4) of 4 on rank 1 of 2: the columns [4, 8) of each of the Q, K and V sections of the weights.
+TEST_F(GraphTransformationTests, TensorParallelAttention) {
+  constexpr int64_t hidden_size = 8;
+  std::vector<float> qkv_weight_values(hidden_size * 3 * hidden_size);
+  std::iota(qkv_weight_values.begin(), qkv_weight_values.end(), 0.0f);
+  std::vector<float> qkv_bias_values(3 * hidden_size);
+  std::iota(qkv_bias_values.begin(), qkv_bias_values.end(), 1000.0f);
+  std::vector<float> output_weight_values(hidden_size * hidden_size);
+  std::iota(output_weight_values.begin(), output_weight_values.end(), 2000.0f);
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(std::vector<int64_t>{2, 3, hidden_size});
+    auto* qkv_weight_arg = builder.MakeInitializer<float>({hidden_size, 3 * hidden_size}, qkv_weight_values);
+    auto* qkv_bias_arg = builder.MakeInitializer<float>({3 * hidden_size}, qkv_bias_values);
+    auto* output_weight_arg = builder.MakeInitializer<float>({hidden_size, hidden_size}, output_weight_values);
+    auto* attention_out = builder.MakeIntermediate();
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Attention", {input_arg, qkv_weight_arg, qkv_bias_arg}, {attention_out}, kMSDomain)
+        .AddAttribute("num_heads", static_cast<int64_t>(4));
+    builder.AddNode("MatMul", {attention_out, output_weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, input_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    for (auto& node : graph.Nodes()) node.SetExecutionProviderType(kCudaExecutionProvider);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.AllReduce"] == 1);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "Attention") {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("num_heads").i() == 2);
+        const Initializer weight{*graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name()),
+                                 graph.ModelPath()};
+        const Initializer bias{*graph_utils::GetConstantInitializer(graph, node.InputDefs()[2]->Name()),
+                               graph.ModelPath()};
+        TEST_RETURN_IF_NOT(weight.dims()[0] == hidden_size && weight.dims()[1] == 12);
+        TEST_RETURN_IF_NOT(bias.dims()[0] == 12);
+        const auto weight_values = weight.DataAsSpan<float>();
+        const auto bias_values = bias.DataAsSpan<float>();
+        for (int64_t section = 0; section < 3; ++section) {
+          for (int64_t column = 0; column < 4; ++column) {
+            const int64_t original_column = section * hidden_size + 4 + column;
+            TEST_RETURN_IF_NOT(bias_values[section * 4 + column] == qkv_bias_values[original_column]);
+            for (int64_t row = 0; row < hidden_size; ++row) {
+              TEST_RETURN_IF_NOT(weight_values[row * 12 + section * 4 + column] ==
+                                 qkv_weight_values[row * 3 * hidden_size + original_column]);
+            }
+          }
+        }
+      } else if (node.OpType() == "MatMul") {
+        const Initializer weight{*graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name()),
+                                 graph.ModelPath()};
+        TEST_RETURN_IF_NOT(weight.dims()[0] == 4 && weight.dims()[1] == hidden_size);
+        const auto values = weight.DataAsSpan<float>();
+        TEST_RETURN_IF_NOT(std::equal(values.begin(), values.end(), output_weight_values.begin() + 4 * hidden_size));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<TensorParallelTransformer>(
+      1, 2, InlinedHashSet<std::string_view>{kCudaExecutionProvider});
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+#endif  // defined(ORT_USE_NCCL)
+
+// The weights of the MatMuls are copied from the host ahead of their use, the bias of the Add stays on the device.
+TEST_F(GraphTransformationTests, InitializerStreaming) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(std::vector<int64_t>{2, 8});
+    auto* w1_arg = builder.MakeInitializer<float>({8, 8}, 0.0f, 1.0f);
+    auto* w2_arg = builder.MakeInitializer<float>({8, 8}, 0.0f, 1.0f);
+    auto* bias_arg = builder.MakeInitializer<float>({8}, 0.0f, 1.0f);
+    auto* matmul1_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* matmul2_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, w1_arg}, {matmul1_out});
+    builder.AddNode("Relu", {matmul1_out}, {relu_out});
+    builder.AddNode("MatMul", {relu_out, w2_arg}, {matmul2_out});
+    builder.AddNode("Add", {matmul2_out, bias_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    for (auto& node : graph.Nodes()) node.SetExecutionProviderType(kCudaExecutionProvider);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MemcpyFromHost"] == 2);
+    TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 3U);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() != "MatMul") {
+        continue;
+      }
+      const Node* copy = graph_utils::GetInputNode(node, 1);
+      TEST_RETURN_IF_NOT(copy != nullptr && copy->OpType() == "MemcpyFromHost");
+      TEST_RETURN_IF_NOT(copy->GetExecutionProviderType() == kCudaExecutionProvider);
+      TEST_RETURN_IF_NOT(graph.IsConstantInitializer(copy->InputDefs()[0]->Name(), false));
+
+      // The copy of the second weight waits for the first MatMul, the producer of the Relu.
+      const bool is_second = graph_utils::GetInputNode(node, 0) != nullptr;
+      size_t num_copy_inputs = 0;
+      for (auto it = copy->InputNodesBegin(); it != copy->InputNodesEnd(); ++it) {
+        TEST_RETURN_IF_NOT(it->OpType() == "MatMul");
+        ++num_copy_inputs;
+      }
+      TEST_RETURN_IF_NOT(num_copy_inputs == (is_second ? 1U : 0U));
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<InitializerStreamingTransformer>(
+      InlinedHashSet<std::string_view>{kCudaExecutionProvider}, 0);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, QuickGelu) {
   // Sigmoid(x*alpha)*x, float
   {
@@ -5239,6 +6160,296 @@ TEST_F(GraphTransformationTests, QuickGelu) {
   }
 }
 
+TEST_F(GraphTransformationTests, RotaryEmbeddingFusion) {
+  // q * cos + rotate_half(q) * sin and the same for k, with the cos and sin lookups shared by both.
+  auto build_test_case = [](bool repeated_halves, int64_t batch_size = 1,
+                            std::vector<int64_t> position_ids_shape = {1, 3}) {
+    return [repeated_halves, batch_size, position_ids_shape](ModelTestBuilder& builder) {
+      constexpr int64_t max_sequence_length = 8;
+      constexpr int64_t head_size = 4;
+      std::vector<float> cos_data;
+      std::vector<float> sin_data;
+      for (int64_t position = 0; position < max_sequence_length; position++) {
+        for (int64_t i = 0; i < head_size; i++) {
+          const float angle = static_cast<float>(position) / static_cast<float>((repeated_halves ? i % 2 : i) + 1);
+          cos_data.push_back(std::cos(angle));
+          sin_data.push_back(std::sin(angle));
+        }
+      }
+
+      std::vector<int64_t> position_ids_data;
+      for (int64_t i = 0; i < TensorShape(position_ids_shape).Size(); i++) {
+        position_ids_data.push_back(i % 3 + 1);
+      }
+
+      auto* position_ids = builder.MakeInput<int64_t>(position_ids_shape, position_ids_data);
+      auto* cos_cache = builder.MakeInitializer<float>({max_sequence_length, head_size}, cos_data);
+      auto* sin_cache = builder.MakeInitializer<float>({max_sequence_length, head_size}, sin_data);
+      auto* axis_0 = builder.MakeInitializer<int64_t>({1}, {0});
+      auto* axis_1 = builder.MakeInitializer<int64_t>({1}, {1});
+      auto* axis_last = builder.MakeInitializer<int64_t>({1}, {-1});
+      auto* half = builder.MakeInitializer<int64_t>({1}, {head_size / 2});
+      auto* end = builder.MakeInitializer<int64_t>({1}, {std::numeric_limits<int64_t>::max()});
+
+      auto* cos_gather = builder.MakeIntermediate();
+      auto* sin_gather = builder.MakeIntermediate();
+      auto* cos = builder.MakeIntermediate();
+      auto* sin = builder.MakeIntermediate();
+      builder.AddNode("Gather", {cos_cache, position_ids}, {cos_gather});
+      builder.AddNode("Gather", {sin_cache, position_ids}, {sin_gather});
+      builder.AddNode("Unsqueeze", {cos_gather, axis_1}, {cos});
+      builder.AddNode("Unsqueeze", {sin_gather, axis_1}, {sin});
+
+      for (int i = 0; i < 2; i++) {
+        auto* x = builder.MakeInput<float>({batch_size, 2, 3, head_size}, -1.0f, 1.0f);
+        auto* first_half = builder.MakeIntermediate();
+        auto* second_half = builder.MakeIntermediate();
+        auto* neg_out = builder.MakeIntermediate();
+        auto* rotated = builder.MakeIntermediate();
+        auto* x_cos = builder.MakeIntermediate();
+        auto* rotated_sin = builder.MakeIntermediate();
+        auto* output = builder.MakeOutput();
+        builder.AddNode("Slice", {x, half, end, axis_last}, {first_half});
+        builder.AddNode("Slice", {x, axis_0, half, axis_last}, {second_half});
+        builder.AddNode("Neg", {first_half}, {neg_out});
+        builder.AddNode("Concat", {neg_out, second_half}, {rotated}).AddAttribute("axis", static_cast<int64_t>(-1));
+        builder.AddNode("Mul", {x, cos}, {x_cos});
+        builder.AddNode("Mul", {sin, rotated}, {rotated_sin});
+        builder.AddNode("Add", {x_cos, rotated_sin}, {output});
+      }
+    };
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Mul"] == 4);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Slice"] == 4);
+    return Status::OK();
+  };
+
+  // The caches repeat the same frequencies in both halves of the head.
+  {
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.RotaryEmbedding"] == 2);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Slice"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Gather"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Unsqueeze"] == 0);
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() == "RotaryEmbedding") {
+          const auto* cos_cache = graph_utils::GetConstantInitializer(graph, node.InputDefs()[2]->Name());
+          TEST_RETURN_IF_NOT(cos_cache != nullptr && cos_cache->dims_size() == 2);
+          TEST_RETURN_IF_NOT(cos_cache->dims(0) == 8 && cos_cache->dims(1) == 2);
+        }
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<RotaryEmbeddingFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case(true), 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The halves of the caches differ, so the pattern is not a RotaryEmbedding.
+  {
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.RotaryEmbedding"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 4);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<RotaryEmbeddingFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case(false), 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+
+  // position_ids has a row per batch entry.
+  {
+    auto post_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.RotaryEmbedding"] == 2);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<RotaryEmbeddingFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case(true, 2, {2, 3}), 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+
+  // The positions are broadcast over the batch, or a single position over the sequence, which RotaryEmbedding
+  // doesn't do.
+  for (const auto& [batch_size, position_ids_shape] : {std::make_pair(int64_t{2}, std::vector<int64_t>{1, 3}),
+                                                       std::make_pair(int64_t{1}, std::vector<int64_t>{1})}) {
+    auto post_graph_checker = [](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.RotaryEmbedding"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["Mul"] == 4);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<RotaryEmbeddingFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case(true, batch_size, position_ids_shape), 14, *logger_,
+                                          std::move(transformer), TransformerLevel::Level2, 1, pre_graph_checker,
+                                          post_graph_checker));
+  }
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion) {
+  // Llama style attention with 2 query heads sharing 1 key/value head of size 4, after RotaryEmbeddingFusion.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* q_proj = builder.MakeInput<float>({1, 2, 8}, -1.0f, 1.0f);
+    auto* k_proj = builder.MakeInput<float>({1, 2, 4}, -1.0f, 1.0f);
+    auto* v_proj = builder.MakeInput<float>({1, 2, 4}, -1.0f, 1.0f);
+    auto* past_key = builder.MakeInput<float>({1, 1, 3, 4}, -1.0f, 1.0f);
+    auto* past_value = builder.MakeInput<float>({1, 1, 3, 4}, -1.0f, 1.0f);
+    auto* position_ids = builder.MakeInput<int64_t>({1, 2}, {3, 4});
+    auto* attention_mask = builder.MakeInput<int64_t>({1, 5}, {1, 1, 1, 1, 1});
+    auto* cos_cache = builder.MakeInitializer<float>({8, 2}, 0.0f, 1.0f);
+    auto* sin_cache = builder.MakeInitializer<float>({8, 2}, 0.0f, 1.0f);
+    auto* present_key = builder.MakeOutput();
+    auto* present_value = builder.MakeOutput();
+    auto* output = builder.MakeOutput();
+
+    auto split_heads = [&](NodeArg* projection, int64_t num_heads, bool rotate) {
+      auto* shape = builder.MakeInitializer<int64_t>({4}, {1, 2, num_heads, 4});
+      auto* reshape_out = builder.MakeIntermediate();
+      auto* transpose_out = builder.MakeIntermediate();
+      builder.AddNode("Reshape", {projection, shape}, {reshape_out});
+      builder.AddNode("Transpose", {reshape_out}, {transpose_out})
+          .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+      if (!rotate) {
+        return transpose_out;
+      }
+      auto* rotary_out = builder.MakeIntermediate();
+      builder.AddNode("RotaryEmbedding", {transpose_out, position_ids, cos_cache, sin_cache}, {rotary_out}, kMSDomain);
+      return rotary_out;
+    };
+
+    auto repeat_kv = [&](NodeArg* present) {
+      auto* axes = builder.MakeInitializer<int64_t>({1}, {2});
+      auto* expand_shape = builder.MakeInitializer<int64_t>({5}, {1, 1, 2, 5, 4});
+      auto* shape = builder.MakeInitializer<int64_t>({4}, {1, 2, 5, 4});
+      auto* unsqueeze_out = builder.MakeIntermediate();
+      auto* expand_out = builder.MakeIntermediate();
+      auto* reshape_out = builder.MakeIntermediate();
+      builder.AddNode("Unsqueeze", {present, axes}, {unsqueeze_out});
+      builder.AddNode("Expand", {unsqueeze_out, expand_shape}, {expand_out});
+      builder.AddNode("Reshape", {expand_out, shape}, {reshape_out});
+      return reshape_out;
+    };
+
+    auto* query = split_heads(q_proj, 2, true);
+    builder.AddNode("Concat", {past_key, split_heads(k_proj, 1, true)}, {present_key})
+        .AddAttribute("axis", static_cast<int64_t>(2));
+    builder.AddNode("Concat", {past_value, split_heads(v_proj, 1, false)}, {present_value})
+        .AddAttribute("axis", static_cast<int64_t>(2));
+
+    auto* mask_axes = builder.MakeInitializer<int64_t>({2}, {1, 2});
+    auto* mask_unsqueeze_out = builder.MakeIntermediate();
+    auto* mask = builder.MakeIntermediate();
+    builder.AddNode("Unsqueeze", {attention_mask, mask_axes}, {mask_unsqueeze_out});
+    builder.AddNode("Cast", {mask_unsqueeze_out}, {mask})
+        .AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+
+    auto* divisor = builder.MakeScalarInitializer<float>(2.0f);
+    auto* output_shape = builder.MakeInitializer<int64_t>({3}, {1, 2, 8});
+    auto* key_transpose_out = builder.MakeIntermediate();
+    auto* qk_out = builder.MakeIntermediate();
+    auto* div_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* softmax_out = builder.MakeIntermediate();
+    auto* pv_out = builder.MakeIntermediate();
+    auto* output_transpose_out = builder.MakeIntermediate();
+    builder.AddNode("Transpose", {repeat_kv(present_key)}, {key_transpose_out})
+        .AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+    builder.AddNode("MatMul", {query, key_transpose_out}, {qk_out});
+    builder.AddNode("Div", {qk_out, divisor}, {div_out});
+    builder.AddNode("Add", {div_out, mask}, {add_out});
+    builder.AddNode("Softmax", {add_out}, {softmax_out}).AddAttribute("axis", static_cast<int64_t>(-1));
+    builder.AddNode("MatMul", {softmax_out, repeat_kv(present_value)}, {pv_out});
+    builder.AddNode("Transpose", {pv_out}, {output_transpose_out})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    builder.AddNode("Reshape", {output_transpose_out, output_shape}, {output});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.RotaryEmbedding"] == 2);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Softmax"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GroupQueryAttention"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.RotaryEmbedding"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Softmax"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Concat"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Transpose"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Unsqueeze"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["ReduceSum"] == 1);
+    for (auto& node : graph.Nodes()) {
+      if (node.OpType() == "GroupQueryAttention") {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("num_heads").i() == 2);
+        TEST_RETURN_IF_NOT(attrs.at("kv_num_heads").i() == 1);
+        TEST_RETURN_IF_NOT(attrs.at("scale").f() == 0.5f);
+        TEST_RETURN_IF_NOT(graph.IsOutput(node.OutputDefs()[1]) && graph.IsOutput(node.OutputDefs()[2]));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<GroupQueryAttentionFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, MemoryAwareNodeOrder) {
+  // Two branches that each expand the input to a large tensor and reduce it again. The priority-based order runs the
+  // nodes in the order they were added, so both large tensors are alive at the same time.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({1, 4}, -1.0f, 1.0f);
+    auto* output = builder.MakeOutput();
+    std::vector<NodeArg*> large;
+    std::vector<NodeArg*> small;
+    for (int i = 0; i < 2; i++) {
+      large.push_back(builder.MakeIntermediate());
+      small.push_back(builder.MakeIntermediate());
+    }
+    for (int i = 0; i < 2; i++) {
+      builder.AddNode("MatMul", {input, builder.MakeInitializer<float>({4, 4096}, -1.0f, 1.0f)}, {large[i]});
+    }
+    for (int i = 0; i < 2; i++) {
+      builder.AddNode("MatMul", {large[i], builder.MakeInitializer<float>({4096, 4}, -1.0f, 1.0f)}, {small[i]});
+    }
+    builder.AddNode("Add", {small[0], small[1]}, {output});
+  };
+
+  // Returns whether each of the large tensors is reduced right after it is computed.
+  auto reduces_each_branch_first = [](const Graph& graph) {
+    GraphViewer graph_viewer(graph);
+    const auto& order = graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED);
+    const Node* first = graph.GetNode(order[0]);
+    const Node* second = graph.GetNode(order[1]);
+    return second->InputDefs()[0] == first->OutputDefs()[0];
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF(reduces_each_branch_first(graph));
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(reduces_each_branch_first(graph));
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MemoryAwareNodeOrder>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer), TransformerLevel::Level3,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+
 struct BiasSoftmaxFusionTester {
   std::shared_ptr<Model> p_model_;
   Status model_load_;
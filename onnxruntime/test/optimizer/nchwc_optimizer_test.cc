@@ -6,6 +6,7 @@
 #include "core/mlas/inc/mlas.h"
 #include "core/session/environment.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/tensorprotoutils.h"
 #include "test/compare_ortvalue.h"
 #include "test/test_environment.h"
@@ -168,7 +169,8 @@ struct NchwcTestHelper {
 
 void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& build_test_case,
                           const std::function<void(InferenceSessionWrapper& session)>& check_nchwc_graph,
-                          int opset_version = 13) {
+                          int opset_version = 13,
+                          const std::function<void(SessionOptions&)>& add_session_options = {}) {
   // Ignore the test if NCHWc is not supported by the platform.
   if (MlasNchwcGetBlockSize() <= 1) {
     return;
@@ -191,6 +193,9 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
     SessionOptions session_options;
     session_options.graph_optimization_level = level;
     session_options.session_logid = "NchwcOptimizerTests";
+    if (add_session_options) {
+      add_session_options(session_options);
+    }
     InferenceSessionWrapper session{session_options, GetEnvironment()};
     ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
     ASSERT_STATUS_OK(session.Initialize());
@@ -1402,6 +1407,43 @@ TEST(NchwcOptimizerTests, MaxPoolTypeCheck) {
   NchwcOptimizerTester(build_test_case, check_nchwc_graph, 12);
 }
 
+TEST(NchwcOptimizerTests, LayoutCostModel) {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
+                       bool expect_nchwc) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>(input_shape);
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      auto& conv_node = helper.AddConvNode(input_arg, conv_output_arg, weights_shape);
+      const int64_t pad = weights_shape[2] / 2;
+      conv_node.AddAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad});
+      helper.AddNode("Relu", {conv_output_arg}, {output_arg});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], expect_nchwc ? 1 : 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], expect_nchwc ? 1 : 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], expect_nchwc ? 1 : 0);
+    };
+
+    auto add_session_options = [](SessionOptions& session_options) {
+      ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsEnableNchwcLayoutCostModel,
+                                                                     "1"));
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, 13, add_session_options);
+  };
+
+  // The im2col buffer of the NCHW convolution costs more than the reorders.
+  test_case({1, 32, 56, 56}, {64, 32, 3, 3}, true);
+
+  // The reorders and the padded output channels cost more than a pointwise
+  // convolution of a single pixel.
+  test_case({1, 64, 1, 1}, {10, 64, 1, 1}, false);
+}
+
 #endif
 
 }  // namespace test
@@ -9,6 +9,7 @@
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selector_action_transformer.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "test/compare_ortvalue.h"
@@ -386,6 +387,22 @@ RunDQMatMulConverted(const std::vector<int64_t>& input1_shape,
     EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 2);
     EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 0);
     EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 0);
+
+    // without the session option, the accuracy level is the one the CPU EP prefers for the block size
+    int64_t expected_accuracy_level = accuracy_level >= 0 ? accuracy_level : 4;
+    if (accuracy_level < 0) {
+      for (const auto& format : CPUExecutionProvider(CPUExecutionProviderInfo()).GetMatMulNBitsFormats()) {
+        if (format.bits == 4 && format.block_size == block_size) {
+          expected_accuracy_level = format.accuracy_level;
+          break;
+        }
+      }
+    }
+    for (const auto& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "MatMulNBits") {
+        EXPECT_EQ(node.GetAttributes().at("accuracy_level").i(), expected_accuracy_level);
+      }
+    }
   };
 
   std::function<void(SessionOptions&)> add_session_options_fn{};
@@ -419,6 +436,11 @@ TEST(QDQTransformerTests, DQMatMulConvertedToMatMulNBits) {
   RunDQMatMulConverted<UInt4x2, false>({12, 12}, {12, 37}, {37, 12}, 0, 16, 1);
 }
 
+TEST(QDQTransformerTests, DQMatMulConvertedToMatMulNBits_EpAccuracyLevel) {
+  RunDQMatMulConverted<Int4x2, true>({12, 32}, {32, 37}, {37, 12}, 0, 16, -1);
+  RunDQMatMulConverted<UInt4x2, false>({12, 32}, {32, 37}, {37, 12}, 0, 32, -1);
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
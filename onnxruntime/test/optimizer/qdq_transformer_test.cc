@@ -13,6 +13,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/qdq_transformer/qdq_final_cleanup.h"
 #include "core/optimizer/qdq_transformer/qdq_propagation.h"
+#include "core/optimizer/qdq_transformer/qlinear_fused_matmul_fusion.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selector_action_transformer.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
@@ -708,6 +709,109 @@ TEST(QDQTransformerTests, MatMul_S8S8U8) {
   QDQTransformerMatMulTests<int8_t, int8_t, uint8_t>(true);
 }
 
+template <typename InputType, typename WeightType, typename OutputType>
+void QDQTransformerFusedMatMulTests(bool has_bias, const std::string& activation) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<InputType>({2, 8, 16},
+                                                   std::numeric_limits<InputType>::min(),
+                                                   std::numeric_limits<InputType>::max());
+    auto* output_arg = builder.MakeOutput();
+
+    auto* weight = builder.MakeInitializer<WeightType>({16, 32}, std::numeric_limits<WeightType>::min() / 2,
+                                                       std::numeric_limits<WeightType>::max() / 2);
+    auto* dq_input_output = builder.MakeIntermediate();
+    auto* dq_weight_output = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<InputType>(input_arg, .02f, std::numeric_limits<InputType>::max() / 2,
+                                               dq_input_output);
+    builder.AddDequantizeLinearNode<WeightType>(weight, .01f, 0, dq_weight_output);
+
+    auto* value = builder.MakeIntermediate();
+    builder.AddNode("MatMul", {dq_input_output, dq_weight_output}, {value});
+    if (has_bias) {
+      auto* bias = builder.MakeInitializer<float>({32}, -1.f, 1.f);
+      auto* add_output = builder.MakeIntermediate();
+      builder.AddNode("Add", {bias, value}, {add_output});
+      value = add_output;
+    }
+    if (!activation.empty()) {
+      auto* activation_output = builder.MakeIntermediate();
+      builder.AddNode(activation, {value}, {activation_output}, activation == "Gelu" ? kMSDomain : "");
+      value = activation_output;
+    }
+
+    auto* q_output = builder.MakeIntermediate();
+    builder.AddQuantizeLinearNode<OutputType>(value, .039f, std::numeric_limits<OutputType>::max() / 2 + 1, q_output);
+    builder.AddDequantizeLinearNode<OutputType>(q_output, .039f, std::numeric_limits<OutputType>::max() / 2 + 1,
+                                                output_arg);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.QLinearFusedMatMul"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.Gelu"], 0);
+    EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+    EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+  };
+
+  // The fused kernel rounds the same float values, up to the order of the float summation, so the outputs can
+  // differ by one quantization step of the output.
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level1,
+                    TransformerLevel::Level2,
+                    13 /*opset_version*/,
+                    0.04 /*per_sample_tolerance*/,
+                    0.0 /*relative_per_sample_tolerance*/,
+                    std::make_unique<QLinearFusedMatMulFusion>());
+}
+
+TEST(QDQTransformerTests, FusedMatMul_U8S8U8) {
+  QDQTransformerFusedMatMulTests<uint8_t, int8_t, uint8_t>(true, "Gelu");
+  QDQTransformerFusedMatMulTests<uint8_t, int8_t, uint8_t>(false, "Relu");
+  QDQTransformerFusedMatMulTests<uint8_t, int8_t, uint8_t>(true, "");
+}
+
+TEST(QDQTransformerTests, FusedMatMul_U8U8S8) {
+  QDQTransformerFusedMatMulTests<uint8_t, uint8_t, int8_t>(true, "Relu");
+}
+
+TEST(QDQTransformerTests, FusedMatMul_S8S8S8) {
+  QDQTransformerFusedMatMulTests<int8_t, int8_t, int8_t>(true, "Gelu");
+}
+
+TEST(QDQTransformerTests, FusedMatMul_NotFusedWithoutBiasOrActivation) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<uint8_t>({2, 16}, 0, 255);
+    auto* output_arg = builder.MakeOutput();
+    auto* weight = builder.MakeInitializer<int8_t>({16, 32}, -64, 64);
+    auto* dq_input_output = builder.MakeIntermediate();
+    auto* dq_weight_output = builder.MakeIntermediate();
+    auto* matmul_output = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<uint8_t>(input_arg, .02f, 128, dq_input_output);
+    builder.AddDequantizeLinearNode<int8_t>(weight, .01f, 0, dq_weight_output);
+    builder.AddNode("MatMul", {dq_input_output, dq_weight_output}, {matmul_output});
+    builder.AddQuantizeLinearNode<uint8_t>(matmul_output, .039f, 128, output_arg);
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.QLinearFusedMatMul"], 0);
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level1,
+                    TransformerLevel::Level2,
+                    13 /*opset_version*/,
+                    0.0 /*per_sample_tolerance*/,
+                    0.0 /*relative_per_sample_tolerance*/,
+                    std::make_unique<QLinearFusedMatMulFusion>());
+}
+
 template <typename Input1Type, typename Input2Type, typename OutputType, typename BiasType = int32_t>
 void QDQTransformerGemmTests(bool has_output_q, bool has_bias, bool beta_not_one = false) {
   auto test_case = [&](const std::vector<int64_t>& input1_shape, const std::vector<int64_t>& input2_shape,
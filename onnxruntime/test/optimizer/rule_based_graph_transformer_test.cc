@@ -71,5 +71,51 @@ TEST(RuleBasedGraphTransformerTest, TestSettingStepsInGraphTransformerManager) {
   ASSERT_STATUS_OK(graph_transformation_mgr.GetSteps(steps_queried));
   ASSERT_EQ(steps_queried, static_cast<unsigned>(10));
 }
+
+namespace {
+// reports a modification for its first `num_modifications` runs, and counts its runs
+class CountingGraphTransformer : public GraphTransformer {
+ public:
+  CountingGraphTransformer(const std::string& name, int num_modifications) noexcept
+      : GraphTransformer(name), num_modifications_(num_modifications) {}
+
+  int NumRuns() const { return num_runs_; }
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/, const logging::Logger&) const override {
+    modified = num_runs_++ < num_modifications_;
+    return Status::OK();
+  }
+
+  int num_modifications_;
+  mutable int num_runs_{0};
+};
+}  // namespace
+
+// a transformer that made no change should not run again until another transformer modifies the graph
+TEST(RuleBasedGraphTransformerTest, TestUnchangedTransformersAreSkipped) {
+  auto model_uri = ORT_TSTR("testdata/transform/fusion/fuse-conv-bn-mul-add-unsqueeze.onnx");
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  Graph& graph = model->MainGraph();
+
+  auto modifying_transformer = std::make_unique<CountingGraphTransformer>("Modifying", 2);
+  auto unchanged_transformer = std::make_unique<CountingGraphTransformer>("Unchanged", 0);
+  const auto* modifying_transformer_ptr = modifying_transformer.get();
+  const auto* unchanged_transformer_ptr = unchanged_transformer.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(modifying_transformer), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(unchanged_transformer), TransformerLevel::Level2));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2,
+                                                              DefaultLoggingManager().DefaultLogger()));
+
+  // the modifying transformer runs until it makes no change. the last modification was made before the unchanged
+  // transformer ran in the second step, so it is not run in the third step.
+  ASSERT_EQ(modifying_transformer_ptr->NumRuns(), 3);
+  ASSERT_EQ(unchanged_transformer_ptr->NumRuns(), 2);
+}
 }  // namespace test
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // Windows Specific
 #ifdef _WIN32
@@ -37,6 +39,12 @@ namespace perftest {
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-R [arrival_rate]: Issues requests at this rate per second for the duration of -t, whether or not the previous\n"
+      "\t\trequests completed (open loop). The requests wait for one of the -c concurrent runs. Reports the latency\n"
+      "\t\tfrom the arrival of the requests, their queueing delay and the achieved rate.\n"
+      "\t-a [poisson|constant]: Distribution of the arrivals of -R. Default:poisson.\n"
+      "\t-L [p99_latency_ms]: Searches for the max arrival rate of the open loop test with a P99 latency under the\n"
+      "\t\tgiven milliseconds, starting from -R if given. Each trial lasts -t seconds.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|openvino|dml|acl|nnapi|coreml|qnn|snpe|rocm|migraphx|xnnpack|vitisai]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'openvino', 'dml', 'acl', 'nnapi', 'coreml', 'qnn', 'snpe', 'rocm', 'migraphx', 'xnnpack' or 'vitisai'. "
       "Default:'cpu'.\n"
@@ -53,6 +61,13 @@ namespace perftest {
       "Syntax is [dimension_name:override_value]. override_value must > 0\n"
       "\t-F [free_dimension_override]: Specifies a free dimension by denotation to override to a specific value for performance optimization. "
       "Syntax is [dimension_denotation:override_value]. override_value must > 0\n"
+      "\t-G [free_dimension_distribution]: With -I, generates the inputs with every value of a free dimension given by\n"
+      "\t\tname, and runs each with the weight of its value. Syntax is [dimension_name:value*weight,value*weight].\n"
+      "\t\t'*weight' defaults to 1. Several dimensions run every combination of their values.\n"
+      "\t\t[Example] -G \"sequence:128*0.6,512*0.3,2048*0.1\"\n"
+      "\t-Y: Runs the test data sets in the order of their ids instead of at random, e.g. to replay the inputs\n"
+      "\t\trecorded with the session.record_inputs_directory session config. With -s, the latencies are also\n"
+      "\t\treported by input shapes.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
       "\t-o [optimization level]: Default is 99 (all). Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels.\n"
@@ -127,6 +142,7 @@ namespace perftest {
       "\t    [Example] [For NNAPI EP] -e nnapi -i \"NNAPI_FLAG_USE_FP16 NNAPI_FLAG_USE_NCHW NNAPI_FLAG_CPU_DISABLED\"\n"
       "\n"
       "\t    [CoreML only] [COREML_FLAG_CREATE_MLPROGRAM]: Create an ML Program model instead of Neural Network.\n"
+      "\t    [CoreML only] [COREML_FLAG_ENABLE_MODEL_CACHE]: Cache the compiled CoreML model across sessions.\n"
       "\t    [Example] [For CoreML EP] -e coreml -i \"COREML_FLAG_CREATE_MLPROGRAM\"\n"
       "\n"
       "\t    [SNPE only] [runtime]: SNPE runtime, options: 'CPU', 'GPU', 'GPU_FLOAT16', 'DSP', 'AIP_FIXED_TF'. \n"
@@ -171,6 +187,43 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
   return true;
 }
 
+static bool ParseDimensionDistribution(std::string& dim_name, std::vector<std::pair<int64_t, double>>& values) {
+  std::string distribution_str = ToUTF8String(optarg);
+  size_t delimiter_location = distribution_str.find(':');
+  if (delimiter_location == 0 || delimiter_location >= distribution_str.size() - 1) {
+    return false;
+  }
+  dim_name = distribution_str.substr(0, delimiter_location);
+
+  std::istringstream ss(distribution_str.substr(delimiter_location + 1));
+  std::string token;
+  ORT_TRY {
+    while (std::getline(ss, token, ',')) {
+      size_t weight_location = token.find('*');
+      int64_t value = std::stoll(token.substr(0, weight_location));
+      double weight = weight_location == std::string::npos ? 1.0 : std::stod(token.substr(weight_location + 1));
+      if (value <= 0 || weight <= 0) {
+        return false;
+      }
+      values.emplace_back(value, weight);
+    }
+  }
+  ORT_CATCH(...) {
+    return false;
+  }
+  return !values.empty();
+}
+
+static bool ParsePositiveDouble(double& value) {
+  ORT_TRY {
+    value = std::stod(ToUTF8String(optarg));
+  }
+  ORT_CATCH(...) {
+    return false;
+  }
+  return value > 0;
+}
+
 static bool ParseSessionConfigs(const std::string& configs_string,
                                 std::unordered_map<std::string, std::string>& session_configs) {
   std::istringstream ss(configs_string);
@@ -206,7 +259,7 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznl"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:G:S:T:C:R:a:L:AMPIDZYvhsqznl"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -226,6 +279,18 @@ static bool ParseSessionConfigs(const std::string& configs_string,
         test_config.run_config.free_dim_denotation_overrides[dim_denotation] = override_val;
         break;
       }
+      case 'G': {
+        std::string dim_name;
+        std::vector<std::pair<int64_t, double>> values;
+        if (!ParseDimensionDistribution(dim_name, values)) {
+          return false;
+        }
+        test_config.run_config.free_dim_distributions[dim_name] = std::move(values);
+        break;
+      }
+      case 'Y':
+        test_config.run_config.replay_test_data_in_order = true;
+        break;
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
           test_config.run_config.test_mode = TestMode::kFixDurationMode;
@@ -329,6 +394,25 @@ static bool ParseSessionConfigs(const std::string& configs_string,
           return false;
         }
         break;
+      case 'R':
+        if (!ParsePositiveDouble(test_config.run_config.arrival_rate)) {
+          return false;
+        }
+        break;
+      case 'a':
+        if (!CompareCString(optarg, ORT_TSTR("poisson"))) {
+          test_config.run_config.poisson_arrivals = true;
+        } else if (!CompareCString(optarg, ORT_TSTR("constant"))) {
+          test_config.run_config.poisson_arrivals = false;
+        } else {
+          return false;
+        }
+        break;
+      case 'L':
+        if (!ParsePositiveDouble(test_config.run_config.latency_slo_ms)) {
+          return false;
+        }
+        break;
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
@@ -400,6 +484,11 @@ static bool ParseSessionConfigs(const std::string& configs_string,
     }
   }
 
+  // the open loop test uses the duration of -t whatever the order of the options
+  if (test_config.run_config.arrival_rate > 0 || test_config.run_config.latency_slo_ms > 0) {
+    test_config.run_config.test_mode = TestMode::kOpenLoopMode;
+  }
+
   // parse model_path and result_file_path
   argc -= optind;
   argv += optind;
@@ -7,6 +7,8 @@
 #include <limits>
 #include <fstream>
 #include <set>
+#include <sstream>
+#include <unordered_map>
 #include <list>
 #include <type_traits>
 #include <core/session/onnxruntime_cxx_api.h>
@@ -31,9 +33,22 @@ namespace onnxruntime {
 namespace perftest {
 
 std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
-  // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
-  const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
-  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+  size_t test_data_id = 0;
+  return Run(test_data_id);
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::Run(size_t& test_data_id) {
+  if (replay_in_order_) {
+    test_data_id = next_test_data_id_.fetch_add(1, std::memory_order_relaxed) % test_inputs_.size();
+  } else if (weighted_test_data_) {
+    // Pick one OrtValueArray from test_inputs_ with the weights of its free dimensions. (NOT ThreadSafe)
+    test_data_id = weighted_dist_(rand_engine_);
+  } else {
+    // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
+    const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
+    test_data_id = static_cast<size_t>(dist_(rand_engine_, p));
+  }
+  const size_t id = test_data_id;
   auto& input = test_inputs_.at(id);
   auto start = std::chrono::high_resolution_clock::now();
   auto output_values = session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
@@ -47,6 +62,9 @@ OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device
                                                const PerformanceTestConfig& performance_test_config,
                                                const TestModelInfo& m)
     : rand_engine_(rd()), input_names_(m.GetInputCount()), input_names_str_(m.GetInputCount()), input_length_(m.GetInputCount()) {
+  free_dim_distributions_ = performance_test_config.run_config.free_dim_distributions;
+  replay_in_order_ = performance_test_config.run_config.replay_test_data_in_order;
+
   Ort::SessionOptions session_options;
 
   provider_name_ = performance_test_config.machine_config.provider_type_name;
@@ -417,11 +435,14 @@ select from 'TF8', 'TF16', 'UINT8', 'FLOAT', 'ITENSOR'. \n)");
       if (key == "COREML_FLAG_CREATE_MLPROGRAM") {
         coreml_flags |= COREML_FLAG_CREATE_MLPROGRAM;
         std::cout << "Enabling ML Program.\n";
+      } else if (key == "COREML_FLAG_ENABLE_MODEL_CACHE") {
+        coreml_flags |= COREML_FLAG_ENABLE_MODEL_CACHE;
+        std::cout << "Enabling the compiled model cache.\n";
       } else if (key.empty()) {
       } else {
         ORT_THROW(
             "[ERROR] [CoreML] wrong key type entered. Choose from the following runtime key options "
-            "that are available for CoreML. ['COREML_FLAG_CREATE_MLPROGRAM'] \n");
+            "that are available for CoreML. ['COREML_FLAG_CREATE_MLPROGRAM', 'COREML_FLAG_ENABLE_MODEL_CACHE'] \n");
       }
     }
     // COREML_FLAG_CREATE_MLPROGRAM
@@ -937,30 +958,92 @@ static void InitializeTensorWithSeed(int32_t seed, Ort::Value& tensor) {
 }
 
 bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
-  // iterate over all input nodes
+  // the free dimensions with a distribution that the inputs use
+  std::vector<std::string> distributed_dims;
   for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
     Ort::TypeInfo type_info = session_.GetInputTypeInfo(i);
-    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
     if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
       auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-      std::vector<int64_t> input_node_dim = tensor_info.GetShape();
-
-      // free dimensions are treated as 1 if not overridden
-      for (int64_t& dim : input_node_dim) {
-        if (dim == -1) {
-          dim = 1;
+      std::vector<const char*> dim_names(tensor_info.GetDimensionsCount());
+      tensor_info.GetSymbolicDimensions(dim_names.data(), dim_names.size());
+      for (const char* dim_name : dim_names) {
+        if (free_dim_distributions_.count(dim_name) != 0 &&
+            std::find(distributed_dims.begin(), distributed_dims.end(), dim_name) == distributed_dims.end()) {
+          distributed_dims.push_back(dim_name);
         }
       }
+    }
+  }
+
+  size_t num_test_data = 1;
+  for (const auto& dim_name : distributed_dims) {
+    num_test_data *= free_dim_distributions_.at(dim_name).size();
+  }
 
-      auto allocator = Ort::AllocatorWithDefaultOptions();
-      Ort::Value input_tensor = Ort::Value::CreateTensor(allocator, (const int64_t*)input_node_dim.data(),
-                                                         input_node_dim.size(), tensor_info.GetElementType());
-      InitializeTensorWithSeed(seed, input_tensor);
-      PreLoadTestData(0, i, std::move(input_tensor));
+  // one test data per combination of the values of the distributed dimensions
+  std::vector<double> weights;
+  for (size_t test_data_id = 0; test_data_id < num_test_data; ++test_data_id) {
+    std::unordered_map<std::string, int64_t> dim_values;
+    double weight = 1.0;
+    for (size_t j = 0, rest = test_data_id; j < distributed_dims.size(); ++j) {
+      const auto& values = free_dim_distributions_.at(distributed_dims[j]);
+      const auto& value = values[rest % values.size()];
+      rest /= values.size();
+      dim_values[distributed_dims[j]] = value.first;
+      weight *= value.second;
     }
+    weights.push_back(weight);
+
+    // iterate over all input nodes
+    for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
+      Ort::TypeInfo type_info = session_.GetInputTypeInfo(i);
+      if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
+        auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+        std::vector<int64_t> input_node_dim = tensor_info.GetShape();
+        std::vector<const char*> dim_names(input_node_dim.size());
+        tensor_info.GetSymbolicDimensions(dim_names.data(), dim_names.size());
+
+        // free dimensions are treated as 1 if not overridden or distributed
+        for (size_t j = 0; j < input_node_dim.size(); ++j) {
+          if (input_node_dim[j] == -1) {
+            auto it = dim_values.find(dim_names[j]);
+            input_node_dim[j] = it != dim_values.end() ? it->second : 1;
+          }
+        }
+
+        auto allocator = Ort::AllocatorWithDefaultOptions();
+        Ort::Value input_tensor = Ort::Value::CreateTensor(allocator, (const int64_t*)input_node_dim.data(),
+                                                           input_node_dim.size(), tensor_info.GetElementType());
+        InitializeTensorWithSeed(seed, input_tensor);
+        PreLoadTestData(test_data_id, i, std::move(input_tensor));
+      }
+    }
+  }
+
+  if (num_test_data > 1) {
+    weighted_dist_ = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    weighted_test_data_ = true;
   }
   return true;
 }
 
+std::string OnnxRuntimeTestSession::GetInputShapes(size_t test_data_id) const {
+  std::ostringstream shapes;
+  const auto& inputs = test_inputs_.at(test_data_id);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (i > 0) {
+      shapes << " ";
+    }
+    shapes << input_names_str_[i] << ":";
+    if (inputs[i] != nullptr && inputs[i].IsTensor()) {
+      const auto dims = inputs[i].GetTensorTypeAndShapeInfo().GetShape();
+      for (size_t j = 0; j < dims.size(); ++j) {
+        shapes << (j > 0 ? "x" : "") << dims[j];
+      }
+    }
+  }
+  return shapes.str();
+}
+
 }  // namespace perftest
 }  // namespace onnxruntime
@@ -3,7 +3,10 @@
 
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
+#include <atomic>
+#include <map>
 #include <random>
+#include <string>
 #include "test_configuration.h"
 #include "test_session.h"
 class TestModelInfo;
@@ -30,6 +33,8 @@ class OnnxRuntimeTestSession : public TestSession {
   ~OnnxRuntimeTestSession() = default;
 
   std::chrono::duration<double> Run() override;
+  std::chrono::duration<double> Run(size_t& test_data_id) override;
+  std::string GetInputShapes(size_t test_data_id) const override;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
@@ -38,6 +43,12 @@ class OnnxRuntimeTestSession : public TestSession {
   std::mt19937 rand_engine_;
   std::uniform_int_distribution<int> dist_;
   std::vector<std::vector<Ort::Value>> test_inputs_;
+  // picks the test data with the weights of RunConfig::free_dim_distributions if there is more than one
+  std::discrete_distribution<size_t> weighted_dist_;
+  bool weighted_test_data_{false};
+  std::map<std::string, std::vector<std::pair<int64_t, double>>> free_dim_distributions_;
+  bool replay_in_order_{false};
+  std::atomic<size_t> next_test_data_id_{0};
   std::vector<std::string> output_names_;
   // The same size with output_names_.
   // TODO: implement a customized allocator, then we can remove output_names_ to simplify this code
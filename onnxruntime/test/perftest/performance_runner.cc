@@ -8,6 +8,9 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -111,11 +114,60 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+static double Percentile(const std::vector<double>& sorted_values, double fraction) {
+  return sorted_values[std::min(sorted_values.size() - 1, static_cast<size_t>(sorted_values.size() * fraction))];
+}
+
+void OpenLoopResult::Print(std::ostream& ostream) const {
+  ostream << "Arrival rate: " << arrival_rate << " requests/s\n"
+          << "Achieved rate: " << achieved_rate << " requests/s\n"
+          << "Completed requests: " << latencies.size() << "\n";
+  if (latencies.empty()) {
+    ostream << std::flush;
+    return;
+  }
+
+  auto output_percentiles = [&ostream](const char* name, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    ostream << name << " P50: " << Percentile(values, 0.5) * 1000 << " ms, "
+            << "P90: " << Percentile(values, 0.9) * 1000 << " ms, "
+            << "P99: " << Percentile(values, 0.99) * 1000 << " ms, "
+            << "P999: " << Percentile(values, 0.999) * 1000 << " ms\n";
+  };
+  output_percentiles("Latency", latencies);
+  output_percentiles("Queueing delay", queueing_delays);
+  output_percentiles("Service time", service_times);
+  ostream << std::flush;
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
 }
 
+void PerformanceRunner::LogLatencyByInputShapes() const {
+  std::map<std::string, std::vector<double>> latencies_by_shapes;
+  for (size_t i = 0; i < performance_result_.time_costs.size(); ++i) {
+    latencies_by_shapes[session_->GetInputShapes(performance_result_.test_data_ids[i])].push_back(
+        performance_result_.time_costs[i]);
+  }
+  if (latencies_by_shapes.size() < 2) {
+    return;
+  }
+
+  std::cout << "\nLatency by input shapes:\n";
+  for (auto& [shapes, latencies] : latencies_by_shapes) {
+    std::sort(latencies.begin(), latencies.end());
+    const double total = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+    std::cout << shapes << ": Runs: " << latencies.size()
+              << ", Average: " << total / latencies.size() * 1000 << " ms"
+              << ", P50: " << Percentile(latencies, 0.5) * 1000 << " ms"
+              << ", P90: " << Percentile(latencies, 0.9) * 1000 << " ms"
+              << ", P99: " << Percentile(latencies, 0.99) * 1000 << " ms\n";
+  }
+  std::cout << std::flush;
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
@@ -138,6 +190,9 @@ Status PerformanceRunner::Run() {
     case TestMode::KFixRepeatedTimesMode:
       ORT_RETURN_IF_ERROR(RepeatedTimesTest());
       break;
+    case TestMode::kOpenLoopMode:
+      ORT_RETURN_IF_ERROR(OpenLoopTest());
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
   }
@@ -165,6 +220,10 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.f_dump_statistics) {
+    LogLatencyByInputShapes();
+  }
+
   return Status::OK();
 }
 
@@ -255,6 +314,142 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop(double arrival_rate, OpenLoopResult& result) {
+  using Clock = std::chrono::high_resolution_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  // the requests arrive at their own pace and wait for one of the concurrent runs, like the requests of a server
+  auto tpool = std::make_unique<DefaultThreadPoolType>(static_cast<int>(run_config.concurrent_session_runs));
+  std::mt19937 rand_engine(run_config.random_seed_for_input_data >= 0 ? run_config.random_seed_for_input_data : 0);
+  std::exponential_distribution<double> interarrival_time(arrival_rate);
+  int pending = 0;
+  Status status;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  result = OpenLoopResult{};
+  result.arrival_rate = arrival_rate;
+
+  const auto start = Clock::now();
+  auto last_end = start;
+  const std::chrono::duration<double> duration(static_cast<double>(run_config.duration_in_seconds));
+  for (std::chrono::duration<double> offset(0); offset < duration;) {
+    const auto arrival = start + std::chrono::duration_cast<Clock::duration>(offset);
+    // a late generator does not delay the arrivals, the next requests are issued right away instead
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lg(m);
+      ++pending;
+    }
+
+    tpool->Schedule([this, arrival, &result, &pending, &status, &last_end, &m, &cv]() {
+      const auto run_start = Clock::now();
+      std::chrono::duration<double> service_time(0);
+      size_t test_data_id = 0;
+      auto run_status = Status::OK();
+      ORT_TRY {
+        service_time = session_->Run(test_data_id);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          run_status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PerformanceRunner::RunOpenLoop caught exception: ", ex.what());
+        });
+      }
+      const auto end = Clock::now();
+
+      std::lock_guard<OrtMutex> lg(m);
+      if (run_status.IsOK()) {
+        result.latencies.push_back(std::chrono::duration<double>(end - arrival).count());
+        result.queueing_delays.push_back(std::chrono::duration<double>(run_start - arrival).count());
+        result.service_times.push_back(service_time.count());
+        result.test_data_ids.push_back(test_data_id);
+        last_end = std::max(last_end, end);
+      } else if (status.IsOK()) {
+        status = run_status;
+      }
+      --pending;
+      cv.notify_all();
+    });
+
+    offset += std::chrono::duration<double>(run_config.poisson_arrivals ? interarrival_time(rand_engine)
+                                                                        : 1.0 / arrival_rate);
+  }
+
+  // Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&pending]() { return pending == 0; });
+
+  std::chrono::duration<double> elapsed = last_end - start;
+  if (elapsed.count() > 0) {
+    result.achieved_rate = result.latencies.size() / elapsed.count();
+  }
+  return status;
+}
+
+Status PerformanceRunner::OpenLoopTest() {
+  const auto& run_config = performance_test_config_.run_config;
+  OpenLoopResult result;
+
+  if (run_config.latency_slo_ms <= 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop(run_config.arrival_rate, result));
+    result.Print(std::cout);
+  } else {
+    // double the arrival rate until the P99 latency misses the SLO, then bisect between the last two rates
+    auto meets_slo = [&run_config](const OpenLoopResult& trial) {
+      if (trial.latencies.empty()) {
+        return false;
+      }
+      std::vector<double> sorted_latencies = trial.latencies;
+      std::sort(sorted_latencies.begin(), sorted_latencies.end());
+      return Percentile(sorted_latencies, 0.99) * 1000 <= run_config.latency_slo_ms;
+    };
+
+    double rate = run_config.arrival_rate;
+    if (rate <= 0) {
+      // start from the rate the concurrent runs sustain with the latency of the warm up run
+      std::chrono::duration<double> first_inference = initial_inference_result_.end - initial_inference_result_.start;
+      rate = run_config.concurrent_session_runs / std::max(first_inference.count(), 1e-6);
+    }
+
+    constexpr int kMaxDoublings = 20;
+    constexpr int kBisections = 6;
+    double passing_rate = 0;
+    double failing_rate = 0;
+    int trial_count = 0;
+    OpenLoopResult passing_result;
+    auto run_trial = [&](double trial_rate) -> Status {
+      ORT_RETURN_IF_ERROR(RunOpenLoop(trial_rate, result));
+      std::cout << "\nSweep trial " << trial_count++ << ":\n";
+      result.Print(std::cout);
+      if (meets_slo(result)) {
+        passing_rate = trial_rate;
+        passing_result = result;
+      } else {
+        failing_rate = trial_rate;
+      }
+      return Status::OK();
+    };
+
+    for (int i = 0; i < kMaxDoublings && failing_rate == 0; ++i, rate *= 2) {
+      ORT_RETURN_IF_ERROR(run_trial(rate));
+    }
+    for (int i = 0; i < kBisections && failing_rate > 0; ++i) {
+      ORT_RETURN_IF_ERROR(run_trial((passing_rate + failing_rate) / 2));
+    }
+
+    std::cout << "\nMax arrival rate under the P99 latency SLO of " << run_config.latency_slo_ms << " ms: "
+              << passing_rate << " requests/s" << std::endl;
+    if (passing_rate > 0) {
+      result = std::move(passing_result);
+    }
+  }
+
+  performance_result_.time_costs = result.latencies;
+  performance_result_.test_data_ids = result.test_data_ids;
+  performance_result_.total_time_cost = std::accumulate(result.latencies.begin(), result.latencies.end(), 0.0);
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
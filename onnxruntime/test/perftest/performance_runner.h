@@ -34,11 +34,26 @@ struct PerformanceResult {
   short average_CPU_usage{0};
   double total_time_cost{0};
   std::vector<double> time_costs;
+  // the test data of each of time_costs
+  std::vector<size_t> test_data_ids;
   std::string model_name;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
 };
 
+struct OpenLoopResult {
+  double arrival_rate{0};
+  double achieved_rate{0};
+  // in seconds, from the arrival of each request to its end
+  std::vector<double> latencies;
+  // in seconds, from the arrival of each request to the start of its run
+  std::vector<double> queueing_delays;
+  std::vector<double> service_times;
+  std::vector<size_t> test_data_ids;
+
+  void Print(std::ostream& ostream) const;
+};
+
 class PerformanceRunner {
  public:
   PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
@@ -48,6 +63,9 @@ class PerformanceRunner {
 
   void LogSessionCreationTime();
 
+  // Latency statistics of the runs of each set of input shapes, if the test data have different shapes.
+  void LogLatencyByInputShapes() const;
+
   inline const PerformanceResult& GetResult() const { return performance_result_; }
 
   inline void SerializeResult() const {
@@ -62,10 +80,11 @@ class PerformanceRunner {
   template <bool isWarmup>
   Status RunOneIteration() {
     std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
+    size_t test_data_id = 0;
 
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      duration_seconds = session_->Run(test_data_id);
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -77,6 +96,7 @@ class PerformanceRunner {
     if (!isWarmup) {
       std::lock_guard<OrtMutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
+      performance_result_.test_data_ids.emplace_back(test_data_id);
       performance_result_.total_time_cost += duration_seconds.count();
       if (performance_test_config_.run_config.f_verbose) {
         std::cout << "iteration:" << performance_result_.time_costs.size() << ","
@@ -90,6 +110,8 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status OpenLoopTest();
+  Status RunOpenLoop(double arrival_rate, OpenLoopResult& result);
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
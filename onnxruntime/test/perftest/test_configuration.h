@@ -16,7 +16,8 @@ namespace perftest {
 
 enum class TestMode : std::uint8_t {
   kFixDurationMode = 0,
-  KFixRepeatedTimesMode
+  KFixRepeatedTimesMode,
+  kOpenLoopMode
 };
 
 enum class Platform : std::uint8_t {
@@ -43,6 +44,11 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // requests per second issued by the open loop mode, whatever the state of the previous requests
+  double arrival_rate{0};
+  bool poisson_arrivals{true};
+  // P99 latency in milliseconds up to which the open loop mode searches for the max arrival rate
+  double latency_slo_ms{0};
   bool f_dump_statistics{false};
   int random_seed_for_input_data{-1};
   bool f_verbose{false};
@@ -61,6 +67,11 @@ struct RunConfig {
   std::unordered_map<std::string, std::string> session_config_entries;
   std::map<std::basic_string<ORTCHAR_T>, int64_t> free_dim_name_overrides;
   std::map<std::basic_string<ORTCHAR_T>, int64_t> free_dim_denotation_overrides;
+  // values of free dimensions, by name, with their weights. the generated inputs get one test data per combination
+  // of values, which runs pick with the product of the weights of its values.
+  std::map<std::string, std::vector<std::pair<int64_t, double>>> free_dim_distributions;
+  // run the test data in the order of their ids, e.g. to replay recorded inputs, instead of at random
+  bool replay_test_data_in_order{false};
   std::string intra_op_thread_affinities;
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
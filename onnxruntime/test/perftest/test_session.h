@@ -3,6 +3,7 @@
 
 #pragma once
 #include <stdlib.h>
+#include <string>
 
 #include "OrtValueList.h"
 
@@ -11,6 +12,10 @@ namespace perftest {
 class TestSession {
  public:
   virtual std::chrono::duration<double> Run() = 0;
+  // Same as Run, and sets the id of the test data that was run.
+  virtual std::chrono::duration<double> Run(size_t& test_data_id) = 0;
+  // The shapes of the inputs of a test data, to break the latencies down by shape.
+  virtual std::string GetInputShapes(size_t test_data_id) const = 0;
   // TODO: implement it
   // This function won't return duration, because it may vary largely.
   // Please measure the perf at a higher level.
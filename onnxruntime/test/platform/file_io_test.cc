@@ -117,6 +117,46 @@ TEST(FileIoTest, ReadFileIntoBuffer) {
   ASSERT_FALSE(Env::Default().ReadFileIntoBuffer(tmp.path.c_str(), 0, 3, gsl::make_span(buffer.data(), 2)).IsOK());
 }
 
+TEST(FileIoTest, ReadFileRegionsIntoBuffers) {
+  TempFilePath tmp(ORT_TSTR("read_regions_test_"));
+  const auto expected_data = GenerateData(32);
+  WriteDataToFile(gsl::make_span(expected_data), tmp.path);
+
+  const auto offsets_and_lengths = GenerateValidOffsetLengthPairs(0, expected_data.size());
+
+  std::vector<std::vector<char>> buffers;
+  std::vector<Env::FileRegionRead> reads;
+  for (const auto& offset_and_length : offsets_and_lengths) {
+    buffers.emplace_back(offset_and_length.second);
+  }
+  for (size_t i = 0; i < offsets_and_lengths.size(); ++i) {
+    reads.push_back({offsets_and_lengths[i].first, offsets_and_lengths[i].second, gsl::make_span(buffers[i])});
+  }
+
+  auto status = Env::Default().ReadFileRegionsIntoBuffers(tmp.path.c_str(), reads);
+  ASSERT_TRUE(status.IsOK()) << "ReadFileRegionsIntoBuffers failed with error: " << status.ErrorMessage();
+
+  for (const auto& read : reads) {
+    auto expected_data_span = gsl::make_span(expected_data.data() + read.offset, read.length);
+    ASSERT_TRUE(SpanEq(read.buffer.first(read.length), expected_data_span))
+        << "Unexpected data for offset " << read.offset << " and length " << read.length;
+  }
+
+  std::vector<char> buffer(expected_data.size() + 1);
+
+  // invalid - negative offset
+  const Env::FileRegionRead negative_offset[] = {{-1, 0, gsl::make_span(buffer)}};
+  ASSERT_FALSE(Env::Default().ReadFileRegionsIntoBuffers(tmp.path.c_str(), negative_offset).IsOK());
+
+  // invalid - length too long
+  const Env::FileRegionRead too_long[] = {{0, 1, gsl::make_span(buffer)}, {0, buffer.size(), gsl::make_span(buffer)}};
+  ASSERT_FALSE(Env::Default().ReadFileRegionsIntoBuffers(tmp.path.c_str(), too_long).IsOK());
+
+  // invalid - buffer too short
+  const Env::FileRegionRead too_short[] = {{0, 3, gsl::make_span(buffer.data(), 2)}};
+  ASSERT_FALSE(Env::Default().ReadFileRegionsIntoBuffers(tmp.path.c_str(), too_short).IsOK());
+}
+
 #ifndef _WIN32  // not implemented on Windows
 TEST(FileIoTest, MapFileIntoMemory) {
   static const auto page_size = sysconf(_SC_PAGESIZE);
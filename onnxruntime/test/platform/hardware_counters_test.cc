@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/hardware_counters.h"
+
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(HardwareCountersTest, CountsTheWorkOfAllThreads) {
+  std::atomic<bool> started{false};
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> sum{0};
+  // a thread that exists when the counters are created is counted
+  std::thread worker([&]() {
+    started = true;
+    while (!stop) {
+      std::this_thread::yield();
+    }
+    volatile uint64_t local_sum = 0;
+    for (uint64_t i = 0; i < 10 * 1000 * 1000; ++i) {
+      local_sum = local_sum + i * i;
+    }
+    sum = local_sum;
+  });
+  while (!started) {
+    std::this_thread::yield();
+  }
+
+  std::unique_ptr<HardwareCounters> counters;
+  const auto status = HardwareCounters::Create(0, counters);
+  if (!status.IsOK()) {
+    stop = true;
+    worker.join();
+    GTEST_SKIP() << status.ErrorMessage();
+  }
+
+  ASSERT_TRUE(counters->IsAvailable(HardwareCounters::kCycles));
+  EXPECT_FALSE(counters->IsAvailable(HardwareCounters::kFpOps));
+
+  const auto begin = counters->Read();
+  stop = true;
+  worker.join();
+  const auto end = counters->Read();
+
+  EXPECT_NE(sum.load(), 0u);
+  EXPECT_GT(end[HardwareCounters::kCycles], begin[HardwareCounters::kCycles]);
+  if (counters->IsAvailable(HardwareCounters::kInstructions)) {
+    // the loop of the worker alone retires more instructions than that
+    EXPECT_GT(end[HardwareCounters::kInstructions] - begin[HardwareCounters::kInstructions], uint64_t{10 * 1000 * 1000});
+  }
+
+  const std::string json = counters->ToJson(begin, end);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_NE(json.find("\"cycles\":"), std::string::npos);
+  EXPECT_EQ(json.find("fp_ops"), std::string::npos);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
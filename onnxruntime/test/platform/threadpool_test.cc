@@ -12,8 +12,12 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -229,6 +233,26 @@ void TestStagedMultiLoopSections(const std::string& name, int num_threads, int n
   }
 }
 
+// Test loops sized from measured costs, with a cost estimate that is far too low or far too high. Every loop runs
+// repeatedly, so later runs use the cost measured in the earlier ones.
+void TestAdaptiveParallelFor(int num_threads, int num_tasks, double cost_per_unit, int dynamic_block_base = 0) {
+  constexpr int num_loops = 10;
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_block_sizing_ = true;
+  thread_options.dynamic_block_base_ = dynamic_block_base;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads, true);
+
+  auto test_data = CreateTestData(num_tasks);
+  for (int l = 0; l < num_loops; l++) {
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, cost_per_unit, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        IncrementElement(*test_data, i);
+      }
+    });
+  }
+  ValidateTestData(*test_data, num_loops);
+}
+
 }  // namespace
 
 namespace onnxruntime {
@@ -416,6 +440,14 @@ TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_blo
   TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_block_base_128", 4, 4, 1000000, 128, true);
 }
 
+TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_8Tasks_hybrid) {
+  TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_8Tasks_hybrid", 4, 4, 8, 0, true);
+}
+
+TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_1MTasks_hybrid) {
+  TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_1MTasks_hybrid", 4, 4, 1000000, 0, true);
+}
+
 TEST(ThreadPoolTest, TestBurstScheduling_0Tasks) {
   TestBurstScheduling("TestBurstScheduling_0Tasks", 0);
 }
@@ -510,6 +542,107 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_0Tasks) {
+  TestAdaptiveParallelFor(4, 0, 1.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_1Task) {
+  TestAdaptiveParallelFor(4, 1, 1.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_100KTasks_Underestimated) {
+  TestAdaptiveParallelFor(4, 100000, 0.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_100KTasks_Overestimated) {
+  TestAdaptiveParallelFor(4, 100000, 1e6);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_100KTasks_dynamic_block_base_4) {
+  TestAdaptiveParallelFor(4, 100000, 1e6, 4);
+}
+
+TEST(ThreadPoolTest, TestScopedMaxDegreeOfParallelism) {
+  CreateThreadPoolAndTest("TestScopedMaxDegreeOfParallelism", 4, [](ThreadPool* tp) {
+    const int pool_degree_of_parallelism = ThreadPool::DegreeOfParallelism(tp);
+    ThreadPool::ScopedMaxDegreeOfParallelism scope(2);
+    EXPECT_EQ(ThreadPool::DegreeOfParallelism(tp), pool_degree_of_parallelism / 2);
+    {
+      // a scope without a limit keeps the current one
+      ThreadPool::ScopedMaxDegreeOfParallelism inner_scope(0);
+      EXPECT_EQ(ThreadPool::DegreeOfParallelism(tp), pool_degree_of_parallelism / 2);
+    }
+
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+    ThreadPool::TrySimpleParallelFor(tp, 1000, [&](std::ptrdiff_t) {
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+      std::lock_guard<std::mutex> lock(mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    });
+    EXPECT_LE(thread_ids.size(), 2u);
+  });
+}
+
+TEST(ThreadPoolTest, TestNestedParallelSections) {
+  constexpr int num_tasks = 1024;
+  auto test_data = CreateTestData(num_tasks);
+  auto increment = [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); };
+  CreateThreadPoolAndTest("TestNestedParallelSections", 4, [&](ThreadPool* tp) {
+    ThreadPool::ParallelSection ps(tp);
+    ThreadPool::TrySimpleParallelFor(tp, num_tasks, increment);
+    {
+      // the inner section runs its loops in the outer one, which stays open after it
+      ThreadPool::ParallelSection inner_ps(tp);
+      ThreadPool::TrySimpleParallelFor(tp, num_tasks, increment);
+    }
+    ThreadPool::TrySimpleParallelFor(tp, num_tasks, increment);
+
+    // the loops of another pool run outside of the section
+    CreateThreadPoolAndTest("TestNestedParallelSections_other", 2, [&](ThreadPool* other_tp) {
+      ThreadPool::ParallelSection other_ps(other_tp);
+      ThreadPool::TrySimpleParallelFor(other_tp, num_tasks, increment);
+    });
+  });
+  ValidateTestData(*test_data, 4);
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(ThreadPoolTest, TestProfilingStats) {
+  CreateThreadPoolAndTest("TestProfilingStats", 4, [](ThreadPool* tp) {
+    EXPECT_TRUE(ThreadPool::GetProfilingStats(tp).empty());
+    ThreadPool::StartProfiling(tp);
+
+    constexpr int num_tasks = 1000;
+    auto test_data = CreateTestData(num_tasks);
+    for (int i = 0; i < 3; ++i) {
+      ThreadPool::TrySimpleParallelFor(tp, num_tasks, [&](std::ptrdiff_t idx) { IncrementElement(*test_data, idx); });
+    }
+    ValidateTestData(*test_data, 3);
+
+    std::atomic<int> num_scheduled{0};
+    for (int i = 0; i < 10; ++i) {
+      ThreadPool::Schedule(tp, [&]() { num_scheduled++; });
+    }
+    while (num_scheduled < 10) {
+      std::this_thread::yield();
+    }
+
+    // the main thread statistics of the trace are reset, the statistics of the pool are not
+    const std::string trace_stats = ThreadPool::StopProfiling(tp);
+    EXPECT_NE(trace_stats.find("\"imbalance\": ["), std::string::npos);
+    EXPECT_NE(trace_stats.find("\"spin_us\": "), std::string::npos);
+    EXPECT_NE(trace_stats.find("\"schedule\": {\"num_tasks\": 10, "), std::string::npos);
+
+    const std::string stats = ThreadPool::GetProfilingStats(tp);
+    EXPECT_NE(stats.find("\"num_loops\": 3, "), std::string::npos) << stats;
+    EXPECT_NE(stats.find("\"num_steals\": "), std::string::npos) << stats;
+    EXPECT_NE(stats.find("\"work_us\": "), std::string::npos) << stats;
+    EXPECT_NE(stats.find("\"blocked_us\": "), std::string::npos) << stats;
+  });
+}
+#endif
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
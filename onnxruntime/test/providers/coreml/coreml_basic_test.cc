@@ -132,6 +132,35 @@ TEST(CoreMLExecutionProviderTest, ArgMaxCastTest) {
 #endif
 }
 
+// The second session loads the compiled model from the model cache
+TEST(CoreMLExecutionProviderTest, ModelCacheTest) {
+  const ORTCHAR_T* model_file_name = ORT_TSTR("testdata/coreml_argmax_cast_test.onnx");
+  constexpr uint32_t coreml_flags = s_coreml_flags | COREML_FLAG_ENABLE_MODEL_CACHE;
+
+#if defined(__APPLE__)
+  std::vector<int64_t> dims_mul_x = {3, 2, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+  OrtValue ml_value_x;
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &ml_value_x);
+
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value_x));
+
+  EPVerificationParams verification_params{};
+  verification_params.ep_node_assignment = ExpectedEPNodeAssignment::All;
+
+  for (int i = 0; i < 2; ++i) {
+    RunAndVerifyOutputsWithEP(model_file_name, CurrentTestName(),
+                              MakeCoreMLExecutionProvider(coreml_flags),
+                              feeds,
+                              verification_params);
+  }
+#else
+  TestModelLoad(model_file_name, MakeCoreMLExecutionProvider(coreml_flags), ExpectedEPNodeAssignment::All);
+#endif
+}
+
 TEST(CoreMLExecutionProviderTest, ArgMaxUnsupportedCastTest) {
   const ORTCHAR_T* model_file_name = ORT_TSTR("testdata/coreml_argmax_unsupported_cast_test.onnx");
 
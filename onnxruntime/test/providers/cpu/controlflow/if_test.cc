@@ -8,7 +8,9 @@
 #include "core/providers/cpu/controlflow/if.h"
 #include "test/providers/provider_test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
+#include "test/util/include/asserts.h"
 #include "test/util/include/default_providers.h"
 
 using namespace ONNX_NAMESPACE;
@@ -418,6 +420,23 @@ TEST(If, ConditionalBranchesOnlyContainConstantNodes_ElseBranchExecution) {
   test.Run();
 }
 
+// The branches are initialized on their first execution, or in the background after session initialization
+TEST(If, LazySubgraphInitialization) {
+  for (bool warm_up : {false, true}) {
+    for (bool condition : {true, false}) {
+      SessionOptions so;
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLazySubgraphInitialization, "1"));
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLazySubgraphWarmUp,
+                                                        warm_up ? "1" : "0"));
+
+      IfOpTesterOnlyConstantNodesInConditionalBranches test;
+      test.AddInput<bool>("If_input", {1}, {condition});
+      test.AddOutput<float>("If_output", {1}, {condition ? 10.f : 1000.f});
+      test.Config(so).RunWithConfig();
+    }
+  }
+}
+
 // This is to test an "If" node with just a "SequenceEmpty" node in the "then" and "else" conditional branches
 class IfOpTesterWithSequencesAsOutput : public OpTester {
  public:
@@ -1042,6 +1042,114 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// Creates a Loop body that passes 'cond' through, so the Loop has a fixed trip count and writes its scan output to
+// slices of the Loop output.
+//
+//   iter_num_in    cond_in                      state_in
+//    (unused)         |                             |
+//               [Identity] (optional)    [Add] or [Concat] (state_in, state_in)
+//                     |                             |
+//                  cond_out                     state_out
+//
+// The scan output is state_in as is, or an Identity of state_out.
+static GraphProto CreateFixedTripCountBody(bool cond_through_identity, bool scan_output_is_state_in,
+                                           bool concat_state) {
+  Model model("fixed trip count subgraph", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  // the state may grow in each iteration
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+
+  auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+  auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+  auto& state_in = graph.GetOrCreateNodeArg("state_in", &float_tensor);
+  auto& state_out = graph.GetOrCreateNodeArg("state_out", &float_tensor);
+
+  NodeArg* cond_out = &cond_in;
+  if (cond_through_identity) {
+    cond_out = &graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {cond_out});
+  }
+
+  if (concat_state) {
+    auto& concat = graph.AddNode("concat", "Concat", "Concat state_in with itself", {&state_in, &state_in},
+                                 {&state_out});
+    concat.AddAttribute("axis", int64_t{0});
+  } else {
+    graph.AddNode("add", "Add", "Add state_in to itself", {&state_in, &state_in}, {&state_out});
+  }
+
+  NodeArg* scan_out = &state_in;
+  if (!scan_output_is_state_in) {
+    scan_out = &graph.GetOrCreateNodeArg("scan_out", &float_tensor);
+    graph.AddNode("scan_out_identity", "Identity", "Forward state_out to scan_out", {&state_out}, {scan_out});
+  }
+
+  graph.SetInputs({&iter_num_in, &cond_in, &state_in});
+  graph.SetOutputs({cond_out, &state_out, scan_out});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+static void RunFixedTripCountLoop(const GraphProto& body, int64_t trip_count,
+                                  const std::vector<int64_t>& state_final_dims, const std::vector<float>& state_final,
+                                  const std::vector<int64_t>& scan_out_dims, const std::vector<float>& scan_out,
+                                  OpTester::ExpectResult expect_result = OpTester::ExpectResult::kExpectSuccess,
+                                  const std::string& failure_message = "") {
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {trip_count});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("state_initial", {1}, {1.0f});
+
+  test.AddOutput<float>("state_final", state_final_dims, state_final);
+  test.AddOutput<float>("scan_out_final", scan_out_dims, scan_out);
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(expect_result, failure_message, {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+// the scan output is a subgraph input, which is copied to its slice of the Loop output
+TEST(Loop, FixedTripCountForwardedInputAsScanOutput) {
+  RunFixedTripCountLoop(CreateFixedTripCountBody(false, true, false), 3,
+                        {1}, {8.0f}, {3, 1}, {1.0f, 2.0f, 4.0f});
+}
+
+TEST(Loop, FixedTripCountConditionThroughIdentity) {
+  RunFixedTripCountLoop(CreateFixedTripCountBody(true, false, false), 3,
+                        {1}, {8.0f}, {3, 1}, {2.0f, 4.0f, 8.0f});
+}
+
+TEST(Loop, FixedTripCountSingleIteration) {
+  RunFixedTripCountLoop(CreateFixedTripCountBody(true, false, false), 1,
+                        {1}, {2.0f}, {1, 1}, {2.0f});
+  RunFixedTripCountLoop(CreateFixedTripCountBody(false, true, false), 1,
+                        {1}, {2.0f}, {1, 1}, {1.0f});
+}
+
+// the scan outputs of all iterations must have the same shape, whether they are written in place or copied
+TEST(Loop, FixedTripCountInconsistentScanOutputShape) {
+  RunFixedTripCountLoop(CreateFixedTripCountBody(true, false, true), 2,
+                        {4}, {1.0f, 1.0f, 1.0f, 1.0f}, {2, 2}, {1.0f, 1.0f, 1.0f, 1.0f},
+                        OpTester::ExpectResult::kExpectFailure, "Inconsistent shape in loop output");
+  RunFixedTripCountLoop(CreateFixedTripCountBody(false, true, true), 2,
+                        {4}, {1.0f, 1.0f, 1.0f, 1.0f}, {2, 1}, {1.0f, 1.0f},
+                        OpTester::ExpectResult::kExpectFailure, "Inconsistent shape in loop output");
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -6,6 +6,10 @@
 
 #include <algorithm>
 #include <random>
+
+#include "core/platform/env.h"
+#include "core/providers/cpu/generator/philox.h"
+#include "core/util/thread_utils.h"
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
@@ -25,16 +29,13 @@ TEST(Random, RandomNormal2DDouble) {
   test.AddAttribute<int64_t>("dtype", TensorProto::DOUBLE);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<double> distribution{mean, scale};
-
   std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  philox::FillNormal<double>({static_cast<uint64_t>(seed), 0}, mean, scale, gsl::make_span(expected_output), nullptr);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
-  // The expected_output is generated using std lib, which is used by CPU kernel only.
+  // The expected_output is generated with the Philox generator of the CPU kernel, which draws differently from the
+  // CUDA one.
   // So we need to exclude other EPs here. Ditto for other places.
   test.Run(OpTester::ExpectResult::kExpectSuccess, "",
            {kCudaExecutionProvider, kCudaNHWCExecutionProvider, kRocmExecutionProvider});
@@ -63,12 +64,8 @@ void RunRandomNormalLike3DFloat(bool infer_dtype = false) {
                         0.f, 0.f, 0.f,
                         0.f, 0.f, 0.f});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<float> distribution{mean, scale};
-
   std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  philox::FillNormal<float>({static_cast<uint64_t>(seed), 0}, mean, scale, gsl::make_span(expected_output), nullptr);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -101,12 +98,8 @@ TEST(Random, RandomUniform1DFloat) {
   test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<float> distribution{low, high};
-
   std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  philox::FillUniform<float>({static_cast<uint64_t>(seed), 0}, low, high, gsl::make_span(expected_output), nullptr);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -135,12 +128,8 @@ void RunRandomUniformLikeTest(bool infer_dtype = false) {
                         {0., 0., 0., 0., 0., 0.,
                          0., 0., 0., 0., 0., 0.});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<double> distribution{low, high};
-
   std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  philox::FillUniform<double>({static_cast<uint64_t>(seed), 0}, low, high, gsl::make_span(expected_output), nullptr);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
@@ -230,6 +219,43 @@ TEST(Random, InvalidDType) {
   }
 }
 
+// The known answers of Philox4x32-10 from the Random123 library.
+TEST(Random, PhiloxKnownAnswers) {
+  EXPECT_EQ(philox::ComputeBlock({0, 0, 0, 0}, 0),
+            (philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  EXPECT_EQ(philox::ComputeBlock({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, 0xffffffffffffffff),
+            (philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  EXPECT_EQ(philox::ComputeBlock({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0x299f31d0a4093822),
+            (philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(Random, PhiloxFillDoesNotDependOnThreadCount) {
+  // not a multiple of the values of a group of blocks, so that the last group is partial
+  constexpr size_t size = 100003;
+  const std::pair<uint64_t, uint64_t> seeds{17, 3};
+
+  std::vector<float> expected(size);
+  philox::FillNormal<float>(seeds, 1.f, 2.f, gsl::make_span(expected), nullptr);
+
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+  std::vector<float> actual(size);
+  philox::FillNormal<float>(seeds, 1.f, 2.f, gsl::make_span(actual), thread_pool.get());
+  EXPECT_EQ(actual, expected);
+
+  // a prefix of the values doesn't depend on how many values are generated
+  std::vector<float> prefix(size / 2);
+  philox::FillNormal<float>(seeds, 1.f, 2.f, gsl::make_span(prefix), thread_pool.get());
+  EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), expected.begin()));
+
+  // the next stream of the generator is a different one
+  std::vector<float> next(size);
+  philox::FillNormal<float>({seeds.first, seeds.second + 1}, 1.f, 2.f, gsl::make_span(next), thread_pool.get());
+  EXPECT_NE(next, expected);
+}
+
 /*
 Note: There are no reference tests that can be reused in this case. I tried to use the tensorflow
 test cases but they use a different RNG (Philox) and hence the test results differ. Since the implementation
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
@@ -247,5 +249,28 @@ TEST(CumSumTest, _1DTestdouble_WithInt64Axis) {
   test.AddOutput<double>("y", {5}, {1., 3., 6., 10., 15.});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+// A row long enough to be scanned in blocks by several threads.
+TEST(CumSumTest, _2DTestLongAxisReverseExclusive) {
+  constexpr int64_t rows = 2;
+  constexpr int64_t dim = 100003;
+  std::vector<int64_t> input(rows * dim);
+  std::vector<int64_t> expected(rows * dim);
+  for (int64_t row = 0; row < rows; ++row) {
+    int64_t sum = 0;
+    for (int64_t i = dim - 1; i >= 0; --i) {
+      input[row * dim + i] = (i % 7) - 3 + row;
+      expected[row * dim + i] = sum;
+      sum += input[row * dim + i];
+    }
+  }
+
+  OpTester test("CumSum", 14, onnxruntime::kOnnxDomain);
+  test.AddAttribute<int64_t>("exclusive", 1);
+  test.AddAttribute<int64_t>("reverse", 1);
+  test.AddInput<int64_t>("x", {rows, dim}, input);
+  test.AddInput<int32_t>("axis", {}, {1});
+  test.AddOutput<int64_t>("y", {rows, dim}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include "test/common/trt_op_test_utils.h"
 #include "core/framework/data_types.h"
 #include "core/util/math.h"
+#include "core/providers/cpu/math/einsum_utils/einsum_contraction_path.h"
 
 namespace onnxruntime {
 namespace test {
@@ -237,6 +238,48 @@ TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
 }
 
+// The contraction of the last two operands comes first, as it is cheaper
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("y", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("z", {2}, {1.f, 2.f});
+  test.AddOutput<float>("o", {2}, {27.f, 59.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
+// More operands than the exhaustive search of the contraction order takes
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Greedy) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,cd,de,ef,f->a");
+  for (const char* name : {"u", "v", "w", "x", "y"}) {
+    test.AddInput<float>(name, {2, 2}, {1.f, 1.f, 1.f, 1.f});
+  }
+  test.AddInput<float>("z", {2}, {1.f, 1.f});
+  test.AddOutput<float>("o", {2}, {32.f, 32.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
+TEST(Einsum, ContractionPath) {
+  // ij,jk,k->i: jk,k first, then with ij
+  const std::vector<std::vector<bool>> operand_labels{{true, true, false}, {false, true, true}, {false, false, true}};
+  const std::vector<bool> output_labels{true, false, false};
+  std::vector<int64_t> label_dims{100, 100, 100};
+  EXPECT_EQ(EinsumOp::ComputeContractionPath(operand_labels, label_dims, output_labels),
+            (EinsumOp::ContractionPath{{1, 2}, {0, 1}}));
+
+  // ij,jk,k->i with a small i and k: left to right is cheaper
+  label_dims = {1, 10000, 100};
+  EXPECT_EQ(EinsumOp::ComputeContractionPath(operand_labels, label_dims, output_labels),
+            (EinsumOp::ContractionPath{{0, 1}, {0, 1}}));
+
+  // ties keep the left to right order
+  EXPECT_EQ(EinsumOp::ComputeContractionPath({{true, true}, {true, true}, {true, true}}, std::vector<int64_t>{4, 4},
+                                             {true, true}),
+            (EinsumOp::ContractionPath{{0, 1}, {0, 1}}));
+}
+
 TEST(Einsum, ExplicitEinsumAsBatchedMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "bij,bjk->bik");
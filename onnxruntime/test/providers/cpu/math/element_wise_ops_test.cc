@@ -9,8 +9,10 @@
 #include "test/common/trt_op_test_utils.h"
 #include "core/util/math.h"
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <math.h>
+#include <tuple>
 
 namespace onnxruntime {
 namespace test {
@@ -631,6 +633,56 @@ TEST(MathOpTest, Div) {
 #endif
 }
 
+// Broadcasts where neither input is a scalar within the innermost span, so the runs are folded and computed in MLAS.
+TEST(MathOpTest, BinaryOps_Broadcast_Folded) {
+  auto run = [](const char* op, const std::function<float(float, float)>& fn,
+                const std::vector<int64_t>& a_dims, const std::vector<int64_t>& b_dims,
+                const std::vector<int64_t>& c_dims) {
+    const auto size = [](const std::vector<int64_t>& dims) {
+      return static_cast<size_t>(TensorShape(dims).Size());
+    };
+    std::vector<float> a(size(a_dims));
+    std::vector<float> b(size(b_dims));
+    for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<float>(i % 17) + 1.0f;
+    for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<float>(i % 13) * 0.5f + 1.0f;
+
+    // a_dims and b_dims have the same rank as c_dims
+    const size_t rank = c_dims.size();
+    std::vector<float> c(size(c_dims));
+    for (size_t i = 0; i < c.size(); ++i) {
+      size_t remaining = i, a_index = 0, b_index = 0, a_stride = 1, b_stride = 1;
+      for (size_t d = rank; d-- > 0;) {
+        const size_t index = remaining % static_cast<size_t>(c_dims[d]);
+        remaining /= static_cast<size_t>(c_dims[d]);
+        a_index += (a_dims[d] == 1 ? 0 : index) * a_stride;
+        b_index += (b_dims[d] == 1 ? 0 : index) * b_stride;
+        a_stride *= static_cast<size_t>(a_dims[d]);
+        b_stride *= static_cast<size_t>(b_dims[d]);
+      }
+      c[i] = fn(a[a_index], b[b_index]);
+    }
+
+    OpTester test(op);
+    test.AddInput<float>("A", a_dims, a);
+    test.AddInput<float>("B", b_dims, b);
+    test.AddOutput<float>("C", c_dims, c);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  };
+
+  const std::vector<std::tuple<const char*, std::function<float(float, float)>>> ops{
+      {"Add", std::plus<float>()},
+      {"Sub", std::minus<float>()},
+      {"Mul", std::multiplies<float>()},
+      {"Div", std::divides<float>()}};
+
+  for (const auto& [op, fn] : ops) {
+    run(op, fn, {2, 1, 3, 1}, {1, 4, 1, 5}, {2, 4, 3, 5});
+    run(op, fn, {1, 4, 1, 21}, {2, 1, 3, 21}, {2, 4, 3, 21});
+    run(op, fn, {6, 7}, {1, 7}, {6, 7});
+    run(op, fn, {3, 1, 1}, {3, 2, 20000}, {3, 2, 20000});
+  }
+}
+
 TEST(MathOpTest, Abs) {
   OpTester test("Abs");
   std::vector<int64_t> dims{2, 2};
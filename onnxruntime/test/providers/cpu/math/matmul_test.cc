@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
@@ -396,6 +397,89 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+// B is a pre-packed initializer so the kernel generated for its shape is used when the platform supports it.
+TEST(MathOpTest, MatMulFloatSgemmJit) {
+  constexpr int64_t batch = 2, M = 7, K = 37, N = 19;
+
+  std::vector<float> a_values(batch * M * K);
+  std::vector<float> b_values(K * N);
+  for (size_t i = 0; i < a_values.size(); i++) {
+    a_values[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.25f;
+  }
+  for (size_t i = 0; i < b_values.size(); i++) {
+    b_values[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.5f;
+  }
+
+  std::vector<float> y_values(batch * M * N);
+  for (int64_t m = 0; m < batch * M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a_values[m * K + k] * b_values[k * N + n];
+      }
+      y_values[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {batch, M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {batch, M, N}, y_values);
+
+  SessionOptions so;
+  ASSERT_EQ(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasSgemmJit, "1"), Status::OK());
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
+// B is a pre-packed initializer with most of its rows zero, so it is multiplied with the block sparse kernel.
+TEST(MathOpTest, MatMulFloatSparseSgemm) {
+  constexpr int64_t batch = 2, M = 5, K = 40, N = 35;
+
+  std::vector<float> a_values(batch * M * K);
+  std::vector<float> b_values(K * N, 0.0f);
+  for (size_t i = 0; i < a_values.size(); i++) {
+    a_values[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.25f;
+  }
+  // every fourth row of B is non-zero, except in the last column block
+  for (int64_t k = 0; k < K; k++) {
+    for (int64_t n = 0; n < N; n++) {
+      if (k % 4 == 0 || n >= 32) {
+        b_values[k * N + n] = static_cast<float>(static_cast<int>((k * N + n) % 7) - 3) * 0.5f;
+      }
+    }
+  }
+
+  std::vector<float> y_values(batch * M * N);
+  for (int64_t m = 0; m < batch * M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a_values[m * K + k] * b_values[k * N + n];
+      }
+      y_values[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {batch, M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {batch, M, N}, y_values);
+
+  SessionOptions so;
+  ASSERT_EQ(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasSparseSgemmMinSparsity, "0.4"), Status::OK());
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 #endif
 
 }  // namespace test
@@ -49,7 +49,6 @@ TEST(SoftmaxOperator, Simple) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
-#if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(SoftmaxOperator, Simple_fp16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -76,7 +75,34 @@ TEST(SoftmaxOperator, Simple_fp16) {
   test.AddOutput<MLFloat16>("Y", dimensions, f_Y);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
-#endif
+
+TEST(SoftmaxOperator, LogSoftmax_fp16) {
+  OpTester test("LogSoftmax", 13);
+
+  std::vector<float> X = {-1.0f, 0.0f, 1.0f, 2.0f, -3.0f, 0.5f};
+  std::vector<float> Y(X.size());
+  for (size_t r = 0; r < 2; r++) {
+    float sum = 0.0f;
+    for (size_t c = 0; c < 3; c++) {
+      sum += std::exp(X[r * 3 + c]);
+    }
+    for (size_t c = 0; c < 3; c++) {
+      Y[r * 3 + c] = X[r * 3 + c] - std::log(sum);
+    }
+  }
+  std::vector<int64_t> dimensions = {2, 3};
+
+  std::vector<MLFloat16> f_X(X.size());
+  std::vector<MLFloat16> f_Y(Y.size());
+  ConvertFloatToMLFloat16(X.data(), f_X.data(), static_cast<int>(X.size()));
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), static_cast<int>(Y.size()));
+
+  test.AddInput<MLFloat16>("X", dimensions, f_X);
+  test.AddOutput<MLFloat16>("Y", dimensions, f_Y);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
 
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(SoftmaxOperator, Simple_bfloat16) {
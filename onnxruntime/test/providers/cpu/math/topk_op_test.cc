@@ -861,5 +861,67 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded<double>(k, n, batch_size);
 }
 
+// rows of at least 4096 values with 16 <= k <= n / 16 are selected among the values at least as good as a threshold
+// estimated from a sample of every row. num_values distinct values make ties, which are resolved by the lower index.
+template <typename T>
+static void TestThresholdFilter(int64_t k, int64_t rows, int64_t n, int64_t num_values, int64_t largest,
+                                int64_t sorted) {
+  std::vector<T> input_vals(rows * n);
+  for (int64_t i = 0; i < rows * n; ++i) {
+    input_vals[i] = static_cast<T>((i * 7919) % num_values);
+  }
+
+  std::vector<T> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t i = 0; i < rows; ++i) {
+    const T* row = input_vals.data() + i * n;
+    std::vector<int64_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [row, largest](int64_t lhs, int64_t rhs) {
+      return largest ? row[lhs] > row[rhs] : row[lhs] < row[rhs];
+    });
+    for (int64_t l = 0; l < k; ++l) {
+      expected_vals.push_back(row[order[l]]);
+      expected_indices.push_back(order[l]);
+    }
+  }
+
+  RunTest(11, k, input_vals, {rows, n}, expected_vals, expected_indices, {rows, k}, false, -1, largest, sorted);
+}
+
+TEST(TopKOperator, ThresholdFilterLongRow) {
+  TestThresholdFilter<float>(50, 1, 100000, 100000, 1, 1);
+  TestThresholdFilter<float>(50, 1, 100000, 100000, 0, 1);
+  TestThresholdFilter<float>(50, 1, 100000, 100000, 1, 0);
+  TestThresholdFilter<double>(1000, 1, 70000, 70000, 0, 0);
+}
+
+TEST(TopKOperator, ThresholdFilterTies) {
+  TestThresholdFilter<float>(300, 1, 8192, 10, 1, 1);
+  TestThresholdFilter<int64_t>(64, 2, 20000, 100, 0, 1);
+  TestThresholdFilter<int32_t>(256, 1, 100000, 3, 1, 0);
+}
+
+// 16 long rows are split between the threads
+TEST(TopKOperator, ThresholdFilterThreaded) {
+  TestThresholdFilter<float>(128, 16, 8192, 8192, 1, 1);
+  TestThresholdFilter<float>(128, 16, 8192, 8192, 0, 0);
+}
+
+// the row of increasing values is the worst case of the heap
+TEST(TopKOperator, ThresholdFilterSortedRow) {
+  constexpr int64_t k = 512;
+  constexpr int64_t n = 65536;
+  std::vector<float> input_vals(n);
+  std::iota(input_vals.begin(), input_vals.end(), 0.0f);
+  std::vector<float> expected_vals(k);
+  std::vector<int64_t> expected_indices(k);
+  for (int64_t l = 0; l < k; ++l) {
+    expected_vals[l] = static_cast<float>(n - 1 - l);
+    expected_indices[l] = n - 1 - l;
+  }
+  RunTest(11, k, input_vals, {1, n}, expected_vals, expected_indices, {1, k}, false);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
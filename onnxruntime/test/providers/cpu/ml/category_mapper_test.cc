@@ -43,5 +43,20 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+// enough elements to be mapped in parallel blocks
+TEST(CategoryMapper, ManyStringsToInt) {
+  static const std::vector<std::string> names = {"One", "Two", "Three", "Four"};
+  static const std::vector<int64_t> indexes = {1, 2, 3, 99};
+
+  std::vector<std::string> input;
+  std::vector<int64_t> output;
+  for (size_t i = 0; i < 50000; ++i) {
+    input.push_back(names[i % names.size()]);
+    output.push_back(indexes[i % indexes.size()]);
+  }
+
+  RunTest({50, 1000}, input, output);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -88,6 +88,57 @@ TEST(MLOpTest, LinearClassifierMulticlassProbSigmoid) {
   test.Run();
 }
 
+// enough batches to be scored in blocks by several threads
+TEST(MLOpTest, LinearClassifierMulticlassSoftmaxManyBatches) {
+  OpTester test("LinearClassifier", 1, onnxruntime::kMLDomain);
+
+  constexpr int64_t num_batches = 2000, num_features = 5, num_classes = 4;
+  std::vector<float> coefficients;
+  for (int64_t c = 0; c < num_classes; ++c) {
+    for (int64_t f = 0; f < num_features; ++f) {
+      coefficients.push_back(c == f ? 1.f : 0.01f * static_cast<float>(c + 2 * f));
+    }
+  }
+  std::vector<float> intercepts = {0.1f, -0.2f, 0.3f, -0.4f};
+  std::vector<int64_t> classes = {10, 11, 12, 13};
+
+  // the features of each batch pick its class, with a margin
+  std::vector<float> X;
+  std::vector<int64_t> predicted_class;
+  std::vector<float> predictions;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    for (int64_t f = 0; f < num_features; ++f) {
+      X.push_back(f == i % num_classes ? 4.f : 0.001f * static_cast<float>((i + f) % 100));
+    }
+    predicted_class.push_back(classes[i % num_classes]);
+
+    std::vector<double> scores(num_classes);
+    double sum = 0.0;
+    for (int64_t c = 0; c < num_classes; ++c) {
+      double score = intercepts[c];
+      for (int64_t f = 0; f < num_features; ++f) {
+        score += static_cast<double>(X[i * num_features + f]) * coefficients[c * num_features + f];
+      }
+      scores[c] = std::exp(score);
+      sum += scores[c];
+    }
+    for (int64_t c = 0; c < num_classes; ++c) {
+      predictions.push_back(static_cast<float>(scores[c] / sum));
+    }
+  }
+
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("intercepts", intercepts);
+  test.AddAttribute("classlabels_ints", classes);
+  test.AddAttribute("post_transform", std::string("SOFTMAX"));
+
+  test.AddInput<float>("X", {num_batches, num_features}, X);
+  test.AddOutput<int64_t>("Y", {num_batches}, predicted_class);
+  test.AddOutput<float>("Z", {num_batches, num_classes}, predictions);
+  test.SetOutputAbsErr("Z", 0.0001f);
+  test.Run();
+}
+
 TEST(MLOpTest, LinearClassifierBinary) {
   OpTester test("LinearClassifier", 1, onnxruntime::kMLDomain);
 
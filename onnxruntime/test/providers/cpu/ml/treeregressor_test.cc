@@ -1,8 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
+#include "core/framework/session_options.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -760,5 +766,103 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+
+void GenDeepTreesAndRunTest(const std::string& mode, int64_t n_obs, const char* compact_layout = "0") {
+  // Enough complete trees of depth 4 for TreeEnsemble to evaluate them with bit vectors instead of walking them.
+  // Node n of every tree has the true branch 2n + 1 and the false branch 2n + 2.
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+  const int64_t n_trees = 24;
+  const int64_t n_nodes_per_tree = 31;
+  const int64_t n_branches_per_tree = 15;
+  const int64_t n_features = 3;
+
+  std::vector<int64_t> nodes_treeids, nodes_nodeids, nodes_featureids, nodes_truenodeids, nodes_falsenodeids;
+  std::vector<float> nodes_values;
+  std::vector<std::string> nodes_modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t tree = 0; tree < n_trees; ++tree) {
+    for (int64_t node = 0; node < n_nodes_per_tree; ++node) {
+      const bool is_leaf = node >= n_branches_per_tree;
+      nodes_treeids.push_back(tree);
+      nodes_nodeids.push_back(node);
+      nodes_featureids.push_back(is_leaf ? 0 : (tree + node) % n_features);
+      nodes_values.push_back(is_leaf ? 0.f : static_cast<float>((tree * 7 + node * 3) % 10) * 0.5f);
+      nodes_modes.push_back(is_leaf ? "LEAF" : mode);
+      nodes_truenodeids.push_back(is_leaf ? 0 : 2 * node + 1);
+      nodes_falsenodeids.push_back(is_leaf ? 0 : 2 * node + 2);
+      if (is_leaf) {
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(node);
+        target_ids.push_back(0);
+        target_weights.push_back(static_cast<float>(tree) + static_cast<float>(node) * 0.25f);
+      }
+    }
+  }
+
+  std::vector<float> X;
+  for (int64_t i = 0; i < n_obs * n_features; ++i) {
+    X.push_back(static_cast<float>((i * 5) % 11) * 0.5f);
+  }
+  // A missing value goes to the false branch since the nodes have no missing value tracks.
+  X[1] = std::numeric_limits<float>::quiet_NaN();
+
+  std::vector<float> Y;
+  for (int64_t i = 0; i < n_obs; ++i) {
+    float score = 0.f;
+    for (int64_t tree = 0; tree < n_trees; ++tree) {
+      int64_t node = 0;
+      while (node < n_branches_per_tree) {
+        const size_t index = static_cast<size_t>(tree * n_nodes_per_tree + node);
+        const float val = X[static_cast<size_t>(i * n_features + nodes_featureids[index])];
+        const bool is_true = mode == "BRANCH_LEQ" ? val <= nodes_values[index] : val < nodes_values[index];
+        node = is_true ? nodes_truenodeids[index] : nodes_falsenodeids[index];
+      }
+      score += static_cast<float>(tree) + static_cast<float>(node) * 0.25f;
+    }
+    Y.push_back(score);
+  }
+
+  test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+  test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+  test.AddAttribute("nodes_treeids", nodes_treeids);
+  test.AddAttribute("nodes_nodeids", nodes_nodeids);
+  test.AddAttribute("nodes_featureids", nodes_featureids);
+  test.AddAttribute("nodes_values", nodes_values);
+  test.AddAttribute("nodes_modes", nodes_modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", int64_t{1});
+
+  test.AddInput<float>("X", {n_obs, n_features}, X);
+  test.AddOutput<float>("Y", {n_obs, 1}, Y);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleCompactLayout, compact_layout));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
+TEST(MLOpTest, TreeRegressorDeepTreesBitVectors) {
+  GenDeepTreesAndRunTest("BRANCH_LEQ", 1);
+  GenDeepTreesAndRunTest("BRANCH_LEQ", 201);
+  GenDeepTreesAndRunTest("BRANCH_LT", 7);
+  GenDeepTreesAndRunTest("BRANCH_LT", 201);
+}
+
+TEST(MLOpTest, TreeRegressorDeepTreesCompactLayout) {
+  for (const char* compact_layout : {"1", "2"}) {
+    GenDeepTreesAndRunTest("BRANCH_LEQ", 1, compact_layout);
+    GenDeepTreesAndRunTest("BRANCH_LEQ", 201, compact_layout);
+    GenDeepTreesAndRunTest("BRANCH_LT", 7, compact_layout);
+    GenDeepTreesAndRunTest("BRANCH_LT", 201, compact_layout);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/framework/session_options.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -979,5 +983,65 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// 3x3 stride 1 convolutions with constant weights and enough channels use the Winograd algorithm when
+// an output tile is configured.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t N = 2, C = 16, H = 9, W = 11, M = 24;
+
+  std::vector<float> X(N * C * H * W), Wt(M * C * 3 * 3), B(M);
+  for (size_t i = 0; i < X.size(); i++) {
+    X[i] = static_cast<float>(static_cast<int>(i % 13) - 6) * 0.125f;
+  }
+  for (size_t i = 0; i < Wt.size(); i++) {
+    Wt[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.0625f;
+  }
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<float>(i) * 0.01f;
+  }
+
+  std::vector<float> Y(N * M * H * W);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t h = 0; h < H; h++) {
+        for (int64_t w = 0; w < W; w++) {
+          double sum = B[m];
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = h + kh - 1;
+                const int64_t iw = w + kw - 1;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += double(X[((n * C + c) * H + ih) * W + iw]) * double(Wt[((m * C + c) * 3 + kh) * 3 + kw]);
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * H + h) * W + w] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  for (const char* tile : {"0", "2", "4", "6"}) {
+    OpTester test("Conv", 11);
+    test.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+    test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    test.AddInput<float>("X", {N, C, H, W}, X);
+    test.AddInput<float>("W", {M, C, 3, 3}, Wt, true);
+    test.AddInput<float>("B", {M}, B, true);
+    test.AddOutput<float>("Y", {N, M, H, W}, Y);
+    test.SetOutputAbsErr("Y", 1e-3f);
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasConvWinogradTile, tile));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
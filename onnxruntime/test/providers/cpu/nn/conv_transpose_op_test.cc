@@ -1147,6 +1147,69 @@ TEST(ConvTransposeTest, ConvTranspose_AutoPad_with_non_default_strides) {
                        kDmlExecutionProvider});     // TODO: Unskip when fixed #41968513
 }
 
+// Many output channels per group, with pads, strides, dilations and bias, against a direct computation.
+TEST(ConvTransposeTest, ConvTranspose_2D_ManyChannels_PadsStridesDilations) {
+  constexpr int64_t N = 2, C = 4, H = 5, W = 6, M = 24, group = 2, KH = 3, KW = 2;
+  constexpr int64_t stride_h = 2, stride_w = 3, dilation_h = 2, dilation_w = 1;
+  constexpr int64_t pad_t = 1, pad_l = 2, pad_b = 2, pad_r = 0;
+  constexpr int64_t OH = (H - 1) * stride_h + dilation_h * (KH - 1) + 1 - pad_t - pad_b;
+  constexpr int64_t OW = (W - 1) * stride_w + dilation_w * (KW - 1) + 1 - pad_l - pad_r;
+  constexpr int64_t C_per_group = C / group, M_per_group = M / group;
+
+  vector<float> X(N * C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int64_t>(i % 7) - 3);
+  }
+  vector<float> weights(C * M_per_group * KH * KW);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = static_cast<float>(static_cast<int64_t>(i % 5) - 2) * 0.5f;
+  }
+  vector<float> B(M);
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(i) * 0.25f;
+  }
+
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t m = 0; m < M; ++m) {
+      const int64_t g = m / M_per_group;
+      for (int64_t i = 0; i < OH * OW; ++i) {
+        Y[(n * M + m) * OH * OW + i] = B[m];
+      }
+      for (int64_t c = g * C_per_group; c < (g + 1) * C_per_group; ++c) {
+        for (int64_t h = 0; h < H; ++h) {
+          for (int64_t w = 0; w < W; ++w) {
+            for (int64_t kh = 0; kh < KH; ++kh) {
+              for (int64_t kw = 0; kw < KW; ++kw) {
+                const int64_t oh = h * stride_h + kh * dilation_h - pad_t;
+                const int64_t ow = w * stride_w + kw * dilation_w - pad_l;
+                if (oh < 0 || oh >= OH || ow < 0 || ow >= OW) {
+                  continue;
+                }
+                Y[((n * M + m) * OH + oh) * OW + ow] +=
+                    X[((n * C + c) * H + h) * W + w] *
+                    weights[((c * M_per_group + m % M_per_group) * KH + kh) * KW + kw];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  OpTester test("ConvTranspose", 11);
+  test.AddAttribute("kernel_shape", vector<int64_t>{KH, KW});
+  test.AddAttribute("group", group);
+  test.AddAttribute("pads", vector<int64_t>{pad_t, pad_l, pad_b, pad_r});
+  test.AddAttribute("strides", vector<int64_t>{stride_h, stride_w});
+  test.AddAttribute("dilations", vector<int64_t>{dilation_h, dilation_w});
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("W", {C, M_per_group, KH, KW}, weights);
+  test.AddInput<float>("B", {M}, B);
+  test.AddOutput<float>("Y", {N, M, OH, OW}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kQnnExecutionProvider});
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(ConvTransposeTest, SharedPrepackedWeights) {
@@ -4,11 +4,14 @@
 #include <algorithm>
 #include <random>
 
+#include "core/framework/session_options.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math.h"
 #include "default_providers.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
 
 namespace onnxruntime {
 namespace test {
@@ -288,6 +291,7 @@ class QLinearConvOpTester {
   int64_t groups_{0};
   float output_scale_{1.0f};
   ActType output_zero_point_{0};
+  bool direct_conv_{false};
 
   static size_t ShapeSize(const std::vector<int64_t>& shape) {
     return static_cast<size_t>(std::accumulate(shape.cbegin(), shape.cend(), 1LL, std::multiplies<int64_t>()));
@@ -518,6 +522,18 @@ class QLinearConvOpTester {
       test.AddAttribute("group", groups_);
     }
 
+    if (direct_conv_) {
+      SessionOptions so;
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasQLinearConvDirect, "1"));
+
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      test.Config(so)
+          .ConfigEps(std::move(execution_providers))
+          .RunWithConfig();
+      return;
+    }
+
     test.Run(OpTester::ExpectResult::kExpectSuccess, "");
   }
 
@@ -574,6 +590,10 @@ class QLinearConvOpTester {
     output_zero_point_ = output_zero_point;
   }
 
+  void SetDirectConv(bool direct_conv) {
+    direct_conv_ = direct_conv;
+  }
+
   void Run() {
     for (bool all_input_initializer_except_x : std::initializer_list<bool>{false, true}) {
       Run(all_input_initializer_except_x);
@@ -663,6 +683,41 @@ TEST(QLinearConvTest, Conv2D_U8S8) {
   test.Run();
 }
 
+TEST(QLinearConvTest, Conv2D_U8S8_Direct) {
+  QLinearConvOpTester<uint8_t, int8_t> test;
+  test.GenerateRandomInput({3, 24, 15, 11}, .05f, 4);
+  test.GenerateRandomWeights({32, 24, 3, 3}, .125f, 3);
+  test.GenerateRandomBias();
+  test.SetPads({1, 1, 1, 1});
+  test.SetOutputScaleAndZeroPoint(.55f, 54);
+  test.SetDirectConv(true);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Conv2D_U8U8_Direct_5x5_Strides) {
+  QLinearConvOpTester<uint8_t, uint8_t> test;
+  test.GenerateRandomInput({2, 13, 19, 17}, .05f, 4);
+  test.GenerateRandomWeights({21, 13, 5, 5}, .125f, 130);
+  test.GenerateRandomBias();
+  test.SetPads({2, 1, 2, 1});
+  test.SetStrides({2, 1});
+  test.SetOutputScaleAndZeroPoint(.55f, 54);
+  test.SetDirectConv(true);
+  test.Run();
+}
+
+TEST(QLinearConvTest, Conv2D_S8S8_Direct) {
+  QLinearConvOpTester<int8_t, int8_t> test;
+  test.GenerateRandomInput({1, 16, 14, 14}, .05f, -3);
+  test.GenerateRandomWeights({16, 16, 3, 3}, .125f, 2);
+  test.GenerateRandomBias();
+  test.SetPads({1, 1, 1, 1});
+  test.SetDilations({2, 2});
+  test.SetOutputScaleAndZeroPoint(.55f, -5);
+  test.SetDirectConv(true);
+  test.Run();
+}
+
 TEST(QLinearConvTest, Conv3D_U8S8) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -254,6 +256,42 @@ TEST(NonMaxSuppressionOpTest, SelectThirty) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManySelectedBoxes_TwoBatches_ThreeClasses) {
+  // 40 disjoint boxes, sorted by score, and a copy of box 30 with the lowest score that is suppressed by it
+  constexpr int64_t num_disjoint_boxes = 40;
+  std::vector<float> boxes;
+  std::vector<float> class_scores;
+  for (int64_t i = 0; i < num_disjoint_boxes; ++i) {
+    const float x = static_cast<float>(2 * i);
+    boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    class_scores.push_back(0.9f - 0.01f * static_cast<float>(i));
+  }
+  boxes.insert(boxes.end(), {0.0f, 60.0f, 1.0f, 61.0f});
+  class_scores.push_back(0.05f);
+
+  std::vector<float> batch_boxes(boxes);
+  batch_boxes.insert(batch_boxes.end(), boxes.begin(), boxes.end());
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t batch = 0; batch < 2; ++batch) {
+    for (int64_t c = 0; c < 3; ++c) {
+      scores.insert(scores.end(), class_scores.begin(), class_scores.end());
+      for (int64_t i = 0; i < num_disjoint_boxes; ++i) {
+        selected_indices.insert(selected_indices.end(), {batch, c, i});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {2, num_disjoint_boxes + 1, 4}, batch_boxes);
+  test.AddInput<float>("scores", {2, 3, num_disjoint_boxes + 1}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {100L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {2 * 3 * num_disjoint_boxes, 3}, selected_indices);
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, SelectSingleBox) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 1, 4},
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <random>
 #include <cmath>
 #include <type_traits>
@@ -5513,6 +5514,146 @@ TEST(ReductionOpTest, ReduceSum_RK_parallel) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCoreMLExecutionProvider});
 }
 
+// Few long rows, split in chunks reduced by different threads.
+TEST(ReductionOpTest, ReduceSum_KR_split_rows) {
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(2 * 65536);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 7);
+  test.AddInput<float>("data", {2, 65536}, in_data);
+  std::vector<float> expected(2, 0.f);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    expected[i / 65536] += in_data[i];
+  }
+  test.AddOutput<float>("reduced", {2}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceSum_all_axes_large) {
+  OpTester test("ReduceSum");
+  test.AddAttribute("keepdims", (int64_t)1);
+  std::vector<float> in_data(256 * 256);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 5);
+  test.AddInput<float>("data", {256, 256}, in_data);
+  float expected = 0.f;
+  for (float v : in_data) {
+    expected += v;
+  }
+  test.AddOutput<float>("reduced", {1, 1}, {expected});
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceSumSquare_KRK_parallel) {
+  OpTester test("ReduceSumSquare");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(8 * 16 * 4);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 9) - 4.f;
+  test.AddInput<float>("data", {8, 16, 4}, in_data);
+  std::vector<float> expected(8 * 4, 0.f);
+  for (size_t i = 0; i < 8; ++i) {
+    for (size_t j = 0; j < 16; ++j) {
+      for (size_t k = 0; k < 4; ++k) {
+        float v = in_data[(i * 16 + j) * 4 + k];
+        expected[i * 4 + k] += v * v;
+      }
+    }
+  }
+  test.AddOutput<float>("reduced", {8, 4}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_KR_split_rows) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)1);
+  std::vector<float> in_data(2 * 32768);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 11) / 2.f;
+  // The maximum of the second row is only in its last chunk.
+  in_data[in_data.size() - 1] = 20.f;
+  test.AddInput<float>("data", {2, 32768}, in_data);
+  std::vector<float> expected(2);
+  for (size_t row = 0; row < 2; ++row) {
+    const float* begin = in_data.data() + row * 32768;
+    const float max = *std::max_element(begin, begin + 32768);
+    double sum = 0;
+    for (const float* p = begin; p != begin + 32768; ++p) {
+      sum += std::exp(*p - max);
+    }
+    expected[row] = static_cast<float>(std::log(sum)) + max;
+  }
+  test.AddOutput<float>("reduced", {2, 1}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_RK_parallel) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(65536);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 13) / 4.f;
+  test.AddInput<float>("data", {2048, 32}, in_data);
+  std::vector<float> expected(32);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    float max = in_data[i];
+    for (size_t j = 0; j < 2048; ++j) {
+      max = std::max(max, in_data[i + j * expected.size()]);
+    }
+    double sum = 0;
+    for (size_t j = 0; j < 2048; ++j) {
+      sum += std::exp(in_data[i + j * expected.size()] - max);
+    }
+    expected[i] = static_cast<float>(std::log(sum)) + max;
+  }
+  test.AddOutput<float>("reduced", {32}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ArgMax_RK_parallel) {
+  OpTester test("ArgMax", 13);
+  test.AddAttribute("axis", (int64_t)0);
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(65536);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)((i * 7) % 101);
+  test.AddInput<float>("data", {2048, 32}, in_data);
+  std::vector<int64_t> expected(32, 0);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    for (size_t j = 1; j < 2048; ++j) {
+      if (in_data[i + j * 32] > in_data[i + expected[i] * 32])
+        expected[i] = static_cast<int64_t>(j);
+    }
+  }
+  test.AddOutput<int64_t>("reduced", {32}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ArgMin_KR_select_last_index) {
+  OpTester test("ArgMin", 13);
+  test.AddAttribute("axis", (int64_t)1);
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddAttribute("select_last_index", (int64_t)1);
+  std::vector<int32_t> in_data(4 * 1000);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = static_cast<int32_t>((i * 7) % 97);
+  test.AddInput<int32_t>("data", {4, 1000}, in_data);
+  std::vector<int64_t> expected(4, 0);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    for (size_t j = 1; j < 1000; ++j) {
+      if (in_data[i * 1000 + j] <= in_data[i * 1000 + expected[i]])
+        expected[i] = static_cast<int64_t>(j);
+    }
+  }
+  test.AddOutput<int64_t>("reduced", {4, 1}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(ReductionOpTest, ReduceSum_RK_keepdims) {
   OpTester test("ReduceSum");
   test.AddAttribute("axes", std::vector<int64_t>{0});
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 
 #include <iterator>
+#include <unordered_set>
 #include <vector>
 
 #include "core/providers/cpu/rnn/deep_cpu_gru.h"
@@ -34,7 +35,8 @@ static void RunGruTest(const std::vector<float>& X_data,
                        // copy the following vectors as we may modify them
                        std::vector<string> activations = default_activations,
                        std::vector<float> activation_alphas = {},
-                       std::vector<float> activation_betas = {}) {
+                       std::vector<float> activation_betas = {},
+                       int intra_op_num_threads = 0) {
   OpTester test("GRU");
 
   test.AddShapeToTensorData();
@@ -98,12 +100,21 @@ static void RunGruTest(const std::vector<float>& X_data,
     test.AddOptionalOutputEdge<float>();
   }
 
-// TensorRT, OpenVINO failed on GRU tests
+  // TensorRT, OpenVINO failed on GRU tests
+  std::unordered_set<std::string> excluded_providers{kTensorrtExecutionProvider};
 #if defined(USE_OPENVINO)
-  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
-#else
-  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  excluded_providers.insert(kOpenVINOExecutionProvider);
 #endif
+
+  if (intra_op_num_threads > 0) {
+    // run with a thread pool of that size for the operators, i.e. without one if it is 1
+    SessionOptions so;
+    so.use_per_session_threads = true;
+    so.intra_op_param.thread_pool_size = intra_op_num_threads;
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", excluded_providers);
+  } else {
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", excluded_providers);
+  }
 }
 
 void DefaultActivationsSimpleWeightsNoBias(std::string direction,
@@ -420,7 +431,8 @@ class DeepCpuGruOpTestContext {
                const std::vector<float>* initial_h,
                const std::vector<float>& expected_Y,
                const std::vector<float>& expected_Y_h,
-               const bool linear_before_reset = false);
+               const bool linear_before_reset = false,
+               const int intra_op_num_threads = 0);
 
  private:
   const int input_size_;
@@ -556,7 +568,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
                                       const std::vector<float>* initial_h,
                                       const std::vector<float>& expected_Y,
                                       const std::vector<float>& expected_Y_h,
-                                      const bool linear_before_reset) {
+                                      const bool linear_before_reset,
+                                      const int intra_op_num_threads) {
   // run with and without output_sequence
   RunGruTest(X, gru_input_weights_, gru_recurrent_weights_,
              expected_Y, expected_Y_h,
@@ -570,7 +583,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
              linear_before_reset,
              activation_func_names_,
              alphas_,
-             betas_);
+             betas_,
+             intra_op_num_threads);
 
   RunGruTest(X, gru_input_weights_, gru_recurrent_weights_,
              expected_Y, expected_Y_h,
@@ -584,7 +598,8 @@ void DeepCpuGruOpTestContext::RunTest(const std::vector<float>& X,
              linear_before_reset,
              activation_func_names_,
              alphas_,
-             betas_);
+             betas_,
+             intra_op_num_threads);
 }
 
 TEST(GRUTest, ONNXRuntime_TestGRUOpForwardBasic) {
@@ -948,6 +963,61 @@ TEST(GRUTest, ONNXRuntime_TestGRUOpSequenceLengthWithBidirectionalLinearBeforeRe
   ctx.RunTest(X, batch_size, seq_length, sequence_length, &initial_h, expected_Y, expected_Y_h, true);
 }
 
+TEST(GRUTest, ONNXRuntime_TestGRUOpBidirectionalConcurrentDirections) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: MLOperatorAuthorImpl.cpp(1817): The parameter is incorrect.";
+  }
+
+  const std::string direction = "bidirectional";
+  const std::vector<std::string> activations = {"sigmoid", "tanh", "sigmoid", "tanh"};
+
+  DeepCpuGruOpTestContext ctx(direction, activations);
+
+  constexpr int batch_size = 2;
+  constexpr int seq_length = 2;
+  std::vector<float> X = {-0.455351f, -0.276391f,
+                          0.855351f, 0.676391f,
+                          -0.185934f, -0.269585f,
+                          0.585934f, 0.669585f};
+  std::vector<int> sequence_length = {2, 1};
+  std::vector<float> initial_h = {0.0f, 0.0f, 0.0f, 0.0f,
+                                  0.0f, 0.0f, 0.0f, 0.0f};
+  std::vector<float> expected_Y = {-0.0325528607f, 0.0774837881f, -0.275918573f, -0.00228558504f,
+                                   -0.0559310019f, 0.101836264f, -0.275918573f, -0.00228558504f,
+
+                                   -0.0577347837f, 0.0796165839f, 0.0f, 0.0f,
+                                   -0.0456649922f, 0.0462125242f, 0.0f, 0.0f};
+  std::vector<float> expected_Y_h = {-0.0577347837f, 0.0796165839f,
+                                     -0.275918573f, -0.00228558504f,
+                                     -0.0559310019f, 0.101836264f,
+                                     -0.275918573f, -0.00228558504f};
+
+  // with 4 threads the directions of this small batch are computed at the same time, each of them by a single
+  // thread, and with 1 thread one after the other. both have to give the same outputs.
+  for (int intra_op_num_threads : {1, 4}) {
+    ctx.RunTest(X, batch_size, seq_length, sequence_length, &initial_h, expected_Y, expected_Y_h, true,
+                intra_op_num_threads);
+  }
+
+  std::vector<float> X_batch_1 = {-0.455351f, -0.276391f,
+                                  -0.185934f, -0.269585f};
+  std::vector<int> sequence_length_batch_1 = {2};
+  std::vector<float> initial_h_batch_1 = {0.0f, 0.0f, 0.0f, 0.0f};
+  std::vector<float> expected_Y_batch_1 = {-0.03255286f, 0.0774838f,
+                                           -0.05469977f, 0.1004222f,
+
+                                           -0.05556786f, 0.0785508f,
+                                           -0.04566499f, 0.04621252f};
+  std::vector<float> expected_Y_h_batch_1 = {-0.05556786f, 0.0785508f,
+                                             -0.05469977f, 0.1004222f};
+
+  for (int intra_op_num_threads : {1, 4}) {
+    ctx.RunTest(X_batch_1, 1, seq_length, sequence_length_batch_1, &initial_h_batch_1, expected_Y_batch_1,
+                expected_Y_h_batch_1, false, intra_op_num_threads);
+  }
+}
+
 TEST(GRUTest, ONNXRuntime_TestGRUOpShorterSeqInMiddle) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
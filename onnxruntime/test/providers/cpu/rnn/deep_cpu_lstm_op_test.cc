@@ -50,7 +50,8 @@ static void RunLstmTest(const std::vector<float>& X_data,
                         std::vector<string> activations = {},
                         std::vector<float> activation_alphas = {},
                         std::vector<float> activation_betas = {},
-                        bool hasClip = true) {
+                        bool hasClip = true,
+                        int intra_op_num_threads = 0) {
   OpTester test("LSTM");
 
   int num_directions = (direction == "bidirectional") ? 2 : 1;
@@ -146,14 +147,23 @@ static void RunLstmTest(const std::vector<float>& X_data,
   test.SetOutputTolerance(0.0001f);
 
   // TensorRT failed on LSTM tests
-  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  if (intra_op_num_threads > 0) {
+    // run with a thread pool of that size for the operators, i.e. without one if it is 1
+    SessionOptions so;
+    so.use_per_session_threads = true;
+    so.intra_op_param.thread_pool_size = intra_op_num_threads;
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  } else {
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
 }
 
 void SimpleWeightsNoBiasTwoRows(std::string direction,
                                 const std::vector<float>& Y_data,
                                 const std::vector<float>& Y_h_data,
                                 const std::vector<float>& Y_c_data,
-                                const std::vector<int>* seq_lengths = nullptr) {
+                                const std::vector<int>* seq_lengths = nullptr,
+                                int intra_op_num_threads = 0) {
   int64_t seq_length = 2;
   int batch_size = 2;
   int64_t input_size = 1;
@@ -177,14 +187,16 @@ void SimpleWeightsNoBiasTwoRows(std::string direction,
 
   RunLstmTest(X_data, W_data, false, R_data, false, Y_data, Y_h_data, Y_c_data,
               input_size, batch_size, hidden_size, seq_length,
-              nullptr, nullptr, nullptr, nullptr, seq_lengths, direction);
+              nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 9999.f, /* output_sequence*/ true,
+              false, {}, {}, {}, true, intra_op_num_threads);
 
   // need at least one output, so we need Y_h or Y_c to be requested (non-empty output to compare against) in order
   // to test Y not being returned (output_sequence == false)
   if (!Y_h_data.empty() || !Y_c_data.empty())
     RunLstmTest(X_data, W_data, false, R_data, false, Y_data, Y_h_data, Y_c_data,
                 input_size, batch_size, hidden_size, seq_length,
-                nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 999.f, /* output_sequence*/ false);
+                nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 999.f, /* output_sequence*/ false,
+                false, {}, {}, {}, true, intra_op_num_threads);
 }
 
 TEST(LSTMTest, ForwardSimpleWeightsNoBiasTwoRows) {
@@ -277,6 +289,47 @@ TEST(LSTMTest, BidirectionalSimpleWeightsNoBiasTwoRows) {
   SimpleWeightsNoBiasTwoRows("bidirectional", Y_data, Y_h_data, Y_c_data);
 }
 
+TEST(LSTMTest, BidirectionalConcurrentDirections) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: MLOperatorAuthorImpl.cpp(1817): The parameter is incorrect.";
+  }
+
+  // the outputs of BidirectionalSimpleWeightsNoBiasTwoRows
+  std::vector<float> Y_data{
+      0.28828835f, 0.36581863f, 0.45679406f,
+      0.34526032f, 0.47220859f, 0.55850911f,
+
+      0.55391603f, 0.69201493f, 0.82696019f,
+      0.64046413f, 0.82303363f, 0.91610711f,
+
+      0.84196719f, 0.89402526f, 0.91073048f,
+      0.85882828f, 0.90703777f, 0.92382453f,
+
+      0.61249432f, 0.70678632f, 0.74094619f,
+      0.62759886f, 0.71640738f, 0.74624585f};
+
+  std::vector<float> Y_h_data{
+      0.84196719f, 0.89402526f, 0.91073048f,
+      0.85882828f, 0.90703777f, 0.92382453f,
+
+      0.55391603f, 0.69201493f, 0.82696019f,
+      0.64046413f, 0.82303363f, 0.91610711f};
+
+  std::vector<float> Y_c_data{
+      1.27731147f, 1.44181041f, 1.53179041f,
+      1.3249796f, 1.51063104f, 1.61451544f,
+
+      1.27850552f, 1.46799496f, 1.57641257f,
+      1.34960834f, 1.54772296f, 1.65633056f};
+
+  // with 4 threads the directions of these small batches are computed at the same time, each of them by a single
+  // thread, and with 1 thread one after the other. both have to give the same outputs.
+  for (int intra_op_num_threads : {1, 4}) {
+    SimpleWeightsNoBiasTwoRows("bidirectional", Y_data, Y_h_data, Y_c_data, nullptr, intra_op_num_threads);
+  }
+}
+
 TEST(LSTMTest, MixedSequenceLengths) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
@@ -665,7 +718,8 @@ class LstmOpContext2x1x2x2 {
                bool use_peepholes = true,
                float clip = 9999.f,
                bool input_forget = false,
-               bool hasClip = true) {
+               bool hasClip = true,
+               int intra_op_num_threads = 0) {
     // run with and without output_sequence to test UniDirectionalLstm handling when Y isn't returned
     for (bool output_sequence : std::initializer_list<bool>{false, true}) {
       ::onnxruntime::test::RunLstmTest(X,
@@ -684,7 +738,8 @@ class LstmOpContext2x1x2x2 {
                                        activation_func_names_,
                                        activation_alphas_,
                                        activation_betas_,
-                                       hasClip);
+                                       hasClip,
+                                       intra_op_num_threads);
     }
   }
 
@@ -744,6 +799,33 @@ TEST(LSTMTest, ONNXRuntime_TestLSTMBidirectionalBasic) {
   context.RunTest(X_data, batch_size, seq_len, nullptr, nullptr, Y_data, Y_h_data, Y_c_data);
 }
 
+TEST(LSTMTest, ONNXRuntime_TestLSTMBidirectionalConcurrentDirections) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: MLOperatorAuthorImpl.cpp(1817): The parameter is incorrect.";
+  }
+
+  constexpr int seq_len = 2, batch_size = 1;
+
+  // the inputs and outputs of ONNXRuntime_TestLSTMBidirectionalBasic, which uses bias and peepholes
+  std::vector<float> X_data = {-0.455351f, -0.276391f,
+                               -0.185934f, -0.269585f};
+  std::vector<float> Y_data = {-0.0251062f, 0.0561262f,
+                               -0.0318928f, 0.0762679f,
+                               -0.0327752f, 0.0593536f,
+                               -0.0306872f, 0.028035f};
+  std::vector<float> Y_h_data = {-0.0327752f, 0.0593536f,
+                                 -0.0318928f, 0.0762679f};
+  std::vector<float> Y_c_data = {-0.0780206f, 0.098829f,
+                                 -0.0753684f, 0.120794f};
+
+  LstmOpContext2x1x2x2 context("bidirectional");
+  for (int intra_op_num_threads : {1, 4}) {
+    context.RunTest(X_data, batch_size, seq_len, nullptr, nullptr, Y_data, Y_h_data, Y_c_data, nullptr,
+                    true, true, 9999.f, false, true, intra_op_num_threads);
+  }
+}
+
 TEST(LSTMTest, ONNXRuntime_TestLSTMForwardNoBiasUsePeepholes) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -116,6 +117,55 @@ TEST(SignalOpsTest, DFT20_Float_inverse) {
   TestInverseFloat(kOpsetVersion20);
 }
 
+// Compares the DFT of lengths with factors 3, 5 and 7, and of prime lengths, to the naive DFT of the input.
+static void TestDFTMatchesNaive(bool complex, bool onesided) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  for (int64_t length : {6, 11, 12, 14, 15, 21, 60, 97}) {
+    OpTester test("DFT", kOpsetVersion20);
+    const int64_t components = complex ? 2 : 1;
+    vector<int64_t> input_shape{2, length, components};
+    vector<float> input_data = random.Uniform<float>(input_shape, -1.f, 1.f);
+
+    const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+    vector<float> expected_output;
+    for (int64_t batch = 0; batch < 2; batch++) {
+      for (int64_t k = 0; k < output_length; k++) {
+        double real = 0;
+        double imag = 0;
+        for (int64_t n = 0; n < length; n++) {
+          const double angle = -2.0 * M_PI * static_cast<double>((n * k) % length) / static_cast<double>(length);
+          const float* x = input_data.data() + (batch * length + n) * components;
+          const double x_imag = complex ? x[1] : 0.0;
+          real += x[0] * std::cos(angle) - x_imag * std::sin(angle);
+          imag += x[0] * std::sin(angle) + x_imag * std::cos(angle);
+        }
+        expected_output.push_back(static_cast<float>(real));
+        expected_output.push_back(static_cast<float>(imag));
+      }
+    }
+
+    test.AddInput<float>("input", input_shape, input_data);
+    test.AddInput<int64_t>("dft_length", {}, {length});
+    test.AddInput<int64_t>("axis", {}, {1});
+    test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+    test.AddOutput<float>("output", {2, output_length, 2}, expected_output);
+    test.SetOutputAbsErr("output", 0.0002f);
+    test.Run();
+  }
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_real) {
+  TestDFTMatchesNaive(false, false);
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_real_onesided) {
+  TestDFTMatchesNaive(false, true);
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix_complex) {
+  TestDFTMatchesNaive(true, false);
+}
+
 // Tests that FFT(FFT(x), inverse=true) == x
 static void TestDFTInvertible(bool complex, int since_version) {
   // TODO: test dft_length
@@ -158,6 +158,21 @@ TEST(CastOpTest, NonStringTypes) {
       CastNonStringTester{});
 }
 
+// Large enough to be cast in parallel blocks.
+TEST(CastOpTest, LargeTensor) {
+  constexpr size_t size = 100003;
+  std::vector<float> float_input(size);
+  for (size_t i = 0; i < size; ++i) {
+    float_input[i] = static_cast<float>(static_cast<int>(i % 1000) - 500) * 0.5f;
+  }
+
+  const std::vector<int32_t> int32_output = CastedValues<float, int32_t>(gsl::make_span(float_input));
+  TestCastOp<float, int32_t>(gsl::make_span(float_input), gsl::make_span(int32_output), {static_cast<int64_t>(size)});
+
+  const std::vector<BFloat16> bfloat16_input = CastedValues<float, BFloat16>(gsl::make_span(float_input));
+  TestCastOp<BFloat16, float>(gsl::make_span(bfloat16_input), gsl::make_span(float_input), {static_cast<int64_t>(size)});
+}
+
 TEST(CastOpTest, FromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   const std::vector<std::string> string_data = {"-inf", "+INF", "0.9767611", "0.28280696",
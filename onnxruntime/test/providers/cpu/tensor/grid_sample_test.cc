@@ -1000,5 +1000,36 @@ TEST(GridSampleTest, test_grid_sample_20_4D_bicubic_reflection_no_align_corners)
   RunTests(test, GetExecutionProviders(20));
 }
 
+// An identity grid over more output locations than are sampled at a time, so that every channel is split in tiles.
+TEST(GridSampleTest, IdentityGridLargeImage) {
+  constexpr int64_t C = 3, H = 40, W = 48;
+  std::vector<float> X_data(C * H * W);
+  for (size_t i = 0; i < X_data.size(); ++i) {
+    X_data[i] = static_cast<float>(i % 97) - 48.f;
+  }
+
+  std::vector<float> Grid_data;
+  Grid_data.reserve(H * W * 2);
+  for (int64_t h = 0; h < H; ++h) {
+    for (int64_t w = 0; w < W; ++w) {
+      Grid_data.push_back(-1.f + 2.f * static_cast<float>(w) / (W - 1));
+      Grid_data.push_back(-1.f + 2.f * static_cast<float>(h) / (H - 1));
+    }
+  }
+
+  for (const char* mode : {"nearest", "linear"}) {
+    for (const char* padding_mode : {"zeros", "border", "reflection"}) {
+      OpTester test("GridSample", 20);
+      test.AddInput<float>("X", {1, C, H, W}, X_data);
+      test.AddInput<float>("Grid", {1, H, W, 2}, Grid_data);
+      test.AddAttribute("mode", std::string(mode));
+      test.AddAttribute("padding_mode", std::string(padding_mode));
+      test.AddAttribute("align_corners", int64_t{1});
+      test.AddOutput<float>("Y", {1, C, H, W}, X_data);
+      RunTests(test, GetExecutionProviders(20));
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1329,6 +1329,34 @@ TEST(DequantizeLinearOp21BlockedTest, SignedInt_UseZeroPoint_LastAxis) {
   DequantizeLinearOp21BlockedTest_Int_Succeed<int16_t, MLFloat16>({2, 2, 4}, 2, 3, x, x_scale, zero_point, y_3);
 }
 
+// large enough to be split across the threads, with a partial last block
+TEST(DequantizeLinearOp21BlockedTest, SignedInt_UseZeroPoint_MiddleAxis_Large) {
+  constexpr int64_t batch = 2, K = 80, N = 40, block_size = 32;
+  constexpr int64_t block_count = (K + block_size - 1) / block_size;
+  std::vector<float> x_scale;
+  std::vector<int> zero_point;
+  for (int64_t i = 0; i < batch * block_count * N; ++i) {
+    x_scale.push_back(0.25f * static_cast<float>(i % 7 - 3));
+    zero_point.push_back(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<int> x;
+  std::vector<float> y;
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t k = 0; k < K; ++k) {
+      for (int64_t n = 0; n < N; ++n) {
+        const int64_t param = (b * block_count + k / block_size) * N + n;
+        const int v = static_cast<int>((b * K + k) * N + n) % 16 - 8;
+        x.push_back(v);
+        y.push_back(static_cast<float>(v - zero_point[param]) * x_scale[param]);
+      }
+    }
+  }
+
+  DequantizeLinearOp21BlockedTest_Int4_Succeed<Int4x2, float>({batch, K, N}, 1, block_size, x, x_scale, zero_point, y);
+  DequantizeLinearOp21BlockedTest_Int_Succeed<int8_t, float>({batch, K, N}, 1, block_size, x, x_scale, zero_point, y);
+  DequantizeLinearOp21BlockedTest_Int_Succeed<int16_t, float>({batch, K, N}, 1, block_size, x, x_scale, zero_point, y);
+}
+
 TEST(DequantizeLinearOp21BlockedTest, UnsignedInt_NoZeroPoint_FirstAxis) {
   std::vector<float> x_scale{-2.0, -4.0, 3.5, 1.0, 2.0, 4.0, -3.5, -1.0};
   std::vector<int> zero_point{};
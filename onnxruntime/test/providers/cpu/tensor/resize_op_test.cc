@@ -1558,6 +1558,40 @@ TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel) {
   test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
   test.Run();
 }
+// Large enough for the rows to be split between threads. Cubic interpolation with a = -0.5 reproduces the ramp since
+// all the taps of the interior output pixels are inside the image, and the border pixels fall on input pixels.
+TEST(ResizeOpTest, ResizeOpCubicDownSampleTest_RGB_align_corners) {
+  OpTester test("Resize", 13);
+  std::vector<float> scales{};
+  std::vector<float> roi{};
+
+  test.AddAttribute("mode", "cubic");
+  test.AddAttribute("cubic_coeff_a", -0.5f);
+  test.AddAttribute("coordinate_transformation_mode", "align_corners");
+
+  constexpr int64_t N = 1, C = 3, H = 64, W = 64, OH = 16, OW = 16;
+  std::vector<float> X(N * C * H * W);
+  for (int64_t c = 0; c < C; ++c) {
+    for (int64_t i = 0; i < H * W; ++i) {
+      X[c * H * W + i] = static_cast<float>(c * 100 + 2 * (i % W));
+    }
+  }
+  std::vector<float> Y(N * C * OH * OW);
+  for (int64_t c = 0; c < C; ++c) {
+    for (int64_t i = 0; i < OH * OW; ++i) {
+      Y[c * OH * OW + i] = static_cast<float>(c * 100) + 2.0f * static_cast<float>(i % OW) * (W - 1) / (OW - 1);
+    }
+  }
+  std::vector<int64_t> sizes{N, C, OH, OW};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("", {0}, scales);
+  test.AddInput<int64_t>("sizes", {4}, sizes);
+  test.AddOutput<float>("Y", {N, C, OH, OW}, Y);
+  test.Run();
+}
+
 TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_tf_half_pixel_for_nn) {
   // tf_half_pixel_for_nn has been deprecated since opset 13
   OpTester test("Resize", 12);
@@ -235,5 +235,33 @@ TEST(ScatterNDOpTest, ScatterND_18_max) {
   test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
 
+TEST(ScatterNDOpTest, ScatterND_18_add_repeated_indices) {
+  // Many updates of few slices, more than a thread's share, so that the updates of one slice have to be applied in
+  // order whatever the number of threads.
+  constexpr int64_t num_slices = 16;
+  constexpr int64_t slice_size = 4;
+  constexpr int64_t num_updates = 4096;
+
+  std::vector<int64_t> data(num_slices * slice_size, 1);
+  std::vector<int64_t> indices(num_updates);
+  std::vector<int64_t> updates(num_updates * slice_size);
+  std::vector<int64_t> output = data;
+  for (int64_t i = 0; i < num_updates; ++i) {
+    indices[i] = (i * 7) % num_slices;
+    for (int64_t j = 0; j < slice_size; ++j) {
+      updates[i * slice_size + j] = i + j;
+      output[indices[i] * slice_size + j] += i + j;
+    }
+  }
+
+  OpTester test("ScatterND", 18);
+  test.AddAttribute("reduction", "add");
+  test.AddInput<int64_t>("data", {num_slices, slice_size}, data);
+  test.AddInput<int64_t>("indices", {num_updates, 1}, indices);
+  test.AddInput<int64_t>("updates", {num_updates, slice_size}, updates);
+  test.AddOutput<int64_t>("output", {num_slices, slice_size}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -8,6 +8,9 @@
 #include "core/providers/cpu/tensor/transpose.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/asserts.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -764,6 +767,64 @@ TEST(TransposeOpTest, DoTransposeEltWise) {
   }
 }
 
+// Computes the expected output of a general permutation element by element.
+template <typename T>
+static void BlockedTransposeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  const size_t size = static_cast<size_t>(TensorShape(input_shape).Size());
+
+  std::vector<T> input_vals(size);
+  for (size_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 251);
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  std::vector<size_t> input_strides(rank);
+  for (size_t i = rank, stride = 1; i-- > 0;) {
+    input_strides[i] = stride;
+    stride *= static_cast<size_t>(input_shape[i]);
+  }
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<T> expected_vals(size);
+  for (size_t out = 0; out < size; ++out) {
+    size_t remaining = out;
+    size_t in = 0;
+    for (size_t i = rank; i-- > 0;) {
+      in += (remaining % static_cast<size_t>(expected_shape[i])) * input_strides[perm[i]];
+      remaining /= static_cast<size_t>(expected_shape[i]);
+    }
+    expected_vals[out] = input_vals[in];
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, {kTensorrtExecutionProvider});
+}
+
+// General permutations that are handled by the tiled transpose in BlockedTranspose.
+template <typename T>
+static void BlockedTransposeTests() {
+  // 2D transposes larger than one tile
+  BlockedTransposeTest<T>({70, 131}, {1, 0});
+  BlockedTransposeTest<T>({3, 129, 65}, {0, 2, 1});
+  // the innermost axis moves and other axes are permuted too
+  BlockedTransposeTest<T>({2, 3, 4, 5}, {3, 1, 0, 2});
+  BlockedTransposeTest<T>({4, 5, 67, 3}, {2, 3, 0, 1});
+  BlockedTransposeTest<T>({2, 3, 4, 5, 6}, {4, 2, 0, 3, 1});
+  BlockedTransposeTest<T>({3, 1, 5, 2, 1, 7}, {5, 4, 0, 3, 1, 2});
+  // the innermost axis does not move, so contiguous runs are copied
+  BlockedTransposeTest<T>({3, 4, 5, 6}, {2, 1, 0, 3});
+  BlockedTransposeTest<T>({2, 3, 4, 5, 6}, {3, 1, 2, 0, 4});
+}
+
+TEST(TransposeOpTest, BlockedTranspose) {
+  BlockedTransposeTests<int8_t>();
+  BlockedTransposeTests<int16_t>();
+  BlockedTransposeTests<float>();
+  BlockedTransposeTests<int64_t>();
+}
+
 #if USE_CUDA
 constexpr const char* kGpuExecutionProvider = kCudaExecutionProvider;
 #elif USE_ROCM
@@ -803,6 +864,17 @@ TEST(TransposeOpTest, Transpose0213_V2) {  // Will trigger Transpose4DParalleliz
   TestTranspose(perm, X_dims, Y_dims);
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(TransposeOpTest, StridedInput) {
+  // the input is a view of the rows of a 3x3 matrix that are all {1, 2, 3}, like the output of an Expand
+  KernelComputeTester test("Transpose");
+  test.AddAttribute("perm", std::vector<int64_t>{1, 0});
+  test.AddInput<float>("X", {3, 3}, {1.f, 2.f, 3.f}, {0, 1});
+  test.AddOutput<float>("Y", {3, 3}, {1.f, 1.f, 1.f, 2.f, 2.f, 2.f, 3.f, 3.f, 3.f});
+  test.Run();
+}
+#endif
+
 TEST(TransposeOpTest, Transpose3DImpl) {
   // Flattening dims 2 and 3 into one dim.
   {
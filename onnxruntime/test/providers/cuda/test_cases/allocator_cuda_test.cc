@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/framework/allocator.h"
+#include "core/framework/stream_handles.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_common.h"
 
@@ -113,5 +114,60 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+TEST(AllocatorTest, CUDAMemPoolAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+  if (!CUDAMemPoolAllocator::IsSupported(cuda_device_id)) {
+    GTEST_SKIP() << "CUDA device doesn't support memory pools.";
+  }
+
+  const size_t size = 1 << 20;
+  CUDAMemPoolAllocator allocator(cuda_device_id, CUDA, 0, 4 * size);
+  EXPECT_TRUE(allocator.IsStreamAware());
+  EXPECT_EQ(allocator.Info().alloc_type, OrtDeviceAllocator);
+
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+  Stream stream(cuda_stream, allocator.Info().device);
+
+  void* a = allocator.AllocOnStream(size, &stream, nullptr);
+  EXPECT_TRUE(a);
+  CUDA_CALL_THROW(cudaMemsetAsync(a, 0, size, cuda_stream));
+  // freed on the stream, the pool can reuse the buffer for the next allocation of the stream
+  allocator.Free(a);
+  void* b = allocator.AllocOnStream(size, &stream, nullptr);
+  EXPECT_TRUE(b);
+
+  void* c = allocator.Alloc(2 * size);
+  EXPECT_TRUE(c);
+
+  AllocatorStats stats;
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 3);
+  EXPECT_EQ(stats.bytes_in_use, static_cast<int64_t>(3 * size));
+  EXPECT_EQ(stats.max_alloc_size, static_cast<int64_t>(2 * size));
+  EXPECT_EQ(stats.bytes_limit, static_cast<int64_t>(4 * size));
+  EXPECT_GE(stats.total_allocated_bytes, static_cast<int64_t>(3 * size));
+
+  // over gpu_mem_limit
+  EXPECT_THROW(allocator.Alloc(2 * size), OnnxRuntimeException);
+
+  // the buffers of the stream outlive it once its run is done
+  allocator.ReleaseStreamBuffers(&stream);
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+  allocator.Free(b);
+  allocator.Free(c);
+
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.max_bytes_in_use, static_cast<int64_t>(3 * size));
+  // the release threshold is 0, the memory is returned to the device on synchronization
+  CUDA_CALL_THROW(cudaDeviceSynchronize());
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
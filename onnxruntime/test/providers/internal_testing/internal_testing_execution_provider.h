@@ -25,6 +25,7 @@ class InternalTestingExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
   DataLayout GetPreferredLayout() const override;
+  bool ConvertLayoutByCost() const override { return convert_layout_by_cost_; }
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
   InternalTestingExecutionProvider& SetDebugOutput(bool debug_output) {
@@ -42,6 +43,11 @@ class InternalTestingExecutionProvider : public IExecutionProvider {
 #endif
   }
 
+  InternalTestingExecutionProvider& SetConvertLayoutByCost(bool convert_layout_by_cost) {
+    convert_layout_by_cost_ = convert_layout_by_cost;
+    return *this;
+  }
+
   /// <summary>
   /// Request all nodes in GetCapability.
   /// If EnableStaticKernels has been called, use static kernels for all nodes.
@@ -78,6 +84,8 @@ class InternalTestingExecutionProvider : public IExecutionProvider {
   // if enabled_static_kernels_ use static kernels for them, otherwise compile.
   bool take_all_nodes_{false};
 
+  bool convert_layout_by_cost_{false};
+
   DataLayout preferred_layout_;  // request all nodes
 
   // per-instance kernel registry so tests using static kernels don't clash.
@@ -12,6 +12,7 @@
 #include "core/session/ort_env.h"
 
 #include "test/framework/test_utils.h"
+#include "test/optimizer/graph_transform_test_builder.h"
 #include "test/test_environment.h"
 #include "test/providers/internal_testing/internal_testing_execution_provider.h"
 #include "test/util/include/asserts.h"
@@ -157,6 +158,37 @@ TEST(InternalTestingEP, PreventSaveOfModelWithCompiledOps) {
                                       "Unable to serialize model as it contains compiled nodes");
 }
 
+// the final Add of mnist, after the MatMul the EP doesn't support, is a partition on its own. it should be left to the
+// CPU EP when the minimum partition size is set.
+TEST(InternalTestingEP, TestMinDevicePartitionSize) {
+  const auto count_ep_nodes = [](const Graph& graph) {
+    return std::count_if(graph.Nodes().begin(), graph.Nodes().end(), [](const Node& node) {
+      return node.GetExecutionProviderType() == utils::kInternalTestingExecutionProvider;
+    });
+  };
+
+  SessionOptions so;
+  // disable the fusions so the original Add nodes are partitioned
+  so.graph_optimization_level = TransformerLevel::Default;
+
+  std::unique_ptr<InferenceSessionWrapper> session;
+  ASSERT_STATUS_OK(CreateSession(so, session));
+  ASSERT_EQ(count_ep_nodes(session->GetGraph()), 2);
+
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMinDevicePartitionSize, "2"));
+  ASSERT_STATUS_OK(CreateSession(so, session));
+
+  const auto& graph = session->GetGraph();
+  ASSERT_EQ(count_ep_nodes(graph), 1);
+
+  const auto cpu_adds = std::count_if(graph.Nodes().begin(), graph.Nodes().end(), [](const Node& node) {
+    return node.OpType() == "Add" && node.GetExecutionProviderType() == kCpuExecutionProvider;
+  });
+  ASSERT_EQ(cpu_adds, 1);
+
+  ExecuteMnist(*session, true);
+}
+
 // the internal NHWC operators are only included as part of contrib ops currently. as the EP requests the NHWC
 // version of the ONNX operator when matching a static kernel, those are required.
 #if !defined(DISABLE_CONTRIB_OPS)
@@ -256,6 +288,55 @@ TEST(InternalTestingEP, TestNhwcConversionOfStaticKernels) {
   run_test(ort_model_path);
 }
 
+TEST(InternalTestingEP, TestNhwcConversionByCost) {
+  // a chain of num_convs Conv -> Relu. all the values are {1, 16, 32, 32} floats.
+  auto run_test = [](int num_convs, const std::string& expected_conv_domain, int expected_transposes) {
+    SCOPED_TRACE("num_convs: " + std::to_string(num_convs));
+
+    const std::unordered_map<std::string, int> domain_to_version = {{"", 13}};
+    Model model("NhwcConversionByCost", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+    ModelTestBuilder builder(model.MainGraph());
+    NodeArg* value = builder.MakeInput<float>({1, 16, 32, 32}, -1.f, 1.f);
+    for (int i = 0; i < num_convs; ++i) {
+      auto* conv_output = builder.MakeIntermediate();
+      auto* relu_output = i + 1 == num_convs ? builder.MakeOutput() : builder.MakeIntermediate();
+      builder.AddNode("Conv", {value, builder.MakeInitializer<float>({16, 16, 3, 3}, -1.f, 1.f)}, {conv_output})
+          .AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      builder.AddNode("Relu", {conv_output}, {relu_output});
+      value = relu_output;
+    }
+    builder.SetGraphOutputs();
+    ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+    std::string model_data;
+    model.ToProto().SerializeToString(&model_data);
+
+    InferenceSessionWrapper session(SessionOptions{}, GetEnvironment());
+    const std::unordered_set<std::string> empty_set;
+    auto ep = std::make_unique<InternalTestingExecutionProvider>(empty_set, empty_set, DataLayout::NHWC);
+    ep->EnableStaticKernels().TakeAllNodes().SetConvertLayoutByCost(true);
+    ASSERT_STATUS_OK(session.RegisterExecutionProvider(std::move(ep)));
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+
+    int num_transposes = 0;
+    for (const auto& node : session.GetGraph().Nodes()) {
+      if (node.OpType() == "Conv") {
+        EXPECT_EQ(node.Domain(), expected_conv_domain);
+      }
+
+      num_transposes += node.OpType() == "Transpose";
+    }
+    EXPECT_EQ(num_transposes, expected_transposes);
+  };
+
+  // the Transposes of the input and the output cost as much as what a single Conv saves
+  run_test(1, kOnnxDomain, 0);
+  // two Conv nodes save twice that, and the Transposes are pushed through the Relu nodes to the input and output
+  run_test(2, kMSInternalNHWCDomain, 2);
+}
+
 // This test can be deprecated now as the code logic has been changed so the model is not applicable
 // TEST(InternalTestingEP, TestRegisterAllocatorHandlesUsageInMultipleSessions) {
 //}
@@ -801,6 +801,75 @@ TEST_F(QnnHTPBackendTests, QnnMultiContextExternal) {
   Ort::Session session(*ort_env, ORT_TSTR("testdata/qnn_ctx/qnn_multi_ctx_external.onnx"), so);
 }
 
+// Two sessions generating their EP context models share one QNN context with kOrtSessionOptionShareEpContexts,
+// the context binary of the 2nd session contains the graphs of both. The sessions created from the EP context
+// models share it too: the 2nd one loads both graphs, and the 1st one uses its graph without loading another context.
+TEST_F(QnnHTPBackendTests, QnnContextShareAcrossSessions) {
+  ProviderOptions provider_options;
+#if defined(_WIN32)
+  provider_options["backend_path"] = "QnnHtp.dll";
+#else
+  provider_options["backend_path"] = "libQnnHtp.so";
+#endif
+
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+
+  auto& logging_manager = DefaultLoggingManager();
+  logging_manager.SetDefaultLoggerSeverity(logging::Severity::kERROR);
+
+  onnxruntime::Model model("QNN_EP_TestModel", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           logging_manager.DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder helper(graph);
+  BuildCastAddTestCase()(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  const auto model_data_span = AsByteSpan(model_data.data(), model_data.size());
+
+  const std::string ctx_model_file_1 = "./qnn_context_share_1_ctx.onnx";
+  const std::string ctx_model_file_2 = "./qnn_context_share_2_ctx.onnx";
+  std::remove(ctx_model_file_1.c_str());
+  std::remove(ctx_model_file_2.c_str());
+
+  {
+    Ort::SessionOptions so1;
+    so1.AddConfigEntry(kOrtSessionOptionEpContextEnable, "1");
+    so1.AddConfigEntry(kOrtSessionOptionEpContextFilePath, ctx_model_file_1.c_str());
+    so1.AddConfigEntry(kOrtSessionOptionEpContextNodeNamePrefix, "graph1");
+    so1.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+    so1.AppendExecutionProvider("QNN", provider_options);
+    Ort::Session session1(*ort_env, model_data_span.data(), model_data_span.size(), so1);
+
+    Ort::SessionOptions so2;
+    so2.AddConfigEntry(kOrtSessionOptionEpContextEnable, "1");
+    so2.AddConfigEntry(kOrtSessionOptionEpContextFilePath, ctx_model_file_2.c_str());
+    so2.AddConfigEntry(kOrtSessionOptionEpContextNodeNamePrefix, "graph2");
+    so2.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+    so2.AppendExecutionProvider("QNN", provider_options);
+    Ort::Session session2(*ort_env, model_data_span.data(), model_data_span.size(), so2);
+  }
+
+  EXPECT_TRUE(std::filesystem::exists(ctx_model_file_1.c_str()));
+  EXPECT_TRUE(std::filesystem::exists(ctx_model_file_2.c_str()));
+
+  {
+    Ort::SessionOptions so;
+    so.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+    so.AppendExecutionProvider("QNN", provider_options);
+
+    Ort::Session session2(*ort_env, ToPathString(ctx_model_file_2).c_str(), so);
+    Ort::Session session1(*ort_env, ToPathString(ctx_model_file_1).c_str(), so);
+  }
+
+  // clean up
+  ASSERT_EQ(std::remove(ctx_model_file_1.c_str()), 0);
+  ASSERT_EQ(std::remove(ctx_model_file_2.c_str()), 0);
+}
+
 #endif  // defined(__aarch64__) || defined(_M_ARM64) || defined(__linux__)
 
 }  // namespace test
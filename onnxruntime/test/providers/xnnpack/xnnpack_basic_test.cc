@@ -89,6 +89,61 @@ TEST(XnnpackEP, TestNhwcConvReluClipFusion) {
   RunAndVerifyOutputsWithEP(ort_model_path, "TestNhwcConvReluClipFusion", std::move(ep), feeds, params);
 }
 
+// with enable_subgraph the Conv, Relu, MaxPool and Add nodes are compiled into a single XNNPACK subgraph,
+// instead of running one kernel each.
+TEST(XnnpackEP, TestSubgraph) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>({1, 3, 16, 16}, -1.f, 1.f);
+    auto* conv0_output = builder.MakeIntermediate();
+    Node& conv0 = builder.AddConvNode(input, builder.MakeInitializer<float>({8, 3, 3, 3}, -1.f, 1.f), conv0_output);
+    conv0.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+
+    auto* relu_output = builder.MakeIntermediate();
+    builder.AddNode("Relu", {conv0_output}, {relu_output});
+
+    auto* pool_output = builder.MakeIntermediate();
+    Node& pool = builder.AddNode("MaxPool", {relu_output}, {pool_output});
+    pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+    pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+
+    auto* conv1_output = builder.MakeIntermediate();
+    builder.AddNode("Conv", {pool_output, builder.MakeInitializer<float>({8, 8, 1, 1}, -1.f, 1.f),
+                             builder.MakeInitializer<float>({8}, -1.f, 1.f)},
+                    {conv1_output});
+
+    builder.AddNode("Add", {conv1_output, pool_output}, {builder.MakeOutput()});
+  };
+
+  onnxruntime::Model model("xnnpack_subgraph", false, DefaultLoggingManager().DefaultLogger());
+  ModelTestBuilder helper(model.MainGraph());
+  build_test_case(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  const auto model_data_span = AsByteSpan(model_data.data(), model_data.size());
+
+  std::function<void(const Graph&)> verify = [](const Graph& graph) -> void {
+    // the Transpose nodes to and from NHWC run on the CPU EP
+    ASSERT_EQ(CountAssignedNodes(graph, kXnnpackExecutionProvider), 1);
+    for (const auto& node : graph.Nodes()) {
+      if (node.GetExecutionProviderType() == kXnnpackExecutionProvider) {
+        ASSERT_EQ(node.OpType().rfind("XNNPACK_", 0), 0u) << "All the nodes should be in one compiled node";
+      }
+    }
+  };
+
+  EPVerificationParams params;
+  params.ep_node_assignment = ExpectedEPNodeAssignment::Some;
+  params.fp32_abs_err = 0.0002f;
+  params.graph_verifier = &verify;
+
+  XnnpackExecutionProviderInfo info{ProviderOptions{{"enable_subgraph", "1"}}, nullptr};
+  RunAndVerifyOutputsWithEP(model_data_span, "XnnpackEP.TestSubgraph",
+                            std::make_unique<XnnpackExecutionProvider>(info), helper.feeds_, params);
+}
+
 // test we can share the cpu ep allocator with the xnnpack EP
 TEST(XnnpackEP, TestAllocatorSharing) {
   auto init_session = [](std::vector<std::shared_ptr<IExecutionProvider>>& eps,
@@ -161,6 +161,49 @@ Status GetStashedActivationCandidates(const GraphViewer& graph_viewer,
   return Status::OK();
 }
 
+/**
+ * @brief Find all long-lived activations in a graph without a forward/backward boundary, e.g. an inference graph.
+ * An activation is long-lived if one of its consumers runs more than kLongLivedActivationMinDistance nodes after its
+ * producer in the topological order.
+ *
+ * @param graph_viewer Graph to iterate.
+ * @param node_index_to_its_order_in_topological_sort_map The mapping of node index to its order in topological sort.
+ * @param candidate_output_args_map Candidate activations that are kept alive for a long time.
+ * @param logger Logger.
+ */
+void GetLongLivedActivationCandidates(const GraphViewer& graph_viewer,
+                                      const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                          node_index_to_its_order_in_topological_sort_map,
+                                      InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                          candidate_output_args_map,
+                                      const logging::Logger& logger) {
+  const auto& node_ids = graph_viewer.GetNodesInTopologicalOrder(TOPOLOGICAL_SORT_ALGORITHM);
+  for (size_t i = 0; i < node_ids.size(); ++i) {
+    const Node* p_node = graph_viewer.GetNode(node_ids[i]);
+    if (p_node == nullptr) { /* skip removed nodes*/
+      continue;
+    }
+
+    for (size_t k = 0; k < p_node->OutputDefs().size(); ++k) {
+      const NodeArg* output_arg = p_node->OutputDefs()[k];
+      if (!output_arg->Exists() || output_arg->Name().empty()) {
+        continue;
+      }
+
+      for (auto& consumer_node : graph_viewer.GetConsumerNodes(output_arg->Name())) {
+        ORT_ENFORCE(consumer_node != nullptr, "Consumer node should not be null.");
+        if (IsLongLivedActivationConsumer(static_cast<ptrdiff_t>(i),
+                                          node_index_to_its_order_in_topological_sort_map.at(consumer_node->Index()))) {
+          candidate_output_args_map[p_node].push_back(k);
+          MO_LOG_DEBUG_INFO(logger, "Find long-lived candidate output named [" + output_arg->Name() + "] of Node " +
+                                        p_node->Name() + "(" + p_node->OpType() + ")");
+          break;
+        }
+      }
+    }
+  }
+}
+
 Status FindORTModuleMemoryOpportunity(const GraphViewer& graph_viewer,
                                       const ProbeConfig& probe_config,
                                       const logging::Logger& logger,
@@ -191,10 +234,15 @@ Status FindORTModuleMemoryOpportunity(const GraphViewer& graph_viewer,
     node_index_to_its_order_in_topological_sort_map[p_node->Index()] = static_cast<ptrdiff_t>(i);
   }
 
-  ORT_RETURN_IF_ERROR(GetStashedActivationCandidates(graph_viewer,
-                                                     yield_op_order_in_topological_sort,
-                                                     candidate_output_args_map,
-                                                     logger));
+  if (yield_op_order_in_topological_sort == -1 && probe_config.enable_inference_recompute) {
+    GetLongLivedActivationCandidates(graph_viewer, node_index_to_its_order_in_topological_sort_map,
+                                     candidate_output_args_map, logger);
+  } else {
+    ORT_RETURN_IF_ERROR(GetStashedActivationCandidates(graph_viewer,
+                                                       yield_op_order_in_topological_sort,
+                                                       candidate_output_args_map,
+                                                       logger));
+  }
 
   InlinedVector<const Node*> layer_boundary_ln_nodes;
   FindLayerBoundaryLayerNormNodes(graph_viewer, logger, node_index_to_its_order_in_topological_sort_map,
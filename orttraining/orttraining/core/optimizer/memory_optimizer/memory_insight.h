@@ -57,6 +57,17 @@ class MemoryRecord {
   int freq = 0;
 };
 
+/**
+ * @brief In graphs without a YieldOp, e.g. inference graphs, an activation is a recompute candidate when it is
+ * consumed more than this number of nodes after its producer in the topological order.
+ */
+constexpr ptrdiff_t kLongLivedActivationMinDistance = 16;
+
+constexpr bool IsLongLivedActivationConsumer(ptrdiff_t producer_order_in_topological_sort,
+                                             ptrdiff_t consumer_order_in_topological_sort) {
+  return consumer_order_in_topological_sort - producer_order_in_topological_sort > kLongLivedActivationMinDistance;
+}
+
 /**
  * @brief Iterate the graph and find all possible memory optimization opportunities for related nodes.
  *
@@ -66,7 +77,8 @@ class MemoryRecord {
  * @param node_index_to_its_order_in_topological_sort_map  The mapping of node index to its order in topological sort.
  * @param yield_op_order_in_topological_sort The order of the boundary op in the topological sort.
  * @param candidate_output_args_map  A map from node to its candidate activations. The candidate activations are
- * generated by forward node, and consumed by backward nodes.
+ * generated by forward node, and consumed by backward nodes. If there is no YieldOp and
+ * probe_config.enable_inference_recompute is set, they are the long-lived activations instead.
  * @param mem_opt_stats  A store to maintain all found optimization plans for related nodes.
  * @return Status
  */
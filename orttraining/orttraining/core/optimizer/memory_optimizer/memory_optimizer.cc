@@ -9,6 +9,8 @@
 #include <vector>
 #include <onnx/defs/attr_proto_util.h>
 
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
 #include "core/framework/random_seed.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
@@ -66,6 +68,26 @@ bool SetTrainingModeForForwardPythonOpNode(Node& node) {
   return false;
 }
 
+// Estimates the size of an activation from its inferred type and shape. Dims that are not statically known count as 1.
+size_t EstimateActivationSizeInBytes(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type() ||
+      type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED) {
+    return 0;
+  }
+
+  SafeInt<size_t> size = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType()->Size();
+  const auto* shape = arg.Shape();
+  if (shape != nullptr) {
+    for (const auto& dim : shape->dim()) {
+      if (dim.has_dim_value()) {
+        size *= static_cast<size_t>(dim.dim_value());
+      }
+    }
+  }
+  return size;
+}
+
 }  // namespace
 
 Status MemoryOptimizer::ParseOptimizationConfigFromString(const std::string& memory_optimization_config_file_path,
@@ -159,6 +181,51 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
   return graph_is_modified;
 }
 
+void MemoryOptimizer::ApplyInferenceMemoryBudget(
+    const InlinedHashMap<const Node*, InlinedVector<size_t>>& candidate_output_args_map,
+    const InlinedHashMap<NodeIndex, ptrdiff_t>& node_index_to_its_order_in_topological_sort_map,
+    InlinedHashMap<const Node*, std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>>&
+        node_to_opt_plan_map,
+    const logging::Logger& logger) const {
+  size_t long_lived_bytes = 0;
+  for (const auto& [node, output_indices] : candidate_output_args_map) {
+    for (size_t output_index : output_indices) {
+      long_lived_bytes += EstimateActivationSizeInBytes(*node->OutputDefs()[output_index]);
+    }
+  }
+
+  std::vector<std::pair<size_t, const Node*>> plan_savings;
+  plan_savings.reserve(node_to_opt_plan_map.size());
+  for (const auto& [node, plan] : node_to_opt_plan_map) {
+    size_t saving = 0;
+    for (size_t output_index : plan->GetActivationOutputIndices()) {
+      saving += EstimateActivationSizeInBytes(*node->OutputDefs()[output_index]);
+    }
+    plan_savings.emplace_back(static_cast<size_t>(static_cast<float>(saving) * plan->GetSaveRatio()), node);
+  }
+
+  // Larger savings first, then the topological order to make the choice deterministic.
+  std::sort(plan_savings.begin(), plan_savings.end(), [&](const auto& lhs, const auto& rhs) {
+    if (lhs.first != rhs.first) {
+      return lhs.first > rhs.first;
+    }
+    return node_index_to_its_order_in_topological_sort_map.at(lhs.second->Index()) <
+           node_index_to_its_order_in_topological_sort_map.at(rhs.second->Index());
+  });
+
+  const size_t budget = static_cast<size_t>(inference_memory_budget_);
+  for (const auto& [saving, node] : plan_savings) {
+    if (long_lived_bytes <= budget) {
+      node_to_opt_plan_map.erase(node);
+    } else {
+      long_lived_bytes -= std::min(saving, long_lived_bytes);
+    }
+  }
+
+  LOGS(logger, INFO) << "Estimated size of the long-lived activations after recompute: " << long_lived_bytes
+                     << " bytes, budget: " << budget << " bytes.";
+}
+
 Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/, const logging::Logger& logger)
     const {
   LOGS(logger, VERBOSE) << "Memory optimization config: " << optimizer_config_file_path_ << ", probe level: "
@@ -200,6 +267,11 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
                                                                  node_to_apply_context_map)
                   .IsOK());
 
+  if (yield_op_order_in_topological_sort == -1 && recompute_probe_config_.enable_inference_recompute) {
+    ApplyInferenceMemoryBudget(candidate_output_args_map, node_index_to_its_order_in_topological_sort_map,
+                               node_to_opt_plan_map, logger);
+  }
+
   // The second pass - apply the transformation.
   const auto& node_ids =
       graph_viewer.GetNodesInTopologicalOrder(optimizer::memory_optimizer::TOPOLOGICAL_SORT_ALGORITHM);
@@ -211,9 +283,15 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
 
     bool has_been_modified = false;
     if (node_to_opt_plan_map.find(p_node) != node_to_opt_plan_map.end()) {
+      // Without a YieldOp, only the consumers of the long-lived activations that run late use the recomputed outputs.
+      const ptrdiff_t boundary_op_order_in_topological_sort =
+          yield_op_order_in_topological_sort != -1
+              ? yield_op_order_in_topological_sort
+              : node_index_to_its_order_in_topological_sort_map.at(p_node->Index()) +
+                    optimizer::memory_optimizer::kLongLivedActivationMinDistance;
       has_been_modified = ModifyGraph(graph, node_index_to_its_order_in_topological_sort_map,
                                       logger,
-                                      yield_op_order_in_topological_sort,
+                                      boundary_op_order_in_topological_sort,
                                       p_node,
                                       node_to_opt_plan_map[p_node],
                                       node_to_apply_context_map[p_node]);
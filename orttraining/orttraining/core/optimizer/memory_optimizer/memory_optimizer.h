@@ -24,18 +24,25 @@ Find recompute subgraphs and enable them according to user configs. The way we c
   b. otherwise, stop collecting and return the subgraph (could be empty).
 3. Pick up the input node from the queue, and do 2 again. The process ends when the queue is empty or 2.b happens.
 4. Clone the recomputable subgraphs and insert them back to the original graph.
+
+For graphs without a YieldOp, e.g. inference graphs, the stashed activations in 1. are the activations consumed long
+after they are produced, and only their late consumers are moved to the recomputed outputs. This is enabled with a
+non-negative inference_memory_budget: the subgraphs enabled by the user configs are recomputed, starting from the ones
+saving the most, until the estimated size of the long-lived activations is within the budget in bytes.
 */
 
 class MemoryOptimizer : public GraphTransformer {
  private:
  public:
   MemoryOptimizer(const std::string& memory_optimization_config_file_path,
-                  const std::string& recompute_probe_config)
-      : GraphTransformer("MemoryOptimizer") {
+                  const std::string& recompute_probe_config,
+                  int64_t inference_memory_budget = -1)
+      : GraphTransformer("MemoryOptimizer"), inference_memory_budget_(inference_memory_budget) {
     // Parse user-defined configs.
     ORT_ENFORCE(ParseOptimizationConfigFromString(
                     memory_optimization_config_file_path, recompute_probe_config)
                     .IsOK());
+    recompute_probe_config_.enable_inference_recompute = inference_memory_budget_ >= 0;
   }
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
@@ -68,6 +75,23 @@ class MemoryOptimizer : public GraphTransformer {
                    std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>& node_plan,
                    std::shared_ptr<optimizer::memory_optimizer::ClusterApplyContext>& apply_context) const;
 
+  /**
+   * @brief Drop the finalized plans that are not needed to fit the long-lived activations of an inference graph into
+   * inference_memory_budget_. The plans saving the most are kept first.
+   *
+   * @param candidate_output_args_map The long-lived activations.
+   * @param node_index_to_its_order_in_topological_sort_map The mapping of node index to its order in topological sort.
+   * @param node_to_opt_plan_map The finalized plans, updated in place.
+   * @param logger Logger.
+   */
+  void ApplyInferenceMemoryBudget(const InlinedHashMap<const Node*, InlinedVector<size_t>>& candidate_output_args_map,
+                                  const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                      node_index_to_its_order_in_topological_sort_map,
+                                  InlinedHashMap<const Node*,
+                                                 std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>>&
+                                      node_to_opt_plan_map,
+                                  const logging::Logger& logger) const;
+
   /**
    * @brief Summarize transformation details.
    *
@@ -105,6 +129,8 @@ class MemoryOptimizer : public GraphTransformer {
   InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> pattern_subgraph_to_user_optimizer_config_map_;
   std::string optimizer_config_file_path_;
   optimizer::memory_optimizer::ProbeConfig recompute_probe_config_;
+  // Size in bytes the long-lived activations of inference graphs should fit in. Negative if disabled.
+  int64_t inference_memory_budget_;
 };
 
 }  // namespace onnxruntime
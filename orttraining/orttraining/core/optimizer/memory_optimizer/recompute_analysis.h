@@ -36,6 +36,9 @@ class ProbeConfig {
 
   ProbeLevel probe_level{ProbeLevel::Basic};
   bool enable_transformer_layer_as_boundary{false};
+  // If the graph has no YieldOp, e.g. an inference graph, use the activations that are consumed long after they are
+  // produced as the candidates to recompute.
+  bool enable_inference_recompute{false};
 };
 
 Status ParseProbeConfigFromString(std::string_view recompute_probe_config,
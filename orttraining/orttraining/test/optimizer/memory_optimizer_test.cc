@@ -384,5 +384,61 @@ TEST(MemoryOptimizerTests, TransformerLayerDetectionTest) {
   ASSERT_EQ(layer_boundary_ln_node[2]->Name(), "LayerNormalization_token_12");
 }
 
+TEST(MemoryOptimizerTests, InferenceRecompute) {
+  const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
+
+  const std::string alleviation_config("Add+:1:-1");
+  onnxruntime::test::TemporaryDirectory tmp_dir{ORT_TSTR("memory_optimizer_test_tmp_dir")};
+  PathString config_path{ConcatPathComponent(tmp_dir.Path(),
+                                             ORT_TSTR("inferencerecompute.json"))};
+  const std::string config_path_str = ToUTF8String(config_path);
+  std::ofstream outfile(config_path_str);
+  outfile << "[\"" << alleviation_config << "\"]" << std::endl;
+  outfile.close();
+
+  // The output of Add is consumed by the first Neg and by the final Mul, which runs long after it.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({16, 16}, -1.0f, 1.0f);
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    builder.AddNode("Add", {input_arg, input_arg}, {add_out});
+
+    NodeArg* chain_out = add_out;
+    for (ptrdiff_t i = 0; i <= optimizer::memory_optimizer::kLongLivedActivationMinDistance; ++i) {
+      auto* neg_out = builder.MakeIntermediate();
+      builder.AddNode("Neg", {chain_out}, {neg_out});
+      chain_out = neg_out;
+    }
+
+    builder.AddNode("Mul", {add_out, chain_out}, {output_arg});
+  };
+
+  // 1024 bytes are kept alive by the Add output, which fits in a 1024 bytes budget.
+  auto check_not_recomputed = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+    return Status::OK();
+  };
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, *logger,
+                                        std::make_unique<MemoryOptimizer>(config_path_str, "0:0", 1024),
+                                        TransformerLevel::Level3, 1, nullptr, check_not_recomputed));
+
+  auto check_recomputed = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 2);
+    // Only the late consumer reads the recomputed output.
+    int recompute_consumer_count = 0;
+    for (auto& node : graph.Nodes()) {
+      if (node.InputDefs()[0]->Name().find("_recompute") != std::string::npos) {
+        TEST_RETURN_IF_NOT(node.OpType() == "Mul");
+        recompute_consumer_count++;
+      }
+    }
+    TEST_RETURN_IF_NOT(recompute_consumer_count == 1);
+    return Status::OK();
+  };
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, *logger,
+                                        std::make_unique<MemoryOptimizer>(config_path_str, "0:0", 1023),
+                                        TransformerLevel::Level3, 1, nullptr, check_recomputed));
+}
+
 }  // namespace test
 }  // namespace onnxruntime
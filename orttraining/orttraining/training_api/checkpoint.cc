@@ -556,7 +556,26 @@ Status FromPropertyBag(const PropertyBag& property_bag, flatbuffers::FlatBufferB
  */
 Status FromCheckpointState(
     const CheckpointState& state, const PathString& checkpoint_path, const bool include_optimizer_state) {
-  flatbuffers::FlatBufferBuilder builder(1024);
+  // Size the builder for the tensor data it will hold, so the buffer isn't repeatedly regrown and copied while the
+  // tensors are serialized.
+  size_t fbs_buffer_size = 1024;
+  if (!state.has_external_data) {
+    for (const auto& [name, param] : state.module_checkpoint_state.named_parameters) {
+      fbs_buffer_size += param->Data().Get<Tensor>().SizeInBytes();
+    }
+  }
+  if (include_optimizer_state) {
+    for (const auto& [group_name, group_optimizer_state] :
+         state.optimizer_checkpoint_state.group_named_optimizer_states) {
+      for (const auto& [param_name, param_optimizer_state] : group_optimizer_state->param_named_optimizer_states) {
+        for (const auto& [state_name, state_value] : param_optimizer_state) {
+          fbs_buffer_size += state_value.Get<Tensor>().SizeInBytes();
+        }
+      }
+    }
+  }
+
+  flatbuffers::FlatBufferBuilder builder(fbs_buffer_size);
 
   fbs::utils::ExternalDataWriter external_data_writer = nullptr;
   std::optional<std::ofstream> external_data_stream;
@@ -606,15 +625,26 @@ namespace load {
 
 /**
  * @brief Load checkpoint flatbuffer from file.
+ * The file is mapped into memory, so its pages are only read as the tensors are loaded from them. It is read into
+ * checkpoint_bytes where it can't be mapped.
  * @param checkpoint_path Path to the checkpoint file.
- * @param checkpoint_bytes Contents of the checkpoint file in bytes.
+ * @param mapped_bytes Contents of the checkpoint file mapped into memory.
+ * @param checkpoint_bytes Contents of the checkpoint file in bytes, if it could not be mapped.
  * @param checkpoint_span Checkpoint bytes represented as a span.
  * @return Status of the operation.
  *
  */
-Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& checkpoint_bytes) {
+Status FromFile(const PathString& checkpoint_path, Env::MappedMemoryPtr& mapped_bytes,
+                InlinedVector<uint8_t>& checkpoint_bytes, gsl::span<const uint8_t>& checkpoint_span) {
   size_t num_bytes = 0;
   ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(checkpoint_path.c_str(), num_bytes));
+
+  if (num_bytes > 0 &&
+      Env::Default().MapFileIntoMemory(checkpoint_path.c_str(), 0, num_bytes, mapped_bytes).IsOK()) {
+    checkpoint_span = gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+    return Status::OK();
+  }
+
   checkpoint_bytes.resize(num_bytes);
 
   std::ifstream bytes_stream(checkpoint_path, std::ifstream::in | std::ifstream::binary);
@@ -623,6 +653,7 @@ Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& check
   ORT_RETURN_IF_NOT(bytes_stream, "Loading checkpoint from ", ToUTF8String(checkpoint_path), " failed. Only ",
                     bytes_stream.gcount(), "/", num_bytes, " bytes could be read.");
 
+  checkpoint_span = checkpoint_bytes;
   return Status::OK();
 }
 
@@ -957,9 +988,11 @@ Status SaveCheckpoint(const CheckpointState& states, const PathString& checkpoin
 Status LoadCheckpoint(const PathString& checkpoint_path, CheckpointState& checkpoint_states) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
+  Env::MappedMemoryPtr mapped_bytes;
   InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
-  return load::ToCheckpointState(checkpoint_bytes, checkpoint_states, checkpoint_path);
+  gsl::span<const uint8_t> checkpoint_span;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, mapped_bytes, checkpoint_bytes, checkpoint_span));
+  return load::ToCheckpointState(checkpoint_span, checkpoint_states, checkpoint_path);
 }
 
 Status LoadCheckpointFromBuffer(gsl::span<const uint8_t> checkpoint_bytes, CheckpointState& checkpoint_state) {
@@ -973,9 +1006,11 @@ Status LoadCheckpointToModel(const PathString& checkpoint_path,
                              ONNX_NAMESPACE::ModelProto& model_proto) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
+  Env::MappedMemoryPtr mapped_bytes;
   InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
-  return load::ToModelProto(checkpoint_bytes, model_proto, checkpoint_path);
+  gsl::span<const uint8_t> checkpoint_span;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, mapped_bytes, checkpoint_bytes, checkpoint_span));
+  return load::ToModelProto(checkpoint_span, model_proto, checkpoint_path);
 }
 #endif
 
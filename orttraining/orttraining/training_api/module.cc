@@ -293,7 +293,19 @@ Module::Module(const ModelIdentifiers& model_identifiers,
         .config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "1";
   }
 
-  train_sess_ = std::make_unique<onnxruntime::InferenceSession>(session_options, env);
+  SessionOptions train_session_options = session_options;
+#ifdef ENABLE_TRAINING
+  // The training graph runs the forward and the backward passes without a YieldOp, so the memory optimizer treats it
+  // like an inference graph: the recompute config only applies with a memory budget. Recompute all the subgraphs
+  // enabled in the config unless the user set a budget.
+  auto& config_options = train_session_options.config_options;
+  if (!config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryOptimizerApplyConfig, "").empty() &&
+      !config_options.GetConfigEntry(kOrtSessionOptionsMemoryOptimizerInferenceBudget).has_value()) {
+    config_options.configurations[kOrtSessionOptionsMemoryOptimizerInferenceBudget] = "0";
+  }
+#endif
+
+  train_sess_ = std::make_unique<onnxruntime::InferenceSession>(train_session_options, env);
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
   if (!op_domains.empty()) {
     ORT_THROW_IF_ERROR(train_sess_->AddCustomOpDomains(op_domains));
@@ -337,6 +349,9 @@ Module::Module(const ModelIdentifiers& model_identifiers,
 
   gradients_.resize(grad_input_names.size());
 
+  utils::WrapInOrtValue<bool>(true, &reset_grad_input_);
+  utils::WrapInOrtValue<bool>(false, &accumulate_grad_input_);
+
   train_input_names_ = TrainInputNames(user_input_names, param_input_names, grad_input_names);
 
   for (const auto& output_name : train_output_names) {
@@ -621,16 +636,17 @@ Status Module::LazyResetGrad() {
 Status Module::TrainStep(const std::vector<OrtValue>& inputs, std::vector<OrtValue>& outputs) {
   ORT_RETURN_IF(state_->module_checkpoint_state.is_nominal_state,
                 "Cannot perform TrainStep with a nominal state. Please load the model parameters first.");
-  std::vector<std::shared_ptr<Parameter>> params;
-  std::vector<OrtValue> feeds{inputs};
-  feeds.insert(feeds.end(), weights_.begin(), weights_.end());
-  feeds.insert(feeds.end(), gradients_.begin(), gradients_.end());
-  // TODO: consider maintaining this as ortvalue instead of bool
-  OrtValue reset_grad_input;
-  utils::WrapInOrtValue<bool>(!accumulate_gradient_, &reset_grad_input);
-  feeds.push_back(reset_grad_input);
-
-  ORT_THROW_IF_ERROR(train_sess_->Run(RunOptions(), train_input_names_.AllInputNames(), feeds, train_output_names_, &outputs));
+  // The feeds are reused across the steps. The gradients are fed as the buffers that the InPlaceAccumulator runs in
+  // place on, so accumulating over micro-batches doesn't allocate them again.
+  train_feeds_.clear();
+  train_feeds_.reserve(inputs.size() + weights_.size() + gradients_.size() + 1);
+  train_feeds_.insert(train_feeds_.end(), inputs.begin(), inputs.end());
+  train_feeds_.insert(train_feeds_.end(), weights_.begin(), weights_.end());
+  train_feeds_.insert(train_feeds_.end(), gradients_.begin(), gradients_.end());
+  train_feeds_.push_back(accumulate_gradient_ ? accumulate_grad_input_ : reset_grad_input_);
+
+  ORT_THROW_IF_ERROR(train_sess_->Run(RunOptions(), train_input_names_.AllInputNames(), train_feeds_,
+                                      train_output_names_, &outputs));
 
   // Reset the flag after every step. In case the ResetGrad was called before running
   // the current step, it will have done the effective resetting during the
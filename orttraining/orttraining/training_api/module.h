@@ -197,6 +197,10 @@ struct Module {
   CheckpointState* state_;  // Non owning pointer to the state.
 
   bool accumulate_gradient_ = false;
+  // the values of the reset_grad input of the training graph
+  OrtValue reset_grad_input_;
+  OrtValue accumulate_grad_input_;
+  std::vector<OrtValue> train_feeds_;
   std::optional<std::string> eval_model_path_;
   std::optional<gsl::span<const uint8_t>> eval_model_buffer_;
   size_t eval_user_input_count_{0U};
@@ -21,11 +21,11 @@ class AdamWOptimizer final : public OpKernel, public AdamWOptimizerBase {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  Status AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2, float lr,
-                           float alpha_correction,
-                           float beta_correction) const;
-  Status AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2, float lr,
-                           float lr_corrected) const;
+  // update count elements of a weight, starting at the given pointers
+  void AdamWComputeMode0(T* weight, const T* gradient, T* momentums_1, T* momentums_2, std::ptrdiff_t count,
+                         float lr, float alpha_correction, float beta_correction) const;
+  void AdamWComputeMode1(T* weight, const T* gradient, T* momentums_1, T* momentums_2, std::ptrdiff_t count,
+                         float lr, float lr_corrected) const;
 };
 
 }  // namespace contrib
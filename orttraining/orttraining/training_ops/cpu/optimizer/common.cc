@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <utility>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/TensorSeq.h"
@@ -29,5 +32,36 @@ Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values,
   return Status::OK();
 }
 
+void MultiTensorApply(concurrency::ThreadPool* tp, const std::vector<int>& tensor_sizes, double cost_per_element,
+                      const std::function<void(size_t tensor_index, std::ptrdiff_t begin, std::ptrdiff_t end)>&
+                          update_chunk,
+                      std::ptrdiff_t chunk_size) {
+  // (tensor index, first element) of each chunk
+  std::vector<std::pair<size_t, std::ptrdiff_t>> chunks;
+  std::ptrdiff_t total_size = 0;
+  for (size_t tensor_index = 0; tensor_index < tensor_sizes.size(); ++tensor_index) {
+    const std::ptrdiff_t tensor_size = tensor_sizes[tensor_index];
+    for (std::ptrdiff_t begin = 0; begin < tensor_size; begin += chunk_size) {
+      chunks.emplace_back(tensor_index, begin);
+    }
+    total_size += tensor_size;
+  }
+
+  if (chunks.empty()) {
+    return;
+  }
+
+  const double cost_per_chunk = cost_per_element * static_cast<double>(total_size) / chunks.size();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(chunks.size()), cost_per_chunk,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t chunk = first; chunk < last; ++chunk) {
+          const auto [tensor_index, begin] = chunks[chunk];
+          const std::ptrdiff_t end = std::min<std::ptrdiff_t>(begin + chunk_size, tensor_sizes[tensor_index]);
+          update_chunk(tensor_index, begin, end);
+        }
+      });
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -5,7 +5,10 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include <cmath>
+#include <functional>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -22,5 +25,13 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 
+// CPU counterpart of the multi-tensor apply of the CUDA optimizers: the elements of all the tensors are split into
+// chunks of at most chunk_size elements, and update_chunk(tensor_index, begin, end) is called for each chunk,
+// in parallel across the chunks of all the tensors, so many small tensors don't serialize the update.
+void MultiTensorApply(concurrency::ThreadPool* tp, const std::vector<int>& tensor_sizes, double cost_per_element,
+                      const std::function<void(size_t tensor_index, std::ptrdiff_t begin, std::ptrdiff_t end)>&
+                          update_chunk,
+                      std::ptrdiff_t chunk_size = 16384);
+
 }  // namespace contrib
 }  // namespace onnxruntime
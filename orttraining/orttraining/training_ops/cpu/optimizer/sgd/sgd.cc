@@ -7,6 +7,7 @@
 #include "core/framework/TensorSeq.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -64,14 +65,16 @@ Status SGDOptimizerV2<T>::Compute(OpKernelContext* ctx) const {
   if (update_signal == nullptr || *update_signal->template Data<bool>()) {
     const float lr = *p.learning_rate->template Data<float>();
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
+    MultiTensorApply(
+        ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes, 2.0,
+        [&p, lr](size_t weight_index, std::ptrdiff_t begin, std::ptrdiff_t end) {
+          const auto& pointers = p.grouped_tensor_pointers[weight_index];
+          EigenVectorArrayMap<T> weight(static_cast<T*>(pointers[0]) + begin, end - begin);
+          ConstEigenVectorArrayMap<T> gradient(static_cast<const T*>(pointers[1]) + begin, end - begin);
 
-      // new_weight = weight - lr * gradient
-      const auto& delta = -lr * MakeEigenArrayMap<T>(gradient);
-      MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) + delta;
-    }
+          // new_weight = weight - lr * gradient
+          weight -= lr * gradient;
+        });
 
     *updated_flag_ptr = true;
   } else {